@@ -0,0 +1,105 @@
+"""Launch a weak and/or strong scaling sweep of the benchmark models.
+
+One job is set up or submitted per model, scaling mode and node count,
+each in its own work directory under the sweep directory. A manifest
+describing the runs is written there for `scaling_report.py`.
+
+"""
+import argparse
+import datetime
+import json
+import os
+
+import lbann
+import lbann.contrib.args
+import lbann.contrib.launcher
+
+import scaling_models
+
+desc = ('Run weak- and strong-scaling benchmarks of standard models '
+        'on synthetic data.')
+parser = argparse.ArgumentParser(description=desc)
+lbann.contrib.args.add_scheduler_arguments(parser, 'lbann_scaling')
+parser.add_argument(
+    '--models', action='store', default='resnet50,transformer,cosmoflow',
+    type=str, help='comma-separated models (default: all)')
+parser.add_argument(
+    '--node-counts', action='store', default='1,2,4,8', type=str,
+    help='comma-separated node counts (default: 1,2,4,8)')
+parser.add_argument(
+    '--scaling', action='store', default='both',
+    choices=('weak', 'strong', 'both'),
+    help='scaling modes to run (default: both)')
+parser.add_argument(
+    '--mini-batch-size-per-node', action='store', default=None, type=int,
+    help=('mini-batch size per node for weak scaling, and at the '
+          'smallest node count for strong scaling (default: per model)'))
+parser.add_argument(
+    '--steps-per-epoch', action='store', default=50, type=int,
+    help='mini-batch steps per epoch (default: 50)')
+parser.add_argument(
+    '--num-epochs', action='store', default=3, type=int,
+    help='epochs per run; the first is discarded as warmup (default: 3)')
+parser.add_argument(
+    '--sweep-dir', action='store', default=None, type=str,
+    help='directory for the sweep (default: timestamped)')
+parser.add_argument(
+    '--no-batch', action='store_true',
+    help='run in the current allocation instead of submitting jobs')
+args = parser.parse_args()
+
+model_names = args.models.split(',')
+node_counts = sorted(int(n) for n in args.node_counts.split(','))
+modes = ('weak', 'strong') if args.scaling == 'both' else (args.scaling,)
+sweep_dir = args.sweep_dir
+if not sweep_dir:
+    timestamp = datetime.datetime.now().strftime('%Y%m%d_%H%M%S')
+    sweep_dir = os.path.join(os.getcwd(), f'{timestamp}_{args.job_name}')
+sweep_dir = os.path.realpath(sweep_dir)
+os.makedirs(sweep_dir, exist_ok=True)
+
+kwargs = lbann.contrib.args.get_scheduler_kwargs(args)
+kwargs.pop('nodes', None)
+
+runs = []
+for name in model_names:
+    if name not in scaling_models.models:
+        raise ValueError(f'unknown model "{name}"')
+    builder, default_mbs = scaling_models.models[name]
+    mbs_per_node = args.mini_batch_size_per_node or default_mbs
+    for mode in modes:
+        for nodes in node_counts:
+            # Weak scaling keeps the per-node mini-batch fixed, strong
+            # scaling keeps the global mini-batch fixed
+            if mode == 'weak':
+                mini_batch_size = mbs_per_node * nodes
+            else:
+                mini_batch_size = mbs_per_node * node_counts[0]
+            num_samples = mini_batch_size * args.steps_per_epoch
+            model, optimizer, make_reader = builder(args.num_epochs)
+            trainer = lbann.Trainer(mini_batch_size=mini_batch_size)
+            work_dir = os.path.join(sweep_dir, f'{name}_{mode}_n{nodes}')
+            status = lbann.contrib.launcher.run(
+                trainer,
+                model,
+                make_reader(num_samples),
+                optimizer,
+                work_dir=work_dir,
+                job_name=f'{args.job_name}_{name}_{mode}_n{nodes}',
+                nodes=nodes,
+                batch_job=not args.no_batch,
+                **kwargs,
+            )
+            runs.append({
+                'model': name,
+                'scaling': mode,
+                'nodes': nodes,
+                'mini_batch_size': mini_batch_size,
+                'work_dir': work_dir,
+                'status': status,
+            })
+
+manifest = os.path.join(sweep_dir, 'manifest.json')
+with open(manifest, 'w') as f:
+    json.dump({'runs': runs}, f, indent=2)
+print(f'Wrote {manifest}')
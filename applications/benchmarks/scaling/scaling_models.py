@@ -0,0 +1,118 @@
+"""Benchmark models for scaling studies.
+
+Each builder returns the objects expected by `lbann.contrib.launcher.run`
+for a model trained on synthetic data, so that runs measure the
+model and the runtime rather than the file system. Every epoch has
+the same number of mini-batch steps regardless of the node count.
+
+"""
+import os
+import sys
+
+import lbann
+import lbann.models
+
+# CosmoFlow lives with its application
+_cosmoflow_dir = os.path.join(
+    os.path.dirname(os.path.dirname(os.path.dirname(
+        os.path.realpath(__file__)))),
+    'physics', 'cosmology', 'cosmoflow')
+
+
+def make_synthetic_reader(num_samples,
+                          sample_dims,
+                          num_labels=0,
+                          response_dims=(1,)):
+    """Synthetic training data reader."""
+    reader = lbann.reader_pb2.Reader(
+        name='synthetic',
+        role='train',
+        shuffle=True,
+        validation_fraction=0,
+        fraction_of_data_to_use=1.0,
+        absolute_sample_count=0,
+        num_samples=num_samples,
+        synth_dimensions=' '.join(str(d) for d in sample_dims),
+    )
+    if num_labels:
+        reader.num_labels = num_labels
+    else:
+        reader.synth_response_dimensions = ' '.join(
+            str(d) for d in response_dims)
+    return lbann.reader_pb2.DataReader(reader=[reader])
+
+
+def _make_model(layers, obj, num_epochs, name):
+    # The timer callback reports the mini-batch time statistics that
+    # throughput is computed from
+    callbacks = [lbann.CallbackPrint(), lbann.CallbackTimer()]
+    return lbann.Model(num_epochs,
+                       layers=layers,
+                       objective_function=obj,
+                       callbacks=callbacks,
+                       name=name)
+
+
+def resnet50(num_epochs):
+    """ResNet-50 on 224x224 ImageNet-sized images."""
+    images = lbann.Input(data_field='samples')
+    labels = lbann.Input(data_field='labels')
+    x = lbann.models.ResNet50(1000)(images)
+    probs = lbann.Softmax(x)
+    cross_entropy = lbann.CrossEntropy(probs, labels)
+    layers = list(lbann.traverse_layer_graph([images, labels]))
+    model = _make_model(layers, cross_entropy, num_epochs, 'resnet50')
+    optimizer = lbann.SGD(learn_rate=0.1, momentum=0.9)
+    reader = lambda num_samples: make_synthetic_reader(
+        num_samples, (3, 224, 224), num_labels=1000)
+    return model, optimizer, reader
+
+
+def transformer(num_epochs, sequence_length=256, embed_dim=512):
+    """Encoder-decoder transformer on random embedded sequences."""
+    samples = lbann.Input(data_field='samples')
+    seqs = lbann.Slice(samples,
+                       axis=0,
+                       slice_points=[0, sequence_length, 2 * sequence_length])
+    source = lbann.Identity(seqs)
+    target = lbann.Identity(seqs)
+    x = lbann.models.Transformer(hidden_size=embed_dim,
+                                 num_heads=8,
+                                 num_encoder_layers=6,
+                                 num_decoder_layers=6)(source, target,
+                                                       sequence_length)
+    obj = lbann.L2Norm2(x)
+    layers = list(lbann.traverse_layer_graph(samples))
+    model = _make_model(layers, obj, num_epochs, 'transformer')
+    optimizer = lbann.Adam(learn_rate=1e-4, beta1=0.9, beta2=0.98, eps=1e-9)
+    reader = lambda num_samples: make_synthetic_reader(
+        num_samples, (2 * sequence_length, embed_dim))
+    return model, optimizer, reader
+
+
+def cosmoflow(num_epochs, input_width=128, input_channels=4, num_secrets=4):
+    """CosmoFlow on 128^3 universes."""
+    sys.path.insert(0, _cosmoflow_dir)
+    import cosmoflow_network_architectures
+    universes = lbann.Input(data_field='samples')
+    secrets = lbann.Input(data_field='responses')
+    preds = cosmoflow_network_architectures.CosmoFlow(
+        input_width=input_width, output_size=num_secrets,
+        use_bn=True)(universes)
+    mse = lbann.MeanSquaredError([preds, secrets])
+    layers = list(lbann.traverse_layer_graph([universes, secrets]))
+    model = _make_model(layers, mse, num_epochs, 'cosmoflow')
+    optimizer = lbann.Adam(learn_rate=1e-3, beta1=0.9, beta2=0.99, eps=1e-8)
+    reader = lambda num_samples: make_synthetic_reader(
+        num_samples,
+        (input_channels, input_width, input_width, input_width),
+        response_dims=(num_secrets,))
+    return model, optimizer, reader
+
+
+# Builders and default mini-batch size per node
+models = {
+    'resnet50': (resnet50, 256),
+    'transformer': (transformer, 64),
+    'cosmoflow': (cosmoflow, 8),
+}
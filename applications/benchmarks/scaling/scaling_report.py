@@ -0,0 +1,139 @@
+"""Build scaling efficiency tables from a finished sweep.
+
+Reads the manifest written by `run_scaling.py`, parses each run's
+output log for mini-batch times and the training algorithm's timer
+breakdown, and prints weak- and strong-scaling tables. Efficiency at
+N nodes is throughput(N) / (N/N0 * throughput(N0)), where N0 is the
+smallest node count of the sweep. With `--min-efficiency`, the exit
+status is nonzero if any run falls below it, so the report can serve
+as an acceptance gate.
+
+"""
+import argparse
+import csv
+import json
+import os
+import re
+import sys
+
+_mini_batch_time_re = re.compile(
+    r'training epoch ([0-9]+) mini-batch time statistics : '
+    r'([0-9.e+-]+)s mean')
+_timer_row_re = re.compile(
+    r'^(\s*)(.*?)\s*\|\s*([0-9]+)\s*\|\s*([0-9.e+-]+)\s*\|'
+    r'\s*([0-9.e+-]+)\s*\|')
+
+
+def parse_log(path):
+    """Mean mini-batch time after the first epoch and per-phase means.
+
+    Returns:
+        (float, dict): Mean mini-batch time in seconds (None if
+        unavailable), and mean time per step of each timer scope in
+        the training algorithm's breakdown.
+
+    """
+    epoch_times = {}
+    phases = {}
+    in_training_timer = False
+    with open(path) as f:
+        for line in f:
+            match = _mini_batch_time_re.search(line)
+            if match:
+                epoch_times[int(match.group(1))] = float(match.group(2))
+                continue
+            if line.startswith('Timer:'):
+                in_training_timer = False
+                continue
+            match = _timer_row_re.match(line)
+            if match:
+                label = match.group(2)
+                if label == 'train()':
+                    in_training_timer = True
+                if in_training_timer:
+                    phases[label] = float(match.group(5))
+    # The first epoch is usually an outlier
+    times = [t for e, t in sorted(epoch_times.items()) if e > 0]
+    if not times:
+        times = list(epoch_times.values())
+    mini_batch_time = sum(times) / len(times) if times else None
+    return mini_batch_time, phases
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('sweep_dir', help='directory of the sweep')
+    parser.add_argument(
+        '--csv', action='store', default=None, type=str,
+        help='also write the tables to a CSV file')
+    parser.add_argument(
+        '--min-efficiency', action='store', default=None, type=float,
+        help='fail if any efficiency is below this fraction')
+    args = parser.parse_args()
+
+    with open(os.path.join(args.sweep_dir, 'manifest.json')) as f:
+        runs = json.load(f)['runs']
+
+    rows = []
+    for run in runs:
+        log = os.path.join(run['work_dir'], 'out.log')
+        mini_batch_time, phases = (parse_log(log) if os.path.exists(log)
+                                   else (None, {}))
+        throughput = (run['mini_batch_size'] / mini_batch_time
+                      if mini_batch_time else None)
+        rows.append(dict(run, mini_batch_time=mini_batch_time,
+                         throughput=throughput, phases=phases))
+
+    # Efficiency relative to the smallest node count of each series
+    failed = False
+    phase_names = []
+    for key in sorted({(r['model'], r['scaling']) for r in rows}):
+        series = sorted((r for r in rows
+                         if (r['model'], r['scaling']) == key),
+                        key=lambda r: r['nodes'])
+        base = series[0]
+        print(f'\n{key[0]} {key[1]} scaling')
+        print(f'{"nodes":>6} {"mbs":>6} {"step (s)":>10} '
+              f'{"samples/s":>12} {"efficiency":>10}')
+        for r in series:
+            r['efficiency'] = None
+            if r['throughput'] and base['throughput']:
+                ideal = base['throughput'] * r['nodes'] / base['nodes']
+                r['efficiency'] = r['throughput'] / ideal
+            if r['efficiency'] is None:
+                print(f'{r["nodes"]:>6} {r["mini_batch_size"]:>6} '
+                      f'{"missing":>10}')
+                failed |= args.min_efficiency is not None
+                continue
+            print(f'{r["nodes"]:>6} {r["mini_batch_size"]:>6} '
+                  f'{r["mini_batch_time"]:>10.4f} '
+                  f'{r["throughput"]:>12.1f} {r["efficiency"]:>10.3f}')
+            if (args.min_efficiency is not None
+                    and r['efficiency'] < args.min_efficiency):
+                failed = True
+            for phase in r['phases']:
+                if phase not in phase_names:
+                    phase_names.append(phase)
+
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            writer = csv.writer(f)
+            writer.writerow(['model', 'scaling', 'nodes', 'mini_batch_size',
+                             'mini_batch_time_s', 'samples_per_s',
+                             'efficiency']
+                            + [f'{p} mean_s' for p in phase_names])
+            for r in rows:
+                writer.writerow(
+                    [r['model'], r['scaling'], r['nodes'],
+                     r['mini_batch_size'], r['mini_batch_time'],
+                     r['throughput'], r['efficiency']]
+                    + [r['phases'].get(p) for p in phase_names])
+
+    if failed:
+        print(f'\nFAILED: efficiency below {args.min_efficiency} '
+              'or missing results')
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
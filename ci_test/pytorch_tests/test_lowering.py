@@ -47,3 +47,48 @@ def test_swish():
         extra_callbacks=[lbann.CallbackPrintModelDescription()])
 
     assert torch.allclose(ref, torch.tensor(out))
+
+
+def test_gelu():
+    """
+    Exact GELU lowers to one chain of element-wise operators.
+    """
+    torch.manual_seed(20230620)
+
+    mod = nn.Sequential(nn.GELU())
+    inp = torch.randn(1, 20)
+    ref = mod(inp)
+
+    g = lbann.torch.compile(mod, input=inp)
+    assert any(isinstance(l, lbann.Erf) for l in g)
+
+    out = lbann.evaluate(g, inp.detach().numpy())
+    assert torch.allclose(ref, torch.tensor(out), atol=1e-6)
+
+
+def test_fused_attention():
+    """
+    Multi-head attention lowers to the fused attention layer.
+    """
+    torch.manual_seed(20230620)
+
+    class testmodule(nn.Module):
+
+        def __init__(self):
+            super().__init__()
+            self.mha = nn.MultiheadAttention(16, 4, batch_first=True)
+
+        def forward(self, input):
+            output, _ = self.mha(input, input, input, need_weights=False)
+            return output
+
+    mod = testmodule()
+    inp = torch.randn(1, 8, 16)
+    ref = mod(inp)
+
+    g = lbann.torch.compile(mod, input=inp)
+    assert any(isinstance(l, lbann.ScaledDotProductAttention) for l in g)
+
+    out = lbann.evaluate(g, inp.detach().numpy())
+    assert torch.allclose(ref, torch.tensor(out).reshape(ref.shape),
+                          atol=1e-5)
@@ -0,0 +1,157 @@
+import os
+import os.path
+import sys
+import numpy as np
+from lbann.util.columnar import SparseColumn, write_columnar
+
+# Bamboo utilities
+current_file = os.path.realpath(__file__)
+current_dir = os.path.dirname(current_file)
+sys.path.insert(0, os.path.join(os.path.dirname(current_dir), 'common_python'))
+import tools
+
+# ==============================================
+# Data
+# ==============================================
+
+# Two dense datum columns, one raw and one compressed, a sparse
+# column of weighted edges, plus a column that the experiment schema
+# leaves out
+np.random.seed(20240611)
+_num_samples = 29
+_chunk_size = 8
+_edge_capacity = 6
+_num_edges = np.random.randint(0, _edge_capacity + 1, size=_num_samples)
+_columns = {
+    'x': np.random.normal(size=(_num_samples, 3, 2)).astype(np.float32),
+    'y': np.random.randint(-100, 100, size=(_num_samples, 5)).astype(np.int16),
+    'edges': SparseColumn(
+        [np.random.randint(0, 10, size=(n, 2)) for n in _num_edges],
+        [np.random.normal(size=n).astype(np.float32) for n in _num_edges]),
+    'unused': np.zeros((_num_samples, 4), dtype=np.float64),
+}
+_scale_y = 0.25
+
+_experiment_schema = f"""
+x:
+  pack: datum
+y:
+  pack: datum
+  scale: {_scale_y}
+edges:
+  pack: datum
+  capacity: {_edge_capacity}
+"""
+
+def get_sample(index):
+    # Sparse entries are packed as all source indices, all target
+    # indices, then all values, with unused entries set to -1 and 0
+    edges = _columns['edges']
+    num_edges = _num_edges[index]
+    coords = np.full((2, _edge_capacity), -1.0)
+    coords[:, :num_edges] = edges.indices[index].T
+    values = np.zeros(_edge_capacity)
+    values[:num_edges] = edges.values[index]
+    return np.concatenate([_columns['x'][index].flatten(),
+                           _columns['y'][index] * _scale_y,
+                           coords.flatten(),
+                           values])
+
+# ==============================================
+# Setup LBANN experiment
+# ==============================================
+
+def setup_experiment(lbann, weekly):
+    """Construct LBANN experiment.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    mini_batch_size = _num_samples // 4
+    trainer = lbann.Trainer(mini_batch_size)
+    model = construct_model(lbann)
+    data_reader = construct_data_reader(lbann)
+    optimizer = lbann.NoOptimizer()
+    return trainer, model, data_reader, optimizer, None # Don't request any specific number of nodes
+
+def construct_model(lbann):
+    """Construct LBANN model.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Layer graph
+    x = lbann.Input(data_field='samples')
+    y = lbann.L2Norm2(x)
+    layers = list(lbann.traverse_layer_graph(x))
+    metric = lbann.Metric(y, name='obj')
+    callbacks = []
+
+    # Compute expected value with NumPy
+    vals = []
+    for i in range(_num_samples):
+        x = get_sample(i).astype(np.float64)
+        y = tools.numpy_l2norm2(x)
+        vals.append(y)
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metric.name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
+    # Construct model
+    num_epochs = 0
+    return lbann.Model(num_epochs,
+                       layers=layers,
+                       metrics=[metric],
+                       callbacks=callbacks)
+
+def construct_data_reader(lbann):
+    """Construct Protobuf message for the columnar data reader.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    data_file = os.path.join(work_dir, 'data.lbcol')
+    schema_file = os.path.join(work_dir, 'experiment_schema.yaml')
+    write_columnar(data_file,
+                   _columns,
+                   chunk_size=_chunk_size,
+                   compression={'y': 'zlib', 'edges': 'zlib'})
+    with open(schema_file, 'w') as f:
+        f.write(_experiment_schema)
+
+    # Note: The training data reader should be removed when
+    # https://github.com/LLNL/lbann/issues/1098 is resolved.
+    message = lbann.reader_pb2.DataReader()
+    for role in ('train', 'test'):
+        reader = message.reader.add()
+        reader.name = 'columnar'
+        reader.role = role
+        reader.shuffle = False
+        reader.fraction_of_data_to_use = 1.0
+        reader.data_filedir = work_dir
+        reader.data_filename = 'data.lbcol'
+        reader.experiment_schema_filename = schema_file
+    return message
+
+# ==============================================
+# Setup PyTest
+# ==============================================
+
+work_dir = os.path.join(os.path.dirname(__file__),
+                        'experiments',
+                        os.path.basename(__file__).split('.py')[0])
+os.makedirs(work_dir, exist_ok=True)
+
+# Create test functions that can interact with PyTest
+for _test_func in tools.create_tests(setup_experiment, __file__, work_dir=work_dir):
+    globals()[_test_func.__name__] = _test_func
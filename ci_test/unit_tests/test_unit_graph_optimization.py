@@ -0,0 +1,239 @@
+"""Tests for the layer graph passes in lbann.core.graph_optimization.
+
+These only rewrite Python layer objects, so no LBANN executable is
+needed.
+
+"""
+import math
+
+import pytest
+import lbann
+from lbann.core.graph_optimization import optimize_graph
+
+
+def _types(layers):
+    return [type(l).__name__ for l in layers]
+
+
+def _ops(l):
+    return [type(op).__name__ for op in l.ops]
+
+
+# ==============================================
+# Identity removal
+# ==============================================
+
+def test_identity_is_bypassed():
+    x = lbann.Input(data_field='samples')
+    y = lbann.Identity(x)
+    z = lbann.Relu(y)
+    layers = optimize_graph([x], outputs=[z])
+    assert 'Identity' not in _types(layers)
+    assert z.parents == [x]
+    assert x.children == [z]
+
+
+def test_identity_permute_is_bypassed():
+    x = lbann.Input(data_field='samples')
+    y = lbann.TensorPermute(x, axes=[0, 1, 2])
+    z = lbann.Relu(y)
+    layers = optimize_graph([x], outputs=[z])
+    assert 'TensorPermute' not in _types(layers)
+    assert z.parents == [x]
+
+
+def test_observable_identities_are_kept():
+    x = lbann.Input(data_field='samples')
+    out = lbann.Identity(x, name='out')
+    named = lbann.Identity(x, name='named')
+    z = lbann.Relu(named)
+    moved = lbann.Identity(x, device='CPU')
+    w = lbann.Relu(moved)
+    layers = optimize_graph([x],
+                            outputs=[out, z, w],
+                            keep_names=['named'])
+    assert out in layers
+    assert named in layers
+    assert moved in layers
+
+
+# ==============================================
+# Reshape and permute chains
+# ==============================================
+
+def test_reshape_chain_is_collapsed():
+    x = lbann.Input(data_field='samples')
+    r1 = lbann.Reshape(x, dims=[4, 4])
+    r2 = lbann.Reshape(r1, dims=[16])
+    z = lbann.Relu(r2)
+    layers = optimize_graph([x], outputs=[z])
+    assert _types(layers).count('Reshape') == 1
+    assert r1 not in layers
+    assert r2.parents == [x]
+
+
+def test_permute_chain_is_composed():
+    x = lbann.Input(data_field='samples')
+    p1 = lbann.TensorPermute(x, axes=[1, 2, 0])
+    p2 = lbann.TensorPermute(p1, axes=[1, 0, 2])
+    z = lbann.Relu(p2)
+    layers = optimize_graph([x], outputs=[z])
+    assert p1 not in layers
+    assert p2.parents == [x]
+    assert list(p2.axes) == [2, 1, 0]
+
+
+def test_reshape_with_two_children_is_kept():
+    x = lbann.Input(data_field='samples')
+    r1 = lbann.Reshape(x, dims=[4, 4])
+    r2 = lbann.Reshape(r1, dims=[16])
+    z1 = lbann.Relu(r2)
+    z2 = lbann.Relu(r1)
+    layers = optimize_graph([x], outputs=[z1, z2])
+    assert r1 in layers
+    assert r2 in layers
+
+
+# ==============================================
+# Constant folding
+# ==============================================
+
+def test_reshape_of_constant_is_folded():
+    x = lbann.Input(data_field='samples')
+    c = lbann.Constant(value=1.5, num_neurons=[2, 3])
+    r = lbann.Reshape(c, dims=[-1])
+    z = lbann.Relu(lbann.Add(x, r))
+    layers = optimize_graph([x], outputs=[z])
+    assert 'Constant' not in _types(layers)
+    assert 'Reshape' not in _types(layers)
+    (add,) = z.parents
+    assert _ops(add) == ['AddConstant']
+    assert add.ops[0].constant == pytest.approx(1.5)
+    assert add.parents == [x]
+
+
+def test_unary_operators_on_constant_are_folded():
+    x = lbann.Input(data_field='samples')
+    c = lbann.Constant(value=2.0, num_neurons=[4])
+    z = lbann.Relu(lbann.Multiply(x, lbann.Sqrt(lbann.Exp(c))))
+    layers = optimize_graph([x], outputs=[z])
+    assert 'Constant' not in _types(layers)
+    (scale,) = z.parents
+    assert _ops(scale) == ['Scale']
+    assert scale.ops[0].constant == pytest.approx(math.e)
+
+
+def test_domain_errors_are_not_folded():
+    x = lbann.Input(data_field='samples')
+    c = lbann.Constant(value=-1.0, num_neurons=[4])
+    log = lbann.Log(c)
+    z = lbann.Relu(lbann.Add(x, log))
+    layers = optimize_graph([x], outputs=[z])
+    assert c in layers
+    assert log in layers
+
+
+def test_arithmetic_between_constants_is_folded():
+    x = lbann.Input(data_field='samples')
+    a = lbann.Constant(value=5.0, num_neurons=[4])
+    b = lbann.Constant(value=3.0, num_neurons=[4])
+    z = lbann.Relu(lbann.Multiply(x, lbann.Subtract(a, b)))
+    layers = optimize_graph([x], outputs=[z])
+    assert 'Constant' not in _types(layers)
+    (scale,) = z.parents
+    assert _ops(scale) == ['Scale']
+    assert scale.ops[0].constant == pytest.approx(2.0)
+
+
+@pytest.mark.parametrize('op, tensor_first, expected, constant', [
+    ('Subtract', True, 'SubtractConstant', 4.0),
+    ('Subtract', False, 'ConstantSubtract', 4.0),
+    ('Divide', True, 'Scale', 0.25),
+    ('Multiply', False, 'Scale', 4.0),
+])
+def test_arithmetic_with_constant_is_folded(op, tensor_first, expected,
+                                            constant):
+    x = lbann.Input(data_field='samples')
+    c = lbann.Constant(value=4.0, num_neurons=[4])
+    args = (x, c) if tensor_first else (c, x)
+    z = lbann.Relu(getattr(lbann, op)(*args))
+    layers = optimize_graph([x], outputs=[z])
+    assert 'Constant' not in _types(layers)
+    (folded,) = z.parents
+    assert _ops(folded) == [expected]
+    assert folded.ops[0].constant == pytest.approx(constant)
+    assert folded.parents == [x]
+
+
+def test_constant_divided_by_tensor_is_kept():
+    x = lbann.Input(data_field='samples')
+    c = lbann.Constant(value=4.0, num_neurons=[4])
+    div = lbann.Divide(c, x)
+    z = lbann.Relu(div)
+    layers = optimize_graph([x], outputs=[z])
+    assert c in layers
+    assert div in layers
+
+
+# ==============================================
+# Element-wise chains
+# ==============================================
+
+def test_elementwise_chain_is_grouped():
+    x = lbann.Input(data_field='samples')
+    e = lbann.Exp(x)
+    s = lbann.Sin(e)
+    t = lbann.Tanh(s)
+    z = lbann.Relu(t)
+    layers = optimize_graph([x], outputs=[z])
+    assert e in layers
+    assert s not in layers
+    assert t not in layers
+    assert _ops(e) == ['Exp', 'Sin', 'Tanh']
+    assert z.parents == [e]
+
+
+def test_elementwise_chain_stops_at_placement_change():
+    x = lbann.Input(data_field='samples')
+    e = lbann.Exp(x)
+    s = lbann.Sin(e, device='CPU')
+    z = lbann.Relu(s)
+    layers = optimize_graph([x], outputs=[z])
+    assert _ops(e) == ['Exp']
+    assert s in layers
+
+
+# ==============================================
+# Dead layer removal
+# ==============================================
+
+def test_dead_layers_are_removed():
+    x = lbann.Input(data_field='samples')
+    z = lbann.Relu(x)
+    dead = lbann.Sigmoid(lbann.Relu(x))
+    kept = lbann.Tanh(x, name='kept')
+    layers = optimize_graph([x], outputs=[z], keep_names=['kept'])
+    assert dead not in layers
+    assert kept in layers
+    assert set(x.children) == {z, kept}
+
+
+def test_slice_children_are_kept():
+    x = lbann.Input(data_field='samples')
+    s = lbann.Slice(x, slice_points=[0, 2, 4])
+    z = lbann.Relu(s)
+    unused = lbann.Relu(s)
+    layers = optimize_graph([x], outputs=[z])
+    assert unused in layers
+    assert s.children == [z, unused]
+
+
+def test_result_is_in_topological_order():
+    x = lbann.Input(data_field='samples')
+    y = lbann.Identity(x)
+    z = lbann.Relu(lbann.Exp(y))
+    layers = optimize_graph([z], outputs=[z])
+    position = {l: i for i, l in enumerate(layers)}
+    for l in layers:
+        for p in l.parents:
+            assert position[p] < position[l]
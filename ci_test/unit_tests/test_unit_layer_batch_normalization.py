@@ -116,6 +116,23 @@ def construct_model(lbann):
     obj.append(z)
     metrics.append(lbann.Metric(z, name='global statistics'))
 
+    # ------------------------------------------
+    # Channels-last layout
+    # ------------------------------------------
+
+    # LBANN implementation
+    decay = 0.9
+    epsilon = 1e-5
+    x = x_lbann
+    y = lbann.BatchNormalization(x,
+                                 decay=decay,
+                                 epsilon=epsilon,
+                                 channels_last=True,
+                                 data_layout='data_parallel')
+    z = lbann.L2Norm2(y)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='channels-last'))
+
     # ------------------------------------------
     # Gradient checking
     # ------------------------------------------
@@ -0,0 +1,239 @@
+import functools
+import operator
+import os
+import os.path
+import sys
+import numpy as np
+import pytest
+import lbann.contrib.args
+
+# Bamboo utilities
+current_file = os.path.realpath(__file__)
+current_dir = os.path.dirname(current_file)
+sys.path.insert(0, os.path.join(os.path.dirname(current_dir), 'common_python'))
+import tools
+
+# ==============================================
+# Objects for Python data reader
+# ==============================================
+# Note: The Python data reader imports this file as a module and calls
+# the functions below to ingest data.
+
+# Data
+np.random.seed(20200113)
+_num_samples = 17
+_sample_dims = (8, 1, 4)
+_sample_size = functools.reduce(operator.mul, _sample_dims)
+_samples = np.random.normal(size=(_num_samples, _sample_size)).astype(np.float32)
+
+# Sample access functions
+def get_sample(index):
+    return _samples[index, :]
+
+
+def num_samples():
+    return _num_samples
+
+
+def sample_dims():
+    return (_sample_size,)
+
+
+# ==============================================
+# Setup LBANN experiment
+# ==============================================
+
+def setup_experiment(lbann, weekly):
+    """Construct LBANN experiment.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    if not lbann.has_feature('DISTCONV'):
+        message = f'{os.path.basename(__file__)} requires DISTCONV'
+        print('Skip - ' + message)
+        pytest.skip(message)   
+    
+    mini_batch_size = num_samples() // 2
+    trainer = lbann.Trainer(mini_batch_size)
+    model = construct_model(lbann)
+    data_reader = construct_data_reader(lbann)
+    optimizer = lbann.NoOptimizer()
+    return trainer, model, data_reader, optimizer, None # Don't request any specific number of nodes
+
+
+def create_parallel_strategy(num_channel_groups, num_width_groups):
+    return {"channel_groups": num_channel_groups,
+            "filter_groups": num_channel_groups,
+            "width_groups": num_width_groups}
+
+
+def construct_model(lbann):
+    """Construct LBANN model.
+
+    A column-parallel layer feeds a row-parallel layer, as in the
+    feed-forward block of a transformer.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Input data
+    # Note: Sum with a weights layer so that gradient checking will
+    # verify that error signals are correct.
+    x_weights = lbann.Weights(optimizer=lbann.SGD(),
+                              initializer=lbann.ConstantInitializer(value=0.0),
+                              name='input_weights')
+    x0 = lbann.WeightsLayer(weights=x_weights,
+                            dims=_sample_dims)
+    x1 = lbann.Reshape(lbann.Input(data_field='samples'), dims=_sample_dims)
+    x_lbann = lbann.Sum(x0, x1)
+
+    # Objects for LBANN model
+    obj = []
+    metrics = []
+    callbacks = []
+
+    num_gpus = tools.gpus_per_node(lbann)
+    if num_gpus < 2 or num_gpus % 2 != 0:
+        e = 'this test requires an even number of GPUs.'
+        print('Skip - ' + e)
+        pytest.skip(e)
+    num_width_groups = 2
+    num_channel_groups = num_gpus // num_width_groups
+
+    # ------------------------------------------
+    # Compute expected metric values with NumPy
+    # ------------------------------------------
+
+    input_channel_dims = _sample_dims[1:]
+    hidden_channel_dims = (1, 6)
+    output_channel_dims = (1, 4)
+    input_channel_size = functools.reduce(operator.mul, input_channel_dims)
+    hidden_channel_size = functools.reduce(operator.mul, hidden_channel_dims)
+    output_channel_size = functools.reduce(operator.mul, output_channel_dims)
+
+    linearity1 = np.random.normal(
+        size=(hidden_channel_size, input_channel_size)
+    ).astype(np.float32)
+    bias1 = np.random.normal(size=(hidden_channel_size, 1)).astype(np.float32)
+    linearity2 = np.random.normal(
+        size=(output_channel_size, hidden_channel_size)
+    ).astype(np.float32)
+    bias2 = np.random.normal(size=(output_channel_size, 1)).astype(np.float32)
+
+    x = (_samples
+         .reshape((-1, input_channel_size))
+         .transpose()
+         .astype(np.float64))
+    y = np.matmul(linearity1.astype(np.float64), x) + bias1.astype(np.float64)
+    y = np.matmul(linearity2.astype(np.float64), y) + bias2.astype(np.float64)
+    z = tools.numpy_l2norm2(y) / _num_samples
+    val = z
+
+    # ------------------------------------------
+    # Column-parallel followed by row-parallel
+    # ------------------------------------------
+
+    # LBANN implementation
+    def make_weights(values, order='C'):
+        return lbann.Weights(
+            optimizer=lbann.SGD(),
+            initializer=lbann.ValueInitializer(
+                values=np.nditer(values, order=order)
+            )
+        )
+    parallel_strategy = create_parallel_strategy(num_channel_groups,
+                                                 num_width_groups)
+    y = lbann.ChannelwiseFullyConnected(
+        x_lbann,
+        weights=(make_weights(linearity1, 'F'), make_weights(bias1)),
+        output_channel_dims=hidden_channel_dims,
+        tensor_parallelism='column',
+        parallel_strategy=parallel_strategy,
+        name="column_parallel"
+    )
+    y = lbann.ChannelwiseFullyConnected(
+        y,
+        weights=(make_weights(linearity2, 'F'), make_weights(bias2)),
+        output_channel_dims=output_channel_dims,
+        tensor_parallelism='row',
+        parallel_strategy=parallel_strategy,
+        name="row_parallel"
+    )
+    z = lbann.L2Norm2(y)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='column then row parallel'))
+
+    # NumPy implementation
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val - tol,
+        upper_bound=val + tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
+    # ------------------------------------------
+    # Gradient checking
+    # ------------------------------------------
+
+    callbacks.append(lbann.CallbackCheckGradients(error_on_failure=True))
+
+    # ------------------------------------------
+    # Construct model
+    # ------------------------------------------
+
+    num_epochs = 1
+    return lbann.Model(num_epochs,
+                       layers=lbann.traverse_layer_graph(x_lbann),
+                       objective_function=obj,
+                       metrics=metrics,
+                       callbacks=callbacks)
+
+
+def construct_data_reader(lbann):
+    """Construct Protobuf message for Python data reader.
+
+    The Python data reader will import the current Python file to
+    access the sample access functions.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Note: The training data reader should be removed when
+    # https://github.com/LLNL/lbann/issues/1098 is resolved.
+    message = lbann.reader_pb2.DataReader()
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'train'
+        )
+    ])
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'test'
+        )
+    ])
+    return message
+
+# ==============================================
+# Setup PyTest
+# ==============================================
+
+# Create test functions that can interact with PyTest
+for _test_func in tools.create_tests(setup_experiment, __file__, environment=lbann.contrib.args.get_distconv_environment()):
+    globals()[_test_func.__name__] = _test_func
@@ -164,6 +164,42 @@ def construct_model(lbann):
         error_on_failure=True,
         execution_modes='test'))
 
+    # ------------------------------------------
+    # Data-parallel layout (logits)
+    # ------------------------------------------
+
+    # LBANN implementation
+    logits_shape = [NUM_CHANNELS, SAMPLE_SPATIAL_SIZE]
+    x0 = lbann.Reshape(x0_lbann, dims=logits_shape)
+    x1 = lbann.Reshape(x1_lbann, dims=logits_shape)
+    y = lbann.CrossEntropy(x0, x1, data_layout='data_parallel',
+                           from_logits=True)
+    y = lbann.Scale(y, constant=RESCALE_CONST)
+    z = lbann.L2Norm2(y)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='data-parallel layout logits'))
+
+    # NumPy implementation
+    vals = []
+    for i in range(num_samples()):
+        x = get_sample(i).astype(np.float64)
+        x0 = x[:slice_size].reshape(logits_shape)
+        x1 = x[slice_size:2 * slice_size].reshape(logits_shape)
+        x0_max = np.max(x0, axis=-1, keepdims=True)
+        log_softmax = x0 - x0_max - np.log(
+            np.sum(np.exp(x0 - x0_max), axis=-1, keepdims=True))
+        y = -np.sum(x1 * log_softmax) * RESCALE_CONST
+        z = tools.numpy_l2norm2(y)
+        vals.append(z)
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
     # ------------------------------------------
     # Data-parallel layout (2D labels-only)
     # ------------------------------------------
@@ -140,6 +140,35 @@ def construct_model(lbann):
         error_on_failure=True,
         execution_modes='test'))
 
+    # ------------------------------------------
+    # Data-parallel layout, vectorized rows
+    # ------------------------------------------
+    # Note: Tile the input so that rows are a multiple of 4 entries.
+
+    # LBANN implementation
+    x = x_lbann
+    x = lbann.Concatenation([x, x, x, x])
+    y = lbann.LayerNorm(x, data_layout='data_parallel')
+    z = lbann.L2Norm2(y)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='vectorized rows'))
+
+    # NumPy implementation
+    vals = []
+    for i in range(num_samples()):
+        x = np.tile(get_sample(i).astype(np.float64), 4)
+        y = numpy_layer_norm(x)
+        z = tools.numpy_l2norm2(y)
+        vals.append(z)
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
     # ------------------------------------------
     # Gradient checking
     # ------------------------------------------
@@ -0,0 +1,206 @@
+import functools
+import operator
+import os
+import os.path
+import sys
+import numpy as np
+
+# Bamboo utilities
+current_file = os.path.realpath(__file__)
+current_dir = os.path.dirname(current_file)
+sys.path.insert(0, os.path.join(os.path.dirname(current_dir), 'common_python'))
+import tools
+
+# ==============================================
+# Objects for Python data reader
+# ==============================================
+# Note: The Python data reader imports this file as a module and calls
+# the functions below to ingest data.
+
+# Data
+np.random.seed(20231012)
+_num_queries = 7
+_num_keys = 5
+_embed_dim = 8
+_value_dim = 6
+_num_heads = 2
+_q_size = _num_queries * _embed_dim
+_k_size = _num_keys * _embed_dim
+_v_size = _num_keys * _value_dim
+_samples = np.random.normal(
+    size=(23, _q_size+_k_size+_v_size)).astype(np.float32)
+
+# Sample access functions
+def get_sample(index):
+    return _samples[index].reshape(-1)
+def num_samples():
+    return _samples.shape[0]
+def sample_dims():
+    return (_samples.shape[-1],)
+
+# ==============================================
+# NumPy implementation
+# ==============================================
+
+def numpy_attention(q, k, v, num_heads, causal):
+    """Multi-head scaled dot-product attention.
+
+    Inputs are sequences of vectors with shapes (num_queries x
+    embed_dim), (num_keys x embed_dim), and (num_keys x value_dim).
+
+    """
+    q_head_size = q.shape[1] // num_heads
+    v_head_size = v.shape[1] // num_heads
+    y = np.zeros((q.shape[0], v.shape[1]), dtype=np.float64)
+    for h in range(num_heads):
+        qh = q[:, h*q_head_size:(h+1)*q_head_size]
+        kh = k[:, h*q_head_size:(h+1)*q_head_size]
+        vh = v[:, h*v_head_size:(h+1)*v_head_size]
+        s = np.matmul(qh, kh.transpose()) / np.sqrt(q_head_size)
+        if causal:
+            s = s + np.triu(np.full(s.shape, -np.inf), k=1)
+        s = s - np.max(s, axis=1, keepdims=True)
+        p = np.exp(s)
+        p = p / np.sum(p, axis=1, keepdims=True)
+        y[:, h*v_head_size:(h+1)*v_head_size] = np.matmul(p, vh)
+    return y
+
+# ==============================================
+# Setup LBANN experiment
+# ==============================================
+
+def setup_experiment(lbann, weekly):
+    """Construct LBANN experiment.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    mini_batch_size = num_samples() // 2
+    trainer = lbann.Trainer(mini_batch_size)
+    model = construct_model(lbann)
+    data_reader = construct_data_reader(lbann)
+    optimizer = lbann.NoOptimizer()
+    return trainer, model, data_reader, optimizer, None # Don't request any specific number of nodes
+
+def construct_model(lbann):
+    """Construct LBANN model.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Input data
+    # Note: Sum with weights layers so that gradient checking will
+    # verify that error signals are correct.
+    x_weights = lbann.Weights(optimizer=lbann.SGD(),
+                              initializer=lbann.ConstantInitializer(value=0.0),
+                              name='input_weights')
+    x = lbann.Sum(lbann.Input(data_field='samples'),
+                  lbann.WeightsLayer(weights=x_weights,
+                                     dims=[_q_size+_k_size+_v_size]))
+    x_slice = lbann.Slice(
+        x,
+        slice_points=[0, _q_size, _q_size+_k_size, _q_size+_k_size+_v_size])
+    q = lbann.Reshape(x_slice, dims=[_num_queries, _embed_dim])
+    k = lbann.Reshape(x_slice, dims=[_num_keys, _embed_dim])
+    v = lbann.Reshape(x_slice, dims=[_num_keys, _value_dim])
+    x_lbann = x
+
+    # Objects for LBANN model
+    obj = []
+    metrics = []
+    callbacks = []
+
+    for causal in (False, True):
+        name = 'causal' if causal else 'non-causal'
+
+        # LBANN implementation
+        y = lbann.ScaledDotProductAttention(q, k, v,
+                                            num_heads=_num_heads,
+                                            causal=causal,
+                                            data_layout='data_parallel')
+        z = lbann.L2Norm2(y)
+        obj.append(z)
+        metrics.append(lbann.Metric(z, name=name))
+
+        # NumPy implementation
+        vals = []
+        for i in range(num_samples()):
+            x = get_sample(i).astype(np.float64)
+            xq = x[:_q_size].reshape([_num_queries, _embed_dim])
+            xk = x[_q_size:_q_size+_k_size].reshape([_num_keys, _embed_dim])
+            xv = x[_q_size+_k_size:].reshape([_num_keys, _value_dim])
+            y = numpy_attention(xq, xk, xv, _num_heads, causal)
+            z = tools.numpy_l2norm2(y)
+            vals.append(z)
+        val = np.mean(vals)
+        tol = 8 * val * np.finfo(np.float32).eps
+        callbacks.append(lbann.CallbackCheckMetric(
+            metric=metrics[-1].name,
+            lower_bound=val-tol,
+            upper_bound=val+tol,
+            error_on_failure=True,
+            execution_modes='test'))
+
+    # ------------------------------------------
+    # Gradient checking
+    # ------------------------------------------
+
+    callbacks.append(lbann.CallbackCheckGradients(error_on_failure=True))
+
+    # ------------------------------------------
+    # Construct model
+    # ------------------------------------------
+
+    num_epochs = 0
+    return lbann.Model(num_epochs,
+                       layers=lbann.traverse_layer_graph(x_lbann),
+                       objective_function=obj,
+                       metrics=metrics,
+                       callbacks=callbacks)
+
+def construct_data_reader(lbann):
+    """Construct Protobuf message for Python data reader.
+
+    The Python data reader will import the current Python file to
+    access the sample access functions.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Note: The training data reader should be removed when
+    # https://github.com/LLNL/lbann/issues/1098 is resolved.
+    message = lbann.reader_pb2.DataReader()
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'train'
+        )
+    ])
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'test'
+        )
+    ])
+    return message
+
+# ==============================================
+# Setup PyTest
+# ==============================================
+
+# Create test functions that can interact with PyTest
+for _test_func in tools.create_tests(setup_experiment, __file__):
+    globals()[_test_func.__name__] = _test_func
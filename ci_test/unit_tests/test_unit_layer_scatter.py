@@ -227,6 +227,61 @@ def construct_model(lbann):
         vals.append(z)
     val = np.mean(vals)
     tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
+    ######################################################################
+    #
+    #          2D Values , 1D Input, Axis = 0, deterministic
+    #
+    ######################################################################
+
+    x0 = lbann.Reshape(x0_lbann, dims=[height, width])
+    x_resliced = lbann.Slice(x1_lbann, slice_points=[0, height, input_size])
+    x1 = lbann.Identity(x_resliced)
+
+    y0 = lbann.Scatter(x0, x1, dims=[output_size, width], axis=0,
+                       deterministic=True,
+                       name="Scatter_2D_axis_0_deterministic")
+
+    y1 = lbann.Concatenation([
+        lbann.Constant(value=i+1, num_neurons=[1])
+        for i in range(output_size * width)
+    ])
+
+    y1 = lbann.Reshape(y1, dims=[width * output_size])
+    y0 = lbann.Reshape(y0, dims=[width * output_size])
+
+    y = lbann.Multiply(y0, y1)
+
+    z = lbann.L2Norm2(y)
+
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='2D, axis=0, deterministic'))
+
+    vals = []
+
+    for i in range(num_samples()):
+        _x = get_sample(i)
+        x0 = np.array(_x[:input_size]).reshape((height, width))
+        x1 = _x[input_size:input_size + height]
+
+        y0 = np.zeros((output_size, width))
+
+        for i in range(height):
+            if 0 <= x1[i] < output_size:
+                for j in range(width):
+                    y0[int(x1[i])][j] += x0[i][j]
+        z = 0
+        for i in range(width * output_size):
+            z += ((i + 1) * y0.flatten()[i])**2
+        vals.append(z)
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
     callbacks.append(lbann.CallbackCheckMetric(
         metric=metrics[-1].name,
         lower_bound=val-tol,
@@ -0,0 +1,158 @@
+"""Tests for the parallel-strategy planner in lbann.util.parallel_planner.
+
+The planner only does arithmetic on measured costs, so no LBANN
+executable is needed.
+
+"""
+import csv
+
+import pytest
+from lbann.util import parallel_planner as planner
+
+
+def _layer(name, layer_type='convolution', time=1e-3,
+           output_dims=(16, 32, 32), weights_bytes=4096,
+           mini_batch_size=32):
+    sample_bytes = 4
+    for d in output_dims:
+        sample_bytes *= d
+    return planner.LayerProfile(name=name,
+                                type=layer_type,
+                                fp_time=time,
+                                bp_time=2 * time,
+                                mini_batch_size=mini_batch_size,
+                                output_dims=tuple(output_dims),
+                                activation_bytes=sample_bytes
+                                * mini_batch_size,
+                                weights_bytes=weights_bytes)
+
+
+def test_partition_stages_balances_times():
+    assert planner.partition_stages([1., 1., 1., 1.], 2) == [0, 2]
+    assert planner.partition_stages([3., 1., 1., 1.], 2) == [0, 1]
+    assert planner.partition_stages([1., 2., 3.], 1) == [0]
+    assert planner.partition_stages([1., 2., 3.], 3) == [0, 1, 2]
+
+
+def test_comm_model():
+    comm = planner.CommModel(latency=1e-6, bandwidth=1e9)
+    assert comm.send(1e3) == pytest.approx(2e-6)
+    assert comm.allreduce(1e3, 1) == 0.
+    assert comm.allgather(1e3, 1) == 0.
+    assert comm.allreduce(1e3, 2) == pytest.approx(2e-6 + 1e-6)
+    assert comm.allgather(1e3, 4) == pytest.approx(3e-6 + 0.75e-6)
+
+
+def test_layer_choices():
+    conv = _layer('conv', output_dims=(16, 32, 32))
+    choices = planner.layer_choices(conv, 4, 32)
+    assert planner.LayerChoice() in choices
+    assert planner.LayerChoice('spatial', 2) in choices
+    assert planner.LayerChoice('channel', 4) in choices
+
+    fc = _layer('fc', layer_type='fully connected', output_dims=(10,))
+    assert planner.layer_choices(fc, 4, 32) == [
+        planner.LayerChoice(), planner.LayerChoice('model', 4)]
+
+    # Two samples cannot keep four processes busy without splitting
+    # samples
+    assert planner.LayerChoice() not in planner.layer_choices(conv, 4, 2)
+    softmax = _layer('softmax', layer_type='softmax', output_dims=(10,))
+    assert planner.layer_choices(softmax, 4, 2) == []
+
+
+def test_layer_cost_scales_with_processes():
+    comm = planner.CommModel()
+    conv = _layer('conv')
+    one = planner.layer_cost(conv, planner.LayerChoice(), 1, 32, comm)
+    four = planner.layer_cost(conv, planner.LayerChoice(), 4, 32, comm)
+    assert one.time == pytest.approx(3e-3)
+    assert four.time == pytest.approx(3e-3 / 4)
+    assert one.allreduce_time == 0.
+    assert four.allreduce_time > 0.
+    assert four.memory < one.memory
+
+
+def test_plan_stage_avoids_needless_redistribution():
+    comm = planner.CommModel()
+    layers = [_layer(f'conv{i}') for i in range(3)]
+    stage = planner.plan_stage(layers, 1, 32, comm)
+    assert stage.choices == [planner.LayerChoice()] * 3
+    assert stage.time == pytest.approx(9e-3)
+
+
+def test_search_orders_and_filters_plans():
+    profile = [_layer(f'conv{i}') for i in range(4)]
+    plans = planner.search(profile, num_gpus=4, mini_batch_size=32,
+                           gpu_memory=2**34)
+    assert plans
+    times = [plan.step_time for plan in plans]
+    assert times == sorted(times)
+    for plan in plans:
+        assert plan.num_gpus == 4
+        assert plan.num_stages * plan.gpus_per_stage == 4
+        assert sorted(plan.assignments()) == [l.name for l in profile]
+        assert plan.throughput == pytest.approx(32 / plan.step_time)
+
+    # Nothing fits in a single byte
+    assert planner.search(profile, num_gpus=4, mini_batch_size=32,
+                          gpu_memory=1) == []
+
+
+def test_export_proto():
+    profile = [_layer(f'conv{i}') for i in range(4)]
+    plans = planner.search(profile, num_gpus=2, mini_batch_size=32,
+                           gpu_memory=2**34, micro_batches=[2],
+                           max_stages=2)
+    plan = next(p for p in plans if p.num_stages == 2)
+    proto = plan.export_proto()
+    assert proto.pipeline_parallelism
+    assert [l.name for l in proto.layer] == [l.name for l in profile]
+    assert [l.grid_tag.value for l in proto.layer] == [
+        stage + 1 for stage, _ in
+        (plan.assignments()[l.name] for l in profile)]
+
+
+def test_read_profiles(tmp_path):
+    layer_csv = tmp_path / 'layers.csv'
+    fields = ['kind', 'name', 'datatype', 'device', 'status', 'dims',
+              'mini_batch_size', 'fp_time_ms', 'bp_time_ms', 'output_dims',
+              'activation_bytes', 'weights_bytes']
+    rows = [
+        ['layer', 'conv (convolution)', 'FLOAT', 'GPU', 'ok', '3x32x32',
+         '32', '1.5', '3', '16x32x32', '2097152', '4096'],
+        ['layer', 'relu (ReLU)', 'FLOAT', 'CPU', 'ok', '3x32x32',
+         '32', '1', '1', '16x32x32', '2097152', '0'],
+        ['operator', 'exp (Exp)', 'FLOAT', 'GPU', 'ok', '3x32x32',
+         '32', '1', '1', '16x32x32', '2097152', '0'],
+        ['layer', 'fc (fully connected)', 'FLOAT', 'GPU', 'failed',
+         '3x32x32', '32', '1', '1', '10', '1280', '40960'],
+        ['layer', 'pool (pooling)', 'FLOAT', 'GPU', 'ok', '3x64x64',
+         '32', '1', '1', '16x16x16', '524288', '0'],
+    ]
+    with open(layer_csv, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(fields)
+        writer.writerows(rows)
+    (conv,) = planner.read_layer_profile(str(layer_csv))
+    assert conv.name == 'conv'
+    assert conv.type == 'convolution'
+    assert conv.fp_time == pytest.approx(1.5e-3)
+    assert conv.bp_time == pytest.approx(3e-3)
+    assert conv.output_dims == (16, 32, 32)
+    assert conv.sample_bytes() == pytest.approx(65536)
+    with pytest.raises(ValueError):
+        planner.read_layer_profile(str(layer_csv), datatype='DOUBLE')
+
+    comm_csv = tmp_path / 'comm.csv'
+    with open(comm_csv, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['collective', 'device', 'comm_size', 'bytes',
+                         'time_us', 'busbw_GBps'])
+        writer.writerow(['allreduce', 'GPU', '4', '8', '60', '0.01'])
+        writer.writerow(['allreduce', 'GPU', '4', '1048576', '200', '12'])
+        writer.writerow(['allgather', 'GPU', '4', '8', '1', '50'])
+        writer.writerow(['allreduce', 'GPU', '1', '8', '1', '50'])
+    comm = planner.read_comm_profile(str(comm_csv))
+    assert comm.latency == pytest.approx(60e-6 / 6)
+    assert comm.bandwidth == pytest.approx(12e9)
@@ -0,0 +1,77 @@
+################################################################################
+## Copyright (c) 2014-2022, Lawrence Livermore National Security, LLC.
+## Produced at the Lawrence Livermore National Laboratory.
+## Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+## the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+##
+## LLNL-CODE-697807.
+## All rights reserved.
+##
+## This file is part of LBANN: Livermore Big Artificial Neural Network
+## Toolkit. For details, see http://software.llnl.gov/LBANN or
+## https://github.com/LLNL/LBANN.
+##
+## Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+## may not use this file except in compliance with the License.  You may
+## obtain a copy of the License at:
+##
+## http://www.apache.org/licenses/LICENSE-2.0
+##
+## Unless required by applicable law or agreed to in writing, software
+## distributed under the License is distributed on an "AS IS" BASIS,
+## WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+## implied. See the License for the specific language governing
+## permissions and limitations under the license.
+
+# Defines the following variables:
+#   - TurboJPEG_FOUND
+#   - TurboJPEG_LIBRARIES
+#   - TurboJPEG_INCLUDE_DIRS
+#
+# Also creates an imported target TurboJPEG::TurboJPEG
+
+# Find the header
+find_path(TurboJPEG_INCLUDE_DIRS turbojpeg.h
+  HINTS ${TurboJPEG_DIR} $ENV{TurboJPEG_DIR} ${LIBJPEG_TURBO_DIR}
+  PATH_SUFFIXES include
+  NO_DEFAULT_PATH
+  DOC "Directory with the TurboJPEG header.")
+find_path(TurboJPEG_INCLUDE_DIRS turbojpeg.h)
+
+# Find the library
+find_library(TurboJPEG_LIBRARY turbojpeg
+  HINTS ${TurboJPEG_DIR} $ENV{TurboJPEG_DIR} ${LIBJPEG_TURBO_DIR}
+  PATH_SUFFIXES lib64 lib
+  NO_DEFAULT_PATH
+  DOC "The TurboJPEG library.")
+find_library(TurboJPEG_LIBRARY turbojpeg)
+
+# Standard handling of the package arguments
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(TurboJPEG
+  DEFAULT_MSG
+  TurboJPEG_LIBRARY TurboJPEG_INCLUDE_DIRS)
+
+# Setup the imported target
+if (NOT TARGET TurboJPEG::TurboJPEG)
+  add_library(TurboJPEG::TurboJPEG INTERFACE IMPORTED)
+endif (NOT TARGET TurboJPEG::TurboJPEG)
+
+# Set the include directories for the target
+set_property(TARGET TurboJPEG::TurboJPEG APPEND
+  PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${TurboJPEG_INCLUDE_DIRS})
+
+# Set the link libraries for the target
+set_property(TARGET TurboJPEG::TurboJPEG APPEND
+  PROPERTY INTERFACE_LINK_LIBRARIES ${TurboJPEG_LIBRARY})
+
+#
+# Cleanup
+#
+
+# Set the include directories
+mark_as_advanced(FORCE TurboJPEG_INCLUDE_DIRS)
+
+# Set the libraries
+set(TurboJPEG_LIBRARIES TurboJPEG::TurboJPEG)
+mark_as_advanced(FORCE TurboJPEG_LIBRARY)
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+// Converts a text sample list into the binary index format that
+// sample_list::load() memory-maps, so that each rank only parses the records
+// of the data files assigned to it.
+
+#include "lbann/data_ingestion/readers/sample_list_impl.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[])
+{
+  if (argc != 3) {
+    std::cerr << "usage: " << argv[0]
+              << " <input text sample list> <output binary sample list>\n";
+    return EXIT_FAILURE;
+  }
+
+  const std::string input_file(argv[1]);
+  const std::string output_file(argv[2]);
+  try {
+    lbann::write_binary_sample_list(input_file, output_file);
+  }
+  catch (lbann::exception& e) {
+    std::cerr << "failed to convert " << input_file << ": " << e.what()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "wrote binary sample list " << output_file << std::endl;
+  return EXIT_SUCCESS;
+}
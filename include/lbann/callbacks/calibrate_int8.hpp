@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_CALIBRATE_INT8_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_CALIBRATE_INT8_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+/**
+ * Calibrate a trained model for int8 inference.
+ *
+ * While the model is evaluated on a calibration dataset, the largest
+ * magnitude of each input of the selected layers is recorded. At the
+ * end of the evaluation the ranges are reduced over the trainer and,
+ * if @c apply is set, the layers switch to int8 forward prop (see
+ * Layer::set_int8_input_ranges). Layers without an int8
+ * implementation stay in full precision.
+ *
+ * batch_functional_inference_algorithm::compare_int8 reports the
+ * accuracy of the quantized model against full precision.
+ */
+class calibrate_int8 : public callback_base
+{
+public:
+  using callback_base::on_evaluate_forward_prop_begin;
+
+  /**
+   * @param layer_names Layers to quantize. Default: every layer that
+   *                    supports int8 inference.
+   * @param apply Switch the layers to int8 once calibrated.
+   */
+  calibrate_int8(std::vector<std::string> layer_names = {},
+                 bool apply = true);
+  calibrate_int8(const calibrate_int8&) = default;
+  calibrate_int8& operator=(const calibrate_int8&) = default;
+  calibrate_int8* copy() const override { return new calibrate_int8(*this); }
+  void on_evaluate_forward_prop_begin(model* m, Layer* l) override;
+  void on_validation_end(model* m) override;
+  void on_test_end(model* m) override;
+  std::string name() const override { return "calibrate_int8"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_evaluate_forward_prop_begin);
+  }
+
+  /** Largest input magnitudes recorded so far, by layer name. */
+  std::map<std::string, std::vector<double>> const& get_ranges() const
+  {
+    return m_ranges;
+  }
+
+  /** Switch the calibrated layers of a model to int8 forward prop. */
+  void apply(model& m) const;
+
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Store state to archive for checkpoint and restart */
+  template <class Archive>
+  void serialize(Archive& ar);
+
+  ///@}
+
+private:
+  /** Add callback specific data to prototext */
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Whether a layer is calibrated. */
+  bool is_selected(Layer const& l) const;
+  /** Reduce the ranges over the trainer and apply them if requested. */
+  void finish_calibration(model* m);
+
+  /// Layers to quantize, all supported layers if empty.
+  std::vector<std::string> m_layer_names;
+  /// Switch the layers to int8 once calibrated.
+  bool m_apply;
+  /// Largest magnitude of each input, by layer name.
+  std::map<std::string, std::vector<double>> m_ranges;
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_calibrate_int8_callback_from_pbuf(const google::protobuf::Message&,
+                                        std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_CALIBRATE_INT8_HPP_INCLUDED
@@ -110,6 +110,34 @@ public:
   /** @name Callback hooks */
   ///@{
 
+  /** @brief Per-layer and per-weights hooks.
+   *
+   *  These run for every layer or weights object in every step, so
+   *  the model only dispatches them to callbacks that declare them
+   *  in get_hooks.
+   */
+  enum hook : unsigned
+  {
+    layer_forward_prop_begin = 0,
+    layer_forward_prop_end,
+    layer_backward_prop_begin,
+    layer_backward_prop_end,
+    layer_evaluate_forward_prop_begin,
+    layer_evaluate_forward_prop_end,
+    weights_optimize_begin,
+    weights_optimize_end,
+    num_hooks
+  };
+  /** @brief Bit for a hook in the mask returned by get_hooks. */
+  static constexpr unsigned hook_bit(hook h) noexcept { return 1u << h; }
+  /** @brief Mask of the per-layer and per-weights hooks this
+   *         callback implements.
+   *
+   *  Callbacks that override any of those hooks must declare them
+   *  here, or the model will never call them.
+   */
+  virtual unsigned get_hooks() const { return 0u; }
+
   /** @brief Called at the beginning of model setup. */
   virtual void on_setup_begin(model* m) {}
   /** @brief Called at the end of model setup. */
@@ -57,6 +57,11 @@ public:
   void add_to_set(model* m, Layer* l, int64_t step, std::set<long>& set);
 
   std::string name() const override { return "check data set indices"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_end) |
+           hook_bit(layer_evaluate_forward_prop_end);
+  }
 
   /** @name Serialization */
   ///@{
@@ -30,6 +30,7 @@
 #define LBANN_CALLBACKS_CALLBACK_CHECK_NAN_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/callbacks/tensor_check_flags.hpp"
 
 namespace lbann {
 namespace callback {
@@ -37,6 +38,12 @@ namespace callback {
 /**
  * Check matrices for whether they include any NaNs or infs to help debugging.
  * This will kill the rank if such values are discovered.
+ *
+ * GPU tensors are scanned on the device without waiting, and the
+ * per-tensor flags of a step are read back once, asynchronously, at
+ * the start of the next step. Bad values are therefore reported one
+ * step late, naming every tensor that held them, so the check can
+ * stay enabled in production runs.
  */
 class check_nan : public callback_base
 {
@@ -44,10 +51,12 @@ public:
   using callback_base::on_backward_prop_end;
   using callback_base::on_forward_prop_end;
 
-  check_nan() = default;
+  check_nan();
   check_nan(const check_nan&) = default;
   check_nan& operator=(const check_nan&) = default;
   check_nan* copy() const override { return new check_nan(*this); }
+  /** Report tensors that held bad values in the previous step. */
+  void on_batch_begin(model* m) override;
   /** Check that activations are good. */
   void on_forward_prop_end(model* m, Layer* l) override;
   /** Check that error signals are good. */
@@ -56,7 +65,15 @@ public:
   void on_backward_prop_end(model* m) override;
   /** Check that weights are good. */
   void on_batch_end(model* m) override;
+  /** Report tensors that held bad values in the last step. */
+  void on_epoch_end(model* m) override;
+  /** Report tensors that held bad values in the last step. */
+  void on_train_end(model* m) override;
   std::string name() const override { return "check_nan"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_end) | hook_bit(layer_backward_prop_end);
+  }
 
   /** @name Serialization */
   ///@{
@@ -70,6 +87,15 @@ public:
 private:
   /** Add callback specific data to prototext */
   void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Raise an error naming the tensors that held bad values in the
+   *  last checked step, after dumping the network. */
+  void report_tripped(model* m);
+
+  /** Flags of the tensors checked in each step. */
+  tensor_check_flags m_flags;
+  /** Step whose flags are read by report_tripped. */
+  size_t m_checked_step = 0;
 };
 
 // Builder function
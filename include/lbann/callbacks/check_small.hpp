@@ -30,6 +30,7 @@
 #define LBANN_CALLBACKS_CALLBACK_CHECK_SMALL_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/callbacks/tensor_check_flags.hpp"
 
 namespace lbann {
 namespace callback {
@@ -41,6 +42,8 @@ namespace callback {
  * Since we often square values, the check is based on the square root of the
  * smallest floating point value.
  * This will kill the rank if such values are discovered.
+ * As with check_nan, GPU tensors are scanned on the device and the
+ * flags of a step are read back at the start of the next step.
  */
 class check_small : public callback_base
 {
@@ -48,17 +51,27 @@ public:
   using callback_base::on_backward_prop_end;
   using callback_base::on_forward_prop_end;
 
-  check_small() = default;
+  check_small();
   check_small(const check_small&) = default;
   check_small& operator=(const check_small&) = default;
   check_small* copy() const override { return new check_small(*this); }
+  /** Report tensors that held small values in the previous step. */
+  void on_batch_begin(model* m) override;
   /** Check that activations are good. */
   void on_forward_prop_end(model* m, Layer* l) override;
   /** Check that gradients are good. */
   void on_backward_prop_end(model* m) override;
   /** Check that weights are good. */
   void on_batch_end(model* m) override;
+  /** Report tensors that held small values in the last step. */
+  void on_epoch_end(model* m) override;
+  /** Report tensors that held small values in the last step. */
+  void on_train_end(model* m) override;
   std::string name() const override { return "check_small"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_end);
+  }
 
   /** @name Serialization */
   ///@{
@@ -72,6 +85,15 @@ public:
 private:
   /** Add callback specific data to prototext */
   void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Raise an error naming the tensors that held small values in the
+   *  last checked step. */
+  void report_tripped(model* m);
+
+  /** Flags of the tensors checked in each step. */
+  tensor_check_flags m_flags;
+  /** Step whose flags are read by report_tripped. */
+  size_t m_checked_step = 0;
 };
 
 // Builder function
@@ -29,9 +29,16 @@
 #define LBANN_CALLBACKS_CALLBACK_CHECKPOINT_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/io/checkpoint_writer.hpp"
 #include "lbann/io/persist.hpp"
 #include "lbann/utils/visitor_hooks.hpp"
 
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+
 namespace lbann {
 
 // Forward-declarations
@@ -48,7 +55,38 @@ enum class callback_phase
   invalid
 };
 
-/** @brief Checkpoint at given interval in given directory */
+/** @brief Checkpoint at given interval in given directory
+ *
+ *  In asynchronous mode, the model is serialized into host memory at
+ *  the checkpoint and its files are written by a background thread
+ *  while training continues. The trainer state, which is small, is
+ *  still written synchronously. The "last checkpoint" marker of an
+ *  asynchronous checkpoint is only written once every rank's files
+ *  are on disk, so a restart never sees a partial checkpoint.
+ *
+ *  When @c per_rank_dir names node-local storage (NVMe, /dev/shm),
+ *  distributed checkpoints form a fast tier. Every @c drain_interval
+ *  of them is also copied to the checkpoint directory in the
+ *  background, and with partner replication each rank keeps a copy
+ *  of another node's files so the tier survives losing a node. On
+ *  restart the newest checkpoint wins; between equally recent ones
+ *  the node-local copy is preferred if every rank can read it.
+ *
+ *  With incremental checkpoints, weights whose version has not
+ *  changed since the previous checkpoint of the same kind (typically
+ *  frozen weights) are left out of the model archive, and the
+ *  archive names the checkpoint it builds on. A full checkpoint is
+ *  written at the start of each run, after @c max_incremental_chain
+ *  incremental ones, and whenever the checkpoint will be drained.
+ *
+ *  The "last checkpoint" marker records how many ranks per trainer
+ *  wrote the checkpoint. A job restarted on a different number of
+ *  ranks (e.g. after losing nodes) skips distributed checkpoints,
+ *  whose files are per rank, and resumes from the newest shared one.
+ *  Weights and optimizer state are then scattered over the new grid,
+ *  data readers are re-partitioned at setup, and ranks the old job
+ *  did not have keep their freshly seeded random number generators.
+ */
 class checkpoint : public callback_base
 {
 public:
@@ -67,6 +105,17 @@ public:
    * checkpoints
    *  @param ckpt_dist_epochs The frequency of distributed checkpoints in epochs
    *  @param ckpt_dist_steps The frequence of distributed checkpoints in steps
+   *  @param async_checkpoint Write model files on a background thread
+   *  @param max_inflight_checkpoints Asynchronous checkpoints that may
+   *         be pending before a new checkpoint waits for the oldest
+   *  @param drain_interval Copy every n-th node-local distributed
+   *         checkpoint to the checkpoint directory (0 disables)
+   *  @param partner_replication Replicate node-local distributed
+   *         checkpoints to a rank on another node
+   *  @param incremental_checkpoint Leave unchanged weights out of
+   *         model checkpoints
+   *  @param max_incremental_chain Incremental checkpoints between
+   *         full ones (0 selects the default of 8)
    */
   checkpoint(std::string checkpoint_dir,
              std::string restart_dir,
@@ -75,7 +124,13 @@ public:
              int checkpoint_secs,
              std::string per_rank_dir,
              int ckpt_dist_epochs,
-             int ckpt_dist_steps)
+             int ckpt_dist_steps,
+             bool async_checkpoint = false,
+             int max_inflight_checkpoints = 1,
+             int drain_interval = 0,
+             bool partner_replication = false,
+             bool incremental_checkpoint = false,
+             int max_incremental_chain = 8)
     : callback_base(),
       m_active_trainer(nullptr),
       m_active_training_algorithm(nullptr),
@@ -86,7 +141,14 @@ public:
       m_checkpoint_secs(checkpoint_secs),
       m_per_rank_dir(per_rank_dir),
       m_ckpt_dist_epochs(ckpt_dist_epochs),
-      m_ckpt_dist_steps(ckpt_dist_steps)
+      m_ckpt_dist_steps(ckpt_dist_steps),
+      m_async_checkpoint(async_checkpoint),
+      m_max_inflight_checkpoints(std::max(max_inflight_checkpoints, 1)),
+      m_drain_interval(std::max(drain_interval, 0)),
+      m_partner_replication(partner_replication),
+      m_incremental_checkpoint(incremental_checkpoint),
+      m_max_incremental_chain(max_incremental_chain > 0 ? max_incremental_chain
+                                                        : 8)
   {}
   checkpoint(const checkpoint&) = default;
   checkpoint& operator=(const checkpoint&) = default;
@@ -212,6 +274,71 @@ private:
                             persist& p,
                             size_t epoch,
                             size_t step);
+  /** Hand model files to the background writer; the marker is
+   *  written when the checkpoint is retired. */
+  void queue_async_checkpoint(checkpoint_writer::file_list files,
+                              std::string latest_file,
+                              visitor_hook hook,
+                              execution_mode mode,
+                              size_t epoch,
+                              size_t step);
+  /** Wait for the oldest asynchronous checkpoint on every rank, then
+   *  write its marker. Collective over the trainer. */
+  void retire_oldest_checkpoint(lbann_comm& comm);
+  /** Replicate a node-local distributed checkpoint to the partner
+   *  node and, at the drain interval, stage a copy for the checkpoint
+   *  directory in @c drain_files; returns whether it did. Files still
+   *  queued for the writer are taken from @c model_files; replicas
+   *  are appended to it in asynchronous mode. Collective over the
+   *  trainer. */
+  bool update_local_tier(lbann_comm& comm,
+                         trainer& t,
+                         visitor_hook hook,
+                         execution_mode mode,
+                         size_t epoch,
+                         size_t step,
+                         std::string const& epochdir,
+                         checkpoint_writer::file_list& model_files,
+                         checkpoint_writer::file_list& drain_files);
+  /** Save the model to @c epochdir, incrementally if enabled. In
+   *  asynchronous mode the files are returned instead of written. */
+  checkpoint_writer::file_list save_model(lbann_comm& comm,
+                                          model& m,
+                                          persist& p,
+                                          std::string const& epochdir,
+                                          bool shared,
+                                          bool force_full);
+  /** Incremental checkpoints of one kind, shared or distributed. */
+  struct incremental_chain
+  {
+    /** Directory of the last checkpoint, empty if there is none. */
+    std::string epochdir;
+    /** Weights versions as of that checkpoint. */
+    std::map<std::string, uint64_t> versions;
+    /** Incremental checkpoints since the last full one. */
+    int length = 0;
+  };
+  /** Pick the weights an incremental checkpoint in @c epochdir can
+   *  leave out and advance @c chain. Returns the path of the model
+   *  directory it builds on, relative to its own, or an empty string
+   *  for a full checkpoint. Collective over the trainer. */
+  std::string start_incremental_checkpoint(lbann_comm& comm,
+                                           model& m,
+                                           incremental_chain& chain,
+                                           std::string const& epochdir,
+                                           bool force_full,
+                                           std::set<std::string>& skip);
+  /** Check that every rank can read its node-local checkpoint,
+   *  restoring lost ones from partner replicas. Collective over the
+   *  trainer. */
+  bool recover_local_checkpoint(lbann_comm& comm,
+                                std::string const& trainer_name,
+                                std::string const& alg_name,
+                                std::string const& dir,
+                                visitor_hook hook,
+                                execution_mode mode,
+                                size_t epoch,
+                                size_t step);
 
 private:
   trainer* m_active_trainer;
@@ -229,6 +356,32 @@ private:
   EvalType m_checkpoint_last;
   bool m_checkpoint_dist;
   bool m_checkpoint_shared;
+  bool m_async_checkpoint;
+  int m_max_inflight_checkpoints;
+  int m_drain_interval;
+  bool m_partner_replication;
+  /** Distributed checkpoints written to the node-local tier. */
+  size_t m_num_local_checkpoints = 0;
+  bool m_incremental_checkpoint;
+  int m_max_incremental_chain;
+  incremental_chain m_shared_chain;
+  incremental_chain m_distributed_chain;
+
+  /** An asynchronous checkpoint whose files may still be in flight. */
+  struct pending_checkpoint
+  {
+    uint64_t ticket;
+    std::string latest_file;
+    visitor_hook hook;
+    execution_mode mode;
+    size_t epoch;
+    size_t step;
+  };
+  std::deque<pending_checkpoint> m_pending_checkpoints;
+  /** Created on the first asynchronous checkpoint. */
+  std::shared_ptr<checkpoint_writer> m_writer;
+  /** Bytes handed to the writer by the current checkpoint. */
+  uint64_t m_async_bytes = 0;
 
   template <size_t _max_dir_len>
   struct header_t
@@ -238,6 +391,7 @@ private:
     int epoch;
     int step;
     int shared;
+    int local;
     char dirname[_max_dir_len];
   };
 };
@@ -293,22 +447,52 @@ std::string get_distributed_checkpoint_dirname(const std::string& trainer_name,
                                                size_t epoch,
                                                size_t step);
 
+/** @brief Send checkpoint files to one trainer rank while receiving
+ *         from another.
+ *
+ *  Every rank of the trainer must call this. Contents are moved in
+ *  chunks of at most @c max_chunk bytes, and all ranks run the same
+ *  number of rounds whatever the sizes they hold.
+ */
+checkpoint_writer::file_list
+exchange_checkpoint_files(lbann_comm& comm,
+                          checkpoint_writer::file_list const& files,
+                          int send_rank,
+                          int recv_rank,
+                          uint64_t max_chunk = uint64_t{1} << 30);
+
+/** @brief File that marks a rank's checkpoint directory as complete.
+ *
+ *  It is written after every other file of the directory, so a
+ *  directory without it was interrupted while being written.
+ */
+checkpoint_writer::file_list::value_type
+get_checkpoint_complete_marker(std::string const& dir);
+
+/** @brief Whether a rank's checkpoint directory was fully written. */
+bool is_checkpoint_complete(std::string const& dir);
+
 // Print last checkpoint to file, used to determine which checkpoint to load
-// from.
+// from. A positive procs_per_trainer records how many ranks wrote it.
 bool write_latest(std::string filename,
                   visitor_hook hook,
                   execution_mode mode,
                   size_t epoch,
-                  size_t train);
+                  size_t train,
+                  int procs_per_trainer = 0);
 
 /** \brief Reads the "latest" file and returns the epoch number and
  *        sample offset for most recent checkpoint
+ *
+ *  If procs_per_trainer is given it is set to the number of ranks
+ *  that wrote the checkpoint, or 0 if the file does not record it.
  */
 bool read_latest(std::string filename,
                  visitor_hook* hook,
                  execution_mode* mode,
                  size_t* epochLast,
-                 size_t* trainLast);
+                 size_t* trainLast,
+                 int* procs_per_trainer = nullptr);
 
 // Builder function
 std::unique_ptr<callback_base>
@@ -37,6 +37,13 @@ namespace callback {
  *  "<prefix><mode>.csv". The (i,j)-entry is the proportion of samples
  *  with prediction i and label j. The prediction and label layers are
  *  assumed to output one-hot vectors for each mini-batch sample.
+ *
+ *  Each rank counts its samples on the device of the prediction layer
+ *  and the counts are reduced once per epoch. With more than
+ *  max_dense_classes classes, a rank keeps the (label, prediction)
+ *  pair of each sample instead of num_classes^2 counters, and the
+ *  file lists the nonzero entries as "prediction,label,proportion"
+ *  lines.
  */
 class confusion_matrix : public callback_base
 {
@@ -46,10 +53,12 @@ public:
 public:
   confusion_matrix(std::string&& prediction_layer,
                    std::string&& label_layer,
-                   std::string&& prefix);
+                   std::string&& prefix,
+                   El::Int max_dense_classes = 1024);
   confusion_matrix(std::string const& prediction_layer,
                    std::string const& label_layer,
-                   std::string const& prefix);
+                   std::string const& prefix,
+                   El::Int max_dense_classes = 1024);
   confusion_matrix(const confusion_matrix&);
   confusion_matrix& operator=(const confusion_matrix&);
   confusion_matrix* copy() const override
@@ -83,23 +92,34 @@ private:
   std::string m_label_layer;
   /** Prefix for output files. */
   std::string m_prefix;
+  /** Largest number of classes with dense counts. */
+  El::Int m_max_dense_classes;
 
-  /** Confusion matrix counts.
-   *  Each vector should be interpreted as a num_classes x num_classes
-   *  matrix in row-major order. The (i,j)-entry is the number of
-   *  samples with prediction i and label j.
-   */
-  std::map<execution_mode, std::vector<El::Int>> m_counts;
+  /** Confusion matrix counts of this rank for one execution mode. */
+  struct local_counts
+  {
+    /** Dense counts, or the keys of the samples seen so far if there
+     *  are more than max_dense_classes classes. The count of
+     *  prediction i and label j, and the key of such a sample, are at
+     *  j + i * num_classes. This matrix is on the device of the
+     *  prediction layer.
+     */
+    std::unique_ptr<El::AbstractMatrix<El::Int>> data;
+    /** Number of keys in @c data. */
+    El::Int num_keys = 0;
+  };
+  std::map<execution_mode, local_counts> m_counts;
 
   /** "View" into prediction matrix.
-   *  This is a CPU matrix. If the prediction layer keeps data on GPU,
-   *  then this will be a matrix copy rather than a matrix view.
+   *  This is on the device of the prediction layer. If the
+   *  prediction layer distributes matrix rows, then this will be a
+   *  (STAR,VC) copy rather than a matrix view.
    */
   std::unique_ptr<AbsDistMatType> m_predictions_v;
   /** "View" into label matrix.
-   *  This is a CPU matrix. If the label layer keeps data on GPU or in
-   *  a different distribution than the prediction layer, then this
-   *  will be a matrix copy rather than a matrix view.
+   *  This is aligned with the prediction view. If the label layer
+   *  keeps data on a different device or in a different distribution,
+   *  then this will be a matrix copy rather than a matrix view.
    */
   std::unique_ptr<AbsDistMatType> m_labels_v;
 
@@ -107,6 +127,8 @@ private:
   const AbsDistMatType& get_predictions(const model& m) const;
   /** Get label matrix. */
   const AbsDistMatType& get_labels(const model& m) const;
+  /** Whether counts are kept as the keys of the samples. */
+  bool is_sparse(const model& m) const;
 
   /** Reset confusion matrix counts. */
   void reset_counts(const model& m);
@@ -117,8 +139,25 @@ private:
   void update_counts(const model& m);
   /** Output confusion matrix to file. */
   void save_confusion_matrix(const model& m);
+  /** Output the nonzero entries of the confusion matrix to file. */
+  void save_sparse_confusion_matrix(const model& m,
+                                    local_counts& counts,
+                                    const std::string& file_name);
 };
 
+#ifdef LBANN_HAS_GPU
+/** Count the (label, prediction) pairs of one-hot columns on the GPU.
+ *  If @c dense, out is the num_classes^2 counts. Otherwise the key of
+ *  column k, or -1 if it has no prediction or label, is written to
+ *  out(0,k).
+ */
+void confusion_matrix_count_gpu(
+  const El::Matrix<DataType, El::Device::GPU>& predictions,
+  const El::Matrix<DataType, El::Device::GPU>& labels,
+  bool dense,
+  El::Matrix<El::Int, El::Device::GPU>& out);
+#endif // LBANN_HAS_GPU
+
 // Builder function
 std::unique_ptr<callback_base> build_confusion_matrix_callback_from_pbuf(
   const google::protobuf::Message&,
@@ -57,6 +57,16 @@ public:
   debug& operator=(const debug&) = default;
   debug* copy() const override { return new debug(*this); }
   std::string name() const override { return "debug"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_begin) |
+           hook_bit(layer_forward_prop_end) |
+           hook_bit(layer_backward_prop_begin) |
+           hook_bit(layer_backward_prop_end) |
+           hook_bit(layer_evaluate_forward_prop_begin) |
+           hook_bit(layer_evaluate_forward_prop_end) |
+           hook_bit(weights_optimize_begin) | hook_bit(weights_optimize_end);
+  }
 
   /** @brief Print that a batch is beginning. */
   void on_batch_begin(model* m) override;
@@ -78,6 +78,11 @@ public:
   void print_phase_start(model* m, execution_mode mode);
 
   std::string name() const override { return "debug_io"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_begin) |
+           hook_bit(layer_evaluate_forward_prop_begin);
+  }
 
   /** @name Serialization */
   ///@{
@@ -29,31 +29,51 @@
 
 #include "lbann/callbacks/callback.hpp"
 
+#include <memory>
+
 namespace lbann {
+
+// Forward declaration
+class tensor_dump_writer;
+
 namespace callback {
 
 /** Dump gradients w.r.t. inputs to file.
  *  After each layer performs a backward prop step, this callback will
  *  dump the gradients w.r.t. inputs (the "error signals") to a
- *  human-readable ASCII file. This is slow and produces a lot of output.
+ *  human-readable ASCII file. This produces a lot of output; use
+ *  the batch interval and sample limit to reduce it. Files are
+ *  written by a background thread from a pinned host copy and are
+ *  complete by the end of training.
  */
 class dump_error_signals : public callback_base
 {
 public:
   /** Constructor.
    *  @param basename The basename for output files.
+   *  @param batch_interval Frequency of dumps (default: each step).
+   *  @param max_samples Number of mini-batch samples dumped at each
+   *                     step (default: all).
    */
-  dump_error_signals(std::string basename = "")
-    : callback_base(), m_basename(basename)
-  {}
+  dump_error_signals(std::string basename = "",
+                     El::Int batch_interval = 1,
+                     El::Int max_samples = 0);
+  dump_error_signals(const dump_error_signals& other);
+  dump_error_signals& operator=(const dump_error_signals& other);
+  ~dump_error_signals() override;
   dump_error_signals* copy() const override
   {
     return new dump_error_signals(*this);
   }
   std::string name() const override { return "dump error signals"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_backward_prop_end);
+  }
 
   /** Write error signals to file after each backward prop step. */
   void on_backward_prop_end(model* m, Layer* l) override;
+  void on_train_end(model* m) override;
 
   /** @name Serialization */
   ///@{
@@ -70,6 +90,11 @@ private:
 
   /** Basename for output files. */
   std::string m_basename;
+  /** Number of mini-batch samples dumped at each step; all if not
+   *  positive. */
+  El::Int m_max_samples;
+  /** Background writer, created on the first dump. */
+  std::unique_ptr<tensor_dump_writer> m_writer;
 };
 
 // Builder function
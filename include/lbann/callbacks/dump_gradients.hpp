@@ -29,11 +29,16 @@
 #ifndef LBANN_CALLBACKS_CALLBACK_DUMP_GRADIENTS_HPP_INCLUDED
 #define LBANN_CALLBACKS_CALLBACK_DUMP_GRADIENTS_HPP_INCLUDED
 
+#include <memory>
 #include <utility>
 
 #include "lbann/callbacks/callback.hpp"
 
 namespace lbann {
+
+// Forward declaration
+class tensor_dump_writer;
+
 namespace callback {
 
 /**
@@ -43,7 +48,9 @@ namespace callback {
  * Elemental's simple ASCII format. This is not meant for
  * checkpointing, but for exporting gradient matrices for analysis
  * that isn't easily done in LBANN.  Note this dumps matrices during
- * each mini-batch. This will be slow and produce a lot of output.
+ * each mini-batch, which produces a lot of output. Files are written
+ * by a background thread from a pinned host copy and are complete by
+ * the end of training.
  */
 class dump_gradients : public callback_base
 {
@@ -54,13 +61,13 @@ public:
    * @param basename The basename for writing files.
    * @param batch_interval The frequency at which to dump the gradients
    */
-  dump_gradients(std::string basename, int batch_interval = 1)
-    : callback_base(batch_interval), m_basename(std::move(basename))
-  {}
-  dump_gradients(const dump_gradients&) = default;
-  dump_gradients& operator=(const dump_gradients&) = default;
+  dump_gradients(std::string basename, int batch_interval = 1);
+  dump_gradients(const dump_gradients& other);
+  dump_gradients& operator=(const dump_gradients& other);
+  ~dump_gradients() override;
   dump_gradients* copy() const override { return new dump_gradients(*this); }
   void on_backward_prop_end(model* m) override;
+  void on_train_end(model* m) override;
   std::string name() const override { return "dump gradients"; }
 
   /** @name Serialization */
@@ -81,6 +88,8 @@ private:
 
   /** @brief Basename for writing files. */
   std::string m_basename;
+  /** @brief Background writer, created on the first dump. */
+  std::unique_ptr<tensor_dump_writer> m_writer;
 };
 
 // Builder function
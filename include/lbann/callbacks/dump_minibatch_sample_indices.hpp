@@ -70,6 +70,11 @@ public:
   void dump_to_file(model* m, Layer* l, int64_t step);
 
   std::string name() const override { return "dump minibatch sample indices"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_end) |
+           hook_bit(layer_evaluate_forward_prop_end);
+  }
 
   /** @name Serialization */
   ///@{
@@ -29,10 +29,15 @@
 
 #include "lbann/callbacks/callback.hpp"
 
+#include <memory>
 #include <set>
 #include <string>
 
 namespace lbann {
+
+// Forward declaration
+class tensor_dump_writer;
+
 namespace callback {
 
 /** @brief Dump layer output tensors to files.
@@ -50,6 +55,11 @@ namespace callback {
  *  we use internally).
  *
  *  CNPY is required to export to NumPy file formats (npy and npz).
+ *
+ *  Outputs are gathered to one process, staged in pinned host memory
+ *  and written by a background thread, so files may appear after the
+ *  step that produced them. All files are written by the end of
+ *  training or testing.
  */
 class dump_outputs : public callback_base
 {
@@ -66,21 +76,34 @@ public:
    *                        working directory).
    *  @param file_format    Output file format. Options are csv, tsv,
    *                        npy, npz (default: csv).
+   *  @param max_samples    Number of mini-batch samples dumped at
+   *                        each step (default: all).
    */
   dump_outputs(std::set<std::string> layer_names, // = std::set<std::string>(),
                std::set<execution_mode> modes,    // = std::set<std::string>(),
                El::Int batch_interval = 0,
                std::string directory = "",
-               std::string file_format = "");
+               std::string file_format = "",
+               El::Int max_samples = 0);
+  dump_outputs(const dump_outputs& other);
+  dump_outputs& operator=(const dump_outputs& other);
+  ~dump_outputs() override;
 
   dump_outputs* copy() const override { return new dump_outputs(*this); }
   std::string name() const override { return "dump outputs"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_end) |
+           hook_bit(layer_evaluate_forward_prop_end);
+  }
 
   void on_forward_prop_end(model* m, Layer* l) override
   {
     do_dump_outputs(*m, *l);
   }
   void on_evaluate_forward_prop_end(model* m, Layer* l) override;
+  void on_train_end(model* m) override;
+  void on_test_end(model* m) override;
 
   /** @name Serialization */
   ///@{
@@ -116,6 +139,14 @@ private:
   /** @brief Output file format. */
   std::string m_file_format;
 
+  /** @brief   Number of mini-batch samples dumped at each step.
+   *  @details If not positive, all samples are dumped.
+   */
+  El::Int m_max_samples;
+
+  /** @brief Background writer, created on the first dump. */
+  std::unique_ptr<tensor_dump_writer> m_writer;
+
   /** @brief   Dump outputs to file.
    *  @details Returns immediately if an output dump is not needed.
    */
@@ -29,12 +29,17 @@
 #ifndef LBANN_CALLBACKS_CALLBACK_DUMP_WEIGHTS_HPP_INCLUDED
 #define LBANN_CALLBACKS_CALLBACK_DUMP_WEIGHTS_HPP_INCLUDED
 
+#include <memory>
 #include <utility>
 
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/utils/visitor_hooks.hpp"
 
 namespace lbann {
+
+// Forward declaration
+class tensor_dump_writer;
+
 namespace callback {
 
 // Forward declaration
@@ -52,6 +57,11 @@ class FileFormat;
  *  ASCII and BINARY formats, respectively. The "distributed_binary"
  *  format is written by using Elemental's BINARY format independently
  *  on each process' local data.
+ *
+ *  Weights are staged in pinned host memory and written by a
+ *  background thread. The trainer master records the dump as the
+ *  latest one after its own weight files are complete; all files are
+ *  written by the end of training.
  */
 class dump_weights : public callback_base
 {
@@ -66,8 +76,10 @@ public:
                std::unique_ptr<dump_weights_internal::FileFormat> file_format);
   dump_weights(const dump_weights&);
   dump_weights& operator=(const dump_weights&);
+  ~dump_weights() override;
   dump_weights* copy() const override { return new dump_weights(*this); }
   void on_train_begin(model* m) override;
+  void on_train_end(model* m) override;
   void on_epoch_end(model* m) override;
   std::string name() const override { return "dump weights"; }
   void set_target_dir(const std::string& dir) { m_directory = dir; }
@@ -95,6 +107,8 @@ private:
   El::Int m_epoch_interval;
   /// Weight file format
   std::unique_ptr<dump_weights_internal::FileFormat> m_file_format;
+  /// Background writer, created on the first dump
+  std::unique_ptr<tensor_dump_writer> m_writer;
 
   /// Dump weights from learning layers
   void do_dump_weights(const model& m, visitor_hook hook);
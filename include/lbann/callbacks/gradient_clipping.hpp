@@ -40,6 +40,10 @@ namespace callback {
 /**
  * @brief Clip gradients whose norm is larger than a user-defined value by
  * dividing them.
+ *
+ * Clipping all gradients by their global norm is handed to the model
+ * (see model::set_gradient_clipping), which folds the scaling into the
+ * optimizer step.
  */
 class clip_gradient_norm : public callback_base
 {
@@ -97,6 +101,9 @@ private:
 
   /** Weights to update. */
   std::unordered_set<weights*> m_weights;
+
+  /** @brief Whether the model's optimizer step does the clipping. */
+  bool m_in_optimizer_step = false;
 };
 
 // Builder function
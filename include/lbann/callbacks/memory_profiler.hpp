@@ -32,6 +32,8 @@
 #include "lbann/callbacks/callback.hpp"
 
 #include <map>
+#include <string>
+#include <vector>
 
 namespace lbann {
 namespace callback {
@@ -42,13 +44,90 @@ namespace callback {
  */
 size_t get_used_gpu_memory();
 
+/** @brief What a tensor holds, for memory attribution. */
+enum class tensor_role
+{
+  activations,
+  error_signals,
+  weights,
+  gradients,
+  optimizer_state,
+  /** Memory not held by any tensor the model knows about
+   *  (workspaces, communication buffers, library handles). */
+  unattributed,
+};
+
+std::string to_string(tensor_role role);
+
+/** @brief Memory held by one tensor on this rank. */
+struct tensor_allocation
+{
+  /** Name of the owning layer or weights. */
+  std::string owner;
+  tensor_role role;
+  /** Allocated bytes on this rank. */
+  size_t bytes;
+  /** Whether the size grows with the mini-batch size. */
+  bool per_sample;
+};
+
+/**
+ * @brief Attribute the live tensors of a model to their owners.
+ *
+ * Every allocated activation and error signal is attributed to its
+ * layer, and every weights tensor, gradient and optimizer state to
+ * its weights. Views (e.g. of in-place layers) are not counted twice.
+ * Distconv tensors are not included.
+ */
+std::vector<tensor_allocation> take_memory_census(model& m);
+
+/**
+ * @brief Predict the peak memory of a rank at another mini-batch size.
+ *
+ * @param census Live tensors at the peak, taken at mini-batch size
+ *   @c census_mini_batch_size.
+ * @param mini_batch_size Mini-batch size to predict for.
+ * @returns Bytes needed by the tensors of @c census, with the
+ *   per-sample tensors scaled linearly to @c mini_batch_size. The
+ *   unattributed entries are assumed not to scale.
+ */
+size_t forecast_peak_memory(std::vector<tensor_allocation> const& census,
+                            size_t census_mini_batch_size,
+                            size_t mini_batch_size);
+
+/**
+ * @brief Largest mini-batch size whose forecast peak fits in
+ *        @c budget bytes.
+ *
+ * @returns 0 if no mini-batch fits, or the largest @c size_t if none
+ *   of the tensors grows with the mini-batch size.
+ */
+size_t
+largest_fitting_mini_batch_size(std::vector<tensor_allocation> const& census,
+                                size_t census_mini_batch_size,
+                                size_t budget);
+
 /**
  * Memory usage profiling
+ *
+ * In the third step, the live tensors are attributed to layers and
+ * weights by role at every layer boundary, and the census with the
+ * most memory is reported as the peak breakdown. The peak is then
+ * forecast for each of @c forecast_mini_batch_sizes, together with
+ * the largest mini-batch size that fits in the device memory. The
+ * census functions can also be used on a model set up with a small
+ * mini-batch to pick the mini-batch size of a run before setting it
+ * up.
+ *
+ * The GPU memory pool's cached blocks per bin and fragmentation are
+ * reported with the peak and at the end of every later epoch, since
+ * mini-batch size changes at epoch boundaries can fragment it.
  */
 class memory_profiler : public callback_base
 {
 public:
-  memory_profiler(bool detailed_first_step = false);
+  memory_profiler(bool detailed_first_step = false,
+                  std::vector<size_t> forecast_mini_batch_sizes = {});
   memory_profiler(const memory_profiler&) = default;
   memory_profiler& operator=(const memory_profiler&) = default;
   ~memory_profiler();
@@ -60,6 +139,7 @@ public:
   void on_setup_begin(model* m, Layer* l) override;
   void on_setup_end(model* m, Layer* l) override;
   void on_batch_end(model* m) override;
+  void on_epoch_end(model* m) override;
 
   // Used for detailed first-step accounting
   void on_forward_prop_begin(model* m) override;
@@ -76,6 +156,13 @@ public:
   void on_backward_prop_end(model* m, Layer* l) override;
 
   std::string name() const override { return "memory profiler"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_begin) |
+           hook_bit(layer_forward_prop_end) |
+           hook_bit(layer_backward_prop_begin) |
+           hook_bit(layer_backward_prop_end);
+  }
 
   /** @name Serialization */
   ///@{
@@ -94,7 +181,15 @@ private:
   void first_step_accounting(model* m, const std::string& msg);
 
   /** Performs peak memory usage collection in third step. */
-  void collect_peak_usage();
+  void collect_peak_usage(model* m);
+
+  /** Prints the tensors live at the peak and the forecasts. */
+  void report_peak_census(model* m);
+
+  /** Prints the GPU memory pool's usage, fragmentation and cached
+   *  blocks per bin.
+   */
+  void report_memory_pool() const;
 
   /** Add callback specific data to prototext */
   void write_specific_proto(lbann_data::Callback& proto) const final;
@@ -130,6 +225,15 @@ private:
    */
   size_t m_setup_end_usage, m_step0_usage, m_step1_usage, m_step2_usage,
     m_peak_mem_usage;
+
+  /** Mini-batch sizes to forecast the peak memory for. */
+  std::vector<size_t> m_forecast_mini_batch_sizes;
+
+  /** Live tensors at the largest census of the third step. */
+  std::vector<tensor_allocation> m_peak_census;
+
+  /** Bytes attributed in @c m_peak_census. */
+  size_t m_peak_census_bytes = 0;
 };
 
 // Builder function
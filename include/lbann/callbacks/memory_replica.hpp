@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_MEMORY_REPLICA_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_MEMORY_REPLICA_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+/**
+ * Keep a copy of each rank's weights and optimizer state in the host
+ * memory of a partner rank on another node.
+ *
+ * Every @c batch_interval steps each rank serializes its local shard
+ * of the weights and optimizer state and starts sending it to the
+ * rank one node ahead in its trainer, while receiving the shard of
+ * the rank one node behind. The exchange uses non-blocking
+ * point-to-point messages and is only waited for at the next
+ * interval, so it overlaps with training. No disk I/O is involved.
+ *
+ * restore() is the recovery path: ranks that lost their state get
+ * their last replicated shard back from their partner and every
+ * other rank rolls back to its own copy of the same step. A rank and
+ * its partner cannot both be lost.
+ */
+class memory_replica : public callback_base
+{
+public:
+  /** @param batch_interval Steps between replications. */
+  memory_replica(int batch_interval = 1) : callback_base(batch_interval) {}
+  /** Copies share the interval but not the replicas. */
+  memory_replica(const memory_replica& other)
+    : callback_base(other.m_batch_interval)
+  {}
+  memory_replica& operator=(const memory_replica&) = delete;
+  memory_replica* copy() const override { return new memory_replica(*this); }
+  void on_batch_end(model* m) override;
+  void on_train_end(model* m) override;
+  std::string name() const override { return "memory replica"; }
+
+  /** @brief Restore weights and optimizer state from the replicas.
+   *
+   *  Collective over the trainer.
+   *
+   *  @param m The model to restore.
+   *  @param lost Whether this rank lost its state.
+   *  @returns The step the state was restored to, or -1 if no rank
+   *           was lost.
+   */
+  El::Int restore(model& m, bool lost);
+
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Store state to archive for checkpoint and restart */
+  template <class Archive>
+  void serialize(Archive& ar);
+
+  ///@}
+
+private:
+  /** Add callback specific data to prototext */
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Wait for the exchange in flight, if any. */
+  void finish_exchange(lbann_comm const& comm);
+
+  /// This rank's state as of m_step.
+  std::string m_local;
+  /// The partner's state as of m_step.
+  std::string m_partner;
+  /// Partner state being received.
+  std::string m_incoming;
+  /// Step of the last replication; -1 before the first one.
+  El::Int m_step = -1;
+  /// Outstanding sends and receives.
+  std::vector<El::mpi::Request<El::byte>> m_requests;
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_memory_replica_callback_from_pbuf(const google::protobuf::Message&,
+                                        std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_MEMORY_REPLICA_HPP_INCLUDED
@@ -43,7 +43,10 @@ namespace callback {
  *     Zhang, H. et al. "mixup: Beyond Empirical Risk Minimization." ICLR, 2018.
  *
  * This implementation does mixup within a single batch, per the recommendation
- * within the paper.
+ * within the paper. Each step, the mini-batch is randomly split into pairs and
+ * both samples of a pair are mixed with each other (with independent mixing
+ * values), so the input and label matrices are updated in place in a single
+ * pass, on CPU or GPU.
  *
  * This approach may create duplicate images, and so uses
  *
@@ -63,6 +66,10 @@ public:
 
   mixup* copy() const override { return new mixup(*this); }
   std::string name() const override { return "mixup"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_end);
+  }
 
   void on_forward_prop_end(model* m, Layer* l) override;
 
@@ -88,6 +95,17 @@ private:
   float m_alpha;
 };
 
+#ifdef LBANN_HAS_GPU
+/** Mix the pairs of columns of samples and labels on the GPU.
+ *  Column pairs(0,k) is mixed with pairs(1,k), using the mixing values
+ *  lambdas(0,k) and lambdas(1,k) respectively.
+ */
+void mixup_pairs_gpu(El::Matrix<DataType, El::Device::GPU>& samples,
+                     El::Matrix<DataType, El::Device::GPU>& labels,
+                     const El::Matrix<El::Int, El::Device::GPU>& pairs,
+                     const El::Matrix<DataType, El::Device::GPU>& lambdas);
+#endif // LBANN_HAS_GPU
+
 // Builder function
 std::unique_ptr<callback_base>
 build_mixup_callback_from_pbuf(const google::protobuf::Message&,
@@ -31,19 +31,38 @@
 
 #include "lbann/callbacks/callback.hpp"
 
+#include <memory>
+
 namespace lbann {
 namespace callback {
 
-/**
+/** Mark training phases, layers and weights as profiler regions.
+ *  Collectives issued by the model's lbann_comm during training are
+ *  marked as regions named after their operation and tag.
+ *
+ *  Optionally, every @c layer_timing_interval training steps the
+ *  forward and backward pass of each layer is timed with GPU events
+ *  (host timers in CPU-only builds), so asynchronous kernel time is
+ *  included. Events are read back at the next timed step, so timing
+ *  does not stall the stream. At the end of each epoch the trainer
+ *  master prints the per-step averages, slowest layers first.
+ *
+ *  The trainer master also prints how long each training step waited
+ *  for data, spent in data store exchanges and kept each I/O thread
+ *  busy, and the distribution of mini-batch fetch latencies.
  */
 class profiler : public callback_base
 {
 public:
-  profiler(bool sync = false, bool skip_init = false);
+  profiler(bool sync = false,
+           bool skip_init = false,
+           int layer_timing_interval = 0);
   profiler(const profiler&) = default;
   profiler& operator=(const profiler&) = default;
   ~profiler();
   profiler* copy() const override { return new profiler(*this); }
+  void on_train_begin(model* m) override;
+  void on_train_end(model* m) override;
   void on_epoch_begin(model* m) override;
   void on_epoch_end(model* m) override;
   void on_validation_begin(model* m) override;
@@ -71,6 +90,16 @@ public:
   void on_optimize_begin(model* m, weights* w) override;
   void on_optimize_end(model* m, weights* w) override;
   std::string name() const override { return "profiler"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_begin) |
+           hook_bit(layer_forward_prop_end) |
+           hook_bit(layer_evaluate_forward_prop_begin) |
+           hook_bit(layer_evaluate_forward_prop_end) |
+           hook_bit(layer_backward_prop_begin) |
+           hook_bit(layer_backward_prop_end) |
+           hook_bit(weights_optimize_begin) | hook_bit(weights_optimize_end);
+  }
 
   /** @name Serialization */
   ///@{
@@ -91,6 +120,18 @@ private:
   bool m_sync;
   /** Whether to skip initial iterations. */
   bool m_skip_init;
+  /** Steps between per-layer timings; 0 disables them. */
+  int m_layer_timing_interval;
+
+  /** Per-layer timing state. */
+  struct layer_timing;
+  std::shared_ptr<layer_timing> m_layer_timing;
+
+  /** Print the per-layer timings of the epoch and reset them. */
+  void report_layer_timing(model* m);
+
+  /** Print the data pipeline stalls of the epoch. */
+  void report_data_pipeline(model* m);
 };
 
 // Builder function
@@ -55,14 +55,22 @@ public:
    * @param dir directory to save model
    * @param disable_save_after_training Don't save after training
    * @param extension file extension e.g., model, state ......
+   * @param weights_container Write all weights into a single binary
+   *        container instead of one Hydrogen file per weights
+   * @param compression_level zlib level for the container (0 to
+   *        store the tensors raw)
    */
   save_model(std::string dir,
              bool disable_save_after_training,
-             std::string extension = "prototext")
+             std::string extension = "prototext",
+             bool weights_container = false,
+             int compression_level = 0)
     : callback_base(),
       m_dir(std::move(dir)),
       m_disable_save_after_training(disable_save_after_training),
-      m_extension(std::move(extension))
+      m_extension(std::move(extension)),
+      m_weights_container(weights_container),
+      m_compression_level(compression_level)
   {}
   save_model(const save_model&) = default;
   save_model& operator=(const save_model&) = default;
@@ -86,6 +94,10 @@ private:
   /// Disables the normal behavior of saving when training is complete
   bool m_disable_save_after_training;
   std::string m_extension; // file extension
+  /// Save weights as a single binary container
+  bool m_weights_container;
+  /// zlib level for the weights container; 0 stores tensors raw
+  int m_compression_level;
   persist p;
 
   void write_proto_binary(const lbann_data::Model& proto,
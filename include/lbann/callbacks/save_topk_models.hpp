@@ -48,12 +48,21 @@ public:
    *  @param metric_name evaluation metric
    *  @param ascending_ordering use ascending ordering for the topk; descending
    *        order is default.
+   *  @param weights_container save into a single binary container,
+   *        which keeps frequent saves cheap
+   *  @param compression_level zlib level for the container
    */
   save_topk_models(std::string dir,
                    int k,
                    std::string metric_name,
-                   bool ascending_ordering = false)
-    : save_model(dir, true),
+                   bool ascending_ordering = false,
+                   bool weights_container = false,
+                   int compression_level = 0)
+    : save_model(dir,
+                 true,
+                 "prototext",
+                 weights_container,
+                 compression_level),
       m_k(k),
       m_metric_name(metric_name),
       m_ascending_ordering(ascending_ordering)
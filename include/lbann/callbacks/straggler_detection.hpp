@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// straggler_detection .hpp .cpp - Callback to report slow ranks
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_STRAGGLER_DETECTION_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_STRAGGLER_DETECTION_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+#include "lbann/comm_nb_request.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+/**
+ * Report the ranks that arrive last after forward propagation.
+ *
+ * Every process arrives at a non-blocking world barrier when its
+ * forward pass ends and waits on it when its backward pass begins,
+ * before any gradient is synchronized. The time a process is blocked
+ * there is how long it waited for the last process, so the lag of a
+ * rank is the longest wait minus its own. This needs no clock
+ * synchronization across nodes and costs each process only its
+ * lag. Waits are averaged over @c report_interval samples and
+ * gathered on the world master, which prints the slowest ranks with
+ * their hosts and the distribution of lags.
+ */
+class straggler_detection : public callback_base
+{
+public:
+  /**
+   * @param batch_interval Steps between samples.
+   * @param report_interval Samples between reports.
+   * @param num_ranks Number of slowest ranks to list.
+   */
+  straggler_detection(int batch_interval = 1,
+                      int report_interval = 100,
+                      int num_ranks = 8)
+    : callback_base(batch_interval),
+      m_report_interval(std::max(report_interval, 1)),
+      m_num_ranks(std::max(num_ranks, 0))
+  {}
+  straggler_detection(const straggler_detection&) = default;
+  straggler_detection& operator=(const straggler_detection&) = default;
+  straggler_detection* copy() const override
+  {
+    return new straggler_detection(*this);
+  }
+  void setup(model* m) override;
+  void on_train_end(model* m) override;
+  using callback_base::on_backward_prop_begin;
+  using callback_base::on_forward_prop_end;
+  void on_forward_prop_end(model* m) override;
+  void on_backward_prop_begin(model* m) override;
+  std::string name() const override { return "straggler detection"; }
+
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Store state to archive for checkpoint and restart */
+  template <class Archive>
+  void serialize(Archive& ar);
+
+  ///@}
+
+private:
+  /** Add callback specific data to prototext */
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Gather the mean waits and print the slowest ranks. */
+  void report(model* m);
+
+  /// Samples between reports.
+  int m_report_interval;
+  /// Number of slowest ranks to list.
+  int m_num_ranks;
+  /// Host name of each world rank (world master only).
+  std::vector<std::string> m_hosts;
+  /// Barrier this process has arrived at.
+  Al::request m_req;
+  /// Whether m_req is outstanding.
+  bool m_arrived = false;
+  /// Time this process arrived.
+  double m_arrival_time = 0.;
+  /// Total wait over the samples since the last report.
+  double m_total_wait = 0.;
+  /// Samples since the last report.
+  int m_num_samples = 0;
+};
+
+// Builder function
+std::unique_ptr<callback_base> build_straggler_detection_callback_from_pbuf(
+  const google::protobuf::Message&,
+  std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_STRAGGLER_DETECTION_HPP_INCLUDED
@@ -37,6 +37,11 @@ namespace callback {
 
 /**
  * Summarize information to Tensorboard using LBANN's summary interface.
+ * When training with K-FAC, the time of each phase of the step is
+ * summarized as kfac_time/\<phase\>. Data pipeline stalls are
+ * summarized under data_pipeline/: per step the time spent waiting
+ * for data and in data store exchanges and each I/O thread's busy
+ * and idle time, per epoch the fetch latency distribution.
  */
 class summary : public callback_base
 {
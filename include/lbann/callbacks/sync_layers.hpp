@@ -60,6 +60,10 @@ public:
   sync_layers& operator=(const sync_layers&) = default;
   sync_layers* copy() const override { return new sync_layers(*this); }
   std::string name() const override { return "sync_layers"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_end) | hook_bit(layer_backward_prop_end);
+  }
 
   using callback_base::on_backward_prop_end;
   using callback_base::on_forward_prop_end;
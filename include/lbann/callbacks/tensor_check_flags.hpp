@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_TENSOR_CHECK_FLAGS_HPP_INCLUDED
+#define LBANN_CALLBACKS_TENSOR_CHECK_FLAGS_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/optimizers/multi_tensor.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Entries that a tensor check looks for. */
+enum class tensor_check_kind
+{
+  /** NaN or inf. */
+  nonfinite,
+  /** Nonzero entries no larger than the square root of the smallest
+   *  normal value, which risk producing denormals. */
+  small
+};
+
+/** @brief Per-tensor flags raised when checked tensors hold bad
+ *         entries during a step.
+ *
+ *  Each tensor checked in a step gets a flag slot and a label. GPU
+ *  tensors are scanned by kernels that only raise their flag in
+ *  device memory, so checking never waits on the device. At the end
+ *  of the step, the flags are copied to pinned host memory in one
+ *  asynchronous copy, and they are read at the start of the next
+ *  step. Tensors queued with @c add are scanned together in one
+ *  launch. CPU tensors are scanned on the host.
+ */
+class tensor_check_flags
+{
+public:
+  explicit tensor_check_flags(tensor_check_kind kind);
+  tensor_check_flags(const tensor_check_flags& other);
+  tensor_check_flags& operator=(const tensor_check_flags& other);
+  ~tensor_check_flags();
+
+  /** @brief Start a step that checks at most @c max_tensors tensors. */
+  void begin_step(size_t max_tensors);
+
+  /** @brief Scan the local entries of a matrix without waiting. */
+  void check(const El::AbstractDistMatrix<DataType>& mat, std::string label);
+
+  /** @brief Queue a matrix to be scanned by check_added. */
+  void add(const El::AbstractDistMatrix<DataType>& mat, std::string label);
+
+  /** @brief Scan every queued matrix, in one launch for GPU data. */
+  void check_added();
+
+  /** @brief Start copying this step's flags to the host. */
+  void end_step();
+
+  /** @brief Labels of the tensors whose flags were raised in the
+   *         last ended step.
+   *  @details Waits for the flags' copy. Each step is reported once.
+   */
+  std::vector<std::string> tripped();
+
+private:
+  /** Claim the next flag slot for a tensor. */
+  size_t claim_slot(std::string label);
+  /** Scan a CPU matrix and raise its host flag. */
+  void check_cpu(const El::AbstractMatrix<DataType>& mat, size_t slot);
+
+  tensor_check_kind m_kind;
+  /** Labels of the tensors checked in the current step. */
+  std::vector<std::string> m_labels;
+  /** Flags raised on the host in the current step. */
+  std::vector<bool> m_host_flags;
+  /** Labels and host flags of the last ended step. */
+  std::vector<std::string> m_ended_labels;
+  std::vector<bool> m_ended_host_flags;
+  /** Matrices queued for check_added, with their slots. */
+  std::vector<std::pair<const El::AbstractMatrix<DataType>*, size_t>> m_added;
+
+#ifdef LBANN_HAS_GPU
+  /** One flag per slot, set to one on the device. */
+  El::Matrix<float, El::Device::GPU> m_flags_gpu;
+  /** Pinned host copy of the last ended step's flags. */
+  El::Matrix<float, El::Device::CPU> m_flags_host;
+  /** Recorded after the flags are copied to the host. */
+  gpu_lib::event_wrapper m_flags_event;
+  /** Staging area for fused launches. */
+  multi_tensor_workspace m_workspace;
+#endif // LBANN_HAS_GPU
+};
+
+#ifdef LBANN_HAS_GPU
+
+/** @brief A contiguous GPU buffer in a fused tensor check. */
+struct tensor_check_entry
+{
+  DataType const* buffer;
+  size_t size;
+  size_t slot;
+};
+
+/** @brief Set @c flags(slot) to one if the local matrix @c mat holds
+ *         an entry that trips the check.
+ *  @details Runs on @c mat's stream once @c flags is ready. */
+void tensor_check_gpu(tensor_check_kind kind,
+                      const El::Matrix<DataType, El::Device::GPU>& mat,
+                      size_t slot,
+                      El::Matrix<float, El::Device::GPU>& flags);
+
+/** @brief Check many contiguous buffers in one launch on @c flags'
+ *         stream. Clears @c entries. */
+void tensor_check_gpu(tensor_check_kind kind,
+                      std::vector<tensor_check_entry>& entries,
+                      multi_tensor_workspace& workspace,
+                      El::Matrix<float, El::Device::GPU>& flags);
+
+#endif // LBANN_HAS_GPU
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_TENSOR_CHECK_FLAGS_HPP_INCLUDED
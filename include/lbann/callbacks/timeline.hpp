@@ -32,6 +32,7 @@
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/utils/timer.hpp"
 
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -44,15 +45,57 @@ namespace callback {
  * The logfile is named timeline.m\<model-rank\>.\<rank\>.txt.
  * Each line is a separate event, written as name:start-time:end-time.
  * Times are relative to the beginning of training.
+ *
+ * Gradient allreduces are logged as sync-\<n\> from launch to
+ * completion, and the part a consumer spent blocked on them as
+ * syncwait-\<n\>. A syncwait much shorter than its sync means the
+ * allreduce was hidden behind backprop.
+ *
+ * Collectives issued through lbann_comm are logged as
+ * coll-\<op\>-\<tag\>-\<n\>, and a per-rank summary of their
+ * calls, bytes, time and bandwidth is written to
+ * collectives.m\<model-rank\>.\<rank\>.txt. If sync_collectives is
+ * set, the GPU is synchronized after each collective so that its
+ * time covers the transfer rather than the enqueue.
+ *
+ * When training with K-FAC, each phase of a K-FAC step (forward and
+ * backward exchanges, inverse communication, preconditioning, ...)
+ * is logged as kfac-\<phase\>-\<n\>.
+ *
+ * Mini-batch fetches by the data coordinator are logged as
+ * fetch-\<buffer\>-\<n\>.
+ *
+ * With the "chrome" format the events are written as Chrome
+ * trace-event JSON instead, which Perfetto and chrome://tracing
+ * load directly. The trainer master gathers the events of all its
+ * ranks into timeline.m\<model-rank\>.json, with one process per
+ * rank and one track each for compute, gradient syncs, collectives
+ * and every I/O thread. Communication is traced as async events
+ * since it may overlap.
  */
 class timeline : public callback_base
 {
 public:
-  timeline(std::string outdir) : callback_base(1), m_outdir(outdir) {}
+  timeline(std::string outdir,
+           bool sync_collectives = false,
+           std::string format = "text")
+    : callback_base(1),
+      m_outdir(outdir),
+      m_sync_collectives(sync_collectives),
+      m_format(std::move(format))
+  {}
   timeline(const timeline&) = default;
   timeline& operator=(const timeline&) = default;
   timeline* copy() const override { return new timeline(*this); }
   std::string name() const override { return "timeline"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_begin) |
+           hook_bit(layer_forward_prop_end) |
+           hook_bit(layer_backward_prop_begin) |
+           hook_bit(layer_backward_prop_end) |
+           hook_bit(weights_optimize_begin) | hook_bit(weights_optimize_end);
+  }
   void on_train_begin(model* m) override;
   void on_train_end(model* m) override;
 
@@ -86,11 +129,40 @@ private:
   friend class cereal::access;
   timeline();
 
+  /** Tracks that events are grouped into. */
+  struct trace_track
+  {
+    static constexpr int compute = 0;
+    static constexpr int gradient_sync = 1;
+    static constexpr int collective = 2;
+    /** I/O thread n is on track io_thread + n. */
+    static constexpr int io_thread = 16;
+  };
+  /** One traced interval; times are relative to the start time. */
+  struct trace_event
+  {
+    std::string name;
+    /** Sequence number within its kind, or -1. */
+    El::Int index;
+    int track;
+    EvalType start;
+    EvalType end;
+  };
+
+  /** Gather the events of the trainer and write them as Chrome
+   *  trace-event JSON. Collective over the trainer. */
+  void write_chrome_trace(lbann_comm& comm,
+                          std::vector<trace_event> const& events) const;
+
   /// Get time relative to the start time.
   EvalType get_rel_time() const { return get_time() - m_start_time; }
 
   /// Directory to write output to.
   std::string m_outdir;
+  /// Synchronize the GPU after each traced collective.
+  bool m_sync_collectives = false;
+  /// Output format, "text" or "chrome".
+  std::string m_format = "text";
   /// Time training started; all times are relative to this.
   EvalType m_start_time = EvalType(0);
   /// Time the current layer's forward pass started.
@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_WATCHDOG_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_WATCHDOG_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class data_coordinator;
+class lbann_comm;
+
+namespace callback {
+
+/**
+ * Dump the state of a process whose training stalls.
+ *
+ * A watchdog thread compares the time spent in the current
+ * mini-batch step with @c slowdown times the median of the last
+ * @c window training steps, and never less than @c min_timeout
+ * seconds. When a step runs over, the training thread is interrupted
+ * with SIGUSR2 for its stack trace, which is written with the
+ * collectives in flight and the state of the data coordinator to
+ * \<prefix\>_rank\<world rank\>.txt. A hang stalls every process, so
+ * each writes its own dump without communicating. Sending SIGUSR2 to
+ * a process while it trains dumps it on demand.
+ *
+ * Evaluation steps are watched with the training timeout. Time
+ * between steps, e.g. in epoch-end callbacks, is not watched. The
+ * signal handler only writes the raw backtrace of the training
+ * thread. The watchdog thread writes the dump within a second,
+ * reading the collectives and data coordinator state while training
+ * runs, so on a process that is not stalled they may be slightly
+ * out of date.
+ */
+class watchdog : public callback_base
+{
+public:
+  /**
+   * @param slowdown Timeout as a multiple of the median step time.
+   * @param window Training steps in the rolling median.
+   * @param min_timeout Minimum timeout in seconds, also used until
+   *                    the first step completes.
+   * @param prefix Prefix of the dump files.
+   */
+  watchdog(double slowdown = 10.,
+           int window = 100,
+           double min_timeout = 300.,
+           std::string prefix = "watchdog");
+  /** Copies the parameters but not the watchdog thread. */
+  watchdog(const watchdog& other);
+  watchdog& operator=(const watchdog& other);
+  ~watchdog() override;
+  watchdog* copy() const override { return new watchdog(*this); }
+  void on_train_begin(model* m) override;
+  void on_train_end(model* m) override;
+  void on_batch_begin(model* m) override;
+  void on_batch_end(model* m) override;
+  void on_batch_evaluate_begin(model* m) override;
+  void on_batch_evaluate_end(model* m) override;
+  std::string name() const override { return "watchdog"; }
+
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Store state to archive for checkpoint and restart */
+  template <class Archive>
+  void serialize(Archive& ar);
+
+  ///@}
+
+private:
+  /** Add callback specific data to prototext */
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Mark the start of a watched step. */
+  void begin_step(model* m);
+  /** Stop the watchdog thread and restore the signal handler. */
+  void stop();
+  /** Body of the watchdog thread. */
+  void watch();
+  /** Write this process's dump, given the training thread's stack. */
+  void dump(std::string const& stack) const;
+
+  /// Timeout as a multiple of the median step time.
+  double m_slowdown;
+  /// Training steps in the rolling median.
+  int m_window;
+  /// Minimum timeout in seconds.
+  double m_min_timeout;
+  /// Prefix of the dump files.
+  std::string m_prefix;
+
+  /// Durations of the last training steps, as a ring buffer.
+  std::vector<double> m_step_times;
+  /// Next slot of m_step_times to overwrite.
+  size_t m_next_step_time = 0;
+
+  /// Communicator whose in-flight collectives are dumped.
+  lbann_comm* m_comm = nullptr;
+  /// Data coordinator whose state is dumped.
+  data_coordinator* m_data_coordinator = nullptr;
+  /// Thread that runs training and callbacks.
+  pthread_t m_train_thread{};
+
+  /// Whether a watched step is running.
+  std::atomic<bool> m_in_step{false};
+  /// Time the current step began.
+  std::atomic<double> m_step_start{0.};
+  /// Step counter of the current step.
+  std::atomic<uint64_t> m_step{0};
+  /// Current timeout in seconds.
+  std::atomic<double> m_timeout;
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  /// Tells the watchdog thread to exit. Guarded by m_mutex.
+  bool m_stop = false;
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_watchdog_callback_from_pbuf(const google::protobuf::Message&,
+                                  std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_WATCHDOG_HPP_INCLUDED
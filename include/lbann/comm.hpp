@@ -40,7 +40,12 @@
 
 #include "detect_El_mpi.hpp"
 
+#include <iosfwd>
 #include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
 #include <typeindex>
 #include <vector>
 
@@ -59,6 +64,40 @@ enum class GridType
   SECONDARY_GRID = 2
 };
 
+/** @brief Algorithm used for matrix allreduces. */
+enum class allreduce_algorithm
+{
+  /** Single allreduce over the whole communicator. */
+  flat,
+  /** Reduce-scatter within each compute node, allreduce the shards
+   *  across nodes, then allgather within each node. */
+  hierarchical
+};
+
+/** @brief One collective call recorded by lbann_comm's tracing. */
+struct collective_record
+{
+  /** Call-site tag active when the collective was issued. */
+  std::string tag;
+  /** Collective operation, e.g. "allreduce". */
+  std::string op;
+  /** Algorithm and device, e.g. "flat/GPU". */
+  std::string algorithm;
+  /** Bytes contributed by this rank. */
+  size_t bytes;
+  /** Time the collective was issued. */
+  double start_time;
+  /** Time the collective completed on this rank. */
+  double end_time;
+
+  /** Achieved bandwidth in bytes per second. */
+  double bandwidth() const noexcept
+  {
+    const double t = end_time - start_time;
+    return t > 0. ? static_cast<double>(bytes) / t : 0.;
+  }
+};
+
 /* Notes on Synchronization
  *
  * The updated interface exposes a synchronization handle/device
@@ -126,8 +165,17 @@ public:
    *  @param trainer_grid_height Height of 2D process grid for each
    *  trainer. Must divide @c procs_per_trainer. Default grid is
    *  approximately square.
+   *  @param topology_aware Place ranks by network location instead
+   *  of world rank. Each rank's location is LBANN_TOPOLOGY_ADDR or
+   *  the launcher's SLURM_TOPOLOGY_ADDR (switch.switch.node), falling
+   *  back to the host name. Ranks are sorted by location and each
+   *  trainer takes a contiguous block, so a trainer spans as few
+   *  switches and nodes as possible and the process columns of its
+   *  grid fill a node before moving on.
    */
-  void split_trainers(int procs_per_trainer = -1, int trainer_grid_height = -1);
+  void split_trainers(int procs_per_trainer = -1,
+                      int trainer_grid_height = -1,
+                      bool topology_aware = false);
 
   /** Split the commicator for the given trainer into primary and secondary
    *
@@ -164,7 +212,10 @@ public:
   inline int get_world_rank(int trainer, int rank) const noexcept
   {
     if (m_secondary_grid_ranks.size() == 0) {
-      return m_procs_per_trainer * trainer + rank;
+      const int position = m_procs_per_trainer * trainer + rank;
+      return m_world_rank_of_position.empty()
+               ? position
+               : m_world_rank_of_position[position];
     }
     else {
       return (m_secondary_grid_ranks.size() + m_primary_grid_ranks.size()) *
@@ -175,12 +226,12 @@ public:
   /** Return the "rank" of the trainer that this rank is in */
   inline int map_world_rank_to_trainer_rank(int world_rank) const noexcept
   {
-    return (world_rank / m_procs_per_trainer);
+    return (get_placement_position(world_rank) / m_procs_per_trainer);
   }
   /** Return the "rank" within the trainer that this rank is in */
   inline int map_world_rank_to_rank_in_trainer(int world_rank) const noexcept
   {
-    return (world_rank % m_procs_per_trainer);
+    return (get_placement_position(world_rank) % m_procs_per_trainer);
   }
   /** Return the rank of the master process in this trainer. */
   inline int get_trainer_master() const noexcept { return 0; }
@@ -590,34 +641,53 @@ public:
                  int count,
                  const El::mpi::Comm& c,
                  El::mpi::Op op = El::mpi::SUM) const;
-  /** Matrix allreduce. */
+  /** Matrix allreduce.
+   *  The hierarchical algorithm falls back to a flat allreduce when
+   *  @c c lives on a single node, has one process per node, has an
+   *  uneven number of processes per node, or when @c m is not
+   *  contiguous or is smaller than the number of processes per node.
+   */
   template <typename TensorDataType>
   void allreduce(El::AbstractMatrix<TensorDataType>& m,
                  const El::mpi::Comm& c,
-                 El::mpi::Op op = El::mpi::SUM) const;
+                 El::mpi::Op op = El::mpi::SUM,
+                 allreduce_algorithm algo = allreduce_algorithm::flat) const;
   /** Matrix allreduce. */
   template <typename TensorDataType>
   void allreduce(El::AbstractDistMatrix<TensorDataType>& m,
                  const El::mpi::Comm& c,
-                 El::mpi::Op op = El::mpi::SUM) const;
+                 El::mpi::Op op = El::mpi::SUM,
+                 allreduce_algorithm algo = allreduce_algorithm::flat) const;
+  /** Treat every @c n consecutive processes of a communicator as one
+   *  node in hierarchical allreduces, instead of the physical compute
+   *  nodes. This lets the hierarchical algorithm run on a single
+   *  node, e.g. in tests. 0 restores the physical grouping.
+   */
+  void set_hierarchical_node_size(int n);
   /** Non-blocking matrix allreduce.
    *  If LBANN has not been built with Aluminum, then this calls a
-   *  blocking matrix allreduce.
+   *  blocking matrix allreduce. The hierarchical algorithm is always
+   *  blocking and leaves @c req untouched.
    */
   template <typename TensorDataType>
-  void nb_allreduce(El::AbstractMatrix<TensorDataType>& m,
-                    const El::mpi::Comm& c,
-                    Al::request& req,
-                    El::mpi::Op op = El::mpi::SUM) const;
+  void
+  nb_allreduce(El::AbstractMatrix<TensorDataType>& m,
+               const El::mpi::Comm& c,
+               Al::request& req,
+               El::mpi::Op op = El::mpi::SUM,
+               allreduce_algorithm algo = allreduce_algorithm::flat) const;
   /** Non-blocking matrix allreduce.
    *  If LBANN has not been built with Aluminum, then this calls a
-   *  blocking matrix allreduce.
+   *  blocking matrix allreduce. The hierarchical algorithm is always
+   *  blocking and leaves @c req untouched.
    */
   template <typename TensorDataType>
-  void nb_allreduce(El::AbstractDistMatrix<TensorDataType>& m,
-                    const El::mpi::Comm& c,
-                    Al::request& req,
-                    El::mpi::Op op = El::mpi::SUM) const;
+  void
+  nb_allreduce(El::AbstractDistMatrix<TensorDataType>& m,
+               const El::mpi::Comm& c,
+               Al::request& req,
+               El::mpi::Op op = El::mpi::SUM,
+               allreduce_algorithm algo = allreduce_algorithm::flat) const;
   /** Non-blocking in-place scalar-array allreduce.
    *  If LBANN has not been built with Aluminum, then this calls a blocking
    *  allreduce.
@@ -630,6 +700,42 @@ public:
                     Al::request& req,
                     El::mpi::Op op = El::mpi::SUM) const;
 
+  /** Sum a matrix replicated over its grid and scatter the columns
+   *  of the result to a column-sharded matrix.
+   *  Each process only receives the columns it owns in @c dst, so the
+   *  traffic is that of a reduce-scatter rather than an allreduce.
+   *  Requires is_column_reduce_scatter_supported(src, dst).
+   */
+  template <typename TensorDataType>
+  void
+  reduce_scatter_columns(const El::AbstractDistMatrix<TensorDataType>& src,
+                         El::AbstractDistMatrix<TensorDataType>& dst) const;
+  /** Whether @c src is [STAR,STAR] and @c dst is an element-wise
+   *  [STAR,VC] matrix of the same size on the same grid. */
+  template <typename TensorDataType>
+  static bool is_column_reduce_scatter_supported(
+    const El::AbstractDistMatrix<TensorDataType>& src,
+    const El::AbstractDistMatrix<TensorDataType>& dst);
+
+  /** Register an in-place matrix allreduce for repeated use.
+   *  Any collective previously registered in @c req is released.
+   *  Collective over @c c. The matrix buffer must outlive @c req, or
+   *  be registered again once it changes.
+   */
+  template <typename TensorDataType>
+  void persistent_allreduce_init(El::AbstractMatrix<TensorDataType>& m,
+                                 const El::mpi::Comm& c,
+                                 Al::persistent_request& req,
+                                 El::mpi::Op op = El::mpi::SUM) const;
+  /** Start a registered collective. */
+  void start(Al::persistent_request& req) const;
+  /** Wait for a registered collective to complete. */
+  void wait(Al::persistent_request& req) const;
+  /** Test whether a registered collective has completed. */
+  bool test(Al::persistent_request& req) const;
+  /** Release a registered collective; it must not be in flight. */
+  void free(Al::persistent_request& req) const;
+
   /** Wait for a all non-blocking requests to complete. */
   template <typename T>
   void wait_all(std::vector<El::mpi::Request<T>>& req) const;
@@ -651,6 +757,9 @@ public:
   void global_barrier() const;
   /** Barrier on an arbitrary communicator. */
   void barrier(const El::mpi::Comm& c) const;
+  /** Non-blocking barrier on an arbitrary communicator. Arrive now;
+   *  wait() or test() on @c req tells when every process arrived. */
+  void nb_barrier(const El::mpi::Comm& c, Al::request& req) const;
 
   /** Send a buffer to rank in trainer. */
   template <typename T>
@@ -786,6 +895,16 @@ public:
   void nb_recv(AbsMat& mat, El::mpi::Request<DataType>& req) const;
   void nb_recv(DistMat& mat, El::mpi::Request<DataType>& req) const;
 
+  /** Exchange equally sized matrices with a rank in the world
+   *  communicator. Contiguous device-memory matrices go straight
+   *  through Aluminum's NCCL or host-transfer backend, without
+   *  staging through host buffers.
+   */
+  template <typename TensorDataType>
+  void sendrecv_matrix(const El::AbstractMatrix<TensorDataType>& snd,
+                       El::AbstractMatrix<TensorDataType>& rcv,
+                       int partner_rank_in_world) const;
+
   /** Send/recv to/from ranks. */
   template <typename T, El::Device D>
   void sendrecv(const T* snd,
@@ -859,6 +978,63 @@ public:
     m_bytes_received = 0;
   }
 
+  /** @name Collective tracing
+   *
+   *  When enabled, matrix allreduces and reduce-scatters, buffer
+   *  allreduces, broadcasts and allgathers, and persistent
+   *  allreduces through this object are recorded with the tag set by
+   *  the innermost collective_tag_scope. Non-blocking collectives
+   *  complete when they are waited on or test true. GPU collectives
+   *  are timed on the host, so without synchronization their times
+   *  only cover the enqueue.
+   */
+  ///@{
+  /** @brief Record collectives, optionally synchronizing the GPU
+   *         after each so that times include the transfer. */
+  void set_collective_tracing(bool enable, bool synchronize = false) noexcept
+  {
+    m_trace_collectives = enable;
+    m_sync_traced_collectives = synchronize;
+  }
+  bool is_collective_tracing() const noexcept { return m_trace_collectives; }
+  /** @brief Open a profiler region around each collective call. */
+  void set_collective_profiling(bool enable) noexcept
+  {
+    m_profile_collectives = enable;
+  }
+  /** @brief Return and clear the collectives recorded so far. */
+  std::vector<collective_record> take_collective_records() const;
+  /** @brief Write the calls, bytes, time and bandwidth of the traced
+   *         collectives, per tag, operation and algorithm. The
+   *         summary survives take_collective_records. */
+  void print_collective_summary(std::ostream& os) const;
+  void reset_collective_summary() const noexcept;
+  /** @brief Keep the collectives that are in flight, independently
+   *         of tracing, so that a hang can be diagnosed. */
+  void set_pending_collective_tracking(bool enable) noexcept
+  {
+    m_track_pending_collectives = enable;
+  }
+  /** @brief Collectives issued but not yet completed, oldest first.
+   *         Their end time is unset and equals the start time. */
+  std::vector<collective_record> get_pending_collectives() const;
+
+  /** @brief Tag the collectives issued during this object's
+   *         lifetime. Scopes nest. */
+  class collective_tag_scope
+  {
+  public:
+    collective_tag_scope(lbann_comm const& comm, std::string tag);
+    ~collective_tag_scope();
+    collective_tag_scope(collective_tag_scope const&) = delete;
+    collective_tag_scope& operator=(collective_tag_scope const&) = delete;
+
+  private:
+    lbann_comm const& m_comm;
+    std::string m_parent_tag;
+  };
+  ///@}
+
   /** Return true if mat can be transmitted. */
   static inline bool is_sendable(const AbsMat& mat) noexcept
   {
@@ -955,6 +1131,28 @@ private:
   El::mpi::Comm m_combined_grid_comm;
   /** Packed group communicators. */
   mutable std::unordered_map<int, El::mpi::Comm> m_group_communicators;
+  /** Node-local and cross-node sub-communicators of a communicator,
+   *  used by the hierarchical allreduce. */
+  struct hierarchical_comms
+  {
+    hierarchical_comms(MPI_Comm intra, MPI_Comm inter, bool use)
+      : intra_node(intra), inter_node(inter), enabled(use)
+    {}
+    /** Processes of the parent communicator on this node. */
+    El::mpi::Comm intra_node;
+    /** Processes of the parent communicator with the same rank in
+     *  @c intra_node. */
+    El::mpi::Comm inter_node;
+    /** Whether the hierarchy is worth using for this communicator. */
+    bool enabled;
+  };
+  /** Hierarchical sub-communicators, keyed by parent communicator.
+   *  Cleared whenever the trainer communicators are rebuilt, since MPI
+   *  can hand out a freed handle again. */
+  mutable std::map<MPI_Comm, hierarchical_comms> m_hierarchical_comms;
+  /** Processes per node in hierarchical allreduces, or 0 to use the
+   *  physical compute nodes. */
+  int m_hierarchical_node_size = 0;
   /** Grid for this trainer. */
   std::unique_ptr<El::Grid> m_grid;
   /** Number of trainers. */
@@ -989,6 +1187,24 @@ private:
   Ranks in primary and secondary grids
   */
   std::vector<int> m_primary_grid_ranks;
+
+  /** World rank placed at each trainer-major position
+   *  (trainer * procs_per_trainer + rank in trainer). Empty when
+   *  ranks are placed in world order. */
+  std::vector<int> m_world_rank_of_position;
+  /** Inverse of m_world_rank_of_position. */
+  std::vector<int> m_position_of_world_rank;
+
+  /** Trainer-major position of a world rank. */
+  int get_placement_position(int world_rank) const noexcept
+  {
+    return m_position_of_world_rank.empty()
+             ? world_rank
+             : m_position_of_world_rank[world_rank];
+  }
+  /** World ranks sorted by network location. Collective over the
+   *  world communicator. */
+  std::vector<int> get_topology_order() const;
   std::vector<int> m_secondary_grid_ranks;
 
   // Various statistics counters.
@@ -998,9 +1214,70 @@ private:
   mutable size_t m_bytes_sent;
   mutable size_t m_bytes_received;
 
+  /** Traces one collective from construction to destruction, or to
+   *  completion of the request it is handed to. */
+  class traced_collective
+  {
+  public:
+    traced_collective(lbann_comm const& comm,
+                      char const* op,
+                      char const* algorithm,
+                      El::Device device,
+                      size_t bytes);
+    ~traced_collective();
+    traced_collective(traced_collective const&) = delete;
+    traced_collective& operator=(traced_collective const&) = delete;
+    /** Finish the record when the request at @c req completes
+     *  instead. */
+    void defer_to(void const* req);
+
+  private:
+    lbann_comm const& m_comm;
+    size_t m_record;
+    size_t m_pending;
+    std::string m_region;
+  };
+  /** Stamp the end time of a record and add it to the summary. */
+  void finish_collective_record(size_t record) const;
+  /** Finish the record deferred to @c req, if any. */
+  void end_deferred_collective(void const* req) const;
+
+  bool m_trace_collectives = false;
+  bool m_sync_traced_collectives = false;
+  bool m_profile_collectives = false;
+  bool m_track_pending_collectives = false;
+  /** In-flight collectives by issue order, when tracked. */
+  mutable std::map<size_t, collective_record> m_pending_collectives;
+  /** Guards m_pending_collectives, which a watchdog thread reads. */
+  mutable std::mutex m_pending_collectives_mutex;
+  mutable size_t m_next_pending_collective = 0;
+  /** Pending entries of non-blocking collectives, by request. */
+  mutable std::unordered_map<void const*, size_t>
+    m_deferred_pending_collectives;
+  /** Tag of the innermost collective_tag_scope. */
+  mutable std::string m_collective_tag = "untagged";
+  mutable std::vector<collective_record> m_collective_records;
+  /** Records of non-blocking collectives still in flight. */
+  mutable std::unordered_map<void const*, size_t> m_deferred_collectives;
+  struct collective_totals
+  {
+    size_t calls = 0;
+    size_t bytes = 0;
+    double time = 0.;
+  };
+  /** Totals keyed by (tag, op, algorithm). */
+  mutable std::map<std::tuple<std::string, std::string, std::string>,
+                   collective_totals>
+    m_collective_summary;
+
   /** Setup communicator for processes in the same compute node. */
   void setup_node_comm();
 
+  /** Get (building on first use) the hierarchical sub-communicators
+   *  of @c c. Collective over @c c on first use. */
+  const hierarchical_comms&
+  get_hierarchical_comms(const El::mpi::Comm& c) const;
+
   /** Initialize the default number of threads per process.
    *  This is the number of OpenMP threads to use for parallel
    *  regions, provided omp_set_num_threads has not been called or the
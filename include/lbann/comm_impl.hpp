@@ -194,6 +194,7 @@ void lbann_comm::all_gather(const T* const src,
                             const El::mpi::Comm& c,
                             El::SyncInfo<D> const& syncInfo) const
 {
+  traced_collective trace(*this, "allgather", "flat", D, sizeof(T) * src_count);
   El::mpi::AllGather(src, src_count, rcv, rcv_count, c, syncInfo);
 }
 
@@ -663,6 +664,11 @@ void lbann_comm::allreduce(T const* const snd,
 {
   auto const size_c = El::mpi::Size(c);
   m_bytes_sent += count * sizeof(T);
+  traced_collective trace(*this,
+                          "allreduce",
+                          "flat",
+                          El::Device::CPU,
+                          sizeof(T) * count);
 #ifdef LBANN_HAS_ALUMINUM
 #ifdef LBANN_ALUMINUM_MPI_PASSTHROUGH
   ::Al::MPIAllreduceAlgorithm algo =
@@ -691,6 +697,11 @@ void lbann_comm::allreduce(T* const data,
 {
   auto const size_c = El::mpi::Size(c);
   m_bytes_sent += count * sizeof(T);
+  traced_collective trace(*this,
+                          "allreduce",
+                          "flat",
+                          El::Device::CPU,
+                          sizeof(T) * count);
 #ifdef LBANN_HAS_ALUMINUM
 #ifdef LBANN_ALUMINUM_MPI_PASSTHROUGH
   ::Al::MPIAllreduceAlgorithm algo =
@@ -1066,6 +1077,7 @@ void lbann_comm::broadcast(const int root,
   // Avoid linking error from uninstantiated El::mpi routine if !S by converting
   // T to El::byte
   using TT = typename interpret_as_byte_if_needed<S, T>::type;
+  traced_collective trace(*this, "broadcast", "flat", D, sizeof(T) * count);
   El::mpi::Broadcast<TT>(reinterpret_cast<TT*>(data), size, root, c, syncInfo);
   count_bytes_broadcast(sizeof(T) * count, rank_c, root);
 }
@@ -1080,18 +1092,24 @@ void lbann_comm::broadcast<std::string>(int root,
 #define PROTO(T)                                                               \
   extern template void lbann_comm::allreduce(El::AbstractMatrix<T>& m,         \
                                              const El::mpi::Comm& c,           \
-                                             El::mpi::Op op) const;            \
+                                             El::mpi::Op op,                   \
+                                             allreduce_algorithm algo) const;  \
   extern template void lbann_comm::allreduce(El::AbstractDistMatrix<T>& m,     \
                                              const El::mpi::Comm& c,           \
-                                             El::mpi::Op op) const;            \
-  extern template void lbann_comm::nb_allreduce(El::AbstractMatrix<T>& m,      \
-                                                const El::mpi::Comm& c,        \
-                                                Al::request& req,              \
-                                                El::mpi::Op op) const;         \
-  extern template void lbann_comm::nb_allreduce(El::AbstractDistMatrix<T>& m,  \
-                                                const El::mpi::Comm& c,        \
-                                                Al::request& req,              \
-                                                El::mpi::Op op) const
+                                             El::mpi::Op op,                   \
+                                             allreduce_algorithm algo) const;  \
+  extern template void lbann_comm::nb_allreduce(                               \
+    El::AbstractMatrix<T>& m,                                                  \
+    const El::mpi::Comm& c,                                                    \
+    Al::request& req,                                                          \
+    El::mpi::Op op,                                                            \
+    allreduce_algorithm algo) const;                                           \
+  extern template void lbann_comm::nb_allreduce(                               \
+    El::AbstractDistMatrix<T>& m,                                              \
+    const El::mpi::Comm& c,                                                    \
+    Al::request& req,                                                          \
+    El::mpi::Op op,                                                            \
+    allreduce_algorithm algo) const
 
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
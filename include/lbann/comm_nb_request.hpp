@@ -33,6 +33,11 @@
 #include <Al.hpp>
 #endif // LBANN_HAS_ALUMINUM
 
+#include <mpi.h>
+
+#include <cstddef>
+#include <functional>
+
 namespace lbann {
 
 namespace Al {
@@ -79,6 +84,49 @@ struct request
   hosttransfer_req_type hosttransfer_req = hosttransfer_null_req;
   MPI_Request raw_mpi_req = MPI_REQUEST_NULL;
 };
+
+/** Collective registered once on a fixed buffer and restarted.
+ *
+ *  Host buffers use an MPI-4 persistent collective, so argument
+ *  checking and schedule setup are paid once. Other buffers re-issue
+ *  a non-blocking collective on every start.
+ */
+struct persistent_request
+{
+  persistent_request() = default;
+  persistent_request(persistent_request const&) = delete;
+  persistent_request& operator=(persistent_request const&) = delete;
+  ~persistent_request()
+  {
+    if (persistent_mpi_req != MPI_REQUEST_NULL) {
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if (!finalized) {
+        MPI_Request_free(&persistent_mpi_req);
+      }
+    }
+  }
+
+  /** Whether the collective was registered on this buffer. */
+  bool is_registered_on(void const* buf, size_t n) const noexcept
+  {
+    return registered && buffer == buf && count == n;
+  }
+
+  /** MPI persistent collective; MPI_REQUEST_NULL if not available. */
+  MPI_Request persistent_mpi_req = MPI_REQUEST_NULL;
+  /** Request of the re-issued collective. */
+  request req;
+  /** Re-issues the collective into @c req. */
+  std::function<void(request&)> restart;
+  /** Buffer and element count the collective was registered on. */
+  void const* buffer = nullptr;
+  size_t count = 0;
+  /** Bytes accounted to the communicator per start. */
+  size_t bytes_sent = 0;
+  size_t bytes_received = 0;
+  bool registered = false;
+};
 } // namespace Al
 
 } // namespace lbann
@@ -30,8 +30,63 @@
 #include "lbann/data_ingestion/data_coordinator.hpp"
 #include "lbann/data_ingestion/infrastructure/io_data_buffer.hpp"
 
+#include <deque>
+#include <future>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
 namespace lbann {
 
+/** @brief Element type used to copy samples from the host to the device */
+enum class input_transfer_type
+{
+  /** Copy at the data coordinator's I/O data type */
+  full,
+  /** IEEE half precision */
+  fp16,
+  /** bfloat16, rounded to nearest even */
+  bf16,
+  /** Unsigned 8-bit integers, quantized by a fixed scale */
+  uint8,
+};
+
+#if defined(LBANN_HAS_GPU)
+/** @brief Gather columns of a device matrix.
+ *
+ *  Column @c j of @c dst is set to column @c indices(j) of @c src.
+ *  The width of @c dst determines how many columns are gathered.
+ */
+template <typename TensorDataType>
+void gather_columns(El::Matrix<TensorDataType, El::Device::GPU> const& src,
+                    El::Matrix<El::Int, El::Device::GPU> const& indices,
+                    El::Matrix<TensorDataType, El::Device::GPU>& dst);
+
+/** @brief Widen packed low-precision columns on the device.
+ *
+ *  @c src holds the columns of @c dst consecutively, each with
+ *  @c dst.Height() entries of @c type. Quantized entries are
+ *  multiplied by @c scale.
+ */
+template <typename TensorDataType>
+void unpack_columns(input_transfer_type type,
+                    float scale,
+                    El::byte const* src,
+                    El::Matrix<TensorDataType, El::Device::GPU>& dst);
+
+/** @brief Fill a device matrix with synthetic samples.
+ *
+ *  With @c num_labels > 0, each column is one-hot at a random row
+ *  below @c num_labels; otherwise the entries are standard normal.
+ *  Entries are a hash of @c seed and their position, so no generator
+ *  state is kept on the device.
+ */
+template <typename TensorDataType>
+void generate_synthetic_columns(El::Int num_labels,
+                                uint64_t seed,
+                                El::Matrix<TensorDataType, El::Device::GPU>& dst);
+#endif // LBANN_HAS_GPU
+
 template <typename TensorDataType>
 class buffered_data_coordinator : public data_coordinator
 {
@@ -52,35 +107,39 @@ public:
   typedef std::map<execution_mode, std::unique_ptr<data_buffer<IODataType>>>
     data_buffer_map_t;
 
+  /** @brief Number of slots in the prefetch ring when not specified
+   *  (classic double buffering). */
+  static constexpr size_t default_num_io_buffers = 2;
+
 public:
-  buffered_data_coordinator(lbann_comm* comm) : data_coordinator(comm)
+  buffered_data_coordinator(lbann_comm* comm,
+                            size_t num_io_buffers = default_num_io_buffers)
+    : data_coordinator(comm)
   {
-
-    // Initialize two buffers
-    m_data_buffers.resize(2);
-    m_current_mini_batch_size.resize(2);
-    for (size_t i = 0; i < m_data_buffers.size(); i++) {
-      for (auto m : execution_mode_iterator()) {
-        if (m != execution_mode::invalid) {
-          m_data_buffers[i][m] =
-            std::make_unique<data_buffer<IODataType>>(comm);
-          m_current_mini_batch_size[i][m] = 0;
-        }
-      }
-    }
+    allocate_data_buffers(num_io_buffers);
 
     for (auto m : execution_mode_iterator()) {
       if (m != execution_mode::invalid) {
         this->m_active_buffer[m].store(0);
+        m_next_fetch_buffer_idx[m] = 0;
       }
     }
   }
 
-  ~buffered_data_coordinator() {}
+  ~buffered_data_coordinator()
+  {
+#if defined(LBANN_HAS_GPU)
+    El::DestroySyncInfo(m_transfer_sync_info);
+#endif // LBANN_HAS_GPU
+  }
 
   // Data Coordinators copy their data readers.
   buffered_data_coordinator(const buffered_data_coordinator& other)
-    : data_coordinator(other)
+    : data_coordinator(other),
+      m_next_fetch_buffer_idx(other.m_next_fetch_buffer_idx),
+      m_device_resident_data(other.m_device_resident_data),
+      m_transfer_type(other.m_transfer_type),
+      m_transfer_scale(other.m_transfer_scale)
   {
     m_data_buffers.resize(other.m_data_buffers.size());
     m_current_mini_batch_size.resize(other.m_current_mini_batch_size.size());
@@ -101,6 +160,10 @@ public:
   buffered_data_coordinator& operator=(const buffered_data_coordinator& other)
   {
     data_coordinator::operator=(other);
+    m_next_fetch_buffer_idx = other.m_next_fetch_buffer_idx;
+    m_device_resident_data = other.m_device_resident_data;
+    m_transfer_type = other.m_transfer_type;
+    m_transfer_scale = other.m_transfer_scale;
     m_data_buffers.clear();
     m_data_buffers.resize(other.m_data_buffers.size());
     m_current_mini_batch_size.clear();
@@ -124,8 +187,51 @@ public:
   template <class Archive>
   void serialize(Archive& ar);
 
+  /** @brief Resize the ring of I/O buffers.
+   *
+   *  With @c num_io_buffers slots, up to @c num_io_buffers-1
+   *  mini-batches are fetched ahead of the active one. Must be called
+   *  before any data field is registered.
+   */
+  void set_num_io_buffers(size_t num_io_buffers) override;
+
+  size_t get_num_io_buffers() const { return m_data_buffers.size(); }
+
+  /** @brief Keep each data set resident in device memory.
+   *
+   *  On the first fetch for an execution mode, every sample of the
+   *  data set is fetched once through the data reader and cached on
+   *  the device. Mini-batches are then gathered on the GPU from the
+   *  shuffled indices and the host fetch path is skipped. Samples are
+   *  cached after the data reader's transforms, so this is only
+   *  appropriate for deterministic pipelines and data sets that fit
+   *  in device memory (e.g. MNIST, CIFAR-10, preloaded local-cache
+   *  data stores).
+   */
+  void set_device_resident_data(bool device_resident);
+
+  bool is_device_resident_data() const { return m_device_resident_data; }
+
+  /** @brief Copy samples to GPU input layers at reduced precision.
+   *
+   *  The host buffers are packed to @c type ("fp16", "bf16" or
+   *  "uint8"; empty or "full" disables packing) before the
+   *  host-to-device copy and widened on the GPU, which cuts the
+   *  transfer by 2x or 4x. Quantized samples are stored as
+   *  round(x / @c scale) clamped to [0,255], so "uint8" is lossless
+   *  for pipelines whose host transforms emit multiples of
+   *  @c scale (e.g. to_lbann_layout with the normalization deferred
+   *  to the device). A zero @c scale selects 1/255.
+   */
+  void set_input_transfer_type(std::string const& type, float scale = 0.f);
+
+  input_transfer_type get_input_transfer_type() const
+  {
+    return m_transfer_type;
+  }
+
   /** @brief After registering the active data field, allocate storage for each
-   *  data field in the context maps within the double buffer.
+   *  data field in the context maps within the ring of buffers.
    */
   void register_active_data_field(
     data_field_type const& data_field,
@@ -161,6 +267,17 @@ public:
 
   bool ready_for_next_fetch(execution_mode mode) override;
 
+  void print_state(std::ostream& os) const override;
+
+  /** @brief Non-padding entries in the samples this rank consumed in
+   *  the last completed step.
+   *
+   *  Only counted when the data reader has variable-length samples;
+   *  the trainer-wide totals and padding fraction are reported at the
+   *  end of each epoch.
+   */
+  uint64_t get_num_effective_tokens(execution_mode mode) const;
+
   const data_buffer<IODataType>&
   get_data_buffer(const data_buffer_map_t& buffer_map,
                   const execution_mode mode) const;
@@ -184,6 +301,84 @@ protected:
                                 uint64_t relative_base_position,
                                 execution_mode mode);
 
+  /** @brief Queue a background fetch of a mini-batch into a buffer.
+   *
+   *  Requests are serviced in submission order by a single I/O
+   *  thread so that the data reader's work group is never shared
+   *  between concurrent fetches.
+   */
+  void start_background_fetch(int future_active_buffer,
+                              data_buffer<IODataType>& buf,
+                              uint64_t loaded_mini_batch_size,
+                              uint64_t relative_base_position,
+                              execution_mode mode);
+
+  /** @brief Block until the background fetch into a buffer is done
+   *  and record the wait in the pipeline stats. */
+  void wait_for_background_fetch(data_buffer<IODataType>& buf);
+
+  /** @brief Service queued background fetches until the queue is empty */
+  void drain_background_fetch_queue();
+
+  /** @brief Number of mini-batches that may be fetched ahead of the
+   *  active buffer. */
+  uint64_t get_prefetch_depth(execution_mode mode) const;
+
+  void allocate_data_buffers(size_t num_io_buffers);
+
+  /** @brief Allocate input buffers on the I/O threads.
+   *
+   *  Each buffer is resized to @c width columns by an I/O thread and
+   *  every I/O thread first-touches its share of the columns, so the
+   *  pages land on the I/O threads' NUMA domain instead of the
+   *  caller's. The I/O threads' scratch arenas are sized for one
+   *  sample the same way.
+   */
+  void place_input_buffers(
+    std::vector<std::pair<El::AbstractDistMatrix<IODataType>*, El::Int>> const&
+      buffers,
+    El::Int width);
+
+  /** @brief Count the non-padding entries of the samples in a
+   *  consumed buffer. */
+  void count_effective_tokens(execution_mode mode,
+                              const data_buffer<IODataType>& buf);
+
+  /** @brief Report the trainer's effective tokens for the epoch that
+   *  just ended and reset the counters. */
+  void report_effective_tokens(execution_mode mode);
+
+#if defined(LBANN_HAS_GPU)
+  /** @brief Start copying a fetched buffer to the device.
+   *
+   *  The host-to-device copy of every data field consumed by a GPU
+   *  input layer is issued on the transfer stream and an event is
+   *  recorded that the compute stream waits on in
+   *  distribute_from_local_matrix.
+   */
+  void stage_to_device(data_buffer<IODataType>& buf);
+
+  /** @brief Copy the local samples to the device at the input
+   *  transfer type and widen them into @c device_samples. */
+  void stage_packed_samples(
+    data_buffer<IODataType>& buf,
+    CPUMat const& host_samples,
+    El::Matrix<IODataType, El::Device::GPU>& device_samples);
+
+  /** @brief Fetch every sample of the data set into device memory */
+  void preload_device_resident_data(execution_mode mode);
+
+  /** @brief Build a mini-batch from the device-resident data set.
+   *
+   *  The columns are gathered into the buffer's device staging
+   *  matrices on the transfer stream.
+   */
+  void fetch_from_device_resident_data(data_buffer<IODataType>& buf,
+                                       uint64_t loaded_mini_batch_size,
+                                       uint64_t relative_base_position,
+                                       execution_mode mode);
+#endif // LBANN_HAS_GPU
+
   const data_buffer<IODataType>& get_next_buffer(execution_mode mode) const;
   data_buffer<IODataType>& get_next_buffer(execution_mode mode);
 
@@ -236,7 +431,8 @@ protected:
   io_buffer_map_t m_active_buffer;
 
   /** Vector of input data buffers
-   *  There are two sets of buffer maps to allow for double buffered execution
+   *  The buffer maps form a ring (two by default for double buffered
+   *  execution) indexed by the active buffer index modulo its size.
    *  Within each buffer map there is a buffer for each phase of execution.
    *  Each matrix column corresponds to a flattened mini-batch sample
    *  or label or responase.
@@ -247,6 +443,64 @@ protected:
    * Stores each buffer mini-batch size as it was returned from the data reader.
    */
   std::vector<std::map<execution_mode, uint64_t>> m_current_mini_batch_size;
+
+  /**
+   * Map from execution context to the (unwrapped) index of the next
+   * buffer that has not yet been scheduled for a fetch
+   */
+  std::map<execution_mode, int> m_next_fetch_buffer_idx;
+
+  /** A pending background fetch request */
+  struct fetch_request
+  {
+    int buffer_idx;
+    data_buffer<IODataType>* buffer;
+    uint64_t mini_batch_size;
+    uint64_t relative_base_position;
+    execution_mode mode;
+    std::promise<void> done;
+  };
+
+#if defined(LBANN_HAS_GPU)
+  /** Data fields that are consumed by input layers on the GPU */
+  std::set<data_field_type> m_device_staged_data_fields;
+  /** Device-resident copy of each data set, one column per sample */
+  std::map<execution_mode,
+           std::map<data_field_type,
+                    std::unique_ptr<El::Matrix<IODataType, El::Device::GPU>>>>
+    m_device_resident_samples;
+  /** Map from sample index to its column in the device-resident data */
+  std::map<execution_mode, std::unordered_map<uint64_t, El::Int>>
+    m_device_resident_columns;
+  /** Dedicated stream for host-to-device copies of the input buffers */
+  El::SyncInfo<El::Device::GPU> m_transfer_sync_info =
+    El::CreateNewSyncInfo<El::Device::GPU>();
+#endif // LBANN_HAS_GPU
+
+  /** Serve mini-batches from a device-resident copy of the data sets */
+  bool m_device_resident_data = false;
+
+  /** Non-padding entries consumed by this rank in the last step */
+  std::map<execution_mode, uint64_t> m_num_effective_tokens;
+  /** Non-padding and total entries consumed by this rank this epoch */
+  std::map<execution_mode, uint64_t> m_epoch_effective_tokens;
+  std::map<execution_mode, uint64_t> m_epoch_total_tokens;
+
+  /** Element type of samples copied to GPU input layers */
+  input_transfer_type m_transfer_type = input_transfer_type::full;
+
+  /** Number of synthetic mini-batch fields generated on the device,
+   *  mixed into the seed of the next one
+   */
+  uint64_t m_num_synthetic_fields_generated = 0;
+  /** Quantization step for uint8 transfers */
+  float m_transfer_scale = 1.f / 255.f;
+
+  /** FIFO of background fetches, serviced in order */
+  std::deque<fetch_request> m_background_fetch_queue;
+  std::mutex m_background_fetch_queue_mutex;
+  /** True while an I/O thread is draining the fetch queue */
+  bool m_background_fetch_active = false;
 };
 
 } // namespace lbann
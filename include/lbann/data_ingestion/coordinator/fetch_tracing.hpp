@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_INGESTION_COORDINATOR_FETCH_TRACING_HPP_INCLUDED
+#define LBANN_DATA_INGESTION_COORDINATOR_FETCH_TRACING_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <vector>
+
+namespace lbann {
+
+/** @brief One mini-batch fetched by a data coordinator. */
+struct fetch_record
+{
+  /** @brief Thread that ran the fetch, numbered in order of first
+   *         use starting from 0. */
+  int thread;
+  /** @brief Data buffer the fetch filled. */
+  int buffer;
+  /** @brief When the fetch started, from get_time(). */
+  EvalType start_time;
+  /** @brief When the fetch ended, from get_time(). */
+  EvalType end_time;
+};
+
+/** @brief Start or stop recording mini-batch fetches. */
+void set_fetch_tracing(bool enable);
+
+/** @brief Return and clear the recorded fetches. */
+std::vector<fetch_record> take_fetch_records();
+
+/** @brief Record a fetch into @c buffer that started at
+ *         @c start_time and ended now.
+ *  @details Does nothing unless tracing is on. Safe to call from
+ *  any thread.
+ */
+void record_fetch(int buffer, EvalType start_time);
+
+} // namespace lbann
+
+#endif // LBANN_DATA_INGESTION_COORDINATOR_FETCH_TRACING_HPP_INCLUDED
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_INGESTION_COORDINATOR_PIPELINE_STATS_HPP_INCLUDED
+#define LBANN_DATA_INGESTION_COORDINATOR_PIPELINE_STATS_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Time the data pipeline spent in one step, or summed over
+ *         the steps of an epoch, in seconds. */
+struct data_pipeline_times
+{
+  /** @brief Time the training loop was blocked on background
+   *         fetches. */
+  EvalType wait_time = 0.;
+  /** @brief Time spent in data store mini-batch exchanges. */
+  EvalType exchange_time = 0.;
+  /** @brief Wall time, from the end of the previous step. */
+  EvalType step_time = 0.;
+  /** @brief Time each I/O thread spent fetching, indexed by thread
+   *         in order of first use. */
+  std::vector<EvalType> io_busy_time;
+  /** @brief Number of steps summed. */
+  uint64_t num_steps = 0;
+
+  /** @brief Time I/O thread @c i was not fetching. */
+  EvalType io_idle_time(size_t i) const;
+};
+
+/** @brief Distribution of mini-batch fetch latencies, in seconds. */
+struct fetch_latency_summary
+{
+  uint64_t count = 0;
+  EvalType mean = 0.;
+  EvalType p50 = 0.;
+  EvalType p90 = 0.;
+  EvalType p99 = 0.;
+  EvalType max = 0.;
+};
+
+/** @brief Stall instrumentation for a data coordinator.
+ *
+ *  The training loop records how long it waited for data and how
+ *  long data store exchanges took, the I/O threads record each
+ *  mini-batch fetch. Steps are closed when the data coordinator
+ *  releases the active buffer, so the times of the step that just
+ *  finished are available to batch-end callbacks; epochs likewise
+ *  before epoch-end callbacks. A step whose wait time is a large
+ *  fraction of its step time is input-bound.
+ */
+class data_pipeline_stats
+{
+public:
+  /** @brief The training loop waited @c seconds for a fetch. */
+  void record_wait(EvalType seconds);
+
+  /** @brief A data store exchange took @c seconds. */
+  void record_exchange(EvalType seconds);
+
+  /** @brief The calling I/O thread fetched a mini-batch for
+   *         @c mode between @c start_time and @c end_time. */
+  void record_fetch(execution_mode mode,
+                    EvalType start_time,
+                    EvalType end_time);
+
+  /** @brief Close the current step of @c mode. */
+  void end_step(execution_mode mode);
+
+  /** @brief Close the current epoch of @c mode. */
+  void end_epoch(execution_mode mode);
+
+  /** @brief Times of the last closed step. */
+  data_pipeline_times const& get_last_step() const { return m_last_step; }
+
+  /** @brief Times summed over the last closed epoch of @c mode. */
+  data_pipeline_times get_last_epoch(execution_mode mode) const;
+
+  /** @brief Fetch latencies of the last closed epoch of @c mode. */
+  fetch_latency_summary get_fetch_latency(execution_mode mode) const;
+
+private:
+  /** @brief Index of the calling thread. Caller holds the mutex. */
+  size_t get_thread_index();
+
+  mutable std::mutex m_mutex;
+  std::map<std::thread::id, size_t> m_threads;
+  /** @brief Start of the current step, zero before the first. */
+  EvalType m_step_start = 0.;
+  data_pipeline_times m_step;
+  data_pipeline_times m_last_step;
+  std::map<execution_mode, data_pipeline_times> m_epoch;
+  std::map<execution_mode, data_pipeline_times> m_last_epoch;
+  std::map<execution_mode, std::vector<EvalType>> m_latencies;
+  std::map<execution_mode, fetch_latency_summary> m_last_latency;
+};
+
+} // namespace lbann
+
+#endif // LBANN_DATA_INGESTION_COORDINATOR_PIPELINE_STATS_HPP_INCLUDED
@@ -27,11 +27,14 @@
 #ifndef LBANN_DATA_COORDINATOR_HPP
 #define LBANN_DATA_COORDINATOR_HPP
 
+#include "lbann/data_ingestion/coordinator/pipeline_stats.hpp"
 #include "lbann/data_ingestion/infrastructure/dataset.hpp"
 #include "lbann/data_ingestion/readers/metadata.hpp"
 #include "lbann/data_ingestion/readers/utils/input_data_type.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 
+#include <iosfwd>
+
 // #ifdef LBANN_HAS_DISTCONV
 // #include "lbann/data_ingestion/readers/data_reader_hdf5_legacy.hpp"
 // #endif // LBANN_HAS_DISTCONV
@@ -91,6 +94,10 @@ public:
         uint64_t max_mini_batch_size,
         std::map<execution_mode, generic_data_reader*> data_readers);
 
+  /** Set the number of I/O buffers used to prefetch mini-batches.
+   *  Data coordinators that do not buffer ignore the request. */
+  virtual void set_num_io_buffers(size_t num_io_buffers) {}
+
   /** Once all of the models that are served by this data coordinator are
    *  setup and have registered which data fields are required, setup the local
    *  buffers in the data coordinator for each data field.
@@ -150,6 +157,18 @@ public:
       mode requested */
   virtual void collect_background_data_fetch(execution_mode mode) = 0;
 
+  /** @brief Stall instrumentation of the data pipeline */
+  const data_pipeline_stats& get_pipeline_stats() const
+  {
+    return m_pipeline_stats;
+  }
+
+  /** @brief Write the position of each dataset and the state of any
+   *  fetches, to diagnose a stalled run. Takes no locks, so it can be
+   *  called while the training loop is blocked.
+   */
+  virtual void print_state(std::ostream& os) const;
+
   //************************************************************************
   // Helper functions for LTFB
   //************************************************************************
@@ -310,6 +329,9 @@ protected:
 
   std::set<data_field_type> m_active_data_fields;
 
+  /** Time spent waiting for, exchanging and fetching data */
+  data_pipeline_stats m_pipeline_stats;
+
 public: // @todo BVE FIXME
   bool m_data_set_processed;
   std::mutex dr_mutex;
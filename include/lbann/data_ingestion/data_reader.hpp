@@ -39,6 +39,7 @@
 #include "lbann/utils/random_number_generators.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <string>
 #include <unistd.h>
@@ -91,6 +92,7 @@ public:
       m_label_fn(""),
       m_shuffle(shuffle),
       m_absolute_sample_count(0),
+      m_epoch(0),
       m_use_fraction(1.0),
       m_gan_labelling(false), // default, not GAN
       m_gan_label_value(
@@ -377,6 +379,20 @@ public:
   /// get the linearized size of what is identified by desc.
   virtual int get_linearized_size(data_field_type const& data_field) const;
 
+  /// True if samples are padded out to the linearized data size.
+  virtual bool has_variable_length_samples() const { return false; }
+  /** @brief Get the number of entries of a sample that are not padding.
+   *
+   *  Readers of variable-length samples override this, together with
+   *  has_variable_length_samples, to enable length bucketing and
+   *  effective-token accounting. It must give the same answer on
+   *  every rank of the trainer.
+   */
+  virtual uint64_t get_sample_length(uint64_t data_id) const
+  {
+    return get_linearized_data_size();
+  }
+
   /// Get the dimensions of the data.
   virtual const std::vector<El::Int> get_data_dims() const
   {
@@ -394,6 +410,31 @@ public:
   uint64_t* get_indices() { return &m_shuffled_indices[0]; }
   /// Get the number of samples in this dataset.
   virtual uint64_t get_num_data() const { return m_shuffled_indices.size(); }
+  /** @brief Whether samples are drawn from a stream rather than from a
+   *  materialized index; see streaming_data_reader.
+   */
+  virtual bool is_streaming() const { return false; }
+  /** @brief Whether the input layers generate mini-batches on the
+   *  device instead of fetching them; see data_reader_synthetic.
+   */
+  virtual bool generates_data_on_device() const { return false; }
+  /** @brief Get the index of the sample at a position in the epoch.
+   *
+   *  Positions are only valid after prepare_sample_indices covered
+   *  them.
+   */
+  virtual uint64_t get_sample_index(uint64_t position) const
+  {
+    return m_shuffled_indices[position];
+  }
+  /** @brief Make the sample indices at positions
+   *  <tt>first + i * stride</tt>, <tt>i < count</tt>, available.
+   *
+   *  Called once per fetch, before the I/O threads look up samples.
+   */
+  virtual void
+  prepare_sample_indices(uint64_t first, uint64_t stride, uint64_t count)
+  {}
   /// Get the number of unused samples in this dataset.
   size_t get_num_unused_data(execution_mode m) const;
 
@@ -486,6 +527,12 @@ public:
     m_transform_pipeline = std::move(tp);
   }
 
+  /** Get the transform pipeline this data reader uses. */
+  transform::transform_pipeline& get_transform_pipeline()
+  {
+    return m_transform_pipeline;
+  }
+
 #ifdef LBANN_HAS_DISTCONV
   /**
    * Returns whether shuffle (which refers to input data shuffling for
@@ -542,6 +589,36 @@ protected:
                                 El::Matrix<El::Int>& indices_fetched,
                                 execution_mode mode = execution_mode::invalid);
 
+  /** @brief Fetch every data field of the sample at position @c s
+   *  in the mini-batch
+   *
+   *  Samples are spread over the I/O threads dynamically. Per-sample
+   *  I/O RNGs are selected by the sample's position in the
+   *  mini-batch, so the result does not depend on which thread
+   *  fetched it.
+   */
+  bool fetch_sample(std::map<data_field_type, CPUMat*>& input_buffers,
+                    uint64_t current_position_in_data_set,
+                    uint64_t s,
+                    uint64_t sample_stride,
+                    El::Matrix<El::Int>& indices_fetched,
+                    execution_mode mode);
+
+  bool fetch_sample_conduit(std::vector<conduit::Node>& samples,
+                            uint64_t current_position_in_data_set,
+                            uint64_t s,
+                            uint64_t sample_stride,
+                            El::Matrix<El::Int>& indices_fetched,
+                            execution_mode mode);
+
+  /** @brief Whether fetch may claim samples dynamically across I/O threads.
+   *
+   *  Readers that override fetch_data_block to schedule their own
+   *  work (e.g. a single thread fetching the whole mini-batch) must
+   *  return false.
+   */
+  virtual bool supports_dynamic_sample_scheduling() const { return true; }
+
   /** @brief Called by fetch_data, fetch_label, fetch_response
    *
    * Fetch data from a single data field into a matrix.
@@ -630,6 +707,28 @@ protected:
   /// Shuffle indices and profide a random number generator
   virtual void shuffle_indices(rng_gen& gen);
 
+  /** @brief Shuffle indices so that most samples stay on their owner
+   *
+   * Samples are bucketed by the rank that owns them in the data store,
+   * and each bucket is shuffled. Each mini-batch slot is then filled
+   * from the bucket of the rank that consumes it with probability
+   * @c locality, or otherwise from a bucket picked at random in
+   * proportion to its size (as a global shuffle would). Since the
+   * data store's ranks own random subsets of the data, the mini-batch
+   * statistics stay close to those of a global shuffle.
+   *
+   * @returns The number of samples that will be exchanged between ranks
+   */
+  uint64_t block_local_shuffle_indices(rng_gen& gen, double locality);
+
+  /** @brief Sort each run of @c bucket_size shuffled indices by length
+   *
+   * Consecutive mini-batches then hold samples of similar length while
+   * the order of the buckets stays random. The sort is stable, so
+   * every rank produces the same order.
+   */
+  void bucket_indices_by_length(uint64_t bucket_size);
+
 public:
   std::vector<uint64_t> m_shuffled_indices;
   /// Record of the indicies that are not being used for training
@@ -643,6 +742,8 @@ public:
   std::string m_label_fn;
   bool m_shuffle;
   uint64_t m_absolute_sample_count;
+  /// Number of completed epochs; keys the per-sample I/O random streams
+  uint64_t m_epoch;
   std::map<execution_mode, double> m_execution_mode_split_fraction;
   double m_use_fraction;
   int m_first_n;
@@ -34,6 +34,7 @@
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
 #include "lbann/utils/exception.hpp"
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -47,6 +48,7 @@ namespace lbann {
   lbann::pad(std::to_string(data_id), LBANN_SAMPLE_ID_PAD, '0')
 
 class generic_data_reader;
+class spill_segment_store;
 
 /** Create a hash function for hashing a std::pair type */
 struct size_t_pair_hash
@@ -233,6 +235,21 @@ public:
    * the future */
   void set_finished_building_map() { m_owner_maps_were_exchanged = true; }
 
+  /** @brief Returns true if the owner of every sample is known, so that
+   * get_owner() and get_destination() may be called */
+  bool has_owner_map() const
+  {
+    return m_owner_maps_were_exchanged && m_owner_map_mb_size > 0 &&
+           !m_is_local_cache;
+  }
+
+  /// Returns the rank that owns data_id, or -1 if it is not known
+  int get_owner(uint64_t data_id) const;
+
+  /// Returns the rank that consumes the sample at position pos of the
+  /// shuffled indices (i.e., the rank an exchange sends it to)
+  int get_destination(uint64_t pos) const;
+
   /// Recompact the nodes because they are not copied properly when
   /// instantiating using the copy constructor
   void compact_nodes();
@@ -255,6 +272,20 @@ public:
 
   void set_node_sizes_vary() { m_node_sizes_vary = true; }
 
+  /// Returns true if owned samples are held in zlib-compressed form
+  bool is_compressing() const { return m_compression_level > 0; }
+
+  /** @brief Returns true if owned samples are held as fixed-size records
+   *
+   * Enabled by the cmd line flag --data_store_fixed_records; ignored
+   * when sample sizes vary, and switched off on every rank if samples
+   * turn out not to share one schema. See: store_record()
+   */
+  bool uses_fixed_records() const
+  {
+    return m_fixed_records && !m_node_sizes_vary;
+  }
+
   bool has_conduit_node(uint64_t data_id) const;
 
   /// only used for debugging; pass --debug on cmd line to get
@@ -267,7 +298,7 @@ public:
   int get_data_size()
   {
     std::lock_guard<std::mutex> lock(m_mutex);
-    return m_data.size();
+    return m_data.size() + m_record_slots.size();
   }
 
   /// made public for debugging during development
@@ -368,6 +399,13 @@ private:
   /** @brief maps data_id to m_m_cur_spill_dir_integer. */
   map_ii_t m_spilled_nodes;
 
+  /** @brief Segment-file backend for samples spilled during preloading
+   *
+   * Shared by copies of this data store. When null, samples are
+   * spilled one file per node (see spill_conduit_node).
+   */
+  std::shared_ptr<spill_segment_store> m_spill_segments;
+
   /// used in set_conduit_node(...)
   // Guards m_sample_sizes, m_data, m_image_offsets, m_sample_sizes
   mutable std::mutex m_mutex;
@@ -509,6 +547,20 @@ private:
   /// the current minibatch; this is filled in by exchange_data()
   std::unordered_map<uint64_t, conduit::Node> m_minibatch_data;
 
+  /** @brief Decompressed copies of the nodes handed out by get_conduit_node
+   *
+   * Only used when compression is enabled. Entries are filled lazily by
+   * the I/O threads and dropped whenever m_minibatch_data is rebuilt.
+   * Guarded by m_mutex.
+   */
+  mutable std::unordered_map<uint64_t, conduit::Node> m_decompressed_data;
+
+  /// zlib compression level for owned samples; 0 disables compression
+  int m_compression_level = 0;
+
+  /// Names of the fields to compress; if empty, every field is compressed
+  std::unordered_set<std::string> m_compression_fields;
+
   /// work space; used in exchange_data
   std::vector<conduit::Node> m_send_buffer;
   std::vector<conduit::Node> m_send_buffer_2;
@@ -537,6 +589,70 @@ private:
   /// this proc needs to recv from others. (formerly called "needed")
   std::vector<std::unordered_set<uint64_t>> m_indices_to_recv;
 
+  /** @brief If true, exchange mini-batch data with one message per node
+   *
+   * Samples bound for another node are coalesced into a single message
+   * per (sender, remote node), sent to a forwarding rank on that node,
+   * and delivered from there over the node-local transport; samples
+   * bound for the same node are coalesced per destination rank.
+   * See: start_exchange_data_by_node()
+   */
+  bool m_node_aggregated_exchange = false;
+
+  /// Maps each rank in the trainer to the lowest trainer rank on its node
+  std::vector<int> m_node_of_rank;
+
+  /// Maps a node (see m_node_of_rank) to its trainer ranks, in order
+  std::unordered_map<int, std::vector<int>> m_ranks_on_node;
+
+  /** @brief Per-peer lists of the samples in each stage of a
+   * node-aggregated exchange, in the order they are packed
+   *
+   * Stage 1 carries samples from their owners to either their final
+   * destination (same node) or a forwarding rank (remote node); stage 2
+   * carries forwarded samples within the destination node.
+   */
+  std::vector<std::vector<uint64_t>> m_stage_1_send_ids;
+  std::vector<std::vector<uint64_t>> m_stage_1_recv_ids;
+  std::vector<std::vector<uint64_t>> m_stage_2_send_ids;
+  std::vector<std::vector<uint64_t>> m_stage_2_recv_ids;
+
+  /// Samples in the current mini-batch whose final destination is me
+  std::vector<uint64_t> m_my_exchanged_ids;
+
+  /// work space for node-aggregated exchanges; one buffer per message
+  std::vector<std::vector<El::byte>> m_stage_send_buffers;
+  std::vector<std::vector<El::byte>> m_stage_recv_buffers;
+
+  /** @brief If true, owned samples are stored as raw records
+   *
+   * Samples of one fixed schema are kept back to back in
+   * m_record_blocks, with no conduit::Node or message header per
+   * sample, and are exchanged with one message per peer.
+   * See: uses_fixed_records()
+   */
+  bool m_fixed_records = false;
+  /// Compact schema shared by every record
+  conduit::Schema m_record_schema;
+  /// Size in bytes of one record
+  size_t m_record_size = 0;
+  /// True if records leave out the padded data_id level of each sample
+  bool m_record_wraps_id = false;
+  /// Number of records in each of m_record_blocks
+  static constexpr size_t m_records_per_block = 1024;
+  /// Storage for the records this rank owns; blocks never move
+  std::vector<std::unique_ptr<El::byte[]>> m_record_blocks;
+  /// Maps data_id -> slot of its record in m_record_blocks
+  std::unordered_map<uint64_t, size_t> m_record_slots;
+  /** @brief Nodes viewing owned records, handed out by get_conduit_node
+   *
+   * Only filled for owned samples that are requested outside of a
+   * mini-batch exchange. Guarded by m_mutex.
+   */
+  mutable std::unordered_map<uint64_t, conduit::Node> m_record_views;
+  /// Message-shaped view of a record, returned by get_random_node
+  mutable conduit::Node m_random_record;
+
   //=========================================================================
   // methods follow
   //=========================================================================
@@ -544,6 +660,75 @@ private:
   void start_exchange_data_by_sample(uint64_t current_pos, uint64_t mb_size);
   void finish_exchange_data_by_sample();
 
+  /// Builds m_node_of_rank and m_ranks_on_node
+  void setup_node_aggregated_exchange();
+
+  /// Node-aggregated variants of start/finish_exchange_data_by_sample
+  void start_exchange_data_by_node(uint64_t current_pos, uint64_t mb_size);
+  void finish_exchange_data_by_node();
+
+  /// Fixed-record variants of start/finish_exchange_data_by_sample
+  void start_exchange_records(uint64_t current_pos, uint64_t mb_size);
+  void finish_exchange_records();
+
+  /** @brief Copies the data of a sample into a new record
+   *
+   * The first record fixes m_record_schema and m_record_size; a
+   * leading data_id level is not part of the schema. If a later
+   * sample has a different compacted schema, the records are
+   * converted to nodes and false is returned; the caller then stores
+   * the sample as a node. Caller must hold m_mutex.
+   */
+  bool store_record(uint64_t data_id, const conduit::Node& node);
+
+  /** @brief Moves every record into m_data and marks sizes as varying
+   *
+   * Invalidates nodes previously returned for owned records. Caller
+   * must hold m_mutex.
+   */
+  void convert_records_to_nodes();
+
+  /// Makes view a sample node over record, restoring its data_id level
+  void set_record_view(conduit::Node& view,
+                       uint64_t data_id,
+                       const El::byte* record) const;
+
+  /// Returns the record in slot
+  El::byte* get_record(size_t slot) const
+  {
+    return m_record_blocks[slot / m_records_per_block].get() +
+           (slot % m_records_per_block) * m_record_size;
+  }
+
+  /** @brief Returns the record data of a sample this rank owns
+   *
+   * Samples reloaded from a checkpoint are held as conduit nodes, in
+   * which case this is the data section of the node. Caller must hold
+   * m_mutex.
+   */
+  const El::byte* get_owned_record(uint64_t data_id) const;
+
+  /// Returns true if this rank holds data_id; caller must hold m_mutex
+  bool owns_sample(uint64_t data_id) const
+  {
+    return m_data.count(data_id) != 0 || m_record_slots.count(data_id) != 0;
+  }
+
+  /** @brief Makes m_record_schema and m_record_size known on every rank
+   *
+   * Ranks that own no samples learn them from the lowest rank that does.
+   * If any rank holds samples of another schema, every rank falls back
+   * to exchanging conduit nodes. Collective over the trainer.
+   */
+  void exchange_record_schema();
+
+  /// Returns the size of the sample message for data_id
+  size_t get_sample_message_size(uint64_t data_id);
+
+  /// Posts one coalesced nonblocking recv per nonempty list in ids
+  void post_coalesced_recvs(const std::vector<std::vector<uint64_t>>& ids,
+                            int tag);
+
   void setup_data_store_buffers();
 
   /// called by exchange_data
@@ -553,6 +738,23 @@ private:
   /// for use when conduit Nodes have non-uniform size, e.g, imagenet
   void exchange_sample_sizes();
 
+  /** @brief Copies node_in to node_out, compressing the selected leaves
+   *
+   * Leaves that are too small, or that do not shrink, are copied as-is.
+   * @param selected true if an ancestor of node_in is a selected field
+   */
+  void compress_node(const conduit::Node& node_in,
+                     conduit::Node& node_out,
+                     bool selected) const;
+
+  /// Inverse of compress_node
+  void decompress_node(const conduit::Node& node_in,
+                       conduit::Node& node_out) const;
+
+  /// Returns a cached, decompressed copy of the node for data_id
+  const conduit::Node& get_decompressed_node(uint64_t data_id,
+                                             const conduit::Node& node) const;
+
   /// fills in m_indices_to_send and returns the number of samples
   /// that will be sent
   int build_indices_i_will_send(uint64_t current_pos, uint64_t mb_size);
@@ -625,6 +827,11 @@ private:
   /** @brief Loads conduit nodes from file into m_data */
   void load_spilled_conduit_nodes();
 
+  /// Starts loading the spilled samples that this rank owns in
+  /// [current_pos, current_pos + mb_size) of the shuffled indices
+  void readahead_spilled_conduit_nodes(uint64_t current_pos,
+                                       uint64_t mb_size);
+
   /** @brief Creates directory structure, opens metadata file for output, etc
    *
    * This method is called for both --data_store_spill and
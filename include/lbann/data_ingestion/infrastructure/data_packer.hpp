@@ -50,6 +50,11 @@ namespace data_packer {
  *  data from the ith sample is written into the ith column of the
  *  corresponding matrix.
  *
+ *  The location and type of each field is resolved once and cached
+ *  per thread, keyed by field. Samples matching the cached layout are
+ *  then packed without path lookups. Samples that do not match go
+ *  through extract_data_field_from_sample, with its checks.
+ *
  *  @param[in] samples The list of Conduit nodes holding sample data.
  *  @param[in,out] input_buffers A map of data field identifiers to
  *         Hydrogen matrices. The matrices must have the correct size
@@ -100,6 +100,9 @@ public:
   uint64_t get_next_mini_batch_size() const;
   /// Get the current mini-batch size.
   uint64_t get_current_mini_batch_size() const;
+  /// Get the size of the mini-batch num_steps in the future (0 if it
+  /// falls beyond the end of the current epoch)
+  uint64_t get_mini_batch_size_ahead(uint64_t num_steps) const;
   /// Return the full mini_batch_size.
   uint64_t get_mini_batch_max() const { return m_mini_batch_size; }
   /// Set the mini batch stride
@@ -152,6 +155,8 @@ public:
   uint64_t get_position() const { return m_current_pos; }
   /// Get the next position in the data reader.
   uint64_t get_next_position() const;
+  /// Get the position in the data reader num_steps in the future.
+  uint64_t get_position_ahead(uint64_t num_steps) const;
 
   /// Set the number of iterations in each epoch.
   void set_num_iterations_per_epoch(uint64_t num_iterations_per_epoch)
@@ -28,6 +28,9 @@
 #define LBANN_IO_BUFFER_HPP_INCLUDED
 
 #include "lbann/data_ingestion/readers/utils/input_data_type.hpp"
+#if defined(LBANN_HAS_GPU)
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
 
 namespace lbann {
 
@@ -55,6 +58,26 @@ public:
   // Once samples are fetched, track if the data fields are pulled out
   // of the buffer
   std::map<data_field_type, uint64_t> m_num_samples_per_field_distributed;
+#if defined(LBANN_HAS_GPU)
+  /** Device copies of the input buffers, staged on the data
+   *  coordinator's transfer stream ahead of forward propagation */
+  std::map<data_field_type, std::unique_ptr<AbsDistMatrixType>>
+    m_device_input_buffers;
+  /** Recorded on the transfer stream once the device copies are done */
+  gpu_lib::event_wrapper m_device_copy_event;
+  /** Recorded on the compute stream once the device copies are consumed */
+  gpu_lib::event_wrapper m_device_release_event;
+  /** Columns gathered from device-resident data for this mini-batch */
+  El::Matrix<El::Int, El::Device::GPU> m_device_sample_columns;
+  /** True if the device copies hold the current mini-batch */
+  bool m_device_buffers_staged = false;
+  /** Pinned host and device staging for samples copied at reduced
+   *  precision */
+  std::unique_ptr<hydrogen::simple_buffer<El::byte, El::Device::CPU>>
+    m_packed_host_samples;
+  std::unique_ptr<hydrogen::simple_buffer<El::byte, El::Device::GPU>>
+    m_packed_device_samples;
+#endif // LBANN_HAS_GPU
 
   data_buffer(lbann_comm* comm)
     : m_num_samples_fetched(0), m_fetch_data_in_background(false)
@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SPILL_SEGMENT_STORE_HPP_INCLUDED
+#define LBANN_SPILL_SEGMENT_STORE_HPP_INCLUDED
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Spill backend built on large append-only segment files
+ *
+ *  Records (opaque byte strings keyed by sample id) are appended to
+ *  segment files in the background by a writer thread, and an
+ *  in-memory index maps each id to its segment, offset and length.
+ *  Callers can request readahead of the records they will need next;
+ *  those are loaded by the same background thread so that read() is
+ *  usually served from memory.
+ *
+ *  All public methods are thread-safe. Segment files are removed
+ *  when the store is destroyed.
+ */
+class spill_segment_store
+{
+public:
+  /// Default size at which a new segment file is started
+  static constexpr size_t default_segment_size = size_t{1} << 30;
+
+  /// Default bound on the bytes queued for writing before append blocks
+  static constexpr size_t default_max_pending_bytes = size_t{256} << 20;
+
+  /** @param dir Directory to hold the segment files; must exist
+   *  @param segment_size Size at which a new segment file is started
+   *  @param max_pending_bytes Bytes that may be queued for writing
+   *         before append() blocks
+   */
+  spill_segment_store(std::string dir,
+                      size_t segment_size = default_segment_size,
+                      size_t max_pending_bytes = default_max_pending_bytes);
+  ~spill_segment_store();
+
+  spill_segment_store(const spill_segment_store&) = delete;
+  spill_segment_store& operator=(const spill_segment_store&) = delete;
+
+  /** @brief Queue a record for writing
+   *
+   *  The buffer is copied, so it may be reused as soon as this
+   *  returns. Records with an id that is already present replace the
+   *  previous record.
+   */
+  void append(uint64_t id, const void* buf, size_t len);
+
+  /// Block until every queued record has been written
+  void flush();
+
+  /** @brief Load the given records into memory in the background
+   *
+   *  This replaces the previous readahead window: records cached by
+   *  an earlier call that are not in ids are dropped. Unknown ids are
+   *  ignored.
+   */
+  void readahead(const std::vector<uint64_t>& ids);
+
+  /** @brief Read the record for id into out
+   *
+   *  Served from the readahead cache or the pending-write queue when
+   *  possible, otherwise read synchronously from the segment file.
+   */
+  void read(uint64_t id, std::vector<char>& out);
+
+  /// Returns true if a record for id has been appended
+  bool contains(uint64_t id) const;
+
+  /// Number of records held
+  size_t size() const;
+
+  /// Number of segment files opened so far
+  size_t get_num_segments() const;
+
+  /// Directory holding the segment files
+  const std::string& get_directory() const noexcept { return m_dir; }
+
+private:
+  struct record_location
+  {
+    size_t segment;
+    size_t offset;
+    size_t length;
+  };
+
+  /// Main loop of the background thread
+  void worker();
+
+  /// Append one record to the current segment; called by the worker
+  void write_record(uint64_t id, const std::vector<char>& bytes);
+
+  /// Read the record at loc; safe to call without holding m_mutex
+  void read_record(int fd,
+                   const record_location& loc,
+                   std::vector<char>& out) const;
+
+  /// Rethrow an exception raised on the background thread, if any
+  void check_worker_error() const;
+
+  std::string segment_filename(size_t segment) const;
+
+  std::string m_dir;
+  size_t m_segment_size;
+  size_t m_max_pending_bytes;
+
+  /// Guards everything below
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+
+  /// Where each written record lives
+  std::unordered_map<uint64_t, record_location> m_index;
+
+  /// Records that were appended but are not yet on disk
+  std::unordered_map<uint64_t, std::shared_ptr<const std::vector<char>>>
+    m_pending;
+  /// Order in which pending records are written
+  std::deque<uint64_t> m_write_queue;
+  size_t m_pending_bytes = 0;
+  /// True while the worker is writing a record outside of the lock
+  bool m_writing = false;
+
+  /// Records of the current readahead window that are not yet cached
+  std::deque<uint64_t> m_readahead_queue;
+  std::unordered_set<uint64_t> m_readahead_window;
+  std::unordered_map<uint64_t, std::vector<char>> m_readahead_cache;
+
+  /// One file descriptor per segment
+  std::vector<int> m_segment_fds;
+  size_t m_cur_segment_bytes = 0;
+
+  std::exception_ptr m_worker_error;
+  bool m_stop = false;
+  std::thread m_worker;
+};
+
+} // namespace lbann
+
+#endif // LBANN_SPILL_SEGMENT_STORE_HPP_INCLUDED
@@ -46,6 +46,7 @@ class DataReaderHDF5WhiteboxTester;
 #define HDF5_METADATA_KEY_TRANSPOSE "transpose"
 #define HDF5_METADATA_KEY_COERCE "coerce"
 #define HDF5_METADATA_KEY_PACK "pack"
+#define HDF5_METADATA_KEY_NORMALIZE "normalize"
 /** Valid string values for a metadata file */
 #define HDF5_METADATA_VALUE_COERCE_FLOAT "float"
 #define HDF5_METADATA_VALUE_COERCE_DOUBLE "double"
@@ -78,6 +79,7 @@ static std::set<std::string> const hdf5_metadata_valid_keys = {
   HDF5_METADATA_KEY_TRANSPOSE,
   HDF5_METADATA_KEY_COERCE,
   HDF5_METADATA_KEY_PACK,
+  HDF5_METADATA_KEY_NORMALIZE,
 };
 
 /**
@@ -113,6 +115,28 @@ public:
 
   void load() override;
 
+  /** @brief Compute z-score normalization for the marked fields.
+   *
+   *  Every field whose metadata contains "normalize: true" is read
+   *  once across the trainer, each rank streaming a contiguous share
+   *  of the samples as stored on disk (after any coercion). The
+   *  per-rank Welford accumulators, one per channel for channels-last
+   *  images, are merged across the trainer, and @c scale = 1/stddev
+   *  and @c bias = -mean/stddev are written into the experiment
+   *  schema and applied to subsequent fetches. The trainer master
+   *  saves the updated experiment schema to @c filename unless it is
+   *  empty.
+   */
+  void compute_normalization_statistics(const std::string& filename = "");
+
+  /** @brief Normalize the marked fields with the scale and bias of
+   *         another reader, usually the training reader.
+   *
+   *  Validation and test data must be normalized with the statistics
+   *  of the training data, not their own.
+   */
+  void copy_normalization_statistics(const hdf5_data_reader& other);
+
   bool fetch_conduit_node(conduit::Node& sample, uint64_t data_id) override;
 
   /** @brief Sets the name of the yaml experiment file */
@@ -223,6 +247,31 @@ private:
 
   std::unordered_map<std::string, PackingGroup> m_packing_groups;
 
+  /** A field that is loaded from disk, with the directives in its
+   *  metadata resolved up front so that loading a sample needs no
+   *  metadata lookups or string parsing.
+   */
+  struct FieldPlan
+  {
+    /** Path of the field within a sample, with a leading '/' */
+    std::string node_path;
+    /** Type to coerce to, or EMPTY_ID to keep the type on disk */
+    conduit::index_t coerce_to = conduit::DataType::EMPTY_ID;
+    bool normalize = false;
+    /** If false, scale and bias each hold a single value */
+    bool normalize_per_channel = false;
+    std::vector<double> scale;
+    std::vector<double> bias;
+    /** Channels last to channels first repacking */
+    bool repack = false;
+    int64_t n_channels = 0;
+    std::vector<int64_t> dims;
+  };
+
+  /** One entry per non-composite field of m_useme_node_map; filled in
+   *  by build_field_plans() */
+  std::vector<FieldPlan> m_field_plans;
+
   /** Name of nodes in schemas that contain instructions
    * on normalizing, packing, and casting data, etc.
    */
@@ -308,8 +357,14 @@ private:
   get_leaves_multi(conduit::Node* node_in,
                    std::unordered_map<std::string, conduit::Node*>& leaves_out);
 
+  /** Loads the samples this rank owns, one file at a time. */
   void do_preload_data_store() override;
 
+  /** Opens a data file through the HDF5 core driver, which reads the
+   *  whole file into memory at once; see --hdf5_core_driver.
+   */
+  hid_t open_file_in_memory(size_t index) const;
+
   /** Loads a sample from file to a conduit::Node; call normalize,
    *  coerce, pack, etc. "ignore_failure" is only used for
    *  by the call to print_metadata().
@@ -344,21 +399,48 @@ private:
   /** Fills in m_packing_groups data structure */
   void build_packing_map(conduit::Node& node);
 
+  /** Fills in m_field_plans from m_useme_node_map */
+  void build_field_plans();
+
+  /** Returns true if metadata contains "normalize: true" */
+  bool is_marked_for_normalization(const conduit::Node& metadata) const;
+
+  /** Writes the scale and bias of a field into the experiment schema */
+  void set_normalization(const std::string& path,
+                         const std::vector<double>& scale,
+                         const std::vector<double>& bias);
+
+  /** Fills in the normalization directives of a plan from metadata */
+  void resolve_normalization(FieldPlan& plan,
+                             const conduit::Node& metadata) const;
+
+  /** Fills in the repacking directives of a plan from metadata */
+  void resolve_repack(FieldPlan& plan, const conduit::Node& metadata) const;
+
   /** repacks from HWC to CHW */
   void repack_image(conduit::Node& node,
                     const std::string& path,
                     const conduit::Node& metadata);
+  void repack_image(conduit::Node& leaf, const FieldPlan& plan);
+  /** If scale and bias are not null, each channel is also normalized
+   *  while it is repacked */
+  void repack_image(conduit::Node& leaf,
+                    const FieldPlan& plan,
+                    const double* scale,
+                    const double* bias);
+  /** normalize() followed by repack_image(), in a single pass */
+  void normalize_and_repack_image(conduit::Node& leaf, const FieldPlan& plan);
 
   /** called from load_sample */
-  void coerce(const conduit::Node& metadata,
+  void coerce(conduit::index_t coerce_to,
               hid_t file_handle,
               const std::string& original_path,
-              const std::string& new_pathname,
-              conduit::Node& node);
+              conduit::Node& leaf);
 
   void normalize(conduit::Node& node,
                  const std::string& path,
                  const conduit::Node& metadata);
+  void normalize(conduit::Node& leaf, const FieldPlan& plan);
 
   /** Constructs m_data_dims_lookup_table and m_linearized_size_lookup_table */
   void construct_linearized_size_lookup_tables();
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// data_reader_columnar .hpp .cpp - generic_data_reader class for chunked
+// columnar files
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_READER_COLUMNAR_HPP
+#define LBANN_DATA_READER_COLUMNAR_HPP
+
+#include "lbann/data_ingestion/data_reader.hpp"
+#include "lbann/utils/file_utils.hpp"
+
+#include <conduit/conduit.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/** Valid keys for a field in a columnar experiment schema */
+#define COLUMNAR_SCHEMA_KEY_PACK "pack"
+#define COLUMNAR_SCHEMA_KEY_SCALE "scale"
+#define COLUMNAR_SCHEMA_KEY_BIAS "bias"
+#define COLUMNAR_SCHEMA_KEY_NUM_LABELS "num_labels"
+#define COLUMNAR_SCHEMA_KEY_CAPACITY "capacity"
+
+namespace lbann {
+
+/**
+ * Data reader for the LBANN columnar format.
+ *
+ * A columnar file stores each field of the data set as a column whose
+ * samples all have the same type and shape. A column is split into
+ * chunks of a fixed number of samples. Each chunk starts at an
+ * aligned offset and is either stored raw or zlib-compressed, chosen
+ * per column. A JSON footer records the columns and the offset of
+ * each of their chunks, so sample @c i of a column is found directly
+ * from chunk <tt>i / chunk_size</tt>. Files are written by
+ * python/lbann/util/columnar.py, which also converts .npz and HDF5
+ * data sets.
+ *
+ * The file is memory-mapped, so raw columns are copied straight from
+ * the page cache into the mini-batch. Compressed chunks are inflated
+ * on first use and cached per I/O thread.
+ *
+ * The experiment schema is a yaml file in the style of the one used
+ * by hdf5_data_reader: each top-level key names a column and gives
+ * its "pack" group (datum, label or response) and optionally a
+ * "scale" and "bias". Only the listed columns are ever read. Datum
+ * and response columns are packed in the order they appear. The
+ * label column must hold one integer per sample and give
+ * "num_labels".
+ *
+ * A column may instead be sparse, in COO layout: each sample holds a
+ * variable number of entries, each with @c index_dims integer
+ * coordinates and optionally a value. Edge lists of graphs
+ * (index_dims = 2) and bags of categorical features (index_dims = 1)
+ * are stored this way without padding. A sparse column in the schema
+ * gives a "capacity", the largest number of entries a sample may
+ * have, and is packed into the mini-batch as @c index_dims rows of
+ * @c capacity coordinates (all first coordinates, then all second
+ * coordinates, ...) followed by @c capacity values. Unused entries
+ * get coordinate -1 and value 0. Gather, scatter and embedding layers
+ * ignore out-of-range indices, so they consume the packed coordinates
+ * directly and the unused entries contribute nothing.
+ */
+class columnar_reader : public generic_data_reader
+{
+public:
+  columnar_reader(bool shuffle = true);
+  columnar_reader(const columnar_reader&) = default;
+  columnar_reader& operator=(const columnar_reader&) = default;
+  ~columnar_reader() override = default;
+
+  columnar_reader* copy() const override { return new columnar_reader(*this); }
+
+  std::string get_type() const override { return "columnar_reader"; }
+
+  /** @brief Sets the name of the yaml experiment schema file */
+  void set_experiment_schema_filename(std::string fn)
+  {
+    m_experiment_schema_filename = fn;
+  }
+
+  void load() override;
+
+  int get_num_labels() const override { return m_num_labels; }
+  int get_num_responses() const override
+  {
+    return get_linearized_response_size();
+  }
+  int get_linearized_data_size() const override { return m_datum_size; }
+  int get_linearized_label_size() const override { return m_num_labels; }
+  int get_linearized_response_size() const override
+  {
+    return m_response_size;
+  }
+  const std::vector<El::Int> get_data_dims() const override;
+
+protected:
+  bool fetch_datum(CPUMat& X, uint64_t data_id, uint64_t mb_idx) override;
+  bool fetch_label(CPUMat& Y, uint64_t data_id, uint64_t mb_idx) override;
+  bool fetch_response(CPUMat& Y, uint64_t data_id, uint64_t mb_idx) override;
+
+private:
+  /** Element types a column may hold */
+  enum class column_type
+  {
+    INT8,
+    UINT8,
+    INT16,
+    INT32,
+    INT64,
+    FLOAT32,
+    FLOAT64
+  };
+
+  /** A column as described by the file footer */
+  struct column
+  {
+    std::string name;
+    column_type type;
+    size_t word_size;
+    /** Dimensions of one sample */
+    std::vector<El::Int> dims;
+    /** Number of elements in one sample */
+    size_t sample_size;
+    bool compressed;
+    /** Byte offset of each chunk in the file */
+    std::vector<uint64_t> chunk_offsets;
+    /** Stored byte size of each chunk */
+    std::vector<uint64_t> chunk_sizes;
+    /** Byte size of each chunk once inflated, for sparse columns */
+    std::vector<uint64_t> raw_chunk_sizes;
+    DataType scale = 1;
+    DataType bias = 0;
+    /** Whether the column is in COO layout */
+    bool sparse = false;
+    /** Number of coordinates of each entry of a sparse column */
+    size_t index_dims = 0;
+    /** Whether the entries of a sparse column have values */
+    bool has_values = false;
+    /** Largest number of entries packed for a sample of a sparse column */
+    size_t capacity = 0;
+  };
+
+  /** Reads the header and footer of the memory-mapped file */
+  void read_footer();
+
+  /** Selects the columns named in the experiment schema */
+  void select_columns();
+
+  /** Returns the raw bytes of a chunk of a column, inflated if needed */
+  const char* get_chunk(size_t column_index, uint64_t chunk) const;
+
+  /** Returns the start of a sample's raw bytes in a dense column */
+  const char* get_sample(size_t column_index, uint64_t data_id) const;
+
+  /** Packs the entries of a sample of a sparse column */
+  void fetch_sparse(const column& col,
+                    size_t column_index,
+                    uint64_t data_id,
+                    DataType* dst) const;
+
+  /** Converts and copies a sample of each column into consecutive
+   *  rows of a mini-batch column
+   */
+  void fetch_columns(const std::vector<size_t>& columns,
+                     CPUMat& X,
+                     uint64_t data_id,
+                     uint64_t mb_idx) const;
+
+  std::string m_experiment_schema_filename;
+  conduit::Node m_experiment_schema;
+
+  /** Memory map of the data file, shared between copies */
+  std::shared_ptr<const file::mapped_file> m_file;
+  uint64_t m_num_samples = 0;
+  /** Number of samples in each chunk */
+  uint64_t m_chunk_size = 0;
+  std::vector<column> m_columns;
+
+  /** Indices into m_columns of the datum and response columns */
+  std::vector<size_t> m_datum_columns;
+  std::vector<size_t> m_response_columns;
+  /** Index into m_columns of the label column, if any */
+  int m_label_column = -1;
+
+  int m_datum_size = 0;
+  int m_response_size = 0;
+  int m_num_labels = 0;
+};
+
+} // namespace lbann
+
+#endif // LBANN_DATA_READER_COLUMNAR_HPP
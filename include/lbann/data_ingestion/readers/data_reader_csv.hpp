@@ -30,7 +30,10 @@
 #define LBANN_DATA_READER_CSV_HPP
 
 #include "lbann/data_ingestion/data_reader.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace lbann {
 
@@ -39,6 +42,9 @@ namespace lbann {
  * This will parse a header to determine how many columns of data there are, and
  * will return each row split based on a separator. This does not handle quotes
  * or escape sequences. The label column is by default converted to an integer.
+ * Rows are indexed up front but only parsed when fetched. With
+ * --csv_binary_cache, the parsed rows are written once to a binary cache
+ * that later runs memory-map instead of re-reading the CSV text.
  * @note This does not currently support comments or blank lines.
  */
 class csv_reader : public generic_data_reader
@@ -168,6 +174,39 @@ protected:
    *  (Made public to support data store functionality)
    */
   std::string fetch_raw_line(uint64_t data_id);
+  /// Read the raw line for data_id from a specific stream.
+  std::string read_raw_line(std::ifstream& ifs, uint64_t data_id);
+
+  /**
+   * Parse the data columns of a raw line into dst, skipping the label,
+   * response, and skipped columns. Returns the number of values written.
+   */
+  size_t parse_line(const std::string& line, DataType* dst);
+  /// Number of values parse_line writes per row.
+  size_t get_num_parsed_cols() const;
+  /// Whether col holds data (not the label, response, or a skipped column).
+  bool is_data_col(int col) const
+  {
+    return !((!m_disable_labels && col == m_label_col) ||
+             (!m_disable_responses && col == m_response_col) ||
+             col < m_skip_cols);
+  }
+
+  /**
+   * Build the row index from a memory map of the data file, starting at
+   * byte body_start. The scan is split across OpenMP threads, and labels
+   * and responses are extracted on the way.
+   */
+  void index_lines(size_t body_start,
+                   std::vector<long long>& index,
+                   std::unordered_set<int>& label_classes);
+
+  /// Fingerprint of the data file and the parsing configuration.
+  uint64_t get_binary_cache_key() const;
+  /// Map a binary cache if it matches key; returns false otherwise.
+  bool load_binary_cache(const std::string& filename, uint64_t key);
+  /// Parse every row into a binary cache, split across all ranks.
+  void write_binary_cache(const std::string& filename, uint64_t key);
 
   /// String value that separates data.
   char m_separator = ',';
@@ -207,6 +246,12 @@ protected:
   std::vector<int> m_labels;
   /// Store responses.
   std::vector<DataType> m_responses;
+  /// Memory-mapped binary cache of parsed rows (shared between copies).
+  std::shared_ptr<const file::mapped_file> m_binary_cache;
+  /// First parsed row in the binary cache.
+  const DataType* m_binary_cache_rows = nullptr;
+  /// Number of values per row in the binary cache.
+  size_t m_binary_cache_row_len = 0;
   /// Per-column transformation functions.
   std::unordered_map<int, std::function<DataType(const std::string&)>>
     m_col_transforms;
@@ -268,6 +268,8 @@ protected:
   void add_independent_variable_type(const variable_t independent);
   /// add data type for dependent variable
   void add_dependent_variable_type(const variable_t dependent);
+  /// Whether a data type is an independent or dependent variable
+  bool is_variable_used(const variable_t t) const;
 
   /// Check if a key is in the black lists to filter out
   bool filter(const std::set<std::string>& key_filter,
@@ -88,6 +88,8 @@ protected:
   generic_data_reader* m_label_reader;
   /// Sum of the size of data from all the data readers.
   int m_data_size = 0;
+  /// Row at which each reader's data starts, followed by m_data_size.
+  std::vector<int> m_data_offsets;
 };
 
 } // namespace lbann
@@ -31,6 +31,9 @@
 
 #include "compound_data_reader.hpp"
 
+#include <cstdint>
+#include <utility>
+
 namespace lbann {
 
 /**
@@ -93,6 +96,12 @@ protected:
 
   /// Partial sums of the number of samples in each reader.
   std::vector<uint64_t> m_num_samples_psum;
+  /// Index of the data reader holding each sample, so that fetches
+  /// look the reader up instead of searching the partial sums.
+  std::vector<uint16_t> m_sample_readers;
+
+  /// Return the reader holding a sample and the sample's index in it.
+  std::pair<generic_data_reader*, uint64_t> find_sample(uint64_t data_id) const;
 
   /// code common to both load() and load_using_data_store()
   void setup_indices(uint64_t num_samples);
@@ -31,6 +31,8 @@
 
 #include "lbann/data_ingestion/data_reader.hpp"
 
+#include <future>
+
 namespace lbann {
 
 /**
@@ -38,6 +40,11 @@ namespace lbann {
  * Provide the directory containing all the channel subdirectories.
  * This assumes the data is stored as floats in row-major order.
  * The channels to load are currently hardcoded. This only supports regression.
+ *
+ * Reading is latency-bound since every channel of a sample is its own
+ * file. All files of a sample are opened up front so that the file
+ * system reads them concurrently, and the files of the next
+ * mini-batch are prefetched through the I/O thread pool.
  */
 class mesh_reader : public generic_data_reader
 {
@@ -83,12 +90,28 @@ protected:
   bool fetch_datum(CPUMat& X, uint64_t data_id, uint64_t mb_idx) override;
   bool fetch_response(CPUMat& Y, uint64_t data_id, uint64_t mb_idx) override;
 
+  /** @brief Hint that the files of the next mini-batch will be read.
+   *
+   *  Assumes the next fetch continues where this one ends.
+   */
+  void prepare_sample_indices(uint64_t first,
+                              uint64_t stride,
+                              uint64_t count) override;
+
   /**
    * Load filename into mat.
    * This may do datatype conversion if DataType is not float.
    * mat should be of size (m_data_height, m_data_width).
    */
   void load_file(uint64_t data_id, const std::string channel, Mat& mat);
+  /**
+   * Read an open file into mat, as load_file.
+   * filename is only used for error messages.
+   */
+  void read_file(int fd,
+                 const std::string& filename,
+                 uint64_t data_id,
+                 Mat& mat);
   /// Return the full path to the data file for datum data_id's channel.
   std::string construct_filename(std::string channel, uint64_t data_id);
 
@@ -145,6 +168,8 @@ protected:
    * transformation applied.
    */
   std::vector<std::pair<bool, bool>> m_flip_choices;
+  /// Readahead hints for the next mini-batch, at most one job in flight.
+  std::shared_future<void> m_prefetch;
 };
 
 } // namespace lbann
@@ -30,6 +30,10 @@
 #include "lbann/data_ingestion/data_reader.hpp"
 #ifdef LBANN_HAS_LARGESCALE_NODE2VEC
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace lbann {
 
 // Note (tym 4/8/20): Including largescale_node2vec in this header
@@ -56,6 +60,14 @@ class RandomWalker;
  *  periodically recomputed based on the number of times each vertex
  *  is visited.
  *
+ *  Walks are generated in batches of one mini-batch, or, if
+ *  @c prefetch_batches is positive, by a background thread that runs
+ *  one batched walker call per @c prefetch_batches mini-batches and
+ *  keeps at least that many mini-batches of walks ready. The walker is
+ *  collective over the trainer, so the background thread decides when
+ *  to run purely from the number of mini-batches consumed, which is the
+ *  same on every rank.
+ *
  *  @warning This is experimental.
  *
  */
@@ -67,7 +79,8 @@ public:
                   size_t walk_length,
                   double return_param,
                   double inout_param,
-                  size_t num_negative_samples);
+                  size_t num_negative_samples,
+                  size_t prefetch_batches = 0);
   node2vec_reader(const node2vec_reader&) = delete;
   node2vec_reader& operator=(const node2vec_reader&) = delete;
   ~node2vec_reader() override;
@@ -93,11 +106,32 @@ protected:
 private:
   /** Perform random walks, starting from random local vertices.
    *
-   *  This uses IO RNG objects internally, so we have to make sure
-   *  that the caller has acquired control of the IO RNG.
+   *  Complete walks are appended to @c walks back to back, each with
+   *  @c m_walk_length vertex indices. The caller must own @c gen,
+   *  e.g. by having acquired control of the IO RNG.
+   */
+  void run_walker(size_t num_walks, rng_gen& gen, std::vector<size_t>& walks);
+
+  /** Add walks to the cache, growing it to at least @c min_capacity
+   *  walks and evicting the oldest walks once it is full.
+   */
+  void
+  cache_walks(const size_t* walks, size_t num_walks, size_t min_capacity);
+
+  /** Get the i-th oldest walk in the cache. */
+  const size_t* get_cached_walk(size_t i) const;
+
+  /** Whether the background thread should run another walker call.
+   *
+   *  Expects @c m_walks_mutex to be held.
    */
-  std::vector<std::vector<size_t>> run_walker(size_t num_walks,
-                                              const locked_io_rng_ref&);
+  bool need_prefetch_round() const;
+
+  /** Main loop of the background thread that prefetches walks. */
+  void prefetch_walks(size_t walks_per_round);
+
+  /** Stop and join the background thread. */
+  void stop_prefetching();
 
   /** Update noise distribution for negative sampling.
    *
@@ -123,8 +157,43 @@ private:
    *  there is not a step to gather them to the original process. To
    *  handle cases where the walker returns no walks, we cache walks
    *  from previous mini-batch iterations.
+   *
+   *  This is a ring buffer of @c m_walks_cache_capacity walks stored
+   *  back to back.
+   */
+  std::vector<size_t> m_walks_cache;
+  /** Number of walks the cache can hold. */
+  size_t m_walks_cache_capacity{0};
+  /** Slot of the oldest walk in the cache. */
+  size_t m_walks_cache_begin{0};
+  /** Number of walks in the cache. */
+  size_t m_walks_cache_size{0};
+
+  /** @brief Number of mini-batches of walks to generate per walker
+   *  call in the background thread. Zero disables prefetching.
+   */
+  size_t m_prefetch_batches;
+  /** Background thread that prefetches walks. */
+  std::thread m_prefetch_thread;
+  /** Guards the prefetch state and the vertex visit counts. */
+  std::mutex m_walks_mutex;
+  std::condition_variable m_walks_cv;
+  /** Prefetched walks that have not been cached, stored back to back
+   *  starting at @c m_ready_walks_begin.
+   */
+  std::vector<size_t> m_ready_walks;
+  size_t m_ready_walks_begin{0};
+  /** Number of mini-batches covered by completed walker calls. */
+  size_t m_produced_batches{0};
+  /** Number of mini-batches consumed by @c fetch_data_block. */
+  size_t m_consumed_batches{0};
+  bool m_stop_prefetch{false};
+  /** RNG owned by the background thread. */
+  rng_gen m_prefetch_rng;
+  /** Duplicate of the trainer communicator used by the walker, so that
+   *  its collectives never interleave with other trainer traffic.
    */
-  std::deque<std::vector<size_t>> m_walks_cache;
+  MPI_Comm m_walker_comm{MPI_COMM_NULL};
 
   /** Global indices of local graph vertices. */
   std::vector<size_t> m_local_vertex_global_indices;
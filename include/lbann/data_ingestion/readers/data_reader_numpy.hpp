@@ -32,6 +32,7 @@
 
 #include "lbann/data_ingestion/data_reader.hpp"
 #include <cnpy.h>
+#include <memory>
 
 namespace lbann {
 
@@ -88,6 +89,19 @@ protected:
    * for copying).
    */
   cnpy::NpyArray m_data;
+  /**
+   * If set, the array's data lives in node-shared memory (see
+   * --node_shared_numpy) and m_data only holds its metadata.
+   */
+  std::shared_ptr<const char> m_shared_data;
+
+  /// Returns the array's data, wherever it is held
+  template <typename T>
+  const T* get_data() const
+  {
+    return reinterpret_cast<const T*>(
+      m_shared_data ? m_shared_data.get() : m_data.data_holder->data());
+  }
 };
 
 } // namespace lbann
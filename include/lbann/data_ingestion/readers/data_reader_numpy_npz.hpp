@@ -33,6 +33,7 @@
 #include "data_reader_numpy.hpp"
 #include "lbann/data_ingestion/data_reader.hpp"
 #include <cnpy.h>
+#include <memory>
 
 namespace lbann {
 /**
@@ -99,6 +100,21 @@ protected:
    * for copying).
    */
   cnpy::NpyArray m_data, m_labels, m_responses;
+  /**
+   * If set, the corresponding array's data lives in node-shared memory
+   * (see --node_shared_numpy) and the NpyArray only holds its metadata.
+   */
+  std::shared_ptr<const char> m_shared_data, m_shared_labels,
+    m_shared_responses;
+
+  /// Returns an array's data, wherever it is held
+  template <typename T>
+  static const T* get_data(const cnpy::NpyArray& ary,
+                           const std::shared_ptr<const char>& shared)
+  {
+    return reinterpret_cast<const T*>(shared ? shared.get()
+                                             : ary.data_holder->data());
+  }
 
   // A constant to be multiplied when data is converted
   // from int16 to DataType.
@@ -67,6 +67,8 @@ protected:
                         uint64_t mb_size,
                         El::Matrix<El::Int>& indices_fetched,
                         execution_mode mode = execution_mode::invalid) override;
+  /** The whole mini-batch is fetched by the first I/O thread. */
+  bool supports_dynamic_sample_scheduling() const override { return false; }
   bool fetch_label(CPUMat& Y, uint64_t data_id, uint64_t mb_idx) override;
 
 private:
@@ -39,11 +39,13 @@ public:
   python_dataset_reader(std::string dataset_path,
                         std::string module_dir,
                         uint64_t prefetch_factor,
+                        uint64_t batches_in_flight,
                         bool shuffle)
     : generic_data_reader(shuffle),
       m_dataset_path(dataset_path),
       m_module_dir(module_dir),
-      m_prefetch_factor(prefetch_factor)
+      m_prefetch_factor(prefetch_factor),
+      m_batches_in_flight(batches_in_flight)
   {}
   python_dataset_reader(const python_dataset_reader&) = default;
   python_dataset_reader& operator=(const python_dataset_reader&) = default;
@@ -84,10 +86,17 @@ protected:
                         uint64_t mb_size,
                         El::Matrix<El::Int>& indices_fetched,
                         execution_mode mode = execution_mode::invalid) override;
+  /** The whole mini-batch is fetched by the first I/O thread. */
+  bool supports_dynamic_sample_scheduling() const override { return false; }
 
 private:
   void queue_epoch();
-  void queue_samples(uint64_t samples_to_queue);
+  /** @brief Submit the next local mini-batch to the worker processes.
+   *
+   *  The workers assemble the samples directly into a free slot of the
+   *  shared-memory batch ring. Returns false once the epoch is exhausted.
+   */
+  bool queue_batch();
 
   /** @brief Path to the pickled dataset object. */
   std::string m_dataset_path;
@@ -95,14 +104,15 @@ private:
   std::string m_module_dir;
   /** @brief Number of samples to prefetch per worker. */
   int m_prefetch_factor;
+  /** @brief Number of mini-batches kept in flight (0 = derive from
+   *  prefetch factor). */
+  uint64_t m_batches_in_flight;
   /** @brief Number of I/O threads. */
   int m_num_io_threads;
   /** @brief The current dataset shuffled minibatch offset. */
   uint64_t m_dataset_minibatch_offset;
-  /** @brief The current dataset shuffled sample offset. */
-  uint64_t m_dataset_sample_offset;
-  /** @brief Number of samples requested this epoch. */
-  uint64_t m_queued_samples;
+  /** @brief Number of mini-batches queued but not yet fetched. */
+  uint64_t m_queued_batches;
   /** @brief Dimensions of data sample tensor. */
   std::vector<El::Int> m_sample_dims;
   /** @brief Size of label tensor. */
@@ -58,10 +58,16 @@ public:
   std::string get_type() const override { return "data_reader_sample_list"; }
 
   /** @brief Open the file and get the sample name for the given index.
+   *  @details The handle is leased from the sample list's open file
+   *           cache, so it is not evicted until the matching
+   *           close_file().
    *  @returns A pair containing the file handle and the name of the
    *           sample.
    */
   std::pair<file_handle_type, sample_name_type> open_file(size_t index);
+  /** @brief Release the lease taken by open_file(). The handle stays
+   *         cached until it is evicted.
+   */
   void close_file(size_t index_in);
 
   /**
@@ -88,6 +94,10 @@ protected:
   void
   load_list_of_samples_from_archive(const std::string& sample_list_archive);
 
+  /** Order each rank's samples within every mini-batch by file; see
+   *  --sort_mini_batch_by_file */
+  void sort_mini_batches_by_file(uint64_t mini_batch_size);
+
 }; // class data_reader_sample_list
 
 } // end of namespace lbann
@@ -36,6 +36,9 @@
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/vectorwrapbuf.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace lbann {
 
 template <typename SampleListT>
@@ -81,6 +84,11 @@ void data_reader_sample_list<SampleListT>::shuffle_indices(rng_gen& gen)
   if (trainer_exists()) {
     mini_batch_size = get_trainer().get_max_mini_batch_size();
   }
+  auto& arg_parser = global_argument_parser();
+  if (mini_batch_size != 0 &&
+      arg_parser.get<bool>(LBANN_OPTION_SORT_MINI_BATCH_BY_FILE)) {
+    sort_mini_batches_by_file(mini_batch_size);
+  }
   if (mini_batch_size != 0) {
     m_sample_list.compute_epochs_file_usage(get_shuffled_indices(),
                                             mini_batch_size,
@@ -88,6 +96,35 @@ void data_reader_sample_list<SampleListT>::shuffle_indices(rng_gen& gen)
   }
 }
 
+template <typename SampleListT>
+void data_reader_sample_list<SampleListT>::sort_mini_batches_by_file(
+  uint64_t mini_batch_size)
+{
+  // Rank r fetches positions i of each mini-batch with
+  // i % num_ranks == r (see compute_epochs_file_usage), so sorting
+  // within those strided slots leaves every sample on the same rank
+  // and in the same mini-batch.
+  const uint64_t num_ranks = m_comm->get_procs_per_trainer();
+  const uint64_t num_samples = m_shuffled_indices.size();
+  std::vector<uint64_t> slice;
+  for (uint64_t base = 0; base < num_samples; base += mini_batch_size) {
+    const uint64_t end = std::min(base + mini_batch_size, num_samples);
+    for (uint64_t r = 0; r < num_ranks; ++r) {
+      slice.clear();
+      for (uint64_t i = base + r; i < end; i += num_ranks) {
+        slice.push_back(m_shuffled_indices[i]);
+      }
+      std::stable_sort(slice.begin(), slice.end(), [this](auto a, auto b) {
+        return m_sample_list[a].first < m_sample_list[b].first;
+      });
+      uint64_t k = 0;
+      for (uint64_t i = base + r; i < end; i += num_ranks) {
+        m_shuffled_indices[i] = slice[k++];
+      }
+    }
+  }
+}
+
 template <typename SampleListT>
 void data_reader_sample_list<SampleListT>::load()
 {
@@ -119,8 +156,15 @@ void data_reader_sample_list<SampleListT>::load_list_of_samples(
     m_sample_list.keep_sample_order(false);
   }
 
-  // Load the sample list
-  if (arg_parser.get<bool>(LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE)) {
+  // Load the sample list. A binary sample list is memory-mapped by every rank,
+  // which then only parses its own partition, so it is never broadcast. With
+  // a node-shared sample list, the binary index is built once per node for
+  // all trainers that use the same file.
+  if (arg_parser.get<bool>(LBANN_OPTION_NODE_SHARED_SAMPLE_LIST)) {
+    m_sample_list.load_node_shared(sample_list_file, *(this->m_comm), true);
+  }
+  else if (arg_parser.get<bool>(LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE) &&
+      !is_binary_sample_list(sample_list_file)) {
     std::vector<char> buffer;
     if (m_comm->am_trainer_master()) {
       load_file(sample_list_file, buffer);
@@ -152,6 +196,11 @@ void data_reader_sample_list<SampleListT>::load_list_of_samples(
 
   // Set base directory for your data.
   generic_data_reader::set_file_dir(m_sample_list.get_samples_dirname());
+
+  const int max_open_files = arg_parser.get<int>(LBANN_OPTION_MAX_OPEN_FILES);
+  if (max_open_files > 0) {
+    m_sample_list.set_max_open_files(max_open_files);
+  }
 }
 
 template <typename SampleListT>
@@ -178,7 +227,7 @@ auto data_reader_sample_list<SampleListT>::open_file(size_t index)
   -> std::pair<file_handle_type, sample_name_type>
 {
   auto [sample_id, sample_name] = m_sample_list[index];
-  m_sample_list.open_samples_file_handle(index);
+  m_sample_list.acquire_samples_file_handle(index);
   auto file_handle_out = m_sample_list.get_samples_file_handle(sample_id);
   LBANN_ASSERT(m_sample_list.is_file_handle_valid(file_handle_out));
   return std::make_pair(file_handle_out, std::move(sample_name));
@@ -187,7 +236,7 @@ auto data_reader_sample_list<SampleListT>::open_file(size_t index)
 template <typename SampleListT>
 void data_reader_sample_list<SampleListT>::close_file(size_t index)
 {
-  m_sample_list.close_samples_file_handle(index);
+  m_sample_list.release_samples_file_handle(index);
 }
 
 } // end of namespace lbann
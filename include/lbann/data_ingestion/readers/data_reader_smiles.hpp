@@ -81,6 +81,10 @@ public:
   }
   int get_num_labels() const override { return m_num_labels; }
 
+  bool has_variable_length_samples() const override { return true; }
+  /** Tokens in the sample including <bos> and <eos>, but not <pad> */
+  uint64_t get_sample_length(uint64_t data_id) const override;
+
   void set_sequence_length(int n)
   {
     m_sequence_length = n;
@@ -146,6 +150,18 @@ public:
   /** @brief Returns the name of the metadata file */
   const std::string& get_metadata_filename() { return m_metadata_filename; }
 
+  /** @brief Tokenize every sample of a SMILES data file into a token cache
+   *
+   *  The cache holds one record of get_linearized_data_size() token ids per
+   *  line of the data file, in the same order as the offsets file, behind a
+   *  small header that records the record length and a hash of the
+   *  vocabulary. The file is written under a temporary name and renamed
+   *  into place, so concurrent builders never expose a partial cache.
+   */
+  void write_token_cache(const std::string& data_filename,
+                         const std::string& offsets_filename,
+                         const std::string& cache_filename);
+
 private:
   // note: linearized_size is m_sequence_length+2; the +2 is for the
   //       <bos> and <eos> characters that get tacked on
@@ -191,6 +207,16 @@ private:
   // maps: sample id -> offset within a file
   offset_map_t m_sample_offsets;
 
+  /** A memory-mapped token cache for one SMILES data file; defined in the
+   *  source file. Shared between copies of the reader.
+   */
+  struct token_cache_file;
+
+  /** maps: sample list file id -> token cache; empty unless
+   *  --smiles_token_cache is given
+   */
+  std::vector<std::shared_ptr<const token_cache_file>> m_token_cache;
+
   /** Here and elsewhere, 'index' refers to an entry in the shuffled indices;
    *  'local_id' refers, loosely, to a line number in a file.
    *  Also, 'file' or 'filename' refers to a file containing SMILES strings.
@@ -246,6 +272,12 @@ private:
 
   void build_some_maps();
 
+  /// Hash of the vocabulary and record length; stored in token caches
+  uint64_t get_token_cache_key() const;
+
+  /// Build any missing token caches under cache_dir and map them
+  void load_token_caches(const std::string& cache_dir);
+
   // called by read_offset_data()
   void read_metadata_file(std::vector<size_t>& samples_per_file,
                           std::vector<std::string>& data_filenames,
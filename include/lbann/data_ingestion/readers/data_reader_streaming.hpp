@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_READER_STREAMING_HPP
+#define LBANN_DATA_READER_STREAMING_HPP
+
+#include "lbann/data_ingestion/data_reader.hpp"
+
+#include <deque>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace lbann {
+
+/**
+ * Base class for readers of data sets too large to index per sample.
+ *
+ * generic_data_reader shuffles a vector holding one index per sample,
+ * which costs 8 bytes per sample on every rank. A streaming reader
+ * instead describes its data as a list of shards (e.g. files), each a
+ * run of consecutive samples, and samples are drawn as a stream:
+ *
+ * - Each epoch visits the shards in a new random order and reads each
+ *   shard front to back.
+ * - The samples pass through a shuffle buffer of bounded size
+ *   (--stream_shuffle_buffer_size), which emits a random buffered
+ *   sample for each one read.
+ *
+ * Memory is proportional to the number of shards and the buffer size,
+ * not to the number of samples. Every rank in the trainer replays the
+ * same stream of sample indices, which is cheap next to reading the
+ * samples, and keeps only the window that the current mini-batch
+ * needs. The stream is a deterministic function of the seed drawn at
+ * setup, the epoch and the position, so the checkpointed epoch and
+ * data set position are enough to resume it.
+ *
+ * Derived classes call set_shards() from load() and implement the
+ * usual fetch_datum()/fetch_label()/fetch_response() for global
+ * sample indices; locate_sample() splits an index into a shard and an
+ * offset. Validation and tournament splits of a streaming reader are
+ * not supported; use separate readers for those roles.
+ */
+class streaming_data_reader : public generic_data_reader
+{
+public:
+  streaming_data_reader(bool shuffle = true);
+  streaming_data_reader(const streaming_data_reader&);
+  streaming_data_reader& operator=(const streaming_data_reader&);
+  ~streaming_data_reader() override = default;
+
+  bool is_streaming() const override { return true; }
+  uint64_t get_num_data() const override { return m_num_samples; }
+  uint64_t get_sample_index(uint64_t position) const override;
+  void prepare_sample_indices(uint64_t first,
+                              uint64_t stride,
+                              uint64_t count) override;
+
+  /** @brief Sets the number of samples held in the shuffle buffer.
+   *
+   *  Defaults to --stream_shuffle_buffer_size.
+   */
+  void set_shuffle_buffer_size(uint64_t size) { m_shuffle_buffer_size = size; }
+
+  /** @brief Number of shards in the data set. */
+  uint64_t get_num_shards() const { return m_shard_offsets.size() - 1; }
+
+  /** @brief Splits a global sample index into its shard and the
+   *  offset within the shard.
+   */
+  std::pair<uint64_t, uint64_t> locate_sample(uint64_t index) const;
+
+protected:
+  using generic_data_reader::shuffle_indices;
+  /** @brief Restarts the stream for the current epoch. */
+  void shuffle_indices(rng_gen& gen) override;
+
+  /** @brief Declares the shards of the data set.
+   *
+   *  Shard @c i holds the samples with global indices starting at the
+   *  sum of the sizes of the shards before it. Honors
+   *  absolute_sample_count and fraction_of_data_to_use by stopping the
+   *  stream early.
+   */
+  void set_shards(const std::vector<uint64_t>& shard_sizes);
+
+private:
+  /** Restarts the stream at the beginning of the current epoch */
+  void restart_stream();
+
+  /** Draws the next sample index of the stream */
+  uint64_t next_sample_index();
+
+  /** Total number of samples drawn per epoch */
+  uint64_t m_num_samples = 0;
+  /** Global index of the first sample of each shard, and the total */
+  std::vector<uint64_t> m_shard_offsets;
+  /** Capacity of the shuffle buffer; 0 until set or read from the
+   *  command line */
+  uint64_t m_shuffle_buffer_size = 0;
+  /** Seed of the stream, drawn from the data sequence generator once */
+  uint64_t m_seed = 0;
+  bool m_seeded = false;
+
+  // Stream state for the current epoch
+  std::mt19937_64 m_stream_gen;
+  std::vector<uint64_t> m_shard_order;
+  uint64_t m_shard_position = 0;
+  uint64_t m_sample_in_shard = 0;
+  std::vector<uint64_t> m_shuffle_buffer;
+  /** Sample indices drawn for positions [m_window_start, ...) */
+  std::deque<uint64_t> m_window;
+  uint64_t m_window_start = 0;
+  /** Epoch that the stream state belongs to */
+  uint64_t m_stream_epoch = 0;
+  std::mutex m_stream_mutex;
+};
+
+} // namespace lbann
+
+#endif // LBANN_DATA_READER_STREAMING_HPP
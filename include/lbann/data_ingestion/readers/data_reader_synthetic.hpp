@@ -39,6 +39,12 @@ namespace lbann {
 /**
  * Data reader for generating random samples.
  * Samples are different every time.
+ *
+ * When generating on the device, the I/O threads fetch nothing and
+ * the input layers fill each mini-batch directly in GPU memory with
+ * standard normal samples and responses and one-hot labels, so
+ * benchmarks measure neither host fetch nor host-to-device copies.
+ * The tensor type of the samples is that of the input layer.
  */
 class data_reader_synthetic : public generic_data_reader
 {
@@ -68,6 +74,13 @@ public:
 
   void load() override;
 
+  /** @brief Generate mini-batches on the device instead of the host */
+  void set_generate_on_device(bool b) { m_generate_on_device = b; }
+  bool generates_data_on_device() const override
+  {
+    return m_generate_on_device;
+  }
+
   int get_linearized_size(data_field_type const& data_field) const override
   {
     auto iter = m_synthetic_data_fields.find(data_field);
@@ -121,6 +134,9 @@ private:
   std::vector<El::Int> m_response_dimensions;
 
   std::map<data_field_type, std::vector<El::Int>> m_synthetic_data_fields;
+
+  /** Whether input layers generate the mini-batches on the device */
+  bool m_generate_on_device = false;
 };
 
 } // namespace lbann
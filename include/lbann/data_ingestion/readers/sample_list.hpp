@@ -46,6 +46,8 @@ static const std::string multi_sample_inclusion_v2 =
   "MULTI-SAMPLE_INCLUSION_V2";
 static const std::string conduit_hdf5_exclusion = "CONDUIT_HDF5_EXCLUSION";
 static const std::string conduit_hdf5_inclusion = "CONDUIT_HDF5_INCLUSION";
+/// Leading bytes that identify a sample list in the binary index format
+static const std::string binary_sample_list_magic = "LBANNSL1";
 
 struct sample_list_header
 {
@@ -135,6 +137,24 @@ public:
             const lbann_comm& comm,
             bool interleave);
 
+  /** Load the partition of a binary sample list selected by the stride and
+   *  offset. The file is memory-mapped and only the records of the files
+   *  assigned to this rank are parsed.
+   */
+  void load_binary(const std::string& samplelist_file,
+                   size_t stride = 1,
+                   size_t offset = 0);
+
+  /** Load this rank's partition of a sample list whose binary index is built
+   *  once per node. One rank on the node reads the file, text or binary,
+   *  into a node-local shared memory segment that every rank loading the
+   *  same file maps, so trainers that share a sample list neither re-read
+   *  nor re-index it. Collective over the ranks of the node.
+   */
+  void load_node_shared(const std::string& samplelist_file,
+                        const lbann_comm& comm,
+                        bool interleave);
+
   /// Restore a sample list from a serialized string
   void load_from_string(const std::string& samplelist,
                         const lbann_comm& comm,
@@ -216,11 +236,22 @@ protected:
   /// Reads the header of a sample list
   void read_header(std::istream& istrm);
 
+  /// Load the partition of a binary sample list held in memory
+  void load_binary_image(const char* data,
+                         size_t file_size,
+                         const std::string& samplelist_file,
+                         size_t stride,
+                         size_t offset);
+
   /// read the body of a sample list, which is the list of sample files, where
   /// each file contains a single sample.
   virtual void
   read_sample_list(std::istream& istrm, size_t stride = 1, size_t offset = 0);
 
+  /// Parse one non-empty line of the sample list body, without the trailing
+  /// whitespaces
+  virtual void read_sample_list_line(const std::string& line);
+
   /// Assign names to samples when there is only one sample per file without a
   /// name.
   virtual void assign_samples_name();
@@ -28,9 +28,13 @@
 #define LBANN_DATA_READERS_SAMPLE_LIST_IMPL_HPP
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <locale>
 #include <memory>
@@ -40,6 +44,9 @@
 #include <unordered_set>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "lbann/comm_impl.hpp"
@@ -285,6 +292,120 @@ inline const std::string& sample_list_header::get_label_filename() const
   return m_label_filename;
 }
 
+//--------------------------
+//   binary sample list
+//--------------------------
+
+// The binary index format stores the text header verbatim followed by a table
+// of offsets into a string table that holds one body line per data file:
+//   magic (8 bytes), version, number of files, header length  (uint64 each)
+//   header text
+//   offsets[number of files + 1]                               (uint64 each)
+//   body lines, concatenated without separators
+// Integers are in the native byte order of the host that wrote the file.
+
+static constexpr uint64_t binary_sample_list_version = 1u;
+
+/// Whether the given file is a sample list in the binary index format
+inline bool is_binary_sample_list(const std::string& samplelist_file)
+{
+  std::ifstream ifs(samplelist_file, std::ios::binary);
+  std::string magic(binary_sample_list_magic.size(), '\0');
+  ifs.read(&magic[0], magic.size());
+  return ifs.good() && (magic == binary_sample_list_magic);
+}
+
+/** Build the binary index image of a text sample list in memory. Exclusive
+ *  lists are rejected since resolving them requires opening every data file.
+ */
+inline std::string make_binary_sample_list(const std::string& text_file)
+{
+  zstr::ifstream istrm(text_file);
+  std::string header_text;
+  sample_list_header header;
+  auto read_header_line = [&](const std::string& info) {
+    std::string line;
+    if (!std::getline(istrm, line) || line.empty()) {
+      LBANN_ERROR("unable to read the header line of sample list ",
+                  text_file,
+                  " for ",
+                  info);
+    }
+    header_text += line + "\n";
+    return line;
+  };
+
+  header.set_sample_list_type(read_header_line("the exclusiveness"));
+  header.set_sample_count(
+    read_header_line("the number of samples and the number of files"));
+  header.set_data_file_dir(read_header_line("the data file directory"));
+  if (header.use_label_header()) {
+    header.set_label_filename(
+      read_header_line("the path to label/response file"));
+  }
+  if (header.is_exclusive()) {
+    LBANN_ERROR("sample list ",
+                text_file,
+                " is exclusive; only inclusive and single-sample lists can "
+                "be converted to the binary format");
+  }
+
+  const uint64_t num_files = header.get_num_files();
+  std::vector<uint64_t> offsets;
+  offsets.reserve(num_files + 1u);
+  offsets.push_back(0u);
+  std::string body;
+
+  const std::string whitespaces(" \t\f\v\n\r");
+  std::string line;
+  while ((offsets.size() <= num_files) && std::getline(istrm, line)) {
+    const size_t end_of_str = line.find_last_not_of(whitespaces);
+    if (end_of_str == std::string::npos) { // empty line
+      continue;
+    }
+    body.append(line, 0, end_of_str + 1);
+    offsets.push_back(body.size());
+  }
+  if (offsets.size() != num_files + 1u) {
+    LBANN_ERROR("Sample list ",
+                text_file,
+                ": number of files requested ",
+                num_files,
+                " does not equal number of files found ",
+                offsets.size() - 1u);
+  }
+
+  const uint64_t fields[3] = {binary_sample_list_version,
+                              num_files,
+                              header_text.size()};
+  std::string image;
+  image.reserve(binary_sample_list_magic.size() + sizeof(fields) +
+                header_text.size() + offsets.size() * sizeof(uint64_t) +
+                body.size());
+  image.append(binary_sample_list_magic);
+  image.append(reinterpret_cast<const char*>(fields), sizeof(fields));
+  image.append(header_text);
+  image.append(reinterpret_cast<const char*>(offsets.data()),
+               offsets.size() * sizeof(uint64_t));
+  image.append(body);
+  return image;
+}
+
+/// Convert a text sample list into the binary index format
+inline void write_binary_sample_list(const std::string& text_file,
+                                     const std::string& binary_file)
+{
+  const std::string image = make_binary_sample_list(text_file);
+  std::ofstream ofs(binary_file, std::ios::binary | std::ios::trunc);
+  if (!ofs) {
+    LBANN_ERROR("unable to open ", binary_file, " for writing");
+  }
+  ofs.write(image.data(), image.size());
+  if (!ofs) {
+    LBANN_ERROR("failed to write the binary sample list ", binary_file);
+  }
+}
+
 //------------------
 //   sample_list
 //------------------
@@ -359,6 +480,12 @@ inline void sample_list<sample_name_t>::load(const std::string& samplelist_file,
                                              const lbann_comm& comm,
                                              bool interleave)
 {
+  if (is_binary_sample_list(samplelist_file)) {
+    const size_t stride = interleave ? comm.get_procs_per_trainer() : 1ul;
+    const size_t offset = interleave ? comm.get_rank_in_trainer() : 0ul;
+    load_binary(samplelist_file, stride, offset);
+    return;
+  }
   m_header.set_sample_list_name(samplelist_file);
   zstr::ifstream istrm(samplelist_file);
   // std::ifstream istrm(samplelist_file);
@@ -391,6 +518,263 @@ inline void sample_list<sample_name_t>::load(const sample_list_header& header,
   read_sample_list(istrm, stride, offset);
 }
 
+template <typename sample_name_t>
+inline void
+sample_list<sample_name_t>::load_binary(const std::string& samplelist_file,
+                                        size_t stride,
+                                        size_t offset)
+{
+  const int fd = open(samplelist_file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LBANN_ERROR("unable to open binary sample list ", samplelist_file);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    LBANN_ERROR("unable to stat binary sample list ", samplelist_file);
+  }
+  const size_t file_size = st.st_size;
+  void* const mapped =
+    (file_size > 0u) ? mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0)
+                     : MAP_FAILED;
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    LBANN_ERROR("unable to map binary sample list ", samplelist_file);
+  }
+  std::unique_ptr<void, std::function<void(void*)>> mapping(
+    mapped,
+    [file_size](void* p) { munmap(p, file_size); });
+  load_binary_image(static_cast<const char*>(mapped),
+                    file_size,
+                    samplelist_file,
+                    stride,
+                    offset);
+}
+
+template <typename sample_name_t>
+inline void
+sample_list<sample_name_t>::load_binary_image(const char* data,
+                                              size_t file_size,
+                                              const std::string& samplelist_file,
+                                              size_t stride,
+                                              size_t offset)
+{
+  m_header.set_sample_list_name(samplelist_file);
+  m_stride = stride;
+
+  size_t pos = binary_sample_list_magic.size();
+  auto read_u64 = [&](size_t at) {
+    if (at + sizeof(uint64_t) > file_size) {
+      LBANN_ERROR("binary sample list ", samplelist_file, " is truncated");
+    }
+    uint64_t v;
+    std::memcpy(&v, data + at, sizeof(v));
+    return v;
+  };
+  const uint64_t version = read_u64(pos);
+  const uint64_t num_files = read_u64(pos + sizeof(uint64_t));
+  const uint64_t header_len = read_u64(pos + 2 * sizeof(uint64_t));
+  pos += 3 * sizeof(uint64_t);
+  if (version != binary_sample_list_version) {
+    LBANN_ERROR("binary sample list ",
+                samplelist_file,
+                " has unsupported version ",
+                version);
+  }
+  if (pos + header_len > file_size) {
+    LBANN_ERROR("binary sample list ", samplelist_file, " is truncated");
+  }
+
+  std::istringstream header_strm(std::string(data + pos, header_len));
+  read_header(header_strm);
+  if (m_header.is_exclusive() || (m_header.get_num_files() != num_files)) {
+    LBANN_ERROR("binary sample list ",
+                samplelist_file,
+                " has an inconsistent header");
+  }
+
+  const size_t offsets_pos = pos + header_len;
+  const size_t body_pos = offsets_pos + (num_files + 1u) * sizeof(uint64_t);
+  if (body_pos + read_u64(offsets_pos + num_files * sizeof(uint64_t)) >
+      file_size) {
+    LBANN_ERROR("binary sample list ", samplelist_file, " is truncated");
+  }
+
+  m_sample_list.reserve(m_header.get_sample_count() / stride + 1u);
+  for (size_t f = offset; f < num_files; f += stride) {
+    const uint64_t begin = read_u64(offsets_pos + f * sizeof(uint64_t));
+    const uint64_t end = read_u64(offsets_pos + (f + 1u) * sizeof(uint64_t));
+    if (begin > end) {
+      LBANN_ERROR("binary sample list ", samplelist_file, " is corrupted");
+    }
+    read_sample_list_line(std::string(data + body_pos + begin, end - begin));
+  }
+}
+
+template <typename sample_name_t>
+inline void
+sample_list<sample_name_t>::load_node_shared(const std::string& samplelist_file,
+                                             const lbann_comm& comm,
+                                             bool interleave)
+{
+  // Only the ranks on this node that load the same file share a segment.
+  // Trainers with their own lists fall into separate groups.
+  const size_t name_hash = std::hash<std::string>{}(samplelist_file);
+  MPI_Comm list_comm;
+  MPI_Comm_split(comm.get_node_comm().GetMPIComm(),
+                 static_cast<int>(name_hash & 0x7fffffffu),
+                 comm.get_rank_in_world(),
+                 &list_comm);
+
+  // Different files can hash to the same color. Split off the ranks that
+  // load the root's file until every group loads a single file.
+  while (true) {
+    unsigned long long root_name_size = samplelist_file.size();
+    MPI_Bcast(&root_name_size, 1, MPI_UNSIGNED_LONG_LONG, 0, list_comm);
+    std::string root_name = samplelist_file;
+    root_name.resize(root_name_size);
+    MPI_Bcast(root_name.data(),
+              static_cast<int>(root_name_size),
+              MPI_CHAR,
+              0,
+              list_comm);
+    int same_file = (root_name == samplelist_file) ? 1 : 0;
+    int all_same_file = 0;
+    MPI_Allreduce(&same_file, &all_same_file, 1, MPI_INT, MPI_LAND, list_comm);
+    if (all_same_file) {
+      break;
+    }
+    MPI_Comm sub_comm;
+    MPI_Comm_split(list_comm, 1 - same_file, 0, &sub_comm);
+    MPI_Comm_free(&list_comm);
+    list_comm = sub_comm;
+  }
+  int list_rank = 0;
+  MPI_Comm_rank(list_comm, &list_rank);
+  const bool is_root = (list_rank == 0);
+
+  // The root builds the binary index and publishes it under a name unique to
+  // its process. Its errors are broadcast so that every rank raises them
+  // instead of waiting for a segment that never comes.
+  std::string seg_name;
+  void* seg = MAP_FAILED;
+  std::string error;
+  unsigned long long fields[3] = {0ull, 0ull, 0ull}; // size, pid, error size
+  if (is_root) {
+    try {
+      std::string image;
+      if (is_binary_sample_list(samplelist_file)) {
+        std::ifstream ifs(samplelist_file, std::ios::binary);
+        image.assign(std::istreambuf_iterator<char>(ifs),
+                     std::istreambuf_iterator<char>());
+        if (!ifs.good() && !ifs.eof()) {
+          LBANN_ERROR("unable to read binary sample list ", samplelist_file);
+        }
+      }
+      else {
+        image = make_binary_sample_list(samplelist_file);
+      }
+      if (image.empty()) {
+        LBANN_ERROR("sample list ", samplelist_file, " is empty");
+      }
+      fields[0] = image.size();
+      fields[1] = static_cast<unsigned long long>(getpid());
+      seg_name = "/lbann_sl_" + std::to_string(name_hash) + "_" +
+                 std::to_string(fields[1]);
+
+      shm_unlink(seg_name.c_str()); // in case a previous run left it behind
+      const int fd =
+        shm_open(seg_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      if (fd == -1) {
+        LBANN_ERROR("shm_open failed for ",
+                    seg_name,
+                    " (",
+                    samplelist_file,
+                    ")");
+      }
+      const bool sized = (ftruncate(fd, image.size()) == 0);
+      if (sized) {
+        seg = mmap(nullptr,
+                   image.size(),
+                   PROT_READ | PROT_WRITE,
+                   MAP_SHARED,
+                   fd,
+                   0);
+      }
+      close(fd);
+      if (!sized) {
+        LBANN_ERROR("ftruncate of ", seg_name, " to ", image.size(), " failed");
+      }
+      if (seg == MAP_FAILED) {
+        LBANN_ERROR("mmap of ", seg_name, " failed");
+      }
+      std::memcpy(seg, image.data(), image.size());
+    }
+    catch (std::exception const& e) {
+      error = e.what();
+      if (!seg_name.empty()) {
+        shm_unlink(seg_name.c_str());
+      }
+      fields[2] = error.size();
+    }
+  }
+  MPI_Bcast(fields, 3, MPI_UNSIGNED_LONG_LONG, 0, list_comm);
+  if (fields[2] > 0) {
+    error.resize(fields[2]);
+    MPI_Bcast(error.data(),
+              static_cast<int>(fields[2]),
+              MPI_CHAR,
+              0,
+              list_comm);
+    MPI_Comm_free(&list_comm);
+    LBANN_ERROR("node-shared sample list ",
+                samplelist_file,
+                " could not be built: ",
+                error);
+  }
+  const size_t image_size = fields[0];
+  seg_name = "/lbann_sl_" + std::to_string(name_hash) + "_" +
+             std::to_string(fields[1]);
+
+  if (!is_root) {
+    const int fd = shm_open(seg_name.c_str(), O_RDONLY, 0);
+    if (fd != -1) {
+      seg = mmap(nullptr, image_size, PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+    }
+  }
+  // Once everyone has it mapped the name is no longer needed. A rank that
+  // could not map it fails the whole group.
+  int mapped = (seg != MAP_FAILED) ? 1 : 0;
+  int all_mapped = 0;
+  MPI_Allreduce(&mapped, &all_mapped, 1, MPI_INT, MPI_LAND, list_comm);
+  if (is_root) {
+    shm_unlink(seg_name.c_str());
+  }
+  MPI_Comm_free(&list_comm);
+  if (!all_mapped) {
+    if (seg != MAP_FAILED) {
+      munmap(seg, image_size);
+    }
+    LBANN_ERROR("node-shared sample list ",
+                samplelist_file,
+                " could not be mapped from ",
+                seg_name,
+                " on every rank");
+  }
+
+  std::unique_ptr<void, std::function<void(void*)>> mapping(
+    seg,
+    [image_size](void* p) { munmap(p, image_size); });
+  const size_t stride = interleave ? comm.get_procs_per_trainer() : 1ul;
+  const size_t offset = interleave ? comm.get_rank_in_trainer() : 0ul;
+  load_binary_image(static_cast<const char*>(seg),
+                    image_size,
+                    samplelist_file,
+                    stride,
+                    offset);
+}
+
 template <typename sample_name_t>
 inline void
 sample_list<sample_name_t>::load_from_string(const std::string& samplelist,
@@ -506,25 +890,8 @@ inline void sample_list<sample_name_t>::read_sample_list(std::istream& istrm,
       continue;
     }
 
-    std::stringstream sstr(line.substr(
-      0,
-      end_of_str + 1)); // clear trailing spaces for accurate parsing
-    std::string filename;
-
-    sstr >> filename;
-
-    const std::string file_path =
-      add_delimiter(m_header.get_file_dir()) + filename;
-
-    if (filename.empty() ||
-        (m_check_data_file && !check_if_file_exists(file_path))) {
-      LBANN_ERROR("data file '", file_path, "' does not exist.");
-    }
-
-    const sample_file_id_t index = m_file_id_stats_map.size();
-    static const auto sn0 = uninitialized_sample_name<sample_name_t>();
-    m_sample_list.emplace_back(std::make_pair(index, sn0));
-    m_file_id_stats_map.emplace_back(filename);
+    // clear trailing spaces for accurate parsing
+    read_sample_list_line(line.substr(0, end_of_str + 1));
   }
 
   if (m_header.get_num_files() != cnt_files) {
@@ -542,6 +909,29 @@ inline void sample_list<sample_name_t>::read_sample_list(std::istream& istrm,
   }
 }
 
+template <typename sample_name_t>
+inline void
+sample_list<sample_name_t>::read_sample_list_line(const std::string& line)
+{
+  std::stringstream sstr(line);
+  std::string filename;
+
+  sstr >> filename;
+
+  const std::string file_path =
+    add_delimiter(m_header.get_file_dir()) + filename;
+
+  if (filename.empty() ||
+      (m_check_data_file && !check_if_file_exists(file_path))) {
+    LBANN_ERROR("data file '", file_path, "' does not exist.");
+  }
+
+  const sample_file_id_t index = m_file_id_stats_map.size();
+  static const auto sn0 = uninitialized_sample_name<sample_name_t>();
+  m_sample_list.emplace_back(std::make_pair(index, sn0));
+  m_file_id_stats_map.emplace_back(filename);
+}
+
 template <typename sample_name_t>
 inline size_t
 sample_list<sample_name_t>::get_samples_per_file(std::istream& istrm,
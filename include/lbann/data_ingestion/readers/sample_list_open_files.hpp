@@ -30,6 +30,9 @@
 #include "sample_list.hpp"
 
 #include <deque>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 /// Number of system and other files that may be open during execution
 #define LBANN_MAX_OPEN_FILE_MARGIN 128
@@ -105,15 +108,35 @@ public:
 
   void set_files_handle(const std::string& filename, file_handle_t h);
 
-  void delete_file_handle_pq_entry(sample_file_id_t id);
-
-  void manage_open_file_handles(sample_file_id_t id);
-
+  /** Returns an open handle to the file holding the ith sample. Open
+   *  handles are cached, up to the open file limit, and shared by all
+   *  threads; the least recently used unleased handle is closed first
+   *  when the limit is reached.
+   */
   file_handle_t open_samples_file_handle(const size_t i);
 
+  /** With check_if_in_use, the handle is left in the cache for later
+   *  reuse. Otherwise it is closed right away, unless it is leased.
+   */
   virtual void close_samples_file_handle(const size_t i,
                                          bool check_if_in_use = false);
 
+  /** Like open_samples_file_handle(), but the handle is not closed
+   *  until a matching release_samples_file_handle(). Use this when
+   *  other threads may be opening files at the same time.
+   */
+  file_handle_t acquire_samples_file_handle(const size_t i);
+  void release_samples_file_handle(const size_t i);
+
+  /// Bound the number of files kept open at once
+  void set_max_open_files(size_t n);
+  size_t get_max_open_files() const { return m_max_open_files; }
+
+  /// Handle cache statistics
+  size_t get_num_file_handle_hits() const;
+  size_t get_num_file_handle_misses() const;
+  size_t get_num_file_handle_evictions() const;
+
   void compute_epochs_file_usage(const std::vector<uint64_t>& shufled_indices,
                                  uint64_t mini_batch_size,
                                  const lbann_comm& comm);
@@ -135,6 +158,13 @@ protected:
 
   file_handle_t open_file_handle(std::string file_path);
 
+  /// The following expect m_open_files_mutex to be held
+  file_handle_t open_samples_file_handle_locked(const size_t i);
+  /// Mark a file as most recently used, and evict if over the limit
+  void manage_open_file_handles(sample_file_id_t id);
+  /// Close a file and drop it from the cache
+  void close_cached_file_handle(sample_file_id_t id);
+
   /// Get the list of samples that exist in a bundle file
   file_handle_t get_bundled_sample_names(std::string file_path,
                                          std::vector<std::string>& sample_names,
@@ -169,6 +199,9 @@ protected:
                         size_t stride = 1,
                         size_t offset = 0) override;
 
+  /// read one line of an inclusive sample list
+  void read_sample_list_line(const std::string& line) override;
+
   void assign_samples_name() override {}
 
   /// Get the number of total/included/excluded samples
@@ -176,13 +209,6 @@ protected:
                        size_t& included,
                        size_t& excluded) const override;
 
-  static bool pq_cmp(fd_use_map_t left, fd_use_map_t right)
-  {
-    return ((left.second).first < (right.second).first) ||
-           (((left.second).first == (right.second).first) &&
-            ((left.second).second < (right.second).second));
-  }
-
   virtual file_handle_t
   open_file_handle_for_read(const std::string& file_path) = 0;
   virtual void close_file_handle(file_handle_t& h) = 0;
@@ -203,8 +229,24 @@ private:
   /// Track the number of samples per file
   std::unordered_map<std::string, size_t> m_file_map;
 
-  /// Track the number of open file descriptors and when they will be used next
-  std::deque<fd_use_map_t> m_open_fd_pq;
+  /// Guards the file handles and the cache below, which are shared by
+  /// all I/O threads of a rank
+  mutable std::mutex m_open_files_mutex;
+
+  /// Open files, most recently used first
+  std::list<sample_file_id_t> m_open_files_lru;
+
+  /// Position of each open file in m_open_files_lru
+  std::unordered_map<sample_file_id_t,
+                     typename std::list<sample_file_id_t>::iterator>
+    m_open_files_lru_pos;
+
+  /// Number of outstanding leases on each leased file
+  std::unordered_map<sample_file_id_t, size_t> m_file_leases;
+
+  size_t m_num_file_handle_hits = 0;
+  size_t m_num_file_handle_misses = 0;
+  size_t m_num_file_handle_evictions = 0;
 
   size_t m_max_open_files;
 };
@@ -44,7 +44,8 @@ template <typename sample_name_t, typename file_handle_t>
 inline sample_list_open_files<sample_name_t,
                               file_handle_t>::~sample_list_open_files()
 {
-  m_open_fd_pq.clear();
+  m_open_files_lru.clear();
+  m_open_files_lru_pos.clear();
 }
 
 template <typename sample_name_t, typename file_handle_t>
@@ -104,9 +105,12 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>::copy_members(
     set_samples_filename(i, rhs.get_samples_filename(i));
   }
 
-  /// Do not copy the open file descriptor priority queue
+  /// Do not copy the open file cache
   /// File handle ownership is not transfered in the copy
-  m_open_fd_pq.clear();
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
+  m_open_files_lru.clear();
+  m_open_files_lru_pos.clear();
+  m_file_leases.clear();
 }
 
 template <typename sample_name_t, typename file_handle_t>
@@ -355,90 +359,103 @@ sample_list_open_files<sample_name_t, file_handle_t>::read_inclusive_list(
       continue;
     }
 
-    std::istringstream sstr(line.substr(
-      0,
-      end_of_str + 1)); // clear trailing spaces for accurate parsing
-    std::string filename;
-    size_t included_samples;
-    size_t excluded_samples = 0;
+    // clear trailing spaces for accurate parsing
+    read_sample_list_line(line.substr(0, end_of_str + 1));
+  }
 
-    sstr >> filename >> included_samples;
+  if (m_header.get_num_files() != cnt_files) {
+    LBANN_ERROR(std::string("Sample list number of files requested ") +
+                std::to_string(m_header.get_num_files()) +
+                std::string(" does not equal number of files loaded ") +
+                std::to_string(cnt_files));
+  }
+}
 
-    if (m_header.has_unused_sample_fields()) {
-      sstr >> excluded_samples;
-    }
+template <typename sample_name_t, typename file_handle_t>
+inline void
+sample_list_open_files<sample_name_t, file_handle_t>::read_sample_list_line(
+  const std::string& line)
+{
+  if (m_header.is_exclusive()) {
+    LBANN_ERROR("sample list ",
+                m_header.get_sample_list_name(),
+                " is exclusive and cannot be read line by line");
+  }
 
-    const std::string file_path =
-      add_delimiter(m_header.get_file_dir()) + filename;
+  std::istringstream sstr(line);
+  std::string filename;
+  size_t included_samples;
+  size_t excluded_samples = 0;
 
-    if (filename.empty() ||
-        (this->m_check_data_file && !check_if_file_exists(file_path))) {
-      throw lbann_exception(std::string{} + __FILE__ + " " +
-                            std::to_string(__LINE__) + " :: data file '" +
-                            filename + "' does not exist.");
-    }
+  sstr >> filename >> included_samples;
 
-    file_handle_t file_hnd = open_file_handle(file_path);
-    if (this->m_check_data_file && !is_file_handle_valid(file_hnd)) {
-      continue; // skipping the file
-    }
+  if (m_header.has_unused_sample_fields()) {
+    sstr >> excluded_samples;
+  }
 
-    sample_file_id_t index = m_file_id_stats_map.size();
-    m_file_id_stats_map.emplace_back(
-      std::make_tuple(filename,
-                      uninitialized_file_handle<file_handle_t>(),
-                      std::deque<std::pair<int, int>>{}));
-    set_files_handle(filename, file_hnd);
+  const std::string file_path =
+    add_delimiter(m_header.get_file_dir()) + filename;
 
-    size_t valid_sample_count = 0u;
-    // #define VALIDATE_SAMPLE_LIST
-#ifdef VALIDATE_SAMPLE_LIST
-    std::vector<std::string> sample_names;
-#endif
-    if constexpr (std::is_integral_v<sample_name_t>) {
-      valid_sample_count = read_line_integral_type(sstr, index);
-    }
-    else {
-      valid_sample_count = read_line(sstr, index);
-    }
-    if (valid_sample_count != included_samples) {
-      LBANN_ERROR(
-        "Bundle file",
-        filename,
-        " does not contain the correct number of included samples: expected ",
-        included_samples,
-        " samples, but found ",
-        valid_sample_count);
-    }
+  if (filename.empty() ||
+      (this->m_check_data_file && !check_if_file_exists(file_path))) {
+    throw lbann_exception(std::string{} + __FILE__ + " " +
+                          std::to_string(__LINE__) + " :: data file '" +
+                          filename + "' does not exist.");
+  }
 
-    if (m_file_map.count(filename) > 0) {
-      if (valid_sample_count != m_file_map[filename]) {
-        LBANN_ERROR(
-          std::string("The same file ") + filename +
-          " was opened multiple times and reported different sizes: " +
-          std::to_string(valid_sample_count) + " and " +
-          std::to_string(m_file_map[filename]));
-      }
-    }
-    else {
-      m_file_map[filename] =
-        /*valid_sample_count*/ included_samples + excluded_samples;
-    }
+  file_handle_t file_hnd = open_file_handle(file_path);
+  if (this->m_check_data_file && !is_file_handle_valid(file_hnd)) {
+    return; // skipping the file
+  }
+
+  sample_file_id_t index = m_file_id_stats_map.size();
+  m_file_id_stats_map.emplace_back(
+    std::make_tuple(filename,
+                    uninitialized_file_handle<file_handle_t>(),
+                    std::deque<std::pair<int, int>>{}));
+  set_files_handle(filename, file_hnd);
+
+  size_t valid_sample_count = 0u;
+  // #define VALIDATE_SAMPLE_LIST
 #ifdef VALIDATE_SAMPLE_LIST
-    validate_implicit_bundles_sample_names(file_path,
-                                           filename,
-                                           sample_names,
-                                           included_samples,
-                                           excluded_samples);
+  std::vector<std::string> sample_names;
 #endif
+  if constexpr (std::is_integral_v<sample_name_t>) {
+    valid_sample_count = read_line_integral_type(sstr, index);
+  }
+  else {
+    valid_sample_count = read_line(sstr, index);
+  }
+  if (valid_sample_count != included_samples) {
+    LBANN_ERROR(
+      "Bundle file",
+      filename,
+      " does not contain the correct number of included samples: expected ",
+      included_samples,
+      " samples, but found ",
+      valid_sample_count);
   }
 
-  if (m_header.get_num_files() != cnt_files) {
-    LBANN_ERROR(std::string("Sample list number of files requested ") +
-                std::to_string(m_header.get_num_files()) +
-                std::string(" does not equal number of files loaded ") +
-                std::to_string(cnt_files));
+  if (m_file_map.count(filename) > 0) {
+    if (valid_sample_count != m_file_map[filename]) {
+      LBANN_ERROR(
+        std::string("The same file ") + filename +
+        " was opened multiple times and reported different sizes: " +
+        std::to_string(valid_sample_count) + " and " +
+        std::to_string(m_file_map[filename]));
+    }
+  }
+  else {
+    m_file_map[filename] =
+      /*valid_sample_count*/ included_samples + excluded_samples;
   }
+#ifdef VALIDATE_SAMPLE_LIST
+  validate_implicit_bundles_sample_names(file_path,
+                                         filename,
+                                         sample_names,
+                                         included_samples,
+                                         excluded_samples);
+#endif
 }
 
 template <typename sample_name_t, typename file_handle_t>
@@ -624,6 +641,7 @@ inline file_handle_t
 sample_list_open_files<sample_name_t, file_handle_t>::get_samples_file_handle(
   sample_file_id_t id) const
 {
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
   file_handle_t h = std::get<FID_STATS_HANDLE>(m_file_id_stats_map[id]);
   return h;
 }
@@ -670,6 +688,7 @@ sample_list_open_files<sample_name_t, file_handle_t>::set_files_handle(
   const std::string& filename,
   file_handle_t h)
 {
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
   sample_file_id_t id = sample_file_id_t(0);
   for (auto&& e : m_file_id_stats_map) {
     if (std::get<FID_STATS_NAME>(e) == filename) {
@@ -808,7 +827,10 @@ sample_list_open_files<sample_name_t, file_handle_t>::all_gather_packed_lists(
     std::get<FID_STATS_DEQUE>(e).clear();
     my_files.emplace_back(std::get<FID_STATS_NAME>(e));
   }
-  m_open_fd_pq.clear();
+  // File ids are reassigned below
+  m_open_files_lru.clear();
+  m_open_files_lru_pos.clear();
+  m_file_leases.clear();
 
   size_t num_samples =
     this->all_gather_field(this->m_sample_list, per_rank_samples, comm);
@@ -876,14 +898,11 @@ sample_list_open_files<sample_name_t, file_handle_t>::compute_epochs_file_usage(
     LBANN_WARNING("Unable to compute file usage with empty mini-batch size");
     return;
   }
+  // Open handles are kept across epochs; only the usage queues are rebuilt
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
   for (auto&& e : m_file_id_stats_map) {
-    auto& h = std::get<FID_STATS_HANDLE>(e);
-    close_file_handle(h);
-    clear_file_handle(h);
     std::get<FID_STATS_DEQUE>(e).clear();
   }
-  // Once all of the file handles are closed, clear the priority queue
-  m_open_fd_pq.clear();
   for (size_t i = 0; i < shuffled_indices.size(); i++) {
     uint64_t idx = shuffled_indices[i];
     const auto& s = this->m_sample_list[idx];
@@ -900,45 +919,36 @@ sample_list_open_files<sample_name_t, file_handle_t>::compute_epochs_file_usage(
   }
 }
 
-template <typename sample_name_t, typename file_handle_t>
-inline void sample_list_open_files<sample_name_t, file_handle_t>::
-  delete_file_handle_pq_entry(sample_file_id_t id)
-{
-  for (std::deque<fd_use_map_t>::iterator it = m_open_fd_pq.begin();
-       it != m_open_fd_pq.end();
-       ++it) {
-    if (it->first == id) {
-      it = m_open_fd_pq.erase(it);
-      break;
-    }
-  }
-  return;
-}
-
 template <typename sample_name_t, typename file_handle_t>
 inline void
 sample_list_open_files<sample_name_t, file_handle_t>::manage_open_file_handles(
   sample_file_id_t id)
 {
-  /// When we enter this function the priority queue is either empty or a heap
-  if (!m_open_fd_pq.empty()) {
-    if (m_open_fd_pq.size() > m_max_open_files) {
-      auto& f = m_open_fd_pq.front();
-      auto& victim = m_file_id_stats_map[f.first];
-      auto& victim_fd = std::get<FID_STATS_HANDLE>(victim);
-      std::pop_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
-      m_open_fd_pq.pop_back();
-      close_file_handle(victim_fd);
-      clear_file_handle(victim_fd);
-    }
+  /// Move the file to the front of the LRU list
+  auto pos = m_open_files_lru_pos.find(id);
+  if (pos != m_open_files_lru_pos.end()) {
+    m_open_files_lru.splice(m_open_files_lru.begin(),
+                            m_open_files_lru,
+                            pos->second);
+  }
+  else {
+    m_open_files_lru.push_front(id);
+    m_open_files_lru_pos[id] = m_open_files_lru.begin();
+  }
 
-    /// Before we can enqueue the any new access times for this descriptor,
-    /// remove any earlier descriptor
-    std::sort_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
-    if (m_open_fd_pq.front().first == id) {
-      m_open_fd_pq.pop_front();
+  /// Close the least recently used files that are not leased until the
+  /// cache is back under its limit
+  auto victim = m_open_files_lru.end();
+  while (m_open_files_lru.size() > m_max_open_files &&
+         victim != m_open_files_lru.begin()) {
+    --victim;
+    const sample_file_id_t victim_id = *victim;
+    if (victim_id == id || m_file_leases.count(victim_id) != 0) {
+      continue;
     }
-    std::make_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
+    ++victim;
+    close_cached_file_handle(victim_id);
+    ++m_num_file_handle_evictions;
   }
 
   auto& e = m_file_id_stats_map[id];
@@ -946,43 +956,60 @@ sample_list_open_files<sample_name_t, file_handle_t>::manage_open_file_handles(
   if (!file_access_queue.empty()) {
     file_access_queue.pop_front();
   }
-  if (!file_access_queue.empty()) {
-    m_open_fd_pq.emplace_back(std::make_pair(id, file_access_queue.front()));
-  }
-  else {
-    /// If there are no future access of the file place a terminator entry to
-    /// track the open file, but is always sorted to the top of the heap
-    m_open_fd_pq.emplace_back(std::make_pair(id, std::make_pair(INT_MAX, id)));
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void
+sample_list_open_files<sample_name_t, file_handle_t>::close_cached_file_handle(
+  sample_file_id_t id)
+{
+  auto& fh = std::get<FID_STATS_HANDLE>(m_file_id_stats_map[id]);
+  close_file_handle(fh);
+  clear_file_handle(fh);
+  auto pos = m_open_files_lru_pos.find(id);
+  if (pos != m_open_files_lru_pos.end()) {
+    m_open_files_lru.erase(pos->second);
+    m_open_files_lru_pos.erase(pos);
   }
-  std::push_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
-  return;
 }
 
 template <typename sample_name_t, typename file_handle_t>
 inline file_handle_t
 sample_list_open_files<sample_name_t, file_handle_t>::open_samples_file_handle(
   const size_t i)
+{
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
+  return open_samples_file_handle_locked(i);
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline file_handle_t sample_list_open_files<sample_name_t, file_handle_t>::
+  open_samples_file_handle_locked(const size_t i)
 {
   const sample_t& s = this->m_sample_list[i];
   sample_file_id_t id = s.first;
-  file_handle_t h = get_samples_file_handle(id);
-  if (!is_file_handle_valid(h)) {
-    const std::string& file_name = get_samples_filename(id);
-    const std::string& file_dir = this->get_samples_dirname();
-    const std::string file_path = add_delimiter(file_dir) + file_name;
-    if (file_name.empty() || !check_if_file_exists(file_path)) {
-      LBANN_ERROR("data file '", file_path, "' does not exist.");
-    }
-    h = open_file_handle(file_path);
-
-    if (!is_file_handle_valid(h)) {
-      LBANN_ERROR("data file '", file_path, "' could not be opened.");
-    }
-    auto& e = m_file_id_stats_map[id];
-    std::get<FID_STATS_HANDLE>(e) = h;
-    /// If a new file is opened, place it in the priority queue
+  file_handle_t h = std::get<FID_STATS_HANDLE>(m_file_id_stats_map[id]);
+  if (is_file_handle_valid(h)) {
+    ++m_num_file_handle_hits;
     manage_open_file_handles(id);
+    return h;
+  }
+  ++m_num_file_handle_misses;
+  const std::string& file_name = get_samples_filename(id);
+  const std::string& file_dir = this->get_samples_dirname();
+  const std::string file_path = add_delimiter(file_dir) + file_name;
+  if (file_name.empty() || !check_if_file_exists(file_path)) {
+    LBANN_ERROR("data file '", file_path, "' does not exist.");
   }
+  h = open_file_handle(file_path);
+
+  if (!is_file_handle_valid(h)) {
+    LBANN_ERROR("data file '", file_path, "' could not be opened.");
+  }
+  auto& e = m_file_id_stats_map[id];
+  std::get<FID_STATS_HANDLE>(e) = h;
+  /// If a new file is opened, place it in the cache
+  manage_open_file_handles(id);
   return h;
 }
 
@@ -992,21 +1019,76 @@ sample_list_open_files<sample_name_t, file_handle_t>::close_samples_file_handle(
   const size_t i,
   bool check_if_in_use)
 {
+  if (check_if_in_use) {
+    // Keep the handle cached; it is closed when evicted
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
   const sample_t& s = this->m_sample_list[i];
   sample_file_id_t id = s.first;
-  auto h = get_samples_file_handle(id);
-  if (is_file_handle_valid(h)) {
-    auto& e = m_file_id_stats_map[id];
-    auto& file_access_queue = std::get<FID_STATS_DEQUE>(e);
-    if (!check_if_in_use || file_access_queue.empty()) {
-      auto& fh = std::get<FID_STATS_HANDLE>(e);
-      close_file_handle(fh);
-      clear_file_handle(fh);
-      delete_file_handle_pq_entry(id);
-    }
+  auto h = std::get<FID_STATS_HANDLE>(m_file_id_stats_map[id]);
+  if (is_file_handle_valid(h) && m_file_leases.count(id) == 0) {
+    close_cached_file_handle(id);
+  }
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline file_handle_t sample_list_open_files<sample_name_t, file_handle_t>::
+  acquire_samples_file_handle(const size_t i)
+{
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
+  file_handle_t h = open_samples_file_handle_locked(i);
+  ++m_file_leases[this->m_sample_list[i].first];
+  return h;
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void sample_list_open_files<sample_name_t, file_handle_t>::
+  release_samples_file_handle(const size_t i)
+{
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
+  auto lease = m_file_leases.find(this->m_sample_list[i].first);
+  if (lease == m_file_leases.end()) {
+    LBANN_ERROR("releasing the file of sample ", i, ", which is not leased");
+  }
+  if (--lease->second == 0) {
+    m_file_leases.erase(lease);
   }
 }
 
+template <typename sample_name_t, typename file_handle_t>
+inline void
+sample_list_open_files<sample_name_t, file_handle_t>::set_max_open_files(
+  size_t n)
+{
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
+  m_max_open_files = n;
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline size_t sample_list_open_files<sample_name_t, file_handle_t>::
+  get_num_file_handle_hits() const
+{
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
+  return m_num_file_handle_hits;
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline size_t sample_list_open_files<sample_name_t, file_handle_t>::
+  get_num_file_handle_misses() const
+{
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
+  return m_num_file_handle_misses;
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline size_t sample_list_open_files<sample_name_t, file_handle_t>::
+  get_num_file_handle_evictions() const
+{
+  std::lock_guard<std::mutex> lock(m_open_files_mutex);
+  return m_num_file_handle_evictions;
+}
+
 template <typename sample_name_t, typename file_handle_t>
 inline bool
 sample_list_open_files<sample_name_t, file_handle_t>::is_file_handle_valid(
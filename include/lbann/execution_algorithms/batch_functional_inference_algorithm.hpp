@@ -34,6 +34,12 @@
 #include "lbann/layers/io/input_layer.hpp"
 #include "lbann/models/model.hpp"
 
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
 namespace lbann {
 
 /** @brief Class for LBANN batch inference algorithms.
@@ -118,6 +124,93 @@ public:
     return labels;
   }
 
+  /** @brief Accuracy of int8 inference against full precision */
+  struct int8_comparison
+  {
+    /** @brief Fraction of samples classified correctly in full
+     *  precision */
+    double fp32_accuracy = 0.;
+    /** @brief Fraction classified correctly with int8 layers */
+    double int8_accuracy = 0.;
+    /** @brief Fraction where both predict the same category */
+    double agreement = 0.;
+  };
+
+  /** @brief Compare a model calibrated for int8 inference with its
+   *  full-precision self.
+   *
+   *  Runs infer with the model's int8 layers (see the calibrate_int8
+   *  callback), then again with them switched back to full precision,
+   *  and prints the result on the trainer master.
+   *
+   * @param[in] model A model with layers running in int8
+   * @param[in] samples A distributed matrix containing samples for model input
+   * @param[in] labels The true category of each sample
+   * @param[in] mbs The max mini-batch size
+   */
+  template <typename DataT,
+            El::Dist CDist,
+            El::Dist RDist,
+            El::DistWrap DistView,
+            El::Device Device>
+  int8_comparison
+  compare_int8(observer_ptr<model> model,
+               El::DistMatrix<DataT, CDist, RDist, DistView, Device> const&
+                 samples,
+               El::Matrix<int, El::Device::CPU> const& labels,
+               size_t mbs)
+  {
+    std::vector<std::pair<Layer*, std::vector<double>>> int8_layers;
+    for (auto* l : model->get_layers()) {
+      if (l->using_int8_inference()) {
+        int8_layers.emplace_back(l, l->get_int8_input_ranges());
+      }
+    }
+    if (int8_layers.empty()) {
+      LBANN_ERROR("model \"",
+                  model->get_name(),
+                  "\" has no layers running in int8");
+    }
+    if (labels.Height() != samples.Height()) {
+      LBANN_ERROR("expected ",
+                  samples.Height(),
+                  " labels, but got ",
+                  labels.Height());
+    }
+
+    const auto int8_labels = infer(model, samples, mbs);
+    for (auto& [l, ranges] : int8_layers) {
+      l->set_int8_input_ranges({});
+    }
+    const auto fp32_labels = infer(model, samples, mbs);
+    for (auto& [l, ranges] : int8_layers) {
+      l->set_int8_input_ranges(ranges);
+    }
+
+    int8_comparison result;
+    const El::Int num_samples = labels.Height();
+    for (El::Int i = 0; i < num_samples; ++i) {
+      result.fp32_accuracy += (fp32_labels(i) == labels(i));
+      result.int8_accuracy += (int8_labels(i) == labels(i));
+      result.agreement += (fp32_labels(i) == int8_labels(i));
+    }
+    if (num_samples > 0) {
+      result.fp32_accuracy /= num_samples;
+      result.int8_accuracy /= num_samples;
+      result.agreement /= num_samples;
+    }
+    if (model->get_comm()->am_trainer_master()) {
+      std::ostringstream ss;
+      ss << "int8 inference of model \"" << model->get_name() << "\" on "
+         << num_samples << " samples: accuracy " << std::fixed
+         << std::setprecision(2) << 100 * result.int8_accuracy
+         << "% (full precision " << 100 * result.fp32_accuracy
+         << "%), predictions agree on " << 100 * result.agreement << "%\n";
+      std::cout << ss.str();
+    }
+    return result;
+  }
+
 protected:
   /** @brief Run model inference on a single mini-batch of samples
    * This method takes a mini-batch of samples, inserts them into the input
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CO_SCHEDULED_TRAINING_HPP
+#define LBANN_CO_SCHEDULED_TRAINING_HPP
+
+#include "lbann/base.hpp"
+#include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class data_coordinator;
+class model;
+
+/** @brief SGD training of several independent models on the same
+ *         mini-batches.
+ *
+ *  Meant for hyperparameter sweeps of small models, which alone
+ *  leave most of a GPU idle. The models live in one trainer and
+ *  take every mini-batch from its data coordinator, so each sample
+ *  is read and preprocessed once for all of them. Each step launches
+ *  every model's forward pass on its own GPU stream before running
+ *  any objective function, so the forward passes overlap with each
+ *  other and with the backward passes of the models before them.
+ *  Backward passes join the default stream, where the gradients are
+ *  synchronized and the optimizers step, so they run in model order.
+ *  Models are spread round-robin over @c num_streams streams, as in
+ *  ensemble_inference. Without a GPU the models run one after
+ *  another.
+ *
+ *  The models may differ in anything but their input data fields,
+ *  whose dimensions must match. Each model has its own execution
+ *  context and callbacks. Validation and checkpointing of the
+ *  training state are left to the caller.
+ */
+class co_scheduled_training
+{
+public:
+  /** @param models Models to train
+   *  @param grids Grids to set the models up on
+   *  @param max_mini_batch_size The trainer's maximum mini-batch size
+   *  @param num_streams GPU streams to spread the models over; 0 gives
+   *         each model its own stream
+   */
+  co_scheduled_training(std::vector<std::unique_ptr<model>> models,
+                        std::vector<El::Grid*> const& grids,
+                        size_t max_mini_batch_size,
+                        size_t num_streams = 0);
+  ~co_scheduled_training();
+  co_scheduled_training(const co_scheduled_training&) = delete;
+  co_scheduled_training& operator=(const co_scheduled_training&) = delete;
+
+  /** @brief Train every model until it meets @c term
+   *
+   *  A model that stops early, e.g. by an early stopping callback,
+   *  sits out the remaining steps while the others go on.
+   */
+  void train(data_coordinator& dc, SGDTerminationCriteria const& term);
+
+  size_t get_num_models() const noexcept { return m_models.size(); }
+  model& get_model(size_t i) { return *m_models.at(i); }
+  SGDExecutionContext& get_execution_context(size_t i)
+  {
+    return m_contexts.at(i);
+  }
+
+private:
+  /** @brief Train the models that are not done on one mini-batch
+   *  @returns Whether the data coordinator reached the end of the
+   *           epoch
+   */
+  bool train_step(data_coordinator& dc, std::vector<bool> const& active);
+
+private:
+#ifdef LBANN_HAS_GPU
+  /** @brief Streams owned by the trainer, destroyed after the models */
+  std::vector<El::SyncInfo<El::Device::GPU>> m_streams;
+  /** @brief Recorded once each model's forward pass has read the
+   *         mini-batch, before the next one overwrites it
+   */
+  std::vector<gpu_lib::event_wrapper> m_input_events;
+#endif // LBANN_HAS_GPU
+  std::vector<std::unique_ptr<model>> m_models;
+  std::vector<SGDExecutionContext> m_contexts;
+};
+
+} // namespace lbann
+
+#endif // LBANN_CO_SCHEDULED_TRAINING_HPP
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_ENSEMBLE_INFERENCE_HPP
+#define LBANN_ENSEMBLE_INFERENCE_HPP
+
+#include "lbann/base.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class model;
+
+/** @brief Inference with several models over the same samples.
+ *
+ *  The models (e.g. the members of an LTFB population) live in one
+ *  process and their forward passes over each mini-batch are launched
+ *  back to back on separate GPU streams, so the GPU runs them
+ *  concurrently. Models are spread round-robin over @c num_streams
+ *  streams, so models on the same stream share its DNN library
+ *  workspace, and all of them allocate from the process-wide memory
+ *  pool. Without a GPU the models run one after another.
+ *
+ *  The prediction for each sample is the largest entry of the mean of
+ *  the models' softmax outputs. As with
+ *  batch_functional_inference_algorithm, every model is assumed to
+ *  have one input layer and a softmax output layer, and all of them
+ *  must predict the same categories.
+ */
+class ensemble_inference
+{
+public:
+  /** @param models Trained models, e.g. from load_inference_ensemble
+   *  @param grids Grids the models were set up on
+   *  @param num_streams GPU streams to spread the models over; 0 gives
+   *         each model its own stream
+   */
+  ensemble_inference(std::vector<std::unique_ptr<model>> models,
+                     std::vector<El::Grid*> const& grids,
+                     size_t num_streams = 0);
+  ~ensemble_inference();
+  ensemble_inference(const ensemble_inference&) = delete;
+  ensemble_inference& operator=(const ensemble_inference&) = delete;
+
+  /** @brief Predict the category of each sample
+   *
+   *  Collective over the trainer.
+   *
+   *  @param samples Samples stored one per column, identical on every
+   *         rank in the trainer
+   *  @param mbs Mini-batch size, at most the models' maximum
+   *  @param model_labels If not null, set to the prediction of each
+   *         model, one sample per row and one model per column
+   *  @return Ensemble prediction for each sample, as a column vector
+   */
+  El::Matrix<int, El::Device::CPU>
+  infer(El::Matrix<DataType, El::Device::CPU> const& samples,
+        size_t mbs,
+        El::Matrix<int, El::Device::CPU>* model_labels = nullptr);
+
+  size_t get_num_models() const noexcept { return m_models.size(); }
+  model& get_model(size_t i) { return *m_models.at(i); }
+
+private:
+#ifdef LBANN_HAS_GPU
+  /** @brief Streams owned by the ensemble, destroyed after the models */
+  std::vector<El::SyncInfo<El::Device::GPU>> m_streams;
+#endif // LBANN_HAS_GPU
+  std::vector<std::unique_ptr<model>> m_models;
+};
+
+} // namespace lbann
+
+#endif // LBANN_ENSEMBLE_INFERENCE_HPP
@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_INFERENCE_SERVER_HPP
+#define LBANN_INFERENCE_SERVER_HPP
+
+#include "lbann/base.hpp"
+#include "lbann/utils/duration_histogram.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class model;
+
+/** @brief Long-running inference on requests that arrive one sample
+ *  at a time.
+ *
+ *  Application threads on the trainer master call submit() with one
+ *  sample each and get a future for its predicted category. Every rank
+ *  in the trainer calls serve(), which groups the queued requests into
+ *  mini-batches, runs forward propagation and fulfils the futures. A
+ *  mini-batch is dispatched as soon as it holds @c max_batch_size
+ *  requests or its oldest request has waited @c max_latency, so light
+ *  traffic is answered promptly and heavy traffic is batched.
+ *
+ *  As with batch_functional_inference_algorithm, the model is assumed
+ *  to have one input layer and a softmax output layer.
+ */
+class inference_server
+{
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  /** @brief Summary of the requests served so far */
+  struct statistics
+  {
+    uint64_t num_requests = 0;
+    uint64_t num_batches = 0;
+    /** @brief Time from submit() to the result being ready, in seconds */
+    double latency_p50 = 0.;
+    double latency_p99 = 0.;
+  };
+
+  /** @param model A trained model
+   *  @param sample_size Number of entries in each sample
+   *  @param max_batch_size Largest mini-batch to run
+   *  @param max_latency Longest a request waits for its mini-batch to
+   *         fill before it is run anyway
+   */
+  inference_server(observer_ptr<model> model,
+                   size_t sample_size,
+                   size_t max_batch_size,
+                   std::chrono::microseconds max_latency);
+  ~inference_server() = default;
+  inference_server(const inference_server&) = delete;
+  inference_server& operator=(const inference_server&) = delete;
+
+  /** @brief Queue a sample for inference.
+   *
+   *  Thread-safe. Only valid on the trainer master.
+   *
+   *  @return Future for the predicted category
+   */
+  std::future<int> submit(std::vector<DataType> sample);
+
+  /** @brief Run mini-batches until shutdown() is called.
+   *
+   *  Collective over the trainer. Requests still queued at shutdown
+   *  are served before returning, and the trainer master then prints
+   *  the latency statistics.
+   */
+  void serve();
+
+  /** @brief Ask serve() to return once the queue drains. Thread-safe. */
+  void shutdown();
+
+  /** @brief Latency statistics. Thread-safe. */
+  statistics get_statistics() const;
+
+  /** @brief Print the statistics as one line */
+  void print_statistics(std::ostream& os) const;
+
+private:
+  struct request
+  {
+    std::vector<DataType> sample;
+    std::promise<int> result;
+    clock_type::time_point arrival;
+  };
+
+  /** @brief Wait for the next mini-batch (trainer master only)
+   *  @return False once the server is shut down and drained
+   */
+  bool collect_batch_(std::vector<request>& batch);
+
+  /** @brief Forward prop a mini-batch stored one sample per column */
+  void run_batch_(El::Matrix<DataType, El::Device::CPU> const& samples,
+                  std::vector<int>& labels);
+
+  observer_ptr<model> m_model;
+  size_t m_sample_size;
+  size_t m_max_batch_size;
+  std::chrono::microseconds m_max_latency;
+
+  std::mutex m_queue_mutex;
+  std::condition_variable m_queue_cv;
+  std::deque<request> m_queue;
+  bool m_shutdown = false;
+
+  mutable std::mutex m_stats_mutex;
+  DurationHistogram m_latency;
+  uint64_t m_num_batches = 0;
+};
+
+} // namespace lbann
+
+#endif // LBANN_INFERENCE_SERVER_HPP
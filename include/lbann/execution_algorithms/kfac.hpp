@@ -84,6 +84,7 @@ public:
        std::vector<size_t> update_intervals,
        size_t update_interval_steps,
        kfac::kfac_inverse_strategy inverse_strategy,
+       size_t inverse_rebalance_interval,
        std::vector<std::string> disable_layers,
        double learning_rate_factor,
        double learning_rate_factor_gru,
@@ -91,7 +92,11 @@ public:
        bool distribute_precondition_compute,
        bool use_eigen_decomposition,
        bool enable_copy_errors,
-       bool enable_copy_activations);
+       bool enable_copy_activations,
+       bool staggered_inverse,
+       bool half_precision_communication,
+       size_t inverse_rank,
+       bool batched_inverse);
 
   ~KFAC() noexcept = default;
   KFAC(KFAC const& other) = delete;
@@ -166,6 +171,7 @@ protected:
   kfac::KFACExecutionContext* do_get_new_execution_context() const final;
 
   void start_send_recv_inverse_matrices(ExeContextType& context,
+                                        model& model,
                                         lbann_comm* comm);
   void end_send_recv_inverse_matrices(ExeContextType& context,
                                       lbann_comm* comm);
@@ -201,6 +207,25 @@ private:
   void allgather_precondition_gradient(lbann_comm& comm,
                                        ExeContextType& context);
 
+  /** @brief Assign Kronecker inversions to balance the load.
+   *  @param use_measured_times Use inversion times measured since
+   *  the last call instead of estimated costs.
+   */
+  void balance_inverse_assignment(lbann_comm& comm,
+                                  ExeContextType& context,
+                                  bool use_measured_times);
+
+  /** @brief Choose the local blocks to invert in this step.
+   *  @details Without staggering, all local blocks are inverted on
+   *  Kronecker update steps. With staggering, the local blocks are
+   *  split by estimated cost into one group per step of the update
+   *  interval.
+   */
+  std::vector<bool> get_inverse_schedule(lbann_comm& comm,
+                                         ExeContextType& context,
+                                         size_t step,
+                                         bool is_kronecker_update_required);
+
   /** @brief The KFAC stopping criteria. */
   std::unique_ptr<TermCriteriaType> m_stopping_criteria;
 
@@ -235,6 +260,33 @@ private:
   /** @brief Assignment strategy for the model-parallel part. */
   kfac::kfac_inverse_strategy m_inverse_strategy;
 
+  /** @brief Steps between re-planning a balanced assignment. */
+  size_t m_inverse_rebalance_interval;
+
+  /** @brief Inversion time of each block since the last re-plan.
+   *  @details Only nonzero for blocks inverted by this process.
+   */
+  std::vector<double> m_inverse_times;
+
+  /** @brief Step of the last re-plan. */
+  size_t m_last_rebalance_step = 0;
+
+  /** @brief Spread inversions over the steps of an update interval.
+   *  @details Each block is still inverted once per interval, but
+   *  the preconditioner uses its previous inverse until then.
+   */
+  bool m_staggered_inverse;
+
+  /** @brief Communicate Kronecker factors in FP16. */
+  bool m_half_precision_communication;
+
+  /** @brief Rank of the warm-started eigendecomposition of large
+   *  Kronecker factors (0 for a full decomposition). */
+  size_t m_inverse_rank;
+
+  /** @brief Invert small Kronecker factors of the same size together. */
+  bool m_batched_inverse;
+
   /** @brief List of layers to be ignored by the callback. */
   std::vector<std::string> m_disable_layers;
 
@@ -30,6 +30,8 @@
 #include "lbann/execution_algorithms/kfac/execution_context.hpp"
 #include "lbann/layers/layer.hpp"
 
+#include <cmath>
+
 namespace lbann {
 
 // Forward declaration
@@ -47,6 +49,9 @@ using BackendT = ::Al::MPIBackend;
 #endif
 
 using ReqT = typename BackendT::req_type;
+
+template <El::Device Device>
+class batched_inverse;
 } // namespace kfac
 
 /** A building block for K-FAC.
@@ -169,6 +174,39 @@ public:
 
   size_t get_inverse_proc_rank() const { return m_inverse_proc_rank; }
 
+  /** @brief Move the inversion of this block to another process.
+   *  @details Only the owning process keeps a running average of the
+   *  Kronecker factors, so moving a block restarts its average.
+   */
+  void set_inverse_proc_rank(size_t rank)
+  {
+    if (rank != get_inverse_proc_rank()) {
+      m_inverse_proc_rank = rank;
+      m_has_kronecker_inverse = false;
+    }
+  }
+
+  /** @brief Rank of the eigendecomposition used to invert large
+   *  Kronecker factors (0 for a full decomposition). */
+  void set_inverse_rank(size_t rank) { m_inverse_rank = rank; }
+
+  /** @brief Queue small factors in @p batch instead of inverting
+   *  them in update_kronecker_inverse (nullptr to disable). */
+  void set_inverse_batch(kfac::batched_inverse<Device>* batch)
+  {
+    m_inverse_batch = batch;
+  }
+
+  /** @brief Estimated cost of inverting the Kronecker factors.
+   *  @details Inversion is cubic in the factor height. By default the
+   *  inverse matrices are treated as one square factor.
+   */
+  virtual double get_inverse_cost(lbann_comm* comm)
+  {
+    const double size = get_inverse_matrices_size(comm);
+    return size * std::sqrt(size);
+  }
+
   DataType* get_local_activation_buffer(int index)
   {
     return m_parent_local_activations[index]->Buffer();
@@ -210,6 +248,16 @@ protected:
   /** @brief Return the default sync info that may used in update functions. */
   El::SyncInfo<Device> get_sync_info();
 
+  /** @brief Invert a damped Kronecker factor with Cholesky, or queue
+   *  it in the inverse batch if one is set and the factor is small. */
+  void invert_kronecker_factor(El::Matrix<DataType, Device>& Ainv,
+                               El::Matrix<DataType, Device>& Linv,
+                               const El::Matrix<DataType, Device>& A,
+                               bool report_time,
+                               DataType damping,
+                               DataType damping_bn_err,
+                               bool is_bn);
+
   /** @brief The target layer. */
   Layer* m_layer;
 
@@ -218,7 +266,7 @@ protected:
   const size_t m_layer_id;
 
   /** @brief The process ID which perform inverse on Kronecker. */
-  const int m_inverse_proc_rank;
+  int m_inverse_proc_rank;
 
   /** @brief distributed martices for activations and gradients. */
   std::vector<std::unique_ptr<AbsDistMat>> m_parent_local_activations,
@@ -245,6 +293,12 @@ protected:
   /** @brief Whether this block already has an inverse history. */
   bool m_has_kronecker_inverse;
 
+  /** @brief Rank of the low-rank eigendecomposition of the factors. */
+  size_t m_inverse_rank = 0;
+
+  /** @brief Batch of pending factor inversions, if batching. */
+  kfac::batched_inverse<Device>* m_inverse_batch = nullptr;
+
 private:
   /** @brief The execution context that created this block.
    *  TODO: Use its own workspace and remove this pointer. */
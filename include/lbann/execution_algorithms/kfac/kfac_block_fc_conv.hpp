@@ -146,6 +146,8 @@ public:
     total_size +=
       m_kronecker_factor_buf_G.Height() * m_kronecker_factor_buf_G.Width();
     total_size += m_grad_buffer_v.Height() * m_grad_buffer_v.Width();
+    total_size += m_eigenvectors_A.Height() * m_eigenvectors_A.Width();
+    total_size += m_eigenvectors_G.Height() * m_eigenvectors_G.Width();
     return total_size;
   }
 
@@ -201,6 +203,8 @@ public:
 
   int get_inverse_matrices_size(lbann_comm* comm) override;
 
+  double get_inverse_cost(lbann_comm* comm) override;
+
   std::vector<int> get_inverse_matrices_size_vector(lbann_comm* comm) override;
 
   void resize_inverse_matrices_size(
@@ -275,6 +279,10 @@ private:
   /** @brief Inverse of the average Kronecker factors. */
   El::Matrix<DataType, Device> m_kronecker_inverse_A, m_kronecker_inverse_G;
 
+  /** @brief Eigenvectors of the last low-rank inversion, used to
+   *  warm-start the next one. */
+  El::Matrix<DataType, Device> m_eigenvectors_A, m_eigenvectors_G;
+
   /** @brief Size and height of inverse matrices. */
   size_t m_Ainv_height = 0, m_Ainv_width = 0, m_Ginv_height = 0,
          m_Ginv_width = 0;
@@ -196,6 +196,8 @@ public:
   /** @brief Get inverse matrices size (offset). */
   int get_inverse_matrices_size(lbann_comm* comm) override;
 
+  double get_inverse_cost(lbann_comm* comm) override;
+
   int set_inverse_matrices(El::Matrix<DataType, Device>& workspace,
                            int offset,
                            lbann_comm* comm) override;
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_KFAC_KFAC_TIMING_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_KFAC_KFAC_TIMING_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace kfac {
+
+/** @brief One interval spent in a phase of a K-FAC step. */
+struct phase_record
+{
+  /** @brief Phase name, e.g. "inverse_comm". */
+  std::string name;
+  /** @brief When the phase started, from get_time(). */
+  EvalType start_time;
+  /** @brief When the phase ended, from get_time(). */
+  EvalType end_time;
+};
+
+/** @brief Phases of a K-FAC step, in the order they are reported. */
+std::vector<std::string> const& phase_names();
+
+/** @brief Time spent in the phases of K-FAC steps.
+ *
+ *  Owned by the model, so that callbacks can report the phases of
+ *  the steps that train it.
+ */
+class phase_timer
+{
+public:
+  /** @brief Start or stop recording phase intervals. */
+  void set_tracing(bool enable) noexcept { m_tracing = enable; }
+
+  /** @brief Return and clear the recorded phase intervals. */
+  std::vector<phase_record> take_records();
+
+  /** @brief Clear the per-step phase totals at the start of a step. */
+  void begin_step();
+
+  /** @brief Record that a phase ran for @c seconds and ended now.
+   *  @details Always adds to the per-step totals; the interval is
+   *  only kept if tracing is on.
+   */
+  void record(std::string const& name, EvalType seconds);
+
+  /** @brief Whether a K-FAC step has begun. Every rank of a trainer
+   *         agrees, unlike on which phases ran.
+   */
+  bool has_steps() const noexcept { return m_has_steps; }
+
+  /** @brief Total time of a phase in the current (or last) step, in
+   *         seconds. Zero if the phase did not run.
+   */
+  EvalType get_step_time(std::string const& name) const;
+
+private:
+  bool m_tracing = false;
+  bool m_has_steps = false;
+  std::vector<phase_record> m_records;
+  std::map<std::string, EvalType> m_step_times;
+};
+
+} // namespace kfac
+} // namespace lbann
+
+#endif // LBANN_EXECUTION_ALGORITHMS_KFAC_KFAC_TIMING_HPP_INCLUDED
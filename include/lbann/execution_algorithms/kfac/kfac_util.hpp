@@ -62,6 +62,8 @@ enum class kfac_inverse_strategy
   EACH, // Apply round-robin assingment to every type of layers. may
   // not work well for small networks.
   ROOT, // Use only the root GPU. This is only for testing.
+  BALANCED, // Balance the estimated O(n^3) inversion cost (or the
+            // measured inversion time) across processes.
 };
 
 enum class kfac_reduce_scatter_mode
@@ -100,6 +102,38 @@ void get_matrix_inverse_eigen(El::AbstractMatrix<DataType>& Ainv,
                               bool is_bn,
                               const El::SyncInfo<Device>& sync_info);
 
+/** @brief Gets an approximate inverse of A from a low-rank
+ *  eigendecomposition.
+ *
+ *  One step of subspace iteration, started from the eigenvectors in
+ *  @p basis, resolves the top @p rank eigenpairs of A; the rest of the
+ *  spectrum is treated as flat at the smallest resolved eigenvalue.
+ *  @p basis is updated with the new eigenvectors so that the next
+ *  call is warm-started. Falls back to get_matrix_inverse_eigen when
+ *  @p rank is zero or more than half the height of A.
+ **/
+template <El::Device Device>
+void get_matrix_inverse_low_rank(El::Matrix<DataType, Device>& Ainv,
+                                 El::Matrix<DataType, Device>& Linv,
+                                 El::Matrix<DataType, Device>& basis,
+                                 const El::Matrix<DataType, Device>& A,
+                                 size_t rank,
+                                 bool report_time,
+                                 DataType damping,
+                                 const El::SyncInfo<Device>& sync_info);
+
+/** @brief Compute alpha * [X; 1] [X; 1]^T, the Kronecker factor of a
+ *  fully-connected layer with bias, without forming [X; 1].
+ *
+ *  @param ones Workspace with one entry per column of X.
+ **/
+template <El::Device Device>
+void get_kronecker_factor_fc_with_bias(
+  El::Matrix<DataType, Device>& factor,
+  const El::Matrix<DataType, Device>& activations,
+  El::Matrix<DataType, Device>& ones,
+  DataType alpha);
+
 /** @brief Gets statistics of a given matrix. **/
 template <El::Device Device>
 std::string get_matrix_stat(const El::Matrix<DataType, Device>& X,
@@ -112,16 +146,33 @@ void allreduce_lower_tri(El::AbstractMatrix<DataType>& A,
                          lbann_comm* comm,
                          const El::SyncInfo<Device>& sync_info);
 
+/** @brief Assign blocks to processes by longest processing time first.
+ *  @details Blocks are taken in decreasing order of cost and each is
+ *  given to the least loaded process, with ties going to the lower
+ *  block index and rank. The result only depends on the inputs, so
+ *  every process computes the same assignment.
+ *  @param costs Cost of each block.
+ *  @param num_procs Number of processes.
+ *  @param ranks Output: the process assigned to each block.
+ *  @returns The total cost assigned to each process.
+ */
+std::vector<double> balance_inverse_assignment(std::vector<double> const& costs,
+                                               size_t num_procs,
+                                               std::vector<size_t>& ranks);
+
 /** @brief Get whether a global buffer is needed. **/
 bool is_reduce_scatter_buffer_required(kfac_reduce_scatter_mode mode);
 
-/** @brief Perform reduce-scatter on one or more blocks. **/
+/** @brief Perform reduce-scatter on one or more blocks.
+ *  @param half_precision Communicate in FP16 (ALLREDUCE mode only).
+ */
 template <El::Device Device>
 void reduce_scatter_blocks(
   const std::vector<std::pair<size_t, El::AbstractMatrix<DataType>*>>& blocks,
   El::Matrix<DataType, Device>& global_buffer,
   lbann_comm* comm,
-  kfac_reduce_scatter_mode mode);
+  kfac_reduce_scatter_mode mode,
+  bool half_precision = false);
 
 /** @brief Get whether local and global buffers are needed. **/
 std::pair<bool, bool> is_allgather_buffer_required(kfac_allgather_mode mode);
@@ -135,7 +186,10 @@ void allgather_blocks(
   lbann_comm* comm,
   kfac_allgather_mode mode);
 
-/** @brief Perform allgather for inverse matrices **/
+/** @brief Perform allgather for inverse matrices
+ *  @details Always communicates in the working precision, since
+ *  inverse entries can exceed the FP16 range.
+ */
 template <El::Device Device>
 void allgather_inverse_matrices(
   const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,
@@ -206,6 +260,62 @@ void unpack_lower_tri(El::Matrix<DataType, Device>& A,
                       const El::Matrix<DataType, Device>& L,
                       const El::SyncInfo<Device>& sync_info);
 
+/** @brief Invert a batch of damped symmetric positive definite
+ *  matrices in place.
+ *
+ *  Column i of A holds a height x height matrix. Row 0 of damping
+ *  holds the damping added to the first half of its diagonal and row
+ *  1 the damping added to the second half. **/
+template <El::Device Device>
+void get_matrix_inverse_batched(El::Matrix<DataType, Device>& A,
+                                const El::Matrix<DataType, Device>& damping,
+                                El::Int height,
+                                const El::SyncInfo<Device>& sync_info);
+
+/** @brief Collects small Kronecker factors and inverts the ones of
+ *  the same size together.
+ *
+ *  On GPUs each group of same-sized factors is inverted with a single
+ *  kernel launch, instead of one Cholesky factorization and
+ *  triangular solve per factor.
+ */
+template <El::Device Device>
+class batched_inverse
+{
+public:
+  /** @brief Largest factor height that is batched. */
+  static constexpr El::Int max_height = 64;
+
+  /** @brief Queue the inversion of a damped factor.
+   *  @details Ainv must be resized by the caller, and both matrices
+   *  must stay alive until run is called.
+   *  @returns Whether the factor was queued. Factors larger than
+   *  max_height are not batched.
+   */
+  bool add(const El::Matrix<DataType, Device>& A,
+           El::Matrix<DataType, Device>& Ainv,
+           DataType damping,
+           DataType damping_bn_err,
+           bool is_bn);
+
+  /** @brief Invert all queued factors and empty the queue. */
+  void run();
+
+  bool empty() const { return m_entries.empty(); }
+  size_t size() const { return m_entries.size(); }
+
+private:
+  struct entry
+  {
+    const El::Matrix<DataType, Device>* factor;
+    El::Matrix<DataType, Device>* inverse;
+    DataType damping;
+    DataType damping_bn_err;
+    bool is_bn;
+  };
+  std::vector<entry> m_entries;
+};
+
 template <typename T, El::Device Device>
 void TranslateBetweenGridsVCAsync(
   const El::DistMatrix<T, El::STAR, El::VC, El::ELEMENT, Device>& A,
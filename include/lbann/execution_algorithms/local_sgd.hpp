@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/execution_algorithms/factory.hpp"
+#include "lbann/execution_algorithms/training_algorithm.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/make_abstract.hpp"
+
+#include <google/protobuf/message.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace lbann {
+
+/** @class LocalSGDExecutionContext
+ *  @brief The execution context for local SGD.
+ *
+ *  Besides the number of completed rounds, this holds the outer
+ *  optimizer state: the weights values agreed on at the end of the
+ *  last round and the outer momentum.
+ */
+class LocalSGDExecutionContext final : public ExecutionContext
+{
+public:
+  LocalSGDExecutionContext() = default;
+  ~LocalSGDExecutionContext() = default;
+
+  std::unique_ptr<ExecutionContext> get_new() const override
+  {
+    return std::make_unique<LocalSGDExecutionContext>();
+  }
+
+  std::string get_type() const override { return "local_sgd"; }
+
+  std::string get_state_string() const noexcept override
+  {
+    return build_string(this->get_type(), ".step.", this->get_step());
+  }
+
+  /** @name Checkpointing
+   *  @brief Not supported; LocalSGD::apply rejects models with a
+   *         checkpoint callback.
+   */
+  ///@{
+  void save_to_checkpoint_shared(persist& p) override
+  {
+    LBANN_ERROR("local SGD does not support checkpointing");
+  }
+  void load_from_checkpoint_shared(persist& p) override
+  {
+    LBANN_ERROR("local SGD does not support checkpointing");
+  }
+  void save_to_checkpoint_distributed(persist& p) override
+  {
+    LBANN_ERROR("local SGD does not support checkpointing");
+  }
+  void load_from_checkpoint_distributed(persist& p) override
+  {
+    LBANN_ERROR("local SGD does not support checkpointing");
+  }
+  ///@}
+
+  /** @brief Weights values at the start of the current round. */
+  std::unordered_map<std::string, std::unique_ptr<AbsDistMat>> anchors;
+  /** @brief Outer momentum, one per weights object. */
+  std::unordered_map<std::string, std::unique_ptr<AbsDistMat>> velocities;
+  /** @brief Local training steps taken over all rounds. */
+  size_t local_steps = 0;
+  /** @brief Time spent averaging weights across trainers. */
+  double averaging_time = 0.;
+  /** @brief Bytes contributed to each weights average. */
+  size_t averaged_bytes = 0;
+}; // class LocalSGDExecutionContext
+
+/** @class LocalSGD
+ *  @brief Communication-avoiding training by periodic averaging.
+ *
+ *  Each trainer runs the local training algorithm on its own, which
+ *  synchronizes gradients only within the trainer. Afterwards the
+ *  weights are averaged across trainers. With the default outer
+ *  optimizer this is plain local SGD; a smaller outer learning rate
+ *  and outer (Nesterov) momentum give the DiLoCo scheme, which treats
+ *  the averaged weight change of a round as an outer gradient:
+ *
+ *  @f[
+ *    \Delta = \theta_{\text{anchor}} - \bar{\theta}, \quad
+ *    v \leftarrow \mu v + \Delta, \quad
+ *    \theta \leftarrow \theta_{\text{anchor}} - \eta
+ *      (\text{nesterov} ? \Delta + \mu v : v)
+ *  @f]
+ *
+ *  Trainer-local optimizer state (e.g. Adam moments) is not
+ *  averaged. Checkpointing is not supported: a checkpoint of the
+ *  model would miss the round count and the outer optimizer state,
+ *  so models with a checkpoint callback are rejected.
+ */
+class LocalSGD final : public TrainingAlgorithm
+{
+public:
+  using ExeContextType = LocalSGDExecutionContext;
+
+public:
+  /** @name Life-cycle management */
+  ///@{
+  /** @brief Construct local SGD from its component pieces.
+   *  @param[in] name A string identifying this instance.
+   *  @param[in] local_training_algorithm The training algorithm to
+   *             run between averaging rounds. Its stopping criteria
+   *             sets the number of local steps per round.
+   *  @param[in] max_rounds Number of averaging rounds.
+   *  @param[in] outer_learning_rate Outer optimizer step size.
+   *  @param[in] outer_momentum Outer optimizer momentum.
+   *  @param[in] outer_nesterov Use Nesterov outer momentum.
+   *  @param[in] suppress_timer Suppress the summary output.
+   */
+  LocalSGD(std::string name,
+           std::unique_ptr<TrainingAlgorithm> local_training_algorithm,
+           size_t max_rounds,
+           double outer_learning_rate,
+           double outer_momentum,
+           bool outer_nesterov,
+           bool suppress_timer);
+
+  ~LocalSGD() noexcept = default;
+  LocalSGD(LocalSGD const& other) = delete;
+  LocalSGD& operator=(LocalSGD const&) = delete;
+  LocalSGD(LocalSGD&&) = default;
+  LocalSGD& operator=(LocalSGD&&) = default;
+  ///@}
+  /** @brief Queries */
+  ///@{
+  std::string get_type() const final { return "local SGD"; }
+  ///@}
+  /** @name Apply interface */
+  ///@{
+  void apply(ExecutionContext& context,
+             model& m,
+             data_coordinator& dc,
+             execution_mode mode) final;
+  ///@}
+protected:
+  LocalSGDExecutionContext* do_get_new_execution_context() const final
+  {
+    return new LocalSGDExecutionContext();
+  }
+
+private:
+  /** @brief Average the weights across trainers and apply the outer
+   *         optimizer. */
+  void average_weights(LocalSGDExecutionContext& ctxt, model& m) const;
+
+  /** @brief Whether the outer optimizer needs per-weights state. */
+  bool has_outer_optimizer() const noexcept;
+
+private:
+  /** @brief The training algorithm run between averaging rounds. */
+  std::unique_ptr<TrainingAlgorithm> m_local_algo;
+  /** @brief Number of averaging rounds. */
+  size_t m_max_rounds;
+  /** @brief Outer optimizer step size. */
+  double m_outer_learning_rate;
+  /** @brief Outer optimizer momentum. */
+  double m_outer_momentum;
+  /** @brief Use Nesterov outer momentum. */
+  bool m_outer_nesterov;
+  /** @brief Suppress the summary output. */
+  bool m_suppress_timer = false;
+}; // class LocalSGD
+
+} // namespace lbann
+
+/** @brief Build the local SGD training algorithm from a protobuf
+ *         message.
+ */
+template <>
+std::unique_ptr<lbann::LocalSGD>
+lbann::make<lbann::LocalSGD>(google::protobuf::Message const& msg);
+
+#endif // LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
@@ -97,6 +97,30 @@ public:
     // Better API, but complicates "sendrecv_weights":
     // virtual std::unique_ptr<model> get_partner_model(
     //   lbann_comm const& c, El::Int partner_trainer);
+
+    /** @name Overlapped exchange
+     *
+     *  Strategies that return true from overlaps_exchange() are
+     *  driven through these functions instead of
+     *  get_partner_model(). The exchange is started at one
+     *  metaround, runs while the local model keeps training, and is
+     *  completed (and the tournament decided) at the next one.
+     */
+    ///@{
+    /** @brief Whether the exchange is overlapped with training. */
+    virtual bool overlaps_exchange() const noexcept { return false; }
+    /** @brief Snapshot the local model and start sending it. */
+    virtual void start_partner_exchange(model const& m,
+                                        El::Int partner_trainer,
+                                        size_t step);
+    /** @brief Partner of the exchange in flight, or -1 if none. */
+    virtual El::Int pending_partner_trainer() const noexcept { return -1; }
+    /** @brief Wait for the exchange in flight and build the partner
+     *         model from it.
+     *  @param[in] m The local model, used as a template.
+     */
+    virtual std::unique_ptr<model> finish_partner_exchange(model const& m);
+    ///@}
   protected:
     /** @brief Access weights_names. */
     std::set<std::string> const& weights_names() const noexcept
@@ -139,11 +163,19 @@ public:
    *             declared the winner.
    *  @param[in] comm_algo Algorithm for exchanging models.
    *  @param[in] mutate_algo Algorithm for mutating models.
+   *  @param[in] reuse_partner_scores Use the scores the partner
+   *             computed for its own model instead of re-evaluating
+   *             it, provided the received weights match the ones it
+   *             scored.
+   *  @param[in] evaluation_batches Number of tournament mini-batches
+   *             to evaluate models on (0 for the full data set).
    */
   RandomPairwiseExchange(
     std::unordered_map<std::string, metric_strategy> metrics,
     std::unique_ptr<ExchangeStrategy> comm_algo,
-    std::unique_ptr<MutationStrategy> mutate_algo);
+    std::unique_ptr<MutationStrategy> mutate_algo,
+    bool reuse_partner_scores = false,
+    size_t evaluation_batches = 0);
 
   ~RandomPairwiseExchange() = default;
   RandomPairwiseExchange(RandomPairwiseExchange const& other);
@@ -168,6 +200,26 @@ private:
   evaluate_model(model& m,
                  LTFBExecutionContext& ctxt,
                  data_coordinator& dc) const;
+  /** @brief Get the partner's own scores for @c partner_model.
+   *
+   *  Trainers swap the scores of their local models together with a
+   *  fingerprint of the weights they were computed from. If the
+   *  fingerprint matches the received model on every rank, the
+   *  partner's scores are returned; otherwise the model is evaluated
+   *  locally.
+   */
+  std::unordered_map<std::string, EvalType>
+  get_partner_scores(model& local_model,
+                     model& partner_model,
+                     int partner_trainer,
+                     std::unordered_map<std::string, EvalType> const&
+                       local_scores,
+                     LTFBExecutionContext& ctxt,
+                     data_coordinator& dc) const;
+  /** @brief Tournament variant for overlapped exchange strategies. */
+  void select_next_overlapped(model& m,
+                              ltfb::LTFBExecutionContext& ctxt,
+                              data_coordinator& dc) const;
   /** @brief Generate a new trainer partner from the comm. */
   int get_partner_trainer(lbann_comm const& c) const noexcept;
   /** @brief Evaluate the output of two models according to the input
@@ -211,10 +263,31 @@ private:
    */
   std::unique_ptr<MutationStrategy> m_mutate_algo;
 
+  /** @brief Trust the partner's scores of its own model.
+   *
+   *  This halves the evaluation cost of a tournament, at the price of
+   *  scoring each model on its own trainer's tournament data.
+   */
+  bool m_reuse_partner_scores;
+
+  /** @brief Tournament mini-batches per evaluation (0 for all). */
+  size_t m_evaluation_batches;
+
 }; // class RandomPairwiseExchange
 
 /** @class SendRecvWeights
  *  @brief Exchange model weights directly using sendrecvs.
+ *
+ *  In overlapped mode, the weights (and SGD/Adam state) are copied
+ *  to host buffers and streamed to the partner with non-blocking
+ *  messages of at most @c chunk_size elements on a dedicated
+ *  communicator. Local training continues while they are in flight;
+ *  progress relies on the MPI library's asynchronous progress.
+ *
+ *  With @c bf16_transfer, every exchanged matrix is rounded to
+ *  bfloat16 on the wire, halving the transfer for FP32 models. The
+ *  bytes saved are reported after each exchange.
+ *
  *  @todo More general approach to exchange optimizer state. Currently
  *  only SGD and Adam are supported.
  */
@@ -230,28 +303,60 @@ public:
    *                           then all weights are exchanged.
    *  @param[in] exchange_hyperparameters Exchange optimizer
    *                                      hyperparameters.
+   *  @param[in] overlap_exchange Overlap the exchange with training.
+   *  @param[in] chunk_size Maximum elements per message when
+   *                        overlapping (0 for no limit).
+   *  @param[in] bf16_transfer Round the exchanged data to bfloat16
+   *                           on the wire.
    */
   SendRecvWeights(std::set<std::string> const& weights_names,
-                  bool exchange_hyperparameters);
+                  bool exchange_hyperparameters,
+                  bool overlap_exchange = false,
+                  size_t chunk_size = 0,
+                  bool bf16_transfer = false);
 
   /** @brief Construct from weights names
    *  @param[in] weights_names Names of weights to exchange. If empty,
    *                           then all weights are exchanged.
    *  @param[in] exchange_hyperparameters Exchange optimizer
    *                                      hyperparameters.
+   *  @param[in] overlap_exchange Overlap the exchange with training.
+   *  @param[in] chunk_size Maximum elements per message when
+   *                        overlapping (0 for no limit).
+   *  @param[in] bf16_transfer Round the exchanged data to bfloat16
+   *                           on the wire.
    */
   SendRecvWeights(std::set<std::string>&& weights_names,
-                  bool exchange_hyperparameters);
+                  bool exchange_hyperparameters,
+                  bool overlap_exchange = false,
+                  size_t chunk_size = 0,
+                  bool bf16_transfer = false);
 
-  SendRecvWeights(SendRecvWeights const&) = default;
-  SendRecvWeights(SendRecvWeights&&) = default;
+  /** @brief Copies the configuration, not an exchange in flight. */
+  SendRecvWeights(SendRecvWeights const&);
+  SendRecvWeights(SendRecvWeights&&);
+  ~SendRecvWeights();
 
   std::unique_ptr<model> get_partner_model(model const& m,
                                            El::Int partner_trainer,
                                            size_t /*step*/) final;
 
+  bool overlaps_exchange() const noexcept final { return overlap_exchange_; }
+  void start_partner_exchange(model const& m,
+                              El::Int partner_trainer,
+                              size_t step) final;
+  El::Int pending_partner_trainer() const noexcept final;
+  std::unique_ptr<model> finish_partner_exchange(model const& m) final;
+
 private:
+  /** @brief Host buffers and requests of an overlapped exchange. */
+  struct PendingExchange;
+
   bool exchange_hyperparams_;
+  bool overlap_exchange_;
+  size_t chunk_size_;
+  bool bf16_transfer_;
+  std::unique_ptr<PendingExchange> pending_;
 }; // class SendRecvWeights
 
 /// See @c lbann::callbacks::ltfb::communication_algorithm::checkpoint_file
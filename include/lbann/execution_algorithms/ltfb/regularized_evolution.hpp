@@ -62,7 +62,8 @@ public:
   RegularizedEvolution(std::string metric_name,
                        metric_strategy winner_strategy,
                        std::unique_ptr<MutationStrategy> mutate_algo,
-                       int sample_size);
+                       int sample_size,
+                       int compression_level = 0);
   ~RegularizedEvolution() = default;
   RegularizedEvolution(RegularizedEvolution const& other);
 
@@ -99,6 +100,10 @@ private:
    */
   int m_sample_size;
 
+  /** @brief zlib level for models sent between trainers (0 is off)
+   */
+  int m_compression_level;
+
 }; // class RegularizedEvolution
 
 } // namespace ltfb
@@ -29,6 +29,7 @@
 
 #include "lbann/execution_algorithms/execution_context.hpp"
 #include "lbann/utils/cloneable.hpp"
+#include "lbann/utils/accumulating_timer.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/timer.hpp"
 
@@ -115,6 +116,14 @@ public:
   void stop_timer() noexcept { m_timer.stop(); }
   double get_current_execution_time() const noexcept { return m_timer.check(); }
 
+  /** @brief Durations of the mini-batch steps of the current epoch,
+   *         including their batch callbacks. */
+  AccumulatingTimer& get_step_timer() noexcept { return m_step_timer; }
+  AccumulatingTimer const& get_step_timer() const noexcept
+  {
+    return m_step_timer;
+  }
+
 private:
   friend class cereal::access;
   SGDExecutionContext() = default;
@@ -123,6 +132,9 @@ private:
   /** @brief Timer tracking execution time. */
   lbann::Timer m_timer;
 
+  /** @brief Timer tracking the steps of the current epoch. */
+  AccumulatingTimer m_step_timer;
+
   /** Number of times the training data set has been traversed. */
   size_t m_epoch = 0;
 
@@ -50,18 +50,26 @@ namespace lbann {
 class SGDTrainingAlgorithm : public TrainingAlgorithm
 {
 public:
-  /** @brief Construct with a name. */
+  /** @brief Construct with a name.
+   *  @param gradient_accumulation_steps Number of micro-batches
+   *         whose gradients are accumulated before each optimization
+   *         step. 0 and 1 step after every mini-batch.
+   *  @param overlap_validation Validate a snapshot of the weights
+   *         during the next epoch instead of between epochs.
+   */
   SGDTrainingAlgorithm(std::string name,
                        std::unique_ptr<SGDTerminationCriteria> stop,
-                       bool suppress_timer_output);
+                       bool suppress_timer_output,
+                       size_t gradient_accumulation_steps = 1,
+                       bool overlap_validation = false);
 
   SGDTrainingAlgorithm(const SGDTrainingAlgorithm& other) = delete;
   SGDTrainingAlgorithm& operator=(const SGDTrainingAlgorithm& other) = delete;
 
-  SGDTrainingAlgorithm(SGDTrainingAlgorithm&& other) = default;
-  SGDTrainingAlgorithm& operator=(SGDTrainingAlgorithm&& other) = default;
+  SGDTrainingAlgorithm(SGDTrainingAlgorithm&& other);
+  SGDTrainingAlgorithm& operator=(SGDTrainingAlgorithm&& other);
 
-  virtual ~SGDTrainingAlgorithm() = default;
+  virtual ~SGDTrainingAlgorithm();
   /** Copy training_algorithm. */
   //  virtual sgd_training_algorithm* copy() const = default;
 
@@ -100,12 +108,35 @@ public:
   std::unique_ptr<SGDExecutionContext> get_new_execution_context() const;
 
 protected:
-  /** Train model on one step / mini-batch of an SGD forward pass */
+  /** @brief Train model on one optimization step.
+   *
+   *  The step accumulates gradients over the configured number of
+   *  micro-batches. Backprop callbacks on all but the last see
+   *  partial gradients. If the epoch ends first, the step uses the
+   *  micro-batches seen so far, still scaled as if the step were
+   *  full.
+   */
   bool train_mini_batch(SGDExecutionContext& c,
                         model& model,
                         data_coordinator& dc,
                         ScopeTimer timer);
 
+  /** Forward and backward prop one micro-batch without stepping */
+  bool
+  train_micro_batch(model& model, data_coordinator& dc, ScopeTimer timer);
+
+  /** @brief Run the micro-batches of a pipeline-parallel model.
+   *
+   *  Each process runs its stage's share of a one-forward-one-backward
+   *  schedule. Every stage fetches each micro-batch, since the data
+   *  coordinator is shared by the trainer. @c num_micro_batches is
+   *  lowered to the number run when the epoch ends within the step.
+   */
+  bool train_pipeline_micro_batches(model& model,
+                                    data_coordinator& dc,
+                                    size_t& num_micro_batches,
+                                    ScopeTimer timer);
+
   /** Evaluate model on one step / mini-batch of an SGD forward pass */
   bool evaluate_mini_batch(SGDExecutionContext& c,
                            model& model,
@@ -113,6 +144,63 @@ protected:
                            execution_mode mode,
                            ScopeTimer timer);
 
+  /** @brief Fetch and forward prop one evaluation mini-batch.
+   *
+   *  The mini-batch is evaluated by end_evaluate_mini_batch. Returns
+   *  "true" if it is the last one of the epoch.
+   */
+  bool begin_evaluate_mini_batch(SGDExecutionContext& c,
+                                 model& model,
+                                 data_coordinator& dc,
+                                 execution_mode mode,
+                                 ScopeTimer timer);
+
+  /** @brief Evaluate the objective function and metrics of the last
+   *         forward propped mini-batch.
+   */
+  void end_evaluate_mini_batch(SGDExecutionContext& c,
+                               model& model,
+                               execution_mode mode,
+                               ScopeTimer timer);
+
+  ////////////////////////////////////////////////////////////
+  // Overlapped validation
+  ////////////////////////////////////////////////////////////
+
+  /** @brief Start validating a snapshot of the model's weights.
+   *
+   *  The snapshot is a copy of the model without optimizers that
+   *  reports through the model's callbacks. It is made at the first
+   *  validation of a call to train and its weights are refreshed at
+   *  every later one. Its validation mini-batches are interleaved
+   *  with the next epoch's training steps by
+   *  step_overlapped_validation. On GPUs the snapshot runs on its
+   *  own stream, so each validation forward prop overlaps the
+   *  training step that follows it.
+   */
+  void start_overlapped_validation(SGDExecutionContext& c,
+                                   model& model,
+                                   data_coordinator& dc,
+                                   ScopeTimer timer);
+
+  /** @brief Evaluate the pending validation mini-batch and forward
+   *         prop the next one.
+   *
+   *  At the end of the validation epoch, runs the evaluation-end
+   *  callbacks and passes an early stop on to the training context.
+   */
+  void step_overlapped_validation(SGDExecutionContext& c,
+                                  data_coordinator& dc,
+                                  ScopeTimer timer);
+
+  /** @brief Run the rest of the snapshot's validation, if any. */
+  void finish_overlapped_validation(SGDExecutionContext& c,
+                                    data_coordinator& dc,
+                                    ScopeTimer timer);
+
+  /** @brief Free the snapshot and its stream. */
+  void clear_validation_snapshot();
+
   ////////////////////////////////////////////////////////////
   // Callbacks
   ////////////////////////////////////////////////////////////
@@ -155,6 +243,28 @@ private:
    */
   bool m_suppress_timer = false;
 
+  /** @brief Micro-batches accumulated per optimization step. */
+  size_t m_gradient_accumulation_steps = 1;
+
+  /** @brief Validate during the next epoch, see
+   *         start_overlapped_validation.
+   */
+  bool m_overlap_validation = false;
+  /** @brief Copy of the model that is validated during training. */
+  std::unique_ptr<model> m_validation_snapshot;
+  /** @brief Whether a validation mini-batch of the snapshot has been
+   *         forward propped but not evaluated.
+   */
+  bool m_validation_in_flight = false;
+  /** @brief Whether the pending validation mini-batch is the last
+   *         one of the epoch.
+   */
+  bool m_validation_epoch_done = false;
+#ifdef LBANN_HAS_GPU
+  /** @brief Stream of the snapshot's layers. */
+  El::SyncInfo<El::Device::GPU> m_validation_stream;
+#endif // LBANN_HAS_GPU
+
 #ifdef LBANN_HAS_GPU
   gpu_lib::event_wrapper m_data_prefetch_sync_event;
 #endif // LBANN_HAS_GPU
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_IO_CHECKPOINT_WRITER_HPP_INCLUDED
+#define LBANN_IO_CHECKPOINT_WRITER_HPP_INCLUDED
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Writes checkpoint files from host memory on a background
+ *         thread.
+ *
+ *  Each submission is a batch of (path, contents) pairs that is
+ *  written, fsync'd and closed in order. Callers get a ticket they
+ *  can wait on; a batch is durable once its ticket has been waited
+ *  for. Errors on the writer thread are rethrown by the next call to
+ *  wait() or wait_all().
+ */
+class checkpoint_writer
+{
+public:
+  using file_list = std::vector<std::pair<std::string, std::string>>;
+
+  checkpoint_writer();
+  ~checkpoint_writer();
+
+  checkpoint_writer(const checkpoint_writer&) = delete;
+  checkpoint_writer& operator=(const checkpoint_writer&) = delete;
+
+  /** @brief Queue a batch of files; returns its ticket. */
+  uint64_t submit(file_list files);
+
+  /** @brief Block until the batch with the given ticket is written. */
+  void wait(uint64_t ticket);
+
+  /** @brief Block until every queued batch is written. */
+  void wait_all();
+
+  /** @brief Number of batches that are queued or being written. */
+  size_t num_pending() const;
+
+  /** @brief Total bytes written so far. */
+  uint64_t get_bytes_written() const;
+
+  /** @brief Write a batch on the calling thread; returns its size. */
+  static uint64_t write_files(file_list const& files);
+
+private:
+  void worker();
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<std::pair<uint64_t, file_list>> m_queue;
+  /** Tickets below this value have been written. */
+  uint64_t m_completed = 0;
+  uint64_t m_next_ticket = 0;
+  uint64_t m_bytes_written = 0;
+  std::exception_ptr m_worker_error;
+  bool m_stop = false;
+  std::thread m_worker;
+};
+
+} // namespace lbann
+
+#endif // LBANN_IO_CHECKPOINT_WRITER_HPP_INCLUDED
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_IO_TENSOR_DUMP_WRITER_HPP_INCLUDED
+#define LBANN_IO_TENSOR_DUMP_WRITER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/exception.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+// Forward declaration
+class thread_pool;
+
+/** @brief Writes host copies of tensors on a background thread.
+ *
+ *  Used by the dump callbacks so that diagnostic output does not
+ *  stall training. A submitted matrix is copied into one of a small
+ *  ring of pinned host buffers, on a dedicated stream if it is
+ *  GPU-resident, and its write function is queued on a single writer
+ *  thread that reads the staged copy once the copy has landed.
+ *  Submitting only blocks when every buffer still holds an unwritten
+ *  tensor, which bounds the host memory in use. Writes finish in
+ *  submission order. Errors on the writer thread are rethrown by the
+ *  next submit or wait_all.
+ */
+class tensor_dump_writer
+{
+public:
+  template <typename T>
+  using write_function =
+    std::function<void(const El::Matrix<T, El::Device::CPU>&)>;
+
+  /** @param num_buffers Number of staging buffers (at least 1). */
+  explicit tensor_dump_writer(size_t num_buffers = 2);
+  ~tensor_dump_writer();
+
+  tensor_dump_writer(const tensor_dump_writer&) = delete;
+  tensor_dump_writer& operator=(const tensor_dump_writer&) = delete;
+
+  /** @brief Stage a local matrix and queue a write of the copy. */
+  template <typename T>
+  void submit(const El::AbstractMatrix<T>& data, write_function<T> write);
+
+  /** @brief Gather a distributed matrix to its root process and
+   *         queue a write of it there.
+   *
+   *  The gather stays on the matrix's device. Collective over the
+   *  matrix's grid; only the root process queues a write.
+   *
+   *  @param max_width If positive, only the first @c max_width
+   *                   columns (mini-batch samples) are gathered.
+   */
+  template <typename T>
+  void submit_gathered(const El::AbstractDistMatrix<T>& data,
+                       write_function<T> write,
+                       El::Int max_width = 0);
+
+  /** @brief Queue a task that runs after every write submitted so
+   *         far, e.g. to write an index of the dumped files. */
+  void submit_task(std::function<void()> task);
+
+  /** @brief Block until every queued write has finished. */
+  void wait_all();
+
+private:
+  struct staging_buffer
+  {
+    /** Pinned host memory holding the staged tensor. */
+    std::unique_ptr<hydrogen::simple_buffer<El::byte, El::Device::CPU>> host;
+    /** Completion of the write reading from this buffer. */
+    std::future<void> write;
+#ifdef LBANN_HAS_GPU
+    /** Recorded after the device-to-host copy into this buffer. */
+    gpu_lib::event_wrapper copy_done;
+#endif // LBANN_HAS_GPU
+  };
+
+  /** Wait until the next buffer of the ring has been written, grow
+   *  it to at least @c bytes and return it. */
+  staging_buffer& acquire(size_t bytes);
+  /** Queue @c write to run once the copy into @c buf has landed. */
+  void enqueue(staging_buffer& buf, std::function<void()> write);
+
+  std::vector<std::unique_ptr<staging_buffer>> m_buffers;
+  size_t m_next_buffer = 0;
+  /** Completion of the most recent task from submit_task. */
+  std::future<void> m_last_task;
+  /** Single-threaded pool running the writes. */
+  std::unique_ptr<thread_pool> m_writer;
+#ifdef LBANN_HAS_GPU
+  /** Dedicated stream for device-to-host copies. */
+  El::SyncInfo<El::Device::GPU> m_copy_sync_info;
+#endif // LBANN_HAS_GPU
+};
+
+template <typename T>
+void tensor_dump_writer::submit(const El::AbstractMatrix<T>& data,
+                                write_function<T> write)
+{
+  const El::Int height = data.Height();
+  const El::Int width = data.Width();
+  auto& buf = acquire(height * width * sizeof(T));
+  auto* host = reinterpret_cast<T*>(buf.host->data());
+  switch (data.GetDevice()) {
+  case El::Device::CPU:
+    for (El::Int col = 0; col < width; ++col) {
+      std::copy_n(data.LockedBuffer(0, col), height, host + col * height);
+    }
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    const auto data_sync = El::SyncInfoFromMatrix(
+      static_cast<const El::Matrix<T, El::Device::GPU>&>(data));
+    // The copy waits for the producer of the data, and later work on
+    // the data's stream (including freeing it) waits for the copy
+    El::AddSynchronizationPoint(data_sync, m_copy_sync_info);
+    hydrogen::gpu::Copy2DToHost(data.LockedBuffer(),
+                                data.LDim(),
+                                host,
+                                height,
+                                height,
+                                width,
+                                m_copy_sync_info);
+    buf.copy_done.record(m_copy_sync_info.Stream());
+    El::AddSynchronizationPoint(m_copy_sync_info, data_sync);
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device for tensor dump");
+  }
+  enqueue(buf, [host, height, width, write = std::move(write)]() {
+    El::Matrix<T, El::Device::CPU> staged;
+    staged.LockedAttach(height, width, host, std::max(height, El::Int(1)));
+    write(staged);
+  });
+}
+
+template <typename T>
+void tensor_dump_writer::submit_gathered(const El::AbstractDistMatrix<T>& data,
+                                         write_function<T> write,
+                                         El::Int max_width)
+{
+  const El::AbstractDistMatrix<T>* source = &data;
+  std::unique_ptr<El::AbstractDistMatrix<T>> view;
+  if (max_width > 0 && data.Width() > max_width) {
+    view.reset(data.Construct(data.Grid(), data.Root()));
+    El::LockedView(*view, data, El::ALL, El::IR(0, max_width));
+    source = view.get();
+  }
+  std::unique_ptr<El::AbstractDistMatrix<T>> circ;
+  switch (data.GetLocalDevice()) {
+  case El::Device::CPU:
+    circ = std::make_unique<CircMatDT<T, El::Device::CPU>>(data.Grid(),
+                                                          data.Root());
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    circ = std::make_unique<CircMatDT<T, El::Device::GPU>>(data.Grid(),
+                                                          data.Root());
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device for tensor dump");
+  }
+  El::Copy(*source, *circ);
+  if (circ->CrossRank() == circ->Root()) {
+    submit(circ->LockedMatrix(), std::move(write));
+  }
+}
+
+} // namespace lbann
+
+#endif // LBANN_IO_TENSOR_DUMP_WRITER_HPP_INCLUDED
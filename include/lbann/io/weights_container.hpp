@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_IO_WEIGHTS_CONTAINER_HPP_INCLUDED
+#define LBANN_IO_WEIGHTS_CONTAINER_HPP_INCLUDED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+class lbann_comm;
+class weights;
+
+/** @brief Single-file binary container for a model's weight values.
+ *
+ *  The file holds a fixed header (magic, format version, tensor
+ *  count, index offset), one column-major blob per weights object
+ *  aligned to 64 bytes, and an index at the end with each tensor's
+ *  name, dimensions, element size, codec, offset and stored size.
+ *  Blobs are either raw or zlib-compressed. Raw containers are read
+ *  through a memory map, so each rank only touches the pages holding
+ *  its own entries.
+ */
+namespace weights_container {
+
+/** @brief Name of the container within a model directory. */
+constexpr char file_name[] = "model_weights.lbw";
+
+/** @brief Write the values of @c weights_list to @c path.
+ *
+ *  Collective over the trainer; the trainer master writes the file.
+ *  Blobs are zlib-compressed at @c compression_level when it is
+ *  positive and compression actually saves space.
+ *
+ *  @returns Bytes written on the trainer master, zero elsewhere.
+ */
+uint64_t write(std::string const& path,
+               std::vector<weights*> const& weights_list,
+               lbann_comm& comm,
+               int compression_level = 0);
+
+/** @brief Load the weights in @c weights_list that are stored in
+ *         @c path, matching them by name.
+ *
+ *  Collective over the trainer; every rank must be able to read the
+ *  file.
+ *
+ *  @returns Names of the weights that are not in the container.
+ */
+std::vector<std::string> read(std::string const& path,
+                              std::vector<weights*> const& weights_list,
+                              lbann_comm& comm);
+
+/** @brief Make the weights in @c weights_list that are stored in
+ *         @c path take their values from it on first access.
+ *
+ *  Unlike read, this is meant to be called before the weights are
+ *  set up: they then skip their initializer, and each one copies its
+ *  entries out of the memory-mapped file (and to the GPU, if need be)
+ *  the first time its values are used. Compressed tensors are
+ *  inflated here. Not collective.
+ *
+ *  @returns Names of the weights that are not in the container.
+ */
+std::vector<std::string> attach(std::string const& path,
+                                std::vector<weights*> const& weights_list);
+
+} // namespace weights_container
+} // namespace lbann
+
+#endif // LBANN_IO_WEIGHTS_CONTAINER_HPP_INCLUDED
@@ -66,6 +66,7 @@ public:
   {
     return ERROR_SIGNALS | PREV_ACTIVATIONS;
   }
+  bool supports_graph_capture() const override { return true; }
 
   description get_description() const override
   {
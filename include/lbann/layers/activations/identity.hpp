@@ -72,6 +72,7 @@ public:
   El::Device get_device_allocation() const override { return Device; }
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool has_tensor_views() const override { return true; }
 
 #ifdef LBANN_HAS_ONNX
   std::string get_onnx_op_type() const override { return "Identity"; }
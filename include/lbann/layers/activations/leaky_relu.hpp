@@ -130,6 +130,7 @@ protected:
   {
     return ERROR_SIGNALS | ACTIVATIONS;
   }
+  bool supports_graph_capture() const override { return true; }
 
 private:
   /** Function slope in negative region. */
@@ -80,6 +80,7 @@ public:
   {
     return ERROR_SIGNALS | ACTIVATIONS;
   }
+  bool supports_graph_capture() const override { return true; }
 
 #ifdef LBANN_HAS_ONNX
   std::string get_onnx_op_type() const override { return "Relu"; }
@@ -146,6 +146,13 @@ public:
   const InputAbsDistMatrixType&
   get_error_signals(const Layer& parent) const override;
   bool owns_activations() const override { return m_activations_created; }
+  size_t get_plannable_tensor_bytes(int index,
+                                    bool error_signal,
+                                    El::Int mini_batch_size) const override;
+  size_t get_fp_tensor_signature() const override;
+  size_t get_input_redistribution_bytes(int input_index) const override;
+  bool share_input_redistribution(int input_index,
+                                  Layer const& sibling) override;
 
   El::Int current_output_mini_batch_size() const override;
   El::Int
@@ -315,6 +322,42 @@ protected:
   weights const& master_weights(size_t idx) const { return get_weights(idx); }
 
 private:
+  /** @brief Attach a tensor to its region of the model's activation
+   *         memory plan.
+   *
+   *  The tensor must already be aligned with its final distribution.
+   *
+   *  @returns false if the tensor is not planned, in which case it is
+   *           left empty.
+   */
+  template <typename T>
+  bool attach_planned_tensor(El::AbstractDistMatrix<T>& mat,
+                             int index,
+                             bool error_signal,
+                             El::Int height,
+                             El::Int width);
+  /** @brief Whether a tensor lives in the model's planned arenas. */
+  template <typename T>
+  bool is_planned_tensor(El::AbstractDistMatrix<T> const& mat) const;
+  /** @brief Resize a tensor, keeping room for the model's maximum
+   *         mini-batch.
+   *
+   *  Every allocation of the tensor then has the same size, so
+   *  mini-batch size changes and partial mini-batches reuse memory
+   *  from the pool instead of allocating new blocks.
+   */
+  template <typename T>
+  void resize_for_mini_batch(El::AbstractDistMatrix<T>& mat,
+                             El::Int height,
+                             El::Int width) const;
+
+  /** @brief Run the layer's tensors on the GPU stream the model
+   *  assigned to the layer, if any.
+   *
+   *  @returns Whether the layer runs on its own stream.
+   */
+  bool use_layer_stream(bool error_signals);
+
   /** @brief Attempt to take ownership of the previous error signal.
    *
    *  If the underlying matrix has the right datatype and
@@ -449,6 +492,13 @@ private:
    */
   bool m_activations_created = false;
 
+  /** @brief Redistributed sibling inputs viewed in place of copies.
+   *
+   *  Indexed by input. A null entry means the input is set up from
+   *  the parent's output as usual.
+   */
+  std::vector<InputAbsDistMatrixType const*> m_shared_input_redistributions;
+
 #ifdef LBANN_HAS_DISTCONV
   friend class data_type_distconv_adapter<InputTensorDataType,
                                           OutputTensorDataType>;
@@ -29,19 +29,24 @@
 
 #include "lbann/layers/data_type_layer.hpp"
 
+#include <utility>
+
 namespace lbann {
 
 /** @brief Cutout a square from an image
  *
  *  Expects two inputs: a 3D image tensor in CHW format and a scalar
  *  length of the cutout square.
+ *
+ *  The square is centered at the same random position for every
+ *  sample in the mini-batch. When run in-place, only the pixels in
+ *  the square are written.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class cutout_layer : public data_type_layer<TensorDataType>
 {
   static_assert(Layout == data_layout::DATA_PARALLEL,
                 "cutout_layer only supports DATA_PARALLEL");
-  static_assert(Device == El::Device::CPU, "cutou_layer only supports CPU");
 
 public:
   /** @name Public Types */
@@ -83,16 +88,18 @@ protected:
   void setup_dims() override;
 
   void write_specific_proto(lbann_data::Layer& proto) const final;
+
+private:
+  /** Draw the (row, column) of the cutout center for a mini-batch. */
+  std::pair<El::Int, El::Int> draw_cutout_center() const;
 };
 
 #ifndef LBANN_CUTOUT_LAYER_INSTANTIATE
-#define PROTO(T)                                                               \
-  extern template class cutout_layer<T,                                        \
-                                     data_layout::DATA_PARALLEL,               \
-                                     El::Device::CPU>
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class cutout_layer<T, data_layout::DATA_PARALLEL, Device>
 
-#include "lbann/macros/instantiate.hpp"
-#undef PROTO
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
 #endif // LBANN_CUTOUT_LAYER_INSTANTIATE
 
 } // namespace lbann
@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_IMAGE_IMAGE_AUGMENTATION_HPP_INCLUDED
+#define LBANN_LAYERS_IMAGE_IMAGE_AUGMENTATION_HPP_INCLUDED
+
+#include "lbann/layers/data_type_layer.hpp"
+
+namespace lbann {
+
+/** @brief Random geometric augmentation of images
+ *
+ *  Expects a 3D input tensor, which is interpreted as an image in CHW
+ *  format. During training, each sample is rotated, scaled and
+ *  translated by random amounts and then cropped to the output size.
+ *  The transforms are composed into one affine map per sample, so
+ *  each output pixel is a single bilinear interpolation of the input
+ *  and pixels that map outside the input are zero. Outside of
+ *  training, the output is the center crop of the input.
+ *
+ *  Gradients are not propagated during backprop.
+ */
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+class image_augmentation_layer : public data_type_layer<TensorDataType>
+{
+  static_assert(Layout == data_layout::DATA_PARALLEL,
+                "image_augmentation_layer only supports DATA_PARALLEL");
+
+public:
+  /** @brief Number of coefficients of an affine map. */
+  static constexpr El::Int num_coefficients = 6;
+
+public:
+  /** @param comm            LBANN communicator
+   *  @param height          Output image height. Zero keeps the input
+   *                         height.
+   *  @param width           Output image width. Zero keeps the input
+   *                         width.
+   *  @param max_rotation    Largest rotation, in degrees, in either
+   *                         direction
+   *  @param max_translation Largest translation, as a fraction of the
+   *                         input size, in either direction
+   *  @param min_scale       Smallest zoom factor
+   *  @param max_scale       Largest zoom factor
+   */
+  image_augmentation_layer(lbann_comm* comm,
+                           El::Int height,
+                           El::Int width,
+                           float max_rotation,
+                           float max_translation,
+                           float min_scale,
+                           float max_scale);
+
+  image_augmentation_layer* copy() const override
+  {
+    return new image_augmentation_layer(*this);
+  }
+
+  /** @name Serialization */
+  ///@{
+
+  template <typename ArchiveT>
+  void serialize(ArchiveT& ar);
+
+  ///@}
+
+  std::string get_type() const override { return "image augmentation"; }
+  data_layout get_data_layout() const override { return Layout; }
+  El::Device get_device_allocation() const override { return Device; }
+  bool can_run_inplace() const override { return false; }
+  int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+
+  description get_description() const override;
+
+  void fp_compute() override;
+
+protected:
+  friend class cereal::access;
+  image_augmentation_layer()
+    : image_augmentation_layer(nullptr, 0, 0, 0.f, 0.f, 1.f, 1.f)
+  {}
+
+  void setup_dims() override;
+
+  void write_specific_proto(lbann_data::Layer& proto) const final;
+
+private:
+  /** @brief Draw the affine map of each local sample.
+   *
+   *  Sample @c j's map is stored in column @c j as
+   *  @f$(a_0,\dots,a_5)@f$: the output pixel centered at @f$(x,y)@f$
+   *  reads the input at @f$(a_0 x + a_1 y + a_2, a_3 x + a_4 y +
+   *  a_5)@f$. Both are in pixel units with the origin at the corner
+   *  of the image.
+   */
+  void draw_transforms(El::Matrix<float, El::Device::CPU>& transforms) const;
+
+  /** Output image height. */
+  El::Int m_height;
+  /** Output image width. */
+  El::Int m_width;
+  /** Largest rotation, in degrees. */
+  float m_max_rotation;
+  /** Largest translation, as a fraction of the input size. */
+  float m_max_translation;
+  /** Smallest zoom factor. */
+  float m_min_scale;
+  /** Largest zoom factor. */
+  float m_max_scale;
+};
+
+#ifndef LBANN_IMAGE_AUGMENTATION_LAYER_INSTANTIATE
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class image_augmentation_layer<T,                            \
+                                                 data_layout::DATA_PARALLEL,   \
+                                                 Device>
+
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
+#endif // LBANN_IMAGE_AUGMENTATION_LAYER_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_IMAGE_IMAGE_AUGMENTATION_HPP_INCLUDED
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_IMAGE_IMAGE_AUGMENTATION_IMPL_HPP_INCLUDED
+#define LBANN_LAYERS_IMAGE_IMAGE_AUGMENTATION_IMPL_HPP_INCLUDED
+
+#include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/layers/image/image_augmentation.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
+#include "lbann/utils/description.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/random.hpp"
+
+#include "lbann/proto/layers.pb.h"
+
+#include <cmath>
+
+namespace lbann {
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+image_augmentation_layer<TensorDataType, Layout, Device>::
+  image_augmentation_layer(lbann_comm* comm,
+                           El::Int height,
+                           El::Int width,
+                           float max_rotation,
+                           float max_translation,
+                           float min_scale,
+                           float max_scale)
+  : data_type_layer<TensorDataType>(comm),
+    m_height(height),
+    m_width(width),
+    m_max_rotation(max_rotation),
+    m_max_translation(max_translation),
+    m_min_scale(min_scale),
+    m_max_scale(max_scale)
+{}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void image_augmentation_layer<TensorDataType, Layout, Device>::setup_dims()
+{
+  data_type_layer<TensorDataType>::setup_dims();
+
+  // Get input dimensions
+  auto dims = this->get_input_dims();
+
+  // Check that dimensions and parameters are valid
+  if (dims.size() != 3) {
+    std::ostringstream ss;
+    for (size_t i = 0; i < dims.size(); ++i) {
+      ss << (i > 0 ? " x " : "") << dims[i];
+    }
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" ",
+                "expects a 3D input in CHW format, ",
+                "but input dimensions are ",
+                ss.str());
+  }
+  if (m_height < 0 || m_width < 0) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" ",
+                "has invalid output size ",
+                m_height,
+                " x ",
+                m_width);
+  }
+  if (m_min_scale <= 0.f || m_max_scale < m_min_scale) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" ",
+                "has invalid scale range [",
+                m_min_scale,
+                ", ",
+                m_max_scale,
+                "]");
+  }
+
+  // Crop to the output size
+  if (m_height > 0) {
+    dims[1] = m_height;
+  }
+  if (m_width > 0) {
+    dims[2] = m_width;
+  }
+  this->set_output_dims(dims);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void image_augmentation_layer<TensorDataType, Layout, Device>::
+  write_specific_proto(lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<TensorDataType>);
+  auto* msg = proto.mutable_image_augmentation();
+  msg->set_height(m_height);
+  msg->set_width(m_width);
+  msg->set_max_rotation(m_max_rotation);
+  msg->set_max_translation(m_max_translation);
+  msg->set_min_scale(m_min_scale);
+  msg->set_max_scale(m_max_scale);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+description
+image_augmentation_layer<TensorDataType, Layout, Device>::get_description()
+  const
+{
+  auto desc = data_type_layer<TensorDataType>::get_description();
+  desc.add("Max rotation", m_max_rotation);
+  desc.add("Max translation", m_max_translation);
+  desc.add("Scale range",
+           "[" + std::to_string(m_min_scale) + ", " +
+             std::to_string(m_max_scale) + "]");
+  return desc;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void image_augmentation_layer<TensorDataType, Layout, Device>::draw_transforms(
+  El::Matrix<float, El::Device::CPU>& transforms) const
+{
+  constexpr float pi = M_PI;
+  const auto& input_dims = this->get_input_dims();
+  const auto& output_dims = this->get_output_dims();
+  const float input_height = input_dims[1];
+  const float input_width = input_dims[2];
+  const float output_height = output_dims[1];
+  const float output_width = output_dims[2];
+  const El::Int num_samples = transforms.Width();
+
+  // Outside of training, take the center crop
+  const auto& mode =
+    this->m_model->get_execution_context().get_execution_mode();
+  const bool augment = (mode == execution_mode::training);
+
+  auto& gen = get_generator();
+  for (El::Int sample = 0; sample < num_samples; ++sample) {
+    float angle = 0.f, scale = 1.f, shift_x = 0.f, shift_y = 0.f;
+    if (augment) {
+      angle = (2 * random_uniform<float>(gen) - 1) * m_max_rotation * pi / 180;
+      scale = m_min_scale +
+              random_uniform<float>(gen) * (m_max_scale - m_min_scale);
+      shift_x =
+        (2 * random_uniform<float>(gen) - 1) * m_max_translation * input_width;
+      shift_y =
+        (2 * random_uniform<float>(gen) - 1) * m_max_translation * input_height;
+    }
+
+    // Map the output offset from its center through the inverse
+    // rotation and zoom, then shift by the input center
+    const float c = std::cos(angle) / scale;
+    const float s = std::sin(angle) / scale;
+    float* a = transforms.Buffer(0, sample);
+    a[0] = c;
+    a[1] = s;
+    a[2] = input_width / 2 + shift_x - c * output_width / 2 -
+           s * output_height / 2;
+    a[3] = -s;
+    a[4] = c;
+    a[5] = input_height / 2 + shift_y + s * output_width / 2 -
+           c * output_height / 2;
+  }
+}
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_IMAGE_IMAGE_AUGMENTATION_IMPL_HPP_INCLUDED
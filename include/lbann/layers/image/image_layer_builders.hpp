@@ -34,6 +34,7 @@ LBANN_DEFINE_LAYER_BUILDER(bilinear_resize);
 LBANN_DEFINE_LAYER_BUILDER(composite_image_transformation);
 LBANN_DEFINE_LAYER_BUILDER(rotation);
 LBANN_DEFINE_LAYER_BUILDER(cutout);
+LBANN_DEFINE_LAYER_BUILDER(image_augmentation);
 
 } // namespace lbann
 #endif // LBANN_LAYERS_IMAGE_IMAGE_LAYER_BUILDERS_HPP_INCLUDED
@@ -28,6 +28,7 @@
 #define LBANN_LAYERS_LAYER_HPP_INCLUDED
 
 #include "lbann/base.hpp"
+#include "lbann/comm_nb_request.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/typename.hpp"
 #include <string>
@@ -711,6 +712,178 @@ public:
   void unfreeze();
   bool is_frozen() const;
 
+  /** @brief Whether the current backprop step needs error signals
+   *         w.r.t. this layer's inputs.
+   *
+   *  Set by the model before each layer's back prop. False when no
+   *  layer upstream has trainable weights, e.g. below the lowest
+   *  trainable layer of a frozen backbone. Layers may then skip
+   *  computing their error signals, which are left unspecified.
+   */
+  bool are_error_signals_needed() const noexcept
+  {
+    return m_error_signals_needed;
+  }
+  void set_error_signals_needed(bool needed) noexcept
+  {
+    m_error_signals_needed = needed;
+  }
+
+  ///@}
+  /** @name Asynchronous communication */
+  ///@{
+
+  /** @brief Complete communication the layer left in flight.
+   *
+   *  A layer may issue a collective on its outputs or error signals
+   *  without waiting for it, so that independent layers, e.g. the
+   *  other branches of a sub-graph, run meanwhile. The first consumer
+   *  calls this before reading the tensors: children before forward
+   *  prop, parents before back prop, and the model at the end of each
+   *  pass. Error signals that were in flight at the end of back prop
+   *  are propagated to the parents here.
+   */
+  void finish_pending_communication();
+  bool has_pending_communication() const noexcept
+  {
+    return !m_pending_requests.empty();
+  }
+
+  ///@}
+  /** @name Activation checkpointing */
+  ///@{
+
+  /** @brief Recompute the layer's outputs during backprop instead of
+   *  keeping them from forward prop.
+   */
+  void set_checkpoint(bool checkpoint) noexcept { m_checkpoint = checkpoint; }
+  bool is_checkpointed() const noexcept { return m_checkpoint; }
+
+  /** @brief If false, running forward prop again would not reproduce
+   *  the outputs and state used in backprop, e.g. because the layer
+   *  is random or updates running statistics. Such layers are never
+   *  recomputed.
+   */
+  virtual bool supports_recomputation() const { return true; }
+
+  ///@}
+  /** @name GPU graph capture */
+  ///@{
+
+  /** @brief If true, fp_compute only launches GPU work on the streams
+   *  of the layer's tensors, without host synchronization, memory
+   *  allocation or host-side state, so it can be captured into a GPU
+   *  graph and replayed.
+   */
+  virtual bool supports_graph_capture() const { return false; }
+
+  /** @brief Hash of the buffers and shapes used by fp_compute.
+   *
+   *  A captured graph is only replayed while the signatures of its
+   *  layers are unchanged.
+   */
+  virtual size_t get_fp_tensor_signature() const { return 0; }
+
+  ///@}
+  /** @name Layer fusion */
+  ///@{
+
+  /** @brief Take over the computation of @c child, one of whose
+   *  inputs is this layer's only output.
+   *
+   *  Called at setup, before layers are set up. If this returns true,
+   *  this layer now produces the child's output and the model removes
+   *  the child from the graph. The child's other inputs, if any, are
+   *  appended to this layer's inputs.
+   */
+  virtual bool fuse_child(Layer const& /*child*/) { return false; }
+
+  /** @brief Take over the computation of @c parent, this layer's
+   *  only input, whose only output is this layer.
+   *
+   *  Called at setup, before layers are set up, if @c parent could
+   *  not take over this layer. If this returns true, the model
+   *  removes the parent from the graph and this layer reads the
+   *  parent's input instead.
+   */
+  virtual bool fuse_parent(Layer const& /*parent*/) { return false; }
+
+  /** @brief Fold @c child, whose only input is this layer's only
+   *  output, into this layer's trained weights.
+   *
+   *  Called by model::compile_for_inference once the weights hold
+   *  their final values. If this returns true, this layer's output
+   *  equals the child's inference-time output and the model removes
+   *  the child from the graph.
+   */
+  virtual bool fold_child_into_weights(Layer const& /*child*/)
+  {
+    return false;
+  }
+
+  ///@}
+  /** @name Int8 inference */
+  ///@{
+
+  /** @brief Whether forward prop has an int8 implementation. */
+  virtual bool supports_int8_inference() const { return false; }
+
+  /** @brief Run forward prop with int8 arithmetic.
+   *
+   *  Each input is quantized with a single scale that maps its
+   *  calibrated range onto [-127, 127], and weights are quantized
+   *  with one scale per output channel. Products are accumulated in
+   *  int32. Back prop is unaffected, so this is meant for trained
+   *  models.
+   *
+   *  @param input_ranges Largest magnitude of each input seen during
+   *                      calibration. Empty to return to full
+   *                      precision.
+   *  @returns False, changing nothing, if the layer has no int8
+   *           implementation.
+   */
+  bool set_int8_input_ranges(std::vector<double> input_ranges);
+  std::vector<double> const& get_int8_input_ranges() const noexcept
+  {
+    return m_int8_input_ranges;
+  }
+  bool using_int8_inference() const noexcept
+  {
+    return !m_int8_input_ranges.empty();
+  }
+
+  ///@}
+  /** @name Redistribution between layers */
+  ///@{
+
+  /** @brief Bytes per sample copied to form an input tensor.
+   *
+   *  Zero if the input views the parent's output, which is the case
+   *  when both tensors have the same distribution and data type.
+   */
+  virtual size_t get_input_redistribution_bytes(int /*input_index*/) const
+  {
+    return 0;
+  }
+
+  /** @brief Whether two outputs always hold the same tensor. */
+  virtual bool outputs_alias(int output_index, int other_index) const
+  {
+    return output_index == other_index;
+  }
+
+  /** @brief Reuse a sibling's redistributed copy of an input.
+   *
+   *  @c sibling must consume the same (or an aliasing) parent output
+   *  and run earlier in the forward pass. Returns false if its copy
+   *  cannot be viewed in place of this layer's own copy.
+   */
+  virtual bool share_input_redistribution(int /*input_index*/,
+                                          Layer const& /*sibling*/)
+  {
+    return false;
+  }
+
   ///@}
 
   /** @brief Set whether to keep or dynamically reallocate error signals.
@@ -733,6 +906,33 @@ public:
    */
   virtual bool owns_activations() const = 0;
 
+  /** @brief If true, output activations or error signals may view the
+   *  layer's inputs or previous error signals instead of owning memory.
+   *
+   *  Layers that override the tensor setup functions to create views
+   *  must return true. The activation memory planner keeps a viewed
+   *  tensor live for as long as any tensor viewing it.
+   */
+  virtual bool has_tensor_views() const { return m_runs_inplace; }
+
+  /** @brief Local memory needed for a tensor the activation memory
+   *  planner may place.
+   *
+   *  @param index Child index of an output activation, or parent index
+   *               of an error signal.
+   *  @param error_signal Whether the tensor is an error signal.
+   *  @param mini_batch_size Mini-batch size to plan for.
+   *  @returns Bytes on this process, or 0 if the layer manages the
+   *           tensor itself.
+   */
+  virtual size_t
+  get_plannable_tensor_bytes(int /*index*/,
+                             bool /*error_signal*/,
+                             El::Int /*mini_batch_size*/) const
+  {
+    return 0;
+  }
+
   /** @name Serialization */
   ///@{
 
@@ -750,6 +950,20 @@ protected:
   Layer& operator=(Layer const& other);
   ///@}
 
+  /** @brief Leave a non-blocking request for the tensors' first
+   *         consumer to complete.
+   *
+   *  @see finish_pending_communication
+   */
+  void add_pending_communication(Al::request const& req);
+
+  /** @brief Work on the results of the pending communication, e.g.
+   *         unpacking a receive buffer into the outputs.
+   *
+   *  Called once the pending requests have completed.
+   */
+  virtual void finalize_pending_communication() {}
+
   /** @name Weights-related accessors */
   ///@{
   void add_weights(ViewingWeightsPtr w)
@@ -878,6 +1092,13 @@ protected:
 
   /** @brief Avoid back prop if frozen */
   bool m_frozen;
+  /** @brief Whether back prop must compute error signals. */
+  bool m_error_signals_needed = true;
+  /** @brief Non-blocking communication on the layer's tensors. */
+  std::vector<Al::request> m_pending_requests;
+  /** @brief Error signals wait for the pending communication before
+   *         being propagated to the parents. */
+  bool m_error_signals_deferred = false;
 
   /** @brief Time spent in forward propagation. */
   EvalType m_fp_time;
@@ -903,6 +1124,14 @@ protected:
    */
   bool m_runs_inplace = false;
 
+  /** @brief Recompute outputs during backprop. */
+  bool m_checkpoint = false;
+
+  /** @brief Calibrated input ranges for int8 inference.
+   *  Empty when running in full precision.
+   */
+  std::vector<double> m_int8_input_ranges;
+
   /** @name Layer parallelism */
   ///@{
 
@@ -29,12 +29,18 @@
 
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/layers/layer.hpp"
+#include "lbann/layers/learning/bias_activation.hpp"
 #ifdef LBANN_HAS_DNN_LIB
 #include "lbann/utils/dnn_lib/convolution.hpp"
 #include "lbann/utils/dnn_lib/helpers.hpp"
 #endif // LBANN_HAS_DNN_LIB
+#ifdef LBANN_HAS_ONEDNN_CPU
+#include "lbann/utils/dnn_lib/onednn/convolution.hpp"
+#endif // LBANN_HAS_ONEDNN_CPU
 #include "lbann/utils/memory.hpp"
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #ifdef LBANN_HAS_DISTCONV
@@ -119,6 +125,7 @@ public:
   const std::vector<int>& get_pads() const { return m_pads; }
   const std::vector<int>& get_strides() const { return m_strides; }
   const std::vector<int>& get_dilations() const { return m_dilations; }
+  bool is_channels_last() const noexcept { return m_channels_last; }
 
 protected:
   int m_output_channels;
@@ -144,6 +151,43 @@ protected:
    */
   ScalingType m_bias_scaling_factor;
 
+  /** @brief Whether tensors are stored in channels-last order.
+   *  @details If set, input and output dimensions are interpreted
+   *  as (spatial dims..., channels) and the kernel is stored with
+   *  the input channels as its fastest-varying dimension. Only
+   *  supported with cuDNN.
+   */
+  bool m_channels_last = false;
+
+  /** Activation child applied together with the bias. */
+  fused_activation m_fused_activation = fused_activation::NONE;
+  /** Input of the fused activation, if backprop needs it. */
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>>
+    m_fused_preactivations;
+  /** Gradient w.r.t. the input of the fused activation. */
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>>
+    m_fused_activation_gradient;
+
+  /** @brief Scale factors of a fused nearest-neighbor upsample parent.
+   *  @details Empty unless the layer has taken over its parent (see
+   *  fuse_parent). The layer input is then the upsample input and
+   *  the layer computes the equivalent transposed convolution.
+   */
+  std::vector<int> m_upsample_factors;
+  /** Pads of the transposed convolution for a fused upsample. */
+  std::vector<int> m_upsample_pads;
+  /** @brief Sums kernel entries over the windows of a fused upsample.
+   *  @details Maps a flattened spatial filter to a flattened filter
+   *  of the transposed convolution.
+   */
+  DMatDT<Device> m_upsample_window;
+  /** @brief Kernel of the transposed convolution for a fused upsample.
+   *  @details One column per input channel.
+   */
+  DMatDT<Device> m_upsample_kernel;
+  /** Gradient w.r.t. the transposed convolution kernel. */
+  DMatDT<Device> m_upsample_kernel_gradient;
+
 #ifdef LBANN_HAS_DNN_LIB
 
   /** @brief Math type to use inside DNN library.
@@ -160,7 +204,9 @@ protected:
   /** Tensor DNN library descriptors. */
   dnn_lib::data_parallel_layer_tensor_manager<TensorDataType>
     m_tensors_dnn_desc;
-  /** Forward algorithm cache (mini-batch size -> algo). */
+  /** Forward algorithm cache (mini-batch size -> algo).
+   *  @details Sizes smaller than a cached one reuse its algorithm.
+   */
   std::unordered_map<int, dnn_lib::fwd_conv_alg_config> m_fwd_dnn_algos;
   /** Backward data algorithm cache (mini-batch size -> algo). */
   std::unordered_map<int, dnn_lib::bwd_data_conv_alg_config> m_bwd_data_dnn_algos;
@@ -169,6 +215,16 @@ protected:
 
 #endif // LBANN_HAS_DNN_LIB
 
+#ifdef LBANN_HAS_ONEDNN_CPU
+  /** @brief oneDNN primitive cache (mini-batch size -> primitives).
+   *  @details Not copied with the layer.
+   */
+  std::unordered_map<
+    int,
+    std::unique_ptr<onednn::convolution_primitives<TensorDataType>>>
+    m_onednn_convolutions;
+#endif // LBANN_HAS_ONEDNN_CPU
+
 public:
   /** @todo Remove num_data_dims from arg list */
   base_convolution_layer(int num_data_dims,
@@ -190,8 +246,22 @@ public:
   void set_dnn_math_mode(dnn_lib::dnnMathType_t math_type) noexcept;
 #endif // LBANN_HAS_DNN_LIB
 
+  /** @brief Store tensors in channels-last (NHWC) order. */
+  void set_channels_last(bool channels_last) noexcept;
+
   description get_description() const override;
   void setup_dims() override;
+  bool fuse_child(Layer const& child) override;
+  /** @brief Take over a preceding nearest-neighbor upsample
+   *  (ungrouped, unit-stride, undilated, channels-first convolution
+   *  only, with pads smaller than the kernel). */
+  bool fuse_parent(Layer const& parent) override;
+  /** @brief Fold a following batch normalization into the kernel and
+   *  bias (convolution only, channels-first). */
+  bool fold_child_into_weights(Layer const& child) override;
+  /** @brief Int8 forward prop is available on CPU for ungrouped,
+   *  undilated, channels-first convolutions. */
+  bool supports_int8_inference() const override;
 
   /** @brief Setup layer data.
    *  The kernel weights are setup in the convolution and
@@ -205,7 +275,7 @@ public:
   ///@{
 
   template <typename ArchiveT>
-  void serialize(ArchiveT& ar);
+  void serialize(ArchiveT& ar, std::uint32_t const version);
 
   ///@}
 
@@ -213,6 +283,13 @@ protected:
   /** Dimensions of convolution kernel. */
   virtual std::vector<int> get_kernel_dims() const = 0;
 
+  /** @brief Permute tensor dimensions to (channels, spatial dims...).
+   *  @details No-op unless the layer is channels-last.
+   */
+  std::vector<int> to_channels_first(std::vector<int> dims) const;
+  /** @brief Inverse of @c to_channels_first. */
+  std::vector<int> from_channels_first(std::vector<int> dims) const;
+
   /** Convolution with DNN library. */
   void apply_convolution_dnn(bool during_forward_prop);
 
@@ -228,13 +305,91 @@ protected:
   /** Transposed convolution with im2col GEMM algorithm. */
   void apply_transposed_convolution_im2col(bool during_forward_prop);
 
+  /** Forward prop convolution with im2col and int8 GEMM. */
+  void apply_convolution_int8();
+
   void apply_bias_cpu();
 
+  /** Add the bias and apply the fused activation in one pass. */
+  void apply_bias_and_fused_activation();
+
   void compute_gradients_im2col(bool using_transposed_convolution);
 
+  /** @brief Convolution on CPU.
+   *  @details Uses int8 GEMM in forward prop if int8 inference is
+   *  enabled, oneDNN if it is available for this layer and im2col
+   *  GEMM otherwise.
+   */
+  void apply_convolution_cpu(bool during_forward_prop);
+  /** @brief Transposed convolution on CPU. */
+  void apply_transposed_convolution_cpu(bool during_forward_prop);
+  /** @brief Bias and kernel gradients on CPU. */
+  void compute_gradients_cpu(bool using_transposed_convolution);
+
+  void compute_bias_gradient_cpu();
+
+  /** @brief Compute the transposed convolution kernel for a fused
+   *  upsample from the current kernel weights.
+   *  @details Each entry is a sum of kernel entries over an upsample
+   *  window. Must be called before the convolution is applied.
+   */
+  void expand_upsampled_kernel();
+
 private:
+  /** @brief Kernel dimensions of the computed convolution.
+   *  @details With a fused upsample, the transposed convolution
+   *  kernel is indexed by input channel first and each spatial
+   *  dimension grows by the scale factor minus one.
+   */
+  std::vector<int> get_computed_kernel_dims() const;
+  /** Pads of the computed convolution. */
+  const std::vector<int>& get_computed_pads() const noexcept;
+  /** Strides of the computed convolution. */
+  const std::vector<int>& get_computed_strides() const noexcept;
+  /** Local kernel of the computed convolution. */
+  const El::AbstractMatrix<TensorDataType>& get_computed_kernel() const;
+
+  /** @brief Add the gradient w.r.t. the transposed convolution
+   *  kernel of a fused upsample to the kernel gradient.
+   *  @details kernel_gradient = dst_scale * kernel_gradient +
+   *  gradient_scale * (transposed convolution kernel gradient).
+   */
+  void contract_upsampled_kernel_gradient(
+    El::AbstractMatrix<TensorDataType>& kernel_gradient,
+    TensorDataType dst_scale,
+    TensorDataType gradient_scale);
+
+  /** @brief Whether the CPU path can use oneDNN primitives.
+   *  @details Requires FP32 data in channels-first layout.
+   */
+  bool using_onednn() const noexcept;
+
+#ifdef LBANN_HAS_ONEDNN_CPU
+  /** @brief Get cached primitives for the local mini-batch.
+   *  @param transposed_layer Whether the layer is a deconvolution,
+   *  i.e. the convolution source is the layer output.
+   */
+  onednn::convolution_primitives<TensorDataType>&
+  get_onednn_convolution(bool transposed_layer,
+                         int mini_batch_size,
+                         El::Int src_ldim,
+                         El::Int dst_ldim);
+
+  void apply_convolution_onednn(bool during_forward_prop);
+  void apply_transposed_convolution_onednn(bool during_forward_prop);
+  void compute_kernel_gradient_onednn(bool using_transposed_convolution);
+#endif // LBANN_HAS_ONEDNN_CPU
+
 #ifdef LBANN_HAS_DNN_LIB
 
+  /** @brief Describe a convolution problem for the algorithm cache.
+   *  @details Keys are shared by all layers and persisted across
+   *  runs, so they capture everything that affects algorithm choice.
+   */
+  std::string get_algo_cache_key(const std::string& pass,
+                                 int local_mini_batch_size,
+                                 size_t ws_size) const;
+
   /** Get the DNN library algorithm to use for forward prop. */
   dnn_lib::fwd_conv_alg_config
   get_forward_algo_dnn(const int local_mini_batch_size,
@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+
+#ifndef LBANN_LAYERS_LEARNING_BIAS_ACTIVATION_HPP_INCLUDED
+#define LBANN_LAYERS_LEARNING_BIAS_ACTIVATION_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/layers/data_type_layer.hpp"
+
+#include <memory>
+#include <utility>
+
+namespace lbann {
+
+/** @brief Activation applied by a learning layer together with its
+ *         bias.
+ */
+enum class fused_activation
+{
+  NONE,
+  RELU,
+  GELU,
+};
+
+/** @brief Activation of a layer that a parent layer can compute.
+ *
+ *  Returns fused_activation::RELU for a ReLU layer and
+ *  fused_activation::GELU for an operator layer made of a single GELU
+ *  operator, if the layer has the given data type and device.
+ *  Returns fused_activation::NONE otherwise.
+ */
+template <typename TensorDataType, El::Device Device>
+fused_activation get_fusable_activation(Layer const& l);
+
+/** @brief Add a bias and apply a ReLU in one pass over a matrix.
+ *
+ *  Used by learning layers that have taken over the computation of a
+ *  ReLU child. Entry @f$ (i,j) @f$ of @c output becomes
+ *    @f[ \max(y_{ij} + \alpha b_{\lfloor i/k \rfloor}, 0) @f]
+ *  where @f$ k @f$ is @c rows_per_bias. If @c bias is null, only the
+ *  ReLU is applied.
+ */
+template <typename TensorDataType>
+void apply_bias_relu(El::Matrix<TensorDataType, El::Device::CPU> const* bias,
+                     TensorDataType const& scale,
+                     El::Int rows_per_bias,
+                     El::Matrix<TensorDataType, El::Device::CPU>& output);
+
+/** @brief Backprop through a ReLU, given its output.
+ *
+ *  @c gradient_wrt_input may be the same matrix as
+ *  @c gradient_wrt_output.
+ */
+template <typename TensorDataType>
+void apply_relu_gradient(
+  El::Matrix<TensorDataType, El::Device::CPU> const& output,
+  El::Matrix<TensorDataType, El::Device::CPU> const& gradient_wrt_output,
+  El::Matrix<TensorDataType, El::Device::CPU>& gradient_wrt_input);
+
+/** @brief Add a bias and apply a GELU in one pass over a matrix.
+ *
+ *  Like apply_bias_relu, with the tanh approximation of GELU used by
+ *  the GELU operator. The input of the GELU is written to
+ *  @c preactivations, which must have the dimensions of @c output,
+ *  since backprop needs it.
+ */
+template <typename TensorDataType>
+void apply_bias_gelu(
+  El::Matrix<TensorDataType, El::Device::CPU> const* bias,
+  TensorDataType const& scale,
+  El::Int rows_per_bias,
+  El::Matrix<TensorDataType, El::Device::CPU>& preactivations,
+  El::Matrix<TensorDataType, El::Device::CPU>& output);
+
+/** @brief Backprop through a GELU, given its input.
+ *
+ *  @c gradient_wrt_input may be the same matrix as
+ *  @c gradient_wrt_output.
+ */
+template <typename TensorDataType>
+void apply_gelu_gradient(
+  El::Matrix<TensorDataType, El::Device::CPU> const& input,
+  El::Matrix<TensorDataType, El::Device::CPU> const& gradient_wrt_output,
+  El::Matrix<TensorDataType, El::Device::CPU>& gradient_wrt_input);
+
+/** @brief Add a bias and compute row statistics in one pass.
+ *
+ *  Used by fully-connected layers that feed an entry-wise batch
+ *  normalization. Row @f$ i @f$ of @c output becomes
+ *  @f$ y_{ij} + \alpha b_i @f$, and @c statistics, with the height of
+ *  @c output and two columns, is overwritten with the sum and the sum
+ *  of squares of each row. If @c bias is null, only the statistics
+ *  are computed.
+ */
+template <typename TensorDataType>
+void apply_bias_row_statistics(
+  El::Matrix<TensorDataType, El::Device::CPU> const* bias,
+  TensorDataType const& scale,
+  El::Matrix<TensorDataType, El::Device::CPU>& output,
+  El::Matrix<TensorDataType, El::Device::CPU>& statistics);
+
+#ifdef LBANN_HAS_GPU
+template <typename TensorDataType>
+void apply_bias_relu(El::Matrix<TensorDataType, El::Device::GPU> const* bias,
+                     TensorDataType const& scale,
+                     El::Int rows_per_bias,
+                     El::Matrix<TensorDataType, El::Device::GPU>& output);
+template <typename TensorDataType>
+void apply_bias_gelu(
+  El::Matrix<TensorDataType, El::Device::GPU> const* bias,
+  TensorDataType const& scale,
+  El::Int rows_per_bias,
+  El::Matrix<TensorDataType, El::Device::GPU>& preactivations,
+  El::Matrix<TensorDataType, El::Device::GPU>& output);
+template <typename TensorDataType>
+void apply_bias_row_statistics(
+  El::Matrix<TensorDataType, El::Device::GPU> const* bias,
+  TensorDataType const& scale,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  El::Matrix<TensorDataType, El::Device::GPU>& statistics);
+template <typename TensorDataType>
+void apply_relu_gradient(
+  El::Matrix<TensorDataType, El::Device::GPU> const& output,
+  El::Matrix<TensorDataType, El::Device::GPU> const& gradient_wrt_output,
+  El::Matrix<TensorDataType, El::Device::GPU>& gradient_wrt_input);
+template <typename TensorDataType>
+void apply_gelu_gradient(
+  El::Matrix<TensorDataType, El::Device::GPU> const& input,
+  El::Matrix<TensorDataType, El::Device::GPU> const& gradient_wrt_output,
+  El::Matrix<TensorDataType, El::Device::GPU>& gradient_wrt_input);
+#endif // LBANN_HAS_GPU
+
+/** @brief Resize @c buffer like @c mat, constructing it if needed. */
+template <typename TensorDataType>
+El::AbstractDistMatrix<TensorDataType>& get_fused_activation_buffer(
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>>& buffer,
+  El::AbstractDistMatrix<TensorDataType> const& mat)
+{
+  if (buffer == nullptr) {
+    buffer.reset(mat.Construct(mat.Grid(), mat.Root()));
+  }
+  buffer->AlignWith(mat.DistData());
+  buffer->Resize(mat.Height(), mat.Width());
+  return *buffer;
+}
+
+/** @brief Add a bias and apply a fused activation to a layer output.
+ *
+ *  @c preactivations is only used by activations that are
+ *  differentiated from their input.
+ */
+template <typename TensorDataType, El::Device Device>
+void apply_bias_activation(
+  El::Matrix<TensorDataType, Device> const* bias,
+  TensorDataType const& scale,
+  El::Int rows_per_bias,
+  fused_activation activation,
+  El::AbstractDistMatrix<TensorDataType>& output,
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>>& preactivations)
+{
+  using LocalMatrixType = El::Matrix<TensorDataType, Device>;
+  auto& local_output = static_cast<LocalMatrixType&>(output.Matrix());
+  switch (activation) {
+  case fused_activation::RELU:
+    apply_bias_relu(bias, scale, rows_per_bias, local_output);
+    break;
+  case fused_activation::GELU: {
+    auto& local_preactivations = static_cast<LocalMatrixType&>(
+      get_fused_activation_buffer(preactivations, output).Matrix());
+    apply_bias_gelu(bias,
+                    scale,
+                    rows_per_bias,
+                    local_preactivations,
+                    local_output);
+    break;
+  }
+  default:
+    LBANN_ERROR("layer has no fused activation");
+  }
+}
+
+/** @brief Backprop of a layer through its fused activation.
+ *
+ *  While the guard lives, the layer's gradient w.r.t. its output is
+ *  swapped with the gradient w.r.t. the activation's input, computed
+ *  into @c buffer. A ReLU is differentiated from the layer's output
+ *  and a GELU from @c preactivations. The layer's backprop then runs
+ *  unchanged. Does nothing if @c activation is
+ *  fused_activation::NONE.
+ */
+template <typename TensorDataType, El::Device Device>
+class fused_activation_backprop_guard
+{
+public:
+  using MatrixType = El::AbstractDistMatrix<TensorDataType>;
+  using LocalMatrixType = El::Matrix<TensorDataType, Device>;
+
+  fused_activation_backprop_guard(data_type_layer<TensorDataType>& l,
+                                  fused_activation activation,
+                                  MatrixType const* preactivations,
+                                  std::unique_ptr<MatrixType>& buffer)
+  {
+    if (activation == fused_activation::NONE) {
+      return;
+    }
+    auto& gradient_wrt_output = l.get_all_prev_error_signals().front();
+    get_fused_activation_buffer(buffer, *gradient_wrt_output);
+    auto const& local_gradient_wrt_output =
+      static_cast<LocalMatrixType const&>(gradient_wrt_output->LockedMatrix());
+    auto& local_buffer = static_cast<LocalMatrixType&>(buffer->Matrix());
+    if (activation == fused_activation::GELU) {
+      if (preactivations == nullptr) {
+        LBANN_ERROR("fused GELU in layer \"",
+                    l.get_name(),
+                    "\" has no saved inputs");
+      }
+      apply_gelu_gradient(
+        static_cast<LocalMatrixType const&>(preactivations->LockedMatrix()),
+        local_gradient_wrt_output,
+        local_buffer);
+    }
+    else {
+      apply_relu_gradient(
+        static_cast<LocalMatrixType const&>(l.get_activations().LockedMatrix()),
+        local_gradient_wrt_output,
+        local_buffer);
+    }
+    std::swap(gradient_wrt_output, buffer);
+    m_gradient_wrt_output = &gradient_wrt_output;
+    m_buffer = &buffer;
+  }
+  ~fused_activation_backprop_guard()
+  {
+    if (m_gradient_wrt_output != nullptr) {
+      std::swap(*m_gradient_wrt_output, *m_buffer);
+    }
+  }
+  fused_activation_backprop_guard(fused_activation_backprop_guard const&) =
+    delete;
+  fused_activation_backprop_guard&
+  operator=(fused_activation_backprop_guard const&) = delete;
+
+private:
+  std::unique_ptr<MatrixType>* m_gradient_wrt_output = nullptr;
+  std::unique_ptr<MatrixType>* m_buffer = nullptr;
+};
+
+#ifndef LBANN_BIAS_ACTIVATION_INSTANTIATE
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template fused_activation get_fusable_activation<T, Device>(          \
+    Layer const&);                                                             \
+  extern template void apply_bias_relu(El::Matrix<T, Device> const*,           \
+                                       T const&,                               \
+                                       El::Int,                                \
+                                       El::Matrix<T, Device>&);                \
+  extern template void apply_bias_gelu(El::Matrix<T, Device> const*,           \
+                                       T const&,                               \
+                                       El::Int,                                \
+                                       El::Matrix<T, Device>&,                 \
+                                       El::Matrix<T, Device>&);                \
+  extern template void apply_bias_row_statistics(El::Matrix<T, Device> const*, \
+                                                 T const&,                     \
+                                                 El::Matrix<T, Device>&,       \
+                                                 El::Matrix<T, Device>&);      \
+  extern template void apply_relu_gradient(El::Matrix<T, Device> const&,       \
+                                           El::Matrix<T, Device> const&,       \
+                                           El::Matrix<T, Device>&);            \
+  extern template void apply_gelu_gradient(El::Matrix<T, Device> const&,       \
+                                           El::Matrix<T, Device> const&,       \
+                                           El::Matrix<T, Device>&)
+
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
+#endif // LBANN_BIAS_ACTIVATION_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LEARNING_BIAS_ACTIVATION_HPP_INCLUDED
@@ -34,6 +34,21 @@
 #endif
 namespace lbann {
 
+/** @brief Split of a channel-wise fully-connected linearity
+ *
+ *  Only used with Distconv. The features are split across the
+ *  processes in the width dimension of the layer's parallel strategy.
+ */
+enum class fc_tensor_parallelism
+{
+  /** Each process applies the full linearity */
+  NONE,
+  /** Each process computes a block of the output features */
+  COLUMN,
+  /** Each process consumes a block of the input features */
+  ROW
+};
+
 #ifdef LBANN_HAS_DISTCONV
 namespace dc {
 template <typename TensorDataType>
@@ -65,12 +80,17 @@ public:
 
   dc::Shape get_activations_local_shape(int index = 0) const override;
 
+  /** Sum partial results across the tensor-parallel process group */
+  void allreduce_partial_sums(TensorDevType& tensor);
+
   std::unique_ptr<dc::ChannelwiseFullyConnected<TensorDataType>>
     m_linear_operator;
   std::unique_ptr<TensorDevType> m_linear;
   std::unique_ptr<TensorDevType> m_bias;
   std::unique_ptr<TensorDevType> m_linearity_gradient;
   std::unique_ptr<TensorDevType> m_bias_gradient;
+  /** Processes that share the linearity under tensor parallelism */
+  std::unique_ptr<El::mpi::Comm> m_tensor_parallel_comm;
 }; // class definition channelwise_fully_connected_distconv_adapter
 
 #endif // LBANN_HAS_DISTCONV
@@ -100,10 +120,14 @@ public:
    *  @param bias                   Whether to apply bias.
    *  @param transpose              Whether to apply transpose of
    *                                weights matrix.
+   *  @param tensor_parallelism     How the linearity is split across
+   *                                processes with Distconv.
    */
-  channelwise_fully_connected_layer(std::vector<size_t> output_channel_dims,
-                                    bool bias,
-                                    bool transpose);
+  channelwise_fully_connected_layer(
+    std::vector<size_t> output_channel_dims,
+    bool bias,
+    bool transpose,
+    fc_tensor_parallelism tensor_parallelism = fc_tensor_parallelism::NONE);
 
   channelwise_fully_connected_layer(
     const channelwise_fully_connected_layer& other) = default;
@@ -133,6 +157,10 @@ public:
 
   bool transpose() const noexcept { return m_transpose; }
   bool has_bias() const noexcept { return m_has_bias; }
+  fc_tensor_parallelism tensor_parallelism() const noexcept
+  {
+    return m_tensor_parallelism;
+  }
 
 protected:
   /** Add layer specific data to prototext */
@@ -170,6 +198,8 @@ private:
   bool m_has_bias;
   /** Whether to transpose linearity. */
   bool m_transpose;
+  /** How the linearity is split across processes. */
+  fc_tensor_parallelism m_tensor_parallelism;
 
   template <typename U, El::Device D>
   friend void
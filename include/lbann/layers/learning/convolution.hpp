@@ -107,7 +107,11 @@ public:
 
   int get_backprop_requirements() const override
   {
-    return ERROR_SIGNALS | WEIGHTS | PREV_ACTIVATIONS;
+    // A fused ReLU is differentiated from the layer's output
+    const bool fused_relu =
+      (this->m_fused_activation == fused_activation::RELU);
+    return ERROR_SIGNALS | WEIGHTS | PREV_ACTIVATIONS |
+           (fused_relu ? ACTIVATIONS : 0);
   }
 
 #ifdef LBANN_HAS_ONNX
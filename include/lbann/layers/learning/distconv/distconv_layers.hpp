@@ -31,6 +31,8 @@
 #include "distconv/tensor/tensor_mpi.hpp"
 #include "lbann/utils/distconv.hpp"
 
+#include <utility>
+
 #ifdef LBANN_HAS_DISTCONV
 namespace distconv {
 template <typename Backend, typename DataType>
@@ -41,6 +43,23 @@ class ChannelwiseFullyConnected
 public:
   ChannelwiseFullyConnected(Backend& backend) : m_be(backend){};
 
+  /** @brief Restrict this process to a block of the linearity.
+   *
+   *  With tensor parallelism, the features are split across
+   *  @c num_blocks processes. If @c split_output is true, each
+   *  process computes a block of the output features from the full
+   *  input (column parallelism). Otherwise, each process computes
+   *  partial sums of all output features from a block of the input
+   *  features (row parallelism) and the caller must sum them across
+   *  processes before applying bias.
+   */
+  void set_linearity_block(bool split_output, int block_index, int num_blocks)
+  {
+    m_split_output = split_output;
+    m_block_index = block_index;
+    m_num_blocks = num_blocks;
+  }
+
   template <typename Allocator>
   int forward(
     bool transpose_A,
@@ -78,6 +97,23 @@ public:
 
 protected:
   Backend& m_be;
+
+private:
+  /** Height and width of the full linearity matrix */
+  std::pair<El::Int, El::Int>
+  get_linearity_dims(bool transpose_A,
+                     El::Int local_input_size,
+                     El::Int local_output_size) const;
+  /** Rows and columns of the linearity used by this process */
+  std::pair<El::IR, El::IR>
+  get_linearity_block(bool transpose_A, El::Int height, El::Int width) const;
+
+  /** Whether output features are split across processes */
+  bool m_split_output = false;
+  /** Block of the linearity used by this process */
+  int m_block_index = 0;
+  /** Number of processes sharing the linearity */
+  int m_num_blocks = 1;
 }; // class definition ChannelwiseFullyConnected
 
 template <typename DataType, typename locale, typename Allocator>
@@ -28,7 +28,9 @@
 #define LBANN_LAYERS_LEARNING_EMBEDDING_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/layers/learning/embedding_hash.hpp"
 #include "lbann/models/model.hpp"
+#include "lbann/optimizers/sparse_gradient.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/layers.pb.h"
 #include "lbann/utils/memory.hpp"
@@ -78,10 +80,18 @@ public:
    *                        vector is initialized with zeros. The
    *                        objective function gradient w.r.t. this
    *                        embedding vector is always zero.
+   *  @param sparse_gradient Pass the optimizer a column-sparse
+   *                        gradient with only the embedding vectors
+   *                        that were looked up, if it supports it.
+   *  @param hash_inputs    Hash input IDs to embedding vectors
+   *                        instead of using them as indices (see
+   *                        @c embedding_hash::get_row).
    */
   embedding_layer(size_t num_embeddings,
                   size_t embedding_dim,
-                  El::Int padding_idx = -1);
+                  El::Int padding_idx = -1,
+                  bool sparse_gradient = false,
+                  bool hash_inputs = false);
 
   embedding_layer(const embedding_layer& other);
   embedding_layer& operator=(const embedding_layer& other);
@@ -120,6 +130,18 @@ protected:
   void fp_compute() override;
   void bp_compute() override;
 
+  /** @brief Add the gradient w.r.t. the embeddings to @c opt as a
+   *         column-sparse contribution.
+   *  @return false, without side effects, if a dense gradient is
+   *          needed instead.
+   */
+  bool bp_compute_sparse(optimizer& opt);
+
+  /** @brief Embedding vector looked up by an input entry.
+   *  @return Out-of-range if the entry has no embedding vector.
+   */
+  El::Int get_lookup_index(TensorDataType x) const;
+
 private:
   /** Size of dictionary of embeddings. */
   size_t m_num_embeddings;
@@ -130,6 +152,10 @@ private:
    *  gradient w.r.t. this embedding vector is always zero.
    */
   El::Int m_padding_idx;
+  /** Whether to pass the optimizer a column-sparse gradient. */
+  bool m_sparse_gradient;
+  /** Whether to hash input IDs to embedding vectors. */
+  bool m_hash_inputs;
 };
 
 // =========================================================
@@ -145,17 +171,23 @@ void embedding_layer<T, L, D>::write_specific_proto(
   msg->set_num_embeddings(m_num_embeddings);
   msg->set_embedding_dim(m_embedding_dim);
   msg->mutable_padding_idx()->set_value(m_padding_idx);
+  msg->set_sparse_gradient(m_sparse_gradient);
+  msg->set_hash_inputs(m_hash_inputs);
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 embedding_layer<TensorDataType, Layout, Device>::embedding_layer(
   size_t num_embeddings,
   size_t embedding_dim,
-  El::Int padding_idx)
+  El::Int padding_idx,
+  bool sparse_gradient,
+  bool hash_inputs)
   : data_type_layer<TensorDataType>(nullptr),
     m_num_embeddings{num_embeddings},
     m_embedding_dim{embedding_dim},
-    m_padding_idx{padding_idx}
+    m_padding_idx{padding_idx},
+    m_sparse_gradient{sparse_gradient},
+    m_hash_inputs{hash_inputs}
 {}
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -169,7 +201,9 @@ embedding_layer<TensorDataType, Layout, Device>::embedding_layer(
   : data_type_layer<TensorDataType>(other),
     m_num_embeddings{other.m_num_embeddings},
     m_embedding_dim{other.m_embedding_dim},
-    m_padding_idx{other.m_padding_idx}
+    m_padding_idx{other.m_padding_idx},
+    m_sparse_gradient{other.m_sparse_gradient},
+    m_hash_inputs{other.m_hash_inputs}
 {}
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -181,6 +215,8 @@ embedding_layer<TensorDataType, Layout, Device>::operator=(
   m_num_embeddings = other.m_num_embeddings;
   m_embedding_dim = other.m_embedding_dim;
   m_padding_idx = other.m_padding_idx;
+  m_sparse_gradient = other.m_sparse_gradient;
+  m_hash_inputs = other.m_hash_inputs;
   return *this;
 }
 
@@ -219,6 +255,8 @@ embedding_layer<TensorDataType, Layout, Device>::get_description() const
   desc.add("Num embeddings", m_num_embeddings);
   desc.add("Embedding dim", m_embedding_dim);
   desc.add("Padding index", m_padding_idx);
+  desc.add("Sparse gradient", m_sparse_gradient);
+  desc.add("Hash inputs", m_hash_inputs);
   return desc;
 }
 
@@ -226,6 +264,12 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void embedding_layer<TensorDataType, Layout, Device>::setup_dims()
 {
   data_type_layer<TensorDataType>::setup_dims();
+  if (m_hash_inputs && m_num_embeddings == 0) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" hashes inputs, but has no embeddings");
+  }
   auto dims = this->get_input_dims();
   dims.push_back(static_cast<int>(m_embedding_dim));
   this->set_output_dims(dims);
@@ -323,6 +367,74 @@ void embedding_layer<TensorDataType, Layout, Device>::setup_data(
   }
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool embedding_layer<TensorDataType, Layout, Device>::bp_compute_sparse(
+  optimizer& opt)
+{
+  if (!m_sparse_gradient) {
+    return false;
+  }
+  auto* dt_opt = dynamic_cast<OptimizerType*>(&opt);
+  if (dt_opt == nullptr ||
+      !sparse_gradient::is_supported(*this->m_model, *dt_opt)) {
+    return false;
+  }
+
+  // Indices on host
+  El::Matrix<TensorDataType, El::Device::CPU> local_input;
+  El::Copy(this->get_local_prev_activations(), local_input);
+  const El::Int input_size = this->get_input_size();
+  const El::Int local_mini_batch_size = local_input.Width();
+
+  // Map each lookup to a column of the compact gradient
+  // Note: Don't update gradient for padding index
+  std::vector<El::Int> lookups(input_size * local_mini_batch_size, -1);
+  for (El::Int j = 0; j < local_mini_batch_size; ++j) {
+    for (El::Int i = 0; i < input_size; ++i) {
+      const El::Int ind = get_lookup_index(local_input(i, j));
+      if (0 <= ind && ind < static_cast<El::Int>(m_num_embeddings) &&
+          ind != m_padding_idx) {
+        lookups[i + j * input_size] = ind;
+      }
+    }
+  }
+  std::vector<El::Int> rows, positions;
+  sparse_gradient::coalesce(lookups, rows, positions);
+
+  // View output grad as one column per lookup
+  using MatType = El::Matrix<TensorDataType, Device>;
+  const auto* local_output_grad =
+    &static_cast<const MatType&>(this->get_local_prev_error_signals());
+  MatType contiguous_output_grad;
+  if (!local_output_grad->Contiguous()) {
+    El::Copy(*local_output_grad, contiguous_output_grad);
+    local_output_grad = &contiguous_output_grad;
+  }
+  MatType output_grad;
+  output_grad.SetSyncInfo(El::SyncInfoFromMatrix(*local_output_grad));
+  output_grad.LockedAttach(m_embedding_dim,
+                           input_size * local_mini_batch_size,
+                           local_output_grad->LockedBuffer(),
+                           m_embedding_dim);
+  MatType compact_grad;
+  compact_grad.SetSyncInfo(El::SyncInfoFromMatrix(output_grad));
+  El::Zeros(compact_grad, m_embedding_dim, rows.size());
+  sparse_gradient::scatter_add_columns(output_grad, positions, compact_grad);
+  dt_opt->add_to_sparse_gradient(rows, compact_grad);
+  return true;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+El::Int embedding_layer<TensorDataType, Layout, Device>::get_lookup_index(
+  TensorDataType x) const
+{
+  const El::Int ind = static_cast<El::Int>(std::floor(x));
+  if (m_hash_inputs) {
+    return embedding_hash::get_row(ind, m_num_embeddings);
+  }
+  return ind;
+}
+
 LBANN_DEFINE_LAYER_BUILDER(embedding);
 
 #ifndef LBANN_EMBEDDING_LAYER_INSTANTIATE
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_LEARNING_EMBEDDING_HASH_HPP_INCLUDED
+#define LBANN_LAYERS_LEARNING_EMBEDDING_HASH_HPP_INCLUDED
+
+#include "lbann/utils/hash.hpp"
+
+#include <cstdint>
+
+#if defined __CUDACC__ || defined __HIPCC__
+#define LBANN_EMBEDDING_HASH_FUNC __host__ __device__ __forceinline__
+#else
+#define LBANN_EMBEDDING_HASH_FUNC inline
+#endif // __CUDACC__ || __HIPCC__
+
+namespace lbann {
+
+/** @brief Hashing trick for embedding lookups
+ *
+ *  Categorical IDs from a large or open vocabulary are hashed
+ *  directly to rows of the embedding table. This replaces a hash,
+ *  one-hot and fully-connected pipeline without materializing
+ *  one-hot vectors of vocabulary width.
+ */
+namespace embedding_hash {
+
+/** @brief Embedding row for a categorical ID
+ *
+ *  Mixes the ID with the SplitMix64 finalizer and reduces it modulo
+ *  the number of embeddings. Host and device give the same row.
+ */
+LBANN_EMBEDDING_HASH_FUNC int64_t get_row(int64_t id, int64_t num_embeddings)
+{
+  const uint64_t x = splitmix64(static_cast<uint64_t>(id));
+  return static_cast<int64_t>(x % static_cast<uint64_t>(num_embeddings));
+}
+
+} // namespace embedding_hash
+} // namespace lbann
+
+#undef LBANN_EMBEDDING_HASH_FUNC
+
+#endif // LBANN_LAYERS_LEARNING_EMBEDDING_HASH_HPP_INCLUDED
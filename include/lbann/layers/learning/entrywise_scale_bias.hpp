@@ -101,6 +101,15 @@ public:
 
   void setup_data(size_t max_mini_batch_size) override;
 
+  /** @brief Per-entry map, y = scale*x + shift.
+   *
+   *  Returns false for model-parallel layers, whose weights are
+   *  distributed.
+   */
+  bool get_inference_affine(El::Matrix<TensorDataType, El::Device::CPU>& scale,
+                            El::Matrix<TensorDataType, El::Device::CPU>& shift)
+    const;
+
 protected:
   /** Add layer specific data to prototext */
   void write_specific_proto(lbann_data::Layer& proto) const final;
@@ -200,8 +209,42 @@ void entrywise_scale_bias_layer<TensorDataType, Layout, Dev>::setup_data(
   m_weights_gradient->Resize(output_size, 2);
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Dev>
+bool entrywise_scale_bias_layer<TensorDataType, Layout, Dev>::
+  get_inference_affine(El::Matrix<TensorDataType, El::Device::CPU>& scale,
+                       El::Matrix<TensorDataType, El::Device::CPU>& shift) const
+{
+  if (Layout != data_layout::DATA_PARALLEL || this->num_weights() != 1) {
+    return false;
+  }
+  El::Matrix<TensorDataType, El::Device::CPU> values;
+  El::Copy(this->weights_values(0).LockedMatrix(), values);
+  El::Copy(values(El::ALL, El::IR(0)), scale);
+  El::Copy(values(El::ALL, El::IR(1)), shift);
+  return true;
+}
+
 LBANN_DEFINE_LAYER_BUILDER(entrywise_scale_bias);
 
+/** @brief Inference-time affine map of an entry-wise scale/bias layer.
+ *
+ *  Helper for layers that fold an entry-wise scale/bias child into
+ *  their weights (see Layer::fold_child_into_weights).
+ *
+ *  @returns False if @c l is not a data-parallel entry-wise scale/bias
+ *           layer of type @c T on device @c D.
+ */
+template <typename T, El::Device D>
+bool get_entrywise_scale_bias_affine(Layer const& l,
+                                     El::Matrix<T, El::Device::CPU>& scale,
+                                     El::Matrix<T, El::Device::CPU>& shift)
+{
+  using LayerType =
+    entrywise_scale_bias_layer<T, data_layout::DATA_PARALLEL, D>;
+  auto const* layer = dynamic_cast<LayerType const*>(&l);
+  return layer != nullptr && layer->get_inference_affine(scale, shift);
+}
+
 #ifndef LBANN_ENTRYWISE_SCALE_BIAS_LAYER_INSTANTIATE
 
 #define PROTO_DEVICE(T, Device)                                                \
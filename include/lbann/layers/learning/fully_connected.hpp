@@ -28,8 +28,10 @@
 #define LBANN_LAYERS_LEARNING_FULLY_CONNECTED_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/layers/learning/bias_activation.hpp"
 #include "lbann/models/model.hpp"
 
+#include <memory>
 #include <string>
 
 namespace lbann {
@@ -94,8 +96,37 @@ public:
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override
   {
-    return ERROR_SIGNALS | WEIGHTS | PREV_ACTIVATIONS;
+    // A fused ReLU is differentiated from the layer's output
+    return ERROR_SIGNALS | WEIGHTS | PREV_ACTIVATIONS |
+           (m_fused_activation == fused_activation::RELU ? ACTIVATIONS : 0);
   }
+  bool fuse_child(Layer const& child) override;
+  /** @brief Fold a following batch normalization, entry-wise batch
+   *  normalization or entry-wise scale/bias into the linearity and
+   *  bias (replicated weights only). */
+  bool fold_child_into_weights(Layer const& child) override;
+  /** @brief Compute the row sums and sums of squares of the output
+   *  while applying the bias during training.
+   *
+   *  Set up by a child entry-wise batch normalization layer that
+   *  takes its mini-batch statistics from this layer's output, so
+   *  that the output is read once for both. @c statistics, which the
+   *  child owns, is resized to the output height with two columns.
+   *  Only applies to data-parallel layers without a fused activation.
+   *  Pass null to stop.
+   */
+  void set_output_statistics(AbsDistMatrixType* statistics) noexcept
+  {
+    m_output_statistics = statistics;
+  }
+  /** @brief Activation applied together with the bias. */
+  fused_activation get_fused_activation() const noexcept
+  {
+    return m_fused_activation;
+  }
+  /** @brief Int8 forward prop is available for data-parallel CPU
+   *  layers. */
+  bool supports_int8_inference() const override;
 
 #ifdef LBANN_HAS_ONNX
   void fill_onnx_node(onnx::GraphProto& graph) const override;
@@ -107,7 +138,7 @@ public:
   ///@{
 
   template <typename ArchiveT>
-  void serialize(ArchiveT& ar);
+  void serialize(ArchiveT& ar, std::uint32_t const version);
 
   ///@}
 
@@ -138,6 +169,20 @@ private:
   /** Whether the transpose of the linearity matrix is applied. */
   bool m_transpose;
 
+  /** Activation child applied together with the bias. */
+  fused_activation m_fused_activation = fused_activation::NONE;
+  /** Input of the fused activation, if backprop needs it. */
+  std::unique_ptr<AbsDistMatrixType> m_fused_preactivations;
+  /** Gradient w.r.t. the input of the fused activation. */
+  std::unique_ptr<AbsDistMatrixType> m_fused_activation_gradient;
+
+  /** Row statistics of the output, owned by the child layer. Not
+   *  copied, since the child sets it up again. */
+  AbsDistMatrixType* m_output_statistics = nullptr;
+
+  /** Whether forward prop computes the output statistics. */
+  bool computes_output_statistics() const;
+
   /** Deallocate distributed matrices. */
   void deallocate_matrices()
   {
@@ -55,7 +55,9 @@ namespace lbann {
  *  "hh_bias" ( @f$ 3 \text{hidden\_size} @f$ ).
  *
  *  Support is experimental and requires either cuDNN (on GPU) or
- *  oneDNN (on CPU).
+ *  oneDNN (on CPU). On GPU, cells with a small hidden size run with
+ *  fused kernels that keep the recurrent weights in shared memory
+ *  instead of calling cuDNN.
  *
  *  @todo Support bidirectional RNNs
  */
@@ -97,6 +99,17 @@ public:
   size_t get_num_layers() const { return m_num_layers; }
   const hydrogen::simple_buffer<El::byte, Device>& get_reserve_space() const;
 
+  /** @brief Allow fused kernels for small hidden sizes
+   *  @details Enabled by default. Needed when the cuDNN reserve
+   *           space is used outside the layer.
+   */
+  void set_fused_kernels_enabled(bool enabled)
+  {
+    m_fused_kernels_enabled = enabled;
+  }
+  /** @brief Whether forward and back prop run with fused kernels */
+  bool uses_fused_kernels() const;
+
 protected:
   /** Add layer specific data to prototext */
   void write_specific_proto(lbann_data::Layer& proto) const final;
@@ -115,6 +128,8 @@ private:
   size_t m_hidden_size;
   /** @brief Number of stacked GRU cells */
   size_t m_num_layers;
+  /** @brief Whether fused kernels may be used */
+  bool m_fused_kernels_enabled = true;
 
 #ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   /** @name oneDNN CPU implementation */
@@ -217,6 +232,38 @@ private:
   /** @brief Setup cuDNN implementation */
   void setup_cudnn();
 
+  ///@}
+  /** @name Fused kernel implementation */
+  ///@{
+
+  /** @brief Workspaces used in fused kernel implementation
+   *  @details Sequences are stored as
+   *           @f$ \text{size}\times(\text{mini\_batch\_size}
+   *           \cdot\text{sequence\_length}) @f$ matrices.
+   */
+  struct FusedObjects
+  {
+    using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+
+    /** @brief Contiguous copy of a non-contiguous input sequence */
+    LocalMat input_sequence_workspace;
+    /** @brief Contiguous copy of a non-contiguous output gradient */
+    LocalMat output_sequence_grad_workspace;
+    /** @brief Input projections of gates, or their gradients */
+    LocalMat input_gates_workspace;
+    /** @brief Gradients w.r.t. recurrent projections of gates */
+    LocalMat hh_gates_grad_workspace;
+    /** @brief Gradient w.r.t. input sequence of current cell */
+    LocalMat input_sequence_grad_workspace;
+    /** @brief Output sequence of each cell */
+    std::vector<LocalMat> output_sequence_workspaces;
+    /** @brief Forward prop intermediates of each cell */
+    std::vector<LocalMat> reserve_workspaces;
+  };
+
+  /** @brief Storage for fused kernel workspaces */
+  std::unique_ptr<FusedObjects> m_fused_objects;
+
   ///@}
 #endif // LBANN_GRU_LAYER_CUDNN_SUPPORTED
 
@@ -224,6 +271,10 @@ private:
   friend void fp_compute_impl(gru_layer<T, Layout, Device>&);
   template <typename T>
   friend void bp_compute_impl(gru_layer<T, Layout, Device>&);
+  template <typename T>
+  friend void fp_compute_fused_impl(gru_layer<T, Layout, Device>&);
+  template <typename T>
+  friend void bp_compute_fused_impl(gru_layer<T, Layout, Device>&);
 };
 
 // Builder function
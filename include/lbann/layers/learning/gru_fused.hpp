@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_LEARNING_GRU_FUSED_HPP_INCLUDED
+#define LBANN_LAYERS_LEARNING_GRU_FUSED_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+namespace lbann {
+
+/** @brief Fused GPU kernels for GRU cells with small hidden states.
+ *
+ *  With a small hidden size, the cuDNN GRU is dominated by kernel
+ *  launches and by re-reading the recurrent weights at every time
+ *  step. The input projections of a whole sequence are independent,
+ *  so they are computed with one GEMM per cell. The recurrence is
+ *  then run by a persistent kernel with one thread block per
+ *  sequence that keeps "hh_matrix" in shared memory for all time
+ *  steps.
+ *
+ *  Sequences are stored as @f$ \text{size}\times(\text{mini\_batch\_size}
+ *  \cdot\text{sequence\_length}) @f$ matrices with the time step
+ *  varying fastest, which matches the layer's input and output
+ *  tensors. Gates are ordered as reset, update, new, like the
+ *  layer's weights.
+ */
+namespace gru_fused {
+
+/** @brief Largest hidden size handled by the fused kernels */
+constexpr size_t max_hidden_size = 64;
+
+/** @brief Number of rows in the forward prop reserve space
+ *  @details Each time step stores the reset, update, and new gates,
+ *           the recurrent part of the new gate, and the previous
+ *           hidden state.
+ */
+constexpr size_t reserve_rows_per_hidden = 5;
+
+/** @brief Whether the fused kernels can run a GRU cell
+ *  @details The recurrent weights must fit in shared memory.
+ */
+template <typename TensorDataType>
+bool is_supported(size_t hidden_size);
+
+/** @brief Forward prop recurrence of one GRU cell
+ *
+ *  @param input_gates   @f$ W_{ih} x_t @f$ without bias
+ *                       (3 hidden_size x mini_batch_size*sequence_length)
+ *  @param init_hidden   hidden_size x mini_batch_size
+ *  @param output        Hidden states
+ *                       (hidden_size x mini_batch_size*sequence_length)
+ *  @param reserve       Intermediate values for back prop
+ *                       (reserve_rows_per_hidden hidden_size x
+ *                       mini_batch_size*sequence_length)
+ */
+template <typename TensorDataType>
+void fp_recurrence(
+  size_t sequence_length,
+  El::Matrix<TensorDataType, El::Device::GPU> const& hh_matrix,
+  El::Matrix<TensorDataType, El::Device::GPU> const& ih_bias,
+  El::Matrix<TensorDataType, El::Device::GPU> const& hh_bias,
+  El::Matrix<TensorDataType, El::Device::GPU> const& input_gates,
+  El::Matrix<TensorDataType, El::Device::GPU> const& init_hidden,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  El::Matrix<TensorDataType, El::Device::GPU>& reserve);
+
+/** @brief Back prop recurrence of one GRU cell
+ *
+ *  @param output_grad      Gradient w.r.t. hidden states
+ *                          (hidden_size x
+ *                          mini_batch_size*sequence_length)
+ *  @param input_gates_grad Gradient w.r.t. @f$ W_{ih} x_t + b_{ih} @f$
+ *                          (3 hidden_size x
+ *                          mini_batch_size*sequence_length)
+ *  @param hh_gates_grad    Gradient w.r.t. @f$ W_{hh} h_{t-1} + b_{hh} @f$
+ *                          (3 hidden_size x
+ *                          mini_batch_size*sequence_length)
+ *  @param init_hidden_grad hidden_size x mini_batch_size
+ */
+template <typename TensorDataType>
+void bp_recurrence(
+  size_t sequence_length,
+  El::Matrix<TensorDataType, El::Device::GPU> const& hh_matrix,
+  El::Matrix<TensorDataType, El::Device::GPU> const& reserve,
+  El::Matrix<TensorDataType, El::Device::GPU> const& output_grad,
+  El::Matrix<TensorDataType, El::Device::GPU>& input_gates_grad,
+  El::Matrix<TensorDataType, El::Device::GPU>& hh_gates_grad,
+  El::Matrix<TensorDataType, El::Device::GPU>& init_hidden_grad);
+
+} // namespace gru_fused
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LEARNING_GRU_FUSED_HPP_INCLUDED
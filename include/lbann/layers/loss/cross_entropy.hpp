@@ -72,6 +72,12 @@ public:
  *  Given a predicted distribution @f$y@f$ and ground truth
  *  distribution @f$\hat{y}@f$,
  *  @f[ CE(y,\hat{y}) = - \sum\limits_{i} \hat{y}_i \log y_i @f]
+ *
+ *  If @c from_logits is set, the first input holds logits and the
+ *  predicted distribution is their softmax over the last tensor
+ *  dimension. The loss is computed with a log-sum-exp reduction and
+ *  the softmax is never stored, which is cheaper and more accurate
+ *  than a separate softmax layer for large vocabularies.
  */
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 class cross_entropy_layer : public data_type_layer<TensorDataType>
@@ -86,23 +92,36 @@ public:
   ///@}
 
 public:
-  cross_entropy_layer(lbann_comm* comm, bool use_labels)
-    : data_type_layer<TensorDataType>(comm), m_use_labels(use_labels)
+  cross_entropy_layer(lbann_comm* comm,
+                      bool use_labels,
+                      bool from_logits = false)
+    : data_type_layer<TensorDataType>(comm),
+      m_use_labels(use_labels),
+      m_from_logits(from_logits)
   {
     this->m_expected_num_parent_layers = 2;
   }
 
   cross_entropy_layer(const cross_entropy_layer& other)
-    : data_type_layer<TensorDataType>(other), m_use_labels(other.m_use_labels)
+    : data_type_layer<TensorDataType>(other),
+      m_use_labels(other.m_use_labels),
+      m_from_logits(other.m_from_logits)
   {
     m_workspace.reset(other.m_workspace ? other.m_workspace->Copy() : nullptr);
+    m_logits_statistics.reset(other.m_logits_statistics
+                                ? other.m_logits_statistics->Copy()
+                                : nullptr);
   }
 
   cross_entropy_layer& operator=(const cross_entropy_layer& other)
   {
     data_type_layer<TensorDataType>::operator=(other);
     m_use_labels = other.m_use_labels;
+    m_from_logits = other.m_from_logits;
     m_workspace.reset(other.m_workspace ? other.m_workspace->Copy() : nullptr);
+    m_logits_statistics.reset(other.m_logits_statistics
+                                ? other.m_logits_statistics->Copy()
+                                : nullptr);
     return *this;
   }
 
@@ -155,9 +174,17 @@ private:
 
   /** Use interger label tensors as ground-truth. */
   bool m_use_labels;
+  /** Interpret the first input as logits. */
+  bool m_from_logits;
 
   /** Workspace matrix. */
   std::unique_ptr<AbsDistMatrixType> m_workspace;
+  /** @brief Statistics of logits, computed in forward prop.
+   *
+   *  Two rows per softmax: the log-sum-exp of the logits and the sum
+   *  of the ground truth.
+   */
+  std::unique_ptr<AbsDistMatrixType> m_logits_statistics;
 
 #ifdef LBANN_HAS_DISTCONV
   friend class cross_entropy_distconv_adapter<TensorDataType, T_layout, Dev>;
@@ -165,7 +192,8 @@ private:
 protected:
   bool is_distconv_supported() const override
   {
-    return Dev == El::Device::GPU && T_layout == data_layout::DATA_PARALLEL;
+    return Dev == El::Device::GPU && T_layout == data_layout::DATA_PARALLEL &&
+           !m_from_logits;
   }
 
   void setup_distconv_adapter() override
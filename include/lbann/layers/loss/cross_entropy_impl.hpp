@@ -42,6 +42,21 @@ void cross_entropy_layer<TensorDataType, T_layout, Dev>::setup_dims()
   data_type_layer<TensorDataType>::setup_dims();
   this->set_output_dims({1});
 
+  if (m_from_logits) {
+    if (m_use_labels) {
+      LBANN_ERROR(get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" does not support from_logits with use_labels");
+    }
+    if (T_layout != data_layout::DATA_PARALLEL) {
+      LBANN_ERROR(get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" only supports from_logits in data-parallel layout");
+    }
+  }
+
 #ifdef LBANN_HAS_DISTCONV
   // In the current implementation of cross entropy in Distconv, we
   // do not use the reshape layer and just assumes both inputs have
@@ -179,6 +194,13 @@ void cross_entropy_layer<TensorDataType, T_layout, Dev>::setup_data(
     m_workspace->Matrix().SetMemoryMode(1); // CUB memory pool
   }
 #endif // HYDROGEN_HAVE_CUB
+
+  // Initialize logits statistics
+  if (m_from_logits) {
+    m_logits_statistics.reset(
+      new StarVCMatDT<TensorDataType, Dev>(prediction.Grid(),
+                                           prediction.Root()));
+  }
 }
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -197,6 +219,12 @@ void cross_entropy_layer<TensorDataType, T_layout, Dev>::fp_compute()
   const auto& prediction = this->get_prev_activations(0);
   m_workspace->AlignWith(prediction.DistData());
   m_workspace->Resize(1, prediction.Width());
+  if (m_from_logits) {
+    const auto& input_dims = this->get_input_dims(0);
+    const auto num_softmaxes = prediction.Height() / input_dims.back();
+    m_logits_statistics->AlignWith(prediction.DistData());
+    m_logits_statistics->Resize(2 * num_softmaxes, prediction.Width());
+  }
 
   // Compute local contributions and accumulate
   /// @todo Consider reduce rather than allreduce
@@ -232,6 +260,7 @@ void cross_entropy_layer<T, L, D>::write_specific_proto(
   proto.set_datatype(proto::ProtoDataType<T>);
   auto* msg = proto.mutable_cross_entropy();
   msg->set_use_labels(m_use_labels);
+  msg->set_from_logits(m_from_logits);
 }
 
 #ifdef LBANN_HAS_ONNX
@@ -239,15 +268,21 @@ template <typename T, data_layout L, El::Device D>
 void cross_entropy_layer<T, L, D>::fill_onnx_node(onnx::GraphProto& graph) const
 {
   auto const parents = this->get_parent_layers();
-  // z = Log(input=x)
+  // z = Log(input=x), or z = LogSoftmax(input=x) for logits
   auto* log = graph.add_node();
   size_t idx = parents[0]->find_child_layer_index(*this);
   log->add_input(parents[0]->get_name() + "_" + std::to_string(idx));
   log->add_output(this->get_name() + "_log");
   log->set_name(this->get_name() + "_log");
-  log->set_op_type("Log");
+  log->set_op_type(m_from_logits ? "LogSoftmax" : "Log");
   log->set_domain("");
   log->set_doc_string("Log node for Cross Entropy Layer");
+  if (m_from_logits) {
+    auto* axis = log->add_attribute();
+    axis->set_name("axis");
+    axis->set_type(onnx::AttributeProto::INT);
+    axis->set_i(-1);
+  }
 
   // z = Mul(A=y, B=z)
   auto* mul = graph.add_node();
@@ -29,5 +29,6 @@
 namespace lbann {
 
 LBANN_DEFINE_LAYER_BUILDER(matmul);
+LBANN_DEFINE_LAYER_BUILDER(scaled_dot_product_attention);
 
 } // namespace lbann
@@ -104,6 +104,9 @@ public:
 
   description get_description() const override;
 
+  /** @brief Int8 forward prop is available on CPU. */
+  bool supports_int8_inference() const override;
+
   template <typename ArchiveT>
   void serialize(ArchiveT& ar);
 
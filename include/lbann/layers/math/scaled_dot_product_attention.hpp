@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_MATH_SCALED_DOT_PRODUCT_ATTENTION_HPP_INCLUDED
+#define LBANN_LAYERS_MATH_SCALED_DOT_PRODUCT_ATTENTION_HPP_INCLUDED
+
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
+
+#include "lbann/proto/layers.pb.h"
+
+#include <type_traits>
+
+namespace lbann {
+
+/** @brief Fused multi-head scaled dot-product attention
+ *
+ *  Expects three 2D inputs: queries (
+ *  @f$ \text{num\_queries}\times\text{embed\_dim} @f$ ), keys (
+ *  @f$ \text{num\_keys}\times\text{embed\_dim} @f$ ), and values (
+ *  @f$ \text{num\_keys}\times\text{value\_dim} @f$ ). The embedding
+ *  and value dimensions are split evenly between heads, and for each
+ *  head:
+ *  @f[
+ *    \text{Attention}(Q,K,V)
+ *      = \text{softmax}\left( \text{scale} \, Q K^T \right) V
+ *  @f]
+ *  The head outputs are concatenated into a
+ *  @f$ \text{num\_queries}\times\text{value\_dim} @f$ tensor.
+ *
+ *  The softmax is computed online over tiles of keys, as in
+ *  FlashAttention, so the score matrix is never stored. Forward prop
+ *  only keeps the log-sum-exp of each row of scores and back prop
+ *  recomputes the scores from it, so memory use is linear in the
+ *  sequence length.
+ *
+ *  See:
+ *
+ *  Tri Dao, Daniel Y. Fu, Stefano Ermon, Atri Rudra, and Christopher
+ *  Re. "FlashAttention: Fast and memory-efficient exact attention
+ *  with IO-awareness." In Advances in Neural Information Processing
+ *  Systems. 2022.
+ */
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+class scaled_dot_product_attention_layer
+  : public data_type_layer<TensorDataType>
+{
+  static_assert(Layout == data_layout::DATA_PARALLEL,
+                "scaled_dot_product_attention_layer only supports "
+                "data-parallel data layout");
+
+public:
+  /** @brief Largest head size supported on GPU */
+  static constexpr size_t max_gpu_head_size = 128;
+
+  /** @brief Floating-point type for softmax statistics
+   *  @details Half-precision layers keep statistics in single
+   *           precision.
+   */
+  using StatType = std::
+    conditional_t<std::is_same_v<TensorDataType, double>, double, float>;
+
+  /** @param num_heads Number of attention heads
+   *  @param causal    Whether query i only attends to keys 0 through i
+   *  @param scale     Scaling factor for scores. If zero, uses
+   *                   @f$ 1/\sqrt{\text{head\_size}} @f$.
+   */
+  scaled_dot_product_attention_layer(lbann_comm* comm,
+                                     size_t num_heads,
+                                     bool causal,
+                                     double scale);
+
+  scaled_dot_product_attention_layer(
+    const scaled_dot_product_attention_layer& other) = default;
+  scaled_dot_product_attention_layer&
+  operator=(const scaled_dot_product_attention_layer& other) = default;
+  scaled_dot_product_attention_layer* copy() const override;
+
+  /** @name Serialization */
+  ///@{
+
+  template <typename ArchiveT>
+  void serialize(ArchiveT& ar);
+
+  ///@}
+
+  std::string get_type() const override;
+  data_layout get_data_layout() const override;
+  El::Device get_device_allocation() const override;
+  bool can_run_inplace() const override { return false; }
+  int get_backprop_requirements() const override
+  {
+    return ERROR_SIGNALS | PREV_ACTIVATIONS | ACTIVATIONS;
+  }
+
+  description get_description() const override;
+
+protected:
+  /** Add layer specific data to prototext */
+  void write_specific_proto(lbann_data::Layer& proto) const final;
+
+  friend class cereal::access;
+  scaled_dot_product_attention_layer()
+    : scaled_dot_product_attention_layer(nullptr, 1, false, 0.)
+  {}
+
+  void setup_dims() override;
+
+  void fp_compute() override;
+  void bp_compute() override;
+
+private:
+  /** @brief Number of attention heads */
+  size_t m_num_heads;
+  /** @brief Whether query i only attends to keys 0 through i */
+  bool m_causal;
+  /** @brief Scaling factor for scores, or zero for the default */
+  double m_scale;
+
+  /** @brief Log-sum-exp of each row of scores
+   *  @details @f$ (\text{num\_heads}\cdot\text{num\_queries})
+   *           \times\text{local\_mini\_batch\_size} @f$ matrix
+   *           computed in forward prop and used in back prop.
+   */
+  El::Matrix<StatType, Device> m_softmax_stats;
+
+  /** @brief Scaling factor applied to scores */
+  StatType get_scale() const;
+};
+
+// =========================================================
+// Implementation
+// =========================================================
+
+template <typename T, data_layout L, El::Device D>
+void scaled_dot_product_attention_layer<T, L, D>::write_specific_proto(
+  lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<T>);
+  auto* msg = proto.mutable_scaled_dot_product_attention();
+  msg->set_num_heads(m_num_heads);
+  msg->set_causal(m_causal);
+  msg->set_scale(m_scale);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  scaled_dot_product_attention_layer(lbann_comm* comm,
+                                     size_t num_heads,
+                                     bool causal,
+                                     double scale)
+  : data_type_layer<TensorDataType>(comm),
+    m_num_heads{num_heads},
+    m_causal{causal},
+    m_scale{scale}
+{
+  this->m_expected_num_parent_layers = 3;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+scaled_dot_product_attention_layer<TensorDataType, Layout, Device>*
+scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::copy()
+  const
+{
+  return new scaled_dot_product_attention_layer(*this);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+std::string
+scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::get_type()
+  const
+{
+  return "scaled dot-product attention";
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+data_layout scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  get_data_layout() const
+{
+  return Layout;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+El::Device scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  get_device_allocation() const
+{
+  return Device;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+description
+scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  get_description() const
+{
+  auto desc = data_type_layer<TensorDataType>::get_description();
+  desc.add("Heads", m_num_heads);
+  desc.add("Causal", m_causal);
+  if (m_scale > 0.) {
+    desc.add("Scale", m_scale);
+  }
+  else {
+    desc.add("Scale", "1/sqrt(head size)");
+  }
+  return desc;
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#ifndef LBANN_SCALED_DOT_PRODUCT_ATTENTION_LAYER_INSTANTIATE
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class scaled_dot_product_attention_layer<                    \
+    T,                                                                         \
+    data_layout::DATA_PARALLEL,                                                \
+    Device>;
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
+#endif // LBANN_SCALED_DOT_PRODUCT_ATTENTION_LAYER_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_MATH_SCALED_DOT_PRODUCT_ATTENTION_HPP_INCLUDED
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_MATH_SCALED_DOT_PRODUCT_ATTENTION_IMPL_HPP_INCLUDED
+#define LBANN_LAYERS_MATH_SCALED_DOT_PRODUCT_ATTENTION_IMPL_HPP_INCLUDED
+
+#include "lbann/layers/math/scaled_dot_product_attention.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <cmath>
+
+namespace lbann {
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  setup_dims()
+{
+  data_type_layer<TensorDataType>::setup_dims();
+
+  // Check parameters
+  if (m_num_heads == 0) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" has an invalid number of heads (",
+                m_num_heads,
+                ")");
+  }
+
+  // Check input dims
+  const auto& queries_dims = this->get_input_dims(0);
+  const auto& keys_dims = this->get_input_dims(1);
+  const auto& values_dims = this->get_input_dims(2);
+  if (queries_dims.size() != 2 || keys_dims.size() != 2 ||
+      values_dims.size() != 2) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" expects 2D queries, keys, and values, but got ",
+                queries_dims.size(),
+                "D, ",
+                keys_dims.size(),
+                "D, and ",
+                values_dims.size(),
+                "D inputs");
+  }
+  if (keys_dims[0] != values_dims[0]) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" has ",
+                keys_dims[0],
+                " keys but ",
+                values_dims[0],
+                " values");
+  }
+  if (queries_dims[1] != keys_dims[1]) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" has queries of size ",
+                queries_dims[1],
+                " but keys of size ",
+                keys_dims[1]);
+  }
+  const size_t embed_dim = queries_dims[1];
+  const size_t value_dim = values_dims[1];
+  if (embed_dim % m_num_heads != 0 || value_dim % m_num_heads != 0) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" cannot split queries of size ",
+                embed_dim,
+                " and values of size ",
+                value_dim,
+                " between ",
+                m_num_heads,
+                " heads");
+  }
+  if constexpr (Device == El::Device::GPU) {
+    if (embed_dim / m_num_heads > max_gpu_head_size ||
+        value_dim / m_num_heads > max_gpu_head_size) {
+      LBANN_ERROR(this->get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" has head sizes of ",
+                  embed_dim / m_num_heads,
+                  " (queries) and ",
+                  value_dim / m_num_heads,
+                  " (values), but at most ",
+                  max_gpu_head_size,
+                  " is supported on GPU");
+    }
+  }
+
+  // Set output dims
+  this->set_output_dims({queries_dims[0], values_dims[1]});
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+auto scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  get_scale() const -> StatType
+{
+  if (m_scale > 0.) {
+    return static_cast<StatType>(m_scale);
+  }
+  const size_t head_size = this->get_input_dims(0)[1] / m_num_heads;
+  return static_cast<StatType>(1. / std::sqrt(static_cast<double>(head_size)));
+}
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_MATH_SCALED_DOT_PRODUCT_ATTENTION_IMPL_HPP_INCLUDED
@@ -33,11 +33,15 @@
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/optimizers/sgd.hpp"
+#include "lbann/optimizers/sparse_gradient.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/layers.pb.h"
 #include "lbann/utils/memory.hpp"
 #include "lbann/weights/weights_helpers.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 namespace lbann {
 
 /** @brief Embedding layer with distributed weights
@@ -54,17 +58,15 @@ namespace lbann {
  *  size is very large.
  *
  *  To take advantage of sparse gradients, the distributed embedding
- *  layer provides the option to bypass the optimizer (which currently
- *  only supports dense gradients) and perform sparse SGD directly on
- *  the embedding weights. If enabled, SGD occurs during the layers
- *  "update" phase (i.e. in the virtual update_compute function).
- *  Otherwise, the layer converts sparse gradients to a dense tensor
- *  and passes it into the usual optimizer. This is a hack and will be
- *  deprecated once the optimizer class supports sparse gradients.
+ *  layer provides the option to bypass the optimizer and perform
+ *  sparse SGD directly on the embedding weights. If enabled, SGD
+ *  occurs during the layers "update" phase (i.e. in the virtual
+ *  update_compute function). Otherwise, sparse gradients are passed
+ *  to the optimizer if it supports them (see
+ *  data_type_optimizer::add_to_sparse_gradient), or converted to a
+ *  dense tensor.
  *
  *  @warning This is experimental.
- *
- *  @todo Sparse SGD with optimizer class
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class dist_embedding_layer : public data_type_layer<TensorDataType>
@@ -78,7 +80,9 @@ public:
                        size_t embedding_dim,
                        bool sparse_sgd,
                        DataType learning_rate,
-                       bool barrier_in_forward_prop);
+                       bool barrier_in_forward_prop,
+                       size_t hot_cache_size = 0,
+                       size_t hot_cache_refresh_interval = 0);
 
   dist_embedding_layer(const dist_embedding_layer& other);
   dist_embedding_layer& operator=(const dist_embedding_layer& other);
@@ -101,7 +105,7 @@ public:
   ///@{
 
   template <typename ArchiveT>
-  void serialize(ArchiveT& ar);
+  void serialize(ArchiveT& ar, std::uint32_t const version);
 
   ///@}
 
@@ -146,7 +150,25 @@ private:
   nb_barrier(lbann_comm& comm, const El::mpi::Comm& c, Al::request& req);
 
   void attach_embeddings_to_shmem_buffer();
+  /** Refresh the hot-row cache at the start of forward prop.
+   *
+   *  Every @c m_hot_cache_refresh_interval forward props, the most
+   *  frequently looked-up embedding vectors are chosen from the
+   *  trainer-wide lookup counts. The cached values are then copied
+   *  from their owners with an allreduce.
+   */
+  void
+  update_hot_cache(const El::AbstractDistMatrix<TensorDataType>& embeddings);
   void apply_sparse_sgd_step(size_t num_gradients, LocalMat& local_embeddings);
+  /** Pass the received gradients to @c opt as a column-sparse
+   *  contribution.
+   */
+  void add_sparse_gradient(size_t num_gradients,
+                           data_type_optimizer<TensorDataType>& opt);
+#if defined(LBANN_HAS_GPU) && defined(LBANN_HAS_NVSHMEM)
+  /** Zero the NVSHMEM metadata buffer once gradients are consumed. */
+  void reset_metadata_buffer(cudaStream_t stream);
+#endif // defined(LBANN_HAS_GPU) && defined(LBANN_HAS_NVSHMEM)
 
   /** SHMEM buffer for embedding vectors.
    *
@@ -182,6 +204,17 @@ private:
    */
   Al::request m_nb_barrier_request;
 
+  /** Whether gradients have been sent but not yet consumed.
+   *
+   *  On GPU, synchronization is stream-ordered: NVSHMEM barriers are
+   *  enqueued on the compute stream at the start of forward prop and
+   *  before gradients are consumed, so the host never waits. The
+   *  metadata buffer is reset right after the gradients are
+   *  consumed. If that did not happen (e.g. backprop without an
+   *  update), forward prop resets it instead.
+   */
+  bool m_gradients_pending{false};
+
   /** Size of dictionary of embeddings. */
   size_t m_num_embeddings;
   /** Size of embedding vectors. */
@@ -204,9 +237,38 @@ private:
    *  blocking barrier at the beginning of forward prop to make sure
    *  that all the embeddings are ready to be accessed.
    *
-   *  @todo Think of a way to avoid this synchronization.
+   *  GPU forward prop always starts with a stream-ordered barrier,
+   *  so this only affects the CPU implementation.
    */
   bool m_barrier_in_forward_prop;
+
+  /** Number of embedding vectors replicated on every process.
+   *
+   *  Lookups of cached vectors copy from @c m_hot_cache instead of
+   *  performing one-sided communication. Gradients are still sent to
+   *  the owner process. Zero disables the cache.
+   */
+  size_t m_hot_cache_size;
+  /** Forward props between choices of cached embedding vectors. */
+  size_t m_hot_cache_refresh_interval;
+  /** Forward props since cached embedding vectors were chosen. */
+  size_t m_forward_props_since_refresh{0};
+  /** Local lookup counts for each embedding vector.
+   *
+   *  Only allocated if the cache is enabled. Reset whenever cached
+   *  embedding vectors are chosen.
+   */
+  El::Matrix<float, Device> m_access_counts;
+  /** Global indices of cached embedding vectors, sorted. */
+  std::vector<El::Int> m_hot_rows;
+  /** Copy of @c m_hot_rows on the device. */
+  El::Matrix<El::Int, Device> m_hot_rows_device;
+  /** Positions in @c m_hot_rows of locally owned cached vectors. */
+  std::vector<El::Int> m_local_hot_slots;
+  /** Local columns of locally owned cached vectors. */
+  std::vector<El::Int> m_local_hot_cols;
+  /** Cached embedding vectors, one column per @c m_hot_rows entry. */
+  LocalMat m_hot_cache;
 };
 
 // ---------------------------------------------
@@ -224,6 +286,8 @@ void dist_embedding_layer<T, L, D>::write_specific_proto(
   msg->set_sparse_sgd(m_sparse_sgd);
   msg->set_learning_rate(m_learning_rate);
   msg->set_barrier_in_forward_prop(m_barrier_in_forward_prop);
+  msg->set_hot_cache_size(m_hot_cache_size);
+  msg->set_hot_cache_refresh_interval(m_hot_cache_refresh_interval);
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -232,19 +296,28 @@ dist_embedding_layer<TensorDataType, Layout, Device>::dist_embedding_layer(
   size_t embedding_dim,
   bool sparse_sgd,
   DataType learning_rate,
-  bool barrier_in_forward_prop)
+  bool barrier_in_forward_prop,
+  size_t hot_cache_size,
+  size_t hot_cache_refresh_interval)
   : data_type_layer<TensorDataType>(nullptr),
     m_num_embeddings{num_embeddings},
     m_embedding_dim{embedding_dim},
     m_sparse_sgd{sparse_sgd},
     m_learning_rate{learning_rate},
-    m_barrier_in_forward_prop{barrier_in_forward_prop}
+    m_barrier_in_forward_prop{barrier_in_forward_prop},
+    m_hot_cache_size{std::min(hot_cache_size, num_embeddings)},
+    m_hot_cache_refresh_interval{hot_cache_refresh_interval}
 {
 
   // Learning rate is only used for sparse SGD
   if (!m_sparse_sgd) {
     m_learning_rate = -1.0;
   }
+
+  // Default interval for choosing cached embedding vectors
+  if (m_hot_cache_refresh_interval == 0) {
+    m_hot_cache_refresh_interval = 100;
+  }
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -306,6 +379,10 @@ dist_embedding_layer<TensorDataType, Layout, Device>::get_description() const
   desc.add("Embedding dim", m_embedding_dim);
   desc.add("Using sparse SGD", m_sparse_sgd);
   desc.add("SGD learning rate", m_learning_rate);
+  desc.add("Hot cache size", m_hot_cache_size);
+  if (m_hot_cache_size > 0) {
+    desc.add("Hot cache refresh interval", m_hot_cache_refresh_interval);
+  }
   return desc;
 }
 
@@ -388,9 +465,19 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::setup_data(
   embeddings.setup();
   attach_embeddings_to_shmem_buffer();
 
+  // Lookup counts for hot-row cache
+  if (m_hot_cache_size > 0) {
+    El::Zeros(m_access_counts, m_num_embeddings, 1);
+    m_forward_props_since_refresh = 0;
+    m_hot_rows.clear();
+  }
+
   // Non-blocking barrier
-  // Note: Embeddings have been initialized
-  nb_barrier(comm, comm.get_trainer_comm(), m_nb_barrier_request);
+  // Note: Embeddings have been initialized. GPU forward prop starts
+  // with a stream-ordered barrier instead.
+  if constexpr (Device == El::Device::CPU) {
+    nb_barrier(comm, comm.get_trainer_comm(), m_nb_barrier_request);
+  }
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -408,14 +495,84 @@ bool dist_embedding_layer<TensorDataType, Layout, Device>::update_compute()
   }
 
   // Non-blocking barrier
-  // Note: Embeddings are up-to-date.
-  auto& comm = *this->get_comm();
-  comm.wait(m_nb_barrier_request);
-  nb_barrier(comm, comm.get_trainer_comm(), m_nb_barrier_request);
+  // Note: Embeddings are up-to-date. GPU forward prop starts with a
+  // stream-ordered barrier instead.
+  if constexpr (Device == El::Device::CPU) {
+    auto& comm = *this->get_comm();
+    comm.wait(m_nb_barrier_request);
+    nb_barrier(comm, comm.get_trainer_comm(), m_nb_barrier_request);
+  }
 
   return true;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void dist_embedding_layer<TensorDataType, Layout, Device>::update_hot_cache(
+  const El::AbstractDistMatrix<TensorDataType>& embeddings)
+{
+  if (m_hot_cache_size == 0) {
+    return;
+  }
+  auto& comm = *this->get_comm();
+  const auto& trainer_comm = comm.get_trainer_comm();
+
+  // Choose cached embedding vectors from lookup counts
+  if (m_forward_props_since_refresh >= m_hot_cache_refresh_interval) {
+    comm.allreduce(static_cast<El::AbstractMatrix<float>&>(m_access_counts),
+                   trainer_comm);
+    El::Matrix<float, El::Device::CPU> counts;
+    El::Copy(m_access_counts, counts);
+    std::vector<El::Int> order(m_num_embeddings);
+    std::iota(order.begin(), order.end(), El::Int(0));
+    std::partial_sort(order.begin(),
+                      order.begin() + m_hot_cache_size,
+                      order.end(),
+                      [&counts](const El::Int& a, const El::Int& b) {
+                        return counts(a, 0) > counts(b, 0) ||
+                               (counts(a, 0) == counts(b, 0) && a < b);
+                      });
+    m_hot_rows.clear();
+    for (size_t i = 0; i < m_hot_cache_size; ++i) {
+      if (counts(order[i], 0) > 0.f) {
+        m_hot_rows.push_back(order[i]);
+      }
+    }
+    std::sort(m_hot_rows.begin(), m_hot_rows.end());
+    El::Matrix<El::Int, El::Device::CPU> hot_rows(m_hot_rows.size(), 1);
+    std::copy(m_hot_rows.begin(), m_hot_rows.end(), hot_rows.Buffer());
+    El::Copy(hot_rows, m_hot_rows_device);
+
+    // Cached embedding vectors owned by this process
+    m_local_hot_slots.clear();
+    m_local_hot_cols.clear();
+    for (size_t slot = 0; slot < m_hot_rows.size(); ++slot) {
+      if (embeddings.IsLocalCol(m_hot_rows[slot])) {
+        m_local_hot_slots.push_back(slot);
+        m_local_hot_cols.push_back(embeddings.LocalCol(m_hot_rows[slot]));
+      }
+    }
+
+    El::Zero(m_access_counts);
+    m_forward_props_since_refresh = 0;
+  }
+  if (m_hot_rows.empty()) {
+    return;
+  }
+
+  // Copy cached embedding vectors from owners
+  LocalMat local_hot_vectors;
+  local_hot_vectors.SetSyncInfo(El::SyncInfoFromMatrix(m_hot_cache));
+  sparse_gradient::gather_columns(embeddings.LockedMatrix(),
+                                  m_local_hot_cols,
+                                  local_hot_vectors);
+  El::Zeros(m_hot_cache, m_embedding_dim, m_hot_rows.size());
+  sparse_gradient::scatter_columns(local_hot_vectors,
+                                   m_local_hot_slots,
+                                   m_hot_cache);
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+  comm.allreduce(static_cast<AbsMatType&>(m_hot_cache), trainer_comm);
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void dist_embedding_layer<TensorDataType, Layout, Device>::nb_barrier(
   lbann_comm& comm,
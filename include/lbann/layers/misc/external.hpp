@@ -29,8 +29,14 @@
 
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/layers/layer.hpp"
+#include "lbann/layers/misc/external_abi.hpp"
 #include "lbann/proto/datatype.pb.h"
 
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace lbann {
 
 typedef Layer* (*external_layer_setup_t)(lbann_data::DataType datatype,
@@ -46,6 +52,141 @@ typedef Layer* (*external_layer_setup_t)(lbann_data::DataType datatype,
 external_layer_setup_t load_external_library(const std::string& filename,
                                              const std::string& layer_name);
 
+/** @brief Library opened for external kernels
+ *
+ *  The library is closed with dlclose when the last copy is released.
+ */
+using external_library = std::shared_ptr<void>;
+
+/** @brief Open a library for external kernels
+ *
+ *  Throws if the library cannot be loaded.
+ */
+external_library open_external_library(const std::string& filename);
+
+/** @brief Check whether a library exports an external kernel
+ *
+ *  The library must export the function
+ *  @c lbann_external_kernel_<kernel_name> (see external_abi.hpp).
+ */
+bool has_external_kernel(const std::string& filename,
+                         const std::string& kernel_name);
+
+/** @brief Get the function table of an external kernel
+ *
+ *  Throws if the library does not export the kernel or if the kernel
+ *  was built for another version of the ABI. The function table is
+ *  only valid while @p library is open.
+ */
+const lbann_external_kernel*
+load_external_kernel(const external_library& library,
+                     const std::string& filename,
+                     const std::string& kernel_name);
+
+/** @brief Layer that runs an external kernel
+ *
+ *  The kernel only implements the math. This layer owns the tensors
+ *  and calls the kernel with views of its local matrices, the GPU
+ *  stream they are ordered on and scratch memory from the stream's
+ *  workspace (see gpu::get_workspace). Kernels can therefore enqueue
+ *  their work without synchronizing the device or allocating memory.
+ *
+ *  Expects any number of input tensors. The number of outputs is set
+ *  by the kernel.
+ */
+template <typename TensorDataType,
+          data_layout Layout = data_layout::DATA_PARALLEL,
+          El::Device Device = El::Device::CPU>
+class external_kernel_layer final : public data_type_layer<TensorDataType>
+{
+  static_assert(Layout == data_layout::DATA_PARALLEL,
+                "external kernels only support data-parallel layout");
+
+public:
+  external_kernel_layer(lbann_comm* comm,
+                        std::string filename,
+                        std::string kernel_name);
+  external_kernel_layer(const external_kernel_layer& other);
+  external_kernel_layer& operator=(const external_kernel_layer& other);
+  ~external_kernel_layer() override;
+
+  external_kernel_layer* copy() const override;
+
+  /** @name Serialization */
+  ///@{
+
+  template <typename ArchiveT>
+  void serialize(ArchiveT& ar);
+
+  ///@}
+
+  std::string get_type() const override { return "external kernel"; }
+  data_layout get_data_layout() const override { return Layout; }
+  El::Device get_device_allocation() const override { return Device; }
+  bool can_run_inplace() const override { return false; }
+  int get_backprop_requirements() const override
+  {
+    return ERROR_SIGNALS | PREV_ACTIVATIONS | ACTIVATIONS;
+  }
+  description get_description() const override;
+
+protected:
+  /** Add layer specific data to prototext */
+  void write_specific_proto(lbann_data::Layer& proto) const final;
+
+  friend class cereal::access;
+  external_kernel_layer() : external_kernel_layer(nullptr, "", "") {}
+
+  void setup_dims() override;
+  void fp_compute() override;
+  void bp_compute() override;
+
+private:
+  /** @brief Library that exports the kernel */
+  std::string m_filename;
+  /** @brief Kernel name in the library */
+  std::string m_kernel_name;
+
+  /** @brief Library that exports the kernel, shared with copies */
+  external_library m_library;
+  /** @brief Kernel function table, loaded on first use */
+  const lbann_external_kernel* m_kernel = nullptr;
+  /** @brief Kernel state, created at setup */
+  void* m_state = nullptr;
+
+  /** @brief Scratch memory for CPU kernels
+   *
+   *  GPU kernels use the stream workspace instead.
+   */
+  std::vector<std::byte> m_cpu_workspace;
+
+  /** @brief (Re)create the kernel state from the input shapes. */
+  void create_state();
+  /** @brief Destroy the kernel state, if any. */
+  void destroy_state();
+
+  /** @brief Kernel call context for a local mini-batch */
+  lbann_external_context make_context(size_t mini_batch_size);
+};
+
+#ifndef LBANN_EXTERNAL_LAYER_INSTANTIATE
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class external_kernel_layer<T,                               \
+                                              data_layout::DATA_PARALLEL,      \
+                                              Device>
+PROTO_DEVICE(float, El::Device::CPU);
+#ifdef LBANN_HAS_DOUBLE
+PROTO_DEVICE(double, El::Device::CPU);
+#endif // LBANN_HAS_DOUBLE
+#ifdef LBANN_HAS_GPU
+PROTO_DEVICE(float, El::Device::GPU);
+#ifdef LBANN_HAS_DOUBLE
+PROTO_DEVICE(double, El::Device::GPU);
+#endif // LBANN_HAS_DOUBLE
+#endif // LBANN_HAS_GPU
+#undef PROTO_DEVICE
+#endif // LBANN_EXTERNAL_LAYER_INSTANTIATE
+
 } // namespace lbann
 
 #endif // LBANN_LAYERS_MISC_EXTERNAL_HPP_INCLUDED
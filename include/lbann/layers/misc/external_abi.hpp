@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_MISC_EXTERNAL_ABI_HPP_INCLUDED
+#define LBANN_LAYERS_MISC_EXTERNAL_ABI_HPP_INCLUDED
+
+/** @file
+ *
+ *  C interface for external kernels.
+ *
+ *  An external kernel is a plugin that only implements the math of a
+ *  layer. LBANN owns the layer and hands the kernel views of its
+ *  local tensors, the GPU stream they are ordered on and scratch
+ *  memory from the stream's workspace. The kernel should enqueue its
+ *  work on the stream and return without synchronizing the device or
+ *  allocating memory.
+ *
+ *  This header only depends on the C standard library, so a plugin
+ *  does not need to be built against LBANN or Hydrogen. A plugin
+ *  named "<name>" exports
+ *
+ *      const lbann_external_kernel* lbann_external_kernel_<name>(void);
+ *
+ *  with C linkage, returning a table whose @c abi_version is
+ *  @c LBANN_EXTERNAL_ABI_VERSION. Tables with another version are
+ *  rejected when the library is loaded.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief Version of the structures in this file.
+ *
+ *  Incremented whenever their layout or meaning changes.
+ */
+#define LBANN_EXTERNAL_ABI_VERSION 1
+
+/** @brief Largest tensor rank passed to an external kernel */
+#define LBANN_EXTERNAL_MAX_DIMS 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Device that holds tensor data */
+typedef enum
+{
+  LBANN_EXTERNAL_CPU = 0,
+  LBANN_EXTERNAL_GPU = 1
+} lbann_external_device;
+
+/** @brief Tensor entry type */
+typedef enum
+{
+  LBANN_EXTERNAL_FLOAT = 0,
+  LBANN_EXTERNAL_DOUBLE = 1
+} lbann_external_datatype;
+
+/** @brief Shape of one mini-batch sample */
+typedef struct
+{
+  int32_t num_dims;
+  int64_t dims[LBANN_EXTERNAL_MAX_DIMS];
+} lbann_external_shape;
+
+/** @brief View of a local mini-batch tensor
+ *
+ *  Samples are stored in columns: entry @c i of sample @c j is at
+ *  <tt>data[i + j * ldim]</tt>, with @c height equal to the product of
+ *  the sample dims. The view does not own the data.
+ */
+typedef struct
+{
+  void* data;
+  int64_t height;
+  int64_t width;
+  int64_t ldim;
+  lbann_external_shape shape;
+} lbann_external_tensor;
+
+/** @brief State for one kernel call */
+typedef struct
+{
+  /** @brief Always @c LBANN_EXTERNAL_ABI_VERSION */
+  uint32_t abi_version;
+  lbann_external_device device;
+  lbann_external_datatype datatype;
+  /** @brief @c cudaStream_t or @c hipStream_t that orders all tensors
+   *  and the workspace. Null on CPU.
+   */
+  void* stream;
+  /** @brief Scratch memory on @c device.
+   *
+   *  Holds at least the number of bytes requested by the kernel's
+   *  @c workspace_size function. It may be reused by the next layer
+   *  as soon as the call returns, so it must only be used by work
+   *  enqueued on @c stream.
+   */
+  void* workspace;
+  size_t workspace_size;
+  /** @brief Nonzero while training */
+  int32_t is_training;
+  /** @brief Kernel state returned by @c create */
+  void* state;
+} lbann_external_context;
+
+/** @brief Function table exported by an external kernel
+ *
+ *  Functions return zero on success. Optional functions may be null.
+ */
+typedef struct
+{
+  /** @brief Must be @c LBANN_EXTERNAL_ABI_VERSION */
+  uint32_t abi_version;
+
+  /** @brief Number of output tensors */
+  int32_t num_outputs;
+
+  /** @brief Create per-layer state (optional)
+   *
+   *  Called once the input shapes are known. The state is passed to
+   *  every other call through @c lbann_external_context::state.
+   */
+  int (*create)(int32_t num_inputs,
+                const lbann_external_shape* inputs,
+                void** state);
+
+  /** @brief Destroy per-layer state (optional) */
+  void (*destroy)(void* state);
+
+  /** @brief Shape of an output (optional)
+   *
+   *  Outputs have the shape of the first input by default.
+   */
+  int (*output_shape)(void* state,
+                      int32_t output_index,
+                      int32_t num_inputs,
+                      const lbann_external_shape* inputs,
+                      lbann_external_shape* output);
+
+  /** @brief Scratch bytes needed for a local mini-batch (optional) */
+  size_t (*workspace_size)(void* state, int64_t mini_batch_size);
+
+  /** @brief Compute outputs from inputs */
+  int (*forward)(const lbann_external_context* context,
+                 int32_t num_inputs,
+                 const lbann_external_tensor* inputs,
+                 int32_t num_outputs,
+                 lbann_external_tensor* outputs);
+
+  /** @brief Compute input gradients from output gradients (optional)
+   *
+   *  Input gradients are zero if this is null.
+   */
+  int (*backward)(const lbann_external_context* context,
+                  int32_t num_inputs,
+                  const lbann_external_tensor* inputs,
+                  int32_t num_outputs,
+                  const lbann_external_tensor* outputs,
+                  const lbann_external_tensor* output_grads,
+                  lbann_external_tensor* input_grads);
+} lbann_external_kernel;
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // LBANN_LAYERS_MISC_EXTERNAL_ABI_HPP_INCLUDED
@@ -41,7 +41,10 @@ namespace lbann {
 
 /** @brief Layer composed of one or more operator objects
  *
- *  Operators are applied sequentially.
+ *  Operators are applied sequentially. Operators after the first must
+ *  be element-wise: each takes the previous operator's output as its
+ *  only input and runs in place on the layer's output, except where
+ *  it needs its input in backprop.
  */
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 class OperatorLayer final : public data_type_layer<InputT, OutputT>
@@ -52,6 +55,14 @@ class OperatorLayer final : public data_type_layer<InputT, OutputT>
 
   std::vector<OperatorPtr> m_ops;
 
+  /** @brief Inputs of the operators after the first that need them
+   *  in backprop. Entry @c i holds the output of operator @c i.
+   */
+  std::vector<std::unique_ptr<El::AbstractDistMatrix<OutputT>>>
+    m_saved_inputs;
+  /** @brief Gradient between chained operators. */
+  std::unique_ptr<El::AbstractDistMatrix<OutputT>> m_chain_gradient;
+
 public:
   /** @name Lifecycle functions */
   ///@{
@@ -82,6 +93,14 @@ public:
   El::Device get_device_allocation() const final;
   bool can_run_inplace() const final;
   int get_backprop_requirements() const final;
+  bool supports_graph_capture() const final { return m_ops.size() == 1UL; }
+  bool fuse_child(Layer const& child) final;
+
+  /** @brief The operators, in the order they are applied. */
+  std::vector<OperatorPtr> const& get_operators() const noexcept
+  {
+    return m_ops;
+  }
 
   void fp_compute() final;
   void bp_compute() final;
@@ -104,6 +123,15 @@ private:
 
   static std::vector<size_t> fix_type(std::vector<int> const& in);
 
+  /** @brief Whether operator @c i keeps its input for backprop. */
+  bool saves_input(size_t i) const;
+  /** @brief Resize @c buffer like @c mat, constructing it if needed. */
+  static El::AbstractDistMatrix<OutputT>&
+  get_chain_buffer(std::unique_ptr<El::AbstractDistMatrix<OutputT>>& buffer,
+                   El::AbstractDistMatrix<OutputT> const& mat);
+  void fp_compute_chain();
+  void bp_compute_chain();
+
   std::vector<utils::ConstDistTensorView<InputT, D>> get_inputs() const;
   std::vector<utils::DistTensorView<OutputT, D>> get_outputs();
   std::vector<utils::ConstDistTensorView<OutputT, D>>
@@ -37,6 +37,7 @@
 #include "lbann/proto/layers.pb.h"
 #include <cereal/types/base_class.hpp>
 #include <memory>
+#include <type_traits>
 
 namespace lbann {
 
@@ -57,8 +58,14 @@ OperatorLayer<InputT, OutputT, Layout, D>::OperatorLayer(
   std::vector<OperatorPtr> operators)
   : DataTypeLayer(&comm), m_ops{std::move(operators)}
 {
-  LBANN_ASSERT(m_ops.size() == 1UL); // For starters.
+  using ElementwiseType = ElementwiseOperator<InputT, OutputT, D>;
+  LBANN_ASSERT(!m_ops.empty());
   LBANN_ASSERT(m_ops[0]);
+  // Chained operators pass tensors of one type
+  LBANN_ASSERT((std::is_same_v<InputT, OutputT> || m_ops.size() == 1UL));
+  for (size_t i = 1; i < m_ops.size(); ++i) {
+    LBANN_ASSERT(dynamic_cast<ElementwiseType const*>(m_ops[i].get()));
+  }
   this->m_expected_num_parent_layers = -1; // No limit on parents
 }
 
@@ -75,6 +82,8 @@ auto OperatorLayer<InputT, OutputT, Layout, D>::operator=(
   // This is self-assignment safe
   data_type_layer<InputT, OutputT>::operator=(other);
   m_ops = clone_ops(other.m_ops);
+  m_saved_inputs.clear();
+  m_chain_gradient.reset();
   return *this;
 }
 
@@ -112,28 +121,140 @@ bool OperatorLayer<InputT, OutputT, Layout, D>::can_run_inplace() const
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 int OperatorLayer<InputT, OutputT, Layout, D>::get_backprop_requirements() const
 {
-  // Find the union of all internal operators
-  int result = ERROR_SIGNALS;
-  for (const auto& op : m_ops) {
-    result |= op->get_backprop_requirements();
+  // Only the first operator reads the layer's inputs. Later
+  // operators keep their own inputs in m_saved_inputs.
+  return ERROR_SIGNALS | m_ops[0]->get_backprop_requirements();
+}
+
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+bool OperatorLayer<InputT, OutputT, Layout, D>::fuse_child(Layer const& child)
+{
+  if constexpr (!std::is_same_v<InputT, OutputT>) {
+    return false;
+  }
+  else {
+    using ElementwiseType = ElementwiseOperator<InputT, OutputT, D>;
+    auto const* other = dynamic_cast<OperatorLayer const*>(&child);
+    if (other == nullptr || child.get_num_parents() != 1) {
+      return false;
+    }
+    for (auto const& op : other->m_ops) {
+      if (dynamic_cast<ElementwiseType const*>(op.get()) == nullptr) {
+        return false;
+      }
+    }
+    for (auto const& op : other->m_ops) {
+      m_ops.emplace_back(op->clone());
+    }
+    return true;
   }
-  return result;
 }
 
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 void OperatorLayer<InputT, OutputT, Layout, D>::fp_compute()
 {
+  if (m_ops.size() > 1UL) {
+    if constexpr (std::is_same_v<InputT, OutputT>) {
+      return fp_compute_chain();
+    }
+  }
   return m_ops[0]->fp_compute(this->get_inputs(), this->get_outputs());
 }
 
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 void OperatorLayer<InputT, OutputT, Layout, D>::bp_compute()
 {
+  if (m_ops.size() > 1UL) {
+    if constexpr (std::is_same_v<InputT, OutputT>) {
+      return bp_compute_chain();
+    }
+  }
   return m_ops[0]->bp_compute(this->get_inputs(),
                               this->get_grad_wrt_outputs(),
                               this->get_grad_wrt_inputs());
 }
 
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+bool OperatorLayer<InputT, OutputT, Layout, D>::saves_input(size_t i) const
+{
+  return (m_ops[i]->get_backprop_requirements() & PREV_ACTIVATIONS) != 0;
+}
+
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+auto OperatorLayer<InputT, OutputT, Layout, D>::get_chain_buffer(
+  std::unique_ptr<El::AbstractDistMatrix<OutputT>>& buffer,
+  El::AbstractDistMatrix<OutputT> const& mat)
+  -> El::AbstractDistMatrix<OutputT>&
+{
+  if (buffer == nullptr) {
+    buffer.reset(mat.Construct(mat.Grid(), mat.Root()));
+  }
+  buffer->AlignWith(mat.DistData());
+  buffer->Resize(mat.Height(), mat.Width());
+  return *buffer;
+}
+
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+void OperatorLayer<InputT, OutputT, Layout, D>::fp_compute_chain()
+{
+  using MatType = El::AbstractDistMatrix<OutputT>;
+  auto& output = this->get_activations();
+  auto const dims = splice_dims(output.Width(), this->get_output_dims());
+  m_saved_inputs.resize(m_ops.size() - 1);
+
+  // Operator i writes to the output unless the next operator needs
+  // its input in backprop
+  auto get_target = [&](size_t i) -> MatType& {
+    if (i + 1 < m_ops.size() && saves_input(i + 1)) {
+      return get_chain_buffer(m_saved_inputs[i], output);
+    }
+    return output;
+  };
+
+  MatType* target = &get_target(0);
+  std::vector<utils::DistTensorView<OutputT, D>> outputs;
+  outputs.emplace_back(*target, dims);
+  m_ops[0]->fp_compute(this->get_inputs(), outputs);
+  for (size_t i = 1; i < m_ops.size(); ++i) {
+    MatType const& input = *target;
+    target = &get_target(i);
+    std::vector<utils::ConstDistTensorView<InputT, D>> inputs;
+    inputs.emplace_back(input, dims);
+    outputs.clear();
+    outputs.emplace_back(*target, dims);
+    m_ops[i]->fp_compute(inputs, outputs);
+  }
+}
+
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+void OperatorLayer<InputT, OutputT, Layout, D>::bp_compute_chain()
+{
+  auto const& grad_wrt_output = this->get_prev_error_signals();
+  auto const dims =
+    splice_dims(grad_wrt_output.Width(), this->get_output_dims());
+  auto& gradient = get_chain_buffer(m_chain_gradient, grad_wrt_output);
+
+  // Later operators run in place on the chain gradient. Operators
+  // that ignore their input are passed the gradient as a placeholder.
+  for (size_t i = m_ops.size() - 1; i > 0; --i) {
+    auto const& input = saves_input(i) ? *m_saved_inputs[i - 1] : gradient;
+    std::vector<utils::ConstDistTensorView<InputT, D>> inputs;
+    inputs.emplace_back(input, dims);
+    std::vector<utils::ConstDistTensorView<OutputT, D>> grads_wrt_outputs;
+    grads_wrt_outputs.emplace_back(
+      i + 1 == m_ops.size() ? grad_wrt_output : gradient,
+      dims);
+    std::vector<utils::DistTensorView<InputT, D>> grads_wrt_inputs;
+    grads_wrt_inputs.emplace_back(gradient, dims);
+    m_ops[i]->bp_compute(inputs, grads_wrt_outputs, grads_wrt_inputs);
+  }
+  std::vector<utils::ConstDistTensorView<OutputT, D>> grads_wrt_outputs;
+  grads_wrt_outputs.emplace_back(gradient, dims);
+  m_ops[0]->bp_compute(this->get_inputs(),
+                       grads_wrt_outputs,
+                       this->get_grad_wrt_inputs());
+}
+
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 description OperatorLayer<InputT, OutputT, Layout, D>::get_description() const
 {
@@ -169,6 +169,20 @@ private:
    *  implementation.
    */
   bool m_bessel_correction;
+  /** @brief Whether tensors are stored in channels-last order.
+   *
+   *  If set, the last data dimension is the channel dimension and
+   *  statistics are computed over all other dimensions.
+   */
+  bool m_channels_last;
+  /** Whether a ReLU child is applied to the output. */
+  bool m_fused_relu = false;
+  /** @brief Whether a residual sum child is applied to the output.
+   *
+   *  If set, the layer has a second input that is added to the
+   *  normalized output (before the fused ReLU, if any).
+   */
+  bool m_fused_residual = false;
   /**
    * Cache of node-local num_per_sum results for node-local stats.
    * Indexed by effective mini-batch size.
@@ -207,16 +221,20 @@ public:
    *  @param statistics_group_size Number of processors to aggregate
    *         statistics over. Defaults to 1 (i.e. local aggregation).
    *  @param bessel_correction Add Bessel's correction to the denominator.
+   *  @param channels_last Treat the last data dimension as the channel
+   *         dimension.
    */
   batch_normalization_layer(TensorDataType decay = 0.9,
                             TensorDataType epsilon = 1e-5,
                             int statistics_group_size = 1,
-                            bool bessel_correction = true)
+                            bool bessel_correction = true,
+                            bool channels_last = false)
     : data_type_layer<TensorDataType>(nullptr),
       m_decay(decay),
       m_epsilon(epsilon),
       m_statistics_group_size(statistics_group_size),
-      m_bessel_correction(bessel_correction)
+      m_bessel_correction(bessel_correction),
+      m_channels_last(channels_last)
   {
 #ifdef LBANN_DETERMINISTIC
     // Force global computation.
@@ -230,6 +248,9 @@ public:
       m_epsilon(other.m_epsilon),
       m_statistics_group_size(other.m_statistics_group_size),
       m_bessel_correction(other.m_bessel_correction),
+      m_channels_last(other.m_channels_last),
+      m_fused_relu(other.m_fused_relu),
+      m_fused_residual(other.m_fused_residual),
       m_num_per_sum_cache(other.m_num_per_sum_cache),
       m_mean_and_var(other.m_mean_and_var ? other.m_mean_and_var->Copy()
                                           : nullptr),
@@ -255,6 +276,9 @@ public:
     m_epsilon = other.m_epsilon;
     m_statistics_group_size = other.m_statistics_group_size;
     m_bessel_correction = other.m_bessel_correction;
+    m_channels_last = other.m_channels_last;
+    m_fused_relu = other.m_fused_relu;
+    m_fused_residual = other.m_fused_residual;
     m_num_per_sum_cache = other.m_num_per_sum_cache;
 
     // Deep copy matrices
@@ -287,8 +311,30 @@ public:
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override
   {
-    return ERROR_SIGNALS | WEIGHTS | PREV_ACTIVATIONS;
+    // A fused ReLU is differentiated from the layer's output
+    return ERROR_SIGNALS | WEIGHTS | PREV_ACTIVATIONS |
+           (m_fused_relu ? ACTIVATIONS : 0);
   }
+  bool supports_recomputation() const override { return false; }
+
+  /** @brief Fuse a following residual sum and/or ReLU.
+   *
+   *  Accepts a two-input sum layer (the other input becomes this
+   *  layer's second input) followed by a ReLU layer, so that the
+   *  common BN-Add-ReLU pattern reads and writes each activation
+   *  tensor once in each direction.
+   */
+  bool fuse_child(Layer const& child) override;
+
+  /** @brief Per-channel map applied at inference, y = scale*x + shift.
+   *
+   *  Computed from the running statistics and the learned scale and
+   *  bias. Returns false if the layer also applies a fused ReLU or
+   *  residual, or stores tensors channels-last, since it is then not
+   *  an affine map of the channels-first input alone.
+   */
+  bool get_inference_affine(El::Matrix<AccT, El::Device::CPU>& scale,
+                            El::Matrix<AccT, El::Device::CPU>& shift) const;
 
   description get_description() const override
   {
@@ -297,6 +343,8 @@ public:
     desc.add("Epsilon", m_epsilon);
     desc.add("Statistics group size", m_statistics_group_size);
     desc.add("Bessel's correction", m_bessel_correction);
+    desc.add("Tensor layout",
+             m_channels_last ? "channels-last" : "channels-first");
     return desc;
   }
 
@@ -304,7 +352,7 @@ public:
   ///@{
 
   template <typename ArchiveT>
-  void serialize(ArchiveT& ar);
+  void serialize(ArchiveT& ar, std::uint32_t const version);
 
   ///@}
 
@@ -315,14 +363,35 @@ protected:
   void setup_dims() override
   {
     data_type_layer<TensorDataType>::setup_dims();
+    if (m_fused_residual &&
+        this->get_input_dims(1) != this->get_input_dims(0)) {
+      std::stringstream err;
+      err << get_type() << " layer \"" << this->get_name() << "\" "
+          << "has input tensors with incompatible dimensions (";
+      for (int j = 0; j < 2; ++j) {
+        const auto& dims = this->get_input_dims(j);
+        err << (j > 0 ? ", " : "");
+        for (size_t k = 0; k < dims.size(); ++k) {
+          err << (k > 0 ? " x " : "") << dims[k];
+        }
+      }
+      err << ")";
+      LBANN_ERROR(err.str());
+    }
     this->set_output_dims(this->get_input_dims());
   }
 
+  /** Number of channels in the output tensor. */
+  int get_num_channels() const
+  {
+    const auto& dims = this->get_output_dims();
+    return m_channels_last ? dims.back() : dims.front();
+  }
+
   void setup_data(size_t max_mini_batch_size) override
   {
     data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
-    const auto& output_dims = this->get_output_dims();
-    const auto& num_channels = output_dims[0];
+    const auto& num_channels = get_num_channels();
 
     // Display warning if mini-batch size is small
     const auto& output = this->get_activations();
@@ -481,7 +550,8 @@ protected:
 protected:
   bool is_distconv_supported() const override
   {
-    return Dev == El::Device::GPU && T_layout == data_layout::DATA_PARALLEL;
+    return Dev == El::Device::GPU && T_layout == data_layout::DATA_PARALLEL &&
+           !m_channels_last && !m_fused_relu && !m_fused_residual;
   }
   void setup_distconv_adapter() override
   {
@@ -498,6 +568,31 @@ protected:
 
 LBANN_DEFINE_LAYER_BUILDER(batch_normalization);
 
+/** @brief Inference-time affine map of a batch normalization layer.
+ *
+ *  Helper for layers that fold a batch normalization child into their
+ *  weights (see Layer::fold_child_into_weights).
+ *
+ *  @returns False if @c l is not a channels-first batch normalization
+ *           layer of type @c T on device @c D without fused children.
+ */
+template <typename T, El::Device D>
+bool get_batch_normalization_affine(Layer const& l,
+                                    El::Matrix<T, El::Device::CPU>& scale,
+                                    El::Matrix<T, El::Device::CPU>& shift)
+{
+  using LayerType =
+    batch_normalization_layer<T, data_layout::DATA_PARALLEL, D>;
+  auto const* bn = dynamic_cast<LayerType const*>(&l);
+  El::Matrix<typename LayerType::AccT, El::Device::CPU> acc_scale, acc_shift;
+  if (bn == nullptr || !bn->get_inference_affine(acc_scale, acc_shift)) {
+    return false;
+  }
+  El::Copy(acc_scale, scale);
+  El::Copy(acc_shift, shift);
+  return true;
+}
+
 #ifndef LBANN_BATCH_NORMALIZATION_LAYER_INSTANTIATE
 #define PROTO_DEVICE(T, Device)                                                \
   extern template class batch_normalization_layer<T,                           \
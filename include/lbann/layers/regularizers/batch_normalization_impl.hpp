@@ -44,6 +44,56 @@ void batch_normalization_layer<T, L, D>::write_specific_proto(
   msg->set_decay(m_decay);
   msg->set_epsilon(m_epsilon);
   msg->set_statistics_group_size(m_statistics_group_size);
+  msg->set_channels_last(m_channels_last);
+}
+
+template <typename T, data_layout L, El::Device D>
+bool batch_normalization_layer<T, L, D>::fuse_child(Layer const& child)
+{
+  if (m_fused_relu || child.get_data_layout() != L ||
+      child.get_device_allocation() != D ||
+      dynamic_cast<data_type_layer<T> const*>(&child) == nullptr) {
+    return false;
+  }
+  if (child.get_type() == "ReLU") {
+    m_fused_relu = true;
+    return true;
+  }
+  // The residual is added before the ReLU, so it must come first
+  if (child.get_type() == "sum" && child.get_num_parents() == 2 &&
+      !m_fused_residual) {
+    m_fused_residual = true;
+    this->m_expected_num_parent_layers = 2;
+    return true;
+  }
+  return false;
+}
+
+template <typename T, data_layout L, El::Device D>
+bool batch_normalization_layer<T, L, D>::get_inference_affine(
+  El::Matrix<AccT, El::Device::CPU>& scale,
+  El::Matrix<AccT, El::Device::CPU>& shift) const
+{
+  if (m_fused_relu || m_fused_residual || m_channels_last ||
+      this->num_weights() != 4) {
+    return false;
+  }
+  El::Matrix<T, El::Device::CPU> gamma, beta, mean, var;
+  El::Copy(this->weights_values(0).LockedMatrix(), gamma);
+  El::Copy(this->weights_values(1).LockedMatrix(), beta);
+  El::Copy(this->weights_values(2).LockedMatrix(), mean);
+  El::Copy(this->weights_values(3).LockedMatrix(), var);
+  const El::Int num_channels = gamma.Height();
+  scale.Resize(num_channels, 1);
+  shift.Resize(num_channels, 1);
+  for (El::Int channel = 0; channel < num_channels; ++channel) {
+    const AccT inv_stdev =
+      1 / El::Sqrt(static_cast<AccT>(var(channel, 0)) + m_epsilon);
+    scale(channel, 0) = static_cast<AccT>(gamma(channel, 0)) * inv_stdev;
+    shift(channel, 0) = static_cast<AccT>(beta(channel, 0)) -
+                        static_cast<AccT>(mean(channel, 0)) * scale(channel, 0);
+  }
+  return true;
 }
 
 #ifdef LBANN_HAS_DISTCONV
@@ -28,10 +28,6 @@
 #define LBANN_LAYER_REGULARIZER_DROPOUT_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
-#ifdef LBANN_HAS_DNN_LIB
-#include "lbann/utils/dnn_lib/dropout.hpp"
-#include "lbann/utils/dnn_lib/helpers.hpp"
-#endif // LBANN_HAS_DNN_LIB
 #include "lbann/utils/random_number_generators.hpp"
 
 namespace lbann {
@@ -62,52 +58,11 @@ public:
 public:
   /** Keep units with probabiliy keep_prob. */
   dropout(EvalType keep_prob = EvalType(0.5))
-    : data_type_layer<TensorDataType>(nullptr),
-      m_keep_prob(keep_prob)
-#ifdef LBANN_HAS_DNN_LIB
-      ,
-      m_tensors_dnn_desc(this)
-#endif // LBANN_HAS_DNN_LIB
+    : data_type_layer<TensorDataType>(nullptr), m_keep_prob(keep_prob)
   {}
 
-  dropout(const dropout& other)
-    : data_type_layer<TensorDataType>(other),
-      m_keep_prob(other.m_keep_prob),
-      m_mask(other.m_mask ? other.m_mask->Copy() : nullptr)
-#ifdef LBANN_HAS_DNN_LIB
-      ,
-      m_tensors_dnn_desc(other.m_tensors_dnn_desc)
-#endif // LBANN_HAS_DNN_LIB
-  {
-#ifdef LBANN_HAS_DNN_LIB
-    m_tensors_dnn_desc.set_layer(this);
-    m_states = other.m_states;
-    m_reserve_space = other.m_reserve_space;
-    if (other.m_dropout_dnn_desc != nullptr) {
-      setup_dropout_dnn_desc();
-    }
-#endif // LBANN_HAS_DNN_LIB
-  }
-
-  dropout& operator=(const dropout& other)
-  {
-    data_type_layer<TensorDataType>::operator=(other);
-    m_keep_prob = other.m_keep_prob;
-    m_mask = other.m_mask
-               ? std::unique_ptr<AbsDistMatrixType>(other.m_mask->Copy())
-               : nullptr;
-#ifdef LBANN_HAS_DNN_LIB
-    m_tensors_dnn_desc = other.m_tensors_dnn_desc;
-    m_tensors_dnn_desc.set_layer(this);
-    m_states = other.m_states;
-    m_reserve_space = other.m_reserve_space;
-    if (other.m_dropout_dnn_desc != nullptr) {
-      setup_dropout_dnn_desc();
-    }
-#endif // LBANN_HAS_DNN_LIB
-    return *this;
-  }
-
+  dropout(const dropout& other) = default;
+  dropout& operator=(const dropout& other) = default;
   ~dropout() override = default;
 
   dropout* copy() const override { return new dropout(*this); }
@@ -116,6 +71,7 @@ public:
   El::Device get_device_allocation() const override { return Dev; }
   bool can_run_inplace() const override { return true; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool supports_recomputation() const override { return false; }
 
   description get_description() const override
   {
@@ -149,100 +105,52 @@ protected:
   void setup_data(size_t max_mini_batch_size) override
   {
     data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
-    m_mask = std::unique_ptr<AbsDistMatrixType>(this->get_activations().Copy());
-  }
 
-  void setup_gpu() override
-  {
-    data_type_layer<TensorDataType>::setup_gpu();
-#ifndef LBANN_HAS_DNN_LIB
-    LBANN_ERROR("DNN library not detected");
-#else
-
-#ifdef LBANN_DETERMINISTIC
-    /// @todo GPU implementation of dropout with sequential consistency
-    if (this->get_comm()->am_trainer_master()) {
-      LBANN_WARNING(this->get_type(),
-                    " layer \"",
-                    this->get_name(),
-                    "\" ",
-                    "does not guarantee sequential consistency");
-    }
-#endif // LBANN_DETERMINISTIC
-
-    // Initialize DNN library objects
-    setup_dropout_dnn_desc();
-
-#endif // LBANN_HAS_DNN_LIB
+    // Every rank derives the same mask seeds, so masks only depend on
+    // the global position of each entry
+    m_seed_base = get_generator()();
+    this->get_comm()->trainer_broadcast(0, m_seed_base);
   }
 
-  void fp_compute() override
-  {
-    if (this->using_gpus()) {
-      fp_compute_gpu();
-    }
-    else {
-      fp_compute_cpu();
-    }
-  }
+  void fp_compute() override;
 
-  void bp_compute() override
-  {
-    if (this->using_gpus()) {
-      bp_compute_gpu();
-    }
-    else {
-      bp_compute_cpu();
-    }
-  }
+  void bp_compute() override;
 
 private:
-  void fp_compute_cpu();
-
-  /** Adjust gradients for dropout in backprop. */
-  void bp_compute_cpu();
-
-  void fp_compute_gpu();
-
-  void bp_compute_gpu();
-
-#ifdef LBANN_HAS_DNN_LIB
-  /** Setup DNN library dropout descriptor and RNG state.
+  /** Multiply by the current dropout mask, i.e. keep each entry with
+   *  probability keep_prob and scale the kept entries by 1/keep_prob.
    */
-  void setup_dropout_dnn_desc()
-  {
-
-    // Setup RNG state
-    size_t size = dnn_lib::get_dropout_states_size();
-    m_states.Resize((size + sizeof(TensorDataType) - 1) /
-                      sizeof(TensorDataType),
-                    1);
-
-    // Setup dropout descriptor
-    m_dropout_dnn_desc.set(float(1 - m_keep_prob),
-                           m_states.Buffer(),
-                           m_states.Height() * sizeof(TensorDataType),
-                           get_generator()());
-  }
-#endif // LBANN_HAS_DNN_LIB
+  void apply_mask(const AbsDistMatrixType& input,
+                  AbsDistMatrixType& output) const;
 
   /** Probability of keeping each unit. */
   EvalType m_keep_prob;
-  /** Current dropout mask (a scaled Bernoulli random matrix). */
-  std::unique_ptr<AbsDistMatrixType> m_mask;
-
-#ifdef LBANN_HAS_DNN_LIB
-  /** Dropout DNN library descriptor. */
-  dnn_lib::DropoutDescriptor m_dropout_dnn_desc;
-  /** Tensor DNN library descriptors. */
-  dnn_lib::entrywise_layer_tensor_manager<TensorDataType> m_tensors_dnn_desc;
-  /** RNG state for DNN library dropout. */
-  El::Matrix<TensorDataType, El::Device::GPU> m_states;
-  /** Work space for DNN library dropout. */
-  El::Matrix<TensorDataType, El::Device::GPU> m_reserve_space;
-#endif // LBANN_HAS_DNN_LIB
+  /** Seed of the mask sequence, the same on every rank. */
+  uint64_t m_seed_base = 0;
+  /** Number of masks drawn so far. */
+  uint64_t m_num_masks = 0;
+  /** Seed of the current dropout mask (see dropout_mask::keep).
+   *
+   *  The mask is regenerated from it in backprop instead of being
+   *  stored.
+   */
+  uint64_t m_mask_seed = 0;
 };
 
+#ifdef LBANN_HAS_GPU
+/** @brief Apply a regenerated dropout mask on the GPU
+ *
+ *  See dropout_mask::keep. @c input and @c output may be the same
+ *  matrix.
+ */
+template <typename TensorDataType>
+void apply_dropout_mask_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
+                            El::AbstractDistMatrix<TensorDataType>& output,
+                            uint64_t seed,
+                            uint32_t threshold,
+                            TensorDataType scale);
+#endif // LBANN_HAS_GPU
+
 template <typename T, data_layout L, El::Device D>
 using dropout_layer = dropout<T, L, D>;
 
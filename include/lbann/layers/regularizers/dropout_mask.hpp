@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYER_REGULARIZER_DROPOUT_MASK_HPP_INCLUDED
+#define LBANN_LAYER_REGULARIZER_DROPOUT_MASK_HPP_INCLUDED
+
+#include "lbann/utils/hash.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined __CUDACC__ || defined __HIPCC__
+#define LBANN_DROPOUT_MASK_FUNC __host__ __device__ __forceinline__
+#else
+#define LBANN_DROPOUT_MASK_FUNC inline
+#endif // __CUDACC__ || __HIPCC__
+
+namespace lbann {
+
+/** @brief Dropout masks that are regenerated instead of stored
+ *
+ *  Whether an entry is kept is a counter-based hash of a seed and the
+ *  entry's global position in the tensor. Backprop recomputes the
+ *  forward pass's mask from its seed, so no mask or reserve space is
+ *  kept between the passes, and the mask does not depend on how the
+ *  tensor is distributed.
+ */
+namespace dropout_mask {
+
+/** @brief Threshold on 24 random bits for a keep probability */
+inline uint32_t keep_threshold(double keep_prob)
+{
+  return static_cast<uint32_t>(std::clamp(keep_prob, 0.0, 1.0) * 16777216.0);
+}
+
+/** @brief Whether the entry at a global position is kept */
+LBANN_DROPOUT_MASK_FUNC bool
+keep(uint64_t seed, uint64_t global_pos, uint32_t threshold)
+{
+  return (splitmix64(seed + global_pos) >> 40) < threshold;
+}
+
+} // namespace dropout_mask
+} // namespace lbann
+
+#undef LBANN_DROPOUT_MASK_FUNC
+
+#endif // LBANN_LAYER_REGULARIZER_DROPOUT_MASK_HPP_INCLUDED
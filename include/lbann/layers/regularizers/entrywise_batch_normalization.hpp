@@ -29,11 +29,14 @@
 
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/layers/layer.hpp"
+#include "lbann/layers/learning/fully_connected.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/layers.pb.h"
 #include "lbann/utils/memory.hpp"
 
+#include <type_traits>
+
 namespace lbann {
 
 /** @brief Entry-wise batch normalization, including scale/bias
@@ -47,6 +50,14 @@ namespace lbann {
  *  Accelerating Deep Network Training by Reducing Internal Covariate
  *  Shift." In International Conference on Machine Learning,
  *  pp. 448-456. 2015.
+ *
+ *  With @c fuse_statistics, a data-parallel layer whose input comes
+ *  from a fully-connected layer with no other children has that
+ *  layer compute the local sums of the mini-batch statistics while
+ *  it applies its bias (see
+ *  fully_connected_layer::set_output_statistics), which saves a pass
+ *  over the input during training. Otherwise the option has no
+ *  effect.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class entrywise_batch_normalization_layer
@@ -67,10 +78,12 @@ public:
 public:
   entrywise_batch_normalization_layer(
     TensorDataType decay = El::To<TensorDataType>(0.9),
-    TensorDataType epsilon = El::To<TensorDataType>(1e-5))
+    TensorDataType epsilon = El::To<TensorDataType>(1e-5),
+    bool fuse_statistics = false)
     : data_type_layer<TensorDataType>(nullptr),
       m_decay(decay),
-      m_epsilon(epsilon)
+      m_epsilon(epsilon),
+      m_fuse_statistics(fuse_statistics)
   {}
 
   entrywise_batch_normalization_layer(
@@ -78,6 +91,7 @@ public:
     : data_type_layer<TensorDataType>(other),
       m_decay(other.m_decay),
       m_epsilon(other.m_epsilon),
+      m_fuse_statistics(other.m_fuse_statistics),
       m_batch_statistics(
         other.m_batch_statistics ? other.m_batch_statistics->Copy() : nullptr),
       m_batch_statistics_gradient(other.m_batch_statistics_gradient
@@ -91,6 +105,8 @@ public:
     data_type_layer<TensorDataType>::operator=(other);
     m_decay = other.m_decay;
     m_epsilon = other.m_epsilon;
+    m_fuse_statistics = other.m_fuse_statistics;
+    m_statistics_from_parent = false;
     m_batch_statistics.reset(
       other.m_batch_statistics ? other.m_batch_statistics->Copy() : nullptr);
     m_batch_statistics_gradient.reset(
@@ -115,15 +131,26 @@ public:
   {
     return ERROR_SIGNALS | PREV_ACTIVATIONS | WEIGHTS;
   }
+  bool supports_recomputation() const override { return false; }
 
   description get_description() const override
   {
     auto desc = data_type_layer<TensorDataType>::get_description();
     desc.add("Decay", m_decay);
     desc.add("Epsilon", m_epsilon);
+    desc.add("Statistics from parent", m_statistics_from_parent);
     return desc;
   }
 
+  /** @brief Per-entry map applied at inference, y = scale*x + shift.
+   *
+   *  Computed from the running statistics. Returns false for
+   *  model-parallel layers, whose statistics are distributed.
+   */
+  bool get_inference_affine(El::Matrix<TensorDataType, El::Device::CPU>& scale,
+                            El::Matrix<TensorDataType, El::Device::CPU>& shift)
+    const;
+
   /** @name Serialization */
   ///@{
 
@@ -188,6 +215,7 @@ protected:
     // Initialize matrices
     m_batch_statistics.reset(AbsDistMatrixType::Instantiate(dist));
     m_batch_statistics_gradient.reset(AbsDistMatrixType::Instantiate(dist));
+    setup_statistics_from_parent();
   }
 
   void fp_compute() override;
@@ -198,6 +226,12 @@ private:
   TensorDataType m_decay;
   /** Small number to avoid division by zero. */
   TensorDataType m_epsilon;
+  /** Whether to take the local sums of the mini-batch statistics from
+   *  a fully-connected parent. */
+  bool m_fuse_statistics = false;
+  /** Whether the parent computes the local sums. Set up again after
+   *  a copy, since the parent's copy is not linked to this one. */
+  bool m_statistics_from_parent = false;
 
   /** @brief Current mini-batch statistics.
    *
@@ -209,8 +243,54 @@ private:
    * These are fused for performance when doing non-local batchnorm.
    */
   std::unique_ptr<AbsDistMatrixType> m_batch_statistics_gradient;
+
+  /** Have a fully-connected parent compute the local sums of the
+   *  mini-batch statistics, if it can. */
+  void setup_statistics_from_parent();
 };
 
+template <typename T, data_layout L, El::Device D>
+void entrywise_batch_normalization_layer<T, L, D>::
+  setup_statistics_from_parent()
+{
+  using ParentType = fully_connected_layer<T, data_layout::DATA_PARALLEL, D>;
+  m_statistics_from_parent = false;
+  if (!m_fuse_statistics || L != data_layout::DATA_PARALLEL ||
+      this->get_num_parents() != 1 || this->distconv_enabled()) {
+    return;
+  }
+  auto* parent = dynamic_cast<ParentType*>(
+    const_cast<Layer*>(&this->get_parent_layer(0)));
+  if (parent == nullptr || parent->get_num_children() != 1 ||
+      parent->has_fused_relu() || parent->distconv_enabled() ||
+      parent->get_grid_tag() != this->get_grid_tag()) {
+    return;
+  }
+  parent->set_output_statistics(m_batch_statistics.get());
+  m_statistics_from_parent = true;
+}
+
+template <typename T, data_layout L, El::Device D>
+bool entrywise_batch_normalization_layer<T, L, D>::get_inference_affine(
+  El::Matrix<T, El::Device::CPU>& scale,
+  El::Matrix<T, El::Device::CPU>& shift) const
+{
+  if (L != data_layout::DATA_PARALLEL || this->num_weights() != 2) {
+    return false;
+  }
+  El::Matrix<T, El::Device::CPU> mean, var;
+  El::Copy(this->weights_values(0).LockedMatrix(), mean);
+  El::Copy(this->weights_values(1).LockedMatrix(), var);
+  const El::Int size = mean.Height();
+  scale.Resize(size, 1);
+  shift.Resize(size, 1);
+  for (El::Int i = 0; i < size; ++i) {
+    scale(i, 0) = 1 / El::Sqrt(var(i, 0) + m_epsilon);
+    shift(i, 0) = -mean(i, 0) * scale(i, 0);
+  }
+  return true;
+}
+
 template <typename T, data_layout L, El::Device D>
 void entrywise_batch_normalization_layer<T, L, D>::write_specific_proto(
   lbann_data::Layer& proto) const
@@ -219,10 +299,38 @@ void entrywise_batch_normalization_layer<T, L, D>::write_specific_proto(
   auto* msg = proto.mutable_entrywise_batch_normalization();
   msg->set_decay(m_decay);
   msg->set_epsilon(m_epsilon);
+  msg->set_fuse_statistics(m_fuse_statistics);
 }
 
 LBANN_DEFINE_LAYER_BUILDER(entrywise_batch_normalization);
 
+/** @brief Inference-time affine map of an entry-wise batch
+ *         normalization layer.
+ *
+ *  Helper for layers that fold an entry-wise batch normalization
+ *  child into their weights (see Layer::fold_child_into_weights).
+ *
+ *  @returns False if @c l is not a data-parallel entry-wise batch
+ *           normalization layer of type @c T on device @c D.
+ */
+template <typename T, El::Device D>
+bool get_entrywise_batch_normalization_affine(
+  Layer const& l,
+  El::Matrix<T, El::Device::CPU>& scale,
+  El::Matrix<T, El::Device::CPU>& shift)
+{
+  // The layer is only instantiated for single and double precision
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+    using LayerType =
+      entrywise_batch_normalization_layer<T, data_layout::DATA_PARALLEL, D>;
+    auto const* layer = dynamic_cast<LayerType const*>(&l);
+    return layer != nullptr && layer->get_inference_affine(scale, shift);
+  }
+  else {
+    return false;
+  }
+}
+
 #ifndef LBANN_ENTRYWISE_BATCH_NORMALIZATION_LAYER_INSTANTIATE
 #define PROTO_DEVICE(T, Device)                                                \
   extern template class entrywise_batch_normalization_layer<                   \
@@ -63,11 +63,11 @@ public:
                TensorDataType scale =
                  El::To<TensorDataType>(1.0507009873554804934193349852946));
 
-  selu_dropout(const selu_dropout& other);
+  selu_dropout(const selu_dropout& other) = default;
 
-  selu_dropout& operator=(const selu_dropout& other);
+  selu_dropout& operator=(const selu_dropout& other) = default;
 
-  ~selu_dropout() final;
+  ~selu_dropout() final = default;
 
   selu_dropout* copy() const final;
 
@@ -80,6 +80,7 @@ public:
   bool can_run_inplace() const override { return true; }
 
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool supports_recomputation() const override { return false; }
 
   void setup_dims() final;
 
@@ -113,8 +114,15 @@ private:
   TensorDataType m_b;
   /** Probability of keeping each unit. */
   TensorDataType m_keep_prob;
-  /** Current dropout mask (a scaled Bernoulli random matrix). */
-  AbsDistMatrixType* m_mask;
+  /** Seed of the mask sequence, the same on every rank. */
+  uint64_t m_seed_base = 0;
+  /** Number of masks drawn so far. */
+  uint64_t m_num_masks = 0;
+  /** Seed of the current dropout mask (see dropout_mask::keep). */
+  uint64_t m_mask_seed = 0;
+
+  /** Whether the entry at a local position of the current mask is kept */
+  bool keep(El::Int row, El::Int col) const;
 };
 
 LBANN_DEFINE_LAYER_BUILDER(selu_dropout);
@@ -87,6 +87,7 @@ public:
   El::Device get_device_allocation() const override;
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool has_tensor_views() const override { return true; }
 
   description get_description() const override;
 
@@ -27,6 +27,7 @@
 #ifndef LBANN_LAYER_CROSS_GRID_SUM_HPP_INCLUDED
 #define LBANN_LAYER_CROSS_GRID_SUM_HPP_INCLUDED
 
+#include "lbann/comm.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/utils/exception.hpp"
 
@@ -55,6 +56,7 @@ public:
   El::Device get_device_allocation() const final { return Dev; }
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool has_tensor_views() const override { return true; }
 
 protected:
   /** Add layer specific data to prototext */
@@ -129,22 +131,14 @@ private:
       El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Dev>&>(
       output);
 
-    auto const syncInfoOutput =
-      El::SyncInfoFromMatrix(output_cast.LockedMatrix());
-
-    const El::Int mloc = output_cast.LocalHeight();
-    const El::Int nloc = output_cast.LocalWidth();
-
-    El::Matrix<TensorDataType, Dev> temp_output(mloc, nloc);
-
-    El::Copy(output_cast.LockedMatrix(), temp_output);
-
-    El::mpi::AllReduce(temp_output.Buffer(),
-                       output_cast.Buffer(),
-                       mloc * nloc,
-                       El::mpi::SUM,
-                       this->get_subgrid_comm(),
-                       syncInfoOutput);
+    // The children wait for the sum, so the other branches keep
+    // running while it is in flight
+    Al::request req;
+    this->get_comm()->nb_allreduce(
+      static_cast<El::AbstractMatrix<TensorDataType>&>(output_cast.Matrix()),
+      this->get_subgrid_comm(),
+      req);
+    this->add_pending_communication(req);
   }
 
   void fp_setup_outputs() final
@@ -193,18 +187,12 @@ private:
 
     El::Copy(gradient_wrt_output, gradient_wrt_input);
 
-    auto& gradient_wrt_input_cast = dynamic_cast<
-      El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Dev>&>(
-      gradient_wrt_input);
-
-    const El::Int mloc = gradient_wrt_input_cast.LocalHeight();
-    const El::Int nloc = gradient_wrt_input_cast.LocalWidth();
-
-    El::Matrix<TensorDataType, Dev> temp_output(mloc, nloc);
-
-    El::Copy(gradient_wrt_input_cast.LockedMatrix(), temp_output);
-
-    El::AllReduce(gradient_wrt_input, this->get_subgrid_comm(), El::mpi::SUM);
+    // The error signals reach the parents once the sum completes
+    Al::request req;
+    this->get_comm()->nb_allreduce(gradient_wrt_input,
+                                   this->get_subgrid_comm(),
+                                   req);
+    this->add_pending_communication(req);
   }
 
   void bp_compute() final {}
@@ -27,6 +27,7 @@
 #ifndef LBANN_LAYER_CROSS_GRID_SUM_SLICE_HPP_INCLUDED
 #define LBANN_LAYER_CROSS_GRID_SUM_SLICE_HPP_INCLUDED
 
+#include "lbann/comm.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/utils/exception.hpp"
 
@@ -55,6 +56,7 @@ public:
   El::Device get_device_allocation() const override { return Dev; }
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool has_tensor_views() const override { return true; }
 
 protected:
   /** Add layer specific data to prototext */
@@ -89,12 +91,33 @@ protected:
 
   void fp_compute() override
   {
+    auto const subgrid_comm_rank = El::mpi::Rank(this->get_subgrid_comm());
+    auto& input = this->get_prev_activations(subgrid_comm_rank);
+
+    // The sum is sliced into the outputs when a child first reads
+    // them, so the other branches keep running while it is in flight
+    El::Copy(input.LockedMatrix(), m_sum);
+    Al::request req;
+    this->get_comm()->nb_allreduce(
+      static_cast<El::AbstractMatrix<TensorDataType>&>(m_sum),
+      this->get_subgrid_comm(),
+      req);
+    this->add_pending_communication(req);
+    m_sum_pending = true;
+  }
+
+  void finalize_pending_communication() override
+  {
+    if (!m_sum_pending) {
+      return;
+    }
+    m_sum_pending = false;
+
     auto const subgrid_comm_rank = El::mpi::Rank(this->get_subgrid_comm());
     auto const subgrid_comm_size = El::mpi::Size(this->get_subgrid_comm());
 
     auto& output = this->get_activations(subgrid_comm_rank);
     auto& input = this->get_prev_activations(subgrid_comm_rank);
-    // El::Copy(input, output);
 
     auto& output_cast = dynamic_cast<
       El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Dev>&>(
@@ -103,20 +126,7 @@ protected:
     auto const sync_info_output =
       El::SyncInfoFromMatrix(output_cast.LockedMatrix());
 
-    const El::Int mloc = input.LocalHeight();
-    const El::Int nloc = input.LocalWidth();
-
-    El::Matrix<TensorDataType, Dev> prev_allreduce(mloc, nloc),
-      after_allreduce(mloc, nloc);
-
-    El::Copy(input.LockedMatrix(), prev_allreduce);
-
-    El::mpi::AllReduce(prev_allreduce.Buffer(),
-                       after_allreduce.Buffer(),
-                       mloc * nloc,
-                       El::mpi::SUM,
-                       this->get_subgrid_comm(),
-                       sync_info_output);
+    const auto& after_allreduce = m_sum;
 
     const auto input_dims = this->get_input_dims();
     int last_dim = input_dims.back();
@@ -221,6 +231,12 @@ protected:
   }
 
   void bp_compute() final {}
+
+private:
+  /** @brief Local sum over the branches, sliced into the outputs once
+   *         its allreduce completes. */
+  El::Matrix<TensorDataType, Dev> m_sum;
+  bool m_sum_pending = false;
 };
 
 #ifndef LBANN_CROSS_GRID_SUM_SLICE_LAYER_INSTANTIATE
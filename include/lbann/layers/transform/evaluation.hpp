@@ -29,6 +29,9 @@
 
 #include "lbann/layers/data_type_layer.hpp"
 
+#include <map>
+#include <utility>
+
 namespace lbann {
 
 /** @brief Interface with objective function and metrics */
@@ -50,9 +53,35 @@ public:
   void set_scale(EvalType scale) { m_scale = scale; }
   /** Set the AMP scaling factor. */
   void set_amp_scale(EvalType scale) { m_amp_scale = scale; }
-  /** Get evaluated value. */
+  /** Get evaluated value.
+   *  With an accumulation window of more than one step, this is the
+   *  mean of the most recent window read back to the host, and does
+   *  not block.
+   */
   EvalType get_value(bool scaled = true);
 
+  /** @brief Accumulate the value over windows of mini-batch steps.
+   *
+   *  With a window of more than one step, forward prop adds the local
+   *  sum to an accumulator on the layer's device instead of reducing
+   *  it every step. The accumulator is reduced across ranks once per
+   *  window, or when the execution mode changes, and copied to the
+   *  host asynchronously. Values are then collected with
+   *  take_accumulated_value.
+   */
+  void set_accumulation_window(size_t steps);
+  /** Number of mini-batch steps per accumulation window. */
+  size_t get_accumulation_window() const noexcept { return m_window; }
+  /** @brief Take the values accumulated for an execution mode.
+   *
+   *  Returns the unscaled sum over samples, and the number of
+   *  samples, of the windows read back since the last call. If
+   *  @c wait is set, the open window is closed and every outstanding
+   *  read-back is waited for; otherwise this does not block.
+   */
+  std::pair<EvalType, El::Int> take_accumulated_value(execution_mode mode,
+                                                      bool wait);
+
   /** Construct an evaluation layer.
    *  The caller is responsible for deallocating the layer.
    */
@@ -78,6 +107,13 @@ protected:
   void bp_compute() override;
 
 private:
+  /** Add this step to the open accumulation window. */
+  void fp_compute_windowed();
+  /** Reduce the open window and start copying it to the host. */
+  void close_window();
+  /** Add a completed read-back to the accumulated values. */
+  void finish_readback(bool wait);
+
   /** Scaling factor to apply to evaluated value. */
   EvalType m_scale = 0;
   /** Scaling factor for automatic mixed precision.
@@ -94,6 +130,35 @@ private:
   /** CUDA event after a non-blocking GPU-CPU memory copy. */
   gpu_lib::event_wrapper m_copy_event;
 #endif // LBANN_HAS_GPU
+
+  /** Mini-batch steps per accumulation window. */
+  size_t m_window = 1;
+  /** Steps in the open window. */
+  size_t m_window_steps = 0;
+  /** Samples in the open window. */
+  El::Int m_window_samples = 0;
+  /** Execution mode of the open window. */
+  execution_mode m_window_mode = execution_mode::invalid;
+  /** Local sum over the open window (CPU). */
+  EvalType m_window_sum = 0;
+#ifdef LBANN_HAS_GPU
+  /** Local sum over the open window (GPU). */
+  El::Matrix<EvalType, El::Device::GPU> m_window_sum_d;
+#endif // LBANN_HAS_GPU
+  /** Reduced sum of the window being read back.
+   *  The value may be stored in pinned memory.
+   */
+  El::Matrix<EvalType, El::Device::CPU> m_readback;
+  /** Whether a window is being read back. */
+  bool m_readback_pending = false;
+  /** Execution mode of the window being read back. */
+  execution_mode m_readback_mode = execution_mode::invalid;
+  /** Samples in the window being read back. */
+  El::Int m_readback_samples = 0;
+  /** Read-back sums and sample counts not yet taken, per mode. */
+  std::map<execution_mode, std::pair<EvalType, El::Int>> m_accumulated;
+  /** Mean of the most recent window read back. */
+  EvalType m_last_window_mean = 0;
 };
 
 /** Evaluation layer.
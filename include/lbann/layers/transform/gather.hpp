@@ -92,6 +92,12 @@ public:
  *  equal to the size of the index vector. The remaining dimensions of
  *  the output tensor are identical to the data tensor.
  *
+ *  The GPU backprop accumulates gradients for duplicate indices with
+ *  atomic additions by default. If @c deterministic is set, it sorts
+ *  the indices and sums duplicates with a segmented reduction
+ *  instead, which is reproducible and faster when indices collide
+ *  heavily.
+ *
  *  @todo Support higher-dimensional data
  */
 template <typename TensorDataType,
@@ -103,7 +109,7 @@ class gather_layer : public data_type_layer<TensorDataType>
                 "gather layer only supports data parallel layout");
 
 public:
-  gather_layer(const int axis);
+  gather_layer(const int axis, bool deterministic = false);
   gather_layer(const gather_layer& other) = default;
   gather_layer& operator=(const gather_layer& other) = default;
 
@@ -146,6 +152,12 @@ protected:
 #endif // LBANN_HAS_DISTCONV && LBANN_HAS_NVSHMEM
 private:
   int m_gather_axis;
+  /** @brief Avoid atomics in the GPU backprop implementation
+   *
+   *  Gradients for duplicate indices are summed in a fixed order
+   *  after sorting the indices, so results are reproducible.
+   */
+  bool m_deterministic;
 };
 
 // =========================================================
@@ -158,11 +170,15 @@ void gather_layer<T, L, D>::write_specific_proto(lbann_data::Layer& proto) const
   proto.set_datatype(proto::ProtoDataType<T>);
   auto* msg = proto.mutable_gather();
   msg->mutable_axis()->set_value(m_gather_axis);
+  msg->set_deterministic(m_deterministic);
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
-gather_layer<TensorDataType, Layout, Device>::gather_layer(const int axis)
-  : data_type_layer<TensorDataType>(nullptr), m_gather_axis{axis}
+gather_layer<TensorDataType, Layout, Device>::gather_layer(const int axis,
+                                                          bool deterministic)
+  : data_type_layer<TensorDataType>(nullptr),
+    m_gather_axis{axis},
+    m_deterministic{deterministic}
 {
   this->m_expected_num_parent_layers = 2;
 }
@@ -221,6 +237,13 @@ void gather_layer<TensorDataType, Layout, Device>::setup_dims()
 #if defined(LBANN_HAS_DISTCONV) && defined(LBANN_HAS_NVSHMEM)
 
   if (this->distconv_enabled()) {
+    if (m_deterministic) {
+      LBANN_WARNING(this->get_type(),
+                    " layer \"",
+                    this->get_name(),
+                    "\" requested deterministic accumulation, but the ",
+                    "distconv implementation uses NVSHMEM atomics");
+    }
     const auto is_values_3D = input0_dims.size() == 3;
     const auto is_indices_3D = input1_dims.size() == 3;
 
@@ -43,7 +43,9 @@ namespace lbann {
  *  index must be accounted for in the permuted array.
  *
  *  The current implementation of this layer is written for
- *  CUDA. Other implementations will be added as needed.
+ *  CUDA. Other implementations will be added as needed. With
+ *  cuTENSOR, a following scale layer is fused into the permutation
+ *  (see Layer::fuse_child).
  */
 template <typename T>
 class PermuteLayer final : public data_type_layer<T>
@@ -77,6 +79,7 @@ public:
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
   description get_description() const final;
+  bool fuse_child(Layer const& child) final;
 
 protected:
   friend class cereal::access;
@@ -91,6 +94,12 @@ protected:
 private:
   class PermuteImpl;
   std::unique_ptr<PermuteImpl> m_impl;
+  /** @brief Product of the scale operators fused into this layer.
+   *
+   *  Applied to the output in forward prop and to the gradient in
+   *  backprop.
+   */
+  double m_fused_scale = 1.0;
 };
 
 #if defined(LBANN_HAS_TENSOR_PERMUTE)
@@ -38,6 +38,7 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/im2col.hpp"
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -66,6 +67,61 @@ inline pooling_mode to_pool_mode(std::string m)
   }
 }
 
+/** @brief Call @c f with a value of the narrowest unsigned type that
+ *         holds offsets within a pooling window of @c pool_size
+ *         entries.
+ */
+template <typename F>
+void dispatch_max_pool_index_type(int pool_size, F&& f)
+{
+  if (pool_size <= 256) {
+    f(uint8_t{});
+  }
+  else if (pool_size <= 65536) {
+    f(uint16_t{});
+  }
+  else {
+    f(uint32_t{});
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+/** @brief Max pooling that records the offset of each max entry
+ *         within its pooling window
+ *
+ *  Tensors are in channels-first order with at most 3 spatial
+ *  dimensions. Offsets are packed into @c indices, which is resized
+ *  as needed (see @c dispatch_max_pool_index_type). Padding entries
+ *  are never selected.
+ */
+template <typename TensorDataType>
+void max_pool_with_indices_gpu(
+  const El::Matrix<TensorDataType, El::Device::GPU>& input,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  El::Matrix<TensorDataType, El::Device::GPU>& indices,
+  const std::vector<int>& input_dims,
+  const std::vector<int>& output_dims,
+  const std::vector<int>& pool_dims,
+  const std::vector<int>& pads,
+  const std::vector<int>& strides);
+
+/** @brief Backprop of max pooling from recorded window offsets
+ *
+ *  Each input entry gathers the gradients of the outputs whose max it
+ *  is, so the result is deterministic with overlapping windows.
+ */
+template <typename TensorDataType>
+void max_unpool_from_indices_gpu(
+  const El::Matrix<TensorDataType, El::Device::GPU>& gradient_wrt_output,
+  const El::Matrix<TensorDataType, El::Device::GPU>& indices,
+  El::Matrix<TensorDataType, El::Device::GPU>& gradient_wrt_input,
+  const std::vector<int>& input_dims,
+  const std::vector<int>& output_dims,
+  const std::vector<int>& pool_dims,
+  const std::vector<int>& pads,
+  const std::vector<int>& strides);
+#endif // LBANN_HAS_GPU
+
 #ifdef LBANN_HAS_DISTCONV
 
 namespace dc {
@@ -120,13 +176,26 @@ private:
   std::vector<int> m_pads;
   /** Pooling strides. */
   std::vector<int> m_strides;
-
-  /** Input indices for max pooling.
-   *  Each entry corresponds to a local entry in the activations
-   *  matrix. The entry gives the index of the maximum entry within
-   *  the pooling window.
+  /** @brief Whether tensors are stored in channels-last order.
+   *  @details If set, input and output dimensions are interpreted
+   *  as (spatial dims..., channels). Only supported with cuDNN.
    */
-  std::vector<int> m_max_pool_indices;
+  bool m_channels_last = false;
+  /** @brief Whether max pooling keeps only window offsets for backprop.
+   *  @details If set, backprop uses @c m_max_pool_indices and neither
+   *  the input nor the output tensor is kept alive for it. On GPU,
+   *  this replaces the DNN library with custom kernels.
+   */
+  bool m_compact_indices = false;
+
+  /** @brief Input indices for max pooling.
+   *  @details Each entry corresponds to a local entry in the
+   *  activations matrix. The entry gives the index of the maximum
+   *  entry within the pooling window. Entries are packed as the type
+   *  chosen by @c dispatch_max_pool_index_type. Always used on CPU
+   *  and used on GPU with compact indices.
+   */
+  El::Matrix<TensorDataType, Dev> m_max_pool_indices;
 
 #ifdef LBANN_HAS_DNN_LIB
   /** Pooling descriptor. */
@@ -183,6 +252,8 @@ public:
       m_pool_size(other.m_pool_size),
       m_pads(other.m_pads),
       m_strides(other.m_strides),
+      m_channels_last(other.m_channels_last),
+      m_compact_indices(other.m_compact_indices),
       m_max_pool_indices(other.m_max_pool_indices)
 #ifdef LBANN_HAS_DNN_LIB
       ,
@@ -204,6 +275,8 @@ public:
     m_pool_size = other.m_pool_size;
     m_pads = other.m_pads;
     m_strides = other.m_strides;
+    m_channels_last = other.m_channels_last;
+    m_compact_indices = other.m_compact_indices;
     m_max_pool_indices = other.m_max_pool_indices;
 #ifdef LBANN_HAS_DNN_LIB
     m_pooling_dnn_desc = other.m_pooling_dnn_desc;
@@ -218,6 +291,20 @@ public:
 
   pooling_layer* copy() const override { return new pooling_layer(*this); }
 
+  /** @brief Store tensors in channels-last (NHWC) order. */
+  void set_channels_last(bool channels_last) noexcept
+  {
+    m_channels_last = channels_last;
+  }
+  bool is_channels_last() const noexcept { return m_channels_last; }
+
+  /** @brief Keep only max pooling window offsets for backprop. */
+  void set_compact_indices(bool compact_indices) noexcept
+  {
+    m_compact_indices = compact_indices;
+  }
+  bool uses_compact_indices() const noexcept { return m_compact_indices; }
+
   /** @name Serialization */
   ///@{
 
@@ -232,6 +319,9 @@ public:
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override
   {
+    if (m_compact_indices) {
+      return ERROR_SIGNALS;
+    }
     return ERROR_SIGNALS | PREV_ACTIVATIONS | ACTIVATIONS;
   }
 
@@ -289,6 +379,13 @@ public:
     }
     desc.add("Pads", ss.str());
 
+    // Tensor layout
+    desc.add("Tensor layout",
+             m_channels_last ? "channels-last" : "channels-first");
+    if (m_compact_indices) {
+      desc.add("Compact indices", m_compact_indices);
+    }
+
     // Result
     return desc;
   }
@@ -303,12 +400,56 @@ protected:
   void setup_dims() override
   {
     data_type_layer<TensorDataType>::setup_dims();
+    if (m_channels_last) {
+#ifndef LBANN_HAS_CUDNN
+      LBANN_ERROR(this->get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" uses a channels-last layout, which requires cuDNN");
+#endif // LBANN_HAS_CUDNN
+      if (Dev == El::Device::CPU) {
+        LBANN_ERROR(this->get_type(),
+                    " layer \"",
+                    this->get_name(),
+                    "\" uses a channels-last layout, ",
+                    "which is not supported on CPU");
+      }
+    }
+    if (m_compact_indices) {
+      if (m_pool_mode != pooling_mode::MAX &&
+          m_pool_mode != pooling_mode::MAX_DETERMINISTIC) {
+        LBANN_ERROR(this->get_type(),
+                    " layer \"",
+                    this->get_name(),
+                    "\" uses compact indices, ",
+                    "which are only supported with max pooling");
+      }
+      if (m_channels_last) {
+        LBANN_ERROR(this->get_type(),
+                    " layer \"",
+                    this->get_name(),
+                    "\" uses compact indices, ",
+                    "which are not supported with a channels-last layout");
+      }
+      if (Dev == El::Device::GPU && m_pool_dims.size() > 3) {
+        LBANN_ERROR(this->get_type(),
+                    " layer \"",
+                    this->get_name(),
+                    "\" uses compact indices, ",
+                    "which are only supported on GPU with at most ",
+                    "3 spatial dimensions");
+      }
+    }
+
+    // Spatial dims are leading in channels-last layout
     const auto& input_dims = this->get_input_dims();
+    const size_t offset = (m_channels_last ? 0 : 1);
     auto output_dims = input_dims;
     for (size_t i = 0; i < output_dims.size() - 1; ++i) {
       const int effective_dim =
-        (input_dims[i + 1] + 2 * m_pads[i] - m_pool_dims[i] + 1);
-      output_dims[i + 1] = (effective_dim + m_strides[i] - 1) / m_strides[i];
+        (input_dims[i + offset] + 2 * m_pads[i] - m_pool_dims[i] + 1);
+      output_dims[i + offset] =
+        (effective_dim + m_strides[i] - 1) / m_strides[i];
     }
     this->set_output_dims(output_dims);
   }
@@ -321,6 +462,8 @@ protected:
     LBANN_ERROR("DNN library not detected");
 #else
 
+    m_tensors_dnn_desc.set_channels_last(m_channels_last);
+
     // Set pooling descriptor
     m_pooling_dnn_desc.set(m_pool_mode,
                            dnn_lib::DNN_PROPAGATE_NAN,
@@ -349,6 +492,12 @@ private:
   /// Pooling forward propagation with im2col
   void bp_compute_im2col();
 
+  /// Max pooling forward propagation that records window offsets
+  void fp_compute_compact();
+
+  /// Max pooling backward propagation from recorded window offsets
+  void bp_compute_compact();
+
 #ifdef LBANN_HAS_DISTCONV
   friend class pooling_distconv_adapter<TensorDataType, T_layout, Dev>;
 
@@ -62,6 +62,7 @@ public:
   El::Device get_device_allocation() const override { return Dev; }
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool has_tensor_views() const override { return true; }
 
 protected:
   /** Add layer specific data to prototext */
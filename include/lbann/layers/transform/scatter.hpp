@@ -91,6 +91,11 @@ public:
  *  The size of the index vector must match the size of the data
  *  tensor along the scatter dimension.
  *
+ *  The GPU implementation accumulates duplicate indices with atomic
+ *  additions by default. If @c deterministic is set, it sorts the
+ *  indices and sums duplicates with a segmented reduction instead,
+ *  which is reproducible and faster when indices collide heavily.
+ *
  *  @todo Support higher-dimensional data
  */
 template <typename TensorDataType,
@@ -102,7 +107,9 @@ class scatter_layer : public data_type_layer<TensorDataType>
                 "scatter layer only supports data parallel layout");
 
 public:
-  scatter_layer(const std::vector<int>& dims, const int axis);
+  scatter_layer(const std::vector<int>& dims,
+                const int axis,
+                bool deterministic = false);
   scatter_layer(const scatter_layer& other) = default;
   scatter_layer& operator=(const scatter_layer& other) = default;
 
@@ -145,6 +152,12 @@ protected:
 #endif // LBANN_HAS_DISTCONV && LBANN_HAS_NVSHMEM
 private:
   int m_scatter_axis;
+  /** @brief Avoid atomics in the GPU implementation
+   *
+   *  Duplicate indices are summed in a fixed order after sorting
+   *  the indices, so results are reproducible.
+   */
+  bool m_deterministic;
 };
 
 // =========================================================
@@ -159,13 +172,17 @@ void scatter_layer<T, L, D>::write_specific_proto(
   auto* msg = proto.mutable_scatter();
   protobuf::assign_to_repeated(*msg->mutable_dims(), this->get_output_dims());
   msg->mutable_axis()->set_value(m_scatter_axis);
+  msg->set_deterministic(m_deterministic);
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 scatter_layer<TensorDataType, Layout, Device>::scatter_layer(
   const std::vector<int>& dims,
-  const int axis)
-  : data_type_layer<TensorDataType>(nullptr), m_scatter_axis{axis}
+  const int axis,
+  bool deterministic)
+  : data_type_layer<TensorDataType>(nullptr),
+    m_scatter_axis{axis},
+    m_deterministic{deterministic}
 {
   this->m_expected_num_parent_layers = 2;
   this->set_output_dims(dims);
@@ -223,6 +240,13 @@ void scatter_layer<TensorDataType, Layout, Device>::setup_dims()
 #if defined(LBANN_HAS_DISTCONV) && defined(LBANN_HAS_NVSHMEM)
 
   if (this->distconv_enabled()) {
+    if (m_deterministic) {
+      LBANN_WARNING(this->get_type(),
+                    " layer \"",
+                    this->get_name(),
+                    "\" requested deterministic accumulation, but the ",
+                    "distconv implementation uses NVSHMEM atomics");
+    }
     const auto is_values_3D = input0_dims.size() == 3;
     const auto is_indices_3D = input1_dims.size() == 3;
     const auto is_output_3D = output_dims.size() == 3;
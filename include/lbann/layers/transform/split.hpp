@@ -92,6 +92,7 @@ public:
   El::Device get_device_allocation() const override { return Dev; }
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool has_tensor_views() const override { return true; }
 
 #ifdef LBANN_HAS_ONNX
   void fill_onnx_node(onnx::GraphProto& graph) const override;
@@ -114,6 +115,13 @@ protected:
     }
   }
 
+  bool outputs_alias(int output_index, int other_index) const override
+  {
+    // Without sub-graph parallelism, every output views the input
+    return !this->subgraph_parallelism_execution() ||
+           output_index == other_index;
+  }
+
   void fp_setup_outputs() override
   {
     const auto& input = this->get_prev_activations();
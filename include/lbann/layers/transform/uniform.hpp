@@ -80,6 +80,7 @@ public:
   El::Device get_device_allocation() const override { return Dev; }
   bool can_run_inplace() const override { return false; }
   int get_backprop_requirements() const override { return ERROR_SIGNALS; }
+  bool supports_recomputation() const override { return false; }
 
   description get_description() const override
   {
@@ -186,18 +186,23 @@ private:
       // Populate im2col matrix
       const TensorDataType* prev_activations_buffer =
         prev_activations_local.LockedBuffer(0, sample);
-      const int* indices_buffer =
-        &hint_layer.m_max_pool_indices[sample * this->get_input_size()];
-      LBANN_OMP_PARALLEL_FOR
-      for (int channel = 0; channel < num_channels; ++channel) {
-        for (int j = 0; j < num_per_input_channel; ++j) {
-          const int input_index = j + channel * num_per_input_channel;
-          const int max_index = indices_buffer[input_index];
-          TensorDataType* im2col_buffer =
-            im2col_mat.Buffer(channel * pool_size, j);
-          im2col_buffer[max_index] = prev_activations_buffer[input_index];
+      dispatch_max_pool_index_type(pool_size, [&](auto index) {
+        using IndexType = decltype(index);
+        const IndexType* indices_buffer =
+          reinterpret_cast<const IndexType*>(
+            hint_layer.m_max_pool_indices.LockedBuffer()) +
+          sample * this->get_input_size();
+        LBANN_OMP_PARALLEL_FOR
+        for (int channel = 0; channel < num_channels; ++channel) {
+          for (int j = 0; j < num_per_input_channel; ++j) {
+            const int input_index = j + channel * num_per_input_channel;
+            const int max_index = indices_buffer[input_index];
+            TensorDataType* im2col_buffer =
+              im2col_mat.Buffer(channel * pool_size, j);
+            im2col_buffer[max_index] = prev_activations_buffer[input_index];
+          }
         }
-      }
+      });
 
       // Convert im2col matrix to output matrix
       DMatDT output_mat = El::View(activations_local, El::ALL, El::IR(sample));
@@ -258,18 +263,23 @@ private:
 
       // Propagate error signal based on pooling layer
       TensorDataType* output_buffer = error_signal_local.Buffer(0, sample);
-      const int* indices_buffer =
-        &hint_layer.m_max_pool_indices[sample * this->get_input_size()];
-      LBANN_OMP_PARALLEL_FOR
-      for (int channel = 0; channel < num_channels; ++channel) {
-        for (int j = 0; j < num_per_output_channel; ++j) {
-          const int output_index = j + channel * num_per_output_channel;
-          const int max_index = indices_buffer[output_index];
-          TensorDataType* im2col_buffer =
-            im2col_mat.Buffer(channel * pool_size, j);
-          output_buffer[output_index] = im2col_buffer[max_index];
+      dispatch_max_pool_index_type(pool_size, [&](auto index) {
+        using IndexType = decltype(index);
+        const IndexType* indices_buffer =
+          reinterpret_cast<const IndexType*>(
+            hint_layer.m_max_pool_indices.LockedBuffer()) +
+          sample * this->get_input_size();
+        LBANN_OMP_PARALLEL_FOR
+        for (int channel = 0; channel < num_channels; ++channel) {
+          for (int j = 0; j < num_per_output_channel; ++j) {
+            const int output_index = j + channel * num_per_output_channel;
+            const int max_index = indices_buffer[output_index];
+            TensorDataType* im2col_buffer =
+              im2col_mat.Buffer(channel * pool_size, j);
+            output_buffer[output_index] = im2col_buffer[max_index];
+          }
         }
-      }
+      });
     }
   }
 };
@@ -185,6 +185,12 @@ public:
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
 
+  upsample_mode get_upsample_mode() const noexcept { return m_upsample_mode; }
+  const std::vector<int>& get_scale_factors() const noexcept
+  {
+    return m_scale_factors;
+  }
+
 #ifdef LBANN_HAS_ONNX
   void fill_onnx_node(onnx::GraphProto& graph) const override;
 #endif // LBANN_HAS_ONNX
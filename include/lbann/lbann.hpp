@@ -35,6 +35,9 @@
 
 /// Training Algorithms
 #include "lbann/execution_algorithms/batch_functional_inference_algorithm.hpp"
+#include "lbann/execution_algorithms/co_scheduled_training.hpp"
+#include "lbann/execution_algorithms/ensemble_inference.hpp"
+#include "lbann/execution_algorithms/inference_server.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 
 /// Models
@@ -49,6 +52,7 @@
 
 /// Image layers
 #include "lbann/layers/image/bilinear_resize.hpp"
+#include "lbann/layers/image/image_augmentation.hpp"
 
 /// Learning layers
 #include "lbann/layers/learning/channelwise_scale_bias.hpp"
@@ -70,6 +74,7 @@
 
 /// Math layers
 #include "lbann/layers/math/matmul.hpp"
+#include "lbann/layers/math/scaled_dot_product_attention.hpp"
 
 /// Transform layers
 #include "lbann/layers/transform/bernoulli.hpp"
@@ -127,6 +132,7 @@
 
 /// Data readers
 #include "lbann/data_ingestion/readers/data_reader_cifar10.hpp"
+#include "lbann/data_ingestion/readers/data_reader_columnar.hpp"
 #include "lbann/data_ingestion/readers/data_reader_csv.hpp"
 #include "lbann/data_ingestion/readers/data_reader_jag_conduit.hpp"
 #include "lbann/data_ingestion/readers/data_reader_merge_features.hpp"
@@ -160,6 +166,7 @@
 
 /// Callbacks
 #include "lbann/callbacks/alternate_updates.hpp"
+#include "lbann/callbacks/calibrate_int8.hpp"
 #include "lbann/callbacks/check_dataset.hpp"
 #include "lbann/callbacks/check_gradients.hpp"
 #include "lbann/callbacks/check_init.hpp"
@@ -184,6 +191,7 @@
 #include "lbann/callbacks/load_model.hpp"
 #include "lbann/callbacks/ltfb.hpp"
 #include "lbann/callbacks/memory_profiler.hpp"
+#include "lbann/callbacks/memory_replica.hpp"
 #include "lbann/callbacks/mixup.hpp"
 #include "lbann/callbacks/monitor_io.hpp"
 #include "lbann/callbacks/perturb_adam.hpp"
@@ -210,6 +218,8 @@
 #include "lbann/optimizers/adagrad.hpp"
 #include "lbann/optimizers/adam.hpp"
 #include "lbann/optimizers/hypergradient_adam.hpp"
+#include "lbann/optimizers/lamb.hpp"
+#include "lbann/optimizers/lars.hpp"
 #include "lbann/optimizers/rmsprop.hpp"
 #include "lbann/optimizers/sgd.hpp"
 
@@ -72,4 +72,69 @@
   LBANN_ADD_PORTABLE_BINARY_SERIALIZE_ETI(__VA_ARGS__);                        \
   LBANN_ADD_XML_SERIALIZE_ETI(__VA_ARGS__)
 
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+#define LBANN_ADD_BINARY_VERSIONED_SERIALIZE_ETI(...)                          \
+  template void __VA_ARGS__::serialize(cereal::BinaryOutputArchive&,           \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(cereal::BinaryInputArchive&,            \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(RootedBinaryOutputArchive&,             \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(RootedBinaryInputArchive&,              \
+                                       std::uint32_t)
+#else
+#define LBANN_ADD_BINARY_VERSIONED_SERIALIZE_ETI(...)
+#endif
+
+#ifdef LBANN_HAS_CEREAL_JSON_ARCHIVES
+#define LBANN_ADD_JSON_VERSIONED_SERIALIZE_ETI(...)                            \
+  template void __VA_ARGS__::serialize(cereal::JSONOutputArchive&,             \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(cereal::JSONInputArchive&,              \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(RootedJSONOutputArchive&,               \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(RootedJSONInputArchive&,                \
+                                       std::uint32_t)
+#else
+#define LBANN_ADD_JSON_VERSIONED_SERIALIZE_ETI(...)
+#endif
+
+#ifdef LBANN_HAS_CEREAL_PORTABLE_BINARY_ARCHIVES
+#define LBANN_ADD_PORTABLE_BINARY_VERSIONED_SERIALIZE_ETI(...)                 \
+  template void __VA_ARGS__::serialize(cereal::PortableBinaryOutputArchive&,   \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(cereal::PortableBinaryInputArchive&,    \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(RootedPortableBinaryOutputArchive&,     \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(RootedPortableBinaryInputArchive&,      \
+                                       std::uint32_t)
+#else
+#define LBANN_ADD_PORTABLE_BINARY_VERSIONED_SERIALIZE_ETI(...)
+#endif
+
+#ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
+#define LBANN_ADD_XML_VERSIONED_SERIALIZE_ETI(...)                             \
+  template void __VA_ARGS__::serialize(cereal::XMLOutputArchive&,              \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(cereal::XMLInputArchive&,               \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(RootedXMLOutputArchive&,                \
+                                       std::uint32_t);                         \
+  template void __VA_ARGS__::serialize(RootedXMLInputArchive&,                 \
+                                       std::uint32_t)
+#else
+#define LBANN_ADD_XML_VERSIONED_SERIALIZE_ETI(...)
+#endif
+
+/** @brief Instantiate serialize(ArchiveT&, std::uint32_t) for classes
+ *         with a Cereal class version (see CEREAL_CLASS_VERSION).
+ */
+#define LBANN_ADD_ALL_VERSIONED_SERIALIZE_ETI(...)                             \
+  LBANN_ADD_BINARY_VERSIONED_SERIALIZE_ETI(__VA_ARGS__);                       \
+  LBANN_ADD_JSON_VERSIONED_SERIALIZE_ETI(__VA_ARGS__);                         \
+  LBANN_ADD_PORTABLE_BINARY_VERSIONED_SERIALIZE_ETI(__VA_ARGS__);              \
+  LBANN_ADD_XML_VERSIONED_SERIALIZE_ETI(__VA_ARGS__)
+
 #define LBANN_REGISTER_DYNAMIC_INIT(NAME) CEREAL_REGISTER_DYNAMIC_INIT(NAME)
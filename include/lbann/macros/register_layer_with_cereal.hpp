@@ -32,7 +32,9 @@
  *
  *  Define LBANN_LAYER_NAME to be the full layer class name before
  *  including this file. Don't include this file inside the lbann
- *  namespace.
+ *  namespace. If LBANN_LAYER_CLASS_VERSION is defined, the layer is
+ *  registered with that Cereal class version and its serialize
+ *  function takes the version as second argument.
  */
 
 #undef LBANN_COMMA
@@ -43,6 +45,19 @@
 
 #define LBANN_COMMA ,
 
+#ifdef LBANN_LAYER_CLASS_VERSION
+#define LBANN_REGISTER_LAYER_WITH_CEREAL_BASE(NAME, TYPE, LAYOUT, DEVICE)      \
+  CEREAL_CLASS_VERSION(                                                        \
+    ::lbann::NAME<                                                             \
+      TYPE LBANN_COMMA ::lbann::data_layout::LAYOUT LBANN_COMMA DEVICE>,       \
+    LBANN_LAYER_CLASS_VERSION)                                                 \
+  LBANN_ADD_ALL_VERSIONED_SERIALIZE_ETI(                                       \
+    ::lbann::NAME<TYPE, ::lbann::data_layout::LAYOUT, DEVICE>);                \
+  CEREAL_REGISTER_TYPE_WITH_NAME(                                              \
+    ::lbann::NAME<                                                             \
+      TYPE LBANN_COMMA ::lbann::data_layout::LAYOUT LBANN_COMMA DEVICE>,       \
+    #NAME "(" #TYPE "," #LAYOUT "," #DEVICE ")")
+#else
 #define LBANN_REGISTER_LAYER_WITH_CEREAL_BASE(NAME, TYPE, LAYOUT, DEVICE)      \
   LBANN_ADD_ALL_SERIALIZE_ETI(                                                 \
     ::lbann::NAME<TYPE, ::lbann::data_layout::LAYOUT, DEVICE>);                \
@@ -50,6 +65,7 @@
     ::lbann::NAME<                                                             \
       TYPE LBANN_COMMA ::lbann::data_layout::LAYOUT LBANN_COMMA DEVICE>,       \
     #NAME "(" #TYPE "," #LAYOUT "," #DEVICE ")")
+#endif // LBANN_LAYER_CLASS_VERSION
 
 #define LBANN_REGISTER_LAYER_WITH_CEREAL(NAME, TYPE, DEVICE)                   \
   LBANN_REGISTER_LAYER_WITH_CEREAL_BASE(NAME, TYPE, DATA_PARALLEL, DEVICE);    \
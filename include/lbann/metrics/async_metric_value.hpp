@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_METRICS_ASYNC_METRIC_VALUE_HPP_INCLUDED
+#define LBANN_METRICS_ASYNC_METRIC_VALUE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <functional>
+#include <future>
+#include <map>
+
+namespace lbann {
+
+// Forward declarations
+class lbann_comm;
+struct metric_statistics;
+
+/** @brief Metric value computed on a side thread
+ *
+ *  Used by metrics that are expensive to evaluate, e.g. by running an
+ *  external program, so that they do not stall training. In each
+ *  pass over the data (an epoch or an evaluation), the first
+ *  mini-batch launches one computation and later mini-batches only
+ *  count their samples. The computation typically reads the latest
+ *  saved weights or outputs.
+ *
+ *  When the pass ends, the computed value is recorded for all of its
+ *  samples. If the computation is still running on any rank in the
+ *  trainer, the previous value is recorded instead and the
+ *  computation is left running for the next pass. Only the first
+ *  value ever recorded waits for its computation. All ranks record
+ *  the same number of values, so statistics stay consistent across
+ *  the trainer.
+ */
+class async_metric_value
+{
+public:
+  using function_type = std::function<EvalType()>;
+
+  async_metric_value() = default;
+  /** Computations in flight are not copied. */
+  async_metric_value(const async_metric_value& other);
+  async_metric_value& operator=(const async_metric_value& other);
+  ~async_metric_value();
+
+  /** @brief Count a mini-batch, launching a computation if none has
+   *  been launched in this pass.
+   *
+   *  @returns The last computed value, or NaN if none is available.
+   */
+  EvalType evaluate(execution_mode mode,
+                    int mini_batch_size,
+                    const function_type& compute);
+
+  /** @brief End the pass and record a value for its samples.
+   *
+   *  Collective over the trainer.
+   */
+  void flush(execution_mode mode,
+             lbann_comm& comm,
+             metric_statistics& statistics);
+
+private:
+  struct state
+  {
+    /** Computation launched in this or an earlier pass */
+    std::future<EvalType> in_flight;
+    /** Whether the current pass has launched a computation */
+    bool launched = false;
+    /** Samples counted since the last flush */
+    int num_samples = 0;
+    /** Last computed value */
+    EvalType last_value = 0;
+    bool has_last_value = false;
+  };
+  std::map<execution_mode, state> m_states;
+};
+
+} // namespace lbann
+
+#endif // LBANN_METRICS_ASYNC_METRIC_VALUE_HPP_INCLUDED
@@ -27,6 +27,7 @@
 #ifndef LBANN_METRIC_EXECUTABLE_METRIC_HPP
 #define LBANN_METRIC_EXECUTABLE_METRIC_HPP
 
+#include "lbann/metrics/async_metric_value.hpp"
 #include "lbann/metrics/metric.hpp"
 
 namespace lbann {
@@ -41,6 +42,12 @@ namespace lbann {
  *  Experiment directory is defined as the trainer name and model name,
  *  separated by a slash (e.g., ``trainer0/model0``). The executable will be
  *  run from the current working directory of the experiment folder itself.
+ *
+ *  If ``asynchronous`` is set, the executable runs in the background
+ *  once per epoch or evaluation, typically on the latest saved
+ *  weights or outputs, and training continues meanwhile (see
+ *  @c async_metric_value). The value reported at the end of a pass
+ *  is the latest one that every rank has finished computing.
  */
 class executable_metric : public metric
 {
@@ -49,8 +56,13 @@ public:
   executable_metric(lbann_comm* comm = nullptr,
                     std::string name = "",
                     std::string filename = "",
-                    std::string other_args = "")
-    : metric(comm), m_name(name), m_filename(filename), m_other_args(other_args)
+                    std::string other_args = "",
+                    bool asynchronous = false)
+    : metric(comm),
+      m_name(name),
+      m_filename(filename),
+      m_other_args(other_args),
+      m_asynchronous(asynchronous)
   {}
   executable_metric(const executable_metric& other) = default;
   executable_metric& operator=(const executable_metric& other) = default;
@@ -80,6 +92,8 @@ public:
   bool save_to_checkpoint_distributed(persist& p) override;
   bool load_from_checkpoint_distributed(persist& p) override;
 
+  void flush_accumulated_values(execution_mode mode) override;
+
 protected:
   void setup(model& m) override;
   EvalType evaluate(execution_mode mode, int mini_batch_size) override;
@@ -94,8 +108,14 @@ private:
   /** Arguments to prepend before experiment path. */
   std::string m_other_args;
 
+  /** Whether the executable runs in the background. */
+  bool m_asynchronous;
+
   /** Full command line to run. */
   std::string m_cmd;
+
+  /** Executable runs in flight. */
+  async_metric_value m_async_value;
 };
 
 } // namespace lbann
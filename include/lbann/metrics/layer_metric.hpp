@@ -81,6 +81,7 @@ public:
 protected:
   void setup(model& m) override;
   EvalType evaluate(execution_mode mode, int mini_batch_size) override;
+  void flush_accumulated_values(execution_mode mode) override;
 
 private:
   /** Descriptive name for metric. */
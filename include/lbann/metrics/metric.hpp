@@ -122,6 +122,11 @@ public:
    */
   virtual EvalType evaluate(execution_mode mode, int mini_batch_size) = 0;
 
+  /** Add values still being accumulated to the statistics, waiting
+   *  for any in flight.
+   */
+  virtual void flush_accumulated_values(execution_mode mode) {}
+
   /** Clear all statistics. */
   void reset_statistics()
   {
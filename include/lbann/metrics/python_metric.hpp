@@ -27,6 +27,7 @@
 #ifndef LBANN_METRIC_PYTHON_METRIC_HPP
 #define LBANN_METRIC_PYTHON_METRIC_HPP
 
+#include "lbann/metrics/async_metric_value.hpp"
 #include "lbann/metrics/metric.hpp"
 
 #ifdef LBANN_HAS_EMBEDDED_PYTHON
@@ -53,6 +54,12 @@ namespace lbann {
  *  prototype would be:
  *  ``def evaluate(experiment_path: str, rank: int) -> float: ...``
  *
+ *  If ``asynchronous`` is set, the function runs on a side thread
+ *  once per epoch or evaluation, typically on the latest saved
+ *  weights or outputs, and training continues meanwhile (see
+ *  @c async_metric_value). The value reported at the end of a pass
+ *  is the latest one that every rank has finished computing.
+ *
  *  Note that this metric is only available if LBANN was compiled with Python
  *  support.
  */
@@ -64,12 +71,14 @@ public:
                 std::string name = "",
                 std::string module = "",
                 std::string module_dir = "",
-                std::string function = "")
+                std::string function = "",
+                bool asynchronous = false)
     : metric(comm),
       m_name(name),
       m_module(module),
       m_module_dir(module_dir),
-      m_function(function)
+      m_function(function),
+      m_asynchronous(asynchronous)
   {}
   python_metric(const python_metric& other) = default;
   python_metric& operator=(const python_metric& other) = default;
@@ -96,6 +105,8 @@ public:
   bool save_to_checkpoint_distributed(persist& p) override;
   bool load_from_checkpoint_distributed(persist& p) override;
 
+  void flush_accumulated_values(execution_mode mode) override;
+
 protected:
   void setup(model& m) override;
   EvalType evaluate(execution_mode mode, int mini_batch_size) override;
@@ -113,10 +124,20 @@ private:
   /** Python function to call in module. */
   std::string m_function;
 
+  /** Whether the function runs on a side thread. */
+  bool m_asynchronous;
+
 #ifdef LBANN_HAS_EMBEDDED_PYTHON
   python::object m_evaluate_function;
   std::string m_model_dir;
 #endif
+
+  /** Function calls in flight. Declared last so that they finish
+   *  before the function is released. */
+  async_metric_value m_async_value;
+
+  /** Call the Python function. */
+  EvalType call_function(int rank);
 };
 
 } // namespace lbann
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_MODELS_ACTIVATION_MEMORY_PLANNER_HPP_INCLUDED
+#define LBANN_MODELS_ACTIVATION_MEMORY_PLANNER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <iosfwd>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class Layer;
+class model;
+
+/** @brief Places layer activations and error signals in pooled arenas.
+ *
+ *  Without a plan, every layer allocates its own output activations
+ *  and error signals, and the reference counter releases activations
+ *  once their last consumer has run. The planner instead computes the
+ *  lifetime of each tensor over one training step and packs tensors
+ *  that are never live at the same time into the same region of an
+ *  arena. There is one arena per device.
+ *
+ *  A step is numbered by layer in execution order: forward prop of
+ *  layer @c k is step @c k and its backward prop is step
+ *  <tt>2N-1-k</tt> for @c N layers. An activation is live from its
+ *  layer's forward prop until the last of the child's forward prop,
+ *  the child's backward prop if it needs its previous activations,
+ *  the layer's own backward prop if it needs its activations, and
+ *  the rerun of the child's checkpointed segment (see
+ *  Layer::is_checkpointed) if it is recomputed. An error signal is
+ *  live from its layer's backward prop until the parent's backward
+ *  prop. Layers that may view tensors (see
+ *  Layer::has_tensor_views) are not planned, and the tensors they
+ *  view stay live as long as the views do. For a model compiled for
+ *  inference only forward prop is planned, so error signals are not
+ *  placed and activations die with their last consumer.
+ */
+class activation_memory_planner
+{
+public:
+  /** @brief Lifetime and placement of one planned tensor. */
+  struct tensor_interval
+  {
+    Layer const* layer = nullptr;
+    /** @brief Child index of an activation or parent index of an
+     *         error signal. */
+    int index = 0;
+    bool error_signal = false;
+    El::Device device = El::Device::CPU;
+    /** @brief Local bytes at the maximum mini-batch size. */
+    size_t bytes = 0;
+    /** @brief First step the tensor is live. */
+    int birth = 0;
+    /** @brief Last step the tensor is live. */
+    int death = 0;
+    /** @brief Offset into the device's arena. */
+    size_t offset = 0;
+  };
+
+  /** @brief Alignment of planned tensors in bytes. */
+  static constexpr size_t alignment = 256;
+
+  /** @brief Plan and allocate the arenas for a model.
+   *
+   *  The model's layers must be set up and sorted in execution order.
+   */
+  void plan(model const& m, El::Int max_mini_batch_size);
+
+  /** @brief Memory reserved for a tensor.
+   *
+   *  @returns nullptr if the tensor is not planned or needs more than
+   *           @c bytes.
+   */
+  El::byte*
+  get_buffer(Layer const& l, int index, bool error_signal, size_t bytes) const;
+
+  /** @brief Whether a pointer lies in one of the arenas. */
+  bool contains(void const* ptr) const noexcept;
+
+  /** @brief Planned tensors. */
+  std::vector<tensor_interval> const& get_intervals() const noexcept
+  {
+    return m_intervals;
+  }
+  /** @brief Size of a device's arena. */
+  size_t get_arena_bytes(El::Device device) const noexcept;
+  /** @brief Memory the planned tensors of a device take when each has
+   *         its own allocation. */
+  size_t get_unshared_bytes(El::Device device) const noexcept;
+  /** @brief Largest memory planned tensors of a device hold at once. */
+  size_t get_peak_live_bytes(El::Device device) const noexcept;
+
+  /** @brief Print arena sizes against unshared and peak usage. */
+  void print_report(std::ostream& os) const;
+
+  /** @brief Assign arena offsets.
+   *
+   *  Tensors are placed largest first, each in the smallest gap
+   *  between tensors with overlapping lifetimes that fits it, or
+   *  after all of them.
+   *
+   *  @returns The arena size.
+   */
+  static size_t assign_offsets(std::vector<tensor_interval*> const& intervals);
+
+private:
+  using key_type = std::tuple<Layer const*, int, bool>;
+
+  /** @brief Planned tensors. */
+  std::vector<tensor_interval> m_intervals;
+  /** @brief Position of each planned tensor in @c m_intervals. */
+  std::map<key_type, size_t> m_positions;
+
+  /** @brief Arena for tensors on the host. */
+  El::simple_buffer<El::byte, El::Device::CPU> m_cpu_arena;
+#ifdef LBANN_HAS_GPU
+  /** @brief Arena for tensors on the GPU. */
+  El::simple_buffer<El::byte, El::Device::GPU> m_gpu_arena;
+#endif // LBANN_HAS_GPU
+};
+
+} // namespace lbann
+
+#endif // LBANN_MODELS_ACTIVATION_MEMORY_PLANNER_HPP_INCLUDED
@@ -28,11 +28,19 @@
 #define LBANN_MODELS_MODEL_HPP_INCLUDED
 
 #include "lbann/base.hpp"
+#include "lbann/execution_algorithms/kfac/kfac_timing.hpp"
 #include "lbann/io/file_io.hpp"
+#include "lbann/models/activation_memory_planner.hpp"
+#include "lbann/models/pipeline_parallelism.hpp"
+#include "lbann/optimizers/gradient_clipping.hpp"
 #include "lbann/proto/factories.hpp"
 #include "lbann/utils/reference_counter.hpp"
 #include "lbann/utils/summary.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
+#include "lbann/weights/flat_weights_buffer.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
 
 #ifdef LBANN_HAS_ONNX
 #include <onnx/onnx_pb.h>
@@ -45,8 +53,11 @@
 // `IncompleteType*`, which is annoying.)
 #include "lbann/proto/optimizers.pb.h"
 
+#include <map>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 // Forward-declare protobuf class
@@ -93,7 +104,7 @@ public:
         std::unique_ptr<lbann_data::Optimizer> default_optimizer_msg = nullptr);
   model(const model& other);
   model& operator=(const model& other);
-  ~model() = default;
+  ~model();
 
   /** @brief Metadata Accessors */
   ///@{
@@ -172,6 +183,14 @@ public:
   /** @brief Register a new callback for the model. */
   void add_callback(std::shared_ptr<callback_base> cb);
 
+  /** @brief Replace the callbacks of the model.
+   *
+   *  The callbacks are not set up for this model, so this is meant
+   *  for a copy of a model that reports through the callbacks of the
+   *  original.
+   */
+  void set_callbacks(std::vector<std::shared_ptr<callback_base>> callbacks);
+
   /** @brief Register a new metric for the model. */
   void add_metric(std::unique_ptr<metric> m);
 
@@ -228,6 +247,16 @@ public:
    */
   void summarize_matrices(lbann_summary& summarizer);
 
+  /** @brief Time spent in the phases of K-FAC steps. */
+  kfac::phase_timer& get_kfac_phase_timer() noexcept
+  {
+    return m_kfac_phase_timer;
+  }
+  kfac::phase_timer const& get_kfac_phase_timer() const noexcept
+  {
+    return m_kfac_phase_timer;
+  }
+
   ///@}
   /** @name Checkpointing and serialization. */
   ///@{
@@ -246,6 +275,19 @@ public:
   bool save_to_checkpoint_distributed(persist& p);
   bool load_from_checkpoint_distributed(persist& p);
 
+  /** @brief Serialize the model as save_to_checkpoint_shared() would,
+   *  but into host memory.
+   *
+   *  Directories are created and collectives are performed as usual;
+   *  the (path, contents) pairs that would have been written are
+   *  returned instead. Only the trainer master gets a non-empty list.
+   */
+  std::vector<std::pair<std::string, std::string>>
+  snapshot_checkpoint_shared(persist& p);
+  /** @brief Host-memory counterpart of save_to_checkpoint_distributed(). */
+  std::vector<std::pair<std::string, std::string>>
+  snapshot_checkpoint_distributed(persist& p);
+
   /** @brief Write model to proto file */
   void write_proto(lbann_data::Model& proto);
 
@@ -410,12 +452,44 @@ public:
                      bool skip_callbacks = false);
   /** Evaluate any metrics in the model */
   void evaluate_metrics(execution_mode mode, uint64_t current_mini_batch_size);
+  /** @brief Accumulate objective function and metric values over
+   *         windows of mini-batch steps.
+   *
+   *  Evaluation layers add their values to accumulators on their
+   *  device and reduce them across ranks once per window. The results
+   *  are read back asynchronously, so the per-step path does not wait
+   *  on the device. Statistics can lag by up to a window until
+   *  flush_accumulated_metrics is called. A window of one step reads
+   *  every value back in the step that computed it.
+   */
+  void set_metric_accumulation_window(size_t steps);
+  /** @brief Mini-batch steps per metric accumulation window. */
+  size_t get_metric_accumulation_window() const noexcept
+  {
+    return m_metric_accumulation_window;
+  }
+  /** @brief Add every accumulated objective function and metric value
+   *         for an execution mode to the statistics, waiting for any
+   *         still being read back.
+   */
+  void flush_accumulated_metrics(execution_mode mode);
   /** @brief Clear each optimizer's gradient.
    *
    *  This must be called before training forward prop since layers
    *  set an optimizer flag during forward prop.
    */
   void clear_gradients();
+  /** @brief Hold back or release every optimizer's gradient
+   *         synchronization.
+   *
+   *  Used to accumulate gradients over several backprops before
+   *  paying for one synchronization.
+   */
+  void set_gradient_sync_deferred(bool deferred);
+  /** @brief Scale every optimizer's gradient contributions before
+   *         they are synchronized.
+   */
+  void scale_gradients(EvalType factor);
   /** @brief Update weights step. */
   void update_weights();
   /** @brief Update layers step. */
@@ -432,6 +506,247 @@ public:
     return m_activation_refcnt;
   }
 
+  /** @brief Gather sharded weights ahead of the layers that use them.
+   *
+   *  Before each layer runs in forward or backward prop, the full
+   *  views of the sharded weights of the next @c lookahead layers
+   *  are requested, so the allgather is issued while the current
+   *  layer computes rather than just in time.
+   *
+   *  @param lookahead Number of layers to look ahead; 0 disables
+   *                   prefetching.
+   *  @param max_bytes Cap on the full weights held for upcoming
+   *                   layers; 0 means no cap.
+   */
+  void set_weights_prefetch(size_t lookahead, size_t max_bytes = 0) noexcept;
+
+  /** @brief Place activations and error signals in pooled arenas.
+   *
+   *  Takes effect at the next setup. The plan reuses memory as soon
+   *  as a tensor's last consumer in the training step has run, so
+   *  callbacks must not read activations or error signals of other
+   *  layers after that point. Ignored with sub-graph parallelism.
+   */
+  void set_activation_memory_planning(bool enable) noexcept
+  {
+    m_plan_activation_memory = enable;
+  }
+  /** @brief Run the layers as a pipeline of stages.
+   *
+   *  Takes effect at the next setup. Stages are the runs of
+   *  consecutive layers on the same layer-parallel grid, and the SGD
+   *  training algorithm streams its micro-batches through them with
+   *  a one-forward-one-backward schedule. Replaces activation memory
+   *  planning, GPU graph replay and layer streams.
+   */
+  void set_pipeline_parallelism(bool enable) noexcept
+  {
+    m_pipeline_parallelism = enable;
+  }
+  /** @brief The pipeline, or nullptr if the layers are not run as one. */
+  pipeline_parallelism* get_pipeline() const noexcept
+  {
+    return m_pipeline.get();
+  }
+
+  /** @brief Pack weights, gradients and optimizer state into one
+   *         buffer per data type and device.
+   *
+   *  Takes effect at the next setup, which repacks weights that are
+   *  already packed. Disabling it leaves packed weights in place.
+   *  Packed matrices are views into the buffers and cannot grow.
+   */
+  void set_flat_weights(bool enable) noexcept { m_flat_weights = enable; }
+
+  /** @brief The activation memory plan, or nullptr if there is none. */
+  activation_memory_planner const*
+  get_activation_memory_planner() const noexcept
+  {
+    return m_activation_memory_planner.get();
+  }
+
+  /** @brief Recomputation segment containing a checkpointed layer.
+   *
+   *  Segments are maximal runs of checkpointed layers in execution
+   *  order and are built at setup.
+   *
+   *  @returns Segment index, or -1 if the layer is not recomputed.
+   */
+  int get_recompute_segment(Layer const& l) const;
+  /** @brief Whether backprop is currently recomputing a segment. */
+  bool is_recomputing_activations() const noexcept
+  {
+    return m_recomputing_activations;
+  }
+
+  /** @brief Replay the forward prop compute of graph-safe layers from
+   *         GPU graphs.
+   *
+   *  Takes effect at the next setup and only in CUDA builds. Runs of
+   *  consecutive layers that support graph capture are captured into
+   *  one graph on the first full mini-batch and replayed while their
+   *  tensors keep the same buffers. Partial mini-batches and other
+   *  execution modes run eagerly. Activations that a graph reads or
+   *  writes are not released during the step so that their buffers
+   *  stay stable.
+   */
+  void set_gpu_graph_capture(bool enable) noexcept
+  {
+    m_capture_gpu_graphs = enable;
+  }
+  /** @brief Whether forward prop replays captured GPU graphs. */
+  bool uses_fp_graphs() const noexcept;
+
+  /** @brief Run independent layers on a pool of GPU streams.
+   *
+   *  Takes effect at the next setup. Layers are assigned to streams
+   *  along the branches of the layer graph, and a layer waits with
+   *  events on the streams of the parents (forward prop) or children
+   *  (backprop) it depends on. Activations and error signals are kept
+   *  for the whole step since they may be read on another stream.
+   *  A value of 1 keeps the single-stream execution order, which is
+   *  also used in deterministic builds, with sub-graph parallelism,
+   *  GPU graph capture or activation checkpointing.
+   */
+  void set_layer_streams(size_t num_streams) noexcept
+  {
+    m_num_layer_streams = num_streams;
+  }
+  /** @brief Whether layers run on more than one GPU stream. */
+  bool uses_layer_streams() const noexcept;
+#ifdef LBANN_HAS_GPU
+  /** @brief Run every GPU layer on a stream other than the default
+   *         one.
+   *
+   *  Takes effect at the next setup, in place of set_layer_streams.
+   *  Forward prop waits for the work already on the default stream
+   *  but does not make the default stream wait for its layers, so
+   *  the forward passes of models on different streams overlap. Call
+   *  join_layer_streams before using the outputs on the default
+   *  stream. The stream belongs to the caller, so several models can
+   *  share it and its DNN library workspace (see ensemble_inference).
+   */
+  void set_forward_stream(El::SyncInfo<El::Device::GPU> const& sync_info)
+  {
+    m_forward_stream = sync_info;
+  }
+#endif // LBANN_HAS_GPU
+  /** @brief Make the default stream wait for the layer streams. */
+  void join_layer_streams() const { join_layer_streams_(); }
+
+  /** @brief Fuse layers into their parent at setup.
+   *
+   *  Takes effect at the next setup. A layer with a parent that has
+   *  no other children is folded into that parent if the parent can
+   *  take over its computation (see Layer::fuse_child): chains of
+   *  element-wise operator layers, ReLU and GELU layers following
+   *  fully-connected or convolution layers, and residual sums and
+   *  ReLUs following batch normalization. Otherwise a layer may take
+   *  over a parent that only feeds it (see Layer::fuse_parent):
+   *  convolutions take over a preceding nearest-neighbor upsample.
+   *  Fused layers are removed from the model, so they can no longer
+   *  be referenced by name. The applied fusions are reported on the
+   *  trainer master.
+   */
+  void set_layer_fusion(bool enable) noexcept
+  {
+    m_fuse_layers = enable;
+  }
+
+  /** @brief Strip training-only state for inference.
+   *
+   *  Must be called after setup, once the weights hold their trained
+   *  values. Batch normalization layers that follow a convolution or
+   *  fully-connected layer, and entry-wise batch normalization and
+   *  scale/bias layers that follow a fully-connected layer, are folded
+   *  into its weights (see Layer::fold_child_into_weights), and
+   *  dropout and identity layers are removed from the graph. All
+   *  weights are frozen and their optimizers, with their gradient
+   *  buffers and optimizer state, are released. The model is then set up again without error signals,
+   *  so activations only live through forward prop. The applied
+   *  changes are reported on the trainer master. The model can no
+   *  longer be trained.
+   */
+  void compile_for_inference(const std::vector<El::Grid*>& grids);
+
+  /** @brief Whether compile_for_inference has been applied. */
+  bool is_inference_only() const noexcept { return m_inference_only; }
+
+  /** @brief Take weight values from a weights container instead of
+   *         the initializers.
+   *
+   *  Takes effect at the next setup, once. The weights stored in the
+   *  container are attached to it before they are set up (see
+   *  weights_container::attach), so they skip random initialization
+   *  and read their values from the memory-mapped file on first use.
+   *  Weights that are not in the container are reported on the
+   *  trainer master and initialized as usual.
+   */
+  void load_weights_at_setup(std::string container_file)
+  {
+    m_weights_container_file = std::move(container_file);
+  }
+
+  /** @brief Step optimizers together with multi-tensor kernels.
+   *
+   *  Optimizers of the same type, data type and hyperparameters whose
+   *  buffers are contiguous and on the GPU are stepped with a single
+   *  kernel launch instead of one launch per weights (see
+   *  optimizer::get_multi_tensor_key). Other optimizers are stepped
+   *  individually.
+   */
+  void set_multi_tensor_optimizer_step(bool enable) noexcept
+  {
+    m_multi_tensor_step = enable;
+  }
+
+  /** @brief Clip the global L2 norm of all gradients in the
+   *         optimizer step.
+   *
+   *  Gradients are scaled so their norm over all optimized weights is
+   *  at most @c max_norm, after AMP unscaling. When every gradient is
+   *  a contiguous GPU matrix and every optimizer honours
+   *  optimizer::set_step_scale, the norm is reduced and the scale
+   *  computed on the device and applied by the update kernels, so the
+   *  host does not wait. Zero disables clipping.
+   */
+  void set_gradient_clipping(DataType max_norm) noexcept
+  {
+    m_clip_gradient_norm = max_norm;
+  }
+  /** @brief Maximum global gradient norm; zero if clipping is off. */
+  DataType get_gradient_clipping() const noexcept
+  {
+    return m_clip_gradient_norm;
+  }
+#ifdef LBANN_HAS_GPU
+  /** @brief Stream a layer runs on, or nullptr if the layer runs on
+   *         the default stream.
+   */
+  El::SyncInfo<El::Device::GPU> const*
+  get_layer_sync_info(Layer const& l) const;
+  /** @brief The default GPU stream. */
+  El::SyncInfo<El::Device::GPU> const& get_default_sync_info() const
+  {
+    return m_layer_sync_infos.front();
+  }
+#endif // LBANN_HAS_GPU
+  /** @brief Whether the activations of @c l are kept until the end
+   *         of the step instead of being released after their last
+   *         use.
+   */
+  bool keeps_step_activations(Layer const& l) const noexcept
+  {
+    return uses_layer_streams() || m_fp_graph_tensor_layers.count(&l) != 0;
+  }
+  /** @brief Set while layers set up their tensors for a graph
+   *         segment, whose compute is launched afterwards.
+   */
+  bool is_fp_compute_deferred() const noexcept
+  {
+    return m_fp_compute_deferred;
+  }
+
   // ===========================================
   // Automatic mixed precision
   // ===========================================
@@ -440,11 +755,20 @@ public:
   bool is_amp_enabled() const noexcept;
   /** @brief Return the current AMP scale factor. */
   EvalType get_amp_scale_factor() const noexcept;
-  /** @brief Enable automatic mixed precision. */
+  /** @brief Return true if AMP uses dynamic loss scaling. */
+  bool is_amp_loss_scaling_enabled() const noexcept;
+  /** @brief Enable automatic mixed precision.
+   *  @details Without loss scaling, gradients are neither checked
+   *  for non-finite values nor unscaled, so the optimization step
+   *  never waits on the device. This suits compute types whose
+   *  exponent range matches FP32. Setup fails if loss scaling is
+   *  disabled and any layer computes in FP16.
+   */
   void enable_amp(EvalType init_scale_factor = 65536.0,
                   EvalType growth_factor = 2.0,
                   EvalType backoff_factor = 0.5,
-                  size_t growth_interval = 2000);
+                  size_t growth_interval = 2000,
+                  bool loss_scaling = true);
 
   // ===========================================
   // Callbacks
@@ -452,6 +776,8 @@ public:
 
   /** @brief Execute callbacks at end of setup. */
   void do_setup_end_cbs();
+  /** @brief Rebuild the per-hook callback subscriber lists. */
+  void update_hook_callbacks();
   /** @brief Execute callbacks at start of model forward propagation. */
   void do_model_forward_prop_begin_cbs(execution_mode mode);
   /** @brief Execute callbacks at end of model forward propagation. */
@@ -487,6 +813,14 @@ private:
   friend cereal::access;
   model();
 
+  /** @brief Read the checkpoint archive in a model directory.
+   *
+   *  An incremental checkpoint names the checkpoint it builds on in
+   *  its "model.chain" file. That one is loaded first and supplies
+   *  the weights the incremental archive left out.
+   */
+  void load_checkpoint_archive(std::string const& model_dir, bool shared);
+
 private:
   // map to store all distinct grids in the model
   std::unordered_map<std::string, std::shared_ptr<El::Grid>> grids;
@@ -565,6 +899,11 @@ private:
 
   /** @brief Current callbacks to process. */
   std::vector<std::shared_ptr<callback_base>> m_callbacks;
+  /** @brief Callbacks subscribed to each per-layer and per-weights
+   *         hook, indexed by callback_base::hook.
+   *  @details Rebuilt whenever the callback list changes.
+   */
+  std::vector<std::vector<callback_base*>> m_hook_callbacks;
 
   /** @brief A set of layers needed for backpropagation.
    *  @details This set is populated by model::forward_prop and controls
@@ -581,6 +920,8 @@ private:
 
   /** @brief Whether automatic mixed precision (AMP) is enabled. */
   bool m_amp_enabled = false;
+  /** @brief Whether AMP scales the loss and checks gradients. */
+  bool m_amp_loss_scaling = true;
   /** @brief Scale factor for AMP loss scaling. */
   EvalType m_amp_scale_factor = 65536.0;
   /** @brief Growth factor for AMP loss scaling. */
@@ -593,8 +934,172 @@ private:
   size_t m_amp_cur_steps = 0;
   /** @brief Current number of sequentially skipped steps. */
   size_t m_amp_cur_skipped_steps = 0;
+#ifdef LBANN_HAS_GPU
+  /** @brief Device flag, zero if this step's gradients are not finite. */
+  El::Matrix<float, El::Device::GPU> m_amp_is_finite_gpu;
+  /** @brief Pinned host copy of the previous step's flag. */
+  El::Matrix<float, El::Device::CPU> m_amp_is_finite_host;
+  /** @brief Event after copying the flag to the host. */
+  gpu_lib::event_wrapper m_amp_is_finite_event;
+  /** @brief Whether a flag copy has yet to update the loss scale. */
+  bool m_amp_is_finite_pending = false;
+#endif // LBANN_HAS_GPU
+
+  /** @brief Layers ahead to gather sharded weights for; 0 disables. */
+  size_t m_weights_prefetch_lookahead = 0;
+  /** @brief Cap on prefetched full weights in bytes; 0 means no cap. */
+  size_t m_weights_prefetch_max_bytes = 0;
+
+  /** @brief Whether to plan activation memory at setup. */
+  bool m_plan_activation_memory = false;
+  /** @brief Placement of activations and error signals in arenas. */
+  std::unique_ptr<activation_memory_planner> m_activation_memory_planner;
+
+  /** @brief Time spent in the phases of K-FAC steps. */
+  kfac::phase_timer m_kfac_phase_timer;
+
+  /** @brief Whether to run the layers as a pipeline at setup. */
+  bool m_pipeline_parallelism = false;
+  /** @brief Assignment of layers to pipeline stages. */
+  std::unique_ptr<pipeline_parallelism> m_pipeline;
+
+  /** @brief Whether to pack weights into flat buffers at setup. */
+  bool m_flat_weights = false;
+  /** @brief Storage of the packed weights, if any. */
+  std::vector<std::unique_ptr<flat_weights_buffer_base>> m_flat_weights_buffers;
+
+  /** @brief First and last execution index of each recomputation
+   *         segment.
+   */
+  std::vector<std::pair<El::Int, El::Int>> m_recompute_segments;
+  /** @brief Recomputation segment of each checkpointed layer. */
+  std::unordered_map<Layer const*, int> m_recompute_segment_ids;
+  /** @brief Set while backprop reruns forward prop on a segment. */
+  bool m_recomputing_activations = false;
+
+  /** @brief Whether to build forward prop GPU graphs at setup. */
+  bool m_capture_gpu_graphs = false;
+  /** @brief Set while a graph segment's layers set up their tensors. */
+  bool m_fp_compute_deferred = false;
+#ifdef LBANN_HAS_CUDA
+  /** @brief Consecutive layers whose forward compute is one graph. */
+  struct fp_graph_segment
+  {
+    El::Int first;
+    El::Int last;
+    /** @brief Mini-batch size and tensor buffers at capture. */
+    size_t signature = 0;
+    cuda::ExecutableGraph graph;
+  };
+  std::vector<fp_graph_segment> m_fp_graph_segments;
+#endif // LBANN_HAS_CUDA
+  /** @brief Layers whose activations a forward prop graph reads or
+   *         writes: the segments' layers and their parents.
+   */
+  std::unordered_set<const Layer*> m_fp_graph_tensor_layers;
+
+  /** @brief Number of GPU streams to run layers on. */
+  size_t m_num_layer_streams = 1;
+  /** @brief Whether to fuse layers into their parents at setup. */
+  bool m_fuse_layers = false;
+  /** @brief Whether the model was compiled for inference. */
+  bool m_inference_only = false;
+  /** @brief Weights container read at the next setup. */
+  std::string m_weights_container_file;
+  /** @brief An input tensor copied from a parent output with a
+   *         different distribution or data type.
+   */
+  struct redistribution
+  {
+    Layer const* parent;
+    Layer const* child;
+    int input_index;
+    /** @brief Bytes copied per mini-batch sample. */
+    size_t bytes_per_sample;
+    /** @brief Earlier sibling whose copy is viewed instead, if any. */
+    Layer const* source;
+  };
+  /** @brief Redistributions between layers, in execution order. */
+  std::vector<redistribution> m_redistributions;
+  /** @brief Whether to step compatible optimizers together. */
+  bool m_multi_tensor_step = false;
+  /** @brief Maximum global gradient norm; zero disables clipping. */
+  DataType m_clip_gradient_norm = 0;
+  /** @brief Mini-batch steps per metric accumulation window. */
+  size_t m_metric_accumulation_window = 1;
+#ifdef LBANN_HAS_GPU
+  /** @brief Device buffers for gradient clipping in the step. */
+  gradient_clipping::gpu_workspace m_gradient_clip_gpu;
+#endif // LBANN_HAS_GPU
+#ifdef LBANN_HAS_GPU
+  /** @brief Layer streams. The first one is Hydrogen's default
+   *         stream, the others are owned by the model.
+   */
+  std::vector<El::SyncInfo<El::Device::GPU>> m_layer_sync_infos = {
+    El::SyncInfo<El::Device::GPU>{}};
+  /** @brief Index in @c m_layer_sync_infos of each layer not on the
+   *         default stream.
+   */
+  std::unordered_map<Layer const*, size_t> m_layer_stream_ids;
+  /** @brief Stream for every GPU layer, see set_forward_stream. */
+  std::optional<El::SyncInfo<El::Device::GPU>> m_forward_stream;
+#endif // LBANN_HAS_GPU
+  /** @brief Whether the second layer stream is the forward stream,
+   *         which the model does not own.
+   */
+  bool m_borrows_layer_stream = false;
 
 private:
+  /** @brief Request the full weights of the layers following layer @c i
+   *         in execution order, within the prefetch lookahead and cap.
+   */
+  void prefetch_full_weights_(El::Int i, bool forward) const;
+
+  /** @brief Fold layers into parents that can compute them. */
+  void fuse_layers_();
+  /** @brief Remove layers that are identities at inference.
+   *  @returns Names of the removed layers. */
+  std::vector<std::string> remove_inference_identities_();
+  /** @brief Fold layers into their parents' weights.
+   *  @returns Names of the folded layers, by parent. */
+  std::map<std::string, std::vector<std::string>> fold_layers_into_weights_();
+  /** @brief Find the inputs that are copied rather than viewed and
+   *         let siblings share identical copies.
+   */
+  void setup_redistributions_();
+
+  /** @brief Grow or back off the AMP loss scale after a step. */
+  void update_amp_scale_(bool skipped_step);
+
+  /** @brief Group checkpointed layers into recomputation segments. */
+  void setup_recompute_segments_();
+  /** @brief Rerun forward prop on a segment up to layer @c last. */
+  void recompute_segment_(int segment, El::Int last);
+
+  /** @brief Group graph-safe layers into forward prop graph segments. */
+  void setup_fp_graph_segments_();
+  /** @brief Assign layers to GPU streams along graph branches. */
+  void setup_layer_streams_();
+  /** @brief Destroy the streams owned by the model. */
+  void clear_layer_streams_();
+  /** @brief Make all layer streams wait on the default stream. */
+  void fork_layer_streams_() const;
+  /** @brief Make the default stream wait on all layer streams. */
+  void join_layer_streams_() const;
+  /** @brief Make the stream of layer @c l wait on the streams of the
+   *         layers it depends on.
+   */
+  void wait_on_layer_streams_(Layer const& l,
+                              std::vector<Layer const*> const& deps) const;
+#ifdef LBANN_HAS_CUDA
+  /** @brief Forward prop on a graph segment, capturing its compute
+   *         if its tensors changed and launching the graph.
+   */
+  void forward_prop_graph_segment_(fp_graph_segment& segment,
+                                   execution_mode mode,
+                                   bool skip_callbacks);
+#endif // LBANN_HAS_CUDA
+
   // ===========================================
   // Functions to add utility layers
   // ===========================================
@@ -653,11 +1158,14 @@ private:
   /** @brief Reference counter for activations. */
   PointerRangeReferenceCounter m_activation_refcnt;
 
-#ifdef LBANN_HAS_DISTCONV
 private:
+  /** @brief Print tensor distributions and the redistributions
+   *         between layers.
+   */
+  void print_distributions() const;
+#ifdef LBANN_HAS_DISTCONV
   void setup_distconv();
   void setup_distributions();
-  void print_distributions() const;
 #endif // LBANN_HAS_DISTCONV
 };     // class model
 
@@ -808,6 +1316,11 @@ model::set_current_mini_batch_size(uint64_t mini_batch_size) noexcept
 
 inline bool model::is_amp_enabled() const noexcept { return m_amp_enabled; }
 
+inline bool model::is_amp_loss_scaling_enabled() const noexcept
+{
+  return m_amp_loss_scaling;
+}
+
 inline EvalType model::get_amp_scale_factor() const noexcept
 {
   return m_amp_scale_factor;
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_MODELS_PIPELINE_PARALLELISM_HPP_INCLUDED
+#define LBANN_MODELS_PIPELINE_PARALLELISM_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class Layer;
+class model;
+
+/** @brief One forward or backward pass of a micro-batch through a
+ *         pipeline stage. */
+struct pipeline_step
+{
+  bool backward = false;
+  size_t micro_batch = 0;
+};
+
+/** @brief One-forward-one-backward (1F1B) schedule of a stage.
+ *
+ *  Stage @c s first runs forward passes for <tt>S-s-1</tt>
+ *  micro-batches, then alternates one forward and one backward pass,
+ *  and finally drains the remaining backward passes. At most
+ *  <tt>S-s</tt> micro-batches are in flight in a stage, and every
+ *  stage runs its forward passes and its backward passes in
+ *  micro-batch order.
+ */
+std::vector<pipeline_step> make_1f1b_schedule(size_t num_stages,
+                                              size_t stage,
+                                              size_t num_micro_batches);
+
+/** @brief Runs a model as a pipeline of stages on separate grids.
+ *
+ *  Stages are the runs of consecutive layers, in execution order,
+ *  that share a layer-parallel grid tag. Each process belongs to the
+ *  grid of exactly one stage and only runs that stage's layers.
+ *  Tensors on edges between stages are sent point-to-point with
+ *  lbann_comm: the stage grids must have the same shape, so a
+ *  process exchanges its local part with the process of equal rank
+ *  in the other grid. Layers on either side of an edge must have
+ *  the same data layout and use DataType.
+ *
+ *  Only the tensors a stage receives, and the outputs of its input
+ *  layers, are kept for every micro-batch in flight. Before the
+ *  backward pass of a micro-batch that is not the last one run
+ *  forward, the stage replays that micro-batch's forward pass from
+ *  them, as with activation checkpointing.
+ */
+class pipeline_parallelism
+{
+public:
+  /** @brief Assign the layers of a set-up model to stages. */
+  pipeline_parallelism(model& m, std::vector<El::Grid*> const& grids);
+  ~pipeline_parallelism();
+  pipeline_parallelism(const pipeline_parallelism&) = delete;
+  pipeline_parallelism& operator=(const pipeline_parallelism&) = delete;
+
+  size_t get_num_stages() const noexcept { return m_stage_ranks.size(); }
+  /** @brief Stage this process runs. */
+  size_t get_stage() const noexcept { return m_stage; }
+  /** @brief Whether this process runs a layer. */
+  bool is_in_stage(Layer const& l) const;
+
+  /** @name Micro-batch control */
+  ///@{
+  /** @brief Start the forward pass of a micro-batch.
+   *  @param replay Recompute a micro-batch already run forward, from
+   *         the tensors kept for it.
+   */
+  void begin_forward(size_t micro_batch, bool replay);
+  /** @brief Start the backward pass of a micro-batch. */
+  void begin_backward(size_t micro_batch);
+  /** @brief Whether the backward pass of a micro-batch needs its
+   *         forward pass replayed first. */
+  bool needs_replay(size_t micro_batch) const noexcept;
+  /** @brief Mini-batch size of a micro-batch already run forward. */
+  El::Int get_mini_batch_size(size_t micro_batch) const;
+  /** @brief Wait for outstanding sends and drop kept tensors. */
+  void end_mini_batch();
+  ///@}
+
+  /** @name Layer hooks */
+  ///@{
+  /** @brief Input of a layer from a parent in another stage.
+   *
+   *  Receives the tensor, or returns the kept one when replaying.
+   *  @param like Matrix with the distribution to receive into.
+   */
+  El::BaseDistMatrix const& receive_input(Layer const& parent,
+                                          Layer const& child,
+                                          El::BaseDistMatrix const& like);
+  /** @brief Send a layer's outputs to children in other stages.
+   *
+   *  Also keeps the outputs of input layers for replays.
+   */
+  void send_outputs(Layer& l);
+  /** @brief Restore the outputs of an input layer when replaying.
+   *  @returns Whether the layer's forward prop can be skipped.
+   */
+  bool restore_outputs(Layer& l);
+  /** @brief Receive error signals from children in other stages.
+   *  @param skipped Layers whose back prop is disabled this step.
+   */
+  void receive_error_signals(
+    Layer& l,
+    std::unordered_set<Layer const*> const& skipped);
+  /** @brief Send an error signal to a parent in another stage. */
+  void send_error_signal(Layer const& parent,
+                         Layer const& child,
+                         El::BaseDistMatrix const& signal);
+  ///@}
+
+private:
+  using LocalMatrix = El::Matrix<DataType, El::Device::CPU>;
+  using DistMatrix = El::AbstractDistMatrix<DataType>;
+  using edge_type = std::pair<Layer const*, Layer const*>;
+
+  /** @brief Post a send of a matrix's local data. */
+  void send_(DistMatrix const& mat, size_t stage, int tag);
+  /** @brief Receive the local data of a matrix of known size. */
+  void receive_(DistMatrix& mat, size_t stage, int tag);
+  /** @brief Drop the tensors kept for a micro-batch. */
+  void release_(size_t micro_batch);
+
+  model& m_model;
+  /** @brief Stage of every layer. */
+  std::unordered_map<Layer const*, size_t> m_layer_stages;
+  /** @brief Trainer rank of this process's counterpart in each stage. */
+  std::vector<int> m_stage_ranks;
+  size_t m_stage = 0;
+  /** @brief Message tag of every edge between stages. */
+  std::map<edge_type, int> m_edge_tags;
+
+  size_t m_micro_batch = 0;
+  bool m_replaying = false;
+  /** @brief Micro-batches whose forward pass has run. */
+  size_t m_num_forward = 0;
+  /** @brief Micro-batch whose activations the layers hold. */
+  size_t m_last_forward = 0;
+  std::vector<El::Int> m_mini_batch_sizes;
+
+  /** @brief Received inputs, per micro-batch. */
+  std::map<edge_type, std::vector<std::unique_ptr<DistMatrix>>> m_inputs;
+  /** @brief Outputs of input layers, per micro-batch. */
+  std::map<edge_type, std::vector<std::unique_ptr<DistMatrix>>>
+    m_source_outputs;
+  /** @brief Host copies of tensors being sent. */
+  std::list<std::pair<LocalMatrix, El::mpi::Request<DataType>>> m_sends;
+};
+
+} // namespace lbann
+
+#endif // LBANN_MODELS_PIPELINE_PARALLELISM_HPP_INCLUDED
@@ -52,6 +52,10 @@ public:
 
   EvalType finish_evaluation() override;
 
+  bool is_accumulated() const override;
+
+  EvalType take_accumulated_value(execution_mode mode, bool wait) override;
+
   void differentiate() override;
 
   void compute_weight_regularization() override{};
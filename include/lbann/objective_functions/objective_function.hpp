@@ -74,6 +74,11 @@ public:
    */
   EvalType finish_evaluation(execution_mode mode, int mini_batch_size);
 
+  /** Add values still being accumulated by objective function terms
+   *  to the statistics, waiting for any in flight.
+   */
+  void flush_accumulated_values(execution_mode mode);
+
   /** Compute the objective function gradient.
    *  The gradient is with respect to the objective function inputs
    */
@@ -79,6 +79,20 @@ public:
   /** Complete evaluation of the objective function term. */
   virtual EvalType finish_evaluation() = 0;
 
+  /** Whether the term accumulates its values over several steps.
+   *  Accumulated values are collected with take_accumulated_value
+   *  instead of from finish_evaluation.
+   */
+  virtual bool is_accumulated() const { return false; }
+
+  /** Take the scaled sum over samples accumulated for an execution
+   *  mode. If @c wait is set, wait for values still in flight.
+   */
+  virtual EvalType take_accumulated_value(execution_mode mode, bool wait)
+  {
+    return EvalType(0);
+  }
+
   /** Compute the gradient of the objective function term.
    *  The gradient is computed w.r.t. the objective function term
    *  inputs. This should include the scaling factor.
@@ -64,7 +64,9 @@ public:
   ///@}
 
 public:
-  adagrad(TensorDataType learning_rate, TensorDataType eps = 1e-8);
+  adagrad(TensorDataType learning_rate,
+          TensorDataType eps = 1e-8,
+          TensorDataType weight_decay = 0);
   adagrad(const adagrad& other);
   adagrad& operator=(const adagrad& other);
   ~adagrad() override = default;
@@ -77,9 +79,19 @@ public:
   std::string get_type() const override { return "AdaGrad"; }
   /** Human-readable description. */
   description get_description() const override;
+  bool supports_step_scale() const noexcept override { return true; }
+  bool supports_sparse_gradient() const override { return true; }
   /** @brief Returns the optimizer state size in bytes. */
   size_t get_state_size() const override;
 
+  /** @brief Decoupled weight decay, applied in the update kernel. */
+  TensorDataType get_weight_decay() const noexcept { return m_weight_decay; }
+  /** @brief Decoupled weight decay, applied in the update kernel. */
+  void set_weight_decay(TensorDataType weight_decay)
+  {
+    m_weight_decay = weight_decay;
+  }
+
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
 
@@ -100,9 +112,17 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  std::vector<std::unique_ptr<AbsDistMatrixType>*>
+  get_state_matrices() override
+  {
+    return {&m_cache};
+  }
+
 private:
   /** Small factor to avoid division by zero. */
   TensorDataType m_eps;
+  /** @brief Decoupled weight decay (see fused_update). */
+  TensorDataType m_weight_decay;
   /** AdaGrad cache. */
   std::unique_ptr<AbsDistMatrixType> m_cache;
 
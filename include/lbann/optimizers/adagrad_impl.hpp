@@ -38,6 +38,7 @@ void adagrad<TensorDataType>::serialize(Archive& ar)
 {
   ar(cereal::base_class<data_type_optimizer<TensorDataType>>(this),
      CEREAL_NVP(m_eps),
+     CEREAL_NVP(m_weight_decay),
      CEREAL_NVP(m_cache));
 }
 
@@ -91,6 +91,9 @@ public:
   std::string get_type() const override { return "Adam"; }
   /** Human-readable description. */
   description get_description() const override;
+  bool supports_step_scale() const noexcept override { return true; }
+  void undo_skipped_step() override;
+  bool supports_sparse_gradient() const override { return true; }
   /** @brief Returns the optimizer state size in bytes. */
   size_t get_state_size() const override;
   ///@}
@@ -185,6 +188,23 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  std::vector<std::unique_ptr<AbsDistMatrixType>*>
+  get_state_matrices() override
+  {
+    return {&m_moment1, &m_moment2};
+  }
+
+  std::string get_multi_tensor_hyperparameters() const override;
+  bool
+  get_multi_tensor_entry(AbsDistMatrixType& values,
+                         const AbsDistMatrixType& gradient,
+                         multi_tensor_entry<TensorDataType>& entry) override;
+#ifdef LBANN_HAS_GPU
+  void multi_tensor_step_compute(
+    std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info) override;
+#endif // LBANN_HAS_GPU
+
 private:
   /** Update factor for first moment estimate. */
   TensorDataType m_beta1;
@@ -198,6 +218,10 @@ private:
   TensorDataType m_current_beta1 = TensorDataType(1.);
   /** beta2 ^ iteration. */
   TensorDataType m_current_beta2 = TensorDataType(1.);
+  /** beta1 ^ iteration before the last step. */
+  TensorDataType m_previous_beta1 = TensorDataType(1.);
+  /** beta2 ^ iteration before the last step. */
+  TensorDataType m_previous_beta2 = TensorDataType(1.);
   /** First moment estimates. */
   std::unique_ptr<AbsDistMatrixType> m_moment1;
   /** Second moment estimates. */
@@ -27,6 +27,7 @@
 #ifndef LBANN_OPTIMIZERS_DATA_TYPE_OPTIMIZER_HPP_INCLUDED
 #define LBANN_OPTIMIZERS_DATA_TYPE_OPTIMIZER_HPP_INCLUDED
 
+#include "lbann/optimizers/multi_tensor.hpp"
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/utils/describable.hpp"
 
@@ -104,8 +105,32 @@ public:
    */
   AbsDistMatrixType& get_gradient_sharded();
 
+  /** @brief Add a column-sparse contribution to the gradient.
+   *
+   *  Column @c j of @c values is added to local column @c cols[j] of
+   *  this rank's gradient contribution; negative indices are ignored.
+   *  Contributions are summed over the redundant communicator of the
+   *  weights in the next step, which then only updates the weights
+   *  and optimizer state in the columns that were touched. Every rank
+   *  must call this, possibly with no columns, or none must. Requires
+   *  supports_sparse_gradient and weights that are not sharded.
+   */
+  void
+  add_to_sparse_gradient(std::vector<El::Int> const& cols,
+                         El::AbstractMatrix<TensorDataType> const& values);
+
   /** @brief Optimization step. */
   void step() override;
+
+  /** @brief Multi-tensor key; empty unless the gradient is on the GPU
+   *         and the derived class has a multi-tensor path.
+   */
+  std::string get_multi_tensor_key() const final;
+  /** @brief Step a group of optimizers with a few kernel launches.
+   *  @details Optimizers whose buffers cannot join the launch are
+   *           stepped one by one.
+   */
+  void multi_tensor_step(std::vector<optimizer*> const& group) final;
   ///@}
 
   /** @brief Access the scaling factor for optimization step sizes. */
@@ -113,9 +138,24 @@ public:
   /** @brief Set the scaling factor for optimization step sizes. */
   void set_learning_rate(double learning_rate) override;
 
+  /** @brief Optimizer state with the same shape as the weights.
+   *  @details Swapped for the touched columns during a sparse step
+   *           and packed into flat buffers with the weights.
+   */
+  virtual std::vector<std::unique_ptr<AbsDistMatrixType>*> get_state_matrices()
+  {
+    return {};
+  }
+
   /** Are parent weights sharded across ranks? */
   bool is_sharded() const override { return m_sharded; }
 
+  /** How parent weights compress their gradient. */
+  gradient_compression_config const& get_gradient_compression() const override
+  {
+    return m_gradient_compression;
+  }
+
   /** @name Checkpointing functionality */
   ///@{
   /** @brief Archive for checkpoint and restart */
@@ -136,6 +176,45 @@ protected:
   virtual void step_compute(AbsDistMatrixType& values,
                             const AbsDistMatrixType& gradient) = 0;
 
+  /** @brief Hyperparameters and host-side state that must match for
+   *         optimizers to be stepped together.
+   *  @details Empty if the derived class has no multi-tensor path.
+   */
+  virtual std::string get_multi_tensor_hyperparameters() const
+  {
+    return std::string();
+  }
+
+  /** @brief Describe the buffers of one step for a multi-tensor launch.
+   *
+   *  Returns false, without side effects, if the buffers cannot join
+   *  (e.g. they are not contiguous). Otherwise advances host-side
+   *  per-step state the way step_compute does.
+   */
+  virtual bool
+  get_multi_tensor_entry(AbsDistMatrixType& /*values*/,
+                         const AbsDistMatrixType& /*gradient*/,
+                         multi_tensor_entry<TensorDataType>& /*entry*/)
+  {
+    return false;
+  }
+
+#ifdef LBANN_HAS_GPU
+  /** @brief Update every entry in a few kernel launches.
+   *  @details Called on one optimizer of the group after every
+   *           get_multi_tensor_entry call.
+   */
+  virtual void multi_tensor_step_compute(
+    std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info);
+
+  /** @brief Staging area for multi-tensor pointer tables. */
+  multi_tensor_workspace m_multi_tensor_workspace;
+#endif // LBANN_HAS_GPU
+
+  void clear_sparse_gradient() override;
+  void scale_sparse_gradient(EvalType factor) override;
+
   /** @brief Get the info needed to construct a new gradient matrix.
    *  @return Tuple of height, width, DistData (local contributions), and
    *  DistData (global gradient, possibly sharded).
@@ -144,6 +223,11 @@ protected:
   get_matrix_info() const final;
 
 private:
+  /** @brief Optimization step over the columns in the pending
+   *         column-sparse contributions.
+   */
+  void sparse_step();
+
   /** @brief Weights being optimized. */
   data_type_weights<TensorDataType>* m_weights = nullptr;
 
@@ -164,6 +248,19 @@ private:
 
   /** Annotates whether the parent weights are sharded across ranks. */
   bool m_sharded;
+
+  /** Gradient compression requested by the parent weights. */
+  gradient_compression_config m_gradient_compression;
+
+  /** @brief Whether column-sparse contributions are pending. */
+  bool m_sparse_pending = false;
+  /** @brief Columns of the pending column-sparse contributions. */
+  std::vector<El::Int> m_sparse_cols;
+  /** @brief Values of the pending column-sparse contributions.
+   *  @details Distributed like the weights; only the local matrix is
+   *           used.
+   */
+  std::unique_ptr<AbsDistMatrixType> m_sparse_values;
 };
 
 #ifndef LBANN_DATA_TYPE_OPTIMIZER_INSTANTIATE
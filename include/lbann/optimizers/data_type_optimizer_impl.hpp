@@ -35,6 +35,9 @@
 #include "lbann/weights/data_type_weights.hpp"
 
 #include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/optimizers/sparse_gradient.hpp"
+
+#include <sstream>
 
 namespace lbann {
 
@@ -134,6 +137,7 @@ void data_type_optimizer<TensorDataType>::setup_base(WeightsType* w)
 {
   this->set_comm(w->get_comm());
   this->m_sharded = w->is_sharded();
+  this->m_gradient_compression = w->get_gradient_compression();
   this->clear_gradient();
 
   // Set weights being optimized
@@ -172,6 +176,75 @@ void data_type_optimizer<TensorDataType>::set_learning_rate(
   m_learning_rate = learning_rate;
 }
 
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::add_to_sparse_gradient(
+  std::vector<El::Int> const& cols,
+  El::AbstractMatrix<TensorDataType> const& values)
+{
+  if (!this->supports_sparse_gradient()) {
+    LBANN_ERROR(this->get_type(), " optimizer does not support ",
+                "sparse gradients");
+  }
+  if (m_sharded) {
+    LBANN_ERROR("sparse gradients are not supported for sharded weights ",
+                "(",
+                this->get_weights().get_name(),
+                ")");
+  }
+  if (static_cast<El::Int>(cols.size()) != values.Width()) {
+    LBANN_ERROR("got ",
+                cols.size(),
+                " column indices for a sparse gradient ",
+                "with ",
+                values.Width(),
+                " columns");
+  }
+
+  // Append to the pending contributions
+  const auto& weights_values = this->get_weights().get_values_sharded();
+  if (m_sparse_values == nullptr) {
+    m_sparse_values.reset(
+      weights_values.Construct(weights_values.Grid(), weights_values.Root()));
+  }
+  auto& local_values = m_sparse_values->Matrix();
+  const El::Int old_width = m_sparse_cols.size();
+  const El::Int new_width = old_width + cols.size();
+  if (old_width == 0) {
+    El::Copy(values, local_values);
+  }
+  else if (!cols.empty()) {
+    std::unique_ptr<AbsDistMatrixType> old_values(
+      weights_values.Construct(weights_values.Grid(), weights_values.Root()));
+    El::Copy(local_values, old_values->Matrix());
+    local_values.Resize(values.Height(), new_width);
+    auto old_view = local_values(El::ALL, El::IR(0, old_width));
+    auto new_view = local_values(El::ALL, El::IR(old_width, new_width));
+    El::Copy(old_values->LockedMatrix(), old_view);
+    El::Copy(values, new_view);
+  }
+  m_sparse_cols.insert(m_sparse_cols.end(), cols.begin(), cols.end());
+  m_sparse_pending = true;
+}
+
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::clear_sparse_gradient()
+{
+  m_sparse_pending = false;
+  m_sparse_cols.clear();
+  if (m_sparse_values != nullptr) {
+    m_sparse_values->Matrix().Empty();
+  }
+}
+
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::scale_sparse_gradient(
+  EvalType factor)
+{
+  if (m_sparse_pending) {
+    El::Scale(El::To<TensorDataType>(factor), m_sparse_values->Matrix());
+  }
+}
+
 template <typename TensorDataType>
 void data_type_optimizer<TensorDataType>::step()
 {
@@ -182,11 +255,161 @@ void data_type_optimizer<TensorDataType>::step()
     LBANN_ERROR("attempted to perform optimization step without weights");
   }
   const auto start_time = get_time();
-  this->step_compute(m_weights->get_values_sharded(),
-                     this->get_gradient_sharded());
+  if (m_sparse_pending) {
+    this->sparse_step();
+  }
+  else {
+    this->step_compute(m_weights->get_values_sharded(),
+                       this->get_gradient_sharded());
+  }
   this->inc_step_time(get_time() - start_time);
 }
 
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::sparse_step()
+{
+  if (this->has_gradient_contributions()) {
+    LBANN_ERROR("weights \"",
+                m_weights->get_name(),
+                "\" have both sparse and dense gradient contributions");
+  }
+  auto& values = m_weights->get_values_sharded();
+  const El::Int height = values.LocalHeight();
+  // Compact matrices hold this rank's touched columns. Only their
+  // local matrices are used, so they may differ between ranks when
+  // the weights are distributed.
+  auto compact_dist = values.DistData();
+  compact_dist.colDist = El::STAR;
+  compact_dist.rowDist = El::STAR;
+  auto make_matrix = [&compact_dist]() {
+    return std::unique_ptr<AbsDistMatrixType>(
+      AbsDistMatrixType::Instantiate(compact_dist));
+  };
+
+  // Sum contributions from every replica into the touched columns
+  std::vector<El::Int> cols, unique_cols, positions;
+  auto gathered = make_matrix();
+  sparse_gradient::allgather_columns(m_weights->get_comm(),
+                                     values.RedundantComm(),
+                                     m_sparse_cols,
+                                     m_sparse_values->LockedMatrix(),
+                                     cols,
+                                     gathered->Matrix());
+  sparse_gradient::coalesce(cols, unique_cols, positions);
+  const El::Int num_cols = unique_cols.size();
+  if (num_cols == 0) {
+    return;
+  }
+  auto gradient = make_matrix();
+  El::Zeros(*gradient, height, num_cols);
+  sparse_gradient::scatter_add_columns(gathered->LockedMatrix(),
+                                       positions,
+                                       gradient->Matrix());
+
+  // Step on compact copies of the touched columns
+  auto compact_values = make_matrix();
+  compact_values->Resize(height, num_cols);
+  sparse_gradient::gather_columns(values.LockedMatrix(),
+                                  unique_cols,
+                                  compact_values->Matrix());
+  auto state = this->get_state_matrices();
+  std::vector<std::unique_ptr<AbsDistMatrixType>> full_state;
+  for (auto* s : state) {
+    auto compact_state = make_matrix();
+    compact_state->Resize(height, num_cols);
+    sparse_gradient::gather_columns((*s)->LockedMatrix(),
+                                    unique_cols,
+                                    compact_state->Matrix());
+    full_state.emplace_back(std::move(*s));
+    *s = std::move(compact_state);
+  }
+  this->step_compute(*compact_values, *gradient);
+  for (size_t i = 0; i < state.size(); ++i) {
+    sparse_gradient::scatter_columns((*state[i])->LockedMatrix(),
+                                     unique_cols,
+                                     full_state[i]->Matrix());
+    *state[i] = std::move(full_state[i]);
+  }
+  sparse_gradient::scatter_columns(compact_values->LockedMatrix(),
+                                   unique_cols,
+                                   values.Matrix());
+}
+
+template <typename TensorDataType>
+std::string data_type_optimizer<TensorDataType>::get_multi_tensor_key() const
+{
+#ifdef LBANN_HAS_GPU
+  if (m_sparse_pending || m_gradient == nullptr ||
+      m_gradient->GetLocalDevice() != El::Device::GPU) {
+    return std::string();
+  }
+  const auto hyperparameters = this->get_multi_tensor_hyperparameters();
+  if (hyperparameters.empty()) {
+    return std::string();
+  }
+  std::ostringstream key;
+  key << this->get_type() << ' ' << TypeName<TensorDataType>() << ' '
+      << std::hexfloat << m_learning_rate << ' ' << hyperparameters;
+  return key.str();
+#else
+  return std::string();
+#endif // LBANN_HAS_GPU
+}
+
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::multi_tensor_step(
+  std::vector<optimizer*> const& group)
+{
+#ifdef LBANN_HAS_GPU
+  LBANN_CALIPER_MARK_SCOPE((this->get_type() + " multi-tensor").c_str());
+  const auto start_time = get_time();
+  std::vector<multi_tensor_entry<TensorDataType>> entries;
+  std::vector<data_type_optimizer*> members;
+  entries.reserve(group.size());
+  members.reserve(group.size());
+  El::SyncInfo<El::Device::GPU> sync_info;
+  for (auto* o : group) {
+    auto& opt = dynamic_cast<data_type_optimizer&>(*o);
+    if (opt.m_weights == nullptr) {
+      LBANN_ERROR("attempted to perform optimization step without weights");
+    }
+    auto& values = opt.m_weights->get_values_sharded();
+    const auto& gradient = opt.get_gradient_sharded();
+    multi_tensor_entry<TensorDataType> entry{};
+    if (opt.get_multi_tensor_entry(values, gradient, entry)) {
+      if (members.empty()) {
+        sync_info = gpu::get_sync_info(values);
+      }
+      entries.push_back(entry);
+      members.push_back(&opt);
+    }
+    else {
+      opt.step();
+    }
+  }
+  if (members.empty()) {
+    return;
+  }
+  this->multi_tensor_step_compute(entries, sync_info);
+  const auto time_per_step = (get_time() - start_time) / members.size();
+  for (auto* opt : members) {
+    opt->inc_step_time(time_per_step);
+  }
+#else
+  optimizer::multi_tensor_step(group);
+#endif // LBANN_HAS_GPU
+}
+
+#ifdef LBANN_HAS_GPU
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<TensorDataType>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR(this->get_type(), " has no multi-tensor step");
+}
+#endif // LBANN_HAS_GPU
+
 template <typename TensorDataType>
 std::tuple<El::Int, El::Int, El::DistData, El::DistData>
 data_type_optimizer<TensorDataType>::get_matrix_info() const
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_FUSED_UPDATE_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_FUSED_UPDATE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+namespace lbann {
+
+/** @brief Element-wise optimizer updates with decoupled weight decay.
+ *
+ *  An optimizer supplies its update rule as a functor called as
+ *  @c op(x,g,s0,s1) for each weight @c x with gradient @c g and state
+ *  entries @c s0 and @c s1 (a scratch value for state the optimizer
+ *  does not have). The functor returns false if it skipped the entry.
+ *  The weights of updated entries then decay by @c weight_decay times
+ *  their value before the update, as in AdamW, so each entry is read
+ *  and written once per step. The GPU counterparts are in
+ *  src/optimizers/fused_update.cuh.
+ */
+namespace fused_update {
+
+/** @brief Apply @c op to the local entries on the CPU. */
+template <typename TensorDataType, typename OpT>
+void apply_cpu(El::AbstractDistMatrix<TensorDataType>& values,
+               El::AbstractDistMatrix<TensorDataType> const& gradient,
+               El::AbstractDistMatrix<TensorDataType>* state0,
+               El::AbstractDistMatrix<TensorDataType>* state1,
+               TensorDataType weight_decay,
+               OpT const& op)
+{
+  const size_t local_height = values.LocalHeight();
+  const size_t local_width = values.LocalWidth();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
+  auto* __restrict__ state0_buffer =
+    state0 != nullptr ? state0->Buffer() : nullptr;
+  auto* __restrict__ state1_buffer =
+    state1 != nullptr ? state1->Buffer() : nullptr;
+  const bool decay = weight_decay != TensorDataType(0);
+
+  const auto update = [&](TensorDataType& x,
+                          TensorDataType g,
+                          TensorDataType* s0,
+                          TensorDataType* s1) {
+    TensorDataType scratch0(0), scratch1(0);
+    const auto x0 = x;
+    if (op(x,
+           g,
+           s0 != nullptr ? *s0 : scratch0,
+           s1 != nullptr ? *s1 : scratch1) &&
+        decay) {
+      x -= weight_decay * x0;
+    }
+  };
+
+  if (values.Contiguous() && gradient.Contiguous() &&
+      (state0 == nullptr || state0->Contiguous()) &&
+      (state1 == nullptr || state1->Contiguous())) {
+    const size_t local_size = local_height * local_width;
+    LBANN_OMP_PARALLEL_FOR
+    for (size_t i = 0; i < local_size; ++i) {
+      update(values_buffer[i],
+             gradient_buffer[i],
+             state0_buffer != nullptr ? state0_buffer + i : nullptr,
+             state1_buffer != nullptr ? state1_buffer + i : nullptr);
+    }
+  }
+  else {
+    const size_t values_ldim = values.LDim();
+    const size_t gradient_ldim = gradient.LDim();
+    const size_t state0_ldim = state0 != nullptr ? state0->LDim() : 0;
+    const size_t state1_ldim = state1 != nullptr ? state1->LDim() : 0;
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (size_t col = 0; col < local_width; ++col) {
+      for (size_t row = 0; row < local_height; ++row) {
+        update(values_buffer[row + col * values_ldim],
+               gradient_buffer[row + col * gradient_ldim],
+               state0_buffer != nullptr
+                 ? state0_buffer + row + col * state0_ldim
+                 : nullptr,
+               state1_buffer != nullptr
+                 ? state1_buffer + row + col * state1_ldim
+                 : nullptr);
+      }
+    }
+  }
+}
+
+} // namespace fused_update
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_FUSED_UPDATE_HPP_INCLUDED
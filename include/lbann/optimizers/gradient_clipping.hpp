@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_CLIPPING_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_CLIPPING_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class lbann_comm;
+class weights;
+
+namespace gradient_clipping {
+
+/** @brief Global L2 norm of the gradients of @c weights_list.
+ *
+ *  Weights without an optimizer are ignored. The squared norms of
+ *  sharded weights, and of weights on a subgrid, are summed over the
+ *  trainer with a single scalar allreduce. Contiguous GPU gradients
+ *  are reduced together, so the host waits on the device once.
+ */
+DataType global_norm(std::vector<weights*> const& weights_list,
+                     lbann_comm& comm);
+
+/** @brief Scale the gradients of @c weights_list so their global L2
+ *         norm is at most @c max_norm.
+ *  @returns The global norm before clipping.
+ */
+DataType clip_global_norm(std::vector<weights*> const& weights_list,
+                          DataType max_norm,
+                          lbann_comm& comm);
+
+/** @brief Scale each gradient of @c weights_list separately so its L2
+ *         norm is at most @c max_norm.
+ */
+void clip_norm(std::vector<weights*> const& weights_list, DataType max_norm);
+
+#ifdef LBANN_HAS_GPU
+
+/** @brief Device buffers for global_norm_scale_gpu. */
+struct gpu_workspace
+{
+  /** @brief Squared norms of replicated and sharded gradients. */
+  El::Matrix<DataType, El::Device::GPU> sums;
+  /** @brief Scale to pass to optimizer::set_step_scale. */
+  El::Matrix<float, El::Device::GPU> scale;
+};
+
+/** @brief Compute the global-norm clipping scale on the device.
+ *
+ *  Writes min(1, max_norm / norm) into @c workspace.scale, multiplied
+ *  by @c *is_finite if it is not null. Nothing waits on the device
+ *  and the gradients are left as they are: optimizers apply the
+ *  scale in their update kernels when it is passed to
+ *  optimizer::set_step_scale.
+ *
+ *  @returns false, without launching anything, if some gradient is
+ *  not a contiguous GPU matrix of a type the reduction supports. Use
+ *  clip_global_norm in that case.
+ */
+bool global_norm_scale_gpu(std::vector<weights*> const& weights_list,
+                           DataType max_norm,
+                           lbann_comm& comm,
+                           float const* is_finite,
+                           gpu_workspace& workspace);
+
+/** @brief Write the clipping scale for the squared norms in @c sums
+ *         into the 1x1 @c scale.
+ */
+void compute_clip_scale_gpu(El::Matrix<DataType, El::Device::GPU> const& sums,
+                            DataType max_norm,
+                            float const* is_finite,
+                            El::Matrix<float, El::Device::GPU>& scale);
+
+#endif // LBANN_HAS_GPU
+
+} // namespace gradient_clipping
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_CLIPPING_HPP_INCLUDED
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <memory>
+#include <string>
+
+namespace lbann {
+
+class lbann_comm;
+
+/** @brief How a weights gradient is compressed for synchronization. */
+enum class gradient_compression_method
+{
+  /** @brief Allreduce at full precision. */
+  none,
+  /** @brief Allreduce a half-precision copy. */
+  fp16,
+  /** @brief Allgather the largest-magnitude entries. */
+  topk,
+  /** @brief Allreduce the factors of a low-rank approximation
+   *         (Vogels et al., "PowerSGD", NeurIPS 2019).
+   */
+  powersgd,
+};
+
+std::string to_string(gradient_compression_method method);
+
+struct gradient_compression_config
+{
+  gradient_compression_method method = gradient_compression_method::none;
+  /** @brief Fraction of the entries sent by top-k. */
+  double topk_fraction = 0.01;
+  /** @brief Rank of the PowerSGD approximation. */
+  El::Int powersgd_rank = 4;
+};
+
+/** @brief Synchronizes one weights gradient in compressed form.
+ *
+ *  All methods are lossy. The part of the gradient a step did not
+ *  transmit is kept locally and added to the next step's gradient
+ *  (error feedback), so the dropped information is delayed rather
+ *  than lost.
+ */
+template <typename TensorDataType>
+class gradient_compressor
+{
+public:
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+
+  virtual ~gradient_compressor() = default;
+
+  /** @brief Compress the local gradient and start summing it over
+   *         @c redundant_comm.
+   */
+  virtual void start(lbann_comm& comm,
+                     AbsMatType& grad,
+                     El::mpi::Comm const& redundant_comm) = 0;
+
+  /** @brief Complete the sum and write it into @c grad. */
+  virtual void finish(lbann_comm& comm, AbsMatType& grad) = 0;
+
+  /** @brief Ratio of full-precision bytes to bytes sent so far. */
+  double get_compression_ratio() const noexcept
+  {
+    return (m_sent_bytes > 0 ? static_cast<double>(m_uncompressed_bytes) /
+                                 static_cast<double>(m_sent_bytes)
+                             : 0.);
+  }
+
+protected:
+  /** @brief Bytes the gradients would have taken uncompressed. */
+  size_t m_uncompressed_bytes = 0;
+  /** @brief Bytes this process contributed to the collectives. */
+  size_t m_sent_bytes = 0;
+};
+
+/** @brief Construct the compressor for @c config.
+ *  @returns nullptr if @c config disables compression.
+ */
+template <typename TensorDataType>
+std::unique_ptr<gradient_compressor<TensorDataType>>
+make_gradient_compressor(gradient_compression_config const& config,
+                         El::Device device);
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_FUSION_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_FUSION_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+/** @brief A set of gradients synchronized by one packed allreduce.
+ *
+ *  Small weights (biases, batchnorm scale and shift) would otherwise
+ *  each pay the latency of a separate collective. Gradients join an
+ *  open bucket as their backprop completes, which is reverse layer
+ *  order. Every process in the redundant communicator runs the same
+ *  backprop, so all of them form identical buckets.
+ */
+class gradient_fusion_bucket_base
+  : public std::enable_shared_from_this<gradient_fusion_bucket_base>
+{
+public:
+  virtual ~gradient_fusion_bucket_base() = default;
+
+  /** @brief Pack the gradients and start the allreduce.
+   *  @details Does nothing if the allreduce has already started.
+   */
+  virtual void launch(lbann_comm& comm) = 0;
+
+  /** @brief Wait for the allreduce and unpack the results into the
+   *         member gradients.
+   *  @details Launches the bucket first if needed. Later calls do
+   *           nothing, so every member may call this.
+   */
+  virtual void finish(lbann_comm& comm) = 0;
+
+  /** @brief Poke the communication library so a launched allreduce
+   *         keeps moving while backprop computes.
+   *  @returns Whether the bucket is still waiting to be finished.
+   */
+  virtual bool progress(lbann_comm& comm) = 0;
+
+  /** @brief Size of the packed gradients in bytes. */
+  virtual size_t get_size_bytes() const noexcept = 0;
+};
+
+template <typename TensorDataType>
+class gradient_fusion_bucket final : public gradient_fusion_bucket_base
+{
+public:
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+
+  gradient_fusion_bucket(El::Device device, El::mpi::Comm const& comm);
+
+  /** @brief Whether @c grad can be reduced in this bucket. */
+  bool accepts(AbsMatType const& grad, El::mpi::Comm const& comm) const;
+
+  /** @brief Add a gradient. It must stay allocated until finish(). */
+  void add(AbsMatType& grad);
+
+  void launch(lbann_comm& comm) override;
+  void finish(lbann_comm& comm) override;
+  bool progress(lbann_comm& comm) override;
+  size_t get_size_bytes() const noexcept override
+  {
+    return m_size * sizeof(TensorDataType);
+  }
+
+private:
+  El::Device m_device;
+  El::mpi::Comm const* m_comm;
+  std::vector<AbsMatType*> m_grads;
+  /** @brief Number of entries over all member gradients. */
+  El::Int m_size = 0;
+  /** @brief Packed gradients, allocated at launch. */
+  std::unique_ptr<AbsMatType> m_packed;
+  Al::request m_req;
+  /** @brief Handle for this bucket's gradient sync record. */
+  size_t m_record = static_cast<size_t>(-1);
+  bool m_launched = false;
+  bool m_finished = false;
+};
+
+/** @brief Set the bucket size in bytes; 0 disables fusion. */
+void set_gradient_fusion_bucket_size(size_t bytes);
+
+/** @brief Bucket size in bytes; 0 if fusion is disabled. */
+size_t get_gradient_fusion_bucket_size() noexcept;
+
+/** @brief Set the allreduce algorithm used for weight gradients.
+ *
+ *  The hierarchical algorithm is blocking, so it trades the overlap
+ *  of gradient communication with backprop for less inter-node
+ *  traffic.
+ */
+void set_gradient_allreduce_algorithm(allreduce_algorithm algo);
+
+/** @brief Allreduce algorithm used for weight gradients. */
+allreduce_algorithm get_gradient_allreduce_algorithm() noexcept;
+
+/** @brief Add a gradient to the open bucket for its type, device, and
+ *         communicator.
+ *
+ *  The bucket is launched once it reaches the bucket size.
+ *
+ *  @returns The bucket to finish() before reading @c grad. Returns
+ *           nullptr if fusion is disabled or @c grad alone fills a
+ *           bucket; the caller should then allreduce it directly.
+ */
+template <typename TensorDataType>
+std::shared_ptr<gradient_fusion_bucket_base>
+fuse_gradient(lbann_comm& comm,
+              El::AbstractMatrix<TensorDataType>& grad,
+              El::mpi::Comm const& redundant_comm);
+
+/** @brief Launch every partially filled bucket.
+ *  @details Called once backprop has produced all the gradients, so the
+ *           last allreduces overlap with the optimization step.
+ */
+void flush_gradient_fusion_buckets(lbann_comm& comm);
+
+/** @brief Make progress on the launched, unfinished buckets.
+ *  @details Called between layers in backprop. Some MPI
+ *           implementations only advance non-blocking collectives
+ *           from inside MPI calls.
+ */
+void progress_gradient_fusion_buckets(lbann_comm& comm);
+
+/** @brief Timing of one gradient allreduce. */
+struct gradient_sync_record
+{
+  /** @brief Bytes reduced. */
+  size_t bytes;
+  /** @brief Number of weights gradients reduced together. */
+  size_t num_gradients;
+  /** @brief When the allreduce was launched. */
+  EvalType launch_time;
+  /** @brief When a consumer started waiting for it. */
+  EvalType wait_time;
+  /** @brief When the wait returned. With GPU backends the wait only
+   *         orders the compute stream after the allreduce.
+   */
+  EvalType finish_time;
+};
+
+/** @brief Start or stop recording gradient allreduce timings. */
+void set_gradient_sync_tracing(bool enable);
+
+/** @brief Return and clear the recorded timings. */
+std::vector<gradient_sync_record> take_gradient_sync_records();
+
+/** @brief Record that an allreduce was launched.
+ *  @returns A handle for end_gradient_sync_record(), or
+ *           no_gradient_sync_record if tracing is off.
+ */
+size_t begin_gradient_sync_record(size_t bytes, size_t num_gradients);
+
+/** @brief Record that the allreduce behind @c record completed after
+ *         a wait that started at @c wait_time.
+ */
+void end_gradient_sync_record(size_t record, EvalType wait_time);
+
+constexpr size_t no_gradient_sync_record = static_cast<size_t>(-1);
+
+/** @brief Add time spent blocked on gradient allreduces. */
+void add_gradient_sync_wait_time(EvalType seconds);
+
+/** @brief Total time spent blocked on gradient allreduces, in
+ *         seconds. Always counted, so the difference across a region
+ *         gives the region's sync wait.
+ */
+EvalType get_gradient_sync_wait_time();
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_FUSION_HPP_INCLUDED
@@ -108,6 +108,12 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  std::vector<std::unique_ptr<AbsDistMatrixType>*>
+  get_state_matrices() override
+  {
+    return {&m_moment1, &m_moment2, &m_old_gradient};
+  }
+
 private:
   /** @brief Hypergradient learning rate. */
   TensorDataType m_hyper_learning_rate;
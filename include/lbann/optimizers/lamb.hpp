@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_LAMB_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_LAMB_HPP_INCLUDED
+
+#include "lbann/io/persist.hpp"
+#include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/proto/optimizers.pb.h"
+
+namespace lbann {
+
+/** @brief LAMB optimizer.
+ *
+ *  Adam with decoupled weight decay whose update is rescaled per
+ *  weights tensor by the trust ratio ||x|| / ||r||, where @c r is the
+ *  Adam direction plus the weight decay term. The trust ratio is one
+ *  if either norm is zero.
+ *
+ *  The norms are taken over the whole tensor. On the GPU, the
+ *  multi-tensor step reduces the norms of every tensor in the group in
+ *  one launch and computes the trust ratios on the device, so there is
+ *  no host synchronization.
+ *
+ *  Reference:
+ *
+ *  Yang You et al. "Large batch optimization for deep learning:
+ *  Training BERT in 76 minutes." ICLR 2020.
+ */
+template <typename TensorDataType>
+class lamb
+  : public Cloneable<lamb<TensorDataType>, data_type_optimizer<TensorDataType>>
+{
+  using BaseType =
+    Cloneable<lamb<TensorDataType>, data_type_optimizer<TensorDataType>>;
+
+public:
+  /** @name Public Types */
+  ///@{
+
+  /** @brief The tensor type expected in this object. */
+  using AbsDistMatrixType = El::AbstractDistMatrix<TensorDataType>;
+
+  /** @brief The optimizer base type of this object. */
+  using OptimizerType = data_type_optimizer<TensorDataType>;
+
+  /** @brief The concrete weights type used by this object. */
+  using WeightsType = data_type_weights<TensorDataType>;
+
+  ///@}
+
+public:
+  /** @name Life cycle functions */
+  ///@{
+
+  lamb(TensorDataType learning_rate,
+       TensorDataType beta1 = 0.9,
+       TensorDataType beta2 = 0.999,
+       TensorDataType eps = 1e-6,
+       TensorDataType weight_decay = 0.01);
+  lamb(const lamb& other);
+  lamb& operator=(const lamb& other);
+  ~lamb() = default;
+
+  /** Archive for checkpoint and restart */
+  template <class Archive>
+  void serialize(Archive& ar);
+
+  ///@}
+
+  /** @name Descriptions */
+  ///@{
+
+  /** Human-readable type name. */
+  std::string get_type() const override { return "LAMB"; }
+  /** Human-readable description. */
+  description get_description() const override;
+  bool supports_step_scale() const noexcept override { return true; }
+  void undo_skipped_step() override;
+  /** @brief Returns the optimizer state size in bytes. */
+  size_t get_state_size() const override;
+  ///@}
+
+  /** @name Access functions */
+  ///@{
+
+  /** Update factor for first moment estimate. */
+  TensorDataType get_beta1() const noexcept { return m_beta1; }
+  /** Update factor for first moment estimate. */
+  void set_beta1(TensorDataType beta1) { m_beta1 = beta1; }
+  /** Update factor for second moment estimate. */
+  TensorDataType get_beta2() const noexcept { return m_beta2; }
+  /** Update factor for second moment estimate. */
+  void set_beta2(TensorDataType beta2) { m_beta2 = beta2; }
+  /** Small factor to avoid division by zero. */
+  TensorDataType get_eps() const noexcept { return m_eps; }
+  /** Small factor to avoid division by zero. */
+  void set_eps(TensorDataType eps) { m_eps = eps; }
+  /** Decoupled weight decay, included in the trust ratio. */
+  TensorDataType get_weight_decay() const noexcept { return m_weight_decay; }
+  /** Decoupled weight decay, included in the trust ratio. */
+  void set_weight_decay(TensorDataType weight_decay)
+  {
+    m_weight_decay = weight_decay;
+  }
+
+  ///@}
+
+  /** @name Setup */
+  ///@{
+
+  using OptimizerType::setup;
+  void setup(WeightsType* w = nullptr) override;
+
+  ///@}
+
+  /** Add optimizer data to prototext */
+  void write_proto(lbann_data::Optimizer& opt) const final;
+
+protected:
+  friend cereal::access;
+
+  /** @brief Default constructor.
+   *  @details This constructor exists as an implementation detail of
+   *  the serialization code. It is not for general use.
+   */
+  lamb()
+    : lamb(El::To<TensorDataType>(1.f),
+           El::To<TensorDataType>(0.9),
+           El::To<TensorDataType>(0.999),
+           El::To<TensorDataType>(1e-6),
+           El::To<TensorDataType>(0))
+  {}
+
+  /** Computation for an optimization step. */
+  void step_compute(AbsDistMatrixType& values,
+                    const AbsDistMatrixType& gradient) override;
+
+  std::vector<std::unique_ptr<AbsDistMatrixType>*>
+  get_state_matrices() override
+  {
+    return {&m_moment1, &m_moment2};
+  }
+
+  std::string get_multi_tensor_hyperparameters() const override;
+  /** @details Only tensors held whole by each rank can join, since
+   *  the trust ratio needs norms over the full tensor.
+   */
+  bool
+  get_multi_tensor_entry(AbsDistMatrixType& values,
+                         const AbsDistMatrixType& gradient,
+                         multi_tensor_entry<TensorDataType>& entry) override;
+#ifdef LBANN_HAS_GPU
+  void multi_tensor_step_compute(
+    std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info) override;
+#endif // LBANN_HAS_GPU
+
+private:
+  /** Update factor for first moment estimate. */
+  TensorDataType m_beta1;
+  /** Update factor for second moment estimate. */
+  TensorDataType m_beta2;
+  /** Small factor to avoid division by zero. */
+  TensorDataType m_eps;
+  /** Decoupled weight decay. */
+  TensorDataType m_weight_decay;
+  /** beta1 ^ iteration. */
+  TensorDataType m_current_beta1 = TensorDataType(1.);
+  /** beta2 ^ iteration. */
+  TensorDataType m_current_beta2 = TensorDataType(1.);
+  /** beta1 ^ iteration before the last step. */
+  TensorDataType m_previous_beta1 = TensorDataType(1.);
+  /** beta2 ^ iteration before the last step. */
+  TensorDataType m_previous_beta2 = TensorDataType(1.);
+  /** First moment estimates. */
+  std::unique_ptr<AbsDistMatrixType> m_moment1;
+  /** Second moment estimates. */
+  std::unique_ptr<AbsDistMatrixType> m_moment2;
+
+  /** CPU implementation of optimization step. */
+  void step_compute_cpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient);
+#ifdef LBANN_HAS_GPU
+  /** GPU implementation of optimization step. */
+  void step_compute_gpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient);
+#endif // LBANN_HAS_GPU
+};
+
+template <typename TensorDataType>
+std::unique_ptr<optimizer>
+build_lamb_optimizer_from_pbuf(google::protobuf::Message const&);
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_LAMB_HPP_INCLUDED
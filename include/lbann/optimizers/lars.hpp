@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_LARS_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_LARS_HPP_INCLUDED
+
+#include "lbann/io/persist.hpp"
+#include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/proto/optimizers.pb.h"
+
+namespace lbann {
+
+/** @brief LARS optimizer.
+ *
+ *  Momentum SGD whose step is scaled per weights tensor by the local
+ *  learning rate
+ *  @f[ \eta \frac{||x||}{||g|| + \lambda ||x|| + \epsilon} @f]
+ *  with trust coefficient @f$\eta@f$ and weight decay
+ *  @f$\lambda@f$. The local learning rate is one if either norm is
+ *  zero. As with LAMB, the GPU multi-tensor step reduces every norm in
+ *  one launch and applies the trust ratios on the device.
+ *
+ *  Reference:
+ *
+ *  Yang You, Igor Gitman, and Boris Ginsburg. "Large batch training
+ *  of convolutional networks." arXiv preprint arXiv:1708.03888
+ *  (2017).
+ */
+template <typename TensorDataType>
+class lars
+  : public Cloneable<lars<TensorDataType>, data_type_optimizer<TensorDataType>>
+{
+  using BaseType =
+    Cloneable<lars<TensorDataType>, data_type_optimizer<TensorDataType>>;
+
+public:
+  /** @name Public Types */
+  ///@{
+
+  /** @brief The tensor type expected in this object. */
+  using AbsDistMatrixType = El::AbstractDistMatrix<TensorDataType>;
+
+  /** @brief The optimizer base type of this object. */
+  using OptimizerType = data_type_optimizer<TensorDataType>;
+
+  /** @brief The concrete weights type used by this object. */
+  using WeightsType = data_type_weights<TensorDataType>;
+
+  ///@}
+
+public:
+  /** @name Life cycle functions */
+  ///@{
+
+  lars(TensorDataType learning_rate,
+       TensorDataType momentum = 0.9,
+       TensorDataType trust_coefficient = 0.001,
+       TensorDataType weight_decay = 0,
+       TensorDataType eps = 1e-8);
+  lars(const lars& other);
+  lars& operator=(const lars& other);
+  ~lars() = default;
+
+  /** Archive for checkpoint and restart */
+  template <class Archive>
+  void serialize(Archive& ar);
+
+  ///@}
+
+  /** @name Descriptions */
+  ///@{
+
+  /** Human-readable type name. */
+  std::string get_type() const override { return "LARS"; }
+  /** Human-readable description. */
+  description get_description() const override;
+  bool supports_step_scale() const noexcept override { return true; }
+  /** @brief Returns the optimizer state size in bytes. */
+  size_t get_state_size() const override;
+  ///@}
+
+  /** @name Access functions */
+  ///@{
+
+  /** Decay rate for the velocity. */
+  TensorDataType get_momentum() const noexcept { return m_momentum; }
+  /** Decay rate for the velocity. */
+  void set_momentum(TensorDataType momentum) { m_momentum = momentum; }
+  /** Scale of the local learning rate. */
+  TensorDataType get_trust_coefficient() const noexcept
+  {
+    return m_trust_coefficient;
+  }
+  /** Scale of the local learning rate. */
+  void set_trust_coefficient(TensorDataType trust_coefficient)
+  {
+    m_trust_coefficient = trust_coefficient;
+  }
+  /** Weight decay, included in the local learning rate. */
+  TensorDataType get_weight_decay() const noexcept { return m_weight_decay; }
+  /** Weight decay, included in the local learning rate. */
+  void set_weight_decay(TensorDataType weight_decay)
+  {
+    m_weight_decay = weight_decay;
+  }
+  /** Small factor to avoid division by zero. */
+  TensorDataType get_eps() const noexcept { return m_eps; }
+  /** Small factor to avoid division by zero. */
+  void set_eps(TensorDataType eps) { m_eps = eps; }
+
+  ///@}
+
+  /** @name Setup */
+  ///@{
+
+  using OptimizerType::setup;
+  void setup(WeightsType* w = nullptr) override;
+
+  ///@}
+
+  /** Add optimizer data to prototext */
+  void write_proto(lbann_data::Optimizer& opt) const final;
+
+protected:
+  friend cereal::access;
+
+  /** @brief Default constructor.
+   *  @details This constructor exists as an implementation detail of
+   *  the serialization code. It is not for general use.
+   */
+  lars()
+    : lars(El::To<TensorDataType>(1.f),
+           El::To<TensorDataType>(0.9),
+           El::To<TensorDataType>(0.001),
+           El::To<TensorDataType>(0),
+           El::To<TensorDataType>(1e-8))
+  {}
+
+  /** Computation for an optimization step. */
+  void step_compute(AbsDistMatrixType& values,
+                    const AbsDistMatrixType& gradient) override;
+
+  std::vector<std::unique_ptr<AbsDistMatrixType>*>
+  get_state_matrices() override
+  {
+    return {&m_velocity};
+  }
+
+  std::string get_multi_tensor_hyperparameters() const override;
+  /** @details Only tensors held whole by each rank can join, since
+   *  the local learning rate needs norms over the full tensor.
+   */
+  bool
+  get_multi_tensor_entry(AbsDistMatrixType& values,
+                         const AbsDistMatrixType& gradient,
+                         multi_tensor_entry<TensorDataType>& entry) override;
+#ifdef LBANN_HAS_GPU
+  void multi_tensor_step_compute(
+    std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info) override;
+#endif // LBANN_HAS_GPU
+
+private:
+  /** Decay rate for the velocity. */
+  TensorDataType m_momentum;
+  /** Scale of the local learning rate. */
+  TensorDataType m_trust_coefficient;
+  /** Weight decay. */
+  TensorDataType m_weight_decay;
+  /** Small factor to avoid division by zero. */
+  TensorDataType m_eps;
+  /** Velocity term. */
+  std::unique_ptr<AbsDistMatrixType> m_velocity;
+
+  /** CPU implementation of optimization step. */
+  void step_compute_cpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient);
+#ifdef LBANN_HAS_GPU
+  /** GPU implementation of optimization step. */
+  void step_compute_gpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient);
+#endif // LBANN_HAS_GPU
+};
+
+template <typename TensorDataType>
+std::unique_ptr<optimizer>
+build_lars_optimizer_from_pbuf(google::protobuf::Message const&);
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_LARS_HPP_INCLUDED
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_MULTI_TENSOR_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_MULTI_TENSOR_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+#include <type_traits>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Local buffers of one weights object in a multi-tensor
+ *         optimizer step.
+ *
+ *  All buffers are contiguous with @c size entries. State buffers an
+ *  optimizer does not use are nullptr.
+ */
+template <typename TensorDataType>
+struct multi_tensor_entry
+{
+  TensorDataType* values;
+  TensorDataType const* gradient;
+  TensorDataType* state0;
+  TensorDataType* state1;
+  size_t size;
+};
+
+#ifdef LBANN_HAS_GPU
+
+/** @brief Whether multi_tensor_sum_of_squares accepts buffers of a
+ *         data type.
+ */
+template <typename TensorDataType>
+struct multi_tensor_sum_of_squares_supports : std::false_type
+{};
+template <>
+struct multi_tensor_sum_of_squares_supports<float> : std::true_type
+{};
+template <>
+struct multi_tensor_sum_of_squares_supports<double> : std::true_type
+{};
+#ifdef LBANN_HAS_GPU_FP16
+template <>
+struct multi_tensor_sum_of_squares_supports<fp16> : std::true_type
+{};
+#endif // LBANN_HAS_GPU_FP16
+
+/** @brief Host staging area for the tables of multi-tensor launches. */
+struct multi_tensor_workspace
+{
+  std::vector<unsigned char> host;
+  /** @brief Recorded after the table is copied to the device. */
+  gpu_lib::event_wrapper event;
+};
+
+/** @brief Squared L2 norms of many GPU buffers in one kernel launch
+ *         per data type.
+ *
+ *  Each buffer adds @c scale times its sum of squares to one of a few
+ *  result slots, so gradients that need different reductions (e.g.
+ *  sharded and replicated weights) are still handled together.
+ */
+class multi_tensor_sum_of_squares
+{
+public:
+  /** @brief Add @c scale * ||buffer||^2 to slot @c slot. */
+  void add(float const* buffer, size_t size, size_t slot, DataType scale);
+  void add(double const* buffer, size_t size, size_t slot, DataType scale);
+#ifdef LBANN_HAS_GPU_FP16
+  void add(fp16 const* buffer, size_t size, size_t slot, DataType scale);
+#endif // LBANN_HAS_GPU_FP16
+
+  /** @brief Whether any buffer has been added. */
+  bool empty() const noexcept;
+
+  /** @brief Launch the reductions into the @c num_slots x 1 matrix
+   *         @c sums on its stream, without waiting.
+   *  @details @c sums is resized and zeroed. Clears the added buffers.
+   */
+  void launch(size_t num_slots, El::Matrix<DataType, El::Device::GPU>& sums);
+
+  /** @brief Launch the reductions and return the slot sums.
+   *  @details Waits on @c sync_info once. Clears the added buffers.
+   */
+  std::vector<DataType>
+  finish(size_t num_slots, El::SyncInfo<El::Device::GPU> const& sync_info);
+
+  template <typename TensorDataType>
+  struct entry
+  {
+    TensorDataType const* buffer;
+    size_t size;
+    size_t slot;
+    DataType scale;
+  };
+
+private:
+  std::vector<entry<float>> m_float_entries;
+  std::vector<entry<double>> m_double_entries;
+#ifdef LBANN_HAS_GPU_FP16
+  std::vector<entry<fp16>> m_fp16_entries;
+#endif // LBANN_HAS_GPU_FP16
+  multi_tensor_workspace m_workspace;
+};
+
+#endif // LBANN_HAS_GPU
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_MULTI_TENSOR_HPP_INCLUDED
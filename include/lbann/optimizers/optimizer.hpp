@@ -29,6 +29,7 @@
 
 #include "lbann/base.hpp"
 #include "lbann/comm_nb_request.hpp"
+#include "lbann/optimizers/gradient_compression.hpp"
 #include "lbann/utils/cloneable.hpp"
 #include "lbann/utils/compiler_control.hpp"
 #ifdef LBANN_HAS_GPU
@@ -131,6 +132,16 @@ public:
 
   /** @brief Zero out the objective function gradient w.r.t. the weights. */
   void clear_gradient();
+  /** @brief Whether any dense gradient contribution has been added
+   *         since the gradient was last cleared.
+   */
+  bool has_gradient_contributions() const;
+  /** @brief Scale the contributions added since the gradient was
+   *         last cleared.
+   *
+   *  Must be called before the gradient synchronization starts.
+   */
+  void scale_gradient(EvalType factor);
 
   /** @brief Objects that are expected to contribute to the gradient. */
 
@@ -153,9 +164,70 @@ public:
    */
   void remove_gradient_source(const void* source);
 
+  /** @brief Hold back the gradient synchronization.
+   *
+   *  While deferred, removing the last gradient source does not
+   *  launch the synchronization collective, so contributions from
+   *  several backprops accumulate locally. The synchronization is
+   *  then started by the optimization step.
+   */
+  void set_gradient_sync_deferred(bool deferred) noexcept
+  {
+    m_gradient_sync_deferred = deferred;
+  }
+  /** @brief Whether the gradient synchronization is held back. */
+  bool is_gradient_sync_deferred() const noexcept
+  {
+    return m_gradient_sync_deferred;
+  }
+
   /** @brief Perform optimization step. */
   virtual void step() = 0;
 
+  /** @brief Scale GPU optimization steps by a device scalar.
+   *
+   *  While set, GPU steps read the scalar on the device and multiply
+   *  the gradient by it. If it is zero they leave the weights and
+   *  optimizer state unchanged, so a step can be skipped or its
+   *  gradient clipped without the host waiting for the scalar.
+   *  Host-side state, such as Adam's bias correction, still advances
+   *  until undo_skipped_step rewinds it. Only honoured if
+   *  supports_step_scale returns true. Pass nullptr to clear.
+   */
+  void set_step_scale(const float* scale) noexcept { m_step_scale = scale; }
+  /** @brief Device scalar scaling GPU optimization steps, if any. */
+  const float* get_step_scale() const noexcept { return m_step_scale; }
+  /** @brief Whether GPU steps honour set_step_scale. */
+  virtual bool supports_step_scale() const noexcept { return false; }
+  /** @brief Rewind host-side state advanced by the last step.
+   *
+   *  Called once the host learns that a zero step scale skipped the
+   *  last step, before the next step. The kernels already left the
+   *  weights and device-side state unchanged.
+   */
+  virtual void undo_skipped_step() {}
+  /** @brief Whether column-sparse gradient contributions are
+   *         supported (see data_type_optimizer::add_to_sparse_gradient).
+   */
+  virtual bool supports_sparse_gradient() const { return false; }
+
+  /** @brief Key shared by optimizers whose steps can run together.
+   *
+   *  Optimizers with equal non-empty keys have the same type, data
+   *  type and hyperparameters, and can be stepped by a single call to
+   *  multi_tensor_step. Empty if this optimizer has no multi-tensor
+   *  path.
+   */
+  virtual std::string get_multi_tensor_key() const { return std::string(); }
+
+  /** @brief Perform the optimization step of every optimizer in
+   *         @c group.
+   *
+   *  @c group starts with this optimizer, and the others share its
+   *  multi-tensor key. The default steps each one in turn.
+   */
+  virtual void multi_tensor_step(std::vector<optimizer*> const& group);
+
   /** @brief Get the gradient buffer.
    *
    *  This provides access to the underlying gradient buffer, which
@@ -185,6 +257,16 @@ public:
                       TensorDataType& in_scale,
                       bool sync_needed = false);
 
+  /** @brief Keep the local gradient contributions of one data type in
+   *         caller-owned memory.
+   *
+   *  The buffer holds the local part of the contributions stored
+   *  contiguously, and must outlive the optimizer. Only valid for
+   *  weights that are not sharded.
+   */
+  template <typename TensorDataType>
+  void set_gradient_storage(TensorDataType* buffer);
+
   ///@}
   /** @brief Communicator access */
   ///@{
@@ -205,6 +287,11 @@ public:
   /** @brief Reset stats counters. */
   virtual void reset_counters() { m_step_time = 0; }
 
+  /** @brief Ratio of full-precision to transmitted gradient bytes.
+   *  @details 0 if the gradient is not compressed.
+   */
+  double get_gradient_compression_ratio() const;
+
   ///@}
   /** @name Checkpointing */
   ///@{
@@ -233,15 +320,32 @@ public:
     virtual void start_sync(lbann_comm&) = 0;
     virtual void complete_sync(lbann_comm&) = 0;
     virtual void clear() = 0;
+    /** Scale the local contributions. */
+    virtual void scale(EvalType factor) = 0;
+    /** Uncompressed over sent bytes so far; 0 without compression. */
+    virtual double get_compression_ratio() const noexcept = 0;
 
   private:
     optimizer_gradient_status status_ = optimizer_gradient_status::cleared;
   }; // class GradientHelper
 
+  /** @brief Gradient manager for a data type, created on first use. */
+  template <typename TensorDataType>
+  GradientHelper& get_gradient_helper();
+
   /** @brief Copy construct/copy assign */
   optimizer(const optimizer& other);
   optimizer& operator=(const optimizer& other);
 
+  /** @brief Discard pending column-sparse gradient contributions.
+   *  @details Called by clear_gradient.
+   */
+  virtual void clear_sparse_gradient() {}
+  /** @brief Scale pending column-sparse gradient contributions.
+   *  @details Called by scale_gradient.
+   */
+  virtual void scale_sparse_gradient(EvalType /*factor*/) {}
+
   /** @brief Return the current gradient status */
   optimizer_gradient_status get_gradient_status() const
   {
@@ -264,6 +368,10 @@ public:
   /** Are parent weights sharded across ranks? */
   virtual bool is_sharded() const = 0;
 
+  /** @brief How the gradient is compressed for synchronization. */
+  virtual gradient_compression_config const&
+  get_gradient_compression() const = 0;
+
   virtual std::tuple<El::Int, El::Int, El::DistData, El::DistData>
   get_matrix_info() const = 0;
 
@@ -316,6 +424,14 @@ private:
   /** @brief Time spent in optimization step. */
   EvalType m_step_time = 0;
 
+  /** @brief Device scalar scaling GPU optimization steps. */
+  const float* m_step_scale = nullptr;
+
+  /** @brief Whether removing the last gradient source skips the
+   *         synchronization launch.
+   */
+  bool m_gradient_sync_deferred = false;
+
   /** @brief Map from data types to gradient contributions.
    *  @todo Refactor this out. It's a hack.
    */
@@ -27,9 +27,11 @@
 #ifndef LBANN_OPTIMIZERS_OPTIMIZER_IMPL_HPP_INCLUDED
 #define LBANN_OPTIMIZERS_OPTIMIZER_IMPL_HPP_INCLUDED
 
+#include "lbann/optimizers/gradient_fusion.hpp"
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/profiling.hpp"
+#include "lbann/utils/timer.hpp"
 
 namespace lbann {
 
@@ -44,11 +46,17 @@ public:
                      El::Int width,
                      El::DistData dist_data,
                      El::DistData grad_dist_data,
-                     bool sharded_weights)
+                     bool sharded_weights,
+                     gradient_compression_config const& compression = {})
     : local_gradient_contrib_{AbsDistMatType::Instantiate(dist_data)},
       global_gradient_{AbsDistMatType::Instantiate(grad_dist_data)},
+      compressor_{make_gradient_compressor<TensorDataType>(compression,
+                                                           dist_data.device)},
       sharded_weights_{sharded_weights}
   {
+    if (compressor_ != nullptr && sharded_weights_) {
+      LBANN_ERROR("gradient compression is not supported for sharded weights");
+    }
     ensure_gradient_memory(height, width);
     El::Zeros(*local_gradient_contrib_, height, width);
     if (sharded_weights_) {
@@ -69,7 +77,24 @@ public:
 #endif // LBANN_HAS_GPU
 
     if (local_gradient_contrib_->Width() == 0) {
-      local_gradient_contrib_->Resize(height, width);
+      if (storage_ != nullptr) {
+        auto& contrib = *local_gradient_contrib_;
+        const El::Int local_height =
+          contrib.Participating()
+            ? El::Length(height, contrib.ColShift(), contrib.ColStride())
+            : 0;
+        contrib.Attach(height,
+                       width,
+                       contrib.Grid(),
+                       contrib.ColAlign(),
+                       contrib.RowAlign(),
+                       storage_,
+                       std::max(local_height, El::Int{1}),
+                       contrib.Root());
+      }
+      else {
+        local_gradient_contrib_->Resize(height, width);
+      }
       // If distribution is the same, have global gradient matrix view the
       // local contributions.
       if (!sharded_weights_) {
@@ -78,6 +103,17 @@ public:
     }
   }
 
+  /** Keep the local contributions in @c buffer from now on. */
+  void set_storage(TensorDataType* buffer)
+  {
+    if (sharded_weights_) {
+      LBANN_ERROR("gradient storage is not supported for sharded weights");
+    }
+    storage_ = buffer;
+    local_gradient_contrib_->Empty();
+    global_gradient_->Empty();
+  }
+
   AbsDistMatType& local_gradient() noexcept override
   {
     return *local_gradient_contrib_;
@@ -103,6 +139,29 @@ public:
     if (!global_gradient_->Participating()) {
       return;
     }
+    lbann_comm::collective_tag_scope tag(comm, "gradient_sync");
+
+    // Compressed gradients are synchronized by their compressor
+    if (this->get_status() == optimizer_gradient_status::sync_needed &&
+        compressor_ != nullptr) {
+      compressor_->start(comm,
+                         global_gradient_->Matrix(),
+                         global_gradient_->RedundantComm());
+      this->set_status(optimizer_gradient_status::sync_started);
+      return;
+    }
+
+    // Small gradients share a packed allreduce with their neighbors
+    if (this->get_status() == optimizer_gradient_status::sync_needed &&
+        !sharded_weights_) {
+      fusion_bucket_ = fuse_gradient(comm,
+                                     global_gradient_->Matrix(),
+                                     global_gradient_->RedundantComm());
+      if (fusion_bucket_ != nullptr) {
+        this->set_status(optimizer_gradient_status::sync_started);
+        return;
+      }
+    }
 
     // Complete outstanding synchronization of the same data type
     static GradientHelperImpl<TensorDataType>* lastsync = nullptr;
@@ -115,26 +174,48 @@ public:
     case optimizer_gradient_status::sync_needed:
       // Sharded gradients are produced from a reduce-scatter on the local
       // contributions, non-sharded gradients use allreduce
-      if (!sharded_weights_) {
+      if (!sharded_weights_ &&
+          get_gradient_allreduce_algorithm() == allreduce_algorithm::flat) {
+        // The same buffer is reduced every step, so register it once
+        // and only re-register if the gradient is reallocated
+        auto& grad = global_gradient_->Matrix();
+        if (!persistent_sync_.is_registered_on(grad.LockedBuffer(),
+                                               grad.Height() * grad.Width())) {
+          comm.persistent_allreduce_init(grad,
+                                         global_gradient_->RedundantComm(),
+                                         persistent_sync_);
+        }
+        comm.start(persistent_sync_);
+      }
+      else if (!sharded_weights_) {
         comm.nb_allreduce(*global_gradient_,
                           global_gradient_->RedundantComm(),
-                          sync_req_);
+                          sync_req_,
+                          El::mpi::SUM,
+                          get_gradient_allreduce_algorithm());
+      }
+      else if (lbann_comm::is_column_reduce_scatter_supported(
+                 *local_gradient_contrib_,
+                 *global_gradient_)) {
+        // Each process only receives the reduced columns of its shard
+        comm.reduce_scatter_columns(*local_gradient_contrib_,
+                                    *global_gradient_);
+        reduce_scattered_ = true;
       }
       else {
-        // Reduce the local contributions and scatter the results
-        // to the global gradient. The implementation below uses
-        // allreduce temporarily.
+        // Other distributions reduce the local contributions with an
+        // allreduce and keep the local part of the result.
         comm.nb_allreduce(*local_gradient_contrib_,
                           local_gradient_contrib_->RedundantComm(),
                           sync_req_);
-
-        // TODO: Call reduce-scatter directly (currently fails)
-        /*
-        comm.nb_reduce_scatter(*local_gradient_contrib_,
-                               *global_gradient_,
-                               global_gradient_->RedundantComm(),
-                               sync_req_);
-        */
+        reduce_scattered_ = false;
+      }
+      {
+        auto const& reduced =
+          sharded_weights_ ? *local_gradient_contrib_ : *global_gradient_;
+        sync_record_ = begin_gradient_sync_record(
+          reduced.LocalHeight() * reduced.LocalWidth() * sizeof(TensorDataType),
+          1);
       }
       this->set_status(optimizer_gradient_status::sync_started);
       lastsync = this;
@@ -158,10 +239,23 @@ public:
 
     switch (this->get_status()) {
     case optimizer_gradient_status::sync_started:
-      comm.wait(sync_req_);
+      if (compressor_ != nullptr) {
+        compressor_->finish(comm, global_gradient_->Matrix());
+      }
+      else if (fusion_bucket_ != nullptr) {
+        fusion_bucket_->finish(comm);
+        fusion_bucket_.reset();
+      }
+      else {
+        const EvalType wait_time = get_time();
+        comm.wait(sync_req_);
+        comm.wait(persistent_sync_);
+        end_gradient_sync_record(sync_record_, wait_time);
+      }
       if (sharded_weights_) {
-        // TODO: When reduce-scatter is called in start_sync, remove this copy
-        El::Copy(*local_gradient_contrib_, *global_gradient_);
+        if (!reduce_scattered_) {
+          El::Copy(*local_gradient_contrib_, *global_gradient_);
+        }
 
         // Free up memory
         local_gradient_contrib_->Empty();
@@ -183,6 +277,16 @@ public:
     }
   }
 
+  double get_compression_ratio() const noexcept override
+  {
+    return compressor_ != nullptr ? compressor_->get_compression_ratio() : 0.;
+  }
+
+  void scale(EvalType factor) override
+  {
+    El::Scale(El::To<TensorDataType>(factor), *local_gradient_contrib_);
+  }
+
   void clear() override
   {
     this->set_status(optimizer_gradient_status::cleared);
@@ -200,8 +304,21 @@ private:
    */
   std::unique_ptr<AbsDistMatType> global_gradient_;
 
+  /** Lossy synchronization requested by the weights, if any. */
+  std::unique_ptr<gradient_compressor<TensorDataType>> compressor_;
+
+  /** Caller-owned memory for the local contributions, if any. */
+  TensorDataType* storage_ = nullptr;
+
   Al::request sync_req_;
+  /** Allreduce registered on the unsharded gradient buffer. */
+  Al::persistent_request persistent_sync_;
+  /** Fused allreduce this gradient joined, if any. */
+  std::shared_ptr<gradient_fusion_bucket_base> fusion_bucket_;
+  size_t sync_record_ = no_gradient_sync_record;
   bool sharded_weights_;
+  /** Whether the last sharded sync wrote its shard directly. */
+  bool reduce_scattered_ = false;
 }; // class GradientHelperImpl
 
 template <typename TensorDataType>
@@ -217,10 +334,7 @@ void optimizer::add_to_gradient(
 }
 
 template <typename TensorDataType>
-El::AbstractDistMatrix<TensorDataType>&
-optimizer::get_gradient_buffer(TensorDataType& buf_scale,
-                               TensorDataType& in_scale,
-                               bool sync_needed)
+optimizer::GradientHelper& optimizer::get_gradient_helper()
 {
 
   // Anon enum to clarify "get<#>" calls below.
@@ -236,22 +350,44 @@ optimizer::get_gradient_buffer(TensorDataType& buf_scale,
   auto& grad_mgr_ptr =
     m_local_gradient_contributions[std::type_index(typeid(TensorDataType))];
   // If the manager hasn't been created, let's make it.
-  auto mat_info = this->get_matrix_info();
   if (!grad_mgr_ptr) {
+    auto mat_info = this->get_matrix_info();
     // If our optimizer contains a gradient of the same data type, reuse (view)
     // it in the gradient manager
-    grad_mgr_ptr = std::make_unique<GradMgrType>(std::get<HEIGHT>(mat_info),
-                                                 std::get<WIDTH>(mat_info),
-                                                 std::get<DISTDATA_L>(mat_info),
-                                                 std::get<DISTDATA_G>(mat_info),
-                                                 this->is_sharded());
+    grad_mgr_ptr =
+      std::make_unique<GradMgrType>(std::get<HEIGHT>(mat_info),
+                                    std::get<WIDTH>(mat_info),
+                                    std::get<DISTDATA_L>(mat_info),
+                                    std::get<DISTDATA_G>(mat_info),
+                                    this->is_sharded(),
+                                    this->get_gradient_compression());
     grad_mgr_ptr->set_status(optimizer_gradient_status::cleared);
   }
-  grad_mgr_ptr->ensure_gradient_memory(std::get<HEIGHT>(mat_info),
-                                       std::get<WIDTH>(mat_info));
+  return *grad_mgr_ptr;
+}
+
+template <typename TensorDataType>
+void optimizer::set_gradient_storage(TensorDataType* buffer)
+{
+  using GradMgrType = GradientHelperImpl<TensorDataType>;
+  auto& grad_mgr =
+    static_cast<GradMgrType&>(this->get_gradient_helper<TensorDataType>());
+  grad_mgr.set_storage(buffer);
+}
+
+template <typename TensorDataType>
+El::AbstractDistMatrix<TensorDataType>&
+optimizer::get_gradient_buffer(TensorDataType& buf_scale,
+                               TensorDataType& in_scale,
+                               bool sync_needed)
+{
+  using GradMgrType = GradientHelperImpl<TensorDataType>;
+  auto& grad_mgr =
+    static_cast<GradMgrType&>(this->get_gradient_helper<TensorDataType>());
+  auto mat_info = this->get_matrix_info();
+  grad_mgr.ensure_gradient_memory(std::get<0>(mat_info),
+                                  std::get<1>(mat_info));
 
-  // Get the underlying matrix back out.
-  auto& grad_mgr = static_cast<GradMgrType&>(*grad_mgr_ptr);
   // Complete outstanding sync, if needed.
   if (grad_mgr.get_status() == optimizer_gradient_status::sync_started) {
     grad_mgr.complete_sync(*(this->m_comm));
@@ -64,7 +64,8 @@ public:
 public:
   rmsprop(TensorDataType learning_rate,
           TensorDataType decay_rate,
-          TensorDataType eps = 1e-8);
+          TensorDataType eps = 1e-8,
+          TensorDataType weight_decay = 0);
   rmsprop(const rmsprop& other);
   rmsprop& operator=(const rmsprop& other);
   ~rmsprop() override = default;
@@ -77,9 +78,19 @@ public:
   std::string get_type() const override { return "RMSprop"; }
   /** Human-readable description. */
   description get_description() const override;
+  bool supports_step_scale() const noexcept override { return true; }
+  bool supports_sparse_gradient() const override { return true; }
   /** @brief Returns the optimizer state size in bytes. */
   size_t get_state_size() const override;
 
+  /** @brief Decoupled weight decay, applied in the update kernel. */
+  TensorDataType get_weight_decay() const noexcept { return m_weight_decay; }
+  /** @brief Decoupled weight decay, applied in the update kernel. */
+  void set_weight_decay(TensorDataType weight_decay)
+  {
+    m_weight_decay = weight_decay;
+  }
+
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
 
@@ -103,11 +114,30 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  std::vector<std::unique_ptr<AbsDistMatrixType>*>
+  get_state_matrices() override
+  {
+    return {&m_cache};
+  }
+
+  std::string get_multi_tensor_hyperparameters() const override;
+  bool
+  get_multi_tensor_entry(AbsDistMatrixType& values,
+                         const AbsDistMatrixType& gradient,
+                         multi_tensor_entry<TensorDataType>& entry) override;
+#ifdef LBANN_HAS_GPU
+  void multi_tensor_step_compute(
+    std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info) override;
+#endif // LBANN_HAS_GPU
+
 private:
   /** Decay rate. */
   TensorDataType m_decay_rate;
   /** Small factor to avoid division by zero. */
   TensorDataType m_eps;
+  /** @brief Decoupled weight decay (see fused_update). */
+  TensorDataType m_weight_decay;
   /** RMSprop cache. */
   std::unique_ptr<AbsDistMatrixType> m_cache;
 
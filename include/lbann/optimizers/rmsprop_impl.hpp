@@ -39,6 +39,7 @@ void rmsprop<TensorDataType>::serialize(Archive& ar)
   ar(cereal::base_class<data_type_optimizer<TensorDataType>>(this),
      CEREAL_NVP(m_decay_rate),
      CEREAL_NVP(m_eps),
+     CEREAL_NVP(m_weight_decay),
      CEREAL_NVP(m_cache));
 }
 
@@ -65,7 +65,8 @@ public:
 
   sgd(TensorDataType learning_rate,
       TensorDataType momentum = 0,
-      bool nesterov = false);
+      bool nesterov = false,
+      TensorDataType weight_decay = 0);
   sgd(const sgd& other);
   sgd& operator=(const sgd& other);
   ~sgd() override = default;
@@ -86,6 +87,8 @@ public:
   std::string get_type() const override { return "SGD"; }
   /** Human-readable description. */
   description get_description() const override;
+  bool supports_step_scale() const noexcept override { return true; }
+  bool supports_sparse_gradient() const override { return true; }
   /** @brief Returns the optimizer state size in bytes. */
   size_t get_state_size() const override;
   ///@}
@@ -107,6 +110,14 @@ public:
   /** Whether Nesterov acceleration is applied. */
   void set_nesterov(bool nesterov) { m_nesterov = nesterov; }
 
+  /** @brief Decoupled weight decay, applied in the update kernel. */
+  TensorDataType get_weight_decay() const noexcept { return m_weight_decay; }
+  /** @brief Decoupled weight decay, applied in the update kernel. */
+  void set_weight_decay(TensorDataType weight_decay)
+  {
+    m_weight_decay = weight_decay;
+  }
+
   /** Accumulated gradients for momentum optimizer. */
   const AbsDistMatrixType& get_velocity() const;
   /** Accumulated gradients for momentum optimizer. */
@@ -136,6 +147,26 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  std::vector<std::unique_ptr<AbsDistMatrixType>*>
+  get_state_matrices() override
+  {
+    if (m_momentum == El::TypeTraits<TensorDataType>::Zero()) {
+      return {};
+    }
+    return {&m_velocity};
+  }
+
+  std::string get_multi_tensor_hyperparameters() const override;
+  bool
+  get_multi_tensor_entry(AbsDistMatrixType& values,
+                         const AbsDistMatrixType& gradient,
+                         multi_tensor_entry<TensorDataType>& entry) override;
+#ifdef LBANN_HAS_GPU
+  void multi_tensor_step_compute(
+    std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info) override;
+#endif // LBANN_HAS_GPU
+
 private:
   /** @brief Decay rate for gradient accumulation.
    *  @details A momentum of zero corresponds to vanilla SGD.
@@ -143,16 +174,21 @@ private:
   TensorDataType m_momentum;
   /** Whether Nesterov acceleration is used. */
   bool m_nesterov;
+  /** @brief Decoupled weight decay (see fused_update).
+   *  @details Weights shrink by the learning rate times this factor
+   *  times their value at each step.
+   */
+  TensorDataType m_weight_decay;
   /** @brief Accumulated gradients.
    *  @details Not used for vanilla SGD.
    */
   std::unique_ptr<AbsDistMatrixType> m_velocity;
 
-  /** CPU implementation of momentum or Nesterov step. */
+  /** CPU implementation of a step with momentum or weight decay. */
   void momentum_step_cpu(AbsDistMatrixType& values,
                          const AbsDistMatrixType& gradient);
 #ifdef LBANN_HAS_GPU
-  /** GPU implementation of momentum or Nesterov step. */
+  /** GPU implementation of a step with momentum or weight decay. */
   void momentum_step_gpu(AbsDistMatrixType& values,
                          const AbsDistMatrixType& gradient);
 #endif // LBANN_HAS_GPU
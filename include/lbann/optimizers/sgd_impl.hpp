@@ -39,6 +39,7 @@ void sgd<TensorDataType>::serialize(ArchiveT& ar)
   ar(::cereal::base_class<data_type_optimizer<TensorDataType>>(this),
      CEREAL_NVP(m_momentum),
      CEREAL_NVP(m_nesterov),
+     CEREAL_NVP(m_weight_decay),
      CEREAL_NVP(m_velocity));
 }
 
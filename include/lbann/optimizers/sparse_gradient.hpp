@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_SPARSE_GRADIENT_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_SPARSE_GRADIENT_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class lbann_comm;
+class model;
+class optimizer;
+
+/** @brief Helpers for column-sparse gradients.
+ *
+ *  Embedding tables are stored with one embedding vector per column,
+ *  so a "row-sparse" gradient in the usual sense touches a few
+ *  columns of the weights matrix. It is kept as a list of column
+ *  indices and a dense matrix with one column per index.
+ */
+namespace sparse_gradient {
+
+/** @brief Whether a layer in @c m may pass column-sparse gradients
+ *         to @c opt.
+ *  @details AMP loss scaling and model-wide gradient clipping need
+ *           the dense gradient.
+ */
+bool is_supported(model const& m, optimizer const& opt);
+
+/** @brief Sorted, duplicate-free copy of the non-negative entries of
+ *         @c cols.
+ *  @param positions Set to the index of each entry of @c cols in
+ *                   @c unique_cols, or -1 for negative entries.
+ */
+void coalesce(std::vector<El::Int> const& cols,
+              std::vector<El::Int>& unique_cols,
+              std::vector<El::Int>& positions);
+
+/** @brief Copy columns @c cols of @c src into @c dst.
+ *  @details @c dst is resized to @c src.Height() x @c cols.size().
+ */
+template <typename TensorDataType>
+void gather_columns(El::AbstractMatrix<TensorDataType> const& src,
+                    std::vector<El::Int> const& cols,
+                    El::AbstractMatrix<TensorDataType>& dst);
+
+/** @brief Copy the columns of @c src into columns @c cols of @c dst.
+ *  @details @c cols must not contain duplicates.
+ */
+template <typename TensorDataType>
+void scatter_columns(El::AbstractMatrix<TensorDataType> const& src,
+                     std::vector<El::Int> const& cols,
+                     El::AbstractMatrix<TensorDataType>& dst);
+
+/** @brief Add column @c j of @c src to column @c positions[j] of
+ *         @c dst, skipping negative positions.
+ */
+template <typename TensorDataType>
+void scatter_add_columns(El::AbstractMatrix<TensorDataType> const& src,
+                         std::vector<El::Int> const& positions,
+                         El::AbstractMatrix<TensorDataType>& dst);
+
+/** @brief Gather the column-sparse contributions of every rank in
+ *         @c c.
+ *
+ *  Every rank's columns are padded to the largest count, so the
+ *  exchange is two fixed-size allgathers plus one for the counts.
+ *  Padding columns get index -1 in @c cols.
+ */
+template <typename TensorDataType>
+void allgather_columns(lbann_comm const& comm,
+                       El::mpi::Comm const& c,
+                       std::vector<El::Int> const& local_cols,
+                       El::AbstractMatrix<TensorDataType> const& local_values,
+                       std::vector<El::Int>& cols,
+                       El::AbstractMatrix<TensorDataType>& values);
+
+#ifdef LBANN_HAS_GPU
+template <typename TensorDataType>
+void gather_columns_gpu(
+  El::Matrix<TensorDataType, El::Device::GPU> const& src,
+  std::vector<El::Int> const& cols,
+  El::Matrix<TensorDataType, El::Device::GPU>& dst);
+
+template <typename TensorDataType>
+void scatter_columns_gpu(
+  El::Matrix<TensorDataType, El::Device::GPU> const& src,
+  std::vector<El::Int> const& cols,
+  El::Matrix<TensorDataType, El::Device::GPU>& dst);
+
+template <typename TensorDataType>
+void scatter_add_columns_gpu(
+  El::Matrix<TensorDataType, El::Device::GPU> const& src,
+  std::vector<El::Int> const& positions,
+  El::Matrix<TensorDataType, El::Device::GPU>& dst);
+#endif // LBANN_HAS_GPU
+
+} // namespace sparse_gradient
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_SPARSE_GRADIENT_HPP_INCLUDED
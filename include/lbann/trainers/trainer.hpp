@@ -45,6 +45,7 @@ class data_coordinator;
 class description;
 class lbann_comm;
 class callback_base;
+class co_scheduled_training;
 class ExecutionContext;
 class generic_data_reader;
 class TrainingAlgorithm;
@@ -233,6 +234,14 @@ public:
   void
   train(observer_ptr<model> model, El::Int num_epochs, El::Int num_batches = 0);
 
+  /** @brief Train several models on the same mini-batches
+   *  @details The models are trained with SGD regardless of the
+   *  trainer's training algorithm. See co_scheduled_training.
+   */
+  void train(co_scheduled_training& models,
+             El::Int num_epochs,
+             El::Int num_batches = 0);
+
   void evaluate(observer_ptr<model> model,
                 execution_mode mode,
                 El::Int num_batches = 0);
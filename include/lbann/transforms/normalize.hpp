@@ -59,6 +59,8 @@ public:
 
   std::string get_type() const override { return "normalize"; }
 
+  bool supports_device_batch() const override { return true; }
+
   bool supports_non_inplace() const override { return true; }
 
   void apply(utils::type_erased_matrix& data,
@@ -67,6 +69,10 @@ public:
              CPUMat& out,
              std::vector<size_t>& dims) override;
 
+#ifdef LBANN_HAS_GPU
+  void apply_batch(GPUMat& data, const std::vector<size_t>& dims) override;
+#endif // LBANN_HAS_GPU
+
 private:
   /** Channel-wise means. */
   std::vector<float> m_means;
@@ -47,9 +47,15 @@ public:
 
   std::string get_type() const override { return "scale"; }
 
+  bool supports_device_batch() const override { return true; }
+
   void apply(utils::type_erased_matrix& data,
              std::vector<size_t>& dims) override;
 
+#ifdef LBANN_HAS_GPU
+  void apply_batch(GPUMat& data, const std::vector<size_t>& dims) override;
+#endif // LBANN_HAS_GPU
+
 private:
   /** Amount to scale data by. */
   float m_scale;
@@ -36,6 +36,30 @@
 namespace lbann {
 namespace transform {
 
+/**
+ * Region of an image read by a layout-converting transform, and how it is
+ * mirrored. Crops and flips directly preceding such a transform fold into a
+ * view instead of each producing an intermediate image.
+ */
+struct image_view
+{
+  /** Upper-left corner of the region within the source image. */
+  size_t x = 0, y = 0;
+  /** Height and width of the region. */
+  size_t h = 0, w = 0;
+  /** Whether the region is mirrored horizontally and vertically. */
+  bool flip_h = false, flip_v = false;
+
+  /** Restrict the view to an h x w crop at (x, y) of what it shows. */
+  void crop(size_t crop_x, size_t crop_y, size_t crop_h, size_t crop_w)
+  {
+    x += flip_h ? w - crop_x - crop_w : crop_x;
+    y += flip_v ? h - crop_y - crop_h : crop_y;
+    h = crop_h;
+    w = crop_w;
+  }
+};
+
 /**
  * Abstract base class for transforms on data.
  *
@@ -69,6 +93,31 @@ public:
   /** True if the transform supports non-in-place apply. */
   virtual bool supports_non_inplace() const { return false; }
 
+  /**
+   * True if the transform makes no random draws, so its output depends only
+   * on its input and can be computed once and cached.
+   */
+  virtual bool is_deterministic() const { return false; }
+
+  /**
+   * True if the transform only selects or mirrors part of an image, so it
+   * can be folded into an image_view instead of being applied.
+   */
+  virtual bool supports_view_folding() const { return false; }
+
+  /**
+   * True if the transform supports non-in-place apply through an
+   * image_view.
+   */
+  virtual bool supports_fused_view() const { return false; }
+
+  /**
+   * True if the transform can be applied to a batch of DataType samples in
+   * GPU memory. Such transforms are deterministic and do not change the
+   * sample dimensions.
+   */
+  virtual bool supports_device_batch() const { return false; }
+
   /**
    * Apply the transform to data.
    * @param data The input data to transform, which is modified in-place. The
@@ -91,13 +140,54 @@ public:
     LBANN_ERROR("Non-in-place apply not implemented.");
   }
 
+  /**
+   * Compose this transform's effect on the current sample into view.
+   * This makes the same random draws as apply would.
+   * @param view The view to update.
+   * @param dims The dimensions of the image as seen through view. Will be
+   * modified in-place.
+   */
+  virtual void fold_into_view(image_view& view, std::vector<size_t>& dims)
+  {
+    LBANN_ERROR("Folding into an image view not implemented.");
+  }
+
+  /**
+   * Apply the transform to the region of data selected by view.
+   * This does not modify data in-place but places its output in out.
+   * @param dims The dimensions of data. Will be set to the output
+   * dimensions.
+   */
+  virtual void apply(utils::type_erased_matrix& data,
+                     CPUMat& out,
+                     std::vector<size_t>& dims,
+                     const image_view& view)
+  {
+    LBANN_ERROR("Non-in-place apply through an image view not implemented.");
+  }
+
+#ifdef LBANN_HAS_GPU
+  /**
+   * Apply the transform to each column of data, which holds one sample, on
+   * data's stream.
+   * @param data The batch to transform, which is modified in-place.
+   * @param dims The dimensions of one sample.
+   */
+  virtual void apply_batch(GPUMat& data, const std::vector<size_t>& dims)
+  {
+    LBANN_ERROR("Batched device apply not implemented.");
+  }
+#endif // LBANN_HAS_GPU
+
 protected:
   /** Return a value uniformly at random in [a, b). */
   static inline float get_uniform_random(float a, float b)
   {
-    fast_rng_gen& gen = get_fast_io_generator();
     std::uniform_real_distribution<float> dist(a, b);
-    return dist(gen);
+    if (is_io_sample_stream_active()) {
+      return dist(get_io_sample_generator());
+    }
+    return dist(get_fast_io_generator());
   }
   /** Return true with probability p. */
   static inline bool get_bool_random(float p)
@@ -107,8 +197,10 @@ protected:
   /** Return an integer uniformly at random in [a, b). */
   static inline El::Int get_uniform_random_int(El::Int a, El::Int b)
   {
-    fast_rng_gen& gen = get_fast_io_generator();
-    return fast_rand_int(gen, b - a) + a;
+    if (is_io_sample_stream_active()) {
+      return fast_rand_int(get_io_sample_generator(), b - a) + a;
+    }
+    return fast_rand_int(get_fast_io_generator(), b - a) + a;
   }
 };
 
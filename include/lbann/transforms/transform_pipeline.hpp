@@ -55,6 +55,22 @@ public:
   void add_transform(std::unique_ptr<transform>&& trans)
   {
     m_transforms.push_back(std::move(trans));
+    find_fused_view();
+    find_device_transforms();
+  }
+
+  /**
+   * Defer the trailing transforms that support batched device execution
+   * until the mini-batch is on the GPU. The CPU apply methods then stop
+   * short of them, and apply_on_device must be called on each mini-batch.
+   * The conversion to DataType always runs on the CPU.
+   */
+  void set_device_execution(bool device_execution);
+
+  /** True if some transforms are deferred to apply_on_device. */
+  bool has_device_transforms() const
+  {
+    return m_device_begin < m_transforms.size();
   }
 
   /**
@@ -76,18 +92,67 @@ public:
   void apply(CPUMat& data, std::vector<size_t>& dims);
   /**
    * Apply the transforms to data.
+   * Crops and flips directly preceding the conversion to DataType are folded
+   * into it, so that the image is read once and written straight to
+   * out_data.
    * @param data The data to transform. Will be modified in-place.
    * @param out_data Output will be placed here. It will not be reallocated.
    * @param dims Dimensions of data. Will be modified in-place.
+   * @param first Index of the first transform to apply, e.g. to skip the
+   * deterministic prefix when data already had it applied.
    */
-  void
-  apply(El::Matrix<uint8_t>& data, CPUMat& out_data, std::vector<size_t>& dims);
+  void apply(El::Matrix<uint8_t>& data,
+             CPUMat& out_data,
+             std::vector<size_t>& dims,
+             size_t first = 0);
+
+  /**
+   * Number of leading transforms that are deterministic and operate on
+   * uint8 images, so that their output can be cached.
+   */
+  size_t get_deterministic_prefix_length() const;
+
+  /**
+   * Apply only the deterministic prefix to data.
+   * @param data The image to transform. Will be modified in-place.
+   * @param dims Dimensions of data. Will be modified in-place.
+   * @return The number of transforms applied.
+   */
+  size_t apply_deterministic_prefix(El::Matrix<uint8_t>& data,
+                                    std::vector<size_t>& dims);
+
+#ifdef LBANN_HAS_GPU
+  /**
+   * Apply the transforms deferred by set_device_execution to a mini-batch
+   * in GPU memory, on data's stream.
+   * @param data The mini-batch, one sample per column. Modified in-place.
+   * @param dims Dimensions of one sample.
+   */
+  void apply_on_device(GPUMat& data, const std::vector<size_t>& dims);
+#endif // LBANN_HAS_GPU
 
 private:
   /** Ordered list of transforms to apply. */
   std::vector<std::unique_ptr<transform>> m_transforms;
   /** Expected dimensions after applying all transforms. */
   std::vector<size_t> m_expected_out_dims;
+  /**
+   * Index of the first transform in a chain of view-folding transforms that
+   * ends in a fused-view conversion; the number of transforms if none.
+   */
+  size_t m_fused_view_begin = 0;
+  /** Whether trailing transforms are deferred to the GPU. */
+  bool m_device_execution = false;
+  /**
+   * Index of the first transform deferred to apply_on_device; the number of
+   * transforms if none.
+   */
+  size_t m_device_begin = 0;
+
+  /** Recompute m_fused_view_begin. */
+  void find_fused_view();
+  /** Recompute m_device_begin. */
+  void find_device_transforms();
 
   /** Assert dims matches expected_out_dims (if set). */
   void assert_expected_out_dims(const std::vector<size_t>& dims);
@@ -42,6 +42,8 @@ public:
 
   std::string get_type() const override { return "colorize"; }
 
+  bool is_deterministic() const override { return true; }
+
   void apply(utils::type_erased_matrix& data,
              std::vector<size_t>& dims) override;
 };
@@ -63,6 +63,8 @@ public:
 
   bool supports_non_inplace() const override { return true; }
 
+  bool supports_fused_view() const override { return true; }
+
   void apply(utils::type_erased_matrix& data,
              std::vector<size_t>& dims) override;
 
@@ -70,6 +72,11 @@ public:
              CPUMat& out,
              std::vector<size_t>& dims) override;
 
+  void apply(utils::type_erased_matrix& data,
+             CPUMat& out,
+             std::vector<size_t>& dims,
+             const image_view& view) override;
+
 private:
   /** Channel-wise means. */
   std::vector<float> m_means;
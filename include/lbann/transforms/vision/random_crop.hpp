@@ -45,9 +45,13 @@ public:
 
   std::string get_type() const override { return "random_crop"; }
 
+  bool supports_view_folding() const override { return true; }
+
   void apply(utils::type_erased_matrix& data,
              std::vector<size_t>& dims) override;
 
+  void fold_into_view(image_view& view, std::vector<size_t>& dims) override;
+
 private:
   /** Height and width of the crop. */
   size_t m_h, m_w;
@@ -48,12 +48,19 @@ public:
 
   bool supports_non_inplace() const override { return true; }
 
+  bool supports_fused_view() const override { return true; }
+
   void apply(utils::type_erased_matrix& data,
              std::vector<size_t>& dims) override;
 
   void apply(utils::type_erased_matrix& data,
              CPUMat& out,
              std::vector<size_t>& dims) override;
+
+  void apply(utils::type_erased_matrix& data,
+             CPUMat& out,
+             std::vector<size_t>& dims,
+             const image_view& view) override;
 };
 
 std::unique_ptr<transform>
@@ -45,9 +45,13 @@ public:
 
   std::string get_type() const override { return "vertical_flip"; }
 
+  bool supports_view_folding() const override { return true; }
+
   void apply(utils::type_erased_matrix& data,
              std::vector<size_t>& dims) override;
 
+  void fold_into_view(image_view& view, std::vector<size_t>& dims) override;
+
 private:
   /** Probability that that the image is flipped. */
   float m_p;
@@ -29,6 +29,7 @@
 #ifndef LBANN_UTILS_ACCUMULATING_TIMER_INCLUDED
 #define LBANN_UTILS_ACCUMULATING_TIMER_INCLUDED
 
+#include "lbann/utils/duration_histogram.hpp"
 #include "lbann/utils/running_statistics.hpp"
 #include "lbann/utils/timer.hpp"
 
@@ -74,6 +75,9 @@ public:
   /** @brief Determine whether there is an active duration sample running. */
   bool running() const noexcept;
 
+  /** @brief Commit a duration (in seconds) measured elsewhere. */
+  void insert(double duration) noexcept;
+
   ///@}
   /** @name Statistics */
   ///@{
@@ -93,6 +97,11 @@ public:
   /** @brief The largest observed duration. */
   double max() const noexcept;
 
+  /** @brief Approximate @c q-th quantile of the observed durations,
+   *         for @c q in [0,1] (e.g. 0.99 for the 99th percentile).
+   */
+  double percentile(double q) const noexcept;
+
   /** @brief The total time observed by this timer.
    *
    *  Only time that has been committed is reported. That is, it does
@@ -108,6 +117,7 @@ public:
 private:
   Timer m_timer;
   RunningStats m_stats;
+  DurationHistogram m_histogram;
 }; // class AccumulatingTimer
 
 inline void AccumulatingTimer::start() noexcept { m_timer.start(); }
@@ -116,7 +126,7 @@ inline double AccumulatingTimer::stop() noexcept
 {
   if (running()) {
     auto elapsed_time = m_timer.stop();
-    m_stats.insert(elapsed_time);
+    insert(elapsed_time);
     return elapsed_time;
   }
   return 0.;
@@ -134,6 +144,12 @@ inline bool AccumulatingTimer::running() const noexcept
   return m_timer.running();
 }
 
+inline void AccumulatingTimer::insert(double duration) noexcept
+{
+  m_stats.insert(duration);
+  m_histogram.insert(duration);
+}
+
 inline size_t AccumulatingTimer::samples() const noexcept
 {
   return m_stats.samples();
@@ -159,12 +175,21 @@ inline double AccumulatingTimer::max() const noexcept
   return m_stats.samples() ? m_stats.max() : 0.;
 }
 
+inline double AccumulatingTimer::percentile(double q) const noexcept
+{
+  return m_histogram.percentile(q);
+}
+
 inline double AccumulatingTimer::total_time() const noexcept
 {
   return m_stats.total();
 }
 
-inline void AccumulatingTimer::reset_statistics() noexcept { m_stats.reset(); }
+inline void AccumulatingTimer::reset_statistics() noexcept
+{
+  m_stats.reset();
+  m_histogram.reset();
+}
 
 } // namespace lbann
 #endif // LBANN_UTILS_ACCUMULATING_TIMER_INCLUDED
@@ -44,8 +44,8 @@ namespace amp {
  *  will not modify them.
  *  If is_finite_cpu/gpu is set to zero, grads should not be used.
  *
- * @todo This involves a CPU<->GPU sync which could be avoided by
- * fusing these checks into optimizers.
+ * @todo This involves a CPU<->GPU sync. is_finite_and_unscale_all_gpu
+ * avoids it when every gradient is on the GPU.
  *
  * @todo is_finite_cpu/gpu is kind of a hack to share a single buffer
  * across many invocations.
@@ -64,6 +64,23 @@ bool is_finite_and_unscale_all(
   std::vector<optimizer*> optimizers,
   EvalType scale);
 
+#ifdef LBANN_HAS_GPU
+/** Apply is_finite_and_unscale to all gradients in optimizers,
+ *  leaving the result on the device.
+ *
+ *  @c is_finite is set to one and zeroed if a non-finite value is
+ *  found. Nothing waits on the device: GPU optimizers consult the flag
+ *  when it is passed to optimizer::set_step_scale.
+ *
+ *  @returns false, without touching any gradient, if some gradient is
+ *  not on the GPU. Use is_finite_and_unscale_all in that case.
+ */
+bool is_finite_and_unscale_all_gpu(
+  std::vector<optimizer*> const& optimizers,
+  EvalType scale,
+  El::Matrix<float, El::Device::GPU>& is_finite);
+#endif
+
 template <typename TensorDataType>
 void is_finite_and_unscale_cpu(
   El::AbstractDistMatrix<TensorDataType>& grads,
@@ -29,10 +29,15 @@
 
 #include "cnpy.h"
 #include "lbann/utils/exception.hpp"
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace lbann {
+class lbann_comm;
+
 namespace cnpy_utils {
 
 /**
@@ -105,6 +110,26 @@ void shrink_to_fit(cnpy::NpyArray& na, size_t sz);
 /// Show the dimensions of loaded data
 std::string show_shape(const cnpy::NpyArray& na);
 
+/**
+ * Load numpy arrays once per node into POSIX shared memory.
+ *
+ * Collective over the ranks of comm's trainer that share a node. The
+ * lowest of those ranks calls load(), copies the data of the returned
+ * arrays into a shared memory segment and releases its own copy; the
+ * other ranks never read the file. On return, every rank has the
+ * metadata (shape, word_size, ...) of each array in arrays, with an
+ * empty data_holder, and a read-only pointer to its data in data. The
+ * segment is unmapped once the last of these pointers is released.
+ *
+ * @param name Identifies the arrays, e.g. the file they came from
+ */
+void load_node_shared(
+  lbann_comm& comm,
+  const std::string& name,
+  const std::function<std::map<std::string, cnpy::NpyArray>()>& load,
+  std::map<std::string, cnpy::NpyArray>& arrays,
+  std::map<std::string, std::shared_ptr<const char>>& data);
+
 } // end of namespace cnpy_utils
 } // end of namespace lbann
 
@@ -33,6 +33,12 @@
 
 #include <cufft.h>
 
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 #define LBANN_CHECK_CUFFT(cmd)                                                 \
   do {                                                                         \
     auto const lbann_check_cufft_result_ = (cmd);                              \
@@ -56,6 +62,19 @@ std::string value_as_string(cufftResult_t);
 /** @brief The docstring for the given result. */
 std::string result_string(cufftResult_t);
 
+/** @brief ID of the current GPU. */
+int get_device_id();
+
+/** @brief Work area for cuFFT plans executing on a stream.
+ *
+ *  All plans on the same device and stream share one buffer, which
+ *  grows to the largest size requested. Plans on the same stream
+ *  execute in order, so they never use the buffer concurrently.
+ *
+ *  @param size Work area size in bytes.
+ */
+void* get_work_area(size_t size, El::SyncInfo<El::Device::GPU> const& sync);
+
 template <typename T>
 struct cuFFTTypeT;
 
@@ -163,9 +182,9 @@ private:
   {
     size_t worksize_ = 0ULL;
     PlanType plan_ = 0;
-    int num_samples_ = -1; // It's just an int in the basic interface
-    InternalPlanType(PlanType plan, size_t worksize, int n)
-      : worksize_{worksize}, plan_{plan}, num_samples_{n}
+    bool batched_ = true; // Whether one execution covers all samples
+    InternalPlanType(PlanType plan, size_t worksize, bool batched)
+      : worksize_{worksize}, plan_{plan}, batched_{batched}
     {}
     ~InternalPlanType()
     {
@@ -177,14 +196,22 @@ private:
     InternalPlanType(InternalPlanType&& other) noexcept
       : worksize_{other.worksize_},
         plan_{other.plan_},
-        num_samples_{other.num_samples_}
+        batched_{other.batched_}
     {
       other.worksize_ = 0ULL;
       other.plan_ = 0;
-      other.num_samples_ = -1;
     }
   }; // struct InternalPlanType
 
+  /** @brief Layout of a transform
+   *
+   *  (full dims, num samples, input ldim, output ldim, in-place,
+   *  device, stream)
+   */
+  using PlanKeyType = std::
+    tuple<std::vector<int>, int, El::Int, El::Int, bool, int, std::uintptr_t>;
+  using PlanCacheType = fft::PlanCache<PlanKeyType, InternalPlanType>;
+
 public:
   cuFFTWrapper() = default;
   ~cuFFTWrapper() = default;
@@ -262,35 +289,48 @@ public:
   }
 
 private:
+  template <typename InMatT, typename OutMatT>
+  PlanKeyType make_key(InMatT const& in, OutMatT const& out) const
+  {
+    return PlanKeyType{
+      full_dims_,
+      static_cast<int>(in.Width()),
+      in.LDim(),
+      out.LDim(),
+      static_cast<void const*>(in.LockedBuffer()) ==
+        static_cast<void const*>(out.LockedBuffer()),
+      get_device_id(),
+      reinterpret_cast<std::uintptr_t>(SyncInfoFromMatrix(out).Stream())};
+  }
+
   void compute_common(OutputMatType& in, InputMatType& out, int dir) const
   {
     auto const num_samples = in.Width();
     if (num_samples == 0)
       return;
 
+    auto const key = make_key(in, out);
     auto const good_plan =
-      std::find_if(cbegin(plans_),
-                   cend(plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
-                   });
+      std::find_if(cbegin(plans_), cend(plans_), [&key](auto const& a) {
+        return a.first == key;
+      });
     if (good_plan == cend(plans_))
       LBANN_ERROR("No valid cuFFT plan found.");
+    auto const& plan = *(good_plan->second);
 
-    // Setup the workspace
-    ComplexBufferType workspace(good_plan->worksize_,
-                                El::SyncInfoFromMatrix(out));
-    LBANN_CHECK_CUFFT(cufftSetWorkArea(good_plan->plan_, workspace.data()));
+    // Plans on the same stream share one work area
+    LBANN_CHECK_CUFFT(cufftSetWorkArea(
+      plan.plan_,
+      get_work_area(plan.worksize_, El::SyncInfoFromMatrix(out))));
 
     // Run the FFT
-    bool const contiguous_samples = (in.Contiguous()) && (out.Contiguous());
-    if (contiguous_samples) {
-      ExecutorType::Execute(good_plan->plan_, in.Buffer(), out.Buffer(), dir);
+    if (plan.batched_) {
+      ExecutorType::Execute(plan.plan_, in.Buffer(), out.Buffer(), dir);
     }
     else {
       auto num_batches = in.Width();
       for (El::Int ii = 0; ii < num_batches; ++ii) {
-        ExecutorType::Execute(good_plan->plan_,
+        ExecutorType::Execute(plan.plan_,
                               in.Buffer() + ii * in.LDim(),
                               out.Buffer() + ii * out.LDim(),
                               dir);
@@ -309,16 +349,17 @@ private:
     int const num_samples = in.Width();
     if (num_samples == 0)
       return;
-
+    full_dims_ = full_dims;
+    auto const key = make_key(in, out);
     auto const good_plan =
-      std::find_if(cbegin(plans_),
-                   cend(plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
-                   });
-
-    // We don't have a plan for this yet; let's create one!
-    if (good_plan == cend(plans_)) {
+      std::find_if(cbegin(plans_), cend(plans_), [&key](auto const& a) {
+        return a.first == key;
+      });
+    if (good_plan != cend(plans_))
+      return;
+
+    // Reuse a plan from any wrapper with the same layout, or create one
+    auto make_plan = [&]() {
       PlanType plan;
       size_t workspace_size = 0ULL;
 
@@ -330,8 +371,8 @@ private:
       // We'll handle our own workspace
       LBANN_CHECK_CUFFT(cufftSetAutoAllocation(plan, 0));
 
-      auto const& input_dims = Dims::input_dims(full_dims);
-      auto const& output_dims = Dims::output_dims(full_dims);
+      auto input_dims = Dims::input_dims(full_dims);
+      auto output_dims = Dims::output_dims(full_dims);
       int const num_feature_maps = full_dims.front();
       int const feature_map_ndims = full_dims.size() - 1;
       bool const contiguous_samples = (in.Contiguous()) && (out.Contiguous());
@@ -347,6 +388,7 @@ private:
       // Handle the easy case. In this case, all the FFTs to be done
       // are contiguous in memory. Super! Let's just set it up to do
       // them all as one big batch.
+      bool batched = true;
       if (contiguous_samples) {
         int const num_transforms = num_samples * num_feature_maps;
         LBANN_CHECK_CUFFT(cufftMakePlanMany(plan,
@@ -362,6 +404,22 @@ private:
                                             num_transforms,
                                             &workspace_size));
       }
+      else if (num_feature_maps == 1) {
+        // With one feature map per sample, the samples are a single
+        // strided batch, so one plan still covers all of them.
+        LBANN_CHECK_CUFFT(cufftMakePlanMany(plan,
+                                            feature_map_ndims,
+                                            full_dims_mutable.data() + 1,
+                                            input_dims.data() + 1,
+                                            1,
+                                            in.LDim(),
+                                            output_dims.data() + 1,
+                                            1,
+                                            out.LDim(),
+                                            ExecutorType::transform_type,
+                                            num_samples,
+                                            &workspace_size));
+      }
       else {
         // In this case, we apply the FFT to each sample, and, come
         // execution time, we will loop over the samples. (An
@@ -381,20 +439,24 @@ private:
                                             ExecutorType::transform_type,
                                             num_transforms,
                                             &workspace_size));
+        batched = false;
       }
 
       if (plan == 0)
         LBANN_ERROR("cuFFT plan construction failed "
                     "but cuFFT reported no errors.");
 
-      plans_.emplace_back(plan, workspace_size, num_samples);
-    }
+      return std::make_shared<InternalPlanType>(plan, workspace_size, batched);
+    };
+    plans_.emplace_back(key, PlanCacheType::instance().get(key, make_plan));
   }
 
 private:
   // These are likely to be so few in number that a linear search is
   // going to be fine.
-  std::vector<InternalPlanType> plans_;
+  std::vector<std::pair<PlanKeyType, std::shared_ptr<InternalPlanType>>>
+    plans_;
+  std::vector<int> full_dims_;
 
 }; // class cuFFTWrapper
 
@@ -28,12 +28,16 @@
 
 #include "lbann/base.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/hash.hpp"
 #include "lbann/utils/tensor_dims_utils.hpp"
 #include "lbann/utils/typename.hpp"
 
 #include <cuda_runtime.h>
 #include <cutensor.h>
 
+#include <unordered_map>
+#include <vector>
+
 /**
  * The interface below is designed for CUTENSOR v1.
  **/
@@ -106,57 +110,81 @@ using CUDAScalar = typename CUDATypeT<CppType>::scalar_type;
 template <typename CppType>
 constexpr auto CUDAScalarType = CUDATypeT<CUDAScalar<CppType>>::value;
 
-static cutensorHandle_t make_handle()
+inline cutensorHandle_t make_handle()
 {
   cutensorHandle_t handle;
   CHECK_CUTENSOR(cutensorInit(&handle));
   return handle;
 }
-static cutensorHandle_t* get_handle_ptr()
+inline cutensorHandle_t* get_handle_ptr()
 {
   static cutensorHandle_t handle = make_handle();
   return &handle;
 }
 
-static inline cutensor::ModesType make_modes(size_t const ndims)
+inline cutensor::ModesType make_modes(size_t const ndims)
 {
   std::vector<int32_t> modes(ndims + 1); // Add the sample dim.
   std::iota(begin(modes), end(modes), static_cast<int>('a'));
   return modes;
 }
 
-template <typename DataT>
-static std::string get_desc_key(El::Matrix<DataT, El::Device::GPU> const& mat,
-                                cutensor::DimsType const& dims_in)
+namespace cutensor {
+
+/** @brief Identifies a cached tensor descriptor.
+ *
+ *  The width accounts for the minibatch size and the leading
+ *  dimension for the sample stride.
+ */
+struct DescriptorKey
 {
-  auto const& dims = dims_in.get();
-  std::ostringstream oss;
-  oss << mat.Height() << "," << mat.Width() << "," << mat.LDim() << ";";
-  if (dims.size() == 0) {
-    oss << "scalar";
+  std::vector<int64_t> dims;
+  El::Int width;
+  El::Int ldim;
+  cudaDataType_t type;
+
+  bool operator==(DescriptorKey const& other) const noexcept
+  {
+    return (width == other.width && ldim == other.ldim &&
+            type == other.type && dims == other.dims);
   }
-  else {
-    oss << dims.front();
-    for (size_t ii = 1; ii < dims.size(); ++ii)
-      oss << "," << dims[ii];
+};
+
+struct DescriptorKeyHash
+{
+  size_t operator()(DescriptorKey const& key) const noexcept
+  {
+    size_t seed = hash_combine(std::hash<El::Int>{}(key.width), key.ldim);
+    seed = hash_combine<cudaDataType_t, enum_hash<cudaDataType_t>>(seed,
+                                                                  key.type);
+    for (auto const& d : key.dims)
+      seed = hash_combine(seed, d);
+    return seed;
   }
-  oss << ";" << lbann::TypeName<DataT>();
-  return oss.str();
-}
+};
+
+} // namespace cutensor
 
+/** @brief Get a descriptor for the tensor stored in @c mat.
+ *
+ *  Descriptors are cached for the whole process, so every layer that
+ *  sees a given shape and type shares one descriptor, whichever
+ *  translation unit it lives in.
+ */
 template <typename DataT>
-static cutensorTensorDescriptor_t
+cutensorTensorDescriptor_t
 get_descriptor(El::Matrix<DataT, El::Device::GPU> const& mat,
                cutensor::DimsType const& dims)
 {
-  /** @brief Keep track of descriptors so we don't have to repeatedly
-   *         rebuild them.
-   */
-  static std::unordered_map<std::string, cutensorTensorDescriptor_t> s_desc_map;
-
-  auto key = get_desc_key(mat, dims); // captures Width to account for
-                                      // minibatch size and LDim to
-                                      // account for stride.
+  static std::unordered_map<cutensor::DescriptorKey,
+                            cutensorTensorDescriptor_t,
+                            cutensor::DescriptorKeyHash>
+    s_desc_map;
+
+  cutensor::DescriptorKey key{dims.get(),
+                              mat.Width(),
+                              mat.LDim(),
+                              CUDAType<DataT>};
   auto iter = s_desc_map.find(key);
   if (iter == end(s_desc_map)) {
     std::vector<int64_t> extents = dims.get();
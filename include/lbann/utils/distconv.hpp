@@ -194,14 +194,36 @@ int get_number_of_pre_generated_synthetic_data();
  */
 bool is_deterministic();
 
-/** Query the number of partitions in the depth dimension.
+/** Query the number of processes that read parts of one sample.
  */
 int get_number_of_io_partitions();
 
+/** Query the number of IO partitions along depth, height and width.
+ *
+ *  Set with LBANN_DISTCONV_IO_PARTITION_SHAPE (e.g. "2x2x2"). By
+ *  default samples are only partitioned in depth. When it matches
+ *  the spatial partitioning of a distconv input layer, each process
+ *  reads its own block of a sample and no host shuffle is needed.
+ */
+const std::vector<int>& get_io_partition_shape();
+
+/** Return the (depth, height, width) index of the sample block that a
+ *  process reads.
+ */
+std::vector<int> get_io_partition_index(int rank);
+
 /** Query if Cosmoflow parallel I/O is enabled.
  */
 bool is_cosmoflow_parallel_io_enabled();
 
+/** Query if halo exchanges are overlapped with interior compute.
+ *
+ *  When enabled, spatially partitioned convolutions compute the
+ *  interior of the local tensor while halos are exchanged and the
+ *  boundary once they arrive.
+ */
+bool is_overlap_halo_exchange_enabled();
+
 #ifdef DISTCONV_HAS_P2P
 /** Get p2p handle
  */
@@ -109,6 +109,7 @@ constexpr dnnConvolutionMode_t DNN_CROSS_CORRELATION = CUDNN_CROSS_CORRELATION;
 constexpr dnnNanPropagation_t DNN_PROPAGATE_NAN = CUDNN_PROPAGATE_NAN;
 constexpr dnnMathType_t DNN_DEFAULT_MATH = CUDNN_DEFAULT_MATH;
 constexpr dnnTensorFormat_t DNN_TENSOR_NCHW = CUDNN_TENSOR_NCHW;
+constexpr dnnTensorFormat_t DNN_TENSOR_NHWC = CUDNN_TENSOR_NHWC;
 constexpr dnnRNGType_t DNN_RNG_PSEUDO_XORWOW = 0;
 constexpr dnnLRNMode_t DNN_LRN_CROSS_CHANNEL = CUDNN_LRN_CROSS_CHANNEL_DIM1;
 constexpr dnnMathType_t DNN_TENSOR_OP_MATH_ALLOW_CONVERSION =
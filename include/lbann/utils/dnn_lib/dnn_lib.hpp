@@ -639,6 +639,20 @@ public:
   TensorDescriptor& get_activations(int child_index = 0) override;
   TensorDescriptor& get_prev_error_signals(int child_index = 0) override;
   TensorDescriptor& get_error_signals(int parent_index = 0) override;
+
+  /** @brief Whether tensors are stored in channels-last order.
+   *  @details If set, the layer's tensor dimensions are interpreted
+   *  as (spatial dims..., channels) and the descriptors present them
+   *  to the DNN library as NCHW tensors with NHWC strides.
+   */
+  bool is_channels_last() const noexcept { return m_channels_last; }
+  void set_channels_last(bool channels_last) noexcept
+  {
+    m_channels_last = channels_last;
+  }
+
+private:
+  bool m_channels_last = false;
 };
 
 /** Manager for an entry-wise layer's DNN library tensor descriptors. */
@@ -741,6 +755,40 @@ get_bwd_filter_algorithm(bool autotune,
                          size_t ws_size,
                          void* ws);
 
+/** @brief Identify the GPU model and DNN library version.
+ *
+ *  Autotuned algorithms are only valid for the hardware and library
+ *  that measured them, so this is part of every key in the
+ *  convolution algorithm cache.
+ */
+std::string get_autotune_context();
+
+/** @brief Look up an autotuned convolution algorithm.
+ *
+ *  On first use, loads the file given by the @c conv_algo_cache
+ *  command-line option (or @c LBANN_CONV_ALGO_CACHE), if any.
+ *
+ *  @param key Description of the convolution problem, including
+ *  the autotune context.
+ *  @param algo Algorithm enum value, if found.
+ *  @param math_type Math type enum value, if found.
+ *  @returns Whether the key was found.
+ */
+bool find_cached_conv_algorithm(const std::string& key,
+                                int& algo,
+                                int& math_type);
+
+/** @brief Record an autotuned convolution algorithm.
+ *
+ *  If @c persist is true and a cache file is configured, the entry
+ *  is also appended to the file so that later runs can skip the
+ *  search. Only one rank should persist entries.
+ */
+void cache_conv_algorithm(const std::string& key,
+                          int algo,
+                          int math_type,
+                          bool persist);
+
 /** @brief Set the default to use tensor core operations when possible
  * without converting datatypes.
  */
@@ -109,6 +109,7 @@ constexpr dnnConvolutionMode_t DNN_CROSS_CORRELATION = miopenConvolution;
 constexpr dnnNanPropagation_t DNN_PROPAGATE_NAN = MIOPEN_PROPAGATE_NAN;
 constexpr dnnMathType_t DNN_DEFAULT_MATH = 0;
 constexpr dnnTensorFormat_t DNN_TENSOR_NCHW = miopenTensorNCHW;
+constexpr dnnTensorFormat_t DNN_TENSOR_NHWC = miopenTensorNHWC;
 constexpr dnnRNGType_t DNN_RNG_PSEUDO_XORWOW = MIOPEN_RNG_PSEUDO_XORWOW;
 constexpr dnnLRNMode_t DNN_LRN_CROSS_CHANNEL = miopenLRNCrossChannel;
 constexpr dnnMathType_t DNN_TENSOR_OP_MATH_ALLOW_CONVERSION =
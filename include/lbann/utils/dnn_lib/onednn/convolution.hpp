@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_DNN_LIB_ONEDNN_CONVOLUTION_HPP_
+#define LBANN_UTILS_DNN_LIB_ONEDNN_CONVOLUTION_HPP_
+
+#include "lbann/utils/dnn_lib/onednn.hpp"
+
+#include <vector>
+
+#if !defined(LBANN_HAS_ONEDNN)
+static_assert(false,
+              "This file should not be included unless "
+              "OneDNN support is enabled.");
+#endif // !defined(LBANN_HAS_ONEDNN)
+
+namespace lbann {
+namespace onednn {
+
+/** @brief Geometry of a CPU convolution.
+ *
+ *  Described from the convolution's point of view: @c src is the
+ *  tensor the kernel slides over and @c dst is the tensor it
+ *  produces, regardless of whether a layer applies it forward or
+ *  transposed. Tensors are LBANN matrices with one sample per column
+ *  and packed (channels, spatial dims...) rows.
+ */
+struct convolution_geometry
+{
+  /** @brief Number of samples. */
+  int mini_batch_size;
+  /** @brief Source dimensions (channels, spatial dims...). */
+  std::vector<int> src_dims;
+  /** @brief Destination dimensions (channels, spatial dims...). */
+  std::vector<int> dst_dims;
+  /** @brief Kernel dimensions.
+   *  @details (dst channels, src channels / groups, spatial dims...)
+   */
+  std::vector<int> kernel_dims;
+  std::vector<int> pads;
+  std::vector<int> strides;
+  std::vector<int> dilations;
+  int groups;
+  /** @brief Leading dimension of the source matrix. */
+  El::Int src_ldim;
+  /** @brief Leading dimension of the destination matrix. */
+  El::Int dst_ldim;
+};
+
+/** @brief Memory in the layout preferred by a primitive.
+ *
+ *  Wraps a buffer in LBANN's layout. If the primitive picked a
+ *  different (e.g. blocked) layout, a persistent buffer in that
+ *  layout and the reorder between the two are kept as well.
+ */
+class staged_memory
+{
+public:
+  void setup(dnnl::memory::desc const& user_md,
+             dnnl::memory::desc const& primitive_md,
+             dnnl::engine const& engine,
+             bool is_input);
+
+  /** @brief Get primitive memory holding the contents of @c buffer. */
+  dnnl::memory import(dnnl::stream& stream, void const* buffer) const;
+  /** @brief Get primitive memory that will be written to @c buffer. */
+  dnnl::memory output(void* buffer) const;
+  /** @brief Copy memory returned by @c output into @c buffer. */
+  void finish_output(dnnl::stream& stream,
+                     dnnl::memory& primitive_memory,
+                     void* buffer) const;
+
+private:
+  dnnl::engine m_engine;
+  dnnl::memory::desc m_user_md;
+  dnnl::memory m_primitive_memory;
+  dnnl::reorder m_reorder;
+  bool m_needs_reorder = false;
+};
+
+/** @brief Cached oneDNN primitives for a CPU convolution.
+ *
+ *  Primitives are created for one geometry and reused across
+ *  mini-batches of the same size. oneDNN is free to pick blocked
+ *  memory formats; data is reordered to and from LBANN's layout
+ *  around each call. Backward primitives are only built on first
+ *  use, so inference never pays for them.
+ */
+template <typename T>
+class convolution_primitives
+{
+public:
+  convolution_primitives(convolution_geometry geom);
+
+  convolution_geometry const& geometry() const noexcept { return m_geom; }
+
+  /** @brief dst = conv(src, weights) */
+  void forward(T const* src, T const* weights, T* dst);
+  /** @brief diff_src = conv^T(diff_dst, weights) */
+  void backward_data(T const* diff_dst, T const* weights, T* diff_src);
+  /** @brief Overwrite @c diff_weights with the kernel gradient. */
+  void backward_weights(T const* src, T const* diff_dst, T* diff_weights);
+
+private:
+  void setup_backward_data();
+  void setup_backward_weights();
+
+  convolution_geometry m_geom;
+  dnnl::engine m_engine;
+  dnnl::memory::dims m_strides;
+  dnnl::memory::dims m_dilations;
+  dnnl::memory::dims m_pads;
+  dnnl::memory::desc m_src_md;
+  dnnl::memory::desc m_weights_md;
+  dnnl::memory::desc m_dst_md;
+
+  dnnl::convolution_forward::primitive_desc m_fwd_pd;
+  dnnl::convolution_forward m_fwd;
+  staged_memory m_fwd_src, m_fwd_weights, m_fwd_dst;
+
+  bool m_has_bwd_data = false;
+  dnnl::convolution_backward_data m_bwd_data;
+  staged_memory m_bwd_data_diff_dst, m_bwd_data_weights, m_bwd_data_diff_src;
+
+  bool m_has_bwd_weights = false;
+  dnnl::convolution_backward_weights m_bwd_weights;
+  staged_memory m_bwd_weights_src, m_bwd_weights_diff_dst,
+    m_bwd_weights_diff_weights;
+};
+
+} // namespace onednn
+} // namespace lbann
+#endif // LBANN_UTILS_DNN_LIB_ONEDNN_CONVOLUTION_HPP_
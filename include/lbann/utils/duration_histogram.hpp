@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_DURATION_HISTOGRAM_HPP_INCLUDED
+#define LBANN_UTILS_DURATION_HISTOGRAM_HPP_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace lbann {
+
+/** @class DurationHistogram
+ *  @brief Fixed-size histogram of durations for percentile queries.
+ *
+ *  Durations are binned into log-spaced buckets, eight per power of
+ *  two, between 2^-24 s (~60 ns) and 2^16 s (~18 h), so a percentile
+ *  is accurate to within about 9%. Inserting is a few arithmetic
+ *  operations and never allocates.
+ */
+class DurationHistogram
+{
+public:
+  /** @brief Add a duration in seconds. */
+  void insert(double seconds) noexcept;
+
+  /** @brief Forget all durations. */
+  void reset() noexcept;
+
+  /** @brief The number of durations observed. */
+  uint64_t samples() const noexcept { return m_samples; }
+
+  /** @brief Approximate @c q-th quantile, for @c q in [0,1].
+   *
+   *  Returns 0 if no durations have been observed.
+   */
+  double percentile(double q) const noexcept;
+
+private:
+  static constexpr int min_exponent = -24;
+  static constexpr int max_exponent = 16;
+  static constexpr int buckets_per_octave = 8;
+  static constexpr size_t num_buckets =
+    (max_exponent - min_exponent) * buckets_per_octave;
+
+  /** @brief Bucket of a positive duration. */
+  static size_t bucket(double seconds) noexcept;
+  /** @brief Geometric midpoint of a bucket. */
+  static double bucket_value(size_t index) noexcept;
+
+  std::array<uint64_t, num_buckets> m_counts = {};
+  uint64_t m_samples = 0;
+  double m_min = 0.;
+  double m_max = 0.;
+}; // class DurationHistogram
+
+inline void DurationHistogram::insert(double seconds) noexcept
+{
+  seconds = std::max(seconds, 0.);
+  m_min = m_samples ? std::min(m_min, seconds) : seconds;
+  m_max = m_samples ? std::max(m_max, seconds) : seconds;
+  ++m_counts[bucket(seconds)];
+  ++m_samples;
+}
+
+inline void DurationHistogram::reset() noexcept
+{
+  m_counts.fill(0);
+  m_samples = 0;
+  m_min = m_max = 0.;
+}
+
+inline double DurationHistogram::percentile(double q) const noexcept
+{
+  if (m_samples == 0) {
+    return 0.;
+  }
+  q = std::clamp(q, 0., 1.);
+  auto const rank =
+    std::max<uint64_t>(static_cast<uint64_t>(std::ceil(q * m_samples)), 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < num_buckets; ++i) {
+    seen += m_counts[i];
+    if (seen >= rank) {
+      return std::clamp(bucket_value(i), m_min, m_max);
+    }
+  }
+  return m_max;
+}
+
+inline size_t DurationHistogram::bucket(double seconds) noexcept
+{
+  // seconds = mantissa * 2^exponent with mantissa in [0.5,1)
+  int exponent;
+  double const mantissa = std::frexp(seconds, &exponent);
+  if (seconds <= 0. || exponent <= min_exponent) {
+    return 0;
+  }
+  if (exponent > max_exponent) {
+    return num_buckets - 1;
+  }
+  auto const sub =
+    static_cast<size_t>((2. * mantissa - 1.) * buckets_per_octave);
+  return (exponent - min_exponent - 1) * buckets_per_octave +
+         std::min<size_t>(sub, buckets_per_octave - 1);
+}
+
+inline double DurationHistogram::bucket_value(size_t index) noexcept
+{
+  int const exponent = min_exponent + static_cast<int>(index) /
+                                        buckets_per_octave;
+  double const sub = index % buckets_per_octave;
+  double const lo = 1. + sub / buckets_per_octave;
+  double const hi = 1. + (sub + 1.) / buckets_per_octave;
+  return std::ldexp(std::sqrt(lo * hi), exponent);
+}
+
+} // namespace lbann
+#endif // LBANN_UTILS_DURATION_HISTOGRAM_HPP_INCLUDED
@@ -30,6 +30,10 @@
 #include <lbann/utils/dim_helpers.hpp>
 #include <lbann/utils/exception.hpp>
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 namespace lbann {
 // Some metaprogramming. This isn't specific to FFT and should
 // probably move elsewhere sometime soon.
@@ -65,6 +69,58 @@ template <typename T>
 using ToComplex = typename ToComplexT<T>::type;
 
 namespace fft {
+
+/** @brief Process-wide cache of FFT plans
+ *
+ *  Building a plan is expensive, but it only depends on the transform
+ *  layout. Wrappers that see the same dimensions, mini-batch size and
+ *  stream share one plan, so FFT layers are cheap to set up, copy and
+ *  resize. Plans live until the cache is cleared.
+ *
+ *  @tparam KeyT  Ordered description of the transform layout.
+ *  @tparam PlanT Owning wrapper around a library plan handle.
+ */
+template <typename KeyT, typename PlanT>
+class PlanCache
+{
+public:
+  static PlanCache& instance()
+  {
+    static PlanCache cache;
+    return cache;
+  }
+
+  /** @brief Get the plan for @c key, building it if needed.
+   *  @param make_plan Callable returning a
+   *                   <tt>std::shared_ptr<PlanT></tt>. Only called
+   *                   on a cache miss.
+   */
+  template <typename MakePlanT>
+  std::shared_ptr<PlanT> get(KeyT const& key, MakePlanT&& make_plan)
+  {
+    // FFT planners are generally not thread-safe, so plans are also
+    // built under the lock.
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = plans_.find(key);
+    if (iter == plans_.end()) {
+      iter = plans_.emplace(key, make_plan()).first;
+    }
+    return iter->second;
+  }
+
+  /** @brief Release the cache's references to its plans. */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    plans_.clear();
+  }
+
+private:
+  PlanCache() = default;
+  std::mutex mutex_;
+  std::map<KeyT, std::shared_ptr<PlanT>> plans_;
+};
+
 template <typename T>
 auto get_r2c_output_dims(std::vector<T> const& dims)
 {
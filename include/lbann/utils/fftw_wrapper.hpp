@@ -33,6 +33,11 @@
 
 #include <fftw3.h>
 
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 namespace lbann {
 
 namespace fftw {
@@ -87,6 +92,7 @@ struct FFTWTraits;
     static constexpr auto execute_plan_bwd = &FFTW_PREFIX##_execute_dft_c2r;   \
     static constexpr auto destroy_plan = &FFTW_PREFIX##_destroy_plan;          \
     static constexpr auto plain_execute = &FFTW_PREFIX##_execute;              \
+    static constexpr auto alignment_of = &FFTW_PREFIX##_alignment_of;          \
   }
 
 #define BUILD_FFTW_C2C_TRAITS(INTYPE, FFTW_PREFIX)                             \
@@ -99,6 +105,7 @@ struct FFTWTraits;
     static constexpr auto execute_plan_bwd = &FFTW_PREFIX##_execute_dft;       \
     static constexpr auto destroy_plan = &FFTW_PREFIX##_destroy_plan;          \
     static constexpr auto plain_execute = &FFTW_PREFIX##_execute;              \
+    static constexpr auto alignment_of = &FFTW_PREFIX##_alignment_of;          \
     static plan_type plan_many_fwd(int rank,                                   \
                                    const int* n,                               \
                                    int howmany,                                \
@@ -227,8 +234,7 @@ private:
   struct InternalPlanType
   {
     PlanType plan_ = nullptr;
-    int num_samples_ = -1; // It's just an int in fftw
-    InternalPlanType(PlanType plan, int n) : plan_{plan}, num_samples_{n} {}
+    InternalPlanType(PlanType plan) : plan_{plan} {}
     ~InternalPlanType()
     {
       if (plan_ != nullptr) {
@@ -236,14 +242,26 @@ private:
         plan_ = nullptr;
       }
     }
-    InternalPlanType(InternalPlanType&& other) noexcept
-      : plan_{other.plan_}, num_samples_{other.num_samples_}
+    InternalPlanType(InternalPlanType&& other) noexcept : plan_{other.plan_}
     {
       other.plan_ = nullptr;
-      other.num_samples_ = -1;
     }
   }; // struct InternalPlanType
 
+  /** @brief Layout of a transform
+   *
+   *  (full dims, num samples, input ldim, output ldim, in-place,
+   *  input alignment, output alignment, forward)
+   *
+   *  New-array execution requires the same alignment and in-place-ness
+   *  that the plan was built with.
+   */
+  using PlanKeyType = std::
+    tuple<std::vector<int>, int, El::Int, El::Int, bool, int, int, bool>;
+  using PlanCacheType = fft::PlanCache<PlanKeyType, InternalPlanType>;
+  using PlanListType =
+    std::vector<std::pair<PlanKeyType, std::shared_ptr<InternalPlanType>>>;
+
 public:
   FFTWWrapper() = default;
   ~FFTWWrapper() = default;
@@ -265,6 +283,7 @@ public:
                  out,
                  full_dims,
                  fwd_plans_,
+                 /*forward=*/true,
                  TraitsType::plan_many_fwd,
                  TraitsType::plan_guru_fwd);
   }
@@ -295,6 +314,7 @@ public:
                  out,
                  full_dims,
                  bwd_plans_,
+                 /*forward=*/false,
                  TraitsType::plan_many_bwd,
                  TraitsType::plan_guru_bwd);
   }
@@ -312,19 +332,11 @@ public:
 
   void compute_forward(InputMatType& in, OutputMatType& out) const
   {
-    auto const num_samples = in.Width();
-    auto const good_plan =
-      std::find_if(cbegin(fwd_plans_),
-                   cend(fwd_plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
-                   });
-    if (good_plan == cend(fwd_plans_))
-      LBANN_ERROR("No valid FFTW plan found.");
+    auto const& plan = find_plan(fwd_plans_, in, out, true);
 
     // Initial tests suggest there's no performance reason to *not*
     // use the "new-array" interface.
-    TraitsType::execute_plan_fwd(good_plan->plan_,
+    TraitsType::execute_plan_fwd(plan.plan_,
                                  AsFFTWType(in.Buffer()),
                                  AsFFTWType(out.Buffer()));
   }
@@ -336,19 +348,11 @@ public:
 
   void compute_backward(OutputMatType& in, InputMatType& out) const
   {
-    auto const num_samples = in.Width();
-    auto const good_plan =
-      std::find_if(cbegin(bwd_plans_),
-                   cend(bwd_plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
-                   });
-    if (good_plan == cend(bwd_plans_))
-      LBANN_ERROR("No valid FFTW plan found.");
+    auto const& plan = find_plan(bwd_plans_, in, out, false);
 
     // Initial tests suggest there's no performance reason to *not*
     // use the "new-array" interface.
-    TraitsType::execute_plan_bwd(good_plan->plan_,
+    TraitsType::execute_plan_bwd(plan.plan_,
                                  AsFFTWType(in.Buffer()),
                                  AsFFTWType(out.Buffer()));
   }
@@ -359,6 +363,41 @@ public:
   }
 
 private:
+  template <typename InMatT, typename OutMatT>
+  PlanKeyType
+  make_key(InMatT const& in, OutMatT const& out, bool forward) const
+  {
+    auto* in_buffer = const_cast<typename InMatT::value_type*>(
+      in.LockedBuffer());
+    auto* out_buffer = const_cast<typename OutMatT::value_type*>(
+      out.LockedBuffer());
+    return PlanKeyType{
+      full_dims_,
+      static_cast<int>(in.Width()),
+      in.LDim(),
+      out.LDim(),
+      static_cast<void*>(in_buffer) == static_cast<void*>(out_buffer),
+      TraitsType::alignment_of(reinterpret_cast<RealType*>(in_buffer)),
+      TraitsType::alignment_of(reinterpret_cast<RealType*>(out_buffer)),
+      forward};
+  }
+
+  template <typename InMatT, typename OutMatT>
+  InternalPlanType const& find_plan(PlanListType const& plans,
+                                    InMatT const& in,
+                                    OutMatT const& out,
+                                    bool forward) const
+  {
+    auto const key = make_key(in, out, forward);
+    auto const good_plan =
+      std::find_if(cbegin(plans), cend(plans), [&key](auto const& a) {
+        return a.first == key;
+      });
+    if (good_plan == cend(plans))
+      LBANN_ERROR("No valid FFTW plan found.");
+    return *(good_plan->second);
+  }
+
   template <typename InMatT,
             typename OutMatT,
             typename SetupManyFunctorT,
@@ -366,7 +405,8 @@ private:
   void setup_common(InMatT& in,
                     OutMatT& out,
                     std::vector<int> const& full_dims,
-                    std::vector<InternalPlanType>& plans,
+                    PlanListType& plans,
+                    bool forward,
                     SetupManyFunctorT many_functor,
                     SetupGuruFunctorT guru_functor)
   {
@@ -376,15 +416,17 @@ private:
 
     // Look for an acceptable plan
     int const num_samples = in.Width();
+    full_dims_ = full_dims;
+    auto const key = make_key(in, out, forward);
     auto const good_plan =
-      std::find_if(cbegin(plans),
-                   cend(plans),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
-                   });
-
-    // We don't have a plan for this yet; let's create one!
-    if (good_plan == cend(plans)) {
+      std::find_if(cbegin(plans), cend(plans), [&key](auto const& a) {
+        return a.first == key;
+      });
+    if (good_plan != cend(plans))
+      return;
+
+    // Reuse a plan from any wrapper with the same layout, or create one
+    auto make_plan = [&]() {
       PlanType plan;
 
       auto const& input_dims = Dims::input_dims(full_dims);
@@ -452,15 +494,17 @@ private:
                     "  contiguous: ",
                     contiguous_samples);
 
-      plans.emplace_back(plan, num_samples);
-    }
+      return std::make_shared<InternalPlanType>(plan);
+    };
+    plans.emplace_back(key, PlanCacheType::instance().get(key, make_plan));
   }
 
 private:
   // These are likely to be so few in number that a linear search is
   // going to be fine.
-  std::vector<InternalPlanType> fwd_plans_;
-  std::vector<InternalPlanType> bwd_plans_;
+  PlanListType fwd_plans_;
+  PlanListType bwd_plans_;
+  std::vector<int> full_dims_;
 
 }; // class FFTWWrapper
 
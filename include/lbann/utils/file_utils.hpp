@@ -178,6 +178,34 @@ void make_directory(const std::string& path);
 
 void remove_multiple_slashes(std::string& str);
 
+/** @brief List the regular files below a directory.
+ *
+ *  Subdirectories are searched recursively. Paths are relative to @c
+ *  dir and sorted.
+ */
+std::vector<std::string> list_files(const std::string& dir);
+
+/** @brief Read-only memory mapping of a whole file.
+ *
+ *  The mapping is shared (@c MAP_SHARED), so ranks on a node that map
+ *  the same file share its pages in the page cache.
+ */
+class mapped_file
+{
+public:
+  explicit mapped_file(const std::string& filename);
+  ~mapped_file();
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  const char* data() const { return static_cast<const char*>(m_data); }
+  size_t size() const { return m_size; }
+
+private:
+  void* m_data = nullptr;
+  size_t m_size = 0;
+};
+
 } // namespace file
 
 } // namespace lbann
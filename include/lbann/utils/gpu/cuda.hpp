@@ -112,6 +112,8 @@ public:
   bool query() const;
   /** Wait until CUDA event has completed. */
   void synchronize();
+  /** Make a CUDA stream wait until the event has completed. */
+  void wait(cudaStream_t stream);
   /** Get CUDA event object. */
   cudaEvent_t& get_event();
 
@@ -126,6 +128,24 @@ private:
   cudaStream_t m_stream;
 };
 
+/** CUDA event that records a timestamp. */
+class timing_event
+{
+public:
+  timing_event();
+  timing_event(const timing_event&) = delete;
+  timing_event& operator=(const timing_event&) = delete;
+  ~timing_event();
+  /** Enqueue CUDA event on a CUDA stream. */
+  void record(cudaStream_t stream);
+  /** Milliseconds between @c start and this event.
+   *  Blocks until this event has completed. */
+  float elapsed_ms(const timing_event& start);
+
+private:
+  cudaEvent_t m_event;
+};
+
 /** Wrapper around @c cudaGraph_t */
 class Graph
 {
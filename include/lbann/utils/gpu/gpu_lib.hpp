@@ -91,6 +91,35 @@ __device__ __forceinline__ T block_reduce(T val);
 template <size_t bdimx, size_t bdimy, size_t bdimz, class T, class Op>
 __device__ __forceinline__ T block_reduce(T val);
 
+/** @brief Sum over groups of threads within a warp
+ *
+ *  Threads are split into aligned groups of @c width consecutive
+ *  lanes. Every thread in the warp must enter this function. The sum
+ *  is returned on every thread of the group.
+ *
+ *  @tparam width   Group size. Must be a power of two and at most 32.
+ *  @tparam T       Data type
+ *  @param  val     Contribution from thread
+ *  @returns The sum over the thread's group.
+ */
+template <size_t width, class T>
+__device__ __forceinline__ T warp_reduce(T val);
+
+/** @brief Reduction over groups of threads within a warp
+ *
+ *  Threads are split into aligned groups of @c width consecutive
+ *  lanes. Every thread in the warp must enter this function. The
+ *  reduced value is returned on every thread of the group.
+ *
+ *  @tparam width   Group size. Must be a power of two and at most 32.
+ *  @tparam T       Data type
+ *  @tparam Op      Functor for reduction operation
+ *  @param  val     Contribution from thread
+ *  @returns The reduced value over the thread's group.
+ */
+template <size_t width, class T, class Op>
+__device__ __forceinline__ T warp_reduce(T val);
+
 // Unary math functions
 #define DECLARE_UNARY_MATH_FUNC_WITH_TYPE(func, type)                          \
   __device__ __forceinline__ type func(type const& x)
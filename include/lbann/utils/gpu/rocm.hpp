@@ -112,6 +112,8 @@ public:
   bool query() const;
   /** Wait until HIP event has completed. */
   void synchronize();
+  /** Make a HIP stream wait until the event has completed. */
+  void wait(hipStream_t stream);
   /** Get HIP event object. */
   hipEvent_t& get_event();
 
@@ -126,6 +128,24 @@ private:
   hipStream_t m_stream;
 };
 
+/** HIP event that records a timestamp. */
+class timing_event
+{
+public:
+  timing_event();
+  timing_event(const timing_event&) = delete;
+  timing_event& operator=(const timing_event&) = delete;
+  ~timing_event();
+  /** Enqueue HIP event on a HIP stream. */
+  void record(hipStream_t stream);
+  /** Milliseconds between @c start and this event.
+   *  Blocks until this event has completed. */
+  float elapsed_ms(const timing_event& start);
+
+private:
+  hipEvent_t m_event;
+};
+
 // -------------------------------------------------------------
 // Helper functions for tensor operations
 // -------------------------------------------------------------
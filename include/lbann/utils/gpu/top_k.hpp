@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_GPU_TOP_K_HPP_INCLUDED
+#define LBANN_UTILS_GPU_TOP_K_HPP_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace gpu_lib {
+
+/** @brief Sparse vector entry produced by top-k selection. */
+template <typename T>
+struct top_k_entry
+{
+  /** Vector entry value. */
+  T value;
+  /** Vector entry index. */
+  El::Int index;
+};
+
+/** @brief Whether @c a precedes @c b in a top-k list.
+ *  Entries are ordered by value in decreasing order, with ties broken
+ *  in favor of entries with smaller indices.
+ */
+template <typename T>
+__host__ __device__ __forceinline__ bool
+top_k_precedes(const top_k_entry<T>& a, const top_k_entry<T>& b)
+{
+  return a.value > b.value || (a.value == b.value && a.index < b.index);
+}
+
+/** @brief Largest k supported by @c top_k_columns. */
+constexpr El::Int max_top_k = 32;
+
+/** @brief Find the k largest entries in each column of a matrix.
+ *
+ *  Each column is handled by one thread block. Every thread keeps a
+ *  sorted list of the k best entries among the rows it reads, then
+ *  the block extracts the global top-k with k rounds of a
+ *  shared-memory reduction over the heads of the per-thread
+ *  lists. The cost per column is O(height*k/bdimx + k*log(bdimx)),
+ *  which avoids sorting the whole column.
+ *
+ *  Row i of the local matrix is reported with index
+ *  row_shift + i*row_stride. If the column has fewer than k entries,
+ *  the list is padded with -infinity entries with index
+ *  @c pad_index.
+ *
+ *  Block dimensions: bdimx x 1 x 1, with bdimx a power of two
+ *
+ *  Grid dimensions: width x 1 x 1
+ */
+template <size_t bdimx, El::Int max_k, typename T>
+__global__ void top_k_columns_kernel(El::Int k,
+                                     El::Int height,
+                                     El::Int width,
+                                     El::Int row_shift,
+                                     El::Int row_stride,
+                                     El::Int pad_index,
+                                     const T* __restrict__ input,
+                                     El::Int input_ldim,
+                                     top_k_entry<T>* __restrict__ output,
+                                     El::Int output_ldim)
+{
+  const size_t tid = threadIdx.x;
+  __shared__ T shared_values[bdimx];
+  __shared__ El::Int shared_indices[bdimx];
+
+  for (El::Int col = blockIdx.x; col < width; col += gridDim.x) {
+
+    // Per-thread sorted list of best entries
+    top_k_entry<T> list[max_k];
+    for (El::Int i = 0; i < k; ++i) {
+      list[i].value = -gpu_lib::infinity<T>();
+      list[i].index = pad_index;
+    }
+    for (El::Int row = tid; row < height; row += bdimx) {
+      top_k_entry<T> x;
+      x.value = input[row + col * input_ldim];
+      x.index = row_shift + row * row_stride;
+      if (top_k_precedes(x, list[k - 1])) {
+        El::Int i = k - 1;
+        for (; i > 0 && top_k_precedes(x, list[i - 1]); --i) {
+          list[i] = list[i - 1];
+        }
+        list[i] = x;
+      }
+    }
+
+    // Merge per-thread lists, one output entry at a time
+    El::Int pos = 0;
+    for (El::Int out_pos = 0; out_pos < k; ++out_pos) {
+      const auto& head = list[pos < k ? pos : k - 1];
+      shared_values[tid] = head.value;
+      shared_indices[tid] = head.index;
+      for (size_t stride = bdimx / 2; stride > 0; stride /= 2) {
+        __syncthreads();
+        if (tid < stride) {
+          top_k_entry<T> a, b;
+          a.value = shared_values[tid];
+          a.index = shared_indices[tid];
+          b.value = shared_values[tid + stride];
+          b.index = shared_indices[tid + stride];
+          if (top_k_precedes(b, a)) {
+            shared_values[tid] = b.value;
+            shared_indices[tid] = b.index;
+          }
+        }
+      }
+      __syncthreads();
+      const auto winner_index = shared_indices[0];
+      if (tid == 0) {
+        auto& out = output[out_pos + col * output_ldim];
+        out.value = shared_values[0];
+        out.index = winner_index;
+      }
+      // Indices are unique apart from padding, and padding entries
+      // are interchangeable
+      if (pos < k && head.index == winner_index) {
+        ++pos;
+      }
+      __syncthreads();
+    }
+  }
+}
+
+/** @brief Find the k largest entries in each column of a matrix.
+ *
+ *  See @c top_k_columns_kernel. Requires 1 <= k <= @c max_top_k.
+ *  The output matrix is k x width, with leading dimension
+ *  @c output_ldim.
+ */
+template <typename T>
+void top_k_columns(El::Int k,
+                   El::Int height,
+                   El::Int width,
+                   El::Int row_shift,
+                   El::Int row_stride,
+                   El::Int pad_index,
+                   const T* input,
+                   El::Int input_ldim,
+                   top_k_entry<T>* output,
+                   El::Int output_ldim,
+                   const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  if (k < 1 || k > max_top_k) {
+    LBANN_ERROR("top-k kernel supports 1 <= k <= ",
+                max_top_k,
+                ", but got k=",
+                k);
+  }
+  if (width < 1) {
+    return;
+  }
+  constexpr size_t block_size = 128;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = width;
+  gpu_lib::clip_grid_dims(grid_dims);
+  if (k <= 4) {
+    hydrogen::gpu::LaunchKernel(top_k_columns_kernel<block_size, 4, T>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                k,
+                                height,
+                                width,
+                                row_shift,
+                                row_stride,
+                                pad_index,
+                                input,
+                                input_ldim,
+                                output,
+                                output_ldim);
+  }
+  else {
+    hydrogen::gpu::LaunchKernel(top_k_columns_kernel<block_size, max_top_k, T>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                k,
+                                height,
+                                width,
+                                row_shift,
+                                row_stride,
+                                pad_index,
+                                input,
+                                input_ldim,
+                                output,
+                                output_ldim);
+  }
+}
+
+} // namespace gpu_lib
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_UTILS_GPU_TOP_K_HPP_INCLUDED
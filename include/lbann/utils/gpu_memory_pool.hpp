@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_GPU_MEMORY_POOL_HPP_INCLUDED
+#define LBANN_UTILS_GPU_MEMORY_POOL_HPP_INCLUDED
+
+#include "lbann_config.hpp"
+
+#ifdef LBANN_HAS_GPU
+
+#include <cstddef>
+#include <map>
+
+namespace lbann {
+namespace gpu {
+
+/** @brief Snapshot of Hydrogen's GPU memory pool on this device.
+ *
+ *  All zero if Hydrogen was built without the CUB memory pool.
+ */
+struct memory_pool_statistics
+{
+  /** @brief Bytes in blocks handed out to allocations. */
+  size_t live_bytes = 0;
+  size_t live_blocks = 0;
+  /** @brief Bytes in blocks cached for reuse. */
+  size_t free_bytes = 0;
+  size_t free_blocks = 0;
+  size_t largest_free_block = 0;
+  /** @brief Number of cached blocks of each bin size (bytes). */
+  std::map<size_t, size_t> free_bins;
+
+  /** @brief Fraction of the cached bytes outside the largest cached
+   *         block.
+   *
+   *  Close to 1 when the cache is split into many small blocks, which
+   *  cannot serve a large request even though enough bytes are free.
+   */
+  double fragmentation() const noexcept;
+};
+
+/** @brief Current statistics of the memory pool. */
+memory_pool_statistics get_memory_pool_statistics();
+
+/** @brief Grow the memory pool past its high-water mark.
+ *
+ *  Each bin gets @c slack times as many extra cached blocks as it
+ *  holds, live or cached, and the pool's cache limit is raised to
+ *  keep them.
+ *
+ *  @returns Bytes added to the pool.
+ */
+size_t grow_memory_pool(double slack);
+
+/** @brief Grow the memory pool past its high-water mark once.
+ *
+ *  Meant to be called after a warm-up step, when the pool holds one
+ *  block for everything the step needed at its peak. Calls
+ *  grow_memory_pool with the slack given to
+ *  @c --preallocate_memory_pool. Later steps, including ones after a
+ *  mini-batch size change, are served from the cache instead of
+ *  allocating device memory late in the run.
+ *
+ *  Does nothing unless enabled with @c --preallocate_memory_pool,
+ *  and only the first call in a process has an effect.
+ *
+ *  @returns Bytes added to the pool.
+ */
+size_t preallocate_memory_pool();
+
+} // namespace gpu
+} // namespace lbann
+
+#endif // LBANN_HAS_GPU
+#endif // LBANN_UTILS_GPU_MEMORY_POOL_HPP_INCLUDED
@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_GPU_WORKSPACE_HPP_INCLUDED
+#define LBANN_UTILS_GPU_WORKSPACE_HPP_INCLUDED
+
+#include "lbann_config.hpp"
+
+#ifdef LBANN_HAS_GPU
+
+#include <El.hpp>
+
+#include <cstddef>
+
+namespace lbann {
+namespace gpu {
+
+/** @brief Get scratch memory for work on a GPU stream.
+ *
+ *  Every stream owns one workspace that is shared by all DNN library
+ *  and cuTENSOR calls issued on it. The workspace grows to the
+ *  largest request it has seen and is then reused, so steady-state
+ *  training does no workspace allocations and does not fragment the
+ *  memory pool with many differently sized buffers.
+ *
+ *  Since work on a stream is ordered, the memory may be reused as
+ *  soon as the calls that use it have been enqueued. The pointer is
+ *  only valid until the next request on the same stream.
+ */
+void* get_workspace(size_t size, El::SyncInfo<El::Device::GPU> const& si);
+
+/** @brief Get a stream workspace as a column vector.
+ *
+ *  The matrix views the stream's workspace (see @c get_workspace)
+ *  and holds at least @c size bytes. It must not be resized.
+ */
+template <typename T>
+El::Matrix<T, El::Device::GPU>
+get_workspace_matrix(size_t size, El::SyncInfo<El::Device::GPU> const& si)
+{
+  const El::Int height = (size + sizeof(T) - 1) / sizeof(T);
+  El::Matrix<T, El::Device::GPU> workspace;
+  workspace.Attach(height,
+                   1,
+                   static_cast<T*>(get_workspace(height * sizeof(T), si)),
+                   El::Max(height, El::Int(1)));
+  El::SetSyncInfo(workspace, si);
+  return workspace;
+}
+
+/** @brief Bytes held by all stream workspaces. */
+size_t get_workspace_capacity();
+
+/** @brief Release all stream workspaces. */
+void free_workspaces();
+
+} // namespace gpu
+} // namespace lbann
+
+#endif // LBANN_HAS_GPU
+#endif // LBANN_UTILS_GPU_WORKSPACE_HPP_INCLUDED
@@ -119,5 +119,21 @@ void condensation(const std::set<El::Int>& nodes,
                   std::set<El::Int>& condensation_nodes,
                   std::map<El::Int, std::set<El::Int>>& condensation_edges);
 
+/** Assign the nodes of a topologically sorted DAG to a pool of
+ *  streams.
+ *
+ *  Nodes are visited in sorted order. A node continues on the stream
+ *  of its first parent that no earlier sibling has continued from;
+ *  otherwise it starts on the next stream in round-robin order, so
+ *  independent branches land on different streams. The assignment is
+ *  deterministic.
+ *
+ *  @returns Stream index in [0, num_streams) for each node.
+ */
+std::map<El::Int, int>
+assign_streams(const std::set<El::Int>& nodes,
+               const std::map<El::Int, std::set<El::Int>>& edges,
+               int num_streams);
+
 } // namespace graph
 } // namespace lbann
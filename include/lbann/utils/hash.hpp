@@ -27,10 +27,17 @@
 #ifndef LBANN_UTILS_HASH_HPP_INCLUDED
 #define LBANN_UTILS_HASH_HPP_INCLUDED
 
+#include <cstdint>
 #include <functional>
 #include <type_traits>
 #include <utility>
 
+#if defined __CUDACC__ || defined __HIPCC__
+#define LBANN_HASH_FUNC __host__ __device__ __forceinline__
+#else
+#define LBANN_HASH_FUNC inline
+#endif // __CUDACC__ || __HIPCC__
+
 namespace lbann {
 
 /** @brief Combine two hash values
@@ -81,6 +88,21 @@ struct pair_hash
   }
 };
 
+/** @brief 64-bit finalizer of SplitMix64
+ *
+ *  A bijective mix of all 64 input bits. Counter-based generators
+ *  apply it to a seed plus an entry's position, so host and device
+ *  produce the same values.
+ */
+LBANN_HASH_FUNC std::uint64_t splitmix64(std::uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
 } // namespace lbann
 
+#undef LBANN_HASH_FUNC
+
 #endif // LBANN_UTILS_HASH_HPP_INCLUDED
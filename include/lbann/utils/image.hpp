@@ -34,7 +34,8 @@ namespace lbann {
 /**
  * @brief Load an image from filename.
  * @param filename The path to the image to load.
- * @param dst Image will be loaded into this matrix, in OpenCV format.
+ * @param dst Image will be loaded into this matrix, in OpenCV format. Inside
+ * a utils::scratch_arena_scope, it will view scratch memory.
  * @param dims Will contain the dimensions of the image as {channels, height,
  * width}.
  */
@@ -44,8 +45,10 @@ void load_image(const std::string& filename,
 
 /**
  * @brief Decode an image from buf.
+ * @details JPEGs are rotated and flipped as their EXIF orientation asks.
  * @param src A buffer containing image data to be decoded.
- * @param dst Image will be loaded into this matrix, in OpenCV format.
+ * @param dst Image will be loaded into this matrix, in OpenCV format. Inside
+ * a utils::scratch_arena_scope, it will view scratch memory.
  * @param dims Will contain the dimensions of the image as {channels, height,
  * width}.
  */
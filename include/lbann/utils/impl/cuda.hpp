@@ -144,6 +144,31 @@ __device__ __forceinline__ T gpu_lib::block_reduce(T val)
   return val;
 }
 
+// Warp reduction
+template <size_t width, class T>
+__device__ __forceinline__ T gpu_lib::warp_reduce(T val)
+{
+  static_assert(width > 0 && width <= 32 && (width & (width - 1)) == 0,
+                "warp reduction width must be a power of two up to 32");
+#pragma unroll
+  for (int offset = width / 2; offset > 0; offset /= 2) {
+    val += __shfl_xor_sync(0xffffffff, val, offset, width);
+  }
+  return val;
+}
+template <size_t width, class T, class Op>
+__device__ __forceinline__ T gpu_lib::warp_reduce(T val)
+{
+  static_assert(width > 0 && width <= 32 && (width & (width - 1)) == 0,
+                "warp reduction width must be a power of two up to 32");
+  Op op;
+#pragma unroll
+  for (int offset = width / 2; offset > 0; offset /= 2) {
+    val = op(val, __shfl_xor_sync(0xffffffff, val, offset, width));
+  }
+  return val;
+}
+
 // Unary math functions
 #if __CUDA_ARCH__ >= 530
 template <>
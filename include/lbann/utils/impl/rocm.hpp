@@ -160,6 +160,45 @@ __device__ __forceinline__ T gpu_lib::block_reduce(T val)
   return val;
 }
 
+// Warp reduction
+// Note: HIP has no shuffle for __half, so it is shuffled as float.
+namespace rocm {
+namespace details {
+template <class T>
+__device__ __forceinline__ T shfl_xor(T val, int lane_mask, int width)
+{
+  return __shfl_xor(val, lane_mask, width);
+}
+__device__ __forceinline__ __half shfl_xor(__half val, int lane_mask, int width)
+{
+  return __float2half(__shfl_xor(__half2float(val), lane_mask, width));
+}
+} // namespace details
+} // namespace rocm
+template <size_t width, class T>
+__device__ __forceinline__ T gpu_lib::warp_reduce(T val)
+{
+  static_assert(width > 0 && width <= 32 && (width & (width - 1)) == 0,
+                "warp reduction width must be a power of two up to 32");
+#pragma unroll
+  for (int offset = width / 2; offset > 0; offset /= 2) {
+    val += rocm::details::shfl_xor(val, offset, width);
+  }
+  return val;
+}
+template <size_t width, class T, class Op>
+__device__ __forceinline__ T gpu_lib::warp_reduce(T val)
+{
+  static_assert(width > 0 && width <= 32 && (width & (width - 1)) == 0,
+                "warp reduction width must be a power of two up to 32");
+  Op op;
+#pragma unroll
+  for (int offset = width / 2; offset > 0; offset /= 2) {
+    val = op(val, rocm::details::shfl_xor(val, offset, width));
+  }
+  return val;
+}
+
 // Unary math functions
 // This support is far from complete!
 #define WRAP_UNARY_ROCM_HALF_MATH_FUNCTION(func)                               \
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_INT8_HPP
+#define LBANN_UTILS_INT8_HPP
+
+#include "lbann/base.hpp"
+
+#include <cstdint>
+
+namespace lbann {
+
+/** @brief Scale that maps [-range, range] onto [-127, 127].
+ *
+ *  Symmetric quantization: a value x is stored as round(x / scale),
+ *  clamped to [-127, 127], so that zero is represented exactly.
+ */
+template <typename TensorDataType>
+TensorDataType int8_scale(TensorDataType range);
+
+/** @brief Quantize op(X) to int8 with one scale for all entries.
+ *
+ *  @param x        Column-major matrix X.
+ *  @param height   Height of X.
+ *  @param width    Width of X.
+ *  @param ldx      Leading dimension of X.
+ *  @param transpose Whether op(X) is the transpose of X.
+ *  @param scale    Quantization scale, see int8_scale.
+ *  @param out      Dense column-major op(X).
+ *  @param batch_count Number of matrices, which are @c stride_x
+ *                  apart in @c x and stored one after another in
+ *                  @c out.
+ *  @param stride_x Distance between matrices in @c x.
+ */
+template <typename TensorDataType>
+void quantize_int8(const TensorDataType* x,
+                   El::Int height,
+                   El::Int width,
+                   El::Int ldx,
+                   bool transpose,
+                   TensorDataType scale,
+                   int8_t* out,
+                   El::Int batch_count = 1,
+                   El::Int stride_x = 0);
+
+/** @brief Quantize op(X) to int8 with one scale per column of op(X).
+ *
+ *  Used for weights, where each column holds the coefficients of one
+ *  output channel. Parameters are as for quantize_int8, except that
+ *  @c scales receives the scale chosen for each column of op(X).
+ */
+template <typename TensorDataType>
+void quantize_int8_columns(const TensorDataType* x,
+                           El::Int height,
+                           El::Int width,
+                           El::Int ldx,
+                           bool transpose,
+                           TensorDataType* scales,
+                           int8_t* out);
+
+/** @brief Strided-batched int8 GEMM with int32 accumulation.
+ *
+ *  Computes
+ *  @f$ C_b(i,j) = \alpha s_A(i) s_B(j) \sum_k A_b(k,i) B_b(k,j) @f$,
+ *  i.e. @f$ C_b = \alpha\, diag(s_A)\, A_b^T B_b\, diag(s_B) @f$,
+ *  where each @f$ A_b @f$ (k x m) and @f$ B_b @f$ (k x n) is dense
+ *  column-major, so that every output entry is a dot product of two
+ *  contiguous int8 vectors. Null scale arrays are treated as ones.
+ */
+template <typename TensorDataType>
+void gemm_int8(El::Int m,
+               El::Int n,
+               El::Int k,
+               TensorDataType alpha,
+               const int8_t* A,
+               El::Int stride_a,
+               const TensorDataType* a_scales,
+               const int8_t* B,
+               El::Int stride_b,
+               const TensorDataType* b_scales,
+               TensorDataType* C,
+               El::Int ldc,
+               El::Int stride_c,
+               El::Int batch_count);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_INT8_HPP
@@ -28,6 +28,8 @@
 #define LBANN_LIBRARY_HPP
 
 #include "lbann/execution_algorithms/batch_functional_inference_algorithm.hpp"
+#include "lbann/execution_algorithms/ensemble_inference.hpp"
+#include "lbann/execution_algorithms/inference_server.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/proto/proto_common.hpp"
 
@@ -41,7 +43,8 @@ const int lbann_default_random_seed = 42;
  * @param[in] mbs The max mini-batch size
  * @param[in] input_dims The dimension of the input tensor
  * @param[in] output_dims The dimension of the output tensor
- * @return Model loaded from checkpoint
+ * @return Model loaded from checkpoint and compiled for inference
+ *         (see model::compile_for_inference)
  */
 std::unique_ptr<model> load_inference_model(lbann_comm* lc,
                                             std::string cp_dir,
@@ -49,6 +52,41 @@ std::unique_ptr<model> load_inference_model(lbann_comm* lc,
                                             std::vector<int> input_dims,
                                             std::vector<int> output_dims);
 
+/** @brief Builds a model and loads its trained weights directly for
+ *         inference only
+ * @param[in] lc An LBANN Communicator
+ * @param[in] pb Description of the model, e.g. the prototext it was
+ *            trained with
+ * @param[in] weights_file Weights container written by save_model
+ * @param[in] mbs The max mini-batch size
+ * @return Model compiled for inference. Its weights skip random
+ *         initialization and are read from the memory-mapped
+ *         container on first use (see model::load_weights_at_setup).
+ */
+std::unique_ptr<model> load_inference_model(lbann_comm* lc,
+                                            lbann_data::LbannPB const& pb,
+                                            std::string const& weights_file,
+                                            int mbs);
+
+/** @brief Loads trained models from checkpoints for concurrent
+ *         inference over the same samples
+ * @param[in] lc An LBANN Communicator
+ * @param[in] cp_dirs The model checkpoint directories, one per model
+ * @param[in] mbs The max mini-batch size
+ * @param[in] input_dims The dimension of the input tensor
+ * @param[in] output_dims The dimension of the output tensor
+ * @param[in] num_streams GPU streams shared by the models; 0 gives
+ *            each model its own stream
+ * @return Ensemble of the models loaded with load_inference_model
+ */
+std::unique_ptr<ensemble_inference>
+load_inference_ensemble(lbann_comm* lc,
+                        std::vector<std::string> const& cp_dirs,
+                        int mbs,
+                        std::vector<int> input_dims,
+                        std::vector<int> output_dims,
+                        size_t num_streams = 0);
+
 /** @brief Creates execution algorithm and infers on samples using a model
  * @param[in] model A trained model
  * @param[in] samples A distributed matrix containing samples for model input
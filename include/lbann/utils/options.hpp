@@ -71,6 +71,7 @@ namespace lbann {
 
 // Input options
 #define LBANN_OPTION_CKPT_DIR "ckpt_dir"
+#define LBANN_OPTION_CONV_ALGO_CACHE "conv_algo_cache"
 #define LBANN_OPTION_HYDROGEN_BLOCK_SIZE "hydrogen_block_size"
 #define LBANN_OPTION_LOAD_MODEL_WEIGHTS_DIR "load_model_weights_dir"
 #define LBANN_OPTION_MAX_RNG_SEEDS_DISPLAY "RNG seeds per trainer to display"
@@ -80,7 +81,10 @@ namespace lbann {
 #define LBANN_OPTION_NUM_EPOCHS "num_epochs"
 #define LBANN_OPTION_NUM_IO_THREADS "Num. IO threads"
 #define LBANN_OPTION_MAX_IO_RNG_BANKS "Max IO RNG banks"
+#define LBANN_OPTION_NUM_PYTHON_WORKERS "Num. Python workers"
+#define LBANN_OPTION_THREAD_BUDGET_POLICY "Thread budget policy"
 #define LBANN_OPTION_OPTIMIZER "optimizer"
+#define LBANN_OPTION_PREALLOCATE_MEMORY_POOL "preallocate_memory_pool"
 #define LBANN_OPTION_PROCS_PER_TRAINER "Processes per trainer"
 #define LBANN_OPTION_PROTOTEXT "prototext"
 #define LBANN_OPTION_RANDOM_SEED "random_seed"
@@ -95,6 +99,8 @@ namespace lbann {
   "Enable async communication in Sub-grid parallelism"
 #define LBANN_OPTION_TRAINER_ENABLE_TOPO_AWARE_SUBGRID                         \
   "Enable topology aware process placement in Sub-grid parallelism"
+#define LBANN_OPTION_TRAINER_TOPOLOGY_AWARE                                    \
+  "Place trainers by network topology"
 #define LBANN_OPTION_NUM_SUBGRIDS_BLOCK_ORDER                                  \
   "Divide each trainer into equally-sized sub-grids with blocked ordering"
 #ifdef LBANN_HAS_CALIPER
@@ -106,14 +112,21 @@ namespace lbann {
 // Bool flags
 #define LBANN_OPTION_DATA_STORE_CACHE "data_store_cache"
 #define LBANN_OPTION_DATA_STORE_DEBUG "data_store_debug"
+#define LBANN_OPTION_DATA_STORE_DECODED_IMAGES "data_store_decoded_images"
 #define LBANN_OPTION_DATA_STORE_FAIL "data_store_fail"
+#define LBANN_OPTION_DATA_STORE_FIXED_RECORDS "data_store_fixed_records"
 #define LBANN_OPTION_DATA_STORE_MIN_MAX_TIMING "data_store_min_max_timing"
+#define LBANN_OPTION_DATA_STORE_NODE_AGGREGATION "data_store_node_aggregation"
 #define LBANN_OPTION_DATA_STORE_NO_THREAD "data_store_no_thread"
 #define LBANN_OPTION_DATA_STORE_PROFILE "data_store_profile"
 #define LBANN_OPTION_DATA_STORE_TEST_CACHE "data_store_test_cache"
 #define LBANN_OPTION_NODE_SIZES_VARY "node_sizes_vary"
 
 // Input options
+#define LBANN_OPTION_DATA_STORE_COMPRESSION_FIELDS                             \
+  "data_store_compression_fields"
+#define LBANN_OPTION_DATA_STORE_COMPRESSION_LEVEL "data_store_compression_level"
+#define LBANN_OPTION_DATA_STORE_SHUFFLE_LOCALITY "data_store_shuffle_locality"
 #define LBANN_OPTION_DATA_STORE_SPILL "data_store_spill"
 #define LBANN_OPTION_DATA_STORE_TEST_CHECKPOINT "data_store_test_checkpoint"
 
@@ -122,14 +135,19 @@ namespace lbann {
 #define LBANN_OPTION_CHECK_DATA "check_data"
 #define LBANN_OPTION_KEEP_SAMPLE_ORDER "keep_sample_order"
 #define LBANN_OPTION_KEEP_PACKED_FIELDS "keep_packed_fields"
+#define LBANN_OPTION_HDF5_CORE_DRIVER "hdf5_core_driver"
 #define LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE "load_full_sample_list_once"
+#define LBANN_OPTION_NODE_SHARED_NUMPY "node_shared_numpy"
+#define LBANN_OPTION_NODE_SHARED_SAMPLE_LIST "node_shared_sample_list"
 #define LBANN_OPTION_QUIET "quiet"
+#define LBANN_OPTION_SORT_MINI_BATCH_BY_FILE "sort_mini_batch_by_file"
 #define LBANN_OPTION_WRITE_SAMPLE_LABEL_LIST "write_sample_label_list"
 #define LBANN_OPTION_WRITE_SAMPLE_LIST "write_sample_list"
 #define LBANN_OPTION_Z_SCORE "z_score"
 
 // Input options
 #define LBANN_OPTION_ABSOLUTE_SAMPLE_COUNT "absolute_sample_count"
+#define LBANN_OPTION_CSV_BINARY_CACHE "csv_binary_cache"
 #define LBANN_OPTION_DATA_FILEDIR "data_filedir"
 #define LBANN_OPTION_DATA_FILEDIR_TEST "data_filedir_test"
 #define LBANN_OPTION_DATA_FILEDIR_TRAIN "data_filedir_train"
@@ -138,9 +156,12 @@ namespace lbann {
 #define LBANN_OPTION_DATA_FILENAME_TRAIN "data_filename_train"
 #define LBANN_OPTION_DATA_FILENAME_VALIDATE "data_filename_validate"
 #define LBANN_OPTION_DATA_READER_FRACTION "data_reader_fraction"
+#define LBANN_OPTION_HDF5_COMPUTE_NORMALIZATION "hdf5_compute_normalization"
 #define LBANN_OPTION_LABEL_FILENAME_TEST "label_filename_test"
 #define LBANN_OPTION_LABEL_FILENAME_TRAIN "label_filename_train"
 #define LBANN_OPTION_LABEL_FILENAME_VALIDATE "label_filename_validate"
+#define LBANN_OPTION_LENGTH_BUCKET_SIZE "length_bucket_size"
+#define LBANN_OPTION_MAX_OPEN_FILES "max_open_files"
 #define LBANN_OPTION_NORMALIZATION "normalization"
 #define LBANN_OPTION_PILOT2_READ_FILE_SIZES "pilot2_read_file_sizes"
 #define LBANN_OPTION_PILOT2_SAVE_FILE_SIZES "pilot2_save_file_sizes"
@@ -149,6 +170,8 @@ namespace lbann {
 #define LBANN_OPTION_SAMPLE_LIST_VALIDATE "sample_list_validate"
 #define LBANN_OPTION_SEQUENCE_LENGTH "sequence_length"
 #define LBANN_OPTION_SMILES_BUFFER_SIZE "smiles_buffer_size"
+#define LBANN_OPTION_SMILES_TOKEN_CACHE "smiles_token_cache"
+#define LBANN_OPTION_STREAM_SHUFFLE_BUFFER_SIZE "stream_shuffle_buffer_size"
 #define LBANN_OPTION_VOCAB "vocab"
 
 /****** jag options ******/
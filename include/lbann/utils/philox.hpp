@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef LBANN_UTILS_PHILOX_HPP_INCLUDED
+#define LBANN_UTILS_PHILOX_HPP_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace lbann {
+
+/** @class philox_rng
+ *  @brief Counter-based Philox4x32-10 random bit generator.
+ *
+ *  Philox (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+ *  3", SC 2011) is a keyed bijection on a 128-bit counter. The output
+ *  depends only on the key and the counter, so a stream is fully
+ *  described by a few integers and can be recreated anywhere without
+ *  carrying generator state around.
+ *
+ *  The 64-bit key and the upper 96 bits of the counter select the
+ *  stream; the low 32 bits of the counter index 128-bit blocks within
+ *  the stream. Satisfies UniformRandomBitGenerator, so it can be used
+ *  with the standard distributions.
+ */
+class philox_rng
+{
+public:
+  using result_type = uint32_t;
+  using counter_type = std::array<uint32_t, 4>;
+  using key_type = std::array<uint32_t, 2>;
+
+  philox_rng() : philox_rng(0, 0, 0) {}
+
+  /** @brief Construct the stream selected by @c key and @c stream.
+   *
+   *  @c stream occupies counter words 2-3 and @c substream counter
+   *  word 1.
+   */
+  philox_rng(uint64_t key, uint64_t stream, uint32_t substream)
+  {
+    reset(key, stream, substream);
+  }
+
+  /** @brief Rewind to the start of a (possibly different) stream. */
+  void reset(uint64_t key, uint64_t stream, uint32_t substream)
+  {
+    m_key = {static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32)};
+    m_counter = {0,
+                 substream,
+                 static_cast<uint32_t>(stream),
+                 static_cast<uint32_t>(stream >> 32)};
+    m_next = m_block.size();
+  }
+
+  static constexpr result_type min()
+  {
+    return std::numeric_limits<result_type>::min();
+  }
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()()
+  {
+    if (m_next == m_block.size()) {
+      m_block = generate(m_counter, m_key);
+      ++m_counter[0];
+      m_next = 0;
+    }
+    return m_block[m_next++];
+  }
+
+  /** @brief Advance the stream by @c n draws. */
+  void discard(uint64_t n)
+  {
+    const uint64_t buffered = m_block.size() - m_next;
+    if (n <= buffered) {
+      m_next += n;
+      return;
+    }
+    n -= buffered;
+    m_counter[0] += static_cast<uint32_t>(n / m_block.size());
+    m_next = m_block.size();
+    for (uint64_t i = 0; i < n % m_block.size(); ++i) {
+      (*this)();
+    }
+  }
+
+  /** @brief Apply the ten-round Philox4x32 bijection to one block. */
+  static counter_type generate(counter_type ctr, key_type key)
+  {
+    for (int r = 0; r < 10; ++r) {
+      if (r > 0) {
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+      }
+      const uint64_t p0 = uint64_t{0xD2511F53u} * ctr[0];
+      const uint64_t p1 = uint64_t{0xCD9E8D57u} * ctr[2];
+      ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+             static_cast<uint32_t>(p1),
+             static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+             static_cast<uint32_t>(p0)};
+    }
+    return ctr;
+  }
+
+private:
+  key_type m_key;
+  counter_type m_counter;
+  counter_type m_block = {};
+  std::size_t m_next;
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_PHILOX_HPP_INCLUDED
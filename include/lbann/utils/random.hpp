@@ -215,6 +215,31 @@ void gaussian_fill_parallel(El::AbstractDistMatrix<TensorDataType>& mat,
                             TensorDataType mean = 0.0,
                             TensorDataType stddev = 1.0);
 
+#ifdef LBANN_HAS_GPU
+/**
+ * Fill the local entries of a GPU matrix with values drawn from a
+ * Gaussian distribution. Entries are generated on the device from a
+ * counter-based hash of @c seed and their global position, so the
+ * matrix is the same for any grid and distribution as long as every
+ * rank passes the same seed.
+ */
+template <typename TensorDataType>
+void gaussian_fill_gpu(El::AbstractDistMatrix<TensorDataType>& mat,
+                       TensorDataType mean,
+                       TensorDataType stddev,
+                       uint64_t seed);
+/**
+ * Fill the local entries of a GPU matrix with values drawn uniformly
+ * from [center-radius, center+radius). This makes the same guarantees
+ * as gaussian_fill_gpu.
+ */
+template <typename TensorDataType>
+void uniform_fill_gpu(El::AbstractDistMatrix<TensorDataType>& mat,
+                      TensorDataType center,
+                      TensorDataType radius,
+                      uint64_t seed);
+#endif // LBANN_HAS_GPU
+
 bool save_rng_to_checkpoint_shared(persist& p, lbann_comm* comm);
 bool save_rng_to_checkpoint_distributed(persist& p, lbann_comm* comm);
 bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm);
@@ -29,6 +29,7 @@
 
 #include "lbann/comm.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/philox.hpp"
 #include <atomic>
 #include <random>
 #include <thread>
@@ -131,6 +132,42 @@ rng_gen& get_io_generator();
  */
 fast_rng_gen& get_fast_io_generator();
 
+/** @brief Key the calling thread's I/O randomness on one sample.
+ *
+ *  While a scope is alive, get_io_sample_generator() returns a
+ *  counter-based stream that is a pure function of the I/O seed, the
+ *  epoch, the sample index, the execution mode, and the transform id
+ *  selected with set_io_sample_transform(). The draws a sample sees
+ *  therefore do not depend on which I/O thread fetches it, on
+ *  prefetch order, or on the number of I/O threads, and there is no
+ *  generator state to checkpoint. Scopes do not nest.
+ */
+class io_sample_stream_scope
+{
+public:
+  io_sample_stream_scope(uint64_t epoch,
+                         uint64_t sample_id,
+                         execution_mode mode);
+  ~io_sample_stream_scope();
+  io_sample_stream_scope(const io_sample_stream_scope&) = delete;
+  io_sample_stream_scope& operator=(const io_sample_stream_scope&) = delete;
+};
+
+/** @brief Select the per-transform substream of the active sample
+ *         stream, rewinding it to its first draw.
+ */
+void set_io_sample_transform(uint32_t transform_id);
+
+/** @brief Whether the calling thread is inside an
+ *         io_sample_stream_scope.
+ */
+bool is_io_sample_stream_active();
+
+/** @brief Return the calling thread's counter-based sample stream.
+ *  @note Only valid inside an io_sample_stream_scope.
+ */
+philox_rng& get_io_sample_generator();
+
 /** @brief Initialize the random number generator (with optional seed).
  *
  *  @param seed Seed value for the random number generator
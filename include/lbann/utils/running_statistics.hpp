@@ -50,6 +50,22 @@ public:
   constexpr static auto default_max = std::numeric_limits<double>::lowest();
 
 public:
+  RunningStats() = default;
+
+  /** @brief Restore statistics from their accumulated moments.
+   *
+   *  @param count Number of observed samples
+   *  @param mean Mean of the observed samples
+   *  @param sum_sq_dev Sum of squared deviations from the mean
+   *  @param min Minimum observed value
+   *  @param max Maximum observed value
+   */
+  RunningStats(size_t count,
+               double mean,
+               double sum_sq_dev,
+               double min,
+               double max) noexcept;
+
   /** @name Modifiers */
   ///@{
 
@@ -66,6 +82,14 @@ public:
    */
   void insert(double val) noexcept;
 
+  /** @brief Combine with the statistics of a disjoint data set.
+   *
+   *  Uses the pairwise update of Chan, Golub and LeVeque, so partial
+   *  statistics accumulated on different ranks can be merged without
+   *  loss of accuracy.
+   */
+  void merge(RunningStats const& other) noexcept;
+
   ///@}
   /** @name Queries */
   ///@{
@@ -95,6 +119,8 @@ public:
    *        observed.
    */
   double stddev() const noexcept;
+  /** @brief Sum of squared deviations from the running mean. */
+  double sum_squared_deviations() const noexcept;
   ///@}
 
 private:
@@ -105,6 +131,18 @@ private:
   double m_diff_sq = 0.;
 }; // class RunningStats
 
+inline RunningStats::RunningStats(size_t count,
+                                  double mean,
+                                  double sum_sq_dev,
+                                  double min,
+                                  double max) noexcept
+  : m_count{count},
+    m_min{min},
+    m_max{max},
+    m_mean{mean},
+    m_diff_sq{sum_sq_dev}
+{}
+
 inline void RunningStats::reset() noexcept { *this = RunningStats{}; }
 
 inline void RunningStats::insert(double val) noexcept
@@ -118,6 +156,26 @@ inline void RunningStats::insert(double val) noexcept
   m_diff_sq += diff1 * (val - m_mean);
 }
 
+inline void RunningStats::merge(RunningStats const& other) noexcept
+{
+  if (other.m_count == 0UL) {
+    return;
+  }
+  if (m_count == 0UL) {
+    *this = other;
+    return;
+  }
+  const double n_a = static_cast<double>(m_count);
+  const double n_b = static_cast<double>(other.m_count);
+  const double n = n_a + n_b;
+  const double delta = other.m_mean - m_mean;
+  m_mean += delta * (n_b / n);
+  m_diff_sq += other.m_diff_sq + delta * delta * (n_a * n_b / n);
+  m_count += other.m_count;
+  m_min = std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+}
+
 inline size_t RunningStats::samples() const noexcept { return m_count; }
 
 inline double RunningStats::min() const noexcept { return m_min; }
@@ -141,5 +199,10 @@ inline double RunningStats::stddev() const noexcept
   return std::sqrt(this->variance());
 }
 
+inline double RunningStats::sum_squared_deviations() const noexcept
+{
+  return m_diff_sq;
+}
+
 } // namespace lbann
 #endif // LBANN_UTILS_RUNNING_STATISTICS_HPP_INCLUDED
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_SCRATCH_ARENA_HPP_INCLUDED
+#define LBANN_UTILS_SCRATCH_ARENA_HPP_INCLUDED
+
+#include <El.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace lbann {
+namespace utils {
+
+/**
+ * Per-thread bump allocator for the scratch buffers used while loading and
+ * transforming one sample.
+ *
+ * Allocations are only valid inside a scratch_arena_scope, and are all
+ * released when the outermost scope ends. Memory is carved out of large
+ * blocks that are kept across resets; when a sample needs more than one
+ * block, they are merged into one at the next reset. In steady state each
+ * thread then serves every allocation from a single block without touching
+ * the heap.
+ */
+class scratch_arena
+{
+public:
+  /** Alignment of every allocation. */
+  static constexpr size_t alignment = 64;
+
+  scratch_arena() = default;
+  scratch_arena(const scratch_arena&) = delete;
+  scratch_arena& operator=(const scratch_arena&) = delete;
+
+  /** Allocate bytes of scratch memory. */
+  void* allocate(size_t bytes);
+  /** Release everything allocated since the last reset. */
+  void reset();
+  /**
+   * Ensure a single block of at least the given size, allocated and
+   * first-touched by the calling thread. Does nothing inside a scope.
+   */
+  void reserve(size_t bytes);
+
+  /** True if inside a scratch_arena_scope. */
+  bool is_active() const noexcept { return m_depth > 0; }
+  /** Bytes of memory held by the arena. */
+  size_t get_capacity() const noexcept;
+  /** Number of blocks held by the arena. */
+  size_t get_num_blocks() const noexcept { return m_blocks.size(); }
+
+private:
+  friend class scratch_arena_scope;
+
+  struct block
+  {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+  };
+
+  /** Blocks, in the order they are filled. */
+  std::vector<block> m_blocks;
+  /** Block currently being filled. */
+  size_t m_current = 0;
+  /** Offset of the next free byte in the current block. */
+  size_t m_offset = 0;
+  /** Bytes handed out (with padding) since the last reset. */
+  size_t m_used = 0;
+  /** Number of nested scratch_arena_scopes. */
+  size_t m_depth = 0;
+};
+
+/** Get the calling thread's scratch arena. */
+scratch_arena& get_scratch_arena();
+
+/**
+ * Marks the processing of one sample on the calling thread. The scratch
+ * arena is reset when the outermost scope ends.
+ */
+class scratch_arena_scope
+{
+public:
+  scratch_arena_scope() : m_arena(get_scratch_arena()) { ++m_arena.m_depth; }
+  ~scratch_arena_scope()
+  {
+    if (--m_arena.m_depth == 0) {
+      m_arena.reset();
+    }
+  }
+  scratch_arena_scope(const scratch_arena_scope&) = delete;
+  scratch_arena_scope& operator=(const scratch_arena_scope&) = delete;
+
+private:
+  scratch_arena& m_arena;
+};
+
+/**
+ * Get a contiguous height x width matrix for scratch use.
+ *
+ * Inside a scratch_arena_scope this views memory from the calling thread's
+ * arena, so it must not be resized or outlive the scope. Elsewhere it is an
+ * ordinary matrix that owns its memory.
+ */
+template <typename T>
+El::Matrix<T> get_scratch_matrix(El::Int height, El::Int width)
+{
+  auto& arena = get_scratch_arena();
+  if (!arena.is_active() || height * width == 0) {
+    return El::Matrix<T>(height, width);
+  }
+  T* buf = static_cast<T*>(arena.allocate(height * width * sizeof(T)));
+  return El::Matrix<T>(height, width, buf, height);
+}
+
+/**
+ * Make mat a contiguous height x width scratch matrix, as with
+ * get_scratch_matrix. Outside a scratch_arena_scope, mat is resized.
+ */
+template <typename T>
+void attach_scratch_matrix(El::Matrix<T>& mat, El::Int height, El::Int width)
+{
+  auto& arena = get_scratch_arena();
+  if (!arena.is_active() || height * width == 0) {
+    mat.Resize(height, width);
+    return;
+  }
+  T* buf = static_cast<T*>(arena.allocate(height * width * sizeof(T)));
+  mat.Attach(height, width, buf, height);
+}
+
+} // namespace utils
+} // namespace lbann
+
+#endif // LBANN_UTILS_SCRATCH_ARENA_HPP_INCLUDED
@@ -136,12 +136,25 @@ private:
   using BaseType_ = cereal::InputArchive<ThisType_>;
 
 public:
+  /** @brief Construct the archive.
+   *
+   *  @param is The stream holding the archive. Only read on the root.
+   *  @param g The grid over which data is distributed.
+   *  @param root The rank in @c g that reads the archive.
+   *  @param parallel_is Optional stream on every rank, opened on the
+   *         same file. When given, binary distributed matrices are
+   *         read directly by the ranks that own them rather than
+   *         read on the root and scattered.
+   */
   RootedInputArchiveAdaptor(std::istream& is,
                             El::Grid const& g,
-                            El::Int root = 0)
+                            El::Int root = 0,
+                            std::istream* parallel_is = nullptr)
     : BaseType_{this},
       ar_(g.Rank() == root ? std::make_optional<archive_type>(is)
                            : std::nullopt),
+      is_{&is},
+      parallel_is_{parallel_is},
       grid_{&g},
       root_{root}
   {}
@@ -152,6 +165,12 @@ public:
 
   bool am_root() const noexcept { return (this->root() == grid_->Rank()); }
 
+  /** @brief The stream the root reads the archive from. */
+  std::istream& root_stream() const noexcept { return *is_; }
+
+  /** @brief This rank's stream for direct matrix reads, or null. */
+  std::istream* parallel_stream() const noexcept { return parallel_is_; }
+
   void set_next_name(char const* name)
   {
     if (this->am_root())
@@ -181,6 +200,8 @@ public:
 
 private:
   std::optional<archive_type> ar_;
+  std::istream* is_;
+  std::istream* parallel_is_;
   El::Grid const* grid_;
   El::Int root_;
 }; // RootedInputArchiveAdaptor
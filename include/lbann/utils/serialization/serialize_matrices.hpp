@@ -220,7 +220,9 @@ void load(ArchiveT& ar, ::El::AbstractDistMatrix<T>& mat);
 /** @brief Save a distributed matrix to a non-text (binary) archive.
  *
  *  In this case, the binary matrix data will be saved to the archive,
- *  as well as the global height/width.
+ *  as well as the global height/width. Each rank writes its local
+ *  matrix directly, without gathering, along with its distribution,
+ *  alignments and process grid shape.
  *
  *  @tparam ArchiveT (Inferred) The Cereal archive type to use.
  *  @tparam T (Inferred) The data type of the matrix.
@@ -235,12 +237,18 @@ template <typename ArchiveT,
 void save(ArchiveT& ar, ::El::AbstractDistMatrix<T> const& mat);
 
 /** @brief Load a DistMatrix from a non-text archive.
+ *
+ *  If the matrix was saved with the same distribution on a grid of
+ *  the same shape, the local matrix is read in place. Otherwise the
+ *  saved distribution is rebuilt on the target's grid and
+ *  redistributed into the target.
  *
  *  @tparam ArchiveT (Inferred) The Cereal archive type to use.
  *  @tparam T (Inferred) The data type of the matrix.
  *  @param ar The Cereal archive from which the matrix will be read.
  *  @param mat The target matrix to deserialize into.
- *  @throws lbann::exception The input matrix is already setup as a view.
+ *  @throws lbann::exception The input matrix is already setup as a view,
+ *          or it was saved on a process grid of a different shape.
  *  @ingroup serialization
  */
 template <typename ArchiveT,
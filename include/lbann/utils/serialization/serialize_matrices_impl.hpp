@@ -32,6 +32,8 @@
 #include <El/blas_like/level1/Copy/Translate.hpp>
 #include <El/blas_like/level1/Copy/TranslateBetweenGrids.hpp>
 
+#include <memory>
+
 // These really belong in Elemental; let's just extend that.
 namespace El {
 
@@ -226,6 +228,54 @@ void load(ArchiveT& ar, ::El::AbstractDistMatrix<T>& mat)
   mat.Resize(global_height, global_width);
 }
 
+namespace details {
+/** @brief Marks a distributed matrix saved with its layout.
+ *
+ *  Older archives start with the (nonnegative) global height.
+ */
+constexpr ::El::Int dist_matrix_layout_tag = -1;
+
+/** @brief Where the local matrix of a rank sits in a distributed
+ *         matrix.
+ */
+struct dist_matrix_layout
+{
+  ::El::Int col_dist;
+  ::El::Int row_dist;
+  ::El::Int grid_height;
+  ::El::Int grid_width;
+  ::El::Int col_align;
+  ::El::Int row_align;
+  ::El::Int root;
+
+  template <typename T>
+  explicit dist_matrix_layout(::El::AbstractDistMatrix<T> const& mat)
+    : col_dist{static_cast<::El::Int>(mat.ColDist())},
+      row_dist{static_cast<::El::Int>(mat.RowDist())},
+      grid_height{mat.Grid().Height()},
+      grid_width{mat.Grid().Width()},
+      col_align{mat.ColAlign()},
+      row_align{mat.RowAlign()},
+      root{mat.Root()}
+  {}
+  dist_matrix_layout() = default;
+
+  bool operator==(dist_matrix_layout const& other) const
+  {
+    return col_dist == other.col_dist && row_dist == other.row_dist &&
+           grid_height == other.grid_height &&
+           grid_width == other.grid_width && col_align == other.col_align &&
+           row_align == other.row_align && root == other.root;
+  }
+
+  template <typename ArchiveT>
+  void serialize(ArchiveT& ar)
+  {
+    ar(col_dist, row_dist, grid_height, grid_width, col_align, row_align, root);
+  }
+};
+} // namespace details
+
 template <typename ArchiveT,
           typename T,
           lbann::utils::WhenNotTextArchive<ArchiveT>>
@@ -233,8 +283,14 @@ void save(ArchiveT& ar, ::El::AbstractDistMatrix<T> const& mat)
 {
   LBANN_ASSERT(!mat.Viewing());
   // Binary archives don't use NVPs, so there's no point in making
-  // them here.
-  ar(mat.Height(), mat.Width(), mat.LockedMatrix());
+  // them here. Each rank writes its local matrix as is, along with
+  // enough of the layout to tell whether it can be read back in
+  // place.
+  ar(details::dist_matrix_layout_tag,
+     mat.Height(),
+     mat.Width(),
+     details::dist_matrix_layout(mat),
+     mat.LockedMatrix());
 }
 
 template <typename ArchiveT,
@@ -243,18 +299,60 @@ template <typename ArchiveT,
 void load(ArchiveT& ar, ::El::AbstractDistMatrix<T>& mat)
 {
   LBANN_ASSERT(!mat.Viewing());
-  ::El::Int global_height, global_width;
-  ar(global_height, global_width);
-  mat.Resize(global_height, global_width);
+  ::El::Int tag, global_height, global_width;
+  ar(tag);
+  details::dist_matrix_layout layout(mat);
+  if (tag == details::dist_matrix_layout_tag) {
+    ar(global_height, global_width, layout);
+  }
+  else {
+    // Archived without a layout, which is assumed to match
+    global_height = tag;
+    ar(global_width);
+  }
+
+  if (layout == details::dist_matrix_layout(mat)) {
+    // Same distribution on the same grid: read the local matrix in
+    // place
+    mat.Resize(global_height, global_width);
 #ifdef LBANN_DEBUG
-  ::El::Matrix<T, ::El::Device::CPU> mat_cpu;
-  ar(mat_cpu);
-  LBANN_ASSERT(mat_cpu.Height() == mat.LocalHeight());
-  LBANN_ASSERT(mat_cpu.Width() == mat.LocalWidth());
-  mat.Matrix() = mat_cpu;
+    ::El::Matrix<T, ::El::Device::CPU> mat_cpu;
+    ar(mat_cpu);
+    LBANN_ASSERT(mat_cpu.Height() == mat.LocalHeight());
+    LBANN_ASSERT(mat_cpu.Width() == mat.LocalWidth());
+    mat.Matrix() = mat_cpu;
 #else
-  ar(mat.Matrix());
+    ar(mat.Matrix());
 #endif
+    return;
+  }
+
+  // Rebuild the saved distribution and redistribute from it
+  if (layout.grid_height != mat.Grid().Height() ||
+      layout.grid_width != mat.Grid().Width()) {
+    LBANN_ERROR("cannot load a matrix saved on a ",
+                layout.grid_height,
+                "x",
+                layout.grid_width,
+                " process grid into one on a ",
+                mat.Grid().Height(),
+                "x",
+                mat.Grid().Width(),
+                " grid");
+  }
+  auto dist = mat.DistData();
+  dist.colDist = static_cast<::El::Dist>(layout.col_dist);
+  dist.rowDist = static_cast<::El::Dist>(layout.row_dist);
+  dist.colAlign = layout.col_align;
+  dist.rowAlign = layout.row_align;
+  dist.root = layout.root;
+  std::unique_ptr<::El::AbstractDistMatrix<T>> saved_mat(
+    ::El::AbstractDistMatrix<T>::Instantiate(dist));
+  saved_mat->Resize(global_height, global_width);
+  ar(saved_mat->Matrix());
+  LBANN_ASSERT(saved_mat->Matrix().Height() == saved_mat->LocalHeight());
+  LBANN_ASSERT(saved_mat->Matrix().Width() == saved_mat->LocalWidth());
+  ::El::Copy(*saved_mat, mat);
 }
 
 template <typename ArchiveT,
@@ -299,6 +397,58 @@ void save(lbann::RootedOutputArchiveAdaptor<ArchiveT>& ar,
   save(ar, circ_mat_ar);
 }
 
+namespace details {
+/** @brief Read a matrix saved through a rooted binary archive with
+ *         every rank reading the columns it owns.
+ *
+ *  The saved layout is that of a [CIRC,CIRC] matrix: the global
+ *  dimensions, then the root's local matrix as (height, width,
+ *  column-major data). The root only reads the header and skips the
+ *  data; every rank then reads a [STAR,VC] share of the columns from
+ *  its own stream, which is redistributed to the target layout. This
+ *  also works when the grid differs from the one that saved it.
+ */
+template <typename T>
+void parallel_load(
+  lbann::RootedInputArchiveAdaptor<::cereal::BinaryInputArchive>& ar,
+  ::El::AbstractDistMatrix<T>& mat)
+{
+  ::El::Int height, width;
+  ar(::cereal::make_nvp("global_height", height),
+     ::cereal::make_nvp("global_width", width));
+
+  // The root finds the data and steps over it
+  ::El::Int offset = 0;
+  if (ar.am_root()) {
+    ::El::Int local_height, local_width;
+    ar.load_on_root(local_height);
+    ar.load_on_root(local_width);
+    LBANN_ASSERT(local_height == height && local_width == width);
+    auto& is = ar.root_stream();
+    offset = is.tellg();
+    is.seekg(offset + height * width * sizeof(T));
+  }
+  ::El::mpi::Broadcast(offset,
+                       ar.root(),
+                       ar.grid().Comm(),
+                       ::El::SyncInfo<::El::Device::CPU>{});
+
+  using ColsMatType = ::El::
+    DistMatrix<T, ::El::STAR, ::El::VC, ::El::ELEMENT, ::El::Device::CPU>;
+  ColsMatType cols(mat.Grid(), mat.Root());
+  cols.Resize(height, width);
+  auto& is = *ar.parallel_stream();
+  for (::El::Int jl = 0; jl < cols.LocalWidth(); ++jl) {
+    is.seekg(offset + cols.GlobalCol(jl) * height * sizeof(T));
+    is.read(reinterpret_cast<char*>(cols.Buffer(0, jl)), height * sizeof(T));
+  }
+  if (!is) {
+    LBANN_ERROR("failed to read a ", height, "x", width, " matrix");
+  }
+  ::El::Copy(cols, mat);
+}
+} // namespace details
+
 template <typename ArchiveT,
           typename T,
           lbann::utils::WhenNotTextArchive<ArchiveT>>
@@ -309,6 +459,13 @@ void load(lbann::RootedInputArchiveAdaptor<ArchiveT>& ar,
   using CircMatType = ::El::
     DistMatrix<T, ::El::CIRC, ::El::CIRC, ::El::ELEMENT, ::El::Device::CPU>;
 
+  if constexpr (std::is_same_v<ArchiveT, ::cereal::BinaryInputArchive>) {
+    if (ar.parallel_stream() != nullptr) {
+      details::parallel_load(ar, mat);
+      return;
+    }
+  }
+
   // Do the root process read.
   CircMatType circ_mat(mat.Grid(), mat.Root());
   CircMatType circ_mat_ar(ar.grid(), ar.root());
@@ -31,6 +31,9 @@
 
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
+#include <functional>
+#include <future>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -40,6 +43,9 @@
 
 namespace lbann {
 
+// Forward declaration
+class thread_pool;
+
 template <typename T, typename U>
 using BiggerOf = typename std::conditional<(sizeof(T) > sizeof(U)), T, U>::type;
 
@@ -57,6 +63,8 @@ using BiggerOf = typename std::conditional<(sizeof(T) > sizeof(U)), T, U>::type;
  * Distributed matrices should be distributed by model.
  * This class automatically prepends "modelN/" to each tag. The tag is only
  * relevant at the world master process.
+ * Event files are written by a background thread on the world master, so
+ * flushing costs only the collectives needed to reduce the summaries.
  *
  * @note WHEN YOU UPDATE THE PUBLIC API HERE, REMEMBER TO UPDATE THE KLUDGE FOR
  * NON-TENSORBOARD BUILDS BELOW!
@@ -118,14 +126,19 @@ public:
                     int /*step*/);
   /**
    * Write all summaries out.
-   * @todo This can be made faster by combining collective operations element-
-   * wise for each type of summary.
+   * All pending trainer-wide reductions are packed into one sum and one max
+   * reduction, followed by a single gather to the world master. The event
+   * file is written asynchronously.
    */
   void flush();
 
 private:
   lbann_comm* m_comm;
   TBinf::SummaryWriter* m_sw;
+  /** Single-threaded pool writing events (world master only). */
+  std::unique_ptr<thread_pool> m_writer;
+  /** Completion of the most recently queued write. */
+  std::future<void> m_last_write;
 
   /** Represent a pending summary operation.
    * Note that TensorBoard takes scalars as floats
@@ -165,7 +178,7 @@ private:
                       double sqsum_)
       : tag(tag_),
         step(step_),
-        buckets(buckets_),
+        buckets(std::move(buckets_)),
         min(min_),
         max(max_),
         num(num_),
@@ -190,41 +203,46 @@ private:
     double sqsum;
   };
 
-  /** Currently-pending reduce_means. */
-  std::vector<pending_op> m_pending_means;
-  /** Currently-pending reduce_mins. */
-  std::vector<pending_op> m_pending_mins;
-  /** Currently-pending reduce_maxes. */
-  std::vector<pending_op> m_pending_maxes;
-  /** Currently-pending reduce_stdevs. */
-  std::vector<pending_op> m_pending_stdevs;
-  /** Currently-pending reduce_scalars. */
-  std::vector<pending_op> m_pending_scalars;
-  /** Currently-pending sum_reduce_scalars. */
-  std::vector<pending_op> m_pending_sum_scalars;
+  /** Summaries added since the last flush. */
+  struct pending_summaries
+  {
+    /** Currently-pending reduce_means. */
+    std::vector<pending_op> means;
+    /** Currently-pending reduce_mins. */
+    std::vector<pending_op> mins;
+    /** Currently-pending reduce_maxes. */
+    std::vector<pending_op> maxes;
+    /** Currently-pending reduce_stdevs. */
+    std::vector<pending_op> stdevs;
+    /** Currently-pending reduce_scalars. */
+    std::vector<pending_op> scalars;
+    /** Currently-pending sum_reduce_scalars. */
+    std::vector<pending_op> sum_scalars;
+    /** Currently-pending reduce_histograms. */
+    std::vector<pending_histogram> histograms;
+    /** Whether there is nothing to reduce within trainers. */
+    bool empty() const noexcept;
+  };
+
+  /** Currently-pending trainer reductions. */
+  pending_summaries m_pending;
   /** Currently-pending reduce_scalar_alls. */
   std::vector<pending_op> m_pending_scalar_alls;
   /** Buckets for histograms. */
   std::vector<double> m_histogram_buckets;
-  /** Currently-pending reduce_histograms. */
-  std::vector<pending_histogram> m_pending_histograms;
 
-  /** Execute all pending mean operations. */
-  void flush_means();
-  /** Execute all pending min operations. */
-  void flush_mins();
-  /** Execute all pending max operations. */
-  void flush_maxes();
-  /** Execute all pending stdev operations. */
-  void flush_stdevs();
-  /** Execute all pending scalar operations. */
-  void flush_scalars();
-  /** Execute all pending sum-scalar operations. */
-  void flush_sum_scalars();
+  /** Reduce all pending trainer summaries and queue them for writing. */
+  void flush_reductions();
   /** Execute all pending scalar-all operations. */
   void flush_scalar_alls();
-  /** Execute all pending histogram operations. */
-  void flush_histograms();
+  /** Write reduced summaries, laid out as packed by flush_reductions. */
+  void write_reductions(const pending_summaries& ops,
+                        const std::vector<double>& data,
+                        int num_trainers) const;
+  /** Queue a write on the background thread (world master only). */
+  void enqueue_write(std::function<void()> write);
+  /** Block until all queued writes have finished. */
+  void wait_for_writes();
 
   /** Compute the sum of elements in mat. */
   template <typename TensorDataType>
@@ -249,11 +267,6 @@ private:
     -> BiggerOf<TensorDataType, float>;
   /** Prepend "model<model>/" to tag. */
   std::string prepend_model(const std::string tag, int model) const;
-  /** Gather and write out a scalar summary for each model. */
-  void gather_scalar_summary(const std::string tag, float s, int step);
-  /** Gather and write out a scalar summary for each entry in a vector. */
-  void gather_scalar_summary(const std::vector<pending_op>& ops,
-                             std::vector<float>& scalars);
 };
 
 #else
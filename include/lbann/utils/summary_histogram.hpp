@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_SUMMARY_HISTOGRAM_HPP_INCLUDED
+#define LBANN_UTILS_SUMMARY_HISTOGRAM_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/profiling.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace lbann {
+namespace summary_details {
+
+/** Local histogram and moments of a matrix. */
+struct histogram_stats
+{
+  histogram_stats() = default;
+  histogram_stats(size_t num_buckets) : buckets(num_buckets, 0.0) {}
+  /** Counts per bucket; the last counts values above every limit. */
+  std::vector<double> buckets;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  double sum = 0.0;
+  double sqsum = 0.0;
+};
+
+/** Bin a local CPU matrix with upper bucket limits @c limits. */
+template <typename TensorDataType>
+void cpu_local_histogram(const El::AbstractMatrix<TensorDataType>& mat,
+                         const std::vector<double>& limits,
+                         histogram_stats& stats)
+{
+  LBANN_CALIPER_MARK_FUNCTION;
+  stats = histogram_stats(limits.size() + 1);
+  const El::Int height = mat.Height();
+  const El::Int width = mat.Width();
+  const El::Int ldim = mat.LDim();
+  const auto* __restrict__ mat_buf = mat.LockedBuffer();
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      const double val = mat_buf[row + col * ldim];
+      stats.min = std::min(stats.min, val);
+      stats.max = std::max(stats.max, val);
+      stats.sum += val;
+      stats.sqsum += val * val;
+      const auto bucket =
+        std::upper_bound(limits.cbegin(), limits.cend(), val) -
+        limits.cbegin();
+#ifdef LBANN_DEBUG
+      stats.buckets.at(bucket) += 1.0;
+#else
+      stats.buckets[bucket] += 1.0;
+#endif // LBANN_DEBUG
+    }
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+/** Bin a local GPU matrix on the device. Instantiated for float and
+ *  double.
+ */
+template <typename TensorDataType>
+void gpu_local_histogram(
+  const El::Matrix<TensorDataType, El::Device::GPU>& mat,
+  const std::vector<double>& limits,
+  histogram_stats& stats);
+#endif // LBANN_HAS_GPU
+
+} // namespace summary_details
+} // namespace lbann
+#endif // LBANN_UTILS_SUMMARY_HISTOGRAM_HPP_INCLUDED
@@ -29,6 +29,9 @@
 
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/summary.hpp"
+#include "lbann/utils/summary_histogram.hpp"
+
+#include <type_traits>
 
 namespace lbann {
 
@@ -61,7 +64,7 @@ lbann_summary::reduce_mean(const std::string tag,
   }
 
   // Add local sum to list of pending means
-  m_pending_means.emplace_back(tag,
+  m_pending.means.emplace_back(tag,
                                step,
                                sum,
                                0.0f,
@@ -76,7 +79,7 @@ lbann_summary::reduce_min(const std::string tag,
 {
   using AccumT = BiggerOf<TensorDataType, float>;
   AccumT mat_local_min = local_min(mat.LockedMatrix());
-  m_pending_mins.emplace_back(tag, step, mat_local_min);
+  m_pending.mins.emplace_back(tag, step, mat_local_min);
 }
 
 template <typename TensorDataType>
@@ -87,7 +90,7 @@ lbann_summary::reduce_max(const std::string tag,
 {
   using AccumT = BiggerOf<TensorDataType, float>;
   AccumT mat_local_max = local_max(mat.LockedMatrix());
-  m_pending_maxes.emplace_back(tag, step, mat_local_max);
+  m_pending.maxes.emplace_back(tag, step, mat_local_max);
 }
 
 template <typename TensorDataType>
@@ -118,7 +121,7 @@ lbann_summary::reduce_stdev(const std::string tag,
   }
 
   // Add local sums to list of pending stdevs.
-  m_pending_stdevs.emplace_back(tag,
+  m_pending.stdevs.emplace_back(tag,
                                 step,
                                 sum,
                                 sqsum,
@@ -129,9 +132,8 @@ template <typename TensorDataType>
 inline void
 lbann_summary::reduce_scalar(const std::string tag, TensorDataType s, int step)
 {
-  if (mat.RedundantRank() == 0) {
-    m_pending_scalars.emplace_back(tag, step, s);
-  }
+  // Only the trainer master's value is reported.
+  m_pending.scalars.emplace_back(tag, step, s);
 }
 
 template <typename TensorDataType>
@@ -139,7 +141,7 @@ inline void lbann_summary::sum_reduce_scalar(const std::string tag,
                                              TensorDataType s,
                                              int step)
 {
-  m_pending_sum_scalars.emplace_back(tag, step, s);
+  m_pending.sum_scalars.emplace_back(tag, step, s);
 }
 
 template <typename TensorDataType>
@@ -156,57 +158,45 @@ inline void lbann_summary::reduce_histogram(
   const El::AbstractDistMatrix<TensorDataType>& mat,
   int step)
 {
-  using AccumT = BiggerOf<TensorDataType, float>;
-  AccumT mat_local_min = local_min(mat.LockedMatrix());
-  AccumT mat_local_max = local_max(mat.LockedMatrix());
-  // Local sum and squared sum
-  AccumT sum = 0.0;
-  AccumT sqsum = 0.0;
-  // Check distributed matrix format
+  summary_details::histogram_stats stats(m_histogram_buckets.size() + 1);
+  // A redundantly-stored matrix is only binned by one process
   El::DistData mat_format(mat);
-  if (mat_format.colDist == El::STAR && mat_format.rowDist == El::STAR) {
-    // Compute local sums on master process if matrix is Star,Star
-    if (mat.RedundantRank() == 0) {
-      local_sum_sqsum(mat.LockedMatrix(), sum, sqsum);
+  if (mat_format.colDist != El::STAR || mat_format.rowDist != El::STAR ||
+      mat.RedundantRank() == 0) {
+    const auto& local_mat = mat.LockedMatrix();
+    if (local_mat.GetDevice() == El::Device::CPU) {
+      summary_details::cpu_local_histogram(local_mat,
+                                           m_histogram_buckets,
+                                           stats);
     }
-  }
-  else {
-    // Compute local sums on all processes if matrix is in MC,MR;
-    // Star,VC; or similar format
-    // TODO: implement for matrices in Circ,Circ; MC,Star; or similar
-    // formats
-    local_sum_sqsum(mat.LockedMatrix(), sum, sqsum);
-  }
-  // Compute local buckets.
-  std::vector<double> buckets(m_histogram_buckets.size() + 1, 0.0);
-  const auto height = mat.LocalHeight();
-  const auto width = mat.LocalWidth();
-  const auto ldim = mat.LDim();
-  const auto* __restrict__ mat_buf = mat.LockedMatrix().LockedBuffer();
-  for (auto row = 0; row < height; ++row) {
-    for (auto col = 0; col < width; ++col) {
-      // Note: This could be optimized; upper_bound takes O(logn) time.
-      auto bucket = std::distance(m_histogram_buckets.begin(),
-                                  std::upper_bound(m_histogram_buckets.begin(),
-                                                   m_histogram_buckets.end(),
-                                                   mat_buf[row + col * ldim]));
-#ifdef LBANN_DEBUG
-      buckets.at(bucket) += 1.0;
-#else
-      buckets[bucket] += 1.0;
-#endif // LBANN_DEBUG
+#ifdef LBANN_HAS_GPU
+    else if constexpr (std::is_same_v<TensorDataType, float> ||
+                       std::is_same_v<TensorDataType, double>) {
+      using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+      summary_details::gpu_local_histogram(
+        static_cast<const GPUMatType&>(local_mat),
+        m_histogram_buckets,
+        stats);
+    }
+    else {
+      // No device kernel for this type, so bin on the host
+      El::Matrix<TensorDataType, El::Device::CPU> cpu_mat;
+      El::Copy(local_mat, cpu_mat);
+      summary_details::cpu_local_histogram(cpu_mat,
+                                           m_histogram_buckets,
+                                           stats);
     }
+#endif // LBANN_HAS_GPU
   }
   // Add to list of pending histograms.
-  m_pending_histograms.emplace_back(tag,
+  m_pending.histograms.emplace_back(tag,
                                     step,
-                                    std::move(buckets),
-                                    mat_local_min,
-                                    mat_local_max,
+                                    std::move(stats.buckets),
+                                    stats.min,
+                                    stats.max,
                                     mat.Height() * mat.Width(),
-                                    sum,
-                                    sqsum);
-  // TODO: Support histograms on multiple models.
+                                    stats.sum,
+                                    stats.sqsum);
 }
 
 template <typename TensorDataType>
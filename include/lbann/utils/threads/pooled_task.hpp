@@ -0,0 +1,202 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_THREADS_POOLED_TASK_HPP_INCLUDED
+#define LBANN_UTILS_THREADS_POOLED_TASK_HPP_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lbann {
+
+/** @class pooled_task
+ *  @brief A recyclable node holding one type-erased, move-only job.
+ *
+ *  Callables that fit in the inline buffer are constructed in place,
+ *  so submitting a job does not touch the heap. Larger callables
+ *  fall back to a heap allocation. Nodes are owned by a
+ *  pooled_task_allocator and linked through @c next while they sit
+ *  in a free list or queue.
+ */
+class pooled_task
+{
+public:
+  /** @brief Bytes available for callables stored in place */
+  static constexpr std::size_t inline_capacity = 128;
+
+  pooled_task() = default;
+  ~pooled_task() { reset(); }
+
+  pooled_task(const pooled_task&) = delete;
+  pooled_task& operator=(const pooled_task&) = delete;
+
+  /** @brief Store a job; the node must be empty */
+  template <typename FunctionT>
+  void emplace(FunctionT&& func)
+  {
+    using function_type = std::decay_t<FunctionT>;
+    if constexpr (fits_inline<function_type>()) {
+      new (&m_storage) function_type(std::forward<FunctionT>(func));
+      m_ops = &inline_ops<function_type>;
+    }
+    else {
+      new (&m_storage)
+        function_type*(new function_type(std::forward<FunctionT>(func)));
+      m_ops = &heap_ops<function_type>;
+    }
+  }
+
+  /** @brief Run the held job once and release it */
+  void run()
+  {
+    const ops* o = m_ops;
+    m_ops = nullptr;
+    o->run(&m_storage);
+  }
+
+  /** @brief Release the held job without running it */
+  void reset() noexcept
+  {
+    if (m_ops != nullptr) {
+      m_ops->destroy(&m_storage);
+      m_ops = nullptr;
+    }
+  }
+
+  /** @brief Intrusive link for free lists and queues */
+  pooled_task* next = nullptr;
+
+private:
+  struct ops
+  {
+    /** @brief Invoke the callable, then destroy it */
+    void (*run)(void*);
+    /** @brief Destroy the callable */
+    void (*destroy)(void*) noexcept;
+  };
+
+  template <typename F>
+  static constexpr bool fits_inline()
+  {
+    return sizeof(F) <= inline_capacity &&
+           alignof(F) <= alignof(std::max_align_t);
+  }
+
+  /** @brief Destroys the held callable when running it unwinds */
+  template <typename F>
+  struct destroy_guard
+  {
+    void* storage;
+    ~destroy_guard() { ops_for<F>::destroy(storage); }
+  };
+
+  template <typename F>
+  struct ops_for
+  {
+    static void destroy(void* storage) noexcept
+    {
+      static_cast<F*>(storage)->~F();
+    }
+    static void run(void* storage)
+    {
+      destroy_guard<F> guard{storage};
+      (*static_cast<F*>(storage))();
+    }
+  };
+
+  template <typename F>
+  struct heap_ops_for
+  {
+    static void destroy(void* storage) noexcept
+    {
+      delete *static_cast<F**>(storage);
+    }
+    static void run(void* storage)
+    {
+      std::unique_ptr<F> f(*static_cast<F**>(storage));
+      (*f)();
+    }
+  };
+
+  template <typename F>
+  static constexpr ops inline_ops = {&ops_for<F>::run, &ops_for<F>::destroy};
+
+  template <typename F>
+  static constexpr ops heap_ops = {&heap_ops_for<F>::run,
+                                   &heap_ops_for<F>::destroy};
+
+  /** @brief The held job's operations; null when empty */
+  const ops* m_ops = nullptr;
+
+  /** @brief Storage for the callable or a pointer to it */
+  alignas(std::max_align_t) unsigned char m_storage[inline_capacity];
+
+}; // class pooled_task
+
+/** @class pooled_task_allocator
+ *  @brief Owns task nodes in chunks and recycles them.
+ *
+ *  Nodes are handed out and returned as linked batches so that
+ *  threads can keep private caches and only take the lock when a
+ *  cache runs dry or overflows. Nodes are never freed before the
+ *  allocator itself.
+ */
+class pooled_task_allocator
+{
+public:
+  /** @brief Nodes allocated at a time when the free list is empty */
+  static constexpr std::size_t chunk_size = 64;
+
+  pooled_task_allocator() = default;
+  pooled_task_allocator(const pooled_task_allocator&) = delete;
+  pooled_task_allocator& operator=(const pooled_task_allocator&) = delete;
+
+  /** @brief Take @c count empty nodes, linked through @c next */
+  pooled_task* acquire(std::size_t count);
+
+  /** @brief Return the empty nodes linked from @c head to @c tail */
+  void release(pooled_task* head, pooled_task* tail);
+
+  /** @brief Total number of nodes ever allocated */
+  std::size_t capacity() const;
+
+private:
+  mutable std::mutex m_mutex;
+  /** @brief Free nodes, linked through @c next */
+  pooled_task* m_free = nullptr;
+  /** @brief Storage for every node */
+  std::vector<std::unique_ptr<pooled_task[]>> m_chunks;
+
+}; // class pooled_task_allocator
+
+} // namespace lbann
+#endif /* LBANN_UTILS_THREADS_POOLED_TASK_HPP_INCLUDED */
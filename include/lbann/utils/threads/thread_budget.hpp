@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_THREADS_THREAD_BUDGET_HPP_INCLUDED
+#define LBANN_UTILS_THREADS_THREAD_BUDGET_HPP_INCLUDED
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+class lbann_comm;
+
+/** @brief How to divide a rank's cores when the requests do not fit */
+enum class thread_budget_policy
+{
+  /** Every consumer sizes itself independently (no budget) */
+  none,
+  /** OpenMP first, then I/O threads, then Python workers */
+  compute,
+  /** I/O threads first, then Python workers, then OpenMP */
+  io,
+  /** Each consumer gets a share proportional to its request */
+  balanced,
+};
+
+thread_budget_policy thread_budget_policy_from_string(std::string const& str);
+std::string to_string(thread_budget_policy policy);
+
+/** @class thread_budget
+ *  @brief Division of a rank's CPUs among its thread consumers.
+ *
+ *  CPUs are OS indices. OpenMP gets the first slice of the rank's
+ *  CPUs, followed by the reserved CPUs, the I/O threads and the
+ *  Python workers. When no Python workers are requested they share
+ *  the I/O threads' CPUs, one worker per I/O thread.
+ */
+struct thread_budget
+{
+  thread_budget_policy policy = thread_budget_policy::none;
+  int num_omp_threads = 0;
+  int num_io_threads = 0;
+  int num_python_workers = 0;
+  std::vector<int> omp_cpus;
+  /** @brief CPUs held back for runtime helpers such as the Aluminum
+   *  progress engine */
+  std::vector<int> reserved_cpus;
+  std::vector<int> io_cpus;
+  std::vector<int> python_cpus;
+  /** @brief True if there were too few CPUs to separate the consumers
+   *  and they all share the rank's CPUs */
+  bool oversubscribed = false;
+};
+
+/** @brief Divide CPUs among OpenMP, I/O threads and Python workers
+ *
+ *  Requests that fit are granted as is. Otherwise every consumer gets
+ *  at least one CPU and @c policy decides who gets the rest.
+ *
+ *  @param cpus CPUs available to the rank
+ *  @param policy How to resolve oversubscription
+ *  @param num_omp_threads Requested OpenMP threads
+ *  @param num_io_threads Requested I/O threads
+ *  @param num_python_workers Requested Python worker processes; 0
+ *         shares the I/O threads' CPUs
+ *  @param num_reserved CPUs to hold back for runtime helpers
+ */
+thread_budget divide_thread_budget(std::vector<int> const& cpus,
+                                   thread_budget_policy policy,
+                                   int num_omp_threads,
+                                   int num_io_threads,
+                                   int num_python_workers,
+                                   int num_reserved);
+
+/** @brief CPUs available to this rank
+ *
+ *  This is the process's affinity mask. If the rank is not bound
+ *  (its mask covers the whole node) the node's CPUs are split evenly
+ *  between the ranks on the node.
+ */
+std::vector<int> get_rank_cpus(lbann_comm const& comm);
+
+/** @brief Establish the rank's thread budget from the command line
+ *
+ *  Sets the OpenMP thread count, binds the calling thread (and so the
+ *  OpenMP threads it later creates) to the OpenMP and reserved CPUs,
+ *  and prints the allocation on the world master. Later calls return
+ *  the budget established by the first.
+ *
+ *  @return The budget, or null under the "none" policy
+ */
+thread_budget const* setup_thread_budget(lbann_comm const& comm);
+
+/** @brief The budget established by setup_thread_budget, if any */
+thread_budget const* get_thread_budget();
+
+/** @brief Print a one-line-per-consumer summary of a budget */
+void print_thread_budget(std::ostream& os, thread_budget const& budget);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_THREADS_THREAD_BUDGET_HPP_INCLUDED
@@ -29,8 +29,8 @@
 #include "lbann_config.hpp"
 
 #include "lbann/utils/exception.hpp"
-#include "thread_safe_queue.hpp"
-#include "type_erased_function.hpp"
+#include "pooled_task.hpp"
+#include "work_stealing_deque.hpp"
 
 #if defined(LBANN_TOPO_AWARE)
 #include <hwloc.h>
@@ -41,13 +41,28 @@
 
 #include <sched.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <thread>
-#include <unordered_map>
+#include <type_traits>
 #include <vector>
 
 namespace lbann {
 
+/** @class thread_pool
+ *  @brief A work-stealing pool of worker threads.
+ *
+ *  Each worker owns a lock-free deque. Jobs submitted from a worker
+ *  go onto its own deque and idle workers steal from the others;
+ *  jobs submitted from outside the pool go through a short injection
+ *  list. Jobs live in recycled task nodes, so in steady state
+ *  neither submitting nor running a job touches the heap.
+ */
 class thread_pool
 {
 public:
@@ -73,6 +88,24 @@ private:
     thread_container_type& threads_;
   };
 
+  /** @class worker_state
+   *  @brief Per-worker job deque and task-node cache
+   */
+  struct worker_state
+  {
+    worker_state(thread_pool& p, int tid) : pool(p), id(tid) {}
+    /** @brief Pool that owns the worker */
+    thread_pool& pool;
+    /** @brief Local thread id */
+    int id;
+    /** @brief Jobs pushed by this worker; other workers steal from it */
+    work_stealing_deque<pooled_task*> deque;
+    /** @brief Private cache of empty task nodes */
+    pooled_task* free_tasks = nullptr;
+    /** @brief Number of nodes in the private cache */
+    size_type num_free_tasks = 0;
+  };
+
 public:
   /** @brief Construct an empty threadpool. Size must be set with launch().
    */
@@ -92,9 +125,17 @@ public:
   void launch_threads(size_type num_threads);
   /** @brief Launch the threads and pin them to the Hyperthreaded cores */
   void launch_pinned_threads(size_type num_threads, int cpu_offset);
+  /** @brief Launch the threads and bind each of them to a set of CPUs
+   *
+   *  @param num_threads Number of threads
+   *  @param cpus OS indices of the CPUs the threads may run on
+   */
+  void launch_bound_threads(size_type num_threads,
+                            std::vector<int> const& cpus);
   /** Wake and terminate all threads in the pool */
   void reap_threads();
-  /** Reap all threads in the pool and relaunch pinned threads */
+  /** Reap all threads in the pool and relaunch pinned threads on the
+   *  same CPUs */
   void relaunch_pinned_threads(size_type num_threads);
 
   /** @brief Submit a job to the pool's queue */
@@ -106,64 +147,267 @@ public:
 
     std::packaged_task<return_type()> task(std::move(func));
     auto future = task.get_future();
-    global_work_queue_.push(std::move(task));
+    submit_detached_(std::move(task));
     return future;
   }
 
-  /** @brief Submit a job to the pool's queue and place the future
-      into a work group */
+  /** @brief Submit a job to the pool's queue as part of the work
+   *  group
+   *
+   *  The job returns a bool; a false result or an exception is
+   *  reported by finish_work_group().
+   */
   template <typename FunctionT>
   void submit_job_to_work_group(FunctionT func)
   {
-    using return_type = typename std::result_of<FunctionT()>::type;
+    m_work_group_pending.fetch_add(1, std::memory_order_relaxed);
+    try {
+      submit_detached_([this, func = std::move(func)]() mutable {
+        try {
+          if (!func()) {
+            m_work_group_failed.store(true, std::memory_order_relaxed);
+          }
+        }
+        catch (...) {
+          record_work_group_exception_(std::current_exception());
+        }
+        notify_job_done_(m_work_group_pending);
+      });
+    }
+    catch (...) {
+      m_work_group_pending.fetch_sub(1, std::memory_order_relaxed);
+      throw;
+    }
+  }
 
-    std::packaged_task<return_type()> task(std::move(func));
-    m_work_group.emplace_back(task.get_future());
-    global_work_queue_.push(std::move(task));
+  /** @brief Wait for all of the jobs in a work group to finish
+   *
+   *  A worker thread runs its own queued jobs while it waits.
+   */
+  bool finish_work_group();
 
-    return;
+  /** @brief Apply a function to every index in [begin, end)
+   *
+   *  Indices are claimed in chunks of @c grain from a shared counter,
+   *  so threads that draw cheap indices pick up the slack from
+   *  threads stuck on expensive ones. A worker thread that calls this
+   *  processes chunks itself; any other thread only waits. The first
+   *  exception thrown by @c func stops the loop and is rethrown here.
+   *
+   *  @param begin First index
+   *  @param end One past the last index
+   *  @param func Callable invoked as func(i)
+   *  @param grain Number of consecutive indices claimed at a time
+   */
+  template <typename IndexT, typename FunctionT>
+  void parallel_for(IndexT begin,
+                    IndexT end,
+                    FunctionT const& func,
+                    IndexT grain = 1)
+  {
+    static_assert(std::is_integral<IndexT>::value,
+                  "parallel_for requires an integral index type");
+    if (!(begin < end)) {
+      return;
+    }
+    grain = std::max(grain, IndexT{1});
+    const IndexT num_chunks = (end - begin - 1) / grain + 1;
+
+    std::atomic<IndexT> next_chunk{0};
+    std::atomic<size_type> pending{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto run_chunks = [&]() {
+      try {
+        for (IndexT c = next_chunk++; c < num_chunks; c = next_chunk++) {
+          const IndexT first = begin + c * grain;
+          const IndexT last = (end - first > grain ? first + grain : end);
+          for (IndexT i = first; i < last; ++i) {
+            func(i);
+          }
+        }
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next_chunk = num_chunks;
+      }
+    };
+
+    // Outside threads do not process chunks, so per-thread resources
+    // indexed by get_local_thread_id() are never shared with a worker
+    const bool on_worker = (current_worker_() != nullptr);
+    if (!on_worker && get_num_threads() == 0) {
+      run_chunks();
+    }
+    else {
+      const size_type self = (on_worker ? 1 : 0);
+      const size_type num_helpers =
+        std::min(static_cast<size_type>(num_chunks) - self,
+                 get_num_threads() - self);
+      try {
+        for (size_type h = 0; h < num_helpers; ++h) {
+          pending.fetch_add(1, std::memory_order_relaxed);
+          submit_detached_([&]() {
+            run_chunks();
+            notify_job_done_(pending);
+          });
+        }
+      }
+      catch (...) {
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        next_chunk = num_chunks;
+        wait_for_jobs_(pending);
+        throw;
+      }
+      if (on_worker) {
+        run_chunks();
+      }
+      wait_for_jobs_(pending);
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
   }
 
-  /** @brief Wait for all of the jobs in a work group to finish */
-  bool finish_work_group()
+  /** @brief Run a function once on every worker thread
+   *
+   *  Each call is handed its worker's local thread id. Workers wait
+   *  for each other before calling @c func, so no worker runs two of
+   *  the calls; this is meant for per-thread setup such as
+   *  first-touching memory, while the pool is otherwise idle. Must be
+   *  called from outside the pool.
+   */
+  template <typename FunctionT>
+  void for_each_thread(FunctionT const& func)
   {
-    std::string error_message;
-    for (auto& f : m_work_group) {
-      bool valid = f.get();
-      if (!valid) {
-        error_message = "invalid future in work group";
-      }
+    if (current_worker_() != nullptr) {
+      LBANN_ERROR("for_each_thread cannot be called from a worker thread");
+    }
+    const size_type num_threads = get_num_threads();
+    std::atomic<size_type> arrived{0};
+    std::atomic<size_type> pending{num_threads};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    for (size_type t = 0; t < num_threads; ++t) {
+      submit_detached_([&]() {
+        ++arrived;
+        while (arrived.load() < num_threads) {
+          std::this_thread::yield();
+        }
+        try {
+          func(get_local_thread_id());
+        }
+        catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+        notify_job_done_(pending);
+      });
     }
-    m_work_group.clear();
-    if (!error_message.empty()) {
-      LBANN_ERROR(error_message);
+    wait_for_jobs_(pending);
+    if (error) {
+      std::rethrow_exception(error);
     }
-    return true;
   }
 
   /** @brief Query the number of worker threads actually present */
   size_type get_num_threads() const noexcept { return threads_.size(); }
 
-  /** @brief Convert the C++ thread id into a local thread pool id */
+  /** @brief Convert the C++ thread id into a local thread pool id
+   *
+   *  Threads outside the pool report 0.
+   */
   int get_local_thread_id();
 
   /** @brief Convert the C++ thread id into a local thread pool id */
   int get_threads_offset() { return m_threads_offset; }
 
 private:
+  /** @brief Create the worker states for a new set of threads */
+  void setup_workers_(size_type num_threads);
   /** @brief The task executed by each thread */
-  void do_thread_work_();
+  void do_thread_work_(worker_state* self);
+  /** @brief Bind to the pool's CPU list, then do the thread's work */
+  void do_thread_work_bound_thread_(worker_state* self);
 #if defined(LBANN_TOPO_AWARE)
-  void do_thread_work_pinned_thread_(int tid,
+  void do_thread_work_pinned_thread_(worker_state* self,
                                      hwloc_topology_t topo,
                                      hwloc_cpuset_t cpuset);
 #endif // LBANN_TOPO_AWARE
+
+  /** @brief The calling thread's state if it is one of this pool's
+   *  workers */
+  worker_state* current_worker_() const noexcept
+  {
+    return (t_current_worker_ != nullptr && &t_current_worker_->pool == this
+              ? t_current_worker_
+              : nullptr);
+  }
+
+  /** @brief Queue a job without a future */
+  template <typename FunctionT>
+  void submit_detached_(FunctionT&& func)
+  {
+    pooled_task* task = acquire_task_();
+    try {
+      task->emplace(std::forward<FunctionT>(func));
+    }
+    catch (...) {
+      release_task_(task);
+      throw;
+    }
+    push_task_(task);
+  }
+
+  /** @brief Get an empty task node */
+  pooled_task* acquire_task_();
+  /** @brief Recycle an empty task node */
+  void release_task_(pooled_task* task);
+  /** @brief Queue a filled task node and wake a sleeping worker */
+  void push_task_(pooled_task* task);
+  /** @brief Take a queued task: own deque, then injected, then stolen */
+  pooled_task* take_task_(worker_state& self);
+  /** @brief Run a task and recycle its node */
+  void run_task_(pooled_task* task);
+  /** @brief Count down a job counter and wake outside waiters at 0 */
+  void notify_job_done_(std::atomic<size_type>& pending);
+  /** @brief Block until a job counter reaches 0 */
+  void wait_for_jobs_(std::atomic<size_type>& pending);
+  /** @brief Keep the first exception thrown by a work group job */
+  void record_work_group_exception_(std::exception_ptr e);
+
 private:
   /** @brief Container holding the threads */
   thread_container_type threads_;
 
-  /** @brief The thread-safe work queue */
-  thread_safe_queue<type_erased_function> global_work_queue_;
+  /** @brief State for each worker, indexed by local thread id */
+  std::vector<std::unique_ptr<worker_state>> m_workers;
+
+  /** @brief Jobs submitted from outside the pool, in FIFO order */
+  std::mutex m_injection_mutex;
+  pooled_task* m_injection_head = nullptr;
+  pooled_task* m_injection_tail = nullptr;
+  std::atomic<size_type> m_num_injected;
+
+  /** @brief Number of queued jobs that no thread has taken yet */
+  std::atomic<size_type> m_num_queued;
+
+  /** @brief Idle workers sleep here until a job is queued */
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wake_cv;
+  std::atomic<size_type> m_num_sleeping;
+
+  /** @brief Outside threads sleep here until their jobs finish */
+  std::mutex m_done_mutex;
+  std::condition_variable m_done_cv;
+
+  /** @brief Storage for task nodes */
+  pooled_task_allocator m_task_allocator;
 
   /** @brief RAII "deleter" for the threads */
   thread_joiner thread_joiner_;
@@ -171,14 +415,20 @@ private:
   /** @brief Flag to track if more work is to be done */
   std::atomic<bool> all_work_done_;
 
-  std::mutex m_thread_map_mutex;
-  std::unordered_map<std::thread::id, int> m_thread_id_to_local_id_map;
-
   /** @brief Work Group */
-  std::vector<std::future<bool>> m_work_group;
+  std::atomic<size_type> m_work_group_pending;
+  std::atomic<bool> m_work_group_failed;
+  std::mutex m_work_group_mutex;
+  std::exception_ptr m_work_group_exception;
 
   int m_threads_offset;
 
+  /** @brief CPUs the threads were bound to by launch_bound_threads */
+  std::vector<int> m_thread_cpus;
+
+  /** @brief The calling thread's worker state, if it is a worker */
+  static thread_local worker_state* t_current_worker_;
+
 }; // class thread_pool
 
 } // namespace lbann
@@ -46,7 +46,13 @@ namespace lbann {
  */
 void hwloc_print_topo();
 
-// Used in thread_pool.cpp and thread_topology.cpp
+/** @brief CPUs on the NUMA domain closest to this rank's data.
+ *
+ *  This is the domain of the rank's GPU when LBANN is built with
+ *  CUDA, and otherwise the domain the calling thread is running on.
+ *  The set is restricted to the CPUs the rank is bound to. The caller
+ *  frees the returned set.
+ */
 hwloc_cpuset_t get_local_cpuset_for_current_thread(hwloc_topology_t topo);
 
 #endif // LBANN_TOPO_AWARE
@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_THREADS_WORK_STEALING_DEQUE_HPP_INCLUDED
+#define LBANN_UTILS_THREADS_WORK_STEALING_DEQUE_HPP_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace lbann {
+
+/** @class work_stealing_deque
+ *  @brief A lock-free double-ended queue with a single owner.
+ *
+ *  This is the Chase-Lev deque, following the C11 formulation of Le
+ *  et al. (PPoPP 2013). The owning thread pushes and pops at the
+ *  bottom without contention; any other thread may steal from the
+ *  top. The ring buffer grows when full. Retired buffers are kept
+ *  until the deque is destroyed, since a concurrent thief may still
+ *  be reading from them.
+ *
+ *  @tparam T A trivially copyable type, usually a pointer
+ */
+template <typename T>
+class work_stealing_deque
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+                "work_stealing_deque requires a trivially copyable type");
+
+private:
+  /** @class ring_buffer
+   *  @brief Circular array of atomic slots
+   */
+  struct ring_buffer
+  {
+    explicit ring_buffer(std::int64_t capacity)
+      : m_capacity(capacity), m_slots(new std::atomic<T>[capacity])
+    {}
+
+    std::int64_t capacity() const noexcept { return m_capacity; }
+
+    void put(std::int64_t i, T x) noexcept
+    {
+      m_slots[i & (m_capacity - 1)].store(x, std::memory_order_relaxed);
+    }
+
+    T get(std::int64_t i) const noexcept
+    {
+      return m_slots[i & (m_capacity - 1)].load(std::memory_order_relaxed);
+    }
+
+    /** @brief Copy the live range [top, bottom) into a buffer of
+     *  twice the capacity */
+    std::unique_ptr<ring_buffer> grow(std::int64_t bottom,
+                                      std::int64_t top) const
+    {
+      auto bigger = std::make_unique<ring_buffer>(2 * m_capacity);
+      for (std::int64_t i = top; i != bottom; ++i) {
+        bigger->put(i, get(i));
+      }
+      return bigger;
+    }
+
+    std::int64_t m_capacity;
+    std::unique_ptr<std::atomic<T>[]> m_slots;
+  };
+
+public:
+  /** @brief Construct an empty deque
+   *
+   *  @param capacity Initial capacity; rounded up to a power of two
+   */
+  explicit work_stealing_deque(std::int64_t capacity = 256)
+    : m_top(0), m_bottom(0)
+  {
+    std::int64_t c = 1;
+    while (c < capacity) {
+      c *= 2;
+    }
+    m_buffers.emplace_back(std::make_unique<ring_buffer>(c));
+    m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  work_stealing_deque(const work_stealing_deque&) = delete;
+  work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+  /** @brief Push a value onto the bottom. Owner only. */
+  void push(T x)
+  {
+    const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const std::int64_t t = m_top.load(std::memory_order_acquire);
+    ring_buffer* a = m_buffer.load(std::memory_order_relaxed);
+    if (b - t > a->capacity() - 1) {
+      m_buffers.emplace_back(a->grow(b, t));
+      a = m_buffers.back().get();
+      m_buffer.store(a, std::memory_order_release);
+    }
+    a->put(b, x);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /** @brief Pop the most recently pushed value. Owner only.
+   *
+   *  @return false if the deque is empty or a thief won the race
+   *          for the last value
+   */
+  bool pop(T& x)
+  {
+    const std::int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    ring_buffer* a = m_buffer.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = m_top.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Empty
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    x = a->get(b);
+    if (t == b) {
+      // Last value, race against thieves for it
+      const bool won = m_top.compare_exchange_strong(t,
+                                                     t + 1,
+                                                     std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed);
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  /** @brief Take the oldest value. Safe from any thread.
+   *
+   *  @return false if the deque is empty or another thread took the
+   *          value first
+   */
+  bool steal(T& x)
+  {
+    std::int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = m_bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return false;
+    }
+    ring_buffer* a = m_buffer.load(std::memory_order_acquire);
+    x = a->get(t);
+    return m_top.compare_exchange_strong(t,
+                                         t + 1,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed);
+  }
+
+  /** @brief Approximate number of values; exact for the owner */
+  std::int64_t size() const noexcept
+  {
+    const std::int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const std::int64_t t = m_top.load(std::memory_order_relaxed);
+    return b > t ? b - t : 0;
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+
+private:
+  /** @brief Index of the oldest value; advanced by thieves */
+  alignas(64) std::atomic<std::int64_t> m_top;
+  /** @brief One past the newest value; written only by the owner */
+  alignas(64) std::atomic<std::int64_t> m_bottom;
+  /** @brief The current ring buffer */
+  std::atomic<ring_buffer*> m_buffer;
+  /** @brief Every buffer ever allocated; owner only */
+  std::vector<std::unique_ptr<ring_buffer>> m_buffers;
+
+}; // class work_stealing_deque
+
+} // namespace lbann
+#endif /* LBANN_UTILS_THREADS_WORK_STEALING_DEQUE_HPP_INCLUDED */
@@ -46,7 +46,10 @@ namespace lbann {
  *  exclusive time is easily inferred by subtracting sub-timers'
  *  inclusive time from this inclusive time.
  *
- *  More documentation goes here.
+ *  Scopes are looked up by comparing keys in place, so entering a
+ *  scope named by a string literal does not allocate once the scope
+ *  exists. Each scope also keeps a fixed-size duration histogram
+ *  for percentile queries (see AccumulatingTimer::percentile).
  */
 class TimerMap
 {
@@ -57,6 +60,7 @@ public:
   AccumulatingTimer& timer() noexcept;
   AccumulatingTimer const& timer() const noexcept;
 
+  TimerMap& scope(char const* key);
   TimerMap& scope(std::string const& key);
   TimerMap const& scope(std::string const& key) const;
 
@@ -77,9 +81,15 @@ class ScopeTimer
   TimerMap* m_timer;
 
 public:
+  ScopeTimer(TimerMap& timer, char const* scope_name);
   ScopeTimer(TimerMap& timer, std::string const& scope_name);
+  ScopeTimer(ScopeTimer& timer, char const* scope_name);
   ScopeTimer(ScopeTimer& timer, std::string const& scope_name);
   ~ScopeTimer() noexcept;
+
+  /** @brief Commit a duration (in seconds) measured elsewhere, e.g.
+   *         time spent blocked inside a callee, to a sub-scope. */
+  void record(char const* scope_name, double duration);
 }; // class ScopeTimer
 
 template <typename TimerT>
@@ -99,27 +109,45 @@ inline AccumulatingTimer const& TimerMap::timer() const noexcept
   return m_timer;
 }
 
-inline auto TimerMap::scope(std::string const& key) -> TimerMap&
+inline auto TimerMap::scope(char const* key) -> TimerMap&
 {
   auto iter = std::find_if(begin(m_subscopes),
                            end(m_subscopes),
-                           [&key](auto& t) { return t.key() == key; });
+                           [key](auto& t) { return t.key() == key; });
   if (iter == end(m_subscopes))
     return m_subscopes.emplace_back(key);
   else
     return *iter;
 }
 
-inline ScopeTimer::ScopeTimer(TimerMap& timer, std::string const& scope_name)
+inline auto TimerMap::scope(std::string const& key) -> TimerMap&
+{
+  return scope(key.c_str());
+}
+
+inline ScopeTimer::ScopeTimer(TimerMap& timer, char const* scope_name)
   : m_timer{&(timer.scope(scope_name))}
 {
   m_timer->timer().start();
 }
 
-inline ScopeTimer::ScopeTimer(ScopeTimer& timer, std::string const& scope_name)
+inline ScopeTimer::ScopeTimer(TimerMap& timer, std::string const& scope_name)
+  : ScopeTimer{timer, scope_name.c_str()}
+{}
+
+inline ScopeTimer::ScopeTimer(ScopeTimer& timer, char const* scope_name)
   : ScopeTimer{*(timer.m_timer), scope_name}
 {}
 
+inline ScopeTimer::ScopeTimer(ScopeTimer& timer, std::string const& scope_name)
+  : ScopeTimer{*(timer.m_timer), scope_name.c_str()}
+{}
+
+inline void ScopeTimer::record(char const* scope_name, double duration)
+{
+  m_timer->scope(scope_name).timer().insert(duration);
+}
+
 inline ScopeTimer::~ScopeTimer() noexcept
 {
   m_timer->timer().stop();
@@ -32,6 +32,8 @@
 #include "lbann/weights/initializer.hpp"
 #include "lbann/weights/weights.hpp"
 
+#include <functional>
+
 namespace cereal {
 class access;
 } // namespace cereal
@@ -148,6 +150,20 @@ public:
   /** Set an entry in the weight matrix. */
   void set_value(TensorDataType value, size_t row, size_t col);
 
+  /** @brief Fill the values with @c source when they are first
+   *         accessed, instead of with the initializer at setup.
+   *
+   *  Used to load trained values without drawing random ones first
+   *  (see weights_container::attach). The source runs at most once and
+   *  is dropped if the values are set before then.
+   */
+  void set_deferred_values(std::function<void(AbsDistMatrixType&)> source);
+  /** @brief Whether the values still wait on a deferred source. */
+  bool has_deferred_values() const noexcept
+  {
+    return static_cast<bool>(m_deferred_values);
+  }
+
   // -----------------------------------------------
   // Weight memory management
   // -----------------------------------------------
@@ -164,6 +180,8 @@ public:
   void wait_for_full_weights() const override;
   /** @brief Releases the full view of the weights for memory reclamation. */
   void release_full_weights() const override;
+  bool has_full_weights() const noexcept override;
+  size_t get_full_weights_bytes() const override;
 
   /** Reconcile weight values.
    *  If weight values are duplicated across multiple processes, they
@@ -216,6 +234,8 @@ private:
                     std::vector<size_t> const& matrix_width_dims) override;
   void do_move_values_(data_type_weights& other);
   void do_steal_values_(weights& other) override;
+  /** @brief Run the deferred source, if any. */
+  void materialize_values_() const;
 
 private:
   /** Weight matrix (potentially sharded). */
@@ -226,6 +246,15 @@ private:
    */
   mutable std::unique_ptr<AbsDistMatrixType> m_values_view;
 
+  /** Whether m_values_view holds the current values of m_values. Reset
+   *  whenever the sharded values may change. */
+  mutable bool m_full_weights_valid = false;
+
+  /** Fills m_values on first access, see set_deferred_values. Mutable
+   *  since the values are materialized by the const accessors.
+   */
+  mutable std::function<void(AbsDistMatrixType&)> m_deferred_values;
+
   /** Weights initializer.
    *  Default is nullptr, which corresponds to zero initialization.
    */
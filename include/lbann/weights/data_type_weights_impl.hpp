@@ -36,12 +36,36 @@ template <typename ArchiveT>
 void data_type_weights<TensorDataType>::serialize(ArchiveT& ar)
 #if !(defined __CUDACC__)
 {
-  ar(cereal::base_class<weights>(this),
-     CEREAL_NVP(m_values),
-     CEREAL_NVP(m_optimizer));
+  ar(cereal::base_class<weights>(this));
+
+  // Incremental checkpoints may leave out unchanged values
+  auto const* incremental = incremental_checkpoint_scope::get_current();
+  bool stored = true;
+  if (incremental != nullptr) {
+    if constexpr (!utils::IsInputArchive<ArchiveT>) {
+      stored = !incremental->is_skipped(this->get_name());
+    }
+    ar(CEREAL_NVP(stored));
+  }
+  if (stored) {
+    if constexpr (!utils::IsInputArchive<ArchiveT>) {
+      materialize_values_();
+    }
+    else {
+      m_deferred_values = nullptr;
+    }
+    ar(CEREAL_NVP(m_values), CEREAL_NVP(m_optimizer));
+  }
+  else if constexpr (utils::IsInputArchive<ArchiveT>) {
+    auto& previous = dynamic_cast<data_type_weights&>(
+      incremental->get_previous(this->get_name()));
+    m_values = std::move(previous.m_values);
+    m_optimizer = std::move(previous.m_optimizer);
+  }
   if constexpr (utils::IsInputArchive<ArchiveT>) {
     if (m_optimizer)
       m_optimizer->setup_base(this);
+    this->mark_modified();
   }
 }
 #else
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_WEIGHTS_FLAT_WEIGHTS_BUFFER_HPP_INCLUDED
+#define LBANN_WEIGHTS_FLAT_WEIGHTS_BUFFER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class weights;
+
+/** @brief One allocation holding the tensors of many weights.
+ *
+ *  Each buffer owns the local values, gradient contributions and
+ *  optimizer state of every weights object with one data type and
+ *  device, laid out back to back. The weights' matrices are views
+ *  into it, so a whole-model operation can touch one contiguous
+ *  range instead of one small allocation per tensor.
+ */
+class flat_weights_buffer_base
+{
+public:
+  virtual ~flat_weights_buffer_base() = default;
+
+  /** @brief Number of weights objects packed in the buffer. */
+  virtual size_t num_weights() const noexcept = 0;
+  /** @brief Size of the local allocation in bytes. */
+  virtual size_t size_in_bytes() const noexcept = 0;
+};
+
+/** @brief Pack weights into one buffer per data type and device.
+ *
+ *  Must be called after the weights and their optimizers are set up.
+ *  The current values and optimizer state are copied into the
+ *  buffers and the separate allocations are released. Weights that
+ *  are already packed are copied out of their old buffers, which must
+ *  outlive this call. Gradients of sharded weights stay separately
+ *  allocated.
+ *
+ *  The packed matrices are views, so they may shrink but resizing
+ *  them beyond their slots is an error.
+ */
+std::vector<std::unique_ptr<flat_weights_buffer_base>>
+make_flat_weights_buffers(std::vector<weights*> const& weights_list);
+
+} // namespace lbann
+
+#endif // LBANN_WEIGHTS_FLAT_WEIGHTS_BUFFER_HPP_INCLUDED
@@ -28,10 +28,14 @@
 #define LBANN_WEIGHTS_HPP
 
 #include "lbann/base.hpp"
+#include "lbann/optimizers/gradient_compression.hpp"
 #include "lbann/utils/cloneable.hpp"
 #include "lbann/utils/description.hpp"
 
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #ifdef LBANN_HAS_ONNX
@@ -220,6 +224,13 @@ public:
   virtual void wait_for_full_weights() const = 0;
   /** @brief Releases the full view of the weights for memory reclamation. */
   virtual void release_full_weights() const = 0;
+  /** @brief Whether the full view of sharded weights is up to date.
+   *
+   *  Always false if the weights are not sharded.
+   */
+  virtual bool has_full_weights() const noexcept = 0;
+  /** @brief Bytes held by the full view of the weights. */
+  virtual size_t get_full_weights_bytes() const = 0;
   ///@}
 
   // -----------------------------------------------
@@ -267,6 +278,20 @@ public:
   /** Set sharding distribution (VC, MC, MR, or STAR if not sharded). */
   void set_sharding_distribution(El::Dist dist) { m_sharding_strategy = dist; }
 
+  // -----------------------------------------------
+  // Gradient compression
+  // -----------------------------------------------
+  /** How the gradient is compressed for synchronization. */
+  gradient_compression_config const& get_gradient_compression() const
+  {
+    return m_gradient_compression;
+  }
+  /** Set how the gradient is compressed for synchronization. */
+  void set_gradient_compression(gradient_compression_config const& config)
+  {
+    m_gradient_compression = config;
+  }
+
   // -----------------------------------------------
   // Freezing
   // -----------------------------------------------
@@ -277,6 +302,19 @@ public:
   /** Whether weight optimization is enabled. */
   bool is_frozen() const { return m_frozen; }
 
+  // -----------------------------------------------
+  // Versioning
+  // -----------------------------------------------
+  /** @brief Version of the values and optimizer state.
+   *
+   *  Versions are drawn from a process-wide counter whenever the
+   *  values may have been modified, so two observations with the same
+   *  version saw the same state.
+   */
+  uint64_t get_version() const noexcept { return m_version; }
+  /** Record that the values or optimizer state may have changed. */
+  void mark_modified() noexcept;
+
   // -----------------------------------------------
   // Weight matrix accessors
   // -----------------------------------------------
@@ -377,6 +415,50 @@ private:
 
   /** How weights are sharded across ranks. */
   El::Dist m_sharding_strategy;
+
+  /** How the gradient is compressed for synchronization. */
+  gradient_compression_config m_gradient_compression;
+
+  /** See @c get_version. */
+  uint64_t m_version;
+};
+
+/** @brief Leaves unchanged weights out of checkpoint archives.
+ *
+ *  Used for incremental checkpoints. While a scope is active on the
+ *  current thread, weights named in @c skip are serialized without
+ *  their values and optimizer state. When reading, weights stored
+ *  that way take their values and optimizer state from the
+ *  same-named weights in @c previous, i.e. the model as loaded from
+ *  the earlier checkpoint in the chain.
+ *
+ *  Archives written inside a scope must be read inside one.
+ */
+class incremental_checkpoint_scope
+{
+public:
+  incremental_checkpoint_scope(
+    std::set<std::string> skip,
+    std::map<std::string, OwningWeightsPtr> previous = {});
+  ~incremental_checkpoint_scope();
+  incremental_checkpoint_scope(const incremental_checkpoint_scope&) = delete;
+  incremental_checkpoint_scope&
+  operator=(const incremental_checkpoint_scope&) = delete;
+
+  /** The scope active on this thread, or null. */
+  static incremental_checkpoint_scope* get_current() noexcept;
+
+  bool is_skipped(std::string const& name) const
+  {
+    return m_skip.count(name) != 0;
+  }
+  /** Weights from the earlier checkpoint; throws if missing. */
+  weights& get_previous(std::string const& name) const;
+
+private:
+  std::set<std::string> m_skip;
+  std::map<std::string, OwningWeightsPtr> m_previous;
+  incremental_checkpoint_scope* m_outer;
 };
 
 } // namespace lbann
@@ -67,6 +67,54 @@ struct SafeWeightsAccessor
   }
 }; // class SafeWeightsAccessor
 
+/** @brief Copy the values of src into dst if both have data type
+ *         TensorDataType.
+ */
+template <typename TensorDataType>
+bool try_copy_values(weights const& src, weights& dst)
+{
+  using DataTypeWeights = data_type_weights<TensorDataType>;
+  auto const* src_dtw = dynamic_cast<DataTypeWeights const*>(&src);
+  auto* dst_dtw = dynamic_cast<DataTypeWeights*>(&dst);
+  if (src_dtw == nullptr || dst_dtw == nullptr) {
+    return false;
+  }
+  dst_dtw->set_values(src_dtw->get_values_sharded());
+  return true;
+}
+
+/** @brief Copy the values of src into dst, which must have the same
+ *         data type and dimensions.
+ */
+inline void copy_values(weights const& src, weights& dst)
+{
+  if (try_copy_values<float>(src, dst)) {
+    return;
+  }
+  if (try_copy_values<double>(src, dst)) {
+    return;
+  }
+#ifdef LBANN_HAS_HALF
+  if (try_copy_values<cpu_fp16>(src, dst)) {
+    return;
+  }
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU_FP16
+  if (try_copy_values<fp16>(src, dst)) {
+    return;
+  }
+#endif // LBANN_HAS_GPU_FP16
+  LBANN_ERROR("could not copy weights \"",
+              src.get_name(),
+              "\" (",
+              src.get_datatype_name(),
+              ") into weights \"",
+              dst.get_name(),
+              "\" (",
+              dst.get_datatype_name(),
+              ")");
+}
+
 } // namespace weights_details
 } // namespace lbann
 #endif // LBANN_WEIGHTS_WEIGHTS_HELPERS_HPP_INCLUDED
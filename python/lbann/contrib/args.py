@@ -3,6 +3,7 @@
 from typing import Any, List
 
 import argparse
+import math
 import shlex
 
 import lbann
@@ -110,7 +111,9 @@ def get_scheduler_kwargs(args):
 
 def get_distconv_environment(parallel_io=False,
                              num_io_partitions=1,
-                             init_nvshmem=False):
+                             io_partition_shape=None,
+                             init_nvshmem=False,
+                             overlap_halo_exchange=False):
     """Return recommended Distconv variables.
 
     Args:
@@ -118,6 +121,13 @@ def get_distconv_environment(parallel_io=False,
             Whether to read a single sample in parallel.
         num_io_partitions (int):
             The number of processes to read a single sample.
+        io_partition_shape (tuple of int, optional):
+            The number of IO partitions along depth, height and width.
+            Matching the spatial partitioning of the input layer lets
+            each process read its own block and avoids a shuffle.
+        overlap_halo_exchange (bool):
+            Whether to compute the interior of spatially partitioned
+            convolutions while halos are being exchanged.
     """
     # TODO: Use the default halo exchange and shuffle method. See https://github.com/LLNL/lbann/issues/1659
     environment = {
@@ -132,8 +142,15 @@ def get_distconv_environment(parallel_io=False,
         'LBANN_DISTCONV_NUM_IO_PARTITIONS': num_io_partitions,
         "LBANN_KEEP_ERROR_SIGNALS": "1",
     }
+    if io_partition_shape is not None:
+        environment['LBANN_DISTCONV_IO_PARTITION_SHAPE'] = 'x'.join(
+            str(d) for d in io_partition_shape)
+        environment['LBANN_DISTCONV_NUM_IO_PARTITIONS'] = math.prod(
+            io_partition_shape)
     if init_nvshmem:
         environment["LBANN_INIT_NVSHMEM"] = 1
+    if overlap_halo_exchange:
+        environment["LBANN_DISTCONV_OVERLAP_HALO_EXCHANGE"] = 1
 
     return environment
 
@@ -161,7 +178,8 @@ def add_optimizer_arguments(parser,
         action='store',
         default=default_optimizer,
         type=str,
-        choices=('momentum', 'sgd', 'adam', 'adamw', 'adagrad', 'rmsprop'),
+        choices=('momentum', 'sgd', 'adam', 'adamw', 'adagrad', 'rmsprop',
+                 'lamb', 'lars'),
         help='optimizer (default: {})'.format(default_optimizer))
     parser.add_argument('--optimizer-learning-rate',
                         action='store',
@@ -218,6 +236,17 @@ def create_optimizer(args):
         return lbann.core.optimizer.RMSprop(learn_rate=lr,
                                             decay_rate=0.99,
                                             eps=1e-8)
+    elif opt == 'lamb':
+        return lbann.core.optimizer.LAMB(learn_rate=lr,
+                                         beta1=0.9,
+                                         beta2=0.999,
+                                         eps=1e-6,
+                                         weight_decay=1e-2)
+    elif opt == 'lars':
+        return lbann.core.optimizer.LARS(learn_rate=lr,
+                                         momentum=0.9,
+                                         trust_coefficient=1e-3,
+                                         eps=1e-8)
     else:
         raise ValueError('invalid optimizer type ({})'.format(opt))
 
@@ -367,3 +396,21 @@ def add_amp_arguments(args: argparse.ArgumentParser) -> None:
         action='store_true',
         default=False,
         help='Enable automatic mixed precision')
+    args.add_argument(
+        '--amp-no-loss-scaling',
+        dest='amp_loss_scaling',
+        action='store_false',
+        default=True,
+        help='Disable AMP loss scaling and gradient finiteness checks')
+    args.add_argument(
+        '--amp-allow',
+        nargs='*',
+        default=[],
+        metavar='LAYER',
+        help='Additional layer types to run in reduced precision under AMP')
+    args.add_argument(
+        '--amp-deny',
+        nargs='*',
+        default=[],
+        metavar='LAYER',
+        help='Layer types to keep in FP32 under AMP')
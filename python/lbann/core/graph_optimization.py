@@ -0,0 +1,421 @@
+"""Graph-level optimizations of a layer graph.
+
+The passes here rewrite a graph of lbann.Layer objects in place before
+it is exported to protobuf, so that the model set up in C++ has fewer
+layers, activations and error signals:
+
+- Identity layers, and permutes with an identity permutation, are
+  bypassed.
+- Chains of Reshape layers are collapsed into the last reshape, and
+  chains of TensorPermute layers into one composed permutation.
+- Constant subgraphs are folded: a reshape of a constant, element-wise
+  operators on constants and arithmetic between two constants become
+  one Constant layer. Arithmetic between a tensor and a constant
+  becomes the matching operator with a scalar constant.
+- Element-wise operator layers are grouped into their parent operator
+  layer, as in the fuse_layers setup pass of the C++ model.
+- Layers that no output depends on are removed.
+
+A layer is only rewritten when nothing outside the graph can observe
+it: outputs, hint layers, layers named in callbacks, checkpointed
+layers and layers with weights are left as they are, unless no output
+depends on them. Layers with a
+different device, data layout, datatype, sub-grid or parallel strategy
+than their neighbor are not merged with it.
+
+"""
+import math
+import lbann.core.layer
+from lbann.util import make_iterable
+
+# Operators with one input, which an operator layer may chain after
+# its first operator
+_UNARY_OPERATORS = frozenset([
+    'Abs', 'Acos', 'Acosh', 'AddConstant', 'Asin', 'Asinh', 'Atan',
+    'Atanh', 'Ceil', 'Clamp', 'ConstantSubtract', 'Cos', 'Cosh',
+    'EqualConstant', 'Erf', 'ErfInv', 'Exp', 'Expm1', 'Floor', 'Gelu',
+    'GreaterConstant', 'GreaterEqualConstant', 'LessConstant',
+    'LessEqualConstant', 'Log', 'Log1p', 'LogSigmoid', 'LogicalNot',
+    'MaxConstant', 'MinConstant', 'Negative', 'NotEqualConstant',
+    'Reciprocal', 'Round', 'Rsqrt', 'SafeReciprocal', 'Scale', 'Selu',
+    'Sigmoid', 'Sign', 'Sin', 'Sinh', 'Softplus', 'Softsign', 'Sqrt',
+    'Square', 'SubtractConstant', 'Tan', 'Tanh'])
+
+# Scalar versions of operators that can be evaluated on a Constant
+# layer. Domain errors leave the layer unfolded.
+_FOLDABLE_UNARY_OPERATORS = {
+    'Abs': lambda x, op: abs(x),
+    'Acos': lambda x, op: math.acos(x),
+    'AddConstant': lambda x, op: x + op.constant,
+    'Asin': lambda x, op: math.asin(x),
+    'Atan': lambda x, op: math.atan(x),
+    'Ceil': lambda x, op: float(math.ceil(x)),
+    'Clamp': lambda x, op: min(max(x, op.min), op.max),
+    'ConstantSubtract': lambda x, op: op.constant - x,
+    'Cos': lambda x, op: math.cos(x),
+    'Cosh': lambda x, op: math.cosh(x),
+    'Erf': lambda x, op: math.erf(x),
+    'Exp': lambda x, op: math.exp(x),
+    'Expm1': lambda x, op: math.expm1(x),
+    'Floor': lambda x, op: float(math.floor(x)),
+    'Log': lambda x, op: math.log(x),
+    'Log1p': lambda x, op: math.log1p(x),
+    'MaxConstant': lambda x, op: max(x, op.constant),
+    'MinConstant': lambda x, op: min(x, op.constant),
+    'Negative': lambda x, op: -x,
+    'Reciprocal': lambda x, op: 1 / x,
+    'Rsqrt': lambda x, op: 1 / math.sqrt(x),
+    'SafeReciprocal': lambda x, op: 1 / x if x != 0 else 0.0,
+    'Scale': lambda x, op: x * op.constant,
+    'Sigmoid': lambda x, op: 1 / (1 + math.exp(-x)),
+    'Sign': lambda x, op: float((x > 0) - (x < 0)),
+    'Sin': lambda x, op: math.sin(x),
+    'Sinh': lambda x, op: math.sinh(x),
+    'Softplus': lambda x, op: math.log1p(math.exp(x)),
+    'Softsign': lambda x, op: x / (1 + abs(x)),
+    'Sqrt': lambda x, op: math.sqrt(x),
+    'Square': lambda x, op: x * x,
+    'SubtractConstant': lambda x, op: x - op.constant,
+    'Tan': lambda x, op: math.tan(x),
+    'Tanh': lambda x, op: math.tanh(x),
+}
+
+_FOLDABLE_BINARY_OPERATORS = {
+    'Add': lambda x, y: x + y,
+    'Subtract': lambda x, y: x - y,
+    'Multiply': lambda x, y: x * y,
+    'Divide': lambda x, y: x / y,
+}
+
+# Layers whose children each receive a different output tensor, so
+# their list of children cannot change
+_PER_CHILD_OUTPUT_LAYERS = ('Slice', 'Cross_Grid_Sum', 'Cross_Grid_Sum_Slice')
+
+_PLACEMENT_ATTRS = ('device', 'data_layout', 'datatype', 'grid_tag',
+                    'parallel_strategy')
+
+
+def _type_name(l):
+    return type(l).__name__
+
+
+def _op_names(l):
+    return [type(op).__name__ for op in l.ops]
+
+
+def _is_operator_layer(l):
+    """Whether l is one of the generated single-operator layers.
+
+    These set the datatype and device of their operators from the
+    layer, so their operators can be concatenated.
+
+    """
+    import lbann.core.operator_layers
+    cls = type(l)
+    return (cls is not lbann.core.layer.OperatorLayer
+            and getattr(lbann.core.operator_layers, cls.__name__, None) is cls)
+
+
+def _same_placement(a, b):
+    return all(getattr(a, attr) == getattr(b, attr)
+               for attr in _PLACEMENT_ATTRS)
+
+
+def _dims(value):
+    """Tensor dimensions given as an int, a sequence or a string"""
+    if value is None:
+        return None
+    if isinstance(value, str):
+        return [int(d) for d in value.split()]
+    return [int(d) for d in make_iterable(value)]
+
+
+def _layer_kwargs(l):
+    """Arguments to construct a layer in place of l"""
+    return dict(name=l.name,
+                device=l.device,
+                data_layout=l.data_layout,
+                datatype=l.datatype,
+                hint_layer=l.hint_layer,
+                grid_tag=l.grid_tag.get('value'),
+                parallel_strategy=l.parallel_strategy)
+
+
+class _Graph:
+    """Layer graph being rewritten."""
+
+    def __init__(self, layers, outputs, keep_names):
+        self.layers = list(lbann.core.layer.traverse_layer_graph(layers))
+        if outputs:
+            self.outputs = set(outputs)
+        else:
+            self.outputs = set(l for l in self.layers if not l.children)
+        self.hints = set(l.hint_layer for l in self.layers
+                         if l.hint_layer is not None)
+        self.keep_names = set(keep_names)
+
+    def refresh(self):
+        """Recompute the topological order after a rewrite"""
+        anchors = [l for l in self.layers if l.parents or l.children]
+        anchors.extend(self.outputs)
+        self.layers = list(lbann.core.layer.traverse_layer_graph(anchors))
+
+    def is_fixed(self, l):
+        """Whether l is observable outside the graph"""
+        return (l in self.outputs
+                or l in self.hints
+                or l.name in self.keep_names
+                or l.checkpoint
+                or l.weights
+                or _type_name(l) == 'Input')
+
+    def can_bypass(self, l):
+        """Whether l's parent can feed l's children directly"""
+        if self.is_fixed(l) or len(l.parents) != 1 or not l.children:
+            return False
+        parent = l.parents[0]
+        return (len(l.children) == 1
+                or _type_name(parent) not in _PER_CHILD_OUTPUT_LAYERS)
+
+    def bypass(self, l):
+        """Connect the only parent of l directly to l's children"""
+        parent = l.parents[0]
+        i = parent.children.index(l)
+        parent.children[i:i+1] = l.children
+        for child in l.children:
+            child.parents = [parent if p is l else p for p in child.parents]
+        l.parents, l.children = [], []
+
+    def replace(self, old, new, parents=()):
+        """Put new in place of old.
+
+        new takes old's children. Of old's parents, only those in
+        parents stay connected; the others lose old as a child.
+
+        """
+        for p in old.parents:
+            i = p.children.index(old)
+            if p in parents:
+                p.children[i] = new
+            else:
+                del p.children[i]
+        new.parents = list(parents)
+        new.children = old.children
+        for child in new.children:
+            child.parents = [new if p is old else p for p in child.parents]
+        old.parents, old.children = [], []
+
+
+def _remove_identities(graph):
+    changed = False
+    for l in graph.layers:
+        is_identity = _type_name(l) == 'Identity'
+        if _type_name(l) == 'TensorPermute':
+            axes = _dims(l.axes)
+            is_identity = axes == list(range(len(axes)))
+        if (is_identity
+            and graph.can_bypass(l)
+            and _same_placement(l, l.parents[0])):
+            graph.bypass(l)
+            changed = True
+    return changed
+
+
+def _collapse_reshapes(graph):
+    """Merge a reshape or permute into its only child of the same type"""
+    changed = False
+    for l in graph.layers:
+        if (_type_name(l) not in ('Reshape', 'TensorPermute')
+            or len(l.children) != 1):
+            continue
+        child = l.children[0]
+        if (type(child) is not type(l)
+            or child.parents != [l]
+            or not graph.can_bypass(l)
+            or not _same_placement(l, child)):
+            continue
+        if _type_name(l) == 'TensorPermute':
+            axes = _dims(l.axes)
+            child.axes = [axes[a] for a in _dims(child.axes)]
+        graph.bypass(l)
+        changed = True
+    return changed
+
+
+def _fold_constants(graph):
+    changed = False
+    for l in list(graph.layers):
+        if graph.is_fixed(l) or not l.parents:
+            continue
+        constants = [p for p in l.parents
+                     if _type_name(p) == 'Constant' and p.value is not None]
+
+        # Reshape of a constant
+        if _type_name(l) == 'Reshape' and constants == l.parents:
+            in_dims = _dims(constants[0].num_neurons)
+            dims = _dims(l.dims)
+            if in_dims is None or dims is None:
+                continue
+            if -1 in dims:
+                known = math.prod(d for d in dims if d != -1)
+                if known == 0:
+                    continue
+                dims[dims.index(-1)] = math.prod(in_dims) // known
+            new = lbann.core.layer.Constant(value=constants[0].value,
+                                            num_neurons=dims,
+                                            **_layer_kwargs(l))
+            graph.replace(l, new)
+            changed = True
+            continue
+
+        if not _is_operator_layer(l):
+            continue
+        ops = _op_names(l)
+
+        # Element-wise operators on a constant
+        if (len(l.parents) == 1 and constants
+            and all(op in _FOLDABLE_UNARY_OPERATORS for op in ops)):
+            value = constants[0].value
+            try:
+                for op, name in zip(l.ops, ops):
+                    value = float(_FOLDABLE_UNARY_OPERATORS[name](value, op))
+            except (ValueError, ZeroDivisionError, OverflowError):
+                continue
+            new = lbann.core.layer.Constant(
+                value=value,
+                num_neurons=constants[0].num_neurons,
+                **_layer_kwargs(l))
+            graph.replace(l, new)
+            changed = True
+            continue
+
+        if (len(ops) != 1 or ops[0] not in _FOLDABLE_BINARY_OPERATORS
+            or len(l.parents) != 2 or not constants):
+            continue
+        x, y = l.parents
+
+        # Arithmetic between two constants
+        if len(constants) == 2:
+            if _dims(x.num_neurons) != _dims(y.num_neurons):
+                continue
+            try:
+                value = float(
+                    _FOLDABLE_BINARY_OPERATORS[ops[0]](x.value, y.value))
+            except (ZeroDivisionError, OverflowError):
+                continue
+            new = lbann.core.layer.Constant(value=value,
+                                            num_neurons=x.num_neurons,
+                                            **_layer_kwargs(l))
+            graph.replace(l, new)
+            changed = True
+            continue
+
+        # Arithmetic between a tensor and a constant
+        import lbann.core.operator_layers as op_layers
+        kwargs = _layer_kwargs(l)
+        tensor, c = (y, x.value) if x in constants else (x, y.value)
+        if ops[0] == 'Add':
+            new = op_layers.AddConstant(constant=c, **kwargs)
+        elif ops[0] == 'Multiply':
+            new = op_layers.Scale(constant=c, **kwargs)
+        elif ops[0] == 'Subtract' and tensor is x:
+            new = op_layers.SubtractConstant(constant=c, **kwargs)
+        elif ops[0] == 'Subtract':
+            new = op_layers.ConstantSubtract(constant=c, **kwargs)
+        elif ops[0] == 'Divide' and tensor is x and c != 0:
+            new = op_layers.Scale(constant=1 / c, **kwargs)
+        else:
+            continue
+        graph.replace(l, new, parents=[tensor])
+        changed = True
+    return changed
+
+
+def _group_elementwise_chains(graph):
+    """Append the operators of an element-wise child to its parent"""
+    changed = False
+    for l in graph.layers:
+        if (not _is_operator_layer(l)
+            or len(l.children) != 1
+            or graph.is_fixed(l)):
+            continue
+        child = l.children[0]
+        if (not _is_operator_layer(child)
+            or child.parents != [l]
+            or graph.is_fixed(child)
+            or not _same_placement(l, child)
+            or not all(op in _UNARY_OPERATORS for op in _op_names(child))):
+            continue
+        l.ops = list(l.ops) + list(child.ops)
+        l.children = child.children
+        for c in l.children:
+            c.parents = [l if p is child else p for p in c.parents]
+        child.parents, child.children = [], []
+        changed = True
+    return changed
+
+
+def _remove_dead_layers(graph):
+    """Remove layers that no output depends on"""
+
+    # Layers that outputs depend on, through inputs or hint layers
+    live = set()
+    stack = [l for l in graph.layers
+             if l in graph.outputs
+             or l.name in graph.keep_names
+             or _type_name(l) == 'Input']
+    while stack:
+        while stack:
+            l = stack.pop()
+            if l not in live:
+                live.add(l)
+                stack.extend(l.parents)
+                if l.hint_layer is not None:
+                    stack.append(l.hint_layer)
+
+        # Children of multi-output layers cannot be dropped
+        stack = [l for l in graph.layers
+                 if l not in live
+                 and any(p in live
+                         and _type_name(p) in _PER_CHILD_OUTPUT_LAYERS
+                         for p in l.parents)]
+
+    changed = False
+    for l in graph.layers:
+        if l in live:
+            continue
+        for p in l.parents:
+            if p in live:
+                p.children = [c for c in p.children if c is not l]
+        l.parents, l.children = [], []
+        changed = True
+    return changed
+
+
+def optimize_graph(layers, outputs=None, keep_names=()):
+    """Simplify a layer graph before it is exported.
+
+    Args:
+        layers (Layer or Iterable of Layer): Node(s) in layer graph.
+        outputs (Iterable of Layer, optional): Layers whose values are
+            used outside the graph, e.g. by the objective function or
+            metrics. Default is every layer without children.
+        keep_names (Iterable of str, optional): Names of layers that
+            are referred to by name, e.g. in callbacks, and must not
+            be rewritten.
+
+    Returns:
+        list of Layer: Remaining layers, in a topological order.
+
+    """
+    graph = _Graph(layers, outputs, keep_names)
+    passes = (_remove_dead_layers, _fold_constants, _remove_identities,
+              _collapse_reshapes, _group_elementwise_chains)
+    changed = True
+    while changed:
+        changed = False
+        for optimization in passes:
+            if optimization(graph):
+                changed = True
+                graph.refresh()
+    return graph.layers
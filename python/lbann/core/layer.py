@@ -22,6 +22,8 @@ class Layer(abc.ABC):
         datatype (lbann.DataType, optional): Data type used for activations and weights.
         hint_layer (Layer, optional): Hint for output dimensions.
         parallel_strategy (dictionary, optional): Data partitioning scheme.
+        checkpoint (bool, optional): Recompute the output during
+            backprop instead of keeping it from forward prop.
 
     """
 
@@ -38,7 +40,8 @@ class Layer(abc.ABC):
                  datatype=None,
                  hint_layer=None,
                  grid_tag=None,
-                 parallel_strategy=None):
+                 parallel_strategy=None,
+                 checkpoint=False):
         Layer.global_count += 1
         self.parents = []
         self.children = []
@@ -50,6 +53,7 @@ class Layer(abc.ABC):
         self.hint_layer = hint_layer
         self.grid_tag = { 'value': grid_tag } if grid_tag is not None else {}
         self.parallel_strategy = parallel_strategy if parallel_strategy else {}
+        self.checkpoint = checkpoint
 
         # Initialize parents, children, and weights
         for arg in args:
@@ -82,6 +86,8 @@ class Layer(abc.ABC):
             lbann.core.util.set_protobuf_message(proto.parallel_strategy,
                                                  **self.parallel_strategy)
             proto.parallel_strategy.SetInParent()
+        if self.checkpoint:
+            proto.checkpoint = self.checkpoint
         return proto
 
     def add_parent(self, parent):
@@ -118,12 +124,13 @@ if layers_pb2:
         skip_fields = set([
             'name', 'parents', 'children', 'data_layout', 'device_allocation',
             'datatype', 'weights', 'freeze', 'hint_layer', 'grid_tag',
-            'parallel_strategy', 'top', 'bottom', 'type', 'motif_layer']),
+            'parallel_strategy', 'checkpoint', 'top', 'bottom', 'type',
+            'motif_layer']),
         base_class = Layer,
         base_kwargs = set([
             'parents', 'children', 'weights',
             'name', 'device', 'data_layout', 'datatype', 'hint_layer', 'grid_tag',
-            'parallel_strategy']),
+            'parallel_strategy', 'checkpoint']),
         base_has_export_proto = True)
     for c in classes:
         globals()[c.__name__] = c
@@ -32,18 +32,23 @@ class Metric(BaseMetric):
 
 class ExecutableMetric(BaseMetric):
     """Metric that takes its value from a printout of a binary executable.
+
+    If ``asynchronous`` is set, the executable runs in the background
+    once per epoch or evaluation and training does not wait for it.
     """
 
     def __init__(self,
                  name: str,
                  filename: str,
-                 other_args: Union[str, List[str]] = ''):
+                 other_args: Union[str, List[str]] = '',
+                 asynchronous: bool = False):
         self.name = name
         self.filename = filename
         if isinstance(other_args, str):
             self.other_args = other_args
         else:
             self.other_args = " ".join(other_args)
+        self.asynchronous = asynchronous
 
     def export_proto(self):
         """Construct and return a protobuf message."""
@@ -51,22 +56,28 @@ class ExecutableMetric(BaseMetric):
         proto.executable_metric.name = self.name
         proto.executable_metric.filename = self.filename
         proto.executable_metric.other_args = self.other_args
+        proto.executable_metric.asynchronous = self.asynchronous
         return proto
 
 
 class PythonMetric(BaseMetric):
     """Metric that takes its value from a result of a Python function.
+
+    If ``asynchronous`` is set, the function runs on a side thread once
+    per epoch or evaluation and training does not wait for it.
     """
 
     def __init__(self,
                  name: str,
                  module: str,
                  module_dir: str,
-                 function: str = 'evaluate'):
+                 function: str = 'evaluate',
+                 asynchronous: bool = False):
         self.name = name
         self.module = module
         self.module_dir = module_dir
         self.function = function
+        self.asynchronous = asynchronous
 
     def export_proto(self):
         """Construct and return a protobuf message."""
@@ -75,4 +86,5 @@ class PythonMetric(BaseMetric):
         proto.python_metric.module = self.module
         proto.python_metric.module_dir = self.module_dir
         proto.python_metric.function = self.function
+        proto.python_metric.asynchronous = self.asynchronous
         return proto
@@ -6,6 +6,7 @@ from lbann import model_pb2
 from lbann.util import make_iterable
 import lbann.core.layer
 import lbann.core.objective_function
+import lbann.core.graph_optimization
 from enum import Enum
 
 class SubgraphCommunication(Enum):
@@ -29,6 +30,13 @@ class AmpOptions(NamedTuple):
     growth_factor: Optional[float] = None
     backoff_factor: Optional[float] = None
     growth_interval: Optional[int] = None
+    loss_scaling: Optional[bool] = None
+
+
+class WeightsPrefetchOptions(NamedTuple):
+    """Options for gathering sharded weights ahead of use."""
+    lookahead: int = 1
+    max_bytes: Optional[int] = None
 
 
 class Model:
@@ -42,7 +50,17 @@ class Model:
                  subgraph_communication=SubgraphCommunication.PT2PT,
                  subgraph_topology=False,
                  subgraph_num_common_resources=0,
-                 amp: AmpOptions = None):
+                 amp: AmpOptions = None,
+                 weights_prefetch: WeightsPrefetchOptions = None,
+                 plan_activation_memory: bool = False,
+                 capture_gpu_graphs: bool = False,
+                 layer_streams: int = 1,
+                 fuse_layers: bool = False,
+                 multi_tensor_optimizer_step: bool = False,
+                 clip_gradient_norm: float = 0.0,
+                 flat_weights: bool = False,
+                 pipeline_parallelism: bool = False,
+                 optimize_graph: bool = False):
 
         # Scalar fields
         self.epochs = epochs
@@ -52,11 +70,6 @@ class Model:
         # Get connected layers
         self.layers = list(lbann.core.layer.traverse_layer_graph(layers))
 
-        # Get weights associated with layers
-        self.weights = set(make_iterable(weights))
-        for l in self.layers:
-            self.weights.update(l.weights)
-
         # Construct objective function if needed
         obj_type = lbann.core.objective_function.ObjectiveFunction
         if isinstance(objective_function, obj_type):
@@ -73,9 +86,69 @@ class Model:
         self.subgraph_topology = subgraph_topology
         self.subgraph_num_common_resources = subgraph_num_common_resources
 
+        # Simplify the layer graph before it is exported. Layers that
+        # the objective function, metrics and callbacks do not depend
+        # on are removed.
+        if optimize_graph:
+            self.layers = lbann.core.graph_optimization.optimize_graph(
+                self.layers,
+                outputs=self._output_layers(),
+                keep_names=self._layer_names_in_callbacks())
+
+        # Get weights associated with layers
+        self.weights = set(make_iterable(weights))
+        for l in self.layers:
+            self.weights.update(l.weights)
+
         # AMP.
         self.amp = amp
 
+        # Sharded weights prefetching.
+        self.weights_prefetch = weights_prefetch
+
+        # Activation memory planning.
+        self.plan_activation_memory = plan_activation_memory
+
+        # Forward prop replay from GPU graphs.
+        self.capture_gpu_graphs = capture_gpu_graphs
+
+        # GPU streams for independent layers.
+        self.layer_streams = layer_streams
+
+        # Fusion of layers into their parent layer.
+        self.fuse_layers = fuse_layers
+
+        # Multi-tensor optimizer steps.
+        self.multi_tensor_optimizer_step = multi_tensor_optimizer_step
+
+        # Global gradient norm clipping in the optimizer step.
+        self.clip_gradient_norm = clip_gradient_norm
+
+        # Weights packed in contiguous buffers.
+        self.flat_weights = flat_weights
+
+        # Layer-parallel sub-grids run as pipeline stages.
+        self.pipeline_parallelism = pipeline_parallelism
+
+    def _output_layers(self):
+        """Layers used by the objective function and metrics."""
+        layers = [t.layer for t in self.objective_function.terms
+                  if isinstance(t, lbann.core.objective_function.LayerTerm)]
+        layers.extend(m.layer for m in self.metrics)
+        return layers
+
+    def _layer_names_in_callbacks(self):
+        """Names that callbacks may use to refer to layers."""
+        names = set()
+        for c in self.callbacks:
+            for value in vars(c).values():
+                for v in make_iterable(value):
+                    if isinstance(v, lbann.core.layer.Layer):
+                        names.add(v.name)
+                    elif isinstance(v, str):
+                        names.update(v.split())
+        return names
+
     def export_proto(self):
         """Construct and return a protobuf message."""
         # Initialize protobuf message
@@ -106,6 +179,23 @@ class Model:
                 model.amp.backoff_factor = self.amp.backoff_factor
             if self.amp.growth_interval is not None:
                 model.amp.growth_interval = self.amp.growth_interval
+            if self.amp.loss_scaling is not None:
+                model.amp.disable_loss_scaling = not self.amp.loss_scaling
+
+        # Add sharded weights prefetching options:
+        if self.weights_prefetch is not None:
+            model.weights_prefetch.lookahead = self.weights_prefetch.lookahead
+            if self.weights_prefetch.max_bytes is not None:
+                model.weights_prefetch.max_bytes = self.weights_prefetch.max_bytes
+
+        model.plan_activation_memory = self.plan_activation_memory
+        model.capture_gpu_graphs = self.capture_gpu_graphs
+        model.layer_streams = self.layer_streams
+        model.fuse_layers = self.fuse_layers
+        model.multi_tensor_optimizer_step = self.multi_tensor_optimizer_step
+        model.clip_gradient_norm = self.clip_gradient_norm
+        model.flat_weights = self.flat_weights
+        model.pipeline_parallelism = self.pipeline_parallelism
 
         return model
 
@@ -11,6 +11,8 @@ class Trainer:
                  random_seed=None,
                  serialize_io=None,
                  training_algo=None,
+                 gradient_fusion_bucket_size=None,
+                 hierarchical_gradient_allreduce=None,
                  callbacks=[]):
         self.name = name
         self.random_seed = random_seed
@@ -18,6 +20,8 @@ class Trainer:
         self.mini_batch_size = mini_batch_size
         self.hydrogen_block_size = None
         self.training_algo = training_algo
+        self.gradient_fusion_bucket_size = gradient_fusion_bucket_size
+        self.hierarchical_gradient_allreduce = hierarchical_gradient_allreduce
         # Callbacks
         self.callbacks = make_iterable(callbacks)
 
@@ -35,6 +39,10 @@ class Trainer:
             trainer.hydrogen_block_size = self.hydrogen_block_size
         if self.serialize_io is not None:
             trainer.serialize_io = self.serialize_io
+        if self.gradient_fusion_bucket_size is not None:
+            trainer.gradient_fusion_bucket_size = self.gradient_fusion_bucket_size
+        if self.hierarchical_gradient_allreduce is not None:
+            trainer.hierarchical_gradient_allreduce = self.hierarchical_gradient_allreduce
         if self.training_algo is not None:
             trainer.training_algorithm.CopyFrom(self.training_algo.export_proto())
 
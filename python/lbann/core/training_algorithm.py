@@ -102,7 +102,9 @@ class BatchedIterativeOptimizer(TrainingAlgorithm):
             return msg
 
     def __init__(self, name: str, num_iterations: int = 0, epoch_count: int = 0,
-                 max_seconds: float = 0.):
+                 max_seconds: float = 0.,
+                 gradient_accumulation_steps: int = 1,
+                 overlap_validation: bool = False):
         """Construct a new BatchedIterativeOptimizer instance.
 
         Args:
@@ -110,16 +112,28 @@ class BatchedIterativeOptimizer(TrainingAlgorithm):
             num_iterations: Number of minibatches.
             epoch_count: Number of epochs.
             max_seconds: Maximum training duration (seconds)
+            gradient_accumulation_steps: Number of minibatches whose
+                gradients are accumulated before each optimization
+                step.
+            overlap_validation: Validate a snapshot of the weights
+                during the next epoch's training instead of between
+                epochs.
         """
         self.name = name
         self.stopping = self.StoppingCriteria(batch_count=num_iterations,
                                               epoch_count=epoch_count,
                                               seconds=max_seconds)
+        self.gradient_accumulation_steps = gradient_accumulation_steps
+        self.overlap_validation = overlap_validation
 
     def do_export_proto(self):
         """Get a protobuf representation of this object."""
         params = AlgoProto.SGD()
         params.stopping_criteria.CopyFrom(self.stopping.export_proto())
+        if self.gradient_accumulation_steps > 1:
+            params.gradient_accumulation_steps = self.gradient_accumulation_steps
+        if self.overlap_validation:
+            params.overlap_validation = True
         return params
 
 class MetaLearningStrategy:
@@ -186,6 +200,73 @@ class LTFB(TrainingAlgorithm):
         params.local_training_algorithm.CopyFrom(self.local_algo.export_proto())
         return params
 
+class LocalSGD(TrainingAlgorithm):
+    """Local SGD with periodic weight averaging across trainers.
+
+    Each trainer applies a local training algorithm on its own and,
+    at the completion of local training, the weights are averaged
+    across trainers. This replaces a gradient allreduce across
+    trainers every step with one weight average per round. Setting
+    an outer learning rate below 1 and/or outer momentum gives the
+    DiLoCo outer optimizer.
+    """
+
+    class StoppingCriteria:
+        """Stopping criteria for local SGD"""
+        def __init__(self, rounds: int = 1):
+            """Construct a new local SGD stopping criteria object
+
+            Args:
+                rounds:
+                  The number of averaging rounds.
+            """
+            self.rounds = rounds
+
+        def export_proto(self):
+            """Get a protobuf representation of this object."""
+            msg = AlgoProto.LocalSGD.TerminationCriteria()
+            msg.max_rounds = self.rounds
+            return msg
+
+    def __init__(self, name: str, local_algo: TrainingAlgorithm,
+                 rounds: int = 1,
+                 outer_learning_rate: float = 1.0,
+                 outer_momentum: float = 0.0,
+                 outer_nesterov: bool = False):
+        """Construct a new local SGD algorithm.
+
+        Args:
+            name:
+              A user-defined name to identify this object in logs.
+            local_algo:
+              The trainer-local algorithm to apply each round. Its
+              stopping criteria sets the number of local steps.
+            rounds:
+              The number of averaging rounds.
+            outer_learning_rate:
+              Step size applied to the averaged weight change.
+            outer_momentum:
+              Momentum applied to the averaged weight change.
+            outer_nesterov:
+              Whether the outer momentum is Nesterov momentum.
+        """
+        self.name = name
+        self.local_algo = local_algo
+        self.stopping = self.StoppingCriteria(rounds=rounds)
+        self.outer_learning_rate = outer_learning_rate
+        self.outer_momentum = outer_momentum
+        self.outer_nesterov = outer_nesterov
+
+    def do_export_proto(self):
+        """Get a protobuf representation of this object."""
+        params = AlgoProto.LocalSGD()
+        params.stopping_criteria.CopyFrom(self.stopping.export_proto())
+        params.local_training_algorithm.CopyFrom(self.local_algo.export_proto())
+        params.outer_learning_rate = self.outer_learning_rate
+        params.outer_momentum = self.outer_momentum
+        params.outer_nesterov = self.outer_nesterov
+        return params
+
 class MutationStrategy:
     """The strategy for mutation after a tournament in LTFB.
        
@@ -284,12 +365,21 @@ class RandomPairwiseExchange(MetaLearningStrategy):
            happen to work, this essentially implies that the model
            topology should be homogenous across all trainers.
 
+           With `overlap_exchange=True`, the weights are copied to
+           host buffers and streamed to the partner in chunks while
+           local training continues. The tournament is then decided
+           at the next metaround, against the partner's weights from
+           the previous one.
+
         """
 
         def __init__(self, strategy: str = "checkpoint_binary",
                      weights_names: list[str] = [],
                      exchange_hyperparameters: bool = False,
-                     checkpoint_dir: str = None):
+                     checkpoint_dir: str = None,
+                     overlap_exchange: bool = False,
+                     chunk_size: int = 0,
+                     bf16_transfer: bool = False):
             """Construct a new exchange strategy.
 
             Args:
@@ -302,11 +392,25 @@ class RandomPairwiseExchange(MetaLearningStrategy):
                   the "sendrecv_weights" strategy.
                 checkpoint_dir: A path to a directory for storing the
                   checkpoint files. Only applies to "checkpoint_file".
+                overlap_exchange:
+                  If True, overlap the exchange with local training and
+                  apply the tournament at the next metaround. Only
+                  applies to the "sendrecv_weights" strategy.
+                chunk_size:
+                  Maximum number of elements per message when
+                  overlapping the exchange (0 for no limit).
+                bf16_transfer:
+                  If True, round the exchanged weights and optimizer
+                  state to bfloat16 on the wire. Only applies to the
+                  "sendrecv_weights" strategy.
             """
             self.strategy = strategy
             self.exchange_hyperparameters = exchange_hyperparameters
             self.weights_names = make_iterable(weights_names)
             self.checkpoint_dir = checkpoint_dir
+            self.overlap_exchange = overlap_exchange
+            self.chunk_size = chunk_size
+            self.bf16_transfer = bf16_transfer
 
         def export_proto(self):
             """Get a protobuf representation of this object."""
@@ -324,6 +428,9 @@ class RandomPairwiseExchange(MetaLearningStrategy):
                     raise Exception("Must provide checkpoint dir")
             elif self.strategy == "sendrecv_weights":
                 msg.sendrecv_weights.exchange_hyperparameters = self.exchange_hyperparameters
+                msg.sendrecv_weights.overlap_exchange = self.overlap_exchange
+                msg.sendrecv_weights.chunk_size = self.chunk_size
+                msg.sendrecv_weights.bf16_transfer = self.bf16_transfer
             else:
                 raise ValueError("Unknown strategy")
             return msg
@@ -331,7 +438,9 @@ class RandomPairwiseExchange(MetaLearningStrategy):
     def __init__(self,
                  metric_strategies: dict[str,int] = {},
                  exchange_strategy = ExchangeStrategy(),
-                 mutation_strategy = MutationStrategy()):
+                 mutation_strategy = MutationStrategy(),
+                 reuse_partner_scores: bool = False,
+                 evaluation_batches: int = 0):
         """Construct a new RandomPairwiseExchange metalearning strategy.
 
         Args:
@@ -342,11 +451,20 @@ class RandomPairwiseExchange(MetaLearningStrategy):
               The algorithm used for exchanging models.
             mutation_strategy:
               The algorithm used for mutating models.
+            reuse_partner_scores:
+              If True, use the scores the partner computed for its own
+              model instead of re-evaluating it, as long as the
+              received weights match the ones it scored.
+            evaluation_batches:
+              Number of tournament mini-batches to evaluate each model
+              on (0 for the full tournament data set).
         """
 
         self.metric_strategies = metric_strategies
         self.exchange_strategy = exchange_strategy
         self.mutation_strategy = mutation_strategy
+        self.reuse_partner_scores = reuse_partner_scores
+        self.evaluation_batches = evaluation_batches
 
     def export_proto(self):
         """Get a protobuf representation of this object."""
@@ -357,6 +475,8 @@ class RandomPairwiseExchange(MetaLearningStrategy):
 
         msg.exchange_strategy.CopyFrom(self.exchange_strategy.export_proto())
         msg.mutation_strategy.CopyFrom(self.mutation_strategy.export_proto())
+        msg.reuse_partner_scores = self.reuse_partner_scores
+        msg.evaluation_batches = self.evaluation_batches
         return msg
 
 class TruncationSelectionExchange(MetaLearningStrategy):
@@ -416,12 +536,14 @@ class RegularizedEvolution(MetaLearningStrategy):
                  metric_name,
                  metric_strategy,
                  mutation_strategy = MutationStrategy(),
-                 sample_size = 0):
+                 sample_size = 0,
+                 compression_level: int = 0):
         
         self.metric_name = metric_name
         self.metric_strategy = metric_strategy
         self.mutation_strategy = mutation_strategy
         self.sample_size = sample_size
+        self.compression_level = compression_level
 
     def export_proto(self):
         """Get a protobuf representation of this object."""
@@ -432,6 +554,7 @@ class RegularizedEvolution(MetaLearningStrategy):
         msg.metric_strategy = self.metric_strategy
         msg.mutation_strategy.CopyFrom(self.mutation_strategy.export_proto())
         msg.sample_size = self.sample_size
+        msg.compression_level = self.compression_level
         return msg 
 
 class KFAC(TrainingAlgorithm):
@@ -31,6 +31,13 @@ class ShardingStrategy(Enum):
         GRID_COLS = 2 # Sharded across the process grid columns (STAR x MR)
 
 
+class GradientCompression(Enum):
+        NO_COMPRESSION = 0 # Allreduce at full precision
+        FP16_CAST = 1      # Allreduce a half-precision copy
+        TOP_K = 2          # Allgather the largest-magnitude entries
+        POWER_SGD = 3      # Allreduce the factors of a low-rank approximation
+
+
 class Weights:
     """Trainable parameters for neural network."""
 
@@ -38,7 +45,9 @@ class Weights:
 
     def __init__(self, initializer=None, optimizer=None, name=None,
                  datatype=None, sharded=None,
-                 sharding_strategy: Optional[ShardingStrategy] = None):
+                 sharding_strategy: Optional[ShardingStrategy] = None,
+                 gradient_compression: Optional[GradientCompression] = None,
+                 topk_fraction=None, powersgd_rank=None):
         Weights.global_count += 1
         self.name = name if name else 'weights{0}'.format(Weights.global_count)
         self.initializer = initializer
@@ -46,6 +55,9 @@ class Weights:
         self.datatype = datatype
         self.sharded = sharded
         self.sharding_strategy = sharding_strategy
+        self.gradient_compression = gradient_compression
+        self.topk_fraction = topk_fraction
+        self.powersgd_rank = powersgd_rank
 
     def export_proto(self):
         """Construct and return a protobuf message."""
@@ -72,4 +84,11 @@ class Weights:
         if self.sharding_strategy is not None:
             proto.sharding_strategy = self.sharding_strategy.value
 
+        if self.gradient_compression is not None:
+            proto.gradient_compression = self.gradient_compression.value
+        if self.topk_fraction is not None:
+            proto.topk_fraction = self.topk_fraction
+        if self.powersgd_rank is not None:
+            proto.powersgd_rank = self.powersgd_rank
+
         return proto
@@ -31,6 +31,13 @@ class MultiheadAttention(Module):
             probability matrix before softmax. If None, does not apply.
         positional_encoding (SequenceEncoding): An optional positional encoding
             object that may apply on each input.
+        fused (bool): If True, computes all heads with a single fused
+            scaled dot-product attention layer that never materializes
+            the attention matrix. Incompatible with dropout, attention
+            bias, subgraph parallelism, and additive masks.
+        causal (bool): If True, each query only attends to keys at the
+            same or earlier sequence positions. Only supported with
+            `fused`; use an additive mask otherwise.
         name (str): Default name is in the form
             'multiheadattention<index>'.
 
@@ -47,6 +54,8 @@ class MultiheadAttention(Module):
                  subgraph_branches: int = 0,
                  bias: Optional[lbann.Layer] = None,
                  positional_encoding: Optional[SequenceEncoding] = None,
+                 fused: bool = False,
+                 causal: bool = False,
                  name: str = None):
         super().__init__()
         MultiheadAttention.global_count += 1
@@ -58,6 +67,14 @@ class MultiheadAttention(Module):
         self.dropout = dropout
         self.bias = bias
         self.positional_encoding = positional_encoding
+        self.fused = fused
+        self.causal = causal
+        if fused and (dropout > 0 or bias is not None
+                      or subgraph_branches > 0):
+            raise ValueError('Fused attention does not support dropout, '
+                             'attention bias, or subgraph parallelism')
+        if causal and not fused:
+            raise ValueError('Causal attention requires fused attention')
 
         # Self-attention is a special case in which we can stack
         # query/key/value weights
@@ -195,7 +212,20 @@ class MultiheadAttention(Module):
             queries_fc, keys_fc, values_fc = self.positional_encoding.apply_layer(
                 queries_fc, keys_fc, values_fc, seqlen, **extra_kwargs)
 
-        if self.separate_heads:
+        if self.fused:
+            if mask is not None:
+                raise ValueError('Fused attention does not support '
+                                 'additive masks')
+            attentions = lbann.ScaledDotProductAttention(
+                queries_fc,
+                keys_fc,
+                values_fc,
+                num_heads=self.num_heads,
+                causal=self.causal,
+                name=f'{name}_all_heads',
+                **extra_kwargs,
+            )
+        elif self.separate_heads:
             attentions = self.dot_product_attn_separate_heads(
                 name, queries_fc, keys_fc, values_fc, mask, **extra_kwargs)
         else:
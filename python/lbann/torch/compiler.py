@@ -44,6 +44,7 @@ except (ModuleNotFoundError, ImportError):
 import functools
 import inspect
 import lbann
+from lbann.core import graph_optimization
 from lbann.torch import converters, opaque, lowering
 from lbann.torch.helpers import LBANNGraph
 from torch import nn, _dynamo as dynamo
@@ -55,6 +56,7 @@ def compile(module_or_function: Union[nn.Module, Callable[..., Any]],
             *sample_args,
             trace: bool = False,
             with_weights: bool = True,
+            optimize: bool = False,
             **sample_kwargs) -> List[lbann.Layer]:
     """
     Compiles the given PyTorch module or function into an LBANN graph.
@@ -72,6 +74,9 @@ def compile(module_or_function: Union[nn.Module, Callable[..., Any]],
     :param with_weights: If True (default), also stores the parameters of
                          the given model as constant initializers of the LBANN
                          graph's weights.
+    :param optimize: If True, simplifies the resulting graph with
+                     ``lbann.core.graph_optimization`` (e.g., folding constants
+                     and removing identities and redundant reshapes).
     :param sample_kwargs: Named arguments to pass in for compilation. Note that
                           this is necessary to compile ahead-of-time (without
                           tracing).
@@ -82,11 +87,15 @@ def compile(module_or_function: Union[nn.Module, Callable[..., Any]],
                          'compilation')
 
     if trace:
-        return _trace(module_or_function, sample_args, sample_kwargs,
-                      with_weights)
+        graph = _trace(module_or_function, sample_args, sample_kwargs,
+                       with_weights)
+    else:
+        cmod = lazy_compile(module_or_function)
+        graph = cmod(*tuple(sample_kwargs.values()))
 
-    cmod = lazy_compile(module_or_function)
-    return cmod(*tuple(sample_kwargs.values()))
+    if optimize:
+        graph = graph_optimization.optimize_graph(graph)
+    return graph
 
 
 def _trace(f, example_args, example_kwargs, with_weights) -> List[lbann.Layer]:
@@ -160,6 +160,12 @@ def replace_fx(gm: fx.GraphModule,
                     **{k: repl(v)
                        for k, v in node.kwargs.items()})
 
+                # Modules with several outputs (e.g., attention) return a
+                # tuple, whose first entry gets the module weights
+                layer = replaced[node]
+                if isinstance(layer, tuple):
+                    layer = layer[0]
+
                 # Convert weights
                 if with_weights:
                     if type(submodule) not in converters.module_parameters:
@@ -168,10 +174,22 @@ def replace_fx(gm: fx.GraphModule,
                                           f'module type "{type(submodule)}"!')
                     else:
                         converters.module_parameters[type(submodule)](
-                            submodule, replaced[node])
-
-                replaced[node].name = node.name
-                replaced[node].shape = node.meta['val'].shape
+                            submodule, layer)
+
+                if isinstance(replaced[node], tuple):
+                    # Unpack outputs into the getitem nodes that use them
+                    for user in node.users.keys():
+                        output = replaced[node][user.args[1]]
+                        if output is None:
+                            raise NotImplementedError(
+                                f'Output {user.args[1]} of module type '
+                                f'"{type(submodule)}" is not supported')
+                        replaced[user] = output
+                        replaced[user].name = user.name
+                        replaced[user].shape = user.meta['val'].shape
+                else:
+                    replaced[node].name = node.name
+                    replaced[node].shape = node.meta['val'].shape
                 rep.add(node.stack_trace)
             else:
                 raise NameError(
@@ -426,6 +444,13 @@ def partial_lowering(gm: fx.GraphModule) -> fx.GraphModule:
                         and str(user.target) == '<built-in function getitem>')
                 skip_nodes.add(user)
             decompose = False
+        if (node.op == 'call_module' and not decompose
+                and isinstance(node.meta.get('val'), (tuple, list))):
+            # Special case for modules with several outputs + getitem
+            for user in node.users.keys():
+                assert (user.op == 'call_function'
+                        and str(user.target) == '<built-in function getitem>')
+                skip_nodes.add(user)
         # End of lowering decision
 
         if decompose:
@@ -30,6 +30,7 @@ Specific function converters for the LBANN PyTorch frontend.
 
 import functools
 import lbann
+import math
 from lbann.torch.converters import register_function
 import torch.nn as nn
 import warnings
@@ -315,3 +316,68 @@ def zeros(size, **kwargs):
 def addmm(input, mat1, mat2, *, beta=1, alpha=1):
     rhs = lbann.Scale(lbann.MatMul(mat1, mat2), constant=alpha)
     return lbann.Add(lbann.Scale(input, constant=beta), rhs)
+
+
+@register_function('<built-in function gelu>')
+@register_function('torch._C._nn.gelu')
+def gelu(x, approximate='none'):
+    if approximate == 'tanh':
+        return lbann.Gelu(x)
+
+    # Exact GELU, x * Phi(x). The element-wise operators computing Phi form
+    # one chain that is fused into a single operator layer.
+    phi = lbann.Scale(x, constant=1 / math.sqrt(2))
+    phi = lbann.Erf(phi)
+    phi = lbann.AddConstant(phi, constant=1)
+    phi = lbann.Scale(phi, constant=0.5)
+    return lbann.Multiply(x, phi)
+
+
+@register_function('<built-in function scaled_dot_product_attention>')
+@register_function('torch._C._nn.scaled_dot_product_attention')
+@register_function('aten.scaled_dot_product_attention.default')
+def scaled_dot_product_attention(query,
+                                 key,
+                                 value,
+                                 attn_mask=None,
+                                 dropout_p=0.0,
+                                 is_causal=False,
+                                 scale=None,
+                                 **kwargs):
+    """
+    Converts attention to the fused ``ScaledDotProductAttention`` layer.
+    Inputs are either sequences (batch x sequence x embedding) or have a
+    separate head dimension (batch x heads x sequence x head size).
+    """
+    if attn_mask is not None:
+        raise NotImplementedError('Fused attention does not support '
+                                  'attention masks (use is_causal)')
+    if dropout_p > 0:
+        raise NotImplementedError('Fused attention does not support dropout')
+
+    if len(query.shape) == 3:
+        return lbann.ScaledDotProductAttention(query,
+                                               key,
+                                               value,
+                                               num_heads=1,
+                                               causal=is_causal,
+                                               scale=scale or 0.0)
+    if len(query.shape) != 4:
+        raise NotImplementedError('Attention expects 3D or 4D tensors')
+
+    # Move heads into the embedding dimension: (H, L, D) -> (L, H*D)
+    def merge_heads(x):
+        _, heads, seqlen, head_dim = x.shape
+        return lbann.Reshape(lbann.TensorPermute(x, axes=[1, 0, 2]),
+                             dims=[seqlen, heads * head_dim])
+
+    _, heads, seqlen, _ = query.shape
+    value_head_dim = value.shape[-1]
+    attn = lbann.ScaledDotProductAttention(merge_heads(query),
+                                           merge_heads(key),
+                                           merge_heads(value),
+                                           num_heads=heads,
+                                           causal=is_causal,
+                                           scale=scale or 0.0)
+    attn = lbann.Reshape(attn, dims=[seqlen, heads, value_head_dim])
+    return lbann.TensorPermute(attn, axes=[1, 0, 2])
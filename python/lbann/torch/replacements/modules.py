@@ -29,11 +29,13 @@ Specific PyTorch Module converters for the LBANN PyTorch frontend.
 """
 import functools
 import lbann
+from lbann.modules import MultiheadAttention
 from lbann.torch.converters import (register_module,
                                     register_module_weight_converter,
                                     register_opaque_shape_inference)
 import torch
 import torch.nn as nn
+from lbann.torch.replacements.functions import gelu
 
 
 def convnd_layer(c, dims: int, args, kwargs):
@@ -184,7 +186,59 @@ def embedding_impl(mod: nn.Embedding, x, *args, **kwargs):
 @register_module(nn.LayerNorm)
 def ln_impl(mod: nn.LayerNorm, x, *args, **kwargs):
     return lbann.LayerNorm(x, epsilon=mod.eps,
-                           start_dim=-len(mod.normalized_shape))
+                           start_dim=-len(mod.normalized_shape),
+                           scale=mod.weight is not None,
+                           bias=getattr(mod, 'bias', None) is not None)
+
+
+@register_module(nn.GELU)
+def gelu_impl(mod: nn.GELU, x):
+    return gelu(x, approximate=mod.approximate)
+
+
+@register_module(nn.MultiheadAttention)
+def mha_impl(mod: nn.MultiheadAttention,
+             query,
+             key,
+             value,
+             key_padding_mask=None,
+             need_weights=True,
+             attn_mask=None,
+             average_attn_weights=True,
+             is_causal=False):
+    """
+    Converts multi-head attention to ``lbann.modules.MultiheadAttention``,
+    which runs all heads in the fused ``ScaledDotProductAttention`` layer
+    when there is no dropout. Returns the attention output and ``None`` in
+    place of the attention weights, which are never computed.
+    """
+    if not mod.batch_first:
+        raise NotImplementedError('Only batch-first multi-head attention '
+                                  'can be converted to LBANN')
+    if mod.bias_k is not None or mod.add_zero_attn:
+        raise NotImplementedError('Key/value biases and zero attention are '
+                                  'not supported in LBANN')
+    if key_padding_mask is not None or (attn_mask is not None
+                                        and not is_causal):
+        raise NotImplementedError('Attention masks are not supported in '
+                                  'LBANN (use is_causal)')
+    fused = mod.dropout == 0
+    if is_causal and not fused:
+        raise NotImplementedError('Causal attention with dropout is not '
+                                  'supported in LBANN')
+
+    attention = MultiheadAttention(mod.embed_dim,
+                                   mod.num_heads,
+                                   self_attention=(query is key
+                                                   and key is value),
+                                   dropout=mod.dropout,
+                                   fused=fused,
+                                   causal=is_causal)
+    output = attention(query, key, value)
+
+    # Keep the LBANN module for the weight converter
+    output.lbann_module = attention
+    return output, None
 
 
 @register_module([nn.BatchNorm1d, nn.BatchNorm2d, nn.BatchNorm3d])
@@ -256,16 +310,18 @@ def _impl(mod: nn.Tanh, x):
 # Weight conversion
 
 
-def _as_weights(scalar_or_array) -> lbann.Weights:
+def _as_initializer(scalar_or_array) -> lbann.ValueInitializer:
     if hasattr(scalar_or_array, 'shape'):  # Tensor
         if isinstance(scalar_or_array, nn.Parameter):
             scalar_or_array = scalar_or_array.detach().cpu().numpy()
         if isinstance(scalar_or_array, torch.Tensor):
             scalar_or_array = scalar_or_array.detach().cpu().numpy()
-        return lbann.Weights(initializer=lbann.ValueInitializer(
-            values=scalar_or_array.flat))
-    return lbann.Weights(initializer=lbann.ValueInitializer(
-        values=[scalar_or_array]))  # Assuming scalar
+        return lbann.ValueInitializer(values=scalar_or_array.flat)
+    return lbann.ValueInitializer(values=[scalar_or_array])  # Assuming scalar
+
+
+def _as_weights(scalar_or_array) -> lbann.Weights:
+    return lbann.Weights(initializer=_as_initializer(scalar_or_array))
 
 
 @register_module_weight_converter([
@@ -348,3 +404,44 @@ try:
 except (ImportError, ModuleNotFoundError):
     # No PyTorch Geometric installation found, skip
     pass
+
+
+@register_module_weight_converter(nn.LayerNorm)
+def layer_norm_weights(mod: nn.LayerNorm, layer: lbann.LayerNorm):
+    weights = [mod.weight, getattr(mod, 'bias', None)]
+    layer.weights = [_as_weights(w) for w in weights if w is not None]
+
+
+@register_module_weight_converter(nn.MultiheadAttention)
+def mha_weights(mod: nn.MultiheadAttention, layer: lbann.Layer):
+    attention = layer.lbann_module
+    embed_dim = mod.embed_dim
+
+    def bias_or_zeros(bias, size):
+        return bias if bias is not None else torch.zeros(size)
+
+    in_bias = bias_or_zeros(mod.in_proj_bias, 3 * embed_dim)
+    if attention.self_attention:  # Stacked query/key/value matrix
+        matrices = [mod.in_proj_weight]
+        biases = [in_bias]
+        weights = [attention.qkv_weights]
+    else:
+        if mod._qkv_same_embed_dim:
+            matrices = torch.split(mod.in_proj_weight, embed_dim)
+        else:
+            matrices = [
+                mod.q_proj_weight, mod.k_proj_weight, mod.v_proj_weight
+            ]
+        biases = torch.split(in_bias, embed_dim)
+        weights = [
+            attention.query_weights, attention.key_weights,
+            attention.value_weights
+        ]
+    matrices = list(matrices) + [mod.out_proj.weight]
+    biases = list(biases) + [bias_or_zeros(mod.out_proj.bias, embed_dim)]
+    weights.append(attention.output_weights)
+
+    for (matrix_weights, bias_weights), matrix, bias in zip(
+            weights, matrices, biases):
+        matrix_weights.initializer = _as_initializer(matrix)
+        bias_weights.initializer = _as_initializer(bias)
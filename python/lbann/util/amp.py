@@ -1,6 +1,6 @@
 """Support for automatic mixed precision."""
 
-from typing import Optional
+from typing import Iterable, NamedTuple, Optional
 
 import functools
 import argparse
@@ -35,6 +35,45 @@ FP32_LAYERS = frozenset([
 ])
 
 
+class AmpPolicy(NamedTuple):
+    """Per-layer-type datatype policy for automatic mixed precision.
+
+    Layer types in `low_precision` compute in `compute_type`, layer
+    types in `full_precision` compute in FP32, and other layers take
+    the widest datatype among their parents. Weights are always kept
+    in FP32 and converted on use by reduced-precision layers.
+
+    """
+    compute_type: lbann.DataType = lbann.DataType.FP16
+    low_precision: frozenset = FP16_LAYERS
+    full_precision: frozenset = FP32_LAYERS
+
+    def override(self,
+                 allow: Iterable[type] = (),
+                 deny: Iterable[type] = ()) -> 'AmpPolicy':
+        """Return a policy with extra reduced-precision (`allow`) and
+        FP32 (`deny`) layer types. Deny takes precedence.
+
+        """
+        allow = frozenset(allow)
+        deny = frozenset(deny)
+        return self._replace(
+            low_precision=(self.low_precision | allow) - deny,
+            full_precision=(self.full_precision - allow) | deny)
+
+
+def _layer_types(names: Iterable[str]) -> list[type]:
+    """Look up layer classes by name, e.g. 'FullyConnected'."""
+    types = []
+    for name in names:
+        layer_type = getattr(lbann, name, None)
+        if not (isinstance(layer_type, type)
+                and issubclass(layer_type, lbann.Layer)):
+            raise ValueError(f'Unknown layer type "{name}"')
+        types.append(layer_type)
+    return types
+
+
 def num_weights_by_bias(layer: lbann.Layer, bias_field: str = 'has_bias') -> int:
     """Helper for determining the number of weights some layers have.
 
@@ -137,21 +176,24 @@ def get_widest_datatype(datatypes: list[lbann.DataType]) -> lbann.DataType:
     return widest
 
 
-def set_layer_datatypes(model: lbann.Model) -> None:
+def set_layer_datatypes(model: lbann.Model,
+                        policy: Optional[AmpPolicy] = None) -> None:
     """Set datatypes for layers in the model.
 
     If a layer that does not have a datatype set, it will be set based
-    on the conversion lists and its parent layer types.
+    on the policy's conversion lists and its parent layer types.
 
     """
+    if policy is None:
+        policy = AmpPolicy()
     for layer in lbann.traverse_layer_graph(model.layers):
         if layer.datatype is not None:
             continue  # Skip when datatype is already set.
         layer_type = type(layer)
-        if layer_type in FP16_LAYERS:
-            layer.datatype = lbann.DataType.FP16
-        elif layer_type in FP32_LAYERS:
+        if layer_type in policy.full_precision:
             layer.datatype = lbann.DataType.FLOAT
+        elif layer_type in policy.low_precision:
+            layer.datatype = policy.compute_type
         else:
             # Conservatively assume layers with no parents should
             # be in FP32 if there is not conversion or datatype
@@ -170,8 +212,16 @@ def enable_amp(model: lbann.Model,
                init_scale: Optional[float] = None,
                growth_factor: Optional[float] = None,
                backoff_factor: Optional[float] = None,
-               growth_interval: Optional[int] = None) -> None:
-    """Enable automatic mixed precision for a model if requested."""
+               growth_interval: Optional[int] = None,
+               policy: Optional[AmpPolicy] = None) -> None:
+    """Enable automatic mixed precision for a model if requested.
+
+    Layer datatypes follow `policy`, amended by the `--amp-allow` and
+    `--amp-deny` arguments. `--amp-no-loss-scaling` trains without
+    loss scaling, which is only safe when the reduced-precision compute
+    type has the exponent range of FP32, and is rejected for FP16.
+
+    """
     if model.amp is not None:
         raise RuntimeError('Model already has AMP options set, not resetting')
 
@@ -184,9 +234,19 @@ def enable_amp(model: lbann.Model,
     if not enable_amp:
         return
 
+    if policy is None:
+        policy = AmpPolicy()
+    policy = policy.override(
+        allow=_layer_types(getattr(args, 'amp_allow', [])),
+        deny=_layer_types(getattr(args, 'amp_deny', [])))
+    loss_scaling = getattr(args, 'amp_loss_scaling', True)
+    if not loss_scaling and policy.compute_type == lbann.DataType.FP16:
+        raise ValueError('FP16 compute requires loss scaling, '
+                         'do not pass --amp-no-loss-scaling')
+
     # Set up datatypes.
     add_weights(model)
-    set_layer_datatypes(model)
+    set_layer_datatypes(model, policy)
 
     # Enable AMP in the model.
     model.amp = lbann.AmpOptions(
@@ -194,4 +254,5 @@ def enable_amp(model: lbann.Model,
         init_scale=init_scale,
         growth_factor=growth_factor,
         backoff_factor=backoff_factor,
-        growth_interval=growth_interval)
+        growth_interval=growth_interval,
+        loss_scaling=loss_scaling)
@@ -0,0 +1,318 @@
+"""
+Writer and converter for the LBANN columnar data format.
+
+A columnar file holds each field of a data set as a column of samples
+with the same type and shape. Columns are split into chunks of
+``chunk_size`` samples that start at aligned offsets and are stored raw
+or zlib-compressed, chosen per column. A JSON footer records the
+columns and their chunk offsets so that the C++ ``columnar`` data reader
+can memory-map the file and find any sample directly.
+
+Layout::
+
+    header   8-byte magic "LBANNCOL", then uint64 version,
+             footer offset and footer size (little-endian)
+    chunks   column-major: all chunks of the first column, then the next
+    footer   JSON: num_samples, chunk_size, alignment and, per column,
+             dtype, dims, compression, chunk_offsets and chunk_sizes
+
+Sparse columns (:class:`SparseColumn`) have layout "coo" instead of
+dims: each sample has a variable number of entries with ``index_dims``
+integer coordinates and optionally a value. A chunk holds the uint64
+entry offsets of its samples, then the int64 coordinates of all its
+entries, then their values. Since compressed sizes say nothing about
+the inflated size, the footer also records raw_chunk_sizes.
+
+Usage as a converter::
+
+    python -m lbann.util.columnar input.npz output.lbcol \\
+        --chunk-size 256 --compress labels=none images=zlib
+"""
+import argparse
+import json
+import struct
+import zlib
+from typing import Dict, List, Mapping, Optional, Sequence, Union
+
+import numpy as np
+
+MAGIC = b'LBANNCOL'
+VERSION = 1
+_HEADER = struct.Struct('<8sQQQ')
+
+_DTYPES = ('int8', 'uint8', 'int16', 'int32', 'int64', 'float32', 'float64')
+
+
+class SparseColumn:
+    """
+    A column whose samples have a variable number of entries, such as the
+    edges of a graph or a bag of categorical features.
+
+    :param indices: Per sample, an integer array of shape
+                    ``(num_entries, index_dims)``, or ``(num_entries,)`` when
+                    ``index_dims`` is 1
+    :type indices: Sequence[np.ndarray]
+    :param values: Per sample, an array of ``num_entries`` values, or None
+                   if the entries have no values
+    :type values: Optional[Sequence[np.ndarray]]
+    """
+
+    def __init__(self,
+                 indices: Sequence[np.ndarray],
+                 values: Optional[Sequence[np.ndarray]] = None):
+        self.indices = [np.asarray(i, dtype=np.int64) for i in indices]
+        self.index_dims = max(
+            (1 if i.ndim == 1 else i.shape[1] for i in self.indices),
+            default=1)
+        self.indices = [i.reshape(-1, self.index_dims) for i in self.indices]
+        self.values = None
+        if values is not None:
+            self.values = [np.asarray(v) for v in values]
+            if len(self.values) != len(self.indices):
+                raise ValueError('sparse column has '
+                                 f'{len(self.indices)} index arrays but '
+                                 f'{len(self.values)} value arrays')
+            for i, v in zip(self.indices, self.values):
+                if len(v) != len(i):
+                    raise ValueError('sparse sample has '
+                                     f'{len(i)} entries but {len(v)} values')
+
+    def __len__(self) -> int:
+        return len(self.indices)
+
+    @property
+    def dtype(self) -> np.dtype:
+        if self.values is None or not self.values:
+            return np.dtype('int64')
+        return np.result_type(*self.values)
+
+    def max_entries(self) -> int:
+        """Largest number of entries in a sample, i.e. the smallest
+        capacity that a schema can give this column."""
+        return max((len(i) for i in self.indices), default=0)
+
+
+def _sparse_chunk(column: SparseColumn, start: int, stop: int,
+                  dtype: np.dtype) -> bytes:
+    """Serialize the samples of a sparse column in [start, stop)."""
+    indices = column.indices[start:stop]
+    offsets = np.zeros(len(indices) + 1, dtype='<u8')
+    offsets[1:] = np.cumsum([len(i) for i in indices])
+    parts = [
+        offsets.tobytes(),
+        np.concatenate(indices or [np.zeros((0, column.index_dims))]).astype(
+            '<i8').tobytes()
+    ]
+    if column.values is not None:
+        parts.append(
+            np.concatenate(column.values[start:stop]
+                           or [np.zeros(0)]).astype(dtype).tobytes())
+    return b''.join(parts)
+
+
+def write_columnar(path: str,
+                   columns: Mapping[str, Union[np.ndarray, SparseColumn]],
+                   chunk_size: int = 1024,
+                   compression: Optional[Mapping[str, str]] = None,
+                   alignment: int = 64) -> None:
+    """
+    Write arrays to a columnar file.
+
+    :param path: Output file
+    :type path: str
+    :param columns: Arrays whose first axis is the sample axis, or sparse
+                    columns, by column name
+    :type columns: Mapping[str, Union[np.ndarray, SparseColumn]]
+    :param chunk_size: Number of samples in each chunk. Compressed chunks
+                       are inflated whole, so smaller chunks make random
+                       access to compressed columns cheaper.
+    :type chunk_size: int
+    :param compression: "none" or "zlib" by column name, defaults to
+                        "none"
+    :type compression: Optional[Mapping[str, str]]
+    :param alignment: Byte alignment of each chunk
+    :type alignment: int
+    """
+    compression = dict(compression or {})
+    if chunk_size <= 0:
+        raise ValueError('chunk_size must be positive')
+    num_samples = None
+    for name, array in columns.items():
+        if not name or '/' in name:
+            raise ValueError(f'invalid column name "{name}"')
+        if np.dtype(array.dtype).name not in _DTYPES:
+            raise ValueError(
+                f'column "{name}" has unsupported type {array.dtype}')
+        if num_samples is None:
+            num_samples = len(array)
+        elif len(array) != num_samples:
+            raise ValueError(f'column "{name}" has {len(array)} samples, '
+                             f'but other columns have {num_samples}')
+        if compression.get(name, 'none') not in ('none', 'zlib'):
+            raise ValueError(f'column "{name}" has unsupported compression '
+                             f'"{compression[name]}"')
+    num_samples = num_samples or 0
+
+    if alignment % 8 != 0:
+        raise ValueError('alignment must be a multiple of 8')
+
+    def pad(f):
+        f.write(b'\0' * (-f.tell() % alignment))
+
+    footer = {
+        'num_samples': num_samples,
+        'chunk_size': chunk_size,
+        'alignment': alignment,
+        'columns': {},
+    }
+    with open(path, 'wb') as f:
+        f.write(_HEADER.pack(MAGIC, VERSION, 0, 0))
+        for name, array in columns.items():
+            # Stored little-endian, one sample after another
+            dtype = np.dtype(array.dtype).newbyteorder('<')
+            sparse = isinstance(array, SparseColumn)
+            if not sparse:
+                array = np.ascontiguousarray(array, dtype=dtype)
+            method = compression.get(name, 'none')
+            offsets, sizes, raw_sizes = [], [], []
+            for start in range(0, num_samples, chunk_size):
+                if sparse:
+                    data = _sparse_chunk(array, start, start + chunk_size,
+                                         dtype)
+                else:
+                    data = array[start:start + chunk_size].tobytes()
+                raw_sizes.append(len(data))
+                if method == 'zlib':
+                    data = zlib.compress(data)
+                pad(f)
+                offsets.append(f.tell())
+                sizes.append(len(data))
+                f.write(data)
+            desc = {
+                'dtype': dtype.name,
+                'compression': method,
+                'chunk_offsets': offsets,
+                'chunk_sizes': sizes,
+            }
+            if sparse:
+                desc['layout'] = 'coo'
+                desc['index_dims'] = array.index_dims
+                desc['has_values'] = int(array.values is not None)
+                desc['raw_chunk_sizes'] = raw_sizes
+            else:
+                desc['dims'] = list(array.shape[1:]) or [1]
+            footer['columns'][name] = desc
+        pad(f)
+        footer_offset = f.tell()
+        footer_data = json.dumps(footer).encode()
+        f.write(footer_data)
+        f.seek(0)
+        f.write(_HEADER.pack(MAGIC, VERSION, footer_offset, len(footer_data)))
+
+
+def read_columnar(path: str,
+                  names=None) -> Dict[str, Union[np.ndarray, SparseColumn]]:
+    """
+    Read columns of a columnar file, e.g. to check a conversion.
+
+    :param path: Columnar file
+    :type path: str
+    :param names: Columns to read, defaults to all
+    :return: Arrays or sparse columns by column name
+    :rtype: Dict[str, Union[np.ndarray, SparseColumn]]
+    """
+    with open(path, 'rb') as f:
+        magic, version, footer_offset, footer_size = _HEADER.unpack(
+            f.read(_HEADER.size))
+        if magic != MAGIC or version != VERSION:
+            raise ValueError(f'{path} is not a version {VERSION} columnar file')
+        f.seek(footer_offset)
+        footer = json.loads(f.read(footer_size))
+        result = {}
+        for name, desc in footer['columns'].items():
+            if names is not None and name not in names:
+                continue
+            chunks = []
+            for offset, size in zip(desc['chunk_offsets'],
+                                    desc['chunk_sizes']):
+                f.seek(offset)
+                data = f.read(size)
+                if desc['compression'] == 'zlib':
+                    data = zlib.decompress(data)
+                chunks.append(data)
+            dtype = np.dtype(desc['dtype']).newbyteorder('<')
+            if desc.get('layout', 'dense') == 'coo':
+                result[name] = _read_sparse(chunks, desc, dtype,
+                                            footer['num_samples'],
+                                            footer['chunk_size'])
+                continue
+            result[name] = np.frombuffer(b''.join(chunks), dtype=dtype).reshape(
+                [footer['num_samples']] + desc['dims'])
+        return result
+
+
+def _read_sparse(chunks: List[bytes], desc: dict, dtype: np.dtype,
+                 num_samples: int, chunk_size: int) -> SparseColumn:
+    """Deserialize the chunks of a sparse column."""
+    index_dims = desc['index_dims']
+    indices, values = [], []
+    for c, data in enumerate(chunks):
+        chunk_samples = min(chunk_size, num_samples - c * chunk_size)
+        offsets = np.frombuffer(data, dtype='<u8', count=chunk_samples + 1)
+        num_entries = int(offsets[-1])
+        pos = offsets.nbytes
+        coords = np.frombuffer(data, dtype='<i8', count=num_entries *
+                               index_dims, offset=pos).reshape(-1, index_dims)
+        pos += coords.nbytes
+        if desc['has_values']:
+            vals = np.frombuffer(data, dtype=dtype, count=num_entries,
+                                 offset=pos)
+        for begin, end in zip(offsets[:-1], offsets[1:]):
+            indices.append(coords[begin:end])
+            if desc['has_values']:
+                values.append(vals[begin:end])
+    return SparseColumn(indices, values if desc['has_values'] else None)
+
+
+def _load_arrays(path: str) -> Dict[str, np.ndarray]:
+    """Load the arrays of an .npz file or the root datasets of an HDF5
+    file."""
+    if path.endswith('.npz'):
+        with np.load(path) as npz:
+            return {name: npz[name] for name in npz.files}
+    import h5py
+    with h5py.File(path, 'r') as f:
+        return {
+            name: f[name][()]
+            for name in f.keys() if isinstance(f[name], h5py.Dataset)
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Convert an .npz or HDF5 data set to the LBANN '
+        'columnar format. Each array, or each dataset at the root of an '
+        'HDF5 file, becomes a column; its first axis is the sample axis.')
+    parser.add_argument('input', help='.npz or HDF5 file')
+    parser.add_argument('output', help='columnar file to write')
+    parser.add_argument('--chunk-size', type=int, default=1024,
+                        help='samples per chunk (default: 1024)')
+    parser.add_argument('--compress', nargs='*', default=[],
+                        metavar='COLUMN=METHOD',
+                        help='per-column compression, "none" or "zlib"')
+    parser.add_argument('--columns', nargs='*', default=None,
+                        help='columns to keep (default: all)')
+    args = parser.parse_args()
+
+    arrays = _load_arrays(args.input)
+    if args.columns is not None:
+        arrays = {name: arrays[name] for name in args.columns}
+    compression = dict(c.split('=', 1) for c in args.compress)
+    write_columnar(args.output,
+                   arrays,
+                   chunk_size=args.chunk_size,
+                   compression=compression)
+
+
+if __name__ == '__main__':
+    main()
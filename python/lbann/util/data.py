@@ -3,7 +3,8 @@ import os
 import inspect
 import pickle
 import lbann
-from multiprocessing import Pool
+from collections import deque
+from multiprocessing import Pool, resource_tracker, shared_memory
 import numpy as np
 from typing import Dict, List, Optional, Union
 from numpy.typing import ArrayLike
@@ -155,18 +156,65 @@ class DistConvDataset(Dataset):
         """
         self._num_io_partitions = num_io_partitions
 
+    @property
+    def io_partition_shape(self) -> tuple:
+        """
+        Number of DistConv IO partitions along depth, height and width.
+        Each process should return the block of a sample given by
+        ``io_partition_index`` so that no shuffle is needed.
+
+        :return: IO partition shape, defaults to (num_io_partitions, 1, 1)
+        :rtype: tuple
+        """
+        if not hasattr(self, "_io_partition_shape"):
+            self._io_partition_shape = (self.num_io_partitions, 1, 1)
+        return self._io_partition_shape
+
+    @io_partition_shape.setter
+    def io_partition_shape(self, io_partition_shape: tuple) -> None:
+        """
+        Setter for io_partition_shape.
+
+        :param io_partition_shape: DistConv IO partitions along depth,
+                                   height and width
+        :type io_partition_shape: tuple
+        """
+        self._io_partition_shape = tuple(io_partition_shape)
+
+    @property
+    def io_partition_index(self) -> tuple:
+        """
+        Depth, height and width index of the sample block read by this
+        process.
+
+        :return: IO partition index
+        :rtype: tuple
+        """
+        _, parts_h, parts_w = self.io_partition_shape
+        part = self.rank % self.num_io_partitions
+        return (part // (parts_h * parts_w), (part // parts_w) % parts_h,
+                part % parts_w)
+
 
 class DataReader:
     """
     Helper class used by LBANN to control worker processes and handle sample/batch loading.
+
+    Worker processes write samples directly into a ring of batch slots held in
+    POSIX shared memory. Each slot is laid out like a column-major LBANN
+    matrix (one contiguous column per sample) so LBANN can read a finished
+    batch without any intermediate stacking or pickling.
     """
 
     def __init__(self, dataset: Dataset, num_procs: int, prefetch_factor: int,
-                 dtype: str) -> None:
+                 dtype: str, max_batch_size: int,
+                 num_batch_slots: int,
+                 cpus: Optional[List[int]] = None) -> None:
         """
         DataReader Constructor
 
-        Launches worker processes during initialization.
+        Allocates the shared-memory batch ring and launches worker processes
+        during initialization.
 
         :param dataset: Dataset
         :type dataset: Dataset
@@ -176,6 +224,13 @@ class DataReader:
         :type prefetch_factor: int
         :param dtype: Type of the batches to be returned
         :type dtype: str
+        :param max_batch_size: Largest number of samples in a batch
+        :type max_batch_size: int
+        :param num_batch_slots: Number of batches held in shared memory
+        :type num_batch_slots: int
+        :param cpus: CPUs the worker processes are bound to, defaults to
+                     None (inherit the parent's affinity)
+        :type cpus: list[int], optional
         """
         self.dataset = dataset
         self.num_procs = num_procs
@@ -183,22 +238,52 @@ class DataReader:
         self.dtype = dtype
         self.sample_dims = dataset.get_sample_dims()
         self.num_io_partitions = 1
-        self.loaded_samples = []
+        self.max_batch_size = max_batch_size
+        self.num_batch_slots = num_batch_slots
 
         if isinstance(self.dataset, DistConvDataset):
             self.num_io_partitions = self.dataset.num_io_partitions
 
+        field_sizes = {
+            "sample":
+            int(np.prod(self.sample_dims.sample)) // self.num_io_partitions
+        }
+        for field in ("label", "response"):
+            if hasattr(self.sample_dims, field):
+                field_sizes[field] = int(
+                    np.prod(getattr(self.sample_dims, field)))
+
+        # Allocate the ring before forking so every worker maps the same
+        # segments.
+        itemsize = np.dtype(dtype).itemsize
+        self.shms = {}
+        self.ring = {}
+        ring_layout = {}
+        for field, size in field_sizes.items():
+            shape = (num_batch_slots, max_batch_size, size)
+            shm = shared_memory.SharedMemory(
+                create=True, size=max(1, int(np.prod(shape)) * itemsize))
+            self.shms[field] = shm
+            self.ring[field] = np.ndarray(shape, dtype=dtype, buffer=shm.buf)
+            ring_layout[field] = (shm.name, shape)
+
+        self.free_slots = deque(range(num_batch_slots))
+        self.queued_batches = deque()
+        self.current_slot = None
+
         self.pool = Pool(processes=num_procs,
                          initializer=DataReader.init_worker,
-                         initargs=(self.dataset, ))
+                         initargs=(self.dataset, ring_layout, dtype, cpus))
 
     @staticmethod
-    def init_worker(dataset):
+    def init_worker(dataset, ring_layout, dtype, cpus=None):
         """
         Initialize worker process.
 
         Disables the LBANN signal handler since it reports a spurious error
         when the worker process recieves SIGTERM from the master process.
+        Attaches to the shared-memory batch ring and binds the worker to
+        its share of the rank's CPUs, if one was assigned.
         """
         import signal
 
@@ -209,86 +294,115 @@ class DataReader:
             except:
                 pass
 
+        if cpus:
+            try:
+                os.sched_setaffinity(0, cpus)
+            except (AttributeError, OSError):
+                pass
+
         # Process-local storage
-        global g_dataset
+        global g_dataset, g_shms, g_ring
         g_dataset = dataset
+        g_shms = {}
+        g_ring = {}
+        for field, (name, shape) in ring_layout.items():
+            shm = shared_memory.SharedMemory(name=name)
+            # Only the master process may unlink the segments
+            try:
+                resource_tracker.unregister(shm._name, "shared_memory")
+            except Exception:
+                pass
+            g_shms[field] = shm
+            g_ring[field] = np.ndarray(shape, dtype=dtype, buffer=shm.buf)
 
     def terminate(self) -> None:
         """
-        Terminate all worker processes.
+        Terminate all worker processes and release the shared memory.
         """
         self.pool.terminate()
+        self.pool.join()
+        self.ring = {}
+        for shm in self.shms.values():
+            shm.close()
+            shm.unlink()
+        self.shms = {}
 
     @staticmethod
-    def load_sample(ind) -> Sample:
+    def load_samples(slot: int, start: int, inds: List[int]) -> None:
         """
-        Loads the sample from the dataset at the specified index.
+        Loads samples from the dataset straight into a batch slot.
         This function must be called from a worker process.
 
-        :param dataset: Dataset
-        :type dataset: Dataset
-        :param ind: Index to load
-        :type ind: int
-        :return: Sample
-        :rtype: Sample
-        """
-        return g_dataset[ind]
-
-    def load_next_sample_async(self, ind: int):
-        """
-        Submit the next sample index to be loaded to the worker pool.
+        :param slot: Batch slot to write into
+        :type slot: int
+        :param start: Position of the first sample within the batch
+        :type start: int
+        :param inds: Indices to load
+        :type inds: List[int]
         """
-        self.loaded_samples.append(
-            self.pool.apply_async(DataReader.load_sample, (ind, )))
+        for pos, ind in enumerate(inds, start):
+            sample = g_dataset[ind]
+            for field, ring in g_ring.items():
+                ring[slot, pos] = np.asarray(getattr(sample, field),
+                                             dtype=ring.dtype).reshape(-1)
 
-    def queue_samples(self, inds: List[int]) -> None:
+    def queue_batch(self, inds: List[int]) -> None:
         """
-        Set the indices to be loaded this epoch and start submitting jobs
-        to the worker pool.
+        Submit a batch to be assembled in a free slot of the ring. The batch
+        is split into one contiguous chunk per worker process.
 
         :param inds: List of sample indices
         :type inds: List[int]
         """
-        for ind in inds:
-            self.load_next_sample_async(ind)
+        if len(inds) > self.max_batch_size:
+            raise ValueError(f"batch of {len(inds)} samples exceeds "
+                             f"the {self.max_batch_size} sample slots")
+        if not self.free_slots:
+            raise RuntimeError("no free batch slot in shared memory")
+        slot = self.free_slots.popleft()
+        chunk = -(-len(inds) // self.num_procs)
+        jobs = [
+            self.pool.apply_async(DataReader.load_samples,
+                                  (slot, start, inds[start:start + chunk]))
+            for start in range(0, len(inds), chunk)
+        ]
+        self.queued_batches.append((slot, len(inds), jobs))
+
+    def reset(self) -> None:
+        """
+        Wait for all queued batches and return every slot to the free list.
+        """
+        for _, _, jobs in self.queued_batches:
+            for job in jobs:
+                job.wait()
+        self.queued_batches.clear()
+        self.free_slots = deque(range(self.num_batch_slots))
+        self.current_slot = None
 
     def get_batch(self, batch_size: int) -> Dict[str, Union[np.ndarray, int]]:
         """
-        Return a batch of samples.
+        Return the oldest queued batch. The previously returned batch slot is
+        recycled, so its pointers are only valid until the next call.
 
         :param batch_size: Number of samples to return
         :type batch_size: int
         :return: Batch of samples and pointers for each input field
         :rtype: Dict[str, Union[np.ndarray, int]]
         """
-        samples = []
-        for _ in range(batch_size):
-            samples.append(self.loaded_samples.pop(0).get())
+        if self.current_slot is not None:
+            self.free_slots.append(self.current_slot)
+            self.current_slot = None
 
-        batch = {}
+        slot, queued_size, jobs = self.queued_batches.popleft()
+        for job in jobs:
+            job.get()
+        self.current_slot = slot
+        assert queued_size == batch_size
 
-        # Note: we return the arrays with the pointers so that they aren't
-        # deallocated by the garbage collector.
-        batch["sample"] = np.ascontiguousarray([s.sample for s in samples],
-                                               dtype=self.dtype)
-        batch["sample_ptr"] = batch["sample"].ctypes.data
-        assert (batch["sample"].size == np.prod(self.sample_dims.sample) *
-                batch_size / self.num_io_partitions)
-
-        if hasattr(self.sample_dims, "label"):
-            batch["label"] = np.ascontiguousarray([s.label for s in samples],
-                                                  dtype=self.dtype)
-            batch["label_ptr"] = batch["label"].ctypes.data
-            assert batch["label"].size == np.prod(
-                self.sample_dims.label) * batch_size
-
-        if hasattr(self.sample_dims, "response"):
-            batch["response"] = np.ascontiguousarray(
-                [s.response for s in samples], dtype=self.dtype)
-            batch["response_ptr"] = batch["response"].ctypes.data
-            assert (
-                batch["response"].size == np.prod(self.sample_dims.response) *
-                batch_size)
+        batch = {}
+        for field, ring in self.ring.items():
+            batch[field] = ring[slot, :batch_size]
+            batch[f"{field}_ptr"] = batch[field].ctypes.data
 
         return batch
 
@@ -302,6 +416,7 @@ def construct_python_dataset_reader(
     validation_fraction: Optional[float] = 0.0,
     load_module: Optional[bool] = True,
     prefetch_factor: Optional[int] = 1,
+    batches_in_flight: Optional[int] = 0,
 ) -> lbann.reader_pb2.Reader:
     """
     Helper function to take a Dataset object, pickle it, save it, and return
@@ -324,6 +439,9 @@ def construct_python_dataset_reader(
     :type load_module: Optional[bool], optional
     :param prefetch_factor: Number of samples to prefetch per data reader process, defaults to 1
     :type prefetch_factor: Optional[int], optional
+    :param batches_in_flight: Number of mini-batches assembled ahead in shared memory,
+        defaults to 0 (derived from prefetch_factor)
+    :type batches_in_flight: Optional[int], optional
     :return: LBANN Reader protobuf message
     :rtype: lbann.reader_pb2.Reader
     """
@@ -350,6 +468,7 @@ def construct_python_dataset_reader(
             dataset_path=dataset_path,
             module_dir=module_dir,
             prefetch_factor=prefetch_factor,
+            batches_in_flight=batches_in_flight,
         ),
     )
 
@@ -0,0 +1,600 @@
+"""Search parallel strategies for a model from measured layer costs.
+
+The planner reads per-layer forward and backward times, output sizes
+and weight sizes from an `lbann-bench --bench_layers` run on a single
+process, and collective latency and bandwidth from an
+`lbann-comm-bench` run. For a given number of GPUs and mini-batch
+size, it searches:
+
+* pipeline stages: contiguous runs of layers on equal-sized sub-grids
+  (`grid_tag`, `--num_subgrids_block_order` and the model's
+  `pipeline_parallelism` option), with the SGD gradient accumulation
+  steps as micro-batches;
+* per layer within a stage: data parallelism, spatial (distconv
+  height or depth) parallelism, or channel/filter parallelism.
+
+Costs use a simple analytic model. Compute scales with the local
+number of samples. Communication uses latency-bandwidth estimates of
+the halo exchanges, activation allgathers, redistributions between
+layers with different strategies, pipeline transfers and gradient
+allreduces. Plans that do not fit in GPU memory are dropped. The
+predicted throughput is meant for ranking plans, not as an absolute
+forecast.
+
+Example:
+
+    python -m lbann.util.parallel_planner \\
+        --layer-profile lbann_bench.csv --comm-profile lbann_comm_bench.csv \\
+        --num-gpus 16 --mini-batch-size 256 --gpu-memory 16 \\
+        --output parallel_strategy.prototext
+
+"""
+
+from typing import Dict, Iterable, List, NamedTuple, Optional, Tuple
+
+import argparse
+import csv
+
+from google.protobuf import text_format
+
+import lbann
+import lbann.core.util
+from lbann import model_pb2
+
+# Layer types (as reported by lbann-bench) that distconv can split
+# spatially, and that can split their output channels.
+SPATIAL_LAYERS = frozenset([
+    'convolution',
+    'deconvolution',
+    'pooling',
+    'unpooling',
+    'batch normalization',
+    'ReLU',
+    'leaky ReLU',
+    'identity',
+    'sum',
+    'split',
+    'concatenate',
+    'upsample',
+])
+CHANNEL_LAYERS = frozenset([
+    'convolution',
+    'deconvolution',
+])
+MODEL_PARALLEL_LAYERS = frozenset([
+    'fully connected',
+])
+
+# Copies of each weight held per process: values, gradients and two
+# optimizer moments (Adam).
+WEIGHTS_COPIES = 4
+
+
+class LayerProfile(NamedTuple):
+    """Measured cost of one layer on a single process."""
+    name: str
+    type: str
+    # Seconds per mini-batch of `mini_batch_size` samples
+    fp_time: float
+    bp_time: float
+    mini_batch_size: int
+    # Output dimensions of one sample, channels first
+    output_dims: Tuple[int, ...]
+    # Output activations for the mini-batch
+    activation_bytes: int
+    weights_bytes: int
+
+    def sample_bytes(self) -> float:
+        return self.activation_bytes / max(self.mini_batch_size, 1)
+
+
+def read_layer_profile(filename: str,
+                       datatype: str = 'FLOAT',
+                       device: str = 'GPU') -> List[LayerProfile]:
+    """Read the layer rows of an lbann-bench CSV file.
+
+    Rows of other datatypes or devices, operator rows and failed rows
+    are skipped. Only the first benchmark shape is used.
+
+    """
+    profile = []
+    dims = None
+    with open(filename, newline='') as f:
+        for row in csv.DictReader(f):
+            if (row['kind'] != 'layer' or row['datatype'] != datatype
+                    or row['device'] != device or row['status'] != 'ok'):
+                continue
+            if dims is None:
+                dims = row['dims']
+            if row['dims'] != dims:
+                continue
+            name, _, layer_type = row['name'].partition(' (')
+            output_dims = tuple(
+                int(d) for d in row['output_dims'].split('x') if d)
+            profile.append(LayerProfile(
+                name=name,
+                type=layer_type.rstrip(')'),
+                fp_time=float(row['fp_time_ms']) / 1e3,
+                bp_time=float(row['bp_time_ms']) / 1e3,
+                mini_batch_size=int(row['mini_batch_size']),
+                output_dims=output_dims,
+                activation_bytes=int(row['activation_bytes']),
+                weights_bytes=int(row['weights_bytes'])))
+    if not profile:
+        raise ValueError(f'no {datatype} {device} layer results in '
+                         f'"{filename}"')
+    return profile
+
+
+class CommModel(NamedTuple):
+    """Latency-bandwidth model of the interconnect."""
+    latency: float = 5e-6
+    # Bytes per second
+    bandwidth: float = 10e9
+
+    def send(self, num_bytes: float) -> float:
+        return self.latency + num_bytes / self.bandwidth
+
+    def allreduce(self, num_bytes: float, procs: int) -> float:
+        if procs <= 1:
+            return 0.
+        return (2 * (procs - 1) * self.latency
+                + 2 * (procs - 1) / procs * num_bytes / self.bandwidth)
+
+    def allgather(self, num_bytes: float, procs: int) -> float:
+        """Time to allgather `num_bytes` in total."""
+        if procs <= 1:
+            return 0.
+        return ((procs - 1) * self.latency
+                + (procs - 1) / procs * num_bytes / self.bandwidth)
+
+
+def read_comm_profile(filename: str, device: str = 'GPU') -> CommModel:
+    """Fit a CommModel to the allreduce rows of an lbann-comm-bench
+    CSV file.
+
+    The latency comes from the smallest message and the bandwidth is
+    the best bus bandwidth measured.
+
+    """
+    rows = []
+    with open(filename, newline='') as f:
+        for row in csv.DictReader(f):
+            if (row['collective'] == 'allreduce' and row['device'] == device
+                    and int(row['comm_size']) > 1):
+                rows.append(row)
+    if not rows:
+        raise ValueError(f'no {device} allreduce results in "{filename}"')
+    smallest = min(rows, key=lambda row: float(row['bytes']))
+    steps = 2 * (int(smallest['comm_size']) - 1)
+    latency = float(smallest['time_us']) / 1e6 / steps
+    bandwidth = max(float(row['busbw_GBps']) for row in rows) * 1e9
+    return CommModel(latency=latency, bandwidth=bandwidth)
+
+
+class LayerChoice(NamedTuple):
+    """Parallelization of one layer within its stage."""
+    # 'data', 'spatial', 'channel' or 'model'
+    kind: str = 'data'
+    # Processes splitting each sample
+    groups: int = 1
+
+
+class LayerCost(NamedTuple):
+    # Seconds per micro-batch
+    time: float
+    # Seconds per step
+    allreduce_time: float
+    # Bytes per process
+    memory: float
+
+
+def _divisors(n: int) -> List[int]:
+    return [d for d in range(1, n + 1) if n % d == 0]
+
+
+def layer_choices(layer: LayerProfile,
+                  procs: int,
+                  micro_batch_size: int) -> List[LayerChoice]:
+    """Parallelizations of a layer on `procs` processes.
+
+    Every process must hold at least part of one sample, so splitting
+    samples is what lets micro-batches smaller than `procs` run.
+
+    """
+    choices = [LayerChoice()]
+    dims = layer.output_dims
+    for g in _divisors(procs)[1:]:
+        if (layer.type in SPATIAL_LAYERS and len(dims) >= 3
+                and dims[1] % g == 0):
+            choices.append(LayerChoice('spatial', g))
+        if layer.type in CHANNEL_LAYERS and dims and dims[0] % g == 0:
+            choices.append(LayerChoice('channel', g))
+    if layer.type in MODEL_PARALLEL_LAYERS and procs > 1:
+        choices.append(LayerChoice('model', procs))
+    return [c for c in choices if micro_batch_size * c.groups >= procs]
+
+
+def layer_cost(layer: LayerProfile,
+               choice: LayerChoice,
+               procs: int,
+               micro_batch_size: int,
+               comm: CommModel) -> LayerCost:
+    """Cost of a layer on `procs` processes for one micro-batch."""
+    scale = micro_batch_size / max(layer.mini_batch_size, 1) / procs
+    compute = (layer.fp_time + layer.bp_time) * scale
+    local_bytes = layer.sample_bytes() * micro_batch_size / procs
+    g = choice.groups
+    weights = layer.weights_bytes
+    comm_time = 0.
+    if choice.kind == 'spatial':
+        # One boundary slice in each direction, forward and backward
+        halo = 2 * layer.sample_bytes() / layer.output_dims[1]
+        local_samples = micro_batch_size * g / procs
+        comm_time = 2 * comm.send(halo * local_samples)
+    elif choice.kind in ('channel', 'model'):
+        # Outputs are gathered forward and reduce-scattered backward
+        comm_time = 2 * comm.allgather(local_bytes * g, g)
+        weights /= g
+    allreduce_procs = procs // g if choice.kind in ('channel',
+                                                    'model') else procs
+    return LayerCost(time=compute + comm_time,
+                     allreduce_time=comm.allreduce(weights, allreduce_procs),
+                     memory=WEIGHTS_COPIES * weights + local_bytes)
+
+
+def _redistribution_time(layer: LayerProfile,
+                         prev: LayerChoice,
+                         choice: LayerChoice,
+                         procs: int,
+                         micro_batch_size: int,
+                         comm: CommModel) -> float:
+    """Time to move a layer's inputs between parallelizations."""
+    if prev == choice:
+        return 0.
+    local_bytes = layer.sample_bytes() * micro_batch_size / procs
+    return 2 * comm.send(local_bytes)
+
+
+class StagePlan(NamedTuple):
+    layers: List[LayerProfile]
+    choices: List[LayerChoice]
+    # Seconds per micro-batch, forward and backward
+    time: float
+    allreduce_time: float
+    # Peak bytes per process
+    memory: float
+
+
+def plan_stage(layers: List[LayerProfile],
+               procs: int,
+               micro_batch_size: int,
+               comm: CommModel) -> StagePlan:
+    """Choose per-layer parallelizations for a stage.
+
+    Dynamic programming over the layer sequence minimizes compute and
+    communication time, including redistributions between consecutive
+    layers with different parallelizations.
+
+    """
+    # best[c] = (time, choices) of the prefix ending with choice c
+    best: Dict[LayerChoice, Tuple[float, List[LayerChoice]]] = {}
+    prev_layer = None
+    for layer in layers:
+        step = {}
+        for choice in layer_choices(layer, procs, micro_batch_size):
+            cost = layer_cost(layer, choice, procs, micro_batch_size, comm)
+            if prev_layer is None:
+                step[choice] = (cost.time, [choice])
+                continue
+            candidates = [
+                (time + _redistribution_time(prev_layer, prev, choice,
+                                             procs, micro_batch_size,
+                                             comm), path)
+                for prev, (time, path) in best.items()
+            ]
+            time, path = min(candidates, key=lambda c: c[0])
+            step[choice] = (time + cost.time, path + [choice])
+        best = step
+        prev_layer = layer
+    time, choices = min(best.values(), key=lambda c: c[0])
+    costs = [
+        layer_cost(layer, choice, procs, micro_batch_size, comm)
+        for layer, choice in zip(layers, choices)
+    ]
+    return StagePlan(layers=layers,
+                     choices=choices,
+                     time=time,
+                     allreduce_time=sum(c.allreduce_time for c in costs),
+                     memory=sum(c.memory for c in costs))
+
+
+def partition_stages(times: List[float], num_stages: int) -> List[int]:
+    """Split a sequence into contiguous stages with the smallest
+    largest stage time.
+
+    Returns:
+        The index of the first layer of each stage.
+
+    """
+    n = len(times)
+    prefix = [0.]
+    for t in times:
+        prefix.append(prefix[-1] + t)
+    inf = float('inf')
+    # cost[s][i]: best largest stage time for the first i layers in
+    # s stages
+    cost = [[inf] * (n + 1) for _ in range(num_stages + 1)]
+    cut = [[0] * (n + 1) for _ in range(num_stages + 1)]
+    cost[0][0] = 0.
+    for s in range(1, num_stages + 1):
+        for i in range(s, n + 1):
+            for j in range(s - 1, i):
+                c = max(cost[s - 1][j], prefix[i] - prefix[j])
+                if c < cost[s][i]:
+                    cost[s][i] = c
+                    cut[s][i] = j
+    starts = []
+    i = n
+    for s in range(num_stages, 0, -1):
+        i = cut[s][i]
+        starts.append(i)
+    return starts[::-1]
+
+
+class Plan(NamedTuple):
+    """Parallel strategy for a model on a number of GPUs."""
+    num_gpus: int
+    mini_batch_size: int
+    num_micro_batches: int
+    stages: List[StagePlan]
+    # Seconds per optimization step
+    step_time: float
+
+    @property
+    def num_stages(self) -> int:
+        return len(self.stages)
+
+    @property
+    def gpus_per_stage(self) -> int:
+        return self.num_gpus // self.num_stages
+
+    @property
+    def throughput(self) -> float:
+        """Predicted samples per second."""
+        return self.mini_batch_size / self.step_time
+
+    def assignments(self) -> Dict[str, Tuple[int, LayerChoice]]:
+        """Stage index and parallelization of each layer, by name."""
+        return {
+            layer.name: (s, choice)
+            for s, stage in enumerate(self.stages)
+            for layer, choice in zip(stage.layers, stage.choices)
+        }
+
+    def parallel_strategy(self, choice: LayerChoice,
+                          num_dims: int) -> Dict[str, int]:
+        """Layer parallel_strategy arguments for a parallelization."""
+        procs = self.gpus_per_stage
+        g = choice.groups
+        if choice.kind == 'spatial':
+            split = 'depth_groups' if num_dims >= 4 else 'height_groups'
+            return lbann.core.util.get_parallel_strategy_args(
+                sample_groups=procs // g, **{split: g})
+        if choice.kind == 'channel':
+            return lbann.core.util.get_parallel_strategy_args(
+                sample_groups=procs // g, channel_groups=g, filter_groups=g)
+        return {}
+
+    def apply(self, model: lbann.Model) -> None:
+        """Set layer parallel strategies, data layouts and pipeline
+        stages in a model.
+
+        The trainer must still be given `num_micro_batches` gradient
+        accumulation steps and, with more than one stage,
+        `--num_subgrids_block_order` equal to the number of stages.
+
+        """
+        assignments = self.assignments()
+        dims = {
+            layer.name: len(layer.output_dims)
+            for stage in self.stages for layer in stage.layers
+        }
+        for layer in model.layers:
+            if layer.name not in assignments:
+                raise ValueError(f'layer "{layer.name}" was not profiled')
+            stage, choice = assignments[layer.name]
+            layer.parallel_strategy = self.parallel_strategy(
+                choice, dims[layer.name])
+            if choice.kind == 'model':
+                layer.data_layout = 'model_parallel'
+            if self.num_stages > 1:
+                layer.grid_tag = {'value': stage + 1}
+        model.pipeline_parallelism = self.num_stages > 1
+
+    def export_proto(self) -> model_pb2.Model:
+        """Model message with only the parallelization of each layer."""
+        proto = model_pb2.Model()
+        proto.pipeline_parallelism = self.num_stages > 1
+        for s, stage in enumerate(self.stages):
+            for layer, choice in zip(stage.layers, stage.choices):
+                layer_proto = proto.layer.add()
+                layer_proto.name = layer.name
+                if choice.kind == 'model':
+                    layer_proto.data_layout = 'model_parallel'
+                strategy = self.parallel_strategy(choice,
+                                                  len(layer.output_dims))
+                if strategy:
+                    lbann.core.util.set_protobuf_message(
+                        layer_proto.parallel_strategy, **strategy)
+                if self.num_stages > 1:
+                    layer_proto.grid_tag.value = s + 1
+        return proto
+
+    def summary(self) -> str:
+        lines = [
+            f'{self.num_stages} stage(s) x {self.gpus_per_stage} GPU(s), '
+            f'{self.num_micro_batches} micro-batch(es): '
+            f'{self.step_time * 1e3:.2f} ms/step, '
+            f'{self.throughput:.1f} samples/s'
+        ]
+        for s, stage in enumerate(self.stages):
+            kinds = {}
+            for choice in stage.choices:
+                key = (choice.kind if choice.groups == 1 else
+                       f'{choice.kind}x{choice.groups}')
+                kinds[key] = kinds.get(key, 0) + 1
+            layout = ', '.join(f'{n} {k}' for k, n in sorted(kinds.items()))
+            lines.append(f'  stage {s}: {len(stage.layers)} layers '
+                         f'({layout}), {stage.time * 1e3:.2f} ms/micro-batch, '
+                         f'{stage.memory / 2**30:.2f} GiB')
+        return '\n'.join(lines)
+
+
+def search(profile: List[LayerProfile],
+           num_gpus: int,
+           mini_batch_size: int,
+           gpu_memory: float,
+           comm: CommModel = CommModel(),
+           micro_batches: Optional[Iterable[int]] = None,
+           max_stages: Optional[int] = None) -> List[Plan]:
+    """Search parallel strategies for a model.
+
+    Args:
+        profile: Layers in execution order, e.g. from
+            `read_layer_profile`.
+        num_gpus: GPUs in the trainer.
+        mini_batch_size: Samples per optimization step.
+        gpu_memory: Bytes of memory per GPU.
+        comm: Interconnect model.
+        micro_batches: Candidate numbers of pipeline micro-batches.
+            By default 1, 2 and 4 times the number of stages.
+        max_stages: Largest number of pipeline stages to try.
+
+    Returns:
+        Plans that fit in memory, fastest first.
+
+    """
+    plans = []
+    max_stages = min(max_stages or num_gpus, len(profile))
+    for num_stages in _divisors(num_gpus):
+        if num_stages > max_stages:
+            break
+        procs = num_gpus // num_stages
+        counts = (micro_batches if micro_batches is not None else
+                  [num_stages, 2 * num_stages, 4 * num_stages])
+        if num_stages == 1 and micro_batches is None:
+            counts = [1]
+        for num_micro_batches in sorted(set(counts)):
+            if mini_batch_size % num_micro_batches != 0:
+                continue
+            micro_batch_size = mini_batch_size // num_micro_batches
+            choices = [
+                layer_choices(layer, procs, micro_batch_size)
+                for layer in profile
+            ]
+            if not all(choices):
+                continue
+
+            # Balance stages on each layer's best standalone time
+            times = [
+                min(layer_cost(layer, choice, procs, micro_batch_size,
+                               comm).time for choice in layer_choices)
+                for layer, layer_choices in zip(profile, choices)
+            ]
+            starts = partition_stages(times, num_stages) + [len(profile)]
+            stages = [
+                plan_stage(profile[starts[s]:starts[s + 1]], procs,
+                           micro_batch_size, comm)
+                for s in range(num_stages)
+            ]
+
+            # Boundary tensors are sent forward and their error
+            # signals backward. Stages keep the inputs of the
+            # micro-batches they have in flight.
+            stage_times = []
+            fits = True
+            for s, stage in enumerate(stages):
+                time = stage.time
+                memory = stage.memory
+                for boundary in (s, s + 1):
+                    if 0 < boundary < num_stages:
+                        layer = profile[starts[boundary] - 1]
+                        local_bytes = (layer.sample_bytes()
+                                       * micro_batch_size / procs)
+                        time += 2 * comm.send(local_bytes)
+                        if boundary == s:
+                            memory += (num_stages - s) * local_bytes
+                stage_times.append(time)
+                fits = fits and memory <= gpu_memory
+            if not fits:
+                continue
+
+            step_time = ((num_micro_batches + num_stages - 1)
+                         * max(stage_times)
+                         + max(stage.allreduce_time for stage in stages))
+            plans.append(Plan(num_gpus=num_gpus,
+                              mini_batch_size=mini_batch_size,
+                              num_micro_batches=num_micro_batches,
+                              stages=stages,
+                              step_time=step_time))
+    plans.sort(key=lambda plan: plan.step_time)
+    return plans
+
+
+def main(argv: Optional[List[str]] = None) -> None:
+    parser = argparse.ArgumentParser(
+        description='Search parallel strategies from measured layer costs')
+    parser.add_argument('--layer-profile', required=True,
+                        help='lbann-bench CSV from --bench_layers')
+    parser.add_argument('--comm-profile',
+                        help='lbann-comm-bench CSV (default: 5 us, 10 GB/s)')
+    parser.add_argument('--num-gpus', type=int, required=True)
+    parser.add_argument('--mini-batch-size', type=int, required=True)
+    parser.add_argument('--gpu-memory', type=float, default=16.,
+                        help='GiB per GPU (default: 16)')
+    parser.add_argument('--datatype', default='FLOAT')
+    parser.add_argument('--device', default='GPU')
+    parser.add_argument('--micro-batches', type=int, nargs='+',
+                        help='candidate numbers of micro-batches')
+    parser.add_argument('--max-stages', type=int,
+                        help='largest number of pipeline stages')
+    parser.add_argument('--top', type=int, default=5,
+                        help='number of plans to print (default: 5)')
+    parser.add_argument('--output',
+                        help='prototext file for the best plan')
+    args = parser.parse_args(argv)
+
+    profile = read_layer_profile(args.layer_profile, args.datatype,
+                                 args.device)
+    comm = (read_comm_profile(args.comm_profile, args.device)
+            if args.comm_profile else CommModel())
+    plans = search(profile,
+                   args.num_gpus,
+                   args.mini_batch_size,
+                   args.gpu_memory * 2**30,
+                   comm=comm,
+                   micro_batches=args.micro_batches,
+                   max_stages=args.max_stages)
+    if not plans:
+        raise SystemExit('no plan fits in GPU memory')
+    for plan in plans[:args.top]:
+        print(plan.summary())
+    if args.output:
+        best = plans[0]
+        with open(args.output, 'w') as f:
+            f.write(f'# {best.throughput:.1f} samples/s predicted on '
+                    f'{best.num_gpus} GPUs\n')
+            if best.num_stages > 1:
+                f.write(f'# Run with --num_subgrids_block_order='
+                        f'{best.num_stages} and '
+                        f'gradient_accumulation_steps: '
+                        f'{best.num_micro_batches}\n')
+            elif best.num_micro_batches > 1:
+                f.write(f'# Run with gradient_accumulation_steps: '
+                        f'{best.num_micro_batches}\n')
+            f.write(text_format.MessageToString(best.export_proto()))
+
+
+if __name__ == '__main__':
+    main()
@@ -42,6 +42,7 @@
 #include "lbann/comm_impl.hpp"
 #include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu_workspace.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/stack_trace.hpp"
@@ -181,6 +182,9 @@ void lbann::finalize_lbann(lbann_comm* comm)
 #ifdef LBANN_HAS_DNN_LIB
   dnn_lib::destroy();
 #endif
+#ifdef LBANN_HAS_GPU
+  gpu::free_workspaces();
+#endif
 #ifdef LBANN_HAS_EMBEDDED_PYTHON
   python::finalize();
 #endif
@@ -285,6 +289,9 @@ void lbann::finalize(lbann_comm* comm)
 #ifdef LBANN_HAS_DNN_LIB
   dnn_lib::destroy();
 #endif
+#ifdef LBANN_HAS_GPU
+  gpu::free_workspaces();
+#endif
 #ifdef LBANN_HAS_EMBEDDED_PYTHON
   python::finalize();
 #endif
@@ -482,6 +489,7 @@ CEREAL_FORCE_DYNAMIC_INIT(embedding_layer);
 CEREAL_FORCE_DYNAMIC_INIT(entrywise_batch_normalization_layer);
 CEREAL_FORCE_DYNAMIC_INIT(entrywise_scale_bias_layer);
 CEREAL_FORCE_DYNAMIC_INIT(evaluation_layer);
+CEREAL_FORCE_DYNAMIC_INIT(external_kernel_layer);
 CEREAL_FORCE_DYNAMIC_INIT(fully_connected_layer);
 CEREAL_FORCE_DYNAMIC_INIT(gather_layer);
 CEREAL_FORCE_DYNAMIC_INIT(gaussian_layer);
@@ -510,6 +518,7 @@ CEREAL_FORCE_DYNAMIC_INIT(relu_layer);
 CEREAL_FORCE_DYNAMIC_INIT(reshape_layer);
 CEREAL_FORCE_DYNAMIC_INIT(rotation_layer);
 CEREAL_FORCE_DYNAMIC_INIT(rowwise_weights_norms_layer);
+CEREAL_FORCE_DYNAMIC_INIT(scaled_dot_product_attention_layer);
 CEREAL_FORCE_DYNAMIC_INIT(scatter_layer);
 CEREAL_FORCE_DYNAMIC_INIT(selu_dropout);
 CEREAL_FORCE_DYNAMIC_INIT(slice_layer);
@@ -680,6 +689,8 @@ CEREAL_FORCE_DYNAMIC_INIT(data_type_optimizer);
 CEREAL_FORCE_DYNAMIC_INIT(adagrad);
 CEREAL_FORCE_DYNAMIC_INIT(adam);
 CEREAL_FORCE_DYNAMIC_INIT(hypergradient_adam);
+CEREAL_FORCE_DYNAMIC_INIT(lamb);
+CEREAL_FORCE_DYNAMIC_INIT(lars);
 CEREAL_FORCE_DYNAMIC_INIT(rmsprop);
 CEREAL_FORCE_DYNAMIC_INIT(sgd);
 
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/calibrate_int8.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/protobuf.hpp"
+#include "lbann/utils/serialize.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+namespace lbann {
+namespace callback {
+
+calibrate_int8::calibrate_int8(std::vector<std::string> layer_names,
+                               bool apply)
+  : m_layer_names(std::move(layer_names)), m_apply(apply)
+{}
+
+template <class Archive>
+void calibrate_int8::serialize(Archive& ar)
+{
+  ar(::cereal::make_nvp("BaseCallback",
+                        ::cereal::base_class<callback_base>(this)),
+     CEREAL_NVP(m_layer_names),
+     CEREAL_NVP(m_apply),
+     CEREAL_NVP(m_ranges));
+}
+
+void calibrate_int8::write_specific_proto(lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_calibrate_int8();
+  msg->set_layers(protobuf::to_space_sep_string(m_layer_names));
+  msg->set_calibrate_only(!m_apply);
+}
+
+bool calibrate_int8::is_selected(Layer const& l) const
+{
+  if (m_layer_names.empty()) {
+    return l.supports_int8_inference();
+  }
+  return std::find(m_layer_names.begin(),
+                   m_layer_names.end(),
+                   l.get_name()) != m_layer_names.end();
+}
+
+void calibrate_int8::on_evaluate_forward_prop_begin(model* m, Layer* l)
+{
+  // Once a layer runs in int8, its ranges are fixed
+  if (!is_selected(*l) || l->using_int8_inference()) {
+    return;
+  }
+  auto const* dtl = dynamic_cast<data_type_layer<DataType> const*>(l);
+  if (dtl == nullptr) {
+    return;
+  }
+  auto& ranges = m_ranges[l->get_name()];
+  ranges.resize(l->get_num_parents(), 0.);
+  for (int i = 0; i < l->get_num_parents(); ++i) {
+    auto const& local_input = dtl->get_local_prev_activations(i);
+    if (local_input.GetDevice() != El::Device::CPU) {
+      continue;
+    }
+    auto& range = ranges[i];
+    for (El::Int col = 0; col < local_input.Width(); ++col) {
+      for (El::Int row = 0; row < local_input.Height(); ++row) {
+        const double val = std::abs(local_input(row, col));
+        range = std::max(range, val);
+      }
+    }
+  }
+}
+
+void calibrate_int8::on_validation_end(model* m) { finish_calibration(m); }
+
+void calibrate_int8::on_test_end(model* m) { finish_calibration(m); }
+
+void calibrate_int8::finish_calibration(model* m)
+{
+  // Every rank records the same layers, in the same order
+  std::vector<double> local_ranges, ranges;
+  for (auto const& [name, layer_ranges] : m_ranges) {
+    local_ranges.insert(local_ranges.end(),
+                        layer_ranges.begin(),
+                        layer_ranges.end());
+  }
+  ranges.resize(local_ranges.size());
+  m->get_comm()->trainer_allreduce(local_ranges.data(),
+                                   static_cast<int>(local_ranges.size()),
+                                   ranges.data(),
+                                   El::mpi::MAX);
+  auto it = ranges.cbegin();
+  for (auto& [name, layer_ranges] : m_ranges) {
+    std::copy(it, it + layer_ranges.size(), layer_ranges.begin());
+    it += layer_ranges.size();
+  }
+
+  if (m_apply) {
+    apply(*m);
+  }
+}
+
+void calibrate_int8::apply(model& m) const
+{
+  std::vector<std::string> quantized, skipped;
+  for (auto* l : m.get_layers()) {
+    const auto it = m_ranges.find(l->get_name());
+    if (!is_selected(*l) || l->using_int8_inference()) {
+      continue;
+    }
+    if (it != m_ranges.end() && l->set_int8_input_ranges(it->second)) {
+      quantized.push_back(l->get_name());
+    }
+    else {
+      skipped.push_back(l->get_name());
+    }
+  }
+
+  if (m.get_comm()->am_trainer_master() &&
+      (!quantized.empty() || !skipped.empty())) {
+    std::ostringstream ss;
+    ss << name() << ": model \"" << m.get_name() << "\" runs "
+       << quantized.size() << " layers in int8";
+    for (auto const& layer_name : quantized) {
+      ss << " " << layer_name;
+    }
+    if (!skipped.empty()) {
+      ss << "; kept in full precision:";
+      for (auto const& layer_name : skipped) {
+        ss << " " << layer_name;
+      }
+    }
+    ss << "\n";
+    std::cout << ss.str();
+  }
+}
+
+std::unique_ptr<callback_base> build_calibrate_int8_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg,
+  std::shared_ptr<lbann_summary> const&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackCalibrateInt8&>(
+      proto_msg);
+  return std::make_unique<calibrate_int8>(
+    parse_list<std::string>(params.layers()),
+    !params.calibrate_only());
+}
+
+} // namespace callback
+} // namespace lbann
+
+#define LBANN_CLASS_NAME callback::calibrate_int8
+#define LBANN_CLASS_LIBNAME callback_calibrate_int8
+#include <lbann/macros/register_class_with_cereal.hpp>
@@ -253,6 +253,10 @@ void check_gradients::do_check_gradients(model& m) const
     return;
   }
 
+  // Finite differences need every objective function value right away
+  const auto metric_window = m.get_metric_accumulation_window();
+  m.set_metric_accumulation_window(1);
+
   // Reset statistics and gradients
   m.get_objective_function()->reset_statistics(mode);
   for (auto&& met : m.get_metrics()) {
@@ -339,6 +343,7 @@ void check_gradients::do_check_gradients(model& m) const
   for (auto&& met : m.get_metrics()) {
     met->reset_statistics(mode);
   }
+  m.set_metric_accumulation_window(metric_window);
 }
 
 // Builder function
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/callbacks/check_nan.hpp"
+#include "lbann/callbacks/tensor_check_flags.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
@@ -36,59 +37,13 @@
 
 #include <h2/patterns/multimethods/SwitchDispatcher.hpp>
 
+#include <sstream>
+
 namespace lbann {
 namespace callback {
 
 namespace {
 
-/** Check whether a matrix contains a NaN.
- *  If a NaN entry is detected, return true and output the local entry
- *  position in row and col. mat is assumed to be a CPU matrix.
- */
-template <typename TensorDataType>
-bool has_nan(const El::AbstractDistMatrix<TensorDataType>& mat,
-             El::Int& row,
-             El::Int& col)
-{
-  row = -1;
-  col = -1;
-  const auto& local_mat = mat.LockedMatrix();
-  for (El::Int j = 0; j < local_mat.Width(); ++j) {
-    for (El::Int i = 0; i < local_mat.Height(); ++i) {
-      if (std::isnan(local_mat(i, j))) {
-        row = i;
-        col = j;
-        return true;
-      }
-    }
-  }
-  return false;
-}
-
-/** Check whether a matrix contains an inf.
- *  If an inf entry is detected, return true and output the entry
- *  position in row and col. mat is assumed to be a CPU matrix.
- */
-template <typename TensorDataType>
-bool has_inf(const El::AbstractDistMatrix<TensorDataType>& mat,
-             El::Int& row,
-             El::Int& col)
-{
-  row = -1;
-  col = -1;
-  const auto& local_mat = mat.LockedMatrix();
-  for (El::Int j = 0; j < local_mat.Width(); ++j) {
-    for (El::Int i = 0; i < local_mat.Height(); ++i) {
-      if (std::isinf(local_mat(i, j))) {
-        row = i;
-        col = j;
-        return true;
-      }
-    }
-  }
-  return false;
-}
-
 struct DefaultErrorReporter
 {
   template <typename... Ts>
@@ -202,8 +157,21 @@ void dump_network(model* m)
     Dispatcher::Exec(DumpWeightsFunctor(m, c), *w);
   }
 }
+
+/** Number of tensors checked in a training step. */
+size_t count_checked_tensors(model& m)
+{
+  size_t count = 2 * m.get_weights().size();
+  for (const auto* l : m.get_layers()) {
+    count += l->get_num_children() + l->get_num_parents();
+  }
+  return count;
+}
+
 } // namespace
 
+check_nan::check_nan() : m_flags(tensor_check_kind::nonfinite) {}
+
 template <class Archive>
 void check_nan::serialize(Archive& ar)
 {
@@ -216,186 +184,93 @@ void check_nan::write_specific_proto(lbann_data::Callback& proto) const
   proto.mutable_check_nan();
 }
 
-void check_nan::on_forward_prop_end(model* m, Layer* l)
+void check_nan::report_tripped(model* m)
 {
-  using proxy_type =
-    El::AbstractDistMatrixReadDeviceProxy<DataType, El::Device::CPU>;
+  const auto labels = m_flags.tripped();
+  if (labels.empty()) {
+    return;
+  }
+  dump_network(m);
+  std::ostringstream tensors;
+  for (size_t i = 0; i < labels.size(); ++i) {
+    tensors << (i > 0 ? ", " : "") << labels[i];
+  }
+  LBANN_ERROR("rank ",
+              m->get_comm()->get_rank_in_world(),
+              ": NaN or inf found in step ",
+              m_checked_step,
+              " in ",
+              tensors.str());
+}
 
+void check_nan::on_batch_begin(model* m)
+{
+  report_tripped(m);
+  m_flags.begin_step(count_checked_tensors(*m));
+}
+
+void check_nan::on_forward_prop_end(model* m, Layer* l)
+{
   if (!m || !l)
     LBANN_ERROR("Model or layer pointer is null.");
 
   const auto& num_outputs = l->get_num_children();
+  const auto& dtl = dynamic_cast<data_type_layer<DataType>&>(*l);
   for (int i = 0; i < num_outputs; ++i) {
-    El::Int row, col;
-    auto const& dtl = dynamic_cast<data_type_layer<DataType>&>(*l);
-    proxy_type mat_proxy(dtl.get_activations(i));
-    if (has_nan(mat_proxy.GetLocked(), row, col)) {
-      dump_network(m);
-      std::string activation_id =
-        (num_outputs > 1 ? std::to_string(i) + " " : "");
-      LBANN_ERROR("rank ",
-                  m->get_comm()->get_rank_in_world(),
-                  ": "
-                  "local entry (",
-                  row,
-                  ",",
-                  col,
-                  ") is NaN "
-                  "in activations ",
-                  activation_id,
-                  "of layer \"",
-                  l->get_name(),
-                  "\"");
-    }
-    if (has_inf(mat_proxy.GetLocked(), row, col)) {
-      dump_network(m);
-      std::string activation_id =
-        (num_outputs > 1 ? std::to_string(i) + " " : "");
-      LBANN_ERROR("rank ",
-                  m->get_comm()->get_rank_in_world(),
-                  ": "
-                  "local entry (",
-                  row,
-                  ",",
-                  col,
-                  ") is inf "
-                  "in activations ",
-                  activation_id,
-                  "of layer \"",
-                  l->get_name(),
-                  "\"");
-    }
+    m_flags.check(dtl.get_activations(i),
+                  build_string("activations ",
+                               (num_outputs > 1 ? std::to_string(i) + " " : ""),
+                               "of layer \"",
+                               l->get_name(),
+                               "\""));
   }
 }
 
 void check_nan::on_backward_prop_end(model* m, Layer* l)
 {
-  using proxy_type =
-    El::AbstractDistMatrixReadDeviceProxy<DataType, El::Device::CPU>;
   const auto& num_inputs = l->get_num_parents();
+  const auto& dtl = dynamic_cast<data_type_layer<DataType>&>(*l);
   for (int i = 0; i < num_inputs; ++i) {
-    El::Int row, col;
-    auto const& dtl = dynamic_cast<data_type_layer<DataType>&>(*l);
-    proxy_type mat_proxy(dtl.get_error_signals(i));
-    if (has_nan(mat_proxy.GetLocked(), row, col)) {
-      dump_network(m);
-      std::string signal_id = (num_inputs > 1 ? std::to_string(i) + " " : "");
-      LBANN_ERROR("rank ",
-                  m->get_comm()->get_rank_in_world(),
-                  ": "
-                  "local entry (",
-                  row,
-                  ",",
-                  col,
-                  ") is NAN "
-                  "in error signals ",
-                  signal_id,
-                  " of layer \"",
-                  l->get_name(),
-                  "\"");
-    }
-    if (has_inf(mat_proxy.GetLocked(), row, col)) {
-      dump_network(m);
-      std::string signal_id = (num_inputs > 1 ? std::to_string(i) + " " : "");
-      LBANN_ERROR("rank ",
-                  m->get_comm()->get_rank_in_world(),
-                  ": "
-                  "local entry (",
-                  row,
-                  ",",
-                  col,
-                  ") is inf "
-                  "in error signals ",
-                  signal_id,
-                  " of layer \"",
-                  l->get_name(),
-                  "\"");
-    }
+    m_flags.check(dtl.get_error_signals(i),
+                  build_string("error signals ",
+                               (num_inputs > 1 ? std::to_string(i) + " " : ""),
+                               "of layer \"",
+                               l->get_name(),
+                               "\""));
   }
 }
 
 void check_nan::on_backward_prop_end(model* m)
 {
-  using proxy_type =
-    El::AbstractDistMatrixReadDeviceProxy<DataType, El::Device::CPU>;
   for (weights* w : m->get_weights()) {
     auto& dtw = dynamic_cast<data_type_weights<DataType>&>(*w);
     auto* opt = dtw.get_optimizer();
     if (opt != nullptr) {
-      El::Int row, col;
-      auto& grad = opt->get_gradient_sharded();
-      proxy_type mat_proxy(grad);
-      if (has_nan(mat_proxy.GetLocked(), row, col)) {
-        dump_network(m);
-        LBANN_ERROR("rank ",
-                    m->get_comm()->get_rank_in_world(),
-                    ": "
-                    "local entry (",
-                    row,
-                    ",",
-                    col,
-                    ") is NaN "
-                    "in gradient w.r.t. weights \"",
-                    w->get_name(),
-                    "\"");
-      }
-      if (has_inf(mat_proxy.GetLocked(), row, col)) {
-        dump_network(m);
-        LBANN_ERROR("rank ",
-                    m->get_comm()->get_rank_in_world(),
-                    ": "
-                    "local entry (",
-                    row,
-                    ",",
-                    col,
-                    ") is inf "
-                    "in gradient w.r.t. weights \"",
-                    w->get_name(),
-                    "\"");
-      }
+      m_flags.add(opt->get_gradient_sharded(),
+                  build_string("gradient w.r.t. weights \"",
+                               w->get_name(),
+                               "\""));
     }
   }
+  m_flags.check_added();
 }
 
 void check_nan::on_batch_end(model* m)
 {
-  using proxy_type =
-    El::AbstractDistMatrixReadDeviceProxy<DataType, El::Device::CPU>;
   for (weights* w : m->get_weights()) {
     auto& dtw = dynamic_cast<data_type_weights<DataType>&>(*w);
-    El::Int row, col;
-    proxy_type mat_proxy(dtw.get_values());
-    if (has_nan(mat_proxy.GetLocked(), row, col)) {
-      dump_network(m);
-      LBANN_ERROR("rank ",
-                  m->get_comm()->get_rank_in_world(),
-                  ": "
-                  "local entry (",
-                  row,
-                  ",",
-                  col,
-                  ") is NaN "
-                  "in weights \"",
-                  w->get_name(),
-                  "\"");
-    }
-    if (has_inf(mat_proxy.GetLocked(), row, col)) {
-      dump_network(m);
-      LBANN_ERROR("rank ",
-                  m->get_comm()->get_rank_in_world(),
-                  ": "
-                  "local entry (",
-                  row,
-                  ",",
-                  col,
-                  ") is inf "
-                  "in weights \"",
-                  w->get_name(),
-                  "\"");
-    }
+    m_flags.add(dtw.get_values(),
+                build_string("weights \"", w->get_name(), "\""));
   }
+  m_flags.check_added();
+  m_flags.end_step();
+  m_checked_step = m->get_execution_context().get_step();
 }
 
+void check_nan::on_epoch_end(model* m) { report_tripped(m); }
+
+void check_nan::on_train_end(model* m) { report_tripped(m); }
+
 } // namespace callback
 } // namespace lbann
 
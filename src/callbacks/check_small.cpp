@@ -33,32 +33,26 @@
 
 #include "lbann/proto/callbacks.pb.h"
 
+#include <sstream>
+
 namespace lbann {
 namespace callback {
 namespace {
-template <typename TensorDataType>
-bool is_good(const El::AbstractDistMatrix<TensorDataType>& m)
+
+/** Number of tensors checked in a training step. */
+size_t count_checked_tensors(model& m)
 {
-  static const TensorDataType threshold =
-    El::Sqrt(std::numeric_limits<TensorDataType>::min());
-
-  const auto& local_mat = m.LockedMatrix();
-  const El::Int height = local_mat.Height();
-  const El::Int width = local_mat.Width();
-  for (El::Int col = 0; col < width; ++col) {
-    for (El::Int row = 0; row < height; ++row) {
-      const auto val = std::abs(local_mat(row, col));
-      if (val > TensorDataType(0) && val <= threshold) {
-        std::cout << "Found small value " << val << " at (" << row << "," << col
-                  << ")!" << std::endl;
-        return false;
-      }
-    }
+  size_t count = 2 * m.get_weights().size();
+  for (const auto* l : m.get_layers()) {
+    count += l->get_num_children();
   }
-  return true;
+  return count;
 }
+
 } // namespace
 
+check_small::check_small() : m_flags(tensor_check_kind::small) {}
+
 template <class Archive>
 void check_small::serialize(Archive& ar)
 {
@@ -71,69 +65,69 @@ void check_small::write_specific_proto(lbann_data::Callback& proto) const
   proto.mutable_check_small();
 }
 
+void check_small::report_tripped(model* m)
+{
+  const auto labels = m_flags.tripped();
+  if (labels.empty()) {
+    return;
+  }
+  std::ostringstream tensors;
+  for (size_t i = 0; i < labels.size(); ++i) {
+    tensors << (i > 0 ? ", " : "") << labels[i];
+  }
+  LBANN_ERROR(name(),
+              ": "
+              "[",
+              std::to_string(m->get_comm()->get_rank_in_world()),
+              "]: "
+              "small values in ",
+              tensors.str(),
+              " "
+              "(step=",
+              std::to_string(m_checked_step),
+              ")");
+}
+
+void check_small::on_batch_begin(model* m)
+{
+  report_tripped(m);
+  m_flags.begin_step(count_checked_tensors(*m));
+}
+
 void check_small::on_forward_prop_end(model* m, Layer* l)
 {
-  const auto& c = m->get_execution_context();
   auto& dtl = dynamic_cast<data_type_layer<DataType>&>(*l);
-  const auto& acts = dtl.get_activations();
-  if (!is_good(acts)) {
-    LBANN_ERROR(name(),
-                ": "
-                "[",
-                std::to_string(m->get_comm()->get_rank_in_world()),
-                "]: "
-                "error in activations of ",
-                l->get_name(),
-                " "
-                "(step=",
-                std::to_string(c.get_step()),
-                ")");
-  }
+  m_flags.check(dtl.get_activations(), "activations of " + l->get_name());
 }
 
 void check_small::on_backward_prop_end(model* m)
 {
-  const auto& c = m->get_execution_context();
   for (weights* w : m->get_weights()) {
     auto& dtw = dynamic_cast<data_type_weights<DataType>&>(*w);
     auto* opt = dtw.get_optimizer();
-    if (opt != nullptr && !is_good(opt->get_gradient_sharded())) {
-      LBANN_ERROR(name(),
-                  ": "
-                  "[",
-                  std::to_string(m->get_comm()->get_rank_in_world()),
-                  "]: "
-                  "error in weights gradient of ",
-                  dtw.get_name(),
-                  " "
-                  "(step=",
-                  std::to_string(c.get_step()),
-                  ")");
+    if (opt != nullptr) {
+      m_flags.add(opt->get_gradient_sharded(),
+                  "weights gradient of " + dtw.get_name());
     }
   }
+  m_flags.check_added();
 }
 
 void check_small::on_batch_end(model* m)
 {
-  const auto& c = m->get_execution_context();
   for (weights* w : m->get_weights()) {
     auto& dtw = dynamic_cast<data_type_weights<DataType>&>(*w);
-    if (!is_good(dtw.get_values())) {
-      LBANN_ERROR(name(),
-                  ": "
-                  "[",
-                  std::to_string(m->get_comm()->get_rank_in_world()),
-                  "]: "
-                  "error in weights of ",
-                  w->get_name(),
-                  " "
-                  "(step=",
-                  std::to_string(c.get_step() - 1),
-                  ")");
-    }
+    m_flags.add(dtw.get_values(), "weights of " + w->get_name());
   }
+  m_flags.check_added();
+  m_flags.end_step();
+  m_checked_step = m->get_execution_context().get_step();
 }
 
+void check_small::on_epoch_end(model* m) { report_tripped(m); }
+
+void check_small::on_train_end(model* m) { report_tripped(m); }
+
 } // namespace callback
 } // namespace lbann
 
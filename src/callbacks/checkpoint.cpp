@@ -32,12 +32,21 @@
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/weights/weights.hpp"
 
 #include "lbann/proto/callbacks.pb.h"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <memory>
+#include <set>
+#include <sstream>
 #include <string>
+#include <tuple>
+#include <vector>
 
 namespace lbann {
 namespace {
@@ -79,10 +88,160 @@ size_t get_step_with_training_override(model& m, trainer& t)
 {
   return get_current_execution_context_with_training_override(m, t).get_step();
 }
+
+using file_list = checkpoint_writer::file_list;
+
+/** Name of the file written last in a rank's checkpoint directory */
+constexpr char const* checkpoint_complete_marker = ".complete";
+
+uint64_t get_total_bytes(file_list const& files)
+{
+  uint64_t bytes = 0;
+  for (auto const& f : files) {
+    bytes += f.second.size();
+  }
+  return bytes;
+}
+
+/** Distance in trainer ranks to the partner on another node, or 0 if
+ *  the trainer fits on one node. */
+int get_partner_offset(lbann_comm const& comm)
+{
+  int const ppn = comm.get_procs_per_node();
+  return (comm.get_procs_per_trainer() > ppn) ? ppn : 0;
+}
+
+/** Read every file below @c dir, with paths relative to it. Files in
+ *  @c pending (full paths, not yet on disk) are taken from memory. */
+file_list read_checkpoint_files(std::string const& dir,
+                                file_list const& pending)
+{
+  auto const relative_path = [&dir](std::string const& path) {
+    if (path.compare(0, dir.size(), dir) != 0) {
+      LBANN_ERROR("checkpoint file ", path, " is not in ", dir);
+    }
+    auto const pos = path.find_first_not_of('/', dir.size());
+    return (pos == std::string::npos) ? std::string() : path.substr(pos);
+  };
+  std::set<std::string> in_memory;
+  for (auto const& f : pending) {
+    in_memory.insert(relative_path(f.first));
+  }
+  file_list files;
+  for (auto const& rel : file::list_files(dir)) {
+    if (in_memory.count(rel) != 0 || rel == checkpoint_complete_marker) {
+      continue;
+    }
+    std::ifstream ifs(file::join_path(dir, rel), std::ios::binary);
+    if (!ifs) {
+      LBANN_ERROR("failed to open checkpoint file ", dir, "/", rel);
+    }
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    files.emplace_back(rel, oss.str());
+  }
+  for (auto const& f : pending) {
+    files.emplace_back(relative_path(f.first), f.second);
+  }
+  return files;
+}
+
+/** Prefix relative paths with @c dir and create the directories. */
+file_list place_files(std::string const& dir, file_list const& files)
+{
+  file_list placed;
+  placed.reserve(files.size());
+  for (auto const& f : files) {
+    placed.emplace_back(file::join_path(dir, f.first), f.second);
+    file::make_directory(file::extract_parent_directory(placed.back().first));
+  }
+  return placed;
+}
+
 } // namespace
 
 namespace callback {
 
+file_list exchange_checkpoint_files(lbann_comm& comm,
+                                    file_list const& files,
+                                    int send_rank,
+                                    int recv_rank,
+                                    uint64_t max_chunk)
+{
+  // Pack as (name length, name, size, contents) records
+  std::string snd;
+  auto const put_u64 = [&snd](uint64_t x) {
+    snd.append(reinterpret_cast<const char*>(&x), sizeof(x));
+  };
+  for (auto const& f : files) {
+    put_u64(f.first.size());
+    snd += f.first;
+    put_u64(f.second.size());
+    snd += f.second;
+  }
+
+  int const trainer = comm.get_trainer_rank();
+  uint64_t const snd_size = snd.size();
+  uint64_t rcv_size = 0;
+  comm.sendrecv<uint64_t, El::Device::CPU>(&snd_size,
+                                           1,
+                                           trainer,
+                                           send_rank,
+                                           &rcv_size,
+                                           1,
+                                           trainer,
+                                           recv_rank);
+  std::string rcv(rcv_size, '\0');
+  // Partners may hold different sizes, so every rank runs as many
+  // rounds as the largest transfer needs
+  uint64_t const max_size =
+    comm.trainer_allreduce(std::max(snd_size, rcv_size), El::mpi::MAX);
+  for (uint64_t off = 0; off < max_size; off += max_chunk) {
+    auto const chunk = [&](uint64_t size) {
+      return static_cast<int>(off < size ? std::min(max_chunk, size - off)
+                                         : 0);
+    };
+    comm.sendrecv<El::byte, El::Device::CPU>(
+      reinterpret_cast<const El::byte*>(snd.data()) + std::min(off, snd_size),
+      chunk(snd_size),
+      trainer,
+      send_rank,
+      reinterpret_cast<El::byte*>(&rcv[0]) + std::min(off, rcv_size),
+      chunk(rcv_size),
+      trainer,
+      recv_rank);
+  }
+
+  file_list received;
+  size_t pos = 0;
+  auto const get_u64 = [&rcv, &pos]() {
+    uint64_t x;
+    std::memcpy(&x, rcv.data() + pos, sizeof(x));
+    pos += sizeof(x);
+    return x;
+  };
+  while (pos < rcv.size()) {
+    auto const name_size = get_u64();
+    std::string name = rcv.substr(pos, name_size);
+    pos += name_size;
+    auto const size = get_u64();
+    received.emplace_back(std::move(name), rcv.substr(pos, size));
+    pos += size;
+  }
+  return received;
+}
+
+checkpoint_writer::file_list::value_type
+get_checkpoint_complete_marker(std::string const& dir)
+{
+  return {file::join_path(dir, checkpoint_complete_marker), ""};
+}
+
+bool is_checkpoint_complete(std::string const& dir)
+{
+  return file::file_exists(get_checkpoint_complete_marker(dir).first);
+}
+
 // Load from checkpoint occurs during setup callbacks
 void checkpoint::on_setup_begin(model* m) { reload_model(m); }
 
@@ -110,6 +269,10 @@ void checkpoint::on_train_end(model* m)
   if (need_checkpoint(m, callback_phase::epoch)) {
     do_checkpoint(m, visitor_hook::execution_mode_end);
   }
+  // Make every asynchronous checkpoint durable before returning
+  while (!m_pending_checkpoints.empty()) {
+    retire_oldest_checkpoint(*m->get_comm());
+  }
   p.set_cb_type(callback_type::invalid);
 }
 
@@ -250,6 +413,13 @@ bool checkpoint::do_checkpoint(model* m, visitor_hook hook)
   comm->trainer_broadcast(0, epoch);
   comm->trainer_broadcast(0, step);
 
+  // Bound the host memory held by asynchronous checkpoints and drains
+  while (!m_pending_checkpoints.empty() &&
+         m_pending_checkpoints.size() >=
+           static_cast<size_t>(m_max_inflight_checkpoints)) {
+    retire_oldest_checkpoint(*comm);
+  }
+
   // Distributed ckpt
   if (m_checkpoint_dist) {
     this->do_distributed_checkpoint(*comm,
@@ -273,7 +443,7 @@ bool checkpoint::do_checkpoint(model* m, visitor_hook hook)
                                step);
   }
 
-  uint64_t bytes_count = p.get_bytes();
+  uint64_t bytes_count = p.get_bytes() + m_async_bytes;
 
   if (comm->am_trainer_master()) {
     EvalType secs = timer.Stop();
@@ -286,14 +456,17 @@ bool checkpoint::do_checkpoint(model* m, visitor_hook hook)
               << (is_execution_mode_hook(hook)
                     ? to_string(hook, c.get_execution_mode())
                     : to_string(hook))
-              << "] to " << get_checkpoint_dir() << " complete: Epoch=" << epoch
-              << " Step=" << step << " (" << secs << " secs, " << bytes_count
-              << " bytes, " << bw << " MB/sec)" << std::endl;
+              << "] to " << get_checkpoint_dir()
+              << (m_async_checkpoint ? " snapshot" : "")
+              << " complete: Epoch=" << epoch << " Step=" << step << " ("
+              << secs << " secs, " << bytes_count << " bytes, " << bw
+              << " MB/sec)" << std::endl;
     fflush(stdout);
   }
   // record last checkpoint time in case checkpoint_secs interval defined.
   m_checkpoint_last = MPI_Wtime();
   p.reset_bytes();
+  m_async_bytes = 0;
   return true;
 }
 
@@ -307,66 +480,142 @@ std::string checkpoint::find_latest_checkpoint(lbann_comm& comm,
                                                bool& shared)
 {
   constexpr unsigned int max_len_dirname = 1024;
-  std::string dir;
-  size_t epoch_dist = 0;
-  size_t step_dist = 0;
 
-  // Grab latest checkpoint information, checks for latest in dist and shared,
-  // restarts from most recent between the two.
+  // Grab latest checkpoint information from every tier. Candidates are
+  // listed fastest first so that ties go to the node-local copy.
+  struct candidate
+  {
+    std::string dir;
+    bool shared;
+    bool local;
+    visitor_hook hook;
+    execution_mode mode;
+    size_t epoch;
+    size_t step;
+    int ranks;
+  };
+  std::vector<candidate> candidates;
+  int const ranks = comm.get_procs_per_trainer();
   if (comm.am_trainer_master()) {
-    std::string latest_file;
+    auto const add_candidate = [&](std::string const& dir,
+                                   std::string const& latest_file,
+                                   bool is_shared,
+                                   bool is_local) {
+      candidate c{dir, is_shared, is_local};
+      if (!read_latest(latest_file,
+                       &c.hook,
+                       &c.mode,
+                       &c.epoch,
+                       &c.step,
+                       &c.ranks)) {
+        return;
+      }
+      // Distributed checkpoints hold one directory per rank and cannot
+      // be re-partitioned, whereas shared ones are written from the
+      // trainer master and restart on any number of ranks.
+      if (!is_shared && c.ranks > 0 && c.ranks != ranks) {
+        LBANN_WARNING("skipping distributed checkpoint in ",
+                      dir,
+                      " written by ",
+                      c.ranks,
+                      " ranks per trainer (now ",
+                      ranks,
+                      ")");
+        return;
+      }
+      candidates.push_back(std::move(c));
+    };
     if (m_per_rank_dir.length()) {
-      dir = get_distributed_checkpoint_rootdir();
-      latest_file =
-        get_last_distributed_checkpoint_filename(trainer_name, alg_name, dir);
-      read_latest(latest_file, &hook, &mode, &epoch_dist, &step_dist);
+      auto const dir = get_distributed_checkpoint_rootdir();
+      add_candidate(
+        dir,
+        get_last_distributed_checkpoint_filename(trainer_name, alg_name, dir),
+        false,
+        true);
+      if (m_drain_interval > 0) {
+        auto const pfs_dir = get_restart_dir();
+        add_candidate(pfs_dir,
+                      get_last_distributed_checkpoint_filename(trainer_name,
+                                                               alg_name,
+                                                               pfs_dir),
+                      false,
+                      false);
+      }
     }
     if (get_restart_dir().length()) {
-      dir = get_shared_checkpoint_rootdir();
-      latest_file =
-        get_last_shared_checkpoint_filename(trainer_name, alg_name, dir);
-      read_latest(latest_file, &hook, &mode, &epoch, &step);
-    }
-
-    if (epoch > epoch_dist) {
-      dir = get_shared_checkpoint_rootdir();
-      shared = 1;
-    }
-    else if (epoch == epoch_dist && step > step_dist) {
-      dir = get_shared_checkpoint_rootdir();
-      shared = 1;
-    }
-    else {
-      dir = get_distributed_checkpoint_rootdir();
-      step = step_dist;
-      epoch = epoch_dist;
-      shared = 0;
+      auto const dir = get_shared_checkpoint_rootdir();
+      add_candidate(
+        dir,
+        get_last_shared_checkpoint_filename(trainer_name, alg_name, dir),
+        true,
+        false);
     }
+    std::stable_sort(candidates.begin(),
+                     candidates.end(),
+                     [](candidate const& a, candidate const& b) {
+                       return std::tie(a.epoch, a.step) >
+                              std::tie(b.epoch, b.step);
+                     });
   }
-  // Update other ranks on where we are loading from.
+
+  // Update other ranks on where we are loading from. A node-local
+  // checkpoint is only used if every rank can read it, otherwise the
+  // next most recent one is tried.
   // TODO: we would want to prepend dir with the model name and model rank:
   // m->get_name() + '.' + std::to_string(comm->get_trainer_rank()) + '.'
   header_t<max_len_dirname> header;
-  std::memset(&header, 0x0, sizeof(header_t<max_len_dirname>));
-
-  if (comm.am_trainer_master()) {
-    header.hook = hook;
-    header.mode = mode;
-    header.epoch = epoch;
-    header.step = step;
-    header.shared = shared;
-    dir.copy(header.dirname, dir.length(), 0);
-  }
+  std::string dir;
+  for (size_t i = 0;; ++i) {
+    std::memset(&header, 0x0, sizeof(header_t<max_len_dirname>));
+    if (comm.am_trainer_master()) {
+      if (i < candidates.size()) {
+        auto const& c = candidates[i];
+        header.hook = c.hook;
+        header.mode = c.mode;
+        header.epoch = c.epoch;
+        header.step = c.step;
+        header.shared = c.shared;
+        header.local = c.local;
+        c.dir.copy(header.dirname, c.dir.length(), 0);
+      }
+      else {
+        header.hook = visitor_hook::invalid;
+        header.mode = execution_mode::invalid;
+        header.epoch = -1;
+        header.step = -1;
+      }
+    }
 
-  comm.trainer_broadcast(0, header);
+    comm.trainer_broadcast(0, header);
 
-  if (!comm.am_trainer_master()) {
     hook = header.hook;
     mode = header.mode;
     epoch = header.epoch;
     step = header.step;
     shared = header.shared;
     dir = header.dirname;
+    if (!header.local || recover_local_checkpoint(comm,
+                                                  trainer_name,
+                                                  alg_name,
+                                                  dir,
+                                                  hook,
+                                                  mode,
+                                                  epoch,
+                                                  step)) {
+      if (comm.am_trainer_master() && i < candidates.size() &&
+          candidates[i].ranks > 0 && candidates[i].ranks != ranks) {
+        std::cout << "[" << trainer_name << "] resizing from "
+                  << candidates[i].ranks << " to " << ranks
+                  << " ranks per trainer using the shared checkpoint in "
+                  << dir << std::endl;
+      }
+      break;
+    }
+    if (comm.am_trainer_master()) {
+      LBANN_WARNING("node-local checkpoint in ",
+                    dir,
+                    " is incomplete, trying the next most recent one");
+    }
   }
   return dir;
 }
@@ -544,6 +793,12 @@ void checkpoint::write_specific_proto(lbann_data::Callback& proto) const
   msg->set_per_rank_dir(m_per_rank_dir);
   msg->set_ckpt_dist_epochs(m_ckpt_dist_epochs);
   msg->set_ckpt_dist_steps(m_ckpt_dist_steps);
+  msg->set_async_checkpoint(m_async_checkpoint);
+  msg->set_max_inflight_checkpoints(m_max_inflight_checkpoints);
+  msg->set_drain_interval(m_drain_interval);
+  msg->set_partner_replication(m_partner_replication);
+  msg->set_incremental_checkpoint(m_incremental_checkpoint);
+  msg->set_max_incremental_chain(m_max_incremental_chain);
 }
 
 void checkpoint::do_distributed_checkpoint(lbann_comm& comm,
@@ -603,9 +858,13 @@ void checkpoint::do_distributed_checkpoint(lbann_comm& comm,
   // Call top level save to checkpoint function in model, in turn
   // calls save to checkpoint functions for other model classes
   // (weights, layers)
+  checkpoint_writer::file_list model_files;
   if ((p.get_cb_type() == callback_type::model_only) ||
       (p.get_cb_type() == callback_type::full_checkpoint)) {
-    m.save_to_checkpoint_distributed(p);
+    // A drained copy must not build on node-local checkpoints
+    bool const drains = (m_per_rank_dir.length() != 0 && m_drain_interval > 0 &&
+                         (m_num_local_checkpoints + 1) % m_drain_interval == 0);
+    model_files = save_model(comm, m, p, epochdir, false, drains);
   }
   if ((p.get_cb_type() == callback_type::execution_context_only) ||
       (p.get_cb_type() == callback_type::full_checkpoint)) {
@@ -613,13 +872,62 @@ void checkpoint::do_distributed_checkpoint(lbann_comm& comm,
   }
   p.close_checkpoint();
 
+  bool drain = false;
+  checkpoint_writer::file_list drain_files;
+  if (m_per_rank_dir.length() != 0) {
+    drain = update_local_tier(comm,
+                              t,
+                              hook,
+                              mode,
+                              epoch,
+                              step,
+                              epochdir,
+                              model_files,
+                              drain_files);
+  }
+
+  // Mark this rank's files complete after all of them are written
+  if (m_async_checkpoint) {
+    model_files.push_back(get_checkpoint_complete_marker(epochdir));
+  }
+  else {
+    checkpoint_writer::write_files({get_checkpoint_complete_marker(epochdir)});
+  }
+
   // Print latest checkpoint to file
-  if (comm.am_trainer_master()) {
-    auto const latest_file = get_last_distributed_checkpoint_filename(
-      t.get_name(),
-      this->get_active_training_algorithm().get_type(),
-      dir);
-    write_latest(latest_file, hook, mode, epoch, step);
+  auto const latest_file = get_last_distributed_checkpoint_filename(
+    t.get_name(),
+    this->get_active_training_algorithm().get_type(),
+    dir);
+  if (m_async_checkpoint) {
+    m_async_bytes += get_total_bytes(model_files);
+    queue_async_checkpoint(std::move(model_files),
+                           latest_file,
+                           hook,
+                           mode,
+                           epoch,
+                           step);
+  }
+  else if (comm.am_trainer_master()) {
+    write_latest(latest_file,
+                 hook,
+                 mode,
+                 epoch,
+                 step,
+                 comm.get_procs_per_trainer());
+  }
+
+  // The drained copy gets its own marker once it is on disk
+  if (drain) {
+    queue_async_checkpoint(std::move(drain_files),
+                           get_last_distributed_checkpoint_filename(
+                             t.get_name(),
+                             this->get_active_training_algorithm().get_type(),
+                             this->get_checkpoint_dir()),
+                           hook,
+                           mode,
+                           epoch,
+                           step);
   }
 }
 
@@ -650,9 +958,10 @@ void checkpoint::do_shared_checkpoint(lbann_comm& comm,
 
   // Make sure that the master has had a chance to create the directories
   comm.trainer_barrier();
+  checkpoint_writer::file_list model_files;
   if ((p.get_cb_type() == callback_type::model_only) ||
       (p.get_cb_type() == callback_type::full_checkpoint)) {
-    m.save_to_checkpoint_shared(p);
+    model_files = save_model(comm, m, p, epochdir, true, false);
   }
   if ((p.get_cb_type() == callback_type::execution_context_only) ||
       (p.get_cb_type() == callback_type::full_checkpoint)) {
@@ -661,13 +970,308 @@ void checkpoint::do_shared_checkpoint(lbann_comm& comm,
 
   // close our checkpoint
   p.close_checkpoint();
+  auto const latest_file = get_last_shared_checkpoint_filename(
+    t.get_name(),
+    this->get_active_training_algorithm().get_type(),
+    dir);
+  if (m_async_checkpoint) {
+    m_async_bytes += get_total_bytes(model_files);
+    queue_async_checkpoint(std::move(model_files),
+                           latest_file,
+                           hook,
+                           mode,
+                           epoch,
+                           step);
+  }
+  else if (comm.am_trainer_master()) {
+    write_latest(latest_file,
+                 hook,
+                 mode,
+                 epoch,
+                 step,
+                 comm.get_procs_per_trainer());
+  }
+}
+
+file_list checkpoint::save_model(lbann_comm& comm,
+                                 model& m,
+                                 persist& p,
+                                 std::string const& epochdir,
+                                 bool shared,
+                                 bool force_full)
+{
+  file_list model_files;
+  std::unique_ptr<incremental_checkpoint_scope> scope;
+  std::string chain;
+  if (m_incremental_checkpoint) {
+    std::set<std::string> skip;
+    chain = start_incremental_checkpoint(
+      comm,
+      m,
+      shared ? m_shared_chain : m_distributed_chain,
+      epochdir,
+      force_full,
+      skip);
+    scope = std::make_unique<incremental_checkpoint_scope>(std::move(skip));
+  }
+
+  if (m_async_checkpoint) {
+    model_files = shared ? m.snapshot_checkpoint_shared(p)
+                         : m.snapshot_checkpoint_distributed(p);
+  }
+  else if (shared) {
+    m.save_to_checkpoint_shared(p);
+  }
+  else {
+    m.save_to_checkpoint_distributed(p);
+  }
+
+  // Record the checkpoint this one builds on next to the model archive
+  if (m_incremental_checkpoint && (!shared || comm.am_trainer_master())) {
+    file_list chain_file{
+      {file::join_path(epochdir, m.get_name(), "model.chain"), chain + "\n"}};
+    if (m_async_checkpoint) {
+      model_files.push_back(std::move(chain_file.front()));
+    }
+    else {
+      checkpoint_writer::write_files(chain_file);
+    }
+  }
+  return model_files;
+}
+
+std::string
+checkpoint::start_incremental_checkpoint(lbann_comm& comm,
+                                         model& m,
+                                         incremental_chain& chain,
+                                         std::string const& epochdir,
+                                         bool force_full,
+                                         std::set<std::string>& skip)
+{
+  auto const weights_list = m.get_weights();
+  bool const full = (force_full || chain.epochdir.empty() ||
+                     chain.length >= m_max_incremental_chain);
+
+  // Weights are unchanged only if no rank has seen a new version
+  std::vector<int> changed(weights_list.size(), 1);
+  if (!full) {
+    for (size_t i = 0; i < weights_list.size(); ++i) {
+      auto const it = chain.versions.find(weights_list[i]->get_name());
+      changed[i] = (it == chain.versions.end() ||
+                    it->second != weights_list[i]->get_version());
+    }
+  }
+  if (!changed.empty()) {
+    comm.trainer_allreduce(changed.data(),
+                           changed.size(),
+                           changed.data(),
+                           El::mpi::MAX);
+  }
+
+  std::string parent;
+  if (!full) {
+    for (size_t i = 0; i < weights_list.size(); ++i) {
+      if (!changed[i]) {
+        skip.insert(weights_list[i]->get_name());
+      }
+    }
+    parent = file::join_path("..",
+                             "..",
+                             file::extract_base_name(chain.epochdir),
+                             m.get_name());
+  }
+
+  chain.versions.clear();
+  for (auto const* w : weights_list) {
+    chain.versions[w->get_name()] = w->get_version();
+  }
+  chain.length = full ? 0 : chain.length + 1;
+  chain.epochdir = epochdir;
+  return parent;
+}
+
+void checkpoint::queue_async_checkpoint(checkpoint_writer::file_list files,
+                                        std::string latest_file,
+                                        visitor_hook hook,
+                                        execution_mode mode,
+                                        size_t epoch,
+                                        size_t step)
+{
+  if (!m_writer) {
+    m_writer = std::make_shared<checkpoint_writer>();
+  }
+  auto const ticket = m_writer->submit(std::move(files));
+  m_pending_checkpoints.push_back(
+    {ticket, std::move(latest_file), hook, mode, epoch, step});
+}
+
+void checkpoint::retire_oldest_checkpoint(lbann_comm& comm)
+{
+  auto const pending = std::move(m_pending_checkpoints.front());
+  m_pending_checkpoints.pop_front();
+  m_writer->wait(pending.ticket);
+
+  // Every rank's files must be on disk before the marker names them
+  comm.trainer_barrier();
   if (comm.am_trainer_master()) {
-    auto const latest_file = get_last_shared_checkpoint_filename(
+    write_latest(pending.latest_file,
+                 pending.hook,
+                 pending.mode,
+                 pending.epoch,
+                 pending.step,
+                 comm.get_procs_per_trainer());
+  }
+}
+
+bool checkpoint::update_local_tier(lbann_comm& comm,
+                                   trainer& t,
+                                   visitor_hook hook,
+                                   execution_mode mode,
+                                   size_t epoch,
+                                   size_t step,
+                                   std::string const& epochdir,
+                                   file_list& model_files,
+                                   file_list& drain_files)
+{
+  ++m_num_local_checkpoints;
+  int const offset = m_partner_replication ? get_partner_offset(comm) : 0;
+  bool const drain = (m_drain_interval > 0 &&
+                      m_num_local_checkpoints % m_drain_interval == 0);
+  if (m_partner_replication && offset == 0 && m_num_local_checkpoints == 1 &&
+      comm.am_trainer_master()) {
+    LBANN_WARNING("trainer fits on one node, "
+                  "skipping partner replication of checkpoints");
+  }
+  if (offset == 0 && !drain) {
+    return false;
+  }
+
+  auto const files = read_checkpoint_files(epochdir, model_files);
+  auto const& alg_name = this->get_active_training_algorithm().get_type();
+  int const rank = comm.get_rank_in_trainer();
+
+  if (offset != 0) {
+    // Keep the previous node's files next to our own
+    int const n = comm.get_procs_per_trainer();
+    int const next = (rank + offset) % n;
+    int const prev = (rank + n - offset) % n;
+    auto const replica_dir = get_distributed_checkpoint_dirname(
       t.get_name(),
-      this->get_active_training_algorithm().get_type(),
-      dir);
-    write_latest(latest_file, hook, mode, epoch, step);
+      alg_name,
+      prev,
+      m_per_rank_dir + "/" + this->get_checkpoint_dir() + "/partner",
+      hook,
+      mode,
+      epoch,
+      step);
+    auto replica =
+      place_files(replica_dir,
+                  exchange_checkpoint_files(comm, files, next, prev));
+    replica.push_back(get_checkpoint_complete_marker(replica_dir));
+    if (m_async_checkpoint) {
+      m_async_bytes += get_total_bytes(replica);
+      model_files.insert(model_files.end(),
+                         std::make_move_iterator(replica.begin()),
+                         std::make_move_iterator(replica.end()));
+    }
+    else {
+      checkpoint_writer::write_files(replica);
+    }
+  }
+
+  if (drain) {
+    auto const drain_dir =
+      get_distributed_checkpoint_dirname(t.get_name(),
+                                         alg_name,
+                                         rank,
+                                         this->get_checkpoint_dir(),
+                                         hook,
+                                         mode,
+                                         epoch,
+                                         step);
+    drain_files = place_files(drain_dir, files);
+    drain_files.push_back(get_checkpoint_complete_marker(drain_dir));
   }
+  return drain;
+}
+
+bool checkpoint::recover_local_checkpoint(lbann_comm& comm,
+                                          std::string const& trainer_name,
+                                          std::string const& alg_name,
+                                          std::string const& dir,
+                                          visitor_hook hook,
+                                          execution_mode mode,
+                                          size_t epoch,
+                                          size_t step)
+{
+  int const rank = comm.get_rank_in_trainer();
+  auto const epochdir = get_distributed_checkpoint_dirname(trainer_name,
+                                                           alg_name,
+                                                           rank,
+                                                           dir,
+                                                           hook,
+                                                           mode,
+                                                           epoch,
+                                                           step);
+  uint64_t const need = is_checkpoint_complete(epochdir) ? 0 : 1;
+  int const offset = m_partner_replication ? get_partner_offset(comm) : 0;
+  if (offset == 0) {
+    return comm.trainer_allreduce(need, El::mpi::MAX) == 0;
+  }
+
+  // Our replica is on the next node; we hold the previous node's
+  int const n = comm.get_procs_per_trainer();
+  int const next = (rank + offset) % n;
+  int const prev = (rank + n - offset) % n;
+  int const trainer = comm.get_trainer_rank();
+  auto const replica_dir = get_distributed_checkpoint_dirname(trainer_name,
+                                                              alg_name,
+                                                              prev,
+                                                              dir + "/partner",
+                                                              hook,
+                                                              mode,
+                                                              epoch,
+                                                              step);
+  uint64_t const have_replica = is_checkpoint_complete(replica_dir) ? 1 : 0;
+  uint64_t prev_needs = 0;
+  uint64_t next_has = 0;
+  comm.sendrecv<uint64_t, El::Device::CPU>(&need,
+                                           1,
+                                           trainer,
+                                           next,
+                                           &prev_needs,
+                                           1,
+                                           trainer,
+                                           prev);
+  comm.sendrecv<uint64_t, El::Device::CPU>(&have_replica,
+                                           1,
+                                           trainer,
+                                           prev,
+                                           &next_has,
+                                           1,
+                                           trainer,
+                                           next);
+  uint64_t const lost = (need != 0 && next_has == 0) ? 1 : 0;
+  if (comm.trainer_allreduce(lost, El::mpi::MAX) != 0) {
+    return false;
+  }
+  if (comm.trainer_allreduce(need, El::mpi::MAX) == 0) {
+    return true;
+  }
+
+  // Send replicas back to the ranks that lost their files
+  file_list replica;
+  if (prev_needs != 0) {
+    replica = read_checkpoint_files(replica_dir, {});
+  }
+  auto restored = exchange_checkpoint_files(comm, replica, prev, next);
+  if (need != 0) {
+    auto files = place_files(epochdir, restored);
+    files.push_back(get_checkpoint_complete_marker(epochdir));
+    checkpoint_writer::write_files(files);
+  }
+  comm.trainer_barrier();
+  return true;
 }
 
 trainer& checkpoint::get_active_trainer()
@@ -809,7 +1413,8 @@ bool write_latest(std::string filename,
                   visitor_hook hook,
                   execution_mode mode,
                   size_t epoch,
-                  size_t train)
+                  size_t train,
+                  int procs_per_trainer)
 {
   // open the file for writing
   int fd = openwrite(filename.c_str());
@@ -817,11 +1422,23 @@ bool write_latest(std::string filename,
     char field[256];
     std::string hookStr =
       is_execution_mode_hook(hook) ? to_string(hook, mode) : to_string(hook);
-    sprintf(field,
-            "hook=%s epoch=%ld step=%ld\n",
-            hookStr.c_str(),
-            epoch,
-            train);
+    // The rank count goes last so that older readers still parse the
+    // first three fields
+    if (procs_per_trainer > 0) {
+      sprintf(field,
+              "hook=%s epoch=%ld step=%ld ranks=%d\n",
+              hookStr.c_str(),
+              epoch,
+              train,
+              procs_per_trainer);
+    }
+    else {
+      sprintf(field,
+              "hook=%s epoch=%ld step=%ld\n",
+              hookStr.c_str(),
+              epoch,
+              train);
+    }
     write_string(fd, filename.c_str(), field, strlen(field));
     // close our file
     closewrite(fd, filename.c_str());
@@ -836,13 +1453,18 @@ bool read_latest(std::string filename,
                  visitor_hook* hook,
                  execution_mode* mode,
                  size_t* epochLast,
-                 size_t* trainLast)
+                 size_t* trainLast,
+                 int* procs_per_trainer)
 {
   // assume we don't have a file, we'll return -1 in that case
   *epochLast = -1;
   *trainLast = -1;
   *mode = execution_mode::invalid;
   *hook = visitor_hook::invalid;
+  int ranks = 0;
+  if (procs_per_trainer != nullptr) {
+    *procs_per_trainer = 0;
+  }
   // open the file for reading
   int fd = openread(filename.c_str());
   if (fd != -1) {
@@ -851,16 +1473,20 @@ bool read_latest(std::string filename,
     read_string(fd, filename.c_str(), field, sizeof(field));
     char hookStr[64];
     int ret = sscanf(field,
-                     "hook=%s epoch=%ld step=%ld\n",
+                     "hook=%63s epoch=%ld step=%ld ranks=%d\n",
                      hookStr,
                      epochLast,
-                     trainLast);
+                     trainLast,
+                     &ranks);
     visitor_hook_from_string(hookStr, *hook, *mode);
     // close our file
     closeread(fd, filename.c_str());
-    if (ret != 3) {
+    if (ret < 3) {
       return false;
     }
+    if (procs_per_trainer != nullptr && ret == 4) {
+      *procs_per_trainer = ranks;
+    }
     return true;
   }
   return false;
@@ -878,7 +1504,13 @@ build_checkpoint_callback_from_pbuf(const google::protobuf::Message& proto_msg)
                                       params.checkpoint_secs(),
                                       params.per_rank_dir(),
                                       params.ckpt_dist_epochs(),
-                                      params.ckpt_dist_steps());
+                                      params.ckpt_dist_steps(),
+                                      params.async_checkpoint(),
+                                      params.max_inflight_checkpoints(),
+                                      params.drain_interval(),
+                                      params.partner_replication(),
+                                      params.incremental_checkpoint(),
+                                      params.max_incremental_chain());
 }
 
 } // namespace callback
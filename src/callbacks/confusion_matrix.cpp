@@ -33,35 +33,154 @@
 
 #include "lbann/proto/callbacks.pb.h"
 
+#include <algorithm>
 #include <fstream>
+#include <map>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace lbann {
 namespace callback {
 
+namespace {
+
+std::unique_ptr<El::AbstractMatrix<El::Int>> make_counts_matrix(El::Device d)
+{
+  switch (d) {
+  case El::Device::CPU:
+    return std::make_unique<El::Matrix<El::Int, El::Device::CPU>>();
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    return std::make_unique<El::Matrix<El::Int, El::Device::GPU>>();
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+}
+
+/** Count the one-hot columns, whose key is j + i * num_classes for
+ *  prediction i and label j, or -1 if there is no prediction or label.
+ *  If @c dense, out is the counts, otherwise out(0,k) gets the key of
+ *  column k. */
+void count_samples_impl(
+  const El::Matrix<DataType, El::Device::CPU>& predictions,
+  const El::Matrix<DataType, El::Device::CPU>& labels,
+  bool dense,
+  El::Matrix<El::Int, El::Device::CPU>& out)
+{
+  constexpr DataType zero = 0;
+  const El::Int num_classes = predictions.Height();
+  const El::Int width = predictions.Width();
+  std::vector<El::Int> keys(width);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < width; ++col) {
+    El::Int prediction_index = -1, label_index = -1;
+    for (El::Int row = 0; row < num_classes; ++row) {
+      if (predictions(row, col) != zero) {
+        prediction_index = row;
+      }
+      if (labels(row, col) != zero) {
+        label_index = row;
+      }
+    }
+    keys[col] = (prediction_index >= 0 && label_index >= 0
+                   ? label_index + prediction_index * num_classes
+                   : -1);
+  }
+  for (El::Int col = 0; col < width; ++col) {
+    if (!dense) {
+      out(0, col) = keys[col];
+    }
+    else if (keys[col] >= 0) {
+      out(keys[col], 0)++;
+    }
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+void count_samples_impl(
+  const El::Matrix<DataType, El::Device::GPU>& predictions,
+  const El::Matrix<DataType, El::Device::GPU>& labels,
+  bool dense,
+  El::Matrix<El::Int, El::Device::GPU>& out)
+{
+  confusion_matrix_count_gpu(predictions, labels, dense, out);
+}
+#endif // LBANN_HAS_GPU
+
+/** Add a mini-batch to dense counts, or append the keys of its
+ *  samples to the sparse ones. */
+template <El::Device D>
+void count_samples(const El::AbstractMatrix<DataType>& predictions,
+                   const El::AbstractMatrix<DataType>& labels,
+                   bool dense,
+                   std::unique_ptr<El::AbstractMatrix<El::Int>>& data,
+                   El::Int& num_keys)
+{
+  using MatType = El::Matrix<DataType, D>;
+  using IntMatType = El::Matrix<El::Int, D>;
+  const auto& local_predictions = static_cast<const MatType&>(predictions);
+  const auto& local_labels = static_cast<const MatType&>(labels);
+  const El::Int width = local_predictions.Width();
+  IntMatType out;
+  if (dense) {
+    El::View(out, static_cast<IntMatType&>(*data));
+  }
+  else {
+    // The keys are kept for the whole epoch, so the buffer grows
+    // geometrically
+    auto& keys = static_cast<IntMatType&>(*data);
+    if (num_keys + width > keys.Width()) {
+      auto new_keys = std::make_unique<IntMatType>(
+        1,
+        std::max(2 * keys.Width(), num_keys + width));
+      if (num_keys > 0) {
+        IntMatType old_view, new_view;
+        El::LockedView(old_view, keys, El::IR(0, 1), El::IR(0, num_keys));
+        El::View(new_view, *new_keys, El::IR(0, 1), El::IR(0, num_keys));
+        El::Copy(old_view, new_view);
+      }
+      data = std::move(new_keys);
+    }
+    El::View(out,
+             static_cast<IntMatType&>(*data),
+             El::IR(0, 1),
+             El::IR(num_keys, num_keys + width));
+    num_keys += width;
+  }
+  count_samples_impl(local_predictions, local_labels, dense, out);
+}
+
+} // namespace
+
 // ---------------------------------------------------------
 // Constructors
 // ---------------------------------------------------------
 
 confusion_matrix::confusion_matrix(std::string&& prediction_layer,
                                    std::string&& label_layer,
-                                   std::string&& prefix)
+                                   std::string&& prefix,
+                                   El::Int max_dense_classes)
   : callback_base(1),
     m_prediction_layer(std::move(prediction_layer)),
     m_label_layer(std::move(label_layer)),
-    m_prefix(std::move(prefix))
+    m_prefix(std::move(prefix)),
+    m_max_dense_classes(max_dense_classes)
 {}
 
 confusion_matrix::confusion_matrix(std::string const& prediction_layer,
                                    std::string const& label_layer,
-                                   std::string const& prefix)
+                                   std::string const& prefix,
+                                   El::Int max_dense_classes)
   : callback_base(1),
     m_prediction_layer(prediction_layer),
     m_label_layer(label_layer),
-    m_prefix(prefix)
+    m_prefix(prefix),
+    m_max_dense_classes(max_dense_classes)
 {}
 
 confusion_matrix::confusion_matrix(const confusion_matrix& other)
@@ -69,22 +188,32 @@ confusion_matrix::confusion_matrix(const confusion_matrix& other)
     m_prediction_layer(other.m_prediction_layer),
     m_label_layer(other.m_label_layer),
     m_prefix(other.m_prefix),
-    m_counts(other.m_counts),
+    m_max_dense_classes(other.m_max_dense_classes),
     m_predictions_v(other.m_predictions_v ? other.m_predictions_v->Copy()
                                           : nullptr),
     m_labels_v(other.m_labels_v ? other.m_labels_v->Copy() : nullptr)
-{}
+{
+  for (const auto& [mode, counts] : other.m_counts) {
+    auto& copy = m_counts[mode];
+    if (counts.data != nullptr) {
+      copy.data = make_counts_matrix(counts.data->GetDevice());
+      El::Copy(*counts.data, *copy.data);
+    }
+    copy.num_keys = counts.num_keys;
+  }
+}
 
 confusion_matrix& confusion_matrix::operator=(const confusion_matrix& other)
 {
+  confusion_matrix copy(other);
   callback_base::operator=(other);
-  m_prediction_layer = other.m_prediction_layer;
-  m_label_layer = other.m_label_layer;
-  m_prefix = other.m_prefix;
-  m_counts = other.m_counts;
-  m_predictions_v.reset(other.m_predictions_v ? other.m_predictions_v->Copy()
-                                              : nullptr);
-  m_labels_v.reset(other.m_labels_v ? other.m_labels_v->Copy() : nullptr);
+  m_prediction_layer = std::move(copy.m_prediction_layer);
+  m_label_layer = std::move(copy.m_label_layer);
+  m_prefix = std::move(copy.m_prefix);
+  m_max_dense_classes = copy.m_max_dense_classes;
+  m_counts = std::move(copy.m_counts);
+  m_predictions_v = std::move(copy.m_predictions_v);
+  m_labels_v = std::move(copy.m_labels_v);
   return *this;
 }
 
@@ -96,13 +225,23 @@ void confusion_matrix::setup(model* m)
 {
   callback_base::setup(m);
 
-  // Initialize matrix views/copies
+  // Initialize matrix views/copies. Each rank needs the whole
+  // columns of its samples.
   const auto& predictions = get_predictions(*m);
   const auto& labels = get_labels(*m);
-  auto dist_data = predictions.DistData();
-  dist_data.device = El::Device::CPU;
-  m_predictions_v.reset(AbsDistMatType::Instantiate(dist_data));
-  m_labels_v.reset(AbsDistMatType::Instantiate(dist_data));
+  const auto dist_data = predictions.DistData();
+  if (predictions.ColStride() == 1) {
+    m_predictions_v.reset(AbsDistMatType::Instantiate(dist_data));
+  }
+  else {
+    m_predictions_v.reset(AbsDistMatType::Instantiate(*dist_data.grid,
+                                                      dist_data.root,
+                                                      El::STAR,
+                                                      El::VC,
+                                                      El::ELEMENT,
+                                                      dist_data.device));
+  }
+  m_labels_v.reset(AbsDistMatType::Instantiate(m_predictions_v->DistData()));
 
   // Check output dimensions of prediction and label layers
   if (predictions.Height() != labels.Height()) {
@@ -162,6 +301,11 @@ auto confusion_matrix::get_labels(const model& m) const -> const AbsDistMatType&
               "\"");
 }
 
+bool confusion_matrix::is_sparse(const model& m) const
+{
+  return get_predictions(m).Height() > m_max_dense_classes;
+}
+
 // ---------------------------------------------------------
 // Count management functions
 // ---------------------------------------------------------
@@ -171,17 +315,23 @@ void confusion_matrix::reset_counts(const model& m)
   const auto& c = m.get_execution_context();
   auto& counts = m_counts[c.get_execution_mode()];
   const auto& num_classes = get_predictions(m).Height();
-  counts.assign(num_classes * num_classes, 0);
+  const auto device = m_predictions_v->GetLocalDevice();
+  if (counts.data == nullptr || counts.data->GetDevice() != device) {
+    counts.data = make_counts_matrix(device);
+  }
+  counts.num_keys = 0;
+  if (!is_sparse(m)) {
+    counts.data->Resize(num_classes * num_classes, 1);
+    El::Zero(*counts.data);
+  }
 }
 
 void confusion_matrix::update_counts(const model& m)
 {
   LBANN_CALIPER_MARK_FUNCTION;
-  constexpr DataType zero = 0;
 
   // Get predictions
   const auto& predictions = get_predictions(m);
-  const auto& num_classes = predictions.Height();
   m_predictions_v->Empty(false);
   m_predictions_v->AlignWith(predictions);
   if (m_predictions_v->DistData() == predictions.DistData()) {
@@ -190,39 +340,51 @@ void confusion_matrix::update_counts(const model& m)
   else {
     El::Copy(predictions, *m_predictions_v);
   }
-  const auto& local_predictions = m_predictions_v->LockedMatrix();
 
   // Get labels
   const auto& labels = get_labels(m);
   m_labels_v->Empty(false);
-  m_labels_v->AlignWith(predictions);
+  m_labels_v->AlignWith(*m_predictions_v);
   if (m_labels_v->DistData() == labels.DistData()) {
     El::LockedView(*m_labels_v, labels);
   }
   else {
     El::Copy(labels, *m_labels_v);
   }
-  const auto& local_labels = m_labels_v->LockedMatrix();
 
-  // Update counts
+  // Ranks with copies of the same samples count them once
+  if (m_predictions_v->RedundantRank() != 0) {
+    return;
+  }
+
+  // Update counts on the device, without synchronizing
   const auto& c = m.get_execution_context();
   auto& counts = m_counts[c.get_execution_mode()];
-  const auto& local_height = local_predictions.Height();
-  const auto& local_width = local_predictions.Width();
-  for (El::Int local_col = 0; local_col < local_width; ++local_col) {
-    El::Int prediction_index = -1, label_index = -1;
-    LBANN_OMP_PARALLEL_FOR
-    for (El::Int local_row = 0; local_row < local_height; ++local_row) {
-      if (local_predictions(local_row, local_col) != zero) {
-        prediction_index = m_predictions_v->GlobalRow(local_row);
-      }
-      if (local_labels(local_row, local_col) != zero) {
-        label_index = m_labels_v->GlobalRow(local_row);
-      }
-    }
-    if (prediction_index >= 0 && label_index >= 0) {
-      counts[label_index + prediction_index * num_classes]++;
-    }
+  if (counts.data == nullptr) {
+    reset_counts(m);
+  }
+  const bool dense = !is_sparse(m);
+  const auto& local_predictions = m_predictions_v->LockedMatrix();
+  const auto& local_labels = m_labels_v->LockedMatrix();
+  switch (local_predictions.GetDevice()) {
+  case El::Device::CPU:
+    count_samples<El::Device::CPU>(local_predictions,
+                                   local_labels,
+                                   dense,
+                                   counts.data,
+                                   counts.num_keys);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    count_samples<El::Device::GPU>(local_predictions,
+                                   local_labels,
+                                   dense,
+                                   counts.data,
+                                   counts.num_keys);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
   }
 }
 
@@ -234,51 +396,64 @@ void confusion_matrix::save_confusion_matrix(const model& m)
   // Get counts
   const auto& mode = c.get_execution_mode();
   auto& counts = m_counts[mode];
+  if (counts.data == nullptr) {
+    reset_counts(m);
+  }
+
+  // Construct output file name
+  std::string mode_string;
+  switch (mode) {
+  case execution_mode::training:
+    mode_string = "train-epoch" + std::to_string(c.get_epoch());
+    break;
+  case execution_mode::validation:
+    mode_string = "validation-epoch" + std::to_string(c.get_epoch());
+    break;
+  case execution_mode::testing:
+    mode_string = "test";
+    break;
+  default:
+    return; // Exit immediately if execution mode is unknown
+  }
+  const std::string file_name = m_prefix + mode_string + ".csv";
+  if (is_sparse(m)) {
+    save_sparse_confusion_matrix(m, counts, file_name);
+    return;
+  }
+
+  // Copy counts to host once per epoch and restart them
+  El::Matrix<El::Int, El::Device::CPU> host_counts;
+  El::Copy(*counts.data, host_counts);
+  El::Zero(*counts.data);
 
   // Accumulate counts in master process
-  // Note: Counts in non-root processes are set to zero, so this can
-  // be called multiple times without affecting correctness.
   auto&& comm = *m.get_comm();
   if (comm.am_trainer_master()) {
     comm.trainer_reduce(static_cast<El::Int*>(MPI_IN_PLACE),
-                        counts.size(),
-                        counts.data());
+                        host_counts.Height(),
+                        host_counts.Buffer());
   }
   else {
-    comm.trainer_reduce(counts.data(),
-                        counts.size(),
+    comm.trainer_reduce(host_counts.LockedBuffer(),
+                        host_counts.Height(),
                         comm.get_trainer_master(),
                         El::mpi::SUM);
-    counts.assign(counts.size(), 0);
   }
 
   // Save confusion matrix on master process
   if (comm.am_trainer_master()) {
     const auto& num_classes = get_predictions(m).Height();
-    const auto& total_count = std::accumulate(counts.begin(), counts.end(), 0);
+    const El::Int* counts_buf = host_counts.LockedBuffer();
+    const auto& total_count = std::accumulate(counts_buf,
+                                              counts_buf + host_counts.Height(),
+                                              El::Int{0});
     const auto& scale = DataType(1) / total_count;
 
-    // Construct output file name
-    std::string mode_string;
-    switch (mode) {
-    case execution_mode::training:
-      mode_string = "train-epoch" + std::to_string(c.get_epoch());
-      break;
-    case execution_mode::validation:
-      mode_string = "validation-epoch" + std::to_string(c.get_epoch());
-      break;
-    case execution_mode::testing:
-      mode_string = "test";
-      break;
-    default:
-      return; // Exit immediately if execution mode is unknown
-    }
-
     // Write to file
-    std::ofstream fs(m_prefix + mode_string + ".csv");
+    std::ofstream fs(file_name);
     for (El::Int i = 0; i < num_classes; ++i) {
       for (El::Int j = 0; j < num_classes; ++j) {
-        fs << (j > 0 ? "," : "") << counts[j + i * num_classes] * scale;
+        fs << (j > 0 ? "," : "") << counts_buf[j + i * num_classes] * scale;
       }
       fs << "\n";
     }
@@ -286,6 +461,76 @@ void confusion_matrix::save_confusion_matrix(const model& m)
   }
 }
 
+void confusion_matrix::save_sparse_confusion_matrix(
+  const model& m,
+  local_counts& counts,
+  const std::string& file_name)
+{
+  // Copy keys to host once per epoch and restart them
+  El::Matrix<El::Int, El::Device::CPU> host_keys;
+  if (counts.num_keys > 0) {
+    El::Copy(*counts.data, host_keys);
+  }
+  std::vector<El::Int> keys(host_keys.LockedBuffer(),
+                            host_keys.LockedBuffer() + counts.num_keys);
+  counts.num_keys = 0;
+
+  // Nonzero entries of this rank as (key, count) pairs
+  std::sort(keys.begin(), keys.end());
+  std::vector<El::Int> local_entries;
+  for (const auto& key : keys) {
+    if (key < 0) {
+      continue;
+    }
+    if (!local_entries.empty() &&
+        local_entries[local_entries.size() - 2] == key) {
+      ++local_entries.back();
+    }
+    else {
+      local_entries.push_back(key);
+      local_entries.push_back(1);
+    }
+  }
+
+  // Gather entries in master process
+  auto&& comm = *m.get_comm();
+  const int root = comm.get_trainer_master();
+  if (!comm.am_trainer_master()) {
+    comm.trainer_gather(int(local_entries.size()), root);
+    comm.trainer_gatherv(local_entries.data(), local_entries.size(), root);
+    return;
+  }
+  const int procs = comm.get_procs_per_trainer();
+  std::vector<int> sizes(procs), offsets(procs, 0);
+  comm.trainer_gather(int(local_entries.size()), sizes.data());
+  for (int i = 1; i < procs; ++i) {
+    offsets[i] = offsets[i - 1] + sizes[i - 1];
+  }
+  std::vector<El::Int> entries(offsets.back() + sizes.back());
+  comm.trainer_gatherv(local_entries.data(),
+                       local_entries.size(),
+                       entries.data(),
+                       sizes.data(),
+                       offsets.data());
+  std::map<El::Int, El::Int> merged;
+  El::Int total_count = 0;
+  for (size_t i = 0; i + 1 < entries.size(); i += 2) {
+    merged[entries[i]] += entries[i + 1];
+    total_count += entries[i + 1];
+  }
+
+  // Write nonzero entries to file
+  const auto& num_classes = get_predictions(m).Height();
+  const auto& scale = DataType(1) / total_count;
+  std::ofstream fs(file_name);
+  fs << "prediction,label,proportion\n";
+  for (const auto& [key, count] : merged) {
+    fs << key / num_classes << "," << key % num_classes << ","
+       << count * scale << "\n";
+  }
+  fs.close();
+}
+
 // ---------------------------------------------------------
 // Protobuf Serialization
 // ---------------------------------------------------------
@@ -296,6 +541,7 @@ void confusion_matrix::write_specific_proto(lbann_data::Callback& proto) const
   msg->set_prediction(m_prediction_layer);
   msg->set_label(m_label_layer);
   msg->set_prefix(m_prefix);
+  msg->set_max_dense_classes(m_max_dense_classes);
 }
 
 std::unique_ptr<callback_base> build_confusion_matrix_callback_from_pbuf(
@@ -305,9 +551,12 @@ std::unique_ptr<callback_base> build_confusion_matrix_callback_from_pbuf(
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackConfusionMatrix&>(
       proto_msg);
+  const El::Int max_dense_classes =
+    (params.max_dense_classes() > 0 ? params.max_dense_classes() : 1024);
   return std::make_unique<confusion_matrix>(params.prediction(),
                                             params.label(),
-                                            params.prefix());
+                                            params.prefix(),
+                                            max_dense_classes);
 }
 
 } // namespace callback
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/confusion_matrix.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace callback {
+
+namespace {
+
+/** Each block finds the rows of the nonzero prediction and label
+ *  entries of one column at a time.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ */
+template <size_t bsize>
+__global__ void count_kernel(El::Int height,
+                             El::Int width,
+                             const DataType* __restrict__ predictions,
+                             El::Int predictions_ldim,
+                             const DataType* __restrict__ labels,
+                             El::Int labels_ldim,
+                             bool dense,
+                             El::Int* __restrict__ out,
+                             El::Int out_ldim)
+{
+  __shared__ El::Int shared_predictions[bsize];
+  __shared__ El::Int shared_labels[bsize];
+  const size_t tid = threadIdx.x;
+  for (El::Int col = blockIdx.x; col < width; col += gridDim.x) {
+    El::Int prediction_index = -1, label_index = -1;
+    for (El::Int row = threadIdx.x; row < height; row += blockDim.x) {
+      if (predictions[row + col * predictions_ldim] != DataType(0)) {
+        prediction_index = row;
+      }
+      if (labels[row + col * labels_ldim] != DataType(0)) {
+        label_index = row;
+      }
+    }
+
+    // Largest row over the block
+    shared_predictions[tid] = prediction_index;
+    shared_labels[tid] = label_index;
+    for (size_t stride = bsize / 2; stride > 0; stride /= 2) {
+      __syncthreads();
+      if (tid < stride) {
+        if (shared_predictions[tid + stride] > shared_predictions[tid]) {
+          shared_predictions[tid] = shared_predictions[tid + stride];
+        }
+        if (shared_labels[tid + stride] > shared_labels[tid]) {
+          shared_labels[tid] = shared_labels[tid + stride];
+        }
+      }
+    }
+    if (tid == 0) {
+      prediction_index = shared_predictions[0];
+      label_index = shared_labels[0];
+      const El::Int key = (prediction_index >= 0 && label_index >= 0
+                             ? label_index + prediction_index * height
+                             : -1);
+      if (!dense) {
+        out[col * out_ldim] = key;
+      }
+      else if (key >= 0) {
+        atomicAdd(reinterpret_cast<unsigned long long int*>(&out[key]),
+                  1ull);
+      }
+    }
+    __syncthreads();
+  }
+}
+
+} // namespace
+
+void confusion_matrix_count_gpu(
+  const El::Matrix<DataType, El::Device::GPU>& predictions,
+  const El::Matrix<DataType, El::Device::GPU>& labels,
+  bool dense,
+  El::Matrix<El::Int, El::Device::GPU>& out)
+{
+  const El::Int height = predictions.Height();
+  const El::Int width = predictions.Width();
+  if (height == 0 || width == 0) {
+    return;
+  }
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = width;
+  gpu_lib::clip_grid_dims(grid_dims);
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(out),
+                                     gpu::get_sync_info(predictions),
+                                     gpu::get_sync_info(labels));
+  hydrogen::gpu::LaunchKernel(count_kernel<block_size>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              height,
+                              width,
+                              predictions.LockedBuffer(),
+                              predictions.LDim(),
+                              labels.LockedBuffer(),
+                              labels.LDim(),
+                              dense,
+                              out.Buffer(),
+                              out.LDim());
+}
+
+} // namespace callback
+} // namespace lbann
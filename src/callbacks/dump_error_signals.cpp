@@ -26,6 +26,7 @@
 
 #include "lbann/callbacks/dump_error_signals.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/io/tensor_dump_writer.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/utils/serialize.hpp"
@@ -35,18 +36,47 @@
 namespace lbann {
 namespace callback {
 
+dump_error_signals::dump_error_signals(std::string basename,
+                                       El::Int batch_interval,
+                                       El::Int max_samples)
+  : callback_base(std::max(batch_interval, El::Int(1))),
+    m_basename(std::move(basename)),
+    m_max_samples(max_samples)
+{}
+
+dump_error_signals::dump_error_signals(const dump_error_signals& other)
+  : callback_base(other),
+    m_basename(other.m_basename),
+    m_max_samples(other.m_max_samples)
+{}
+
+dump_error_signals&
+dump_error_signals::operator=(const dump_error_signals& other)
+{
+  callback_base::operator=(other);
+  m_basename = other.m_basename;
+  m_max_samples = other.m_max_samples;
+  m_writer.reset();
+  return *this;
+}
+
+dump_error_signals::~dump_error_signals() = default;
+
 template <class Archive>
 void dump_error_signals::serialize(Archive& ar)
 {
   ar(::cereal::make_nvp("BaseCallback",
                         ::cereal::base_class<callback_base>(this)),
-     CEREAL_NVP(m_basename));
+     CEREAL_NVP(m_basename),
+     CEREAL_NVP(m_max_samples));
 }
 
 void dump_error_signals::write_specific_proto(lbann_data::Callback& proto) const
 {
   auto* msg = proto.mutable_dump_error_signals();
   msg->set_basename(m_basename);
+  msg->set_batch_interval(m_batch_interval);
+  msg->set_max_samples(m_max_samples);
 }
 
 void dump_error_signals::on_backward_prop_end(model* m, Layer* l)
@@ -69,9 +99,24 @@ void dump_error_signals::on_backward_prop_end(model* m, Layer* l)
       file << i;
     }
 
-    // Write activations to file
+    // Write error signals to file in the background
+    if (m_writer == nullptr) {
+      m_writer = std::make_unique<tensor_dump_writer>();
+    }
     auto& dtl = dynamic_cast<data_type_layer<DataType>&>(*l);
-    El::Write(dtl.get_error_signals(i), file.str(), El::ASCII);
+    m_writer->submit_gathered<DataType>(
+      dtl.get_error_signals(i),
+      [file = file.str()](const CPUMat& data) {
+        El::Write(data, file, El::ASCII);
+      },
+      m_max_samples);
+  }
+}
+
+void dump_error_signals::on_train_end(model* m)
+{
+  if (m_writer != nullptr) {
+    m_writer->wait_all();
   }
 }
 
@@ -82,7 +127,9 @@ std::unique_ptr<callback_base> build_dump_error_signals_callback_from_pbuf(
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackDumpErrorSignals&>(
       proto_msg);
-  return std::make_unique<dump_error_signals>(params.basename());
+  return std::make_unique<dump_error_signals>(params.basename(),
+                                              params.batch_interval(),
+                                              params.max_samples());
 }
 
 } // namespace callback
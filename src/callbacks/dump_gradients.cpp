@@ -28,6 +28,7 @@
 
 #include "lbann/callbacks/dump_gradients.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/io/tensor_dump_writer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/optimizers/data_type_optimizer.hpp"
 #include "lbann/utils/serialize.hpp"
@@ -40,8 +41,26 @@
 namespace lbann {
 namespace callback {
 
+dump_gradients::dump_gradients(std::string basename, int batch_interval)
+  : callback_base(batch_interval), m_basename(std::move(basename))
+{}
+
 dump_gradients::dump_gradients() : dump_gradients("", 0) {}
 
+dump_gradients::dump_gradients(const dump_gradients& other)
+  : callback_base(other), m_basename(other.m_basename)
+{}
+
+dump_gradients& dump_gradients::operator=(const dump_gradients& other)
+{
+  callback_base::operator=(other);
+  m_basename = other.m_basename;
+  m_writer.reset();
+  return *this;
+}
+
+dump_gradients::~dump_gradients() = default;
+
 template <class Archive>
 void dump_gradients::serialize(Archive& ar)
 {
@@ -72,12 +91,24 @@ void dump_gradients::on_backward_prop_end(model* m)
       auto* dt_opt = dynamic_cast<data_type_optimizer<DataType>*>(opt);
       auto& grad = dt_opt->get_gradient_sharded();
       if (grad.Participating()) {
-        El::Write(grad, file, El::ASCII);
+        if (m_writer == nullptr) {
+          m_writer = std::make_unique<tensor_dump_writer>();
+        }
+        m_writer->submit_gathered<DataType>(grad, [file](const CPUMat& data) {
+          El::Write(data, file, El::ASCII);
+        });
       }
     }
   }
 }
 
+void dump_gradients::on_train_end(model* m)
+{
+  if (m_writer != nullptr) {
+    m_writer->wait_all();
+  }
+}
+
 std::unique_ptr<callback_base> build_dump_gradients_callback_from_pbuf(
   const google::protobuf::Message& proto_msg,
   const std::shared_ptr<lbann_summary>&)
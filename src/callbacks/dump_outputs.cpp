@@ -27,6 +27,7 @@
 #include "lbann/callbacks/dump_outputs.hpp"
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/io/tensor_dump_writer.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/proto/proto_common.hpp"
@@ -114,12 +115,14 @@ dump_outputs::dump_outputs(std::set<std::string> layer_names,
                            std::set<execution_mode> modes,
                            El::Int batch_interval,
                            std::string directory,
-                           std::string file_format)
+                           std::string file_format,
+                           El::Int max_samples)
   : callback_base(std::max(batch_interval, El::Int(1))),
     m_layer_names(std::move(layer_names)),
     m_modes(std::move(modes)),
     m_directory(std::move(directory)),
-    m_file_format(std::move(file_format))
+    m_file_format(std::move(file_format)),
+    m_max_samples(max_samples)
 {
   std::stringstream err;
 
@@ -155,6 +158,29 @@ dump_outputs::dump_outputs(std::set<std::string> layer_names,
 
 dump_outputs::dump_outputs() : dump_outputs({}, {}, 0, "", "") {}
 
+dump_outputs::dump_outputs(const dump_outputs& other)
+  : callback_base(other),
+    m_layer_names(other.m_layer_names),
+    m_modes(other.m_modes),
+    m_directory(other.m_directory),
+    m_file_format(other.m_file_format),
+    m_max_samples(other.m_max_samples)
+{}
+
+dump_outputs& dump_outputs::operator=(const dump_outputs& other)
+{
+  callback_base::operator=(other);
+  m_layer_names = other.m_layer_names;
+  m_modes = other.m_modes;
+  m_directory = other.m_directory;
+  m_file_format = other.m_file_format;
+  m_max_samples = other.m_max_samples;
+  m_writer.reset();
+  return *this;
+}
+
+dump_outputs::~dump_outputs() = default;
+
 template <class Archive>
 void dump_outputs::serialize(Archive& ar)
 {
@@ -163,7 +189,8 @@ void dump_outputs::serialize(Archive& ar)
      CEREAL_NVP(m_layer_names),
      CEREAL_NVP(m_modes),
      CEREAL_NVP(m_directory),
-     CEREAL_NVP(m_file_format));
+     CEREAL_NVP(m_file_format),
+     CEREAL_NVP(m_max_samples));
 }
 
 void dump_outputs::do_dump_outputs(const model& m, const Layer& l)
@@ -187,31 +214,38 @@ void dump_outputs::do_dump_outputs(const model& m, const Layer& l)
     get_multi_trainer_model_path(m, m_directory);
   file::trainer_master_make_directory(root_file_path, m.get_comm());
 
-  // Save layer outputs on root process
+  // Save layer outputs on root process. The files are written in the
+  // background from a staged copy.
+  if (m_writer == nullptr) {
+    m_writer = std::make_unique<tensor_dump_writer>();
+  }
   for (int i = 0; i < l.get_num_children(); ++i) {
     const auto& dtl = dynamic_cast<const data_type_layer<DataType>&>(l);
-    const CircMat<El::Device::CPU> circ_data(dtl.get_activations(i));
-    if (circ_data.CrossRank() == circ_data.Root()) {
-      const auto& data = static_cast<const CPUMat&>(circ_data.LockedMatrix());
-      const std::string file_name =
-        (root_file_path + c.get_state_string() + "_" + l.get_name() +
-         "_output" + std::to_string(i) + "." + m_file_format);
-      if (m_file_format == "csv") {
-        save_text(file_name, ",", data);
-      }
-      else if (m_file_format == "tsv") {
-        save_text(file_name, "\t", data);
-      }
-      else if (m_file_format == "npy") {
-        save_npy(file_name, dtl.get_output_dims(i), data);
-      }
-      else if (m_file_format == "npz") {
-        save_npz(file_name,
-                 l.get_name() + "_output" + std::to_string(i),
-                 dtl.get_output_dims(i),
-                 data);
-      }
-    }
+    const std::string file_name =
+      (root_file_path + c.get_state_string() + "_" + l.get_name() +
+       "_output" + std::to_string(i) + "." + m_file_format);
+    const std::string tensor_name =
+      l.get_name() + "_output" + std::to_string(i);
+    m_writer->submit_gathered<DataType>(
+      dtl.get_activations(i),
+      [file_name,
+       tensor_name,
+       format = m_file_format,
+       dims = dtl.get_output_dims(i)](const CPUMat& data) {
+        if (format == "csv") {
+          save_text(file_name, ",", data);
+        }
+        else if (format == "tsv") {
+          save_text(file_name, "\t", data);
+        }
+        else if (format == "npy") {
+          save_npy(file_name, dims, data);
+        }
+        else if (format == "npz") {
+          save_npz(file_name, tensor_name, dims, data);
+        }
+      },
+      m_max_samples);
   }
 }
 
@@ -224,6 +258,20 @@ void dump_outputs::on_evaluate_forward_prop_end(model* m, Layer* l)
   }
 }
 
+void dump_outputs::on_train_end(model* m)
+{
+  if (m_writer != nullptr) {
+    m_writer->wait_all();
+  }
+}
+
+void dump_outputs::on_test_end(model* m)
+{
+  if (m_writer != nullptr) {
+    m_writer->wait_all();
+  }
+}
+
 void dump_outputs::write_specific_proto(lbann_data::Callback& proto) const
 {
   auto* msg = proto.mutable_dump_outputs();
@@ -235,6 +283,7 @@ void dump_outputs::write_specific_proto(lbann_data::Callback& proto) const
   msg->set_batch_interval(m_batch_interval);
   msg->set_directory(m_directory);
   msg->set_format(m_file_format);
+  msg->set_max_samples(m_max_samples);
 }
 
 std::unique_ptr<callback_base> build_dump_outputs_callback_from_pbuf(
@@ -249,7 +298,8 @@ std::unique_ptr<callback_base> build_dump_outputs_callback_from_pbuf(
                                         modes,
                                         params.batch_interval(),
                                         params.directory(),
-                                        params.format());
+                                        params.format(),
+                                        params.max_samples());
 }
 
 } // namespace callback
@@ -27,6 +27,7 @@
 #include "lbann/callbacks/dump_weights.hpp"
 #include "lbann/callbacks/checkpoint.hpp" // Reuse the checkpoint naming scheme
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/io/tensor_dump_writer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/cloneable.hpp"
@@ -53,8 +54,10 @@ public:
   FileFormat(FileFormat&&) = default;
   virtual ~FileFormat() noexcept = default;
 
-  /** @brief Write weight values to file. */
-  virtual void write(const weights& w, const std::string& file) const = 0;
+  /** @brief Queue weight values to be written to file. */
+  virtual void write(const weights& w,
+                     const std::string& file,
+                     tensor_dump_writer& writer) const = 0;
 };
 
 namespace {
@@ -64,23 +67,25 @@ class TextFileFormat final : public Cloneable<TextFileFormat, FileFormat>
 public:
   TextFileFormat() = default;
 
-  void write(const weights& w, const std::string& file) const final
+  void write(const weights& w,
+             const std::string& file,
+             tensor_dump_writer& writer) const final
   {
 
     // Try casting weights values and writing
-    if (try_write<float>(w, file)) {
+    if (try_write<float>(w, file, writer)) {
       return;
     }
-    if (try_write<double>(w, file)) {
+    if (try_write<double>(w, file, writer)) {
       return;
     }
 #ifdef LBANN_HAS_HALF
-    if (try_write<cpu_fp16>(w, file)) {
+    if (try_write<cpu_fp16>(w, file, writer)) {
       return;
     }
 #endif // LBANN_HAS_HALF
 #ifdef LBANN_HAS_GPU_FP16
-    if (try_write<fp16>(w, file)) {
+    if (try_write<fp16>(w, file, writer)) {
       return;
     }
 #endif // LBANN_HAS_GPU_FP16
@@ -102,14 +107,20 @@ private:
    *  @returns Whether the weight values were saved to file.
    */
   template <typename TensorDataType>
-  bool try_write(const weights& w, const std::string& file) const
+  bool try_write(const weights& w,
+                 const std::string& file,
+                 tensor_dump_writer& writer) const
   {
     auto* typed_w = dynamic_cast<const data_type_weights<TensorDataType>*>(&w);
     if (typed_w == nullptr) {
       return false;
     }
     else {
-      El::Write(typed_w->get_values(), file, El::ASCII);
+      writer.submit_gathered<TensorDataType>(
+        typed_w->get_values(),
+        [file](const El::Matrix<TensorDataType, El::Device::CPU>& values) {
+          El::Write(values, file, El::ASCII);
+        });
       return true;
     }
   }
@@ -120,23 +131,25 @@ class BinaryFileFormat final : public Cloneable<BinaryFileFormat, FileFormat>
 public:
   BinaryFileFormat() = default;
 
-  void write(const weights& w, const std::string& file) const final
+  void write(const weights& w,
+             const std::string& file,
+             tensor_dump_writer& writer) const final
   {
 
     // Try casting weights values and writing
-    if (try_write<float>(w, file)) {
+    if (try_write<float>(w, file, writer)) {
       return;
     }
-    if (try_write<double>(w, file)) {
+    if (try_write<double>(w, file, writer)) {
       return;
     }
 #ifdef LBANN_HAS_HALF
-    if (try_write<cpu_fp16>(w, file)) {
+    if (try_write<cpu_fp16>(w, file, writer)) {
       return;
     }
 #endif // LBANN_HAS_HALF
 #ifdef LBANN_HAS_GPU_FP16
-    if (try_write<fp16>(w, file)) {
+    if (try_write<fp16>(w, file, writer)) {
       return;
     }
 #endif // LBANN_HAS_GPU_FP16
@@ -158,14 +171,20 @@ private:
    *  @returns Whether the weight values were saved to file.
    */
   template <typename TensorDataType>
-  bool try_write(const weights& w, const std::string& file) const
+  bool try_write(const weights& w,
+                 const std::string& file,
+                 tensor_dump_writer& writer) const
   {
     auto* typed_w = dynamic_cast<const data_type_weights<TensorDataType>*>(&w);
     if (typed_w == nullptr) {
       return false;
     }
     else {
-      El::Write(typed_w->get_values(), file, El::BINARY);
+      writer.submit_gathered<TensorDataType>(
+        typed_w->get_values(),
+        [file](const El::Matrix<TensorDataType, El::Device::CPU>& values) {
+          El::Write(values, file, El::BINARY);
+        });
       return true;
     }
   }
@@ -177,23 +196,25 @@ class DistributedBinaryFileFormat final
 public:
   DistributedBinaryFileFormat() = default;
 
-  void write(const weights& w, const std::string& file) const final
+  void write(const weights& w,
+             const std::string& file,
+             tensor_dump_writer& writer) const final
   {
 
     // Try casting weights values and writing
-    if (try_write<float>(w, file)) {
+    if (try_write<float>(w, file, writer)) {
       return;
     }
-    if (try_write<double>(w, file)) {
+    if (try_write<double>(w, file, writer)) {
       return;
     }
 #ifdef LBANN_HAS_HALF
-    if (try_write<cpu_fp16>(w, file)) {
+    if (try_write<cpu_fp16>(w, file, writer)) {
       return;
     }
 #endif // LBANN_HAS_HALF
 #ifdef LBANN_HAS_GPU_FP16
-    if (try_write<fp16>(w, file)) {
+    if (try_write<fp16>(w, file, writer)) {
       return;
     }
 #endif // LBANN_HAS_GPU_FP16
@@ -216,7 +237,9 @@ private:
    *  @returns Whether the weight values were saved to file.
    */
   template <typename TensorDataType>
-  bool try_write(const weights& w, const std::string& file) const
+  bool try_write(const weights& w,
+                 const std::string& file,
+                 tensor_dump_writer& writer) const
   {
     auto* typed_w = dynamic_cast<const data_type_weights<TensorDataType>*>(&w);
     if (typed_w == nullptr) {
@@ -225,9 +248,12 @@ private:
     else {
       const auto& mat = typed_w->get_values();
       if (mat.RedundantRank() == 0) {
-        El::Write(mat.LockedMatrix(),
-                  El::BuildString(file, "_rank", mat.DistRank()),
-                  El::BINARY);
+        writer.submit<TensorDataType>(
+          mat.LockedMatrix(),
+          [file = El::BuildString(file, "_rank", mat.DistRank())](
+            const El::Matrix<TensorDataType, El::Device::CPU>& values) {
+            El::Write(values, file, El::BINARY);
+          });
       }
       return true;
     }
@@ -248,6 +274,8 @@ dump_weights::dump_weights(
     m_file_format(std::move(file_format))
 {}
 
+dump_weights::~dump_weights() = default;
+
 dump_weights::dump_weights()
   : dump_weights("",
                  1,
@@ -277,6 +305,7 @@ dump_weights& dump_weights::operator=(const dump_weights& other)
   m_directory = other.m_directory;
   m_epoch_interval = other.m_epoch_interval;
   m_file_format = other.m_file_format->clone();
+  m_writer.reset();
   return *this;
 }
 
@@ -285,6 +314,13 @@ void dump_weights::on_train_begin(model* m)
   do_dump_weights(*m, visitor_hook::execution_mode_begin);
 }
 
+void dump_weights::on_train_end(model* m)
+{
+  if (m_writer != nullptr) {
+    m_writer->wait_all();
+  }
+}
+
 void dump_weights::on_epoch_end(model* m)
 {
   const auto& context =
@@ -314,21 +350,28 @@ void dump_weights::do_dump_weights(const model& m, visitor_hook hook)
                     '/');
   file::trainer_master_make_directory(dir, m.get_comm());
 
-  // Save weights
+  // Save weights in the background
+  if (m_writer == nullptr) {
+    m_writer = std::make_unique<tensor_dump_writer>();
+  }
   for (auto* w : m.get_weights()) {
-    m_file_format->write(*w, El::BuildString(dir, w->get_name()));
+    m_file_format->write(*w, El::BuildString(dir, w->get_name()), *m_writer);
   }
 
-  // Update checkpoint file
+  // Update checkpoint file once the weight files written by this
+  // process are complete
   if (m.get_comm()->am_trainer_master()) {
-    auto latest_file = get_last_shared_checkpoint_filename(t.get_name(),
-                                                           context.get_type(),
-                                                           m_directory.c_str());
-    write_latest(latest_file,
-                 hook,
-                 context.get_execution_mode(),
-                 context.get_epoch(),
-                 context.get_step());
+    m_writer->submit_task(
+      [latest_file =
+         get_last_shared_checkpoint_filename(t.get_name(),
+                                             context.get_type(),
+                                             m_directory.c_str()),
+       hook,
+       mode = context.get_execution_mode(),
+       epoch = context.get_epoch(),
+       step = context.get_step()]() {
+        write_latest(latest_file, hook, mode, epoch, step);
+      });
   }
 }
 
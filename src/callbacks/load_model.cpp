@@ -30,6 +30,7 @@
 #include "lbann/callbacks/checkpoint.hpp"
 #include "lbann/execution_algorithms/execution_context.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
+#include "lbann/io/weights_container.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
 #include "lbann/utils/exception.hpp"
@@ -133,6 +134,23 @@ void load_weights_from_files(model& m, std::string const& ckpt_dir)
   }
 }
 
+void load_weights_from_container(model& m, std::string const& container_file)
+{
+  auto* comm = m.get_comm();
+  if (comm->am_trainer_master()) {
+    std::cout << "Loading: " << container_file << std::endl;
+  }
+  auto const missing =
+    weights_container::read(container_file, m.get_weights(), *comm);
+  if (comm->am_trainer_master()) {
+    for (auto const& name : missing) {
+      std::cout << "Could not load weights with name \"" << name
+                << "\". Not found in " << container_file << "."
+                << std::endl;
+    }
+  }
+}
+
 // (trb 12/30/2020): My understanding is that `m` should be a
 // constructed model with a DAG and weights that at least have
 // names. This function will then loop through the weights objects of
@@ -140,7 +158,8 @@ void load_weights_from_files(model& m, std::string const& ckpt_dir)
 // directory.
 //
 // Weights can be restored from independent files storing the binary
-// weights or from a checkpoint. In the first case, weights are
+// weights, from a single weights container or from a checkpoint. In
+// the first two cases, weights are
 // matched by filename. In the latter case, the entire model is
 // restored into a temporary model object, which is then stripped for
 // parts and discarded. If dedicated weights files are sharing a
@@ -159,8 +178,12 @@ bool load_model_weights(const std::string& ckpt_dir, model& m)
   }
 
   auto const checkpoint_file = file::join_path(active_ckpt_dir, "model.bin");
+  auto const container_file =
+    file::join_path(active_ckpt_dir, weights_container::file_name);
   if (file::file_exists(checkpoint_file))
     load_weights_from_checkpoint(m, checkpoint_file);
+  else if (file::file_exists(container_file))
+    load_weights_from_container(m, container_file);
   else
     load_weights_from_files(m, active_ckpt_dir);
   return true;
@@ -265,7 +265,8 @@ void restore_model_weights(
 
 std::string sendrecv_string(lbann_comm const& c,
                             std::string const& src,
-                            El::Int partner_trainer)
+                            El::Int partner_trainer,
+                            bool all_ranks = false)
 {
 #ifdef LBANN_HAS_ALUMINUM
   El::mpi::EnsureComm<size_t, El::Collective::SENDRECV>(
@@ -273,8 +274,11 @@ std::string sendrecv_string(lbann_comm const& c,
     El::SyncInfo<El::Device::CPU>{});
 #endif
 
-  if (!c.am_trainer_master())
+  // Either the trainer masters exchange, or every rank exchanges with
+  // the rank in the same position of the partner trainer
+  if (!all_ranks && !c.am_trainer_master())
     return "";
+  int const partner_rank = all_ranks ? c.get_rank_in_trainer() : 0;
 
   // Exchange sizes
   size_t my_size = src.size();
@@ -282,11 +286,11 @@ std::string sendrecv_string(lbann_comm const& c,
   c.sendrecv(&my_size,
              1,
              partner_trainer,
-             0,
+             partner_rank,
              &other_size,
              1,
              partner_trainer,
-             0,
+             partner_rank,
              El::SyncInfo<El::Device::CPU>{});
 
   // Exchange strings
@@ -308,11 +312,11 @@ std::string sendrecv_string(lbann_comm const& c,
     c.sendrecv(send_buf,
                this_blk_send_size,
                partner_trainer,
-               0,
+               partner_rank,
                recv_buf,
                this_blk_recv_size,
                partner_trainer,
-               0,
+               partner_rank,
                El::SyncInfo<El::Device::CPU>{});
 
     send_buf += this_blk_send_size;
@@ -328,19 +332,22 @@ std::string sendrecv_string(lbann_comm const& c,
 template <typename T>
 void exchange(lbann_comm const& c, T& object, El::Int partner_trainer)
 {
+  // Trainers have the same number of ranks, so each rank ships its
+  // own share of the object to its counterpart in the partner trainer.
+  // Matrices are written from and read into their local buffers, and
+  // only redistributed if the partner's distribution differs.
   std::ostringstream oss;
   {
-    RootedBinaryOutputArchive ar(oss, c.get_trainer_grid());
-    c.trainer_barrier();
+    cereal::BinaryOutputArchive ar(oss);
     ar(object);
   }
-  c.trainer_barrier(); // I don't think this is necessary
   {
-    std::istringstream iss{sendrecv_string(c, oss.str(), partner_trainer)};
-    RootedBinaryInputArchive ar(iss, c.get_trainer_grid());
+    std::istringstream iss{
+      sendrecv_string(c, oss.str(), partner_trainer, /*all_ranks=*/true)};
+    cereal::BinaryInputArchive ar(iss);
     ar(object);
   }
-  c.trainer_barrier(); // I don't think this is necessary either
+  c.trainer_barrier();
 }
 
 /** @class SendRecvWeights
@@ -400,9 +407,8 @@ public:
 
     // Get partner process
     const El::Int rank_in_trainer = comm.get_rank_in_trainer();
-    const El::Int procs_per_trainer = comm.get_procs_per_trainer();
     const El::Int partner_rank_in_world =
-      (partner_trainer * procs_per_trainer + rank_in_trainer);
+      comm.get_world_rank(partner_trainer, rank_in_trainer);
 
     // Exchange weights with partner
     for (auto&& w_ptr : m.get_weights()) {
@@ -418,11 +424,9 @@ public:
       using WeightsType = data_type_weights<TensorDataType>;
       auto& recv_weights = dynamic_cast<WeightsType&>(*w_ptr);
       auto send_weights = recv_weights;
-      El::SendRecv(send_weights.get_values_sharded().LockedMatrix(),
-                   recv_weights.get_values_sharded().Matrix(),
-                   comm.get_world_comm(),
-                   partner_rank_in_world,
-                   partner_rank_in_world);
+      comm.sendrecv_matrix(send_weights.get_values_sharded().LockedMatrix(),
+                           recv_weights.get_values_sharded().Matrix(),
+                           partner_rank_in_world);
 
       // If the two weights objects use different optimizers across
       // the set of trainers, we need to be careful about how we
@@ -454,11 +458,9 @@ public:
         auto* send_sgd = dynamic_cast<SGDType*>(send_weights.get_optimizer());
         auto* recv_sgd = dynamic_cast<SGDType*>(recv_weights.get_optimizer());
         if (send_sgd != nullptr && recv_sgd != nullptr) {
-          El::SendRecv(send_sgd->get_velocity().LockedMatrix(),
-                       recv_sgd->get_velocity().Matrix(),
-                       comm.get_world_comm(),
-                       partner_rank_in_world,
-                       partner_rank_in_world);
+          comm.sendrecv_matrix(send_sgd->get_velocity().LockedMatrix(),
+                               recv_sgd->get_velocity().Matrix(),
+                               partner_rank_in_world);
           continue;
         }
 
@@ -467,16 +469,12 @@ public:
         auto* send_adam = dynamic_cast<AdamType*>(send_weights.get_optimizer());
         auto* recv_adam = dynamic_cast<AdamType*>(recv_weights.get_optimizer());
         if (send_adam != nullptr && recv_adam != nullptr) {
-          El::SendRecv(send_adam->get_moment1().LockedMatrix(),
-                       recv_adam->get_moment1().Matrix(),
-                       comm.get_world_comm(),
-                       partner_rank_in_world,
-                       partner_rank_in_world);
-          El::SendRecv(send_adam->get_moment2().LockedMatrix(),
-                       recv_adam->get_moment2().Matrix(),
-                       comm.get_world_comm(),
-                       partner_rank_in_world,
-                       partner_rank_in_world);
+          comm.sendrecv_matrix(send_adam->get_moment1().LockedMatrix(),
+                               recv_adam->get_moment1().Matrix(),
+                               partner_rank_in_world);
+          comm.sendrecv_matrix(send_adam->get_moment2().LockedMatrix(),
+                               recv_adam->get_moment2().Matrix(),
+                               partner_rank_in_world);
           continue;
         }
         LBANN_WARNING("Unknown optimizer type. NO EXCHANGE.");
@@ -489,16 +487,18 @@ private:
                                 optimizer const& opt,
                                 El::Int partner_trainer) const noexcept
   {
+    // Every rank asks the rank in the same position of the partner
     std::size_t const my_type_hash = typeid(opt).hash_code();
     std::size_t other_type_hash = -1;
+    int const partner_rank = c.get_rank_in_trainer();
     c.sendrecv(&my_type_hash,
                1,
                partner_trainer,
-               0,
+               partner_rank,
                &other_type_hash,
                1,
                partner_trainer,
-               0,
+               partner_rank,
                El::SyncInfo<El::Device::CPU>{});
     return my_type_hash == other_type_hash;
   }
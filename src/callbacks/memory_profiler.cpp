@@ -29,7 +29,11 @@
 #include "lbann/callbacks/memory_profiler.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
+#include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/proto/proto_common.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/gpu_memory_pool.hpp"
+#include "lbann/utils/protobuf.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/weights/data_type_weights.hpp"
 #include "lbann/weights/weights.hpp"
@@ -43,6 +47,9 @@
 #include "h2/patterns/multimethods/SwitchDispatcher.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
 #include <string>
 
 namespace lbann {
@@ -67,7 +74,11 @@ using UnaryConstDTL = const data_type_layer<T, T>;
 template <typename T>
 using ConstADM = std::add_const_t<El::AbstractDistMatrix<T>>;
 
+template <typename T>
+using UnaryDTL = data_type_layer<T, T>;
+
 using LayerTypes = h2::meta::tlist::ExpandTL<UnaryConstDTL, Datatypes>;
+using MutableLayerTypes = h2::meta::tlist::ExpandTL<UnaryDTL, Datatypes>;
 using DistMatrixTypes = h2::meta::tlist::ExpandTL<ConstADM, Datatypes>;
 
 // Now create the functors
@@ -211,8 +222,170 @@ size_t get_activation_and_error_signal_size(Layer const& x, std::ostream& os)
   return Dispatcher::Exec(GetActivationAndErrorSignalSize{}, x, os);
 }
 
+/** @brief Add the allocated tensors of a layer to a census. */
+template <typename T>
+void census_layer_tensors(data_type_layer<T>& dtl,
+                          std::vector<tensor_allocation>& census)
+{
+  // In-place layers only hold views of their parents' tensors
+  if (dtl.runs_inplace()) {
+    return;
+  }
+  auto add = [&](auto const& tensors, tensor_role role) {
+    for (auto const& t : tensors) {
+      size_t const bytes = t ? t->AllocatedMemory() * sizeof(T) : 0;
+      if (bytes > 0) {
+        census.push_back({dtl.get_name(), role, bytes, true});
+      }
+    }
+  };
+  add(dtl.get_all_activations(), tensor_role::activations);
+  add(dtl.get_all_error_signals(), tensor_role::error_signals);
+}
+
+struct CensusLayerTensors
+{
+  template <typename T>
+  void operator()(std::vector<tensor_allocation>& census,
+                  data_type_layer<T>& dtl)
+  {
+    census_layer_tensors(dtl, census);
+  }
+  template <typename... Args>
+  static void DeductionError(Args&&...)
+  {
+    LBANN_ERROR("Unknown layer type.");
+  }
+  static void DispatchError(std::vector<tensor_allocation>&, Layer& l)
+  {
+    LBANN_ERROR("Failed to dispatch for layer \"", l.get_name(), "\"");
+  }
+}; // struct CensusLayerTensors
+
+void census_layer_tensors(Layer& x, std::vector<tensor_allocation>& census)
+{
+  using Dispatcher =
+    h2::multimethods::SwitchDispatcher<CensusLayerTensors,
+                                       void,
+                                       Layer,
+                                       MutableLayerTypes>;
+  Dispatcher::Exec(CensusLayerTensors{}, x, census);
+}
+
+/** @brief Bytes of the gradient buffer of an optimizer, which is the
+ *         part of its state that data_type_optimizer holds. */
+template <typename T>
+size_t gradient_bytes_as(optimizer const& opt)
+{
+  auto const* dt_opt = dynamic_cast<data_type_optimizer<T> const*>(&opt);
+  return dt_opt ? dt_opt->data_type_optimizer<T>::get_state_size() : 0;
+}
+
+template <typename... Ts>
+size_t gradient_bytes(optimizer const& opt, h2::meta::TL<Ts...>)
+{
+  size_t bytes = 0;
+  ((bytes = bytes > 0 ? bytes : gradient_bytes_as<Ts>(opt)), ...);
+  return bytes;
+}
+
 } // namespace
 
+std::string to_string(tensor_role role)
+{
+  switch (role) {
+  case tensor_role::activations:
+    return "activations";
+  case tensor_role::error_signals:
+    return "error signals";
+  case tensor_role::weights:
+    return "weights";
+  case tensor_role::gradients:
+    return "gradients";
+  case tensor_role::optimizer_state:
+    return "optimizer state";
+  case tensor_role::unattributed:
+    return "unattributed";
+  default:
+    LBANN_ERROR("Invalid tensor role");
+  }
+}
+
+std::vector<tensor_allocation> take_memory_census(model& m)
+{
+  std::vector<tensor_allocation> census;
+  for (auto* layer : m.get_layers()) {
+    census_layer_tensors(*layer, census);
+  }
+  for (auto* w : m.get_weights()) {
+    std::ostringstream ignored;
+    size_t const bytes = report_dist_matrix(w->get_values_sharded(), ignored);
+    census.push_back({w->get_name(), tensor_role::weights, bytes, false});
+    auto const* opt = w->get_optimizer();
+    if (opt == nullptr) {
+      continue;
+    }
+    size_t const state = opt->get_state_size();
+    size_t const gradient = std::min(gradient_bytes(*opt, Datatypes{}), state);
+    if (gradient > 0) {
+      census.push_back(
+        {w->get_name(), tensor_role::gradients, gradient, false});
+    }
+    if (state > gradient) {
+      census.push_back({w->get_name(),
+                        tensor_role::optimizer_state,
+                        state - gradient,
+                        false});
+    }
+  }
+  return census;
+}
+
+size_t forecast_peak_memory(std::vector<tensor_allocation> const& census,
+                            size_t census_mini_batch_size,
+                            size_t mini_batch_size)
+{
+  if (census_mini_batch_size == 0) {
+    LBANN_ERROR("Cannot forecast from a census at mini-batch size 0");
+  }
+  double bytes = 0.;
+  double const scale =
+    static_cast<double>(mini_batch_size) / census_mini_batch_size;
+  for (auto const& t : census) {
+    bytes += t.per_sample ? t.bytes * scale : t.bytes;
+  }
+  return static_cast<size_t>(std::ceil(bytes));
+}
+
+size_t
+largest_fitting_mini_batch_size(std::vector<tensor_allocation> const& census,
+                                size_t census_mini_batch_size,
+                                size_t budget)
+{
+  if (census_mini_batch_size == 0) {
+    LBANN_ERROR("Cannot forecast from a census at mini-batch size 0");
+  }
+  double fixed = 0., per_sample = 0.;
+  for (auto const& t : census) {
+    (t.per_sample ? per_sample : fixed) += t.bytes;
+  }
+  if (fixed > budget) {
+    return 0;
+  }
+  if (per_sample == 0.) {
+    return std::numeric_limits<size_t>::max();
+  }
+  // The forecast is linear in the mini-batch size
+  auto mini_batch_size = static_cast<size_t>(
+    std::floor((budget - fixed) * census_mini_batch_size / per_sample));
+  while (mini_batch_size > 0 &&
+         forecast_peak_memory(census, census_mini_batch_size, mini_batch_size) >
+           budget) {
+    --mini_batch_size;
+  }
+  return mini_batch_size;
+}
+
 /**
  * @brief Returns the currently used memory, or 0 if LBANN was not compiled with
  * GPU support.
@@ -255,8 +428,11 @@ static inline size_t get_total_gpu_memory()
 #endif
 }
 
-memory_profiler::memory_profiler(bool detailed_first_step)
-  : callback_base(), m_detailed_first_step(detailed_first_step)
+memory_profiler::memory_profiler(bool detailed_first_step,
+                                 std::vector<size_t> forecast_mini_batch_sizes)
+  : callback_base(),
+    m_detailed_first_step(detailed_first_step),
+    m_forecast_mini_batch_sizes(std::move(forecast_mini_batch_sizes))
 {
 #ifndef LBANN_HAS_GPU
   LBANN_WARNING(
@@ -278,6 +454,8 @@ void memory_profiler::write_specific_proto(lbann_data::Callback& proto) const
 {
   auto* msg = proto.mutable_memory_profiler();
   msg->set_detailed_first_step(m_detailed_first_step);
+  msg->set_forecast_mini_batch_sizes(
+    protobuf::to_space_sep_string(m_forecast_mini_batch_sizes));
 }
 
 void memory_profiler::on_setup_begin(model* m)
@@ -627,8 +805,11 @@ void memory_profiler::on_batch_end(model* m)
       // Print memory pool report, if exists
       auto& pool = El::cub::MemoryPool();
       pool.Report(std::cout);
+      report_memory_pool();
 #endif // HYDROGEN_HAVE_CUB
     }
+
+    report_peak_census(m);
   }
 
   // Increment step counter
@@ -637,6 +818,36 @@ void memory_profiler::on_batch_end(model* m)
   }
 }
 
+void memory_profiler::on_epoch_end(model* m)
+{
+  // Mini-batch size changes happen at epoch boundaries and may
+  // fragment the pool
+  if (m_current_step > 2 && m->get_comm()->am_trainer_master()) {
+    report_memory_pool();
+  }
+}
+
+void memory_profiler::report_memory_pool() const
+{
+#ifdef LBANN_HAS_GPU
+  auto const stats = gpu::get_memory_pool_statistics();
+  if (stats.live_blocks == 0 && stats.free_blocks == 0) {
+    return;
+  }
+  std::ostringstream ss;
+  ss << "MEM: Memory pool: " << stats.live_bytes / 1048576.0 << " MiB live in "
+     << stats.live_blocks << " blocks, " << stats.free_bytes / 1048576.0
+     << " MiB cached in " << stats.free_blocks
+     << " blocks (largest: " << stats.largest_free_block / 1048576.0
+     << " MiB, fragmentation: " << stats.fragmentation() << ")\n";
+  for (auto const& [bytes, count] : stats.free_bins) {
+    ss << "MEM:   cached bin " << bytes / 1048576.0 << " MiB: " << count
+       << " blocks\n";
+  }
+  std::cout << ss.str() << std::flush;
+#endif // LBANN_HAS_GPU
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Per-layer memory accounting
 
@@ -662,13 +873,93 @@ void memory_profiler::on_setup_end(model* m, Layer* l)
   }
 }
 
-void memory_profiler::collect_peak_usage()
+void memory_profiler::collect_peak_usage(model* m)
 {
   if (m_current_step == 2) { // Collect peak memory usage in 3rd step
     size_t current_usage = get_used_gpu_memory();
     if (current_usage > m_peak_mem_usage) {
       m_peak_mem_usage = current_usage;
     }
+
+    // Keep the census of the live tensors with the most memory
+    auto census = take_memory_census(*m);
+    size_t bytes = 0;
+    for (auto const& t : census) {
+      bytes += t.bytes;
+    }
+    if (bytes > m_peak_census_bytes) {
+      size_t const used = current_usage > m_initial_memory_usage
+                            ? current_usage - m_initial_memory_usage
+                            : 0;
+      if (used > bytes) {
+        census.push_back(
+          {"", tensor_role::unattributed, used - bytes, false});
+      }
+      m_peak_census = std::move(census);
+      m_peak_census_bytes = bytes;
+    }
+  }
+}
+
+void memory_profiler::report_peak_census(model* m)
+{
+  if (m_peak_census.empty()) {
+    return;
+  }
+  std::map<tensor_role, size_t> by_role;
+  size_t total = 0;
+  for (auto const& t : m_peak_census) {
+    by_role[t.role] += t.bytes;
+    total += t.bytes;
+  }
+  std::cout << "MEM: Live tensors at peak: " << total / 1048576.0 << " MiB"
+            << std::endl;
+  for (auto const& [role, bytes] : by_role) {
+    std::cout << "  " << to_string(role) << ": " << bytes / 1048576.0
+              << " MiB" << std::endl;
+  }
+
+  auto largest = m_peak_census;
+  std::stable_sort(largest.begin(),
+                   largest.end(),
+                   [](tensor_allocation const& a, tensor_allocation const& b) {
+                     return a.bytes > b.bytes;
+                   });
+  largest.resize(std::min<size_t>(largest.size(), 10));
+  std::cout << "MEM: Largest tensors at peak:" << std::endl;
+  for (auto const& t : largest) {
+    std::cout << "  " << (t.owner.empty() ? "(none)" : t.owner) << " ("
+              << to_string(t.role) << "): " << t.bytes / 1048576.0 << " MiB"
+              << std::endl;
+  }
+
+  size_t const census_mini_batch_size = m->get_max_mini_batch_size();
+  if (census_mini_batch_size == 0) {
+    return;
+  }
+  for (auto const& mini_batch_size : m_forecast_mini_batch_sizes) {
+    std::cout << "MEM: Forecast peak memory at mini-batch size "
+              << mini_batch_size << ": "
+              << forecast_peak_memory(m_peak_census,
+                                      census_mini_batch_size,
+                                      mini_batch_size) /
+                   1048576.0
+              << " MiB." << std::endl;
+  }
+  size_t const total_gpu_mem = get_total_gpu_memory();
+  if (total_gpu_mem > m_initial_memory_usage) {
+    size_t const budget = total_gpu_mem - m_initial_memory_usage;
+    size_t const fits = largest_fitting_mini_batch_size(m_peak_census,
+                                                        census_mini_batch_size,
+                                                        budget);
+    std::cout << "MEM: Largest mini-batch size that fits in "
+              << budget / 1048576.0 << " MiB: ";
+    if (fits == std::numeric_limits<size_t>::max()) {
+      std::cout << "unbounded" << std::endl;
+    }
+    else {
+      std::cout << fits << std::endl;
+    }
   }
 }
 
@@ -676,7 +967,7 @@ void memory_profiler::on_forward_prop_begin(model* m, Layer* l)
 {
   if (m_current_step >= 0 && m_current_step <= 2) {
     m_unaccounted_fp_layer[l] = get_used_gpu_memory();
-    collect_peak_usage();
+    collect_peak_usage(m);
   }
 }
 void memory_profiler::on_forward_prop_end(model* m, Layer* l)
@@ -692,7 +983,7 @@ void memory_profiler::on_forward_prop_end(model* m, Layer* l)
     else {
       m_unaccounted_fp_layer[l] = 0;
     }
-    collect_peak_usage();
+    collect_peak_usage(m);
 
     std::ostringstream ss;
     m_act_sizes[l] = get_activation_and_error_signal_size(*l, ss);
@@ -703,7 +994,7 @@ void memory_profiler::on_backward_prop_begin(model* m, Layer* l)
 {
   if (m_current_step >= 0 && m_current_step <= 2) {
     m_unaccounted_bp_layer[l] = get_used_gpu_memory();
-    collect_peak_usage();
+    collect_peak_usage(m);
   }
 }
 void memory_profiler::on_backward_prop_end(model* m, Layer* l)
@@ -719,7 +1010,7 @@ void memory_profiler::on_backward_prop_end(model* m, Layer* l)
     else {
       m_unaccounted_bp_layer[l] = 0;
     }
-    collect_peak_usage();
+    collect_peak_usage(m);
   }
 }
 
@@ -730,7 +1021,9 @@ std::unique_ptr<callback_base> build_memory_profiler_callback_from_pbuf(
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackMemoryProfiler&>(
       proto_msg);
-  return std::make_unique<memory_profiler>(params.detailed_first_step());
+  return std::make_unique<memory_profiler>(
+    params.detailed_first_step(),
+    parse_list<size_t>(params.forecast_mini_batch_sizes()));
 }
 
 } // namespace callback
@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/memory_replica.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/serialize.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+
+namespace lbann {
+namespace callback {
+namespace {
+
+/** Keeps replica traffic apart from other messages on the world
+ *  communicator. */
+constexpr int replica_tag = 0x6d72;
+
+/** Largest message, in bytes. */
+constexpr size_t max_chunk_size = size_t{1} << 30;
+
+/** Distance, in ranks, to the partner holding this rank's replica.
+ *  Same pairing as the checkpoint callback's partner replication. */
+int get_partner_offset(lbann_comm const& comm)
+{
+  int const ppn = comm.get_procs_per_node();
+  return (comm.get_procs_per_trainer() > ppn) ? ppn : 0;
+}
+
+data_type_weights<DataType>& get_weights(weights& w)
+{
+  auto* dtw = dynamic_cast<data_type_weights<DataType>*>(&w);
+  if (dtw == nullptr) {
+    LBANN_ERROR("memory replicas only support weights with the default "
+                "data type, but weights \"",
+                w.get_name(),
+                "\" have another one");
+  }
+  return *dtw;
+}
+
+std::string pack_weights(model& m)
+{
+  std::ostringstream oss;
+  {
+    cereal::BinaryOutputArchive ar(oss);
+    for (auto* w : m.get_weights()) {
+      ar(get_weights(*w));
+    }
+  }
+  return oss.str();
+}
+
+void unpack_weights(model& m, std::string const& state)
+{
+  utils::grid_manager grid_raii(m.get_comm()->get_trainer_grid());
+  std::istringstream iss(state);
+  cereal::BinaryInputArchive ar(iss);
+  for (auto* w : m.get_weights()) {
+    ar(get_weights(*w));
+  }
+}
+
+/** Send @c snd to @c send_rank and receive @c rcv from @c recv_rank,
+ *  both ranks in this trainer. Either buffer may be null. Sizes are
+ *  exchanged first; the data transfers are left in @c requests. */
+void post_exchange(lbann_comm const& comm,
+                   std::string const* snd,
+                   int send_rank,
+                   std::string* rcv,
+                   int recv_rank,
+                   std::vector<El::mpi::Request<El::byte>>& requests)
+{
+  auto const& world = comm.get_world_comm();
+  int const trainer = comm.get_trainer_rank();
+  int const send_world_rank = comm.get_world_rank(trainer, send_rank);
+  int const recv_world_rank = comm.get_world_rank(trainer, recv_rank);
+
+  uint64_t const snd_size = (snd != nullptr) ? snd->size() : 0;
+  uint64_t rcv_size = 0;
+  std::vector<El::mpi::Request<uint64_t>> size_requests;
+  if (rcv != nullptr) {
+    size_requests.emplace_back();
+    comm.nb_tagged_recv(&rcv_size,
+                        1,
+                        recv_world_rank,
+                        replica_tag,
+                        size_requests.back(),
+                        world);
+  }
+  if (snd != nullptr) {
+    size_requests.emplace_back();
+    comm.nb_tagged_send(&snd_size,
+                        1,
+                        send_world_rank,
+                        replica_tag,
+                        size_requests.back(),
+                        world);
+  }
+  comm.wait_all(size_requests);
+
+  if (rcv != nullptr) {
+    rcv->resize(rcv_size);
+    auto* data = reinterpret_cast<El::byte*>(rcv->data());
+    for (size_t offset = 0; offset < rcv_size; offset += max_chunk_size) {
+      requests.emplace_back();
+      comm.nb_tagged_recv(data + offset,
+                          std::min(max_chunk_size, rcv_size - offset),
+                          recv_world_rank,
+                          replica_tag,
+                          requests.back(),
+                          world);
+    }
+  }
+  if (snd != nullptr) {
+    auto const* data = reinterpret_cast<El::byte const*>(snd->data());
+    for (size_t offset = 0; offset < snd_size; offset += max_chunk_size) {
+      requests.emplace_back();
+      comm.nb_tagged_send(data + offset,
+                          std::min(max_chunk_size, snd_size - offset),
+                          send_world_rank,
+                          replica_tag,
+                          requests.back(),
+                          world);
+    }
+  }
+}
+
+} // namespace
+
+template <class Archive>
+void memory_replica::serialize(Archive& ar)
+{
+  ar(::cereal::make_nvp("BaseCallback",
+                        ::cereal::base_class<callback_base>(this)));
+}
+
+void memory_replica::write_specific_proto(lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_memory_replica();
+  msg->set_batch_interval(m_batch_interval);
+}
+
+void memory_replica::finish_exchange(lbann_comm const& comm)
+{
+  if (m_requests.empty()) {
+    return;
+  }
+  comm.wait_all(m_requests);
+  m_requests.clear();
+  std::swap(m_partner, m_incoming);
+  m_incoming.clear();
+}
+
+void memory_replica::on_batch_end(model* m)
+{
+  auto const& comm = *m->get_comm();
+  int const offset = get_partner_offset(comm);
+  if (offset == 0) {
+    if (m_step < 0 && comm.am_trainer_master()) {
+      LBANN_WARNING("trainer fits on one node, "
+                    "so memory replicas would not survive a node failure");
+    }
+    m_step = 0;
+    return;
+  }
+
+  // The previous exchange must finish before its buffers are reused
+  finish_exchange(comm);
+  m_local = pack_weights(*m);
+  m_step = m->get_execution_context().get_step();
+
+  int const rank = comm.get_rank_in_trainer();
+  int const procs = comm.get_procs_per_trainer();
+  post_exchange(comm,
+                &m_local,
+                (rank + offset) % procs,
+                &m_incoming,
+                (rank - offset + procs) % procs,
+                m_requests);
+}
+
+void memory_replica::on_train_end(model* m)
+{
+  finish_exchange(*m->get_comm());
+}
+
+El::Int memory_replica::restore(model& m, bool lost)
+{
+  auto const& comm = *m.get_comm();
+  finish_exchange(comm);
+  if (comm.trainer_allreduce(lost ? 1 : 0, El::mpi::MAX) == 0) {
+    return -1;
+  }
+  int const offset = get_partner_offset(comm);
+  if (offset == 0 || m_local.empty()) {
+    LBANN_ERROR("rank ",
+                comm.get_rank_in_trainer(),
+                " has no memory replica to restore from");
+  }
+
+  // Tell the partner holding this rank's replica whether it is needed
+  int const rank = comm.get_rank_in_trainer();
+  int const procs = comm.get_procs_per_trainer();
+  int const holder = (rank + offset) % procs;
+  int const owner = (rank - offset + procs) % procs;
+  int const my_lost = lost;
+  int holder_lost = 0, owner_lost = 0;
+  comm.sendrecv(&my_lost,
+                1,
+                comm.get_trainer_rank(),
+                holder,
+                &owner_lost,
+                1,
+                comm.get_trainer_rank(),
+                owner,
+                El::SyncInfo<El::Device::CPU>{});
+  comm.sendrecv(&my_lost,
+                1,
+                comm.get_trainer_rank(),
+                owner,
+                &holder_lost,
+                1,
+                comm.get_trainer_rank(),
+                holder,
+                El::SyncInfo<El::Device::CPU>{});
+  if (lost && holder_lost) {
+    LBANN_ERROR("rank ",
+                rank,
+                " and rank ",
+                holder,
+                ", which holds its memory replica, were both lost");
+  }
+
+  // Lost ranks get their state back from its holder
+  std::string recovered;
+  std::vector<El::mpi::Request<El::byte>> requests;
+  post_exchange(comm,
+                owner_lost ? &m_partner : nullptr,
+                owner,
+                lost ? &recovered : nullptr,
+                holder,
+                requests);
+  comm.wait_all(requests);
+  if (lost) {
+    m_local = std::move(recovered);
+  }
+  unpack_weights(m, m_local);
+  return m_step;
+}
+
+std::unique_ptr<callback_base> build_memory_replica_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg,
+  std::shared_ptr<lbann_summary> const&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackMemoryReplica&>(
+      proto_msg);
+  return std::make_unique<memory_replica>(
+    std::max<int>(params.batch_interval(), 1));
+}
+
+} // namespace callback
+} // namespace lbann
+
+#define LBANN_CLASS_NAME callback::memory_replica
+#define LBANN_CLASS_LIBNAME callback_memory_replica
+#include <lbann/macros/register_class_with_cereal.hpp>
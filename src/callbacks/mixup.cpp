@@ -32,9 +32,11 @@
 #include "lbann/utils/beta.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/protobuf.hpp"
-#include "lbann/utils/serialize.hpp"
 #include "lbann/utils/profiling.hpp"
+#include "lbann/utils/serialize.hpp"
+#include "lbann/utils/sync_info_helpers.hpp"
 #include <algorithm>
+#include <numeric>
 
 #include "lbann/proto/callbacks.pb.h"
 
@@ -82,54 +84,72 @@ void mixup::on_forward_prop_end(model* m, Layer* l)
   }
 
   auto* dtl = dynamic_cast<data_type_layer<DataType>*>(l);
-  auto& samples_orig = dtl->get_local_activations(0);
-  auto& labels_orig = dtl->get_local_activations(1);
-  if (samples_orig.GetDevice() != El::Device::CPU ||
-      labels_orig.GetDevice() != El::Device::CPU) {
-    LBANN_ERROR("Mixup requires CPU data.");
+  auto& samples = dtl->get_local_activations(0);
+  auto& labels = dtl->get_local_activations(1);
+  if (samples.GetDevice() != labels.GetDevice()) {
+    LBANN_ERROR("Mixup requires samples and labels on the same device.");
   }
-  // Copy samples.
-  // Assumes data are on CPU.
-  CPUMat samples, labels;
-  El::Copy(samples_orig, samples);
-  El::Copy(labels_orig, labels);
-  El::Int mbsize = samples.Width();
-  const El::Int samples_height = samples.Height();
-  const El::Int labels_height = labels.Height();
+  const El::Int mbsize = samples.Width();
   auto& gen = get_fast_generator();
   beta_distribution<float> dist(m_alpha, m_alpha);
 
-  // For now, data must be on the CPU.
-  if (samples.GetDevice() != El::Device::CPU ||
-      labels.GetDevice() != El::Device::CPU) {
-    LBANN_ERROR("mixup only works with CPU data");
-  }
-
-  // Decide how to mix the mini-batch.
+  // Decide how to mix the mini-batch: split it into random pairs, once
+  // per step. With an odd mini-batch size, one sample is left unmixed.
   std::vector<El::Int> shuffled_indices(mbsize);
   std::iota(shuffled_indices.begin(), shuffled_indices.end(), 0);
   std::shuffle(shuffled_indices.begin(), shuffled_indices.end(), gen);
+  const El::Int num_pairs = mbsize / 2;
+  El::Matrix<El::Int> pairs(2, num_pairs);
+  CPUMat lambdas(2, num_pairs);
+  for (El::Int k = 0; k < num_pairs; ++k) {
+    for (El::Int side = 0; side < 2; ++side) {
+      pairs(side, k) = shuffled_indices[2 * k + side];
+      float lambda = dist(gen);
+      lambdas(side, k) = std::max(lambda, 1.0f - lambda);
+    }
+  }
+  if (num_pairs == 0) {
+    return;
+  }
+
+#ifdef LBANN_HAS_GPU
+  if (samples.GetDevice() == El::Device::GPU) {
+    auto& gpu_samples =
+      static_cast<El::Matrix<DataType, El::Device::GPU>&>(samples);
+    auto& gpu_labels =
+      static_cast<El::Matrix<DataType, El::Device::GPU>&>(labels);
+    El::Matrix<El::Int, El::Device::GPU> gpu_pairs;
+    El::Matrix<DataType, El::Device::GPU> gpu_lambdas;
+    El::SetSyncInfo(gpu_pairs, get_sync_info(gpu_samples));
+    El::SetSyncInfo(gpu_lambdas, get_sync_info(gpu_samples));
+    El::Copy(pairs, gpu_pairs);
+    El::Copy(lambdas, gpu_lambdas);
+    mixup_pairs_gpu(gpu_samples, gpu_labels, gpu_pairs, gpu_lambdas);
+    return;
+  }
+#endif // LBANN_HAS_GPU
 
+  auto& cpu_samples = static_cast<CPUMat&>(samples);
+  auto& cpu_labels = static_cast<CPUMat&>(labels);
+  const El::Int samples_height = cpu_samples.Height();
+  const El::Int labels_height = cpu_labels.Height();
   LBANN_OMP_PARALLEL_FOR
-  for (El::Int i = 0; i < mbsize; ++i) {
-    const El::Int j = shuffled_indices[i];
-    if (i == j) {
-      continue;
-    }
-    float lambda = dist(gen);
-    lambda = std::max(lambda, 1.0f - lambda);
-    const float lambda_sub = 1.0f - lambda;
-    const DataType* __restrict__ x1_buf = samples.LockedBuffer(0, i);
-    const DataType* __restrict__ x2_buf = samples.LockedBuffer(0, j);
-    DataType* __restrict__ x = samples_orig.Buffer(0, i);
-    const DataType* __restrict__ y1_buf = labels.LockedBuffer(0, i);
-    const DataType* __restrict__ y2_buf = labels.LockedBuffer(0, j);
-    DataType* __restrict__ y = labels_orig.Buffer(0, i);
-    for (El::Int k = 0; k < samples_height; ++k) {
-      x[k] = lambda * x1_buf[k] + lambda_sub * x2_buf[k];
+  for (El::Int k = 0; k < num_pairs; ++k) {
+    const DataType lambda_i = lambdas(0, k);
+    const DataType lambda_j = lambdas(1, k);
+    DataType* __restrict__ xi = cpu_samples.Buffer(0, pairs(0, k));
+    DataType* __restrict__ xj = cpu_samples.Buffer(0, pairs(1, k));
+    DataType* __restrict__ yi = cpu_labels.Buffer(0, pairs(0, k));
+    DataType* __restrict__ yj = cpu_labels.Buffer(0, pairs(1, k));
+    for (El::Int r = 0; r < samples_height; ++r) {
+      const DataType a = xi[r], b = xj[r];
+      xi[r] = lambda_i * a + (1 - lambda_i) * b;
+      xj[r] = lambda_j * b + (1 - lambda_j) * a;
     }
-    for (El::Int k = 0; k < labels_height; ++k) {
-      y[k] = lambda * y1_buf[k] + lambda_sub * y2_buf[k];
+    for (El::Int r = 0; r < labels_height; ++r) {
+      const DataType a = yi[r], b = yj[r];
+      yi[r] = lambda_i * a + (1 - lambda_i) * b;
+      yj[r] = lambda_j * b + (1 - lambda_j) * a;
     }
   }
 }
@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/mixup.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace callback {
+
+namespace {
+
+/** Each thread handles one entry of one pair, in both the samples and
+ *  the labels, so both columns are read and written once. */
+__global__ void mixup_pairs_kernel(El::Int num_pairs,
+                                   El::Int samples_height,
+                                   El::Int labels_height,
+                                   DataType* __restrict__ samples,
+                                   El::Int samples_ldim,
+                                   DataType* __restrict__ labels,
+                                   El::Int labels_ldim,
+                                   const El::Int* __restrict__ pairs,
+                                   El::Int pairs_ldim,
+                                   const DataType* __restrict__ lambdas,
+                                   El::Int lambdas_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int height = samples_height + labels_height;
+  for (El::Int pos = gid; pos < num_pairs * height; pos += num_threads) {
+    const auto& k = pos / height;
+    const auto& row = pos % height;
+    const auto& i = pairs[k * pairs_ldim];
+    const auto& j = pairs[k * pairs_ldim + 1];
+    const auto& lambda_i = lambdas[k * lambdas_ldim];
+    const auto& lambda_j = lambdas[k * lambdas_ldim + 1];
+    DataType* xi;
+    DataType* xj;
+    if (row < samples_height) {
+      xi = &samples[row + i * samples_ldim];
+      xj = &samples[row + j * samples_ldim];
+    }
+    else {
+      xi = &labels[row - samples_height + i * labels_ldim];
+      xj = &labels[row - samples_height + j * labels_ldim];
+    }
+    const DataType a = *xi, b = *xj;
+    *xi = lambda_i * a + (DataType(1) - lambda_i) * b;
+    *xj = lambda_j * b + (DataType(1) - lambda_j) * a;
+  }
+}
+
+} // namespace
+
+void mixup_pairs_gpu(El::Matrix<DataType, El::Device::GPU>& samples,
+                     El::Matrix<DataType, El::Device::GPU>& labels,
+                     const El::Matrix<El::Int, El::Device::GPU>& pairs,
+                     const El::Matrix<DataType, El::Device::GPU>& lambdas)
+{
+  const El::Int num_pairs = pairs.Width();
+  const El::Int size = num_pairs * (samples.Height() + labels.Height());
+  if (size == 0) {
+    return;
+  }
+  constexpr El::Int block_dim = 256;
+  El::Int grid_dim = (size + block_dim - 1) / block_dim;
+  if (sizeof(El::Int) > sizeof(uint32_t) &&
+      grid_dim > std::numeric_limits<uint32_t>::max()) {
+    grid_dim = std::numeric_limits<uint32_t>::max();
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(samples),
+                                     gpu::get_sync_info(labels),
+                                     gpu::get_sync_info(pairs),
+                                     gpu::get_sync_info(lambdas));
+  hydrogen::gpu::LaunchKernel(mixup_pairs_kernel,
+                              grid_dim,
+                              block_dim,
+                              0,
+                              multisync,
+                              num_pairs,
+                              samples.Height(),
+                              labels.Height(),
+                              samples.Buffer(),
+                              samples.LDim(),
+                              labels.Buffer(),
+                              labels.LDim(),
+                              pairs.LockedBuffer(),
+                              pairs.LDim(),
+                              lambdas.LockedBuffer(),
+                              lambdas.LDim());
+}
+
+} // namespace callback
+} // namespace lbann
@@ -31,11 +31,13 @@
 
 #include "lbann/data_ingestion/data_coordinator.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/optimizers/optimizer.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/lbann_library.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/weights/weights.hpp"
 
 #include "lbann/proto/callbacks.pb.h"
 
@@ -273,6 +275,33 @@ void print_statistics::report_results(model* m)
     if (!allow_global_statistics) {
       std::cout << report.str() << std::flush;
     }
+
+    // Report the distribution of step times
+    const auto& step_timer = c.get_step_timer();
+    if (step_timer.samples() > 0) {
+      std::cout << m->get_name() << " (instance " << comm->get_trainer_rank()
+                << ") " << mode_string << " step time : mean "
+                << step_timer.mean() << "s, p50 " << step_timer.percentile(0.5)
+                << "s, p95 " << step_timer.percentile(0.95) << "s, p99 "
+                << step_timer.percentile(0.99) << "s, max "
+                << step_timer.max() << "s" << std::endl;
+    }
+
+    // Report how much the compressed weights gradients saved
+    if (mode == execution_mode::training) {
+      for (const auto* w : m->get_weights()) {
+        const auto* opt = w->get_optimizer();
+        const double ratio =
+          (opt != nullptr ? opt->get_gradient_compression_ratio() : 0.);
+        if (ratio > 0.) {
+          std::cout << m->get_name() << " (instance "
+                    << comm->get_trainer_rank() << ") " << w->get_name()
+                    << " gradient compression ("
+                    << to_string(w->get_gradient_compression().method)
+                    << ") : " << ratio << "x" << std::endl;
+        }
+      }
+    }
   }
 }
 
@@ -27,11 +27,18 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/callbacks/profiler.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_ingestion/data_coordinator.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/models/model.hpp"
+#include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/timer.hpp"
 #include "lbann/weights/weights.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
 
 #include "lbann/proto/callbacks.pb.h"
 
@@ -43,13 +50,132 @@
 #endif
 
 #include <algorithm>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace lbann {
 namespace callback {
 
-profiler::profiler(bool sync, bool skip_init)
-  : callback_base(), m_sync(sync), m_skip_init(skip_init)
+namespace {
+
+/** A point in the compute stream, or in host time without GPUs. */
+class time_mark
+{
+public:
+  void record()
+  {
+#ifdef LBANN_HAS_GPU
+    m_event.record(El::SyncInfo<El::Device::GPU>{}.Stream());
+#else
+    m_time = get_time();
+#endif // LBANN_HAS_GPU
+  }
+  /** Milliseconds from @c start to this mark. */
+  double elapsed_ms(time_mark& start)
+  {
+#ifdef LBANN_HAS_GPU
+    return m_event.elapsed_ms(start.m_event);
+#else
+    return 1e3 * (m_time - start.m_time);
+#endif // LBANN_HAS_GPU
+  }
+
+private:
+#ifdef LBANN_HAS_GPU
+  gpu_lib::timing_event m_event;
+#else
+  double m_time = 0.;
+#endif // LBANN_HAS_GPU
+};
+
+} // namespace
+
+struct profiler::layer_timing
+{
+  struct span
+  {
+    Layer const* layer;
+    bool backward;
+    size_t begin;
+    size_t end;
+  };
+  struct totals
+  {
+    std::string type;
+    double fp_ms = 0.;
+    double bp_ms = 0.;
+  };
+
+  /** Marks are reused every timed step. */
+  std::deque<time_mark> marks;
+  size_t num_marks = 0;
+  /** Spans of the last timed step, not yet read back. */
+  std::vector<span> spans;
+  size_t step_begin = 0;
+  size_t step_end = 0;
+  size_t open = 0;
+  /** Whether the current step is timed. */
+  bool active = false;
+  bool pending = false;
+
+  /** Totals over the epoch, by layer name. */
+  std::map<std::string, totals> layers;
+  double step_ms = 0.;
+  int num_steps = 0;
+
+  size_t mark()
+  {
+    if (num_marks == marks.size()) {
+      marks.emplace_back();
+    }
+    marks[num_marks].record();
+    return num_marks++;
+  }
+
+  void begin_layer()
+  {
+    if (active) {
+      open = mark();
+    }
+  }
+
+  void end_layer(Layer const* l, bool backward)
+  {
+    if (active) {
+      spans.push_back({l, backward, open, mark()});
+    }
+  }
+
+  /** Add the last timed step to the totals. */
+  void resolve()
+  {
+    if (!pending) {
+      return;
+    }
+    step_ms += marks[step_end].elapsed_ms(marks[step_begin]);
+    for (auto const& s : spans) {
+      auto& t = layers[s.layer->get_name()];
+      t.type = s.layer->get_type();
+      double const ms = marks[s.end].elapsed_ms(marks[s.begin]);
+      (s.backward ? t.bp_ms : t.fp_ms) += ms;
+    }
+    ++num_steps;
+    spans.clear();
+    num_marks = 0;
+    pending = false;
+  }
+};
+
+profiler::profiler(bool sync, bool skip_init, int layer_timing_interval)
+  : callback_base(),
+    m_sync(sync),
+    m_skip_init(skip_init),
+    m_layer_timing_interval(std::max(layer_timing_interval, 0))
 {
 #ifdef LBANN_HAS_CALIPER
   if (is_caliper_initialized()) {
@@ -80,7 +206,8 @@ void profiler::serialize(Archive& ar)
   ar(::cereal::make_nvp("BaseCallback",
                         ::cereal::base_class<callback_base>(this)),
      CEREAL_NVP(m_sync),
-     CEREAL_NVP(m_skip_init));
+     CEREAL_NVP(m_skip_init),
+     CEREAL_NVP(m_layer_timing_interval));
 }
 
 void profiler::write_specific_proto(lbann_data::Callback& proto) const
@@ -88,6 +215,21 @@ void profiler::write_specific_proto(lbann_data::Callback& proto) const
   auto* msg = proto.mutable_profiler();
   msg->set_sync(m_sync);
   msg->set_skip_init(m_skip_init);
+  msg->set_layer_timing_interval(m_layer_timing_interval);
+}
+
+void profiler::on_train_begin(model* m)
+{
+  m->get_comm()->set_collective_profiling(true);
+  if (m_layer_timing_interval > 0) {
+    m_layer_timing = std::make_shared<layer_timing>();
+  }
+}
+
+void profiler::on_train_end(model* m)
+{
+  m->get_comm()->set_collective_profiling(false);
+  m_layer_timing.reset();
 }
 
 void profiler::on_epoch_begin(model* m)
@@ -106,6 +248,91 @@ void profiler::on_epoch_end(model* m)
 {
   const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
   prof_region_end(("epoch " + std::to_string(c.get_epoch())).c_str(), m_sync);
+  if (m_layer_timing) {
+    report_layer_timing(m);
+  }
+  report_data_pipeline(m);
+}
+
+void profiler::report_data_pipeline(model* m)
+{
+  const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
+  const auto mode = c.get_execution_mode();
+  const auto& stats =
+    get_const_trainer().get_data_coordinator().get_pipeline_stats();
+  const auto epoch = stats.get_last_epoch(mode);
+  const auto latency = stats.get_fetch_latency(mode);
+  auto* comm = m->get_comm();
+  // The slowest rank's input determines the trainer's step time
+  const EvalType max_wait =
+    comm->trainer_allreduce(epoch.wait_time, El::mpi::MAX);
+  if (epoch.num_steps == 0 || !comm->am_trainer_master()) {
+    return;
+  }
+  const double ms = 1e3 / epoch.num_steps;
+  const double pct =
+    epoch.step_time > 0. ? 100. * epoch.wait_time / epoch.step_time : 0.;
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(3);
+  oss << "model " << m->get_name() << " epoch " << c.get_epoch()
+      << ": data pipeline per step, averaged over " << epoch.num_steps
+      << " steps (" << epoch.step_time * ms << " ms per step)\n"
+      << "  waiting for data " << epoch.wait_time * ms << " ms ("
+      << std::setprecision(1) << pct << std::setprecision(3)
+      << "% of step, slowest rank " << max_wait * ms << " ms)\n"
+      << "  data store exchange " << epoch.exchange_time * ms << " ms\n";
+  for (size_t i = 0; i < epoch.io_busy_time.size(); ++i) {
+    oss << "  I/O thread " << i << " busy " << epoch.io_busy_time[i] * ms
+        << " ms, idle " << epoch.io_idle_time(i) * ms << " ms\n";
+  }
+  if (latency.count > 0) {
+    oss << "  fetch latency over " << latency.count
+        << " mini-batches: mean " << 1e3 * latency.mean << " ms, p50 "
+        << 1e3 * latency.p50 << " ms, p90 " << 1e3 * latency.p90
+        << " ms, p99 " << 1e3 * latency.p99 << " ms, max "
+        << 1e3 * latency.max << " ms\n";
+  }
+  std::cout << oss.str() << std::flush;
+}
+
+void profiler::report_layer_timing(model* m)
+{
+  auto& timing = *m_layer_timing;
+  timing.resolve();
+  if (timing.num_steps > 0 && m->get_comm()->am_trainer_master()) {
+    using entry = std::pair<std::string, layer_timing::totals>;
+    std::vector<entry> layers(timing.layers.begin(), timing.layers.end());
+    std::stable_sort(layers.begin(),
+                     layers.end(),
+                     [](entry const& a, entry const& b) {
+                       return (a.second.fp_ms + a.second.bp_ms >
+                               b.second.fp_ms + b.second.bp_ms);
+                     });
+    const auto& c =
+      static_cast<SGDExecutionContext&>(m->get_execution_context());
+    double const steps = timing.num_steps;
+    std::ostringstream oss;
+    oss << "model " << m->get_name() << " epoch " << c.get_epoch()
+        << ": layer times per step, averaged over " << timing.num_steps
+        << " steps (" << timing.step_ms / steps << " ms per step)\n";
+    oss << std::left << std::setw(32) << "layer" << std::setw(24) << "type"
+        << std::right << std::setw(12) << "fp ms" << std::setw(12) << "bp ms"
+        << std::setw(10) << "% step" << "\n";
+    oss << std::fixed << std::setprecision(3);
+    for (auto const& [name, t] : layers) {
+      double const pct =
+        timing.step_ms > 0. ? 100. * (t.fp_ms + t.bp_ms) / timing.step_ms
+                            : 0.;
+      oss << std::left << std::setw(32) << name << std::setw(24) << t.type
+          << std::right << std::setw(12) << t.fp_ms / steps << std::setw(12)
+          << t.bp_ms / steps << std::setw(10) << std::setprecision(1) << pct
+          << std::setprecision(3) << "\n";
+    }
+    std::cout << oss.str() << std::flush;
+  }
+  timing.layers.clear();
+  timing.step_ms = 0.;
+  timing.num_steps = 0;
 }
 
 void profiler::on_validation_begin(model* m)
@@ -142,12 +369,23 @@ void profiler::on_batch_begin(model* m)
   prof_region_begin(("batch " + std::to_string(c.get_step())).c_str(),
                     prof_colors[1],
                     m_sync);
+  if (m_layer_timing && c.get_step() % m_layer_timing_interval == 0) {
+    // By now the previous timed step has long finished on the GPU
+    m_layer_timing->resolve();
+    m_layer_timing->active = true;
+    m_layer_timing->step_begin = m_layer_timing->mark();
+  }
 }
 
 void profiler::on_batch_end(model* m)
 {
   const auto& c = m->get_execution_context();
   prof_region_end(("batch " + std::to_string(c.get_step())).c_str(), m_sync);
+  if (m_layer_timing && m_layer_timing->active) {
+    m_layer_timing->step_end = m_layer_timing->mark();
+    m_layer_timing->active = false;
+    m_layer_timing->pending = true;
+  }
 }
 
 void profiler::on_batch_evaluate_begin(model* m)
@@ -245,11 +483,17 @@ int profiler::get_color(Layer* l)
 void profiler::on_forward_prop_begin(model* m, Layer* l)
 {
   prof_region_begin(("fw " + l->get_name()).c_str(), get_color(l), m_sync);
+  if (m_layer_timing) {
+    m_layer_timing->begin_layer();
+  }
 }
 
 void profiler::on_forward_prop_end(model* m, Layer* l)
 {
   prof_region_end(("fw " + l->get_name()).c_str(), m_sync);
+  if (m_layer_timing) {
+    m_layer_timing->end_layer(l, false);
+  }
 }
 
 void profiler::on_evaluate_forward_prop_begin(model* m, Layer* l)
@@ -265,11 +509,17 @@ void profiler::on_evaluate_forward_prop_end(model* m, Layer* l)
 void profiler::on_backward_prop_begin(model* m, Layer* l)
 {
   prof_region_begin(("bw " + l->get_name()).c_str(), get_color(l), m_sync);
+  if (m_layer_timing) {
+    m_layer_timing->begin_layer();
+  }
 }
 
 void profiler::on_backward_prop_end(model* m, Layer* l)
 {
   prof_region_end(("bw " + l->get_name()).c_str(), m_sync);
+  if (m_layer_timing) {
+    m_layer_timing->end_layer(l, true);
+  }
 }
 
 void profiler::on_optimize_begin(model* m, weights* w)
@@ -288,7 +538,9 @@ build_profiler_callback_from_pbuf(const google::protobuf::Message& proto_msg,
 {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackProfiler&>(proto_msg);
-  return std::make_unique<profiler>(params.sync(), params.skip_init());
+  return std::make_unique<profiler>(params.sync(),
+                                    params.skip_init(),
+                                    params.layer_timing_interval());
 }
 
 } // namespace callback
@@ -30,6 +30,7 @@
 #include "lbann/callbacks/checkpoint.hpp" // Reuse the checkpoint naming scheme
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
+#include "lbann/io/weights_container.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/weights/data_type_weights.hpp"
@@ -83,6 +84,8 @@ void save_model::write_specific_proto(lbann_data::Callback& proto) const
   msg->set_dir(m_dir);
   msg->set_extension(m_extension);
   msg->set_disable_save_after_training(m_disable_save_after_training);
+  msg->set_weights_container(m_weights_container);
+  msg->set_compression_level(m_compression_level);
 }
 
 bool save_model::do_save_model(model* m)
@@ -140,21 +143,31 @@ bool save_model::do_save_model_weights(model* m)
                                                 m_dir.c_str());
   p.open_checkpoint_dir(epochdir.c_str(), comm->am_trainer_master());
 
-  for (weights* w : m->get_weights()) {
-    // create weight file name to match to weight list entry
-    const auto* dtw = dynamic_cast<const data_type_weights<DataType>*>(w);
-    auto file = El::BuildString(epochdir,
-                                "model_weights_",
-                                w->get_name(),
-                                "_",
-                                dtw->get_values().Height(),
-                                "x",
-                                dtw->get_values().Width());
-
-    El::Write(dtw->get_values(), file, El::BINARY);
+  uint64_t bytes_count = 0;
+  if (m_weights_container) {
+    bytes_count =
+      weights_container::write(epochdir + weights_container::file_name,
+                               m->get_weights(),
+                               *comm,
+                               m_compression_level);
+  }
+  else {
+    for (weights* w : m->get_weights()) {
+      // create weight file name to match to weight list entry
+      const auto* dtw = dynamic_cast<const data_type_weights<DataType>*>(w);
+      auto file = El::BuildString(epochdir,
+                                  "model_weights_",
+                                  w->get_name(),
+                                  "_",
+                                  dtw->get_values().Height(),
+                                  "x",
+                                  dtw->get_values().Width());
+
+      El::Write(dtw->get_values(), file, El::BINARY);
+    }
   }
 
-  uint64_t bytes_count = p.get_bytes();
+  bytes_count += p.get_bytes();
 
   if (comm->am_trainer_master()) {
     EvalType secs = timer.Stop();
@@ -183,15 +196,13 @@ build_save_model_callback_from_pbuf(const google::protobuf::Message& proto_msg,
 {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackSaveModel&>(proto_msg);
-  if (params.extension().size() != 0) {
-    return std::make_unique<save_model>(params.dir(),
-                                        params.disable_save_after_training(),
-                                        params.extension());
-  }
-  else {
-    return std::make_unique<save_model>(params.dir(),
-                                        params.disable_save_after_training());
-  }
+  std::string const extension =
+    params.extension().size() != 0 ? params.extension() : "prototext";
+  return std::make_unique<save_model>(params.dir(),
+                                      params.disable_save_after_training(),
+                                      extension,
+                                      params.weights_container(),
+                                      params.compression_level());
 }
 
 } // namespace callback
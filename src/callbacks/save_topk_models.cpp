@@ -122,7 +122,9 @@ std::unique_ptr<callback_base> build_save_topk_models_callback_from_pbuf(
   return std::make_unique<save_topk_models>(params.dir(),
                                             params.k(),
                                             params.metric(),
-                                            params.ascending_ordering());
+                                            params.ascending_ordering(),
+                                            params.weights_container(),
+                                            params.compression_level());
 }
 
 } // namespace callback
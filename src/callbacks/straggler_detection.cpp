@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// straggler_detection .hpp .cpp - Callback to report slow ranks
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/straggler_detection.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/serialize.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace lbann {
+namespace callback {
+
+namespace {
+constexpr int max_host_name = 64;
+} // namespace
+
+template <class Archive>
+void straggler_detection::serialize(Archive& ar)
+{
+  ar(::cereal::make_nvp("BaseCallback",
+                        ::cereal::base_class<callback_base>(this)),
+     CEREAL_NVP(m_report_interval),
+     CEREAL_NVP(m_num_ranks));
+}
+
+void straggler_detection::write_specific_proto(
+  lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_straggler_detection();
+  msg->set_batch_interval(m_batch_interval);
+  msg->set_report_interval(m_report_interval);
+  msg->set_num_ranks(m_num_ranks);
+}
+
+void straggler_detection::setup(model* m)
+{
+  // Bad nodes are found by name, so collect them once up front
+  const auto& comm = *m->get_comm();
+  std::array<char, max_host_name> host{};
+  gethostname(host.data(), host.size() - 1);
+  auto const* host_bytes = reinterpret_cast<El::byte const*>(host.data());
+  if (comm.am_world_master()) {
+    const int num_ranks = comm.get_procs_in_world();
+    std::vector<El::byte> hosts(num_ranks * max_host_name);
+    comm.gather(host_bytes,
+                max_host_name,
+                hosts.data(),
+                comm.get_world_comm());
+    m_hosts.clear();
+    for (int r = 0; r < num_ranks; ++r) {
+      m_hosts.emplace_back(
+        reinterpret_cast<char const*>(&hosts[r * max_host_name]));
+    }
+  }
+  else {
+    comm.gather(host_bytes, max_host_name, 0, comm.get_world_comm());
+  }
+}
+
+void straggler_detection::on_forward_prop_end(model* m)
+{
+  const auto& comm = *m->get_comm();
+  m_arrival_time = get_time();
+  comm.nb_barrier(comm.get_world_comm(), m_req);
+  m_arrived = true;
+}
+
+void straggler_detection::on_backward_prop_begin(model* m)
+{
+  if (!m_arrived) {
+    return;
+  }
+  m->get_comm()->wait(m_req);
+  m_arrived = false;
+  m_total_wait += get_time() - m_arrival_time;
+  if (++m_num_samples >= m_report_interval) {
+    report(m);
+  }
+}
+
+void straggler_detection::on_train_end(model* m)
+{
+  if (m_arrived) {
+    m->get_comm()->wait(m_req);
+    m_arrived = false;
+  }
+  if (m_num_samples > 0) {
+    report(m);
+  }
+}
+
+void straggler_detection::report(model* m)
+{
+  const auto& comm = *m->get_comm();
+  const double mean_wait = m_total_wait / m_num_samples;
+  const int num_samples = m_num_samples;
+  m_total_wait = 0.;
+  m_num_samples = 0;
+  if (!comm.am_world_master()) {
+    comm.gather(mean_wait, 0, comm.get_world_comm());
+    return;
+  }
+
+  const int num_ranks = comm.get_procs_in_world();
+  std::vector<double> waits(num_ranks);
+  comm.gather(mean_wait, waits, comm.get_world_comm());
+
+  // The process that arrived first waited longest
+  const double max_wait = *std::max_element(waits.begin(), waits.end());
+  std::vector<double> lags(num_ranks);
+  for (int r = 0; r < num_ranks; ++r) {
+    lags[r] = max_wait - waits[r];
+  }
+  std::vector<int> order(num_ranks);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&lags](int a, int b) {
+    return lags[a] > lags[b];
+  });
+  auto percentile = [&](double p) {
+    const size_t i = static_cast<size_t>(p * (num_ranks - 1) + 0.5);
+    return lags[order[num_ranks - 1 - i]];
+  };
+
+  std::ostringstream msg;
+  msg << std::fixed << std::setprecision(3) << "straggler detection (over "
+      << num_samples << " steps): lag (ms) median " << 1e3 * percentile(0.5)
+      << ", p90 " << 1e3 * percentile(0.9) << ", p99 "
+      << 1e3 * percentile(0.99) << ", max " << 1e3 * lags[order.front()]
+      << '\n';
+  const int num_listed = std::min(m_num_ranks, num_ranks);
+  for (int i = 0; i < num_listed; ++i) {
+    const int r = order[i];
+    msg << "  rank " << r << " ("
+        << (r < static_cast<int>(m_hosts.size()) ? m_hosts[r] : "?")
+        << "): " << 1e3 * lags[r] << " ms behind\n";
+  }
+  std::cout << msg.str() << std::flush;
+}
+
+std::unique_ptr<callback_base> build_straggler_detection_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg,
+  std::shared_ptr<lbann_summary> const&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackStragglerDetection&>(
+      proto_msg);
+  return std::make_unique<straggler_detection>(
+    params.batch_interval(),
+    params.report_interval() > 0 ? params.report_interval() : 100,
+    params.num_ranks() > 0 ? params.num_ranks() : 8);
+}
+
+} // namespace callback
+} // namespace lbann
+
+#define LBANN_CLASS_NAME callback::straggler_detection
+#define LBANN_CLASS_LIBNAME callback_straggler_detection
+#include <lbann/macros/register_class_with_cereal.hpp>
@@ -27,11 +27,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/callbacks/summary.hpp"
+#include "lbann/data_ingestion/data_coordinator.hpp"
 #include "lbann/execution_algorithms/execution_context.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/metrics/metric.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/trainers/trainer.hpp"
 #include "lbann/weights/data_type_weights.hpp"
 
 #include "lbann/utils/memory.hpp"
@@ -42,6 +44,7 @@
 
 #include <algorithm>
 #include <string>
+#include <utility>
 
 namespace lbann {
 namespace callback {
@@ -87,6 +90,34 @@ void summary::on_batch_end(model* m)
                               intertrainer_barriers,
                               c.get_step());
   m_summarizer->reduce_scalar("global_barriers", global_barriers, c.get_step());
+  // Every rank reports every phase, so the reductions match even when
+  // a phase only ran on some ranks
+  const auto& kfac_timer = m->get_kfac_phase_timer();
+  if (kfac_timer.has_steps()) {
+    for (const auto& phase : kfac::phase_names()) {
+      m_summarizer->reduce_scalar("kfac_time/" + phase,
+                                  kfac_timer.get_step_time(phase),
+                                  c.get_step());
+    }
+  }
+  const auto& io =
+    get_const_trainer().get_data_coordinator().get_pipeline_stats();
+  const auto& io_step = io.get_last_step();
+  m_summarizer->reduce_scalar("data_pipeline/wait_time",
+                              io_step.wait_time,
+                              c.get_step());
+  m_summarizer->reduce_scalar("data_pipeline/exchange_time",
+                              io_step.exchange_time,
+                              c.get_step());
+  for (size_t i = 0; i < io_step.io_busy_time.size(); ++i) {
+    const std::string prefix = "data_pipeline/io_thread" + std::to_string(i);
+    m_summarizer->reduce_scalar(prefix + "/busy_time",
+                                io_step.io_busy_time[i],
+                                c.get_step());
+    m_summarizer->reduce_scalar(prefix + "/idle_time",
+                                io_step.io_idle_time(i),
+                                c.get_step());
+  }
   prof_region_end("summary-batch", false);
 }
 
@@ -109,6 +140,22 @@ void summary::on_epoch_end(model* m)
     std::string phase = "train_" + metric_name;
     m_summarizer->reduce_scalar(phase, train_score, c.get_step());
   }
+  const auto& io =
+    get_const_trainer().get_data_coordinator().get_pipeline_stats();
+  const auto latency = io.get_fetch_latency(c.get_execution_mode());
+  if (latency.count > 0) {
+    const std::pair<std::string, EvalType> latencies[] = {
+      {"mean", latency.mean},
+      {"p50", latency.p50},
+      {"p90", latency.p90},
+      {"p99", latency.p99},
+      {"max", latency.max}};
+    for (const auto& [stat, value] : latencies) {
+      m_summarizer->reduce_scalar("data_pipeline/fetch_latency_" + stat,
+                                  value,
+                                  c.get_step());
+    }
+  }
   save_histograms(m);
   m_summarizer->flush();
   prof_region_end("summary-epoch", false);
@@ -155,27 +202,24 @@ void summary::save_histograms(model* m)
   for (const auto& layer : m->get_layers()) {
     const std::string prefix = layer->get_name() + "/";
     for (int i = 0; i < layer->get_num_children(); ++i) {
+      // Histograms are binned on the matrix's own device
       auto* dtl = dynamic_cast<LayerType*>(layer);
-      AbsDistMatReadProxy<El::Device::CPU> acts(dtl->get_activations(i));
       m_summarizer->reduce_histogram(prefix + "activations" + std::to_string(i),
-                                     acts.GetLocked(),
+                                     dtl->get_activations(i),
                                      c.get_step());
     }
   }
   for (const auto& w : m->get_weights()) {
     const std::string prefix = w->get_name() + "/";
     auto* dtw = dynamic_cast<WeightsType*>(w);
-    AbsDistMatReadProxy<El::Device::CPU> weights(dtw->get_values());
     m_summarizer->reduce_histogram(prefix + "weights",
-                                   weights.GetLocked(),
+                                   dtw->get_values(),
                                    c.get_step());
     optimizer* opt = w->get_optimizer();
     if (opt != nullptr) {
       auto* dt_opt = dynamic_cast<OptimizerType*>(opt);
-      auto& grad = dt_opt->get_gradient_sharded();
-      AbsDistMatReadProxy<El::Device::CPU> gradients(grad);
       m_summarizer->reduce_histogram(prefix + "weights_gradient",
-                                     gradients.GetLocked(),
+                                     dt_opt->get_gradient_sharded(),
                                      c.get_step());
     }
   }
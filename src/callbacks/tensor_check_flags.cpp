@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/tensor_check_flags.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace lbann {
+namespace callback {
+
+namespace {
+
+bool trips(tensor_check_kind kind, DataType x)
+{
+  switch (kind) {
+  case tensor_check_kind::nonfinite:
+    return !std::isfinite(x);
+  case tensor_check_kind::small: {
+    static const DataType threshold =
+      El::Sqrt(std::numeric_limits<DataType>::min());
+    const auto abs_x = std::abs(x);
+    return abs_x > DataType(0) && abs_x <= threshold;
+  }
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
+tensor_check_flags::tensor_check_flags(tensor_check_kind kind) : m_kind(kind)
+{}
+
+tensor_check_flags::tensor_check_flags(const tensor_check_flags& other)
+  : m_kind(other.m_kind)
+{}
+
+tensor_check_flags&
+tensor_check_flags::operator=(const tensor_check_flags& other)
+{
+  m_kind = other.m_kind;
+  m_labels.clear();
+  m_host_flags.clear();
+  m_ended_labels.clear();
+  m_ended_host_flags.clear();
+  m_added.clear();
+  return *this;
+}
+
+tensor_check_flags::~tensor_check_flags() = default;
+
+void tensor_check_flags::begin_step(size_t max_tensors)
+{
+  m_labels.clear();
+  m_host_flags.clear();
+  m_added.clear();
+#ifdef LBANN_HAS_GPU
+  if (m_flags_gpu.Height() < static_cast<El::Int>(max_tensors)) {
+    m_flags_gpu.Resize(max_tensors, 1);
+    El::Zero(m_flags_gpu);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+size_t tensor_check_flags::claim_slot(std::string label)
+{
+  const size_t slot = m_labels.size();
+#ifdef LBANN_HAS_GPU
+  if (slot >= static_cast<size_t>(m_flags_gpu.Height())) {
+    LBANN_ERROR("checked more tensors in a step than the ",
+                m_flags_gpu.Height(),
+                " expected");
+  }
+#endif // LBANN_HAS_GPU
+  m_labels.emplace_back(std::move(label));
+  m_host_flags.push_back(false);
+  return slot;
+}
+
+void tensor_check_flags::check_cpu(const El::AbstractMatrix<DataType>& mat,
+                                   size_t slot)
+{
+  const El::Int height = mat.Height();
+  const El::Int width = mat.Width();
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      if (trips(m_kind, mat(row, col))) {
+        m_host_flags[slot] = true;
+        return;
+      }
+    }
+  }
+}
+
+void tensor_check_flags::check(const El::AbstractDistMatrix<DataType>& mat,
+                               std::string label)
+{
+  const size_t slot = claim_slot(std::move(label));
+  const auto& local_mat = mat.LockedMatrix();
+  switch (local_mat.GetDevice()) {
+  case El::Device::CPU:
+    check_cpu(local_mat, slot);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    tensor_check_gpu(
+      m_kind,
+      static_cast<const El::Matrix<DataType, El::Device::GPU>&>(local_mat),
+      slot,
+      m_flags_gpu);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device for tensor check");
+  }
+}
+
+void tensor_check_flags::add(const El::AbstractDistMatrix<DataType>& mat,
+                             std::string label)
+{
+  m_added.emplace_back(&mat.LockedMatrix(), claim_slot(std::move(label)));
+}
+
+void tensor_check_flags::check_added()
+{
+#ifdef LBANN_HAS_GPU
+  std::vector<tensor_check_entry> entries;
+  std::vector<El::SyncInfo<El::Device::GPU>> entry_syncs;
+  const auto flags_sync = El::SyncInfoFromMatrix(m_flags_gpu);
+#endif // LBANN_HAS_GPU
+  for (const auto& [local_mat, slot] : m_added) {
+#ifdef LBANN_HAS_GPU
+    if (local_mat->GetDevice() == El::Device::GPU) {
+      const auto& gpu_mat =
+        static_cast<const El::Matrix<DataType, El::Device::GPU>&>(*local_mat);
+      if (!gpu_mat.Contiguous()) {
+        tensor_check_gpu(m_kind, gpu_mat, slot, m_flags_gpu);
+        continue;
+      }
+      // The fused launch runs on the flags' stream once the buffer
+      // is ready
+      entry_syncs.push_back(El::SyncInfoFromMatrix(gpu_mat));
+      El::AddSynchronizationPoint(entry_syncs.back(), flags_sync);
+      entries.push_back({gpu_mat.LockedBuffer(),
+                         static_cast<size_t>(gpu_mat.Height()) *
+                           static_cast<size_t>(gpu_mat.Width()),
+                         slot});
+      continue;
+    }
+#endif // LBANN_HAS_GPU
+    check_cpu(*local_mat, slot);
+  }
+  m_added.clear();
+#ifdef LBANN_HAS_GPU
+  if (!entries.empty()) {
+    tensor_check_gpu(m_kind, entries, m_workspace, m_flags_gpu);
+    // Later writes to the buffers wait for the scan
+    for (const auto& sync : entry_syncs) {
+      El::AddSynchronizationPoint(flags_sync, sync);
+    }
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void tensor_check_flags::end_step()
+{
+  m_ended_labels = std::move(m_labels);
+  m_ended_host_flags = std::move(m_host_flags);
+  m_labels.clear();
+  m_host_flags.clear();
+#ifdef LBANN_HAS_GPU
+  const El::Int num_slots = m_ended_labels.size();
+  if (num_slots == 0) {
+    return;
+  }
+  m_flags_event.synchronize();
+  if (m_flags_host.Height() < num_slots) {
+    m_flags_host.SetMemoryMode(1); // Pinned memory
+    m_flags_host.Resize(num_slots, 1);
+  }
+  auto sync_info = El::SyncInfoFromMatrix(m_flags_gpu);
+  hydrogen::gpu::Copy1DToHost(m_flags_gpu.LockedBuffer(),
+                              m_flags_host.Buffer(),
+                              num_slots,
+                              sync_info);
+  m_flags_event.record(sync_info.Stream());
+  // Clear the flags for the next step once they are copied
+  El::Zero(m_flags_gpu);
+#endif // LBANN_HAS_GPU
+}
+
+std::vector<std::string> tensor_check_flags::tripped()
+{
+  std::vector<std::string> labels;
+#ifdef LBANN_HAS_GPU
+  if (!m_ended_labels.empty()) {
+    m_flags_event.synchronize();
+  }
+#endif // LBANN_HAS_GPU
+  for (size_t i = 0; i < m_ended_labels.size(); ++i) {
+    bool raised = m_ended_host_flags[i];
+#ifdef LBANN_HAS_GPU
+    raised = raised || m_flags_host(i, 0) != 0.f;
+#endif // LBANN_HAS_GPU
+    if (raised) {
+      labels.push_back(m_ended_labels[i]);
+    }
+  }
+  m_ended_labels.clear();
+  m_ended_host_flags.clear();
+  return labels;
+}
+
+} // namespace callback
+} // namespace lbann
@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/tensor_check_flags.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+#include "../optimizers/multi_tensor.cuh"
+
+#include <limits>
+
+namespace lbann {
+namespace callback {
+
+namespace {
+
+template <tensor_check_kind Kind>
+__device__ __forceinline__ bool trips(DataType x, DataType threshold)
+{
+  if constexpr (Kind == tensor_check_kind::nonfinite) {
+    return !gpu_lib::isfinite(x);
+  }
+  else {
+    const DataType abs_x = gpu_lib::abs(x);
+    return abs_x > DataType(0) && abs_x <= threshold;
+  }
+}
+
+template <tensor_check_kind Kind>
+__global__ void check_kernel(size_t height,
+                             size_t width,
+                             const DataType* __restrict__ buffer,
+                             size_t ldim,
+                             DataType threshold,
+                             float* __restrict__ flag)
+{
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = blockDim.x * gridDim.x;
+  const size_t nthreadsy = blockDim.y * gridDim.y;
+  bool found = false;
+  for (size_t col = gidy; col < width; col += nthreadsy) {
+    for (size_t row = gidx; row < height; row += nthreadsx) {
+      found |= trips<Kind>(buffer[row + col * ldim], threshold);
+    }
+  }
+  if (found) {
+    *flag = 1.f;
+  }
+}
+
+template <tensor_check_kind Kind>
+__global__ void
+fused_check_kernel(const tensor_check_entry* __restrict__ entries,
+                   const size_t* __restrict__ chunk_offsets,
+                   size_t num_tensors,
+                   size_t num_chunks,
+                   DataType threshold,
+                   float* __restrict__ flags)
+{
+  using multi_tensor::chunk_size;
+  for (size_t chunk = blockIdx.x; chunk < num_chunks; chunk += gridDim.x) {
+    const size_t t =
+      multi_tensor::find_tensor(chunk_offsets, num_tensors, chunk);
+    const auto& entry = entries[t];
+    const size_t begin = (chunk - chunk_offsets[t]) * chunk_size;
+    const size_t end =
+      (begin + chunk_size < entry.size) ? begin + chunk_size : entry.size;
+    bool found = false;
+    for (size_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+      found |= trips<Kind>(entry.buffer[i], threshold);
+    }
+    if (found) {
+      flags[entry.slot] = 1.f;
+    }
+  }
+}
+
+DataType small_threshold()
+{
+  return El::Sqrt(std::numeric_limits<DataType>::min());
+}
+
+} // namespace
+
+void tensor_check_gpu(tensor_check_kind kind,
+                      const El::Matrix<DataType, El::Device::GPU>& mat,
+                      size_t slot,
+                      El::Matrix<float, El::Device::GPU>& flags)
+{
+  const size_t height = mat.Height();
+  const size_t width = mat.Width();
+  if (height == 0 || width == 0) {
+    return;
+  }
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (height + block_size - 1) / block_size;
+  grid_dims.y = width;
+  gpu_lib::clip_grid_dims(grid_dims);
+  // Runs on the matrix's stream once the flags are cleared, and the
+  // flags' stream waits for it
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(mat), gpu::get_sync_info(flags));
+  switch (kind) {
+  case tensor_check_kind::nonfinite:
+    hydrogen::gpu::LaunchKernel(check_kernel<tensor_check_kind::nonfinite>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                multisync,
+                                height,
+                                width,
+                                mat.LockedBuffer(),
+                                static_cast<size_t>(mat.LDim()),
+                                DataType(0),
+                                flags.Buffer() + slot);
+    break;
+  case tensor_check_kind::small:
+    hydrogen::gpu::LaunchKernel(check_kernel<tensor_check_kind::small>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                multisync,
+                                height,
+                                width,
+                                mat.LockedBuffer(),
+                                static_cast<size_t>(mat.LDim()),
+                                small_threshold(),
+                                flags.Buffer() + slot);
+    break;
+  }
+}
+
+void tensor_check_gpu(tensor_check_kind kind,
+                      std::vector<tensor_check_entry>& entries,
+                      multi_tensor_workspace& workspace,
+                      El::Matrix<float, El::Device::GPU>& flags)
+{
+  auto sync_info = gpu::get_sync_info(flags);
+  auto table = multi_tensor::make_device_table(entries, workspace, sync_info);
+  entries.clear();
+  if (table.num_chunks == 0) {
+    return;
+  }
+  const auto grid_dims = multi_tensor::get_grid_dims(table.num_chunks);
+  const dim3 block_dims(multi_tensor::block_size);
+  switch (kind) {
+  case tensor_check_kind::nonfinite:
+    hydrogen::gpu::LaunchKernel(
+      fused_check_kernel<tensor_check_kind::nonfinite>,
+      grid_dims,
+      block_dims,
+      0,
+      sync_info,
+      table.entries,
+      table.chunk_offsets,
+      table.num_tensors,
+      table.num_chunks,
+      DataType(0),
+      flags.Buffer());
+    break;
+  case tensor_check_kind::small:
+    hydrogen::gpu::LaunchKernel(fused_check_kernel<tensor_check_kind::small>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                table.entries,
+                                table.chunk_offsets,
+                                table.num_tensors,
+                                table.num_chunks,
+                                small_threshold(),
+                                flags.Buffer());
+    break;
+  }
+}
+
+} // namespace callback
+} // namespace lbann
@@ -28,7 +28,10 @@
 
 #include "lbann/callbacks/timeline.hpp"
 
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_ingestion/coordinator/fetch_tracing.hpp"
 #include "lbann/models/model.hpp"
+#include "lbann/optimizers/gradient_fusion.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/timer.hpp"
@@ -37,12 +40,42 @@
 #include "lbann/proto/callbacks.pb.h"
 
 #include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace lbann {
 namespace callback {
+namespace {
+
+std::string json_escape(std::string const& s)
+{
+  std::ostringstream oss;
+  for (char const c : s) {
+    switch (c) {
+    case '"':
+      oss << "\\\"";
+      break;
+    case '\\':
+      oss << "\\\\";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+            << int(c) << std::dec;
+      }
+      else {
+        oss << c;
+      }
+    }
+  }
+  return oss.str();
+}
+
+} // namespace
 
 timeline::timeline() : timeline("") {}
 
@@ -52,6 +85,8 @@ void timeline::serialize(Archive& ar)
   ar(::cereal::make_nvp("BaseCallback",
                         ::cereal::base_class<callback_base>(this)),
      CEREAL_NVP(m_outdir),
+     CEREAL_NVP(m_sync_collectives),
+     CEREAL_NVP(m_format),
      CEREAL_NVP(m_start_time),
      CEREAL_NVP(m_fp_start_time),
      CEREAL_NVP(m_bp_start_time),
@@ -65,6 +100,8 @@ void timeline::write_specific_proto(lbann_data::Callback& proto) const
 {
   auto* msg = proto.mutable_timeline();
   msg->set_directory(m_outdir);
+  msg->set_sync_collectives(m_sync_collectives);
+  msg->set_format(m_format);
 }
 
 void timeline::on_train_begin(model* m)
@@ -83,33 +120,195 @@ void timeline::on_train_begin(model* m)
   // Ensure the model is synchronized at the start.
   m->get_comm()->trainer_barrier();
   m_start_time = get_time();
+  take_gradient_sync_records();
+  set_gradient_sync_tracing(true);
+  auto& kfac_timer = m->get_kfac_phase_timer();
+  kfac_timer.take_records();
+  kfac_timer.set_tracing(true);
+  auto& comm = *m->get_comm();
+  comm.take_collective_records();
+  comm.reset_collective_summary();
+  comm.set_collective_tracing(true, m_sync_collectives);
+  take_fetch_records();
+  set_fetch_tracing(true);
 }
 
 void timeline::on_train_end(model* m)
 {
-  const std::string path =
-    m_outdir + "/timeline.m" +
-    std::to_string(m->get_comm()->get_trainer_rank()) + "." +
-    std::to_string(m->get_comm()->get_rank_in_trainer()) + ".txt";
-  std::ofstream f(path);
-  for (const auto& kv : m_fp_times) {
-    const std::string layer_name = "fp-" + kv.first;
-    for (const auto& time : kv.second) {
-      f << layer_name << ":" << time.first << ":" << time.second << '\n';
+  std::vector<trace_event> events;
+  auto const add_times = [&events](std::string const& prefix,
+                                   auto const& times) {
+    for (const auto& kv : times) {
+      for (const auto& time : kv.second) {
+        events.push_back({prefix + kv.first,
+                          -1,
+                          trace_track::compute,
+                          time.first,
+                          time.second});
+      }
+    }
+  };
+  add_times("fp-", m_fp_times);
+  add_times("bp-", m_bp_times);
+  add_times("opt-", m_opt_times);
+  set_gradient_sync_tracing(false);
+  const auto syncs = take_gradient_sync_records();
+  for (size_t i = 0; i < syncs.size(); ++i) {
+    const auto& sync = syncs[i];
+    events.push_back({"sync",
+                      El::Int(i),
+                      trace_track::gradient_sync,
+                      sync.launch_time - m_start_time,
+                      sync.finish_time - m_start_time});
+    events.push_back({"syncwait",
+                      El::Int(i),
+                      trace_track::compute,
+                      sync.wait_time - m_start_time,
+                      sync.finish_time - m_start_time});
+  }
+  auto& kfac_timer = m->get_kfac_phase_timer();
+  kfac_timer.set_tracing(false);
+  const auto phases = kfac_timer.take_records();
+  for (size_t i = 0; i < phases.size(); ++i) {
+    const auto& phase = phases[i];
+    events.push_back({"kfac-" + phase.name,
+                      El::Int(i),
+                      trace_track::compute,
+                      phase.start_time - m_start_time,
+                      phase.end_time - m_start_time});
+  }
+  auto& comm = *m->get_comm();
+  comm.set_collective_tracing(false);
+  const auto collectives = comm.take_collective_records();
+  for (size_t i = 0; i < collectives.size(); ++i) {
+    const auto& coll = collectives[i];
+    events.push_back({"coll-" + coll.op + "-" + coll.tag,
+                      El::Int(i),
+                      trace_track::collective,
+                      coll.start_time - m_start_time,
+                      coll.end_time - m_start_time});
+  }
+  set_fetch_tracing(false);
+  const auto fetches = take_fetch_records();
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    const auto& fetch = fetches[i];
+    events.push_back({"fetch-" + std::to_string(fetch.buffer),
+                      El::Int(i),
+                      trace_track::io_thread + fetch.thread,
+                      fetch.start_time - m_start_time,
+                      fetch.end_time - m_start_time});
+  }
+
+  const std::string suffix = std::to_string(comm.get_trainer_rank()) + "." +
+                             std::to_string(comm.get_rank_in_trainer());
+  if (m_format == "chrome") {
+    write_chrome_trace(comm, events);
+  }
+  else {
+    std::ofstream f(m_outdir + "/timeline.m" + suffix + ".txt");
+    for (const auto& e : events) {
+      f << e.name;
+      if (e.index >= 0) {
+        f << "-" << e.index;
+      }
+      f << ":" << e.start << ":" << e.end << '\n';
+    }
+  }
+  std::ofstream summary(m_outdir + "/collectives.m" + suffix + ".txt");
+  comm.print_collective_summary(summary);
+}
+
+void timeline::write_chrome_trace(lbann_comm& comm,
+                                  std::vector<trace_event> const& events) const
+{
+  // Trace events of this rank: one process per rank, one thread per
+  // track. Times are in microseconds.
+  int const pid = comm.get_rank_in_world();
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(3);
+  oss << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+      << ",\"args\":{\"name\":\"rank " << pid << " (trainer "
+      << comm.get_trainer_rank() << ", rank " << comm.get_rank_in_trainer()
+      << ")\"}},\n{\"name\":\"process_sort_index\",\"ph\":\"M\","
+      << "\"pid\":" << pid << ",\"args\":{\"sort_index\":" << pid << "}}";
+  std::set<int> tracks;
+  for (const auto& e : events) {
+    tracks.insert(e.track);
+  }
+  for (int const track : tracks) {
+    std::string name;
+    switch (track) {
+    case trace_track::compute:
+      name = "compute";
+      break;
+    case trace_track::gradient_sync:
+      name = "gradient sync";
+      break;
+    case trace_track::collective:
+      name = "collectives";
+      break;
+    default:
+      name = "io thread " + std::to_string(track - trace_track::io_thread);
     }
+    oss << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+        << ",\"tid\":" << track << ",\"args\":{\"name\":\"" << name
+        << "\"}}";
   }
-  for (const auto& kv : m_bp_times) {
-    const std::string layer_name = "bp-" + kv.first;
-    for (const auto& time : kv.second) {
-      f << layer_name << ":" << time.first << ":" << time.second << '\n';
+  for (const auto& e : events) {
+    auto const head = [&](char const* ph) -> std::ostream& {
+      return oss << ",\n{\"name\":\"" << json_escape(e.name)
+                 << "\",\"ph\":\"" << ph << "\",\"pid\":" << pid
+                 << ",\"tid\":" << e.track;
+    };
+    if (e.track == trace_track::compute || e.track >= trace_track::io_thread) {
+      head("X") << ",\"ts\":" << 1e6 * e.start
+                << ",\"dur\":" << 1e6 * (e.end - e.start);
+      if (e.index >= 0) {
+        oss << ",\"args\":{\"n\":" << e.index << "}";
+      }
+      oss << "}";
+    }
+    else {
+      // Communication may overlap, so it is traced as async events
+      head("b") << ",\"cat\":\"comm\",\"id\":\"" << e.track << "-"
+                << e.index << "\",\"ts\":" << 1e6 * e.start << "}";
+      head("e") << ",\"cat\":\"comm\",\"id\":\"" << e.track << "-"
+                << e.index << "\",\"ts\":" << 1e6 * e.end << "}";
     }
   }
-  for (const auto& kv : m_opt_times) {
-    const std::string weights_name = "opt-" + kv.first;
-    for (const auto& time : kv.second) {
-      f << weights_name << ":" << time.first << ":" << time.second << '\n';
+  std::string const local = oss.str();
+  auto const* local_bytes = reinterpret_cast<El::byte const*>(local.data());
+
+  // The trainer master writes the events of every rank in the
+  // trainer into one file
+  int const root = 0;
+  if (comm.get_rank_in_trainer() != root) {
+    comm.trainer_gather(int(local.size()), root);
+    comm.trainer_gatherv(local_bytes, local.size(), root);
+    return;
+  }
+  int const procs = comm.get_procs_per_trainer();
+  std::vector<int> sizes(procs), offsets(procs, 0);
+  comm.trainer_gather(int(local.size()), sizes.data());
+  for (int i = 1; i < procs; ++i) {
+    offsets[i] = offsets[i - 1] + sizes[i - 1];
+  }
+  std::string all(offsets.back() + sizes.back(), '\0');
+  comm.trainer_gatherv(local_bytes,
+                       local.size(),
+                       reinterpret_cast<El::byte*>(all.data()),
+                       sizes.data(),
+                       offsets.data());
+  std::ofstream f(m_outdir + "/timeline.m" +
+                  std::to_string(comm.get_trainer_rank()) + ".json");
+  f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  for (int i = 0; i < procs; ++i) {
+    if (i > 0) {
+      f << ",\n";
     }
+    f.write(all.data() + offsets[i], sizes[i]);
   }
+  f << "\n]}\n";
 }
 
 void timeline::on_forward_prop_begin(model* m, Layer* l)
@@ -151,7 +350,13 @@ build_timeline_callback_from_pbuf(const google::protobuf::Message& proto_msg,
 {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackTimeline&>(proto_msg);
-  return std::make_unique<timeline>(params.directory());
+  std::string const& format = params.format();
+  if (!format.empty() && format != "text" && format != "chrome") {
+    LBANN_ERROR("unknown timeline format \"", format, "\"");
+  }
+  return std::make_unique<timeline>(params.directory(),
+                                    params.sync_collectives(),
+                                    format.empty() ? "text" : format);
 }
 
 } // namespace callback
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include "lbann/callbacks/checkpoint.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/io/checkpoint_writer.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+/** Files of a size that depends on the rank that holds them */
+lbann::checkpoint_writer::file_list make_files(int rank)
+{
+  const auto fill = static_cast<char>('a' + rank % 26);
+  return {{"model/weights", std::string(5 * (rank + 1), fill)},
+          {"rng_state/rng", std::to_string(rank)}};
+}
+
+} // namespace
+
+TEST_CASE("Exchanging checkpoint files", "[mpi][checkpoint]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  const int rank = comm.get_rank_in_trainer();
+  const int n = comm.get_procs_per_trainer();
+  const int next = (rank + 1) % n;
+  const int prev = (rank + n - 1) % n;
+
+  // Tiny chunks make ranks holding different sizes need different
+  // numbers of rounds of their own
+  auto const received =
+    lbann::callback::exchange_checkpoint_files(comm,
+                                               make_files(rank),
+                                               next,
+                                               prev,
+                                               3);
+  CHECK(received == make_files(prev));
+
+  // A rank without files still takes part
+  auto const none = lbann::callback::exchange_checkpoint_files(
+    comm,
+    rank == 0 ? lbann::checkpoint_writer::file_list{} : make_files(rank),
+    next,
+    prev,
+    3);
+  if (prev == 0) {
+    CHECK(none.empty());
+  }
+  else {
+    CHECK(none == make_files(prev));
+  }
+}
+
+TEST_CASE("Checkpoint completion marker", "[mpi][checkpoint]")
+{
+  char tmpl[] = "/tmp/lbann_checkpoint_marker_test_XXXXXX";
+  REQUIRE(mkdtemp(tmpl) != nullptr);
+  const std::string dir(tmpl);
+
+  // A directory holding files is not complete until it is marked
+  lbann::checkpoint_writer::write_files({{dir + "/weights", "data"}});
+  CHECK_FALSE(lbann::callback::is_checkpoint_complete(dir));
+  lbann::checkpoint_writer::write_files(
+    {lbann::callback::get_checkpoint_complete_marker(dir)});
+  CHECK(lbann::callback::is_checkpoint_complete(dir));
+
+  unlink(lbann::callback::get_checkpoint_complete_marker(dir).first.c_str());
+  unlink((dir + "/weights").c_str());
+  rmdir(dir.c_str());
+}
+
+TEST_CASE("Last checkpoint marker records the rank count", "[mpi][checkpoint]")
+{
+  char tmpl[] = "/tmp/lbann_checkpoint_latest_test_XXXXXX";
+  REQUIRE(mkdtemp(tmpl) != nullptr);
+  const std::string latest = std::string(tmpl) + "/last.shared.checkpoint";
+
+  lbann::visitor_hook hook;
+  lbann::execution_mode mode;
+  size_t epoch, step;
+  int ranks = -1;
+
+  SECTION("With the rank count")
+  {
+    REQUIRE(lbann::callback::write_latest(latest,
+                                          lbann::visitor_hook::epoch_end,
+                                          lbann::execution_mode::training,
+                                          3,
+                                          120,
+                                          8));
+    REQUIRE(lbann::callback::read_latest(latest,
+                                         &hook,
+                                         &mode,
+                                         &epoch,
+                                         &step,
+                                         &ranks));
+    CHECK(hook == lbann::visitor_hook::epoch_end);
+    CHECK(epoch == 3);
+    CHECK(step == 120);
+    CHECK(ranks == 8);
+  }
+  SECTION("Markers without the rank count still parse")
+  {
+    REQUIRE(lbann::callback::write_latest(latest,
+                                          lbann::visitor_hook::epoch_end,
+                                          lbann::execution_mode::training,
+                                          3,
+                                          120));
+    REQUIRE(lbann::callback::read_latest(latest,
+                                         &hook,
+                                         &mode,
+                                         &epoch,
+                                         &step,
+                                         &ranks));
+    CHECK(hook == lbann::visitor_hook::epoch_end);
+    CHECK(epoch == 3);
+    CHECK(step == 120);
+    CHECK(ranks == 0);
+  }
+
+  unlink(latest.c_str());
+  rmdir(tmpl);
+}
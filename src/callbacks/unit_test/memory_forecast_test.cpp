@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/callbacks/memory_profiler.hpp"
+
+#include <limits>
+#include <vector>
+
+TEST_CASE("Peak memory forecast", "[callback][memory]")
+{
+  using lbann::callback::tensor_allocation;
+  using lbann::callback::tensor_role;
+  using lbann::callback::forecast_peak_memory;
+  using lbann::callback::largest_fitting_mini_batch_size;
+
+  // Census taken at a mini-batch size of 4
+  const std::vector<tensor_allocation> census = {
+    {"fc", tensor_role::activations, 400, true},
+    {"fc", tensor_role::error_signals, 200, true},
+    {"fc_weights", tensor_role::weights, 1000, false},
+    {"fc_weights", tensor_role::gradients, 1000, false},
+    {"fc_weights", tensor_role::optimizer_state, 2000, false},
+    {"", tensor_role::unattributed, 100, false}};
+
+  SECTION("Per-sample tensors scale with the mini-batch size")
+  {
+    CHECK(forecast_peak_memory(census, 4, 4) == 4700);
+    CHECK(forecast_peak_memory(census, 4, 8) == 5300);
+    CHECK(forecast_peak_memory(census, 4, 0) == 4100);
+  }
+
+  SECTION("Largest mini-batch that fits a budget")
+  {
+    CHECK(largest_fitting_mini_batch_size(census, 4, 4700) == 4);
+    CHECK(largest_fitting_mini_batch_size(census, 4, 4849) == 4);
+    CHECK(largest_fitting_mini_batch_size(census, 4, 4850) == 5);
+    CHECK(largest_fitting_mini_batch_size(census, 4, 4000) == 0);
+  }
+
+  SECTION("Batch-independent models always fit")
+  {
+    const std::vector<tensor_allocation> fixed = {
+      {"w", tensor_role::weights, 10, false}};
+    CHECK(largest_fitting_mini_batch_size(fixed, 1, 10) ==
+          std::numeric_limits<size_t>::max());
+    CHECK(largest_fitting_mini_batch_size(fixed, 1, 9) == 0);
+  }
+
+  SECTION("A census needs a mini-batch size")
+  {
+    CHECK_THROWS(forecast_peak_memory(census, 0, 4));
+  }
+}
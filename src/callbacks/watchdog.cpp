@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/watchdog.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_ingestion/data_coordinator.hpp"
+#include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/serialize.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <execinfo.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace lbann {
+namespace callback {
+
+namespace {
+
+constexpr int dump_signal = SIGUSR2;
+
+/** Watchdog of the training run in progress, if any. */
+std::atomic<watchdog const*> active_watchdog{nullptr};
+/** Training thread of the active watchdog. */
+pthread_t active_train_thread;
+/** Handler of the dump signal before training began. */
+struct sigaction previous_action;
+/** Pipe the training thread writes its stack trace to. */
+std::array<int, 2> stack_pipe{-1, -1};
+/** Set once a stack trace has been written to the pipe. */
+volatile sig_atomic_t stack_written = 0;
+
+/** Only calls async-signal-safe functions. The watchdog thread
+ *  writes the rest of the dump once stack_written is set.
+ */
+void handle_dump_signal(int)
+{
+  if (active_watchdog.load() == nullptr) {
+    return;
+  }
+  if (!pthread_equal(pthread_self(), active_train_thread)) {
+    // Signals sent to the process can land on any thread, but only
+    // the training thread can walk its own stack
+    pthread_kill(active_train_thread, dump_signal);
+    return;
+  }
+  std::array<void*, 128> frames;
+  const int num_frames = backtrace(frames.data(), frames.size());
+  backtrace_symbols_fd(frames.data(), num_frames, stack_pipe[1]);
+  stack_written = 1;
+}
+
+/** Read what is in the stack trace pipe without blocking. */
+std::string read_stack_pipe()
+{
+  std::string text;
+  std::array<char, 4096> buf;
+  ssize_t n;
+  while ((n = read(stack_pipe[0], buf.data(), buf.size())) > 0) {
+    text.append(buf.data(), n);
+  }
+  return text;
+}
+
+} // namespace
+
+watchdog::watchdog(double slowdown,
+                   int window,
+                   double min_timeout,
+                   std::string prefix)
+  : callback_base(1),
+    m_slowdown(std::max(slowdown, 1.)),
+    m_window(std::max(window, 1)),
+    m_min_timeout(std::max(min_timeout, 0.)),
+    m_prefix(std::move(prefix)),
+    m_timeout(m_min_timeout)
+{}
+
+watchdog::watchdog(const watchdog& other)
+  : watchdog(other.m_slowdown,
+             other.m_window,
+             other.m_min_timeout,
+             other.m_prefix)
+{}
+
+watchdog& watchdog::operator=(const watchdog& other)
+{
+  if (this != &other) {
+    stop();
+    callback_base::operator=(other);
+    m_slowdown = other.m_slowdown;
+    m_window = other.m_window;
+    m_min_timeout = other.m_min_timeout;
+    m_prefix = other.m_prefix;
+    m_step_times.clear();
+    m_next_step_time = 0;
+    m_timeout = m_min_timeout;
+  }
+  return *this;
+}
+
+watchdog::~watchdog() { stop(); }
+
+template <class Archive>
+void watchdog::serialize(Archive& ar)
+{
+  ar(::cereal::make_nvp("BaseCallback",
+                        ::cereal::base_class<callback_base>(this)),
+     CEREAL_NVP(m_slowdown),
+     CEREAL_NVP(m_window),
+     CEREAL_NVP(m_min_timeout),
+     CEREAL_NVP(m_prefix));
+}
+
+void watchdog::write_specific_proto(lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_watchdog();
+  msg->set_slowdown(m_slowdown);
+  msg->set_window(m_window);
+  msg->set_min_timeout(m_min_timeout);
+  msg->set_prefix(m_prefix);
+}
+
+void watchdog::on_train_begin(model* m)
+{
+  stop();
+  m_comm = m->get_comm();
+  m_data_coordinator = &get_trainer().get_data_coordinator();
+  m_train_thread = pthread_self();
+  m_comm->set_pending_collective_tracking(true);
+
+  // Install the dump handler before the watchdog can raise the signal.
+  // The write end of the pipe does not block, so the handler drops
+  // what does not fit instead of hanging. The first call to backtrace
+  // loads its library, which must not happen inside the handler.
+  if (pipe(stack_pipe.data()) != 0) {
+    LBANN_ERROR("watchdog could not create a pipe");
+  }
+  for (int fd : stack_pipe) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+  std::array<void*, 1> frame;
+  backtrace(frame.data(), frame.size());
+  stack_written = 0;
+  active_train_thread = m_train_thread;
+  active_watchdog = this;
+  struct sigaction sa;
+  sa.sa_handler = &handle_dump_signal;
+  sa.sa_flags = SA_RESTART;
+  sigfillset(&sa.sa_mask);
+  sigaction(dump_signal, &sa, &previous_action);
+
+  m_stop = false;
+  m_thread = std::thread(&watchdog::watch, this);
+}
+
+void watchdog::on_train_end(model* m) { stop(); }
+
+void watchdog::stop()
+{
+  if (!m_thread.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_thread.join();
+  m_in_step = false;
+  if (m_comm != nullptr) {
+    m_comm->set_pending_collective_tracking(false);
+  }
+  watchdog const* self = this;
+  if (active_watchdog.compare_exchange_strong(self, nullptr)) {
+    sigaction(dump_signal, &previous_action, nullptr);
+    for (int& fd : stack_pipe) {
+      close(fd);
+      fd = -1;
+    }
+  }
+}
+
+void watchdog::begin_step(model* m)
+{
+  // The start time is published before the step, so the watchdog
+  // never pairs a new step with an old start time
+  m_step_start = get_time();
+  m_step = m->get_execution_context().get_step();
+  m_in_step = true;
+}
+
+void watchdog::on_batch_begin(model* m) { begin_step(m); }
+
+void watchdog::on_batch_end(model* m)
+{
+  m_in_step = false;
+  const double step_time = get_time() - m_step_start;
+  if (m_step_times.size() < static_cast<size_t>(m_window)) {
+    m_step_times.push_back(step_time);
+  }
+  else {
+    m_step_times[m_next_step_time] = step_time;
+  }
+  m_next_step_time = (m_next_step_time + 1) % m_window;
+
+  auto sorted = m_step_times;
+  auto median = sorted.begin() + sorted.size() / 2;
+  std::nth_element(sorted.begin(), median, sorted.end());
+  m_timeout = std::max(m_min_timeout, m_slowdown * *median);
+}
+
+void watchdog::on_batch_evaluate_begin(model* m) { begin_step(m); }
+
+void watchdog::on_batch_evaluate_end(model* m) { m_in_step = false; }
+
+void watchdog::watch()
+{
+  auto dumped_step = std::numeric_limits<uint64_t>::max();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stop) {
+    m_cv.wait_for(lock, std::chrono::seconds(1));
+    if (m_stop) {
+      continue;
+    }
+    if (stack_written) {
+      stack_written = 0;
+      dump(read_stack_pipe());
+    }
+    if (!m_in_step) {
+      continue;
+    }
+    const auto step = m_step.load();
+    if (step != dumped_step &&
+        get_time() - m_step_start.load() > m_timeout.load()) {
+      // Dump once per stalled step
+      dumped_step = step;
+      pthread_kill(m_train_thread, dump_signal);
+    }
+  }
+}
+
+void watchdog::dump(std::string const& stack) const
+{
+  const double now = get_time();
+  const int rank = m_comm->get_rank_in_world();
+  std::array<char, 64> host{};
+  gethostname(host.data(), host.size() - 1);
+
+  std::ostringstream oss;
+  oss << "Watchdog dump of world rank " << rank << " on " << host.data()
+      << "\n";
+  if (m_in_step) {
+    oss << "Step " << m_step << " has run for " << now - m_step_start
+        << " s (timeout " << m_timeout << " s)\n";
+  }
+  else {
+    oss << "Between steps (timeout " << m_timeout << " s)\n";
+  }
+  oss << "\nStack trace of the training thread:\n" << stack;
+  oss << "\nCollectives in flight:\n";
+  const auto pending = m_comm->get_pending_collectives();
+  for (const auto& c : pending) {
+    oss << "  " << c.tag << " " << c.op << " (" << c.algorithm
+        << "): " << c.bytes << " bytes, issued " << now - c.start_time
+        << " s ago\n";
+  }
+  if (pending.empty()) {
+    oss << "  none\n";
+  }
+  oss << "\nData coordinator:\n";
+  m_data_coordinator->print_state(oss);
+
+  const auto file = build_string(m_prefix, "_rank", rank, ".txt");
+  std::ofstream fs(file);
+  fs << oss.str();
+  std::cerr << "watchdog: rank " << rank << " wrote " << file << std::endl;
+}
+
+std::unique_ptr<callback_base>
+build_watchdog_callback_from_pbuf(const google::protobuf::Message& proto_msg,
+                                  std::shared_ptr<lbann_summary> const&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackWatchdog&>(proto_msg);
+  return std::make_unique<watchdog>(
+    params.slowdown() > 0. ? params.slowdown() : 10.,
+    params.window() > 0 ? params.window() : 100,
+    params.min_timeout() > 0. ? params.min_timeout() : 300.,
+    params.prefix().empty() ? "watchdog" : params.prefix());
+}
+
+} // namespace callback
+} // namespace lbann
+
+#define LBANN_CLASS_NAME callback::watchdog
+#define LBANN_CLASS_LIBNAME callback_watchdog
+#include <lbann/macros/register_class_with_cereal.hpp>
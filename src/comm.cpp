@@ -31,11 +31,21 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 #include "lbann/utils/memory.hpp"
+#include "lbann/utils/profiling.hpp"
 #include "lbann/utils/timer.hpp"
 #include "mpi.h"
 #include "omp.h"
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <numeric>
+#include <ostream>
 #include <sstream>
 #include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace lbann {
 
@@ -91,12 +101,100 @@ lbann_comm::~lbann_comm()
   El::mpi::Free(m_trainer_comm);
   El::mpi::Free(m_intertrainer_comm);
   El::mpi::Free(m_node_comm);
+  m_hierarchical_comms.clear();
 #ifdef LBANN_HAS_ALUMINUM
   ::Al::Finalize();
 #endif
 }
 
-void lbann_comm::split_trainers(int procs_per_trainer, int trainer_grid_height)
+namespace {
+
+constexpr int max_topology_address = 256;
+
+/** This process's network location, coarsest level first. */
+std::string get_topology_address()
+{
+  // Launchers that know the network tree export it, e.g. Slurm's
+  // topology/tree plugin sets SLURM_TOPOLOGY_ADDR to switch.switch.node
+  for (char const* var : {"LBANN_TOPOLOGY_ADDR", "SLURM_TOPOLOGY_ADDR"}) {
+    char const* addr = std::getenv(var);
+    if (addr != nullptr && addr[0] != '\0') {
+      return addr;
+    }
+  }
+  // Without a hint only the node is known
+  char host[max_topology_address] = {};
+  gethostname(host, sizeof(host) - 1);
+  return host;
+}
+
+/** Compare with digit runs as numbers, so node9 comes before node10
+ *  and numbered switches and nodes sort in their physical order. */
+bool natural_less(std::string const& a, std::string const& b)
+{
+  size_t i = 0, j = 0;
+  while (i < a.size() && j < b.size()) {
+    if (std::isdigit(a[i]) && std::isdigit(b[j])) {
+      size_t ie = i, je = j;
+      while (ie < a.size() && std::isdigit(a[ie])) {
+        ++ie;
+      }
+      while (je < b.size() && std::isdigit(b[je])) {
+        ++je;
+      }
+      const auto na = std::stoull(a.substr(i, ie - i));
+      const auto nb = std::stoull(b.substr(j, je - j));
+      if (na != nb) {
+        return na < nb;
+      }
+      i = ie;
+      j = je;
+    }
+    else {
+      if (a[i] != b[j]) {
+        return a[i] < b[j];
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return (a.size() - i) < (b.size() - j);
+}
+
+} // namespace
+
+std::vector<int> lbann_comm::get_topology_order() const
+{
+  const int world_size = El::mpi::Size(get_world_comm());
+  std::vector<El::byte> mine(max_topology_address, 0);
+  const auto addr = get_topology_address();
+  std::copy_n(addr.begin(),
+              std::min<size_t>(addr.size(), max_topology_address - 1),
+              mine.begin());
+  std::vector<El::byte> all(world_size * max_topology_address);
+  El::mpi::AllGather(mine.data(),
+                     max_topology_address,
+                     all.data(),
+                     max_topology_address,
+                     get_world_comm(),
+                     El::SyncInfo<El::Device::CPU>{});
+
+  std::vector<std::string> addrs(world_size);
+  for (int r = 0; r < world_size; ++r) {
+    addrs[r] =
+      reinterpret_cast<char const*>(all.data() + r * max_topology_address);
+  }
+  std::vector<int> order(world_size);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&addrs](int a, int b) {
+    return natural_less(addrs[a], addrs[b]);
+  });
+  return order;
+}
+
+void lbann_comm::split_trainers(int procs_per_trainer,
+                                int trainer_grid_height,
+                                bool topology_aware)
 {
   const int world_size = El::mpi::Size(get_world_comm());
   m_procs_per_trainer = procs_per_trainer;
@@ -119,9 +217,28 @@ void lbann_comm::split_trainers(int procs_per_trainer, int trainer_grid_height)
                 world_size);
   }
 
+  m_world_rank_of_position.clear();
+  m_position_of_world_rank.clear();
+  if (topology_aware) {
+    auto order = get_topology_order();
+    std::vector<int> identity(world_size);
+    std::iota(identity.begin(), identity.end(), 0);
+    if (order != identity) {
+      m_position_of_world_rank.resize(world_size);
+      for (int p = 0; p < world_size; ++p) {
+        m_position_of_world_rank[order[p]] = p;
+      }
+      m_world_rank_of_position = std::move(order);
+    }
+  }
+
+  const int position = get_placement_position(El::mpi::Rank(get_world_comm()));
   m_num_trainers = world_size / m_procs_per_trainer;
-  m_trainer_rank = El::mpi::Rank(get_world_comm()) / m_procs_per_trainer;
-  m_rank_in_trainer = El::mpi::Rank(get_world_comm()) % m_procs_per_trainer;
+  m_trainer_rank = position / m_procs_per_trainer;
+  m_rank_in_trainer = position % m_procs_per_trainer;
+
+  // Freed communicator handles may be reused by the new ones
+  m_hierarchical_comms.clear();
 
   // Initialize trainer and intertrainer communicators
   El::mpi::Split(get_world_comm(),
@@ -144,6 +261,10 @@ void lbann_comm::split_trainer_grid(int num_process_primary_grid,
                                     bool enable_topo_aware)
 {
   const int trainer_size = El::mpi::Size(m_trainer_comm);
+  if (!m_world_rank_of_position.empty()) {
+    LBANN_ERROR("sub-grid parallelism requires trainers placed in world "
+                "rank order, not by topology");
+  }
   m_create_two_models = create_two_models;
   m_subgrid_async_progress = enable_async_comm;
   bool enable_topology_aware = enable_topo_aware;
@@ -257,6 +378,7 @@ void lbann_comm::split_trainer_grid(int num_process_primary_grid,
                 secondary_grid_group);
 
   // Create communicators (one each for primary and secondary grid)
+  m_hierarchical_comms.clear();
   El::mpi::Create(m_trainer_comm, primary_grid_group, m_primary_grid_comm);
   El::mpi::Create(m_trainer_comm, secondary_grid_group, m_secondary_grid_comm);
 
@@ -322,6 +444,11 @@ void lbann_comm::split_trainer_grid(int num_process_primary_grid,
 
 void lbann_comm::intertrainer_sum_matrix(AbsMat& mat) const
 {
+  traced_collective trace(*this,
+                          "allreduce",
+                          "flat",
+                          mat.GetDevice(),
+                          sizeof(DataType) * mat.Height() * mat.Width());
   m_bytes_sent += sizeof(DataType) * mat.Height() * mat.Width();
   El::AllReduce(mat, m_intertrainer_comm, El::mpi::SUM);
   m_bytes_received += sizeof(DataType) * mat.Height() * mat.Width();
@@ -407,6 +534,143 @@ void allreduce_impl(El::Matrix<T, D>& m,
   return El::AllReduce(m, c, op);
 }
 
+// Reduce-scatter the node's contribution into one contiguous shard
+// per local process, allreduce each shard with the processes holding
+// the same shard on the other nodes, then allgather the shards. Only
+// 1/procs_per_node of the data crosses the inter-node network, and
+// the node-local phases run over the fast on-node links.
+//
+// GPU matrices pick up the Aluminum overload below when it is
+// available; only that overload falls back to the parent communicator.
+template <typename T, El::Device D>
+void hierarchical_allreduce_impl(El::Matrix<T, D>& m,
+                                 const El::mpi::Comm& /*c*/,
+                                 const El::mpi::Comm& intra_node,
+                                 const El::mpi::Comm& inter_node,
+                                 El::mpi::Op const& op)
+{
+  const int count = m.Height() * m.Width();
+  const int node_size = El::mpi::Size(intra_node);
+  const int node_rank = El::mpi::Rank(intra_node);
+  std::vector<int> counts(node_size), displs(node_size, 0);
+  for (int i = 0; i < node_size; ++i) {
+    counts[i] = count / node_size + (i < count % node_size ? 1 : 0);
+    if (i > 0) {
+      displs[i] = displs[i - 1] + counts[i - 1];
+    }
+  }
+
+  El::SyncInfo<D> sync_info = El::SyncInfoFromMatrix(m);
+  El::Matrix<T, D> shard;
+  shard.SetSyncInfo(sync_info);
+  shard.Resize(counts[node_rank], 1);
+
+  El::mpi::ReduceScatter(m.LockedBuffer(),
+                         shard.Buffer(),
+                         counts.data(),
+                         op,
+                         intra_node,
+                         sync_info);
+  El::mpi::AllReduce(shard.Buffer(),
+                     counts[node_rank],
+                     op,
+                     inter_node,
+                     sync_info);
+  El::mpi::AllGather(shard.LockedBuffer(),
+                     counts[node_rank],
+                     m.Buffer(),
+                     counts.data(),
+                     displs.data(),
+                     intra_node,
+                     sync_info);
+}
+
+// With an element-wise [STAR,VC] distribution, the columns owned by a
+// process are every p-th column, so each process's columns are packed
+// with one strided copy.
+template <typename T, El::Device D>
+void reduce_scatter_columns_impl(const El::Matrix<T, D>& src,
+                                 El::AbstractDistMatrix<T>& dst)
+{
+  auto& dst_local = static_cast<El::Matrix<T, D>&>(dst.Matrix());
+  const El::mpi::Comm& comm = dst.DistComm();
+  const int comm_size = El::mpi::Size(comm);
+  const El::Int height = src.Height();
+  const El::Int width = src.Width();
+
+  std::vector<int> counts(comm_size, 0), displs(comm_size, 0);
+  std::vector<El::Int> first_col(comm_size, width);
+  for (El::Int j = 0; j < width; ++j) {
+    const int owner = dst.RowOwner(j);
+    counts[owner] += height;
+    first_col[owner] = std::min(first_col[owner], j);
+  }
+  for (int r = 1; r < comm_size; ++r) {
+    displs[r] = displs[r - 1] + counts[r - 1];
+  }
+
+  El::SyncInfo<D> sync_info = El::SyncInfoFromMatrix(dst_local);
+  El::SyncInfo<D> src_sync = El::SyncInfoFromMatrix(src);
+  auto multisync = El::MakeMultiSync(sync_info, src_sync);
+  El::Matrix<T, D> packed;
+  packed.SetSyncInfo(sync_info);
+  packed.Resize(height * width, 1);
+  for (int r = 0; r < comm_size; ++r) {
+    if (counts[r] == 0) {
+      continue;
+    }
+    El::copy::util::InterleaveMatrix(height,
+                                     counts[r] / height,
+                                     src.LockedBuffer(0, first_col[r]),
+                                     1,
+                                     src.LDim() * comm_size,
+                                     packed.Buffer() + displs[r],
+                                     1,
+                                     height,
+                                     multisync);
+  }
+
+  // Receive straight into the local shard when it is contiguous
+  const int my_count = counts[El::mpi::Rank(comm)];
+  if (dst_local.LDim() == height || dst_local.Width() <= 1) {
+    El::mpi::ReduceScatter(packed.LockedBuffer(),
+                           dst_local.Buffer(),
+                           counts.data(),
+                           comm,
+                           sync_info);
+  }
+  else {
+    El::Matrix<T, D> shard;
+    shard.SetSyncInfo(sync_info);
+    shard.Resize(my_count, 1);
+    El::mpi::ReduceScatter(packed.LockedBuffer(),
+                           shard.Buffer(),
+                           counts.data(),
+                           comm,
+                           sync_info);
+    El::copy::util::InterleaveMatrix(height,
+                                     dst_local.Width(),
+                                     shard.LockedBuffer(),
+                                     1,
+                                     height,
+                                     dst_local.Buffer(),
+                                     1,
+                                     dst_local.LDim(),
+                                     sync_info);
+  }
+}
+
+// As for allreduces, GPU matrices pick up the Aluminum overload below
+// when it is available.
+template <typename T, El::Device D>
+void sendrecv_impl(const El::Matrix<T, D>& snd,
+                   El::Matrix<T, D>& rcv,
+                   int partner,
+                   const El::mpi::Comm& c)
+{
+  El::SendRecv(snd, rcv, c, partner, partner);
+}
+
 template <typename T>
 void nb_allreduce_impl(El::Matrix<T, El::Device::CPU>& m,
                        const El::mpi::Comm& c,
@@ -525,6 +789,100 @@ void allreduce_impl(El::Matrix<T, El::Device::GPU>& m,
   return El::AllReduce(m, c, op);
 }
 
+template <typename T, typename BackendT>
+using AluminumSupportsHierarchicalAllreduce = std::conjunction<
+  El::AluminumSupportsBackendAndCollective<T,
+                                           El::Collective::REDUCESCATTER,
+                                           BackendT>,
+  El::AluminumSupportsBackendAndCollective<T,
+                                           El::Collective::ALLREDUCE,
+                                           BackendT>,
+  El::AluminumSupportsBackendAndCollective<T,
+                                           El::Collective::ALLGATHER,
+                                           BackendT>>;
+
+template <typename T,
+          typename BackendT,
+          El::EnableWhen<AluminumSupportsHierarchicalAllreduce<T, BackendT>,
+                         int> = 0>
+void hierarchical_allreduce_aluminum(El::Matrix<T, El::Device::GPU>& m,
+                                     const El::mpi::Comm& /*c*/,
+                                     const El::mpi::Comm& intra_node,
+                                     const El::mpi::Comm& inter_node,
+                                     El::mpi::Op const& op,
+                                     BackendTag<BackendT>)
+{
+  const size_t count = m.Height() * m.Width();
+  const size_t node_size = El::mpi::Size(intra_node);
+  const size_t node_rank = El::mpi::Rank(intra_node);
+  std::vector<size_t> counts(node_size), displs(node_size, 0);
+  for (size_t i = 0; i < node_size; ++i) {
+    counts[i] = count / node_size + (i < count % node_size ? 1 : 0);
+    if (i > 0) {
+      displs[i] = displs[i - 1] + counts[i - 1];
+    }
+  }
+
+  const auto& sync_info = El::SyncInfoFromMatrix(m);
+  El::Matrix<T, El::Device::GPU> shard;
+  shard.SetSyncInfo(sync_info);
+  shard.Resize(counts[node_rank], 1);
+
+  const auto al_op = mpi_op_to_al_op(op);
+  ::Al::Reduce_scatterv<BackendT>(
+    m.LockedBuffer(),
+    shard.Buffer(),
+    counts,
+    al_op,
+    intra_node.template GetComm<BackendT>(sync_info));
+  ::Al::Allreduce<BackendT>(shard.Buffer(),
+                            counts[node_rank],
+                            al_op,
+                            inter_node.template GetComm<BackendT>(sync_info));
+  ::Al::Allgatherv<BackendT>(shard.LockedBuffer(),
+                             m.Buffer(),
+                             counts,
+                             displs,
+                             intra_node.template GetComm<BackendT>(sync_info));
+}
+
+template <typename T,
+          typename BackendT,
+          El::EnableUnless<AluminumSupportsHierarchicalAllreduce<T, BackendT>,
+                           int> = 0>
+void hierarchical_allreduce_aluminum(El::Matrix<T, El::Device::GPU>& m,
+                                     const El::mpi::Comm& c,
+                                     const El::mpi::Comm& intra_node,
+                                     const El::mpi::Comm& inter_node,
+                                     El::mpi::Op const& op,
+                                     BackendTag<BackendT>)
+{
+  // Without device-aware collectives for this type, a single allreduce
+  // avoids staging every phase through the host
+  allreduce_impl(m, c, op);
+}
+
+// Device buffers must not be handed to plain MPI, which need not be
+// GPU-aware, so the phases go through the NCCL backend
+template <typename T>
+void hierarchical_allreduce_impl(El::Matrix<T, El::Device::GPU>& m,
+                                 const El::mpi::Comm& c,
+                                 const El::mpi::Comm& intra_node,
+                                 const El::mpi::Comm& inter_node,
+                                 El::mpi::Op const& op)
+{
+#if defined(AL_HAS_NCCL)
+  return hierarchical_allreduce_aluminum(m,
+                                         c,
+                                         intra_node,
+                                         inter_node,
+                                         op,
+                                         BackendTag<::Al::NCCLBackend>{});
+#else
+  return allreduce_impl(m, c, op);
+#endif
+}
+
 template <typename T>
 void nb_allreduce_impl(El::Matrix<T, El::Device::GPU>& m,
                        El::mpi::Comm const& c,
@@ -552,13 +910,83 @@ void nb_allreduce_impl(El::Matrix<T, El::Device::GPU>& m,
 #endif
 }
 
+template <typename T,
+          typename BackendT,
+          El::EnableWhen<
+            El::AluminumSupportsBackendAndCollective<T,
+                                                     El::Collective::SENDRECV,
+                                                     BackendT>,
+            int> = 0>
+void sendrecv_aluminum(const El::Matrix<T, El::Device::GPU>& snd,
+                       El::Matrix<T, El::Device::GPU>& rcv,
+                       int partner,
+                       const El::mpi::Comm& c,
+                       BackendTag<BackendT>)
+{
+  const auto& syncinfo = El::SyncInfoFromMatrix(rcv);
+  auto multisync = El::MakeMultiSync(syncinfo, El::SyncInfoFromMatrix(snd));
+  ::Al::SendRecv<BackendT>(snd.LockedBuffer(),
+                           snd.Height() * snd.Width(),
+                           partner,
+                           rcv.Buffer(),
+                           rcv.Height() * rcv.Width(),
+                           partner,
+                           c.template GetComm<BackendT>(syncinfo));
+}
+
+template <typename T,
+          typename BackendT,
+          El::EnableUnless<
+            El::AluminumSupportsBackendAndCollective<T,
+                                                     El::Collective::SENDRECV,
+                                                     BackendT>,
+            int> = 0>
+void sendrecv_aluminum(const El::Matrix<T, El::Device::GPU>& snd,
+                       El::Matrix<T, El::Device::GPU>& rcv,
+                       int partner,
+                       const El::mpi::Comm& c,
+                       BackendTag<BackendT>)
+{
+  El::SendRecv(snd, rcv, c, partner, partner);
+}
+
+template <typename T>
+void sendrecv_impl(const El::Matrix<T, El::Device::GPU>& snd,
+                   El::Matrix<T, El::Device::GPU>& rcv,
+                   int partner,
+                   const El::mpi::Comm& c)
+{
+  if ((snd.Width() > 1 && snd.Height() != snd.LDim()) ||
+      (rcv.Width() > 1 && rcv.Height() != rcv.LDim())) {
+    // Aluminum doesn't send strided matrices
+    return El::SendRecv(snd, rcv, c, partner, partner);
+  }
+
+#if defined(AL_HAS_NCCL)
+  return sendrecv_aluminum(snd,
+                           rcv,
+                           partner,
+                           c,
+                           BackendTag<::Al::NCCLBackend>{});
+#elif defined(AL_HAS_HOST_TRANSFER)
+  return sendrecv_aluminum(snd,
+                           rcv,
+                           partner,
+                           c,
+                           BackendTag<::Al::HostTransferBackend>{});
+#else
+  return El::SendRecv(snd, rcv, c, partner, partner);
+#endif
+}
+
 #endif // defined(LBANN_HAS_GPU) && defined(LBANN_HAS_ALUMINUM)
 } // namespace
 
 template <typename TensorDataType>
 void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
                            const El::mpi::Comm& c,
-                           El::mpi::Op op) const
+                           El::mpi::Op op,
+                           allreduce_algorithm algo) const
 {
   if (El::mpi::Size(c) == 1 || m.Height() < 1 || m.Width() < 1) {
     return;
@@ -568,6 +996,41 @@ void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
   m_bytes_sent += sizeof(DataType) * local_size;
   m_bytes_received += sizeof(DataType) * local_size * (El::mpi::Size(c) - 1);
 
+  if (algo == allreduce_algorithm::hierarchical &&
+      (m.Height() == m.LDim() || m.Width() == 1)) {
+    const auto& hc = get_hierarchical_comms(c);
+    if (hc.enabled && local_size >= El::mpi::Size(hc.intra_node)) {
+      traced_collective trace(*this,
+                              "allreduce",
+                              "hierarchical",
+                              m.GetDevice(),
+                              sizeof(TensorDataType) * local_size);
+      switch (m.GetDevice()) {
+      case El::Device::CPU:
+        return hierarchical_allreduce_impl(
+          static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m),
+          c,
+          hc.intra_node,
+          hc.inter_node,
+          op);
+#ifdef LBANN_HAS_GPU
+      case El::Device::GPU:
+        return hierarchical_allreduce_impl(
+          static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(m),
+          c,
+          hc.intra_node,
+          hc.inter_node,
+          op);
+#endif // LBANN_HAS_GPU
+      }
+    }
+  }
+
+  traced_collective trace(*this,
+                          "allreduce",
+                          "flat",
+                          m.GetDevice(),
+                          sizeof(TensorDataType) * local_size);
   switch (m.GetDevice()) {
   case El::Device::CPU:
     return allreduce_impl(
@@ -587,17 +1050,24 @@ void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
 template <typename TensorDataType>
 void lbann_comm::allreduce(El::AbstractDistMatrix<TensorDataType>& m,
                            const El::mpi::Comm& c,
-                           El::mpi::Op op) const
+                           El::mpi::Op op,
+                           allreduce_algorithm algo) const
 {
-  allreduce(m.Matrix(), c, op);
+  allreduce(m.Matrix(), c, op, algo);
 }
 
 template <typename TensorDataType>
 void lbann_comm::nb_allreduce(El::AbstractMatrix<TensorDataType>& m,
                               const El::mpi::Comm& c,
                               Al::request& req,
-                              El::mpi::Op op) const
+                              El::mpi::Op op,
+                              allreduce_algorithm algo) const
 {
+  if (algo == allreduce_algorithm::hierarchical) {
+    // The three phases depend on each other, so there is no single
+    // request to hand back.
+    return allreduce(m, c, op, algo);
+  }
   if (El::mpi::Size(c) == 1 || m.Height() < 1 || m.Width() < 1) {
     return;
   }
@@ -606,6 +1076,12 @@ void lbann_comm::nb_allreduce(El::AbstractMatrix<TensorDataType>& m,
   m_bytes_sent += sizeof(DataType) * local_size;
   m_bytes_received += sizeof(DataType) * local_size * (El::mpi::Size(c) - 1);
 
+  traced_collective trace(*this,
+                          "nb_allreduce",
+                          "flat",
+                          m.GetDevice(),
+                          sizeof(TensorDataType) * local_size);
+  trace.defer_to(&req);
   switch (m.GetDevice()) {
   case El::Device::CPU:
     return nb_allreduce_impl(
@@ -628,9 +1104,46 @@ template <typename TensorDataType>
 void lbann_comm::nb_allreduce(El::AbstractDistMatrix<TensorDataType>& m,
                               const El::mpi::Comm& c,
                               Al::request& req,
-                              El::mpi::Op op) const
+                              El::mpi::Op op,
+                              allreduce_algorithm algo) const
 {
-  nb_allreduce(m.Matrix(), c, req, op);
+  nb_allreduce(m.Matrix(), c, req, op, algo);
+}
+
+template <typename TensorDataType>
+void lbann_comm::sendrecv_matrix(const El::AbstractMatrix<TensorDataType>& snd,
+                                 El::AbstractMatrix<TensorDataType>& rcv,
+                                 int partner_rank_in_world) const
+{
+  if (snd.GetDevice() != rcv.GetDevice()) {
+    LBANN_ERROR("sendrecv_matrix expects the send and receive matrices "
+                "on the same device");
+  }
+  const size_t send_size = snd.Height() * snd.Width();
+  m_bytes_sent += sizeof(TensorDataType) * send_size;
+  m_bytes_received += sizeof(TensorDataType) * rcv.Height() * rcv.Width();
+  traced_collective trace(*this,
+                          "sendrecv",
+                          "direct",
+                          snd.GetDevice(),
+                          sizeof(TensorDataType) * send_size);
+
+  switch (snd.GetDevice()) {
+  case El::Device::CPU:
+    return sendrecv_impl(
+      static_cast<const El::Matrix<TensorDataType, El::Device::CPU>&>(snd),
+      static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(rcv),
+      partner_rank_in_world,
+      get_world_comm());
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    return sendrecv_impl(
+      static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(snd),
+      static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(rcv),
+      partner_rank_in_world,
+      get_world_comm());
+#endif // LBANN_HAS_GPU
+  }
 }
 
 void lbann_comm::wait(Al::request& req) const
@@ -656,6 +1169,7 @@ void lbann_comm::wait(Al::request& req) const
     MPI_Wait(&(req.raw_mpi_req), MPI_STATUS_IGNORE);
     ;
   }
+  end_deferred_collective(&req);
 }
 
 bool lbann_comm::test(Al::request& req) const
@@ -682,16 +1196,184 @@ bool lbann_comm::test(Al::request& req) const
     MPI_Test(&(req.raw_mpi_req), &flag, MPI_STATUS_IGNORE);
     req_test = flag;
   }
+  if (req_test) {
+    end_deferred_collective(&req);
+  }
+  return req_test;
+}
+
+template <typename TensorDataType>
+bool lbann_comm::is_column_reduce_scatter_supported(
+  const El::AbstractDistMatrix<TensorDataType>& src,
+  const El::AbstractDistMatrix<TensorDataType>& dst)
+{
+  return (src.ColDist() == El::STAR && src.RowDist() == El::STAR &&
+          dst.ColDist() == El::STAR && dst.RowDist() == El::VC &&
+          src.Wrap() == El::ELEMENT && dst.Wrap() == El::ELEMENT &&
+          src.Height() == dst.Height() && src.Width() == dst.Width() &&
+          src.GetLocalDevice() == dst.GetLocalDevice() &&
+          &src.Grid() == &dst.Grid() && dst.Participating());
+}
+
+template <typename TensorDataType>
+void lbann_comm::reduce_scatter_columns(
+  const El::AbstractDistMatrix<TensorDataType>& src,
+  El::AbstractDistMatrix<TensorDataType>& dst) const
+{
+  if (!is_column_reduce_scatter_supported(src, dst)) {
+    LBANN_ERROR("reduce_scatter_columns expects a [STAR,STAR] source and "
+                "an element-wise [STAR,VC] destination of the same size");
+  }
+  if (src.Height() < 1 || src.Width() < 1) {
+    return;
+  }
+  if (dst.DistSize() == 1) {
+    El::Copy(src.LockedMatrix(), dst.Matrix());
+    return;
+  }
+
+  const size_t local_size = src.Height() * src.Width();
+  m_bytes_sent += sizeof(TensorDataType) * local_size;
+  m_bytes_received += sizeof(TensorDataType) * dst.LocalHeight() *
+                      dst.LocalWidth() * (dst.DistSize() - 1);
+
+  traced_collective trace(*this,
+                          "reduce_scatter",
+                          "columns",
+                          src.GetLocalDevice(),
+                          sizeof(TensorDataType) * local_size);
+  switch (src.GetLocalDevice()) {
+  case El::Device::CPU:
+    return reduce_scatter_columns_impl(
+      static_cast<const El::Matrix<TensorDataType, El::Device::CPU>&>(
+        src.LockedMatrix()),
+      dst);
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    return reduce_scatter_columns_impl(
+      static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(
+        src.LockedMatrix()),
+      dst);
+#endif // LBANN_HAS_GPU
+  }
+}
+
+template <typename TensorDataType>
+void lbann_comm::persistent_allreduce_init(
+  El::AbstractMatrix<TensorDataType>& m,
+  const El::mpi::Comm& c,
+  Al::persistent_request& req,
+  El::mpi::Op op) const
+{
+  free(req);
+  req.buffer = m.LockedBuffer();
+  req.count = m.Height() * m.Width();
+  req.registered = true;
+  if (El::mpi::Size(c) == 1 || req.count == 0) {
+    return;
+  }
+  req.bytes_sent = sizeof(DataType) * req.count;
+  req.bytes_received = req.bytes_sent * (El::mpi::Size(c) - 1);
+
+#if MPI_VERSION >= 4
+  if (m.GetDevice() == El::Device::CPU &&
+      (m.Height() == m.LDim() || m.Width() == 1)) {
+    checkMPI(MPI_Allreduce_init(MPI_IN_PLACE,
+                                m.Buffer(),
+                                req.count,
+                                El::mpi::TypeMap<TensorDataType>(),
+                                op.op,
+                                c.GetMPIComm(),
+                                MPI_INFO_NULL,
+                                &(req.persistent_mpi_req)));
+    return;
+  }
+#endif // MPI_VERSION >= 4
+
+  // nb_allreduce does its own byte accounting
+  req.bytes_sent = req.bytes_received = 0;
+  req.restart = [this, &m, &c, op](Al::request& r) {
+    nb_allreduce(m, c, r, op);
+  };
+}
+
+void lbann_comm::start(Al::persistent_request& req) const
+{
+  if (!req.registered) {
+    LBANN_ERROR("attempted to start an unregistered persistent collective");
+  }
+  m_bytes_sent += req.bytes_sent;
+  m_bytes_received += req.bytes_received;
+  if (req.persistent_mpi_req != MPI_REQUEST_NULL) {
+    traced_collective trace(*this,
+                            "persistent_allreduce",
+                            "flat",
+                            El::Device::CPU,
+                            req.bytes_sent);
+    trace.defer_to(&req);
+    checkMPI(MPI_Start(&(req.persistent_mpi_req)));
+  }
+  else if (req.restart) {
+    req.restart(req.req);
+  }
+}
+
+void lbann_comm::wait(Al::persistent_request& req) const
+{
+  if (req.persistent_mpi_req != MPI_REQUEST_NULL) {
+    // Completing a persistent request leaves it allocated but inactive
+    MPI_Wait(&(req.persistent_mpi_req), MPI_STATUS_IGNORE);
+  }
+  wait(req.req);
+  end_deferred_collective(&req);
+}
+
+bool lbann_comm::test(Al::persistent_request& req) const
+{
+  bool req_test = test(req.req);
+  if (req.persistent_mpi_req != MPI_REQUEST_NULL) {
+    int flag = 0;
+    MPI_Test(&(req.persistent_mpi_req), &flag, MPI_STATUS_IGNORE);
+    req_test = req_test && flag;
+  }
+  if (req_test) {
+    end_deferred_collective(&req);
+  }
   return req_test;
 }
 
+void lbann_comm::free(Al::persistent_request& req) const
+{
+  m_deferred_collectives.erase(&req);
+  end_deferred_collective(&req);
+  if (req.persistent_mpi_req != MPI_REQUEST_NULL) {
+    checkMPI(MPI_Request_free(&(req.persistent_mpi_req)));
+  }
+  req.restart = nullptr;
+  req.buffer = nullptr;
+  req.count = 0;
+  req.bytes_sent = req.bytes_received = 0;
+  req.registered = false;
+}
+
 void lbann_comm::intertrainer_broadcast_matrix(AbsMat& mat, int root) const
 {
+  traced_collective trace(*this,
+                          "broadcast",
+                          "flat",
+                          mat.GetDevice(),
+                          sizeof(DataType) * mat.Height() * mat.Width());
   El::Broadcast(mat, m_intertrainer_comm, root);
 }
 
 void lbann_comm::intertrainer_broadcast_matrix(AbsDistMat& mat, int root) const
 {
+  traced_collective trace(*this,
+                          "broadcast",
+                          "flat",
+                          mat.GetLocalDevice(),
+                          sizeof(DataType) * mat.LocalHeight() *
+                            mat.LocalWidth());
   El::Broadcast(mat, m_intertrainer_comm, root);
 }
 
@@ -725,6 +1407,11 @@ void lbann_comm::global_barrier() const
 
 void lbann_comm::barrier(const El::mpi::Comm& c) const { El::mpi::Barrier(c); }
 
+void lbann_comm::nb_barrier(const El::mpi::Comm& c, Al::request& req) const
+{
+  checkMPI(MPI_Ibarrier(c.GetMPIComm(), &(req.raw_mpi_req)));
+}
+
 void lbann_comm::send(const AbsMat& mat,
                       const int trainer,
                       const int rank) const
@@ -900,6 +1587,207 @@ const El::mpi::Comm& lbann_comm::get_packed_group_comm(int num_per_group) const
   return m_group_communicators[num_per_group];
 }
 
+void lbann_comm::set_hierarchical_node_size(int n)
+{
+  if (n < 0) {
+    LBANN_ERROR("invalid number of processes per node (", n, ")");
+  }
+  m_hierarchical_node_size = n;
+  m_hierarchical_comms.clear();
+}
+
+const lbann_comm::hierarchical_comms&
+lbann_comm::get_hierarchical_comms(const El::mpi::Comm& c) const
+{
+  auto it = m_hierarchical_comms.find(c.GetMPIComm());
+  if (it != m_hierarchical_comms.end()) {
+    return it->second;
+  }
+
+  // Processes are grouped by the lowest world rank on their node
+  const int rank = El::mpi::Rank(c);
+  const int color = m_hierarchical_node_size > 0
+                      ? rank / m_hierarchical_node_size
+                      : m_world_ranks_on_node.front();
+  MPI_Comm intra, inter;
+  checkMPI(MPI_Comm_split(c.GetMPIComm(), color, rank, &intra));
+  int intra_rank, intra_size, inter_size;
+  MPI_Comm_rank(intra, &intra_rank);
+  MPI_Comm_size(intra, &intra_size);
+  checkMPI(MPI_Comm_split(c.GetMPIComm(), intra_rank, rank, &inter));
+  MPI_Comm_size(inter, &inter_size);
+
+  // Shards only line up across nodes if every node holds the same
+  // number of processes of c
+  int sizes[2] = {intra_size, -intra_size};
+  checkMPI(MPI_Allreduce(MPI_IN_PLACE,
+                         sizes,
+                         2,
+                         MPI_INT,
+                         MPI_MAX,
+                         c.GetMPIComm()));
+  const bool enabled =
+    (sizes[0] == -sizes[1] && intra_size > 1 && inter_size > 1);
+
+  it = m_hierarchical_comms.try_emplace(c.GetMPIComm(), intra, inter, enabled)
+         .first;
+  MPI_Comm_free(&intra); // El::mpi::Comm duplicates internally.
+  MPI_Comm_free(&inter);
+  return it->second;
+}
+
+namespace {
+constexpr size_t no_collective_record = static_cast<size_t>(-1);
+} // namespace
+
+lbann_comm::collective_tag_scope::collective_tag_scope(lbann_comm const& comm,
+                                                       std::string tag)
+  : m_comm{comm}, m_parent_tag{std::move(tag)}
+{
+  std::swap(m_parent_tag, m_comm.m_collective_tag);
+}
+
+lbann_comm::collective_tag_scope::~collective_tag_scope()
+{
+  m_comm.m_collective_tag = std::move(m_parent_tag);
+}
+
+lbann_comm::traced_collective::traced_collective(lbann_comm const& comm,
+                                                 char const* op,
+                                                 char const* algorithm,
+                                                 El::Device device,
+                                                 size_t bytes)
+  : m_comm{comm},
+    m_record{no_collective_record},
+    m_pending{no_collective_record}
+{
+  if (comm.m_profile_collectives) {
+    m_region = build_string(op, " ", comm.m_collective_tag);
+    prof_region_begin(m_region.c_str(), prof_colors[5], false);
+  }
+  if (!comm.m_trace_collectives && !comm.m_track_pending_collectives) {
+    return;
+  }
+  const double now = get_time();
+  collective_record record{
+    comm.m_collective_tag,
+    op,
+    build_string(algorithm, device == El::Device::CPU ? "/CPU" : "/GPU"),
+    bytes,
+    now,
+    now};
+  if (comm.m_track_pending_collectives) {
+    m_pending = comm.m_next_pending_collective++;
+    std::lock_guard<std::mutex> lock(comm.m_pending_collectives_mutex);
+    comm.m_pending_collectives.emplace(m_pending, record);
+  }
+  if (comm.m_trace_collectives) {
+    comm.m_collective_records.push_back(std::move(record));
+    m_record = comm.m_collective_records.size() - 1;
+  }
+}
+
+lbann_comm::traced_collective::~traced_collective()
+{
+  if (!m_region.empty()) {
+    prof_region_end(m_region.c_str(), false);
+  }
+  if (m_record != no_collective_record) {
+    m_comm.finish_collective_record(m_record);
+  }
+  if (m_pending != no_collective_record) {
+    std::lock_guard<std::mutex> lock(m_comm.m_pending_collectives_mutex);
+    m_comm.m_pending_collectives.erase(m_pending);
+  }
+}
+
+void lbann_comm::traced_collective::defer_to(void const* req)
+{
+  if (m_record != no_collective_record) {
+    m_comm.m_deferred_collectives[req] = m_record;
+    m_record = no_collective_record;
+  }
+  if (m_pending != no_collective_record) {
+    m_comm.m_deferred_pending_collectives[req] = m_pending;
+    m_pending = no_collective_record;
+  }
+}
+
+void lbann_comm::finish_collective_record(size_t record) const
+{
+  if (record >= m_collective_records.size()) {
+    // Taken by take_collective_records while in flight
+    return;
+  }
+#ifdef LBANN_HAS_GPU
+  if (m_sync_traced_collectives) {
+    hydrogen::gpu::SynchronizeDevice();
+  }
+#endif // LBANN_HAS_GPU
+  auto& r = m_collective_records[record];
+  r.end_time = get_time();
+  auto& totals = m_collective_summary[{r.tag, r.op, r.algorithm}];
+  ++totals.calls;
+  totals.bytes += r.bytes;
+  totals.time += r.end_time - r.start_time;
+}
+
+void lbann_comm::end_deferred_collective(void const* req) const
+{
+  if (!m_deferred_pending_collectives.empty()) {
+    auto it = m_deferred_pending_collectives.find(req);
+    if (it != m_deferred_pending_collectives.end()) {
+      std::lock_guard<std::mutex> lock(m_pending_collectives_mutex);
+      m_pending_collectives.erase(it->second);
+      m_deferred_pending_collectives.erase(it);
+    }
+  }
+  if (m_deferred_collectives.empty()) {
+    return;
+  }
+  auto it = m_deferred_collectives.find(req);
+  if (it != m_deferred_collectives.end()) {
+    finish_collective_record(it->second);
+    m_deferred_collectives.erase(it);
+  }
+}
+
+std::vector<collective_record> lbann_comm::take_collective_records() const
+{
+  m_deferred_collectives.clear();
+  return std::exchange(m_collective_records, {});
+}
+
+void lbann_comm::print_collective_summary(std::ostream& os) const
+{
+  os << "Collectives on world rank " << get_rank_in_world() << ":\n";
+  for (const auto& [key, totals] : m_collective_summary) {
+    const auto& [tag, op, algorithm] = key;
+    const double bandwidth =
+      totals.time > 0. ? static_cast<double>(totals.bytes) / totals.time : 0.;
+    os << "  " << tag << " " << op << " (" << algorithm << "): "
+       << totals.calls << " calls, " << totals.bytes << " bytes, "
+       << totals.time << " s, " << bandwidth / 1e9 << " GB/s\n";
+  }
+  os.flush();
+}
+
+void lbann_comm::reset_collective_summary() const noexcept
+{
+  m_collective_summary.clear();
+}
+
+std::vector<collective_record> lbann_comm::get_pending_collectives() const
+{
+  std::lock_guard<std::mutex> lock(m_pending_collectives_mutex);
+  std::vector<collective_record> pending;
+  pending.reserve(m_pending_collectives.size());
+  for (const auto& entry : m_pending_collectives) {
+    pending.push_back(entry.second);
+  }
+  return pending;
+}
+
 void lbann_comm::lbann_comm_abort(std::string msg) const
 {
   throw lbann_exception(msg);
@@ -940,18 +1828,37 @@ int get_rank_in_world()
 #define PROTO(T)                                                               \
   template void lbann_comm::allreduce(El::AbstractMatrix<T>& m,                \
                                       const El::mpi::Comm& c,                  \
-                                      El::mpi::Op op) const;                   \
+                                      El::mpi::Op op,                          \
+                                      allreduce_algorithm algo) const;         \
   template void lbann_comm::allreduce(El::AbstractDistMatrix<T>& m,            \
                                       const El::mpi::Comm& c,                  \
-                                      El::mpi::Op op) const;                   \
+                                      El::mpi::Op op,                          \
+                                      allreduce_algorithm algo) const;         \
   template void lbann_comm::nb_allreduce(El::AbstractMatrix<T>& m,             \
                                          const El::mpi::Comm& c,               \
                                          Al::request& req,                     \
-                                         El::mpi::Op op) const;                \
+                                         El::mpi::Op op,                       \
+                                         allreduce_algorithm algo) const;      \
   template void lbann_comm::nb_allreduce(El::AbstractDistMatrix<T>& m,         \
                                          const El::mpi::Comm& c,               \
                                          Al::request& req,                     \
-                                         El::mpi::Op op) const
+                                         El::mpi::Op op,                       \
+                                         allreduce_algorithm algo) const;      \
+  template void lbann_comm::persistent_allreduce_init(                         \
+    El::AbstractMatrix<T>& m,                                                  \
+    const El::mpi::Comm& c,                                                    \
+    Al::persistent_request& req,                                               \
+    El::mpi::Op op) const;                                                     \
+  template void lbann_comm::reduce_scatter_columns(                            \
+    const El::AbstractDistMatrix<T>& src,                                      \
+    El::AbstractDistMatrix<T>& dst) const;                                     \
+  template void lbann_comm::sendrecv_matrix(                                   \
+    const El::AbstractMatrix<T>& snd,                                          \
+    El::AbstractMatrix<T>& rcv,                                                \
+    int partner_rank_in_world) const;                                          \
+  template bool lbann_comm::is_column_reduce_scatter_supported(                \
+    const El::AbstractDistMatrix<T>& src,                                      \
+    const El::AbstractDistMatrix<T>& dst)
 
 #define LBANN_INSTANTIATE_DOUBLE
 #define LBANN_INSTANTIATE_CPU_HALF
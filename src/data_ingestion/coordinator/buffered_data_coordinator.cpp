@@ -26,6 +26,7 @@
 
 #include "lbann/comm_impl.hpp"
 #include "lbann/data_ingestion/coordinator/buffered_data_coordinator_impl.hpp"
+#include "lbann/data_ingestion/coordinator/fetch_tracing.hpp"
 #include "lbann/data_ingestion/data_reader.hpp"
 #include "lbann/data_ingestion/data_store_conduit.hpp"
 #include "lbann/data_ingestion/infrastructure/data_packer.hpp"
@@ -35,12 +36,188 @@
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/hash.hpp"
+#include "lbann/utils/omp_pragma.hpp"
 #include "lbann/utils/profiling.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/tensor_impl.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <utility>
+#include <vector>
 
 namespace lbann {
 
+#if defined(LBANN_HAS_GPU)
+namespace {
+
+size_t get_transfer_type_size(input_transfer_type type)
+{
+  switch (type) {
+  case input_transfer_type::fp16:
+  case input_transfer_type::bf16:
+    return 2;
+  case input_transfer_type::uint8:
+    return 1;
+  default:
+    return sizeof(DataType);
+  }
+}
+
+/** Round a float to the upper 16 bits of its nearest bfloat16 */
+uint16_t float_to_bf16_bits(float x)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  if (std::isnan(x)) {
+    return static_cast<uint16_t>((bits >> 16) | 0x40);
+  }
+  bits += 0x7FFF + ((bits >> 16) & 1);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+/** Pack the columns of @c src consecutively into @c dst */
+template <typename TensorDataType>
+void pack_columns(input_transfer_type type,
+                  float scale,
+                  El::Matrix<TensorDataType, El::Device::CPU> const& src,
+                  El::byte* dst)
+{
+  const El::Int height = src.Height();
+  const El::Int width = src.Width();
+  switch (type) {
+  case input_transfer_type::fp16: {
+#ifdef LBANN_HAS_HALF
+    auto* packed = reinterpret_cast<cpu_fp16*>(dst);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        packed[row + col * height] =
+          cpu_fp16(static_cast<float>(src.CRef(row, col)));
+      }
+    }
+#else
+    LBANN_ERROR("fp16 input transfers require a build with half support");
+#endif // LBANN_HAS_HALF
+    break;
+  }
+  case input_transfer_type::bf16: {
+    auto* packed = reinterpret_cast<uint16_t*>(dst);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        packed[row + col * height] =
+          float_to_bf16_bits(static_cast<float>(src.CRef(row, col)));
+      }
+    }
+    break;
+  }
+  case input_transfer_type::uint8: {
+    auto* packed = reinterpret_cast<uint8_t*>(dst);
+    const float inv_scale = 1.f / scale;
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        const float q =
+          std::nearbyint(static_cast<float>(src.CRef(row, col)) * inv_scale);
+        packed[row + col * height] =
+          static_cast<uint8_t>(std::min(std::max(q, 0.f), 255.f));
+      }
+    }
+    break;
+  }
+  default:
+    LBANN_ERROR("Invalid input transfer type");
+  }
+}
+
+} // namespace
+#endif // LBANN_HAS_GPU
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::allocate_data_buffers(
+  size_t num_io_buffers)
+{
+  num_io_buffers = std::max(num_io_buffers, default_num_io_buffers);
+  m_data_buffers.clear();
+  m_data_buffers.resize(num_io_buffers);
+  m_current_mini_batch_size.clear();
+  m_current_mini_batch_size.resize(num_io_buffers);
+  for (size_t i = 0; i < m_data_buffers.size(); i++) {
+    for (auto m : execution_mode_iterator()) {
+      if (m != execution_mode::invalid) {
+        m_data_buffers[i][m] =
+          std::make_unique<data_buffer<IODataType>>(this->m_comm);
+        m_current_mini_batch_size[i][m] = 0;
+      }
+    }
+  }
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::set_num_io_buffers(
+  size_t num_io_buffers)
+{
+  num_io_buffers = std::max(num_io_buffers, default_num_io_buffers);
+  if (num_io_buffers == m_data_buffers.size()) {
+    return;
+  }
+  if (!m_active_data_fields.empty()) {
+    LBANN_ERROR("Cannot resize the I/O buffer ring after data fields have ",
+                "been registered with the data coordinator");
+  }
+  allocate_data_buffers(num_io_buffers);
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::set_device_resident_data(
+  bool device_resident)
+{
+#if defined(LBANN_HAS_GPU)
+  m_device_resident_data = device_resident;
+#else
+  if (device_resident) {
+    LBANN_ERROR("Device-resident input data requires a GPU-enabled build");
+  }
+#endif // LBANN_HAS_GPU
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::set_input_transfer_type(
+  std::string const& type,
+  float scale)
+{
+  if (type.empty() || type == "full") {
+    m_transfer_type = input_transfer_type::full;
+  }
+  else if (type == "fp16") {
+#if !defined(LBANN_HAS_HALF) || !defined(LBANN_HAS_GPU_FP16)
+    LBANN_ERROR("fp16 input transfers require a build with half support");
+#endif
+    m_transfer_type = input_transfer_type::fp16;
+  }
+  else if (type == "bf16") {
+    m_transfer_type = input_transfer_type::bf16;
+  }
+  else if (type == "uint8") {
+    m_transfer_type = input_transfer_type::uint8;
+  }
+  else {
+    LBANN_ERROR("Unknown input transfer type \"",
+                type,
+                "\"; expected full, fp16, bf16 or uint8");
+  }
+  if (scale < 0.f) {
+    LBANN_ERROR("Input transfer scale must be positive, got ", scale);
+  }
+  m_transfer_scale = (scale > 0.f ? scale : 1.f / 255.f);
+}
+
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::register_active_data_field(
   data_field_type const& data_field,
@@ -109,6 +286,8 @@ void buffered_data_coordinator<TensorDataType>::setup_data_fields(
 #endif // LBANN_HAS_DISTCONV
 
   // Check to see if there are any data fields with unallocated buffers
+  std::vector<std::pair<El::AbstractDistMatrix<IODataType>*, El::Int>>
+    new_buffers;
   for (auto& data_field : m_active_data_fields) {
     for (const auto& buf_map : m_data_buffers) {
       const data_buffer_map_t& buffer_map = buf_map;
@@ -123,8 +302,7 @@ void buffered_data_coordinator<TensorDataType>::setup_data_fields(
             LBANN_ERROR("Invalid value for the linearized size of data field ",
                         data_field);
           }
-          data_buffer->m_input_buffers[data_field]->Resize(linearized_size,
-                                                           max_mini_batch_size);
+          new_buffers.emplace_back(phase_io_buffer.get(), linearized_size);
 
           /// The amount of space needed will vary based on input layer type,
           /// but the batch size is the maximum space necessary
@@ -134,6 +312,52 @@ void buffered_data_coordinator<TensorDataType>::setup_data_fields(
       }
     }
   }
+  place_input_buffers(new_buffers, max_mini_batch_size);
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::place_input_buffers(
+  std::vector<std::pair<El::AbstractDistMatrix<IODataType>*, El::Int>> const&
+    buffers,
+  El::Int width)
+{
+  if (buffers.empty()) {
+    return;
+  }
+  auto resize_all = [&buffers, width]() {
+    for (auto& [buffer, height] : buffers) {
+      buffer->Resize(height, width);
+    }
+  };
+  if (m_io_thread_pool == nullptr || m_io_thread_pool->get_num_threads() == 0) {
+    resize_all();
+    return;
+  }
+
+  // Pinned host memory is placed when it is allocated, so allocate
+  // from an I/O thread rather than from the caller
+  auto& pool = get_io_thread_pool();
+  pool.submit_job(resize_all).get();
+
+  // Each I/O thread first-touches its share of the columns and sizes
+  // its scratch arena for one sample
+  const El::Int num_threads = static_cast<El::Int>(pool.get_num_threads());
+  size_t max_sample_bytes = 0;
+  for (auto& [buffer, height] : buffers) {
+    max_sample_bytes = std::max(max_sample_bytes,
+                                static_cast<size_t>(height) * sizeof(IODataType));
+  }
+  pool.for_each_thread([&](int tid) {
+    for (auto& [buffer, height] : buffers) {
+      auto& local = buffer->Matrix();
+      const El::Int first = local.Width() * tid / num_threads;
+      const El::Int last = local.Width() * (tid + 1) / num_threads;
+      for (El::Int j = first; j < last; ++j) {
+        std::fill_n(local.Buffer(0, j), local.Height(), IODataType(0));
+      }
+    }
+    utils::get_scratch_arena().reserve(max_sample_bytes);
+  });
 }
 
 template <typename TensorDataType>
@@ -150,6 +374,7 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
   std::string prof_title =
     ("fetch_to_local_matrix " + std::to_string(buffer_id));
   prof_region_begin(prof_title.c_str(), prof_colors[2], false);
+  EvalType const start_time = get_time();
   /// Coordinate all available readers so that they perform I/O in the same step
   /// Check to make sure that the local matrix has space for data
 
@@ -167,7 +392,7 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
     // Compute the size of the current local mini-batch
     const uint64_t end_pos =
       std::min(relative_base_position + loaded_mini_batch_size,
-               (uint64_t)dr->m_shuffled_indices.size());
+               dr->get_num_data());
     const uint64_t local_mini_batch_size = std::min(
       ((end_pos - relative_base_position) + ds.get_sample_stride() - 1) /
         ds.get_sample_stride(),
@@ -176,7 +401,12 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
 
     /** @brief Each rank will fetch a mini-batch worth of data into its buffer
      */
-    if (dr->has_conduit_output()) {
+    if (dr->generates_data_on_device()) {
+      // The input layers generate the mini-batch, so there is no I/O
+      buf.m_num_samples_fetched =
+        (relative_base_position < end_pos) ? local_mini_batch_size : 0;
+    }
+    else if (dr->has_conduit_output()) {
       std::vector<conduit::Node> samples(local_mini_batch_size);
       buf.m_num_samples_fetched = dr->fetch(samples,
                                             buf.m_indices_fetched_per_mb,
@@ -203,6 +433,8 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
     }
   }
   prof_region_end(prof_title.c_str(), false);
+  record_fetch(buffer_id, start_time);
+  m_pipeline_stats.record_fetch(mode, start_time, get_time());
   return buf.m_num_samples_fetched;
 }
 
@@ -229,6 +461,10 @@ void buffered_data_coordinator<TensorDataType>::fetch_data_in_background(
 {
   int active_buffer_idx = future_active_buffer % m_data_buffers.size();
   std::lock_guard<std::mutex> guard(dr_mutex);
+#if defined(LBANN_HAS_GPU)
+  // A copy staged to the device may still be reading the host buffers
+  buf.m_device_copy_event.synchronize();
+#endif // LBANN_HAS_GPU
   fetch_to_local_matrix(mode,
                         buf,
                         loaded_mini_batch_size,
@@ -237,6 +473,341 @@ void buffered_data_coordinator<TensorDataType>::fetch_data_in_background(
   return;
 }
 
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::start_background_fetch(
+  int future_active_buffer,
+  data_buffer<IODataType>& buf,
+  uint64_t loaded_mini_batch_size,
+  uint64_t relative_base_position,
+  execution_mode mode)
+{
+#if defined(LBANN_HAS_GPU)
+  if (m_device_resident_data) {
+    fetch_from_device_resident_data(buf,
+                                    loaded_mini_batch_size,
+                                    relative_base_position,
+                                    mode);
+    return;
+  }
+#endif // LBANN_HAS_GPU
+
+  std::promise<void> done;
+  buf.set_data_fetch_future(done.get_future());
+  buf.set_background_fetching_in_progress(true);
+
+  bool launch_worker = false;
+  {
+    std::lock_guard<std::mutex> guard(m_background_fetch_queue_mutex);
+    m_background_fetch_queue.push_back({future_active_buffer,
+                                        &buf,
+                                        loaded_mini_batch_size,
+                                        relative_base_position,
+                                        mode,
+                                        std::move(done)});
+    launch_worker = !m_background_fetch_active;
+    m_background_fetch_active = true;
+  }
+  if (launch_worker) {
+    get_io_thread_pool().submit_job(
+      std::bind(&buffered_data_coordinator::drain_background_fetch_queue,
+                this));
+  }
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::drain_background_fetch_queue()
+{
+  while (true) {
+    fetch_request req;
+    {
+      std::lock_guard<std::mutex> guard(m_background_fetch_queue_mutex);
+      if (m_background_fetch_queue.empty()) {
+        m_background_fetch_active = false;
+        return;
+      }
+      req = std::move(m_background_fetch_queue.front());
+      m_background_fetch_queue.pop_front();
+    }
+    try {
+      fetch_data_in_background(req.buffer_idx,
+                               *req.buffer,
+                               req.mini_batch_size,
+                               req.relative_base_position,
+                               req.mode);
+      req.done.set_value();
+    }
+    catch (...) {
+      req.done.set_exception(std::current_exception());
+    }
+  }
+}
+
+template <typename TensorDataType>
+uint64_t buffered_data_coordinator<TensorDataType>::get_prefetch_depth(
+  execution_mode mode) const
+{
+  // The data store only holds the samples of the most recently
+  // exchanged mini-batch, so it can only run one fetch ahead
+  const generic_data_reader* dr = get_data_reader(mode);
+  if (dr != nullptr && dr->data_store_active()) {
+    const data_store_conduit& store = dr->get_data_store();
+    if (!(store.is_local_cache() && store.is_fully_loaded())) {
+      return 1;
+    }
+  }
+  return m_data_buffers.size() - 1;
+}
+
+#if defined(LBANN_HAS_GPU)
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::stage_to_device(
+  data_buffer<IODataType>& buf)
+{
+  if (buf.m_device_buffers_staged || m_device_staged_data_fields.empty() ||
+      buf.num_samples_ready() == 0) {
+    return;
+  }
+  // Do not overwrite the device buffers until the compute stream is
+  // done with the previous mini-batch staged in them
+  buf.m_device_release_event.wait(m_transfer_sync_info.Stream());
+  for (auto const& data_field : m_device_staged_data_fields) {
+    auto host_it = buf.m_input_buffers.find(data_field);
+    if (host_it == buf.m_input_buffers.end()) {
+      continue;
+    }
+    auto const& host_buffer = *host_it->second;
+    auto& device_buffer = buf.m_device_input_buffers[data_field];
+    if (device_buffer == nullptr) {
+      device_buffer =
+        std::make_unique<StarVCMatDT<IODataType, El::Device::GPU>>(
+          host_buffer.Grid());
+    }
+    El::SetSyncInfo(
+      dynamic_cast<El::Matrix<IODataType, El::Device::GPU>&>(
+        device_buffer->Matrix()),
+      m_transfer_sync_info);
+    device_buffer->Resize(host_buffer.Height(), host_buffer.Width());
+    if (data_field == INPUT_DATA_TYPE_SAMPLES &&
+        m_transfer_type != input_transfer_type::full) {
+      stage_packed_samples(
+        buf,
+        static_cast<CPUMat const&>(host_buffer.LockedMatrix()),
+        dynamic_cast<El::Matrix<IODataType, El::Device::GPU>&>(
+          device_buffer->Matrix()));
+    }
+    else {
+      El::CopyAsync(host_buffer, *device_buffer);
+    }
+  }
+  buf.m_device_copy_event.record(m_transfer_sync_info.Stream());
+  buf.m_device_buffers_staged = true;
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::stage_packed_samples(
+  data_buffer<IODataType>& buf,
+  CPUMat const& host_samples,
+  El::Matrix<IODataType, El::Device::GPU>& device_samples)
+{
+  const size_t num_bytes = host_samples.Height() * host_samples.Width() *
+                           get_transfer_type_size(m_transfer_type);
+  if (num_bytes == 0) {
+    return;
+  }
+  // The previous copy out of the pinned buffer must finish before the
+  // host overwrites it
+  buf.m_device_copy_event.synchronize();
+  auto& host_packed = buf.m_packed_host_samples;
+  auto& device_packed = buf.m_packed_device_samples;
+  if (host_packed == nullptr || host_packed->size() < num_bytes) {
+    host_packed =
+      std::make_unique<hydrogen::simple_buffer<El::byte, El::Device::CPU>>(
+        num_bytes,
+        El::SyncInfo<El::Device::CPU>{},
+        1); // Pinned memory
+  }
+  if (device_packed == nullptr || device_packed->size() < num_bytes) {
+    device_packed =
+      std::make_unique<hydrogen::simple_buffer<El::byte, El::Device::GPU>>(
+        num_bytes,
+        m_transfer_sync_info);
+  }
+  pack_columns(m_transfer_type,
+               m_transfer_scale,
+               host_samples,
+               host_packed->data());
+  hydrogen::gpu::Copy1DToDevice(host_packed->data(),
+                                device_packed->data(),
+                                num_bytes,
+                                m_transfer_sync_info);
+  El::SetSyncInfo(device_samples, m_transfer_sync_info);
+  unpack_columns(m_transfer_type,
+                 m_transfer_scale,
+                 device_packed->data(),
+                 device_samples);
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::preload_device_resident_data(
+  execution_mode mode)
+{
+  generic_data_reader* dr = get_data_reader(mode);
+  if (dr->is_streaming()) {
+    LBANN_ERROR("Device-resident input data requires a data set with a ",
+                "sample index; ",
+                dr->get_type(),
+                " streams its samples");
+  }
+  if (dr->data_store_active()) {
+    const data_store_conduit& store = dr->get_data_store();
+    if (!(store.is_local_cache() && store.is_fully_loaded())) {
+      LBANN_ERROR("Device-resident input data requires every rank to hold ",
+                  "the full data set; use a preloaded local-cache data store");
+    }
+  }
+
+  const uint64_t num_samples = dr->get_num_data();
+  const uint64_t chunk_size =
+    std::max(get_dataset(mode).get_mini_batch_size(), uint64_t{1});
+
+  // Allocate the device-resident data set and host staging buffers
+  auto& device_samples = m_device_resident_samples[mode];
+  std::map<data_field_type, CPUMat> host_chunks;
+  size_t num_bytes = 0;
+  for (auto const& data_field : m_active_data_fields) {
+    const El::Int height = get_linearized_size(data_field);
+    auto& samples = device_samples[data_field];
+    samples = std::make_unique<El::Matrix<IODataType, El::Device::GPU>>();
+    El::SetSyncInfo(*samples, m_transfer_sync_info);
+    samples->Resize(height, num_samples);
+    host_chunks[data_field].SetMemoryMode(1); // Pinned memory
+    host_chunks[data_field].Resize(height, chunk_size);
+    num_bytes += height * num_samples * sizeof(IODataType);
+  }
+  if (m_comm->am_trainer_master()) {
+    LBANN_MSG("caching ",
+              num_samples,
+              " ",
+              to_string(mode),
+              " samples in device memory (",
+              num_bytes / (1024 * 1024),
+              " MiB per rank)");
+  }
+
+  // Fetch every sample of the data set once, in shuffled order, and
+  // remember which column holds which sample
+  auto& columns = m_device_resident_columns[mode];
+  columns.clear();
+  columns.reserve(num_samples);
+  El::Matrix<El::Int> indices_fetched;
+  for (uint64_t pos = 0; pos < num_samples; pos += chunk_size) {
+    const uint64_t n = std::min(chunk_size, num_samples - pos);
+    std::map<data_field_type, CPUMat*> local_input_buffers;
+    for (auto& [data_field, chunk] : host_chunks) {
+      chunk.Resize(chunk.Height(), n);
+      local_input_buffers[data_field] = &chunk;
+    }
+    El::Zeros_seq(indices_fetched, n, 1);
+    std::lock_guard<std::mutex> guard(dr_mutex);
+    get_io_thread_pool()
+      .submit_job([&]() {
+        if (dr->has_conduit_output()) {
+          std::vector<conduit::Node> samples(n);
+          dr->fetch(samples, indices_fetched, pos, 1, n, mode);
+          data_packer::extract_data_fields_from_samples(samples,
+                                                        local_input_buffers);
+        }
+        else {
+          dr->fetch(local_input_buffers, indices_fetched, pos, 1, n, mode);
+        }
+      })
+      .get();
+    for (auto& [data_field, chunk] : host_chunks) {
+      auto cols = (*device_samples[data_field])(El::ALL, El::IR(pos, pos + n));
+      El::Copy(chunk, cols);
+    }
+    for (uint64_t i = 0; i < n; ++i) {
+      columns[indices_fetched(i, 0)] = pos + i;
+    }
+  }
+  // The host staging buffers are released on return
+  gpu_lib::event_wrapper preload_done;
+  preload_done.record(m_transfer_sync_info.Stream());
+  preload_done.synchronize();
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::fetch_from_device_resident_data(
+  data_buffer<IODataType>& buf,
+  uint64_t loaded_mini_batch_size,
+  uint64_t relative_base_position,
+  execution_mode mode)
+{
+  if (m_device_resident_samples.count(mode) == 0) {
+    preload_device_resident_data(mode);
+  }
+  generic_data_reader* dr = get_data_reader(mode);
+  const dataset& ds = get_dataset(mode);
+  auto& device_samples = m_device_resident_samples[mode];
+  const auto& columns = m_device_resident_columns[mode];
+
+  buf.m_num_samples_fetched = 0;
+  buf.m_device_buffers_staged = false;
+  auto const& samples_buffer = *buf.m_input_buffers[INPUT_DATA_TYPE_SAMPLES];
+  if (relative_base_position >= dr->get_num_data() ||
+      samples_buffer.LocalWidth() == 0) {
+    return;
+  }
+
+  // Compute the size of the current local mini-batch, as in
+  // fetch_to_local_matrix
+  const uint64_t end_pos =
+    std::min(relative_base_position + loaded_mini_batch_size,
+             dr->get_num_data());
+  const uint64_t local_mini_batch_size =
+    std::min(((end_pos - relative_base_position) + ds.get_sample_stride() - 1) /
+               ds.get_sample_stride(),
+             static_cast<uint64_t>(samples_buffer.LocalWidth()));
+
+  // Look up the columns of the samples in this mini-batch
+  El::Matrix<El::Int> host_columns(local_mini_batch_size, 1);
+  for (uint64_t i = 0; i < local_mini_batch_size; ++i) {
+    const auto sample_index =
+      dr->get_sample_index(relative_base_position + i * ds.get_sample_stride());
+    buf.m_indices_fetched_per_mb.Set(i, 0, sample_index);
+    host_columns(i, 0) = columns.at(sample_index);
+  }
+  auto& device_columns = buf.m_device_sample_columns;
+  El::SetSyncInfo(device_columns, m_transfer_sync_info);
+  El::Copy(host_columns, device_columns);
+
+  // Gather the mini-batch into the device staging buffers once the
+  // compute stream is done with their previous contents
+  buf.m_device_release_event.wait(m_transfer_sync_info.Stream());
+  for (auto& [data_field, samples] : device_samples) {
+    auto const& host_buffer = *buf.m_input_buffers[data_field];
+    auto& device_buffer = buf.m_device_input_buffers[data_field];
+    if (device_buffer == nullptr) {
+      device_buffer =
+        std::make_unique<StarVCMatDT<IODataType, El::Device::GPU>>(
+          host_buffer.Grid());
+    }
+    auto& local_device_buffer =
+      dynamic_cast<El::Matrix<IODataType, El::Device::GPU>&>(
+        device_buffer->Matrix());
+    El::SetSyncInfo(local_device_buffer, m_transfer_sync_info);
+    device_buffer->Resize(host_buffer.Height(), host_buffer.Width());
+    auto mini_batch_view =
+      local_device_buffer(El::ALL, El::IR(0, local_mini_batch_size));
+    gather_columns(*samples, device_columns, mini_batch_view);
+    m_device_staged_data_fields.insert(data_field);
+  }
+  buf.m_device_copy_event.record(m_transfer_sync_info.Stream());
+  buf.m_device_buffers_staged = true;
+  buf.m_num_samples_fetched = local_mini_batch_size;
+}
+#endif // LBANN_HAS_GPU
+
 template <typename TensorDataType>
 uint64_t buffered_data_coordinator<TensorDataType>::get_current_mini_batch_size(
   execution_mode mode) const
@@ -256,13 +827,22 @@ void buffered_data_coordinator<TensorDataType>::collect_background_data_fetch(
     if (it != buffer_map.end()) {
       data_buffer<IODataType>& io_buffer = *buffer_map[mode];
       if (io_buffer.is_background_fetching_in_progress()) {
-        io_buffer.get_data_fetch_future().get();
-        io_buffer.set_background_fetching_in_progress(false);
+        wait_for_background_fetch(io_buffer);
       }
     }
   }
 }
 
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::wait_for_background_fetch(
+  data_buffer<IODataType>& buf)
+{
+  EvalType const start_time = get_time();
+  buf.get_data_fetch_future().get();
+  buf.set_background_fetching_in_progress(false);
+  m_pipeline_stats.record_wait(get_time() - start_time);
+}
+
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::fetch_active_batch_synchronous(
   execution_mode mode)
@@ -286,6 +866,7 @@ void buffered_data_coordinator<TensorDataType>::fetch_active_batch_synchronous(
 
     // Start data store exchange if necessary (this should be moved
     // earlier as a future optimization)
+    EvalType const exchange_start = get_time();
     get_data_reader(mode)->start_data_store_mini_batch_exchange(
       // Use the relative position of the mini-batch (adjusted for rank)
       relative_base_position - ds.get_base_offset(),
@@ -293,27 +874,27 @@ void buffered_data_coordinator<TensorDataType>::fetch_active_batch_synchronous(
       ds.at_new_epoch());
     // Finish data store exchange before accessing samples
     get_data_reader(mode)->finish_data_store_mini_batch_exchange();
+    m_pipeline_stats.record_exchange(get_time() - exchange_start);
 
     // Set the size for the I/O buffers
     fp_setup_data(active_buffer, loaded_mini_batch_size);
 
-    std::future<void> background_fetch_done = get_io_thread_pool().submit_job(
-      std::bind(&buffered_data_coordinator::fetch_data_in_background,
-                this,
-                idx,
-                std::ref(active_buffer),
-                loaded_mini_batch_size,
-                relative_base_position,
-                mode));
-    active_buffer.set_data_fetch_future(std::move(background_fetch_done));
-    active_buffer.set_background_fetching_in_progress(true);
+    start_background_fetch(idx,
+                           active_buffer,
+                           loaded_mini_batch_size,
+                           relative_base_position,
+                           mode);
   }
+  m_next_fetch_buffer_idx[mode] =
+    std::max(m_next_fetch_buffer_idx[mode], idx + 1);
 
   // Wait for the background thread to complete fetching the same data
   if (active_buffer.is_background_fetching_in_progress()) {
-    active_buffer.get_data_fetch_future().get();
-    active_buffer.set_background_fetching_in_progress(false);
+    wait_for_background_fetch(active_buffer);
   }
+#if defined(LBANN_HAS_GPU)
+  stage_to_device(active_buffer);
+#endif // LBANN_HAS_GPU
 }
 
 template <typename TensorDataType>
@@ -321,53 +902,83 @@ void buffered_data_coordinator<TensorDataType>::fetch_data_asynchronous(
   execution_mode mode)
 {
   data_buffer<IODataType>& current_buffer = get_active_buffer(mode);
-  data_buffer<IODataType>& next_buffer = get_next_buffer(mode);
-  auto next_buffer_idx = this->get_next_buffer_idx(mode);
-  auto next_buffer_id = next_buffer_idx % m_data_buffers.size();
+  const int active_buffer_idx = this->get_active_buffer_idx(mode);
 
   // Wait for the background thread to complete fetching the data
   if (current_buffer.is_background_fetching_in_progress()) {
-    current_buffer.get_data_fetch_future().get();
-    current_buffer.set_background_fetching_in_progress(false);
+    wait_for_background_fetch(current_buffer);
+  }
+
+#if defined(LBANN_HAS_GPU)
+  // Copy the active mini-batch to the device if that has not happened
+  // yet, then start the copy of the following mini-batch if its fetch
+  // is already complete so that it overlaps this step's compute
+  stage_to_device(current_buffer);
+  data_buffer<IODataType>& following_buffer = get_next_buffer(mode);
+  if (following_buffer.is_background_fetching_in_progress() &&
+      following_buffer.m_data_fetch_future.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready) {
+    following_buffer.get_data_fetch_future().get();
+    following_buffer.set_background_fetching_in_progress(false);
+  }
+  if (!following_buffer.is_background_fetching_in_progress()) {
+    stage_to_device(following_buffer);
   }
+#endif // LBANN_HAS_GPU
 
   dataset& ds = get_dataset(mode);
-  //************************************************************************
-  // Get the next mini-batchs size from the data reader
-  uint64_t next_mini_batch_size = ds.get_next_mini_batch_size();
+  int& next_buffer_idx = m_next_fetch_buffer_idx[mode];
+  next_buffer_idx = std::max(next_buffer_idx, active_buffer_idx + 1);
+  const int last_buffer_idx =
+    active_buffer_idx + static_cast<int>(get_prefetch_depth(mode));
 
-  // If there is no valid data and there is not already a background
-  // thread to fetch the data, queue up the background thread
-  if (next_mini_batch_size > 0 && next_buffer.num_samples_ready() == 0 &&
-      !next_buffer.is_background_fetching_in_progress()) {
-    // Store the size of the current mini-batch so that others can obtain it
-    // without worrying about where the data reader is currently at.
-    m_current_mini_batch_size[next_buffer_id][mode] = next_mini_batch_size;
-    uint64_t relative_base_position = ds.get_next_position();
+  // Keep the ring full: queue a fetch for every buffer between the
+  // active one and the prefetch depth that has not been scheduled
+  // yet.  Fetches are queued in mini-batch order, so they complete
+  // in that order as well.
+  for (; next_buffer_idx <= last_buffer_idx; ++next_buffer_idx) {
+    const uint64_t steps_ahead = next_buffer_idx - active_buffer_idx;
+    const int next_buffer_id = next_buffer_idx % m_data_buffers.size();
+    data_buffer<IODataType>& next_buffer =
+      get_data_buffer(m_data_buffers[next_buffer_id], mode);
+    //************************************************************************
+    // Get the mini-batch size from the data reader (zero past the
+    // end of the epoch)
+    uint64_t next_mini_batch_size = ds.get_mini_batch_size_ahead(steps_ahead);
+    if (next_mini_batch_size == 0) {
+      break;
+    }
 
-    // Start data store exchange if necessary (this should be moved
-    // earlier as a future optimization)
-    get_data_reader(mode)->start_data_store_mini_batch_exchange(
-      // Use the relative position of the mini-batch (adjusted for rank)
-      relative_base_position - ds.get_base_offset(),
-      next_mini_batch_size,
-      ds.at_new_epoch());
-    // Finish data store exchange before accessing samples
-    get_data_reader(mode)->finish_data_store_mini_batch_exchange();
+    // If there is no valid data and there is not already a background
+    // thread to fetch the data, queue up the background thread
+    if (next_buffer.num_samples_ready() == 0 &&
+        !next_buffer.is_background_fetching_in_progress()) {
+      // Store the size of the current mini-batch so that others can obtain it
+      // without worrying about where the data reader is currently at.
+      m_current_mini_batch_size[next_buffer_id][mode] = next_mini_batch_size;
+      uint64_t relative_base_position = ds.get_position_ahead(steps_ahead);
 
-    // Set the size for the I/O buffers
-    fp_setup_data(next_buffer, next_mini_batch_size);
+      // Start data store exchange if necessary (this should be moved
+      // earlier as a future optimization)
+      EvalType const exchange_start = get_time();
+      get_data_reader(mode)->start_data_store_mini_batch_exchange(
+        // Use the relative position of the mini-batch (adjusted for rank)
+        relative_base_position - ds.get_base_offset(),
+        next_mini_batch_size,
+        ds.at_new_epoch());
+      // Finish data store exchange before accessing samples
+      get_data_reader(mode)->finish_data_store_mini_batch_exchange();
+      m_pipeline_stats.record_exchange(get_time() - exchange_start);
 
-    std::future<void> background_fetch_done = get_io_thread_pool().submit_job(
-      std::bind(&buffered_data_coordinator::fetch_data_in_background,
-                this,
-                next_buffer_idx,
-                std::ref(next_buffer),
-                next_mini_batch_size,
-                relative_base_position,
-                mode));
-    next_buffer.set_data_fetch_future(std::move(background_fetch_done));
-    next_buffer.set_background_fetching_in_progress(true);
+      // Set the size for the I/O buffers
+      fp_setup_data(next_buffer, next_mini_batch_size);
+
+      start_background_fetch(next_buffer_idx,
+                             next_buffer,
+                             next_mini_batch_size,
+                             relative_base_position,
+                             mode);
+    }
   }
 }
 
@@ -389,23 +1000,104 @@ bool buffered_data_coordinator<TensorDataType>::ready_for_next_fetch(
                     " available");
     }
   }
+  count_effective_tokens(mode, active_buffer);
   active_buffer.m_num_samples_fetched = 0;
+#if defined(LBANN_HAS_GPU)
+  active_buffer.m_device_buffers_staged = false;
+#endif // LBANN_HAS_GPU
 
   // Make sure to update the data reader before incrementing the
   // buffer index
   auto is_epoch_complete = this->update_data_reader(mode);
   if (is_epoch_complete) {
+    report_effective_tokens(mode);
     // Wait for the background thread to complete fetching the same data
     if (active_buffer.is_background_fetching_in_progress()) {
       LBANN_WARNING("ready_for_next_fetch has to wait for the data.");
-      active_buffer.get_data_fetch_future().get();
-      active_buffer.set_background_fetching_in_progress(false);
+      wait_for_background_fetch(active_buffer);
     }
   }
+  m_pipeline_stats.end_step(mode);
+  if (is_epoch_complete) {
+    m_pipeline_stats.end_epoch(mode);
+  }
   this->increment_active_buffer_idx(mode);
   return is_epoch_complete;
 }
 
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::print_state(
+  std::ostream& os) const
+{
+  data_coordinator::print_state(os);
+  for (const auto& [mode, ds] : this->m_datasets) {
+    if (!ds.initialized() || m_data_buffers.empty()) {
+      continue;
+    }
+    const int active = get_active_buffer_idx(mode);
+    os << "  " << to_string(mode) << " buffers: active "
+       << active % m_data_buffers.size() << " of " << m_data_buffers.size()
+       << ", fetching in background:";
+    for (const auto& buffer_map : m_data_buffers) {
+      auto it = buffer_map.find(mode);
+      const bool fetching =
+        (it != buffer_map.end() && it->second != nullptr &&
+         it->second->is_background_fetching_in_progress());
+      os << (fetching ? " yes" : " no");
+    }
+    os << "\n";
+  }
+}
+
+template <typename TensorDataType>
+uint64_t buffered_data_coordinator<TensorDataType>::get_num_effective_tokens(
+  execution_mode mode) const
+{
+  auto it = m_num_effective_tokens.find(mode);
+  return (it != m_num_effective_tokens.end() ? it->second : 0);
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::count_effective_tokens(
+  execution_mode mode,
+  const data_buffer<IODataType>& buf)
+{
+  const generic_data_reader* dr = get_data_reader(mode);
+  if (dr == nullptr || !dr->has_variable_length_samples()) {
+    return;
+  }
+  uint64_t num_tokens = 0;
+  for (uint64_t i = 0; i < buf.m_num_samples_fetched; ++i) {
+    num_tokens += dr->get_sample_length(buf.m_indices_fetched_per_mb.Get(i, 0));
+  }
+  m_num_effective_tokens[mode] = num_tokens;
+  m_epoch_effective_tokens[mode] += num_tokens;
+  m_epoch_total_tokens[mode] +=
+    buf.m_num_samples_fetched * dr->get_linearized_data_size();
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::report_effective_tokens(
+  execution_mode mode)
+{
+  const generic_data_reader* dr = get_data_reader(mode);
+  if (dr == nullptr || !dr->has_variable_length_samples()) {
+    return;
+  }
+  const uint64_t num_effective =
+    m_comm->trainer_allreduce(m_epoch_effective_tokens[mode]);
+  const uint64_t num_total =
+    m_comm->trainer_allreduce(m_epoch_total_tokens[mode]);
+  m_epoch_effective_tokens[mode] = 0;
+  m_epoch_total_tokens[mode] = 0;
+  if (m_comm->am_trainer_master() && num_total > 0) {
+    const double padding = 100. * (num_total - num_effective) / num_total;
+    std::cout << "Role: " << dr->get_role() << " consumed " << num_effective
+              << " effective tokens of " << num_total << " (" << padding
+              << "% padding) this epoch" << std::endl;
+  }
+}
+
 template <typename TensorDataType>
 bool buffered_data_coordinator<TensorDataType>::update_data_reader(
   execution_mode mode)
@@ -550,13 +1242,87 @@ void buffered_data_coordinator<TensorDataType>::distribute_from_local_matrix(
   // Wait for the background thread to complete fetching the same data
   if (buf.is_background_fetching_in_progress()) {
     LBANN_WARNING("distribute from local matrix has to wait for the data.");
-    buf.get_data_fetch_future().get();
-    buf.set_background_fetching_in_progress(false);
+    wait_for_background_fetch(buf);
   }
   if (buf.m_input_buffers.find(data_field) == buf.m_input_buffers.end()) {
     LBANN_ERROR("Unknown data_field_type value requested: " + data_field);
   }
+  generic_data_reader* const dr = get_data_reader(mode);
+  if (dr->generates_data_on_device()) {
+#if defined(LBANN_HAS_GPU)
+    if (input_buffer.GetLocalDevice() != El::Device::GPU) {
+      LBANN_ERROR("Synthetic data generated on the device requires input "
+                  "layers on the GPU");
+    }
+    auto const& host_buffer = *buf.m_input_buffers[data_field];
+    input_buffer.Resize(host_buffer.Height(), host_buffer.Width());
+    const uint64_t seed =
+      hash_combine(hash_combine(std::hash<data_field_type>{}(data_field),
+                                m_num_synthetic_fields_generated++),
+                   m_comm->get_rank_in_world());
+    generate_synthetic_columns(
+      data_field == INPUT_DATA_TYPE_LABELS ? dr->get_num_labels() : 0,
+      seed,
+      static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
+        input_buffer.Matrix()));
+#else
+    LBANN_ERROR("Synthetic data generated on the device requires a GPU build");
+#endif // LBANN_HAS_GPU
+    buf.m_num_samples_per_field_distributed[data_field] =
+      buf.m_num_samples_fetched;
+    prof_region_end(prof_title.c_str(), false);
+    return;
+  }
+#if defined(LBANN_HAS_GPU)
+  bool copied_from_device = false;
+  if (m_device_resident_data &&
+      input_buffer.GetLocalDevice() != El::Device::GPU) {
+    LBANN_ERROR("Device-resident input data requires input layers on the GPU");
+  }
+  if (input_buffer.GetLocalDevice() == El::Device::GPU) {
+    // Subsequent mini-batches of this field are staged on the
+    // transfer stream ahead of time
+    m_device_staged_data_fields.insert(data_field);
+    auto device_it = buf.m_device_input_buffers.find(data_field);
+    if (buf.m_device_buffers_staged &&
+        device_it != buf.m_device_input_buffers.end()) {
+      auto& device_buffer = *device_it->second;
+      auto compute_sync_info = gpu::get_sync_info(input_buffer);
+      buf.m_device_copy_event.wait(compute_sync_info.Stream());
+      // The compute stream now owns the staged data
+      El::SetSyncInfo(
+        dynamic_cast<El::Matrix<IODataType, El::Device::GPU>&>(
+          device_buffer.Matrix()),
+        compute_sync_info);
+      El::Copy(device_buffer, input_buffer);
+      buf.m_device_release_event.record(compute_sync_info.Stream());
+      copied_from_device = true;
+    }
+  }
+  if (!copied_from_device) {
+    view_or_copy_tensor(*buf.m_input_buffers[data_field], input_buffer, false);
+  }
+  auto& pipeline = get_data_reader(mode)->get_transform_pipeline();
+  if (data_field == INPUT_DATA_TYPE_SAMPLES &&
+      pipeline.has_device_transforms()) {
+    // The deferred transforms run on the compute stream, in the input
+    // layer's own copy of the mini-batch
+    if (input_buffer.GetLocalDevice() != El::Device::GPU) {
+      LBANN_ERROR("Device transforms require input layers on the GPU");
+    }
+    if constexpr (std::is_same_v<TensorDataType, DataType>) {
+      auto const& data_dims = get_data_reader(mode)->get_data_dims();
+      pipeline.apply_on_device(
+        static_cast<GPUMat&>(input_buffer.Matrix()),
+        std::vector<size_t>(data_dims.begin(), data_dims.end()));
+    }
+    else {
+      LBANN_ERROR("Device transforms require input layers to use DataType");
+    }
+  }
+#else
   view_or_copy_tensor(*buf.m_input_buffers[data_field], input_buffer, false);
+#endif // LBANN_HAS_GPU
 #ifdef LBANN_HAS_DISTCONV
   if (dc::is_cosmoflow_parallel_io_enabled() &&
       data_field == INPUT_DATA_TYPE_RESPONSES) {
@@ -0,0 +1,337 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_ingestion/coordinator/buffered_data_coordinator.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/hash.hpp"
+
+namespace lbann {
+
+namespace {
+
+/**
+ *  Block dimensions: bsizex x bsizey x 1
+ *
+ *  Grid dimensions: (height / bsizex) x (width / bsizey) x 1
+ */
+template <typename TensorDataType>
+__global__ void gather_columns_kernel(El::Int height,
+                                      El::Int width,
+                                      const TensorDataType* __restrict__ src,
+                                      El::Int src_ldim,
+                                      const El::Int* __restrict__ indices,
+                                      TensorDataType* __restrict__ dst,
+                                      El::Int dst_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  for (El::Int col = gidy; col < width; col += nthreadsy) {
+    const auto& src_col = indices[col];
+    for (El::Int row = gidx; row < height; row += nthreadsx) {
+      dst[row + col * dst_ldim] = src[row + src_col * src_ldim];
+    }
+  }
+}
+
+/** Widen one packed entry to float */
+template <input_transfer_type Type>
+__device__ __forceinline__ float unpack_entry(const El::byte* src,
+                                              El::Int i,
+                                              float scale);
+
+#ifdef LBANN_HAS_GPU_FP16
+template <>
+__device__ __forceinline__ float
+unpack_entry<input_transfer_type::fp16>(const El::byte* src,
+                                        El::Int i,
+                                        float scale)
+{
+  return static_cast<float>(reinterpret_cast<const fp16*>(src)[i]);
+}
+#endif // LBANN_HAS_GPU_FP16
+
+template <>
+__device__ __forceinline__ float
+unpack_entry<input_transfer_type::bf16>(const El::byte* src,
+                                        El::Int i,
+                                        float scale)
+{
+  const uint32_t bits = reinterpret_cast<const uint16_t*>(src)[i];
+  return __uint_as_float(bits << 16);
+}
+
+template <>
+__device__ __forceinline__ float
+unpack_entry<input_transfer_type::uint8>(const El::byte* src,
+                                         El::Int i,
+                                         float scale)
+{
+  return static_cast<float>(reinterpret_cast<const uint8_t*>(src)[i]) * scale;
+}
+
+/**
+ *  Block dimensions: bsizex x bsizey x 1
+ *
+ *  Grid dimensions: (height / bsizex) x (width / bsizey) x 1
+ */
+template <input_transfer_type Type, typename TensorDataType>
+__global__ void unpack_columns_kernel(El::Int height,
+                                      El::Int width,
+                                      float scale,
+                                      const El::byte* __restrict__ src,
+                                      TensorDataType* __restrict__ dst,
+                                      El::Int dst_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  for (El::Int col = gidy; col < width; col += nthreadsy) {
+    for (El::Int row = gidx; row < height; row += nthreadsx) {
+      const float x = unpack_entry<Type>(src, row + col * height, scale);
+      dst[row + col * dst_ldim] = TensorDataType(x);
+    }
+  }
+}
+
+template <input_transfer_type Type, typename TensorDataType>
+void launch_unpack_columns(float scale,
+                           El::byte const* src,
+                           El::Matrix<TensorDataType, El::Device::GPU>& dst)
+{
+  const El::Int height = dst.Height();
+  const El::Int width = dst.Width();
+  constexpr size_t block_size_x = 256;
+  constexpr size_t block_size_y = 1;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size_x;
+  block_dims.y = block_size_y;
+  grid_dims.x = (height + block_size_x - 1) / block_size_x;
+  grid_dims.y = (width + block_size_y - 1) / block_size_y;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(unpack_columns_kernel<Type, TensorDataType>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              gpu::get_sync_info(dst),
+                              height,
+                              width,
+                              scale,
+                              src,
+                              dst.Buffer(),
+                              dst.LDim());
+}
+
+/** Uniform float in (0,1] from the upper 24 bits of a hash */
+__device__ __forceinline__ float to_unit_float(uint64_t bits)
+{
+  return (static_cast<float>(bits >> 40) + 1.f) * (1.f / 16777216.f);
+}
+
+/**
+ *  Block dimensions: bsizex x bsizey x 1
+ *
+ *  Grid dimensions: (height / bsizex) x (width / bsizey) x 1
+ */
+template <typename TensorDataType>
+__global__ void generate_normal_kernel(El::Int height,
+                                       El::Int width,
+                                       uint64_t seed,
+                                       TensorDataType* __restrict__ dst,
+                                       El::Int dst_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  for (El::Int col = gidy; col < width; col += nthreadsy) {
+    for (El::Int row = gidx; row < height; row += nthreadsx) {
+      // Box-Muller transform of two hashed uniforms
+      const uint64_t bits = splitmix64(seed + row + col * height);
+      const float u1 = to_unit_float(bits);
+      const float u2 = to_unit_float(splitmix64(bits));
+      const float x = sqrtf(-2.f * logf(u1)) * cospif(2.f * u2);
+      dst[row + col * dst_ldim] = TensorDataType(x);
+    }
+  }
+}
+
+/**
+ *  Block dimensions: bsizex x bsizey x 1
+ *
+ *  Grid dimensions: (height / bsizex) x (width / bsizey) x 1
+ */
+template <typename TensorDataType>
+__global__ void generate_one_hot_kernel(El::Int height,
+                                        El::Int width,
+                                        El::Int num_labels,
+                                        uint64_t seed,
+                                        TensorDataType* __restrict__ dst,
+                                        El::Int dst_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  for (El::Int col = gidy; col < width; col += nthreadsy) {
+    const El::Int label = splitmix64(seed + col) % num_labels;
+    for (El::Int row = gidx; row < height; row += nthreadsx) {
+      dst[row + col * dst_ldim] =
+        (row == label) ? TensorDataType(1.f) : TensorDataType(0.f);
+    }
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void generate_synthetic_columns(
+  El::Int num_labels,
+  uint64_t seed,
+  El::Matrix<TensorDataType, El::Device::GPU>& dst)
+{
+  const El::Int height = dst.Height();
+  const El::Int width = dst.Width();
+  if (height <= 0 || width <= 0) {
+    return;
+  }
+  constexpr size_t block_size_x = 256;
+  constexpr size_t block_size_y = 1;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size_x;
+  block_dims.y = block_size_y;
+  grid_dims.x = (height + block_size_x - 1) / block_size_x;
+  grid_dims.y = (width + block_size_y - 1) / block_size_y;
+  gpu_lib::clip_grid_dims(grid_dims);
+  if (num_labels > 0) {
+    hydrogen::gpu::LaunchKernel(generate_one_hot_kernel<TensorDataType>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                gpu::get_sync_info(dst),
+                                height,
+                                width,
+                                std::min(num_labels, height),
+                                seed,
+                                dst.Buffer(),
+                                dst.LDim());
+  }
+  else {
+    hydrogen::gpu::LaunchKernel(generate_normal_kernel<TensorDataType>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                gpu::get_sync_info(dst),
+                                height,
+                                width,
+                                seed,
+                                dst.Buffer(),
+                                dst.LDim());
+  }
+}
+
+template <typename TensorDataType>
+void unpack_columns(input_transfer_type type,
+                    float scale,
+                    El::byte const* src,
+                    El::Matrix<TensorDataType, El::Device::GPU>& dst)
+{
+  if (dst.Height() <= 0 || dst.Width() <= 0) {
+    return;
+  }
+  switch (type) {
+  case input_transfer_type::fp16:
+#ifdef LBANN_HAS_GPU_FP16
+    launch_unpack_columns<input_transfer_type::fp16>(scale, src, dst);
+#else
+    LBANN_ERROR("fp16 input transfers require a build with half support");
+#endif // LBANN_HAS_GPU_FP16
+    break;
+  case input_transfer_type::bf16:
+    launch_unpack_columns<input_transfer_type::bf16>(scale, src, dst);
+    break;
+  case input_transfer_type::uint8:
+    launch_unpack_columns<input_transfer_type::uint8>(scale, src, dst);
+    break;
+  default:
+    LBANN_ERROR("Invalid input transfer type");
+  }
+}
+
+template <typename TensorDataType>
+void gather_columns(El::Matrix<TensorDataType, El::Device::GPU> const& src,
+                    El::Matrix<El::Int, El::Device::GPU> const& indices,
+                    El::Matrix<TensorDataType, El::Device::GPU>& dst)
+{
+  const El::Int height = dst.Height();
+  const El::Int width = dst.Width();
+  if (height <= 0 || width <= 0) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(dst),
+                                     gpu::get_sync_info(src),
+                                     gpu::get_sync_info(indices));
+  constexpr size_t block_size_x = 256;
+  constexpr size_t block_size_y = 1;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size_x;
+  block_dims.y = block_size_y;
+  grid_dims.x = (height + block_size_x - 1) / block_size_x;
+  grid_dims.y = (width + block_size_y - 1) / block_size_y;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(gather_columns_kernel<TensorDataType>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              height,
+                              width,
+                              src.LockedBuffer(),
+                              src.LDim(),
+                              indices.LockedBuffer(),
+                              dst.Buffer(),
+                              dst.LDim());
+}
+
+#define PROTO(T)                                                               \
+  template void gather_columns<T>(                                             \
+    El::Matrix<T, El::Device::GPU> const&,                                     \
+    El::Matrix<El::Int, El::Device::GPU> const&,                               \
+    El::Matrix<T, El::Device::GPU>&);                                          \
+  template void unpack_columns<T>(input_transfer_type,                         \
+                                  float,                                       \
+                                  El::byte const*,                             \
+                                  El::Matrix<T, El::Device::GPU>&);            \
+  template void generate_synthetic_columns<T>(El::Int,                         \
+                                              uint64_t,                        \
+                                              El::Matrix<T, El::Device::GPU>&)
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
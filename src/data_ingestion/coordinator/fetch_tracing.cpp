@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_ingestion/coordinator/fetch_tracing.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace lbann {
+namespace {
+
+std::atomic<bool> fetch_tracing{false};
+std::mutex fetch_mutex;
+std::vector<fetch_record> fetch_records;
+std::map<std::thread::id, int> fetch_threads;
+
+} // namespace
+
+void set_fetch_tracing(bool enable) { fetch_tracing = enable; }
+
+std::vector<fetch_record> take_fetch_records()
+{
+  std::lock_guard<std::mutex> lock(fetch_mutex);
+  return std::exchange(fetch_records, {});
+}
+
+void record_fetch(int buffer, EvalType start_time)
+{
+  if (!fetch_tracing) {
+    return;
+  }
+  EvalType const now = get_time();
+  std::lock_guard<std::mutex> lock(fetch_mutex);
+  int const next = static_cast<int>(fetch_threads.size());
+  int const thread =
+    fetch_threads.emplace(std::this_thread::get_id(), next).first->second;
+  fetch_records.push_back({thread, buffer, start_time, now});
+}
+
+} // namespace lbann
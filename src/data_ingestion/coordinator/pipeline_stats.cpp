@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_ingestion/coordinator/pipeline_stats.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace lbann {
+namespace {
+
+/** Add the times of @c src to @c dst. */
+void accumulate(data_pipeline_times& dst, data_pipeline_times const& src)
+{
+  dst.wait_time += src.wait_time;
+  dst.exchange_time += src.exchange_time;
+  dst.step_time += src.step_time;
+  if (dst.io_busy_time.size() < src.io_busy_time.size()) {
+    dst.io_busy_time.resize(src.io_busy_time.size(), 0.);
+  }
+  for (size_t i = 0; i < src.io_busy_time.size(); ++i) {
+    dst.io_busy_time[i] += src.io_busy_time[i];
+  }
+  dst.num_steps += src.num_steps;
+}
+
+/** Nearest-rank quantile of sorted values. */
+EvalType quantile(std::vector<EvalType> const& sorted, double q)
+{
+  size_t const rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+} // namespace
+
+EvalType data_pipeline_times::io_idle_time(size_t i) const
+{
+  EvalType const busy = i < io_busy_time.size() ? io_busy_time[i] : 0.;
+  return std::max(step_time - busy, EvalType(0.));
+}
+
+void data_pipeline_stats::record_wait(EvalType seconds)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_step.wait_time += seconds;
+}
+
+void data_pipeline_stats::record_exchange(EvalType seconds)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_step.exchange_time += seconds;
+}
+
+void data_pipeline_stats::record_fetch(execution_mode mode,
+                                       EvalType start_time,
+                                       EvalType end_time)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t const thread = get_thread_index();
+  if (m_step.io_busy_time.size() <= thread) {
+    m_step.io_busy_time.resize(thread + 1, 0.);
+  }
+  m_step.io_busy_time[thread] += end_time - start_time;
+  m_latencies[mode].push_back(end_time - start_time);
+}
+
+void data_pipeline_stats::end_step(execution_mode mode)
+{
+  EvalType const now = get_time();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // The first step has no previous end to measure from
+  m_step.step_time = m_step_start > 0. ? now - m_step_start : 0.;
+  m_step.io_busy_time.resize(m_threads.size(), 0.);
+  m_step.num_steps = 1;
+  m_step_start = now;
+  accumulate(m_epoch[mode], m_step);
+  m_last_step = std::exchange(m_step, {});
+}
+
+void data_pipeline_stats::end_epoch(execution_mode mode)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_last_epoch[mode] = std::exchange(m_epoch[mode], {});
+
+  auto latencies = std::exchange(m_latencies[mode], {});
+  fetch_latency_summary summary;
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    summary.count = latencies.size();
+    summary.mean =
+      std::accumulate(latencies.begin(), latencies.end(), EvalType(0.)) /
+      latencies.size();
+    summary.p50 = quantile(latencies, 0.5);
+    summary.p90 = quantile(latencies, 0.9);
+    summary.p99 = quantile(latencies, 0.99);
+    summary.max = latencies.back();
+  }
+  m_last_latency[mode] = summary;
+}
+
+data_pipeline_times
+data_pipeline_stats::get_last_epoch(execution_mode mode) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto const it = m_last_epoch.find(mode);
+  return it != m_last_epoch.end() ? it->second : data_pipeline_times{};
+}
+
+fetch_latency_summary
+data_pipeline_stats::get_fetch_latency(execution_mode mode) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto const it = m_last_latency.find(mode);
+  return it != m_last_latency.end() ? it->second : fetch_latency_summary{};
+}
+
+size_t data_pipeline_stats::get_thread_index()
+{
+  size_t const next = m_threads.size();
+  return m_threads.emplace(std::this_thread::get_id(), next).first->second;
+}
+
+} // namespace lbann
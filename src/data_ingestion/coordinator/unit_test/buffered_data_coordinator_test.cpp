@@ -264,3 +264,115 @@ TEST_CASE("Buffered data coordinator test", "[io][data_coordinator][sync]")
     CHECK(data == readers[mode]->get_num_data());
   }
 }
+
+TEST_CASE("Buffered data coordinator prefetch ring test",
+          "[io][data_coordinator][async]")
+{
+  constexpr uint64_t mini_batch_size = 2;
+  constexpr uint64_t num_mini_batches = 7;
+  constexpr size_t num_io_buffers = 4;
+  constexpr auto mode = lbann::execution_mode::training;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  lbann::init_random(0, 2);
+  lbann::init_data_seq_random(42);
+  auto io_thread_pool = std::make_unique<lbann::thread_pool>();
+  io_thread_pool->launch_threads(2);
+
+  std::map<lbann::execution_mode, lbann::generic_data_reader*> readers;
+  readers[mode] = new test_data_reader(num_mini_batches, mini_batch_size);
+  readers[mode]->setup(io_thread_pool->get_num_threads(), io_thread_pool.get());
+  readers[mode]->set_comm(&world_comm);
+  readers[mode]->load();
+  lbann::buffered_data_coordinator<lbann::DataType> bdc(&world_comm);
+  REQUIRE_NOTHROW(bdc.set_num_io_buffers(num_io_buffers));
+  CHECK(bdc.get_num_io_buffers() == num_io_buffers);
+
+  bdc.setup(*io_thread_pool, mini_batch_size, readers);
+  REQUIRE_NOTHROW(bdc.register_active_data_field("samples", {1}));
+  REQUIRE_NOTHROW(bdc.setup_data_fields(mini_batch_size));
+
+  // The ring cannot be resized once data fields are registered
+  CHECK_THROWS(bdc.set_num_io_buffers(num_io_buffers + 1));
+
+  auto samples = El::DistMatrix<lbann::DataType,
+                                El::STAR,
+                                El::STAR,
+                                El::ELEMENT,
+                                El::Device::CPU>(mini_batch_size,
+                                                 1,
+                                                 world_comm.get_trainer_grid());
+
+  // Batches must be handed out in order even with several in flight
+  uint64_t data = 0;
+  bool epoch_done = false;
+  REQUIRE_NOTHROW(bdc.fetch_active_batch_synchronous(mode));
+  while (!epoch_done) {
+    REQUIRE_NOTHROW(bdc.fetch_data_asynchronous(mode));
+    REQUIRE_NOTHROW(bdc.distribute_from_local_matrix(mode, "samples", samples));
+    REQUIRE_NOTHROW(epoch_done = bdc.ready_for_next_fetch(mode));
+    auto current_mini_batch_size = epoch_done ? 1 : mini_batch_size;
+    CHECK((uint64_t)samples.Width() == current_mini_batch_size);
+    for (uint64_t i = 0; i < current_mini_batch_size; ++i) {
+      CHECK(samples.LockedMatrix()(0, i) == data);
+      ++data;
+    }
+  }
+  CHECK(data == readers[mode]->get_num_data());
+}
+
+#if defined(LBANN_HAS_GPU)
+TEST_CASE("Buffered data coordinator device staging test",
+          "[io][data_coordinator][async][gpu]")
+{
+  constexpr uint64_t mini_batch_size = 2;
+  constexpr uint64_t num_mini_batches = 7;
+  constexpr size_t num_io_buffers = 2;
+  constexpr auto mode = lbann::execution_mode::training;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  lbann::init_random(0, 2);
+  lbann::init_data_seq_random(42);
+  auto io_thread_pool = std::make_unique<lbann::thread_pool>();
+  io_thread_pool->launch_threads(2);
+
+  std::map<lbann::execution_mode, lbann::generic_data_reader*> readers;
+  readers[mode] = new test_data_reader(num_mini_batches, mini_batch_size);
+  readers[mode]->setup(io_thread_pool->get_num_threads(), io_thread_pool.get());
+  readers[mode]->set_comm(&world_comm);
+  readers[mode]->load();
+  lbann::buffered_data_coordinator<lbann::DataType> bdc(&world_comm);
+  REQUIRE_NOTHROW(bdc.set_num_io_buffers(num_io_buffers));
+  bdc.setup(*io_thread_pool, mini_batch_size, readers);
+  REQUIRE_NOTHROW(bdc.register_active_data_field("samples", {1}));
+  REQUIRE_NOTHROW(bdc.setup_data_fields(mini_batch_size));
+
+  auto samples = El::DistMatrix<lbann::DataType,
+                                El::STAR,
+                                El::STAR,
+                                El::ELEMENT,
+                                El::Device::GPU>(mini_batch_size,
+                                                 1,
+                                                 world_comm.get_trainer_grid());
+
+  // With only two buffers every staged buffer is refilled by the
+  // background fetch while its device copy may still be in flight
+  uint64_t data = 0;
+  bool epoch_done = false;
+  REQUIRE_NOTHROW(bdc.fetch_active_batch_synchronous(mode));
+  while (!epoch_done) {
+    REQUIRE_NOTHROW(bdc.fetch_data_asynchronous(mode));
+    REQUIRE_NOTHROW(bdc.distribute_from_local_matrix(mode, "samples", samples));
+    REQUIRE_NOTHROW(epoch_done = bdc.ready_for_next_fetch(mode));
+    El::Matrix<lbann::DataType, El::Device::CPU> host_samples;
+    El::Copy(samples.LockedMatrix(), host_samples);
+    auto current_mini_batch_size = epoch_done ? 1 : mini_batch_size;
+    CHECK((uint64_t)host_samples.Width() == current_mini_batch_size);
+    for (uint64_t i = 0; i < current_mini_batch_size; ++i) {
+      CHECK(host_samples(0, i) == data);
+      ++data;
+    }
+  }
+  CHECK(data == readers[mode]->get_num_data());
+}
+#endif // LBANN_HAS_GPU
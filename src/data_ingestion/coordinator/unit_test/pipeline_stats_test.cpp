@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/data_ingestion/coordinator/pipeline_stats.hpp"
+
+#include <thread>
+
+TEST_CASE("Data pipeline stall statistics", "[data_coordinator][profiling]")
+{
+  using lbann::execution_mode;
+  lbann::data_pipeline_stats stats;
+
+  SECTION("Waits and exchanges are attributed to the closed step")
+  {
+    stats.record_wait(0.25);
+    stats.record_wait(0.5);
+    stats.record_exchange(0.125);
+    stats.end_step(execution_mode::training);
+    CHECK(stats.get_last_step().wait_time == 0.75);
+    CHECK(stats.get_last_step().exchange_time == 0.125);
+    CHECK(stats.get_last_step().num_steps == 1);
+
+    stats.end_step(execution_mode::training);
+    CHECK(stats.get_last_step().wait_time == 0.);
+    CHECK(stats.get_last_step().step_time >= 0.);
+  }
+
+  SECTION("I/O threads are numbered in order of first use")
+  {
+    stats.record_fetch(execution_mode::training, 1., 3.);
+    std::thread other([&stats]() {
+      stats.record_fetch(execution_mode::training, 2., 3.);
+    });
+    other.join();
+    stats.record_fetch(execution_mode::training, 3., 4.);
+    stats.end_step(execution_mode::training);
+    const auto& step = stats.get_last_step();
+    REQUIRE(step.io_busy_time.size() == 2);
+    CHECK(step.io_busy_time[0] == 3.);
+    CHECK(step.io_busy_time[1] == 1.);
+    CHECK(step.io_idle_time(0) == 0.);
+  }
+
+  SECTION("Epochs sum their steps and summarize fetch latencies")
+  {
+    for (int i = 1; i <= 100; ++i) {
+      stats.record_wait(1.);
+      stats.record_fetch(execution_mode::training, 0., 0.01 * i);
+      stats.end_step(execution_mode::training);
+    }
+    stats.record_fetch(execution_mode::validation, 0., 5.);
+    stats.end_epoch(execution_mode::training);
+
+    const auto epoch = stats.get_last_epoch(execution_mode::training);
+    CHECK(epoch.num_steps == 100);
+    CHECK(epoch.wait_time == 100.);
+
+    const auto latency = stats.get_fetch_latency(execution_mode::training);
+    CHECK(latency.count == 100);
+    CHECK(latency.p50 == Approx(0.5));
+    CHECK(latency.p90 == Approx(0.9));
+    CHECK(latency.p99 == Approx(0.99));
+    CHECK(latency.max == Approx(1.));
+    CHECK(latency.mean == Approx(0.505));
+
+    // A new epoch starts empty
+    stats.end_epoch(execution_mode::training);
+    CHECK(stats.get_last_epoch(execution_mode::training).num_steps == 0);
+    CHECK(stats.get_fetch_latency(execution_mode::training).count == 0);
+  }
+}
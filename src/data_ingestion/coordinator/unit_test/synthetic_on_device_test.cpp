@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include "lbann/data_ingestion/coordinator/buffered_data_coordinator.hpp"
+#include "lbann/data_ingestion/readers/data_reader_synthetic.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using DeviceMat = El::Matrix<float, El::Device::GPU>;
+
+/** Column-major copy of a device matrix */
+std::vector<float> to_host(DeviceMat const& mat)
+{
+  El::Matrix<float, El::Device::CPU> host;
+  El::Copy(mat, host);
+  std::vector<float> values;
+  for (El::Int j = 0; j < host.Width(); ++j) {
+    for (El::Int i = 0; i < host.Height(); ++i) {
+      values.push_back(host(i, j));
+    }
+  }
+  return values;
+}
+
+std::vector<float> generate(El::Int height,
+                            El::Int width,
+                            El::Int num_labels,
+                            uint64_t seed)
+{
+  DeviceMat mat(height, width);
+  lbann::generate_synthetic_columns(num_labels, seed, mat);
+  return to_host(mat);
+}
+
+} // namespace
+
+TEST_CASE("Device-generated synthetic data",
+          "[mpi][data_coordinator][synthetic]")
+{
+  SECTION("Only generates on the device when asked")
+  {
+    lbann::data_reader_synthetic dr(16, {3, 4}, 10, false);
+    CHECK_FALSE(dr.generates_data_on_device());
+    dr.set_generate_on_device(true);
+    CHECK(dr.generates_data_on_device());
+  }
+
+  SECTION("Samples are standard normal")
+  {
+    const El::Int height = 64;
+    const El::Int width = 256;
+    auto const values = generate(height, width, 0, 17);
+    double sum = 0, sqsum = 0;
+    for (auto const& v : values) {
+      REQUIRE(std::isfinite(v));
+      sum += v;
+      sqsum += v * v;
+    }
+    const double n = values.size();
+    const double mean = sum / n;
+    const double var = sqsum / n - mean * mean;
+    // 16384 samples, so the moments are within a few percent
+    CHECK(mean == Approx(0.).margin(0.05));
+    CHECK(var == Approx(1.).margin(0.05));
+  }
+
+  SECTION("Labels are one-hot")
+  {
+    const El::Int height = 12;
+    const El::Int width = 100;
+    const El::Int num_labels = 10;
+    auto const values = generate(height, width, num_labels, 5);
+    std::vector<int> counts(height, 0);
+    for (El::Int j = 0; j < width; ++j) {
+      int num_hot = 0;
+      for (El::Int i = 0; i < height; ++i) {
+        const auto v = values[i + j * height];
+        CHECK((v == 0.f || v == 1.f));
+        if (v == 1.f) {
+          ++num_hot;
+          ++counts[i];
+        }
+      }
+      CHECK(num_hot == 1);
+    }
+    // Only the first num_labels rows are used, and more than one of
+    // them
+    CHECK(counts[10] == 0);
+    CHECK(counts[11] == 0);
+    int num_used = 0;
+    for (El::Int i = 0; i < num_labels; ++i) {
+      num_used += (counts[i] > 0 ? 1 : 0);
+    }
+    CHECK(num_used > 1);
+  }
+
+  SECTION("Samples depend only on the seed")
+  {
+    auto const first = generate(32, 8, 0, 42);
+    auto const second = generate(32, 8, 0, 42);
+    auto const other = generate(32, 8, 0, 43);
+    CHECK(first == second);
+    CHECK(first != other);
+  }
+}
@@ -34,6 +34,8 @@
 #include <lbann/utils/distconv.hpp>
 #include <lbann/utils/serialize.hpp>
 
+#include <ostream>
+
 namespace lbann {
 
 data_coordinator::~data_coordinator()
@@ -559,6 +561,23 @@ data_coordinator::get_current_mini_batch_size(execution_mode mode) const
   return (dataset.initialized()) ? dataset.get_current_mini_batch_size() : 0;
 }
 
+void data_coordinator::print_state(std::ostream& os) const
+{
+  for (const auto& [mode, ds] : m_datasets) {
+    if (!ds.initialized()) {
+      continue;
+    }
+    os << "  " << to_string(mode) << ": step "
+       << ds.get_current_step_in_epoch() << " of "
+       << ds.get_num_iterations_per_epoch() << " in epoch, position "
+       << ds.get_position() << " of " << ds.get_total_samples() << ", "
+       << ds.get_num_samples_processed() << " samples processed\n";
+  }
+  const auto& last_step = m_pipeline_stats.get_last_step();
+  os << "  last step: " << last_step.step_time << " s, "
+     << last_step.wait_time << " s waiting for data\n";
+}
+
 // save state of IO to a checkpoint
 bool data_coordinator::save_to_checkpoint_shared(persist& p) const
 {
@@ -35,14 +35,18 @@
 #include "lbann/io/persist.hpp"
 #include "lbann/io/persist_impl.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 #include "lbann/utils/timer.hpp"
 
 #include "conduit/conduit_node.hpp"
 
+#include <algorithm>
 #include <future>
+#include <map>
 #include <omp.h>
+#include <random>
 
 namespace lbann {
 
@@ -60,7 +64,9 @@ generic_data_reader::~generic_data_reader()
 template <class Archive>
 void generic_data_reader::serialize(Archive& ar)
 {
-  ar(CEREAL_NVP(m_shuffled_indices), CEREAL_NVP(m_supported_input_types));
+  ar(CEREAL_NVP(m_shuffled_indices),
+     CEREAL_NVP(m_supported_input_types),
+     CEREAL_NVP(m_epoch));
 }
 
 void generic_data_reader::shuffle_indices()
@@ -72,8 +78,98 @@ void generic_data_reader::shuffle_indices(rng_gen& gen)
 {
   // Shuffle the data
   if (m_shuffle) {
-    std::shuffle(m_shuffled_indices.begin(), m_shuffled_indices.end(), gen);
+    auto& arg_parser = global_argument_parser();
+    const double locality =
+      arg_parser.get<float>(LBANN_OPTION_DATA_STORE_SHUFFLE_LOCALITY);
+    if (locality > 0. && m_data_store != nullptr &&
+        m_data_store->has_owner_map()) {
+      const uint64_t num_remote = block_local_shuffle_indices(gen, locality);
+      if (m_comm != nullptr && m_comm->am_world_master()) {
+        const uint64_t n = m_shuffled_indices.size();
+        const int np = m_comm->get_procs_per_trainer();
+        std::cout << "Role: " << get_role() << " block-local shuffle with "
+                  << "locality " << locality << " will exchange "
+                  << num_remote << " of " << n << " samples ("
+                  << (n > 0 ? 100. * num_remote / n : 0.)
+                  << "%) per epoch; a global shuffle would exchange about "
+                  << 100. * (np - 1) / np << "%" << std::endl;
+      }
+    }
+    else {
+      std::shuffle(m_shuffled_indices.begin(), m_shuffled_indices.end(), gen);
+    }
+    const int bucket_size =
+      arg_parser.get<int>(LBANN_OPTION_LENGTH_BUCKET_SIZE);
+    if (bucket_size > 1 && has_variable_length_samples()) {
+      bucket_indices_by_length(bucket_size);
+    }
+  }
+}
+
+void generic_data_reader::bucket_indices_by_length(uint64_t bucket_size)
+{
+  const uint64_t num_indices = m_shuffled_indices.size();
+  std::vector<std::pair<uint64_t, uint64_t>> bucket;
+  bucket.reserve(std::min(bucket_size, num_indices));
+  for (uint64_t begin = 0; begin < num_indices; begin += bucket_size) {
+    const uint64_t end = std::min(begin + bucket_size, num_indices);
+    bucket.clear();
+    for (uint64_t pos = begin; pos < end; ++pos) {
+      const auto index = m_shuffled_indices[pos];
+      bucket.emplace_back(get_sample_length(index), index);
+    }
+    std::stable_sort(bucket.begin(),
+                     bucket.end(),
+                     [](const auto& a, const auto& b) {
+                       return a.first < b.first;
+                     });
+    for (uint64_t pos = begin; pos < end; ++pos) {
+      m_shuffled_indices[pos] = bucket[pos - begin].second;
+    }
+  }
+}
+
+uint64_t generic_data_reader::block_local_shuffle_indices(rng_gen& gen,
+                                                          double locality)
+{
+  // Bucket the samples by owner; every rank must end up with the same
+  // order, so only iterate over ordered containers here
+  std::map<int, std::vector<uint64_t>> buckets;
+  for (const auto& index : m_shuffled_indices) {
+    buckets[m_data_store->get_owner(index)].push_back(index);
+  }
+  for (auto& b : buckets) {
+    std::shuffle(b.second.begin(), b.second.end(), gen);
+  }
+
+  // The owners of a globally shuffled list of samples: drawing from
+  // this picks a bucket in proportion to its original size
+  std::vector<int> owner_pool;
+  owner_pool.reserve(m_shuffled_indices.size());
+  for (const auto& b : buckets) {
+    owner_pool.insert(owner_pool.end(), b.second.size(), b.first);
+  }
+  std::shuffle(owner_pool.begin(), owner_pool.end(), gen);
+  size_t pool_pos = 0;
+
+  std::bernoulli_distribution keep_local(std::min(locality, 1.));
+  uint64_t num_remote = 0;
+  for (uint64_t pos = 0; pos < m_shuffled_indices.size(); ++pos) {
+    const int dst = m_data_store->get_destination(pos);
+    auto it = buckets.find(dst);
+    if (!(keep_local(gen) && it != buckets.end() && !it->second.empty())) {
+      // n.b. there is always a pool entry left for a nonempty bucket
+      do {
+        it = buckets.find(owner_pool[pool_pos++]);
+      } while (it->second.empty());
+    }
+    m_shuffled_indices[pos] = it->second.back();
+    it->second.pop_back();
+    if (it->first != dst) {
+      ++num_remote;
+    }
   }
+  return num_remote;
 }
 
 void generic_data_reader::setup(int num_io_threads,
@@ -112,6 +208,8 @@ lbann::generic_data_reader::fetch(std::vector<conduit::Node>& samples,
     }
   }
 
+  prepare_sample_indices(current_position_in_data_set, sample_stride, mb_size);
+
   /// Allow each thread to perform any preprocessing necessary on the
   /// data source prior to fetching data
   for (int t = 0; t < static_cast<int>(m_io_thread_pool->get_num_threads());
@@ -119,40 +217,25 @@ lbann::generic_data_reader::fetch(std::vector<conduit::Node>& samples,
     preprocess_data_source(t);
   }
 
-  // Fetch data is executed by the thread pool so it has to dispatch
-  // work to other threads in the thread pool and do some work locally
-  for (int t = 0; t < static_cast<int>(m_io_thread_pool->get_num_threads());
-       t++) {
-    // Queue up work into other threads and then finish off the
-    // mini-batch in the active thread
-    if (t == m_io_thread_pool->get_local_thread_id()) {
-      continue;
-    }
-    else {
-      m_io_thread_pool->submit_job_to_work_group(
-        std::bind(&generic_data_reader::fetch_data_block_conduit,
-                  this,
-                  std::ref(samples),
-                  current_position_in_data_set,
-                  t,
-                  m_io_thread_pool->get_num_threads(),
-                  sample_stride,
-                  mb_size,
-                  std::ref(indices_fetched),
-                  mode));
-    }
+  if (mb_size > samples.size()) {
+    LBANN_ERROR("unable to fetch data to conduit nodes, vector length ",
+                samples.size(),
+                " is smaller than mini-batch size",
+                mb_size);
   }
-  fetch_data_block_conduit(samples,
-                           current_position_in_data_set,
-                           m_io_thread_pool->get_local_thread_id(),
-                           m_io_thread_pool->get_num_threads(),
-                           sample_stride,
-                           mb_size,
-                           indices_fetched,
-                           mode);
 
-  // Wait for all of the threads to finish
-  m_io_thread_pool->finish_work_group();
+  // Fetch data is executed by the thread pool, which spreads the
+  // samples over its threads. Samples are claimed dynamically so that
+  // threads that draw cheap samples pick up the slack from threads
+  // stuck on expensive ones.
+  m_io_thread_pool->parallel_for(uint64_t{0}, mb_size, [&](uint64_t s) {
+    fetch_sample_conduit(samples,
+                         current_position_in_data_set,
+                         s,
+                         sample_stride,
+                         indices_fetched,
+                         mode);
+  });
 
   /// Allow each thread to perform any postprocessing necessary on the
   /// data source prior to fetching data
@@ -233,6 +316,8 @@ uint64_t lbann::generic_data_reader::fetch(
     }
   }
 
+  prepare_sample_indices(current_position_in_data_set, sample_stride, mb_size);
+
   /// Allow each thread to perform any preprocessing necessary on the
   /// data source prior to fetching data
   for (int t = 0; t < static_cast<int>(m_io_thread_pool->get_num_threads());
@@ -252,15 +337,28 @@ uint64_t lbann::generic_data_reader::fetch(
   }
 
   // Fetch data is executed by the thread pool so it has to dispatch
-  // work to other threads in the thread pool and do some work locally
-  for (int t = 0; t < static_cast<int>(m_io_thread_pool->get_num_threads());
-       t++) {
-    // Queue up work into other threads and then finish off the
-    // mini-batch in the active thread
-    if (t == m_io_thread_pool->get_local_thread_id()) {
-      continue;
-    }
-    else {
+  // work to other threads in the thread pool and do some work locally.
+  // Unless the reader schedules its own blocks, samples are claimed
+  // dynamically so that threads that draw cheap samples pick up the
+  // slack from threads stuck on expensive ones.
+  if (supports_dynamic_sample_scheduling()) {
+    m_io_thread_pool->parallel_for(uint64_t{0}, mb_size, [&](uint64_t s) {
+      fetch_sample(input_buffers,
+                   current_position_in_data_set,
+                   s,
+                   sample_stride,
+                   indices_fetched,
+                   mode);
+    });
+  }
+  else {
+    for (int t = 0; t < static_cast<int>(m_io_thread_pool->get_num_threads());
+         t++) {
+      // Queue up work into other threads and then finish off the
+      // mini-batch in the active thread
+      if (t == m_io_thread_pool->get_local_thread_id()) {
+        continue;
+      }
       m_io_thread_pool->submit_job_to_work_group(
         std::bind(&generic_data_reader::fetch_data_block,
                   this,
@@ -273,18 +371,18 @@ uint64_t lbann::generic_data_reader::fetch(
                   std::ref(indices_fetched),
                   mode));
     }
-  }
-  fetch_data_block(input_buffers,
-                   current_position_in_data_set,
-                   m_io_thread_pool->get_local_thread_id(),
-                   m_io_thread_pool->get_num_threads(),
-                   sample_stride,
-                   mb_size,
-                   indices_fetched,
-                   mode);
+    fetch_data_block(input_buffers,
+                     current_position_in_data_set,
+                     m_io_thread_pool->get_local_thread_id(),
+                     m_io_thread_pool->get_num_threads(),
+                     sample_stride,
+                     mb_size,
+                     indices_fetched,
+                     mode);
 
-  // Wait for all of the threads to finish
-  m_io_thread_pool->finish_work_group();
+    // Wait for all of the threads to finish
+    m_io_thread_pool->finish_work_group();
+  }
 
   /// Allow each thread to perform any postprocessing necessary on the
   /// data source prior to fetching data
@@ -334,72 +432,94 @@ bool lbann::generic_data_reader::fetch_data_block(
   execution_mode mode)
 {
   for (uint64_t s = block_offset; s < mb_size; s += block_stride) {
-    locked_io_rng_ref io_rng = set_io_generators_local_index(s, mode);
-    int n = current_position_in_data_set + (s * sample_stride);
-    int index = m_shuffled_indices[n];
-    indices_fetched.Set(s, 0, index);
-
-    for (auto& [data_field, buf] : input_buffers) {
-      bool valid = false;
-      if (data_field == INPUT_DATA_TYPE_SAMPLES) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_datum(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+    fetch_sample(input_buffers,
+                 current_position_in_data_set,
+                 s,
+                 sample_stride,
+                 indices_fetched,
+                 mode);
+  }
+
+  return true;
+}
+
+bool lbann::generic_data_reader::fetch_sample(
+  std::map<data_field_type, CPUMat*>& input_buffers,
+  uint64_t current_position_in_data_set,
+  uint64_t s,
+  uint64_t sample_stride,
+  El::Matrix<El::Int>& indices_fetched,
+  execution_mode mode)
+{
+  locked_io_rng_ref io_rng = set_io_generators_local_index(s, mode);
+  // Scratch buffers for decoding and transforming are released per sample
+  utils::scratch_arena_scope scratch;
+  int n = current_position_in_data_set + (s * sample_stride);
+  int index = get_sample_index(n);
+  indices_fetched.Set(s, 0, index);
+  // Augmentations draw from a stream keyed on the sample, not the thread
+  io_sample_stream_scope sample_stream(m_epoch, index, mode);
+
+  for (auto& [data_field, buf] : input_buffers) {
+    bool valid = false;
+    if (data_field == INPUT_DATA_TYPE_SAMPLES) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_data_block function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
       }
-      else if (data_field == INPUT_DATA_TYPE_LABELS && has_labels()) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_label(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+      valid = fetch_datum(*buf, index, s);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
       }
-      else if (data_field == INPUT_DATA_TYPE_RESPONSES && has_responses()) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_response(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+    }
+    else if (data_field == INPUT_DATA_TYPE_LABELS && has_labels()) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_data_block function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
+      }
+      valid = fetch_label(*buf, index, s);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
+      }
+    }
+    else if (data_field == INPUT_DATA_TYPE_RESPONSES && has_responses()) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_data_block function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
       }
-      else if (has_data_field(data_field)) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_data_field(data_field, *buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ",
-                      std::to_string(index),
-                      ") for field ",
-                      data_field);
-        }
+      valid = fetch_response(*buf, index, s);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
       }
-      else {
-        LBANN_ERROR("Unsupported data_field ", data_field);
+    }
+    else if (has_data_field(data_field)) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_data_block function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
+      }
+      valid = fetch_data_field(data_field, *buf, index, s);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ",
+                    std::to_string(index),
+                    ") for field ",
+                    data_field);
       }
     }
+    else {
+      LBANN_ERROR("Unsupported data_field ", data_field);
+    }
   }
 
   return true;
@@ -422,16 +542,34 @@ bool lbann::generic_data_reader::fetch_data_block_conduit(
                 mb_size);
   }
   for (uint64_t s = block_offset; s < mb_size; s += block_stride) {
-    locked_io_rng_ref io_rng = set_io_generators_local_index(s, mode);
-    int n = current_position_in_data_set + (s * sample_stride);
-    int index = m_shuffled_indices[n];
-    indices_fetched.Set(s, 0, index);
-
-    auto& sample = samples[s];
-    bool valid = fetch_conduit_node(sample, index);
-    if (!valid) {
-      LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-    }
+    fetch_sample_conduit(samples,
+                         current_position_in_data_set,
+                         s,
+                         sample_stride,
+                         indices_fetched,
+                         mode);
+  }
+  return true;
+}
+
+bool lbann::generic_data_reader::fetch_sample_conduit(
+  std::vector<conduit::Node>& samples,
+  uint64_t current_position_in_data_set,
+  uint64_t s,
+  uint64_t sample_stride,
+  El::Matrix<El::Int>& indices_fetched,
+  execution_mode mode)
+{
+  locked_io_rng_ref io_rng = set_io_generators_local_index(s, mode);
+  int n = current_position_in_data_set + (s * sample_stride);
+  int index = get_sample_index(n);
+  indices_fetched.Set(s, 0, index);
+  io_sample_stream_scope sample_stream(m_epoch, index, mode);
+
+  auto& sample = samples[s];
+  bool valid = fetch_conduit_node(sample, index);
+  if (!valid) {
+    LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
   }
   return true;
 }
@@ -439,6 +577,7 @@ bool lbann::generic_data_reader::fetch_data_block_conduit(
 void generic_data_reader::update(bool epoch_complete)
 {
   if (epoch_complete) {
+    ++m_epoch;
     shuffle_indices();
     if (m_data_store != nullptr && priming_data_store()) {
       m_data_store->set_shuffled_indices(&m_shuffled_indices);
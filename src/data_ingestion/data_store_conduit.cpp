@@ -31,6 +31,7 @@
 
 #include "lbann/comm_impl.hpp"
 #include "lbann/data_ingestion/data_store_conduit.hpp"
+#include "lbann/data_ingestion/infrastructure/spill_segment_store.hpp"
 
 #include "lbann/data_ingestion/readers/data_reader_image.hpp"
 #include "lbann/data_ingestion/readers/sample_list_impl.hpp"
@@ -49,11 +50,48 @@
 #include <sys/statvfs.h>
 #include <unistd.h>
 #include <unordered_set>
+#include <zlib.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
 
 namespace lbann {
 
+namespace {
+
+/// Child names used to hold a compressed leaf and its original schema
+constexpr char compressed_data_field[] = "_lbann_zlib_data";
+constexpr char compressed_schema_field[] = "_lbann_zlib_schema";
+
+/// Leaves smaller than this are not worth compressing
+constexpr size_t min_compressed_field_bytes = 256;
+
+/// Message tags for the two stages of a node-aggregated exchange
+constexpr int node_exchange_stage_1_tag = 32001;
+constexpr int node_exchange_stage_2_tag = 32002;
+
+/// Message tag for a fixed-record exchange
+constexpr int record_exchange_tag = 32003;
+
+/// Sets n_msg to refer (without copying) to the sections of a message
+/// built by data_store_conduit::build_node_for_sending
+void unpack_sample_message(conduit::uint8* n_buff_ptr, conduit::Node& n_msg)
+{
+  n_msg["schema_len"].set_external((conduit::int64*)n_buff_ptr);
+  n_buff_ptr += 8;
+  n_msg["schema"].set_external_char8_str((char*)(n_buff_ptr));
+  conduit::Schema rcv_schema;
+  conduit::Generator gen(n_msg["schema"].as_char8_str());
+  gen.walk(rcv_schema);
+  n_buff_ptr += n_msg["schema"].total_bytes_compact();
+  n_msg["data"].set_external(rcv_schema, n_buff_ptr);
+}
+
+} // namespace
+
 data_store_conduit::data_store_conduit(generic_data_reader* reader)
   : m_reader(reader)
 {
@@ -104,12 +142,63 @@ data_store_conduit::data_store_conduit(generic_data_reader* reader)
   }
   if (arg_parser.get<std::string>(LBANN_OPTION_DATA_STORE_SPILL) != "") {
     setup_spill(arg_parser.get<std::string>(LBANN_OPTION_DATA_STORE_SPILL));
+    m_spill_segments =
+      std::make_shared<spill_segment_store>(get_conduit_dir());
   }
 
   set_is_local_cache(arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_CACHE));
   set_is_preloading(arg_parser.get<bool>(LBANN_OPTION_PRELOAD_DATA_STORE));
   set_is_explicitly_loading(!is_preloading());
 
+  m_compression_level =
+    arg_parser.get<int>(LBANN_OPTION_DATA_STORE_COMPRESSION_LEVEL);
+  if (m_compression_level < 0 || m_compression_level > 9) {
+    LBANN_ERROR("--data_store_compression_level must be in [0, 9]; got ",
+                m_compression_level);
+  }
+  m_node_aggregated_exchange =
+    arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_NODE_AGGREGATION);
+  if (m_node_aggregated_exchange && num_io_parts > 1) {
+    if (m_world_master) {
+      LBANN_WARNING("--data_store_node_aggregation is not supported with "
+                    "multiple I/O partitions; ignoring it");
+    }
+    m_node_aggregated_exchange = false;
+  }
+
+  if (is_compressing() && (is_local_cache() || m_spill)) {
+    if (m_world_master) {
+      LBANN_WARNING("data store compression is not supported with "
+                    "--data_store_cache or --data_store_spill; ignoring "
+                    "--data_store_compression_level");
+    }
+    m_compression_level = 0;
+  }
+  if (is_compressing()) {
+    std::stringstream ss(
+      arg_parser.get<std::string>(LBANN_OPTION_DATA_STORE_COMPRESSION_FIELDS));
+    std::string field;
+    while (std::getline(ss, field, ',')) {
+      if (!field.empty()) {
+        m_compression_fields.insert(field);
+      }
+    }
+    // Compressed samples have data-dependent sizes
+    set_node_sizes_vary();
+    PROFILE("data_store_conduit is compressing samples with zlib level ",
+            m_compression_level);
+  }
+
+  m_fixed_records = arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_FIXED_RECORDS);
+  if (m_fixed_records && (is_local_cache() || m_spill || is_compressing())) {
+    if (m_world_master) {
+      LBANN_WARNING("--data_store_fixed_records is not supported with "
+                    "--data_store_cache, --data_store_spill or data store "
+                    "compression; ignoring it");
+    }
+    m_fixed_records = false;
+  }
+
   if (is_local_cache()) {
     PROFILE("data_store_conduit is running in local_cache mode");
   }
@@ -234,6 +323,16 @@ void data_store_conduit::copy_members(const data_store_conduit& rhs)
   m_cur_spill_dir_integer = rhs.m_cur_spill_dir_integer;
   m_cur_spill_dir = rhs.m_cur_spill_dir;
   m_num_files_in_cur_spill_dir = rhs.m_num_files_in_cur_spill_dir;
+  m_spilled_nodes = rhs.m_spilled_nodes;
+  m_spill_segments = rhs.m_spill_segments;
+
+  m_compression_level = rhs.m_compression_level;
+  m_compression_fields = rhs.m_compression_fields;
+
+  m_fixed_records = rhs.m_fixed_records;
+  m_record_schema = rhs.m_record_schema;
+  m_record_size = rhs.m_record_size;
+  m_record_wraps_id = rhs.m_record_wraps_id;
 
   /// Clear the pointer to the data reader, this cannot be copied
   m_reader = nullptr;
@@ -252,6 +351,9 @@ void data_store_conduit::copy_members(const data_store_conduit& rhs)
   m_compacted_sample_size = rhs.m_compacted_sample_size;
   m_indices_to_send = rhs.m_indices_to_send;
   m_indices_to_recv = rhs.m_indices_to_recv;
+  m_node_aggregated_exchange = rhs.m_node_aggregated_exchange;
+  m_node_of_rank = rhs.m_node_of_rank;
+  m_ranks_on_node = rhs.m_ranks_on_node;
 
   m_mini_batch_data_exchange_started = rhs.m_mini_batch_data_exchange_started;
 
@@ -294,6 +396,16 @@ void data_store_conduit::spill_preloaded_conduit_node(uint64_t data_id,
     m_sample_sizes[data_id] = n3.total_bytes_compact();
   }
 
+  if (m_spill_segments) {
+    // Written by the segment store's background thread; n.b. this may
+    // block if too many samples are waiting to be written
+    m_spill_segments->append(data_id, n3.data_ptr(), n3.total_bytes_compact());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_spilled_nodes[data_id] = m_cur_spill_dir_integer;
+    m_data.erase(data_id);
+    return;
+  }
+
   {
     std::lock_guard<std::mutex> lock(m_mutex);
     spill_conduit_node(node, data_id);
@@ -328,8 +440,24 @@ void data_store_conduit::set_preloaded_conduit_node(uint64_t data_id,
     return;
   }
 
+  if (m_fixed_records) {
+    // node is m_data[data_id], so copy it out before erasing it
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (uses_fixed_records() && store_record(data_id, node)) {
+      m_data.erase(data_id);
+      return;
+    }
+  }
+
   {
-    conduit::Node n2 = node; // node == m_data[data_id]
+    conduit::Node n2;
+    if (is_compressing()) {
+      // Compress outside the lock so that I/O threads can overlap it
+      compress_node(node, n2, m_compression_fields.empty());
+    }
+    else {
+      n2 = node; // node == m_data[data_id]
+    }
     std::lock_guard<std::mutex> lock(m_mutex);
     build_node_for_sending(n2, m_data[data_id]);
 
@@ -381,6 +509,178 @@ void data_store_conduit::error_check_compacted_node(const conduit::Node& nd,
   }
 }
 
+namespace {
+
+/** Returns the part of a sample that is kept as a record
+ *
+ *  Readers usually nest every field of a sample under its padded
+ *  data_id, which differs from sample to sample; that level is left
+ *  out of the record schema and restored by set_record_view.
+ */
+const conduit::Node&
+get_record_payload(const conduit::Node& node, uint64_t data_id, bool& wraps_id)
+{
+  wraps_id = node.number_of_children() == 1 &&
+             node.child(0).name() == LBANN_DATA_ID_STR(data_id);
+  return wraps_id ? node.child(0) : node;
+}
+
+} // namespace
+
+bool data_store_conduit::store_record(uint64_t data_id,
+                                      const conduit::Node& node)
+{
+  bool wraps_id;
+  const conduit::Node& payload = get_record_payload(node, data_id, wraps_id);
+  conduit::Node compacted;
+  const conduit::Node* src = &payload;
+  if (!(payload.is_compact() && payload.is_contiguous())) {
+    payload.compact_to(compacted);
+    src = &compacted;
+  }
+  conduit::Schema schema;
+  src->schema().compact_to(schema);
+  if (m_record_size == 0) {
+    m_record_schema = schema;
+    m_record_size = schema.total_bytes_compact();
+    m_record_wraps_id = wraps_id;
+  }
+  else if (wraps_id != m_record_wraps_id || !schema.equals(m_record_schema)) {
+    PROFILE("sample with data_id: ",
+            data_id,
+            " does not match the fixed-size record schema; storing ",
+            "samples as conduit nodes; role: ",
+            m_reader->get_role());
+    convert_records_to_nodes();
+    return false;
+  }
+  if (m_record_slots.count(data_id) != 0) {
+    LBANN_ERROR("duplicate data_id: ", data_id, " in store_record");
+  }
+
+  const size_t slot = m_record_slots.size();
+  if (slot / m_records_per_block == m_record_blocks.size()) {
+    m_record_blocks.emplace_back(
+      std::make_unique<El::byte[]>(m_records_per_block * m_record_size));
+  }
+  std::memcpy(get_record(slot), src->contiguous_data_ptr(), m_record_size);
+  m_record_slots[data_id] = slot;
+  return true;
+}
+
+void data_store_conduit::set_record_view(conduit::Node& view,
+                                         uint64_t data_id,
+                                         const El::byte* record) const
+{
+  auto* ptr = const_cast<El::byte*>(record);
+  view.reset();
+  if (m_record_wraps_id) {
+    view[LBANN_DATA_ID_STR(data_id)].set_external(m_record_schema, ptr);
+  }
+  else {
+    view.set_external(m_record_schema, ptr);
+  }
+}
+
+void data_store_conduit::convert_records_to_nodes()
+{
+  set_node_sizes_vary();
+  for (const auto& t : m_record_slots) {
+    conduit::Node nd;
+    set_record_view(nd, t.first, get_record(t.second));
+    build_node_for_sending(nd, m_data[t.first]);
+  }
+  // Nodes already in m_data were reloaded from a checkpoint
+  for (const auto& t : m_data) {
+    m_sample_sizes[t.first] = t.second.total_bytes_compact();
+  }
+  m_record_slots.clear();
+  m_record_blocks.clear();
+  m_record_views.clear();
+  m_random_record.reset();
+  m_record_schema.reset();
+  m_record_size = 0;
+}
+
+const El::byte* data_store_conduit::get_owned_record(uint64_t data_id) const
+{
+  auto it = m_record_slots.find(data_id);
+  if (it != m_record_slots.end()) {
+    return get_record(it->second);
+  }
+  auto t = m_data.find(data_id);
+  if (t == m_data.end()) {
+    LBANN_ERROR("failed to find data_id: ", data_id, " in the data store");
+  }
+  return reinterpret_cast<const El::byte*>(
+    t->second["data"].contiguous_data_ptr());
+}
+
+void data_store_conduit::exchange_record_schema()
+{
+  // Samples reloaded from a checkpoint are held as nodes
+  bool mismatch = m_node_sizes_vary;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& t : m_data) {
+      bool wraps_id;
+      conduit::Schema schema;
+      get_record_payload(t.second["data"], t.first, wraps_id)
+        .schema()
+        .compact_to(schema);
+      if (m_record_size == 0) {
+        m_record_schema = schema;
+        m_record_size = schema.total_bytes_compact();
+        m_record_wraps_id = wraps_id;
+      }
+      mismatch = mismatch || wraps_id != m_record_wraps_id ||
+                 !schema.equals(m_record_schema);
+    }
+  }
+
+  // Every rank must agree on the storage format, since it decides
+  // which messages are exchanged
+  if (m_comm->trainer_allreduce<int>(mismatch ? 1 : 0, El::mpi::MAX) != 0) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    convert_records_to_nodes();
+    PROFILE("samples do not share one schema; exchanging conduit nodes");
+    return;
+  }
+
+  const int root = m_comm->trainer_allreduce<int>(
+    m_record_size > 0 ? m_rank_in_trainer : m_np_in_trainer,
+    El::mpi::MIN);
+  if (root == m_np_in_trainer) {
+    LBANN_ERROR("no rank holds any samples, so the record size needed for "
+                "data exchange is unknown; role: ",
+                m_reader->get_role());
+  }
+  // The first character records whether the data_id level is elided
+  std::vector<char> json;
+  if (m_rank_in_trainer == root) {
+    const std::string str = m_record_schema.to_json();
+    json.push_back(m_record_wraps_id ? '1' : '0');
+    json.insert(json.end(), str.begin(), str.end());
+  }
+  m_comm->broadcast(root, json, m_comm->get_trainer_comm());
+  const bool wraps_id = json.front() == '1';
+  const conduit::Schema schema(std::string(json.begin() + 1, json.end()));
+  if (m_record_size == 0) {
+    m_record_schema = schema;
+    m_record_size = schema.total_bytes_compact();
+    m_record_wraps_id = wraps_id;
+  }
+  mismatch = wraps_id != m_record_wraps_id || !schema.equals(m_record_schema);
+  if (m_comm->trainer_allreduce<int>(mismatch ? 1 : 0, El::mpi::MAX) != 0) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    convert_records_to_nodes();
+    PROFILE("ranks hold samples with different schemas; exchanging ",
+            "conduit nodes");
+    return;
+  }
+  PROFILE("exchanging fixed-size records of ", m_record_size, " bytes");
+}
+
 // n.b. Do not put any PROFILE or DEBUG_DS statements in this method,
 //      since the threading from the data_reader will cause you grief
 void data_store_conduit::set_conduit_node(uint64_t data_id,
@@ -402,7 +702,7 @@ void data_store_conduit::set_conduit_node(uint64_t data_id,
 
   {
     // std::lock_guard<std::mutex> lock(m_mutex);
-    if (already_have == false && m_data.find(data_id) != m_data.end()) {
+    if (already_have == false && owns_sample(data_id)) {
       DEBUG_DS("m_data.size: ",
                m_data.size(),
                " ERROR: duplicate data_id: ",
@@ -467,7 +767,17 @@ void data_store_conduit::set_conduit_node(uint64_t data_id,
                m_num_partitions_in_trainer);
       auto key = std::make_pair(data_id, m_offset_in_partition);
       m_owner[key] = m_rank_in_trainer;
-      build_node_for_sending(node, m_data[data_id]);
+      if (uses_fixed_records() && store_record(data_id, node)) {
+        return;
+      }
+      if (is_compressing()) {
+        conduit::Node n2;
+        compress_node(node, n2, m_compression_fields.empty());
+        build_node_for_sending(n2, m_data[data_id]);
+      }
+      else {
+        build_node_for_sending(node, m_data[data_id]);
+      }
       m_sample_sizes[data_id] = m_data[data_id].total_bytes_compact();
       error_check_compacted_node(m_data[data_id], data_id);
       //      m_mutex.unlock();
@@ -496,10 +806,26 @@ data_store_conduit::get_conduit_node(uint64_t data_id) const
   // if not preloaded, and get_label() or get_response() is called,
   // we need to check m_data
   if (t2 == m_minibatch_data.end()) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    iterator_t t3 = m_data.find(data_id);
-    if (t3 != m_data.end()) {
-      return t3->second["data"];
+    const conduit::Node* owned = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      iterator_t t3 = m_data.find(data_id);
+      if (t3 != m_data.end()) {
+        owned = &(t3->second["data"]);
+      }
+      else if (m_record_slots.count(data_id) != 0) {
+        auto& view = m_record_views[data_id];
+        if (view.dtype().is_empty()) {
+          set_record_view(view, data_id, get_owned_record(data_id));
+        }
+        owned = &view;
+      }
+    }
+    if (owned != nullptr) {
+      if (is_compressing()) {
+        return get_decompressed_node(data_id, *owned);
+      }
+      return *owned;
     }
     LBANN_ERROR("failed to find data_id: ",
                 data_id,
@@ -511,9 +837,123 @@ data_store_conduit::get_conduit_node(uint64_t data_id) const
                 m_reader->get_role());
   }
 
+  if (is_compressing()) {
+    return get_decompressed_node(data_id, t2->second);
+  }
   return t2->second;
 }
 
+const conduit::Node&
+data_store_conduit::get_decompressed_node(uint64_t data_id,
+                                          const conduit::Node& node) const
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_decompressed_data.find(data_id);
+    if (it != m_decompressed_data.end()) {
+      return it->second;
+    }
+  }
+
+  // Decompress without holding the lock so that the I/O threads
+  // calling in here can work in parallel
+  conduit::Node nd;
+  decompress_node(node, nd);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // If another thread beat us to it, emplace keeps the existing entry
+  auto result = m_decompressed_data.emplace(data_id, std::move(nd));
+  return result.first->second;
+}
+
+void data_store_conduit::compress_node(const conduit::Node& node_in,
+                                       conduit::Node& node_out,
+                                       bool selected) const
+{
+  node_out.reset();
+  if (node_in.dtype().is_object()) {
+    for (const auto& name : node_in.child_names()) {
+      const bool child_selected =
+        selected ||
+        m_compression_fields.find(name) != m_compression_fields.end();
+      compress_node(node_in[name], node_out[name], child_selected);
+    }
+    return;
+  }
+
+  const size_t num_bytes = node_in.total_bytes_compact();
+  if (!selected || node_in.dtype().is_list() ||
+      num_bytes < min_compressed_field_bytes) {
+    node_out.set(node_in);
+    return;
+  }
+
+  conduit::Node compact;
+  node_in.compact_to(compact);
+  uLongf compressed_len = compressBound(num_bytes);
+  std::vector<Bytef> compressed(compressed_len);
+  const int status =
+    compress2(compressed.data(),
+              &compressed_len,
+              reinterpret_cast<const Bytef*>(compact.data_ptr()),
+              num_bytes,
+              m_compression_level);
+  if (status != Z_OK) {
+    LBANN_ERROR("zlib compress2 failed with status ", status);
+  }
+
+  // Incompressible data is kept as-is
+  if (compressed_len >= num_bytes) {
+    node_out.set(compact);
+    return;
+  }
+
+  node_out[compressed_data_field].set(conduit::DataType::uint8(compressed_len));
+  std::memcpy(node_out[compressed_data_field].data_ptr(),
+              compressed.data(),
+              compressed_len);
+  node_out[compressed_schema_field].set(compact.schema().to_json());
+}
+
+void data_store_conduit::decompress_node(const conduit::Node& node_in,
+                                         conduit::Node& node_out) const
+{
+  node_out.reset();
+  if (!node_in.dtype().is_object()) {
+    node_out.set(node_in);
+    return;
+  }
+
+  if (!node_in.has_child(compressed_data_field)) {
+    for (const auto& name : node_in.child_names()) {
+      decompress_node(node_in[name], node_out[name]);
+    }
+    return;
+  }
+
+  const conduit::Node& packed = node_in[compressed_data_field];
+  conduit::Schema s;
+  conduit::Generator gen(node_in[compressed_schema_field].as_char8_str());
+  gen.walk(s);
+  node_out.set(s);
+
+  uLongf raw_len = s.total_bytes_compact();
+  const int status =
+    uncompress(reinterpret_cast<Bytef*>(node_out.data_ptr()),
+               &raw_len,
+               reinterpret_cast<const Bytef*>(packed.data_ptr()),
+               packed.dtype().number_of_elements());
+  if (status != Z_OK ||
+      raw_len != static_cast<uLongf>(s.total_bytes_compact())) {
+    LBANN_ERROR("zlib uncompress failed with status ",
+                status,
+                "; expected ",
+                s.total_bytes_compact(),
+                " bytes, got ",
+                raw_len);
+  }
+}
+
 // code in the following method is a modification of code from
 // conduit/src/libs/relay/conduit_relay_mpi.cpp
 void data_store_conduit::build_node_for_sending(const conduit::Node& node_in,
@@ -565,7 +1005,12 @@ void data_store_conduit::start_exchange_data_by_sample(uint64_t current_pos,
   // In this case those processors won't know the size of the compacted
   // nodes, hence, cannot properly set up their recv buffers, hence,
   // mpi throws errors.
-  if (m_bcast_sample_size && !m_node_sizes_vary) {
+  if (m_bcast_sample_size && m_fixed_records) {
+    // n.b. this may fall back to conduit nodes on every rank
+    exchange_record_schema();
+    m_bcast_sample_size = false;
+  }
+  else if (m_bcast_sample_size && !m_node_sizes_vary) {
     verify_sample_size();
     m_bcast_sample_size = false;
   }
@@ -587,10 +1032,23 @@ void data_store_conduit::start_exchange_data_by_sample(uint64_t current_pos,
   if (m_spill) {
     // TODO
     load_spilled_conduit_nodes();
+    readahead_spilled_conduit_nodes(current_pos + mb_size, mb_size);
   }
 
   int num_recv_req = build_indices_i_will_recv(current_pos, mb_size);
 
+  if (uses_fixed_records()) {
+    start_exchange_records(current_pos, mb_size);
+    m_start_snd_rcv_time += (get_time() - tm5);
+    return;
+  }
+
+  if (m_node_aggregated_exchange) {
+    start_exchange_data_by_node(current_pos, mb_size);
+    m_start_snd_rcv_time += (get_time() - tm5);
+    return;
+  }
+
   m_send_requests.resize(num_send_req);
   m_recv_requests.resize(num_recv_req);
   m_recv_buffer.resize(num_recv_req);
@@ -719,6 +1177,15 @@ void data_store_conduit::start_exchange_data_by_sample(uint64_t current_pos,
 
 void data_store_conduit::finish_exchange_data_by_sample()
 {
+  if (uses_fixed_records()) {
+    finish_exchange_records();
+    return;
+  }
+  if (m_node_aggregated_exchange) {
+    finish_exchange_data_by_node();
+    return;
+  }
+
   // wait for all msgs to complete
   double tm5 = get_time();
   m_comm->wait_all(m_send_requests);
@@ -732,17 +1199,13 @@ void data_store_conduit::finish_exchange_data_by_sample()
   tm5 = get_time();
   conduit::Node nd;
   m_minibatch_data.clear();
+  if (is_compressing()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decompressed_data.clear();
+  }
   for (size_t j = 0; j < m_recv_buffer.size(); j++) {
-    conduit::uint8* n_buff_ptr = (conduit::uint8*)m_recv_buffer[j].data_ptr();
     conduit::Node n_msg;
-    n_msg["schema_len"].set_external((conduit::int64*)n_buff_ptr);
-    n_buff_ptr += 8;
-    n_msg["schema"].set_external_char8_str((char*)(n_buff_ptr));
-    conduit::Schema rcv_schema;
-    conduit::Generator gen(n_msg["schema"].as_char8_str());
-    gen.walk(rcv_schema);
-    n_buff_ptr += n_msg["schema"].total_bytes_compact();
-    n_msg["data"].set_external(rcv_schema, n_buff_ptr);
+    unpack_sample_message((conduit::uint8*)m_recv_buffer[j].data_ptr(), n_msg);
 
     int data_id = m_recv_data_ids[j];
     m_minibatch_data[data_id].set_external(n_msg["data"]);
@@ -756,6 +1219,370 @@ void data_store_conduit::finish_exchange_data_by_sample()
   }
 }
 
+void data_store_conduit::setup_node_aggregated_exchange()
+{
+  // Nodes are identified by the lowest trainer rank they hold
+  int my_node = m_rank_in_trainer;
+  for (int p = 0; p < m_np_in_trainer; ++p) {
+    if (m_comm->is_rank_node_local(p, m_comm->get_trainer_comm())) {
+      my_node = p;
+      break;
+    }
+  }
+  m_node_of_rank.resize(m_np_in_trainer);
+  m_comm->trainer_all_gather(my_node, m_node_of_rank);
+
+  m_ranks_on_node.clear();
+  for (int p = 0; p < m_np_in_trainer; ++p) {
+    m_ranks_on_node[m_node_of_rank[p]].push_back(p);
+  }
+  PROFILE("node-aggregated exchange over ",
+          m_ranks_on_node.size(),
+          " nodes in the trainer");
+}
+
+size_t data_store_conduit::get_sample_message_size(uint64_t data_id)
+{
+  if (!m_node_sizes_vary) {
+    return m_compacted_sample_size;
+  }
+  auto it = m_sample_sizes.find(data_id);
+  if (it == m_sample_sizes.end()) {
+    LBANN_ERROR("m_sample_sizes.find(data_id) == m_sample_sizes.end() for "
+                "data_id: ",
+                data_id,
+                "; m_sample_sizes.size: ",
+                m_sample_sizes.size());
+  }
+  return it->second;
+}
+
+void data_store_conduit::post_coalesced_recvs(
+  const std::vector<std::vector<uint64_t>>& ids,
+  int tag)
+{
+  for (int p = 0; p < m_np_in_trainer; ++p) {
+    if (ids[p].empty()) {
+      continue;
+    }
+    size_t total = 0;
+    for (auto index : ids[p]) {
+      total += get_sample_message_size(index);
+    }
+    if (total > static_cast<size_t>(std::numeric_limits<int>::max())) {
+      LBANN_ERROR("coalesced message of ", total, " bytes is too large");
+    }
+    m_stage_recv_buffers.emplace_back(total);
+    m_recv_requests.emplace_back();
+    m_comm->nb_tagged_recv<El::byte>(m_stage_recv_buffers.back().data(),
+                                     total,
+                                     p,
+                                     tag,
+                                     m_recv_requests.back(),
+                                     m_comm->get_trainer_comm());
+  }
+}
+
+void data_store_conduit::start_exchange_data_by_node(uint64_t current_pos,
+                                                     uint64_t mb_size)
+{
+  if (m_node_of_rank.empty()) {
+    setup_node_aggregated_exchange();
+  }
+
+  //========================================================================
+  // part 1: every rank computes the same routing plan for the mini-batch
+
+  const int me = m_rank_in_trainer;
+  m_stage_1_send_ids.assign(m_np_in_trainer, {});
+  m_stage_1_recv_ids.assign(m_np_in_trainer, {});
+  m_stage_2_send_ids.assign(m_np_in_trainer, {});
+  m_stage_2_recv_ids.assign(m_np_in_trainer, {});
+  m_my_exchanged_ids.clear();
+  for (uint64_t i = current_pos; i < current_pos + mb_size; ++i) {
+    auto index = (*m_shuffled_indices)[i];
+    // n.b. there is a single I/O partition, see the ctor
+    const int dst =
+      (int)(i % m_owner_map_mb_size) % m_num_partitions_in_trainer;
+    auto key = std::make_pair(index, m_offset_in_partition);
+    const int src = m_owner[key];
+    if (dst == me) {
+      m_my_exchanged_ids.push_back(index);
+    }
+
+    // Samples bound for another node go through a forwarding rank on
+    // that node; spread the senders of each node across its ranks
+    int hop = dst;
+    const int dst_node = m_node_of_rank[dst];
+    if (m_node_of_rank[src] != dst_node) {
+      const auto& src_ranks = m_ranks_on_node[m_node_of_rank[src]];
+      const auto& dst_ranks = m_ranks_on_node[dst_node];
+      const size_t local_src =
+        std::lower_bound(src_ranks.begin(), src_ranks.end(), src) -
+        src_ranks.begin();
+      hop = dst_ranks[local_src % dst_ranks.size()];
+    }
+    if (src == me) {
+      m_stage_1_send_ids[hop].push_back(index);
+    }
+    if (hop == me) {
+      m_stage_1_recv_ids[src].push_back(index);
+    }
+    if (hop != dst) {
+      if (hop == me) {
+        m_stage_2_send_ids[dst].push_back(index);
+      }
+      if (dst == me) {
+        m_stage_2_recv_ids[hop].push_back(index);
+      }
+    }
+  }
+
+  //========================================================================
+  // part 2: start stage 1, one coalesced message per peer
+
+  // Requests must not move once posted
+  m_send_requests.clear();
+  m_recv_requests.clear();
+  m_send_requests.reserve(m_np_in_trainer);
+  m_recv_requests.reserve(m_np_in_trainer);
+  m_stage_send_buffers.clear();
+  m_stage_recv_buffers.clear();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int p = 0; p < m_np_in_trainer; ++p) {
+      const auto& ids = m_stage_1_send_ids[p];
+      if (ids.empty()) {
+        continue;
+      }
+      size_t total = 0;
+      for (auto index : ids) {
+        total += get_sample_message_size(index);
+      }
+      if (total > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        LBANN_ERROR("coalesced message of ", total, " bytes is too large");
+      }
+      m_stage_send_buffers.emplace_back(total);
+      El::byte* buf = m_stage_send_buffers.back().data();
+      for (auto index : ids) {
+        auto it = m_data.find(index);
+        if (it == m_data.end()) {
+          LBANN_ERROR("failed to find data_id: ",
+                      index,
+                      " to be sent to ",
+                      p,
+                      " in m_data");
+        }
+        const size_t sz = get_sample_message_size(index);
+        std::memcpy(buf, it->second.data_ptr(), sz);
+        buf += sz;
+      }
+      m_send_requests.emplace_back();
+      m_comm->nb_tagged_send<El::byte>(m_stage_send_buffers.back().data(),
+                                       total,
+                                       p,
+                                       node_exchange_stage_1_tag,
+                                       m_send_requests.back(),
+                                       m_comm->get_trainer_comm());
+    }
+    post_coalesced_recvs(m_stage_1_recv_ids, node_exchange_stage_1_tag);
+  }
+}
+
+void data_store_conduit::finish_exchange_data_by_node()
+{
+  double tm5 = get_time();
+  m_comm->wait_all(m_send_requests);
+  m_comm->wait_all(m_recv_requests);
+
+  // Record where each received sample starts
+  std::unordered_map<uint64_t, El::byte*> located;
+  size_t b = 0;
+  auto locate = [&](const std::vector<std::vector<uint64_t>>& ids) {
+    for (int p = 0; p < m_np_in_trainer; ++p) {
+      if (ids[p].empty()) {
+        continue;
+      }
+      El::byte* ptr = m_stage_recv_buffers[b++].data();
+      for (auto index : ids[p]) {
+        located[index] = ptr;
+        ptr += get_sample_message_size(index);
+      }
+    }
+  };
+  locate(m_stage_1_recv_ids);
+
+  //========================================================================
+  // part 3: stage 2, forward samples to their destinations on this node
+
+  m_send_requests.clear();
+  m_recv_requests.clear();
+  m_send_requests.reserve(m_np_in_trainer);
+  m_recv_requests.reserve(m_np_in_trainer);
+  m_stage_send_buffers.clear();
+  for (int p = 0; p < m_np_in_trainer; ++p) {
+    const auto& ids = m_stage_2_send_ids[p];
+    if (ids.empty()) {
+      continue;
+    }
+    size_t total = 0;
+    for (auto index : ids) {
+      total += get_sample_message_size(index);
+    }
+    m_stage_send_buffers.emplace_back(total);
+    El::byte* buf = m_stage_send_buffers.back().data();
+    for (auto index : ids) {
+      const size_t sz = get_sample_message_size(index);
+      std::memcpy(buf, located.at(index), sz);
+      buf += sz;
+    }
+    m_send_requests.emplace_back();
+    m_comm->nb_tagged_send<El::byte>(m_stage_send_buffers.back().data(),
+                                     total,
+                                     p,
+                                     node_exchange_stage_2_tag,
+                                     m_send_requests.back(),
+                                     m_comm->get_trainer_comm());
+  }
+  post_coalesced_recvs(m_stage_2_recv_ids, node_exchange_stage_2_tag);
+  m_comm->wait_all(m_send_requests);
+  m_comm->wait_all(m_recv_requests);
+  locate(m_stage_2_recv_ids);
+  m_comm->trainer_barrier();
+  m_wait_all_time += (get_time() - tm5);
+
+  //========================================================================
+  // part 4: construct the Nodes needed by me for the current minibatch
+
+  tm5 = get_time();
+  m_minibatch_data.clear();
+  if (is_compressing()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_decompressed_data.clear();
+  }
+  for (auto index : m_my_exchanged_ids) {
+    auto it = located.find(index);
+    if (it == located.end()) {
+      LBANN_ERROR("failed to receive data_id: ", index);
+    }
+    conduit::Node n_msg;
+    unpack_sample_message((conduit::uint8*)it->second, n_msg);
+    m_minibatch_data[index].set_external(n_msg["data"]);
+  }
+  m_rebuild_time += (get_time() - tm5);
+
+  if (m_spill) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_data.clear();
+  }
+}
+
+void data_store_conduit::start_exchange_records(uint64_t current_pos,
+                                                uint64_t mb_size)
+{
+  // Both sides list the samples of a message in sorted order, so a
+  // message is just the records back to back
+  m_stage_1_send_ids.assign(m_np_in_trainer, {});
+  m_stage_1_recv_ids.assign(m_np_in_trainer, {});
+  for (int p = 0; p < m_np_in_trainer; ++p) {
+    auto& send_ids = m_stage_1_send_ids[p];
+    send_ids.assign(m_indices_to_send[p].begin(), m_indices_to_send[p].end());
+    std::sort(send_ids.begin(), send_ids.end());
+    auto& recv_ids = m_stage_1_recv_ids[p];
+    recv_ids.assign(m_indices_to_recv[p].begin(), m_indices_to_recv[p].end());
+    std::sort(recv_ids.begin(), recv_ids.end());
+  }
+
+  // Requests must not move once posted
+  m_send_requests.clear();
+  m_recv_requests.clear();
+  m_send_requests.reserve(m_np_in_trainer);
+  m_recv_requests.reserve(m_np_in_trainer);
+  m_stage_send_buffers.clear();
+  m_stage_recv_buffers.clear();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (int p = 0; p < m_np_in_trainer; ++p) {
+    // My own samples are viewed in place, see finish_exchange_records
+    const auto& ids = m_stage_1_send_ids[p];
+    if (ids.empty() || p == m_rank_in_trainer) {
+      continue;
+    }
+    const size_t total = ids.size() * m_record_size;
+    if (total > static_cast<size_t>(std::numeric_limits<int>::max())) {
+      LBANN_ERROR("coalesced message of ", total, " bytes is too large");
+    }
+    m_stage_send_buffers.emplace_back(total);
+    El::byte* buf = m_stage_send_buffers.back().data();
+    for (auto index : ids) {
+      std::memcpy(buf, get_owned_record(index), m_record_size);
+      buf += m_record_size;
+    }
+    m_send_requests.emplace_back();
+    m_comm->nb_tagged_send<El::byte>(m_stage_send_buffers.back().data(),
+                                     total,
+                                     p,
+                                     record_exchange_tag,
+                                     m_send_requests.back(),
+                                     m_comm->get_trainer_comm());
+  }
+  for (int p = 0; p < m_np_in_trainer; ++p) {
+    const auto& ids = m_stage_1_recv_ids[p];
+    if (ids.empty() || p == m_rank_in_trainer) {
+      continue;
+    }
+    const size_t total = ids.size() * m_record_size;
+    if (total > static_cast<size_t>(std::numeric_limits<int>::max())) {
+      LBANN_ERROR("coalesced message of ", total, " bytes is too large");
+    }
+    m_stage_recv_buffers.emplace_back(total);
+    m_recv_requests.emplace_back();
+    m_comm->nb_tagged_recv<El::byte>(m_stage_recv_buffers.back().data(),
+                                     total,
+                                     p,
+                                     record_exchange_tag,
+                                     m_recv_requests.back(),
+                                     m_comm->get_trainer_comm());
+  }
+}
+
+void data_store_conduit::finish_exchange_records()
+{
+  double tm5 = get_time();
+  m_comm->wait_all(m_send_requests);
+  m_comm->wait_all(m_recv_requests);
+  m_comm->trainer_barrier();
+  m_wait_all_time += (get_time() - tm5);
+
+  //========================================================================
+  // construct the Nodes needed by me for the current minibatch; they
+  // view the received records, or my own, without parsing a schema
+
+  tm5 = get_time();
+  m_minibatch_data.clear();
+  size_t b = 0;
+  for (int p = 0; p < m_np_in_trainer; ++p) {
+    const auto& ids = m_stage_1_recv_ids[p];
+    if (ids.empty()) {
+      continue;
+    }
+    if (p == m_rank_in_trainer) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      for (auto index : ids) {
+        set_record_view(m_minibatch_data[index],
+                        index,
+                        get_owned_record(index));
+      }
+      continue;
+    }
+    El::byte* ptr = m_stage_recv_buffers[b++].data();
+    for (auto index : ids) {
+      set_record_view(m_minibatch_data[index], index, ptr);
+      ptr += m_record_size;
+    }
+  }
+  m_rebuild_time += (get_time() - tm5);
+}
+
 int data_store_conduit::build_indices_i_will_recv(uint64_t current_pos,
                                                   uint64_t mb_size)
 {
@@ -797,7 +1624,7 @@ int data_store_conduit::build_indices_i_will_send(uint64_t current_pos,
     auto index = (*m_shuffled_indices)[i];
     /// If this rank owns the index send it to the (i%m_np)'th rank
     bool is_mine = false;
-    if (m_data.find(index) != m_data.end()) {
+    if (owns_sample(index)) {
       is_mine = true;
     }
     else if (m_spilled_nodes.find(index) != m_spilled_nodes.end()) {
@@ -853,11 +1680,42 @@ void data_store_conduit::build_preloaded_owner_map(
   m_owner_maps_were_exchanged = true;
 }
 
+int data_store_conduit::get_owner(uint64_t data_id) const
+{
+  auto it = m_owner.find(std::make_pair(data_id, m_offset_in_partition));
+  if (it == m_owner.end()) {
+    return -1;
+  }
+  return it->second;
+}
+
+int data_store_conduit::get_destination(uint64_t pos) const
+{
+#ifdef LBANN_HAS_DISTCONV
+  int num_ranks_in_partition = dc::get_number_of_io_partitions();
+#else
+  int num_ranks_in_partition = 1;
+#endif // LBANN_HAS_DISTCONV
+  return ((int)(pos % m_owner_map_mb_size) % m_num_partitions_in_trainer) *
+           num_ranks_in_partition +
+         m_offset_in_partition;
+}
+
 const conduit::Node& data_store_conduit::get_random_node() const
 {
   std::lock_guard<std::mutex> lock(m_mutex);
   size_t sz = m_data.size();
 
+  // Records have no message node, so return a view shaped like one
+  if (sz == 0 && !m_record_slots.empty()) {
+    auto it = std::next(m_record_slots.begin(),
+                        random() % m_record_slots.size());
+    set_record_view(m_random_record["data"],
+                    it->first,
+                    get_record(it->second));
+    return m_random_record;
+  }
+
   // Deal with edge case
   if (sz == 0) {
     LBANN_ERROR("can't return random node since we have no data "
@@ -1087,9 +1945,7 @@ void data_store_conduit::check_mem_capacity(lbann_comm* comm,
 bool data_store_conduit::has_conduit_node(uint64_t data_id) const
 {
   std::lock_guard<std::mutex> lock(m_mutex);
-  std::unordered_map<uint64_t, conduit::Node>::const_iterator t =
-    m_data.find(data_id);
-  return t != m_data.end();
+  return owns_sample(data_id);
 }
 
 void data_store_conduit::set_shuffled_indices(
@@ -1177,6 +2033,10 @@ void data_store_conduit::set_loading_is_complete()
   set_is_explicitly_loading(false);
   check_query_flags();
 
+  if (m_spill_segments) {
+    m_spill_segments->flush();
+  }
+
   if (m_run_checkpoint_test) {
     test_checkpoint(m_spill_dir_base);
   }
@@ -1903,7 +2763,8 @@ void data_store_conduit::flush_profile_file() const
 
 size_t data_store_conduit::get_num_global_indices() const
 {
-  size_t n = m_comm->trainer_allreduce<size_t>(m_data.size());
+  size_t n =
+    m_comm->trainer_allreduce<size_t>(m_data.size() + m_record_slots.size());
   return n;
 }
 
@@ -2036,6 +2897,11 @@ void data_store_conduit::write_checkpoint(std::string dir_name)
   for (auto t : m_data) {
     spill_conduit_node(t.second["data"], t.first);
   }
+  for (const auto& t : m_record_slots) {
+    conduit::Node nd;
+    set_record_view(nd, t.first, get_record(t.second));
+    spill_conduit_node(nd, t.first);
+  }
   m_metadata.close();
   PROFILE("time to write checkpoint: ", (get_time() - tm1));
 }
@@ -2254,6 +3120,20 @@ void data_store_conduit::load_spilled_conduit_nodes()
 {
   m_data.clear();
 
+  if (m_spill_segments) {
+    std::vector<char> bytes;
+    for (const auto& v : m_indices_to_send) {
+      for (const auto& id : v) {
+        m_spill_segments->read(id, bytes);
+        conduit::Node n_msg;
+        unpack_sample_message(reinterpret_cast<conduit::uint8*>(bytes.data()),
+                              n_msg);
+        build_node_for_sending(n_msg["data"], m_data[id]);
+      }
+    }
+    return;
+  }
+
   for (const auto& v : m_indices_to_send) {
     for (const auto& id : v) {
       map_ii_t::const_iterator it = m_spilled_nodes.find(id);
@@ -2274,6 +3154,24 @@ void data_store_conduit::load_spilled_conduit_nodes()
   }
 }
 
+void data_store_conduit::readahead_spilled_conduit_nodes(uint64_t current_pos,
+                                                         uint64_t mb_size)
+{
+  if (!m_spill_segments) {
+    return;
+  }
+  std::vector<uint64_t> ids;
+  const uint64_t end =
+    std::min<uint64_t>(current_pos + mb_size, m_shuffled_indices->size());
+  for (uint64_t i = current_pos; i < end; ++i) {
+    auto index = (*m_shuffled_indices)[i];
+    if (m_spilled_nodes.find(index) != m_spilled_nodes.end()) {
+      ids.push_back(index);
+    }
+  }
+  m_spill_segments->readahead(ids);
+}
+
 void data_store_conduit::open_informational_files()
 {
   auto& arg_parser = global_argument_parser();
@@ -2532,6 +3430,7 @@ size_t data_store_conduit::get_mem_usage()
     }
     r += nd.total_bytes_compact();
   }
+  r += m_record_slots.size() * m_record_size;
   return r;
 }
 
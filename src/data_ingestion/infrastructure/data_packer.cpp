@@ -32,6 +32,118 @@
 #include <conduit/conduit_node.hpp>
 #include <conduit/conduit_utils.hpp>
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/** @brief Where a data field lives within a sample node, and its layout.
+ *
+ *  Samples produced by the same reader share a schema, so the path
+ *  lookup is done once and replayed as a sequence of child indices
+ *  below the sample's data_id node. The child names are kept to
+ *  validate each replayed step.
+ */
+struct field_packing_plan
+{
+  std::vector<conduit::index_t> child_indices;
+  std::vector<std::string> child_names;
+  conduit::DataType::TypeID dtype_id = conduit::DataType::EMPTY_ID;
+  conduit::index_t num_elements = 0;
+  bool valid = false;
+};
+
+bool is_supported_dtype(conduit::DataType::TypeID id)
+{
+  switch (id) {
+  case conduit::DataType::FLOAT64_ID:
+  case conduit::DataType::FLOAT32_ID:
+  case conduit::DataType::INT64_ID:
+  case conduit::DataType::INT32_ID:
+  case conduit::DataType::UINT64_ID:
+  case conduit::DataType::UINT32_ID:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/** Resolve data_field in sample and record how to find it again. The
+ *  plan is left invalid if the sample cannot be packed into a matrix
+ *  of the given height, in which case the checked path reports why.
+ */
+void build_packing_plan(field_packing_plan& plan,
+                        lbann::data_field_type const& data_field,
+                        conduit::Node const& sample,
+                        conduit::index_t height)
+{
+  plan.valid = false;
+  plan.child_indices.clear();
+  plan.child_names.clear();
+  if (sample.number_of_children() != 1)
+    return;
+  conduit::Node const* node = &sample.child(0);
+  if (!node->has_path(data_field))
+    return;
+  std::string curr, next, rest = data_field;
+  while (!rest.empty()) {
+    conduit::utils::split_path(rest, curr, next);
+    if (!curr.empty()) {
+      auto const idx = node->schema().child_index(curr);
+      node = &node->child(idx);
+      plan.child_indices.push_back(idx);
+      plan.child_names.push_back(curr);
+    }
+    rest = next;
+  }
+  plan.dtype_id = static_cast<conduit::DataType::TypeID>(node->dtype().id());
+  plan.num_elements = node->dtype().number_of_elements();
+  plan.valid = (is_supported_dtype(plan.dtype_id) &&
+                plan.num_elements == height && !plan.child_indices.empty());
+}
+
+/** Replay a plan on a sample. Returns null if the sample does not
+ *  match the plan's schema or the matrix height.
+ */
+conduit::Node const* resolve_packing_plan(field_packing_plan const& plan,
+                                          conduit::Node const& sample,
+                                          conduit::index_t height)
+{
+  if (!plan.valid || plan.num_elements != height ||
+      sample.number_of_children() != 1)
+    return nullptr;
+  conduit::Node const* node = &sample.child(0);
+  for (size_t i = 0; i < plan.child_indices.size(); ++i) {
+    auto const idx = plan.child_indices[i];
+    if (idx >= node->number_of_children())
+      return nullptr;
+    node = &node->child(idx);
+    if (node->name() != plan.child_names[i])
+      return nullptr;
+  }
+  if (node->dtype().id() != plan.dtype_id ||
+      node->dtype().number_of_elements() != plan.num_elements)
+    return nullptr;
+  return node;
+}
+
+template <typename SampleT>
+void write_columns(lbann::CPUMat& X,
+                   std::vector<conduit::Node const*> const& nodes,
+                   size_t const n_elts)
+{
+  for (size_t mb_idx = 0; mb_idx < nodes.size(); ++mb_idx) {
+    if (nodes[mb_idx] == nullptr)
+      continue;
+    auto const* const sample =
+      static_cast<SampleT const*>(nodes[mb_idx]->element_ptr(0));
+    std::copy_n(sample, n_elts, X.Buffer() + X.LDim() * mb_idx);
+  }
+}
+
+} // namespace
+
 /* The data_packer class is designed to extract data fields from
  * Conduit nodes and pack them into Hydrogen matrices.
  */
@@ -39,16 +151,54 @@ void lbann::data_packer::extract_data_fields_from_samples(
   std::vector<conduit::Node> const& samples,
   std::map<data_field_type, CPUMat*>& input_buffers)
 {
+  // Plans are cached per I/O thread so that no locking is needed
+  thread_local std::unordered_map<data_field_type, field_packing_plan> plans;
+
   auto const num_samples = samples.size();
+  std::vector<conduit::Node const*> nodes(num_samples);
   for (auto const& [data_field, X] : input_buffers) {
     LBANN_ASSERT_DEBUG(num_samples <= static_cast<size_t>(X->Width()));
+    auto& plan = plans[data_field];
+    // (Re)plan whenever the schema of the batch differs from the cached one
+    if (num_samples > 0 &&
+        resolve_packing_plan(plan, samples.front(), X->Height()) == nullptr)
+      build_packing_plan(plan, data_field, samples.front(), X->Height());
+
+    // Samples that match the plan are packed below in one type-resolved
+    // pass. Any other sample goes through the checked per-sample path,
+    // which also verifies that the extracted sample's linearized size
+    // equals the height of X.
     for (size_t mb_idx = 0UL; mb_idx < num_samples; ++mb_idx) {
-      // This call will verify that the extracted sample has the
-      // expected size. In particular, the extracted sample's
-      // linearized size must equal the height of the input matrix
-      // X. The assertion above verifies that the matrix X has
-      // sufficient width to accommodate the sample.
-      extract_data_field_from_sample(data_field, samples[mb_idx], *X, mb_idx);
+      nodes[mb_idx] =
+        resolve_packing_plan(plan, samples[mb_idx], X->Height());
+      if (nodes[mb_idx] == nullptr)
+        extract_data_field_from_sample(data_field, samples[mb_idx], *X, mb_idx);
+    }
+    if (!plan.valid)
+      continue;
+
+    size_t const n_elts = plan.num_elements;
+    switch (plan.dtype_id) {
+    case conduit::DataType::FLOAT64_ID:
+      write_columns<conduit::float64>(*X, nodes, n_elts);
+      break;
+    case conduit::DataType::FLOAT32_ID:
+      write_columns<conduit::float32>(*X, nodes, n_elts);
+      break;
+    case conduit::DataType::INT64_ID:
+      write_columns<conduit::int64>(*X, nodes, n_elts);
+      break;
+    case conduit::DataType::INT32_ID:
+      write_columns<conduit::int32>(*X, nodes, n_elts);
+      break;
+    case conduit::DataType::UINT64_ID:
+      write_columns<conduit::uint64>(*X, nodes, n_elts);
+      break;
+    case conduit::DataType::UINT32_ID:
+      write_columns<conduit::uint32>(*X, nodes, n_elts);
+      break;
+    default:
+      break;
     }
   }
 }
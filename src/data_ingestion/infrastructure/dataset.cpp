@@ -122,6 +122,34 @@ uint64_t dataset::get_next_position() const
   }
 }
 
+uint64_t dataset::get_mini_batch_size_ahead(uint64_t num_steps) const
+{
+  const uint64_t mini_batch_idx = m_current_mini_batch_idx + num_steps;
+  if (mini_batch_idx > (m_num_iterations_per_epoch - 1)) {
+    return 0;
+  }
+  else if (mini_batch_idx == (m_num_iterations_per_epoch - 1)) {
+    return m_last_mini_batch_size;
+  }
+  else {
+    return m_mini_batch_size;
+  }
+}
+
+uint64_t dataset::get_position_ahead(uint64_t num_steps) const
+{
+  uint64_t pos = m_current_pos;
+  for (uint64_t i = 0; i < num_steps; ++i) {
+    if (m_current_mini_batch_idx + i == (m_num_iterations_per_epoch - 1)) {
+      pos += m_stride_to_last_mini_batch;
+    }
+    else {
+      pos += m_stride_to_next_mini_batch;
+    }
+  }
+  return pos;
+}
+
 void dataset::set_mini_batch_size(const uint64_t s) { m_mini_batch_size = s; }
 
 void dataset::print_config()
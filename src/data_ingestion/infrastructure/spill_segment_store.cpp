@@ -0,0 +1,338 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_ingestion/infrastructure/spill_segment_store.hpp"
+
+#include "lbann/utils/exception.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace lbann {
+
+spill_segment_store::spill_segment_store(std::string dir,
+                                         size_t segment_size,
+                                         size_t max_pending_bytes)
+  : m_dir(std::move(dir)),
+    m_segment_size(segment_size),
+    m_max_pending_bytes(max_pending_bytes)
+{
+  if (m_segment_size == 0) {
+    LBANN_ERROR("spill segment size must be positive");
+  }
+  m_worker = std::thread(&spill_segment_store::worker, this);
+}
+
+spill_segment_store::~spill_segment_store()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+  for (size_t i = 0; i < m_segment_fds.size(); ++i) {
+    ::close(m_segment_fds[i]);
+    ::unlink(segment_filename(i).c_str());
+  }
+}
+
+void spill_segment_store::append(uint64_t id, const void* buf, size_t len)
+{
+  auto bytes = std::make_shared<const std::vector<char>>(
+    static_cast<const char*>(buf),
+    static_cast<const char*>(buf) + len);
+  std::unique_lock<std::mutex> lock(m_mutex);
+  check_worker_error();
+  // Bound the memory held by records waiting to be written
+  m_cv.wait(lock, [&] {
+    return m_pending_bytes == 0 ||
+           m_pending_bytes + len <= m_max_pending_bytes || m_worker_error;
+  });
+  check_worker_error();
+  auto it = m_pending.find(id);
+  if (it != m_pending.end()) {
+    m_pending_bytes -= it->second->size();
+    it->second = bytes;
+  }
+  else {
+    m_pending.emplace(id, bytes);
+    m_write_queue.push_back(id);
+  }
+  m_pending_bytes += len;
+  m_readahead_cache.erase(id);
+  lock.unlock();
+  m_cv.notify_all();
+}
+
+void spill_segment_store::flush()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [&] {
+    return (m_write_queue.empty() && !m_writing) || m_worker_error;
+  });
+  check_worker_error();
+}
+
+void spill_segment_store::readahead(const std::vector<uint64_t>& ids)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    check_worker_error();
+    m_readahead_window.clear();
+    m_readahead_queue.clear();
+    for (const auto& id : ids) {
+      if (m_index.count(id) != 0 && m_pending.count(id) == 0 &&
+          m_readahead_window.insert(id).second &&
+          m_readahead_cache.count(id) == 0) {
+        m_readahead_queue.push_back(id);
+      }
+    }
+    // Drop whatever the previous window cached but this one doesn't use
+    for (auto it = m_readahead_cache.begin(); it != m_readahead_cache.end();) {
+      if (m_readahead_window.count(it->first) == 0) {
+        it = m_readahead_cache.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+  m_cv.notify_all();
+}
+
+void spill_segment_store::read(uint64_t id, std::vector<char>& out)
+{
+  int fd = -1;
+  record_location loc;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    check_worker_error();
+    m_readahead_window.erase(id);
+    auto cached = m_readahead_cache.find(id);
+    if (cached != m_readahead_cache.end()) {
+      out = std::move(cached->second);
+      m_readahead_cache.erase(cached);
+      return;
+    }
+    auto pending = m_pending.find(id);
+    if (pending != m_pending.end()) {
+      out = *pending->second;
+      return;
+    }
+    auto it = m_index.find(id);
+    if (it == m_index.end()) {
+      LBANN_ERROR("no spilled record for sample id ", id, " in ", m_dir);
+    }
+    loc = it->second;
+    fd = m_segment_fds[loc.segment];
+  }
+  read_record(fd, loc, out);
+}
+
+bool spill_segment_store::contains(uint64_t id) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_index.count(id) != 0 || m_pending.count(id) != 0;
+}
+
+size_t spill_segment_store::size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t n = m_index.size();
+  for (const auto& t : m_pending) {
+    if (m_index.count(t.first) == 0) {
+      ++n;
+    }
+  }
+  return n;
+}
+
+size_t spill_segment_store::get_num_segments() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_segment_fds.size();
+}
+
+void spill_segment_store::worker()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [&] {
+      return m_stop || !m_write_queue.empty() || !m_readahead_queue.empty();
+    });
+    if (m_stop) {
+      return;
+    }
+    try {
+      // Writes go first so that readahead sees a complete index
+      if (!m_write_queue.empty()) {
+        const uint64_t id = m_write_queue.front();
+        m_write_queue.pop_front();
+        auto bytes = m_pending.at(id);
+        m_writing = true;
+        lock.unlock();
+        write_record(id, *bytes);
+        lock.lock();
+        m_writing = false;
+        // The record may have been replaced while it was being written
+        auto it = m_pending.find(id);
+        if (it != m_pending.end() && it->second == bytes) {
+          m_pending_bytes -= bytes->size();
+          m_pending.erase(it);
+        }
+        else if (it != m_pending.end()) {
+          m_write_queue.push_back(id);
+        }
+        lock.unlock();
+        m_cv.notify_all();
+        lock.lock();
+        continue;
+      }
+
+      const uint64_t id = m_readahead_queue.front();
+      m_readahead_queue.pop_front();
+      if (m_readahead_window.count(id) == 0 ||
+          m_readahead_cache.count(id) != 0) {
+        continue;
+      }
+      const record_location loc = m_index.at(id);
+      const int fd = m_segment_fds[loc.segment];
+      lock.unlock();
+      std::vector<char> bytes;
+      read_record(fd, loc, bytes);
+      lock.lock();
+      // Only keep it if it's still wanted
+      if (m_readahead_window.count(id) != 0) {
+        m_readahead_cache[id] = std::move(bytes);
+      }
+    }
+    catch (...) {
+      if (!lock.owns_lock()) {
+        lock.lock();
+      }
+      m_writing = false;
+      m_worker_error = std::current_exception();
+      lock.unlock();
+      m_cv.notify_all();
+      return;
+    }
+  }
+}
+
+void spill_segment_store::write_record(uint64_t id,
+                                       const std::vector<char>& bytes)
+{
+  // Only the worker opens segments and advances m_cur_segment_bytes,
+  // but readers look up m_segment_fds under the lock
+  int fd;
+  record_location loc;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_segment_fds.empty() ||
+        (m_cur_segment_bytes > 0 &&
+         m_cur_segment_bytes + bytes.size() > m_segment_size)) {
+      const std::string fn = segment_filename(m_segment_fds.size());
+      const int new_fd = ::open(fn.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+      if (new_fd < 0) {
+        LBANN_ERROR("failed to open spill segment ",
+                    fn,
+                    ": ",
+                    std::strerror(errno));
+      }
+      m_segment_fds.push_back(new_fd);
+      m_cur_segment_bytes = 0;
+    }
+    fd = m_segment_fds.back();
+    loc = {m_segment_fds.size() - 1, m_cur_segment_bytes, bytes.size()};
+    m_cur_segment_bytes += bytes.size();
+  }
+
+  size_t written = 0;
+  while (written < bytes.size()) {
+    const ssize_t n = ::pwrite(fd,
+                               bytes.data() + written,
+                               bytes.size() - written,
+                               loc.offset + written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      LBANN_ERROR("failed to write spilled record for sample id ",
+                  id,
+                  " to ",
+                  segment_filename(loc.segment),
+                  ": ",
+                  std::strerror(errno));
+    }
+    written += n;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_index[id] = loc;
+}
+
+void spill_segment_store::read_record(int fd,
+                                      const record_location& loc,
+                                      std::vector<char>& out) const
+{
+  out.resize(loc.length);
+  size_t done = 0;
+  while (done < loc.length) {
+    const ssize_t n =
+      ::pread(fd, out.data() + done, loc.length - done, loc.offset + done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      LBANN_ERROR("failed to read spilled record from ",
+                  segment_filename(loc.segment),
+                  " at offset ",
+                  loc.offset,
+                  ": ",
+                  (n == 0 ? "unexpected end of file" : std::strerror(errno)));
+    }
+    done += n;
+  }
+}
+
+void spill_segment_store::check_worker_error() const
+{
+  if (m_worker_error) {
+    std::rethrow_exception(m_worker_error);
+  }
+}
+
+std::string spill_segment_store::segment_filename(size_t segment) const
+{
+  return m_dir + "/segment_" + std::to_string(segment);
+}
+
+} // namespace lbann
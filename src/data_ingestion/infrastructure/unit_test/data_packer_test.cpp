@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/data_ingestion/infrastructure/data_packer.hpp>
+
+#include <conduit/conduit_node.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+conduit::Node make_sample(int id, double value, bool int_labels)
+{
+  conduit::Node sample;
+  auto& node = sample[std::to_string(id)];
+  std::vector<double> samples(4, value);
+  node["inputs/samples"].set(samples);
+  if (int_labels) {
+    std::vector<conduit::int32> labels(2, static_cast<conduit::int32>(id));
+    node["labels"].set(labels);
+  }
+  else {
+    std::vector<float> labels(2, static_cast<float>(id));
+    node["labels"].set(labels);
+  }
+  return sample;
+}
+
+} // namespace
+
+TEST_CASE("Data packer", "[seq][data_packer]")
+{
+  lbann::CPUMat samples_mat(4, 6), labels_mat(2, 6);
+  std::map<lbann::data_field_type, lbann::CPUMat*> buffers = {
+    {"inputs/samples", &samples_mat},
+    {"labels", &labels_mat}};
+
+  SECTION("Batches are packed column by column")
+  {
+    // The label type changes midway through, so the cached plan has to
+    // be abandoned for the later samples
+    std::vector<conduit::Node> samples;
+    for (int i = 0; i < 6; ++i) {
+      samples.push_back(make_sample(i, 0.5 * i, i < 3));
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+      lbann::data_packer::extract_data_fields_from_samples(samples, buffers);
+      for (int j = 0; j < 6; ++j) {
+        for (int i = 0; i < 4; ++i) {
+          CHECK(samples_mat(i, j) == lbann::DataType(0.5 * j));
+        }
+        for (int i = 0; i < 2; ++i) {
+          CHECK(labels_mat(i, j) == lbann::DataType(j));
+        }
+      }
+    }
+  }
+
+  SECTION("Missing fields are reported")
+  {
+    std::vector<conduit::Node> samples = {make_sample(0, 1.0, true)};
+    samples.front()["0"].remove("labels");
+    CHECK_THROWS(
+      lbann::data_packer::extract_data_fields_from_samples(samples, buffers));
+  }
+
+  SECTION("Size mismatches are reported")
+  {
+    std::vector<conduit::Node> samples = {make_sample(0, 1.0, true)};
+    lbann::CPUMat short_mat(3, 1);
+    buffers["inputs/samples"] = &short_mat;
+    CHECK_THROWS(
+      lbann::data_packer::extract_data_fields_from_samples(samples, buffers));
+  }
+}
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/data_ingestion/infrastructure/spill_segment_store.hpp>
+
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+std::vector<char> make_record(uint64_t id, size_t len)
+{
+  std::vector<char> bytes(len);
+  std::iota(bytes.begin(), bytes.end(), static_cast<char>(id));
+  return bytes;
+}
+
+} // namespace
+
+TEST_CASE("Spill segment store", "[seq][data_store][spill]")
+{
+  char tmpl[] = "/tmp/lbann_spill_segment_test_XXXXXX";
+  REQUIRE(mkdtemp(tmpl) != nullptr);
+  const std::string dir(tmpl);
+
+  {
+    // Small segments so that records span several files
+    lbann::spill_segment_store store(dir, 1000);
+    constexpr uint64_t num_records = 32;
+    for (uint64_t id = 0; id < num_records; ++id) {
+      const auto bytes = make_record(id, 100 + id);
+      store.append(id, bytes.data(), bytes.size());
+    }
+
+    SECTION("Pending and written records can be read back")
+    {
+      std::vector<char> out;
+      store.read(3, out);
+      CHECK(out == make_record(3, 103));
+      store.flush();
+      CHECK(store.size() == num_records);
+      CHECK(store.get_num_segments() > 1);
+      for (uint64_t id = 0; id < num_records; ++id) {
+        store.read(id, out);
+        CHECK(out == make_record(id, 100 + id));
+      }
+    }
+
+    SECTION("Readahead windows serve reads")
+    {
+      store.flush();
+      std::vector<char> out;
+      store.readahead({5, 6, 7, 1000});
+      store.readahead({7, 8, 9});
+      for (uint64_t id : {7, 8, 9, 5}) {
+        store.read(id, out);
+        CHECK(out == make_record(id, 100 + id));
+      }
+    }
+
+    SECTION("Appending an existing id replaces its record")
+    {
+      const auto bytes = make_record(42, 10);
+      store.append(4, bytes.data(), bytes.size());
+      store.flush();
+      std::vector<char> out;
+      store.read(4, out);
+      CHECK(out == bytes);
+      CHECK(store.size() == num_records);
+    }
+
+    SECTION("Unknown ids are an error")
+    {
+      std::vector<char> out;
+      CHECK(!store.contains(num_records));
+      CHECK_THROWS(store.read(num_records, out));
+    }
+  }
+
+  ::rmdir(dir.c_str());
+}
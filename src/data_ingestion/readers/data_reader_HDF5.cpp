@@ -30,9 +30,16 @@
 #include "lbann/data_ingestion/readers/data_reader_sample_list_impl.hpp"
 #include "lbann/data_ingestion/readers/sample_list_impl.hpp"
 #include "lbann/data_ingestion/readers/sample_list_open_files_impl.hpp"
-#include "lbann/transforms/repack_HWC_to_CHW_layout.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/running_statistics.hpp"
 #include "lbann/utils/timer.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <vector>
+
 namespace lbann {
 namespace {
 
@@ -63,37 +70,73 @@ void do_normalize(T* const data,
   }
 }
 
-// Pack 2-D tensor into a channels-first from a channels-last storage format
-template <typename T>
-void do_repack_tensor_HWC_to_CHW(T* const src_buf,
-                                 size_t const n_elts,
-                                 size_t const n_rows,
-                                 size_t const n_cols,
-                                 size_t const n_channels)
+// Number of pixels (or voxels) moved together when converting from
+// channels last to channels first. A tile of channels-last input stays
+// in L1 while the contiguous run of each channel's output is written,
+// so the inner loop is a unit-stride store that the compiler can
+// vectorize.
+constexpr size_t repack_tile_size = 64;
+
+// Convert n_pixels x n_channels channels-last data in src to channels
+// first in dst. With Normalize, x * scale[k] + bias[k] is applied to
+// channel k in the same pass over memory.
+template <bool Normalize, typename T>
+void do_repack_channels_last_to_first(T const* __restrict__ src,
+                                      T* __restrict__ dst,
+                                      size_t const n_pixels,
+                                      size_t const n_channels,
+                                      const double* scale,
+                                      const double* bias)
 {
-  std::vector<T> work;
-  work.reserve(n_elts);
-  T* const dst_buf = work.data();
-  std::vector<size_t> dims = {n_channels, n_rows, n_cols};
-  transform::repack_HWC_to_CHW(src_buf, dst_buf, dims);
-  std::copy_n(dst_buf, n_elts, src_buf);
+  for (size_t p0 = 0; p0 < n_pixels; p0 += repack_tile_size) {
+    size_t const p1 = std::min(p0 + repack_tile_size, n_pixels);
+    for (size_t k = 0; k < n_channels; k++) {
+      T const* const in = src + k;
+      T* const out = dst + k * n_pixels;
+      if constexpr (Normalize) {
+        double const s = scale[k];
+        double const b = bias[k];
+        for (size_t p = p0; p < p1; p++) {
+          out[p] = in[p * n_channels] * s + b;
+        }
+      }
+      else {
+        for (size_t p = p0; p < p1; p++) {
+          out[p] = in[p * n_channels];
+        }
+      }
+    }
+  }
 }
 
-// Pack 3-D tensor into a channels-first from a channels-last storage format
+// In-place wrapper: buf holds n_elts = n_pixels * n_channels values.
+// Either both scale and bias point to n_channels values, or both are
+// null and the data is only repacked.
 template <typename T>
-void do_repack_tensor_DHWC_to_CDHW(T* const src_buf,
-                                   size_t const n_elts,
-                                   size_t const depth,
-                                   size_t const height,
-                                   size_t const width,
-                                   size_t const n_channels)
+void do_repack_channels_last_to_first(T* const buf,
+                                      size_t const n_elts,
+                                      size_t const n_channels,
+                                      const double* scale,
+                                      const double* bias)
 {
-  std::vector<T> work;
-  work.reserve(n_elts);
-  T* const dst_buf = work.data();
-  std::vector<size_t> dims = {n_channels, depth, height, width};
-  transform::repack_DHWC_to_CDHW(src_buf, dst_buf, dims);
-  std::copy_n(dst_buf, n_elts, src_buf);
+  std::vector<T> work(buf, buf + n_elts);
+  size_t const n_pixels = n_elts / n_channels;
+  if (scale != nullptr) {
+    do_repack_channels_last_to_first<true>(work.data(),
+                                           buf,
+                                           n_pixels,
+                                           n_channels,
+                                           scale,
+                                           bias);
+  }
+  else {
+    do_repack_channels_last_to_first<false>(work.data(),
+                                            buf,
+                                            n_pixels,
+                                            n_channels,
+                                            nullptr,
+                                            nullptr);
+  }
 }
 
 } // namespace
@@ -182,6 +225,7 @@ void hdf5_data_reader::copy_members(const hdf5_data_reader& rhs)
   m_experiment_schema = rhs.m_experiment_schema;
   m_data_schema = rhs.m_data_schema;
   m_useme_node_map = rhs.m_useme_node_map;
+  m_field_plans = rhs.m_field_plans;
   // m_data_map should not be copied, as it contains pointers, and is only
   // needed for setting up other structures during load
 
@@ -249,12 +293,223 @@ void hdf5_data_reader::load()
               << "; num samples: " << m_shuffled_indices.size() << std::endl;
   }
 
+  const std::string normalization_filename =
+    arg_parser.get<std::string>(LBANN_OPTION_HDF5_COMPUTE_NORMALIZATION);
+  if (!normalization_filename.empty() && get_role() == "train") {
+    compute_normalization_statistics(normalization_filename);
+  }
+
   if (!arg_parser.get<bool>(LBANN_OPTION_QUIET) &&
       get_comm()->am_world_master()) {
     print_metadata();
   }
 }
 
+void hdf5_data_reader::compute_normalization_statistics(
+  const std::string& filename)
+{
+  double tm1 = get_time();
+
+  // Find the marked fields; they are read without normalization or
+  // repacking, so channels-last images keep their channel stride
+  std::vector<FieldPlan> raw_plans;
+  std::vector<int64_t> num_channels;
+  for (const FieldPlan& plan : m_field_plans) {
+    const conduit::Node& metadata =
+      m_useme_node_map.at(plan.node_path.substr(1)).child(s_metadata_node_name);
+    if (!is_marked_for_normalization(metadata)) {
+      continue;
+    }
+    FieldPlan raw_plan = plan;
+    raw_plan.normalize = false;
+    raw_plan.repack = false;
+    raw_plans.push_back(std::move(raw_plan));
+    num_channels.push_back(
+      (metadata.has_child(HDF5_METADATA_KEY_CHANNELS) &&
+           is_hdf5_field_channels_last(metadata)
+         ? metadata[HDF5_METADATA_KEY_CHANNELS].to_int64()
+         : 1));
+  }
+  if (raw_plans.empty()) {
+    LBANN_WARNING("no fields in the experiment schema for role ",
+                  get_role(),
+                  " are marked '",
+                  HDF5_METADATA_KEY_NORMALIZE,
+                  ": true'; skipping the normalization pass");
+    return;
+  }
+
+  // Stream this rank's contiguous share of the samples in sample list
+  // order, so that each file is opened once
+  std::vector<uint64_t> indices(m_shuffled_indices);
+  std::sort(indices.begin(), indices.end());
+  const uint64_t rank = m_comm->get_rank_in_trainer();
+  const uint64_t num_ranks = m_comm->get_procs_per_trainer();
+  const uint64_t begin = rank * indices.size() / num_ranks;
+  const uint64_t end = (rank + 1) * indices.size() / num_ranks;
+  std::vector<std::vector<RunningStats>> stats(raw_plans.size());
+  for (size_t f = 0; f < raw_plans.size(); ++f) {
+    stats[f].resize(num_channels[f]);
+  }
+  std::swap(m_field_plans, raw_plans);
+  for (uint64_t j = begin; j < end; ++j) {
+    conduit::Node node;
+    auto [file_handle, sample_name] =
+      data_reader_sample_list::open_file(indices[j]);
+    try {
+      load_sample(node, file_handle, sample_name);
+    }
+    catch (...) {
+      close_file(indices[j]);
+      throw;
+    }
+    close_file(indices[j]);
+    for (size_t f = 0; f < m_field_plans.size(); ++f) {
+      conduit::Node values;
+      node[m_field_plans[f].node_path].to_float64_array(values);
+      const double* data = values.as_float64_ptr();
+      const size_t n = values.dtype().number_of_elements();
+      const size_t n_channels = stats[f].size();
+      for (size_t k = 0; k < n; ++k) {
+        stats[f][k % n_channels].insert(data[k]);
+      }
+    }
+  }
+  std::swap(m_field_plans, raw_plans);
+
+  // Merge the accumulators across the trainer
+  constexpr size_t num_moments = 5;
+  std::vector<double> local_moments;
+  for (const auto& field_stats : stats) {
+    for (const auto& s : field_stats) {
+      local_moments.insert(local_moments.end(),
+                           {static_cast<double>(s.samples()),
+                            s.mean(),
+                            s.sum_squared_deviations(),
+                            s.min(),
+                            s.max()});
+    }
+  }
+  const int count = local_moments.size();
+  std::vector<double> all_moments(count * num_ranks);
+  std::vector<int> counts(num_ranks, count);
+  std::vector<int> displacements(num_ranks);
+  for (uint64_t r = 0; r < num_ranks; ++r) {
+    displacements[r] = r * count;
+  }
+  m_comm->trainer_all_gather(local_moments,
+                             all_moments,
+                             counts,
+                             displacements);
+  size_t pos = 0;
+  for (auto& field_stats : stats) {
+    for (auto& s : field_stats) {
+      s.reset();
+      for (uint64_t r = 0; r < num_ranks; ++r) {
+        const double* m = &all_moments[r * count + pos];
+        s.merge(
+          RunningStats(static_cast<size_t>(m[0]), m[1], m[2], m[3], m[4]));
+      }
+      pos += num_moments;
+    }
+  }
+
+  // Record the normalization in the experiment schema
+  for (size_t f = 0; f < raw_plans.size(); ++f) {
+    std::vector<double> scale, bias;
+    for (const auto& s : stats[f]) {
+      const double stddev = s.stddev();
+      const double inv_stddev = (stddev > 0. ? 1. / stddev : 1.);
+      scale.push_back(inv_stddev);
+      bias.push_back(-s.mean() * inv_stddev);
+    }
+    const std::string path = raw_plans[f].node_path.substr(1);
+    set_normalization(path, scale, bias);
+    if (get_comm()->am_world_master()) {
+      std::cout << "field " << path << ": " << stats[f].front().samples()
+                << " values per channel; scale[0]: " << scale.front()
+                << " bias[0]: " << bias.front() << std::endl;
+    }
+  }
+  build_field_plans();
+
+  if (!filename.empty() && m_comm->am_trainer_master()) {
+    conduit::relay::io::save(m_experiment_schema, filename, "yaml");
+  }
+  if (get_comm()->am_world_master()) {
+    std::cout << "hdf5_data_reader::compute_normalization_statistics() time: "
+              << get_time() - tm1 << "; num samples: " << indices.size()
+              << std::endl;
+  }
+}
+
+void hdf5_data_reader::copy_normalization_statistics(
+  const hdf5_data_reader& other)
+{
+  for (const FieldPlan& plan : m_field_plans) {
+    const std::string path = plan.node_path.substr(1);
+    const conduit::Node& metadata =
+      m_useme_node_map.at(path).child(s_metadata_node_name);
+    if (!is_marked_for_normalization(metadata)) {
+      continue;
+    }
+    const auto it = other.m_useme_node_map.find(path);
+    if (it == other.m_useme_node_map.end() ||
+        !it->second.has_child(s_metadata_node_name) ||
+        !it->second[s_metadata_node_name].has_child(HDF5_METADATA_KEY_SCALE)) {
+      LBANN_ERROR("the ",
+                  other.get_role(),
+                  " reader has no normalization for field ",
+                  path,
+                  ", which the ",
+                  get_role(),
+                  " reader normalizes");
+    }
+    const conduit::Node& src = it->second[s_metadata_node_name];
+    conduit::Node scale, bias;
+    src[HDF5_METADATA_KEY_SCALE].to_float64_array(scale);
+    src[HDF5_METADATA_KEY_BIAS].to_float64_array(bias);
+    const double* scale_ptr = scale.as_float64_ptr();
+    const double* bias_ptr = bias.as_float64_ptr();
+    set_normalization(
+      path,
+      std::vector<double>(scale_ptr,
+                          scale_ptr + scale.dtype().number_of_elements()),
+      std::vector<double>(bias_ptr,
+                          bias_ptr + bias.dtype().number_of_elements()));
+  }
+  build_field_plans();
+}
+
+bool hdf5_data_reader::is_marked_for_normalization(
+  const conduit::Node& metadata) const
+{
+  if (!metadata.has_child(HDF5_METADATA_KEY_NORMALIZE)) {
+    return false;
+  }
+  const conduit::Node& flag = metadata[HDF5_METADATA_KEY_NORMALIZE];
+  return flag.dtype().is_string() ? conduit_to_string(flag) == "true"
+                                  : flag.to_int64() != 0;
+}
+
+void hdf5_data_reader::set_normalization(const std::string& path,
+                                         const std::vector<double>& scale,
+                                         const std::vector<double>& bias)
+{
+  for (conduit::Node* metadata :
+       {&m_experiment_schema[path][s_metadata_node_name],
+        &m_useme_node_map[path][s_metadata_node_name]}) {
+    if (scale.size() == 1) {
+      (*metadata)[HDF5_METADATA_KEY_SCALE] = scale.front();
+      (*metadata)[HDF5_METADATA_KEY_BIAS] = bias.front();
+    }
+    else {
+      (*metadata)[HDF5_METADATA_KEY_SCALE].set(scale);
+      (*metadata)[HDF5_METADATA_KEY_BIAS].set(bias);
+    }
+  }
+}
+
 // master loads the experiment-schema then bcasts to others
 void hdf5_data_reader::load_schema(std::string filename, conduit::Node& schema)
 {
@@ -276,33 +531,55 @@ void hdf5_data_reader::do_preload_data_store()
               << get_role() << std::endl;
   }
 
+  // Group the samples this rank owns by file, so that each file is
+  // opened once and read through in sample list order rather than
+  // revisited in shuffled order
+  std::map<size_t, std::vector<size_t>> indices_by_file;
   for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
     int index = m_shuffled_indices[idx];
     if (m_data_store->get_index_owner(index) !=
         get_comm()->get_rank_in_trainer()) {
       continue;
     }
-    try {
-      conduit::Node& node = m_data_store->get_empty_node(index);
-      load_sample_from_sample_list(node, index);
-      m_data_store->set_preloaded_conduit_node(index, node);
-    }
-    catch (conduit::Error const& e) {
-      LBANN_ERROR("trying to load the node ",
-                  index,
-                  " and caught conduit exception: ",
-                  e.what());
-    }
+    indices_by_file[m_sample_list[index].first].push_back(index);
   }
-  // Once all of the data has been preloaded, close all of the file handles
 
-  for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
-    int index = m_shuffled_indices[idx];
-    if (m_data_store->get_index_owner(index) !=
-        get_comm()->get_rank_in_trainer()) {
-      continue;
+  const bool in_memory =
+    global_argument_parser().get<bool>(LBANN_OPTION_HDF5_CORE_DRIVER);
+  for (auto& [file_id, indices] : indices_by_file) {
+    std::sort(indices.begin(), indices.end());
+    hid_t file_handle = 0;
+    if (in_memory) {
+      file_handle = open_file_in_memory(indices.front());
+    }
+    for (const size_t index : indices) {
+      try {
+        conduit::Node& node = m_data_store->get_empty_node(index);
+        if (in_memory) {
+          load_sample(node[LBANN_DATA_ID_STR(index)],
+                      file_handle,
+                      m_sample_list[index].second);
+          pack(node, index);
+        }
+        else {
+          load_sample_from_sample_list(node, index);
+        }
+        m_data_store->set_preloaded_conduit_node(index, node);
+      }
+      catch (conduit::Error const& e) {
+        LBANN_ERROR("trying to load the node ",
+                    index,
+                    " and caught conduit exception: ",
+                    e.what());
+      }
+    }
+    // The file is not needed again once its samples are loaded
+    if (in_memory) {
+      H5Fclose(file_handle);
+    }
+    else {
+      m_sample_list.close_samples_file_handle(indices.front());
     }
-    close_file(index); // data_reader_sample_list::close_file
   }
 
   size_t nn = m_data_store->get_num_global_indices();
@@ -311,10 +588,35 @@ void hdf5_data_reader::do_preload_data_store()
               << get_time() - tm1 << "s"
               << "num samples (local to this rank): "
               << m_data_store->get_data_size()
-              << "; global to this trainer: " << nn << std::endl;
+              << "; global to this trainer: " << nn
+              << "; open file cache hits: "
+              << m_sample_list.get_num_file_handle_hits()
+              << " misses: " << m_sample_list.get_num_file_handle_misses()
+              << std::endl;
   }
 }
 
+hid_t hdf5_data_reader::open_file_in_memory(size_t index) const
+{
+  const auto file_id = m_sample_list[index].first;
+  const std::string file_path =
+    add_delimiter(m_sample_list.get_samples_dirname()) +
+    m_sample_list.get_samples_filename(file_id);
+
+  // The core driver reads the whole file when it is opened; without a
+  // backing store nothing is written back on close
+  const hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  if (fapl < 0 || H5Pset_fapl_core(fapl, 64 * 1024 * 1024, false) < 0) {
+    LBANN_ERROR("could not set up the HDF5 core driver for '", file_path, "'");
+  }
+  const hid_t file_handle = H5Fopen(file_path.c_str(), H5F_ACC_RDONLY, fapl);
+  H5Pclose(fapl);
+  if (file_handle < 0) {
+    LBANN_ERROR("data file '", file_path, "' could not be opened.");
+  }
+  return file_handle;
+}
+
 // Loads the fields that are specified in the user supplied schema
 void hdf5_data_reader::load_sample(conduit::Node& node,
                                    hid_t file_handle,
@@ -326,63 +628,102 @@ void hdf5_data_reader::load_sample(conduit::Node& node,
   // optimized to have a cut-through for when the experiment schema matches the
   // data schema load data for the field names specified in the user's
   // experiment-schema
-  for (auto& [pathname, path_node] : m_useme_node_map) {
-    // do not load a "packed" field, as it doesn't exist on disk!
-    if (!is_composite_node(path_node)) {
-
-      // check that the requested data (pathname) exists on disk
-      const std::string original_path = "/" + sample_name + "/" + pathname;
-      if (!conduit::relay::io::hdf5_has_path(file_handle, original_path)) {
-        if (ignore_failure) {
-          continue;
-        }
-        LBANN_ERROR("hdf5_has_path failed for path: ", original_path);
+  const std::string sample_path = "/" + sample_name;
+  std::string original_path;
+  for (const FieldPlan& plan : m_field_plans) {
+    // check that the requested data (pathname) exists on disk
+    original_path = sample_path + plan.node_path;
+    if (!conduit::relay::io::hdf5_has_path(file_handle, original_path)) {
+      if (ignore_failure) {
+        continue;
       }
+      LBANN_ERROR("hdf5_has_path failed for path: ", original_path);
+    }
 
-      // get the new path-name (prepend the index)
-      std::ostringstream ss2;
-      ss2 << '/' << pathname;
-      const std::string new_pathname(ss2.str());
+    // optionally coerce the data, e.g, from double to float, per settings
+    // in the experiment_schema
+    conduit::Node& leaf = node[plan.node_path];
+    if (plan.coerce_to != conduit::DataType::EMPTY_ID) {
+      coerce(plan.coerce_to, file_handle, original_path, leaf);
+    }
+    else {
+      conduit::relay::io::hdf5_read(file_handle, original_path, leaf);
+    }
 
-      // note: this will throw an exception if the child node doesn't exist
-      const conduit::Node& metadata = path_node.child(s_metadata_node_name);
+    // check to see if there are integer types left in the sample and warn the
+    // user
+    auto dtype = leaf.dtype();
+    // https://github.com/LLNL/conduit/blob/develop/src/libs/conduit/conduit_data_type.hpp
+    if (!dtype.is_floating_point()) {
+      LBANN_MSG("Ingesting sample field ",
+                plan.node_path.substr(1),
+                " which has unconventional data format ",
+                dtype.to_string());
+    }
 
-      // optionally coerce the data, e.g, from double to float, per settings
-      // in the experiment_schema
-      if (metadata.has_child(HDF5_METADATA_KEY_COERCE)) {
-        coerce(metadata, file_handle, original_path, new_pathname, node);
+    // for images
+    // Check to make sure that the image / data volume has more than one
+    // channel and is in a channel's last format.  LBANN wants data in a
+    // channels first format. When the field is also normalized both are
+    // done in one pass.
+    if (plan.repack && plan.normalize) {
+      normalize_and_repack_image(leaf, plan);
+    }
+    else if (plan.repack) {
+      repack_image(leaf, plan);
+    }
+    // optionally normalize
+    else if (plan.normalize) {
+      normalize(leaf, plan);
+    }
+  }
+}
+
+void hdf5_data_reader::build_field_plans()
+{
+  m_field_plans.clear();
+  for (const auto& [pathname, path_node] : m_useme_node_map) {
+    // do not load a "packed" field, as it doesn't exist on disk!
+    if (is_composite_node(path_node)) {
+      continue;
+    }
+    FieldPlan plan;
+    plan.node_path = "/" + pathname;
+
+    // note: this will throw an exception if the child node doesn't exist
+    const conduit::Node& metadata = path_node.child(s_metadata_node_name);
+
+    if (metadata.has_child(HDF5_METADATA_KEY_COERCE)) {
+      const std::string& coerce_to =
+        conduit_to_string(metadata[HDF5_METADATA_KEY_COERCE]);
+      // Example of data coercion taken from
+      // https://github.com/LLNL/conduit/blob/develop/src/tests/conduit/t_conduit_node_to_array.cpp
+      if (coerce_to == "float") {
+        plan.coerce_to = conduit::DataType::FLOAT32_ID;
       }
-      else {
-        conduit::relay::io::hdf5_read(file_handle,
-                                      original_path,
-                                      node[new_pathname]);
+      else if (coerce_to == "double") {
+        plan.coerce_to = conduit::DataType::FLOAT64_ID;
       }
-
-      // check to see if there are integer types left in the sample and warn the
-      // user
-      auto dtype = node[new_pathname].dtype();
-      // https://github.com/LLNL/conduit/blob/develop/src/libs/conduit/conduit_data_type.hpp
-      if (!dtype.is_floating_point()) {
-        LBANN_MSG("Ingesting sample field ",
-                  pathname,
-                  " which has unconventional data format ",
-                  dtype.to_string());
+      else if (coerce_to == "int") {
+        plan.coerce_to = conduit::DataType::INT32_ID;
       }
-
-      // optionally normalize
-      if (metadata.has_child(HDF5_METADATA_KEY_SCALE) ||
-          metadata.has_child(HDF5_METADATA_KEY_BIAS)) {
-        normalize(node, new_pathname, metadata);
+      else if (coerce_to == "long" || coerce_to == "int64") {
+        plan.coerce_to = conduit::DataType::INT64_ID;
       }
-
-      // for images
-      // Check to make sure that the image / data volume has more than one
-      // channel and is in a channel's last format.  LBANN wants data in a
-      // channels first format
-      if (does_hdf5_field_require_repack_to_channels_first(metadata)) {
-        repack_image(node, new_pathname, metadata);
+      else {
+        LBANN_ERROR("Un-implemented type requested for coercion: ",
+                    coerce_to,
+                    "; you need to update the data reader to support this");
       }
     }
+    if (metadata.has_child(HDF5_METADATA_KEY_SCALE) ||
+        metadata.has_child(HDF5_METADATA_KEY_BIAS)) {
+      resolve_normalization(plan, metadata);
+    }
+    if (does_hdf5_field_require_repack_to_channels_first(metadata)) {
+      resolve_repack(plan, metadata);
+    }
+    m_field_plans.push_back(std::move(plan));
   }
 }
 
@@ -392,16 +733,22 @@ void hdf5_data_reader::load_sample_from_sample_list(conduit::Node& node,
 {
   auto [file_handle, sample_name] = data_reader_sample_list::open_file(index);
   const std::string padded_index = LBANN_DATA_ID_STR(index);
-  load_sample(node[padded_index], file_handle, sample_name, ignore_failure);
+  try {
+    load_sample(node[padded_index], file_handle, sample_name, ignore_failure);
+  }
+  catch (...) {
+    close_file(index);
+    throw;
+  }
+  close_file(index);
   pack(node, index);
 }
 
-void hdf5_data_reader::normalize(conduit::Node& node,
-                                 const std::string& path,
-                                 const conduit::Node& metadata)
+void hdf5_data_reader::resolve_normalization(
+  FieldPlan& plan,
+  const conduit::Node& metadata) const
 {
-  void* vals = node[path].element_ptr(0);
-  size_t n_elements = node[path].dtype().number_of_elements();
+  plan.normalize = true;
 
   // treat this as a multi-channel image
   if (metadata.has_child(HDF5_METADATA_KEY_CHANNELS)) {
@@ -425,24 +772,12 @@ void hdf5_data_reader::normalize(conduit::Node& node,
 
     // get the scale and bias arrays
     const double* scale = metadata[HDF5_METADATA_KEY_SCALE].as_double_ptr();
-    std::vector<double> b(n_channels, 0);
-    const double* bias = b.data();
+    plan.normalize_per_channel = true;
+    plan.scale.assign(scale, scale + n_channels);
+    plan.bias.assign(n_channels, 0);
     if (metadata.has_child(HDF5_METADATA_KEY_BIAS)) {
-      bias = metadata[HDF5_METADATA_KEY_BIAS].as_double_ptr();
-    }
-
-    // perform the normalization
-    if (node[path].dtype().is_float32()) {
-      float* data = reinterpret_cast<float*>(vals);
-      do_normalize(data, scale, bias, n_elements, n_channels);
-    }
-    else if (node[path].dtype().is_float64()) {
-      double* data = reinterpret_cast<double*>(vals);
-      do_normalize(data, scale, bias, n_elements, n_channels);
-    }
-    else {
-      LBANN_ERROR(
-        "Only float and double are currently supported for normalization");
+      const double* bias = metadata[HDF5_METADATA_KEY_BIAS].as_double_ptr();
+      plan.bias.assign(bias, bias + n_channels);
     }
   }
 
@@ -453,20 +788,51 @@ void hdf5_data_reader::normalize(conduit::Node& node,
     if (metadata.has_child(HDF5_METADATA_KEY_BIAS)) {
       bias = metadata[HDF5_METADATA_KEY_BIAS].value();
     }
+    plan.normalize_per_channel = false;
+    plan.scale.assign(1, scale);
+    plan.bias.assign(1, bias);
+  }
+}
+
+void hdf5_data_reader::normalize(conduit::Node& node,
+                                 const std::string& path,
+                                 const conduit::Node& metadata)
+{
+  FieldPlan plan;
+  resolve_normalization(plan, metadata);
+  normalize(node[path], plan);
+}
 
-    if (node[path].dtype().is_float32()) {
-      float* data = reinterpret_cast<float*>(vals);
-      do_normalize(data, scale, bias, n_elements);
+void hdf5_data_reader::normalize(conduit::Node& leaf, const FieldPlan& plan)
+{
+  void* vals = leaf.element_ptr(0);
+  size_t n_elements = leaf.dtype().number_of_elements();
+  const double* scale = plan.scale.data();
+  const double* bias = plan.bias.data();
+
+  // perform the normalization
+  if (leaf.dtype().is_float32()) {
+    float* data = reinterpret_cast<float*>(vals);
+    if (plan.normalize_per_channel) {
+      do_normalize(data, scale, bias, n_elements, plan.scale.size());
+    }
+    else {
+      do_normalize(data, scale[0], bias[0], n_elements);
     }
-    else if (node[path].dtype().is_float64()) {
-      double* data = reinterpret_cast<double*>(vals);
-      do_normalize(data, scale, bias, n_elements);
+  }
+  else if (leaf.dtype().is_float64()) {
+    double* data = reinterpret_cast<double*>(vals);
+    if (plan.normalize_per_channel) {
+      do_normalize(data, scale, bias, n_elements, plan.scale.size());
     }
     else {
-      LBANN_ERROR(
-        "Only float and double are currently supported for normalization");
+      do_normalize(data, scale[0], bias[0], n_elements);
     }
   }
+  else {
+    LBANN_ERROR(
+      "Only float and double are currently supported for normalization");
+  }
 }
 
 // recursive
@@ -516,6 +882,8 @@ void hdf5_data_reader::parse_schemas()
     }
   }
 
+  build_field_plans();
+
   construct_linearized_size_lookup_tables();
 }
 
@@ -624,17 +992,16 @@ void hdf5_data_reader::pack(conduit::Node& node, size_t index)
   for (const auto& t : m_packing_groups) {
     const std::string& group_name = t.first;
     const PackingGroup& g = t.second;
-    std::string group_type = conduit::DataType::id_to_name(g.data_type);
-    if (group_type == "float32") {
+    if (g.data_type == conduit::DataType::FLOAT32_ID) {
       pack<float>(group_name, node, index);
     }
-    else if (group_type == "float64") {
+    else if (g.data_type == conduit::DataType::FLOAT64_ID) {
       pack<double>(group_name, node, index);
     }
     else {
       LBANN_ERROR("packing is currently only implemented for float32 and "
                   "float64; your data type was: ",
-                  group_type,
+                  conduit::DataType::id_to_name(g.data_type),
                   " for group_name: ",
                   group_name);
     }
@@ -754,11 +1121,10 @@ void hdf5_data_reader::adjust_metadata(conduit::Node* node)
   }
 }
 
-void hdf5_data_reader::coerce(const conduit::Node& metadata,
+void hdf5_data_reader::coerce(conduit::index_t coerce_to,
                               hid_t file_handle,
                               const std::string& original_path,
-                              const std::string& new_pathname,
-                              conduit::Node& node)
+                              conduit::Node& leaf)
 {
   conduit::Node tmp;
   conduit::relay::io::hdf5_read(file_handle, original_path, tmp);
@@ -773,39 +1139,15 @@ void hdf5_data_reader::coerce(const conduit::Node& metadata,
       tmp.dtype().to_string());
   }
 
-  const std::string& coerce_to =
-    conduit_to_string(metadata[HDF5_METADATA_KEY_COERCE]);
-
-  // Example of data coercion taken from
-  // https://github.com/LLNL/conduit/blob/develop/src/tests/conduit/t_conduit_node_to_array.cpp
-  conduit::DataType::TypeID coerced_tid;
-  if (coerce_to == "float") {
-    coerced_tid = conduit::DataType::FLOAT32_ID;
-  }
-  else if (coerce_to == "double") {
-    coerced_tid = conduit::DataType::FLOAT64_ID;
-  }
-  else if (coerce_to == "int") {
-    coerced_tid = conduit::DataType::INT32_ID;
-  }
-  else if (coerce_to == "long" || coerce_to == "int64") {
-    coerced_tid = conduit::DataType::INT64_ID;
-  }
-  else {
-    LBANN_ERROR("Un-implemented type requested for coercion: ",
-                coerce_to,
-                "; you need to update the data reader to support this");
-  }
   // https://github.com/LLNL/conduit/blob/develop/src/libs/conduit/conduit_node.hpp#L3263
-  tmp.to_data_type(coerced_tid, node[new_pathname]);
+  tmp.to_data_type(coerce_to, leaf);
 }
 
-void hdf5_data_reader::repack_image(conduit::Node& node,
-                                    const std::string& path,
-                                    const conduit::Node& metadata)
+void hdf5_data_reader::resolve_repack(FieldPlan& plan,
+                                      const conduit::Node& metadata) const
 {
-
   // ==== start: sanity checking
+  plan.repack = false;
   if (!metadata.has_child(HDF5_METADATA_KEY_CHANNELS)) {
     LBANN_WARNING("repack_image called, but metadata is missing the 'channels' "
                   "field; please check your schemas");
@@ -820,60 +1162,78 @@ void hdf5_data_reader::repack_image(conduit::Node& node,
   }
   // ==== end: sanity checking
 
-  void* vals = node[path].element_ptr(0);
-  size_t n_elts = node[path].dtype().number_of_elements();
-  int64_t n_channels = metadata[HDF5_METADATA_KEY_CHANNELS].value();
+  const int64_t n_channels = metadata[HDF5_METADATA_KEY_CHANNELS].value();
+  plan.n_channels = n_channels;
   const conduit::int64* dims = metadata[HDF5_METADATA_KEY_DIMS].as_int64_ptr();
   const int num_dims =
     metadata[HDF5_METADATA_KEY_DIMS].dtype().number_of_elements();
+  if (num_dims != 2 && num_dims != 3) {
+    LBANN_ERROR("Only 2D and 3D tensors are supported for repacking");
+  }
+  plan.dims.assign(dims, dims + num_dims);
+  plan.repack = true;
+}
+
+void hdf5_data_reader::repack_image(conduit::Node& node,
+                                    const std::string& path,
+                                    const conduit::Node& metadata)
+{
+  FieldPlan plan;
+  resolve_repack(plan, metadata);
+  if (plan.repack) {
+    repack_image(node[path], plan);
+  }
+}
 
-  if (num_dims == 2) {
-    const int row_dim = dims[0];
-    const int col_dim = dims[1];
+void hdf5_data_reader::repack_image(conduit::Node& leaf, const FieldPlan& plan)
+{
+  repack_image(leaf, plan, nullptr, nullptr);
+}
 
-    if (node[path].dtype().is_float32()) {
-      float* data = reinterpret_cast<float*>(vals);
-      do_repack_tensor_HWC_to_CHW(data, n_elts, row_dim, col_dim, n_channels);
-    }
-    else if (node[path].dtype().is_float64()) {
-      double* data = reinterpret_cast<double*>(vals);
-      do_repack_tensor_HWC_to_CHW(data, n_elts, row_dim, col_dim, n_channels);
-    }
-    else {
-      LBANN_ERROR(
-        "Only float and double are currently supported for repacking");
-    }
-  }
-  else if (num_dims == 3) {
-    const int depth_dim = dims[0];
-    const int height_dim = dims[1];
-    const int width_dim = dims[2];
-
-    if (node[path].dtype().is_float32()) {
-      float* data = reinterpret_cast<float*>(vals);
-      do_repack_tensor_DHWC_to_CDHW(data,
-                                    n_elts,
-                                    depth_dim,
-                                    height_dim,
-                                    width_dim,
-                                    n_channels);
-    }
-    else if (node[path].dtype().is_float64()) {
-      double* data = reinterpret_cast<double*>(vals);
-      do_repack_tensor_DHWC_to_CDHW(data,
-                                    n_elts,
-                                    depth_dim,
-                                    height_dim,
-                                    width_dim,
-                                    n_channels);
-    }
-    else {
-      LBANN_ERROR(
-        "Only float and double are currently supported for repacking");
-    }
+void hdf5_data_reader::repack_image(conduit::Node& leaf,
+                                    const FieldPlan& plan,
+                                    const double* scale,
+                                    const double* bias)
+{
+  void* vals = leaf.element_ptr(0);
+  size_t n_elts = leaf.dtype().number_of_elements();
+  const size_t n_channels = plan.n_channels;
+  size_t const n_pixels = std::accumulate(plan.dims.begin(),
+                                          plan.dims.end(),
+                                          size_t{1},
+                                          std::multiplies<size_t>());
+  if (n_pixels * n_channels != n_elts) {
+    LBANN_ERROR("field ",
+                leaf.path(),
+                " has ",
+                n_elts,
+                " elements, but its dims and channels in the schema give ",
+                n_pixels * n_channels);
+  }
+
+  if (leaf.dtype().is_float32()) {
+    float* data = reinterpret_cast<float*>(vals);
+    do_repack_channels_last_to_first(data, n_elts, n_channels, scale, bias);
+  }
+  else if (leaf.dtype().is_float64()) {
+    double* data = reinterpret_cast<double*>(vals);
+    do_repack_channels_last_to_first(data, n_elts, n_channels, scale, bias);
   }
   else {
-    LBANN_ERROR("Only 2D and 3D tensors are supported for repacking");
+    LBANN_ERROR("Only float and double are currently supported for repacking");
+  }
+}
+
+void hdf5_data_reader::normalize_and_repack_image(conduit::Node& leaf,
+                                                  const FieldPlan& plan)
+{
+  if (plan.normalize_per_channel) {
+    repack_image(leaf, plan, plan.scale.data(), plan.bias.data());
+  }
+  else {
+    const std::vector<double> scale(plan.n_channels, plan.scale[0]);
+    const std::vector<double> bias(plan.n_channels, plan.bias[0]);
+    repack_image(leaf, plan, scale.data(), bias.data());
   }
 }
 
@@ -0,0 +1,593 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// data_reader_columnar .hpp .cpp - generic_data_reader class for chunked
+// columnar files
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_ingestion/readers/data_reader_columnar.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/profiling.hpp"
+
+#include "conduit/conduit_relay.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <type_traits>
+#include <zlib.h>
+
+namespace lbann {
+
+namespace {
+
+/// Leading bytes of a columnar file
+constexpr char columnar_magic[8] = {'L', 'B', 'A', 'N', 'N', 'C', 'O', 'L'};
+constexpr uint64_t columnar_version = 1;
+
+/// Fixed-size header at the start of a columnar file.
+/// The JSON footer at footer_offset describes the columns.
+struct columnar_header
+{
+  char magic[8];
+  uint64_t version;
+  uint64_t footer_offset;
+  uint64_t footer_size;
+};
+
+std::vector<uint64_t> to_uint64_vector(const conduit::Node& node)
+{
+  conduit::Node values;
+  node.to_uint64_array(values);
+  const conduit::uint64_array array = values.value();
+  std::vector<uint64_t> result(array.number_of_elements());
+  for (size_t i = 0; i < result.size(); ++i) {
+    result[i] = array[i];
+  }
+  return result;
+}
+
+template <typename T>
+void convert(const char* src,
+             size_t size,
+             DataType scale,
+             DataType bias,
+             DataType* dst)
+{
+  if (std::is_same<T, DataType>::value && scale == DataType(1) &&
+      bias == DataType(0)) {
+    std::memcpy(dst, src, size * sizeof(T));
+    return;
+  }
+  // Chunks are aligned in the file, so samples are aligned for T
+  const T* values = reinterpret_cast<const T*>(src);
+  for (size_t i = 0; i < size; ++i) {
+    dst[i] = static_cast<DataType>(values[i]) * scale + bias;
+  }
+}
+
+/// A chunk of a sparse column holds, for its n samples, the entry offsets
+/// (uint64, n + 1 of them, the first being 0), then the coordinates of all
+/// entries (int64, index_dims per entry, entry after entry) and then, if the
+/// column has values, one value per entry. All three parts are 8-byte
+/// aligned since offsets and coordinates are 8 bytes wide.
+
+/// The chunk of a compressed column that an I/O thread last inflated
+struct chunk_cache_entry
+{
+  std::weak_ptr<const file::mapped_file> file;
+  uint64_t offset = 0;
+  std::vector<char> data;
+};
+
+} // namespace
+
+columnar_reader::columnar_reader(bool shuffle) : generic_data_reader(shuffle)
+{}
+
+void columnar_reader::load()
+{
+  LBANN_CALIPER_MARK_SCOPE("columnar_reader::load");
+  m_file = std::make_shared<const file::mapped_file>(get_file_dir() +
+                                                     get_data_filename());
+  read_footer();
+
+  if (m_experiment_schema_filename.empty()) {
+    LBANN_ERROR("columnar_reader requires an experiment schema");
+  }
+  conduit::relay::io::load(m_experiment_schema_filename,
+                           "yaml",
+                           m_experiment_schema);
+  select_columns();
+
+  m_shuffled_indices.clear();
+  m_shuffled_indices.resize(m_num_samples);
+  std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+  resize_shuffled_indices();
+  select_subset_of_data();
+}
+
+void columnar_reader::read_footer()
+{
+  const std::string filename = get_file_dir() + get_data_filename();
+  columnar_header header;
+  if (m_file->size() < sizeof(header)) {
+    LBANN_ERROR(filename, " is not a columnar file");
+  }
+  std::memcpy(&header, m_file->data(), sizeof(header));
+  if (std::memcmp(header.magic, columnar_magic, sizeof(header.magic)) != 0) {
+    LBANN_ERROR(filename, " is not a columnar file");
+  }
+  if (header.version != columnar_version) {
+    LBANN_ERROR(filename,
+                " has columnar format version ",
+                header.version,
+                ", but only version ",
+                columnar_version,
+                " is supported");
+  }
+  if (header.footer_offset + header.footer_size > m_file->size()) {
+    LBANN_ERROR(filename, " is truncated");
+  }
+
+  conduit::Node footer;
+  footer.parse(std::string(m_file->data() + header.footer_offset,
+                           header.footer_size),
+               "json");
+  m_num_samples = footer["num_samples"].to_uint64();
+  m_chunk_size = footer["chunk_size"].to_uint64();
+  if (m_chunk_size == 0) {
+    LBANN_ERROR(filename, " has a chunk size of 0");
+  }
+  const uint64_t num_chunks = (m_num_samples + m_chunk_size - 1) / m_chunk_size;
+
+  static const std::map<std::string, std::pair<column_type, size_t>> types = {
+    {"int8", {column_type::INT8, 1}},
+    {"uint8", {column_type::UINT8, 1}},
+    {"int16", {column_type::INT16, 2}},
+    {"int32", {column_type::INT32, 4}},
+    {"int64", {column_type::INT64, 8}},
+    {"float32", {column_type::FLOAT32, 4}},
+    {"float64", {column_type::FLOAT64, 8}},
+  };
+
+  m_columns.clear();
+  const conduit::Node& columns = footer["columns"];
+  for (conduit::index_t i = 0; i < columns.number_of_children(); ++i) {
+    const conduit::Node& desc = columns.child(i);
+    column col;
+    col.name = columns.child_names()[i];
+    const auto type = types.find(desc["dtype"].as_string());
+    if (type == types.end()) {
+      LBANN_ERROR("column ",
+                  col.name,
+                  " of ",
+                  filename,
+                  " has unsupported type ",
+                  desc["dtype"].as_string());
+    }
+    col.type = type->second.first;
+    col.word_size = type->second.second;
+    const std::string layout =
+      desc.has_child("layout") ? desc["layout"].as_string() : "dense";
+    if (layout == "coo") {
+      // The packed size depends on the capacity given by the schema
+      col.sparse = true;
+      col.index_dims = desc["index_dims"].to_uint64();
+      col.has_values = desc["has_values"].to_uint64() != 0;
+      col.raw_chunk_sizes = to_uint64_vector(desc["raw_chunk_sizes"]);
+      if (col.index_dims == 0) {
+        LBANN_ERROR("sparse column ",
+                    col.name,
+                    " of ",
+                    filename,
+                    " has no index dimensions");
+      }
+    }
+    else if (layout == "dense") {
+      col.sample_size = 1;
+      for (const auto d : to_uint64_vector(desc["dims"])) {
+        col.dims.push_back(d);
+        col.sample_size *= d;
+      }
+    }
+    else {
+      LBANN_ERROR("column ",
+                  col.name,
+                  " of ",
+                  filename,
+                  " has unsupported layout ",
+                  layout);
+    }
+    const std::string compression = desc["compression"].as_string();
+    if (compression != "none" && compression != "zlib") {
+      LBANN_ERROR("column ",
+                  col.name,
+                  " of ",
+                  filename,
+                  " has unsupported compression ",
+                  compression);
+    }
+    col.compressed = (compression == "zlib");
+    col.chunk_offsets = to_uint64_vector(desc["chunk_offsets"]);
+    col.chunk_sizes = to_uint64_vector(desc["chunk_sizes"]);
+    if (col.chunk_offsets.size() != num_chunks ||
+        col.chunk_sizes.size() != num_chunks ||
+        (col.sparse && col.raw_chunk_sizes.size() != num_chunks)) {
+      LBANN_ERROR("column ",
+                  col.name,
+                  " of ",
+                  filename,
+                  " should have ",
+                  num_chunks,
+                  " chunks");
+    }
+    for (uint64_t c = 0; c < num_chunks; ++c) {
+      if (col.chunk_offsets[c] + col.chunk_sizes[c] > m_file->size()) {
+        LBANN_ERROR("column ", col.name, " of ", filename, " is truncated");
+      }
+      const size_t alignment =
+        col.sparse ? sizeof(uint64_t) : col.word_size;
+      if (col.chunk_offsets[c] % alignment != 0) {
+        LBANN_ERROR("column ", col.name, " of ", filename, " is misaligned");
+      }
+    }
+    m_columns.push_back(std::move(col));
+  }
+}
+
+void columnar_reader::select_columns()
+{
+  m_datum_columns.clear();
+  m_response_columns.clear();
+  m_label_column = -1;
+  m_datum_size = 0;
+  m_response_size = 0;
+  m_num_labels = 0;
+
+  for (conduit::index_t i = 0; i < m_experiment_schema.number_of_children();
+       ++i) {
+    const conduit::Node& field = m_experiment_schema.child(i);
+    const std::string& name = m_experiment_schema.child_names()[i];
+    const auto col =
+      std::find_if(m_columns.begin(), m_columns.end(), [&name](const column& c) {
+        return c.name == name;
+      });
+    if (col == m_columns.end()) {
+      LBANN_ERROR("experiment schema field ",
+                  name,
+                  " is not a column of ",
+                  get_data_filename());
+    }
+    const size_t index = std::distance(m_columns.begin(), col);
+    if (col->sparse) {
+      if (!field.has_child(COLUMNAR_SCHEMA_KEY_CAPACITY)) {
+        LBANN_ERROR("sparse field ",
+                    name,
+                    " of the experiment schema needs \"",
+                    COLUMNAR_SCHEMA_KEY_CAPACITY,
+                    "\"");
+      }
+      col->capacity = field[COLUMNAR_SCHEMA_KEY_CAPACITY].to_uint64();
+      col->sample_size =
+        col->capacity * (col->index_dims + (col->has_values ? 1 : 0));
+      col->dims = {static_cast<El::Int>(col->sample_size)};
+    }
+    if (field.has_child(COLUMNAR_SCHEMA_KEY_SCALE)) {
+      col->scale = field[COLUMNAR_SCHEMA_KEY_SCALE].to_double();
+    }
+    if (field.has_child(COLUMNAR_SCHEMA_KEY_BIAS)) {
+      col->bias = field[COLUMNAR_SCHEMA_KEY_BIAS].to_double();
+    }
+
+    const std::string pack =
+      field.has_child(COLUMNAR_SCHEMA_KEY_PACK)
+        ? field[COLUMNAR_SCHEMA_KEY_PACK].as_string()
+        : "";
+    if (pack == INPUT_DATA_TYPE_SAMPLES || pack == "datum") {
+      m_datum_columns.push_back(index);
+      m_datum_size += col->sample_size;
+    }
+    else if (pack == INPUT_DATA_TYPE_RESPONSES || pack == "response") {
+      m_response_columns.push_back(index);
+      m_response_size += col->sample_size;
+    }
+    else if (pack == INPUT_DATA_TYPE_LABELS || pack == "label") {
+      if (m_label_column >= 0) {
+        LBANN_ERROR("experiment schema has more than one label field");
+      }
+      if (col->sparse || col->sample_size != 1 ||
+          col->type == column_type::FLOAT32 ||
+          col->type == column_type::FLOAT64) {
+        LBANN_ERROR("label column ", name, " must hold one integer per sample");
+      }
+      if (!field.has_child(COLUMNAR_SCHEMA_KEY_NUM_LABELS)) {
+        LBANN_ERROR("label field ",
+                    name,
+                    " of the experiment schema needs \"",
+                    COLUMNAR_SCHEMA_KEY_NUM_LABELS,
+                    "\"");
+      }
+      m_label_column = index;
+      m_num_labels = field[COLUMNAR_SCHEMA_KEY_NUM_LABELS].to_int();
+    }
+    else {
+      LBANN_ERROR("experiment schema field ",
+                  name,
+                  " has unknown pack group \"",
+                  pack,
+                  "\"");
+    }
+  }
+
+  if (m_datum_columns.empty()) {
+    LBANN_ERROR("experiment schema has no datum fields");
+  }
+  if (has_labels() && m_label_column < 0) {
+    LBANN_ERROR("labels are enabled but the experiment schema has no label "
+                "field");
+  }
+  if (has_responses() && m_response_columns.empty()) {
+    LBANN_ERROR("responses are enabled but the experiment schema has no "
+                "response fields");
+  }
+}
+
+const std::vector<El::Int> columnar_reader::get_data_dims() const
+{
+  if (m_datum_columns.size() == 1) {
+    return m_columns[m_datum_columns.front()].dims;
+  }
+  return {m_datum_size};
+}
+
+const char* columnar_reader::get_chunk(size_t column_index,
+                                       uint64_t chunk) const
+{
+  const column& col = m_columns[column_index];
+  if (!col.compressed) {
+    return m_file->data() + col.chunk_offsets[chunk];
+  }
+
+  // Samples are fetched in shuffled order, so only the chunk that
+  // this thread last used is kept for each column
+  thread_local std::vector<chunk_cache_entry> chunk_cache;
+  if (chunk_cache.size() < m_columns.size()) {
+    chunk_cache.resize(m_columns.size());
+  }
+  auto& entry = chunk_cache[column_index];
+  if (entry.file.lock() != m_file ||
+      entry.offset != col.chunk_offsets[chunk]) {
+    if (col.sparse) {
+      entry.data.resize(col.raw_chunk_sizes[chunk]);
+    }
+    else {
+      const uint64_t chunk_samples =
+        std::min(m_chunk_size, m_num_samples - chunk * m_chunk_size);
+      entry.data.resize(chunk_samples * col.sample_size * col.word_size);
+    }
+    uLongf size = entry.data.size();
+    const int status = uncompress(
+      reinterpret_cast<Bytef*>(entry.data.data()),
+      &size,
+      reinterpret_cast<const Bytef*>(m_file->data() + col.chunk_offsets[chunk]),
+      col.chunk_sizes[chunk]);
+    if (status != Z_OK || size != entry.data.size()) {
+      LBANN_ERROR("failed to decompress chunk ",
+                  chunk,
+                  " of column ",
+                  col.name,
+                  " (zlib error ",
+                  status,
+                  ")");
+    }
+    entry.file = m_file;
+    entry.offset = col.chunk_offsets[chunk];
+  }
+  return entry.data.data();
+}
+
+const char* columnar_reader::get_sample(size_t column_index,
+                                        uint64_t data_id) const
+{
+  const column& col = m_columns[column_index];
+  const size_t offset =
+    (data_id % m_chunk_size) * col.sample_size * col.word_size;
+  return get_chunk(column_index, data_id / m_chunk_size) + offset;
+}
+
+void columnar_reader::fetch_sparse(const column& col,
+                                   size_t column_index,
+                                   uint64_t data_id,
+                                   DataType* dst) const
+{
+  const uint64_t chunk = data_id / m_chunk_size;
+  const uint64_t chunk_samples =
+    std::min(m_chunk_size, m_num_samples - chunk * m_chunk_size);
+  const uint64_t local_id = data_id % m_chunk_size;
+  const char* data = get_chunk(column_index, chunk);
+  const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data);
+  const uint64_t total_entries = offsets[chunk_samples];
+  const uint64_t chunk_bytes =
+    (chunk_samples + 1) * sizeof(uint64_t) +
+    total_entries * (col.index_dims * sizeof(int64_t) +
+                     (col.has_values ? col.word_size : 0));
+  if (chunk_bytes > col.raw_chunk_sizes[chunk] ||
+      offsets[local_id] > offsets[local_id + 1] ||
+      offsets[local_id + 1] > total_entries) {
+    LBANN_ERROR("chunk ", chunk, " of sparse column ", col.name, " is corrupted");
+  }
+  const int64_t* coords =
+    reinterpret_cast<const int64_t*>(offsets + chunk_samples + 1);
+  const uint64_t begin = offsets[local_id];
+  const uint64_t num_entries = offsets[local_id + 1] - begin;
+  if (num_entries > col.capacity) {
+    LBANN_ERROR("sample ",
+                data_id,
+                " of sparse column ",
+                col.name,
+                " has ",
+                num_entries,
+                " entries, but the capacity is ",
+                col.capacity);
+  }
+
+  // Coordinates, one row of the capacity per index dimension
+  std::fill(dst, dst + col.index_dims * col.capacity, DataType(-1));
+  for (uint64_t e = 0; e < num_entries; ++e) {
+    const int64_t* entry = coords + (begin + e) * col.index_dims;
+    for (size_t d = 0; d < col.index_dims; ++d) {
+      dst[d * col.capacity + e] = static_cast<DataType>(entry[d]);
+    }
+  }
+  if (!col.has_values) {
+    return;
+  }
+
+  DataType* values_dst = dst + col.index_dims * col.capacity;
+  std::fill(values_dst + num_entries,
+            values_dst + col.capacity,
+            DataType(0));
+  const char* values = reinterpret_cast<const char*>(
+    coords + total_entries * col.index_dims) + begin * col.word_size;
+  switch (col.type) {
+  case column_type::INT8:
+    convert<int8_t>(values, num_entries, col.scale, col.bias, values_dst);
+    break;
+  case column_type::UINT8:
+    convert<uint8_t>(values, num_entries, col.scale, col.bias, values_dst);
+    break;
+  case column_type::INT16:
+    convert<int16_t>(values, num_entries, col.scale, col.bias, values_dst);
+    break;
+  case column_type::INT32:
+    convert<int32_t>(values, num_entries, col.scale, col.bias, values_dst);
+    break;
+  case column_type::INT64:
+    convert<int64_t>(values, num_entries, col.scale, col.bias, values_dst);
+    break;
+  case column_type::FLOAT32:
+    convert<float>(values, num_entries, col.scale, col.bias, values_dst);
+    break;
+  case column_type::FLOAT64:
+    convert<double>(values, num_entries, col.scale, col.bias, values_dst);
+    break;
+  }
+}
+
+void columnar_reader::fetch_columns(const std::vector<size_t>& columns,
+                                    CPUMat& X,
+                                    uint64_t data_id,
+                                    uint64_t mb_idx) const
+{
+  DataType* dst = X.Buffer(0, mb_idx);
+  for (const size_t index : columns) {
+    const column& col = m_columns[index];
+    if (col.sparse) {
+      fetch_sparse(col, index, data_id, dst);
+      dst += col.sample_size;
+      continue;
+    }
+    const char* src = get_sample(index, data_id);
+    switch (col.type) {
+    case column_type::INT8:
+      convert<int8_t>(src, col.sample_size, col.scale, col.bias, dst);
+      break;
+    case column_type::UINT8:
+      convert<uint8_t>(src, col.sample_size, col.scale, col.bias, dst);
+      break;
+    case column_type::INT16:
+      convert<int16_t>(src, col.sample_size, col.scale, col.bias, dst);
+      break;
+    case column_type::INT32:
+      convert<int32_t>(src, col.sample_size, col.scale, col.bias, dst);
+      break;
+    case column_type::INT64:
+      convert<int64_t>(src, col.sample_size, col.scale, col.bias, dst);
+      break;
+    case column_type::FLOAT32:
+      convert<float>(src, col.sample_size, col.scale, col.bias, dst);
+      break;
+    case column_type::FLOAT64:
+      convert<double>(src, col.sample_size, col.scale, col.bias, dst);
+      break;
+    }
+    dst += col.sample_size;
+  }
+}
+
+bool columnar_reader::fetch_datum(CPUMat& X, uint64_t data_id, uint64_t mb_idx)
+{
+  fetch_columns(m_datum_columns, X, data_id, mb_idx);
+  return true;
+}
+
+bool columnar_reader::fetch_label(CPUMat& Y, uint64_t data_id, uint64_t mb_idx)
+{
+  const column& col = m_columns[m_label_column];
+  const char* src = get_sample(m_label_column, data_id);
+  int64_t label = 0;
+  switch (col.type) {
+  case column_type::INT8:
+    label = *reinterpret_cast<const int8_t*>(src);
+    break;
+  case column_type::UINT8:
+    label = *reinterpret_cast<const uint8_t*>(src);
+    break;
+  case column_type::INT16:
+    label = *reinterpret_cast<const int16_t*>(src);
+    break;
+  case column_type::INT32:
+    label = *reinterpret_cast<const int32_t*>(src);
+    break;
+  case column_type::INT64:
+    label = *reinterpret_cast<const int64_t*>(src);
+    break;
+  default:
+    LBANN_ERROR("label column ", col.name, " does not hold integers");
+  }
+  if (label < 0 || label >= m_num_labels) {
+    LBANN_ERROR("sample ",
+                data_id,
+                " has label ",
+                label,
+                ", but there are ",
+                m_num_labels,
+                " labels");
+  }
+  Y(label, mb_idx) = 1;
+  return true;
+}
+
+bool columnar_reader::fetch_response(CPUMat& Y,
+                                     uint64_t data_id,
+                                     uint64_t mb_idx)
+{
+  fetch_columns(m_response_columns, Y, data_id, mb_idx);
+  return true;
+}
+
+} // namespace lbann
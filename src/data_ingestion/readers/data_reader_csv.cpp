@@ -28,13 +28,55 @@
 
 #include "lbann/data_ingestion/readers/data_reader_csv.hpp"
 #include "lbann/comm_impl.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/hash.hpp"
+#include "lbann/utils/omp_pragma.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 
-#include <unordered_set>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace lbann {
 
+namespace {
+
+/// Leading bytes of a CSV binary cache file
+constexpr char binary_cache_magic[8] = {'L', 'B', 'C', 'S', 'V', 'B', 'C', '1'};
+
+/// Fixed-size header of a CSV binary cache.
+/// It is followed by the int32 labels and the DataType responses (when
+/// enabled), then by the parsed rows starting at rows_offset.
+struct binary_cache_header
+{
+  char magic[8];
+  uint64_t key;
+  uint64_t num_rows;
+  uint64_t num_cols;
+  uint64_t row_len;
+  uint64_t rows_offset;
+};
+
+/// Rows of one chunk of the file, as found by csv_reader::index_lines
+struct line_chunk
+{
+  /// Start offset of each line, plus one past the end of the last line
+  std::vector<long long> offsets;
+  std::vector<int> labels;
+  std::vector<DataType> responses;
+  /// Index within the chunk of the first malformed line, if any
+  size_t bad_line = std::string::npos;
+  std::string error;
+};
+
+} // namespace
+
 csv_reader::csv_reader(bool shuffle) : generic_data_reader(shuffle)
 {
   // By default assume that there are labels in the CSV data set
@@ -59,6 +101,9 @@ csv_reader::csv_reader(const csv_reader& other)
     m_index(other.m_index),
     m_labels(other.m_labels),
     m_responses(other.m_responses),
+    m_binary_cache(other.m_binary_cache),
+    m_binary_cache_rows(other.m_binary_cache_rows),
+    m_binary_cache_row_len(other.m_binary_cache_row_len),
     m_col_transforms(other.m_col_transforms),
     m_label_transform(other.m_label_transform),
     m_response_transform(other.m_response_transform)
@@ -86,6 +131,9 @@ csv_reader& csv_reader::operator=(const csv_reader& other)
   m_index = other.m_index;
   m_labels = other.m_labels;
   m_responses = other.m_responses;
+  m_binary_cache = other.m_binary_cache;
+  m_binary_cache_rows = other.m_binary_cache_rows;
+  m_binary_cache_row_len = other.m_binary_cache_row_len;
   m_col_transforms = other.m_col_transforms;
   m_label_transform = other.m_label_transform;
   m_response_transform = other.m_response_transform;
@@ -110,6 +158,30 @@ void csv_reader::load()
 {
   bool master = m_comm->am_world_master();
   setup_ifstreams();
+
+  // Use the binary cache if a current one exists
+  const std::string cache_dir =
+    global_argument_parser().get<std::string>(LBANN_OPTION_CSV_BINARY_CACHE);
+  const uint64_t cache_key = get_binary_cache_key();
+  std::string cache_filename;
+  if (!cache_dir.empty()) {
+    std::ostringstream name;
+    name << file::extract_base_name(get_data_filename()) << "." << std::hex
+         << cache_key << ".lbcache";
+    cache_filename = file::join_path(cache_dir, name.str());
+    if (load_binary_cache(cache_filename, cache_key)) {
+      if (master) {
+        std::cerr << "num samples: " << m_num_samples << " (from "
+                  << cache_filename << ")\n";
+      }
+      m_shuffled_indices.resize(m_num_samples);
+      std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+      resize_shuffled_indices();
+      select_subset_of_data();
+      return;
+    }
+  }
+
   std::ifstream& ifs = *m_ifstreams[0];
   const El::mpi::Comm& world_comm = m_comm->get_world_comm();
   // Parse the header to determine how many columns there are.
@@ -175,60 +247,8 @@ void csv_reader::load()
     // TODO: Skip comment lines.
     // Used to count the number of label classes.
     std::unordered_set<int> label_classes;
-    index.push_back(ifs.tellg());
+    index_lines(static_cast<size_t>(ifs.tellg()), index, label_classes);
 
-    int num_samples_to_use = get_absolute_sample_count();
-    int line_num = 0;
-    if (num_samples_to_use == 0) {
-      num_samples_to_use = -1;
-    }
-    while (std::getline(ifs, line)) {
-      if (line_num == num_samples_to_use) {
-        break;
-      }
-      ++line_num;
-
-      // Verify the line has the right number of columns.
-      if (std::count(line.begin(), line.end(), m_separator) + 1 != m_num_cols) {
-        throw lbann_exception("csv_reader: line " + std::to_string(line_num) +
-                              " does not have right number of entries");
-      }
-      index.push_back(ifs.tellg());
-      // Extract the label.
-      if (!m_disable_labels) {
-        size_t cur_pos = 0;
-        for (int col = 0; col < m_num_cols; ++col) {
-          size_t end_pos = line.find_first_of(m_separator, cur_pos);
-          if (col == m_label_col) {
-            int label =
-              m_label_transform(line.substr(cur_pos, end_pos - cur_pos));
-            label_classes.insert(label);
-            m_labels.push_back(label);
-            break;
-          }
-          cur_pos = end_pos + 1;
-        }
-      }
-      // Possibly extract the response.
-      if (!m_disable_responses) {
-        size_t cur_pos = 0;
-        for (int col = 0; col < m_num_cols; ++col) {
-          size_t end_pos = line.find_first_of(m_separator, cur_pos);
-          if (col == m_response_col) {
-            DataType response =
-              m_response_transform(line.substr(cur_pos, end_pos - cur_pos));
-            m_responses.push_back(response);
-            break;
-          }
-          cur_pos = end_pos + 1;
-        }
-      }
-    }
-
-    if (!ifs.eof() && num_samples_to_use == 0) {
-      // If we didn't get to EOF, something went wrong.
-      throw lbann_exception("csv_reader: did not reach EOF");
-    }
     if (!m_disable_labels) {
       // Do some simple validation checks on the classes.
       // Ensure the elements begin with 0, and there are no gaps.
@@ -271,6 +291,14 @@ void csv_reader::load()
     m_num_labels = m_labels.size();
   }
 
+  // Parse every row once into the binary cache, then fetch from it
+  if (!cache_filename.empty()) {
+    write_binary_cache(cache_filename, cache_key);
+    if (!load_binary_cache(cache_filename, cache_key)) {
+      LBANN_ERROR("failed to load the CSV binary cache ", cache_filename);
+    }
+  }
+
   // Reset indices.
   m_shuffled_indices.resize(m_num_samples);
   std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
@@ -287,10 +315,15 @@ void csv_reader::setup(int num_io_threads,
 
 bool csv_reader::fetch_datum(CPUMat& X, uint64_t data_id, uint64_t mb_idx)
 {
-  auto line = fetch_line_label_response(data_id);
-  // TODO: Avoid unneeded copies.
-  for (size_t i = 0; i < line.size(); ++i) {
-    X(i, mb_idx) = line[i];
+  // Columns are contiguous, so parse or copy straight into X
+  DataType* dst = X.Buffer(0, mb_idx);
+  if (m_binary_cache) {
+    std::copy_n(m_binary_cache_rows + data_id * m_binary_cache_row_len,
+                m_binary_cache_row_len,
+                dst);
+  }
+  else {
+    parse_line(fetch_raw_line(data_id), dst);
   }
   return true;
 }
@@ -339,45 +372,72 @@ std::vector<DataType> csv_reader::fetch_line(uint64_t data_id)
 
 std::vector<DataType> csv_reader::fetch_line_label_response(uint64_t data_id)
 {
-  std::string line = fetch_raw_line(data_id);
-  std::vector<DataType> parsed_line;
+  if (m_binary_cache) {
+    const DataType* row =
+      m_binary_cache_rows + data_id * m_binary_cache_row_len;
+    return std::vector<DataType>(row, row + m_binary_cache_row_len);
+  }
+  std::vector<DataType> parsed_line(m_num_cols);
+  parsed_line.resize(parse_line(fetch_raw_line(data_id), parsed_line.data()));
+  return parsed_line;
+}
+
+size_t csv_reader::parse_line(const std::string& line, DataType* dst)
+{
   // Note: load already verified that every line is properly formatted.
+  const char* const buf = line.c_str();
+  size_t count = 0;
   size_t cur_pos = 0; // Current *start* of a column.
   for (int col = 0; col < m_num_cols; ++col) {
-    // Note for last column, this returns std::npos, which substr handles.
-    size_t end_pos = line.find_first_of(m_separator, cur_pos);
+    size_t end_pos = line.find(m_separator, cur_pos);
+    if (end_pos == std::string::npos) {
+      end_pos = line.size();
+    }
     // Skip the label, response, and any columns if needed.
-    if ((!m_disable_labels && col == m_label_col) ||
-        (!m_disable_responses && col == m_response_col) || col < m_skip_cols) {
+    if (!is_data_col(col)) {
       cur_pos = end_pos + 1;
       continue;
     }
-    // Note: This results in a copy, switch to string_view when we can.
-    std::string str_val = line.substr(cur_pos, end_pos - cur_pos);
-    cur_pos = end_pos + 1;
-    DataType val;
     if (m_col_transforms.count(col)) {
-      val = m_col_transforms[col](str_val);
+      dst[count] =
+        m_col_transforms[col](line.substr(cur_pos, end_pos - cur_pos));
     }
     else {
-      // No easy way to parameterize based on DataType, so always use double.
-      try {
-        val = std::stod(str_val);
-      }
-      catch (std::invalid_argument& e) {
-        throw lbann_exception("csv_reader: could not convert '" + str_val +
-                              "'");
+      // Parse in place: strtod stops at the separator, so the field is
+      // never copied out. No easy way to parameterize based on DataType,
+      // so always use double.
+      char* parsed_end = nullptr;
+      const double val = std::strtod(buf + cur_pos, &parsed_end);
+      if (parsed_end == buf + cur_pos || parsed_end > buf + end_pos) {
+        throw lbann_exception("csv_reader: could not convert '" +
+                              line.substr(cur_pos, end_pos - cur_pos) + "'");
       }
+      dst[count] = val;
     }
-    parsed_line.push_back(val);
+    ++count;
+    cur_pos = end_pos + 1;
   }
-  return parsed_line;
+  return count;
+}
+
+size_t csv_reader::get_num_parsed_cols() const
+{
+  size_t count = 0;
+  for (int col = 0; col < m_num_cols; ++col) {
+    count += is_data_col(col) ? 1 : 0;
+  }
+  return count;
 }
 
 std::string csv_reader::fetch_raw_line(uint64_t data_id)
+{
+  return read_raw_line(*m_ifstreams[m_io_thread_pool->get_local_thread_id()],
+                       data_id);
+}
+
+std::string csv_reader::read_raw_line(std::ifstream& ifs, uint64_t data_id)
 {
   static int n = 0;
-  std::ifstream& ifs = *m_ifstreams[m_io_thread_pool->get_local_thread_id()];
   // Seek to the start of this datum's line.
   ifs.seekg(m_index[data_id], std::ios::beg);
   // Compute the length of the line to read, excluding newline.
@@ -428,4 +488,258 @@ void csv_reader::setup_ifstreams()
   }
 }
 
+void csv_reader::index_lines(size_t body_start,
+                             std::vector<long long>& index,
+                             std::unordered_set<int>& label_classes)
+{
+  const file::mapped_file map(get_file_dir() + get_data_filename());
+  const char* const data = map.data();
+  const size_t size = map.size();
+
+  // Split the body into one chunk per thread, each starting on a line
+  const int num_chunks = std::max(1, omp_get_max_threads());
+  std::vector<size_t> bounds(num_chunks + 1, size);
+  bounds[0] = std::min(body_start, size);
+  for (int c = 1; c < num_chunks; ++c) {
+    size_t pos = bounds[0] + (size - bounds[0]) * c / num_chunks;
+    pos = std::max(pos, bounds[c - 1]);
+    if (pos > bounds[0] && pos < size) {
+      const void* nl = std::memchr(data + pos - 1, '\n', size - pos + 1);
+      pos = nl ? static_cast<const char*>(nl) - data + 1 : size;
+    }
+    bounds[c] = pos;
+  }
+
+  // Locate the lines and extract the label/response of each chunk
+  std::vector<line_chunk> chunks(num_chunks);
+  LBANN_OMP_PARALLEL_FOR
+  for (int c = 0; c < num_chunks; ++c) {
+    line_chunk& chunk = chunks[c];
+    const char* line_begin = data + bounds[c];
+    const char* const chunk_end = data + bounds[c + 1];
+    while (line_begin < chunk_end) {
+      const void* nl = std::memchr(line_begin, '\n', chunk_end - line_begin);
+      const char* line_end = nl ? static_cast<const char*>(nl) : chunk_end;
+      // Verify the line has the right number of columns.
+      if (std::count(line_begin, line_end, m_separator) + 1 != m_num_cols) {
+        chunk.bad_line = chunk.offsets.size();
+        chunk.error = " does not have right number of entries";
+        break;
+      }
+      try {
+        const char* field_begin = line_begin;
+        for (int col = 0; col < m_num_cols; ++col) {
+          const char* field_end = std::find(field_begin, line_end, m_separator);
+          if (!m_disable_labels && col == m_label_col) {
+            int label = m_label_transform(std::string(field_begin, field_end));
+            chunk.labels.push_back(label);
+          }
+          if (!m_disable_responses && col == m_response_col) {
+            chunk.responses.push_back(
+              m_response_transform(std::string(field_begin, field_end)));
+          }
+          field_begin = field_end + 1;
+        }
+      }
+      catch (const std::exception& e) {
+        chunk.bad_line = chunk.offsets.size();
+        chunk.error = std::string(": ") + e.what();
+        break;
+      }
+      chunk.offsets.push_back(line_begin - data);
+      line_begin = line_end + 1;
+    }
+    chunk.offsets.push_back(line_begin - data);
+  }
+
+  // Stitch the chunks together in file order, honoring the sample count
+  int num_samples_to_use = get_absolute_sample_count();
+  size_t max_lines = std::string::npos;
+  if (num_samples_to_use > 0) {
+    max_lines = num_samples_to_use;
+  }
+  index.clear();
+  size_t num_lines = 0;
+  long long end_offset = bounds[0];
+  for (const auto& chunk : chunks) {
+    const size_t chunk_lines = chunk.offsets.size() - 1;
+    const size_t lines = std::min(chunk_lines, max_lines - num_lines);
+    if (lines > 0) {
+      index.insert(index.end(),
+                   chunk.offsets.begin(),
+                   chunk.offsets.begin() + lines);
+      if (!m_disable_labels) {
+        label_classes.insert(chunk.labels.begin(),
+                             chunk.labels.begin() + lines);
+        m_labels.insert(m_labels.end(),
+                        chunk.labels.begin(),
+                        chunk.labels.begin() + lines);
+      }
+      if (!m_disable_responses) {
+        m_responses.insert(m_responses.end(),
+                           chunk.responses.begin(),
+                           chunk.responses.begin() + lines);
+      }
+      end_offset = chunk.offsets[lines];
+      num_lines += lines;
+    }
+    if (num_lines == max_lines) {
+      break;
+    }
+    if (chunk.bad_line != std::string::npos) {
+      throw lbann_exception("csv_reader: line " +
+                            std::to_string(num_lines + 1) + chunk.error);
+    }
+  }
+  index.push_back(end_offset);
+}
+
+uint64_t csv_reader::get_binary_cache_key() const
+{
+  struct stat st;
+  const std::string filename = get_file_dir() + get_data_filename();
+  if (stat(filename.c_str(), &st) != 0) {
+    LBANN_ERROR("failed to stat ", filename);
+  }
+  size_t h = hash_combine(0, static_cast<long long>(st.st_size));
+  h = hash_combine(h, static_cast<long long>(st.st_mtime));
+  h = hash_combine(h, m_separator);
+  for (int v : {m_skip_cols,
+                m_skip_rows,
+                m_label_col,
+                m_response_col,
+                static_cast<int>(m_has_header),
+                static_cast<int>(m_disable_labels),
+                static_cast<int>(m_disable_responses),
+                static_cast<int>(sizeof(DataType))}) {
+    h = hash_combine(h, v);
+  }
+  return hash_combine(h, get_absolute_sample_count());
+}
+
+bool csv_reader::load_binary_cache(const std::string& filename, uint64_t key)
+{
+  // The root decides so that every rank takes the same path
+  int current = 0;
+  binary_cache_header header;
+  if (m_comm->am_world_master()) {
+    std::ifstream in(filename, std::ios::binary);
+    current = in && in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+              std::memcmp(header.magic,
+                          binary_cache_magic,
+                          sizeof(header.magic)) == 0 &&
+              header.key == key;
+  }
+  m_comm->broadcast<int>(0, current, m_comm->get_world_comm());
+  if (!current) {
+    return false;
+  }
+
+  auto map = std::make_shared<const file::mapped_file>(filename);
+  std::memcpy(&header, map->data(), sizeof(header));
+  const size_t num_rows = header.num_rows;
+  if (map->size() <
+      header.rows_offset + num_rows * header.row_len * sizeof(DataType)) {
+    LBANN_ERROR("CSV binary cache ", filename, " is truncated");
+  }
+  m_num_cols = header.num_cols;
+  m_num_samples = num_rows;
+  m_label_col = m_num_cols - 1;
+  const char* p = map->data() + sizeof(header);
+  if (!m_disable_labels) {
+    const int32_t* labels = reinterpret_cast<const int32_t*>(p);
+    m_labels.assign(labels, labels + num_rows);
+    m_num_labels = m_labels.size();
+    p += num_rows * sizeof(int32_t);
+  }
+  if (!m_disable_responses) {
+    m_response_col = m_num_cols - 1;
+    const DataType* responses = reinterpret_cast<const DataType*>(p);
+    m_responses.assign(responses, responses + num_rows);
+  }
+  m_index.clear();
+  m_binary_cache_rows =
+    reinterpret_cast<const DataType*>(map->data() + header.rows_offset);
+  m_binary_cache_row_len = header.row_len;
+  m_binary_cache = std::move(map);
+  return true;
+}
+
+void csv_reader::write_binary_cache(const std::string& filename, uint64_t key)
+{
+  binary_cache_header header;
+  std::memcpy(header.magic, binary_cache_magic, sizeof(header.magic));
+  header.key = key;
+  header.num_rows = m_num_samples;
+  header.num_cols = m_num_cols;
+  header.row_len = get_num_parsed_cols();
+  size_t rows_offset = sizeof(header);
+  if (!m_disable_labels) {
+    rows_offset += header.num_rows * sizeof(int32_t);
+  }
+  if (!m_disable_responses) {
+    rows_offset += header.num_rows * sizeof(DataType);
+  }
+  // Align the rows for direct access through the mapping
+  rows_offset = (rows_offset + 63) / 64 * 64;
+  header.rows_offset = rows_offset;
+  const size_t row_bytes = header.row_len * sizeof(DataType);
+  const std::string tmp_filename = filename + ".tmp";
+
+  // The root writes the header, labels, and responses and sizes the file
+  if (m_comm->am_world_master()) {
+    file::make_directory(file::extract_parent_directory(filename));
+    std::ofstream out(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      LBANN_ERROR("failed to open ", tmp_filename, " for writing");
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!m_disable_labels) {
+      std::vector<int32_t> labels(m_labels.begin(), m_labels.end());
+      out.write(reinterpret_cast<const char*>(labels.data()),
+                labels.size() * sizeof(int32_t));
+    }
+    if (!m_disable_responses) {
+      out.write(reinterpret_cast<const char*>(m_responses.data()),
+                m_responses.size() * sizeof(DataType));
+    }
+    out.close();
+    if (!out || truncate(tmp_filename.c_str(),
+                         rows_offset + header.num_rows * row_bytes) != 0) {
+      LBANN_ERROR("failed to write ", tmp_filename);
+    }
+  }
+  m_comm->global_barrier();
+
+  // Every rank parses a contiguous block of rows into its part of the file
+  const uint64_t rank = m_comm->get_rank_in_world();
+  const uint64_t nprocs = m_comm->get_procs_in_world();
+  const uint64_t begin = header.num_rows * rank / nprocs;
+  const uint64_t end = header.num_rows * (rank + 1) / nprocs;
+  if (begin < end) {
+    std::fstream out(tmp_filename,
+                     std::ios::in | std::ios::out | std::ios::binary);
+    if (!out) {
+      LBANN_ERROR("failed to open ", tmp_filename, " for writing");
+    }
+    out.seekp(rows_offset + begin * row_bytes);
+    std::vector<DataType> row(m_num_cols);
+    for (uint64_t j = begin; j < end; ++j) {
+      parse_line(read_raw_line(*m_ifstreams[0], j), row.data());
+      out.write(reinterpret_cast<const char*>(row.data()), row_bytes);
+    }
+    if (!out) {
+      LBANN_ERROR("failed to write rows to ", tmp_filename);
+    }
+  }
+  m_comm->global_barrier();
+
+  if (m_comm->am_world_master()) {
+    if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+      LBANN_ERROR("failed to rename ", tmp_filename, " to ", filename);
+    }
+  }
+  m_comm->global_barrier();
+}
+
 } // namespace lbann
@@ -117,17 +117,19 @@ void hdf5_reader<TensorDataType>::read_hdf5_hyperslab(hsize_t h_data,
                                                       TensorDataType* sample)
 {
   prof_region_begin("read_hdf5_hyperslab", prof_colors[0], false);
-  // this is the splits, right now it is hard coded to split along the
-  // z axis
-  int num_io_parts = dc::get_number_of_io_partitions();
+  // Each rank reads the (depth, height, width) block of the sample
+  // that matches its part of the IO partitioning
+  const auto block = dc::get_io_partition_index(rank);
 
   // how many times the pattern should repeat in the hyperslab
   hsize_t count[4] = {1, 1, 1, 1};
 
   // necessary for the hdf5 lib
   hid_t memspace = H5Screate_simple(4, m_hyperslab_dims.data(), NULL);
-  int spatial_offset = rank % num_io_parts;
-  hsize_t offset[4] = {0, m_hyperslab_dims[1] * spatial_offset, 0, 0};
+  hsize_t offset[4] = {0,
+                       m_hyperslab_dims[1] * block[0],
+                       m_hyperslab_dims[2] * block[1],
+                       m_hyperslab_dims[3] * block[2]};
 
   // from an explanation of the hdf5 select_hyperslab:
   // start -> a starting location for the hyperslab
@@ -246,8 +248,20 @@ void hdf5_reader<TensorDataType>::load()
   for (auto i : m_data_dims) {
     m_hyperslab_dims.push_back(i);
   }
-  // Partition the z dimension
-  m_hyperslab_dims[1] /= dc::get_number_of_io_partitions();
+  // Partition the spatial dimensions
+  const auto& io_shape = dc::get_io_partition_shape();
+  for (int i = 0; i < 3; ++i) {
+    if (m_hyperslab_dims[i + 1] % io_shape[i] != 0) {
+      LBANN_ERROR("spatial dimension ",
+                  i,
+                  " of the HDF5 samples (",
+                  m_hyperslab_dims[i + 1],
+                  ") is not divisible by the number of IO partitions (",
+                  io_shape[i],
+                  ")");
+    }
+    m_hyperslab_dims[i + 1] /= io_shape[i];
+  }
 
 #define DATA_READER_HDF5_USE_MPI_IO
 #ifdef DATA_READER_HDF5_USE_MPI_IO
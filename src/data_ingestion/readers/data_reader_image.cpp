@@ -32,9 +32,13 @@
 #include "lbann/data_ingestion/readers/sample_list_impl.hpp"
 #include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/lbann_library.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/threads/thread_utils.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/vectorwrapbuf.hpp"
+#ifdef LBANN_HAS_OPENCV
+#include "lbann/utils/image.hpp"
+#endif // LBANN_HAS_OPENCV
 
 #include <fstream>
 
@@ -290,20 +294,9 @@ void image_data_reader::do_preload_data_store()
       }
     }
 
-    for (int t = 0; t < num_threads; t++) {
-      if (t == io_thread_pool->get_local_thread_id()) {
-        continue;
-      }
-      else {
-        io_thread_pool->submit_job_to_work_group(
-          std::bind(&image_data_reader::load_conduit_nodes_from_file,
-                    this,
-                    data_ids[t]));
-      }
-    }
-    load_conduit_nodes_from_file(
-      data_ids[io_thread_pool->get_local_thread_id()]);
-    io_thread_pool->finish_work_group();
+    io_thread_pool->parallel_for(0, num_threads, [&](int t) {
+      load_conduit_nodes_from_file(data_ids[t]);
+    });
   }
   else {
     if (get_comm()->am_world_master()) {
@@ -356,10 +349,36 @@ void image_data_reader::load_conduit_node_from_file(uint64_t data_id,
                 ".");
   }
   const label_t label = m_labels[data_id];
+  node[LBANN_DATA_ID_STR(data_id) + "/label"].set(label);
+
+  if (global_argument_parser().get<bool>(
+        LBANN_OPTION_DATA_STORE_DECODED_IMAGES)) {
+    // Store the image decoded and with the deterministic transforms
+    // applied; "dims" marks the buffer as decoded.
+    if (m_data_store != nullptr && m_data_store->is_local_cache()) {
+      LBANN_ERROR("--data_store_decoded_images is not supported with "
+                  "--data_store_cache");
+    }
+#ifdef LBANN_HAS_OPENCV
+    El::Matrix<uint8_t> image;
+    std::vector<size_t> dims;
+    load_image(filename, image, dims);
+    m_transform_pipeline.apply_deterministic_prefix(image, dims);
+    const size_t size = image.Height() * image.Width();
+    std::vector<uint64_t> dims_u64(dims.begin(), dims.end());
+    node[LBANN_DATA_ID_STR(data_id) + "/buffer"].set_char_ptr(
+      reinterpret_cast<char*>(image.Buffer()),
+      size);
+    node[LBANN_DATA_ID_STR(data_id) + "/buffer_size"] = size;
+    node[LBANN_DATA_ID_STR(data_id) + "/dims"].set(dims_u64);
+    return;
+#else
+    LBANN_ERROR("--data_store_decoded_images requires OpenCV");
+#endif // LBANN_HAS_OPENCV
+  }
 
   std::vector<char> data;
   read_raw_data(filename, data);
-  node[LBANN_DATA_ID_STR(data_id) + "/label"].set(label);
   node[LBANN_DATA_ID_STR(data_id) + "/buffer"].set(data);
   node[LBANN_DATA_ID_STR(data_id) + "/buffer_size"] = data.size();
 }
@@ -30,6 +30,9 @@
 #include "lbann/data_ingestion/readers/sample_list_impl.hpp"
 #include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/image.hpp"
+#include "lbann/utils/scratch_arena.hpp"
+
+#include <cstring>
 
 namespace lbann {
 
@@ -60,6 +63,7 @@ bool imagenet_reader::fetch_datum(CPUMat& X, uint64_t data_id, uint64_t mb_idx)
 {
   El::Matrix<uint8_t> image;
   std::vector<size_t> dims;
+  size_t first_transform = 0;
   const auto file_id = m_sample_list[data_id].first;
   const std::string filename = m_sample_list.get_samples_filename(file_id);
   const std::string image_path = get_file_dir() + filename;
@@ -106,11 +110,23 @@ bool imagenet_reader::fetch_datum(CPUMat& X, uint64_t data_id, uint64_t mb_idx)
     if (have_node) {
       char* buf = node[LBANN_DATA_ID_STR(data_id) + "/buffer"].value();
       size_t size = node[LBANN_DATA_ID_STR(data_id) + "/buffer_size"].value();
-      El::Matrix<uint8_t> encoded_image(size,
-                                        1,
-                                        reinterpret_cast<uint8_t*>(buf),
-                                        size);
-      decode_image(encoded_image, image, dims);
+      const std::string dims_path = LBANN_DATA_ID_STR(data_id) + "/dims";
+      if (node.has_path(dims_path)) {
+        // Already decoded; copy it, as transforms modify it in-place.
+        const uint64_t* stored_dims = node[dims_path].as_uint64_ptr();
+        dims.assign(stored_dims, stored_dims + 3);
+        utils::attach_scratch_matrix(image, size, 1);
+        std::memcpy(image.Buffer(), buf, size);
+        first_transform =
+          m_transform_pipeline.get_deterministic_prefix_length();
+      }
+      else {
+        El::Matrix<uint8_t> encoded_image(size,
+                                          1,
+                                          reinterpret_cast<uint8_t*>(buf),
+                                          size);
+        decode_image(encoded_image, image, dims);
+      }
     }
   }
 
@@ -120,7 +136,7 @@ bool imagenet_reader::fetch_datum(CPUMat& X, uint64_t data_id, uint64_t mb_idx)
   }
 
   auto X_v = create_datum_view(X, mb_idx);
-  m_transform_pipeline.apply(image, X_v, dims);
+  m_transform_pipeline.apply(image, X_v, dims, first_transform);
 
   return true;
 }
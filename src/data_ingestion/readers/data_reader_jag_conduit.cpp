@@ -278,6 +278,14 @@ void data_reader_jag_conduit::read_node(const hid_t& h,
 }
 #endif
 
+bool data_reader_jag_conduit::is_variable_used(const variable_t t) const
+{
+  return (std::find(m_independent.cbegin(), m_independent.cend(), t) !=
+          m_independent.cend()) ||
+         (std::find(m_dependent.cbegin(), m_dependent.cend(), t) !=
+          m_dependent.cend());
+}
+
 const conduit::Node&
 data_reader_jag_conduit::get_conduit_node(const conduit::Node& n_base,
                                           const std::string key)
@@ -902,41 +910,57 @@ void data_reader_jag_conduit::do_preload_data_store()
     LBANN_WARNING("starting preload for role: ", get_role());
   }
 
-  for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
-    int index = m_shuffled_indices[idx];
-    if (m_data_store->get_index_owner(index) !=
-        get_comm()->get_rank_in_trainer()) {
-      continue;
+  // Only read the fields that the experiment uses, rather than the
+  // whole scalar, input and image groups of each sample
+  std::vector<std::string> field_names;
+  if (is_variable_used(JAG_Scalar)) {
+    for (const auto& scalar_key : m_scalar_keys) {
+      field_names.push_back(m_output_scalar_prefix + scalar_key);
     }
-    try {
-      const sample_t& s = m_sample_list[index];
-      const std::string& sample_name = s.second;
-      sample_file_id_t id = s.first;
-      m_sample_list.open_samples_file_handle(index);
-      auto h = m_sample_list.get_samples_file_handle(id);
-      conduit::Node& node = m_data_store->get_empty_node(index);
-
-      preload_helper(h, sample_name, m_output_scalar_prefix, index, node);
-      preload_helper(h, sample_name, m_input_prefix, index, node);
-      for (auto t : m_emi_image_keys) {
-        const std::string field_name = m_output_image_prefix + t;
-        preload_helper(h, sample_name, field_name, index, node);
-      }
-      m_data_store->set_preloaded_conduit_node(index, node);
+  }
+  if (is_variable_used(JAG_Input)) {
+    for (const auto& input_key : m_input_keys) {
+      field_names.push_back(m_input_prefix + input_key);
     }
-    catch (conduit::Error const& e) {
-      LBANN_ERROR(" :: trying to load the node " + std::to_string(index) +
-                  " with key " + key + " and got " + e.what());
+  }
+  if (is_variable_used(JAG_Image)) {
+    for (const auto& t : m_emi_image_keys) {
+      field_names.push_back(m_output_image_prefix + t);
     }
   }
-  /// Once all of the data has been preloaded, close all of the file handles
+
+  // Group the samples this rank owns by file, so that each file is
+  // opened once and read through in sample list order
+  std::map<sample_file_id_t, std::vector<size_t>> indices_by_file;
   for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
     int index = m_shuffled_indices[idx];
     if (m_data_store->get_index_owner(index) !=
         get_comm()->get_rank_in_trainer()) {
       continue;
     }
-    m_sample_list.close_samples_file_handle(index, true);
+    indices_by_file[m_sample_list[index].first].push_back(index);
+  }
+
+  for (auto& [id, indices] : indices_by_file) {
+    std::sort(indices.begin(), indices.end());
+    m_sample_list.open_samples_file_handle(indices.front());
+    auto h = m_sample_list.get_samples_file_handle(id);
+    for (const size_t index : indices) {
+      try {
+        const std::string& sample_name = m_sample_list[index].second;
+        conduit::Node& node = m_data_store->get_empty_node(index);
+        for (const auto& field_name : field_names) {
+          preload_helper(h, sample_name, field_name, index, node);
+        }
+        m_data_store->set_preloaded_conduit_node(index, node);
+      }
+      catch (conduit::Error const& e) {
+        LBANN_ERROR(" :: trying to load the node " + std::to_string(index) +
+                    " with key " + key + " and got " + e.what());
+      }
+    }
+    /// The file is not needed again once its samples are loaded
+    m_sample_list.close_samples_file_handle(indices.front(), true);
   }
 
   if (get_comm()->am_world_master() ||
@@ -944,7 +968,10 @@ void data_reader_jag_conduit::do_preload_data_store()
        get_comm()->am_trainer_master())) {
     std::stringstream msg;
     msg << " loading data for role: " << get_role() << " took "
-        << get_time() - tm1 << "s";
+        << get_time() - tm1 << "s; open file cache hits: "
+        << m_sample_list.get_num_file_handle_hits()
+        << " misses: " << m_sample_list.get_num_file_handle_misses()
+        << " evictions: " << m_sample_list.get_num_file_handle_evictions();
     LBANN_WARNING(msg.str());
   }
 }
@@ -1624,12 +1651,15 @@ bool data_reader_jag_conduit::fetch_datum(CPUMat& X,
   bool ok = true;
   // Create a node to hold all of the data
   conduit::Node node;
+  // Other I/O threads may be opening files, so hold a lease on this one
+  bool leased = false;
   if (data_store_active()) {
     const conduit::Node& ds_node = m_data_store->get_conduit_node(data_id);
     node.set_external(ds_node);
   }
   else {
-    m_sample_list.open_samples_file_handle(data_id);
+    m_sample_list.acquire_samples_file_handle(data_id);
+    leased = true;
   }
 
   for (size_t i = 0u; ok && (i < X_v.size()); ++i) {
@@ -1643,7 +1673,9 @@ bool data_reader_jag_conduit::fetch_datum(CPUMat& X,
     m_data_store->set_conduit_node(data_id, node);
   }
 
-  m_sample_list.close_samples_file_handle(data_id, true);
+  if (leased) {
+    m_sample_list.release_samples_file_handle(data_id);
+  }
   m_using_random_node.erase(m_io_thread_pool->get_local_thread_id());
   return ok;
 }
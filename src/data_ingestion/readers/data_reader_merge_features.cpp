@@ -43,7 +43,9 @@ data_reader_merge_features::data_reader_merge_features(
 
 data_reader_merge_features::data_reader_merge_features(
   const data_reader_merge_features& other)
-  : generic_compound_data_reader(other), m_data_size(other.m_data_size)
+  : generic_compound_data_reader(other),
+    m_data_size(other.m_data_size),
+    m_data_offsets(other.m_data_offsets)
 {
   if (other.m_label_reader != nullptr)
     m_label_reader = other.m_label_reader->copy();
@@ -56,6 +58,7 @@ data_reader_merge_features::operator=(const data_reader_merge_features& other)
 {
   generic_compound_data_reader::operator=(other);
   m_data_size = other.m_data_size;
+  m_data_offsets = other.m_data_offsets;
   if (m_label_reader) {
     delete m_label_reader;
   }
@@ -75,11 +78,14 @@ data_reader_merge_features::~data_reader_merge_features()
 void data_reader_merge_features::load()
 {
   // Load each data reader separately.
+  m_data_size = 0;
+  m_data_offsets.assign(1, 0);
   for (auto&& reader : m_data_readers) {
     double tm1 = get_time();
     reader->set_comm(m_comm);
     reader->load();
     m_data_size += reader->get_linearized_data_size();
+    m_data_offsets.push_back(m_data_size);
     if (get_comm()->am_world_master()) {
       std::cerr << "time to set up subsidiary reader: " << get_time() - tm1
                 << "\n";
@@ -115,12 +121,11 @@ bool data_reader_merge_features::fetch_datum(CPUMat& X,
                                              uint64_t data_id,
                                              uint64_t mb_idx)
 {
-  int start = 0;
-  for (auto&& reader : m_data_readers) {
-    auto X_view =
-      X(El::IR(start, start + reader->get_linearized_data_size()), El::ALL);
-    reader->fetch_datum(X_view, data_id, mb_idx);
-    start += reader->get_linearized_data_size();
+  // Row ranges are fixed at load, so each sample skips the size
+  // queries on the subsidiary readers.
+  for (size_t i = 0; i < m_data_readers.size(); ++i) {
+    auto X_view = X(El::IR(m_data_offsets[i], m_data_offsets[i + 1]), El::ALL);
+    m_data_readers[i]->fetch_datum(X_view, data_id, mb_idx);
   }
   return true;
 }
@@ -29,6 +29,10 @@
 #include "lbann/data_ingestion/readers/data_reader_merge_samples.hpp"
 #include "lbann/utils/options.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 namespace lbann {
 
 data_reader_merge_samples::data_reader_merge_samples(
@@ -42,7 +46,8 @@ data_reader_merge_samples::data_reader_merge_samples(
 data_reader_merge_samples::data_reader_merge_samples(
   const data_reader_merge_samples& other)
   : generic_compound_data_reader(other),
-    m_num_samples_psum(other.m_num_samples_psum)
+    m_num_samples_psum(other.m_num_samples_psum),
+    m_sample_readers(other.m_sample_readers)
 {}
 
 data_reader_merge_samples&
@@ -50,6 +55,7 @@ data_reader_merge_samples::operator=(const data_reader_merge_samples& other)
 {
   generic_compound_data_reader::operator=(other);
   m_num_samples_psum = other.m_num_samples_psum;
+  m_sample_readers = other.m_sample_readers;
   return *this;
 }
 
@@ -57,9 +63,13 @@ data_reader_merge_samples::~data_reader_merge_samples() {}
 
 size_t data_reader_merge_samples::compute_num_samples_psum()
 {
+  if (m_data_readers.size() >
+      size_t{std::numeric_limits<uint16_t>::max()} + 1) {
+    throw lbann_exception("data_reader_merge_samples: too many data readers");
+  }
   size_t global_num_samples = 0;
   // Prepend a 0 to make things easier.
-  m_num_samples_psum.push_back(0);
+  m_num_samples_psum.assign(1, 0);
   for (auto&& reader : m_data_readers) {
     m_num_samples_psum.push_back(reader->get_num_data());
     global_num_samples += reader->get_num_data();
@@ -67,9 +77,27 @@ size_t data_reader_merge_samples::compute_num_samples_psum()
   std::partial_sum(m_num_samples_psum.begin(),
                    m_num_samples_psum.end(),
                    m_num_samples_psum.begin());
+  // Flatten the partial sums into a per-sample reader table.
+  m_sample_readers.resize(global_num_samples);
+  for (size_t i = 0; i < m_data_readers.size(); ++i) {
+    std::fill(m_sample_readers.begin() + m_num_samples_psum[i],
+              m_sample_readers.begin() + m_num_samples_psum[i + 1],
+              static_cast<uint16_t>(i));
+  }
   return global_num_samples;
 }
 
+std::pair<generic_data_reader*, uint64_t>
+data_reader_merge_samples::find_sample(uint64_t data_id) const
+{
+  if (data_id >= m_sample_readers.size()) {
+    throw lbann_exception("data_reader_merge_samples: do not have data ID " +
+                          std::to_string(data_id));
+  }
+  const auto i = m_sample_readers[data_id];
+  return {m_data_readers[i], data_id - m_num_samples_psum[i]};
+}
+
 void data_reader_merge_samples::sanity_check_for_consistency(
   int num_labels,
   int data_size,
@@ -129,45 +157,24 @@ bool data_reader_merge_samples::fetch_datum(CPUMat& X,
                                             uint64_t data_id,
                                             uint64_t mb_idx)
 {
-  // Find the right data reader to delegate to.
-  for (size_t i = 0; i < m_data_readers.size(); ++i) {
-    if (data_id < m_num_samples_psum[i + 1]) {
-      data_id -= m_num_samples_psum[i];
-      return m_data_readers[i]->fetch_datum(X, data_id, mb_idx);
-    }
-  }
-  throw lbann_exception("data_reader_merge_samples: do not have data ID " +
-                        std::to_string(data_id));
+  const auto [reader, local_id] = find_sample(data_id);
+  return reader->fetch_datum(X, local_id, mb_idx);
 }
 
 bool data_reader_merge_samples::fetch_label(CPUMat& Y,
                                             uint64_t data_id,
                                             uint64_t mb_idx)
 {
-  // Find the right data reader to delegate to.
-  for (size_t i = 0; i < m_data_readers.size(); ++i) {
-    if (data_id < m_num_samples_psum[i + 1]) {
-      data_id -= m_num_samples_psum[i];
-      return m_data_readers[i]->fetch_label(Y, data_id, mb_idx);
-    }
-  }
-  throw lbann_exception("data_reader_merge_samples: do not have data ID " +
-                        std::to_string(data_id));
+  const auto [reader, local_id] = find_sample(data_id);
+  return reader->fetch_label(Y, local_id, mb_idx);
 }
 
 bool data_reader_merge_samples::fetch_response(CPUMat& Y,
                                                uint64_t data_id,
                                                uint64_t mb_idx)
 {
-  // Find the right data reader to delegate to.
-  for (size_t i = 0; i < m_data_readers.size(); ++i) {
-    if (data_id < m_num_samples_psum[i + 1]) {
-      data_id -= m_num_samples_psum[i];
-      return m_data_readers[i]->fetch_response(Y, data_id, mb_idx);
-    }
-  }
-  throw lbann_exception("data_reader_merge_samples: do not have data ID " +
-                        std::to_string(data_id));
+  const auto [reader, local_id] = find_sample(data_id);
+  return reader->fetch_response(Y, local_id, mb_idx);
 }
 
 } // namespace lbann
@@ -30,8 +30,55 @@
 #include "lbann/utils/glob.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace lbann {
 
+namespace {
+
+/** @brief Open a file for reading and ask the OS to start reading it */
+int open_with_readahead(const std::string& filename)
+{
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+#ifdef POSIX_FADV_WILLNEED
+  if (fd >= 0) {
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  }
+#endif // POSIX_FADV_WILLNEED
+  return fd;
+}
+
+/** @brief File descriptors that are closed when going out of scope */
+class open_files
+{
+public:
+  open_files() = default;
+  open_files(const open_files&) = delete;
+  open_files& operator=(const open_files&) = delete;
+  ~open_files()
+  {
+    for (const int fd : m_fds) {
+      ::close(fd);
+    }
+  }
+  int open(const std::string& filename)
+  {
+    const int fd = open_with_readahead(filename);
+    if (fd < 0) {
+      throw lbann_exception("mesh_reader: failed to open " + filename);
+    }
+    m_fds.push_back(fd);
+    return fd;
+  }
+
+private:
+  std::vector<int> m_fds;
+};
+
+} // namespace
+
 mesh_reader::mesh_reader(bool shuffle) : generic_data_reader(shuffle)
 {
   m_supported_input_types[INPUT_DATA_TYPE_RESPONSES] = true;
@@ -84,16 +131,64 @@ bool mesh_reader::fetch_datum(CPUMat& X, uint64_t data_id, uint64_t mb_idx)
     m_flip_choices[data_id].first = dist(gen);
     m_flip_choices[data_id].second = dist(gen);
   }
+  // Open all channels before reading any, so that their reads overlap
+  std::vector<std::string> filenames;
+  std::vector<int> fds;
+  open_files files;
+  for (const auto& channel : m_channels) {
+    filenames.push_back(construct_filename(channel, data_id));
+    fds.push_back(files.open(filenames.back()));
+  }
   for (size_t i = 0; i < m_channels.size(); ++i) {
     Mat X_view = El::View(X,
                           El::IR(i * m_data_height * m_data_width,
                                  (i + 1) * m_data_height * m_data_width),
                           El::IR(mb_idx));
-    load_file(data_id, m_channels[i], X_view);
+    read_file(fds[i], filenames[i], data_id, X_view);
   }
   return true;
 }
 
+void mesh_reader::prepare_sample_indices(uint64_t first,
+                                         uint64_t stride,
+                                         uint64_t count)
+{
+  generic_data_reader::prepare_sample_indices(first, stride, count);
+  if (m_io_thread_pool == nullptr) {
+    return;
+  }
+  std::vector<std::string> filenames;
+  const uint64_t num_data = get_num_data();
+  for (uint64_t i = 0; i < count; ++i) {
+    const uint64_t pos = first + (count + i) * stride;
+    if (pos >= num_data) {
+      break;
+    }
+    const uint64_t data_id = get_sample_index(pos);
+    for (const auto& channel : m_channels) {
+      filenames.push_back(construct_filename(channel, data_id));
+    }
+    filenames.push_back(construct_filename(m_target_name, data_id));
+  }
+  if (filenames.empty()) {
+    return;
+  }
+  // Hints are cheap, so wait for the last batch rather than pile up
+  if (m_prefetch.valid()) {
+    m_prefetch.wait();
+  }
+  m_prefetch = m_io_thread_pool
+                 ->submit_job([filenames = std::move(filenames)]() {
+                   for (const auto& filename : filenames) {
+                     const int fd = open_with_readahead(filename);
+                     if (fd >= 0) {
+                       ::close(fd);
+                     }
+                   }
+                 })
+                 .share();
+}
+
 bool mesh_reader::fetch_response(CPUMat& Y, uint64_t data_id, uint64_t mb_idx)
 {
   Mat Y_view = El::View(Y, El::ALL, El::IR(mb_idx));
@@ -106,14 +201,29 @@ void mesh_reader::load_file(uint64_t data_id,
                             Mat& mat)
 {
   const std::string filename = construct_filename(channel, data_id);
-  std::ifstream f(filename, std::ios::binary);
-  if (f.fail()) {
-    throw lbann_exception("mesh_reader: failed to open " + filename);
-  }
+  open_files files;
+  read_file(files.open(filename), filename, data_id, mat);
+}
+
+void mesh_reader::read_file(int fd,
+                            const std::string& filename,
+                            uint64_t data_id,
+                            Mat& mat)
+{
   // Load into a local buffer.
   DataType* buf = m_load_bufs[m_io_thread_pool->get_local_thread_id()].data();
-  if (!f.read((char*)buf, m_data_height * m_data_width * sizeof(float))) {
-    throw lbann_exception("mesh_reader: failed to read " + filename);
+  const size_t size = m_data_height * m_data_width * sizeof(float);
+  size_t done = 0;
+  while (done < size) {
+    const ssize_t n =
+      ::pread(fd, reinterpret_cast<char*>(buf) + done, size - done, done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      throw lbann_exception("mesh_reader: failed to read " + filename);
+    }
+    done += n;
   }
   if (std::is_same<float, DataType>::value) {
     // Need to transpose from row-major to column-major order.
@@ -82,8 +82,10 @@ node2vec_reader::node2vec_reader(std::string graph_file,
                                  size_t walk_length,
                                  double return_param,
                                  double inout_param,
-                                 size_t num_negative_samples)
+                                 size_t num_negative_samples,
+                                 size_t prefetch_batches)
   : generic_data_reader(true),
+    m_prefetch_batches{prefetch_batches},
     m_graph_file(std::move(graph_file)),
     m_epoch_size{epoch_size},
     m_walk_length{walk_length},
@@ -94,10 +96,18 @@ node2vec_reader::node2vec_reader(std::string graph_file,
 
 node2vec_reader::~node2vec_reader()
 {
+  stop_prefetching();
+
   // Deallocate objects in right order
   m_random_walker.reset();
   m_edge_weight_data.reset();
   m_distributed_database.reset();
+
+  int finalized = 0;
+  MPI_Finalized(&finalized);
+  if (m_walker_comm != MPI_COMM_NULL && !finalized) {
+    MPI_Comm_free(&m_walker_comm);
+  }
 }
 
 node2vec_reader* node2vec_reader::copy() const
@@ -140,28 +150,49 @@ bool node2vec_reader::fetch_data_block(CPUMat& X,
   const size_t mb_size_ = mb_size;
 
   // Perform random walks and add to cache
-  auto walks = run_walker(mb_size, io_rng);
-  const auto max_cache_size = std::max(mb_size_, m_walks_cache.size());
-  for (auto& walk : walks) {
-    if (m_walks_cache.size() >= max_cache_size) {
-      m_walks_cache.pop_front();
+  if (m_prefetch_batches == 0) {
+    std::vector<size_t> walks;
+    run_walker(mb_size_, get_io_generator(), walks);
+    cache_walks(walks.data(), walks.size() / m_walk_length, mb_size_);
+  }
+  else {
+    std::unique_lock<std::mutex> lock(m_walks_mutex);
+    if (!m_prefetch_thread.joinable()) {
+      m_prefetch_rng.seed(get_io_generator()());
+      m_prefetch_thread = std::thread(&node2vec_reader::prefetch_walks,
+                                      this,
+                                      m_prefetch_batches * mb_size_);
     }
-    m_walks_cache.emplace_back(std::move(walk));
+    m_walks_cv.wait(lock,
+                    [this] { return m_produced_batches > m_consumed_batches; });
+    const size_t num_ready =
+      (m_ready_walks.size() - m_ready_walks_begin) / m_walk_length;
+    const size_t num_walks = std::min(num_ready, mb_size_);
+    cache_walks(m_ready_walks.data() + m_ready_walks_begin,
+                num_walks,
+                mb_size_);
+    m_ready_walks_begin += num_walks * m_walk_length;
+    ++m_consumed_batches;
+    lock.unlock();
+    m_walks_cv.notify_all();
   }
 
   // Recompute noise distribution if there are enough vertex visits
-  if (m_total_visit_count > 2 * m_noise_visit_count) {
-    update_noise_distribution();
+  {
+    std::lock_guard<std::mutex> lock(m_walks_mutex);
+    if (m_total_visit_count > 2 * m_noise_visit_count) {
+      update_noise_distribution();
+    }
   }
 
   // Populate output tensor with negative samples and walk
   /// @todo Parallelize
   for (size_t j = 0; j < mb_size_; ++j) {
-    const auto& walk = m_walks_cache[j % m_walks_cache.size()];
+    const size_t* walk = get_cached_walk(j % m_walks_cache_size);
 
     // Negative samples
     // Note: Make sure negative samples are not repeated or in the walk
-    std::unordered_set<size_t> walk_set(walk.begin(), walk.end());
+    std::unordered_set<size_t> walk_set(walk, walk + m_walk_length);
     for (size_t i = 0; i < m_num_negative_samples; ++i) {
       size_t global_index;
       do {
@@ -218,9 +249,25 @@ void node2vec_reader::load()
   }
   comm.trainer_barrier();
 
+  // Background walks need concurrent MPI calls from several threads
+  if (m_prefetch_batches > 0) {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if (provided < MPI_THREAD_MULTIPLE) {
+      if (comm.am_trainer_master()) {
+        LBANN_WARNING("node2vec walk prefetching requires "
+                      "MPI_THREAD_MULTIPLE; generating walks synchronously");
+      }
+      m_prefetch_batches = 0;
+    }
+  }
+
   // Construct random walker
   constexpr bool small_edge_weight_variance = false;
   constexpr bool verbose = false;
+  if (m_walker_comm == MPI_COMM_NULL) {
+    MPI_Comm_dup(comm.get_trainer_comm().GetMPIComm(), &m_walker_comm);
+  }
   m_random_walker =
     std::make_unique<RandomWalker>(graph,
                                    *edge_weight_data,
@@ -228,7 +275,7 @@ void node2vec_reader::load()
                                    m_walk_length,
                                    m_return_param,
                                    m_inout_param,
-                                   comm.get_trainer_comm().GetMPIComm(),
+                                   m_walker_comm,
                                    verbose);
   comm.trainer_barrier();
 
@@ -262,12 +309,16 @@ void node2vec_reader::load()
   // Make sure walks cache has at least one walk
   const auto io_rng = set_io_generators_local_index(0);
   m_walks_cache.clear();
+  m_walks_cache_capacity = 0;
+  m_walks_cache_begin = 0;
+  m_walks_cache_size = 0;
+  std::vector<size_t> walks;
   do {
-    auto walks = run_walker(1, io_rng);
-    for (auto& walk : walks) {
-      m_walks_cache.emplace_back(std::move(walk));
-    }
-  } while (comm.trainer_allreduce(m_walks_cache.empty() ? 1 : 0));
+    walks.clear();
+    run_walker(1, get_io_generator(), walks);
+    const size_t num_walks = walks.size() / m_walk_length;
+    cache_walks(walks.data(), num_walks, m_walks_cache_size + num_walks);
+  } while (comm.trainer_allreduce(m_walks_cache_size == 0 ? 1 : 0));
 
   // Construct list of indices
   m_shuffled_indices.resize(m_epoch_size);
@@ -276,8 +327,9 @@ void node2vec_reader::load()
   select_subset_of_data();
 }
 
-std::vector<std::vector<size_t>>
-node2vec_reader::run_walker(size_t num_walks, const locked_io_rng_ref&)
+void node2vec_reader::run_walker(size_t num_walks,
+                                 rng_gen& gen,
+                                 std::vector<size_t>& walks)
 {
 
   // HavoqGT graph
@@ -290,39 +342,127 @@ node2vec_reader::run_walker(size_t num_walks, const locked_io_rng_ref&)
   std::vector<Vertex> start_vertices;
   start_vertices.reserve(num_walks);
   for (size_t i = 0; i < num_walks; ++i) {
-    const auto& local_index =
-      fast_rand_int(get_io_generator(), num_local_vertices);
+    const auto& local_index = fast_rand_int(gen, num_local_vertices);
     const auto& global_index = m_local_vertex_global_indices.at(local_index);
     start_vertices.push_back(graph.label_to_locator(global_index));
   }
 
-  // Perform random walks
+  // Perform random walks; all start vertices go through one walker
+  // call so that remote edge lookups are aggregated
   const auto walks_vertices = m_random_walker->run_walker(start_vertices);
 
   // Convert walks to vertex indices
-  std::vector<std::vector<size_t>> walks_indices;
-  walks_indices.reserve(walks_vertices.size());
+  const size_t first = walks.size();
+  walks.reserve(first + walks_vertices.size() * m_walk_length);
   for (const auto& walk_vertices : walks_vertices) {
-    walks_indices.emplace_back();
-    auto& walk_indices = walks_indices.back();
-    walk_indices.reserve(walk_vertices.size());
-    for (const auto& vertex : walk_vertices) {
-      walk_indices.emplace_back(graph.locator_to_label(vertex));
+    if (walk_vertices.size() < m_walk_length) {
+      continue;
+    }
+    for (size_t i = 0; i < m_walk_length; ++i) {
+      walks.push_back(graph.locator_to_label(walk_vertices[i]));
     }
   }
 
   // Record visits to local vertices
-  for (const auto& walk : walks_indices) {
-    for (const auto& global_index : walk) {
-      if (m_local_vertex_local_indices.count(global_index) != 0) {
-        const auto& local_index = m_local_vertex_local_indices.at(global_index);
-        ++m_local_vertex_visit_counts[local_index];
-        ++m_total_visit_count;
+  std::lock_guard<std::mutex> lock(m_walks_mutex);
+  for (size_t i = first; i < walks.size(); ++i) {
+    const auto iter = m_local_vertex_local_indices.find(walks[i]);
+    if (iter != m_local_vertex_local_indices.end()) {
+      ++m_local_vertex_visit_counts[iter->second];
+      ++m_total_visit_count;
+    }
+  }
+}
+
+void node2vec_reader::cache_walks(const size_t* walks,
+                                  size_t num_walks,
+                                  size_t min_capacity)
+{
+  // Grow the ring buffer, keeping the cached walks in order
+  if (min_capacity > m_walks_cache_capacity) {
+    std::vector<size_t> cache(min_capacity * m_walk_length);
+    for (size_t i = 0; i < m_walks_cache_size; ++i) {
+      const size_t* walk = get_cached_walk(i);
+      std::copy(walk, walk + m_walk_length, &cache[i * m_walk_length]);
+    }
+    m_walks_cache = std::move(cache);
+    m_walks_cache_capacity = min_capacity;
+    m_walks_cache_begin = 0;
+  }
+
+  for (size_t k = 0; k < num_walks; ++k) {
+    const size_t slot =
+      (m_walks_cache_begin + m_walks_cache_size) % m_walks_cache_capacity;
+    std::copy(walks + k * m_walk_length,
+              walks + (k + 1) * m_walk_length,
+              &m_walks_cache[slot * m_walk_length]);
+    if (m_walks_cache_size < m_walks_cache_capacity) {
+      ++m_walks_cache_size;
+    }
+    else {
+      m_walks_cache_begin = (m_walks_cache_begin + 1) % m_walks_cache_capacity;
+    }
+  }
+}
+
+const size_t* node2vec_reader::get_cached_walk(size_t i) const
+{
+  const size_t slot = (m_walks_cache_begin + i) % m_walks_cache_capacity;
+  return &m_walks_cache[slot * m_walk_length];
+}
+
+bool node2vec_reader::need_prefetch_round() const
+{
+  return m_consumed_batches + m_prefetch_batches > m_produced_batches;
+}
+
+void node2vec_reader::prefetch_walks(size_t walks_per_round)
+{
+  std::vector<size_t> walks;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_walks_mutex);
+      m_walks_cv.wait(lock, [this] {
+        return m_stop_prefetch || need_prefetch_round();
+      });
+      // A round that is due still runs when stopping: every rank makes
+      // the same decision and the walker is collective.
+      if (!need_prefetch_round()) {
+        return;
+      }
+    }
+
+    walks.clear();
+    run_walker(walks_per_round, m_prefetch_rng, walks);
+
+    {
+      std::lock_guard<std::mutex> lock(m_walks_mutex);
+      // Drop consumed walks, and the oldest ones if the walker keeps
+      // returning more walks than are consumed
+      m_ready_walks.erase(m_ready_walks.begin(),
+                          m_ready_walks.begin() + m_ready_walks_begin);
+      m_ready_walks_begin = 0;
+      m_ready_walks.insert(m_ready_walks.end(), walks.begin(), walks.end());
+      const size_t max_ready = 2 * walks_per_round * m_walk_length;
+      if (m_ready_walks.size() > max_ready) {
+        m_ready_walks_begin = m_ready_walks.size() - max_ready;
       }
+      m_produced_batches += m_prefetch_batches;
     }
+    m_walks_cv.notify_all();
   }
+}
 
-  return walks_indices;
+void node2vec_reader::stop_prefetching()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_walks_mutex);
+    m_stop_prefetch = true;
+  }
+  m_walks_cv.notify_all();
+  if (m_prefetch_thread.joinable()) {
+    m_prefetch_thread.join();
+  }
 }
 
 /// @todo Parallelize
@@ -27,6 +27,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/data_ingestion/readers/data_reader_numpy.hpp"
+#include "lbann/utils/cnpy_utils.hpp"
+#include "lbann/utils/options.hpp"
 #include <cnpy.h>
 #include <cstdio>
 #include <string>
@@ -43,7 +45,8 @@ numpy_reader::numpy_reader(const numpy_reader& other)
     m_num_samples(other.m_num_samples),
     m_num_features(other.m_num_features),
     m_num_labels(other.m_num_labels),
-    m_data(other.m_data)
+    m_data(other.m_data),
+    m_shared_data(other.m_shared_data)
 {}
 
 numpy_reader& numpy_reader::operator=(const numpy_reader& other)
@@ -53,6 +56,7 @@ numpy_reader& numpy_reader::operator=(const numpy_reader& other)
   m_num_features = other.m_num_features;
   m_num_labels = other.m_num_labels;
   m_data = other.m_data;
+  m_shared_data = other.m_shared_data;
   return *this;
 }
 
@@ -68,7 +72,25 @@ void numpy_reader::load()
   }
   ifs.close();
 
-  m_data = cnpy::npy_load(infile);
+  if (global_argument_parser().get<bool>(LBANN_OPTION_NODE_SHARED_NUMPY)) {
+    std::map<std::string, cnpy::NpyArray> arrays;
+    std::map<std::string, std::shared_ptr<const char>> data;
+    cnpy_utils::load_node_shared(
+      *get_comm(),
+      infile,
+      [&infile]() {
+        return std::map<std::string, cnpy::NpyArray>{
+          {"data", cnpy::npy_load(infile)}};
+      },
+      arrays,
+      data);
+    m_data = arrays.at("data");
+    m_shared_data = data.at("data");
+  }
+  else {
+    m_data = cnpy::npy_load(infile);
+    m_shared_data.reset();
+  }
   m_num_samples = m_data.shape[0];
   m_num_features = std::accumulate(m_data.shape.begin() + 1,
                                    m_data.shape.end(),
@@ -98,11 +120,11 @@ void numpy_reader::load()
     std::unordered_set<int> label_classes;
     for (int i = 0; i < m_num_samples; ++i) {
       if (m_data.word_size == 4) {
-        float* data = m_data.data<float>() + i * (m_num_features + 1);
+        const float* data = get_data<float>() + i * (m_num_features + 1);
         label_classes.insert((int)data[m_num_features + 1]);
       }
       else if (m_data.word_size == 8) {
-        double* data = m_data.data<double>() + i * (m_num_features + 1);
+        const double* data = get_data<double>() + i * (m_num_features + 1);
         label_classes.insert((int)data[m_num_features + 1]);
       }
     }
@@ -138,13 +160,13 @@ bool numpy_reader::fetch_datum(Mat& X, uint64_t data_id, uint64_t mb_idx)
     features_size += 1;
   }
   if (m_data.word_size == 4) {
-    float* data = m_data.data<float>() + data_id * features_size;
+    const float* data = get_data<float>() + data_id * features_size;
     for (int j = 0; j < m_num_features; ++j) {
       X(j, mb_idx) = data[j];
     }
   }
   else if (m_data.word_size == 8) {
-    double* data = m_data.data<double>() + data_id * features_size;
+    const double* data = get_data<double>() + data_id * features_size;
     for (int j = 0; j < m_num_features; ++j) {
       X(j, mb_idx) = data[j];
     }
@@ -159,11 +181,11 @@ bool numpy_reader::fetch_label(Mat& Y, uint64_t data_id, uint64_t mb_idx)
   }
   int label = 0;
   if (m_data.word_size == 4) {
-    float* data = m_data.data<float>() + data_id * (m_num_features + 1);
+    const float* data = get_data<float>() + data_id * (m_num_features + 1);
     label = (int)data[m_num_features + 1];
   }
   else if (m_data.word_size == 8) {
-    double* data = m_data.data<double>() + data_id * (m_num_features + 1);
+    const double* data = get_data<double>() + data_id * (m_num_features + 1);
     label = (int)data[m_num_features + 1];
   }
   Y(label, mb_idx) = 1;
@@ -177,11 +199,11 @@ bool numpy_reader::fetch_response(Mat& Y, uint64_t data_id, uint64_t mb_idx)
   }
   auto response = DataType(0);
   if (m_data.word_size == 4) {
-    float* data = m_data.data<float>() + data_id * (m_num_features + 1);
+    const float* data = get_data<float>() + data_id * (m_num_features + 1);
     response = (DataType)data[m_num_features + 1];
   }
   else if (m_data.word_size == 8) {
-    double* data = m_data.data<double>() + data_id * (m_num_features + 1);
+    const double* data = get_data<double>() + data_id * (m_num_features + 1);
     response = (DataType)data[m_num_features + 1];
   }
   Y(0, mb_idx) = response;
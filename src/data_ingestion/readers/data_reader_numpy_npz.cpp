@@ -28,6 +28,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/data_ingestion/readers/data_reader_numpy_npz.hpp"
+#include "lbann/utils/cnpy_utils.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/profiling.hpp"
 #include <cnpy.h>
 #include <cstdio>
@@ -55,6 +57,9 @@ numpy_npz_reader::numpy_npz_reader(const numpy_npz_reader& other)
     m_data(other.m_data),
     m_labels(other.m_labels),
     m_responses(other.m_responses),
+    m_shared_data(other.m_shared_data),
+    m_shared_labels(other.m_shared_labels),
+    m_shared_responses(other.m_shared_responses),
     m_scaling_factor_int16(other.m_scaling_factor_int16)
 {}
 
@@ -68,6 +73,9 @@ numpy_npz_reader& numpy_npz_reader::operator=(const numpy_npz_reader& other)
   m_data = other.m_data;
   m_labels = other.m_labels;
   m_responses = other.m_responses;
+  m_shared_data = other.m_shared_data;
+  m_shared_labels = other.m_shared_labels;
+  m_shared_responses = other.m_shared_responses;
   m_scaling_factor_int16 = other.m_scaling_factor_int16;
   return *this;
 }
@@ -85,7 +93,48 @@ void numpy_npz_reader::load()
   }
   ifs.close();
 
-  const cnpy::npz_t npz = cnpy::npz_load(infile);
+  cnpy::npz_t npz;
+  std::map<std::string, std::shared_ptr<const char>> shared_data;
+  const bool node_shared =
+    global_argument_parser().get<bool>(LBANN_OPTION_NODE_SHARED_NUMPY);
+  if (node_shared) {
+    // Only the arrays this reader uses are placed in shared memory;
+    // missing keys are reported below on every rank.
+    std::vector<std::string> keys = {NPZ_KEY_DATA};
+    if (m_supported_input_types[INPUT_DATA_TYPE_LABELS]) {
+      keys.push_back(NPZ_KEY_LABELS);
+    }
+    if (m_supported_input_types[INPUT_DATA_TYPE_RESPONSES]) {
+      keys.push_back(NPZ_KEY_RESPONSES);
+    }
+    cnpy_utils::load_node_shared(
+      *get_comm(),
+      infile,
+      [&infile, &keys]() {
+        const cnpy::npz_t all = cnpy::npz_load(infile);
+        cnpy::npz_t wanted;
+        for (const auto& key : keys) {
+          const auto it = all.find(key);
+          if (it != all.end()) {
+            wanted.emplace(key, it->second);
+          }
+        }
+        return wanted;
+      },
+      npz,
+      shared_data);
+  }
+  else {
+    npz = cnpy::npz_load(infile);
+  }
+  const auto get_shared_data =
+    [&shared_data](const std::string& key) -> std::shared_ptr<const char> {
+    const auto it = shared_data.find(key);
+    return it == shared_data.end() ? nullptr : it->second;
+  };
+  m_shared_data = get_shared_data(NPZ_KEY_DATA);
+  m_shared_labels = get_shared_data(NPZ_KEY_LABELS);
+  m_shared_responses = get_shared_data(NPZ_KEY_RESPONSES);
 
   std::vector<std::tuple<const bool, const std::string, cnpy::NpyArray&>>
     npyLoadList;
@@ -155,7 +204,7 @@ void numpy_npz_reader::load()
       throw lbann_exception(
         "numpy_npz_reader: label numpy array should be in int32");
     }
-    int* data = m_labels.data<int>();
+    const int* data = get_data<int>(m_labels, m_shared_labels);
     for (int i = 0; i < m_num_samples; ++i) {
       label_classes.insert((int)data[i]);
     }
@@ -186,7 +235,8 @@ bool numpy_npz_reader::fetch_datum(Mat& X, uint64_t data_id, uint64_t mb_idx)
 
   if (m_data.word_size == 2) {
     // Convert int16 to DataType.
-    const short* data = m_data.data<short>() + data_id * m_num_features;
+    const short* data =
+      get_data<short>(m_data, m_shared_data) + data_id * m_num_features;
     DataType* dest = X_v.Buffer();
 
     // OPTIMIZE
@@ -195,12 +245,12 @@ bool numpy_npz_reader::fetch_datum(Mat& X, uint64_t data_id, uint64_t mb_idx)
       dest[j] = data[j] * m_scaling_factor_int16;
   }
   else {
-    void* data = NULL;
+    const void* data = NULL;
     if (m_data.word_size == 4) {
-      data = (void*)(m_data.data<float>() + data_id * m_num_features);
+      data = get_data<float>(m_data, m_shared_data) + data_id * m_num_features;
     }
     else if (m_data.word_size == 8) {
-      data = (void*)(m_data.data<double>() + data_id * m_num_features);
+      data = get_data<double>(m_data, m_shared_data) + data_id * m_num_features;
     }
     std::memcpy(X_v.Buffer(), data, m_num_features * m_data.word_size);
   }
@@ -212,7 +262,7 @@ bool numpy_npz_reader::fetch_label(Mat& Y, uint64_t data_id, uint64_t mb_idx)
   if (!m_supported_input_types[INPUT_DATA_TYPE_LABELS]) {
     throw lbann_exception("numpy_npz_reader: do not have labels");
   }
-  const int label = m_labels.data<int>()[data_id];
+  const int label = get_data<int>(m_labels, m_shared_labels)[data_id];
   Y(label, mb_idx) = 1;
   return true;
 }
@@ -226,8 +276,8 @@ bool numpy_npz_reader::fetch_response(Mat& Y, uint64_t data_id, uint64_t mb_idx)
   Mat Y_v = El::View(Y, El::IR(0, Y.Height()), El::IR(mb_idx, mb_idx + 1));
   if (m_responses.word_size == 2) {
     // Convert int16 to DataType.
-    const short* data =
-      m_responses.data<short>() + data_id * m_num_response_features;
+    const short* data = get_data<short>(m_responses, m_shared_responses) +
+                        data_id * m_num_response_features;
     DataType* dest = Y_v.Buffer();
     // OPTIMIZE
     LBANN_OMP_PARALLEL_FOR
@@ -236,14 +286,14 @@ bool numpy_npz_reader::fetch_response(Mat& Y, uint64_t data_id, uint64_t mb_idx)
     return true;
   }
 
-  void* responses = NULL;
+  const void* responses = NULL;
   if (m_responses.word_size == 4) {
-    responses =
-      (void*)(m_responses.data<float>() + data_id * m_num_response_features);
+    responses = get_data<float>(m_responses, m_shared_responses) +
+                data_id * m_num_response_features;
   }
   else if (m_responses.word_size == 8) {
-    responses =
-      (void*)(m_responses.data<double>() + data_id * m_num_response_features);
+    responses = get_data<double>(m_responses, m_shared_responses) +
+                data_id * m_num_response_features;
   }
   std::memcpy(Y_v.Buffer(),
               responses,
@@ -40,6 +40,7 @@
 
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/python.hpp"
+#include "lbann/utils/threads/thread_budget.hpp"
 
 namespace lbann {
 
@@ -92,9 +93,9 @@ bool python_dataset_reader::fetch_data_block(
   // Acquire Python GIL on first IO thread
   python::global_interpreter_lock gil;
 
-  // If not enough samples were queued when the epoch began, queue the rest
-  if (m_queued_samples < mb_size) {
-    queue_samples(mb_size - m_queued_samples);
+  // Make sure the mini-batch being fetched has been submitted
+  if (m_queued_batches == 0 && !queue_batch()) {
+    LBANN_ERROR("no mini-batch left to fetch from the Python dataset");
   }
 
   // Check that shared memory array is large enough
@@ -111,10 +112,12 @@ bool python_dataset_reader::fetch_data_block(
     indices_fetched.Set(i, 0, sample_index);
   }
 
-  // Get the next batch from the Python data reader
+  // Wait for the oldest in-flight batch. Its shared-memory slot stays
+  // valid until the next call to get_batch.
   python::object batch =
     PyObject_CallMethod(m_data_reader, "get_batch", "(l)", mb_size);
   python::check_error();
+  --m_queued_batches;
 
   // Get samples
   // Note: we don't use python::objects here because PyDict_GetItemString
@@ -160,8 +163,8 @@ bool python_dataset_reader::fetch_data_block(
     El::Copy(response_shared_memory_matrix, Y);
   }
 
-  // Prefetch the next minibatch asynchronously
-  this->queue_samples(mb_size);
+  // Refill the ring with the next mini-batch
+  this->queue_batch();
 
   return true;
 }
@@ -297,37 +300,78 @@ void python_dataset_reader::setup(int num_io_threads,
               "(only float and double are supported)");
 #endif
 
-  // Create Python data reader and worker processes
+  // Size the shared-memory batch ring for the largest local mini-batch
+  execution_mode mode = exec_mode_from_string(get_role());
+  dataset& ds = get_trainer().get_data_coordinator().get_dataset(mode);
+  const uint64_t sample_stride = ds.get_sample_stride();
+  const uint64_t mini_batch_stride = ds.get_stride_to_next_mini_batch();
+  const uint64_t base_offset = ds.get_base_offset();
+  uint64_t max_batch_size = 1;
+  if (mini_batch_stride > base_offset) {
+    max_batch_size =
+      (mini_batch_stride - base_offset + sample_stride - 1) / sample_stride;
+  }
+  // Size the worker pool from the thread budget if there is one, and
+  // bind the workers to its Python CPUs
+  long num_workers = num_io_threads;
+  Py_INCREF(Py_None);
+  python::object worker_cpus = Py_None;
+  if (thread_budget const* budget = get_thread_budget()) {
+    num_workers = budget->num_python_workers;
+    worker_cpus = PyList_New(budget->python_cpus.size());
+    for (size_t i = 0; i < budget->python_cpus.size(); ++i) {
+      PyList_SET_ITEM(worker_cpus.get(),
+                      i,
+                      PyLong_FromLong(budget->python_cpus[i]));
+    }
+    python::check_error();
+  }
+
+  if (m_batches_in_flight == 0) {
+    // Keep about as many samples in flight as the prefetch factor asks for
+    const uint64_t prefetch_samples = m_prefetch_factor * num_workers;
+    m_batches_in_flight =
+      std::max<uint64_t>(2,
+                         (prefetch_samples + max_batch_size - 1) /
+                           max_batch_size);
+  }
+
+  // Create Python data reader and worker processes. One extra slot holds
+  // the batch most recently returned by get_batch.
   python::object lbann_data = PyImport_ImportModule("lbann.util.data");
-  m_data_reader = PyObject_CallMethod(lbann_data,
-                                      "DataReader",
-                                      "(O, l, l, s)",
-                                      m_dataset.get(),
-                                      num_io_threads,
-                                      m_prefetch_factor,
-                                      datatype_typecode.c_str());
+  m_data_reader =
+    PyObject_CallMethod(lbann_data,
+                        "DataReader",
+                        "(O, l, l, s, l, l, O)",
+                        m_dataset.get(),
+                        num_workers,
+                        m_prefetch_factor,
+                        datatype_typecode.c_str(),
+                        static_cast<long>(max_batch_size),
+                        static_cast<long>(m_batches_in_flight + 1),
+                        worker_cpus.get());
   python::check_error();
 
   queue_epoch();
 }
 
-void python_dataset_reader::queue_samples(uint64_t samples_to_queue)
+bool python_dataset_reader::queue_batch()
 {
   // NOTE: ASSUMES GIL IS ALREADY TAKEN
   execution_mode mode = exec_mode_from_string(get_role());
   dataset& ds = get_trainer().get_data_coordinator().get_dataset(mode);
 
-  // Get shuffled indices to be fetched by worker processes
+  // Get shuffled indices of the next local mini-batch
   python::object inds_list = PyList_New(0);
   uint64_t num_samples = m_num_samples;
   uint64_t sample_stride = ds.get_sample_stride();
   uint64_t mini_batch_stride = ds.get_stride_to_next_mini_batch();
   uint64_t base_offset = ds.get_base_offset();
+  uint64_t batch_begin = m_dataset_minibatch_offset * mini_batch_stride;
 
-  for (uint64_t i = 0; i < samples_to_queue; ++i) {
-    uint64_t sample_ind = base_offset +
-                          m_dataset_minibatch_offset * mini_batch_stride +
-                          m_dataset_sample_offset * sample_stride;
+  for (uint64_t offset = base_offset; offset < mini_batch_stride;
+       offset += sample_stride) {
+    uint64_t sample_ind = batch_begin + offset;
 
     // We went over the entire epoch
     if (sample_ind >= num_samples)
@@ -336,23 +380,19 @@ void python_dataset_reader::queue_samples(uint64_t samples_to_queue)
     PyList_Append(
       inds_list,
       python::object(PyLong_FromLong(m_shuffled_indices[sample_ind])));
-
-    ++m_dataset_sample_offset;
-    ++m_queued_samples;
-
-    // Cycle minibatch offset
-    if (m_dataset_sample_offset * sample_stride + base_offset >=
-        mini_batch_stride) {
-      m_dataset_sample_offset = 0;
-      ++m_dataset_minibatch_offset;
-    }
   }
+  if (PyList_Size(inds_list) == 0) {
+    return false;
+  }
+  ++m_dataset_minibatch_offset;
 
   python::object(PyObject_CallMethod(m_data_reader,
-                                     "queue_samples",
+                                     "queue_batch",
                                      "(O)",
                                      inds_list.get()));
   python::check_error();
+  ++m_queued_batches;
+  return true;
 }
 
 void python_dataset_reader::queue_epoch()
@@ -362,15 +402,21 @@ void python_dataset_reader::queue_epoch()
 
   // Resets the sample offset to the beginning of the epoch
   m_dataset_minibatch_offset = 0;
-  m_dataset_sample_offset = 0;
-  m_queued_samples = 0;
+  m_queued_batches = 0;
 #ifdef LBANN_HAS_DISTCONV
   m_fetched_minibatch_count = 0;
 #endif // LBANN_HAS_DISTCONV
 
-  // Prefetch the first set of samples (if less than minibatch size, the first
-  // minibatch read will take care of the rest)
-  queue_samples(m_prefetch_factor * m_num_io_threads);
+  // Drop batches left over from an epoch that ended early
+  python::object(PyObject_CallMethod(m_data_reader, "reset", nullptr));
+  python::check_error();
+
+  // Put the first mini-batches in flight
+  for (uint64_t i = 0; i < m_batches_in_flight; ++i) {
+    if (!queue_batch()) {
+      break;
+    }
+  }
 }
 
 void python_dataset_reader::load()
@@ -408,6 +454,13 @@ void python_dataset_reader::load()
     PyObject_SetAttrString(m_dataset,
                            "num_io_partitions",
                            PyLong_FromLong(dc::get_number_of_io_partitions()));
+    const auto& io_shape = dc::get_io_partition_shape();
+    PyObject_SetAttrString(m_dataset,
+                           "io_partition_shape",
+                           Py_BuildValue("(iii)",
+                                         io_shape[0],
+                                         io_shape[1],
+                                         io_shape[2]));
   }
   python::check_error();
 #endif // LBANN_HAS_DISTCONV
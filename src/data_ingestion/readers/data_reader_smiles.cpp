@@ -39,11 +39,112 @@
 #include "lbann/utils/vectorwrapbuf.hpp"
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <mutex>
 #include <random>
 
 namespace lbann {
 
+namespace {
+
+/// Leading bytes of a SMILES token cache file
+constexpr char token_cache_magic[8] = {'L', 'B', 'S', 'M', 'T', 'O', 'K', '1'};
+
+/// Fixed-size header of a token cache; the token records follow it
+struct token_cache_header
+{
+  char magic[8];
+  uint64_t num_samples;
+  uint64_t record_len;
+  uint64_t key;
+};
+
+/// 64-bit FNV-1a; used to fingerprint vocabularies and data file paths
+uint64_t fnv1a(const void* data,
+               size_t n,
+               uint64_t h = 14695981039346656037ull)
+{
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < n; ++i) {
+    h = (h ^ p[i]) * 1099511628211ull;
+  }
+  return h;
+}
+
+/// Whether a token cache exists and matches the expected layout
+bool token_cache_is_current(const std::string& filename,
+                            uint64_t num_samples,
+                            uint64_t record_len,
+                            uint64_t key)
+{
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  if (!in) {
+    return false;
+  }
+  const uint64_t bytes = in.tellg();
+  token_cache_header header;
+  in.seekg(0, std::ios::beg);
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+  return std::memcmp(header.magic, token_cache_magic, sizeof(header.magic)) ==
+           0 &&
+         header.num_samples == num_samples &&
+         header.record_len == record_len && header.key == key &&
+         bytes == sizeof(header) +
+                    num_samples * record_len * sizeof(unsigned short);
+}
+
+/// Name of the token cache for a data file; the full path is hashed so that
+/// data files with the same name in different directories do not collide
+std::string get_token_cache_filename(const std::string& cache_dir,
+                                     const std::string& data_filename)
+{
+  std::ostringstream s;
+  s << file::extract_base_name(data_filename) << "." << std::hex
+    << fnv1a(data_filename.data(), data_filename.size()) << ".tokens";
+  return file::join_path(cache_dir, s.str());
+}
+
+} // namespace
+
+struct smiles_data_reader::token_cache_file
+{
+  token_cache_file(const std::string& filename,
+                   uint64_t num_samples,
+                   uint64_t record_len,
+                   uint64_t key)
+    : map(filename), num_samples(num_samples), record_len(record_len)
+  {
+    if (!token_cache_is_current(filename, num_samples, record_len, key)) {
+      LBANN_ERROR("token cache ",
+                  filename,
+                  " does not match the data file, the vocabulary, or the "
+                  "sequence length");
+    }
+    tokens = reinterpret_cast<const unsigned short*>(
+      map.data() + sizeof(token_cache_header));
+  }
+
+  const unsigned short* get_tokens(size_t local_id) const
+  {
+    if (local_id >= num_samples) {
+      LBANN_ERROR("sample ",
+                  local_id,
+                  " is out of range for a token cache with ",
+                  num_samples,
+                  " samples");
+    }
+    return tokens + local_id * record_len;
+  }
+
+  file::mapped_file map;
+  size_t num_samples;
+  size_t record_len;
+  const unsigned short* tokens = nullptr;
+};
+
 smiles_data_reader::smiles_data_reader(const bool shuffle)
   : data_reader_sample_list(shuffle)
 {}
@@ -93,6 +194,7 @@ void smiles_data_reader::copy_members(const smiles_data_reader& rhs)
   m_local_to_index = rhs.m_local_to_index;
   m_filename_to_local_id_set = rhs.m_filename_to_local_id_set;
   m_index_to_filename = rhs.m_index_to_filename;
+  m_token_cache = rhs.m_token_cache;
 }
 
 void smiles_data_reader::load()
@@ -103,9 +205,13 @@ void smiles_data_reader::load()
 
   double tm1 = get_time();
   auto& arg_parser = global_argument_parser();
+  const std::string token_cache_dir =
+    arg_parser.get<std::string>(LBANN_OPTION_SMILES_TOKEN_CACHE);
 
-  // for now, only implemented for data store with preloading
-  set_use_data_store(true);
+  // without a token cache, only implemented for data store with preloading
+  if (token_cache_dir.empty()) {
+    set_use_data_store(true);
+  }
 
   if (m_sequence_length == 0) {
     if (arg_parser.get<int>(LBANN_OPTION_SEQUENCE_LENGTH) == -1) {
@@ -146,7 +252,12 @@ void smiles_data_reader::load()
 
   // load various metadata
   build_some_maps();
-  load_offsets_and_lengths();
+  if (token_cache_dir.empty()) {
+    load_offsets_and_lengths();
+  }
+  else {
+    load_token_caches(token_cache_dir);
+  }
   print_statistics();
 }
 
@@ -159,6 +270,28 @@ void smiles_data_reader::do_preload_data_store()
               << "; role: " << get_role() << std::endl;
   }
 
+  // The samples are already tokenized; copy this rank's records
+  if (!m_token_cache.empty()) {
+    for (const auto& index : m_shuffled_indices) {
+      if (m_data_store->get_index_owner(index) !=
+          get_comm()->get_rank_in_trainer()) {
+        continue;
+      }
+      auto const [file_id, local_id] = get_sample(index);
+      const unsigned short* tokens =
+        m_token_cache[file_id]->get_tokens(local_id);
+      conduit::Node& node = m_data_store->get_empty_node(index);
+      node[LBANN_DATA_ID_STR(index) + "/data"] =
+        std::vector<unsigned short>(tokens, tokens + m_linearized_data_size);
+      m_data_store->set_preloaded_conduit_node(index, node);
+    }
+    if (get_comm()->am_world_master()) {
+      std::cout << " do_preload_data_store time: " << get_time() - tm1
+                << std::endl;
+    }
+    return;
+  }
+
   // Randomize the ordering in which this rank will open data files.
   // Note that each rank will open each data file at most one time.
   std::vector<std::string> my_ordering;
@@ -311,8 +444,18 @@ std::set<int> smiles_data_reader::get_my_indices() const
 bool smiles_data_reader::fetch_datum(Mat& X, uint64_t data_id, uint64_t mb_idx)
 {
   if (!data_store_active()) {
-    LBANN_ERROR(
-      "it should be impossible you you to be here; please contact Dave Hysom");
+    if (m_token_cache.empty()) {
+      LBANN_ERROR("it should be impossible you you to be here; please contact "
+                  "Dave Hysom");
+    }
+    // Fixed-length records: no lookup, tokenization or padding needed
+    auto const [file_id, local_id] = get_sample(data_id);
+    const unsigned short* tokens =
+      m_token_cache[file_id]->get_tokens(local_id);
+    for (int j = 0; j < m_linearized_data_size; ++j) {
+      X(j, mb_idx) = tokens[j];
+    }
+    return true;
   }
 
   const conduit::Node& node = m_data_store->get_conduit_node(data_id);
@@ -329,6 +472,30 @@ bool smiles_data_reader::fetch_datum(Mat& X, uint64_t data_id, uint64_t mb_idx)
   return true;
 }
 
+uint64_t smiles_data_reader::get_sample_length(uint64_t data_id) const
+{
+  if (!m_token_cache.empty()) {
+    auto const [file_id, local_id] = m_sample_list[data_id];
+    const unsigned short* tokens =
+      m_token_cache[file_id]->get_tokens(local_id);
+    int n = m_linearized_data_size;
+    while (n > 0 && tokens[n - 1] == m_pad) {
+      --n;
+    }
+    return n;
+  }
+  // Without a token cache, every rank holds the string lengths
+  const auto iter = m_sample_offsets.find(data_id);
+  if (iter == m_sample_offsets.end()) {
+    LBANN_ERROR("failed to find data_id ",
+                data_id,
+                " in m_sample_offsets map; map size: ",
+                m_sample_offsets.size());
+  }
+  const uint64_t num_chars = iter->second.second;
+  return std::min(num_chars, uint64_t(m_linearized_data_size - 2)) + 2;
+}
+
 bool smiles_data_reader::fetch_label(Mat& Y, uint64_t data_id, uint64_t mb_idx)
 {
   LBANN_ERROR("smiles_data_reader::fetch_label is not implemented");
@@ -652,6 +819,150 @@ void smiles_data_reader::build_some_maps()
   }
 }
 
+uint64_t smiles_data_reader::get_token_cache_key() const
+{
+  std::vector<std::pair<char, short>> vocab(m_vocab.begin(), m_vocab.end());
+  std::sort(vocab.begin(), vocab.end());
+  uint64_t h = fnv1a(&m_linearized_data_size, sizeof(m_linearized_data_size));
+  for (const auto& [c, id] : vocab) {
+    h = fnv1a(&c, sizeof(c), h);
+    h = fnv1a(&id, sizeof(id), h);
+  }
+  for (const short id : {m_pad, m_unk, m_bos, m_eos}) {
+    h = fnv1a(&id, sizeof(id), h);
+  }
+  return h;
+}
+
+void smiles_data_reader::write_token_cache(const std::string& data_filename,
+                                           const std::string& offsets_filename,
+                                           const std::string& cache_filename)
+{
+  std::ifstream offsets_in(offsets_filename, std::ios::binary | std::ios::ate);
+  if (!offsets_in) {
+    LBANN_ERROR("failed to open ", offsets_filename, " for reading");
+  }
+  const uint64_t num_samples =
+    static_cast<uint64_t>(offsets_in.tellg()) / OffsetAndLengthBinarySize;
+  offsets_in.seekg(0, std::ios::beg);
+  const file::mapped_file data(data_filename);
+
+  const std::string tmp_filename =
+    build_string(cache_filename, ".tmp.", get_comm()->get_rank_in_world());
+  std::ofstream out(tmp_filename, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    LBANN_ERROR("failed to open ", tmp_filename, " for writing");
+  }
+  token_cache_header header;
+  std::memcpy(header.magic, token_cache_magic, sizeof(header.magic));
+  header.num_samples = num_samples;
+  header.record_len = m_linearized_data_size;
+  header.key = get_token_cache_key();
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::vector<unsigned short> tokens;
+  long long offset;
+  unsigned short length;
+  for (uint64_t local_id = 0; local_id < num_samples; ++local_id) {
+    if (!offsets_in.read((char*)&offset, OffsetBinarySize) ||
+        !offsets_in.read((char*)&length, LengthBinarySize)) {
+      LBANN_ERROR("read offset field failed : ", offsets_filename);
+    }
+    if (offset < 0 || static_cast<size_t>(offset) + length > data.size()) {
+      LBANN_ERROR("sample ",
+                  local_id,
+                  " of ",
+                  data_filename,
+                  " lies outside of the file");
+    }
+    // As in get_raw_sample(), anything after an internal delimiter is ignored
+    const char* const smiles = data.data() + offset;
+    const char* const end =
+      std::find_if(smiles, smiles + length, [this](char c) {
+        return is_delimiter(c);
+      });
+    encode_smiles(smiles, static_cast<unsigned short>(end - smiles), tokens);
+    out.write(reinterpret_cast<const char*>(tokens.data()),
+              tokens.size() * sizeof(unsigned short));
+  }
+  out.close();
+  if (!out) {
+    LBANN_ERROR("failed to write the token cache ", tmp_filename);
+  }
+  if (std::rename(tmp_filename.c_str(), cache_filename.c_str()) != 0) {
+    LBANN_ERROR("failed to rename ", tmp_filename, " to ", cache_filename);
+  }
+}
+
+void smiles_data_reader::load_token_caches(const std::string& cache_dir)
+{
+  double tm1 = get_time();
+  std::vector<size_t> samples_per_file;
+  std::vector<std::string> data_filenames;
+  std::vector<std::string> offsets_filenames;
+  read_metadata_file(samples_per_file, data_filenames, offsets_filenames);
+
+  if (get_comm()->am_world_master()) {
+    file::make_directory(cache_dir);
+  }
+  get_comm()->global_barrier();
+
+  // Build the caches that are missing or stale; each data file is tokenized
+  // by one rank of the world
+  const uint64_t key = get_token_cache_key();
+  const size_t record_len = m_linearized_data_size;
+  const size_t np = get_comm()->get_procs_in_world();
+  const size_t me = get_comm()->get_rank_in_world();
+  // maps: data filename -> index into the metadata file entries
+  std::unordered_map<std::string, size_t> metadata_index;
+  std::vector<std::string> cache_filenames(data_filenames.size());
+  size_t num_built = 0;
+  for (size_t j = 0; j < data_filenames.size(); ++j) {
+    metadata_index[data_filenames[j]] = j;
+    cache_filenames[j] = get_token_cache_filename(cache_dir, data_filenames[j]);
+    if (j % np == me && !token_cache_is_current(cache_filenames[j],
+                                                samples_per_file[j],
+                                                record_len,
+                                                key)) {
+      write_token_cache(data_filenames[j],
+                        offsets_filenames[j],
+                        cache_filenames[j]);
+      ++num_built;
+    }
+  }
+  get_comm()->global_barrier();
+
+  // Map the caches of the data files in the sample list
+  std::vector<std::shared_ptr<const token_cache_file>> caches(
+    data_filenames.size());
+  m_token_cache.assign(m_sample_list.get_num_files(), nullptr);
+  for (size_t file_id = 0; file_id < m_token_cache.size(); ++file_id) {
+    std::string filename = m_sample_list.get_samples_dirname() + "/" +
+                           m_sample_list.get_samples_filename(file_id);
+    file::remove_multiple_slashes(filename);
+    const auto iter = metadata_index.find(filename);
+    if (iter == metadata_index.end()) {
+      LBANN_ERROR("data file ",
+                  filename,
+                  " is not listed in the metadata file ",
+                  get_metadata_filename());
+    }
+    const size_t j = iter->second;
+    if (caches[j] == nullptr) {
+      caches[j] = std::make_shared<const token_cache_file>(cache_filenames[j],
+                                                           samples_per_file[j],
+                                                           record_len,
+                                                           key);
+    }
+    m_token_cache[file_id] = caches[j];
+  }
+
+  if (get_comm()->am_world_master()) {
+    std::cout << "token caches in " << cache_dir << ": built " << num_built
+              << " on world master; time: " << get_time() - tm1 << std::endl;
+  }
+}
+
 void smiles_data_reader::read_offset_data(std::vector<SampleData>& data)
 {
   data.clear();
@@ -817,7 +1128,9 @@ void smiles_data_reader::use_unused_index_set(execution_mode m)
   m_filename_to_local_id_set.clear();
   // Rebuild them on the previously used index set
   build_some_maps();
-  load_offsets_and_lengths();
+  if (m_token_cache.empty()) {
+    load_offsets_and_lengths();
+  }
   print_statistics();
 }
 
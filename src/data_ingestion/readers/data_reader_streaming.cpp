@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_ingestion/readers/data_reader_streaming.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/hash.hpp"
+#include "lbann/utils/options.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace lbann {
+
+streaming_data_reader::streaming_data_reader(bool shuffle)
+  : generic_data_reader(shuffle)
+{}
+
+streaming_data_reader::streaming_data_reader(
+  const streaming_data_reader& other)
+  : generic_data_reader(other),
+    m_num_samples(other.m_num_samples),
+    m_shard_offsets(other.m_shard_offsets),
+    m_shuffle_buffer_size(other.m_shuffle_buffer_size),
+    m_seed(other.m_seed),
+    m_seeded(other.m_seeded),
+    m_stream_gen(other.m_stream_gen),
+    m_shard_order(other.m_shard_order),
+    m_shard_position(other.m_shard_position),
+    m_sample_in_shard(other.m_sample_in_shard),
+    m_shuffle_buffer(other.m_shuffle_buffer),
+    m_window(other.m_window),
+    m_window_start(other.m_window_start),
+    m_stream_epoch(other.m_stream_epoch)
+{}
+
+streaming_data_reader&
+streaming_data_reader::operator=(const streaming_data_reader& other)
+{
+  generic_data_reader::operator=(other);
+  m_num_samples = other.m_num_samples;
+  m_shard_offsets = other.m_shard_offsets;
+  m_shuffle_buffer_size = other.m_shuffle_buffer_size;
+  m_seed = other.m_seed;
+  m_seeded = other.m_seeded;
+  m_stream_gen = other.m_stream_gen;
+  m_shard_order = other.m_shard_order;
+  m_shard_position = other.m_shard_position;
+  m_sample_in_shard = other.m_sample_in_shard;
+  m_shuffle_buffer = other.m_shuffle_buffer;
+  m_window = other.m_window;
+  m_window_start = other.m_window_start;
+  m_stream_epoch = other.m_stream_epoch;
+  return *this;
+}
+
+void streaming_data_reader::set_shards(
+  const std::vector<uint64_t>& shard_sizes)
+{
+  for (auto m : execution_mode_iterator()) {
+    if (get_execution_mode_split_fraction(m) > 0.) {
+      LBANN_ERROR(get_type(),
+                  " streams its samples and cannot split off a ",
+                  to_string(m),
+                  " set; use a separate data reader for it");
+    }
+  }
+
+  m_shard_offsets.assign(1, 0);
+  for (const auto size : shard_sizes) {
+    m_shard_offsets.push_back(m_shard_offsets.back() + size);
+  }
+  m_num_samples = m_shard_offsets.back();
+  if (m_num_samples == 0) {
+    LBANN_ERROR(get_type(), " has no samples");
+  }
+  // A partial data set is the start of each epoch's stream
+  m_num_samples = get_num_indices_to_use();
+
+  if (m_shuffle_buffer_size == 0) {
+    m_shuffle_buffer_size = global_argument_parser().get<int>(
+      LBANN_OPTION_STREAM_SHUFFLE_BUFFER_SIZE);
+  }
+  m_window.clear();
+  m_stream_epoch = m_epoch + 1; // Force a restart
+}
+
+std::pair<uint64_t, uint64_t>
+streaming_data_reader::locate_sample(uint64_t index) const
+{
+  const auto it =
+    std::upper_bound(m_shard_offsets.begin(), m_shard_offsets.end(), index);
+  const uint64_t shard = std::distance(m_shard_offsets.begin(), it) - 1;
+  return {shard, index - m_shard_offsets[shard]};
+}
+
+void streaming_data_reader::shuffle_indices(rng_gen& gen)
+{
+  // Draw the seed once so that every epoch's stream can be replayed
+  // from the epoch number alone
+  if (!m_seeded) {
+    m_seed = gen();
+    m_seeded = true;
+  }
+  std::lock_guard<std::mutex> lock(m_stream_mutex);
+  restart_stream();
+}
+
+void streaming_data_reader::restart_stream()
+{
+  m_stream_epoch = m_epoch;
+  m_stream_gen.seed(hash_combine(m_seed, m_epoch));
+  m_shard_order.resize(get_num_shards());
+  std::iota(m_shard_order.begin(), m_shard_order.end(), 0);
+  if (m_shuffle) {
+    std::shuffle(m_shard_order.begin(), m_shard_order.end(), m_stream_gen);
+  }
+  m_shard_position = 0;
+  m_sample_in_shard = 0;
+  m_shuffle_buffer.clear();
+  m_window.clear();
+  m_window_start = 0;
+}
+
+uint64_t streaming_data_reader::next_sample_index()
+{
+  // Top up the shuffle buffer from the current shard
+  const uint64_t capacity =
+    m_shuffle ? std::max(m_shuffle_buffer_size, uint64_t{1}) : 1;
+  while (m_shuffle_buffer.size() < capacity &&
+         m_shard_position < m_shard_order.size()) {
+    const uint64_t shard = m_shard_order[m_shard_position];
+    const uint64_t shard_size =
+      m_shard_offsets[shard + 1] - m_shard_offsets[shard];
+    if (m_sample_in_shard < shard_size) {
+      m_shuffle_buffer.push_back(m_shard_offsets[shard] + m_sample_in_shard);
+      ++m_sample_in_shard;
+    }
+    else {
+      ++m_shard_position;
+      m_sample_in_shard = 0;
+    }
+  }
+  if (m_shuffle_buffer.empty()) {
+    LBANN_ERROR(get_type(), " ran past the end of its stream");
+  }
+
+  // Emit a random buffered sample
+  uint64_t slot = 0;
+  if (m_shuffle_buffer.size() > 1) {
+    std::uniform_int_distribution<uint64_t> dist(0,
+                                                 m_shuffle_buffer.size() - 1);
+    slot = dist(m_stream_gen);
+  }
+  const uint64_t index = m_shuffle_buffer[slot];
+  m_shuffle_buffer[slot] = m_shuffle_buffer.back();
+  m_shuffle_buffer.pop_back();
+  return index;
+}
+
+void streaming_data_reader::prepare_sample_indices(uint64_t first,
+                                                   uint64_t stride,
+                                                   uint64_t count)
+{
+  if (count == 0 || first >= m_num_samples) {
+    return;
+  }
+  const uint64_t last = std::min(first + (count - 1) * stride,
+                                 m_num_samples - 1);
+
+  std::lock_guard<std::mutex> lock(m_stream_mutex);
+  // Positions only move forward within an epoch; going back, e.g.
+  // after restarting from a checkpoint, replays the stream
+  if (m_stream_epoch != m_epoch || first < m_window_start) {
+    restart_stream();
+  }
+  while (!m_window.empty() && m_window_start < first) {
+    m_window.pop_front();
+    ++m_window_start;
+  }
+  while (m_window_start + m_window.size() <= last) {
+    const uint64_t index = next_sample_index();
+    if (m_window.empty() && m_window_start < first) {
+      ++m_window_start;
+    }
+    else {
+      m_window.push_back(index);
+    }
+  }
+}
+
+uint64_t streaming_data_reader::get_sample_index(uint64_t position) const
+{
+  if (position < m_window_start ||
+      position >= m_window_start + m_window.size()) {
+    LBANN_ERROR(get_type(),
+                " was asked for the sample at position ",
+                position,
+                ", which was not prepared");
+  }
+  return m_window[position - m_window_start];
+}
+
+} // namespace lbann
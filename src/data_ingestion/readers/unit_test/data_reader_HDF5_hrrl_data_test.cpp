@@ -205,6 +205,63 @@ TEST_CASE("hdf5 data reader transform tests", "[data_reader][hdf5][hrrl]")
   }
 }
 
+TEST_CASE("hdf5 data reader normalization sharing",
+          "[data_reader][hdf5][hrrl][normalize]")
+{
+  DataReaderHDF5WhiteboxTester white_box_tester;
+  auto make_reader = [&](const std::string& role,
+                         const std::vector<std::string>& normalized,
+                         const std::string& dropped = "") {
+    auto reader = std::make_unique<lbann::hdf5_data_reader>();
+    reader->set_role(role);
+    white_box_tester.get_data_schema(*reader).parse(hdf5_hrrl_data_schema,
+                                                    "yaml");
+    conduit::Node& experiment_schema =
+      white_box_tester.get_experiment_schema(*reader);
+    experiment_schema.parse(hdf5_hrrl_experiment_schema, "yaml");
+    for (const auto& field : normalized) {
+      experiment_schema[field + "/metadata/normalize"] = "true";
+    }
+    if (!dropped.empty()) {
+      experiment_schema.remove(dropped);
+    }
+    white_box_tester.parse_schemas(*reader);
+    return reader;
+  };
+
+  SECTION("Other roles take the training statistics")
+  {
+    auto train_reader = make_reader("train", {"Epmax"});
+    auto test_reader = make_reader("test", {"Epmax"});
+
+    // Stands in for the statistics of compute_normalization_statistics
+    white_box_tester.set_normalization(*train_reader, "Epmax", {0.5}, {-3.});
+    REQUIRE(white_box_tester.get_normalization(*test_reader, "Epmax").first !=
+            std::vector<double>{0.5});
+
+    test_reader->copy_normalization_statistics(*train_reader);
+    auto [scale, bias] =
+      white_box_tester.get_normalization(*test_reader, "Epmax");
+    CHECK(scale == std::vector<double>{0.5});
+    CHECK(bias == std::vector<double>{-3.});
+    const conduit::Node& metadata =
+      white_box_tester.get_experiment_schema(*test_reader)["Epmax/metadata"];
+    CHECK(metadata["scale"].to_float64() == 0.5);
+    CHECK(metadata["bias"].to_float64() == -3.);
+
+    // Unmarked fields keep their own normalization
+    CHECK(white_box_tester.get_normalization(*test_reader, "T") ==
+          white_box_tester.get_normalization(*train_reader, "T"));
+  }
+
+  SECTION("A field without training statistics is an error")
+  {
+    auto train_reader = make_reader("train", {"Epmax"}, "alpha");
+    auto test_reader = make_reader("test", {"Epmax", "alpha"});
+    CHECK_THROWS(test_reader->copy_normalization_statistics(*train_reader));
+  }
+}
+
 TEST_CASE("hdf5 data reader pack test", "[data_reader][hdf5][hrrl][pack]")
 {
   // initialize stuff (boilerplate)
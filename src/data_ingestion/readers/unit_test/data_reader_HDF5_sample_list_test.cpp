@@ -28,13 +28,18 @@
 
 #include "MPITestHelpers.hpp"
 #include "TestHelpers.hpp"
+#include "./data_reader_common_catch2.hpp"
 #include "lbann/data_ingestion/readers/data_reader_HDF5.hpp"
+#include "lbann/data_ingestion/readers/data_reader_sample_list_impl.hpp"
 #include "lbann/data_ingestion/readers/sample_list_impl.hpp"
 #include "lbann/data_ingestion/readers/sample_list_open_files_impl.hpp"
 #include "lbann/proto/lbann.pb.h"
 #include <google/protobuf/text_format.h>
 #include <lbann/base.hpp>
 
+#include <conduit/conduit_relay_io_hdf5.hpp>
+#include <sstream>
+
 namespace {
 
 std::string const probies_hdf5_legacy_sample_list =
@@ -89,4 +94,125 @@ TEST_CASE("hdf5 data reader",
     hdf5_dr->get_sample_list().to_string(buf);
     CHECK(sample_list == buf);
   }
+
+  SECTION("binary MULTI-SAMPLE_INCLUSION_V2")
+  {
+    std::string const sample_list =
+      probies_hdf5_multi_sample_inclusion_v2_sample_list;
+    const std::string dir = create_test_directory(
+      "hdf5_binary_sample_list_" + std::to_string(comm.get_rank_in_world()));
+    write_file(sample_list, dir, "sample_list.txt");
+    const std::string bin_fn = dir + "/sample_list.bin";
+    lbann::write_binary_sample_list(dir + "/sample_list.txt", bin_fn);
+    REQUIRE(lbann::is_binary_sample_list(bin_fn));
+    CHECK_FALSE(lbann::is_binary_sample_list(dir + "/sample_list.txt"));
+
+    hdf5_dr->get_sample_list().load(bin_fn, comm, true);
+    hdf5_dr->get_sample_list().all_gather_packed_lists(comm);
+    std::string buf;
+    hdf5_dr->get_sample_list().to_string(buf);
+    CHECK(sample_list == buf);
+  }
+}
+
+TEST_CASE("node-shared sample list",
+          "[mpi][data_reader][sample_list][hdf5][.filesystem]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  // Every rank on a node reads the same files, written once per node
+  int pid = getpid();
+  comm.world_broadcast(0, pid);
+  const std::string dir =
+    "/tmp/hdf5_node_shared_sample_list_" + std::to_string(pid);
+  std::string const sample_list =
+    probies_hdf5_multi_sample_inclusion_v2_sample_list;
+  if (comm.get_rank_in_node() == 0) {
+    lbann::file::make_directory(dir);
+    write_file(sample_list, dir, "sample_list.txt");
+    write_file("", dir, "empty.txt");
+    lbann::write_binary_sample_list(dir + "/sample_list.txt",
+                                    dir + "/sample_list.bin");
+  }
+  comm.global_barrier();
+
+  auto hdf5_dr = std::make_unique<lbann::hdf5_data_reader>();
+  hdf5_dr->get_sample_list().unset_data_file_check();
+  auto& list = hdf5_dr->get_sample_list();
+
+  SECTION("text list")
+  {
+    list.load_node_shared(dir + "/sample_list.txt", comm, true);
+    list.all_gather_packed_lists(comm);
+    std::string buf;
+    list.to_string(buf);
+    CHECK(sample_list == buf);
+  }
+
+  SECTION("binary list")
+  {
+    list.load_node_shared(dir + "/sample_list.bin", comm, true);
+    list.all_gather_packed_lists(comm);
+    std::string buf;
+    list.to_string(buf);
+    CHECK(sample_list == buf);
+  }
+
+  SECTION("errors on the building rank reach every rank")
+  {
+    CHECK_THROWS(list.load_node_shared(dir + "/missing.txt", comm, true));
+    CHECK_THROWS(list.load_node_shared(dir + "/empty.txt", comm, true));
+  }
+}
+
+TEST_CASE("hdf5 data reader file leases",
+          "[mpi][data_reader][sample_list][hdf5][.filesystem]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  const std::string dir = create_test_directory(
+    "hdf5_file_leases_" + std::to_string(comm.get_rank_in_world()));
+  std::ostringstream sample_list;
+  sample_list << "MULTI-SAMPLE_INCLUSION_V2\n6 3\n" << dir << "\n";
+  for (int f = 0; f < 3; ++f) {
+    const std::string fn = "leases_" + std::to_string(f) + ".h5";
+    conduit::Node node;
+    node["RUN_ID/" + std::to_string(2 * f) + "/x"] = 1.0;
+    node["RUN_ID/" + std::to_string(2 * f + 1) + "/x"] = 2.0;
+    hid_t h = conduit::relay::io::hdf5_create_file(dir + "/" + fn);
+    conduit::relay::io::hdf5_write(node, h);
+    conduit::relay::io::hdf5_close_file(h);
+    sample_list << fn << " 2 RUN_ID/" << 2 * f << " RUN_ID/" << 2 * f + 1
+                << "\n";
+  }
+
+  auto hdf5_dr = std::make_unique<lbann::hdf5_data_reader>();
+  auto& list = hdf5_dr->get_sample_list();
+  list.unset_data_file_check();
+  std::istringstream iss(sample_list.str());
+  list.load(iss, comm, true);
+  list.all_gather_packed_lists(comm);
+  list.set_max_open_files(1);
+  auto is_open = [&list](size_t index) {
+    return list.is_file_handle_valid(
+      list.get_samples_file_handle(list[index].first));
+  };
+
+  // Samples 0, 2 and 4 live in different files
+  hdf5_dr->open_file(0);
+  hdf5_dr->open_file(2);
+  CHECK(is_open(0));
+  CHECK(is_open(2));
+  CHECK(list.get_num_file_handle_evictions() == 0);
+
+  // Once released, the handles are evicted as the cache turns over
+  hdf5_dr->close_file(0);
+  hdf5_dr->close_file(2);
+  hdf5_dr->open_file(4);
+  CHECK_FALSE(is_open(0));
+  CHECK_FALSE(is_open(2));
+  CHECK(is_open(4));
+  CHECK(list.get_num_file_handle_evictions() == 2);
+  hdf5_dr->close_file(4);
+  CHECK_THROWS(hdf5_dr->close_file(4));
 }
@@ -85,6 +85,27 @@ public:
     return x.load_sample(node, file_handle, sample_name);
   }
 
+  void set_normalization(lbann::hdf5_data_reader& x,
+                         const std::string& path,
+                         const std::vector<double>& scale,
+                         const std::vector<double>& bias)
+  {
+    x.set_normalization(path, scale, bias);
+    x.build_field_plans();
+  }
+
+  /** Returns the scale and bias that loading applies to a field */
+  std::pair<std::vector<double>, std::vector<double>>
+  get_normalization(lbann::hdf5_data_reader& x, const std::string& path)
+  {
+    for (const auto& plan : x.m_field_plans) {
+      if (plan.node_path == "/" + path && plan.normalize) {
+        return {plan.scale, plan.bias};
+      }
+    }
+    return {};
+  }
+
   void print_metadata(lbann::hdf5_data_reader& x, std::ostream& os = std::cout)
   {
     x.print_metadata(os);
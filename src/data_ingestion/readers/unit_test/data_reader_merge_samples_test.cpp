@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/data_ingestion/readers/data_reader_merge_samples.hpp"
+
+#include <numeric>
+#include <vector>
+
+namespace {
+
+/** Reader whose one-entry samples encode the reader and sample index */
+class toy_reader : public lbann::generic_data_reader
+{
+public:
+  toy_reader(uint64_t num_samples, int tag)
+    : lbann::generic_data_reader(false), m_num_samples(num_samples), m_tag(tag)
+  {}
+  toy_reader* copy() const override { return new toy_reader(*this); }
+  std::string get_type() const override { return "toy_reader"; }
+  void load() override
+  {
+    m_shuffled_indices.resize(m_num_samples);
+    std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+  }
+  int get_linearized_data_size() const override { return 1; }
+  const std::vector<El::Int> get_data_dims() const override { return {1}; }
+
+protected:
+  bool fetch_datum(lbann::CPUMat& X, uint64_t data_id, uint64_t mb_idx) override
+  {
+    X(0, mb_idx) = 100 * m_tag + data_id;
+    return true;
+  }
+
+private:
+  uint64_t m_num_samples;
+  int m_tag;
+};
+
+class toy_merge_samples : public lbann::data_reader_merge_samples
+{
+public:
+  using lbann::data_reader_merge_samples::data_reader_merge_samples;
+  using lbann::data_reader_merge_samples::fetch_datum;
+};
+
+} // namespace
+
+TEST_CASE("Merge samples data reader", "[data_reader][merge_samples]")
+{
+  const std::vector<uint64_t> sizes = {3, 0, 5, 1};
+  std::vector<lbann::generic_data_reader*> readers;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    readers.push_back(new toy_reader(sizes[i], i));
+  }
+  toy_merge_samples dr(readers, false);
+  dr.load();
+  REQUIRE(dr.get_num_data() == 9);
+
+  SECTION("every sample is fetched from its own reader")
+  {
+    lbann::CPUMat X(1, 9);
+    for (uint64_t id = 0; id < 9; ++id) {
+      REQUIRE(dr.fetch_datum(X, id, id));
+    }
+    const std::vector<int> expected = {0, 1, 2, 200, 201, 202, 203, 204, 300};
+    for (int id = 0; id < 9; ++id) {
+      CHECK(X(0, id) == expected[id]);
+    }
+  }
+
+  SECTION("copies keep the sample table")
+  {
+    toy_merge_samples other(dr);
+    lbann::CPUMat X(1, 1);
+    REQUIRE(other.fetch_datum(X, 7, 0));
+    CHECK(X(0, 0) == 204);
+    CHECK_THROWS(other.fetch_datum(X, 9, 0));
+  }
+}
@@ -41,6 +41,7 @@
 
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
 #include <ctime> // Use time since epoch as unique tmp directory.
 #include <regex>
 #include <string>
@@ -99,6 +100,7 @@ TEST_CASE("SMILES functional black-box",
                                 "--use_data_store",
                                 "--preload_data_store",
                                 "--sequence_length=100",
+                                "--length_bucket_size=1000000",
                                 "--vocab",
                                 vocab_fn.c_str()};
     int const argc = sizeof(argv) / sizeof(argv[0]);
@@ -151,6 +153,26 @@ TEST_CASE("SMILES functional black-box",
       REQUIRE_NOTHROW(test_fetch(*test_ptr));
     }
   }
+
+  SECTION("length bucketing sorts each bucket by sample length")
+  {
+    REQUIRE(unit_test::utilities::IsValidPtr(train_ptr));
+    REQUIRE(train_ptr->has_variable_length_samples());
+    auto before = train_ptr->get_shuffled_indices();
+    // A new epoch reshuffles; the only bucket spans the whole data set
+    REQUIRE_NOTHROW(train_ptr->update(true));
+    auto after = train_ptr->get_shuffled_indices();
+    for (size_t j = 1; j < after.size(); ++j) {
+      CHECK(train_ptr->get_sample_length(after[j - 1]) <=
+            train_ptr->get_sample_length(after[j]));
+    }
+    for (const auto& index : after) {
+      CHECK(train_ptr->get_sample_length(index) <= 102);
+    }
+    std::sort(before.begin(), before.end());
+    std::sort(after.begin(), after.end());
+    CHECK(before == after);
+  }
 }
 
 static int write_offsets(std::string const& smi, std::ostream& out)
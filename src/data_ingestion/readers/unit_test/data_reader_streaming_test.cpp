@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/data_ingestion/readers/data_reader_streaming.hpp"
+#include "lbann/utils/random_number_generators.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+/** Streaming reader over shards of the given sizes */
+class toy_streaming_reader : public lbann::streaming_data_reader
+{
+public:
+  toy_streaming_reader(std::vector<uint64_t> shard_sizes,
+                       uint64_t buffer_size,
+                       bool shuffle)
+    : lbann::streaming_data_reader(shuffle), m_shard_sizes(shard_sizes)
+  {
+    set_shuffle_buffer_size(buffer_size);
+  }
+  toy_streaming_reader* copy() const override
+  {
+    return new toy_streaming_reader(*this);
+  }
+  std::string get_type() const override { return "toy_streaming_reader"; }
+  void load() override { set_shards(m_shard_sizes); }
+
+  /** Draws a whole epoch, a few positions at a time */
+  std::vector<uint64_t> draw_epoch(uint64_t count)
+  {
+    std::vector<uint64_t> indices;
+    for (uint64_t pos = 0; pos < get_num_data(); pos += count) {
+      prepare_sample_indices(pos, 1, count);
+      for (uint64_t i = pos; i < std::min(pos + count, get_num_data()); ++i) {
+        indices.push_back(get_sample_index(i));
+      }
+    }
+    return indices;
+  }
+
+private:
+  std::vector<uint64_t> m_shard_sizes;
+};
+
+} // namespace
+
+TEST_CASE("Streaming data reader", "[data_reader][streaming]")
+{
+  lbann::init_random(42, 1);
+  lbann::init_data_seq_random(42);
+
+  const std::vector<uint64_t> shard_sizes = {7, 0, 13, 1, 9};
+  const uint64_t num_samples = 30;
+
+  SECTION("each epoch is a permutation of the data set")
+  {
+    toy_streaming_reader dr(shard_sizes, 4, true);
+    dr.load();
+    dr.setup(1, nullptr);
+    REQUIRE(dr.get_num_data() == num_samples);
+    std::vector<uint64_t> expected(num_samples);
+    std::iota(expected.begin(), expected.end(), 0);
+    auto first = dr.draw_epoch(5);
+    auto sorted = first;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(sorted == expected);
+    CHECK(first != expected);
+
+    dr.update(true);
+    auto second = dr.draw_epoch(5);
+    CHECK(second != first);
+    std::sort(second.begin(), second.end());
+    CHECK(second == expected);
+  }
+
+  SECTION("without shuffling samples come in storage order")
+  {
+    toy_streaming_reader dr(shard_sizes, 4, false);
+    dr.load();
+    dr.setup(1, nullptr);
+    std::vector<uint64_t> expected(num_samples);
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(dr.draw_epoch(3) == expected);
+  }
+
+  SECTION("the stream is replayed when positions go back")
+  {
+    toy_streaming_reader dr(shard_sizes, 8, true);
+    dr.load();
+    dr.setup(1, nullptr);
+    const auto epoch = dr.draw_epoch(6);
+    // Resuming mid-epoch, as after a restart, sees the same samples
+    dr.prepare_sample_indices(12, 2, 4);
+    for (uint64_t i = 0; i < 4; ++i) {
+      CHECK(dr.get_sample_index(12 + 2 * i) == epoch[12 + 2 * i]);
+    }
+    CHECK_THROWS(dr.get_sample_index(11));
+  }
+}
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "lbann/data_ingestion/data_store_conduit.hpp"
+#include "lbann/data_ingestion/readers/data_reader_synthetic.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/options.hpp"
+
+#include <conduit/conduit.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr int num_features = 4;
+
+/** Fills a sample the way readers do, nested under its data_id */
+void make_sample(conduit::Node& node, uint64_t data_id, int num_values)
+{
+  const std::string id = LBANN_DATA_ID_STR(data_id);
+  std::vector<float> x(num_values);
+  for (int k = 0; k < num_values; ++k) {
+    x[k] = 10.f * data_id + k;
+  }
+  node[id + "/x"].set(x);
+  node[id + "/label"].set(static_cast<int32_t>(data_id));
+}
+
+void check_sample(const conduit::Node& node, uint64_t data_id, int num_values)
+{
+  const std::string id = LBANN_DATA_ID_STR(data_id);
+  INFO("data_id: " << data_id);
+  REQUIRE(node.has_path(id + "/x"));
+  REQUIRE(node[id + "/x"].dtype().number_of_elements() == num_values);
+  const float* x = node[id + "/x"].as_float32_ptr();
+  for (int k = 0; k < num_values; ++k) {
+    CHECK(x[k] == 10.f * data_id + k);
+  }
+  CHECK(node[id + "/label"].as_int32() == static_cast<int32_t>(data_id));
+}
+
+} // namespace
+
+TEST_CASE("Data store fixed-size records", "[mpi][data_store]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto& arg_parser = lbann::global_argument_parser();
+  arg_parser.clear();
+  lbann::construct_all_options();
+  char const* argv[] = {"data_store_conduit_fixed_records_test.exe",
+                        "--use_data_store",
+                        "--preload_data_store",
+                        "--data_store_fixed_records"};
+  int const argc = sizeof(argv) / sizeof(argv[0]);
+  REQUIRE_NOTHROW(arg_parser.parse(argc, argv));
+
+  const int np = comm.get_procs_per_trainer();
+  const int rank = comm.get_rank_in_trainer();
+  const uint64_t mb_size = 2 * np;
+  const uint64_t num_samples = 2 * mb_size;
+
+  lbann::data_reader_synthetic reader(num_samples, num_features, false);
+  reader.set_comm(&comm);
+  reader.set_role("train");
+  auto* ds = new lbann::data_store_conduit(&reader);
+  reader.set_data_store(ds);
+
+  // Samples are owned round robin; reversing the order means most
+  // of them are sent to another rank
+  std::vector<uint64_t> indices(num_samples);
+  std::unordered_map<int, int> owner;
+  for (uint64_t i = 0; i < num_samples; ++i) {
+    indices[i] = num_samples - 1 - i;
+    owner[i] = i % np;
+  }
+  ds->set_shuffled_indices(&indices);
+  ds->set_preloaded_owner_map(owner);
+  ds->set_finished_building_map();
+
+  // Rank 0's second sample is wider in the fallback section
+  uint64_t odd_id = num_samples;
+  SECTION("uniform samples are exchanged as records") {}
+  SECTION("a sample of another shape switches every rank to nodes")
+  {
+    odd_id = np;
+  }
+  auto num_values = [&](uint64_t id) {
+    return id == odd_id ? num_features + 1 : num_features;
+  };
+
+  for (uint64_t id = rank; id < num_samples; id += np) {
+    conduit::Node& node = ds->get_empty_node(id);
+    make_sample(node, id, num_values(id));
+    ds->set_preloaded_conduit_node(id, node);
+  }
+  ds->setup(mb_size);
+  ds->set_loading_is_complete();
+
+  // Owned samples are viewed in place
+  for (uint64_t id = rank; id < num_samples; id += np) {
+    check_sample(ds->get_conduit_node(id), id, num_values(id));
+  }
+
+  for (uint64_t pos = 0; pos < num_samples; pos += mb_size) {
+    ds->start_exchange_mini_batch_data(pos, mb_size, false);
+    ds->finish_exchange_mini_batch_data();
+    for (uint64_t i = pos; i < pos + mb_size; ++i) {
+      if (ds->get_destination(i) == rank) {
+        check_sample(ds->get_conduit_node(indices[i]),
+                     indices[i],
+                     num_values(indices[i]));
+      }
+    }
+  }
+  CHECK(ds->uses_fixed_records() == (odd_id == num_samples));
+}
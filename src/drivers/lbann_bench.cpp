@@ -0,0 +1,672 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Micro-benchmarks for LBANN operators and layers.
+//
+// Operators are constructed by name through the operator factory and
+// their fp_compute/bp_compute are timed on data-parallel matrices.
+// Layers are taken from a prototext model (gaussian layers make
+// convenient sources) and timed through per-layer callback hooks
+// while the model runs forward and backward propagation. Each
+// configuration is swept over the requested shapes, datatypes, and
+// devices, and results are written as CSV on the world master.
+
+#include "lbann/base.hpp"
+#include "lbann/callbacks/callback.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/layers/layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/operators/operator.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
+#include "lbann/proto/factories.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/options.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/weights/weights.hpp"
+
+#include "lbann/proto/datatype.pb.h"
+#include "lbann/proto/lbann.pb.h"
+#include "lbann/proto/operators.pb.h"
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace lbann;
+
+namespace {
+
+/** @brief One row of benchmark output. */
+struct bench_result
+{
+  std::string kind;
+  std::string name;
+  std::string datatype;
+  std::string device;
+  std::string dims;
+  El::Int mini_batch_size;
+  double fp_time = 0.;
+  double bp_time = 0.;
+  /** @brief Layer output dimensions of one sample. */
+  std::string output_dims;
+  /** @brief Output activations for the mini-batch. */
+  size_t activation_bytes = 0;
+  /** @brief Weights owned or shared by the layer. */
+  size_t weights_bytes = 0;
+  std::string status = "ok";
+};
+
+struct bench_options
+{
+  std::vector<std::vector<El::Int>> shapes;
+  El::Int mini_batch_size;
+  int warmup;
+  int iterations;
+  std::vector<std::string> datatypes;
+  std::vector<std::string> devices;
+};
+
+/** @brief Operator names registered with the default factory, with
+ *         the number of inputs each expects.
+ *
+ *  The factory does not expose operator arity, so it is listed here.
+ */
+std::vector<std::pair<std::string, int>> const& operator_table()
+{
+  static std::vector<std::pair<std::string, int>> const table = {
+    {"Abs", 1},
+    {"Acos", 1},
+    {"Acosh", 1},
+    {"Add", 2},
+    {"AddConstant", 1},
+    {"Asin", 1},
+    {"Asinh", 1},
+    {"Atan", 1},
+    {"Atanh", 1},
+    {"BinaryCrossEntropy", 2},
+    {"BooleanAccuracy", 2},
+    {"BooleanFalseNegative", 2},
+    {"BooleanFalsePositive", 2},
+    {"Ceil", 1},
+    {"Clamp", 1},
+    {"ConstantSubtract", 1},
+    {"Cos", 1},
+    {"Cosh", 1},
+    {"Divide", 2},
+    {"Equal", 2},
+    {"EqualConstant", 1},
+    {"Erf", 1},
+    {"ErfInv", 1},
+    {"Exp", 1},
+    {"Expm1", 1},
+    {"Floor", 1},
+    {"Gelu", 1},
+    {"Greater", 2},
+    {"GreaterConstant", 1},
+    {"GreaterEqual", 2},
+    {"GreaterEqualConstant", 1},
+    {"Less", 2},
+    {"LessConstant", 1},
+    {"LessEqual", 2},
+    {"LessEqualConstant", 1},
+    {"Log", 1},
+    {"Log1p", 1},
+    {"LogSigmoid", 1},
+    {"LogicalAnd", 2},
+    {"LogicalNot", 1},
+    {"LogicalOr", 2},
+    {"LogicalXor", 2},
+    {"Max", 2},
+    {"MaxConstant", 1},
+    {"Min", 2},
+    {"MinConstant", 1},
+    {"Mod", 2},
+    {"Multiply", 2},
+    {"Negative", 1},
+    {"NotEqual", 2},
+    {"NotEqualConstant", 1},
+    {"Pow", 2},
+    {"Reciprocal", 1},
+    {"Round", 1},
+    {"Rsqrt", 1},
+    {"SafeDivide", 2},
+    {"SafeReciprocal", 1},
+    {"Scale", 1},
+    {"Select", 3},
+    {"Selu", 1},
+    {"Sigmoid", 1},
+    {"SigmoidBinaryCrossEntropy", 2},
+    {"Sign", 1},
+    {"Sin", 1},
+    {"Sinh", 1},
+    {"Softplus", 1},
+    {"Softsign", 1},
+    {"Sqrt", 1},
+    {"Square", 1},
+    {"SquaredDifference", 2},
+    {"Subtract", 2},
+    {"SubtractConstant", 1},
+    {"Tan", 1},
+    {"Tanh", 1},
+  };
+  return table;
+}
+
+void sync_device()
+{
+#ifdef LBANN_HAS_GPU
+  hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+}
+
+std::vector<std::string> split(std::string const& str, char delim)
+{
+  std::vector<std::string> tokens;
+  std::istringstream ss(str);
+  std::string token;
+  while (std::getline(ss, token, delim)) {
+    if (!token.empty()) {
+      tokens.push_back(token);
+    }
+  }
+  return tokens;
+}
+
+/** @brief Parse shapes such as "64x64;1024" into dimension lists. */
+std::vector<std::vector<El::Int>> parse_shapes(std::string const& str)
+{
+  std::vector<std::vector<El::Int>> shapes;
+  for (auto const& shape : split(str, ';')) {
+    std::vector<El::Int> dims;
+    for (auto const& dim : split(shape, 'x')) {
+      dims.push_back(std::stol(dim));
+    }
+    shapes.push_back(std::move(dims));
+  }
+  return shapes;
+}
+
+std::string shape_to_string(std::vector<El::Int> const& dims)
+{
+  std::string str;
+  for (auto const& d : dims) {
+    str += (str.empty() ? "" : "x") + std::to_string(d);
+  }
+  return str;
+}
+
+El::Int shape_size(std::vector<El::Int> const& dims)
+{
+  El::Int size = 1;
+  for (auto const& d : dims) {
+    size *= d;
+  }
+  return size;
+}
+
+template <typename T>
+std::string datatype_name()
+{
+  return lbann_data::DataType_Name(proto::ProtoDataType<T>);
+}
+
+bool is_requested(std::vector<std::string> const& requested,
+                  std::string const& name)
+{
+  return std::find(requested.cbegin(), requested.cend(), name) !=
+         requested.cend();
+}
+
+/** @brief Build an operator message with default-valued parameters. */
+template <typename T, El::Device D>
+lbann_data::Operator make_operator_proto(std::string const& name)
+{
+  auto const* desc =
+    google::protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(
+      "lbann_data." + name + "Operator");
+  if (desc == nullptr) {
+    LBANN_ERROR("no parameter message for operator \"", name, "\"");
+  }
+  std::unique_ptr<google::protobuf::Message> params(
+    google::protobuf::MessageFactory::generated_factory()
+      ->GetPrototype(desc)
+      ->New());
+  lbann_data::Operator msg;
+  msg.set_input_datatype(proto::ProtoDataType<T>);
+  msg.set_output_datatype(proto::ProtoDataType<T>);
+  msg.set_device_allocation(proto::ProtoDevice<D>);
+  msg.mutable_parameters()->PackFrom(*params);
+  return msg;
+}
+
+template <typename T, El::Device D>
+void bench_operator(lbann_comm& comm,
+                    bench_options const& opts,
+                    std::string const& name,
+                    int num_inputs,
+                    std::vector<El::Int> const& dims,
+                    bench_result& result)
+{
+  using OperatorType = Operator<T, T, D>;
+  using MatType = El::DistMatrix<T, El::STAR, El::VC, El::ELEMENT, D>;
+
+  auto op = proto::construct_operator<T, T, D>(
+    make_operator_proto<T, D>(name));
+
+  auto const& g = comm.get_trainer_grid();
+  auto const height = shape_size(dims);
+  auto const width = opts.mini_batch_size;
+  std::vector<MatType> inputs, grad_wrt_inputs;
+  for (int i = 0; i < num_inputs; ++i) {
+    inputs.emplace_back(height, width, g, 0);
+    grad_wrt_inputs.emplace_back(height, width, g, 0);
+    El::Fill(inputs.back(), El::To<T>(0.5));
+  }
+  MatType output(height, width, g, 0), grad_wrt_output(height, width, g, 0);
+  El::Fill(grad_wrt_output, El::To<T>(1.));
+
+  std::vector<typename OperatorType::ConstInputTensorType> input_views;
+  std::vector<typename OperatorType::InputTensorType> grad_wrt_input_views;
+  for (int i = 0; i < num_inputs; ++i) {
+    input_views.emplace_back(inputs[i]);
+    grad_wrt_input_views.emplace_back(grad_wrt_inputs[i]);
+  }
+  std::vector<typename OperatorType::OutputTensorType> output_views;
+  output_views.emplace_back(output);
+  std::vector<typename OperatorType::ConstOutputTensorType>
+    grad_wrt_output_views;
+  grad_wrt_output_views.emplace_back(grad_wrt_output);
+
+  for (int iter = 0; iter < opts.warmup + opts.iterations; ++iter) {
+    bool const record = iter >= opts.warmup;
+    sync_device();
+    auto start = get_time();
+    op->fp_compute(input_views, output_views);
+    sync_device();
+    if (record) {
+      result.fp_time += get_time() - start;
+    }
+    start = get_time();
+    op->bp_compute(input_views, grad_wrt_output_views, grad_wrt_input_views);
+    sync_device();
+    if (record) {
+      result.bp_time += get_time() - start;
+    }
+  }
+}
+
+template <typename T, El::Device D>
+void bench_operators(lbann_comm& comm,
+                     bench_options const& opts,
+                     std::vector<bench_result>& results)
+{
+  if (!is_requested(opts.datatypes, datatype_name<T>()) ||
+      !is_requested(opts.devices, to_string(D))) {
+    return;
+  }
+  for (auto const& dims : opts.shapes) {
+    for (auto const& [name, num_inputs] : operator_table()) {
+      bench_result result{"operator",
+                          name,
+                          datatype_name<T>(),
+                          to_string(D),
+                          shape_to_string(dims),
+                          opts.mini_batch_size};
+      try {
+        bench_operator<T, D>(comm, opts, name, num_inputs, dims, result);
+      }
+      catch (std::exception const& e) {
+        result.status = std::string("error: ") + e.what();
+      }
+      results.push_back(std::move(result));
+    }
+  }
+}
+
+/** @brief Accumulates forward and backward prop time per layer. */
+class layer_timer_callback final : public callback_base
+{
+public:
+  layer_timer_callback* copy() const override
+  {
+    return new layer_timer_callback(*this);
+  }
+  std::string name() const override { return "layer timer"; }
+  unsigned get_hooks() const override
+  {
+    return hook_bit(layer_forward_prop_begin) |
+           hook_bit(layer_forward_prop_end) |
+           hook_bit(layer_backward_prop_begin) |
+           hook_bit(layer_backward_prop_end);
+  }
+  void on_forward_prop_begin(model*, Layer*) override { start(); }
+  void on_forward_prop_end(model*, Layer* l) override
+  {
+    stop(m_fp_times[l->get_name()]);
+  }
+  void on_backward_prop_begin(model*, Layer*) override { start(); }
+  void on_backward_prop_end(model*, Layer* l) override
+  {
+    stop(m_bp_times[l->get_name()]);
+  }
+
+  /** @brief Whether elapsed times are currently being recorded. */
+  bool m_record = false;
+  std::map<std::string, double> m_fp_times;
+  std::map<std::string, double> m_bp_times;
+
+private:
+  void write_specific_proto(lbann_data::Callback&) const override {}
+  void start()
+  {
+    sync_device();
+    m_start = get_time();
+  }
+  void stop(double& total)
+  {
+    sync_device();
+    if (m_record) {
+      total += get_time() - m_start;
+    }
+  }
+  double m_start = 0.;
+};
+
+/** @brief Benchmark every layer in a prototext model.
+ *
+ *  All layers are switched to the given datatype and device, and the
+ *  output dimensions of gaussian layers are set to the benchmark
+ *  shape.
+ */
+template <typename T, El::Device D>
+void bench_layers(lbann_comm& comm,
+                  bench_options const& opts,
+                  lbann_data::LbannPB const& pb,
+                  std::vector<bench_result>& results)
+{
+  if (!is_requested(opts.datatypes, datatype_name<T>()) ||
+      !is_requested(opts.devices, to_string(D))) {
+    return;
+  }
+  for (auto const& dims : opts.shapes) {
+    lbann_data::LbannPB this_pb(pb);
+    for (auto& proto_layer : *this_pb.mutable_model()->mutable_layer()) {
+      proto_layer.set_datatype(proto::ProtoDataType<T>);
+      proto_layer.set_device_allocation(to_string(D));
+      if (proto_layer.has_gaussian()) {
+        auto* neuron_dims =
+          proto_layer.mutable_gaussian()->mutable_neuron_dims();
+        neuron_dims->Clear();
+        for (auto const& d : dims) {
+          neuron_dims->Add(d);
+        }
+      }
+    }
+
+    std::vector<bench_result> model_results;
+    try {
+      auto m = proto::construct_model(&comm,
+                                      this_pb.optimizer(),
+                                      this_pb.trainer(),
+                                      this_pb.model());
+      auto timer = std::make_shared<layer_timer_callback>();
+      m->add_callback(timer);
+      m->setup(opts.mini_batch_size, {&comm.get_trainer_grid()});
+      for (int iter = 0; iter < opts.warmup + opts.iterations; ++iter) {
+        timer->m_record = iter >= opts.warmup;
+        m->clear_gradients();
+        m->forward_prop(execution_mode::training);
+        m->get_objective_function()->differentiate();
+        m->backward_prop(false);
+      }
+      for (auto const* l : m->get_layers()) {
+        bench_result result{"layer",
+                            l->get_name() + " (" + l->get_type() + ")",
+                            datatype_name<T>(),
+                            to_string(D),
+                            shape_to_string(dims),
+                            opts.mini_batch_size};
+        result.fp_time = timer->m_fp_times[l->get_name()];
+        result.bp_time = timer->m_bp_times[l->get_name()];
+        auto const out_dims = l->get_output_dims();
+        result.output_dims =
+          shape_to_string(std::vector<El::Int>(out_dims.begin(),
+                                               out_dims.end()));
+        for (int i = 0; i < l->get_num_children(); ++i) {
+          result.activation_bytes +=
+            sizeof(T) * l->get_output_size(i) * opts.mini_batch_size;
+        }
+        for (auto const& w : l->get_weights_pointers()) {
+          if (auto const w_ptr = w.lock()) {
+            result.weights_bytes += sizeof(T) * w_ptr->get_size();
+          }
+        }
+        model_results.push_back(std::move(result));
+      }
+    }
+    catch (std::exception const& e) {
+      bench_result result{"layer",
+                          this_pb.model().name(),
+                          datatype_name<T>(),
+                          to_string(D),
+                          shape_to_string(dims),
+                          opts.mini_batch_size};
+      result.status = std::string("error: ") + e.what();
+      model_results = {std::move(result)};
+    }
+    for (auto& result : model_results) {
+      results.push_back(std::move(result));
+    }
+  }
+}
+
+template <El::Device D>
+void bench_all_types(lbann_comm& comm,
+                     bench_options const& opts,
+                     bool run_operators,
+                     lbann_data::LbannPB const* pb,
+                     std::vector<bench_result>& results)
+{
+  auto bench_type = [&](auto t) {
+    using T = decltype(t);
+    if (run_operators) {
+      bench_operators<T, D>(comm, opts, results);
+    }
+    if (pb != nullptr) {
+      bench_layers<T, D>(comm, opts, *pb, results);
+    }
+  };
+  bench_type(float{});
+#ifdef LBANN_HAS_DOUBLE
+  bench_type(double{});
+#endif // LBANN_HAS_DOUBLE
+#ifdef LBANN_HAS_HALF
+  if constexpr (D == El::Device::CPU) {
+    bench_type(cpu_fp16{});
+  }
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU_FP16
+  if constexpr (D != El::Device::CPU) {
+    bench_type(fp16{});
+  }
+#endif // LBANN_HAS_GPU_FP16
+}
+
+/** @brief Write results as CSV with per-iteration mean times.
+ *
+ *  Times are the maximum over the ranks of the trainer.
+ */
+void write_results(lbann_comm& comm,
+                   bench_options const& opts,
+                   std::vector<bench_result> const& results,
+                   std::string const& filename)
+{
+  std::ofstream ofs;
+  if (comm.am_world_master()) {
+    ofs.open(filename);
+    if (!ofs) {
+      LBANN_ERROR("could not open \"", filename, "\" for writing");
+    }
+    ofs << "kind,name,datatype,device,dims,mini_batch_size,"
+        << "fp_time_ms,bp_time_ms,output_dims,activation_bytes,"
+        << "weights_bytes,status\n";
+  }
+  auto const scale = 1e3 / std::max(opts.iterations, 1);
+  for (auto const& r : results) {
+    auto const fp_time = comm.trainer_allreduce(r.fp_time, El::mpi::MAX);
+    auto const bp_time = comm.trainer_allreduce(r.bp_time, El::mpi::MAX);
+    if (comm.am_world_master()) {
+      ofs << r.kind << ",\"" << r.name << "\"," << r.datatype << ","
+          << r.device << "," << r.dims << "," << r.mini_batch_size << ","
+          << fp_time * scale << "," << bp_time * scale << ","
+          << r.output_dims << "," << r.activation_bytes << ","
+          << r.weights_bytes << ",\"" << r.status << "\"\n";
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  auto& arg_parser = global_argument_parser();
+  construct_all_options();
+  arg_parser.add_flag("bench operators",
+                      {"--bench_operators"},
+                      "[BENCH] Benchmark every registered operator");
+  arg_parser.add_option("bench layers",
+                        {"--bench_layers"},
+                        "[BENCH] Prototext model whose layers are benchmarked",
+                        "");
+  arg_parser.add_option("bench shapes",
+                        {"--bench_shapes"},
+                        "[BENCH] Sample shapes, e.g. \"64x64;1024\"",
+                        "1024");
+  arg_parser.add_option("bench mini-batch size",
+                        {"--bench_mini_batch_size"},
+                        "[BENCH] Mini-batch size",
+                        64);
+  arg_parser.add_option("bench warmup",
+                        {"--bench_warmup"},
+                        "[BENCH] Untimed warmup iterations",
+                        2);
+  arg_parser.add_option("bench iterations",
+                        {"--bench_iterations"},
+                        "[BENCH] Timed iterations",
+                        10);
+  arg_parser.add_option("bench datatypes",
+                        {"--bench_datatypes"},
+                        "[BENCH] Comma-separated datatypes, e.g. FLOAT,DOUBLE",
+                        "FLOAT,DOUBLE,FP16");
+  arg_parser.add_option("bench devices",
+                        {"--bench_devices"},
+                        "[BENCH] Comma-separated devices, e.g. CPU,GPU",
+                        "CPU,GPU");
+  arg_parser.add_option("bench output",
+                        {"--bench_output"},
+                        "[BENCH] CSV file for results",
+                        "lbann_bench.csv");
+
+  try {
+    arg_parser.parse(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error during argument parsing:\n\ne.what():\n\n  " << e.what()
+              << "\n\nProcess terminating." << std::endl;
+    std::terminate();
+  }
+
+  world_comm_ptr comm = initialize(argc, argv);
+  const bool master = comm->am_world_master();
+
+  try {
+    auto const layers_file = arg_parser.get<std::string>("bench layers");
+    bool const run_operators = arg_parser.get<bool>("bench operators");
+    if (arg_parser.help_requested() ||
+        (!run_operators && layers_file.empty())) {
+      if (master)
+        std::cout << arg_parser << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    bench_options opts;
+    opts.shapes = parse_shapes(arg_parser.get<std::string>("bench shapes"));
+    opts.mini_batch_size = arg_parser.get<int>("bench mini-batch size");
+    opts.warmup = arg_parser.get<int>("bench warmup");
+    opts.iterations = arg_parser.get<int>("bench iterations");
+    opts.datatypes = split(arg_parser.get<std::string>("bench datatypes"), ',');
+    opts.devices = split(arg_parser.get<std::string>("bench devices"), ',');
+
+    std::unique_ptr<lbann_data::LbannPB> pb;
+    if (!layers_file.empty()) {
+      pb = std::make_unique<lbann_data::LbannPB>();
+      read_prototext_file(layers_file, *pb, master);
+    }
+
+    std::vector<bench_result> results;
+    bench_all_types<El::Device::CPU>(*comm,
+                                     opts,
+                                     run_operators,
+                                     pb.get(),
+                                     results);
+#ifdef LBANN_HAS_GPU
+    bench_all_types<El::Device::GPU>(*comm,
+                                     opts,
+                                     run_operators,
+                                     pb.get(),
+                                     results);
+#endif // LBANN_HAS_GPU
+
+    auto const output = arg_parser.get<std::string>("bench output");
+    write_results(*comm, opts, results, output);
+    if (master) {
+      std::cout << "Wrote " << results.size() << " benchmark results to "
+                << output << std::endl;
+    }
+  }
+  catch (exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  }
+  catch (std::exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,386 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Benchmark for the lbann_comm collectives used in training.
+//
+// MPI is split into trainers exactly as in lbann (see
+// --procs_per_trainer), and each collective is run on the
+// communicator training uses: matrix allreduce and nb_allreduce
+// (flat and hierarchical) and column reduce-scatter on the trainer,
+// matrix broadcast across trainers, and the K-FAC allgather_blocks
+// in each of its modes. Every message size is swept on each device;
+// the device determines the Aluminum backend. Results are written as
+// CSV on the world master and can be used to find the crossover
+// points between algorithms and backends.
+
+#include "lbann/base.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/execution_algorithms/kfac/kfac_util.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/lbann_library.hpp"
+#include "lbann/utils/options.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace lbann;
+
+namespace {
+
+struct comm_bench_options
+{
+  std::vector<El::Int> sizes;
+  std::vector<std::string> collectives;
+  int warmup;
+  int iterations;
+};
+
+struct comm_bench_result
+{
+  std::string collective;
+  std::string algorithm;
+  std::string device;
+  std::string backend;
+  El::Int num_elements;
+  /** @brief Number of processes in the collective's communicator. */
+  int comm_size;
+  /** @brief Mean time per call, in seconds. */
+  double time;
+};
+
+std::vector<std::string> split(std::string const& str)
+{
+  std::vector<std::string> tokens;
+  std::istringstream ss(str);
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    if (!token.empty()) {
+      tokens.push_back(token);
+    }
+  }
+  return tokens;
+}
+
+bool is_requested(comm_bench_options const& opts, std::string const& name)
+{
+  return std::find(opts.collectives.cbegin(),
+                   opts.collectives.cend(),
+                   name) != opts.collectives.cend();
+}
+
+void sync_device()
+{
+#ifdef LBANN_HAS_GPU
+  hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+}
+
+/** @brief Aluminum backend lbann_comm dispatches to for a device. */
+template <El::Device D>
+std::string backend_name()
+{
+#if defined(LBANN_HAS_GPU) && defined(LBANN_HAS_ALUMINUM)
+  if constexpr (D == El::Device::GPU) {
+#if defined(AL_HAS_NCCL)
+    return "NCCL";
+#elif defined(AL_HAS_HOST_TRANSFER)
+    return "HostTransfer";
+#endif
+  }
+#endif // defined(LBANN_HAS_GPU) && defined(LBANN_HAS_ALUMINUM)
+  return "MPI";
+}
+
+/** @brief Mean time per call of @c f, maximized over all ranks. */
+template <typename F>
+double time_collective(lbann_comm& comm, comm_bench_options const& opts, F f)
+{
+  for (int i = 0; i < opts.warmup; ++i) {
+    f();
+  }
+  sync_device();
+  comm.global_barrier();
+  auto const start = get_time();
+  for (int i = 0; i < opts.iterations; ++i) {
+    f();
+  }
+  sync_device();
+  double const time = (get_time() - start) / std::max(opts.iterations, 1);
+  return comm.allreduce(time, comm.get_world_comm(), El::mpi::MAX);
+}
+
+template <El::Device D>
+void bench_collectives(lbann_comm& comm,
+                       comm_bench_options const& opts,
+                       std::vector<comm_bench_result>& results)
+{
+  using MatType = El::Matrix<DataType, D>;
+  using AbsMatType = El::AbstractMatrix<DataType>;
+  auto const& trainer_comm = comm.get_trainer_comm();
+  auto const& grid = comm.get_trainer_grid();
+  int const procs_per_trainer = comm.get_procs_per_trainer();
+
+  auto add_result = [&](std::string const& collective,
+                        std::string const& algorithm,
+                        El::Int num_elements,
+                        int comm_size,
+                        double time) {
+    results.push_back({collective,
+                       algorithm,
+                       to_string(D),
+                       backend_name<D>(),
+                       num_elements,
+                       comm_size,
+                       time});
+  };
+
+  std::vector<std::pair<std::string, allreduce_algorithm>> const algos = {
+    {"flat", allreduce_algorithm::flat},
+    {"hierarchical", allreduce_algorithm::hierarchical}};
+
+  for (auto const n : opts.sizes) {
+
+    // Gradient allreduce within the trainer
+    MatType buf;
+    El::Zeros(buf, n, 1);
+    for (auto const& [algo_name, algo] : algos) {
+      if (is_requested(opts, "allreduce")) {
+        auto const time = time_collective(comm, opts, [&] {
+          comm.allreduce(static_cast<AbsMatType&>(buf),
+                         trainer_comm,
+                         El::mpi::SUM,
+                         algo);
+        });
+        add_result("allreduce", algo_name, n, procs_per_trainer, time);
+      }
+      if (is_requested(opts, "nb_allreduce")) {
+        auto const time = time_collective(comm, opts, [&] {
+          Al::request req;
+          comm.nb_allreduce(static_cast<AbsMatType&>(buf),
+                            trainer_comm,
+                            req,
+                            El::mpi::SUM,
+                            algo);
+          comm.wait(req);
+        });
+        add_result("nb_allreduce", algo_name, n, procs_per_trainer, time);
+      }
+    }
+
+    // Sharded gradient reduce-scatter within the trainer
+    if (is_requested(opts, "reduce_scatter")) {
+      El::Int const height = std::max(n / procs_per_trainer, El::Int(1));
+      El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, D> src(grid);
+      El::DistMatrix<DataType, El::STAR, El::VC, El::ELEMENT, D> dst(grid);
+      El::Zeros(src, height, procs_per_trainer);
+      El::Zeros(dst, height, procs_per_trainer);
+      auto const time = time_collective(comm, opts, [&] {
+        comm.reduce_scatter_columns(src, dst);
+      });
+      add_result("reduce_scatter",
+                 "columns",
+                 height * procs_per_trainer,
+                 procs_per_trainer,
+                 time);
+    }
+
+    // Model exchange between trainers
+    if (is_requested(opts, "broadcast") && comm.get_num_trainers() > 1) {
+      auto const time = time_collective(comm, opts, [&] {
+        comm.intertrainer_broadcast_matrix(static_cast<AbsMatType&>(buf), 0);
+      });
+      add_result("broadcast", "intertrainer", n, comm.get_num_trainers(), time);
+    }
+
+    // K-FAC exchange of one block per rank in the trainer
+    if (is_requested(opts, "allgather_blocks")) {
+      El::Int const height = std::max(n / procs_per_trainer, El::Int(1));
+      std::vector<MatType> block_mats(procs_per_trainer);
+      std::vector<std::pair<size_t, El::AbstractMatrix<DataType>*>> blocks;
+      for (int i = 0; i < procs_per_trainer; ++i) {
+        El::Zeros(block_mats[i], height, 1);
+        blocks.emplace_back(i, &block_mats[i]);
+      }
+      std::vector<std::pair<std::string, kfac::kfac_allgather_mode>> const
+        modes = {{"ALLGATHER", kfac::kfac_allgather_mode::ALLGATHER},
+                 {"ALLREDUCE", kfac::kfac_allgather_mode::ALLREDUCE},
+                 {"BROADCAST", kfac::kfac_allgather_mode::BROADCAST}};
+      for (auto const& [mode_name, mode] : modes) {
+        MatType local_buffer, global_buffer;
+        El::Zeros(local_buffer, height, 1);
+        El::Zeros(global_buffer, height * procs_per_trainer, 1);
+        auto const time = time_collective(comm, opts, [&] {
+          kfac::allgather_blocks(blocks,
+                                 local_buffer,
+                                 global_buffer,
+                                 &comm,
+                                 mode);
+        });
+        add_result("allgather_blocks",
+                   mode_name,
+                   height * procs_per_trainer,
+                   procs_per_trainer,
+                   time);
+      }
+    }
+  }
+}
+
+/** @brief Write results as CSV with latency and bandwidths.
+ *
+ *  Bus bandwidth scales the algorithm bandwidth by the fraction of
+ *  the message each process must send for the collective (as in
+ *  nccl-tests), so that it is comparable across process counts.
+ */
+void write_results(std::vector<comm_bench_result> const& results,
+                   lbann_comm const& comm,
+                   std::string const& filename)
+{
+  std::ofstream ofs(filename);
+  if (!ofs) {
+    LBANN_ERROR("could not open \"", filename, "\" for writing");
+  }
+  ofs << "collective,algorithm,device,backend,world_size,procs_per_trainer,"
+      << "comm_size,elements,bytes,time_us,algbw_GBps,busbw_GBps\n";
+  for (auto const& r : results) {
+    double const bytes = double(r.num_elements) * sizeof(DataType);
+    double const p = r.comm_size;
+    double factor = 1.;
+    if (r.collective == "allreduce" || r.collective == "nb_allreduce" ||
+        (r.collective == "allgather_blocks" && r.algorithm == "ALLREDUCE")) {
+      factor = 2. * (p - 1.) / p;
+    }
+    else if (r.collective == "reduce_scatter" ||
+             r.collective == "allgather_blocks") {
+      factor = (p - 1.) / p;
+    }
+    double const algbw = r.time > 0. ? bytes / r.time / 1e9 : 0.;
+    ofs << r.collective << "," << r.algorithm << "," << r.device << ","
+        << r.backend << "," << comm.get_procs_in_world() << ","
+        << comm.get_procs_per_trainer() << "," << r.comm_size << ","
+        << r.num_elements << "," << bytes << "," << r.time * 1e6 << ","
+        << algbw << "," << algbw * factor << "\n";
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  auto& arg_parser = global_argument_parser();
+  construct_all_options();
+  arg_parser.add_option("comm bench sizes",
+                        {"--comm_bench_sizes"},
+                        "[COMM BENCH] Comma-separated message sizes, "
+                        "in elements",
+                        "1024,16384,262144,4194304,67108864");
+  arg_parser.add_option("comm bench collectives",
+                        {"--comm_bench_collectives"},
+                        "[COMM BENCH] Comma-separated collectives to run",
+                        "allreduce,nb_allreduce,reduce_scatter,broadcast,"
+                        "allgather_blocks");
+  arg_parser.add_option("comm bench warmup",
+                        {"--comm_bench_warmup"},
+                        "[COMM BENCH] Untimed warmup calls",
+                        5);
+  arg_parser.add_option("comm bench iterations",
+                        {"--comm_bench_iterations"},
+                        "[COMM BENCH] Timed calls",
+                        20);
+  arg_parser.add_option("comm bench output",
+                        {"--comm_bench_output"},
+                        "[COMM BENCH] CSV file for results",
+                        "lbann_comm_bench.csv");
+
+  try {
+    arg_parser.parse(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error during argument parsing:\n\ne.what():\n\n  " << e.what()
+              << "\n\nProcess terminating." << std::endl;
+    std::terminate();
+  }
+
+  world_comm_ptr comm = initialize(argc, argv);
+  const bool master = comm->am_world_master();
+
+  try {
+    if (arg_parser.help_requested()) {
+      if (master)
+        std::cout << arg_parser << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    comm_bench_options opts;
+    for (auto const& size :
+         split(arg_parser.get<std::string>("comm bench sizes"))) {
+      opts.sizes.push_back(std::stol(size));
+    }
+    opts.collectives =
+      split(arg_parser.get<std::string>("comm bench collectives"));
+    opts.warmup = arg_parser.get<int>("comm bench warmup");
+    opts.iterations = arg_parser.get<int>("comm bench iterations");
+
+    // Split MPI into trainers as training would
+    allocate_trainer_resources(comm.get());
+    if (master && is_requested(opts, "broadcast") &&
+        comm->get_num_trainers() == 1) {
+      std::cout << "Skipping broadcast: there is only one trainer"
+                << std::endl;
+    }
+
+    std::vector<comm_bench_result> results;
+    bench_collectives<El::Device::CPU>(*comm, opts, results);
+#ifdef LBANN_HAS_GPU
+    bench_collectives<El::Device::GPU>(*comm, opts, results);
+#endif // LBANN_HAS_GPU
+
+    if (master) {
+      auto const output = arg_parser.get<std::string>("comm bench output");
+      write_results(results, *comm, output);
+      std::cout << "Wrote " << results.size() << " benchmark results to "
+                << output << std::endl;
+    }
+  }
+  catch (lbann::exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  }
+  catch (std::exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
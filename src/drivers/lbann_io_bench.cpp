@@ -0,0 +1,334 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// End-to-end I/O benchmark for data readers.
+//
+// Sets up the trainer, its data readers, the buffered data coordinator
+// and (if configured) the data store from the usual prototext
+// arguments, but never builds the model. Epochs are run by
+// distributing every mini-batch into matrices the way input layers
+// do, and throughput, I/O thread utilization and data store exchange
+// time are reported for each requested number of I/O threads. Rows
+// are appended to a CSV file so that runs at different scales can be
+// collected into one table.
+
+#include "lbann/lbann.hpp"
+#include "lbann/data_ingestion/coordinator/buffered_data_coordinator.hpp"
+#include "lbann/data_ingestion/readers/utils/input_data_type.hpp"
+#include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/protobuf_utils.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include "lbann/proto/lbann.pb.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace lbann;
+
+namespace {
+
+struct io_bench_options
+{
+  execution_mode mode;
+  int num_epochs;
+  bool synchronous;
+  std::vector<size_t> thread_counts;
+};
+
+std::vector<size_t> parse_thread_counts(std::string const& str)
+{
+  std::vector<size_t> counts;
+  std::istringstream ss(str);
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    if (!token.empty()) {
+      counts.push_back(std::stoul(token));
+    }
+  }
+  return counts;
+}
+
+/** @brief Data fields provided by the configured data readers. */
+std::map<data_field_type, std::vector<El::Int>>
+get_data_fields(data_coordinator const& dc)
+{
+  auto const dr_metadata = dc.get_dr_metadata();
+  std::map<data_field_type, std::vector<El::Int>> fields;
+  fields[INPUT_DATA_TYPE_SAMPLES] =
+    dr_metadata.data_dims.at(data_reader_target_mode::INPUT);
+  if (dc.has_labels()) {
+    fields[INPUT_DATA_TYPE_LABELS] =
+      dr_metadata.data_dims.at(data_reader_target_mode::CLASSIFICATION);
+  }
+  if (dc.has_responses()) {
+    fields[INPUT_DATA_TYPE_RESPONSES] =
+      dr_metadata.data_dims.at(data_reader_target_mode::REGRESSION);
+  }
+  return fields;
+}
+
+/** @brief Run epochs with each I/O thread count and write one CSV row
+ *         per epoch.
+ *
+ *  Times are the maximum over the ranks of the trainer. Thread
+ *  utilization is the fraction of the epoch each I/O thread spent
+ *  fetching, summarized over all threads of all ranks.
+ */
+template <typename TensorDataType>
+void run_io_benchmark(lbann_comm& comm,
+                      trainer& t,
+                      buffered_data_coordinator<TensorDataType>& dc,
+                      io_bench_options const& opts,
+                      std::ostream* os)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif // LBANN_HAS_GPU
+  using MatType =
+    El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Dev>;
+
+  auto const mode = opts.mode;
+  if (!dc.is_execution_mode_valid(mode)) {
+    LBANN_ERROR("no data reader for ", to_string(mode));
+  }
+
+  // Register data fields the way input layers do
+  auto const fields = get_data_fields(dc);
+  std::map<data_field_type, std::unique_ptr<MatType>> matrices;
+  El::Int bytes_per_sample = 0;
+  for (auto const& [field, dims] : fields) {
+    dc.register_active_data_field(field, dims);
+    matrices[field] = std::make_unique<MatType>(comm.get_trainer_grid());
+    bytes_per_sample += dc.get_linearized_size(field) * sizeof(DataType);
+  }
+  dc.setup_data_fields(t.get_max_mini_batch_size());
+
+  auto& io_thread_pool = t.get_io_thread_pool();
+  auto const max_threads = io_thread_pool.get_num_threads();
+  auto thread_counts = opts.thread_counts;
+  if (thread_counts.empty()) {
+    thread_counts.push_back(max_threads);
+  }
+
+  SGDExecutionContext c(mode);
+  for (auto const num_threads : thread_counts) {
+    if (num_threads == 0 || num_threads > max_threads) {
+      // Data readers size per-thread state when they are set up
+      LBANN_ERROR("cannot run with ",
+                  num_threads,
+                  " I/O threads; data readers were set up for at most ",
+                  max_threads);
+    }
+    dc.collect_background_data_fetch(mode);
+    io_thread_pool.relaunch_pinned_threads(num_threads);
+
+    for (int epoch = 0; epoch < opts.num_epochs; ++epoch) {
+      dc.reset_mode(c);
+      uint64_t num_samples = 0, num_steps = 0;
+      comm.trainer_barrier();
+      auto const start = get_time();
+      if (!opts.synchronous) {
+        dc.fetch_active_batch_synchronous(mode);
+      }
+      bool end_of_epoch = false;
+      while (!end_of_epoch) {
+        if (opts.synchronous) {
+          dc.fetch_active_batch_synchronous(mode);
+        }
+        else {
+          dc.fetch_data_asynchronous(mode);
+        }
+        for (auto& [field, mat] : matrices) {
+          dc.distribute_from_local_matrix(mode, field, *mat);
+        }
+        num_samples += dc.get_current_mini_batch_size(mode);
+        ++num_steps;
+        end_of_epoch = dc.ready_for_next_fetch(mode);
+        c.inc_step();
+      }
+      EvalType const epoch_time =
+        comm.trainer_allreduce(EvalType(get_time() - start), El::mpi::MAX);
+      c.inc_epoch();
+
+      auto const& stats = dc.get_pipeline_stats();
+      auto const times = stats.get_last_epoch(mode);
+      auto const latency = stats.get_fetch_latency(mode);
+      EvalType util_sum = 0., util_min = 1., util_max = 0.;
+      for (size_t i = 0; i < num_threads; ++i) {
+        EvalType const busy =
+          i < times.io_busy_time.size() ? times.io_busy_time[i] : 0.;
+        EvalType const util = epoch_time > 0. ? busy / epoch_time : 0.;
+        util_sum += util;
+        util_min = std::min(util_min, util);
+        util_max = std::max(util_max, util);
+      }
+      util_sum = comm.trainer_allreduce(util_sum);
+      util_min = comm.trainer_allreduce(util_min, El::mpi::MIN);
+      util_max = comm.trainer_allreduce(util_max, El::mpi::MAX);
+      auto const wait_time =
+        comm.trainer_allreduce(times.wait_time, El::mpi::MAX);
+      auto const exchange_time =
+        comm.trainer_allreduce(times.exchange_time, El::mpi::MAX);
+      auto const util_mean =
+        util_sum / (num_threads * comm.get_procs_per_trainer());
+
+      if (os != nullptr) {
+        EvalType const bytes = EvalType(num_samples) * bytes_per_sample;
+        *os << to_string(mode) << "," << comm.get_procs_in_world() << ","
+            << comm.get_procs_per_trainer() << "," << num_threads << ","
+            << (opts.synchronous ? "sync" : "async") << "," << epoch << ","
+            << num_steps << "," << num_samples << "," << epoch_time << ","
+            << num_samples / epoch_time << "," << bytes / epoch_time << ","
+            << wait_time << "," << exchange_time << "," << latency.p50 << ","
+            << latency.p99 << "," << util_mean << "," << util_min << ","
+            << util_max << std::endl;
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  auto& arg_parser = global_argument_parser();
+  construct_all_options();
+  arg_parser.add_option("io bench mode",
+                        {"--io_bench_mode"},
+                        "[IO BENCH] Execution mode whose data reader is run",
+                        "training");
+  arg_parser.add_option("io bench epochs",
+                        {"--io_bench_epochs"},
+                        "[IO BENCH] Epochs per I/O thread count",
+                        2);
+  arg_parser.add_option("io bench threads",
+                        {"--io_bench_threads"},
+                        "[IO BENCH] Comma-separated I/O thread counts, "
+                        "each at most the size of the I/O thread pool "
+                        "(default: the full pool)",
+                        "");
+  arg_parser.add_flag("io bench synchronous",
+                      {"--io_bench_synchronous"},
+                      "[IO BENCH] Fetch every mini-batch synchronously");
+  arg_parser.add_option("io bench output",
+                        {"--io_bench_output"},
+                        "[IO BENCH] CSV file results are appended to",
+                        "lbann_io_bench.csv");
+
+  try {
+    arg_parser.parse(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error during argument parsing:\n\ne.what():\n\n  " << e.what()
+              << "\n\nProcess terminating." << std::endl;
+    std::terminate();
+  }
+
+  world_comm_ptr comm = initialize(argc, argv);
+  const bool master = comm->am_world_master();
+
+  try {
+    if (arg_parser.help_requested() or argc == 1) {
+      if (master)
+        std::cout << arg_parser << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    io_bench_options opts;
+    opts.mode =
+      exec_mode_from_string(arg_parser.get<std::string>("io bench mode"));
+    opts.num_epochs = arg_parser.get<int>("io bench epochs");
+    opts.synchronous = arg_parser.get<bool>("io bench synchronous");
+    opts.thread_counts =
+      parse_thread_counts(arg_parser.get<std::string>("io bench threads"));
+
+    // Split MPI into trainers
+    allocate_trainer_resources(comm.get());
+
+    // Load the prototexts specified on the command line; the model is
+    // never constructed
+    auto pbs = protobuf_utils::load_prototext(master);
+    get_cmdline_overrides(*comm, *pbs[0]);
+    lbann_data::LbannPB& pb = *pbs[0];
+    auto& t = construct_trainer(comm.get(), pb.mutable_trainer(), pb);
+    if (!t.background_io_activity_allowed()) {
+      opts.synchronous = true;
+    }
+
+    // Only the world master writes results
+    std::unique_ptr<std::ofstream> ofs;
+    if (master) {
+      auto const output = arg_parser.get<std::string>("io bench output");
+      bool const write_header = !std::ifstream(output).good();
+      ofs = std::make_unique<std::ofstream>(output, std::ios::app);
+      if (!*ofs) {
+        LBANN_ERROR("could not open \"", output, "\" for writing");
+      }
+      if (write_header) {
+        *ofs << "mode,world_size,procs_per_trainer,io_threads,fetch,epoch,"
+             << "steps,samples,epoch_time_s,samples_per_s,bytes_per_s,"
+             << "wait_time_s,exchange_time_s,fetch_p50_s,fetch_p99_s,"
+             << "io_util_mean,io_util_min,io_util_max\n";
+      }
+    }
+
+    bool found = false;
+    auto& dc = t.get_data_coordinator();
+#define PROTO(T)                                                               \
+  if (auto* bdc = dynamic_cast<buffered_data_coordinator<T>*>(&dc)) {          \
+    run_io_benchmark(*comm, t, *bdc, opts, ofs.get());                         \
+    found = true;                                                              \
+  }
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+    if (!found) {
+      LBANN_ERROR("trainer does not use a buffered data coordinator");
+    }
+  }
+  catch (lbann::exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  }
+  catch (std::exception& e) {
+    El::ReportException(e);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
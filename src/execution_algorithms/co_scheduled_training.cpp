@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/co_scheduled_training.hpp"
+#include "lbann/callbacks/callback.hpp"
+#include "lbann/data_ingestion/data_coordinator.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+co_scheduled_training::co_scheduled_training(
+  std::vector<std::unique_ptr<model>> models,
+  std::vector<El::Grid*> const& grids,
+  size_t max_mini_batch_size,
+  size_t num_streams)
+  : m_models{std::move(models)}
+{
+  if (m_models.empty()) {
+    LBANN_ERROR("co-scheduled training requires at least one model");
+  }
+  for (const auto& m : m_models) {
+    if (m == nullptr) {
+      LBANN_ERROR("co-scheduled training got a null model");
+    }
+  }
+#ifdef LBANN_HAS_GPU
+  // Models on the same stream share its DNN library workspace
+  if (num_streams == 0 || num_streams > m_models.size()) {
+    num_streams = m_models.size();
+  }
+  for (size_t i = 0; i < num_streams; ++i) {
+    m_streams.push_back(El::CreateNewSyncInfo<El::Device::GPU>());
+  }
+  m_input_events.resize(m_models.size());
+  for (size_t i = 0; i < m_models.size(); ++i) {
+    m_models[i]->set_forward_stream(m_streams[i % num_streams]);
+  }
+#else
+  (void)num_streams;
+#endif // LBANN_HAS_GPU
+  m_contexts.reserve(m_models.size());
+  for (auto& m : m_models) {
+    m->setup(max_mini_batch_size, grids, true);
+    m_contexts.emplace_back(execution_mode::training);
+  }
+}
+
+co_scheduled_training::~co_scheduled_training()
+{
+#ifdef LBANN_HAS_GPU
+  // The models may still free memory on the streams
+  for (const auto& si : m_streams) {
+    El::Synchronize(si);
+  }
+  m_models.clear();
+  for (auto& si : m_streams) {
+    El::DestroySyncInfo(si);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void co_scheduled_training::train(data_coordinator& dc,
+                                  SGDTerminationCriteria const& term)
+{
+  const size_t num_models = m_models.size();
+  std::vector<bool> active(num_models);
+  auto update_active = [&]() {
+    for (size_t i = 0; i < num_models; ++i) {
+      active[i] = active[i] && !term(m_contexts[i]);
+    }
+    return std::find(active.begin(), active.end(), true) != active.end();
+  };
+
+  for (size_t i = 0; i < num_models; ++i) {
+    auto& m = *m_models[i];
+    auto& c = m_contexts[i];
+    c.set_execution_mode(execution_mode::training);
+    m.reset_mode(c, execution_mode::training);
+    if (m.is_amp_enabled()) {
+      m.get_objective_function()->set_amp_scale(m.get_amp_scale_factor());
+    }
+    for (const auto& cb : m.get_callbacks()) {
+      cb->on_train_begin(&m);
+    }
+    active[i] = true;
+  }
+
+  // The models step together, so the first one's context stands for
+  // the position in the data set
+  dc.reset_mode(m_contexts.front());
+  while (update_active()) {
+    const std::vector<bool> in_epoch = active;
+    for (size_t i = 0; i < num_models; ++i) {
+      if (!in_epoch[i]) {
+        continue;
+      }
+      auto& m = *m_models[i];
+      m.reset_mode(m_contexts[i], execution_mode::training);
+      m.reset_epoch_statistics(execution_mode::training);
+      m_contexts[i].get_step_timer().reset_statistics();
+      for (const auto& cb : m.get_callbacks()) {
+        cb->on_epoch_begin(&m);
+      }
+    }
+    dc.reset_mode(m_contexts.front());
+
+    bool end_of_epoch = false;
+    while (!end_of_epoch && update_active()) {
+      end_of_epoch = train_step(dc, active);
+    }
+
+    // Models that finished within the epoch still close it
+    for (size_t i = 0; i < num_models; ++i) {
+      if (!in_epoch[i]) {
+        continue;
+      }
+      auto& m = *m_models[i];
+      m_contexts[i].inc_epoch();
+      m.flush_accumulated_metrics(execution_mode::training);
+      for (const auto& cb : m.get_callbacks()) {
+        cb->on_epoch_end(&m);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_models; ++i) {
+    auto& m = *m_models[i];
+    m.reset_mode(m_contexts[i], execution_mode::training);
+    for (const auto& cb : m.get_callbacks()) {
+      cb->on_train_end(&m);
+    }
+  }
+}
+
+bool co_scheduled_training::train_step(data_coordinator& dc,
+                                       std::vector<bool> const& active)
+{
+  const size_t num_models = m_models.size();
+  for (size_t i = 0; i < num_models; ++i) {
+    if (!active[i]) {
+      continue;
+    }
+    auto& m = *m_models[i];
+    auto& c = m_contexts[i];
+    c.get_step_timer().start();
+    m.reset_mode(c, execution_mode::training);
+    for (const auto& cb : m.get_callbacks()) {
+      if (c.get_step() % cb->get_batch_interval() == 0) {
+        cb->on_batch_begin(&m);
+      }
+    }
+  }
+
+  // The previous mini-batch must be read before it is overwritten
+#ifdef LBANN_HAS_GPU
+  for (auto& event : m_input_events) {
+    event.synchronize();
+  }
+#endif // LBANN_HAS_GPU
+  dc.fetch_active_batch_synchronous(execution_mode::training);
+  const El::Int mini_batch_size =
+    dc.get_current_mini_batch_size(execution_mode::training);
+
+  // Launch every forward pass before waiting on any of them
+  for (size_t i = 0; i < num_models; ++i) {
+    if (!active[i]) {
+      continue;
+    }
+    auto& m = *m_models[i];
+    m.clear_gradients();
+    m.set_current_mini_batch_size(mini_batch_size);
+    m.forward_prop(execution_mode::training);
+#ifdef LBANN_HAS_GPU
+    m_input_events[i].record(m_streams[i % m_streams.size()].Stream());
+#endif // LBANN_HAS_GPU
+  }
+
+  // Each backward pass only waits for its own model's forward pass
+  for (size_t i = 0; i < num_models; ++i) {
+    if (!active[i]) {
+      continue;
+    }
+    auto& m = *m_models[i];
+    auto* const obj = m.get_objective_function();
+    m.join_layer_streams();
+    obj->start_evaluation(execution_mode::training, mini_batch_size);
+    obj->differentiate();
+    m.backward_prop();
+    obj->compute_weight_regularization();
+  }
+
+  const bool finished = dc.ready_for_next_fetch(execution_mode::training);
+
+  for (size_t i = 0; i < num_models; ++i) {
+    if (!active[i]) {
+      continue;
+    }
+    auto& m = *m_models[i];
+    auto& c = m_contexts[i];
+    m.get_objective_function()->finish_evaluation(execution_mode::training,
+                                                  mini_batch_size);
+    m.evaluate_metrics(execution_mode::training, mini_batch_size);
+    m.update_weights();
+    m.update_layers();
+    c.inc_step();
+    for (const auto& cb : m.get_callbacks()) {
+      if (c.get_step() % cb->get_batch_interval() == 0) {
+        cb->on_batch_end(&m);
+      }
+    }
+    c.get_step_timer().stop();
+  }
+  return finished;
+}
+
+} // namespace lbann
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/ensemble_inference.hpp"
+#include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/layers/io/input_layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+namespace {
+
+/** @brief The model's softmax output layer */
+const data_type_layer<DataType>& get_softmax_layer(const model& m)
+{
+  for (const auto* l : m.get_layers()) {
+    if (l->get_type() == "softmax") {
+      return dynamic_cast<const data_type_layer<DataType>&>(*l);
+    }
+  }
+  LBANN_ERROR("model \"", m.get_name(), "\" has no softmax layer");
+}
+
+/** @brief Index of the largest entry in column @c col */
+int argmax(El::Matrix<DataType, El::Device::CPU> const& x, El::Int col)
+{
+  int pred = 0;
+  for (El::Int row = 1; row < x.Height(); ++row) {
+    if (x(row, col) > x(pred, col)) {
+      pred = row;
+    }
+  }
+  return pred;
+}
+
+} // namespace
+
+ensemble_inference::ensemble_inference(
+  std::vector<std::unique_ptr<model>> models,
+  std::vector<El::Grid*> const& grids,
+  size_t num_streams)
+  : m_models{std::move(models)}
+{
+  if (m_models.empty()) {
+    LBANN_ERROR("ensemble inference requires at least one model");
+  }
+  for (const auto& m : m_models) {
+    if (m == nullptr) {
+      LBANN_ERROR("ensemble inference got a null model");
+    }
+  }
+#ifdef LBANN_HAS_GPU
+  // Models on the same stream share its DNN library workspace
+  if (num_streams == 0 || num_streams > m_models.size()) {
+    num_streams = m_models.size();
+  }
+  for (size_t i = 0; i < num_streams; ++i) {
+    m_streams.push_back(El::CreateNewSyncInfo<El::Device::GPU>());
+  }
+  for (size_t i = 0; i < m_models.size(); ++i) {
+    auto& m = *m_models[i];
+    m.set_forward_stream(m_streams[i % num_streams]);
+    m.setup(m.get_max_mini_batch_size(), grids, true);
+  }
+#else
+  (void)grids;
+  (void)num_streams;
+#endif // LBANN_HAS_GPU
+}
+
+ensemble_inference::~ensemble_inference()
+{
+#ifdef LBANN_HAS_GPU
+  // The models may still free memory on the streams
+  for (const auto& si : m_streams) {
+    El::Synchronize(si);
+  }
+  m_models.clear();
+  for (auto& si : m_streams) {
+    El::DestroySyncInfo(si);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+El::Matrix<int, El::Device::CPU>
+ensemble_inference::infer(El::Matrix<DataType, El::Device::CPU> const& samples,
+                          size_t mbs,
+                          El::Matrix<int, El::Device::CPU>* model_labels)
+{
+  const size_t num_models = m_models.size();
+  const El::Int num_samples = samples.Width();
+  for (const auto& m : m_models) {
+    if (mbs == 0 || mbs > m->get_max_mini_batch_size()) {
+      LBANN_ERROR("mini-batch size ",
+                  mbs,
+                  " is not in [1, ",
+                  m->get_max_mini_batch_size(),
+                  "] for model \"",
+                  m->get_name(),
+                  "\"");
+    }
+  }
+
+  // As in batch_functional_inference_algorithm, the layers need an SGD
+  // execution context to find the mini-batch size
+  std::vector<SGDExecutionContext> contexts;
+  contexts.reserve(num_models);
+  for (auto& m : m_models) {
+    contexts.emplace_back(execution_mode::inference);
+    m->reset_mode(contexts.back(), execution_mode::inference);
+  }
+
+  El::Matrix<int, El::Device::CPU> labels(num_samples, 1);
+  if (model_labels != nullptr) {
+    model_labels->Resize(num_samples, num_models);
+  }
+  auto& comm = *m_models.front()->get_comm();
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+    dist_samples(comm.get_trainer_grid());
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+    outputs(comm.get_trainer_grid());
+  El::Matrix<DataType, El::Device::CPU> mean_outputs;
+  for (El::Int begin = 0; begin < num_samples;
+       begin += static_cast<El::Int>(mbs)) {
+    const El::Int end =
+      std::min(begin + static_cast<El::Int>(mbs), num_samples);
+    const El::Int batch_size = end - begin;
+    dist_samples.Resize(samples.Height(), batch_size);
+    El::Copy(samples(El::ALL, El::IR(begin, end)), dist_samples.Matrix());
+
+    // Launch every forward pass before waiting on any of them
+    for (auto& m : m_models) {
+      m->set_current_mini_batch_size(batch_size);
+      for (int i = 0; i < m->get_num_layers(); ++i) {
+        auto& l = m->get_layer(i);
+        if (l.get_type() == "input") {
+          auto& il = dynamic_cast<input_layer<DataType>&>(l);
+          il.set_samples(dist_samples);
+        }
+      }
+      m->forward_prop(execution_mode::inference);
+    }
+    for (auto& m : m_models) {
+      m->join_layer_streams();
+    }
+
+    // The largest entry of the summed outputs is that of their mean
+    for (size_t j = 0; j < num_models; ++j) {
+      El::Copy(get_softmax_layer(*m_models[j]).get_activations(), outputs);
+      const auto& local_outputs = outputs.LockedMatrix();
+      if (j == 0) {
+        El::Copy(local_outputs, mean_outputs);
+      }
+      else if (local_outputs.Height() != mean_outputs.Height()) {
+        LBANN_ERROR("model \"",
+                    m_models[j]->get_name(),
+                    "\" predicts ",
+                    local_outputs.Height(),
+                    " categories, but model \"",
+                    m_models.front()->get_name(),
+                    "\" predicts ",
+                    mean_outputs.Height());
+      }
+      else {
+        El::Axpy(DataType(1), local_outputs, mean_outputs);
+      }
+      if (model_labels != nullptr) {
+        for (El::Int col = 0; col < batch_size; ++col) {
+          (*model_labels)(begin + col, j) = argmax(local_outputs, col);
+        }
+      }
+    }
+    for (El::Int col = 0; col < batch_size; ++col) {
+      labels(begin + col, 0) = argmax(mean_outputs, col);
+    }
+  }
+  return labels;
+}
+
+} // namespace lbann
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "lbann/execution_algorithms/factory.hpp"
 #include "lbann/execution_algorithms/kfac.hpp"
+#include "lbann/execution_algorithms/local_sgd.hpp"
 #include "lbann/execution_algorithms/ltfb.hpp"
 #include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
 #include "lbann/utils/make_abstract.hpp"
@@ -41,6 +42,7 @@ lbann::TrainingAlgorithmFactory build_default_factory()
   lbann::TrainingAlgorithmFactory fact;
   fact.register_builder("SGD", lbann::make<lbann::SGDTrainingAlgorithm>);
   fact.register_builder("LTFB", lbann::make<lbann::LTFB>);
+  fact.register_builder("LocalSGD", lbann::make<lbann::LocalSGD>);
   fact.register_builder("KFAC", lbann::make<lbann::KFAC>);
   return fact;
 }
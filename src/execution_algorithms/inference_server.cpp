@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/inference_server.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/layers/io/input_layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace lbann {
+
+inference_server::inference_server(observer_ptr<model> model,
+                                   size_t sample_size,
+                                   size_t max_batch_size,
+                                   std::chrono::microseconds max_latency)
+  : m_model{model},
+    m_sample_size{sample_size},
+    m_max_batch_size{max_batch_size},
+    m_max_latency{max_latency}
+{
+  if (m_model == nullptr) {
+    LBANN_ERROR("inference server requires a model");
+  }
+  if (m_sample_size == 0 || m_max_batch_size == 0) {
+    LBANN_ERROR("sample size and max mini-batch size must be larger than 0");
+  }
+}
+
+std::future<int> inference_server::submit(std::vector<DataType> sample)
+{
+  if (!m_model->get_comm()->am_trainer_master()) {
+    LBANN_ERROR("inference requests must be submitted on the trainer master");
+  }
+  if (sample.size() != m_sample_size) {
+    LBANN_ERROR("expected a sample with ",
+                m_sample_size,
+                " entries, but got ",
+                sample.size());
+  }
+  request req;
+  req.sample = std::move(sample);
+  req.arrival = clock_type::now();
+  auto result = req.result.get_future();
+  {
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    if (m_shutdown) {
+      LBANN_ERROR("inference server has been shut down");
+    }
+    m_queue.push_back(std::move(req));
+  }
+  m_queue_cv.notify_one();
+  return result;
+}
+
+void inference_server::shutdown()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    m_shutdown = true;
+  }
+  m_queue_cv.notify_all();
+}
+
+bool inference_server::collect_batch_(std::vector<request>& batch)
+{
+  std::unique_lock<std::mutex> lock(m_queue_mutex);
+  m_queue_cv.wait(lock, [this] { return m_shutdown || !m_queue.empty(); });
+  if (m_queue.empty()) {
+    return false;
+  }
+
+  // Give the mini-batch until the oldest request's deadline to fill
+  if (!m_shutdown && m_queue.size() < m_max_batch_size) {
+    const auto deadline = m_queue.front().arrival + m_max_latency;
+    m_queue_cv.wait_until(lock, deadline, [this] {
+      return m_shutdown || m_queue.size() >= m_max_batch_size;
+    });
+  }
+
+  const size_t batch_size = std::min(m_queue.size(), m_max_batch_size);
+  batch.clear();
+  batch.reserve(batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    batch.push_back(std::move(m_queue.front()));
+    m_queue.pop_front();
+  }
+  return true;
+}
+
+void inference_server::serve()
+{
+  auto& comm = *m_model->get_comm();
+  const bool is_master = comm.am_trainer_master();
+
+  // As in batch_functional_inference_algorithm, the layers need an SGD
+  // execution context to find the mini-batch size
+  auto c = SGDExecutionContext(execution_mode::inference);
+  m_model->reset_mode(c, execution_mode::inference);
+
+  std::vector<request> batch;
+  std::vector<DataType> buffer;
+  std::vector<int> labels;
+  while (true) {
+    // The trainer master forms the mini-batch and shares it; an empty
+    // mini-batch means the server has shut down
+    int batch_size = 0;
+    if (is_master) {
+      batch_size = collect_batch_(batch) ? static_cast<int>(batch.size()) : 0;
+      buffer.resize(batch_size * m_sample_size);
+      for (int i = 0; i < batch_size; ++i) {
+        std::copy(batch[i].sample.begin(),
+                  batch[i].sample.end(),
+                  buffer.begin() + i * m_sample_size);
+      }
+    }
+    comm.trainer_broadcast(0, batch_size);
+    if (batch_size == 0) {
+      break;
+    }
+    buffer.resize(batch_size * m_sample_size);
+    comm.trainer_broadcast(0, buffer.data(), static_cast<int>(buffer.size()));
+
+    El::Matrix<DataType, El::Device::CPU> samples;
+    samples.LockedAttach(m_sample_size,
+                         batch_size,
+                         buffer.data(),
+                         m_sample_size);
+    try {
+      run_batch_(samples, labels);
+    }
+    catch (...) {
+      for (auto& req : batch) {
+        req.result.set_exception(std::current_exception());
+      }
+      throw;
+    }
+
+    if (is_master) {
+      const auto now = clock_type::now();
+      {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        for (const auto& req : batch) {
+          m_latency.insert(
+            std::chrono::duration<double>(now - req.arrival).count());
+        }
+        ++m_num_batches;
+      }
+      for (int i = 0; i < batch_size; ++i) {
+        batch[i].result.set_value(labels[i]);
+      }
+      batch.clear();
+    }
+  }
+
+  if (is_master) {
+    print_statistics(std::cout);
+  }
+}
+
+void inference_server::run_batch_(
+  El::Matrix<DataType, El::Device::CPU> const& samples,
+  std::vector<int>& labels)
+{
+  auto& m = *m_model;
+  const El::Int batch_size = samples.Width();
+  m.set_current_mini_batch_size(batch_size);
+
+  // Insert samples into the input layer
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+    dist_samples(m.get_comm()->get_trainer_grid());
+  dist_samples.Resize(samples.Height(), batch_size);
+  El::Copy(samples, dist_samples.Matrix());
+  for (int i = 0; i < m.get_num_layers(); ++i) {
+    auto& l = m.get_layer(i);
+    if (l.get_type() == "input") {
+      auto& il = dynamic_cast<input_layer<DataType>&>(l);
+      il.set_samples(dist_samples);
+    }
+  }
+  m.forward_prop(execution_mode::inference);
+
+  // Each sample's prediction is the largest entry in its softmax column
+  labels.assign(batch_size, 0);
+  for (const auto* l : m.get_layers()) {
+    if (l->get_type() == "softmax") {
+      const auto& dtl = dynamic_cast<const data_type_layer<DataType>&>(*l);
+      El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+        outputs(dtl.get_activations().Grid());
+      El::Copy(dtl.get_activations(), outputs);
+      const auto& local_outputs = outputs.LockedMatrix();
+      for (El::Int col = 0; col < batch_size; ++col) {
+        int pred = 0;
+        for (El::Int row = 1; row < local_outputs.Height(); ++row) {
+          if (local_outputs(row, col) > local_outputs(pred, col)) {
+            pred = row;
+          }
+        }
+        labels[col] = pred;
+      }
+    }
+  }
+}
+
+inference_server::statistics inference_server::get_statistics() const
+{
+  std::lock_guard<std::mutex> lock(m_stats_mutex);
+  statistics stats;
+  stats.num_requests = m_latency.samples();
+  stats.num_batches = m_num_batches;
+  stats.latency_p50 = m_latency.percentile(0.5);
+  stats.latency_p99 = m_latency.percentile(0.99);
+  return stats;
+}
+
+void inference_server::print_statistics(std::ostream& os) const
+{
+  const auto stats = get_statistics();
+  const double mean_batch_size =
+    stats.num_batches > 0
+      ? static_cast<double>(stats.num_requests) / stats.num_batches
+      : 0.;
+  std::ostringstream ss;
+  ss << "inference server: " << stats.num_requests << " requests in "
+     << stats.num_batches << " mini-batches (mean size " << std::fixed
+     << std::setprecision(1) << mean_batch_size << "), latency p50 "
+     << std::setprecision(3) << stats.latency_p50 * 1e3 << " ms, p99 "
+     << stats.latency_p99 * 1e3 << " ms\n";
+  os << ss.str();
+}
+
+} // namespace lbann
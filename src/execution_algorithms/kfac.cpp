@@ -35,6 +35,7 @@
 #include "lbann/execution_algorithms/kfac/kfac_block_channelwise_fc.hpp"
 #include "lbann/execution_algorithms/kfac/kfac_block_fc_conv.hpp"
 #include "lbann/execution_algorithms/kfac/kfac_block_gru.hpp"
+#include "lbann/execution_algorithms/kfac/kfac_timing.hpp"
 #include "lbann/execution_algorithms/kfac/kfac_util.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/layers/learning/channelwise_fully_connected.hpp"
@@ -48,11 +49,35 @@
 
 #include "lbann/proto/training_algorithm.pb.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <limits>
+#include <numeric>
 
 namespace lbann {
 
+namespace {
+
+/** @brief Add the time between two clock readings to a K-FAC time
+ *  counter, in microseconds, and record it as a phase of the model's
+ *  step. */
+void add_phase_time(model& m,
+                    int& counter,
+                    char const* phase,
+                    std::chrono::high_resolution_clock::time_point start,
+                    std::chrono::high_resolution_clock::time_point stop)
+{
+  counter +=
+    std::chrono::duration_cast<std::chrono::microseconds>(stop - start)
+      .count();
+  m.get_kfac_phase_timer().record(
+    phase,
+    std::chrono::duration<double>(stop - start).count());
+}
+
+} // namespace
+
 /// @todo Initialize properly
 KFAC::KFAC(std::string name,
            std::unique_ptr<TermCriteriaType> stop,
@@ -70,6 +95,7 @@ KFAC::KFAC(std::string name,
            std::vector<size_t> update_intervals,
            size_t update_interval_steps,
            kfac::kfac_inverse_strategy inverse_strategy,
+           size_t inverse_rebalance_interval,
            std::vector<std::string> disable_layers,
            double learning_rate_factor,
            double learning_rate_factor_gru,
@@ -77,7 +103,11 @@ KFAC::KFAC(std::string name,
            bool distribute_precondition_compute,
            bool use_eigen_decomposition,
            bool enable_copy_errors,
-           bool enable_copy_activations)
+           bool enable_copy_activations,
+           bool staggered_inverse,
+           bool half_precision_communication,
+           size_t inverse_rank,
+           bool batched_inverse)
 
   : TrainingAlgorithm{std::move(name)},
     m_stopping_criteria{std::move(stop)},
@@ -94,6 +124,7 @@ KFAC::KFAC(std::string name,
     m_update_intervals{std::move(update_intervals)},
     m_update_interval_steps{update_interval_steps},
     m_inverse_strategy{inverse_strategy},
+    m_inverse_rebalance_interval{inverse_rebalance_interval},
     m_disable_layers{std::move(disable_layers)},
     m_learning_rate_factor{learning_rate_factor},
     m_learning_rate_factor_gru{learning_rate_factor_gru},
@@ -102,6 +133,10 @@ KFAC::KFAC(std::string name,
     m_enable_copy_errors{enable_copy_errors},
     m_enable_copy_activations{enable_copy_activations},
     m_use_eigen_decomposition{use_eigen_decomposition},
+    m_staggered_inverse{staggered_inverse},
+    m_half_precision_communication{half_precision_communication},
+    m_inverse_rank{inverse_rank},
+    m_batched_inverse{batched_inverse},
     m_use_KFAC_epoch{std::move(kfac_use_interval)}
 {}
 
@@ -205,6 +240,7 @@ void KFAC::train(ExeContextType& kfac_context,
         // regressions.
         // model.reconcile_weight_values();
 
+        model.flush_accumulated_metrics(execution_mode::training);
         do_epoch_end_cbs(model);
 
         // Evaluate on validation set
@@ -273,6 +309,7 @@ bool KFAC::train_mini_batch(ExeContextType& kfac_context,
 
   model.reset_mode(sgd_context, execution_mode::training);
   dc.reset_mode(sgd_context);
+  model.get_kfac_phase_timer().begin_step();
   do_batch_begin_cbs(model);
 
   bool finished = false;
@@ -330,10 +367,11 @@ bool KFAC::train_mini_batch(ExeContextType& kfac_context,
         }
 #endif // LBANN_HAS_GPU
         auto t_stop = std::chrono::high_resolution_clock::now();
-        m_time_forward_pass +=
-          std::chrono::duration_cast<std::chrono::microseconds>(t_stop -
-                                                                t_start)
-            .count();
+        add_phase_time(model,
+                       m_time_forward_pass,
+                       "forward_pass",
+                       t_start,
+                       t_stop);
       }
 
       if (compute_inverse) {
@@ -370,10 +408,11 @@ bool KFAC::train_mini_batch(ExeContextType& kfac_context,
         }
 #endif // LBANN_HAS_GPU
         auto t_stop = std::chrono::high_resolution_clock::now();
-        m_time_backward_pass +=
-          std::chrono::duration_cast<std::chrono::microseconds>(t_stop -
-                                                                t_start)
-            .count();
+        add_phase_time(model,
+                       m_time_backward_pass,
+                       "backward_pass",
+                       t_start,
+                       t_stop);
       }
       else {
         finished = dc.ready_for_next_fetch(execution_mode::training);
@@ -401,9 +440,7 @@ bool KFAC::train_mini_batch(ExeContextType& kfac_context,
         }
 #endif // LBANN_HAS_GPU
         auto t_stop = std::chrono::high_resolution_clock::now();
-        m_time_kfac += std::chrono::duration_cast<std::chrono::microseconds>(
-                         t_stop - t_start)
-                         .count();
+        add_phase_time(model, m_time_kfac, "kfac", t_start, t_stop);
       }
 
       else if (comm.get_grid_type() == GridType::NO_GRID or
@@ -440,10 +477,11 @@ bool KFAC::train_mini_batch(ExeContextType& kfac_context,
             allgather_precondition_gradient(comm, kfac_context);
         }
         auto t_stop = std::chrono::high_resolution_clock::now();
-        m_time_span_precond_comm +=
-          std::chrono::duration_cast<std::chrono::microseconds>(t_stop -
-                                                                t_start)
-            .count();
+        add_phase_time(model,
+                       m_time_span_precond_comm,
+                       "precond_comm",
+                       t_start,
+                       t_stop);
       }
 
       if (comm.get_grid_type() == GridType::PRIMARY_GRID or
@@ -573,6 +611,88 @@ void KFAC::allgather_precondition_gradient(lbann_comm& comm,
                          allgather_mode);
 }
 
+void KFAC::balance_inverse_assignment(lbann_comm& comm,
+                                      ExeContextType& context,
+                                      bool use_measured_times)
+{
+  const auto& blocks = context.m_blocks;
+  const size_t num_blocks = blocks.size();
+  std::vector<double> costs(num_blocks, 0.);
+  if (use_measured_times) {
+    // Each block is only timed by the process that inverts it
+    m_inverse_times.resize(num_blocks, 0.);
+    comm.trainer_allreduce(m_inverse_times.data(),
+                           num_blocks,
+                           costs.data());
+  }
+  else {
+    for (size_t i = 0; i < num_blocks; ++i)
+      costs[i] = blocks[i]->get_inverse_cost(&comm);
+  }
+
+  std::vector<size_t> ranks;
+  const size_t num_procs = comm.get_procs_per_trainer();
+  const auto loads =
+    kfac::balance_inverse_assignment(costs, num_procs, ranks);
+  for (size_t i = 0; i < num_blocks; ++i)
+    blocks[i]->set_inverse_proc_rank(ranks[i]);
+  m_inverse_times.assign(num_blocks, 0.);
+
+  if (comm.am_trainer_master()) {
+    std::vector<size_t> counts(loads.size(), 0);
+    for (const auto& rank : ranks)
+      ++counts[rank];
+    const double max_load = *std::max_element(loads.cbegin(), loads.cend());
+    const double mean_load =
+      std::accumulate(loads.cbegin(), loads.cend(), 0.) / loads.size();
+    std::cout << "K-FAC inverse assignment ("
+              << (use_measured_times ? "measured seconds" : "estimated cost")
+              << "):" << std::endl;
+    for (size_t rank = 0; rank < loads.size(); ++rank)
+      std::cout << "  rank " << rank << ": load=" << loads[rank]
+                << ", blocks=" << counts[rank] << std::endl;
+    std::cout << "  max/mean load: "
+              << (mean_load > 0. ? max_load / mean_load : 1.) << std::endl;
+  }
+}
+
+std::vector<bool>
+KFAC::get_inverse_schedule(lbann_comm& comm,
+                           ExeContextType& context,
+                           size_t step,
+                           bool is_kronecker_update_required)
+{
+  const auto& blocks = context.m_blocks;
+  const size_t rank = comm.get_rank_in_trainer();
+  const size_t interval = context.m_update_interval;
+  std::vector<bool> schedule(blocks.size(), false);
+
+  // Every block needs an inverse before the first preconditioning
+  if (!m_staggered_inverse || !m_has_kronecker_inverse || interval <= 1) {
+    if (is_kronecker_update_required) {
+      for (size_t i = 0; i < blocks.size(); ++i)
+        schedule[i] = (blocks[i]->get_inverse_proc_rank() == rank);
+    }
+    return schedule;
+  }
+
+  // Split local blocks into one group per step of the interval
+  std::vector<size_t> local_ids;
+  std::vector<double> costs;
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    if (blocks[i]->get_inverse_proc_rank() == rank) {
+      local_ids.push_back(i);
+      costs.push_back(blocks[i]->get_inverse_cost(&comm));
+    }
+  }
+  std::vector<size_t> slots;
+  kfac::balance_inverse_assignment(costs, interval, slots);
+  const size_t slot = step % interval;
+  for (size_t j = 0; j < local_ids.size(); ++j)
+    schedule[local_ids[j]] = (slots[j] == slot);
+  return schedule;
+}
+
 void KFAC::sync_weights_model(model& model, lbann_comm* comm)
 {
   // Does not support Model parallel only Data Parallel
@@ -1055,6 +1175,7 @@ void send_recv_precomputed_gradients(
 }
 
 void KFAC::start_send_recv_inverse_matrices(ExeContextType& context,
+                                            model& model,
                                             lbann_comm* comm)
 {
 
@@ -1125,10 +1246,11 @@ void KFAC::start_send_recv_inverse_matrices(ExeContextType& context,
                                      backend_comm);
         }
         auto t_stop = std::chrono::high_resolution_clock::now();
-        m_time_span_inverse_send_recv +=
-          std::chrono::duration_cast<std::chrono::microseconds>(t_stop -
-                                                                t_start)
-            .count();
+        add_phase_time(model,
+                       m_time_span_inverse_send_recv,
+                       "inverse_send_recv",
+                       t_start,
+                       t_stop);
       }
     }
   }
@@ -1157,9 +1279,11 @@ void KFAC::start_send_recv_inverse_matrices(ExeContextType& context,
                                  backend_comm);
     }
     auto t_stop = std::chrono::high_resolution_clock::now();
-    m_time_span_inverse_send_recv +=
-      std::chrono::duration_cast<std::chrono::microseconds>(t_stop - t_start)
-        .count();
+    add_phase_time(model,
+                   m_time_span_inverse_send_recv,
+                   "inverse_send_recv",
+                   t_start,
+                   t_stop);
   }
 }
 
@@ -1336,6 +1460,8 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
                                                         output_size);
       }
       else if (is_gru) {
+        // K-FAC reads gate values from the cuDNN reserve space
+        l_gru->set_fused_kernels_enabled(false);
         output_size =
           broadcast_variable_grids(l_gru->get_activations().Height(), &comm);
         block =
@@ -1362,6 +1488,7 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
           output_size);
       }
 
+      block->set_inverse_rank(m_inverse_rank);
       context.m_blocks.push_back(std::move(block));
       if (m_inverse_strategy != kfac::kfac_inverse_strategy::ROOT)
         proc_rank = (proc_rank + 1) % num_procs;
@@ -1369,6 +1496,14 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
       prof_region_end(("kfac-setup/" + l->get_name()).c_str(), prof_sync);
     }
 
+    if (m_inverse_strategy == kfac::kfac_inverse_strategy::BALANCED) {
+      if (comm.get_grid_type() == GridType::NO_GRID)
+        balance_inverse_assignment(comm, context, false);
+      else if (comm.am_trainer_master())
+        LBANN_WARNING("K-FAC balanced inverse strategy is not supported "
+                      "with sub-grid parallelism, using round-robin");
+    }
+
     if (comm.am_trainer_master()) {
       for (const auto& block : context.m_blocks)
         std::cout << "K-FAC setup: " << block->get_info() << std::endl;
@@ -1385,9 +1520,11 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
     }
   }
   auto t_stop_f = std::chrono::high_resolution_clock::now();
-  m_time_span_forward_comm_end +=
-    std::chrono::duration_cast<std::chrono::microseconds>(t_stop_f - t_start_f)
-      .count();
+  add_phase_time(model,
+                 m_time_span_forward_comm_end,
+                 "forward_comm_end",
+                 t_start_f,
+                 t_stop_f);
 
   for (auto& block : context.m_blocks)
     block->on_forward_prop_end(&comm);
@@ -1396,11 +1533,13 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
       (comm.get_grid_type() == GridType::PRIMARY_GRID or
        comm.get_grid_type() == GridType::SECONDARY_GRID)) {
     auto t_start = std::chrono::high_resolution_clock::now();
-    start_send_recv_inverse_matrices(context, &comm);
+    start_send_recv_inverse_matrices(context, model, &comm);
     auto t_stop = std::chrono::high_resolution_clock::now();
-    m_time_span_inverse_comm +=
-      std::chrono::duration_cast<std::chrono::microseconds>(t_stop - t_start)
-        .count();
+    add_phase_time(model,
+                   m_time_span_inverse_comm,
+                   "inverse_comm",
+                   t_start,
+                   t_stop);
 
     m_has_kronecker_inverse = true;
   }
@@ -1411,9 +1550,11 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
     }
   }
   auto t_stop_b = std::chrono::high_resolution_clock::now();
-  m_time_span_backward_comm_end +=
-    std::chrono::duration_cast<std::chrono::microseconds>(t_stop_b - t_start_b)
-      .count();
+  add_phase_time(model,
+                 m_time_span_backward_comm_end,
+                 "backward_comm_end",
+                 t_start_b,
+                 t_stop_b);
 
 #ifdef LBANN_HAS_GPU
   hydrogen::gpu::SynchronizeDevice();
@@ -1427,9 +1568,11 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
     block->start_communication_forward_end(&comm);
   }
   auto t_stop = std::chrono::high_resolution_clock::now();
-  m_time_span_forward_comm +=
-    std::chrono::duration_cast<std::chrono::microseconds>(t_stop - t_start)
-      .count();
+  add_phase_time(model,
+                 m_time_span_forward_comm,
+                 "forward_comm",
+                 t_start,
+                 t_stop);
 }
 
 void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
@@ -1485,9 +1628,11 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
 
     end_send_recv_inverse_matrices(context, &comm);
     auto t_stop = std::chrono::high_resolution_clock::now();
-    m_time_span_inverse_comm +=
-      std::chrono::duration_cast<std::chrono::microseconds>(t_stop - t_start)
-        .count();
+    add_phase_time(model,
+                   m_time_span_inverse_comm,
+                   "inverse_comm",
+                   t_start,
+                   t_stop);
   }
 
   // List up layers to be updated
@@ -1502,9 +1647,11 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
       block->end_communication_forward_end(&comm);
   }
   auto t_stop_f = std::chrono::high_resolution_clock::now();
-  m_time_span_forward_comm_end +=
-    std::chrono::duration_cast<std::chrono::microseconds>(t_stop_f - t_start_f)
-      .count();
+  add_phase_time(model,
+                 m_time_span_forward_comm_end,
+                 "forward_comm_end",
+                 t_start_f,
+                 t_stop_f);
 
 #ifdef LBANN_HAS_GPU
   hydrogen::gpu::SynchronizeDevice();
@@ -1518,9 +1665,11 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
       block->end_communication_backward_end(&comm);
   }
   auto t_stop = std::chrono::high_resolution_clock::now();
-  m_time_span_backward_comm +=
-    std::chrono::duration_cast<std::chrono::microseconds>(t_stop - t_start)
-      .count();
+  add_phase_time(model,
+                 m_time_span_backward_comm,
+                 "backward_comm",
+                 t_start,
+                 t_stop);
 
   if (comm.get_grid_type() == GridType::SECONDARY_GRID or
       comm.get_grid_type() == GridType::NO_GRID) {
@@ -1532,6 +1681,15 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
     const bool is_kronecker_update_required =
       ((num_steps % context.m_update_interval) == 0 ||
        !m_has_kronecker_inverse);
+    const bool is_rebalance_enabled =
+      (m_inverse_strategy == kfac::kfac_inverse_strategy::BALANCED &&
+       m_inverse_rebalance_interval > 0 &&
+       comm.get_grid_type() == GridType::NO_GRID);
+    if (is_rebalance_enabled && is_kronecker_update_required &&
+        num_steps >= m_last_rebalance_step + m_inverse_rebalance_interval) {
+      balance_inverse_assignment(comm, context, true);
+      m_last_rebalance_step = num_steps;
+    }
     if (is_kronecker_update_required) {
       prof_region_begin("kfac-update", prof_color, prof_sync);
 
@@ -1583,7 +1741,8 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
       kfac::reduce_scatter_blocks(buffers,
                                   global_buffer,
                                   &comm,
-                                  reduce_scatter_mode);
+                                  reduce_scatter_mode,
+                                  m_half_precision_communication);
       prof_region_end("kfac-update/reduce-scatter", prof_sync);
 
 #ifdef LBANN_NVPROF
@@ -1616,9 +1775,16 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
 
     // Step 2: Model-parallel inverse computation
     prof_region_begin("kfac-inverse", prof_color, prof_sync);
-    for (auto& block : context.m_blocks) {
-      if (!is_kronecker_update_required ||
-          (size_t)comm.get_rank_in_trainer() != block->get_inverse_proc_rank())
+    const auto inverse_schedule =
+      get_inverse_schedule(comm,
+                           context,
+                           num_steps,
+                           is_kronecker_update_required);
+    kfac::batched_inverse<Device> inverse_batch;
+    std::vector<size_t> batched_block_ids;
+    for (size_t block_id = 0; block_id < context.m_blocks.size(); ++block_id) {
+      auto& block = context.m_blocks[block_id];
+      if (!inverse_schedule[block_id])
         continue;
 
       prof_region_begin(("kfac-inverse/" + block->get_name()).c_str(),
@@ -1629,6 +1795,14 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
         dynamic_cast<kfac_block_bn<Device>*>(block.get()) != nullptr;
       const bool is_gru =
         dynamic_cast<kfac_block_gru<Device>*>(block.get()) != nullptr;
+#ifdef LBANN_HAS_GPU
+      if (is_rebalance_enabled)
+        hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+      const auto t_start_inverse = std::chrono::high_resolution_clock::now();
+      const size_t batch_size = inverse_batch.size();
+      if (m_batched_inverse)
+        block->set_inverse_batch(&inverse_batch);
       block->update_kronecker_inverse(
         &comm,
         m_use_pi,
@@ -1639,9 +1813,40 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
         m_print_matrix,
         m_print_matrix_summary,
         m_print_time);
+      block->set_inverse_batch(nullptr);
+      if (inverse_batch.size() > batch_size)
+        batched_block_ids.push_back(block_id);
+      if (is_rebalance_enabled) {
+#ifdef LBANN_HAS_GPU
+        hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+        const auto t_stop_inverse = std::chrono::high_resolution_clock::now();
+        m_inverse_times[block_id] +=
+          std::chrono::duration<double>(t_stop_inverse - t_start_inverse)
+            .count();
+      }
       prof_region_end(("kfac-inverse/" + block->get_name()).c_str(), prof_sync);
     }
 
+    // Invert the small factors queued by the blocks
+    if (!inverse_batch.empty()) {
+      prof_region_begin("kfac-inverse/batched", prof_color, prof_sync);
+      const auto t_start_inverse = std::chrono::high_resolution_clock::now();
+      inverse_batch.run();
+      if (is_rebalance_enabled) {
+#ifdef LBANN_HAS_GPU
+        hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+        const auto t_stop_inverse = std::chrono::high_resolution_clock::now();
+        const double t_inverse =
+          std::chrono::duration<double>(t_stop_inverse - t_start_inverse)
+            .count();
+        for (const auto& block_id : batched_block_ids)
+          m_inverse_times[block_id] += t_inverse / batched_block_ids.size();
+      }
+      prof_region_end("kfac-inverse/batched", prof_sync);
+    }
+
     // allgather inverse matrices
     if (is_first_step and false) {
       kfac::allgather_inverse_matrices_sizes(context.m_blocks,
@@ -1865,6 +2070,9 @@ lbann::make<lbann::KFAC>(google::protobuf::Message const& msg_in)
   const bool enable_copy_errors = kfac_params.enable_copy_errors();
   const bool enable_copy_activations = kfac_params.enable_copy_activations();
   const bool use_eigen_decomposition = kfac_params.use_eigen_decomposition();
+  if (kfac_params.inverse_rank() > 0 && !use_eigen_decomposition)
+    LBANN_WARNING("K-FAC inverse_rank is ignored unless "
+                  "use_eigen_decomposition is set");
 
   const std::string inverse_strategy_str = kfac_params.inverse_strategy();
   kfac::kfac_inverse_strategy inverse_strategy;
@@ -1874,6 +2082,8 @@ lbann::make<lbann::KFAC>(google::protobuf::Message const& msg_in)
     inverse_strategy = kfac::kfac_inverse_strategy::EACH;
   else if (inverse_strategy_str == "root")
     inverse_strategy = kfac::kfac_inverse_strategy::ROOT;
+  else if (inverse_strategy_str == "balanced")
+    inverse_strategy = kfac::kfac_inverse_strategy::BALANCED;
   else {
     std::stringstream err;
     err << "Invalid inverse strategy type: " << inverse_strategy_str;
@@ -1906,6 +2116,7 @@ lbann::make<lbann::KFAC>(google::protobuf::Message const& msg_in)
                                     std::move(update_intervals),
                                     update_interval_steps,
                                     inverse_strategy,
+                                    kfac_params.inverse_rebalance_interval(),
                                     std::move(disable_layers),
                                     learning_rate_factor,
                                     learning_rate_factor_gru,
@@ -1913,5 +2124,9 @@ lbann::make<lbann::KFAC>(google::protobuf::Message const& msg_in)
                                     distribute_precondition_compute,
                                     use_eigen_decomposition,
                                     enable_copy_errors,
-                                    enable_copy_activations);
+                                    enable_copy_activations,
+                                    kfac_params.staggered_inverse(),
+                                    kfac_params.half_precision_communication(),
+                                    kfac_params.inverse_rank(),
+                                    kfac_params.batched_inverse());
 }
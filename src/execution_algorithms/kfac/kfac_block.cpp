@@ -53,6 +53,29 @@ El::SyncInfo<El::Device::GPU> kfac_block<El::Device::GPU>::get_sync_info()
 }
 #endif // LBANN_HAS_GPU
 
+template <El::Device Device>
+void kfac_block<Device>::invert_kronecker_factor(
+  El::Matrix<DataType, Device>& Ainv,
+  El::Matrix<DataType, Device>& Linv,
+  const El::Matrix<DataType, Device>& A,
+  const bool report_time,
+  const DataType damping,
+  const DataType damping_bn_err,
+  const bool is_bn)
+{
+  if (m_inverse_batch != nullptr &&
+      m_inverse_batch->add(A, Ainv, damping, damping_bn_err, is_bn))
+    return;
+  kfac::get_matrix_inverse(Ainv,
+                           Linv,
+                           A,
+                           report_time,
+                           damping,
+                           damping_bn_err,
+                           is_bn,
+                           get_sync_info());
+}
+
 template <El::Device Device>
 void kfac_block<Device>::compute_local_kronecker_factors(lbann_comm* comm,
                                                          bool print_matrix,
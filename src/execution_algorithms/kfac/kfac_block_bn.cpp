@@ -202,14 +202,13 @@ void kfac_block_bn<Device>::update_kronecker_inverse(
                                    sync_info);
   }
   else {
-    kfac::get_matrix_inverse(Finv,
-                             FLinv,
-                             Fave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_act),
-                             DataType(damping_err),
-                             true,
-                             sync_info);
+    this->invert_kronecker_factor(Finv,
+                                  FLinv,
+                                  Fave,
+                                  comm->am_trainer_master() && print_time,
+                                  DataType(damping_act),
+                                  DataType(damping_err),
+                                  true);
   }
 
   // dump L2 norm of matrices
@@ -67,7 +67,7 @@ void kfac_block_channelwise_fc<Device>::compute_local_kronecker_factors(
   El::Matrix<DataType, Device> local_activations_reshaped,
     local_errors_reshaped;
 
-  if (local_activations.Contiguous() and false) {
+  if (local_activations.Contiguous()) {
     local_activations_reshaped.LockedAttach(input_channel_size,
                                             local_batch_size *
                                               num_input_channels,
@@ -80,7 +80,7 @@ void kfac_block_channelwise_fc<Device>::compute_local_kronecker_factors(
                                       local_batch_size * num_input_channels);
   }
 
-  if (local_errors.Contiguous() and false) {
+  if (local_errors.Contiguous()) {
     local_errors_reshaped.LockedAttach(output_channel_size,
                                        local_batch_size * num_input_channels,
                                        local_errors.LockedBuffer(),
@@ -101,24 +101,13 @@ void kfac_block_channelwise_fc<Device>::compute_local_kronecker_factors(
   auto& G = this->get_workspace_matrix("G", m_height_G, m_height_G);
 
   if (m_has_bias) {
-    auto& local_activations_with_ones =
-      this->get_workspace_matrix("local_activations_with_ones",
-                                 local_activations_reshaped.Height() + 1,
-                                 local_activations_reshaped.Width());
-    auto local_activations_dst =
-      El::View(local_activations_with_ones,
-               El::IR(0, local_activations_reshaped.Height()),
-               El::ALL);
-    El::Copy(local_activations_reshaped, local_activations_dst);
-    auto local_activations_ones =
-      El::View(local_activations_with_ones,
-               El::IR(local_activations_reshaped.Height(),
-                      local_activations_reshaped.Height() + 1),
-               El::ALL);
-    El::Ones(local_activations_ones, 1, local_activations_reshaped.Width());
-    get_kronecker_factor_fc(A,
-                            local_activations_with_ones,
-                            1.0 / mini_batch_size);
+    auto& ones = this->get_workspace_matrix("ones",
+                                            local_activations_reshaped.Width(),
+                                            1);
+    kfac::get_kronecker_factor_fc_with_bias(A,
+                                            local_activations_reshaped,
+                                            ones,
+                                            DataType(1.0 / mini_batch_size));
   }
   else {
     get_kronecker_factor_fc(A,
@@ -286,22 +275,20 @@ void kfac_block_channelwise_fc<Device>::update_kronecker_inverse(
                                    sync_info);
   }
   else {
-    kfac::get_matrix_inverse(Ainv,
-                             ALinv,
-                             Aave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_act * pi),
-                             0,
-                             false,
-                             sync_info);
-    kfac::get_matrix_inverse(Ginv,
-                             GLinv,
-                             Gave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_err / pi),
-                             0,
-                             false,
-                             sync_info);
+    this->invert_kronecker_factor(Ainv,
+                                  ALinv,
+                                  Aave,
+                                  comm->am_trainer_master() && print_time,
+                                  DataType(damping_act * pi),
+                                  0,
+                                  false);
+    this->invert_kronecker_factor(Ginv,
+                                  GLinv,
+                                  Gave,
+                                  comm->am_trainer_master() && print_time,
+                                  DataType(damping_err / pi),
+                                  0,
+                                  false);
   }
 
   if (print_matrix_summary) {
@@ -627,6 +614,9 @@ void kfac_block_channelwise_fc<Device>::end_communication_forward_end(
     for (auto& req : this->m_requests_forward_end) {
       ::Al::Wait<kfac::BackendT>(req);
     }
+    // The staging copies are only read by the transfers
+    for (auto& copy : this->m_activations_copy)
+      copy->Empty();
 
     if (primary_grid_ranks.size() < secondary_grid_ranks.size() and false) {
       auto local_activations0 = dynamic_cast<
@@ -766,6 +756,8 @@ void kfac_block_channelwise_fc<Device>::end_communication_backward_end(
     for (auto& req : this->m_requests_backward_end) {
       ::Al::Wait<kfac::BackendT>(req);
     }
+    for (auto& copy : this->m_errors_copy)
+      copy->Empty();
 
     if (primary_grid_ranks.size() < secondary_grid_ranks.size() and false) {
       auto local_errors0 = dynamic_cast<
@@ -1080,6 +1072,14 @@ int kfac_block_channelwise_fc<Device>::get_inverse_matrices_size(
   return my_height_A * my_height_A + my_height_G * my_height_G;
 }
 
+template <El::Device Device>
+double kfac_block_channelwise_fc<Device>::get_inverse_cost(lbann_comm* comm)
+{
+  this->get_inverse_matrices_size(comm);
+  const double A_height = m_Ainv_height, G_height = m_Ginv_height;
+  return A_height * A_height * A_height + G_height * G_height * G_height;
+}
+
 template <El::Device Device>
 int kfac_block_channelwise_fc<Device>::set_inverse_matrices(
   El::Matrix<DataType, Device>& workspace,
@@ -72,23 +72,11 @@ void kfac_block_fc_conv<Device>::compute_local_kronecker_factors(
   auto& G = this->get_workspace_matrix("G", m_height_G, m_height_G);
   if (!m_is_conv) {
     if (m_has_bias) {
-      auto& local_activations_with_ones =
-        this->get_workspace_matrix("local_activations_with_ones",
-                                   local_activations.Height() + 1,
-                                   local_activations.Width());
-      auto local_activations_dst =
-        El::View(local_activations_with_ones,
-                 El::IR(0, local_activations.Height()),
-                 El::ALL);
-      El::Copy(local_activations, local_activations_dst);
-      auto local_activations_ones = El::View(
-        local_activations_with_ones,
-        El::IR(local_activations.Height(), local_activations.Height() + 1),
-        El::ALL);
-      El::Ones(local_activations_ones, 1, local_activations.Width());
-      get_kronecker_factor_fc(A,
-                              local_activations_with_ones,
-                              1.0 / mini_batch_size);
+      auto& ones = this->get_workspace_matrix("ones", local_batch_size, 1);
+      kfac::get_kronecker_factor_fc_with_bias(A,
+                                              local_activations,
+                                              ones,
+                                              DataType(1.0 / mini_batch_size));
     }
     else {
       get_kronecker_factor_fc(A, local_activations, 1.0 / mini_batch_size);
@@ -270,6 +258,8 @@ void kfac_block_fc_conv<Device>::update_kronecker_inverse(
     this->m_has_kronecker_inverse = true;
     m_kronecker_inverse_A.Resize(Aave.Height(), Aave.Width());
     m_kronecker_inverse_G.Resize(Gave.Height(), Gave.Width());
+    m_eigenvectors_A.Empty();
+    m_eigenvectors_G.Empty();
   }
   // TODO: Refactoring
   auto& Ainv = m_kronecker_inverse_A;
@@ -280,40 +270,38 @@ void kfac_block_fc_conv<Device>::update_kronecker_inverse(
     this->get_workspace_matrix("GLinv", Gave.Height(), Gave.Height());
 
   if (use_eigen_decomposition) {
-    kfac::get_matrix_inverse_eigen(Ainv,
-                                   ALinv,
-                                   Aave,
-                                   comm->am_trainer_master() && print_time,
-                                   DataType(damping_act * pi),
-                                   0,
-                                   false,
-                                   sync_info);
-    kfac::get_matrix_inverse_eigen(Ginv,
-                                   GLinv,
-                                   Gave,
-                                   comm->am_trainer_master() && print_time,
-                                   DataType(damping_err / pi),
-                                   0,
-                                   false,
-                                   sync_info);
+    kfac::get_matrix_inverse_low_rank(Ainv,
+                                      ALinv,
+                                      m_eigenvectors_A,
+                                      Aave,
+                                      this->m_inverse_rank,
+                                      comm->am_trainer_master() && print_time,
+                                      DataType(damping_act * pi),
+                                      sync_info);
+    kfac::get_matrix_inverse_low_rank(Ginv,
+                                      GLinv,
+                                      m_eigenvectors_G,
+                                      Gave,
+                                      this->m_inverse_rank,
+                                      comm->am_trainer_master() && print_time,
+                                      DataType(damping_err / pi),
+                                      sync_info);
   }
   else {
-    kfac::get_matrix_inverse(Ainv,
-                             ALinv,
-                             Aave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_act * pi),
-                             0,
-                             false,
-                             sync_info);
-    kfac::get_matrix_inverse(Ginv,
-                             GLinv,
-                             Gave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_err / pi),
-                             0,
-                             false,
-                             sync_info);
+    this->invert_kronecker_factor(Ainv,
+                                  ALinv,
+                                  Aave,
+                                  comm->am_trainer_master() && print_time,
+                                  DataType(damping_act * pi),
+                                  0,
+                                  false);
+    this->invert_kronecker_factor(Ginv,
+                                  GLinv,
+                                  Gave,
+                                  comm->am_trainer_master() && print_time,
+                                  DataType(damping_err / pi),
+                                  0,
+                                  false);
   }
 
   if (print_matrix_summary) {
@@ -694,6 +682,9 @@ void kfac_block_fc_conv<Device>::end_communication_forward_end(lbann_comm* comm)
     for (auto& req : this->m_requests_forward_end) {
       ::Al::Wait<kfac::BackendT>(req);
     }
+    // The staging copies are only read by the transfers
+    for (auto& copy : this->m_activations_copy)
+      copy->Empty();
 
     if (primary_grid_ranks.size() < secondary_grid_ranks.size() and false) {
       auto local_activations0 = dynamic_cast<
@@ -842,6 +833,8 @@ void kfac_block_fc_conv<Device>::end_communication_backward_end(
     for (auto& req : this->m_requests_backward_end) {
       ::Al::Wait<kfac::BackendT>(req);
     }
+    for (auto& copy : this->m_errors_copy)
+      copy->Empty();
 
     if (primary_grid_ranks.size() < secondary_grid_ranks.size() and false) {
       auto local_errors0 = dynamic_cast<
@@ -1174,6 +1167,14 @@ int kfac_block_fc_conv<Device>::get_inverse_matrices_size(lbann_comm* comm)
   return my_height_A * my_height_A + my_height_G * my_height_G;
 }
 
+template <El::Device Device>
+double kfac_block_fc_conv<Device>::get_inverse_cost(lbann_comm* comm)
+{
+  this->get_inverse_matrices_size(comm);
+  const double A_height = m_Ainv_height, G_height = m_Ginv_height;
+  return A_height * A_height * A_height + G_height * G_height * G_height;
+}
+
 template <El::Device Device>
 int kfac_block_fc_conv<Device>::set_inverse_matrices(
   El::Matrix<DataType, Device>& workspace,
@@ -914,6 +914,22 @@ int kfac_block_gru<Device>::get_inverse_matrices_size(lbann_comm* comm)
   return inverse_size;
 }
 
+template <El::Device Device>
+double kfac_block_gru<Device>::get_inverse_cost(lbann_comm* comm)
+{
+  const double input_size = get_input_size();
+  const double hidden_size = get_hidden_size();
+  const auto cube = [](double x) { return x * x * x; };
+
+  double cost = cube(input_size) + cube(hidden_size);
+  for (auto& matrix_type : kfac_gru_util::LEARNABLE_MATRICES) {
+    cost += cube(kfac_gru_util::is_matrix_height_hidden(matrix_type)
+                   ? hidden_size
+                   : input_size);
+  }
+  return cost;
+}
+
 template <El::Device Device>
 std::vector<std::tuple<std::string, size_t, size_t>>
 kfac_block_gru<Device>::get_internal_matrix_info() const
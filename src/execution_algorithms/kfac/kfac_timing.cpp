@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/kfac/kfac_timing.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <utility>
+
+namespace lbann {
+namespace kfac {
+
+std::vector<std::string> const& phase_names()
+{
+  static const std::vector<std::string> names = {"forward_pass",
+                                                 "backward_pass",
+                                                 "kfac",
+                                                 "forward_comm",
+                                                 "forward_comm_end",
+                                                 "backward_comm",
+                                                 "backward_comm_end",
+                                                 "inverse_comm",
+                                                 "inverse_send_recv",
+                                                 "precond_comm"};
+  return names;
+}
+
+std::vector<phase_record> phase_timer::take_records()
+{
+  return std::exchange(m_records, {});
+}
+
+void phase_timer::begin_step()
+{
+  m_step_times.clear();
+  m_has_steps = true;
+}
+
+void phase_timer::record(std::string const& name, EvalType seconds)
+{
+  m_step_times[name] += seconds;
+  if (m_tracing) {
+    const EvalType now = get_time();
+    m_records.push_back({name, now - seconds, now});
+  }
+}
+
+EvalType phase_timer::get_step_time(std::string const& name) const
+{
+  auto it = m_step_times.find(name);
+  return it != m_step_times.end() ? it->second : EvalType(0);
+}
+
+} // namespace kfac
+} // namespace lbann
@@ -36,6 +36,11 @@
 #include <core/imports/mpi.hpp>
 #include <iomanip>
 #include <iterator>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <type_traits>
 
 namespace lbann {
 namespace kfac {
@@ -339,6 +344,223 @@ void get_matrix_inverse_eigen(El::AbstractMatrix<DataType>& Ainv,
   El::Synchronize(sync_info);
 }
 
+template <El::Device Device>
+void get_matrix_inverse_low_rank(El::Matrix<DataType, Device>& Ainv,
+                                 El::Matrix<DataType, Device>& Linv,
+                                 El::Matrix<DataType, Device>& basis,
+                                 const El::Matrix<DataType, Device>& A,
+                                 const size_t rank,
+                                 const bool report_time,
+                                 const DataType damping,
+                                 const El::SyncInfo<Device>& sync_info)
+{
+  assert(A.Height() == A.Width());
+  const El::Int height = A.Height();
+  const El::Int k = rank;
+  if (k == 0 || 2 * k > height) {
+    basis.Empty();
+    get_matrix_inverse_eigen<Device>(Ainv,
+                                     Linv,
+                                     A,
+                                     report_time,
+                                     damping,
+                                     0,
+                                     false,
+                                     sync_info);
+    return;
+  }
+  Ainv.Resize(height, height);
+
+  using CPUMatType = El::Matrix<DataType, El::Device::CPU>;
+  const auto one = El::TypeTraits<DataType>::One();
+  const auto zero = El::TypeTraits<DataType>::Zero();
+  const auto uplo = El::UpperOrLowerNS::LOWER;
+  El::HermitianEigCtrl<DataType> ctrl;
+
+  const double t_start = get_time();
+
+  // Start from the eigenvectors of the previous inversion. Since the
+  // factors are moving averages, a single subspace iteration per
+  // update is enough to track the dominant eigenspace.
+  if (basis.Height() != height || basis.Width() != k) {
+    CPUMatType init;
+    El::Gaussian(init, height, k);
+    El::Copy(init, basis);
+  }
+  El::Matrix<DataType, Device> Y(height, k), Q(height, k);
+  El::Gemm(El::NORMAL, El::NORMAL, one, A, basis, zero, Y);
+
+  // Orthonormalize the subspace: Q = Y W S^{-1/2} with Y^T Y = W S W^T.
+  El::Matrix<DataType, Device> small(k, k);
+  El::Gemm(El::TRANSPOSE, El::NORMAL, one, Y, Y, zero, small);
+  CPUMatType gram, s, W;
+  El::Copy(small, gram);
+  El::HermitianEig(uplo, gram, s, W, ctrl);
+  DataType s_max = zero;
+  for (El::Int i = 0; i < k; i++)
+    s_max = std::max(s_max, s(i));
+  const DataType s_min = s_max * std::numeric_limits<DataType>::epsilon();
+  for (El::Int j = 0; j < k; j++) {
+    const DataType scale = one / std::sqrt(std::max(s(j), s_min));
+    for (El::Int i = 0; i < k; i++)
+      W(i, j) *= scale;
+  }
+  El::Copy(W, small);
+  El::Gemm(El::NORMAL, El::NORMAL, one, Y, small, zero, Q);
+
+  const double t_basis = get_time();
+
+  // Rayleigh-Ritz: eigenpairs of Q^T A Q give U = Q Z and Lambda.
+  El::Gemm(El::NORMAL, El::NORMAL, one, A, Q, zero, Y);
+  El::Gemm(El::TRANSPOSE, El::NORMAL, one, Q, Y, zero, small);
+  CPUMatType projected, lambda, Z;
+  El::Copy(small, projected);
+  El::HermitianEig(uplo, projected, lambda, Z, ctrl);
+  El::Copy(Z, small);
+  El::Gemm(El::NORMAL, El::NORMAL, one, Q, small, zero, basis);
+
+  const double t_eig = get_time();
+
+  // The unresolved part of the spectrum is assumed to be flat at the
+  // smallest resolved eigenvalue:
+  //   Ainv = c I + U (diag(1/(lambda+damping)) - c I) U^T
+  // with c = 1/(lambda_min+damping).
+  DataType lambda_min = std::numeric_limits<DataType>::max();
+  for (El::Int i = 0; i < k; i++) {
+    lambda(i) = std::max(lambda(i), zero);
+    lambda_min = std::min(lambda_min, lambda(i));
+  }
+  const DataType c = one / (lambda_min + damping);
+  CPUMatType diag;
+  El::Zeros(diag, k, k);
+  for (El::Int i = 0; i < k; i++)
+    diag(i, i) = one / (lambda(i) + damping) - c;
+  El::Copy(diag, small);
+  El::Gemm(El::NORMAL, El::NORMAL, one, basis, small, zero, Y);
+  identity<Device>(Ainv, sync_info);
+  El::Scale(c, Ainv);
+  El::Gemm(El::NORMAL, El::TRANSPOSE, one, Y, basis, one, Ainv);
+
+  const double t_inverse = get_time();
+
+  if (report_time) {
+    std::cout << "K-FAC: get_matrix_inverse_low_rank of"
+              << " " << A.Height() << "x" << A.Width() << " with rank " << k
+              << " (damping=" << damping << "): "
+              << " t_basis=" << (t_basis - t_start)
+              << ", t_eig=" << (t_eig - t_basis)
+              << ", t_inverse=" << (t_inverse - t_eig) << std::endl;
+  }
+
+  El::Synchronize(sync_info);
+}
+
+template <El::Device Device>
+bool batched_inverse<Device>::add(const El::Matrix<DataType, Device>& A,
+                                  El::Matrix<DataType, Device>& Ainv,
+                                  const DataType damping,
+                                  const DataType damping_bn_err,
+                                  const bool is_bn)
+{
+  if (A.Height() > max_height)
+    return false;
+  m_entries.push_back({&A, &Ainv, damping, damping_bn_err, is_bn});
+  return true;
+}
+
+template <El::Device Device>
+void batched_inverse<Device>::run()
+{
+  if (m_entries.empty())
+    return;
+  const El::SyncInfo<Device> sync_info =
+    El::SyncInfoFromMatrix(*m_entries.front().inverse);
+
+  std::map<El::Int, std::vector<const entry*>> groups;
+  for (const auto& e : m_entries)
+    groups[e.factor->Height()].push_back(&e);
+
+  for (const auto& group : groups) {
+    const El::Int height = group.first;
+    const auto& entries = group.second;
+    const El::Int batch_size = entries.size();
+
+    if (batch_size == 1) {
+      const auto& e = *entries.front();
+      El::Matrix<DataType, Device> Linv(height, height);
+      get_matrix_inverse<Device>(*e.inverse,
+                                 Linv,
+                                 *e.factor,
+                                 false,
+                                 e.damping,
+                                 e.damping_bn_err,
+                                 e.is_bn,
+                                 sync_info);
+      continue;
+    }
+
+    // Pack the factors into the columns of one matrix
+    El::Matrix<DataType, Device> buffer(height * height, batch_size);
+    El::Matrix<DataType, El::Device::CPU> damping_cpu(2, batch_size);
+    for (El::Int i = 0; i < batch_size; i++) {
+      const auto& e = *entries[i];
+      El::Matrix<DataType, Device> slot;
+      slot.Attach(height, height, buffer.Buffer(0, i), height);
+      El::Copy(*e.factor, slot);
+      damping_cpu(0, i) = e.damping;
+      damping_cpu(1, i) = e.is_bn ? e.damping_bn_err : e.damping;
+    }
+    El::Matrix<DataType, Device> damping;
+    El::Copy(damping_cpu, damping);
+
+    get_matrix_inverse_batched<Device>(buffer, damping, height, sync_info);
+
+    for (El::Int i = 0; i < batch_size; i++) {
+      El::Matrix<DataType, Device> slot;
+      slot.LockedAttach(height, height, buffer.LockedBuffer(0, i), height);
+      El::Copy(slot, *entries[i]->inverse);
+    }
+    El::Synchronize(sync_info);
+  }
+  m_entries.clear();
+}
+
+template <El::Device Device>
+void get_kronecker_factor_fc_with_bias(
+  El::Matrix<DataType, Device>& factor,
+  const El::Matrix<DataType, Device>& activations,
+  El::Matrix<DataType, Device>& ones,
+  const DataType alpha)
+{
+  const El::Int height = activations.Height();
+  const El::Int width = activations.Width();
+  assert(factor.Height() == height + 1);
+  assert(factor.Width() == height + 1);
+  const auto zero = El::TypeTraits<DataType>::Zero();
+  El::Ones(ones, width, 1);
+  auto factor_activations =
+    El::View(factor, El::IR(0, height), El::IR(0, height));
+  auto factor_col = El::View(factor, El::IR(0, height), El::IR(height));
+  auto factor_row = El::View(factor, El::IR(height), El::IR(0, height));
+  auto factor_corner = El::View(factor, El::IR(height), El::IR(height));
+  El::Gemm(El::NORMAL,
+           El::TRANSPOSE,
+           alpha,
+           activations,
+           activations,
+           zero,
+           factor_activations);
+  El::Gemm(El::NORMAL, El::NORMAL, alpha, activations, ones, zero, factor_col);
+  El::Gemm(El::TRANSPOSE,
+           El::TRANSPOSE,
+           alpha,
+           ones,
+           activations,
+           zero,
+           factor_row);
+  El::Fill(factor_corner, DataType(alpha * width));
+}
+
 template <El::Device Device>
 std::string get_matrix_stat(const El::Matrix<DataType, Device>& X,
                             const char* name)
@@ -366,6 +588,97 @@ void allreduce_lower_tri(El::AbstractMatrix<DataType>& A,
   unpack_lower_tri<Device>(A, AL, sync_info);
 }
 
+std::vector<double> balance_inverse_assignment(std::vector<double> const& costs,
+                                               size_t num_procs,
+                                               std::vector<size_t>& ranks)
+{
+  if (num_procs == 0)
+    LBANN_ERROR("Cannot assign K-FAC blocks to zero processes");
+
+  std::vector<size_t> order(costs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&costs](size_t a, size_t b) {
+    return costs[a] > costs[b];
+  });
+
+  // Min-heap of (load, rank)
+  using LoadT = std::pair<double, size_t>;
+  std::priority_queue<LoadT, std::vector<LoadT>, std::greater<LoadT>> heap;
+  for (size_t rank = 0; rank < num_procs; ++rank)
+    heap.emplace(0., rank);
+
+  std::vector<double> loads(num_procs, 0.);
+  ranks.assign(costs.size(), 0);
+  for (const auto& block : order) {
+    const auto [load, rank] = heap.top();
+    heap.pop();
+    ranks[block] = rank;
+    loads[rank] = load + costs[block];
+    heap.emplace(loads[rank], rank);
+  }
+  return loads;
+}
+
+namespace {
+
+/** @brief Half-precision type used to communicate on a device. */
+template <El::Device Device>
+struct HalfTypeT
+{
+  using type = void;
+};
+#ifdef LBANN_HAS_HALF
+template <>
+struct HalfTypeT<El::Device::CPU>
+{
+  using type = cpu_fp16;
+};
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU_FP16
+template <>
+struct HalfTypeT<El::Device::GPU>
+{
+  using type = fp16;
+};
+#endif // LBANN_HAS_GPU_FP16
+
+/** @brief Sum a buffer over the K-FAC communicator.
+ *  @details With @c half_precision, the buffer is sent as FP16 and
+ *  converted back afterwards. Contributions are scaled by the number
+ *  of processes first so that the sum stays in range.
+ */
+template <El::Device Device>
+void allreduce_buffer(El::Matrix<DataType, Device>& buffer,
+                      lbann_comm* comm,
+                      bool half_precision)
+{
+  if (!half_precision) {
+    comm->allreduce((El::AbstractMatrix<DataType>&)buffer,
+                    comm->get_KFAC_comm());
+    return;
+  }
+  using HalfT = typename HalfTypeT<Device>::type;
+  if constexpr (std::is_void_v<HalfT>) {
+    LBANN_ERROR("K-FAC half-precision communication requires "
+                "LBANN to be built with half-precision support");
+  }
+  else {
+    const DataType scale = DataType(El::mpi::Size(comm->get_KFAC_comm()));
+    El::Matrix<HalfT, Device> half_buffer;
+    if constexpr (Device == El::Device::GPU) {
+      half_buffer.SetSyncInfo(El::SyncInfoFromMatrix(buffer));
+    }
+    El::Scale(El::TypeTraits<DataType>::One() / scale, buffer);
+    El::Copy(buffer, half_buffer);
+    comm->allreduce((El::AbstractMatrix<HalfT>&)half_buffer,
+                    comm->get_KFAC_comm());
+    El::Copy(half_buffer, buffer);
+    El::Scale(scale, buffer);
+  }
+}
+
+} // namespace
+
 bool is_reduce_scatter_buffer_required(const kfac_reduce_scatter_mode mode)
 {
   if (mode == kfac_reduce_scatter_mode::ALLREDUCE)
@@ -382,7 +695,8 @@ void reduce_scatter_blocks(
   const std::vector<std::pair<size_t, El::AbstractMatrix<DataType>*>>& blocks,
   El::Matrix<DataType, Device>& global_buffer,
   lbann_comm* comm,
-  const kfac_reduce_scatter_mode mode)
+  const kfac_reduce_scatter_mode mode,
+  bool half_precision)
 {
 
   if (mode == kfac_reduce_scatter_mode::REDUCE) {
@@ -423,8 +737,7 @@ void reduce_scatter_blocks(
   }
 
   if (mode == kfac_reduce_scatter_mode::ALLREDUCE) {
-    comm->allreduce((El::AbstractMatrix<DataType>&)global_buffer,
-                    comm->get_KFAC_comm());
+    allreduce_buffer(global_buffer, comm, half_precision);
   }
   else {
     std::vector<size_t> recv_sizes;
@@ -1549,6 +1862,29 @@ void unpack_lower_tri(El::Matrix<DataType, El::Device::CPU>& A,
           L(row + (2 * height - (col - 1)) * col / 2 - col, 0);
 }
 
+template <>
+void get_matrix_inverse_batched(
+  El::Matrix<DataType, El::Device::CPU>& A,
+  const El::Matrix<DataType, El::Device::CPU>& damping,
+  const El::Int height,
+  const El::SyncInfo<El::Device::CPU>& sync_info)
+{
+  El::Matrix<DataType, El::Device::CPU> factor, Linv(height, height);
+  for (El::Int i = 0; i < A.Width(); i++) {
+    El::Matrix<DataType, El::Device::CPU> inverse;
+    inverse.Attach(height, height, A.Buffer(0, i), height);
+    El::Copy(inverse, factor);
+    get_matrix_inverse<El::Device::CPU>(inverse,
+                                        Linv,
+                                        factor,
+                                        false,
+                                        damping(0, i),
+                                        damping(1, i),
+                                        true,
+                                        sync_info);
+  }
+}
+
 #define PROTO_DEVICE(T, Device)                                                \
   template void get_matrix_inverse(El::AbstractMatrix<T>& Ainv,                \
                                    El::AbstractMatrix<T>& Linv,                \
@@ -1567,6 +1903,20 @@ void unpack_lower_tri(El::Matrix<DataType, El::Device::CPU>& A,
     T damping_bn_err,                                                          \
     bool is_bn,                                                                \
     const El::SyncInfo<Device>& sync_info);                                    \
+  template void get_matrix_inverse_low_rank(                                   \
+    El::Matrix<T, Device>& Ainv,                                               \
+    El::Matrix<T, Device>& Linv,                                               \
+    El::Matrix<T, Device>& basis,                                              \
+    const El::Matrix<T, Device>& A,                                            \
+    size_t rank,                                                               \
+    bool report_time,                                                          \
+    T damping,                                                                 \
+    const El::SyncInfo<Device>& sync_info);                                    \
+  template void get_kronecker_factor_fc_with_bias(                             \
+    El::Matrix<T, Device>& factor,                                             \
+    const El::Matrix<T, Device>& activations,                                  \
+    El::Matrix<T, Device>& ones,                                               \
+    T alpha);                                                                  \
   template std::string get_matrix_stat(const El::Matrix<T, Device>& X,         \
                                        const char* name);                      \
   template void allreduce_lower_tri(El::AbstractMatrix<T>& A,                  \
@@ -1577,7 +1927,8 @@ void unpack_lower_tri(El::Matrix<DataType, El::Device::CPU>& A,
     const std::vector<std::pair<size_t, El::AbstractMatrix<T>*>>& blocks,      \
     El::Matrix<T, Device>& global_buffer,                                      \
     lbann_comm* comm,                                                          \
-    const kfac_reduce_scatter_mode mode);                                      \
+    const kfac_reduce_scatter_mode mode,                                       \
+    bool half_precision);                                                      \
   template void allgather_blocks(                                              \
     const std::vector<std::pair<size_t, El::AbstractMatrix<T>*>>& blocks,      \
     El::Matrix<T, Device>& local_buffer,                                       \
@@ -1617,9 +1968,11 @@ void unpack_lower_tri(El::Matrix<DataType, El::Device::CPU>& A,
     El::DistMatrix<T, El::STAR, El::VC, El::ELEMENT, Device>& B);
 
 PROTO_DEVICE(DataType, El::Device::CPU);
+template class batched_inverse<El::Device::CPU>;
 
 #ifdef LBANN_HAS_GPU
 PROTO_DEVICE(DataType, El::Device::GPU);
+template class batched_inverse<El::Device::GPU>;
 // If GPUS are defined then the default case CPU case needs to be instantiated
 PROTO_DEVICECOMM(DataType, El::Device::CPU);
 #endif // LBANN_HAS_GPU
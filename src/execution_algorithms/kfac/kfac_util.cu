@@ -150,6 +150,58 @@ kfac_unpack_lower_tri_kernel(TensorDataType* __restrict__ A,
   }
 }
 
+/** Gauss-Jordan elimination of one matrix per thread block. The
+ *  matrices are symmetric positive definite, so no pivoting is
+ *  needed. */
+template <typename TensorDataType>
+__global__ void
+kfac_batched_inverse_kernel(TensorDataType* __restrict__ A,
+                            const TensorDataType* __restrict__ damping,
+                            const size_t height)
+{
+  extern __shared__ __align__(8) unsigned char shared_memory[];
+  auto* M = reinterpret_cast<TensorDataType*>(shared_memory);
+  auto* factors = M + height * height;
+  const size_t size = height * height;
+  auto* A_batch = A + blockIdx.x * size;
+  const TensorDataType damping_lo = damping[2 * blockIdx.x];
+  const TensorDataType damping_hi = damping[2 * blockIdx.x + 1];
+
+  for (size_t gid = threadIdx.x; gid < size; gid += blockDim.x) {
+    const size_t row = gid % height;
+    const size_t col = gid / height;
+    M[gid] = A_batch[gid];
+    if (row == col)
+      M[gid] += (row >= height / 2 ? damping_hi : damping_lo);
+  }
+  __syncthreads();
+
+  for (size_t k = 0; k < height; ++k) {
+    const TensorDataType pivot_inv = TensorDataType(1) / M[k + k * height];
+    for (size_t row = threadIdx.x; row < height; row += blockDim.x)
+      factors[row] = M[row + k * height];
+    __syncthreads();
+    for (size_t col = threadIdx.x; col < height; col += blockDim.x) {
+      const TensorDataType x =
+        (col == k ? TensorDataType(1) : M[k + col * height]);
+      M[k + col * height] = x * pivot_inv;
+    }
+    __syncthreads();
+    for (size_t gid = threadIdx.x; gid < size; gid += blockDim.x) {
+      const size_t row = gid % height;
+      const size_t col = gid / height;
+      if (row != k) {
+        const TensorDataType x = (col == k ? TensorDataType(0) : M[gid]);
+        M[gid] = x - factors[row] * M[k + col * height];
+      }
+    }
+    __syncthreads();
+  }
+
+  for (size_t gid = threadIdx.x; gid < size; gid += blockDim.x)
+    A_batch[gid] = M[gid];
+}
+
 } // namespace
 
 template <>
@@ -328,5 +380,27 @@ void unpack_lower_tri(El::Matrix<DataType, El::Device::GPU>& A,
   }
 }
 
+template <>
+void get_matrix_inverse_batched(
+  El::Matrix<DataType, El::Device::GPU>& A,
+  const El::Matrix<DataType, El::Device::GPU>& damping,
+  const El::Int height,
+  const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  const size_t batch_size = A.Width();
+  constexpr size_t block_size = 256;
+  const size_t shared_size = (height * height + height) * sizeof(DataType);
+  if (batch_size > 0 && height > 0) {
+    hydrogen::gpu::LaunchKernel(kfac_batched_inverse_kernel<DataType>,
+                                batch_size,
+                                block_size,
+                                shared_size,
+                                sync_info,
+                                A.Buffer(),
+                                damping.LockedBuffer(),
+                                static_cast<size_t>(height));
+  }
+}
+
 } // namespace kfac
 } // namespace lbann
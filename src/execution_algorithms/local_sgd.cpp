@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/local_sgd.hpp"
+#include "lbann/callbacks/checkpoint.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/profiling.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include "lbann/proto/training_algorithm.pb.h"
+
+#include <iostream>
+
+namespace lbann {
+
+LocalSGD::LocalSGD(std::string name,
+                   std::unique_ptr<TrainingAlgorithm> local_training_algorithm,
+                   size_t max_rounds,
+                   double outer_learning_rate,
+                   double outer_momentum,
+                   bool outer_nesterov,
+                   bool suppress_timer)
+  : TrainingAlgorithm{std::move(name)},
+    m_local_algo{std::move(local_training_algorithm)},
+    m_max_rounds{max_rounds},
+    m_outer_learning_rate{outer_learning_rate},
+    m_outer_momentum{outer_momentum},
+    m_outer_nesterov{outer_nesterov},
+    m_suppress_timer{suppress_timer}
+{
+  if (m_local_algo == nullptr) {
+    LBANN_ERROR("local SGD requires a local training algorithm");
+  }
+  if (m_outer_learning_rate <= 0.) {
+    LBANN_ERROR("local SGD outer learning rate must be positive, got ",
+                m_outer_learning_rate);
+  }
+  if (m_outer_momentum < 0. || m_outer_momentum >= 1.) {
+    LBANN_ERROR("local SGD outer momentum must be in [0,1), got ",
+                m_outer_momentum);
+  }
+}
+
+bool LocalSGD::has_outer_optimizer() const noexcept
+{
+  return m_outer_learning_rate != 1. || m_outer_momentum != 0.;
+}
+
+void LocalSGD::apply(ExecutionContext& context,
+                     model& m,
+                     data_coordinator& dc,
+                     execution_mode /*mode*/)
+{
+  LBANN_CALIPER_MARK_FUNCTION;
+  auto& ctxt = dynamic_cast<ExeContextType&>(context);
+  auto& comm = *m.get_comm();
+
+  // A restart would begin a new round from stale outer state
+  for (auto const* cb : m.get_callbacks()) {
+    if (dynamic_cast<callback::checkpoint const*>(cb) != nullptr) {
+      LBANN_ERROR("local SGD does not support checkpointing; remove the "
+                  "checkpoint callback from model \"",
+                  m.get_name(),
+                  "\"");
+    }
+  }
+
+  // All trainers in this lbann_comm take part in the averaging
+  comm.intertrainer_barrier();
+
+  // The outer optimizer steps from the common values at round start
+  if (has_outer_optimizer()) {
+    for (auto* w : m.get_weights()) {
+      auto* dtw = dynamic_cast<data_type_weights<DataType>*>(w);
+      auto& anchor = ctxt.anchors[w->get_name()];
+      if (dtw != nullptr && dtw->get_optimizer() != nullptr &&
+          anchor == nullptr) {
+        auto const& values = dtw->get_values_sharded();
+        anchor.reset(AbsDistMat::Instantiate(values.DistData()));
+        El::Copy(values, *anchor);
+      }
+    }
+  }
+
+  while (ctxt.get_step() < m_max_rounds) {
+    auto local_ctxt = m_local_algo->get_new_execution_context();
+    m_local_algo->apply(*local_ctxt, m, dc, execution_mode::training);
+    ctxt.local_steps += local_ctxt->get_step();
+    average_weights(ctxt, m);
+    ctxt.inc_step();
+  }
+
+  // Each round replaces (local steps) gradient syncs across trainers
+  // with one weights average of the same size
+  if (!m_suppress_timer && comm.am_world_master() && ctxt.get_step() > 0) {
+    const size_t rounds = ctxt.get_step();
+    const double time_per_average = ctxt.averaging_time / rounds;
+    const size_t avoided =
+      ctxt.local_steps > rounds ? ctxt.local_steps - rounds : 0;
+    std::cout << "LocalSGD::" << this->get_name() << ": " << rounds
+              << " rounds, " << ctxt.local_steps << " local steps, "
+              << ctxt.averaging_time << " s averaging ("
+              << time_per_average << " s and " << ctxt.averaged_bytes
+              << " bytes per round); estimated "
+              << time_per_average * avoided << " s of inter-trainer "
+              << "communication saved by skipping " << avoided
+              << " per-step syncs" << std::endl;
+  }
+}
+
+void LocalSGD::average_weights(LocalSGDExecutionContext& ctxt, model& m) const
+{
+  auto& comm = *m.get_comm();
+  const int num_trainers = comm.get_num_trainers();
+  const bool outer = has_outer_optimizer();
+  const DataType mu = El::To<DataType>(m_outer_momentum);
+  const DataType lr = El::To<DataType>(m_outer_learning_rate);
+
+  lbann_comm::collective_tag_scope tag(comm, "local_sgd_average");
+  const auto start = get_time();
+  size_t bytes = 0;
+  for (auto* w : m.get_weights()) {
+    auto* dtw = dynamic_cast<data_type_weights<DataType>*>(w);
+    if (dtw == nullptr) {
+      LBANN_ERROR("local SGD only supports weights of the default data type; "
+                  "weights \"",
+                  w->get_name(),
+                  "\" use another type");
+    }
+    if (dtw->get_optimizer() == nullptr) {
+      continue;
+    }
+    auto& values = dtw->get_values_sharded();
+    bytes += values.LocalHeight() * values.LocalWidth() * sizeof(DataType);
+
+    auto& anchor = ctxt.anchors[w->get_name()];
+    if (outer && anchor == nullptr) {
+      LBANN_ERROR("local SGD lost the anchor of weights \"",
+                  w->get_name(),
+                  "\"");
+    }
+
+    comm.intertrainer_sum_matrix(values);
+    if (num_trainers > 1) {
+      El::Scale(El::To<DataType>(1. / num_trainers), values);
+    }
+    if (!outer) {
+      continue;
+    }
+
+    // values <- anchor - lr * step, with delta = anchor - average
+    auto& velocity = ctxt.velocities[w->get_name()];
+    if (velocity == nullptr) {
+      velocity.reset(AbsDistMat::Instantiate(values.DistData()));
+      El::Zeros(*velocity, values.Height(), values.Width());
+    }
+    El::Axpy(DataType(-1), *anchor, values);
+    El::Scale(DataType(-1), values);
+    El::Scale(mu, *velocity);
+    El::Axpy(DataType(1), values, *velocity);
+    if (m_outer_nesterov) {
+      El::Axpy(mu, *velocity, values);
+    }
+    else {
+      El::Copy(*velocity, values);
+    }
+    El::Scale(-lr, values);
+    El::Axpy(DataType(1), *anchor, values);
+    El::Copy(values, *anchor);
+  }
+  ctxt.averaging_time += get_time() - start;
+  ctxt.averaged_bytes = bytes;
+}
+
+} // namespace lbann
+
+template <>
+std::unique_ptr<lbann::LocalSGD>
+lbann::make<lbann::LocalSGD>(google::protobuf::Message const& msg_in)
+{
+  auto const& msg = dynamic_cast<lbann_data::TrainingAlgorithm const&>(msg_in);
+
+  lbann_data::LocalSGD params;
+  LBANN_ASSERT(msg.parameters().UnpackTo(&params));
+
+  // proto3 defaults of 0 mean plain averaging
+  const double outer_lr =
+    params.outer_learning_rate() > 0. ? params.outer_learning_rate() : 1.;
+  return std::make_unique<LocalSGD>(
+    msg.name(),
+    make_abstract<TrainingAlgorithm>(params.local_training_algorithm()),
+    params.stopping_criteria().max_rounds(),
+    outer_lr,
+    params.outer_momentum(),
+    params.outer_nesterov(),
+    params.suppress_timer_output());
+}
@@ -100,7 +100,8 @@ inline static void restore_model_weights(
 
 inline static std::string sendrecv_string(lbann_comm const& c,
                                           std::string const& src,
-                                          El::Int partner_trainer)
+                                          El::Int partner_trainer,
+                                          bool all_ranks = false)
 {
 #ifdef LBANN_HAS_ALUMINUM
   El::mpi::EnsureComm<size_t, El::Collective::SENDRECV>(
@@ -108,8 +109,11 @@ inline static std::string sendrecv_string(lbann_comm const& c,
     El::SyncInfo<El::Device::CPU>{});
 #endif
 
-  if (!c.am_trainer_master())
+  // Either the trainer masters exchange, or every rank exchanges with
+  // the rank in the same position of the partner trainer
+  if (!all_ranks && !c.am_trainer_master())
     return "";
+  int const partner_rank = all_ranks ? c.get_rank_in_trainer() : 0;
 
   // Exchange sizes
   size_t my_size = src.size();
@@ -117,11 +121,11 @@ inline static std::string sendrecv_string(lbann_comm const& c,
   c.sendrecv(&my_size,
              1,
              partner_trainer,
-             0,
+             partner_rank,
              &other_size,
              1,
              partner_trainer,
-             0,
+             partner_rank,
              El::SyncInfo<El::Device::CPU>{});
 
   // Exchange strings
@@ -143,11 +147,11 @@ inline static std::string sendrecv_string(lbann_comm const& c,
     c.sendrecv(send_buf,
                this_blk_send_size,
                partner_trainer,
-               0,
+               partner_rank,
                recv_buf,
                this_blk_recv_size,
                partner_trainer,
-               0,
+               partner_rank,
                El::SyncInfo<El::Device::CPU>{});
 
     send_buf += this_blk_send_size;
@@ -164,19 +168,22 @@ template <typename T>
 inline static void
 exchange(lbann_comm const& c, T& object, El::Int partner_trainer)
 {
+  // Trainers have the same number of ranks, so each rank ships its
+  // own share of the object to its counterpart in the partner trainer.
+  // Matrices are written from and read into their local buffers, and
+  // only redistributed if the partner's distribution differs.
   std::ostringstream oss;
   {
-    RootedBinaryOutputArchive ar(oss, c.get_trainer_grid());
-    c.trainer_barrier();
+    cereal::BinaryOutputArchive ar(oss);
     ar(object);
   }
-  c.trainer_barrier(); // I don't think this is necessary
   {
-    std::istringstream iss{sendrecv_string(c, oss.str(), partner_trainer)};
-    RootedBinaryInputArchive ar(iss, c.get_trainer_grid());
+    std::istringstream iss{
+      sendrecv_string(c, oss.str(), partner_trainer, /*all_ranks=*/true)};
+    cereal::BinaryInputArchive ar(iss);
     ar(object);
   }
-  c.trainer_barrier(); // I don't think this is necessary either
+  c.trainer_barrier();
 }
 
 } // namespace ltfb
@@ -38,10 +38,12 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/protobuf.hpp"
+#include "lbann/weights/data_type_weights.hpp"
 
 #include "lbann/proto/training_algorithm.pb.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <sstream>
@@ -132,19 +134,74 @@ bool local_wins(EvalType local,
   return false; // Silence compiler warning about no return.
 }
 
+/** @brief FNV-1a hash of the local entries of the model's weights.
+ *
+ *  Returns 0 ("unknown") if some weights cannot be hashed.
+ */
+uint64_t weights_fingerprint(model const& m)
+{
+  uint64_t hash = 14695981039346656037ull;
+  El::Matrix<DataType, El::Device::CPU> local;
+  for (auto const* w_ptr : m.get_weights()) {
+    auto const* w = dynamic_cast<data_type_weights<DataType> const*>(w_ptr);
+    if (!w)
+      return 0;
+    El::Copy(w->get_values_sharded().LockedMatrix(), local);
+    for (El::Int col = 0; col < local.Width(); ++col) {
+      auto const* bytes =
+        reinterpret_cast<unsigned char const*>(local.LockedBuffer(0, col));
+      size_t const num_bytes = local.Height() * sizeof(DataType);
+      for (size_t i = 0; i < num_bytes; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+      }
+    }
+  }
+  return hash;
+}
+
 } // namespace
 
+// ExchangeStrategy implementation
+
+void RandomPairwiseExchange::ExchangeStrategy::start_partner_exchange(
+  model const&,
+  El::Int,
+  size_t)
+{
+  LBANN_ERROR("This LTFB exchange strategy cannot overlap the exchange "
+              "with training");
+}
+
+std::unique_ptr<model>
+RandomPairwiseExchange::ExchangeStrategy::finish_partner_exchange(
+  model const&)
+{
+  LBANN_ERROR("This LTFB exchange strategy cannot overlap the exchange "
+              "with training");
+  return nullptr;
+}
+
 // RandomPairwiseExchange implementation
 
 RandomPairwiseExchange::RandomPairwiseExchange(
   std::unordered_map<std::string, metric_strategy> metrics,
   std::unique_ptr<ExchangeStrategy> comm_algo,
-  std::unique_ptr<MutationStrategy> mutate_algo)
+  std::unique_ptr<MutationStrategy> mutate_algo,
+  bool reuse_partner_scores,
+  size_t evaluation_batches)
   : m_metrics{std::move(metrics)},
     m_comm_algo{std::move(comm_algo)},
-    m_mutate_algo{std::move(mutate_algo)}
+    m_mutate_algo{std::move(mutate_algo)},
+    m_reuse_partner_scores{reuse_partner_scores},
+    m_evaluation_batches{evaluation_batches}
 {
   LBANN_ASSERT(m_metrics.size());
+  if (m_reuse_partner_scores && m_comm_algo->overlaps_exchange()) {
+    LBANN_WARNING("LTFB partner scores cannot be reused with an overlapped "
+                  "exchange, since the partner weights are one metaround "
+                  "old; partner models will be evaluated locally");
+  }
 }
 
 RandomPairwiseExchange::RandomPairwiseExchange(
@@ -161,7 +218,9 @@ RandomPairwiseExchange::RandomPairwiseExchange(
   RandomPairwiseExchange const& other)
   : m_metrics{other.m_metrics},
     m_comm_algo{other.m_comm_algo->clone()},
-    m_mutate_algo{other.m_mutate_algo->clone()}
+    m_mutate_algo{other.m_mutate_algo->clone()},
+    m_reuse_partner_scores{other.m_reuse_partner_scores},
+    m_evaluation_batches{other.m_evaluation_batches}
 {}
 
 std::unordered_map<std::string, EvalType>
@@ -184,7 +243,11 @@ RandomPairwiseExchange::evaluate_model(model& m,
   dc.mark_data_store_explicitly_loading(execution_mode::tournament);
 
   // Evaluate model on validation set
-  get_trainer().evaluate(&m, execution_mode::tournament);
+  get_trainer().evaluate(&m, execution_mode::tournament, m_evaluation_batches);
+  if (m_evaluation_batches > 0) {
+    // A partial pass may leave a prefetch in flight
+    dc.collect_background_data_fetch(execution_mode::tournament);
+  }
 
   // Get metric values
   std::unordered_map<std::string, EvalType> metric_values;
@@ -214,6 +277,52 @@ RandomPairwiseExchange::evaluate_model(model& m,
   return metric_values;
 }
 
+std::unordered_map<std::string, EvalType>
+RandomPairwiseExchange::get_partner_scores(
+  model& local_model,
+  model& partner_model,
+  int partner_trainer,
+  std::unordered_map<std::string, EvalType> const& local_scores,
+  LTFBExecutionContext& ctxt,
+  data_coordinator& dc) const
+{
+  if (!m_reuse_partner_scores)
+    return evaluate_model(partner_model, ctxt, dc);
+
+  // Pack the fingerprint and scores in a fixed (sorted) order. Each
+  // rank hashes its own shard, so the exchange is rank-to-rank.
+  auto const& comm = *(local_model.get_comm());
+  std::set<std::string> const names = keys(m_metrics);
+  std::vector<EvalType> local_buf, partner_buf(names.size());
+  for (auto const& name : names)
+    local_buf.push_back(local_scores.at(name));
+  uint64_t const local_hash = weights_fingerprint(local_model);
+  uint64_t partner_hash = 0;
+  comm.sendrecv<uint64_t, El::Device::CPU>(&local_hash,
+                                           1,
+                                           partner_trainer,
+                                           &partner_hash,
+                                           1,
+                                           partner_trainer);
+  comm.sendrecv<EvalType, El::Device::CPU>(local_buf.data(),
+                                           local_buf.size(),
+                                           partner_trainer,
+                                           partner_buf.data(),
+                                           partner_buf.size(),
+                                           partner_trainer);
+
+  int const mismatch =
+    (partner_hash == 0 || partner_hash != weights_fingerprint(partner_model));
+  if (comm.trainer_allreduce(mismatch, El::mpi::MAX))
+    return evaluate_model(partner_model, ctxt, dc);
+
+  std::unordered_map<std::string, EvalType> partner_scores;
+  size_t i = 0;
+  for (auto const& name : names)
+    partner_scores[name] = partner_buf[i++];
+  return partner_scores;
+}
+
 int RandomPairwiseExchange::get_partner_trainer(
   lbann_comm const& comm) const noexcept
 {
@@ -289,6 +398,11 @@ void RandomPairwiseExchange::select_next(model& m,
                                          ltfb::LTFBExecutionContext& ctxt,
                                          data_coordinator& dc) const
 {
+  if (m_comm_algo->overlaps_exchange()) {
+    select_next_overlapped(m, ctxt, dc);
+    return;
+  }
+
   auto const& comm = *(m.get_comm());
   auto const step = ctxt.get_step();
   const std::string message_prefix =
@@ -320,7 +434,12 @@ void RandomPairwiseExchange::select_next(model& m,
 
   LBANN_LOG_WORLD_MASTER(comm, message_prefix, "evaluating partner model...");
 
-  auto const partner_scores = evaluate_model(*partner_model, ctxt, dc);
+  auto const partner_scores = get_partner_scores(m,
+                                                 *partner_model,
+                                                 partner_trainer,
+                                                 local_scores,
+                                                 ctxt,
+                                                 dc);
 
   // If we win, we do nothing. The input model is the winner, so no
   // further action is required. Otherwise, swap models.
@@ -357,6 +476,73 @@ void RandomPairwiseExchange::select_next(model& m,
                            ")");
 }
 
+void RandomPairwiseExchange::select_next_overlapped(
+  model& m,
+  ltfb::LTFBExecutionContext& ctxt,
+  data_coordinator& dc) const
+{
+  auto const& comm = *(m.get_comm());
+  auto const step = ctxt.get_step();
+  const std::string message_prefix =
+    (comm.am_trainer_master() || comm.am_world_master()
+       ? build_string("LTFB (model \"",
+                      m.get_name(),
+                      "\", "
+                      "step ",
+                      step,
+                      "): ")
+       : "");
+
+  // Decide the tournament started at the previous metaround. The
+  // partner weights are one metaround older than the local ones.
+  int const local_trainer = comm.get_trainer_rank();
+  int const partner_trainer = m_comm_algo->pending_partner_trainer();
+  if (partner_trainer >= 0) {
+    LBANN_LOG_WORLD_MASTER(comm,
+                           message_prefix,
+                           "finishing overlapped tournament...");
+
+    auto const local_scores = evaluate_model(m, ctxt, dc);
+    auto partner_model = m_comm_algo->finish_partner_exchange(m);
+    auto const partner_scores = evaluate_model(*partner_model, ctxt, dc);
+
+    int const tournament_winner =
+      (local_is_better(local_scores, partner_scores) ? local_trainer
+                                                     : partner_trainer);
+    if (tournament_winner == partner_trainer) {
+      m = std::move(*partner_model);
+      m_mutate_algo->mutate(m, step);
+
+      auto& trainer = get_trainer();
+      m.setup(trainer.get_max_mini_batch_size(),
+              trainer.get_grids(),
+              /*force*/ true);
+    }
+
+    LBANN_LOG_TRAINER_MASTER(comm,
+                             message_prefix,
+                             "trainer ",
+                             local_trainer,
+                             " selected model from trainer ",
+                             tournament_winner,
+                             " (trainer ",
+                             local_trainer,
+                             " score = ",
+                             stringify(local_scores),
+                             ", trainer ",
+                             partner_trainer,
+                             " score = ",
+                             stringify(partner_scores),
+                             ")");
+  }
+
+  // Start streaming the (possibly new) local model to the next
+  // partner; it is consumed at the next metaround.
+  LBANN_LOG_WORLD_MASTER(comm, message_prefix, "starting tournament...");
+  int const next_partner = get_partner_trainer(comm);
+  m_comm_algo->start_partner_exchange(m, next_partner, step);
+}
+
 } // namespace ltfb
 } // namespace lbann
 
@@ -401,7 +587,10 @@ make_sendrecv_weights(std::set<std::string> weights_names,
   auto const& params = dynamic_cast<SendRecvWeights const&>(msg);
   return std::make_unique<lbann::ltfb::SendRecvWeights>(
     std::move(weights_names),
-    params.exchange_hyperparameters());
+    params.exchange_hyperparameters(),
+    params.overlap_exchange(),
+    params.chunk_size(),
+    params.bf16_transfer());
 }
 
 lbann::ltfb::RandomPairwiseExchange::metric_strategy
@@ -489,5 +678,7 @@ lbann::make<lbann::ltfb::RandomPairwiseExchange>(
   return std::make_unique<lbann::ltfb::RandomPairwiseExchange>(
     std::move(metric_map),
     make_abstract<ExchangeStrategyType>(msg.exchange_strategy()),
-    make_abstract<MutationStrategyType>(msg.mutation_strategy()));
+    make_abstract<MutationStrategyType>(msg.mutation_strategy()),
+    msg.reuse_partner_scores(),
+    msg.evaluation_batches());
 }
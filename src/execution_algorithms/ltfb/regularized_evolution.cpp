@@ -42,7 +42,11 @@
 
 #include "lbann/proto/training_algorithm.pb.h"
 
+#include <zlib.h>
+
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <sstream>
@@ -52,6 +56,48 @@
 
 namespace lbann {
 namespace ltfb {
+namespace {
+
+/** @brief zlib-compress a packed model, prefixed by its size. */
+std::string compress_string(std::string const& in, int level)
+{
+  uint64_t const in_size = in.size();
+  uLongf size = compressBound(in.size());
+  std::string out(sizeof(in_size) + size, '\0');
+  std::memcpy(out.data(), &in_size, sizeof(in_size));
+  int const status =
+    compress2(reinterpret_cast<Bytef*>(out.data() + sizeof(in_size)),
+              &size,
+              reinterpret_cast<Bytef const*>(in.data()),
+              in.size(),
+              level);
+  if (status != Z_OK) {
+    LBANN_ERROR("zlib failed to compress a model (error ", status, ")");
+  }
+  out.resize(sizeof(in_size) + size);
+  return out;
+}
+
+/** @brief Inverse of compress_string. */
+std::string decompress_string(std::string const& in)
+{
+  uint64_t out_size = 0;
+  LBANN_ASSERT(in.size() >= sizeof(out_size));
+  std::memcpy(&out_size, in.data(), sizeof(out_size));
+  std::string out(out_size, '\0');
+  uLongf size = out_size;
+  int const status =
+    uncompress(reinterpret_cast<Bytef*>(out.data()),
+               &size,
+               reinterpret_cast<Bytef const*>(in.data() + sizeof(out_size)),
+               in.size() - sizeof(out_size));
+  if (status != Z_OK || size != out_size) {
+    LBANN_ERROR("zlib failed to decompress a model (error ", status, ")");
+  }
+  return out;
+}
+
+} // namespace
 
 // RegularizedEvolution Implementation
 
@@ -59,18 +105,27 @@ RegularizedEvolution::RegularizedEvolution(
   std::string metric_name,
   metric_strategy winner_strategy,
   std::unique_ptr<MutationStrategy> mutate_algo,
-  int sample_size)
+  int sample_size,
+  int compression_level)
   : m_mutate_algo{std::move(mutate_algo)},
     m_metric_name{std::move(metric_name)},
     m_metric_strategy{std::move(winner_strategy)},
-    m_sample_size{std::move(sample_size)}
-{}
+    m_sample_size{std::move(sample_size)},
+    m_compression_level{compression_level}
+{
+  if (m_compression_level < 0 || m_compression_level > 9) {
+    LBANN_ERROR("Regularized evolution compression level must be in "
+                "[0, 9]; got ",
+                m_compression_level);
+  }
+}
 
 RegularizedEvolution::RegularizedEvolution(RegularizedEvolution const& other)
   : m_mutate_algo{other.m_mutate_algo->clone()},
     m_metric_name{other.m_metric_name},
     m_metric_strategy{other.m_metric_strategy},
-    m_sample_size{other.m_sample_size}
+    m_sample_size{other.m_sample_size},
+    m_compression_level{other.m_compression_level}
 {}
 
 EvalType RegularizedEvolution::evaluate_model(model& m,
@@ -206,10 +261,20 @@ void RegularizedEvolution::select_next(model& m,
     if (winner_id != oldest_id) {
       auto model_string = pack(m);
       if (comm.am_trainer_master()) {
+        size_t const packed_size = model_string.size();
+        if (m_compression_level > 0)
+          model_string = compress_string(model_string, m_compression_level);
         send_string(comm, model_string, oldest_id);
         std::cout << "In Reg Evo step " << step << ", trainer " << trainer_id
                   << " with score " << score_list_all[trainer_id]
-                  << " sends model to trainer " << oldest_id << std::endl;
+                  << " sends model to trainer " << oldest_id;
+        if (m_compression_level > 0) {
+          std::cout << " (" << model_string.size() << " bytes, saved "
+                    << static_cast<long long>(packed_size) -
+                         static_cast<long long>(model_string.size())
+                    << " bytes)";
+        }
+        std::cout << std::endl;
       }
     }
   }
@@ -220,6 +285,8 @@ void RegularizedEvolution::select_next(model& m,
       std::string rcv_str;
       if (comm.am_trainer_master()) {
         rcv_str = recv_string(comm, winner_id);
+        if (m_compression_level > 0)
+          rcv_str = decompress_string(rcv_str);
         std::cout << "In Reg Evo step " << step << ", trainer " << trainer_id
                   << " receives model from trainer " << winner_id << std::endl;
       }
@@ -276,5 +343,6 @@ lbann::make<lbann::ltfb::RegularizedEvolution>(
     msg.metric_name(),
     to_lbann(msg.metric_strategy()),
     make_abstract<MutationStrategyType>(msg.mutation_strategy()),
-    msg.sample_size());
+    msg.sample_size(),
+    msg.compression_level());
 }
@@ -37,6 +37,14 @@
 
 #include "checkpoint_common.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <vector>
+
 namespace {
 bool have_same_optimizer_type(lbann::lbann_comm const& c,
                               lbann::optimizer const& opt,
@@ -55,22 +63,237 @@ bool have_same_optimizer_type(lbann::lbann_comm const& c,
              El::SyncInfo<El::Device::CPU>{});
   return my_type_hash == other_type_hash;
 }
+
+El::Int get_partner_rank_in_world(lbann::lbann_comm const& comm,
+                                  El::Int partner_trainer)
+{
+  const El::Int rank_in_trainer = comm.get_rank_in_trainer();
+  const El::Int procs_per_trainer = comm.get_procs_per_trainer();
+  const bool subgrid = comm.get_grid_type() != lbann::GridType::NO_GRID;
+  return subgrid
+           ? (partner_trainer * procs_per_trainer * 2 + rank_in_trainer)
+           : comm.get_world_rank(partner_trainer, rank_in_trainer);
+}
+
+/** @brief Round an FP32 value to the nearest bfloat16.
+ *
+ *  bfloat16 is the upper half of an FP32 word, so it keeps the FP32
+ *  exponent range and the conversion needs no library support.
+ */
+uint16_t to_bf16(float x)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  if ((bits & 0x7fffffffu) > 0x7f800000u) {
+    // Keep NaNs quiet instead of rounding them to infinity
+    return static_cast<uint16_t>((bits >> 16) | 0x0040u);
+  }
+  bits += 0x7fffu + ((bits >> 16) & 1u);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+float from_bf16(uint16_t x)
+{
+  uint32_t const bits = static_cast<uint32_t>(x) << 16;
+  float y;
+  std::memcpy(&y, &bits, sizeof(y));
+  return y;
+}
+
+using HostMatType = El::Matrix<lbann::DataType, El::Device::CPU>;
+
+/** @brief Column-major bfloat16 copy of a (possibly device) matrix. */
+std::vector<uint16_t> encode_bf16(El::AbstractMatrix<lbann::DataType> const& x)
+{
+  HostMatType host;
+  El::Copy(x, host);
+  std::vector<uint16_t> y(host.Height() * host.Width());
+  for (El::Int col = 0; col < host.Width(); ++col) {
+    for (El::Int row = 0; row < host.Height(); ++row) {
+      y[row + col * host.Height()] =
+        to_bf16(static_cast<float>(host.CRef(row, col)));
+    }
+  }
+  return y;
+}
+
+/** @brief Expand a bfloat16 buffer into a matrix of the same size. */
+void decode_bf16(std::vector<uint16_t> const& x,
+                 El::AbstractMatrix<lbann::DataType>& y)
+{
+  HostMatType host(y.Height(), y.Width());
+  for (El::Int col = 0; col < host.Width(); ++col) {
+    for (El::Int row = 0; row < host.Height(); ++row) {
+      host(row, col) = static_cast<lbann::DataType>(
+        from_bf16(x[row + col * host.Height()]));
+    }
+  }
+  El::Copy(host, y);
+}
+
+/** @brief Post matching non-blocking sends and receives of at most
+ *         @c chunk elements each.
+ *
+ *  Messages between a pair of ranks are matched in order, so a
+ *  single tag suffices.
+ */
+template <typename T>
+void post_chunks(lbann::lbann_comm const& comm,
+                 T const* snd,
+                 T* rcv,
+                 El::Int count,
+                 El::Int chunk,
+                 int partner_rank,
+                 El::mpi::Comm const& c,
+                 std::vector<El::mpi::Request<T>>& requests)
+{
+  for (El::Int offset = 0; offset < count; offset += chunk) {
+    int const size = std::min(chunk, count - offset);
+    requests.emplace_back();
+    comm.nb_tagged_recv(rcv + offset,
+                        size,
+                        partner_rank,
+                        /*tag=*/0,
+                        requests.back(),
+                        c);
+    requests.emplace_back();
+    comm.nb_tagged_send(snd + offset,
+                        size,
+                        partner_rank,
+                        /*tag=*/0,
+                        requests.back(),
+                        c);
+  }
+}
+
+/** @brief Bytes put on the wire and bytes a full-precision exchange
+ *         would have needed. */
+struct transfer_stats
+{
+  size_t sent = 0;
+  size_t full = 0;
+};
+
+/** @brief Exchange equally sized matrices with a partner rank,
+ *         optionally rounded to bfloat16 on the wire. */
+void exchange_matrix(lbann::lbann_comm const& comm,
+                     El::AbstractMatrix<lbann::DataType> const& snd,
+                     El::AbstractMatrix<lbann::DataType>& rcv,
+                     int partner_rank,
+                     bool bf16,
+                     transfer_stats& stats)
+{
+  size_t const count = snd.Height() * snd.Width();
+  stats.full += count * sizeof(lbann::DataType);
+  if (!bf16) {
+    stats.sent += count * sizeof(lbann::DataType);
+    comm.sendrecv_matrix(snd, rcv, partner_rank);
+    return;
+  }
+  stats.sent += count * sizeof(uint16_t);
+  auto const snd_bf16 = encode_bf16(snd);
+  std::vector<uint16_t> rcv_bf16(rcv.Height() * rcv.Width());
+  std::vector<El::mpi::Request<El::byte>> requests;
+  post_chunks(comm,
+              reinterpret_cast<El::byte const*>(snd_bf16.data()),
+              reinterpret_cast<El::byte*>(rcv_bf16.data()),
+              snd_bf16.size() * sizeof(uint16_t),
+              std::numeric_limits<int>::max(),
+              partner_rank,
+              comm.get_world_comm(),
+              requests);
+  comm.wait_all(requests);
+  decode_bf16(rcv_bf16, rcv);
+}
+
+/** @brief Report the savings of a bfloat16 exchange. */
+void report_transfer(lbann::lbann_comm const& comm,
+                     transfer_stats const& stats)
+{
+  size_t const sent = comm.trainer_allreduce(stats.sent);
+  size_t const full = comm.trainer_allreduce(stats.full);
+  if (comm.am_world_master()) {
+    std::cout << "LTFB sendrecv_weights: trainer " << comm.get_trainer_rank()
+              << " sent " << sent << " bytes in bfloat16 (saved "
+              << full - sent << " bytes)" << std::endl;
+  }
+}
 } // namespace
 
 namespace lbann {
 namespace ltfb {
 
+/** Host copies of the exchanged matrices of one weights object.
+ *  Index 0 holds the values, followed by any optimizer state.
+ */
+struct SendRecvWeights::PendingExchange
+{
+  using MatType = El::Matrix<DataType, El::Device::CPU>;
+  struct Entry
+  {
+    std::vector<MatType> send;
+    std::vector<MatType> recv;
+    /** Wire buffers when exchanging in bfloat16. */
+    std::vector<std::vector<uint16_t>> send_bf16;
+    std::vector<std::vector<uint16_t>> recv_bf16;
+    /** Exchange the whole optimizer when the exchange completes. */
+    bool binary_optimizer = false;
+  };
+
+  ~PendingExchange()
+  {
+    if (!requests.empty())
+      El::mpi::WaitAll(requests.size(), requests.data());
+    if (!bf16_requests.empty())
+      El::mpi::WaitAll(bf16_requests.size(), bf16_requests.data());
+    El::mpi::Free(exchange_comm);
+  }
+
+  El::Int partner_trainer = -1;
+  /** Duplicate of the world communicator, so the chunks cannot match
+   *  messages posted by training in the meantime. */
+  El::mpi::Comm exchange_comm;
+  std::map<std::string, Entry> entries;
+  std::vector<El::mpi::Request<DataType>> requests;
+  std::vector<El::mpi::Request<El::byte>> bf16_requests;
+  transfer_stats stats;
+};
+
 SendRecvWeights::SendRecvWeights(std::set<std::string> const& weights_names,
-                                 bool exchange_hyperparameters)
-  : BaseType(weights_names), exchange_hyperparams_{exchange_hyperparameters}
+                                 bool exchange_hyperparameters,
+                                 bool overlap_exchange,
+                                 size_t chunk_size,
+                                 bool bf16_transfer)
+  : BaseType(weights_names),
+    exchange_hyperparams_{exchange_hyperparameters},
+    overlap_exchange_{overlap_exchange},
+    chunk_size_{chunk_size},
+    bf16_transfer_{bf16_transfer}
 {}
 
 SendRecvWeights::SendRecvWeights(std::set<std::string>&& weights_names,
-                                 bool exchange_hyperparameters)
+                                 bool exchange_hyperparameters,
+                                 bool overlap_exchange,
+                                 size_t chunk_size,
+                                 bool bf16_transfer)
   : BaseType(std::move(weights_names)),
-    exchange_hyperparams_{exchange_hyperparameters}
+    exchange_hyperparams_{exchange_hyperparameters},
+    overlap_exchange_{overlap_exchange},
+    chunk_size_{chunk_size},
+    bf16_transfer_{bf16_transfer}
+{}
+
+SendRecvWeights::SendRecvWeights(SendRecvWeights const& other)
+  : BaseType(other),
+    exchange_hyperparams_{other.exchange_hyperparams_},
+    overlap_exchange_{other.overlap_exchange_},
+    chunk_size_{other.chunk_size_},
+    bf16_transfer_{other.bf16_transfer_}
 {}
 
+SendRecvWeights::SendRecvWeights(SendRecvWeights&&) = default;
+SendRecvWeights::~SendRecvWeights() = default;
+
 std::unique_ptr<model>
 SendRecvWeights::get_partner_model(model const& m,
                                    El::Int partner_trainer,
@@ -83,15 +306,12 @@ SendRecvWeights::get_partner_model(model const& m,
   model& partner_model = *partner_model_ptr;
 
   // Get partner process
-  const El::Int rank_in_trainer = comm.get_rank_in_trainer();
-  const El::Int procs_per_trainer = comm.get_procs_per_trainer();
-
-  const bool subgrid = m.get_comm()->get_grid_type() != GridType::NO_GRID;
   const El::Int partner_rank_in_world =
-    (partner_trainer * procs_per_trainer * (subgrid ? 2 : 1) + rank_in_trainer);
+    get_partner_rank_in_world(comm, partner_trainer);
   comm.intertrainer_barrier();
 
   // Exchange weights with partner
+  transfer_stats stats;
   for (auto&& w_ptr : partner_model.get_weights()) {
     // Skip weights if name isn't in list
     auto const& weights_names = this->weights_names();
@@ -105,11 +325,12 @@ SendRecvWeights::get_partner_model(model const& m,
     using WeightsType = data_type_weights<TensorDataType>;
     auto& recv_weights = dynamic_cast<WeightsType&>(*w_ptr);
     auto send_weights = recv_weights;
-    El::SendRecv(send_weights.get_values_sharded().LockedMatrix(),
-                 recv_weights.get_values_sharded().Matrix(),
-                 comm.get_world_comm(),
-                 partner_rank_in_world,
-                 partner_rank_in_world);
+    exchange_matrix(comm,
+                    send_weights.get_values_sharded().LockedMatrix(),
+                    recv_weights.get_values_sharded().Matrix(),
+                    partner_rank_in_world,
+                    bf16_transfer_,
+                    stats);
 
     // If the two weights objects use different optimizers across
     // the set of trainers, we need to be careful about how we
@@ -141,11 +362,12 @@ SendRecvWeights::get_partner_model(model const& m,
       auto* send_sgd = dynamic_cast<SGDType*>(send_weights.get_optimizer());
       auto* recv_sgd = dynamic_cast<SGDType*>(recv_weights.get_optimizer());
       if (send_sgd != nullptr && recv_sgd != nullptr) {
-        El::SendRecv(send_sgd->get_velocity().LockedMatrix(),
-                     recv_sgd->get_velocity().Matrix(),
-                     comm.get_world_comm(),
-                     partner_rank_in_world,
-                     partner_rank_in_world);
+        exchange_matrix(comm,
+                        send_sgd->get_velocity().LockedMatrix(),
+                        recv_sgd->get_velocity().Matrix(),
+                        partner_rank_in_world,
+                        bf16_transfer_,
+                        stats);
         continue;
       }
 
@@ -154,21 +376,179 @@ SendRecvWeights::get_partner_model(model const& m,
       auto* send_adam = dynamic_cast<AdamType*>(send_weights.get_optimizer());
       auto* recv_adam = dynamic_cast<AdamType*>(recv_weights.get_optimizer());
       if (send_adam != nullptr && recv_adam != nullptr) {
-        El::SendRecv(send_adam->get_moment1().LockedMatrix(),
-                     recv_adam->get_moment1().Matrix(),
-                     comm.get_world_comm(),
-                     partner_rank_in_world,
-                     partner_rank_in_world);
-        El::SendRecv(send_adam->get_moment2().LockedMatrix(),
-                     recv_adam->get_moment2().Matrix(),
-                     comm.get_world_comm(),
-                     partner_rank_in_world,
-                     partner_rank_in_world);
+        exchange_matrix(comm,
+                        send_adam->get_moment1().LockedMatrix(),
+                        recv_adam->get_moment1().Matrix(),
+                        partner_rank_in_world,
+                        bf16_transfer_,
+                        stats);
+        exchange_matrix(comm,
+                        send_adam->get_moment2().LockedMatrix(),
+                        recv_adam->get_moment2().Matrix(),
+                        partner_rank_in_world,
+                        bf16_transfer_,
+                        stats);
         continue;
       }
       LBANN_WARNING("Unknown optimizer type. NO EXCHANGE.");
     }
   }
+  if (bf16_transfer_)
+    report_transfer(comm, stats);
+  return partner_model_ptr;
+}
+
+void SendRecvWeights::start_partner_exchange(model const& m,
+                                             El::Int partner_trainer,
+                                             size_t /*step*/)
+{
+  if (pending_) {
+    LBANN_ERROR("An overlapped LTFB exchange with trainer ",
+                pending_->partner_trainer,
+                " is still in flight");
+  }
+  auto& comm = *m.get_comm();
+  const El::Int partner_rank = get_partner_rank_in_world(comm, partner_trainer);
+
+  auto pending = std::make_unique<PendingExchange>();
+  pending->partner_trainer = partner_trainer;
+  El::mpi::Dup(comm.get_world_comm(), pending->exchange_comm);
+
+  using TensorDataType = DataType;
+  using WeightsType = data_type_weights<TensorDataType>;
+  using MatType = PendingExchange::MatType;
+  auto const& weights_names = this->weights_names();
+  for (auto const* w_ptr : m.get_weights()) {
+    if (!weights_names.empty() &&
+        (weights_names.find(w_ptr->get_name()) == weights_names.cend())) {
+      continue;
+    }
+    auto const& w = dynamic_cast<WeightsType const&>(*w_ptr);
+    auto& entry = pending->entries[w.get_name()];
+
+    // Snapshot the matrices, since training keeps updating them
+    auto add_matrix = [&entry](El::AbstractMatrix<TensorDataType> const& x) {
+      entry.send.emplace_back();
+      El::Copy(x, entry.send.back());
+      entry.recv.emplace_back(x.Height(), x.Width());
+    };
+    add_matrix(w.get_values_sharded().LockedMatrix());
+
+    optimizer const* opt = w.get_optimizer();
+    if (!opt)
+      continue;
+    if (exchange_hyperparams_ ||
+        !have_same_optimizer_type(comm, *opt, partner_trainer)) {
+      entry.binary_optimizer = true;
+    }
+    else if (auto const* sgd_opt =
+               dynamic_cast<sgd<TensorDataType> const*>(opt)) {
+      add_matrix(sgd_opt->get_velocity().LockedMatrix());
+    }
+    else if (auto const* adam_opt =
+               dynamic_cast<adam<TensorDataType> const*>(opt)) {
+      add_matrix(adam_opt->get_moment1().LockedMatrix());
+      add_matrix(adam_opt->get_moment2().LockedMatrix());
+    }
+    else {
+      LBANN_WARNING("Unknown optimizer type. NO EXCHANGE.");
+    }
+  }
+
+  // Post all chunks
+  El::Int const max_count = std::numeric_limits<int>::max();
+  El::Int const chunk =
+    (chunk_size_ > 0 ? std::min<El::Int>(chunk_size_, max_count) : max_count);
+  auto& stats = pending->stats;
+  for (auto& [name, entry] : pending->entries) {
+    for (size_t i = 0; i < entry.send.size(); ++i) {
+      MatType& snd = entry.send[i];
+      MatType& rcv = entry.recv[i];
+      El::Int const count = snd.Height() * snd.Width();
+      stats.full += count * sizeof(DataType);
+      if (!bf16_transfer_) {
+        stats.sent += count * sizeof(DataType);
+        post_chunks(comm,
+                    snd.LockedBuffer(),
+                    rcv.Buffer(),
+                    count,
+                    chunk,
+                    partner_rank,
+                    pending->exchange_comm,
+                    pending->requests);
+        continue;
+      }
+      stats.sent += count * sizeof(uint16_t);
+      entry.send_bf16.push_back(encode_bf16(snd));
+      entry.recv_bf16.emplace_back(count);
+      snd.Empty();
+      post_chunks(
+        comm,
+        reinterpret_cast<El::byte const*>(entry.send_bf16.back().data()),
+        reinterpret_cast<El::byte*>(entry.recv_bf16.back().data()),
+        count * El::Int(sizeof(uint16_t)),
+        std::min(chunk * El::Int(sizeof(uint16_t)), max_count),
+        partner_rank,
+        pending->exchange_comm,
+        pending->bf16_requests);
+    }
+  }
+  pending_ = std::move(pending);
+}
+
+El::Int SendRecvWeights::pending_partner_trainer() const noexcept
+{
+  return pending_ ? pending_->partner_trainer : -1;
+}
+
+std::unique_ptr<model> SendRecvWeights::finish_partner_exchange(model const& m)
+{
+  if (!pending_) {
+    LBANN_ERROR("No overlapped LTFB exchange is in flight");
+  }
+  auto& comm = *m.get_comm();
+  comm.wait_all(pending_->requests);
+  comm.wait_all(pending_->bf16_requests);
+  pending_->requests.clear();
+  pending_->bf16_requests.clear();
+  if (bf16_transfer_) {
+    for (auto& [name, entry] : pending_->entries) {
+      for (size_t i = 0; i < entry.recv_bf16.size(); ++i)
+        decode_bf16(entry.recv_bf16[i], entry.recv[i]);
+    }
+    report_transfer(comm, pending_->stats);
+  }
+
+  // Apply the received matrices to a copy of the local model
+  using TensorDataType = DataType;
+  using WeightsType = data_type_weights<TensorDataType>;
+  auto partner_model_ptr = std::make_unique<model>(m);
+  for (auto&& w_ptr : partner_model_ptr->get_weights()) {
+    auto entry_it = pending_->entries.find(w_ptr->get_name());
+    if (entry_it == pending_->entries.end())
+      continue;
+    auto& entry = entry_it->second;
+    auto& w = dynamic_cast<WeightsType&>(*w_ptr);
+    El::Copy(entry.recv[0], w.get_values_sharded().Matrix());
+
+    optimizer* opt = w.get_optimizer();
+    if (!opt)
+      continue;
+    if (entry.binary_optimizer) {
+      auto opt_up = opt->clone();
+      exchange(comm, opt_up, pending_->partner_trainer);
+      opt_up->setup(&w);
+      w.set_optimizer(std::move(opt_up));
+    }
+    else if (auto* sgd_opt = dynamic_cast<sgd<TensorDataType>*>(opt)) {
+      El::Copy(entry.recv[1], sgd_opt->get_velocity().Matrix());
+    }
+    else if (auto* adam_opt = dynamic_cast<adam<TensorDataType>*>(opt)) {
+      El::Copy(entry.recv[1], adam_opt->get_moment1().Matrix());
+      El::Copy(entry.recv[2], adam_opt->get_moment2().Matrix());
+    }
+  }
+  pending_.reset();
   return partner_model_ptr;
 }
 
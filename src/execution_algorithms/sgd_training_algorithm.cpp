@@ -32,11 +32,15 @@
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/optimizers/gradient_fusion.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu_memory_pool.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/timer_map.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+#include "lbann/weights/weights_helpers.hpp"
 
 #include "lbann/proto/training_algorithm.pb.h"
 
@@ -45,6 +49,7 @@
 #include <adiak.hpp>
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -54,15 +59,27 @@ namespace lbann {
 SGDTrainingAlgorithm::SGDTrainingAlgorithm(
   std::string name,
   std::unique_ptr<SGDTerminationCriteria> stop,
-  bool suppress_timer)
+  bool suppress_timer,
+  size_t gradient_accumulation_steps,
+  bool overlap_validation)
   : TrainingAlgorithm{std::move(name)},
     m_timers{"<default>"},
     m_stopping_criteria{std::move(stop)},
     m_validation_context{execution_mode::validation},
     m_validation_epochs{1UL},
-    m_suppress_timer{suppress_timer}
+    m_suppress_timer{suppress_timer},
+    m_gradient_accumulation_steps{
+      std::max(gradient_accumulation_steps, size_t{1})},
+    m_overlap_validation{overlap_validation}
 {}
 
+SGDTrainingAlgorithm::SGDTrainingAlgorithm(SGDTrainingAlgorithm&& other) =
+  default;
+SGDTrainingAlgorithm&
+SGDTrainingAlgorithm::operator=(SGDTrainingAlgorithm&& other) = default;
+
+SGDTrainingAlgorithm::~SGDTrainingAlgorithm() { clear_validation_snapshot(); }
+
 ////////////////////////////////////////////////////////////
 // Evaluation and training
 ////////////////////////////////////////////////////////////
@@ -116,6 +133,10 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
     model.get_objective_function()->set_amp_scale(model.get_amp_scale_factor());
   }
 
+  // The snapshot is made again since the model may have changed
+  // between calls (e.g. in LTFB)
+  clear_validation_snapshot();
+
   // Run callbacks.
   do_train_begin_cbs(model, ScopeTimer{train_timer, "train_begin callbacks"});
 
@@ -131,6 +152,7 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
     model.reset_mode(c, execution_mode::training);
     model.reset_epoch_statistics(execution_mode::training);
     dc.reset_mode(c);
+    c.get_step_timer().reset_statistics();
     do_epoch_begin_cbs(model, ScopeTimer{train_timer, "epoch_begin callbacks"});
 
     // Train a mini batch. Returns "true" if the data_coordinator
@@ -158,6 +180,22 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
                          dc,
                          ScopeTimer{train_timer, "train minibatch"});
       ++total_batches;
+#ifdef LBANN_HAS_GPU
+      // The first step is the warm-up that sizes the memory pool
+      if (total_batches == 1) {
+        const size_t added_bytes = gpu::preallocate_memory_pool();
+        if (added_bytes > 0 && get_trainer().get_comm()->am_world_master()) {
+          std::cout << "Preallocated " << added_bytes / 1048576.0
+                    << " MiB in the GPU memory pool" << std::endl;
+        }
+      }
+#endif // LBANN_HAS_GPU
+      if (m_validation_in_flight) {
+        step_overlapped_validation(
+          c,
+          dc,
+          ScopeTimer{train_timer, "overlapped validation"});
+      }
     }
     LBANN_CALIPER_LOOP_END(train_batch);
 
@@ -168,6 +206,7 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
     // unless requested. Commented out for now to test for any regressions.
     // model.reconcile_weight_values();
 
+    model.flush_accumulated_metrics(execution_mode::training);
     do_epoch_end_cbs(model, ScopeTimer{train_timer, "epoch_end callbacks"});
 
     // Evaluate on validation set
@@ -176,7 +215,15 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
     // move out of the main training cycle and become part of an
     // "evaluation policy" or something of that nature, ideally with
     // its own context that we needn't know about.
-    if (dc.is_execution_mode_valid(execution_mode::validation)) {
+    if (dc.is_execution_mode_valid(execution_mode::validation) &&
+        m_overlap_validation) {
+      start_overlapped_validation(
+        c,
+        model,
+        dc,
+        ScopeTimer{train_timer, "overlapped validation"});
+    }
+    else if (dc.is_execution_mode_valid(execution_mode::validation)) {
       evaluate(evaluation_context,
                model,
                dc,
@@ -192,6 +239,11 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
     }
   }
   LBANN_CALIPER_LOOP_END(train_epoch);
+  finish_overlapped_validation(
+    c,
+    dc,
+    ScopeTimer{train_timer, "overlapped validation"});
+  clear_validation_snapshot();
   c.stop_timer();
 #ifdef LBANN_HAS_CALIPER
   if (is_caliper_initialized()) {
@@ -216,6 +268,7 @@ bool SGDTrainingAlgorithm::train_mini_batch(SGDExecutionContext& c,
                                             data_coordinator& dc,
                                             ScopeTimer timer)
 {
+  c.get_step_timer().start();
   model.reset_mode(c, execution_mode::training);
   dc.reset_mode(c);
   do_batch_begin_cbs(model,
@@ -224,15 +277,91 @@ bool SGDTrainingAlgorithm::train_mini_batch(SGDExecutionContext& c,
 
   bool finished = false;
 
-#ifdef LBANN_HAS_GPU
-  m_data_prefetch_sync_event.synchronize();
-#endif // LBANN_HAS_GPU
+  // Each micro-batch's objective is averaged over its own samples, so
+  // scale the gradients to average over the whole step
+  size_t num_micro_batches = m_gradient_accumulation_steps;
+  auto* const obj = model.get_objective_function();
+  const EvalType amp_scale =
+    model.is_amp_enabled() ? model.get_amp_scale_factor() : EvalType(0);
+  if (num_micro_batches > 1) {
+    obj->set_amp_scale((amp_scale > 0 ? amp_scale : EvalType(1)) /
+                       num_micro_batches);
+  }
 
-  if (get_trainer().background_io_activity_allowed()) {
-    dc.fetch_data_asynchronous(execution_mode::training);
+  // Gradients accumulate in the optimizers' buffers over the
+  // micro-batches. Only the last backprop launches their
+  // synchronization.
+  model.clear_gradients();
+  size_t num_run = num_micro_batches;
+  if (model.get_pipeline() != nullptr) {
+    finished = train_pipeline_micro_batches(model, dc, num_run, timer);
   }
   else {
-    dc.fetch_active_batch_synchronous(execution_mode::training);
+    num_run = 0;
+    while (num_run < num_micro_batches && !finished) {
+      model.set_gradient_sync_deferred(num_run + 1 < num_micro_batches);
+      finished = train_micro_batch(model, dc, timer);
+      ++num_run;
+    }
+  }
+  if (num_micro_batches > 1) {
+    model.set_gradient_sync_deferred(false);
+    obj->set_amp_scale(amp_scale);
+  }
+
+  // When the epoch ends within the step, average over the
+  // micro-batches that were run rather than the ones scheduled
+  if (num_run < num_micro_batches) {
+    model.scale_gradients(EvalType(num_micro_batches) / EvalType(num_run));
+  }
+
+#if defined(LBANN_HAVE_OMP_TASKLOOP)
+  LBANN_OMP_PARALLEL
+  {
+#pragma omp single
+    {
+#endif
+      // Update step
+      {
+        ScopeTimer optimizer_timer{timer, "optimizer*"};
+        EvalType const sync_wait = get_gradient_sync_wait_time();
+        model.update_weights();
+        optimizer_timer.record("gradient sync wait",
+                               get_gradient_sync_wait_time() - sync_wait);
+      }
+      model.update_layers();
+#if defined(LBANN_HAVE_OMP_TASKLOOP)
+    }
+  }
+#endif
+
+  c.inc_step();
+  do_batch_end_cbs(model,
+                   execution_mode::training,
+                   ScopeTimer{timer, "batch_end callbacks"});
+  c.get_step_timer().stop();
+  return finished;
+}
+
+// Returns "true" if the data_coordinator detects the end of an epoch.
+bool SGDTrainingAlgorithm::train_micro_batch(model& model,
+                                             data_coordinator& dc,
+                                             ScopeTimer timer)
+{
+  bool finished = false;
+
+  {
+    ScopeTimer _{timer, "data wait"};
+#ifdef LBANN_HAS_GPU
+    m_data_prefetch_sync_event.synchronize();
+#endif // LBANN_HAS_GPU
+
+    if (get_trainer().background_io_activity_allowed()) {
+      dc.fetch_data_asynchronous(execution_mode::training);
+    }
+    else {
+      dc.fetch_active_batch_synchronous(execution_mode::training);
+    }
   }
 
   El::Int current_mini_batch_size =
@@ -246,7 +375,6 @@ bool SGDTrainingAlgorithm::train_mini_batch(SGDExecutionContext& c,
     {
 #endif
       // Forward prop step
-      model.clear_gradients();
       {
         ScopeTimer _{timer, "forward prop*"};
         model.forward_prop(execution_mode::training);
@@ -277,19 +405,91 @@ bool SGDTrainingAlgorithm::train_mini_batch(SGDExecutionContext& c,
         execution_mode::training,
         current_mini_batch_size);
       model.evaluate_metrics(execution_mode::training, current_mini_batch_size);
-
-      // Update step
-      model.update_weights();
-      model.update_layers();
 #if defined(LBANN_HAVE_OMP_TASKLOOP)
     }
   }
 #endif
 
-  c.inc_step();
-  do_batch_end_cbs(model,
-                   execution_mode::training,
-                   ScopeTimer{timer, "batch_end callbacks"});
+  return finished;
+}
+
+bool SGDTrainingAlgorithm::train_pipeline_micro_batches(
+  model& model,
+  data_coordinator& dc,
+  size_t& num_micro_batches,
+  ScopeTimer timer)
+{
+  auto& pipeline = *model.get_pipeline();
+  auto* const obj = model.get_objective_function();
+  bool finished = false;
+
+  // If the epoch ends within the step, micro-batches past the last one
+  // fetched are dropped from the schedule. Every stage learns this
+  // before running any of them forward.
+  const auto schedule = make_1f1b_schedule(pipeline.get_num_stages(),
+                                           pipeline.get_stage(),
+                                           num_micro_batches);
+  for (const auto& step : schedule) {
+    const size_t micro_batch = step.micro_batch;
+    if (micro_batch >= num_micro_batches) {
+      continue;
+    }
+    if (!step.backward) {
+      {
+        ScopeTimer _{timer, "data wait"};
+#ifdef LBANN_HAS_GPU
+        m_data_prefetch_sync_event.synchronize();
+#endif // LBANN_HAS_GPU
+        if (get_trainer().background_io_activity_allowed()) {
+          dc.fetch_data_asynchronous(execution_mode::training);
+        }
+        else {
+          dc.fetch_active_batch_synchronous(execution_mode::training);
+        }
+      }
+      const El::Int mini_batch_size =
+        dc.get_current_mini_batch_size(execution_mode::training);
+      model.set_current_mini_batch_size(mini_batch_size);
+      pipeline.begin_forward(micro_batch, false);
+      {
+        ScopeTimer _{timer, "forward prop*"};
+        model.forward_prop(execution_mode::training);
+      }
+#ifdef LBANN_HAS_GPU
+      m_data_prefetch_sync_event.record(
+        El::SyncInfo<El::Device::GPU>{}.Stream());
+#endif // LBANN_HAS_GPU
+      obj->start_evaluation(execution_mode::training, mini_batch_size);
+      if (dc.ready_for_next_fetch(execution_mode::training)) {
+        finished = true;
+        num_micro_batches = micro_batch + 1;
+      }
+      obj->finish_evaluation(execution_mode::training, mini_batch_size);
+      model.evaluate_metrics(execution_mode::training, mini_batch_size);
+    }
+    else {
+      model.set_current_mini_batch_size(
+        pipeline.get_mini_batch_size(micro_batch));
+      if (pipeline.needs_replay(micro_batch)) {
+        ScopeTimer _{timer, "forward prop*"};
+        pipeline.begin_forward(micro_batch, true);
+        model.forward_prop(execution_mode::training);
+      }
+      pipeline.begin_backward(micro_batch);
+      // A truncated step is rescaled before its gradients are synced
+      model.set_gradient_sync_deferred(
+        micro_batch + 1 < num_micro_batches ||
+        num_micro_batches < m_gradient_accumulation_steps);
+      obj->differentiate();
+      {
+        ScopeTimer _{timer, "back prop*"};
+        model.backward_prop();
+      }
+      obj->compute_weight_regularization();
+    }
+  }
+  pipeline.end_mini_batch();
+
   return finished;
 }
 
@@ -327,6 +527,7 @@ void SGDTrainingAlgorithm::evaluate(SGDExecutionContext& c,
   model.reset_mode(c, mode);
   // Ensure that the data coordinator has the right execution context
   dc.reset_mode(c);
+  c.get_step_timer().reset_statistics();
   // Return early if execution mode is invalid
   if (!dc.is_execution_mode_valid(mode))
     return;
@@ -356,6 +557,7 @@ void SGDTrainingAlgorithm::evaluate(SGDExecutionContext& c,
       c.inc_epoch();
   }
   LBANN_CALIPER_LOOP_END(eval_batch);
+  model.flush_accumulated_metrics(mode);
   do_evaluate_end_cbs(model,
                       mode,
                       ScopeTimer{eval_timer, "eval_end callbacks"});
@@ -367,20 +569,46 @@ bool SGDTrainingAlgorithm::evaluate_mini_batch(SGDExecutionContext& c,
                                                execution_mode mode,
                                                ScopeTimer timer)
 {
+  bool const finished = begin_evaluate_mini_batch(c, model, dc, mode, timer);
+  end_evaluate_mini_batch(c, model, mode, timer);
+  return finished;
+}
+
+bool SGDTrainingAlgorithm::begin_evaluate_mini_batch(SGDExecutionContext& c,
+                                                     model& model,
+                                                     data_coordinator& dc,
+                                                     execution_mode mode,
+                                                     ScopeTimer timer)
+{
+  c.get_step_timer().start();
   model.reset_mode(c, mode);
   dc.reset_mode(c);
   do_batch_begin_cbs(model, mode, ScopeTimer{timer, "batch_begin callbacks"});
-  if (get_trainer().background_io_activity_allowed()) {
-    dc.fetch_data_asynchronous(mode);
-  }
-  else {
-    dc.fetch_active_batch_synchronous(mode);
+  {
+    ScopeTimer _{timer, "data wait"};
+    if (get_trainer().background_io_activity_allowed()) {
+      dc.fetch_data_asynchronous(mode);
+    }
+    else {
+      dc.fetch_active_batch_synchronous(mode);
+    }
   }
   El::Int current_mini_batch_size = dc.get_current_mini_batch_size(mode);
   model.set_current_mini_batch_size(current_mini_batch_size);
-  model.forward_prop(mode);
-  bool const finished = dc.ready_for_next_fetch(mode);
+  {
+    ScopeTimer _{timer, "forward prop*"};
+    model.forward_prop(mode);
+  }
+  return dc.ready_for_next_fetch(mode);
+}
 
+void SGDTrainingAlgorithm::end_evaluate_mini_batch(SGDExecutionContext& c,
+                                                   model& model,
+                                                   execution_mode mode,
+                                                   ScopeTimer timer)
+{
+  model.reset_mode(c, mode);
+  El::Int const current_mini_batch_size = model.get_current_mini_batch_size();
   model.get_objective_function()->start_evaluation(mode,
                                                    current_mini_batch_size);
   model.get_objective_function()->finish_evaluation(mode,
@@ -389,7 +617,127 @@ bool SGDTrainingAlgorithm::evaluate_mini_batch(SGDExecutionContext& c,
   model.update_layers();
   c.inc_step();
   do_batch_end_cbs(model, mode, ScopeTimer{timer, "batch_end callbacks"});
-  return finished;
+  c.get_step_timer().stop();
+}
+
+////////////////////////////////////////////////////////////
+// Overlapped validation
+////////////////////////////////////////////////////////////
+
+void SGDTrainingAlgorithm::start_overlapped_validation(SGDExecutionContext& c,
+                                                       model& model,
+                                                       data_coordinator& dc,
+                                                       ScopeTimer timer)
+{
+  // A validation epoch longer than a training epoch runs out here
+  finish_overlapped_validation(c, dc, timer);
+
+  if (m_validation_snapshot == nullptr) {
+    auto snapshot = std::make_unique<lbann::model>(model);
+    snapshot->set_callbacks({});
+    for (auto* w : snapshot->get_weights()) {
+      w->set_optimizer(nullptr);
+    }
+#ifdef LBANN_HAS_GPU
+    m_validation_stream = El::CreateNewSyncInfo<El::Device::GPU>();
+    snapshot->set_forward_stream(m_validation_stream);
+#endif // LBANN_HAS_GPU
+    auto& trainer = get_trainer();
+    snapshot->setup(trainer.get_max_mini_batch_size(),
+                    trainer.get_grids(),
+                    /*force*/ true);
+    snapshot->set_callbacks(model.get_callbacks_with_ownership());
+    m_validation_snapshot = std::move(snapshot);
+  }
+  else {
+    // Copy the weights on the default stream, which the snapshot's
+    // forward prop waits for
+    auto const src_weights = model.get_weights();
+    auto const dst_weights = m_validation_snapshot->get_weights();
+    if (src_weights.size() != dst_weights.size()) {
+      LBANN_ERROR("model \"",
+                  model.get_name(),
+                  "\" has ",
+                  src_weights.size(),
+                  " weights, but its validation snapshot has ",
+                  dst_weights.size());
+    }
+    for (size_t i = 0; i < src_weights.size(); ++i) {
+      weights_details::copy_values(*src_weights[i], *dst_weights[i]);
+    }
+  }
+
+  auto& snapshot = *m_validation_snapshot;
+  auto& vc = m_validation_context;
+  constexpr auto mode = execution_mode::validation;
+  ++m_validation_epochs;
+  snapshot.reset_epoch_statistics(mode);
+  snapshot.reset_mode(vc, mode);
+  dc.reset_mode(vc);
+  vc.get_step_timer().reset_statistics();
+  do_evaluate_begin_cbs(snapshot,
+                        mode,
+                        ScopeTimer{timer, "eval_begin callbacks"});
+  if (get_trainer().background_io_activity_allowed()) {
+    dc.fetch_active_batch_synchronous(mode);
+    snapshot.set_current_mini_batch_size(dc.get_current_mini_batch_size(mode));
+  }
+  m_validation_epoch_done =
+    begin_evaluate_mini_batch(vc, snapshot, dc, mode, timer);
+  m_validation_in_flight = true;
+  dc.reset_mode(c);
+}
+
+void SGDTrainingAlgorithm::step_overlapped_validation(SGDExecutionContext& c,
+                                                      data_coordinator& dc,
+                                                      ScopeTimer timer)
+{
+  auto& snapshot = *m_validation_snapshot;
+  auto& vc = m_validation_context;
+  constexpr auto mode = execution_mode::validation;
+
+  // The forward prop ran alongside the last training step
+  snapshot.join_layer_streams();
+  end_evaluate_mini_batch(vc, snapshot, mode, timer);
+  if (m_validation_epoch_done) {
+    vc.inc_epoch();
+    snapshot.flush_accumulated_metrics(mode);
+    do_evaluate_end_cbs(snapshot,
+                        mode,
+                        ScopeTimer{timer, "eval_end callbacks"});
+    c.set_early_stop(vc.get_early_stop());
+    m_validation_in_flight = false;
+  }
+  else {
+    m_validation_epoch_done =
+      begin_evaluate_mini_batch(vc, snapshot, dc, mode, timer);
+  }
+  dc.reset_mode(c);
+}
+
+void SGDTrainingAlgorithm::finish_overlapped_validation(SGDExecutionContext& c,
+                                                        data_coordinator& dc,
+                                                        ScopeTimer timer)
+{
+  while (m_validation_in_flight) {
+    step_overlapped_validation(c, dc, timer);
+  }
+}
+
+void SGDTrainingAlgorithm::clear_validation_snapshot()
+{
+  if (m_validation_snapshot == nullptr) {
+    return;
+  }
+#ifdef LBANN_HAS_GPU
+  // The snapshot may still free memory on its stream
+  El::Synchronize(m_validation_stream);
+  m_validation_snapshot.reset();
+  El::DestroySyncInfo(m_validation_stream);
+#else
+  m_validation_snapshot.reset();
+#endif // LBANN_HAS_GPU
+  m_validation_in_flight = false;
 }
 
 std::unique_ptr<SGDExecutionContext>
@@ -586,5 +934,7 @@ lbann::make<lbann::SGDTrainingAlgorithm>(
   return std::make_unique<SGDTrainingAlgorithm>(
     params.name(),
     std::move(stopping),
-    sgd_params.suppress_timer_output());
+    sgd_params.suppress_timer_output(),
+    sgd_params.gradient_accumulation_steps(),
+    sgd_params.overlap_validation());
 }
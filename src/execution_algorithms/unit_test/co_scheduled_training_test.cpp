@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/data_ingestion/data_coordinator.hpp>
+#include <lbann/execution_algorithms/co_scheduled_training.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <cmath>
+#include <sstream>
+
+namespace {
+
+// Weights minimized through their squared L2 norm, so each SGD step
+// scales them by 1 - 2*learn_rate
+std::string const model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "l2"
+    }
+  }
+  layer {
+    name: "inp"
+    children: "l2"
+    weights: "w"
+    weights_layer {
+      dims: 3
+    }
+  }
+  layer {
+    name: "l2"
+    parents: "inp"
+    l2_norm2 {
+    }
+  }
+  weights {
+    name: "w"
+    initializer {
+      value_initializer {
+        values: 1.0
+        values: -2.0
+        values: 0.5
+      }
+    }
+  }
+}
+)ptext";
+
+constexpr uint64_t mini_batch_size = 2;
+constexpr uint64_t batches_per_epoch = 2;
+const std::vector<float> initial_values = {1.f, -2.f, 0.5f};
+
+/** Hands out empty mini-batches of a fixed size, since the models
+ *  have no input layers
+ */
+class counting_data_coordinator final : public lbann::data_coordinator
+{
+public:
+  counting_data_coordinator(lbann::lbann_comm* comm) : data_coordinator(comm)
+  {}
+  void setup_data_fields(uint64_t) override {}
+  void fetch_active_batch_synchronous(lbann::execution_mode) override
+  {
+    ++m_num_fetches;
+  }
+  void fetch_data_asynchronous(lbann::execution_mode) override {}
+  bool ready_for_next_fetch(lbann::execution_mode) override
+  {
+    return m_num_fetches % batches_per_epoch == 0;
+  }
+  void collect_background_data_fetch(lbann::execution_mode) override {}
+  const El::Matrix<El::Int>*
+  get_sample_indices_per_mb(lbann::execution_mode) const override
+  {
+    return nullptr;
+  }
+  El::Matrix<El::Int>* get_sample_indices_per_mb(lbann::execution_mode) override
+  {
+    return nullptr;
+  }
+  uint64_t get_current_mini_batch_size(lbann::execution_mode) const override
+  {
+    return mini_batch_size;
+  }
+
+  uint64_t get_num_fetches() const noexcept { return m_num_fetches; }
+
+private:
+  uint64_t m_num_fetches = 0;
+};
+
+std::unique_ptr<lbann::model> make_model(double learn_rate)
+{
+  std::ostringstream ss;
+  ss << model_prototext << "optimizer {\n"
+     << "  sgd {\n"
+     << "    learn_rate: " << learn_rate << "\n"
+     << "  }\n"
+     << "}\n";
+  return unit_test::utilities::construct_model(ss.str());
+}
+
+void check_values(lbann::model& m, float learn_rate, size_t steps)
+{
+  auto const& w =
+    dynamic_cast<lbann::data_type_weights<float>&>(*m.get_weights().front());
+  auto const& values = w.get_values();
+  const float scale = std::pow(1.f - 2.f * learn_rate, steps);
+  REQUIRE(values.Height() == static_cast<El::Int>(initial_values.size()));
+  for (size_t i = 0; i < initial_values.size(); ++i) {
+    CHECK(values.Get(i, 0) == Approx(scale * initial_values[i]));
+  }
+}
+
+} // namespace
+
+TEST_CASE("Co-scheduled training", "[mpi][algorithm]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  std::vector<std::unique_ptr<lbann::model>> models;
+  models.push_back(make_model(0.1));
+  models.push_back(make_model(0.25));
+  lbann::co_scheduled_training co(std::move(models),
+                                  {&comm.get_trainer_grid()},
+                                  mini_batch_size);
+  REQUIRE(co.get_num_models() == 2);
+  counting_data_coordinator dc(&comm);
+
+  SECTION("Each model follows its own optimizer")
+  {
+    co.train(dc, lbann::BatchTerminationCriteria(3));
+    CHECK(dc.get_num_fetches() == 3);
+    for (size_t i = 0; i < 2; ++i) {
+      CHECK(co.get_execution_context(i).get_step() == 3);
+      CHECK(co.get_execution_context(i).get_epoch() == 2);
+    }
+    check_values(co.get_model(0), 0.1f, 3);
+    check_values(co.get_model(1), 0.25f, 3);
+  }
+
+  SECTION("A stopped model sits out while the other trains")
+  {
+    co.train(dc, lbann::BatchTerminationCriteria(1));
+    co.get_execution_context(1).set_early_stop(true);
+    co.train(dc, lbann::BatchTerminationCriteria(4));
+    CHECK(dc.get_num_fetches() == 4);
+    CHECK(co.get_execution_context(0).get_step() == 4);
+    CHECK(co.get_execution_context(1).get_step() == 1);
+    check_values(co.get_model(0), 0.1f, 4);
+    check_values(co.get_model(1), 0.25f, 1);
+  }
+}
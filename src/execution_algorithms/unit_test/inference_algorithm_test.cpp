@@ -32,12 +32,19 @@
 #include "lbann/objective_functions/objective_function.hpp"
 #include <lbann/base.hpp>
 #include <lbann/execution_algorithms/batch_functional_inference_algorithm.hpp>
+#include <lbann/execution_algorithms/ensemble_inference.hpp>
+#include <lbann/execution_algorithms/inference_server.hpp>
 #include <lbann/models/model.hpp>
 #include <lbann/utils/lbann_library.hpp>
 
 #include "lbann/proto/lbann.pb.h"
 #include <google/protobuf/text_format.h>
 
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
 namespace pb = ::google::protobuf;
 
 namespace {
@@ -123,3 +130,87 @@ TEST_CASE("Test batch_function_inference_algorithm", "[inference]")
     }
   }
 }
+
+TEST_CASE("Test inference_server", "[inference]")
+{
+  using DataType = float;
+  int mbs_class_n = 4;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  std::unique_ptr<lbann::model> model = make_model<DataType>(comm, mbs_class_n);
+  lbann::inference_server server(model.get(),
+                                 mbs_class_n,
+                                 mbs_class_n,
+                                 std::chrono::milliseconds(5));
+
+  SECTION("Requests are batched and answered")
+  {
+    // Submit one-hot samples from a client thread on the trainer master
+    // while every rank serves
+    std::vector<int> labels;
+    std::thread client([&]() {
+      if (comm.am_trainer_master()) {
+        std::vector<std::future<int>> results;
+        for (int i = 0; i < 2 * mbs_class_n + 1; ++i) {
+          std::vector<DataType> sample(mbs_class_n, 0.f);
+          sample[i % mbs_class_n] = 1.f;
+          results.push_back(server.submit(std::move(sample)));
+        }
+        for (auto& r : results) {
+          labels.push_back(r.get());
+        }
+      }
+      server.shutdown();
+    });
+    server.serve();
+    client.join();
+
+    if (comm.am_trainer_master()) {
+      REQUIRE(labels.size() == static_cast<size_t>(2 * mbs_class_n + 1));
+      for (size_t i = 0; i < labels.size(); ++i) {
+        CHECK(labels[i] == static_cast<int>(i) % mbs_class_n);
+      }
+      auto stats = server.get_statistics();
+      CHECK(stats.num_requests == labels.size());
+      CHECK(stats.num_batches >= 3);
+      CHECK(stats.latency_p99 >= stats.latency_p50);
+    }
+  }
+}
+
+TEST_CASE("Test ensemble_inference", "[inference]")
+{
+  using DataType = float;
+  int mbs_class_n = 4;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  std::vector<std::unique_ptr<lbann::model>> models;
+  models.push_back(make_model<DataType>(comm, mbs_class_n));
+  models.push_back(std::make_unique<lbann::model>(*models.front()));
+  models.back()->setup(mbs_class_n, {&comm.get_trainer_grid()});
+  lbann::ensemble_inference ensemble(std::move(models),
+                                     {&comm.get_trainer_grid()},
+                                     1);
+  REQUIRE(ensemble.get_num_models() == 2);
+
+  SECTION("Every model and the ensemble predict the one-hot category")
+  {
+    // Two mini-batches, the second one partial
+    const int num_samples = mbs_class_n + 2;
+    El::Matrix<DataType, El::Device::CPU> samples(mbs_class_n, num_samples);
+    El::Zero(samples);
+    for (int i = 0; i < num_samples; ++i) {
+      samples(i % mbs_class_n, i) = 1.f;
+    }
+
+    El::Matrix<int, El::Device::CPU> model_labels;
+    auto labels = ensemble.infer(samples, mbs_class_n, &model_labels);
+    REQUIRE(labels.Height() == num_samples);
+    REQUIRE(model_labels.Width() == 2);
+    for (int i = 0; i < num_samples; ++i) {
+      CHECK(labels(i, 0) == i % mbs_class_n);
+      CHECK(model_labels(i, 0) == i % mbs_class_n);
+      CHECK(model_labels(i, 1) == i % mbs_class_n);
+    }
+  }
+}
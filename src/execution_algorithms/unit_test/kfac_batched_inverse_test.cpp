@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/execution_algorithms/kfac/kfac_util.hpp"
+
+#include <vector>
+
+namespace {
+
+using lbann::DataType;
+using CPUMatType = El::Matrix<DataType, El::Device::CPU>;
+
+/** Deterministic symmetric positive definite factor */
+CPUMatType make_factor(El::Int height, El::Int seed)
+{
+  CPUMatType B(height, height), A;
+  for (El::Int j = 0; j < height; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      B(i, j) = DataType(((i * 7 + j * 3 + seed) % 11) - 5) / DataType(8);
+    }
+  }
+  El::Identity(A, height, height);
+  El::Gemm(El::NORMAL, El::TRANSPOSE, DataType(1), B, B, DataType(1), A);
+  return A;
+}
+
+struct factor_spec
+{
+  El::Int height;
+  DataType damping;
+  DataType damping_bn_err;
+  bool is_bn;
+};
+
+template <El::Device Device>
+void check_batched_inverse(std::vector<factor_spec> const& specs)
+{
+  using MatType = El::Matrix<DataType, Device>;
+  std::vector<MatType> factors(specs.size()), inverses(specs.size());
+  lbann::kfac::batched_inverse<Device> batch;
+  for (size_t i = 0; i < specs.size(); ++i) {
+    auto const& s = specs[i];
+    El::Copy(make_factor(s.height, i), factors[i]);
+    inverses[i].Resize(s.height, s.height);
+    REQUIRE(batch.add(factors[i],
+                      inverses[i],
+                      s.damping,
+                      s.damping_bn_err,
+                      s.is_bn));
+  }
+  REQUIRE(batch.size() == specs.size());
+  batch.run();
+  CHECK(batch.empty());
+
+  for (size_t i = 0; i < specs.size(); ++i) {
+    auto const& s = specs[i];
+    auto const sync_info = El::SyncInfoFromMatrix(factors[i]);
+    MatType expected(s.height, s.height), Linv(s.height, s.height);
+    lbann::kfac::get_matrix_inverse<Device>(expected,
+                                            Linv,
+                                            factors[i],
+                                            false,
+                                            s.damping,
+                                            s.damping_bn_err,
+                                            s.is_bn,
+                                            sync_info);
+    CPUMatType expected_cpu, result_cpu;
+    El::Copy(expected, expected_cpu);
+    El::Copy(inverses[i], result_cpu);
+    for (El::Int col = 0; col < s.height; ++col) {
+      for (El::Int row = 0; row < s.height; ++row) {
+        CHECK(result_cpu(row, col) ==
+              Approx(expected_cpu(row, col)).margin(1e-4));
+      }
+    }
+  }
+}
+
+template <El::Device Device>
+void check_batched_inverse()
+{
+  SECTION("Single factor")
+  {
+    check_batched_inverse<Device>({{5, 0.1, 0.1, false}});
+  }
+  SECTION("Groups of same-sized factors")
+  {
+    check_batched_inverse<Device>({{3, 0.1, 0.1, false},
+                                   {6, 0.01, 0.01, false},
+                                   {3, 0.5, 0.5, false},
+                                   {6, 0.2, 0.2, false},
+                                   {3, 1e-3, 1e-3, false}});
+  }
+  SECTION("Batch-normalization factors")
+  {
+    check_batched_inverse<Device>({{4, 0.1, 0.3, true},
+                                   {4, 0.05, 0.2, true},
+                                   {4, 0.1, 0.1, false}});
+  }
+  SECTION("Largest batched factors")
+  {
+    constexpr auto height = lbann::kfac::batched_inverse<Device>::max_height;
+    check_batched_inverse<Device>({{height, 0.1, 0.1, false},
+                                   {height, 0.2, 0.2, false}});
+  }
+  SECTION("Larger factors are not batched")
+  {
+    constexpr auto height =
+      lbann::kfac::batched_inverse<Device>::max_height + 1;
+    El::Matrix<DataType, Device> A, Ainv(height, height);
+    El::Copy(make_factor(height, 0), A);
+    lbann::kfac::batched_inverse<Device> batch;
+    CHECK_FALSE(batch.add(A, Ainv, 0.1, 0.1, false));
+    CHECK(batch.empty());
+  }
+}
+
+} // namespace
+
+TEST_CASE("K-FAC batched inverse matches per-factor inverse",
+          "[kfac][algorithm]")
+{
+  SECTION("CPU") { check_batched_inverse<El::Device::CPU>(); }
+#ifdef LBANN_HAS_GPU
+  SECTION("GPU") { check_batched_inverse<El::Device::GPU>(); }
+#endif // LBANN_HAS_GPU
+}
@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/execution_algorithms/kfac/kfac_util.hpp"
+
+#include <vector>
+
+#ifdef LBANN_HAS_HALF
+TEST_CASE("K-FAC factors reduced in FP16", "[mpi][kfac][algorithm]")
+{
+  using MatType = El::Matrix<lbann::DataType, El::Device::CPU>;
+  auto& comm = unit_test::utilities::current_world_comm();
+  const int rank = comm.get_rank_in_trainer();
+  const int num_procs = comm.get_procs_per_trainer();
+  constexpr El::Int block_height = 16;
+
+  // Each process owns one block. Every contribution is close to the
+  // FP16 limit, so the sum only fits if it is scaled down first.
+  auto contribution = [](El::Int i) {
+    return lbann::DataType(40000.f * (1.f + float(i) / 64.f));
+  };
+  std::vector<MatType> factors(num_procs);
+  std::vector<std::pair<size_t, El::AbstractMatrix<lbann::DataType>*>> blocks;
+  for (int p = 0; p < num_procs; ++p) {
+    factors[p].Resize(block_height, 1);
+    for (El::Int i = 0; i < block_height; ++i) {
+      factors[p](i, 0) = contribution(i);
+    }
+    blocks.emplace_back(p, &factors[p]);
+  }
+
+  MatType global_buffer(block_height * num_procs, 1);
+  using lbann::kfac::kfac_reduce_scatter_mode;
+  lbann::kfac::reduce_scatter_blocks(blocks,
+                                     global_buffer,
+                                     &comm,
+                                     kfac_reduce_scatter_mode::ALLREDUCE,
+                                     true);
+  for (El::Int i = 0; i < block_height; ++i) {
+    CHECK(factors[rank](i, 0) ==
+          Approx(num_procs * contribution(i)).epsilon(2e-3));
+  }
+}
+#endif // LBANN_HAS_HALF
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/execution_algorithms/kfac/kfac_util.hpp"
+
+#include <vector>
+
+TEST_CASE("Balanced K-FAC inverse assignment", "[kfac][algorithm]")
+{
+  using lbann::kfac::balance_inverse_assignment;
+  std::vector<size_t> ranks;
+
+  SECTION("Large blocks are spread across processes")
+  {
+    // One 2048-wide factor dominates a handful of small ones
+    const std::vector<double> costs = {8., 2048., 64., 8., 512., 64.};
+    const auto loads = balance_inverse_assignment(costs, 3, ranks);
+    REQUIRE(ranks.size() == costs.size());
+    REQUIRE(loads.size() == 3);
+    CHECK(ranks[1] == 0);
+    CHECK(ranks[4] == 1);
+    CHECK(loads[0] == 2048.);
+    CHECK(loads[1] == 512.);
+    CHECK(loads[2] == 144.);
+  }
+
+  SECTION("Loads add up to the total cost")
+  {
+    const std::vector<double> costs = {5., 4., 3., 3., 3.};
+    const auto loads = balance_inverse_assignment(costs, 2, ranks);
+    std::vector<double> check(2, 0.);
+    for (size_t i = 0; i < costs.size(); ++i)
+      check[ranks[i]] += costs[i];
+    CHECK(check == loads);
+  }
+
+  SECTION("Ties are broken deterministically")
+  {
+    const std::vector<double> costs(4, 1.);
+    balance_inverse_assignment(costs, 4, ranks);
+    CHECK(ranks == std::vector<size_t>{0, 1, 2, 3});
+  }
+
+  SECTION("Zero processes is an error")
+  {
+    CHECK_THROWS(balance_inverse_assignment({1.}, 0, ranks));
+  }
+}
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/execution_algorithms/kfac/kfac_util.hpp"
+
+namespace {
+
+using lbann::DataType;
+using CPUMatType = El::Matrix<DataType, El::Device::CPU>;
+
+/** Factor with eigenvalues 10, 6 and then 2, so that a rank-3 view
+ *  with a flat tail at the smallest resolved eigenvalue is exact.
+ *  The eigenvectors are the columns of a Householder reflection. */
+CPUMatType make_factor(El::Int height)
+{
+  CPUMatType v(height, 1), H, D, HD, A;
+  for (El::Int i = 0; i < height; ++i) {
+    v(i, 0) = DataType(1 + (i * 5) % 7);
+  }
+  const DataType norm_sq = El::Dot(v, v);
+  El::Identity(H, height, height);
+  El::Gemm(El::NORMAL,
+           El::TRANSPOSE,
+           DataType(-2) / norm_sq,
+           v,
+           v,
+           DataType(1),
+           H);
+  El::Identity(D, height, height);
+  El::Scale(DataType(2), D);
+  D(0, 0) = 10;
+  D(1, 1) = 6;
+  El::Gemm(El::NORMAL, El::NORMAL, DataType(1), H, D, HD);
+  El::Gemm(El::NORMAL, El::TRANSPOSE, DataType(1), HD, H, A);
+  return A;
+}
+
+template <El::Device Device>
+CPUMatType exact_inverse(El::Matrix<DataType, Device> const& A,
+                         DataType damping)
+{
+  El::Matrix<DataType, Device> Ainv(A.Height(), A.Width()),
+    Linv(A.Height(), A.Width());
+  lbann::kfac::get_matrix_inverse<Device>(Ainv,
+                                          Linv,
+                                          A,
+                                          false,
+                                          damping,
+                                          damping,
+                                          false,
+                                          El::SyncInfoFromMatrix(A));
+  CPUMatType Ainv_cpu;
+  El::Copy(Ainv, Ainv_cpu);
+  return Ainv_cpu;
+}
+
+void check_close(CPUMatType const& result, CPUMatType const& expected)
+{
+  REQUIRE(result.Height() == expected.Height());
+  REQUIRE(result.Width() == expected.Width());
+  for (El::Int col = 0; col < expected.Width(); ++col) {
+    for (El::Int row = 0; row < expected.Height(); ++row) {
+      CHECK(result(row, col) == Approx(expected(row, col)).margin(1e-4));
+    }
+  }
+}
+
+template <El::Device Device>
+void check_low_rank_inverse()
+{
+  using MatType = El::Matrix<DataType, Device>;
+  constexpr El::Int height = 12;
+  constexpr DataType damping = 0.1;
+  MatType A, Ainv, Linv, basis;
+  El::Copy(make_factor(height), A);
+  auto const sync_info = El::SyncInfoFromMatrix(A);
+  auto const expected = exact_inverse<Device>(A, damping);
+
+  SECTION("Warm-started subspace iteration converges")
+  {
+    constexpr size_t rank = 3;
+    for (int step = 0; step < 30; ++step) {
+      lbann::kfac::get_matrix_inverse_low_rank<Device>(Ainv,
+                                                       Linv,
+                                                       basis,
+                                                       A,
+                                                       rank,
+                                                       false,
+                                                       damping,
+                                                       sync_info);
+      REQUIRE(basis.Height() == height);
+      REQUIRE(basis.Width() == El::Int(rank));
+    }
+    CPUMatType result;
+    El::Copy(Ainv, result);
+    check_close(result, expected);
+
+    // The basis holds orthonormal eigenvectors
+    CPUMatType basis_cpu, gram;
+    El::Copy(basis, basis_cpu);
+    El::Gemm(El::TRANSPOSE,
+             El::NORMAL,
+             DataType(1),
+             basis_cpu,
+             basis_cpu,
+             gram);
+    for (El::Int j = 0; j < gram.Width(); ++j) {
+      for (El::Int i = 0; i < gram.Height(); ++i) {
+        CHECK(gram(i, j) == Approx(i == j ? 1 : 0).margin(1e-4));
+      }
+    }
+  }
+
+  SECTION("Large ranks fall back to the full eigendecomposition")
+  {
+    CPUMatType init;
+    El::Gaussian(init, height, 2);
+    El::Copy(init, basis);
+    for (size_t rank : {size_t(0), size_t(height / 2 + 1)}) {
+      lbann::kfac::get_matrix_inverse_low_rank<Device>(Ainv,
+                                                       Linv,
+                                                       basis,
+                                                       A,
+                                                       rank,
+                                                       false,
+                                                       damping,
+                                                       sync_info);
+      CHECK(basis.Height() == 0);
+      CPUMatType result;
+      El::Copy(Ainv, result);
+      check_close(result, expected);
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("K-FAC low-rank inverse", "[kfac][algorithm]")
+{
+  SECTION("CPU") { check_low_rank_inverse<El::Device::CPU>(); }
+#ifdef LBANN_HAS_GPU
+  SECTION("GPU") { check_low_rank_inverse<El::Device::GPU>(); }
+#endif // LBANN_HAS_GPU
+}
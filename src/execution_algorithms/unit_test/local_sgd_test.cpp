@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/local_sgd.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
+#include <lbann/execution_algorithms/sgd_training_algorithm.hpp>
+#include <lbann/io/persist.hpp>
+#include <lbann/trainers/trainer.hpp>
+
+namespace {
+
+std::string const checkpointed_model_prototext = R"ptext(
+model {
+  layer {
+    name: "inp"
+    children: "out"
+    weights_layer {
+      dims: 4
+    }
+  }
+  layer {
+    name: "out"
+    parents: "inp"
+    dummy {
+    }
+  }
+  callback {
+    checkpoint {
+      checkpoint_dir: "local_sgd_ckpt"
+      checkpoint_epochs: 1
+    }
+  }
+}
+)ptext";
+
+} // namespace
+
+TEST_CASE("Local SGD rejects checkpointing", "[mpi][algorithm]")
+{
+  auto m = unit_test::utilities::construct_model(checkpointed_model_prototext);
+  auto& trainer = lbann::get_trainer();
+
+  lbann::LocalSGD algo(
+    "local_sgd",
+    std::make_unique<lbann::SGDTrainingAlgorithm>(
+      "sgd",
+      std::make_unique<lbann::BatchTerminationCriteria>(1UL),
+      /*suppress_timer_output=*/true),
+    /*max_rounds=*/1UL,
+    /*outer_learning_rate=*/1.,
+    /*outer_momentum=*/0.,
+    /*outer_nesterov=*/false,
+    /*suppress_timer=*/true);
+  auto ctxt = algo.get_new_execution_context();
+  CHECK_THROWS(algo.apply(*ctxt,
+                          *m,
+                          trainer.get_data_coordinator(),
+                          lbann::execution_mode::training));
+  CHECK(ctxt->get_step() == 0UL);
+
+  lbann::persist p;
+  CHECK_THROWS(ctxt->save_to_checkpoint_shared(p));
+  CHECK_THROWS(ctxt->load_from_checkpoint_distributed(p));
+}
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/io/checkpoint_writer.hpp"
+
+#include "lbann/utils/exception.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lbann {
+namespace {
+
+void write_file(std::string const& path, std::string const& contents)
+{
+  mode_t const mode = S_IWUSR | S_IRUSR | S_IWGRP | S_IRGRP;
+  int const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, mode);
+  if (fd == -1) {
+    LBANN_ERROR("failed to create checkpoint file \"",
+                path,
+                "\" (",
+                std::strerror(errno),
+                ")");
+  }
+  size_t offset = 0;
+  while (offset < contents.size()) {
+    ssize_t const n =
+      ::write(fd, contents.data() + offset, contents.size() - offset);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      int const err = errno;
+      ::close(fd);
+      LBANN_ERROR("failed to write checkpoint file \"",
+                  path,
+                  "\" (",
+                  std::strerror(err),
+                  ")");
+    }
+    offset += n;
+  }
+  // Close even if the flush fails, reporting the first error
+  int err = (::fsync(fd) != 0 ? errno : 0);
+  if (::close(fd) != 0 && err == 0) {
+    err = errno;
+  }
+  if (err != 0) {
+    LBANN_ERROR("failed to flush checkpoint file \"",
+                path,
+                "\" (",
+                std::strerror(err),
+                ")");
+  }
+}
+
+} // namespace
+
+checkpoint_writer::checkpoint_writer()
+{
+  m_worker = std::thread(&checkpoint_writer::worker, this);
+}
+
+checkpoint_writer::~checkpoint_writer()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+}
+
+uint64_t checkpoint_writer::submit(file_list files)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_worker_error) {
+    std::rethrow_exception(m_worker_error);
+  }
+  uint64_t const ticket = m_next_ticket++;
+  m_queue.emplace_back(ticket, std::move(files));
+  m_cv.notify_all();
+  return ticket;
+}
+
+void checkpoint_writer::wait(uint64_t ticket)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [&] { return m_completed > ticket || m_worker_error; });
+  if (m_worker_error) {
+    std::rethrow_exception(m_worker_error);
+  }
+}
+
+void checkpoint_writer::wait_all()
+{
+  uint64_t last_ticket;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_next_ticket == 0)
+      return;
+    last_ticket = m_next_ticket - 1;
+  }
+  wait(last_ticket);
+}
+
+size_t checkpoint_writer::num_pending() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_next_ticket - m_completed;
+}
+
+uint64_t checkpoint_writer::get_bytes_written() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_bytes_written;
+}
+
+uint64_t checkpoint_writer::write_files(file_list const& files)
+{
+  uint64_t bytes = 0;
+  for (auto const& [path, contents] : files) {
+    write_file(path, contents);
+    bytes += contents.size();
+  }
+  return bytes;
+}
+
+void checkpoint_writer::worker()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    // Drain the queue before stopping so queued checkpoints are kept
+    m_cv.wait(lock, [&] { return m_stop || !m_queue.empty(); });
+    if (m_queue.empty() || m_worker_error) {
+      return;
+    }
+    auto [ticket, files] = std::move(m_queue.front());
+    m_queue.pop_front();
+    lock.unlock();
+    uint64_t bytes = 0;
+    std::exception_ptr error;
+    try {
+      bytes = write_files(files);
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+    files.clear();
+    lock.lock();
+    m_bytes_written += bytes;
+    m_completed = ticket + 1;
+    if (error) {
+      m_worker_error = error;
+    }
+    m_cv.notify_all();
+  }
+}
+
+} // namespace lbann
@@ -30,6 +30,8 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
+#include <string>
+#include <vector>
 
 #define LBANN_PERSIST_INSTANTIATE
 #include "lbann/io/file_io.hpp"
@@ -50,8 +52,6 @@
  * using a file-per-process
  ****************************************************/
 
-/* TODO: user buffered I/O for more efficient writes */
-
 /** Stores meta data needed to reconstruct matrix in memory after reading
  *  it back from a file */
 struct layer_header
@@ -64,9 +64,78 @@ struct layer_header
   uint64_t ldim; /**< specifies padding of first dimension in local storage */
 };
 
-/** \brief Given an open file descriptor, file name, and a matrix, write the
- * matrix to the file descriptor, return the number of bytes written */
+namespace {
+
+std::string get_rank_distmat_filename(std::string const& dir,
+                                      lbann::persist_type type,
+                                      const char* name)
+{
+  if (type == lbann::persist_type::train) {
+    return dir + std::string("/train_") + name;
+  }
+  else if (type == lbann::persist_type::model) {
+    return dir + std::string("/model_") + name;
+  }
+  LBANN_ERROR("invalid persist_type (", static_cast<int>(type), ")");
+  return "";
+}
 
+/** Write a whole buffer, retrying on short writes. */
+void write_fully(int fd,
+                 std::string const& filename,
+                 const char* buf,
+                 size_t size)
+{
+  while (size > 0) {
+    ssize_t const rc = write(fd, buf, size);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LBANN_ERROR("failed to write ",
+                  size,
+                  " bytes to ",
+                  filename,
+                  " (",
+                  std::strerror(errno),
+                  ")");
+    }
+    buf += rc;
+    size -= rc;
+  }
+}
+
+/** Read a whole buffer, retrying on short reads. */
+void read_fully(int fd, std::string const& filename, char* buf, size_t size)
+{
+  while (size > 0) {
+    ssize_t const rc = read(fd, buf, size);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LBANN_ERROR("failed to read ",
+                  size,
+                  " bytes from ",
+                  filename,
+                  " (",
+                  rc < 0 ? std::strerror(errno) : "unexpected end of file",
+                  ")");
+    }
+    buf += rc;
+    size -= rc;
+  }
+}
+
+} // namespace
+
+/** \brief Given a file name and a matrix, write the local part of the
+ *  matrix to its own file.
+ *
+ *  The header and the (unpadded, host-resident) local data are staged
+ *  in one buffer and written with a single large write, then the file
+ *  is synced and closed.
+ */
 template <typename TensorDataType>
 bool lbann::persist::write_rank_distmat(
   persist_type type,
@@ -74,16 +143,8 @@ bool lbann::persist::write_rank_distmat(
   const El::AbstractDistMatrix<TensorDataType>& M)
 {
   // TODO: store in network order
-  std::string filename = m_checkpoint_dir;
-  if (type == persist_type::train) {
-    filename += std::string("/train_") + name;
-  }
-  else if (type == persist_type::model) {
-    filename += std::string("/model_") + name;
-  }
-  else {
-    LBANN_ERROR("invalid persist_type (", static_cast<int>(type), ")");
-  }
+  std::string const filename =
+    get_rank_distmat_filename(m_checkpoint_dir, type, name);
   // skip all of this if matrix is not held on rank
   const El::Int localHeight = M.LocalHeight();
   const El::Int localWidth = M.LocalWidth();
@@ -93,8 +154,6 @@ bool lbann::persist::write_rank_distmat(
     return true;
   }
 
-  int fd = lbann::openwrite(filename.c_str());
-
   // build our header
   struct layer_header header;
   header.rank = (uint64_t)M.Grid().Rank();
@@ -104,45 +163,32 @@ bool lbann::persist::write_rank_distmat(
   header.localheight = (uint64_t)M.LocalHeight();
   header.ldim = (uint64_t)M.LDim();
 
-  // write the header to the file
-  ssize_t write_rc = write(fd, &header, sizeof(header));
-  if (write_rc != sizeof(header)) {
-    // error!
-  }
-  m_bytes[type] += write_rc;
-
-  // now write the data for our part of the distributed matrix
-  const El::Int lDim = M.LDim();
-  if (localHeight == lDim) {
-    // the local dimension in memory matches the local height,
-    // so we can write our data in a single shot
-    auto* buf = (void*)M.LockedBuffer();
-    El::Int bufsize = localHeight * localWidth * sizeof(DataType);
-    write_rc = write(fd, buf, bufsize);
-    if (write_rc != bufsize) {
-      // error!
-    }
-    m_bytes[type] += write_rc;
+  // Stage the header and the local data without padding. Copying
+  // through a host matrix also handles device-resident matrices.
+  size_t const data_size = localHeight * localWidth * sizeof(TensorDataType);
+  std::vector<char> buffer(sizeof(header) + data_size);
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  {
+    El::Matrix<TensorDataType, El::Device::CPU> local(
+      localHeight,
+      localWidth,
+      reinterpret_cast<TensorDataType*>(buffer.data() + sizeof(header)),
+      localHeight);
+    El::Copy(M.LockedMatrix(), local);
   }
-  else {
-    // TODO: if this padding is small, may not be a big deal to write it out
-    // anyway we've got some padding along the first dimension while storing the
-    // matrix in memory, avoid writing the padding
-    for (El::Int j = 0; j < localWidth; ++j) {
-      auto* buf = (void*)M.LockedBuffer(0, j);
-      El::Int bufsize = localHeight * sizeof(DataType);
-      write_rc = write(fd, buf, bufsize);
-      if (write_rc != bufsize) {
-        // error!
-      }
-      m_bytes[type] += write_rc;
-    }
+
+  int const fd = lbann::openwrite(filename.c_str());
+  if (fd == -1) {
+    LBANN_ERROR("failed to create ", filename);
   }
+  write_fully(fd, filename, buffer.data(), buffer.size());
+  lbann::closewrite(fd, filename.c_str());
+  m_bytes[type] += buffer.size();
   return true;
 }
 
-/** \brief Given an open file descriptor, file name, and a matrix, read the
- * matrix from the file descriptor, return the number of bytes read */
+/** \brief Given a file name and a matrix, read the local part of the
+ *  matrix back from its own file, return false if there is no file */
 template <typename TensorDataType>
 bool lbann::persist::read_rank_distmat(
   persist_type type,
@@ -150,16 +196,8 @@ bool lbann::persist::read_rank_distmat(
   El::AbstractDistMatrix<TensorDataType>& M)
 {
   // read in the header
-  std::string filename = m_checkpoint_dir;
-  if (type == persist_type::train) {
-    filename += std::string("/train_") + name;
-  }
-  else if (type == persist_type::model) {
-    filename += std::string("/model_") + name;
-  }
-  else {
-    LBANN_ERROR("invalid persist_type (", static_cast<int>(type), ")");
-  }
+  std::string const filename =
+    get_rank_distmat_filename(m_checkpoint_dir, type, name);
   int fd = openread(filename.c_str());
   // file does not exist. we will try to grab matrix from rank 0
   if (fd == -1) {
@@ -167,94 +205,39 @@ bool lbann::persist::read_rank_distmat(
   }
 
   struct layer_header header;
-  ssize_t read_rc = read(fd, &header, sizeof(header));
-  if (read_rc != sizeof(header)) {
-    LBANN_ERROR("failed to read layer header from file (attempted to read ",
-                sizeof(header),
-                " bytes from ",
-                filename,
-                ", but got ",
-                read_rc,
-                " bytes)");
-  }
-  m_bytes[type] += read_rc;
+  read_fully(fd, filename, reinterpret_cast<char*>(&header), sizeof(header));
+  m_bytes[type] += sizeof(header);
 
   // resize our global matrix
   El::Int height = header.height;
   El::Int width = header.width;
   M.Resize(height, width);
-  // TODO: check that header values match up
   const El::Int localheight = header.localheight;
   const El::Int localwidth = header.localwidth;
-  if (M.ColStride() == 1 && M.RowStride() == 1) {
-    if (M.Height() == M.LDim()) {
-      auto* buf = (void*)M.Buffer();
-      El::Int bufsize = localheight * localwidth * sizeof(DataType);
-      read_rc = read(fd, buf, bufsize);
-      if (read_rc != bufsize) {
-        LBANN_ERROR("failed to read layer data from file (attempted to read ",
-                    bufsize,
-                    " bytes from ",
-                    filename,
-                    ", but got ",
-                    read_rc,
-                    " bytes)");
-      }
-      m_bytes[type] += read_rc;
-    }
-    else {
-      for (El::Int j = 0; j < localwidth; ++j) {
-        auto* buf = (void*)M.Buffer(0, j);
-        El::Int bufsize = localheight * sizeof(DataType);
-        read_rc = read(fd, buf, bufsize);
-        if (read_rc != bufsize) {
-          LBANN_ERROR("failed to read layer data from file (attempted to read ",
-                      bufsize,
-                      " bytes from ",
-                      filename,
-                      ", but got ",
-                      read_rc,
-                      " bytes)");
-        }
-        m_bytes[type] += read_rc;
-      }
-    }
-  }
-  else {
-    const El::Int lDim = M.LDim();
-    if (localheight == lDim) {
-      auto* buf = (void*)M.Buffer();
-      El::Int bufsize = localheight * localwidth * sizeof(DataType);
-      read_rc = read(fd, buf, bufsize);
-      if (read_rc != bufsize) {
-        LBANN_ERROR("failed to read layer data from file (attempted to read ",
-                    bufsize,
-                    " bytes from ",
-                    filename,
-                    ", but got ",
-                    read_rc,
-                    " bytes)");
-      }
-      m_bytes[type] += read_rc;
-    }
-    else {
-      for (El::Int jLoc = 0; jLoc < localwidth; ++jLoc) {
-        auto* buf = (void*)M.Buffer(0, jLoc);
-        El::Int bufsize = localheight * sizeof(DataType);
-        read_rc = read(fd, buf, bufsize);
-        if (read_rc != bufsize) {
-          LBANN_ERROR("failed to read layer data from file (attempted to read ",
-                      bufsize,
-                      " bytes from ",
-                      filename,
-                      ", but got ",
-                      read_rc,
-                      " bytes)");
-        }
-        m_bytes[type] += read_rc;
-      }
-    }
+  if (localheight != M.LocalHeight() || localwidth != M.LocalWidth()) {
+    closeread(fd, filename.c_str());
+    LBANN_ERROR("local size in ",
+                filename,
+                " (",
+                localheight,
+                " x ",
+                localwidth,
+                ") does not match the distribution of the matrix (",
+                M.LocalHeight(),
+                " x ",
+                M.LocalWidth(),
+                ")");
   }
+
+  // Read the local data in one shot into a host buffer
+  El::Matrix<TensorDataType, El::Device::CPU> local(localheight, localwidth);
+  read_fully(fd,
+             filename,
+             reinterpret_cast<char*>(local.Buffer()),
+             localheight * localwidth * sizeof(TensorDataType));
+  closeread(fd, filename.c_str());
+  El::Copy(local, M.Matrix());
+  m_bytes[type] += localheight * localwidth * sizeof(TensorDataType);
   return true;
 }
 
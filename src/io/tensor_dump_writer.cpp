@@ -0,0 +1,116 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/io/tensor_dump_writer.hpp"
+
+#include "lbann/utils/threads/thread_pool.hpp"
+
+namespace lbann {
+
+tensor_dump_writer::tensor_dump_writer(size_t num_buffers)
+  : m_writer{std::make_unique<thread_pool>()}
+#ifdef LBANN_HAS_GPU
+    ,
+    m_copy_sync_info{El::CreateNewSyncInfo<El::Device::GPU>()}
+#endif // LBANN_HAS_GPU
+{
+  for (size_t i = 0; i < std::max(num_buffers, size_t(1)); ++i) {
+    m_buffers.emplace_back(std::make_unique<staging_buffer>());
+  }
+  m_writer->launch_threads(1);
+}
+
+tensor_dump_writer::~tensor_dump_writer()
+{
+  try {
+    wait_all();
+  }
+  catch (const std::exception& e) {
+    LBANN_WARNING("failed to write tensor dump (", e.what(), ")");
+  }
+  m_writer.reset();
+#ifdef LBANN_HAS_GPU
+  El::DestroySyncInfo(m_copy_sync_info);
+#endif // LBANN_HAS_GPU
+}
+
+auto tensor_dump_writer::acquire(size_t bytes) -> staging_buffer&
+{
+  auto& buf = *m_buffers[m_next_buffer];
+  m_next_buffer = (m_next_buffer + 1) % m_buffers.size();
+  if (buf.write.valid()) {
+    buf.write.get();
+  }
+  if (buf.host == nullptr || buf.host->size() < bytes) {
+#ifdef LBANN_HAS_GPU
+    constexpr unsigned memory_mode = 1; // Pinned memory
+#else
+    constexpr unsigned memory_mode = 0;
+#endif // LBANN_HAS_GPU
+    buf.host =
+      std::make_unique<hydrogen::simple_buffer<El::byte, El::Device::CPU>>(
+        bytes,
+        El::SyncInfo<El::Device::CPU>{},
+        memory_mode);
+  }
+  return buf;
+}
+
+void tensor_dump_writer::enqueue(staging_buffer& buf,
+                                 std::function<void()> write)
+{
+  buf.write = m_writer->submit_job([&buf, write = std::move(write)]() {
+#ifdef LBANN_HAS_GPU
+    buf.copy_done.synchronize();
+#endif // LBANN_HAS_GPU
+    write();
+  });
+}
+
+void tensor_dump_writer::submit_task(std::function<void()> task)
+{
+  if (m_last_task.valid()) {
+    m_last_task.get();
+  }
+  m_last_task = m_writer->submit_job(std::move(task));
+}
+
+void tensor_dump_writer::wait_all()
+{
+  // The writer has one thread, so writes finish in submission order
+  for (size_t i = 0; i < m_buffers.size(); ++i) {
+    auto& buf = *m_buffers[(m_next_buffer + i) % m_buffers.size()];
+    if (buf.write.valid()) {
+      buf.write.get();
+    }
+  }
+  if (m_last_task.valid()) {
+    m_last_task.get();
+  }
+}
+
+} // namespace lbann
@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+// File being tested
+#include <lbann/io/weights_container.hpp>
+
+#include <lbann/base.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+#include <lbann/weights/initializer.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using lbann::DataType;
+
+namespace {
+
+auto make_weights(lbann::lbann_comm& comm,
+                  std::string name,
+                  size_t height,
+                  size_t width,
+                  DataType value,
+                  bool setup = true)
+{
+  auto out = std::make_unique<lbann::data_type_weights<DataType>>(comm);
+  out->set_name(std::move(name));
+  out->set_dims({height}, {width});
+  out->set_initializer(
+    std::make_unique<lbann::constant_initializer<DataType>>(value));
+  if (setup) {
+    out->setup();
+  }
+  return out;
+}
+
+} // namespace
+
+TEST_CASE("Weights container round trip", "[mpi][io][weights]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  size_t const size_of_world = comm.get_procs_in_world();
+  std::string const path = "weights_container_test.lbw";
+
+  auto src_a = make_weights(comm, "a", 3 * size_of_world, 5, 1.f);
+  auto src_b = make_weights(comm, "b", 7, 2 * size_of_world, 2.f);
+  // Give the tensors distinct entries so a misplaced column shows up
+  for (auto* w : {src_a.get(), src_b.get()}) {
+    auto& values = w->get_values_sharded();
+    for (El::Int jl = 0; jl < values.LocalWidth(); ++jl) {
+      for (El::Int il = 0; il < values.LocalHeight(); ++il) {
+        values.SetLocal(il,
+                        jl,
+                        DataType(values.GlobalRow(il) +
+                                 100 * values.GlobalCol(jl)));
+      }
+    }
+  }
+
+  auto const level = GENERATE(0, 6);
+  std::vector<lbann::weights*> const src = {src_a.get(), src_b.get()};
+  lbann::weights_container::write(path, src, comm, level);
+  comm.trainer_barrier();
+
+  auto tgt_a = make_weights(comm, "a", 3 * size_of_world, 5, 0.f);
+  auto tgt_c = make_weights(comm, "c", 4, 4, 3.f);
+  std::vector<lbann::weights*> const tgt = {tgt_a.get(), tgt_c.get()};
+  auto const missing = lbann::weights_container::read(path, tgt, comm);
+  comm.trainer_barrier();
+  if (comm.am_trainer_master()) {
+    std::remove(path.c_str());
+  }
+
+  REQUIRE(missing == std::vector<std::string>{"c"});
+  auto const& expected = src_a->get_values_sharded();
+  auto const& actual = tgt_a->get_values_sharded();
+  for (El::Int jl = 0; jl < actual.LocalWidth(); ++jl) {
+    for (El::Int il = 0; il < actual.LocalHeight(); ++il) {
+      CHECK(actual.GetLocal(il, jl) == expected.GetLocal(il, jl));
+    }
+  }
+  CHECK(tgt_c->get_values_sharded().Get(0, 0) == DataType(3.f));
+}
+
+TEST_CASE("Weights container lazy attach", "[mpi][io][weights]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  size_t const size_of_world = comm.get_procs_in_world();
+  std::string const path = "weights_container_attach_test.lbw";
+
+  auto src = make_weights(comm, "a", 3 * size_of_world, 5, 0.f);
+  auto& src_values = src->get_values_sharded();
+  for (El::Int jl = 0; jl < src_values.LocalWidth(); ++jl) {
+    for (El::Int il = 0; il < src_values.LocalHeight(); ++il) {
+      src_values.SetLocal(il,
+                          jl,
+                          DataType(src_values.GlobalRow(il) +
+                                   100 * src_values.GlobalCol(jl)));
+    }
+  }
+  auto const level = GENERATE(0, 6);
+  lbann::weights_container::write(path, {src.get()}, comm, level);
+  comm.trainer_barrier();
+
+  // Attach before setup, as model::load_weights_at_setup does
+  auto tgt_a = make_weights(comm, "a", 3 * size_of_world, 5, -1.f, false);
+  auto tgt_c = make_weights(comm, "c", 4, 4, 3.f, false);
+  auto const missing =
+    lbann::weights_container::attach(path, {tgt_a.get(), tgt_c.get()});
+  REQUIRE(missing == std::vector<std::string>{"c"});
+  CHECK(tgt_a->has_deferred_values());
+  CHECK_FALSE(tgt_c->has_deferred_values());
+  tgt_a->setup();
+  tgt_c->setup();
+  CHECK(tgt_a->has_deferred_values());
+
+  auto const& actual = tgt_a->get_values_sharded();
+  CHECK_FALSE(tgt_a->has_deferred_values());
+  auto const& expected = src->get_values_sharded();
+  for (El::Int jl = 0; jl < actual.LocalWidth(); ++jl) {
+    for (El::Int il = 0; il < actual.LocalHeight(); ++il) {
+      CHECK(actual.GetLocal(il, jl) == expected.GetLocal(il, jl));
+    }
+  }
+  CHECK(tgt_c->get_values_sharded().Get(0, 0) == DataType(3.f));
+
+  comm.trainer_barrier();
+  if (comm.am_trainer_master()) {
+    std::remove(path.c_str());
+  }
+}
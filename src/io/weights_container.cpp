@@ -0,0 +1,458 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/io/weights_container.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+namespace lbann {
+namespace weights_container {
+namespace {
+
+constexpr char magic[8] = {'L', 'B', 'A', 'N', 'N', 'W', 'T', 'S'};
+constexpr uint32_t format_version = 1;
+constexpr uint64_t blob_alignment = 64;
+
+enum class codec : uint64_t
+{
+  raw = 0,
+  zlib = 1,
+};
+
+struct file_header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t num_tensors;
+  uint64_t index_offset;
+};
+
+struct tensor_entry
+{
+  std::string name;
+  uint64_t height;
+  uint64_t width;
+  uint64_t element_size;
+  codec compression;
+  uint64_t offset;
+  uint64_t stored_bytes;
+};
+
+using CircMatType =
+  El::DistMatrix<DataType, El::CIRC, El::CIRC, El::ELEMENT, El::Device::CPU>;
+using StarMatType =
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+template <typename T>
+void append(std::string& buf, T const& x)
+{
+  buf.append(reinterpret_cast<char const*>(&x), sizeof(x));
+}
+
+/** @brief Bounds-checked reader over the mapped file. */
+class cursor
+{
+public:
+  cursor(file::mapped_file const& file, uint64_t offset)
+    : m_file{file}, m_offset{offset}
+  {}
+
+  void read(void* out, uint64_t size)
+  {
+    if (m_offset + size > m_file.size()) {
+      LBANN_ERROR("weights container is truncated");
+    }
+    std::memcpy(out, m_file.data() + m_offset, size);
+    m_offset += size;
+  }
+
+  template <typename T>
+  T read()
+  {
+    T x;
+    read(&x, sizeof(x));
+    return x;
+  }
+
+private:
+  file::mapped_file const& m_file;
+  uint64_t m_offset;
+};
+
+std::vector<tensor_entry> read_index(file::mapped_file const& file,
+                                     std::string const& path)
+{
+  file_header header;
+  cursor(file, 0).read(&header, sizeof(header));
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0) {
+    LBANN_ERROR(path, " is not a weights container");
+  }
+  if (header.version != format_version) {
+    LBANN_ERROR(path,
+                " has weights container version ",
+                header.version,
+                " (expected ",
+                format_version,
+                ")");
+  }
+  std::vector<tensor_entry> index(header.num_tensors);
+  cursor c(file, header.index_offset);
+  for (auto& entry : index) {
+    entry.name.resize(c.read<uint64_t>());
+    c.read(entry.name.data(), entry.name.size());
+    entry.height = c.read<uint64_t>();
+    entry.width = c.read<uint64_t>();
+    entry.element_size = c.read<uint64_t>();
+    entry.compression = c.read<codec>();
+    entry.offset = c.read<uint64_t>();
+    entry.stored_bytes = c.read<uint64_t>();
+    if (entry.offset + entry.stored_bytes > file.size()) {
+      LBANN_ERROR("weights container entry \"", entry.name, "\" is truncated");
+    }
+  }
+  return index;
+}
+
+/** @brief Check that @c values have the stored dimensions */
+void check_dims(tensor_entry const& entry,
+                El::AbstractDistMatrix<DataType> const& values,
+                std::string const& path)
+{
+  El::Int const height = entry.height;
+  El::Int const width = entry.width;
+  if (values.Height() != height || values.Width() != width) {
+    LBANN_ERROR("weights \"",
+                entry.name,
+                "\" are ",
+                values.Height(),
+                "x",
+                values.Width(),
+                " but ",
+                path,
+                " stores them as ",
+                height,
+                "x",
+                width);
+  }
+}
+
+/** @brief Copy a column-major tensor held by every rank into @c values
+ *
+ *  Every rank views the whole tensor and copies out only the entries
+ *  it owns.
+ */
+void copy_values(DataType const* data,
+                 tensor_entry const& entry,
+                 El::AbstractDistMatrix<DataType>& values)
+{
+  El::Int const height = entry.height;
+  El::Int const width = entry.width;
+  StarMatType view(values.Grid());
+  view.LockedAttach(height, width, values.Grid(), 0, 0, data, height);
+  El::Copy(view, values);
+}
+
+/** @brief Inflate a zlib-compressed tensor into @c out */
+void inflate(file::mapped_file const& file,
+             tensor_entry const& entry,
+             std::string const& name,
+             DataType* out)
+{
+  uLongf size = entry.height * entry.width * sizeof(DataType);
+  int const status =
+    uncompress(reinterpret_cast<Bytef*>(out),
+               &size,
+               reinterpret_cast<Bytef const*>(file.data() + entry.offset),
+               entry.stored_bytes);
+  if (status != Z_OK ||
+      size != entry.height * entry.width * sizeof(DataType)) {
+    LBANN_ERROR("zlib failed to decompress weights \"",
+                name,
+                "\" (error ",
+                status,
+                ")");
+  }
+}
+
+} // namespace
+
+uint64_t write(std::string const& path,
+               std::vector<weights*> const& weights_list,
+               lbann_comm& comm,
+               int compression_level)
+{
+  bool const am_root = comm.am_trainer_master();
+  std::ofstream ofs;
+  if (am_root) {
+    ofs.open(path, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+      LBANN_ERROR("failed to open ", path, " for writing");
+    }
+    // Placeholder; rewritten once the index offset is known
+    file_header const header{};
+    ofs.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  }
+
+  std::vector<tensor_entry> index;
+  uint64_t offset = sizeof(file_header);
+  std::string blob, compressed;
+  for (auto const* w : weights_list) {
+    auto const* dtw = dynamic_cast<data_type_weights<DataType> const*>(w);
+    if (dtw == nullptr) {
+      LBANN_ERROR("weights \"",
+                  w->get_name(),
+                  "\" cannot be stored in a weights container since "
+                  "they do not use the default data type");
+    }
+
+    // Gather the values on the trainer master
+    auto const& values = dtw->get_values_sharded();
+    CircMatType circ(values.Grid(), 0);
+    El::Copy(values, circ);
+    if (!am_root) {
+      continue;
+    }
+    auto const& local = circ.LockedMatrix();
+    if (local.Height() != circ.Height() || local.Width() != circ.Width()) {
+      LBANN_ERROR("weights \"",
+                  w->get_name(),
+                  "\" are not distributed over the trainer grid");
+    }
+
+    // Pack the columns contiguously
+    size_t const col_bytes = local.Height() * sizeof(DataType);
+    blob.resize(col_bytes * local.Width());
+    for (El::Int j = 0; j < local.Width(); ++j) {
+      std::memcpy(blob.data() + j * col_bytes,
+                  local.LockedBuffer(0, j),
+                  col_bytes);
+    }
+
+    tensor_entry entry{w->get_name(),
+                       static_cast<uint64_t>(local.Height()),
+                       static_cast<uint64_t>(local.Width()),
+                       sizeof(DataType),
+                       codec::raw,
+                       offset,
+                       blob.size()};
+    std::string const* stored = &blob;
+    if (compression_level > 0 && !blob.empty()) {
+      uLongf size = compressBound(blob.size());
+      compressed.resize(size);
+      int const status =
+        compress2(reinterpret_cast<Bytef*>(compressed.data()),
+                  &size,
+                  reinterpret_cast<Bytef const*>(blob.data()),
+                  blob.size(),
+                  compression_level);
+      if (status != Z_OK) {
+        LBANN_ERROR("zlib failed to compress weights \"",
+                    w->get_name(),
+                    "\" (error ",
+                    status,
+                    ")");
+      }
+      // Keep incompressible tensors raw so they can be mapped
+      if (size < blob.size()) {
+        compressed.resize(size);
+        entry.compression = codec::zlib;
+        entry.stored_bytes = size;
+        stored = &compressed;
+      }
+    }
+    ofs.write(stored->data(), stored->size());
+    offset += stored->size();
+    uint64_t const padding = (blob_alignment - offset % blob_alignment) %
+                             blob_alignment;
+    ofs.write(std::string(padding, '\0').data(), padding);
+    offset += padding;
+    index.emplace_back(std::move(entry));
+  }
+  if (!am_root) {
+    return 0;
+  }
+
+  std::string index_buf;
+  for (auto const& entry : index) {
+    append(index_buf, static_cast<uint64_t>(entry.name.size()));
+    index_buf.append(entry.name);
+    append(index_buf, entry.height);
+    append(index_buf, entry.width);
+    append(index_buf, entry.element_size);
+    append(index_buf, entry.compression);
+    append(index_buf, entry.offset);
+    append(index_buf, entry.stored_bytes);
+  }
+  ofs.write(index_buf.data(), index_buf.size());
+
+  file_header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = format_version;
+  header.num_tensors = index.size();
+  header.index_offset = offset;
+  ofs.seekp(0);
+  ofs.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  ofs.close();
+  if (!ofs) {
+    LBANN_ERROR("failed to write ", path);
+  }
+  return offset + index_buf.size();
+}
+
+std::vector<std::string> read(std::string const& path,
+                              std::vector<weights*> const& weights_list,
+                              lbann_comm& comm)
+{
+  file::mapped_file const file(path);
+  auto const index = read_index(file, path);
+  std::unordered_map<std::string, tensor_entry const*> entries;
+  for (auto const& entry : index) {
+    entries.emplace(entry.name, &entry);
+  }
+
+  std::vector<std::string> missing;
+  for (auto* w : weights_list) {
+    auto const it = entries.find(w->get_name());
+    if (it == entries.end()) {
+      missing.push_back(w->get_name());
+      continue;
+    }
+    auto const& entry = *it->second;
+    auto* dtw = dynamic_cast<data_type_weights<DataType>*>(w);
+    if (dtw == nullptr || entry.element_size != sizeof(DataType)) {
+      LBANN_ERROR("weights \"",
+                  w->get_name(),
+                  "\" do not have the data type stored in ",
+                  path);
+    }
+    auto& values = dtw->get_values_sharded();
+    check_dims(entry, values, path);
+    El::Int const height = entry.height;
+    El::Int const width = entry.width;
+
+    if (entry.compression == codec::raw) {
+      copy_values(
+        reinterpret_cast<DataType const*>(file.data() + entry.offset),
+        entry,
+        values);
+    }
+    else if (entry.compression == codec::zlib) {
+      // The trainer master inflates the tensor and scatters it
+      CircMatType circ(values.Grid(), 0);
+      circ.Resize(height, width);
+      if (comm.am_trainer_master() && height * width > 0) {
+        auto& local = circ.Matrix();
+        std::vector<DataType> buf(height * width);
+        inflate(file, entry, w->get_name(), buf.data());
+        for (El::Int j = 0; j < width; ++j) {
+          std::memcpy(local.Buffer(0, j),
+                      buf.data() + j * height,
+                      height * sizeof(DataType));
+        }
+      }
+      El::Copy(circ, values);
+    }
+    else {
+      LBANN_ERROR("weights \"",
+                  w->get_name(),
+                  "\" use an unknown codec in ",
+                  path);
+    }
+  }
+  return missing;
+}
+
+std::vector<std::string> attach(std::string const& path,
+                                std::vector<weights*> const& weights_list)
+{
+  auto const file = std::make_shared<file::mapped_file const>(path);
+  auto const index = read_index(*file, path);
+  std::unordered_map<std::string, tensor_entry const*> entries;
+  for (auto const& entry : index) {
+    entries.emplace(entry.name, &entry);
+  }
+
+  std::vector<std::string> missing;
+  for (auto* w : weights_list) {
+    auto const it = entries.find(w->get_name());
+    if (it == entries.end()) {
+      missing.push_back(w->get_name());
+      continue;
+    }
+    auto const& entry = *it->second;
+    auto* dtw = dynamic_cast<data_type_weights<DataType>*>(w);
+    if (dtw == nullptr || entry.element_size != sizeof(DataType)) {
+      LBANN_ERROR("weights \"",
+                  w->get_name(),
+                  "\" do not have the data type stored in ",
+                  path);
+    }
+
+    if (entry.compression == codec::raw) {
+      // The pages are only read once the weights are first accessed
+      dtw->set_deferred_values(
+        [file, entry, path](El::AbstractDistMatrix<DataType>& values) {
+          check_dims(entry, values, path);
+          copy_values(
+            reinterpret_cast<DataType const*>(file->data() + entry.offset),
+            entry,
+            values);
+        });
+    }
+    else if (entry.compression == codec::zlib) {
+      // Inflate now, on every rank, so that filling the values later
+      // is not collective
+      auto buf =
+        std::make_shared<std::vector<DataType>>(entry.height * entry.width);
+      inflate(*file, entry, w->get_name(), buf->data());
+      dtw->set_deferred_values(
+        [buf, entry, path](El::AbstractDistMatrix<DataType>& values) {
+          check_dims(entry, values, path);
+          copy_values(buf->data(), entry, values);
+        });
+    }
+    else {
+      LBANN_ERROR("weights \"",
+                  w->get_name(),
+                  "\" use an unknown codec in ",
+                  path);
+    }
+  }
+  return missing;
+}
+
+} // namespace weights_container
+} // namespace lbann
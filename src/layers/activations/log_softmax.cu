@@ -31,6 +31,8 @@
 #include "lbann/utils/dnn_lib/softmax.hpp"
 #endif // LBANN_HAS_DNN_LIB
 
+#include <type_traits>
+
 namespace lbann {
 
 namespace {
@@ -39,12 +41,182 @@ namespace {
 template <class T>
 struct max_op
 {
-  __device__ __forceinline__ DataType operator()(const T& x1, const T& x2) const
+  __device__ __forceinline__ T operator()(const T& x1, const T& x2) const
   {
     return gpu_lib::max(x1, x2);
   }
 };
 
+/** @brief Number of threads that share a matrix column in warp kernels */
+constexpr size_t warp_width = 32;
+
+/** @brief Number of warp groups in each CUDA block */
+constexpr size_t warps_per_block = 8;
+
+/** @brief Largest matrix column handled by the warp kernels
+ *
+ *  Larger columns are handled by the DNN library.
+ */
+constexpr size_t max_warp_height = 1024;
+
+/** @brief Launch a warp kernel specialized for the column height
+ *
+ *  @c launch is called with a constant holding the number of column
+ *  entries per thread, rounded up to a power of two.
+ */
+template <typename Launcher>
+void dispatch_warp_kernel(size_t height, Launcher&& launch)
+{
+  size_t items = 1;
+  while (items * warp_width < height) {
+    items *= 2;
+  }
+  switch (items) {
+  case 1:
+    launch(std::integral_constant<size_t, 1>{});
+    break;
+  case 2:
+    launch(std::integral_constant<size_t, 2>{});
+    break;
+  case 4:
+    launch(std::integral_constant<size_t, 4>{});
+    break;
+  case 8:
+    launch(std::integral_constant<size_t, 8>{});
+    break;
+  case 16:
+    launch(std::integral_constant<size_t, 16>{});
+    break;
+  case 32:
+    launch(std::integral_constant<size_t, 32>{});
+    break;
+  default:
+    LBANN_ERROR("matrix height ",
+                height,
+                " is too large for warp kernels (max ",
+                max_warp_height,
+                ")");
+  }
+}
+
+/** @brief Compute layer output with one warp group per matrix column
+ *
+ *  y = x - shift - log(sum(x-shift))
+ *
+ *  The column is loaded into registers once, so the shift, the sum,
+ *  and the output are computed with a single read and write of each
+ *  entry.
+ *
+ *  Block dimensions: warp_width x warps_per_block x 1
+ *
+ *  Grid dimension: (width / warps_per_block) x 1 x 1
+ */
+template <size_t items_per_thread, typename TensorDataType>
+__global__ void fp_warp_kernel(size_t height,
+                               size_t width,
+                               const TensorDataType* __restrict__ input,
+                               size_t input_ldim,
+                               TensorDataType* __restrict__ output,
+                               size_t output_ldim)
+{
+  const size_t lane = threadIdx.x;
+  const size_t gidy = threadIdx.y + blockIdx.x * blockDim.y;
+  const size_t nwarps = blockDim.y * gridDim.x;
+  for (size_t col = gidy; col < width; col += nwarps) {
+    const auto* __restrict__ x = &input[col * input_ldim];
+    auto* __restrict__ y = &output[col * output_ldim];
+
+    // Load column and find largest value
+    TensorDataType vals[items_per_thread];
+    TensorDataType shift{-gpu_lib::infinity<TensorDataType>()};
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t row = lane + item * warp_width;
+      vals[item] =
+        (row < height ? x[row] : -gpu_lib::infinity<TensorDataType>());
+      shift = gpu_lib::max(shift, vals[item]);
+    }
+    shift =
+      gpu_lib::warp_reduce<warp_width, TensorDataType, max_op<TensorDataType>>(
+        shift);
+
+    // Compute sum(exp(x-shift))
+    TensorDataType sum{0};
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t row = lane + item * warp_width;
+      vals[item] -= shift;
+      if (row < height) {
+        sum += gpu_lib::exp(vals[item]);
+      }
+    }
+    sum = gpu_lib::warp_reduce<warp_width>(sum);
+
+    // Compute output
+    const TensorDataType log_sum_exp = gpu_lib::log(sum);
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t row = lane + item * warp_width;
+      if (row < height) {
+        y[row] = vals[item] - log_sum_exp;
+      }
+    }
+  }
+}
+
+/** @brief Compute gradient w.r.t. input with one warp group per
+ *  matrix column
+ *
+ *  dx = dy - softmax(x) * sum(dy)
+ *
+ *  The sum and the gradient are computed in one pass over the column.
+ *
+ *  Block dimensions: warp_width x warps_per_block x 1
+ *
+ *  Grid dimension: (width / warps_per_block) x 1 x 1
+ */
+template <size_t items_per_thread, typename TensorDataType>
+__global__ void
+bp_warp_kernel(size_t height,
+               size_t width,
+               const TensorDataType* __restrict__ output,
+               size_t output_ldim,
+               const TensorDataType* __restrict__ gradient_wrt_output,
+               size_t gradient_wrt_output_ldim,
+               TensorDataType* __restrict__ gradient_wrt_input,
+               size_t gradient_wrt_input_ldim)
+{
+  const size_t lane = threadIdx.x;
+  const size_t gidy = threadIdx.y + blockIdx.x * blockDim.y;
+  const size_t nwarps = blockDim.y * gridDim.x;
+  for (size_t col = gidy; col < width; col += nwarps) {
+    const auto* __restrict__ y = &output[col * output_ldim];
+    const auto* __restrict__ dy =
+      &gradient_wrt_output[col * gradient_wrt_output_ldim];
+    auto* __restrict__ dx = &gradient_wrt_input[col * gradient_wrt_input_ldim];
+
+    // Load column and compute sum(dy)
+    TensorDataType dy_vals[items_per_thread];
+    TensorDataType sum{0};
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t row = lane + item * warp_width;
+      dy_vals[item] = (row < height ? dy[row] : TensorDataType{0});
+      sum += dy_vals[item];
+    }
+    sum = gpu_lib::warp_reduce<warp_width>(sum);
+
+    // Compute gradient w.r.t. input
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t row = lane + item * warp_width;
+      if (row < height) {
+        dx[row] = dy_vals[item] - gpu_lib::exp(y[row]) * sum;
+      }
+    }
+  }
+}
+
 /** @brief Kernel for max reduction on matrix columns
  *
  *  Each CUDA block computes the max over a subset of matrix entries
@@ -268,6 +440,37 @@ void fp_compute_impl(log_softmax_layer<TensorDataType,
   auto& local_output =
     dynamic_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
       l.get_local_activations());
+
+  // Short columns are handled by one warp group each
+  const size_t local_height = local_input.Height();
+  const size_t local_width = local_input.Width();
+  if (local_height <= max_warp_height) {
+    if (!local_input.IsEmpty()) {
+      auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_output),
+                                         gpu::get_sync_info(local_input));
+      dim3 block_dims, grid_dims;
+      block_dims.x = warp_width;
+      block_dims.y = warps_per_block;
+      grid_dims.x = (local_width + warps_per_block - 1) / warps_per_block;
+      gpu_lib::clip_grid_dims(grid_dims);
+      dispatch_warp_kernel(local_height, [&](auto items_per_thread) {
+        hydrogen::gpu::LaunchKernel(
+          fp_warp_kernel<decltype(items_per_thread)::value, TensorDataType>,
+          grid_dims,
+          block_dims,
+          0,
+          multisync,
+          local_height,
+          local_width,
+          local_input.LockedBuffer(),
+          local_input.LDim(),
+          local_output.Buffer(),
+          local_output.LDim());
+      });
+    }
+    return;
+  }
+
   dnn_lib::softmax_forward(one,
                            l.m_tensors_dnn_desc.get_prev_activations(),
                            local_input,
@@ -292,6 +495,41 @@ void bp_compute_impl(log_softmax_layer<TensorDataType,
     dynamic_cast<const GPUMatType&>(l.get_local_prev_error_signals());
   auto& local_gradient_wrt_input =
     dynamic_cast<GPUMatType&>(l.get_local_error_signals());
+
+  // Short columns are handled by one warp group each
+  const size_t local_height = local_output.Height();
+  const size_t local_width = local_output.Width();
+  if (local_height <= max_warp_height) {
+    if (!local_output.IsEmpty()) {
+      auto multisync =
+        El::MakeMultiSync(gpu::get_sync_info(local_gradient_wrt_input),
+                          gpu::get_sync_info(local_gradient_wrt_output),
+                          gpu::get_sync_info(local_output));
+      dim3 block_dims, grid_dims;
+      block_dims.x = warp_width;
+      block_dims.y = warps_per_block;
+      grid_dims.x = (local_width + warps_per_block - 1) / warps_per_block;
+      gpu_lib::clip_grid_dims(grid_dims);
+      dispatch_warp_kernel(local_height, [&](auto items_per_thread) {
+        hydrogen::gpu::LaunchKernel(
+          bp_warp_kernel<decltype(items_per_thread)::value, TensorDataType>,
+          grid_dims,
+          block_dims,
+          0,
+          multisync,
+          local_height,
+          local_width,
+          local_output.LockedBuffer(),
+          local_output.LDim(),
+          local_gradient_wrt_output.LockedBuffer(),
+          local_gradient_wrt_output.LDim(),
+          local_gradient_wrt_input.Buffer(),
+          local_gradient_wrt_input.LDim());
+      });
+    }
+    return;
+  }
+
   dnn_lib::softmax_backward(one,
                             l.m_tensors_dnn_desc.get_activations(),
                             local_output,
@@ -33,9 +33,11 @@
 #ifdef LBANN_HAS_DISTCONV
 #include "lbann/layers/data_type_distconv_adapter.hpp"
 #endif // LBANN_HAS_DISTCONV
+#include "lbann/models/activation_memory_planner.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/hash.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/summary_impl.hpp"
 #include "lbann/utils/tensor_impl.hpp"
@@ -166,6 +168,17 @@ modify_reference_counter(PointerRangeReferenceCounter& refcnt,
   }
 }
 
+#ifdef LBANN_HAS_GPU
+template <typename TensorDataType>
+static void set_gpu_sync_info(El::AbstractDistMatrix<TensorDataType>& mat,
+                              El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  El::SetSyncInfo(
+    dynamic_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(mat.Matrix()),
+    sync_info);
+}
+#endif // LBANN_HAS_GPU
+
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
 {
@@ -195,9 +208,15 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
       wp.synchronize_with_master();
   }
 
+  // Inputs may still be in flight from the parents
+  for (int i = 0; i < get_num_parents(); ++i) {
+    const_cast<Layer&>(get_parent_layer(i)).finish_pending_communication();
+  }
+
   // Setup tensors
   fp_setup_inputs();
   fp_setup_outputs();
+  use_layer_stream(false);
 
   // Increase output activation reference count for children (or objective
   // functions) to use
@@ -221,8 +240,10 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
     get_distconv_adapter().fp_setup();
 #endif // LBANN_HAS_DISTCONV
 
-  // Apply layer's compute function
-  if (this->is_participating())
+  // Apply layer's compute function. In a GPU graph segment, the
+  // model launches the compute once the segment is set up.
+  if (this->is_participating() &&
+      !(m != nullptr && m->is_fp_compute_deferred()))
   {
     LBANN_CALIPER_MARK_SCOPE(("fp_compute:" + this->get_name()).c_str());
     const auto fp_compute_start = get_time();
@@ -247,18 +268,30 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
     auto& refcnt = m->get_activation_reference_counter();
     auto bpreqs = this->get_backprop_requirements();
 
+    // Checkpointed layers are recomputed before their backprop, so
+    // they only hold the inputs entering their segment. Recomputation
+    // then accounts for the tensors like a regular forward prop.
+    const int segment =
+      (m->is_recomputing_activations() ? -1
+                                       : m->get_recompute_segment(*this));
+    const bool recompute = (segment >= 0);
+
     // If activations are owned and not necessary for backprop, release owned
     // activation memory (the next layer will also release its previous
     // activations later).
-    if (this->owns_activations() && !(bpreqs & ACTIVATIONS)) {
+    if (this->owns_activations() && (recompute || !(bpreqs & ACTIVATIONS))) {
       for (size_t i = 0; i < m_outputs.size(); ++i) {
         modify_reference_counter(refcnt, this->get_activations(i), false);
       }
     }
 
     // If previous activations are not necessary for backprop, release
-    if (!(bpreqs & PREV_ACTIVATIONS)) {
-      for (int i = 0; i < this->get_num_parents(); ++i) {
+    for (int i = 0; i < this->get_num_parents(); ++i) {
+      const bool keep =
+        (recompute
+           ? m->get_recompute_segment(this->get_parent_layer(i)) != segment
+           : (bpreqs & PREV_ACTIVATIONS) != 0);
+      if (!keep) {
         modify_reference_counter(refcnt, this->get_prev_activations(i), false);
       }
     }
@@ -274,6 +307,169 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
   m_fp_time += get_time() - fp_start;
 }
 
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  get_plannable_tensor_bytes(int index,
+                             bool error_signal,
+                             El::Int mini_batch_size) const
+{
+  // Views, distconv tensors and the outputs of input layers are set
+  // up by the layer itself
+  if (this->has_tensor_views() || distconv_enabled() ||
+      get_num_parents() == 0) {
+    return 0;
+  }
+  auto local_bytes =
+    [mini_batch_size](El::Int height, BaseDistMat const& dist, size_t size) {
+      const El::Int col_stride = dist.ColStride();
+      const El::Int row_stride = dist.RowStride();
+      const El::Int local_height = (height + col_stride - 1) / col_stride;
+      const El::Int local_width =
+        (mini_batch_size + row_stride - 1) / row_stride;
+      return static_cast<size_t>(local_height * local_width) * size;
+    };
+  if (error_signal) {
+    if (m_persistent_error_signals) {
+      return 0;
+    }
+    return local_bytes(get_input_size(index),
+                       get_prev_activations(index),
+                       sizeof(InputTensorDataType));
+  }
+  return local_bytes(get_output_size(index),
+                     get_activations(index),
+                     sizeof(OutputTensorDataType));
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+bool data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  use_layer_stream(bool error_signals)
+{
+#ifdef LBANN_HAS_GPU
+  model const* m = this->get_model();
+  auto const* sync_info = (m ? m->get_layer_sync_info(*this) : nullptr);
+  if (sync_info == nullptr) {
+    return false;
+  }
+  for (auto& mat : m_inputs) {
+    set_gpu_sync_info(*mat, *sync_info);
+  }
+  for (auto& mat : m_outputs) {
+    set_gpu_sync_info(*mat, *sync_info);
+  }
+  if (error_signals) {
+    for (auto& mat : m_gradient_wrt_outputs) {
+      set_gpu_sync_info(*mat, *sync_info);
+    }
+    for (auto& mat : m_gradient_wrt_inputs) {
+      set_gpu_sync_info(*mat, *sync_info);
+    }
+  }
+
+  // Weights proxies are copied and sharded weights are gathered on
+  // the default stream
+  bool default_stream_weights = false;
+  for (auto const& wp : m_weights_proxy) {
+    default_stream_weights |= (!wp.empty() && !wp.values().Viewing());
+  }
+  for (size_t i = 0; i < this->num_weights(); ++i) {
+    default_stream_weights |= this->get_weights(i).is_sharded();
+  }
+  if (default_stream_weights) {
+    El::AddSynchronizationPoint(m->get_default_sync_info(), *sync_info);
+  }
+  return true;
+#else
+  return false;
+#endif // LBANN_HAS_GPU
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType,
+                       OutputTensorDataType>::get_fp_tensor_signature() const
+{
+  size_t hash = 0;
+  auto add_matrix = [&hash](auto const& mat) {
+    hash = hash_combine(hash, mat.LockedBuffer());
+    hash = hash_combine(hash, mat.LocalHeight());
+    hash = hash_combine(hash, mat.LocalWidth());
+    hash = hash_combine(hash, mat.LDim());
+  };
+  for (int i = 0; i < get_num_parents(); ++i) {
+    add_matrix(get_prev_activations(i));
+  }
+  for (int i = 0; i < get_num_children(); ++i) {
+    add_matrix(get_activations(i));
+  }
+  return hash;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+template <typename T>
+bool data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  attach_planned_tensor(El::AbstractDistMatrix<T>& mat,
+                        int index,
+                        bool error_signal,
+                        El::Int height,
+                        El::Int width)
+{
+  model const* m = this->get_model();
+  auto const* plan = (m ? m->get_activation_memory_planner() : nullptr);
+  if (plan == nullptr) {
+    return false;
+  }
+  El::Int local_height = 0, local_width = 0;
+  if (mat.Participating()) {
+    local_height = El::Length(height, mat.ColShift(), mat.ColStride());
+    local_width = El::Length(width, mat.RowShift(), mat.RowStride());
+  }
+  El::byte* buffer =
+    plan->get_buffer(*this,
+                     index,
+                     error_signal,
+                     static_cast<size_t>(local_height * local_width) *
+                       sizeof(T));
+  if (buffer == nullptr) {
+    return false;
+  }
+  mat.Attach(height,
+             width,
+             mat.Grid(),
+             mat.ColAlign(),
+             mat.RowAlign(),
+             reinterpret_cast<T*>(buffer),
+             std::max(local_height, El::Int{1}),
+             mat.Root());
+  return true;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+template <typename T>
+bool data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  is_planned_tensor(El::AbstractDistMatrix<T> const& mat) const
+{
+  model const* m = this->get_model();
+  auto const* plan = (m ? m->get_activation_memory_planner() : nullptr);
+  return plan != nullptr && plan->contains(mat.LockedBuffer());
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+template <typename T>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  resize_for_mini_batch(El::AbstractDistMatrix<T>& mat,
+                        El::Int height,
+                        El::Int width) const
+{
+  // Shrinking a matrix keeps its memory
+  model const* m = this->get_model();
+  const auto max_width =
+    (m ? static_cast<El::Int>(m->get_max_mini_batch_size()) : El::Int{0});
+  if (width < max_width) {
+    mat.Resize(height, max_width);
+  }
+  mat.Resize(height, width);
+}
+
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::
   setup_reference_counter(El::AbstractDistMatrix<OutputTensorDataType>& mat)
@@ -282,6 +478,13 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::
   if (!m)
     return;
 
+  // Replayed graphs keep using the buffers they were captured with,
+  // and other layer streams may still read the activations
+  if (m->keeps_step_activations(*this)) {
+    this->m_activations_created = true;
+    return;
+  }
+
   auto& refcnt = m->get_activation_reference_counter();
   auto range = MatrixRefCounter::get_range(mat);
   refcnt.emplace(range, MatrixRefCounter(mat, this));
@@ -310,6 +513,7 @@ void data_type_layer<InputTensorDataType,
 
   // Setup tensors
   bp_setup_gradient_wrt_inputs();
+  [[maybe_unused]] const bool own_stream = use_layer_stream(true);
 
 #if defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
   // Synchronize GPUs and check for errors
@@ -336,6 +540,16 @@ void data_type_layer<InputTensorDataType,
     get_distconv_adapter().bp_postprocess();
 #endif // LBANN_HAS_DISTCONV
 
+#ifdef LBANN_HAS_GPU
+  // Gradient syncs run on the default stream once the last source is
+  // removed
+  if (own_stream && this->has_weights()) {
+    model const* m = this->get_model();
+    El::AddSynchronizationPoint(*m->get_layer_sync_info(*this),
+                                m->get_default_sync_info());
+  }
+#endif // LBANN_HAS_GPU
+
   // Remove this layer as a gradient source for weight optimizers
   this->remove_as_gradient_source();
 
@@ -1003,6 +1217,10 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::setup_matrices(
     m_persistent_error_signals = true;
 #endif
 
+  // Inference-only models never compute error signals
+  if (this->get_model()->is_inference_only())
+    m_persistent_error_signals = false;
+
   // Destroy previously setup matrices
   m_inputs.clear();
   m_outputs.clear();
@@ -1011,6 +1229,8 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::setup_matrices(
   m_temp_grad.clear();
   m_subgrid_tensors_split.clear();
 
+  m_shared_input_redistributions.assign(get_num_parents(), nullptr);
+
   // Construct matrices
   m_inputs.resize(get_num_parents());
   m_outputs.resize(get_num_children());
@@ -1173,6 +1393,59 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::check_setup()
   }
 }
 
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t
+data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  get_input_redistribution_bytes(int input_index) const
+{
+#ifdef LBANN_HAS_DISTCONV
+  if (!keep_original_inputs(input_index))
+    return 0;
+#endif // LBANN_HAS_DISTCONV
+  const auto& parent = get_parent_layer(input_index);
+  if (parent.get_output_datatype() == get_input_datatype() &&
+      parent.get_activations(*this).DistData() ==
+        get_prev_activations(input_index).DistData()) {
+    return 0;
+  }
+  return get_input_size(input_index) * sizeof(InputTensorDataType);
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+bool data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  share_input_redistribution(int input_index, Layer const& sibling)
+{
+  // The copy must be left untouched by the sibling and by this layer
+  const auto* other = dynamic_cast<data_type_layer const*>(&sibling);
+  if (other == nullptr || other == this || m_runs_inplace ||
+      other->runs_inplace()) {
+    return false;
+  }
+#ifdef LBANN_HAS_DISTCONV
+  if (this->distconv_enabled() || other->distconv_enabled()) {
+    return false;
+  }
+#endif // LBANN_HAS_DISTCONV
+
+  // Both layers must copy the same parent output the same way
+  const auto& parent = get_parent_layer(input_index);
+  const int other_index =
+    static_cast<int>(other->find_parent_layer_index(parent));
+  if (other_index >= other->get_num_parents() ||
+      other->get_input_redistribution_bytes(other_index) == 0 ||
+      !parent.outputs_alias(
+        static_cast<int>(parent.find_child_layer_index(*this)),
+        static_cast<int>(parent.find_child_layer_index(sibling)))) {
+    return false;
+  }
+  const auto& copy = other->get_prev_activations(other_index);
+  if (!(copy.DistData() == get_prev_activations(input_index).DistData())) {
+    return false;
+  }
+  m_shared_input_redistributions[input_index] = &copy;
+  return true;
+}
+
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType,
                      OutputTensorDataType>::fp_setup_inputs()
@@ -1188,9 +1461,19 @@ void data_type_layer<InputTensorDataType,
 
     // Initialize input tensor
     const auto& parent = get_parent_layer(i);
-    const auto& parent_output = parent.get_activations(*this);
     auto& input = get_prev_activations(i);
     input.Empty(false);
+    auto* pipeline = this->get_model()->get_pipeline();
+    if (pipeline != nullptr && !pipeline->is_in_stage(parent)) {
+      const auto& received = pipeline->receive_input(parent, *this, input);
+      view_or_copy_tensor(received, input, !m_runs_inplace);
+      continue;
+    }
+    const auto& parent_output = parent.get_activations(*this);
+    if (m_shared_input_redistributions[i] != nullptr) {
+      El::LockedView(input, *m_shared_input_redistributions[i]);
+      continue;
+    }
     view_or_copy_tensor(parent_output, input, !m_runs_inplace);
   }
 }
@@ -1228,7 +1511,7 @@ void data_type_layer<InputTensorDataType,
       continue;
 #endif // LBANN_HAS_DISTCONV
     auto& output = get_activations(i);
-    if (output.Viewing()) {
+    if (output.Viewing() && !is_planned_tensor(output)) {
       LBANN_ERROR(get_name(),
                   " fp_setup_outputs should be overridden",
                   " if it needs to handle outputs that view",
@@ -1238,7 +1521,16 @@ void data_type_layer<InputTensorDataType,
     if (align_outputs) {
       output.AlignWith(alignment_dist);
     }
-    output.Resize(get_output_size(i), mini_batch_size);
+    // Planned tensors are not reference counted, the plan already
+    // frees their memory for reuse after their last use
+    if (attach_planned_tensor(output,
+                              i,
+                              false,
+                              get_output_size(i),
+                              mini_batch_size)) {
+      continue;
+    }
+    resize_for_mini_batch(output, get_output_size(i), mini_batch_size);
     this->setup_reference_counter(output);
   }
 }
@@ -1445,7 +1737,15 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::
          ? m_gradient_wrt_outputs[i]
          : m_gradient_wrt_inputs[i]);
 
-    if (m_persistent_error_signals)
+    // Parents in other pipeline stages run on other processes
+    auto* pipeline = this->get_model()->get_pipeline();
+    if (pipeline != nullptr && !pipeline->is_in_stage(parent)) {
+      pipeline->send_error_signal(parent, *this, *error_signal);
+      continue;
+    }
+
+    // Planned error signals stay in place until the parent is done
+    if (m_persistent_error_signals || is_planned_tensor(*error_signal))
       attempt_view_error_signal(parent, *this, *error_signal);
     else if (error_signal->Viewing())
       deep_copy_error_signal(parent, *this, *error_signal);
@@ -1518,7 +1818,15 @@ void data_type_layer<InputTensorDataType,
     }
     gradient_wrt_input.Empty(false);
     gradient_wrt_input.AlignWith(get_prev_activations(i));
-    gradient_wrt_input.Resize(get_input_size(i), mini_batch_size);
+    if (!attach_planned_tensor(gradient_wrt_input,
+                               i,
+                               true,
+                               get_input_size(i),
+                               mini_batch_size)) {
+      resize_for_mini_batch(gradient_wrt_input,
+                            get_input_size(i),
+                            mini_batch_size);
+    }
   }
 }
 
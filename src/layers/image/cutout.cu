@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_CUTOUT_LAYER_INSTANTIATE
+#include "lbann/layers/image/cutout_impl.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** Each thread handles one pixel. In-place, only pixels in the square are
+ *  written. */
+template <typename TensorDataType>
+__global__ void fp_kernel(El::Int num_samples,
+                          El::Int num_channels,
+                          El::Int input_height,
+                          El::Int input_width,
+                          El::Int row_center,
+                          El::Int col_center,
+                          const TensorDataType* __restrict__ cutouts,
+                          El::Int cutouts_ldim,
+                          const TensorDataType* input,
+                          El::Int input_ldim,
+                          TensorDataType* output,
+                          El::Int output_ldim,
+                          bool inplace)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int sample_size = num_channels * input_height * input_width;
+  const El::Int size = num_samples * sample_size;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const auto& sample = pos / sample_size;
+    const auto& idx = pos % sample_size;
+    const auto& row = (idx / input_width) % input_height;
+    const auto& col = idx % input_width;
+
+    const float cutout = static_cast<float>(cutouts[sample * cutouts_ldim]);
+    El::Int col_start = static_cast<El::Int>(col_center - cutout / 2);
+    col_start = col_start > 0 ? col_start : 0;
+    El::Int col_end = static_cast<El::Int>(col_start + cutout);
+    col_end = col_end < input_width - 1 ? col_end : input_width - 1;
+    El::Int row_start = static_cast<El::Int>(row_center - cutout / 2);
+    row_start = row_start > 0 ? row_start : 0;
+    El::Int row_end = static_cast<El::Int>(row_start + cutout);
+    row_end = row_end < input_height - 1 ? row_end : input_height - 1;
+
+    const bool inside = (col >= col_start && col < col_end &&
+                         row >= row_start && row < row_end);
+    if (inside) {
+      output[sample * output_ldim + idx] = TensorDataType(0.f);
+    }
+    else if (!inplace) {
+      output[sample * output_ldim + idx] = input[sample * input_ldim + idx];
+    }
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void cutout_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+
+  // Matrices
+  const auto& local_input = this->get_local_prev_activations();
+  const auto& local_cutouts = this->get_local_prev_activations(1);
+  auto& local_output = this->get_local_activations();
+
+  // Dimensions
+  const auto& input_dims = this->get_input_dims(0);
+  const El::Int num_samples = local_input.Width();
+  const El::Int num_channels = input_dims[0];
+  const El::Int input_height = input_dims[1];
+  const El::Int input_width = input_dims[2];
+
+  const auto center = draw_cutout_center();
+
+  // Get GPU grid dimensions
+  const El::Int size = local_input.Height() * num_samples;
+  constexpr El::Int block_dim = 256;
+  El::Int grid_dim = (size + block_dim - 1) / block_dim;
+  if (sizeof(El::Int) > sizeof(uint32_t) &&
+      grid_dim > std::numeric_limits<uint32_t>::max()) {
+    grid_dim = std::numeric_limits<uint32_t>::max();
+  }
+
+  // Launch GPU kernel
+  if (grid_dim > 0) {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_output),
+                                       gpu::get_sync_info(local_input),
+                                       gpu::get_sync_info(local_cutouts));
+    hydrogen::gpu::LaunchKernel(fp_kernel<TensorDataType>,
+                                grid_dim,
+                                block_dim,
+                                0,
+                                multisync,
+                                num_samples,
+                                num_channels,
+                                input_height,
+                                input_width,
+                                center.first,
+                                center.second,
+                                local_cutouts.LockedBuffer(),
+                                local_cutouts.LDim(),
+                                local_input.LockedBuffer(),
+                                local_input.LDim(),
+                                local_output.Buffer(),
+                                local_output.LDim(),
+                                this->runs_inplace());
+  }
+}
+
+#define PROTO(T)                                                               \
+  template class cutout_layer<T, data_layout::DATA_PARALLEL, El::Device::GPU>
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_IMAGE_AUGMENTATION_LAYER_INSTANTIATE
+#include "lbann/layers/image/image_augmentation_impl.hpp"
+
+#include <cmath>
+
+namespace lbann {
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void image_augmentation_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+
+  // Input and output tensors
+  const auto& local_input = this->get_local_prev_activations();
+  auto& local_output = this->get_local_activations();
+
+  // Tensor dimensions
+  const auto& input_dims = this->get_input_dims();
+  const auto& output_dims = this->get_output_dims();
+  const El::Int num_samples = local_input.Width();
+  const El::Int num_channels = input_dims[0];
+  const El::Int input_height = input_dims[1];
+  const El::Int input_width = input_dims[2];
+  const El::Int output_height = output_dims[1];
+  const El::Int output_width = output_dims[2];
+
+  El::Matrix<float, El::Device::CPU> transforms(num_coefficients,
+                                                num_samples);
+  draw_transforms(transforms);
+
+  // Resample each output pixel once with the composed transform
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int sample = 0; sample < num_samples; ++sample) {
+    for (El::Int output_row = 0; output_row < output_height; ++output_row) {
+      const float* a = transforms.LockedBuffer(0, sample);
+      const TensorDataType* x = local_input.LockedBuffer(0, sample);
+      TensorDataType* y = local_output.Buffer(0, sample);
+      for (El::Int output_col = 0; output_col < output_width; ++output_col) {
+
+        // Interpolation point relative to input pixel centers
+        const float out_x = output_col + 0.5f;
+        const float out_y = output_row + 0.5f;
+        const float in_x = a[0] * out_x + a[1] * out_y + a[2] - 0.5f;
+        const float in_y = a[3] * out_x + a[4] * out_y + a[5] - 0.5f;
+        const El::Int col0 = static_cast<El::Int>(std::floor(in_x));
+        const El::Int row0 = static_cast<El::Int>(std::floor(in_y));
+        const float unit_x = in_x - col0;
+        const float unit_y = in_y - row0;
+
+        // Neighbors outside the input are zero
+        const bool has_col0 = (col0 >= 0 && col0 < input_width);
+        const bool has_col1 = (col0 + 1 >= 0 && col0 + 1 < input_width);
+        const bool has_row0 = (row0 >= 0 && row0 < input_height);
+        const bool has_row1 = (row0 + 1 >= 0 && row0 + 1 < input_height);
+        const float w00 = (has_row0 && has_col0)
+                            ? (1.f - unit_x) * (1.f - unit_y)
+                            : 0.f;
+        const float w01 =
+          (has_row0 && has_col1) ? unit_x * (1.f - unit_y) : 0.f;
+        const float w10 =
+          (has_row1 && has_col0) ? (1.f - unit_x) * unit_y : 0.f;
+        const float w11 = (has_row1 && has_col1) ? unit_x * unit_y : 0.f;
+        const El::Int offset = row0 * input_width + col0;
+
+        for (El::Int channel = 0; channel < num_channels; ++channel) {
+          const TensorDataType* x_c =
+            x + channel * input_height * input_width;
+          float result = 0.f;
+          if (w00 != 0.f)
+            result += w00 * static_cast<float>(x_c[offset]);
+          if (w01 != 0.f)
+            result += w01 * static_cast<float>(x_c[offset + 1]);
+          if (w10 != 0.f)
+            result += w10 * static_cast<float>(x_c[offset + input_width]);
+          if (w11 != 0.f)
+            result += w11 * static_cast<float>(x_c[offset + input_width + 1]);
+          y[channel * output_height * output_width +
+            output_row * output_width + output_col] =
+            static_cast<TensorDataType>(result);
+        }
+      }
+    }
+  }
+}
+
+#define PROTO(T)                                                               \
+  template class image_augmentation_layer<T,                                   \
+                                          data_layout::DATA_PARALLEL,          \
+                                          El::Device::CPU>
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
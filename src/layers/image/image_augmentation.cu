@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_IMAGE_AUGMENTATION_LAYER_INSTANTIATE
+#include "lbann/layers/image/image_augmentation_impl.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** Each thread computes one output pixel in every channel. */
+template <typename TensorDataType>
+__global__ void fp_kernel(El::Int num_samples,
+                          El::Int num_channels,
+                          El::Int input_height,
+                          El::Int input_width,
+                          El::Int output_height,
+                          El::Int output_width,
+                          const float* __restrict__ transforms,
+                          El::Int transforms_ldim,
+                          const TensorDataType* __restrict__ input,
+                          El::Int input_ldim,
+                          TensorDataType* __restrict__ output,
+                          El::Int output_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int size = num_samples * output_height * output_width;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const auto& sample = pos / (output_height * output_width);
+    const auto& output_row = (pos / output_width) % output_height;
+    const auto& output_col = pos % output_width;
+    const float* a = &transforms[sample * transforms_ldim];
+
+    // Interpolation point relative to input pixel centers
+    const float out_x = output_col + 0.5f;
+    const float out_y = output_row + 0.5f;
+    const float in_x = a[0] * out_x + a[1] * out_y + a[2] - 0.5f;
+    const float in_y = a[3] * out_x + a[4] * out_y + a[5] - 0.5f;
+    const El::Int col0 = static_cast<El::Int>(gpu_lib::floor(in_x));
+    const El::Int row0 = static_cast<El::Int>(gpu_lib::floor(in_y));
+    const float unit_x = in_x - col0;
+    const float unit_y = in_y - row0;
+
+    // Neighbors outside the input are zero
+    const bool has_col0 = (col0 >= 0 && col0 < input_width);
+    const bool has_col1 = (col0 + 1 >= 0 && col0 + 1 < input_width);
+    const bool has_row0 = (row0 >= 0 && row0 < input_height);
+    const bool has_row1 = (row0 + 1 >= 0 && row0 + 1 < input_height);
+    const float w00 =
+      (has_row0 && has_col0) ? (1.f - unit_x) * (1.f - unit_y) : 0.f;
+    const float w01 = (has_row0 && has_col1) ? unit_x * (1.f - unit_y) : 0.f;
+    const float w10 = (has_row1 && has_col0) ? (1.f - unit_x) * unit_y : 0.f;
+    const float w11 = (has_row1 && has_col1) ? unit_x * unit_y : 0.f;
+    const El::Int offset = row0 * input_width + col0;
+
+    const TensorDataType* x = &input[sample * input_ldim];
+    TensorDataType* y = &output[sample * output_ldim +
+                                output_row * output_width + output_col];
+    for (El::Int channel = 0; channel < num_channels; ++channel) {
+      float result = 0.f;
+      if (w00 != 0.f)
+        result += w00 * static_cast<float>(x[offset]);
+      if (w01 != 0.f)
+        result += w01 * static_cast<float>(x[offset + 1]);
+      if (w10 != 0.f)
+        result += w10 * static_cast<float>(x[offset + input_width]);
+      if (w11 != 0.f)
+        result += w11 * static_cast<float>(x[offset + input_width + 1]);
+      y[channel * output_height * output_width] =
+        static_cast<TensorDataType>(result);
+      x += input_height * input_width;
+    }
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void image_augmentation_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+
+  // Matrices
+  const auto& local_input = this->get_local_prev_activations();
+  auto& local_output = this->get_local_activations();
+
+  // Dimensions
+  const auto& input_dims = this->get_input_dims();
+  const auto& output_dims = this->get_output_dims();
+  const El::Int num_samples = local_input.Width();
+  const El::Int num_channels = input_dims[0];
+  const El::Int input_height = input_dims[1];
+  const El::Int input_width = input_dims[2];
+  const El::Int output_height = output_dims[1];
+  const El::Int output_width = output_dims[2];
+  if (num_samples == 0) {
+    return;
+  }
+
+  // Draw the transforms on the host and copy them to the GPU
+  auto sync_info = gpu::get_sync_info(local_output);
+  El::Matrix<float, El::Device::CPU> transforms(num_coefficients,
+                                                num_samples);
+  draw_transforms(transforms);
+  hydrogen::simple_buffer<float, El::Device::GPU> device_transforms(
+    transforms.Height() * transforms.Width(),
+    sync_info);
+  hydrogen::gpu::Copy1DToDevice(transforms.LockedBuffer(),
+                                device_transforms.data(),
+                                transforms.Height() * transforms.Width(),
+                                sync_info);
+
+  // Get GPU grid dimensions
+  const El::Int size = num_samples * output_height * output_width;
+  constexpr El::Int block_dim = 256;
+  El::Int grid_dim = (size + block_dim - 1) / block_dim;
+  if (sizeof(El::Int) > sizeof(uint32_t) &&
+      grid_dim > std::numeric_limits<uint32_t>::max()) {
+    grid_dim = std::numeric_limits<uint32_t>::max();
+  }
+
+  // Launch GPU kernel
+  if (grid_dim > 0) {
+    auto multisync =
+      El::MakeMultiSync(sync_info, gpu::get_sync_info(local_input));
+    hydrogen::gpu::LaunchKernel(fp_kernel<TensorDataType>,
+                                grid_dim,
+                                block_dim,
+                                0,
+                                multisync,
+                                num_samples,
+                                num_channels,
+                                input_height,
+                                input_width,
+                                output_height,
+                                output_width,
+                                device_transforms.data(),
+                                num_coefficients,
+                                local_input.LockedBuffer(),
+                                local_input.LDim(),
+                                local_output.Buffer(),
+                                local_output.LDim());
+  }
+}
+
+#define PROTO(T)                                                               \
+  template class image_augmentation_layer<T,                                   \
+                                          data_layout::DATA_PARALLEL,          \
+                                          El::Device::GPU>
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -29,6 +29,7 @@
 #include "lbann/layers/image/bilinear_resize.hpp"
 #include "lbann/layers/image/composite_image_transformation.hpp"
 #include "lbann/layers/image/cutout.hpp"
+#include "lbann/layers/image/image_augmentation.hpp"
 #include "lbann/layers/image/rotation.hpp"
 #include "lbann/utils/exception.hpp"
 
@@ -119,25 +120,44 @@ template <typename T, lbann::data_layout L, El::Device D>
 std::unique_ptr<lbann::Layer>
 lbann::build_cutout_layer_from_pbuf(lbann_comm* comm, lbann_data::Layer const&)
 {
-  if constexpr (L == data_layout::DATA_PARALLEL && D == El::Device::CPU)
-    if constexpr (std::is_same_v<T, float>)
-      return std::make_unique<
-        cutout_layer<float, data_layout::DATA_PARALLEL, El::Device::CPU>>(comm);
-#ifdef LBANN_HAS_DOUBLE
-    else if constexpr (std::is_same_v<T, double>)
-      return std::make_unique<
-        cutout_layer<double, data_layout::DATA_PARALLEL, El::Device::CPU>>(
-        comm);
-#endif // LBANN_HAS_DOUBLE
-    else {
-      (void)comm;
-      LBANN_ERROR(
-        "cutout_layer is only supported for \"float\" and \"double\".");
-    }
+  if constexpr (L == data_layout::DATA_PARALLEL &&
+                (std::is_same_v<T, float> || std::is_same_v<T, double>)) {
+    return std::make_unique<cutout_layer<T, data_layout::DATA_PARALLEL, D>>(
+      comm);
+  }
   else {
     (void)comm;
     LBANN_ERROR("cutout layer is only supported with a data-parallel layout "
-                "and on CPU");
+                "and for \"float\" and \"double\"");
+    return nullptr;
+  }
+}
+
+template <typename T, lbann::data_layout L, El::Device D>
+std::unique_ptr<lbann::Layer>
+lbann::build_image_augmentation_layer_from_pbuf(
+  lbann_comm* comm,
+  lbann_data::Layer const& proto_layer)
+{
+  if constexpr (L == data_layout::DATA_PARALLEL) {
+    auto const& params = proto_layer.image_augmentation();
+    auto const min_scale = params.min_scale() > 0.f ? params.min_scale() : 1.f;
+    auto const max_scale =
+      params.max_scale() > 0.f ? params.max_scale() : min_scale;
+    return std::make_unique<
+      image_augmentation_layer<T, data_layout::DATA_PARALLEL, D>>(
+      comm,
+      params.height(),
+      params.width(),
+      params.max_rotation(),
+      params.max_translation(),
+      min_scale,
+      max_scale);
+  }
+  else {
+    (void)comm;
+    LBANN_ERROR("image augmentation layer is only supported with a "
+                "data-parallel layout");
     return nullptr;
   }
 }
@@ -148,7 +168,8 @@ namespace lbann {
   LBANN_LAYER_BUILDER_ETI(bilinear_resize, T, Device);                         \
   LBANN_LAYER_BUILDER_ETI(composite_image_transformation, T, Device);          \
   LBANN_LAYER_BUILDER_ETI(rotation, T, Device);                                \
-  LBANN_LAYER_BUILDER_ETI(cutout, T, Device)
+  LBANN_LAYER_BUILDER_ETI(cutout, T, Device);                                  \
+  LBANN_LAYER_BUILDER_ETI(image_augmentation, T, Device)
 
 #include "lbann/macros/instantiate_device.hpp"
 
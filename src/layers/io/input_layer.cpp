@@ -313,6 +313,33 @@ void input_distconv_adapter<TensorDataType, T_layout, Dev>::setup_fp_tensors()
     auto dist_no_halo = dist;
     dist_no_halo.clear_overlap();
 
+    // Without a shuffle, each rank must have read exactly the spatial
+    // block of the sample that the Distconv distribution assigns to it
+    if (!m_shuffle_required && m_data_field == INPUT_DATA_TYPE_SAMPLES &&
+        dc::get_num_spatial_dims(this->layer()) == 3) {
+      const auto& io_shape = dc::get_io_partition_shape();
+      const auto& locale_shape = dist.get_locale_shape();
+      if (static_cast<int>(locale_shape[2]) != io_shape[0] ||
+          static_cast<int>(locale_shape[1]) != io_shape[1] ||
+          static_cast<int>(locale_shape[0]) != io_shape[2]) {
+        LBANN_ERROR("the data reader of ",
+                    this->layer().get_name(),
+                    " reads ",
+                    io_shape[0],
+                    "x",
+                    io_shape[1],
+                    "x",
+                    io_shape[2],
+                    " (DxHxW) sample blocks, but the layer is partitioned as ",
+                    locale_shape[2],
+                    "x",
+                    locale_shape[1],
+                    "x",
+                    locale_shape[0],
+                    "; set LBANN_DISTCONV_IO_PARTITION_SHAPE to match");
+      }
+    }
+
     const auto original_host_tensor_dist =
       m_shuffle_required ? sample_dist : dist_no_halo;
     // Create a view to the host LBANN matrix
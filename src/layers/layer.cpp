@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/layer.hpp"
+#include "lbann/comm.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/io/persist.hpp"
@@ -73,6 +74,8 @@ Layer::Layer(const Layer& other)
     m_update_time(other.m_update_time),
     m_name(other.m_name),
     m_runs_inplace(other.m_runs_inplace),
+    m_checkpoint(other.m_checkpoint),
+    m_int8_input_ranges(other.m_int8_input_ranges),
     m_parent_layers(other.m_parent_layers),
     m_child_layers(other.m_child_layers),
     m_weights(other.m_weights),
@@ -100,6 +103,8 @@ Layer& Layer::operator=(const Layer& other)
   m_output_dims_list = other.m_output_dims_list;
   m_hint_layer = other.m_hint_layer;
   m_runs_inplace = other.m_runs_inplace;
+  m_checkpoint = other.m_checkpoint;
+  m_int8_input_ranges = other.m_int8_input_ranges;
 
   return *this;
 }
@@ -480,6 +485,29 @@ bool Layer::is_frozen() const
   return m_frozen;
 }
 
+bool Layer::set_int8_input_ranges(std::vector<double> input_ranges)
+{
+  if (input_ranges.empty()) {
+    m_int8_input_ranges.clear();
+    return true;
+  }
+  if (!supports_int8_inference()) {
+    return false;
+  }
+  if (input_ranges.size() != static_cast<size_t>(get_num_parents())) {
+    LBANN_ERROR(get_type(),
+                " layer \"",
+                get_name(),
+                "\" has ",
+                get_num_parents(),
+                " inputs, but got ",
+                input_ranges.size(),
+                " int8 input ranges");
+  }
+  m_int8_input_ranges = std::move(input_ranges);
+  return true;
+}
+
 void Layer::setup(size_t max_mini_batch_size,
                   const std::vector<El::Grid*>& grids)
 {
@@ -780,10 +808,20 @@ void Layer::back_prop()
   LBANN_CALIPER_MARK_SCOPE(scope_name.c_str());
 #endif
 
+  // Error signals may still be in flight from the children
+  for (int i = 0; i < get_num_children(); ++i) {
+    const_cast<Layer&>(get_child_layer(i)).finish_pending_communication();
+  }
+
   allocate_new_gradients_();
   back_prop_impl_();
-  propagate_error_signals_to_parents_();
-  clear_prev_error_signals_();
+  if (m_pending_requests.empty()) {
+    propagate_error_signals_to_parents_();
+    clear_prev_error_signals_();
+  }
+  else {
+    m_error_signals_deferred = true;
+  }
 
   // Release the now-unnecessary full weight views
   for (size_t i = 0; i < this->num_weights(); ++i) {
@@ -791,6 +829,28 @@ void Layer::back_prop()
   }
 }
 
+void Layer::add_pending_communication(Al::request const& req)
+{
+  m_pending_requests.push_back(req);
+}
+
+void Layer::finish_pending_communication()
+{
+  if (m_pending_requests.empty()) {
+    return;
+  }
+  for (auto& req : m_pending_requests) {
+    get_comm()->wait(req);
+  }
+  m_pending_requests.clear();
+  finalize_pending_communication();
+  if (m_error_signals_deferred) {
+    m_error_signals_deferred = false;
+    propagate_error_signals_to_parents_();
+    clear_prev_error_signals_();
+  }
+}
+
 void Layer::write_proto(lbann_data::Layer& proto) const
 {
   proto.Clear();
@@ -808,6 +868,7 @@ void Layer::write_proto(lbann_data::Layer& proto) const
   proto.set_data_layout(to_string(this->get_data_layout()));
   if (this->get_hint_layer())
     proto.set_hint_layer(this->get_hint_layer()->get_name());
+  proto.set_checkpoint(m_checkpoint);
   // FIXME(KLG): Ignore for now. (Tom's problem)
   // proto.set_parallel_strategy();
 
@@ -25,6 +25,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/layers/learning/base_convolution.hpp"
+#include "lbann/layers/learning/bias_activation.hpp"
+#include "lbann/layers/regularizers/batch_normalization.hpp"
+#include "lbann/layers/transform/upsample.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/layers/layer.hpp"
 #include "lbann/models/model.hpp"
@@ -32,9 +35,12 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu_workspace.hpp"
 #include "lbann/utils/im2col.hpp"
+#include "lbann/utils/int8.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/timer.hpp"
+#include "lbann/utils/typename.hpp"
 #ifdef LBANN_HAS_DNN_LIB
 #include "lbann/utils/dnn_lib/convolution.hpp"
 #include "lbann/utils/dnn_lib/helpers.hpp"
@@ -48,8 +54,11 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace lbann {
@@ -102,7 +111,11 @@ base_convolution_layer<TensorDataType, Device>::base_convolution_layer(
     m_strides(other.m_strides),
     m_dilations(other.m_dilations),
     m_groups(other.m_groups),
-    m_bias_scaling_factor(other.m_bias_scaling_factor)
+    m_bias_scaling_factor(other.m_bias_scaling_factor),
+    m_channels_last(other.m_channels_last),
+    m_fused_activation(other.m_fused_activation),
+    m_upsample_factors(other.m_upsample_factors),
+    m_upsample_pads(other.m_upsample_pads)
 #ifdef LBANN_HAS_DNN_LIB
     ,
     m_convolution_math_type(other.m_convolution_math_type),
@@ -134,6 +147,12 @@ auto base_convolution_layer<TensorDataType, Device>::operator=(
   m_dilations = other.m_dilations;
   m_groups = other.m_groups;
   m_bias_scaling_factor = other.m_bias_scaling_factor;
+  m_channels_last = other.m_channels_last;
+  m_fused_activation = other.m_fused_activation;
+  m_fused_preactivations.reset();
+  m_fused_activation_gradient.reset();
+  m_upsample_factors = other.m_upsample_factors;
+  m_upsample_pads = other.m_upsample_pads;
 
 #ifdef LBANN_HAS_DNN_LIB
   // Copy DNN library objects
@@ -149,6 +168,9 @@ auto base_convolution_layer<TensorDataType, Device>::operator=(
   m_bwd_data_dnn_algos = other.m_bwd_data_dnn_algos;
   m_bwd_filter_dnn_algos = other.m_bwd_filter_dnn_algos;
 #endif // LBANN_HAS_DNN_LIB
+#ifdef LBANN_HAS_ONEDNN_CPU
+  m_onednn_convolutions.clear();
+#endif // LBANN_HAS_ONEDNN_CPU
 
   return *this;
 }
@@ -166,6 +188,35 @@ void base_convolution_layer<TensorDataType, Device>::set_dnn_math_mode(
 }
 #endif // LBANN_HAS_DNN_LIB
 
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::set_channels_last(
+  bool channels_last) noexcept
+{
+  m_channels_last = channels_last;
+}
+
+template <typename TensorDataType, El::Device Device>
+std::vector<int>
+base_convolution_layer<TensorDataType, Device>::to_channels_first(
+  std::vector<int> dims) const
+{
+  if (m_channels_last && dims.size() > 1) {
+    std::rotate(dims.rbegin(), dims.rbegin() + 1, dims.rend());
+  }
+  return dims;
+}
+
+template <typename TensorDataType, El::Device Device>
+std::vector<int>
+base_convolution_layer<TensorDataType, Device>::from_channels_first(
+  std::vector<int> dims) const
+{
+  if (m_channels_last && dims.size() > 1) {
+    std::rotate(dims.begin(), dims.begin() + 1, dims.end());
+  }
+  return dims;
+}
+
 template <typename TensorDataType, El::Device Device>
 description
 base_convolution_layer<TensorDataType, Device>::get_description() const
@@ -208,6 +259,10 @@ base_convolution_layer<TensorDataType, Device>::get_description() const
   // Groups
   desc.add("Groups", m_groups);
 
+  // Tensor layout
+  desc.add("Tensor layout",
+           m_channels_last ? "channels-last" : "channels-first");
+
   // Bias
   ss.str(std::string{});
   ss.clear();
@@ -216,6 +271,16 @@ base_convolution_layer<TensorDataType, Device>::get_description() const
            : "enabled");
   desc.add("Bias", ss.str());
 
+  // Fused upsample
+  if (!m_upsample_factors.empty()) {
+    ss.str(std::string{});
+    ss.clear();
+    for (size_t i = 0; i < m_upsample_factors.size(); ++i) {
+      ss << (i > 0 ? ", " : "") << m_upsample_factors[i];
+    }
+    desc.add("Fused upsample factors", ss.str());
+  }
+
 #ifdef LBANN_HAS_DNN_LIB
   if (Device == El::Device::GPU) {
     desc.add("DNN Math Mode",
@@ -234,7 +299,7 @@ void base_convolution_layer<TensorDataType, Device>::setup_dims()
   std::ostringstream err;
 
   // Check number of channels and channel groups
-  const auto& input_dims = this->get_input_dims();
+  const auto input_dims = to_channels_first(this->get_input_dims());
   if (m_output_channels < 1) {
     err << this->get_type() << " layer \"" << this->get_name() << "\" "
         << "has an invalid number of output channels "
@@ -320,6 +385,18 @@ void base_convolution_layer<TensorDataType, Device>::setup_dims()
         << "but only one group is currently supported on CPU";
     LBANN_ERROR(err.str());
   }
+  if (m_channels_last) {
+#ifndef LBANN_HAS_CUDNN
+    err << this->get_type() << " layer \"" << this->get_name() << "\" "
+        << "uses a channels-last layout, which requires cuDNN";
+    LBANN_ERROR(err.str());
+#endif // LBANN_HAS_CUDNN
+    if (Device == El::Device::CPU) {
+      err << this->get_type() << " layer \"" << this->get_name() << "\" "
+          << "uses a channels-last layout, which is not supported on CPU";
+      LBANN_ERROR(err.str());
+    }
+  }
 }
 
 template <typename TensorDataType, El::Device Device>
@@ -329,8 +406,8 @@ void base_convolution_layer<TensorDataType, Device>::setup_data(
   data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
 
   // Tensor dimensions
-  const auto& input_dims = this->get_input_dims();
-  const auto& output_dims = this->get_output_dims();
+  const auto input_dims = to_channels_first(this->get_input_dims());
+  const auto output_dims = to_channels_first(this->get_output_dims());
   const auto& kernel_dims_ = this->get_kernel_dims();
   std::vector<size_t> kernel_dims(kernel_dims_.begin(), kernel_dims_.end());
   const auto kernel_size = get_linear_size(kernel_dims);
@@ -420,6 +497,43 @@ void base_convolution_layer<TensorDataType, Device>::setup_data(
                   "\"");
     }
   }
+
+  // Transposed convolution for a fused upsample
+  if (!m_upsample_factors.empty()) {
+    const size_t num_spatial_dims = m_conv_dims.size();
+    El::Int window_height = 1, window_width = 1;
+    for (size_t d = 0; d < num_spatial_dims; ++d) {
+      window_height *= m_conv_dims[d] + m_upsample_factors[d] - 1;
+      window_width *= m_conv_dims[d];
+    }
+    El::Matrix<TensorDataType, El::Device::CPU> window(window_height,
+                                                       window_width);
+    for (El::Int row = 0; row < window_height; ++row) {
+      for (El::Int col = 0; col < window_width; ++col) {
+        // Kernel entry j contributes to transposed kernel entry m if
+        // j + m - (kernel dim - 1) is in [0, scale factor) in every
+        // spatial dimension
+        bool inside = true;
+        El::Int m = row, j = col;
+        for (size_t d = num_spatial_dims; d-- > 0;) {
+          const El::Int kernel_dim = m_conv_dims[d];
+          const El::Int expanded_dim = kernel_dim + m_upsample_factors[d] - 1;
+          const El::Int offset =
+            j % kernel_dim + m % expanded_dim - (kernel_dim - 1);
+          inside = inside && offset >= 0 && offset < m_upsample_factors[d];
+          m /= expanded_dim;
+          j /= kernel_dim;
+        }
+        window(row, col) = (inside ? El::TypeTraits<TensorDataType>::One()
+                                   : El::TypeTraits<TensorDataType>::Zero());
+      }
+    }
+    El::Copy(window, m_upsample_window);
+    const El::Int expanded_size = get_linear_size(get_computed_kernel_dims());
+    m_upsample_kernel.Resize(expanded_size / input_dims[0], input_dims[0]);
+    m_upsample_kernel_gradient.Resize(expanded_size / input_dims[0],
+                                      input_dims[0]);
+  }
 }
 
 template <typename TensorDataType, El::Device Device>
@@ -430,18 +544,20 @@ void base_convolution_layer<TensorDataType, Device>::setup_gpu()
   LBANN_ERROR("DNN library not detected");
 #else
 
-  const auto& output_dims = this->get_output_dims();
-  const auto& kernel_dims = this->get_kernel_dims();
+  const auto output_dims = to_channels_first(this->get_output_dims());
+  const auto kernel_dims = get_computed_kernel_dims();
+  m_tensors_dnn_desc.set_channels_last(m_channels_last);
 
   // Set kernel descriptor
   m_kernel_dnn_desc.set(dnn_lib::get_data_type<TensorDataType>(),
-                        dnn_lib::DNN_TENSOR_NCHW,
+                        (m_channels_last ? dnn_lib::DNN_TENSOR_NHWC
+                                         : dnn_lib::DNN_TENSOR_NCHW),
                         kernel_dims);
 
   // Set convolution descriptor
   m_convolution_dnn_desc.set(
-    m_pads,
-    m_strides,
+    get_computed_pads(),
+    get_computed_strides(),
     m_dilations,
     dnn_lib::get_convolution_data_type<TensorDataType>(),
     dnn_lib::DNN_CROSS_CORRELATION);
@@ -471,7 +587,7 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_dnn(
   const auto one = El::TypeTraits<ScalingType>::One();
 
   // Matrices
-  const auto& kernel = this->weights_values(0);
+  const auto& kernel = get_computed_kernel();
   const auto& input =
     (during_forward_prop ? this->get_local_prev_activations()
                          : this->get_local_prev_error_signals());
@@ -484,12 +600,6 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_dnn(
     return;
   }
 
-  // Initialize GPU workspace
-  El::Matrix<TensorDataType, El::Device::GPU> workspace;
-#ifdef HYDROGEN_HAVE_CUB
-  workspace.SetMemoryMode(1);
-#endif // HYDROGEN_HAVE_CUB
-
   // Convolution parameters
   std::vector<int> input_dims, output_dims;
   if (during_forward_prop) {
@@ -508,14 +618,16 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_dnn(
                          : m_tensors_dnn_desc.get_error_signals());
 
   // Get workspace size
-  auto multisync = El::MakeMultiSync(gpu::get_sync_info(workspace));
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output));
   size_t workspace_size =
     dnn_lib::get_fwd_conv_workspace_size(m_kernel_dnn_desc,
                                          input_desc,
                                          m_convolution_dnn_desc,
                                          output_desc,
                                          multisync);
-  workspace.Resize(workspace_size / sizeof(TensorDataType), 1);
+  auto workspace =
+    gpu::get_workspace_matrix<TensorDataType>(workspace_size,
+                                              gpu::get_sync_info(output));
   workspace_size = workspace.Height() * sizeof(TensorDataType);
 
   // Perform convolution on the GPU
@@ -538,7 +650,7 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_dnn(
                                input_desc,
                                input,
                                m_kernel_dnn_desc,
-                               kernel.LockedMatrix(),
+                               kernel,
                                m_convolution_dnn_desc,
                                convolution_dnn_algorithm_config.first,
                                workspace,
@@ -562,7 +674,7 @@ void base_convolution_layer<TensorDataType, Device>::
   const auto one = El::TypeTraits<ScalingType>::One();
 
   // GPU data
-  const auto& kernel = this->weights_values(0);
+  const auto& kernel = get_computed_kernel();
   const auto& input =
     (during_forward_prop ? this->get_local_prev_activations()
                          : this->get_local_prev_error_signals());
@@ -575,13 +687,6 @@ void base_convolution_layer<TensorDataType, Device>::
     return;
   }
 
-  // Initialize GPU workspace
-  // Note: Use CUB GPU memory pool if possible
-  El::Matrix<TensorDataType, El::Device::GPU> workspace;
-#ifdef HYDROGEN_HAVE_CUB
-  workspace.SetMemoryMode(1);
-#endif // HYDROGEN_HAVE_CUB
-
   // Convolution transpose parameters
   std::vector<int> input_dims, output_dims;
   if (during_forward_prop) {
@@ -600,14 +705,16 @@ void base_convolution_layer<TensorDataType, Device>::
                          : m_tensors_dnn_desc.get_error_signals());
 
   // Get workspace size
-  auto multisync = El::MakeMultiSync(gpu::get_sync_info(workspace));
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output));
   size_t workspace_size =
     dnn_lib::get_bwd_data_conv_workspace_size(input_desc,
                                               m_kernel_dnn_desc,
                                               m_convolution_dnn_desc,
                                               output_desc,
                                               multisync);
-  workspace.Resize(workspace_size / sizeof(TensorDataType), 1);
+  auto workspace =
+    gpu::get_workspace_matrix<TensorDataType>(workspace_size,
+                                              gpu::get_sync_info(output));
   workspace_size = workspace.Height() * sizeof(TensorDataType);
 
   // Perform transposed convolution on the GPU
@@ -631,7 +738,7 @@ void base_convolution_layer<TensorDataType, Device>::
   dnn_lib::convolution_backward_data(
     one,
     m_kernel_dnn_desc,
-    kernel.LockedMatrix(),
+    kernel,
     input_desc,
     input,
     m_convolution_dnn_desc,
@@ -650,6 +757,10 @@ void base_convolution_layer<TensorDataType, Device>::apply_bias_dnn()
 #ifndef LBANN_HAS_DNN_LIB
   LBANN_ERROR("DNN library not detected");
 #else
+  if (m_fused_activation != fused_activation::NONE) {
+    apply_bias_and_fused_activation();
+    return;
+  }
   auto& local_output = this->get_local_activations();
   if (m_bias_scaling_factor != El::TypeTraits<ScalingType>::Zero() &&
       local_output.Height() > 0 && local_output.Width() > 0) {
@@ -717,22 +828,24 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_dnn(
                                             gradient_scale_dt,
                                             true);
     if (has_local_data) {
-      // Initialize GPU workspace
-      El::Matrix<TensorDataType, El::Device::GPU> workspace;
-#ifdef HYDROGEN_HAVE_CUB
-      workspace.SetMemoryMode(1); // CUB GPU memory pool
-#endif // HYDROGEN_HAVE_CUB
-
       // Initialize DNN library objects
       auto&& input_desc = m_tensors_dnn_desc.get_prev_activations();
       auto&& gradient_wrt_output_desc =
         m_tensors_dnn_desc.get_prev_error_signals();
 
-      auto dst_scale = ScalingType(dst_scale_dt),
-           gradient_scale = ScalingType(gradient_scale_dt);
+      // With a fused upsample, the gradient w.r.t. the transposed
+      // convolution kernel is contracted afterwards
+      const bool upsampled = !m_upsample_factors.empty();
+      El::AbstractMatrix<TensorDataType>& local_kernel_gradient =
+        (upsampled ? m_upsample_kernel_gradient : kernel_gradient.Matrix());
+      auto dst_scale = (upsampled ? El::TypeTraits<ScalingType>::Zero()
+                                  : ScalingType(dst_scale_dt)),
+           gradient_scale = (upsampled ? El::TypeTraits<ScalingType>::One()
+                                       : ScalingType(gradient_scale_dt));
 
       // Get workspace size
-      auto multisync = El::MakeMultiSync(gpu::get_sync_info(workspace));
+      const auto sync_info = gpu::get_sync_info(kernel_gradient.Matrix());
+      auto multisync = El::MakeMultiSync(sync_info);
 
       // Determine algorithm and compute kernel gradient
       if (using_transposed_convolution) {
@@ -742,7 +855,8 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_dnn(
                                                        m_convolution_dnn_desc,
                                                        m_kernel_dnn_desc,
                                                        multisync);
-        workspace.Resize(workspace_size / sizeof(TensorDataType), 1);
+        auto workspace =
+          gpu::get_workspace_matrix<TensorDataType>(workspace_size, sync_info);
         workspace_size = workspace.Height() * sizeof(TensorDataType);
         dnn_lib::bwd_filter_conv_alg_config
           kernel_gradient_dnn_algorithm_config = get_backward_filter_algo_dnn(
@@ -768,7 +882,7 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_dnn(
           workspace,
           dst_scale,
           m_kernel_dnn_desc,
-          kernel_gradient.Matrix());
+          local_kernel_gradient);
       }
       else {
         size_t workspace_size =
@@ -777,7 +891,8 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_dnn(
                                                        m_convolution_dnn_desc,
                                                        m_kernel_dnn_desc,
                                                        multisync);
-        workspace.Resize(workspace_size / sizeof(TensorDataType), 1);
+        auto workspace =
+          gpu::get_workspace_matrix<TensorDataType>(workspace_size, sync_info);
         workspace_size = workspace.Height() * sizeof(TensorDataType);
         dnn_lib::bwd_filter_conv_alg_config
           kernel_gradient_dnn_algorithm_config = get_backward_filter_algo_dnn(
@@ -803,7 +918,12 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_dnn(
           workspace,
           dst_scale,
           m_kernel_dnn_desc,
-          kernel_gradient.Matrix());
+          local_kernel_gradient);
+      }
+      if (upsampled) {
+        contract_upsampled_kernel_gradient(kernel_gradient.Matrix(),
+                                           dst_scale_dt,
+                                           gradient_scale_dt);
       }
     }
     else {
@@ -820,7 +940,7 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_im2col(
 {
 
   // Local matrices
-  const auto& local_kernel = this->weights_values(0).LockedMatrix();
+  const auto& local_kernel = get_computed_kernel();
   const auto& local_input =
     (during_forward_prop ? this->get_local_prev_activations()
                          : this->get_local_prev_error_signals());
@@ -839,7 +959,7 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_im2col(
     input_dims = this->get_output_dims();
     output_dims = this->get_input_dims();
   }
-  const auto& kernel_dims = this->get_kernel_dims();
+  const auto kernel_dims = get_computed_kernel_dims();
   const auto kernel_size = get_linear_size(kernel_dims);
 
   // Initialize matrices
@@ -860,9 +980,9 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_im2col(
                            input_dims[0],
                            input_dims.size() - 1,
                            &input_dims[1],
-                           m_pads.data(),
+                           get_computed_pads().data(),
                            &kernel_dims[2],
-                           m_strides.data());
+                           get_computed_strides().data());
 
     // Apply convolution to current input column
     output_col.Attach(m, n, local_output.Buffer(0, col), m);
@@ -876,13 +996,86 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_im2col(
   }
 }
 
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::apply_convolution_int8()
+{
+  if constexpr (Device == El::Device::CPU &&
+                std::is_floating_point_v<TensorDataType>) {
+
+    // Local matrices
+    const auto& local_kernel = this->weights_values(0).LockedMatrix();
+    const auto& local_input = this->get_local_prev_activations();
+    auto& local_output = this->get_local_activations();
+
+    // Matrix parameters, as in apply_convolution_im2col
+    const auto& input_dims = this->get_input_dims();
+    const auto& output_dims = this->get_output_dims();
+    const auto& kernel_dims = this->get_kernel_dims();
+    const int m = local_output.Height() / output_dims[0];
+    const int n = output_dims[0];
+    const int k = get_linear_size(kernel_dims) / output_dims[0];
+
+    // Each output channel's filter gets its own scale
+    std::vector<int8_t> kernel(k * n);
+    std::vector<TensorDataType> kernel_scales(n);
+    quantize_int8_columns(local_kernel.LockedBuffer(),
+                          k,
+                          n,
+                          k,
+                          false,
+                          kernel_scales.data(),
+                          kernel.data());
+
+    const auto input_scale = int8_scale(
+      static_cast<TensorDataType>(this->get_int8_input_ranges().front()));
+    DMatDT<Device> input_col;
+    DMatDT<Device> im2col_matrix(k, m);
+    std::vector<int8_t> im2col_int8(k * m);
+    for (El::Int col = 0; col < local_input.Width(); ++col) {
+      El::LockedView(input_col, local_input, El::ALL, El::IR(col));
+      im2col<TensorDataType>(input_col,
+                             im2col_matrix,
+                             input_dims[0],
+                             input_dims.size() - 1,
+                             &input_dims[1],
+                             m_pads.data(),
+                             &kernel_dims[2],
+                             m_strides.data());
+      quantize_int8(im2col_matrix.LockedBuffer(),
+                    k,
+                    m,
+                    im2col_matrix.LDim(),
+                    false,
+                    input_scale,
+                    im2col_int8.data());
+      gemm_int8(m,
+                n,
+                k,
+                input_scale,
+                im2col_int8.data(),
+                0,
+                static_cast<const TensorDataType*>(nullptr),
+                kernel.data(),
+                0,
+                kernel_scales.data(),
+                local_output.Buffer(0, col),
+                m,
+                0,
+                1);
+    }
+  }
+  else {
+    LBANN_ERROR("int8 inference requires float or double data on CPU");
+  }
+}
+
 template <typename TensorDataType, El::Device Device>
 void base_convolution_layer<TensorDataType, Device>::
   apply_transposed_convolution_im2col(bool during_forward_prop)
 {
 
   // Local matrices
-  const auto& local_kernel = this->weights_values(0).LockedMatrix();
+  const auto& local_kernel = get_computed_kernel();
   const auto& local_input =
     (during_forward_prop ? this->get_local_prev_activations()
                          : this->get_local_prev_error_signals());
@@ -902,7 +1095,7 @@ void base_convolution_layer<TensorDataType, Device>::
     input_dims = this->get_output_dims();
     output_dims = this->get_input_dims();
   }
-  const auto& kernel_dims = this->get_kernel_dims();
+  const auto kernel_dims = get_computed_kernel_dims();
   const auto kernel_size = get_linear_size(kernel_dims);
 
   // Initialize matrices
@@ -934,15 +1127,19 @@ void base_convolution_layer<TensorDataType, Device>::
                            output_dims[0],
                            output_dims.size() - 1,
                            &output_dims[1],
-                           m_pads.data(),
+                           get_computed_pads().data(),
                            &kernel_dims[2],
-                           m_strides.data());
+                           get_computed_strides().data());
   }
 }
 
 template <typename TensorDataType, El::Device Device>
 void base_convolution_layer<TensorDataType, Device>::apply_bias_cpu()
 {
+  if (m_fused_activation != fused_activation::NONE) {
+    apply_bias_and_fused_activation();
+    return;
+  }
 
   // Return immediately if there is no bias
   if (m_bias_scaling_factor == El::TypeTraits<ScalingType>::Zero())
@@ -975,8 +1172,275 @@ void base_convolution_layer<TensorDataType, Device>::apply_bias_cpu()
 }
 
 template <typename TensorDataType, El::Device Device>
-void base_convolution_layer<TensorDataType, Device>::compute_gradients_im2col(
-  bool using_transposed_convolution)
+void base_convolution_layer<TensorDataType,
+                            Device>::apply_bias_and_fused_activation()
+{
+  using LocalMatrixType = El::Matrix<TensorDataType, Device>;
+  LocalMatrixType const* local_bias = nullptr;
+  if (m_bias_scaling_factor != El::TypeTraits<ScalingType>::Zero()) {
+    local_bias = &static_cast<LocalMatrixType const&>(
+      this->weights_values(1).LockedMatrix());
+  }
+  const El::Int num_output_channels = this->get_output_dims()[0];
+  apply_bias_activation(local_bias,
+                        TensorDataType(m_bias_scaling_factor),
+                        this->get_output_size() / num_output_channels,
+                        m_fused_activation,
+                        this->get_activations(),
+                        m_fused_preactivations);
+}
+
+template <typename TensorDataType, El::Device Device>
+bool base_convolution_layer<TensorDataType, Device>::fuse_child(
+  Layer const& child)
+{
+  // The fused kernel assumes a channels-first layout
+  if (m_fused_activation != fused_activation::NONE || m_channels_last ||
+      child.get_data_layout() != this->get_data_layout()) {
+    return false;
+  }
+  m_fused_activation = get_fusable_activation<TensorDataType, Device>(child);
+  return m_fused_activation != fused_activation::NONE;
+}
+
+template <typename TensorDataType, El::Device Device>
+bool base_convolution_layer<TensorDataType, Device>::fuse_parent(
+  Layer const& parent)
+{
+  // Nearest-neighbor upsampling by s followed by a unit-stride
+  // convolution with kernel size k and pad p is a transposed
+  // convolution with stride s, kernel size k+s-1 and pad k-1-p
+  using UpsampleType =
+    upsample_layer<TensorDataType, data_layout::DATA_PARALLEL, Device>;
+  auto const* upsample = dynamic_cast<UpsampleType const*>(&parent);
+  const size_t num_spatial_dims = m_conv_dims.size();
+  if (upsample == nullptr || this->get_type() != "convolution" ||
+      this->get_data_layout() != data_layout::DATA_PARALLEL ||
+      !m_upsample_factors.empty() || m_channels_last || m_groups != 1 ||
+      upsample->get_upsample_mode() != upsample_mode::NEAREST ||
+      upsample->get_scale_factors().size() != num_spatial_dims ||
+      m_pads.size() != num_spatial_dims ||
+      m_strides.size() != num_spatial_dims ||
+      m_dilations.size() != num_spatial_dims) {
+    return false;
+  }
+  const auto& scale_factors = upsample->get_scale_factors();
+  for (size_t i = 0; i < num_spatial_dims; ++i) {
+    if (scale_factors[i] < 1 || m_strides[i] != 1 || m_dilations[i] != 1 ||
+        m_pads[i] < 0 || m_pads[i] >= m_conv_dims[i]) {
+      return false;
+    }
+  }
+  m_upsample_factors = scale_factors;
+  m_upsample_pads.resize(num_spatial_dims);
+  for (size_t i = 0; i < num_spatial_dims; ++i) {
+    m_upsample_pads[i] = m_conv_dims[i] - 1 - m_pads[i];
+  }
+  return true;
+}
+
+template <typename TensorDataType, El::Device Device>
+std::vector<int>
+base_convolution_layer<TensorDataType, Device>::get_computed_kernel_dims() const
+{
+  auto dims = this->get_kernel_dims();
+  if (!m_upsample_factors.empty()) {
+    std::swap(dims[0], dims[1]);
+    for (size_t i = 0; i < m_upsample_factors.size(); ++i) {
+      dims[i + 2] += m_upsample_factors[i] - 1;
+    }
+  }
+  return dims;
+}
+
+template <typename TensorDataType, El::Device Device>
+const std::vector<int>&
+base_convolution_layer<TensorDataType, Device>::get_computed_pads()
+  const noexcept
+{
+  return m_upsample_factors.empty() ? m_pads : m_upsample_pads;
+}
+
+template <typename TensorDataType, El::Device Device>
+const std::vector<int>&
+base_convolution_layer<TensorDataType, Device>::get_computed_strides()
+  const noexcept
+{
+  return m_upsample_factors.empty() ? m_strides : m_upsample_factors;
+}
+
+template <typename TensorDataType, El::Device Device>
+auto base_convolution_layer<TensorDataType, Device>::get_computed_kernel()
+  const -> const El::AbstractMatrix<TensorDataType>&
+{
+  if (m_upsample_factors.empty()) {
+    return this->weights_values(0).LockedMatrix();
+  }
+  return m_upsample_kernel;
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::expand_upsampled_kernel()
+{
+  // The kernel holds one filter per (output channel, input channel)
+  // pair. The transposed convolution kernel holds one column per
+  // input channel, in which the output channels are stacked.
+  const auto& local_kernel = this->weights_values(0).LockedMatrix();
+  const El::Int window_size = m_upsample_window.Width();
+  const El::Int expanded_size = m_upsample_window.Height();
+  const El::Int num_input_channels = m_upsample_kernel.Width();
+  if constexpr (Device == El::Device::GPU) {
+    m_upsample_kernel.SetSyncInfo(gpu::get_sync_info(local_kernel));
+  }
+  DMatDT<Device> filters, expanded_filters;
+  for (El::Int channel = 0; channel < m_output_channels; ++channel) {
+    filters.LockedAttach(
+      window_size,
+      num_input_channels,
+      local_kernel.LockedBuffer(channel * window_size * num_input_channels,
+                                0),
+      window_size);
+    if constexpr (Device == El::Device::GPU) {
+      filters.SetSyncInfo(gpu::get_sync_info(local_kernel));
+    }
+    El::View(expanded_filters,
+             m_upsample_kernel,
+             El::IR(channel * expanded_size, (channel + 1) * expanded_size),
+             El::ALL);
+    El::Gemm(El::NORMAL,
+             El::NORMAL,
+             El::TypeTraits<TensorDataType>::One(),
+             m_upsample_window,
+             filters,
+             El::TypeTraits<TensorDataType>::Zero(),
+             expanded_filters);
+  }
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::
+  contract_upsampled_kernel_gradient(
+    El::AbstractMatrix<TensorDataType>& kernel_gradient,
+    TensorDataType dst_scale,
+    TensorDataType gradient_scale)
+{
+  // Adjoint of expand_upsampled_kernel
+  const El::Int window_size = m_upsample_window.Width();
+  const El::Int expanded_size = m_upsample_window.Height();
+  const El::Int num_input_channels = m_upsample_kernel_gradient.Width();
+  DMatDT<Device> filters_gradient, expanded_filters_gradient;
+  for (El::Int channel = 0; channel < m_output_channels; ++channel) {
+    filters_gradient.Attach(
+      window_size,
+      num_input_channels,
+      kernel_gradient.Buffer(channel * window_size * num_input_channels, 0),
+      window_size);
+    if constexpr (Device == El::Device::GPU) {
+      filters_gradient.SetSyncInfo(gpu::get_sync_info(kernel_gradient));
+    }
+    El::LockedView(
+      expanded_filters_gradient,
+      m_upsample_kernel_gradient,
+      El::IR(channel * expanded_size, (channel + 1) * expanded_size),
+      El::ALL);
+    El::Gemm(El::TRANSPOSE,
+             El::NORMAL,
+             gradient_scale,
+             m_upsample_window,
+             expanded_filters_gradient,
+             dst_scale,
+             filters_gradient);
+  }
+}
+
+template <typename TensorDataType, El::Device Device>
+bool base_convolution_layer<TensorDataType, Device>::supports_int8_inference()
+  const
+{
+  return Device == El::Device::CPU &&
+         std::is_floating_point_v<TensorDataType> &&
+         this->get_type() == "convolution" && m_groups == 1 &&
+         !m_channels_last && m_upsample_factors.empty() &&
+         std::all_of(m_dilations.begin(), m_dilations.end(), [](int d) {
+           return d == 1;
+         });
+}
+
+template <typename TensorDataType, El::Device Device>
+bool base_convolution_layer<TensorDataType, Device>::fold_child_into_weights(
+  Layer const& child)
+{
+  // A deconvolution kernel is not indexed by output channel first
+  using LocalMatrix = El::Matrix<TensorDataType, El::Device::CPU>;
+  LocalMatrix scale, shift;
+  const El::Int num_channels = this->get_output_dims()[0];
+  if (this->get_type() != "convolution" ||
+      m_fused_activation != fused_activation::NONE || m_channels_last ||
+      child.get_output_size() != this->get_output_size() ||
+      !get_batch_normalization_affine<TensorDataType, Device>(child,
+                                                              scale,
+                                                              shift) ||
+      scale.Height() != num_channels) {
+    return false;
+  }
+  auto* kernel_weights = dynamic_cast<WeightsType*>(&this->get_weights(0));
+  const bool has_bias =
+    (m_bias_scaling_factor != El::TypeTraits<ScalingType>::Zero());
+  auto* bias_weights =
+    (has_bias ? dynamic_cast<WeightsType*>(&this->get_weights(1)) : nullptr);
+  if (kernel_weights == nullptr || kernel_weights->is_sharded() ||
+      (has_bias && (bias_weights == nullptr || bias_weights->is_sharded()))) {
+    return false;
+  }
+
+  // Scale each output channel's filters. The weights are replicated,
+  // so every process updates its own copy.
+  auto& kernel = kernel_weights->get_values_sharded();
+  LocalMatrix local_kernel;
+  El::Copy(kernel.LockedMatrix(), local_kernel);
+  const El::Int filter_size = local_kernel.Height() / num_channels;
+  for (El::Int row = 0; row < local_kernel.Height(); ++row) {
+    local_kernel(row, 0) *= scale(row / filter_size, 0);
+  }
+  El::Copy(local_kernel, kernel.Matrix());
+
+  // bias' = scale * bias + shift, stored without the bias scaling
+  std::vector<TensorDataType> bias(num_channels);
+  LocalMatrix local_bias;
+  if (has_bias) {
+    El::Copy(bias_weights->get_values().LockedMatrix(), local_bias);
+  }
+  for (El::Int channel = 0; channel < num_channels; ++channel) {
+    const auto b =
+      (has_bias ? El::To<TensorDataType>(m_bias_scaling_factor) *
+                    local_bias(channel, 0)
+                : El::TypeTraits<TensorDataType>::Zero());
+    bias[channel] = scale(channel, 0) * b + shift(channel, 0);
+  }
+  if (has_bias) {
+    const auto factor = El::To<TensorDataType>(m_bias_scaling_factor);
+    for (El::Int channel = 0; channel < num_channels; ++channel) {
+      local_bias(channel, 0) = bias[channel] / factor;
+    }
+    El::Copy(local_bias, bias_weights->get_values_sharded().Matrix());
+  }
+  else {
+    // New bias weights take their values at the next setup
+    auto w = std::make_shared<WeightsType>(*this->get_comm());
+    w->set_name(this->get_name() + "_bias");
+    w->set_initializer(
+      std::make_unique<value_initializer<TensorDataType>>(std::move(bias)));
+    m_bias_scaling_factor = El::TypeTraits<ScalingType>::One();
+    this->set_num_weights(2);
+    this->set_weights(1, w);
+    this->m_model->add_weights(std::move(w));
+  }
+  return true;
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType,
+                            Device>::compute_bias_gradient_cpu()
 {
 
   // Local matrices
@@ -985,17 +1449,10 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_im2col(
     this->get_local_prev_error_signals();
   const bool has_local_data =
     (!local_input.IsEmpty() && !local_gradient_wrt_output.IsEmpty());
-
-  // Get convolution parameters
   const El::Int local_width = local_input.Width();
-  const auto& input_dims = this->get_input_dims();
-  const auto& output_dims = this->get_output_dims();
-  const int num_input_channels = input_dims[0];
-  const int num_output_channels = output_dims[0];
+  const int num_output_channels = this->get_output_dims()[0];
   const int num_per_output_channel =
     this->get_output_size() / num_output_channels;
-  const auto& kernel_dims = this->get_kernel_dims();
-  const auto kernel_size = get_linear_size(kernel_dims);
 
   // Compute bias gradient
   // Note: Sum is computed with Kahan summation
@@ -1031,6 +1488,28 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_im2col(
       El::Scale(dst_scale, bias_gradient);
     }
   }
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::compute_gradients_im2col(
+  bool using_transposed_convolution)
+{
+
+  // Local matrices
+  const DMatDT<Device>& local_input = this->get_local_prev_activations();
+  const DMatDT<Device>& local_gradient_wrt_output =
+    this->get_local_prev_error_signals();
+
+  // Get convolution parameters
+  const El::Int local_width = local_input.Width();
+  const auto& input_dims = this->get_input_dims();
+  const auto& output_dims = this->get_output_dims();
+  const int num_input_channels = input_dims[0];
+  const int num_output_channels = output_dims[0];
+  const auto kernel_dims = get_computed_kernel_dims();
+  const auto kernel_size = get_linear_size(kernel_dims);
+
+  compute_bias_gradient_cpu();
 
   // Stop early if kernel is not being optimized
   auto* kernel_optimizer = this->get_weights(0).get_optimizer();
@@ -1051,9 +1530,23 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_im2col(
        gradient_scale = El::TypeTraits<TensorDataType>::Zero();
   auto& kernel_gradient =
     kernel_optimizer->get_gradient_buffer(dst_scale, gradient_scale, true);
-  El::Scale(dst_scale, kernel_gradient);
+
+  // With a fused upsample, the gradient w.r.t. the transposed
+  // convolution kernel is contracted afterwards
+  const bool upsampled = !m_upsample_factors.empty();
+  auto col_scale = gradient_scale;
+  if (upsampled) {
+    El::Zero(m_upsample_kernel_gradient);
+    col_scale = El::TypeTraits<TensorDataType>::One();
+  }
+  else {
+    El::Scale(dst_scale, kernel_gradient);
+  }
   DMatDT<Device> im2col_matrix(m, k);
-  DMatDT<Device> kernel_gradient_matrix(m, n, kernel_gradient.Buffer(), m);
+  auto* kernel_gradient_buffer =
+    (upsampled ? m_upsample_kernel_gradient.Buffer()
+               : kernel_gradient.Buffer());
+  DMatDT<Device> kernel_gradient_matrix(m, n, kernel_gradient_buffer, m);
 
   // Compute kernel gradient contributions from each data sample
   for (El::Int col = 0; col < local_width; ++col) {
@@ -1066,12 +1559,12 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_im2col(
                              num_output_channels,
                              output_dims.size() - 1,
                              &output_dims[1],
-                             m_pads.data(),
+                             get_computed_pads().data(),
                              &kernel_dims[2],
-                             m_strides.data());
+                             get_computed_strides().data());
       El::Gemm(El::NORMAL,
                El::NORMAL,
-               gradient_scale,
+               col_scale,
                im2col_matrix,
                input_col,
                El::TypeTraits<TensorDataType>::One(),
@@ -1090,21 +1583,253 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_im2col(
                              num_input_channels,
                              input_dims.size() - 1,
                              &input_dims[1],
-                             m_pads.data(),
+                             get_computed_pads().data(),
                              &kernel_dims[2],
-                             m_strides.data());
+                             get_computed_strides().data());
       El::Gemm(El::NORMAL,
                El::NORMAL,
-               gradient_scale,
+               col_scale,
                im2col_matrix,
                gradient_wrt_output_col,
                El::TypeTraits<TensorDataType>::One(),
                kernel_gradient_matrix);
     }
   }
+  if (upsampled) {
+    contract_upsampled_kernel_gradient(kernel_gradient.Matrix(),
+                                       dst_scale,
+                                       gradient_scale);
+  }
 }
 
+template <typename TensorDataType, El::Device Device>
+bool base_convolution_layer<TensorDataType, Device>::using_onednn()
+  const noexcept
+{
+#ifdef LBANN_HAS_ONEDNN_CPU
+  return (Device == El::Device::CPU &&
+          std::is_same_v<TensorDataType, float> && !m_channels_last &&
+          m_upsample_factors.empty());
+#else
+  return false;
+#endif // LBANN_HAS_ONEDNN_CPU
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::apply_convolution_cpu(
+  bool during_forward_prop)
+{
+  if (during_forward_prop && this->using_int8_inference()) {
+    apply_convolution_int8();
+    return;
+  }
+#ifdef LBANN_HAS_ONEDNN_CPU
+  if (using_onednn()) {
+    apply_convolution_onednn(during_forward_prop);
+    return;
+  }
+#endif // LBANN_HAS_ONEDNN_CPU
+  apply_convolution_im2col(during_forward_prop);
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::
+  apply_transposed_convolution_cpu(bool during_forward_prop)
+{
+#ifdef LBANN_HAS_ONEDNN_CPU
+  if (using_onednn()) {
+    apply_transposed_convolution_onednn(during_forward_prop);
+    return;
+  }
+#endif // LBANN_HAS_ONEDNN_CPU
+  apply_transposed_convolution_im2col(during_forward_prop);
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::compute_gradients_cpu(
+  bool using_transposed_convolution)
+{
+#ifdef LBANN_HAS_ONEDNN_CPU
+  if (using_onednn()) {
+    compute_bias_gradient_cpu();
+    compute_kernel_gradient_onednn(using_transposed_convolution);
+    return;
+  }
+#endif // LBANN_HAS_ONEDNN_CPU
+  compute_gradients_im2col(using_transposed_convolution);
+}
+
+#ifdef LBANN_HAS_ONEDNN_CPU
+template <typename TensorDataType, El::Device Device>
+auto base_convolution_layer<TensorDataType, Device>::get_onednn_convolution(
+  bool transposed_layer,
+  int mini_batch_size,
+  El::Int src_ldim,
+  El::Int dst_ldim) -> onednn::convolution_primitives<TensorDataType>&
+{
+  auto& prims = m_onednn_convolutions[mini_batch_size];
+  if (prims != nullptr && prims->geometry().src_ldim == src_ldim &&
+      prims->geometry().dst_ldim == dst_ldim) {
+    return *prims;
+  }
+  onednn::convolution_geometry geom;
+  geom.mini_batch_size = mini_batch_size;
+  geom.src_dims = this->get_input_dims();
+  geom.dst_dims = this->get_output_dims();
+  if (transposed_layer) {
+    std::swap(geom.src_dims, geom.dst_dims);
+  }
+  geom.kernel_dims = this->get_kernel_dims();
+  geom.pads = m_pads;
+  geom.strides = m_strides;
+  geom.dilations = m_dilations;
+  geom.groups = m_groups;
+  geom.src_ldim = src_ldim;
+  geom.dst_ldim = dst_ldim;
+  prims = std::make_unique<onednn::convolution_primitives<TensorDataType>>(
+    std::move(geom));
+  return *prims;
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::apply_convolution_onednn(
+  bool during_forward_prop)
+{
+  if constexpr (Device == El::Device::CPU &&
+                std::is_same_v<TensorDataType, float>) {
+    const auto& local_kernel = this->weights_values(0).LockedMatrix();
+    const auto& local_input =
+      (during_forward_prop ? this->get_local_prev_activations()
+                           : this->get_local_prev_error_signals());
+    auto& local_output =
+      (during_forward_prop ? this->get_local_activations()
+                           : this->get_local_error_signals());
+    if (local_input.Width() == 0) {
+      return;
+    }
+    auto& prims = get_onednn_convolution(!during_forward_prop,
+                                         local_input.Width(),
+                                         local_input.LDim(),
+                                         local_output.LDim());
+    prims.forward(local_input.LockedBuffer(),
+                  local_kernel.LockedBuffer(),
+                  local_output.Buffer());
+  }
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::
+  apply_transposed_convolution_onednn(bool during_forward_prop)
+{
+  if constexpr (Device == El::Device::CPU &&
+                std::is_same_v<TensorDataType, float>) {
+    const auto& local_kernel = this->weights_values(0).LockedMatrix();
+    const auto& local_input =
+      (during_forward_prop ? this->get_local_prev_activations()
+                           : this->get_local_prev_error_signals());
+    auto& local_output =
+      (during_forward_prop ? this->get_local_activations()
+                           : this->get_local_error_signals());
+    if (local_input.Width() == 0) {
+      return;
+    }
+    auto& prims = get_onednn_convolution(during_forward_prop,
+                                         local_input.Width(),
+                                         local_output.LDim(),
+                                         local_input.LDim());
+    prims.backward_data(local_input.LockedBuffer(),
+                        local_kernel.LockedBuffer(),
+                        local_output.Buffer());
+  }
+}
+
+template <typename TensorDataType, El::Device Device>
+void base_convolution_layer<TensorDataType, Device>::
+  compute_kernel_gradient_onednn(bool using_transposed_convolution)
+{
+  if constexpr (Device == El::Device::CPU &&
+                std::is_same_v<TensorDataType, float>) {
+    auto* kernel_optimizer = this->get_weights(0).get_optimizer();
+    if (kernel_optimizer == nullptr) {
+      return;
+    }
+    auto dst_scale = El::TypeTraits<TensorDataType>::Zero(),
+         gradient_scale = El::TypeTraits<TensorDataType>::Zero();
+    auto& kernel_gradient =
+      kernel_optimizer->get_gradient_buffer(dst_scale, gradient_scale, true);
+    auto& local_kernel_gradient = kernel_gradient.Matrix();
+
+    // The convolution source is the layer input, or the output
+    // gradient for a deconvolution
+    const auto& local_input = this->get_local_prev_activations();
+    const auto& local_gradient_wrt_output =
+      this->get_local_prev_error_signals();
+    const auto& src = (using_transposed_convolution
+                         ? local_gradient_wrt_output
+                         : local_input);
+    const auto& diff_dst = (using_transposed_convolution
+                              ? local_input
+                              : local_gradient_wrt_output);
+    if (src.Width() == 0) {
+      El::Scale(dst_scale, kernel_gradient);
+      return;
+    }
+    auto& prims = get_onednn_convolution(using_transposed_convolution,
+                                         src.Width(),
+                                         src.LDim(),
+                                         diff_dst.LDim());
+
+    // oneDNN overwrites its output, so only write in place if the
+    // old gradient is discarded anyway
+    if (dst_scale == El::TypeTraits<TensorDataType>::Zero()) {
+      prims.backward_weights(src.LockedBuffer(),
+                             diff_dst.LockedBuffer(),
+                             local_kernel_gradient.Buffer());
+      El::Scale(gradient_scale, local_kernel_gradient);
+    }
+    else {
+      DMatDT<Device> contribution(local_kernel_gradient.Height(),
+                                  local_kernel_gradient.Width());
+      prims.backward_weights(src.LockedBuffer(),
+                             diff_dst.LockedBuffer(),
+                             contribution.Buffer());
+      El::Scale(dst_scale, local_kernel_gradient);
+      El::Axpy(gradient_scale, contribution, local_kernel_gradient);
+    }
+  }
+}
+#endif // LBANN_HAS_ONEDNN_CPU
+
 #ifdef LBANN_HAS_DNN_LIB
+namespace {
+
+/** @brief Find an algorithm already chosen for a larger mini-batch.
+ *
+ *  An algorithm that runs a mini-batch also runs a smaller one within
+ *  the same workspace, so mini-batch schedules and partial
+ *  mini-batches need not autotune again. Prefers the closest size.
+ *
+ *  @returns nullptr if no cached size is large enough.
+ */
+template <typename AlgoConfig>
+AlgoConfig const* find_algo_for_larger_mini_batch(
+  std::unordered_map<int, AlgoConfig> const& algos,
+  int local_mini_batch_size)
+{
+  AlgoConfig const* best = nullptr;
+  int best_size = 0;
+  for (auto const& [size, config] : algos) {
+    if (size >= local_mini_batch_size &&
+        (best == nullptr || size < best_size)) {
+      best = &config;
+      best_size = size;
+    }
+  }
+  return best;
+}
+
+} // namespace
+
 template <typename TensorDataType, El::Device Device>
 dnn_lib::fwd_conv_alg_config
 base_convolution_layer<TensorDataType, Device>::get_forward_algo_dnn(
@@ -1120,12 +1845,27 @@ base_convolution_layer<TensorDataType, Device>::get_forward_algo_dnn(
   TensorDataType* ws)
 {
   if (m_fwd_dnn_algos.count(local_mini_batch_size) == 0) {
+    if (auto const* larger =
+          find_algo_for_larger_mini_batch(m_fwd_dnn_algos,
+                                          local_mini_batch_size)) {
+      const auto config = *larger;
+      m_fwd_dnn_algos[local_mini_batch_size] = config;
+      return config;
+    }
 #ifdef LBANN_DETERMINISTIC
     bool deterministic = true;
 #else
     bool deterministic = false;
 #endif
-    m_fwd_dnn_algos[local_mini_batch_size] =
+    const auto key = get_algo_cache_key("fwd", local_mini_batch_size, ws_size);
+    int algo, math_type;
+    if (dnn_lib::find_cached_conv_algorithm(key, algo, math_type)) {
+      m_fwd_dnn_algos[local_mini_batch_size] = {
+        static_cast<dnn_lib::fwd_conv_alg>(algo),
+        static_cast<dnn_lib::dnnMathType_t>(math_type)};
+      return m_fwd_dnn_algos[local_mini_batch_size];
+    }
+    const auto config =
       dnn_lib::get_fwd_algorithm(true,
                                  deterministic,
                                  input_desc,
@@ -1137,6 +1877,11 @@ base_convolution_layer<TensorDataType, Device>::get_forward_algo_dnn(
                                  output,
                                  ws_size,
                                  ws);
+    dnn_lib::cache_conv_algorithm(key,
+                                  static_cast<int>(config.first),
+                                  static_cast<int>(config.second),
+                                  this->get_comm()->am_world_master());
+    m_fwd_dnn_algos[local_mini_batch_size] = config;
   }
   return m_fwd_dnn_algos[local_mini_batch_size];
 }
@@ -1156,12 +1901,28 @@ base_convolution_layer<TensorDataType, Device>::get_backward_data_algo_dnn(
   TensorDataType* ws)
 {
   if (m_bwd_data_dnn_algos.count(local_mini_batch_size) == 0) {
+    if (auto const* larger =
+          find_algo_for_larger_mini_batch(m_bwd_data_dnn_algos,
+                                          local_mini_batch_size)) {
+      const auto config = *larger;
+      m_bwd_data_dnn_algos[local_mini_batch_size] = config;
+      return config;
+    }
 #ifdef LBANN_DETERMINISTIC
     bool deterministic = true;
 #else
     bool deterministic = false;
 #endif
-    m_bwd_data_dnn_algos[local_mini_batch_size] =
+    const auto key =
+      get_algo_cache_key("bwd_data", local_mini_batch_size, ws_size);
+    int algo, math_type;
+    if (dnn_lib::find_cached_conv_algorithm(key, algo, math_type)) {
+      m_bwd_data_dnn_algos[local_mini_batch_size] = {
+        static_cast<dnn_lib::bwd_data_conv_alg>(algo),
+        static_cast<dnn_lib::dnnMathType_t>(math_type)};
+      return m_bwd_data_dnn_algos[local_mini_batch_size];
+    }
+    const auto config =
       dnn_lib::get_bwd_data_algorithm(true,
                                       deterministic,
                                       kernel_desc,
@@ -1173,6 +1934,11 @@ base_convolution_layer<TensorDataType, Device>::get_backward_data_algo_dnn(
                                       error_signal,
                                       ws_size,
                                       ws);
+    dnn_lib::cache_conv_algorithm(key,
+                                  static_cast<int>(config.first),
+                                  static_cast<int>(config.second),
+                                  this->get_comm()->am_world_master());
+    m_bwd_data_dnn_algos[local_mini_batch_size] = config;
   }
   return m_bwd_data_dnn_algos[local_mini_batch_size];
 }
@@ -1191,11 +1957,27 @@ base_convolution_layer<TensorDataType, Device>::get_backward_filter_algo_dnn(
   TensorDataType* ws)
 {
   if (m_bwd_filter_dnn_algos.count(local_mini_batch_size) == 0) {
+    if (auto const* larger =
+          find_algo_for_larger_mini_batch(m_bwd_filter_dnn_algos,
+                                          local_mini_batch_size)) {
+      const auto config = *larger;
+      m_bwd_filter_dnn_algos[local_mini_batch_size] = config;
+      return config;
+    }
 #ifdef LBANN_DETERMINISTIC
     bool deterministic = true;
 #else
     bool deterministic = false;
 #endif
+    const auto key =
+      get_algo_cache_key("bwd_filter", local_mini_batch_size, ws_size);
+    int algo, math_type;
+    if (dnn_lib::find_cached_conv_algorithm(key, algo, math_type)) {
+      m_bwd_filter_dnn_algos[local_mini_batch_size] = {
+        static_cast<dnn_lib::bwd_filter_conv_alg>(algo),
+        static_cast<dnn_lib::dnnMathType_t>(math_type)};
+      return m_bwd_filter_dnn_algos[local_mini_batch_size];
+    }
     // Temporary filter gradient buffer.
     El::Matrix<TensorDataType, El::Device::GPU> kernel_gradient;
 #ifdef HYDROGEN_HAVE_CUB
@@ -1203,7 +1985,7 @@ base_convolution_layer<TensorDataType, Device>::get_backward_filter_algo_dnn(
 #endif
     kernel_gradient.Resize(this->get_weights(0).get_matrix_height(),
                            this->get_weights(0).get_matrix_width());
-    m_bwd_filter_dnn_algos[local_mini_batch_size] =
+    const auto config =
       dnn_lib::get_bwd_filter_algorithm(true,
                                         deterministic,
                                         input_desc,
@@ -1215,9 +1997,52 @@ base_convolution_layer<TensorDataType, Device>::get_backward_filter_algo_dnn(
                                         kernel_gradient.Buffer(),
                                         ws_size,
                                         ws);
+    dnn_lib::cache_conv_algorithm(key,
+                                  static_cast<int>(config.first),
+                                  static_cast<int>(config.second),
+                                  this->get_comm()->am_world_master());
+    m_bwd_filter_dnn_algos[local_mini_batch_size] = config;
   }
   return m_bwd_filter_dnn_algos[local_mini_batch_size];
 }
+
+template <typename TensorDataType, El::Device Device>
+std::string base_convolution_layer<TensorDataType, Device>::get_algo_cache_key(
+  const std::string& pass,
+  int local_mini_batch_size,
+  size_t ws_size) const
+{
+#ifdef LBANN_DETERMINISTIC
+  constexpr bool deterministic = true;
+#else
+  constexpr bool deterministic = false;
+#endif
+  auto print_dims = [](std::ostream& os, const std::vector<int>& dims) {
+    for (size_t i = 0; i < dims.size(); ++i) {
+      os << (i > 0 ? "x" : "") << dims[i];
+    }
+    os << ' ';
+  };
+  std::ostringstream ss;
+  ss << dnn_lib::get_autotune_context() << ' ' << this->get_type() << ' '
+     << pass << ' ' << TypeName<TensorDataType>() << ' '
+     << static_cast<int>(m_convolution_math_type) << ' '
+     << (deterministic ? "det" : "nondet") << ' ' << local_mini_batch_size
+     << ' ';
+  print_dims(ss, this->get_input_dims());
+  print_dims(ss, this->get_output_dims());
+  print_dims(ss, get_kernel_dims());
+  print_dims(ss, m_pads);
+  print_dims(ss, m_strides);
+  print_dims(ss, m_dilations);
+  if (!m_upsample_factors.empty()) {
+    ss << "upsample ";
+    print_dims(ss, m_upsample_factors);
+  }
+  ss << m_groups << ' ' << (m_channels_last ? "nhwc" : "nchw") << ' '
+     << ws_size;
+  return ss.str();
+}
 #endif // LBANN_HAS_DNN_LIB
 
 #ifdef LBANN_HAS_DISTCONV
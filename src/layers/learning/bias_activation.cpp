@@ -0,0 +1,237 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+
+#define LBANN_BIAS_ACTIVATION_INSTANTIATE
+#include "lbann/layers/learning/bias_activation.hpp"
+#include "lbann/layers/operator_layer.hpp"
+#include "lbann/operators/math/unary.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+namespace lbann {
+
+namespace {
+
+// Same tanh approximation as the GELU operator
+template <typename TensorDataType>
+TensorDataType gelu(TensorDataType const& x)
+{
+  const auto sqrt_two_over_pi = El::To<TensorDataType>(0.7978845608028654);
+  const auto coeff = El::To<TensorDataType>(0.044715);
+  const auto one = El::TypeTraits<TensorDataType>::One();
+  const TensorDataType hx = x * El::To<TensorDataType>(0.5);
+  return hx * (one + El::Tanh(sqrt_two_over_pi * (x + coeff * x * x * x)));
+}
+
+template <typename TensorDataType>
+TensorDataType gelu_gradient(TensorDataType const& x,
+                             TensorDataType const& dy)
+{
+  const auto c1 = El::To<TensorDataType>(0.797885);
+  const auto c2 = El::To<TensorDataType>(0.107032);
+  const auto c3 = El::To<TensorDataType>(0.0356774);
+  const auto one = El::TypeTraits<TensorDataType>::One();
+  const TensorDataType x3 = x * x * x;
+  const TensorDataType c1x = c1 * x;
+  const TensorDataType c3x3 = c3 * x3;
+  const TensorDataType sech = one / El::Cosh(c1x + c3x3);
+  const TensorDataType dx =
+    (one + (c1x + c2 * x3) * sech * sech + El::Tanh(c1x + c3x3));
+  return dx * dy * El::To<TensorDataType>(0.5);
+}
+
+} // namespace
+
+template <typename TensorDataType, El::Device Device>
+fused_activation get_fusable_activation(Layer const& l)
+{
+  if (l.get_device_allocation() != Device ||
+      dynamic_cast<data_type_layer<TensorDataType> const*>(&l) == nullptr) {
+    return fused_activation::NONE;
+  }
+  if (l.get_type() == "ReLU") {
+    return fused_activation::RELU;
+  }
+  using GeluType = GeluOperator<TensorDataType, Device>;
+  auto is_gelu = [](auto const* op_layer) {
+    if (op_layer == nullptr || op_layer->get_operators().size() != 1UL) {
+      return false;
+    }
+    auto const* op = op_layer->get_operators().front().get();
+    return dynamic_cast<GeluType const*>(op) != nullptr;
+  };
+  using DataParallelType = OperatorLayer<TensorDataType,
+                                         TensorDataType,
+                                         data_layout::DATA_PARALLEL,
+                                         Device>;
+  using ModelParallelType = OperatorLayer<TensorDataType,
+                                          TensorDataType,
+                                          data_layout::MODEL_PARALLEL,
+                                          Device>;
+  if (is_gelu(dynamic_cast<DataParallelType const*>(&l)) ||
+      is_gelu(dynamic_cast<ModelParallelType const*>(&l))) {
+    return fused_activation::GELU;
+  }
+  return fused_activation::NONE;
+}
+
+template <typename TensorDataType>
+void apply_bias_relu(El::Matrix<TensorDataType, El::Device::CPU> const* bias,
+                     TensorDataType const& scale,
+                     El::Int rows_per_bias,
+                     El::Matrix<TensorDataType, El::Device::CPU>& output)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  const TensorDataType zero = El::TypeTraits<TensorDataType>::Zero();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      auto& y = output(row, col);
+      auto x = y;
+      if (bias != nullptr) {
+        x += scale * bias->Get(row / rows_per_bias, 0);
+      }
+      y = (x > zero ? x : zero);
+    }
+  }
+}
+
+template <typename TensorDataType>
+void apply_bias_gelu(
+  El::Matrix<TensorDataType, El::Device::CPU> const* bias,
+  TensorDataType const& scale,
+  El::Int rows_per_bias,
+  El::Matrix<TensorDataType, El::Device::CPU>& preactivations,
+  El::Matrix<TensorDataType, El::Device::CPU>& output)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      auto& y = output(row, col);
+      auto x = y;
+      if (bias != nullptr) {
+        x += scale * bias->Get(row / rows_per_bias, 0);
+      }
+      preactivations(row, col) = x;
+      y = gelu(x);
+    }
+  }
+}
+
+template <typename TensorDataType>
+void apply_bias_row_statistics(
+  El::Matrix<TensorDataType, El::Device::CPU> const* bias,
+  TensorDataType const& scale,
+  El::Matrix<TensorDataType, El::Device::CPU>& output,
+  El::Matrix<TensorDataType, El::Device::CPU>& statistics)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int row = 0; row < height; ++row) {
+    const auto b = (bias != nullptr ? scale * bias->Get(row, 0)
+                                    : El::TypeTraits<TensorDataType>::Zero());
+    auto sum = El::TypeTraits<TensorDataType>::Zero();
+    auto sqsum = El::TypeTraits<TensorDataType>::Zero();
+    for (El::Int col = 0; col < width; ++col) {
+      auto& y = output(row, col);
+      y += b;
+      sum += y;
+      sqsum += y * y;
+    }
+    statistics(row, 0) = sum;
+    statistics(row, 1) = sqsum;
+  }
+}
+
+template <typename TensorDataType>
+void apply_relu_gradient(
+  El::Matrix<TensorDataType, El::Device::CPU> const& output,
+  El::Matrix<TensorDataType, El::Device::CPU> const& gradient_wrt_output,
+  El::Matrix<TensorDataType, El::Device::CPU>& gradient_wrt_input)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  const TensorDataType zero = El::TypeTraits<TensorDataType>::Zero();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      const auto& dy = gradient_wrt_output(row, col);
+      gradient_wrt_input(row, col) = (output(row, col) > zero ? dy : zero);
+    }
+  }
+}
+
+template <typename TensorDataType>
+void apply_gelu_gradient(
+  El::Matrix<TensorDataType, El::Device::CPU> const& input,
+  El::Matrix<TensorDataType, El::Device::CPU> const& gradient_wrt_output,
+  El::Matrix<TensorDataType, El::Device::CPU>& gradient_wrt_input)
+{
+  const El::Int height = input.Height();
+  const El::Int width = input.Width();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      gradient_wrt_input(row, col) =
+        gelu_gradient(input(row, col), gradient_wrt_output(row, col));
+    }
+  }
+}
+
+#define PROTO(T)                                                               \
+  template void apply_bias_relu(El::Matrix<T, El::Device::CPU> const*,         \
+                                T const&,                                      \
+                                El::Int,                                       \
+                                El::Matrix<T, El::Device::CPU>&);              \
+  template void apply_bias_gelu(El::Matrix<T, El::Device::CPU> const*,         \
+                                T const&,                                      \
+                                El::Int,                                       \
+                                El::Matrix<T, El::Device::CPU>&,               \
+                                El::Matrix<T, El::Device::CPU>&);              \
+  template void apply_bias_row_statistics(                                     \
+    El::Matrix<T, El::Device::CPU> const*,                                     \
+    T const&,                                                                  \
+    El::Matrix<T, El::Device::CPU>&,                                           \
+    El::Matrix<T, El::Device::CPU>&);                                          \
+  template void apply_relu_gradient(El::Matrix<T, El::Device::CPU> const&,     \
+                                    El::Matrix<T, El::Device::CPU> const&,     \
+                                    El::Matrix<T, El::Device::CPU>&);          \
+  template void apply_gelu_gradient(El::Matrix<T, El::Device::CPU> const&,     \
+                                    El::Matrix<T, El::Device::CPU> const&,     \
+                                    El::Matrix<T, El::Device::CPU>&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#undef LBANN_INSTANTIATE_CPU_HALF
+
+#define PROTO_DEVICE(T, Device)                                                \
+  template fused_activation get_fusable_activation<T, Device>(Layer const&)
+#include "lbann/macros/instantiate_device.hpp"
+
+} // namespace lbann
@@ -0,0 +1,441 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+
+#define LBANN_BIAS_ACTIVATION_INSTANTIATE
+#include "lbann/layers/learning/bias_activation.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/**
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (height / bsize) x width x 1
+ */
+template <typename TensorDataType>
+__global__ void bias_relu_kernel(size_t height,
+                                 size_t width,
+                                 size_t rows_per_bias,
+                                 const TensorDataType* __restrict__ bias,
+                                 TensorDataType scale,
+                                 TensorDataType* __restrict__ output,
+                                 size_t output_ldim)
+{
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = blockDim.x * gridDim.x;
+  const size_t nthreadsy = blockDim.y * gridDim.y;
+  for (size_t col = gidy; col < width; col += nthreadsy) {
+    for (size_t row = gidx; row < height; row += nthreadsx) {
+      auto& y = output[row + col * output_ldim];
+      auto x = y;
+      if (bias != nullptr) {
+        x += scale * bias[row / rows_per_bias];
+      }
+      y = gpu_lib::max(x, TensorDataType{0.f});
+    }
+  }
+}
+
+// Same tanh approximation as the GELU operator
+template <typename TensorDataType>
+__device__ __forceinline__ TensorDataType gelu(TensorDataType const& x)
+{
+  TensorDataType const sqrt_two_over_pi(0.7978845608028654);
+  TensorDataType const coeff(0.044715);
+  TensorDataType const hx = x * TensorDataType(0.5);
+  return hx * (TensorDataType(1) +
+               gpu_lib::tanh(sqrt_two_over_pi * (x + coeff * x * x * x)));
+}
+
+template <typename TensorDataType>
+__device__ __forceinline__ TensorDataType
+gelu_gradient(TensorDataType const& x, TensorDataType const& dy)
+{
+  TensorDataType const c1(0.797885);
+  TensorDataType const c2(0.107032);
+  TensorDataType const c3(0.0356774);
+  TensorDataType const x3 = x * x * x;
+  TensorDataType const c1x = c1 * x;
+  TensorDataType const c3x3 = c3 * x3;
+  TensorDataType const sech =
+    TensorDataType(1) / gpu_lib::cosh(c1x + c3x3);
+  TensorDataType const dx = (TensorDataType(1) +
+                             (c1x + c2 * x3) * sech * sech +
+                             gpu_lib::tanh(c1x + c3x3));
+  return dx * dy * TensorDataType(0.5);
+}
+
+/**
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (height / bsize) x width x 1
+ */
+template <typename TensorDataType>
+__global__ void bias_gelu_kernel(size_t height,
+                                 size_t width,
+                                 size_t rows_per_bias,
+                                 const TensorDataType* __restrict__ bias,
+                                 TensorDataType scale,
+                                 TensorDataType* __restrict__ preactivations,
+                                 size_t preactivations_ldim,
+                                 TensorDataType* __restrict__ output,
+                                 size_t output_ldim)
+{
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = blockDim.x * gridDim.x;
+  const size_t nthreadsy = blockDim.y * gridDim.y;
+  for (size_t col = gidy; col < width; col += nthreadsy) {
+    for (size_t row = gidx; row < height; row += nthreadsx) {
+      auto& y = output[row + col * output_ldim];
+      auto x = y;
+      if (bias != nullptr) {
+        x += scale * bias[row / rows_per_bias];
+      }
+      preactivations[row + col * preactivations_ldim] = x;
+      y = gelu(x);
+    }
+  }
+}
+
+/**
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (height / bsize) x width x 1
+ */
+template <typename TensorDataType>
+__global__ void gelu_gradient_kernel(size_t height,
+                                     size_t width,
+                                     const TensorDataType* input,
+                                     size_t input_ldim,
+                                     const TensorDataType* gradient_wrt_output,
+                                     size_t gradient_wrt_output_ldim,
+                                     TensorDataType* gradient_wrt_input,
+                                     size_t gradient_wrt_input_ldim)
+{
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = blockDim.x * gridDim.x;
+  const size_t nthreadsy = blockDim.y * gridDim.y;
+  for (size_t col = gidy; col < width; col += nthreadsy) {
+    for (size_t row = gidx; row < height; row += nthreadsx) {
+      const auto x = input[row + col * input_ldim];
+      const auto dy =
+        gradient_wrt_output[row + col * gradient_wrt_output_ldim];
+      gradient_wrt_input[row + col * gradient_wrt_input_ldim] =
+        gelu_gradient(x, dy);
+    }
+  }
+}
+
+/**
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (height / bsize) x width x 1
+ */
+template <typename TensorDataType>
+__global__ void relu_gradient_kernel(size_t height,
+                                     size_t width,
+                                     const TensorDataType* output,
+                                     size_t output_ldim,
+                                     const TensorDataType* gradient_wrt_output,
+                                     size_t gradient_wrt_output_ldim,
+                                     TensorDataType* gradient_wrt_input,
+                                     size_t gradient_wrt_input_ldim)
+{
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = blockDim.x * gridDim.x;
+  const size_t nthreadsy = blockDim.y * gridDim.y;
+  for (size_t col = gidy; col < width; col += nthreadsy) {
+    for (size_t row = gidx; row < height; row += nthreadsx) {
+      const auto& y = output[row + col * output_ldim];
+      const auto dy =
+        gradient_wrt_output[row + col * gradient_wrt_output_ldim];
+      gradient_wrt_input[row + col * gradient_wrt_input_ldim] =
+        (y > TensorDataType{0.f} ? dy : TensorDataType{0.f});
+    }
+  }
+}
+
+/**
+ *  One thread per row, so that each column is read coalesced.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (height / bsize) x 1 x 1
+ */
+template <typename TensorDataType>
+__global__ void
+bias_row_statistics_kernel(size_t height,
+                           size_t width,
+                           const TensorDataType* __restrict__ bias,
+                           TensorDataType scale,
+                           TensorDataType* __restrict__ output,
+                           size_t output_ldim,
+                           TensorDataType* __restrict__ sums,
+                           TensorDataType* __restrict__ sqsums)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t row = gid; row < height; row += nthreads) {
+    const TensorDataType b =
+      (bias != nullptr ? scale * bias[row] : TensorDataType{0.f});
+    TensorDataType sum{0.f}, sqsum{0.f};
+    for (size_t col = 0; col < width; ++col) {
+      auto& y = output[row + col * output_ldim];
+      y += b;
+      sum += y;
+      sqsum += y * y;
+    }
+    sums[row] = sum;
+    sqsums[row] = sqsum;
+  }
+}
+
+constexpr size_t block_size = 256;
+
+dim3 get_grid_dims(El::Int height, El::Int width)
+{
+  dim3 grid_dims;
+  grid_dims.x = (height + block_size - 1) / block_size;
+  grid_dims.y = width;
+  gpu_lib::clip_grid_dims(grid_dims);
+  return grid_dims;
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void apply_bias_relu(El::Matrix<TensorDataType, El::Device::GPU> const* bias,
+                     TensorDataType const& scale,
+                     El::Int rows_per_bias,
+                     El::Matrix<TensorDataType, El::Device::GPU>& output)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  auto launch = [&](auto const& sync) {
+    hydrogen::gpu::LaunchKernel(bias_relu_kernel<TensorDataType>,
+                                get_grid_dims(height, width),
+                                dim3(block_size),
+                                0,
+                                sync,
+                                height,
+                                width,
+                                rows_per_bias,
+                                bias != nullptr ? bias->LockedBuffer()
+                                                : nullptr,
+                                scale,
+                                output.Buffer(),
+                                output.LDim());
+  };
+  if (bias != nullptr) {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                       gpu::get_sync_info(*bias));
+    launch(multisync);
+  }
+  else {
+    launch(gpu::get_sync_info(output));
+  }
+}
+
+template <typename TensorDataType>
+void apply_bias_gelu(
+  El::Matrix<TensorDataType, El::Device::GPU> const* bias,
+  TensorDataType const& scale,
+  El::Int rows_per_bias,
+  El::Matrix<TensorDataType, El::Device::GPU>& preactivations,
+  El::Matrix<TensorDataType, El::Device::GPU>& output)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  auto launch = [&](auto const& sync) {
+    hydrogen::gpu::LaunchKernel(bias_gelu_kernel<TensorDataType>,
+                                get_grid_dims(height, width),
+                                dim3(block_size),
+                                0,
+                                sync,
+                                height,
+                                width,
+                                rows_per_bias,
+                                bias != nullptr ? bias->LockedBuffer()
+                                                : nullptr,
+                                scale,
+                                preactivations.Buffer(),
+                                preactivations.LDim(),
+                                output.Buffer(),
+                                output.LDim());
+  };
+  if (bias != nullptr) {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                       gpu::get_sync_info(preactivations),
+                                       gpu::get_sync_info(*bias));
+    launch(multisync);
+  }
+  else {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                       gpu::get_sync_info(preactivations));
+    launch(multisync);
+  }
+}
+
+template <typename TensorDataType>
+void apply_bias_row_statistics(
+  El::Matrix<TensorDataType, El::Device::GPU> const* bias,
+  TensorDataType const& scale,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  El::Matrix<TensorDataType, El::Device::GPU>& statistics)
+{
+  const El::Int height = output.Height();
+  if (height < 1) {
+    return;
+  }
+  dim3 grid_dims;
+  grid_dims.x = (height + block_size - 1) / block_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  auto launch = [&](auto const& sync) {
+    hydrogen::gpu::LaunchKernel(bias_row_statistics_kernel<TensorDataType>,
+                                grid_dims,
+                                dim3(block_size),
+                                0,
+                                sync,
+                                height,
+                                output.Width(),
+                                bias != nullptr ? bias->LockedBuffer()
+                                                : nullptr,
+                                scale,
+                                output.Buffer(),
+                                output.LDim(),
+                                statistics.Buffer(0, 0),
+                                statistics.Buffer(0, 1));
+  };
+  if (bias != nullptr) {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                       gpu::get_sync_info(statistics),
+                                       gpu::get_sync_info(*bias));
+    launch(multisync);
+  }
+  else {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                       gpu::get_sync_info(statistics));
+    launch(multisync);
+  }
+}
+
+template <typename TensorDataType>
+void apply_relu_gradient(
+  El::Matrix<TensorDataType, El::Device::GPU> const& output,
+  El::Matrix<TensorDataType, El::Device::GPU> const& gradient_wrt_output,
+  El::Matrix<TensorDataType, El::Device::GPU>& gradient_wrt_input)
+{
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(gradient_wrt_input),
+                      gpu::get_sync_info(output),
+                      gpu::get_sync_info(gradient_wrt_output));
+  hydrogen::gpu::LaunchKernel(relu_gradient_kernel<TensorDataType>,
+                              get_grid_dims(height, width),
+                              dim3(block_size),
+                              0,
+                              multisync,
+                              height,
+                              width,
+                              output.LockedBuffer(),
+                              output.LDim(),
+                              gradient_wrt_output.LockedBuffer(),
+                              gradient_wrt_output.LDim(),
+                              gradient_wrt_input.Buffer(),
+                              gradient_wrt_input.LDim());
+}
+
+template <typename TensorDataType>
+void apply_gelu_gradient(
+  El::Matrix<TensorDataType, El::Device::GPU> const& input,
+  El::Matrix<TensorDataType, El::Device::GPU> const& gradient_wrt_output,
+  El::Matrix<TensorDataType, El::Device::GPU>& gradient_wrt_input)
+{
+  const El::Int height = input.Height();
+  const El::Int width = input.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(gradient_wrt_input),
+                      gpu::get_sync_info(input),
+                      gpu::get_sync_info(gradient_wrt_output));
+  hydrogen::gpu::LaunchKernel(gelu_gradient_kernel<TensorDataType>,
+                              get_grid_dims(height, width),
+                              dim3(block_size),
+                              0,
+                              multisync,
+                              height,
+                              width,
+                              input.LockedBuffer(),
+                              input.LDim(),
+                              gradient_wrt_output.LockedBuffer(),
+                              gradient_wrt_output.LDim(),
+                              gradient_wrt_input.Buffer(),
+                              gradient_wrt_input.LDim());
+}
+
+#define PROTO(T)                                                               \
+  template void apply_bias_relu(El::Matrix<T, El::Device::GPU> const*,         \
+                                T const&,                                      \
+                                El::Int,                                       \
+                                El::Matrix<T, El::Device::GPU>&);              \
+  template void apply_bias_gelu(El::Matrix<T, El::Device::GPU> const*,         \
+                                T const&,                                      \
+                                El::Int,                                       \
+                                El::Matrix<T, El::Device::GPU>&,               \
+                                El::Matrix<T, El::Device::GPU>&);              \
+  template void apply_bias_row_statistics(                                     \
+    El::Matrix<T, El::Device::GPU> const*,                                     \
+    T const&,                                                                  \
+    El::Matrix<T, El::Device::GPU>&,                                           \
+    El::Matrix<T, El::Device::GPU>&);                                          \
+  template void apply_relu_gradient(El::Matrix<T, El::Device::GPU> const&,     \
+                                    El::Matrix<T, El::Device::GPU> const&,     \
+                                    El::Matrix<T, El::Device::GPU>&);          \
+  template void apply_gelu_gradient(El::Matrix<T, El::Device::GPU> const&,     \
+                                    El::Matrix<T, El::Device::GPU> const&,     \
+                                    El::Matrix<T, El::Device::GPU>&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -32,7 +32,9 @@ namespace lbann {
 
 template <typename TensorDataType, El::Device Device>
 template <typename ArchiveT>
-void base_convolution_layer<TensorDataType, Device>::serialize(ArchiveT& ar)
+void base_convolution_layer<TensorDataType, Device>::serialize(
+  ArchiveT& ar,
+  std::uint32_t const version)
 {
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
@@ -44,13 +46,22 @@ void base_convolution_layer<TensorDataType, Device>::serialize(ArchiveT& ar)
      CEREAL_NVP(m_dilations),
      CEREAL_NVP(m_groups),
      CEREAL_NVP(m_bias_scaling_factor));
+  // Version 1 added the channels-last layout and layer fusion
+  if (version >= 1) {
+    ar(CEREAL_NVP(m_channels_last),
+       CEREAL_NVP(m_fused_activation),
+       CEREAL_NVP(m_upsample_factors),
+       CEREAL_NVP(m_upsample_pads));
+  }
   /// @todo Consider serializing m_convolution_math_type
 }
 } // namespace lbann
 
 #define LBANN_COMMA ,
 #define PROTO_DEVICE(T, D)                                                     \
-  LBANN_ADD_ALL_SERIALIZE_ETI(::lbann::base_convolution_layer<T, D>);          \
+  CEREAL_CLASS_VERSION(::lbann::base_convolution_layer<T LBANN_COMMA D>, 1)    \
+  LBANN_ADD_ALL_VERSIONED_SERIALIZE_ETI(                                       \
+    ::lbann::base_convolution_layer<T, D>);                                    \
   CEREAL_REGISTER_TYPE_WITH_NAME(                                              \
     ::lbann::base_convolution_layer<T LBANN_COMMA D>,                          \
     "base_convolution_layer(" #T "," #D ")")
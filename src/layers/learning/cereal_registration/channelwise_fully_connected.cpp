@@ -38,7 +38,8 @@ void channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
      CEREAL_NVP(m_has_bias),
-     CEREAL_NVP(m_transpose));
+     CEREAL_NVP(m_transpose),
+     CEREAL_NVP(m_tensor_parallelism));
 }
 
 } // namespace lbann
@@ -32,16 +32,22 @@ namespace lbann {
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 template <typename ArchiveT>
 void fully_connected_layer<TensorDataType, Layout, Device>::serialize(
-  ArchiveT& ar)
+  ArchiveT& ar,
+  std::uint32_t const version)
 {
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
      CEREAL_NVP(m_bias_scaling_factor),
      CEREAL_NVP(m_transpose));
+  // Version 1 added the fused activation
+  if (version >= 1) {
+    ar(CEREAL_NVP(m_fused_activation));
+  }
 }
 
 } // namespace lbann
 
 #define LBANN_LAYER_NAME fully_connected_layer
+#define LBANN_LAYER_CLASS_VERSION 1
 #include <lbann/macros/register_layer_with_cereal.hpp>
@@ -46,6 +46,16 @@ void channelwise_fully_connected_layer<T, L, D>::write_specific_proto(
     msg->add_output_channel_dims(dims[ii]);
   msg->mutable_bias()->set_value(m_has_bias);
   msg->mutable_transpose()->set_value(m_transpose);
+  switch (m_tensor_parallelism) {
+  case fc_tensor_parallelism::COLUMN:
+    msg->set_tensor_parallelism("column");
+    break;
+  case fc_tensor_parallelism::ROW:
+    msg->set_tensor_parallelism("row");
+    break;
+  default:
+    break;
+  }
 }
 
 // =========================================================
@@ -63,6 +73,30 @@ void channelwise_fully_connected_distconv_adapter<
 
   data_type_distconv_adapter<TensorDataType>::setup_distributions(constraints);
 
+  // With tensor parallelism, the width process groups split the
+  // features of either the output (column) or the input (row). The
+  // other tensor is replicated across those processes.
+  const auto& layer = dynamic_cast<
+    const channelwise_fully_connected_layer<TensorDataType, Layout, Device>&>(
+    this->layer());
+  const auto mode = layer.tensor_parallelism();
+  if (mode != fc_tensor_parallelism::NONE) {
+    auto replicate_width = [](dc::Dist& dist) {
+      auto split_shape = dist.get_split_shape();
+      split_shape[0] = 1;
+      dist = dc::Dist::make_shared_distribution(dist.get_locale_shape(),
+                                                split_shape);
+    };
+    if (mode == fc_tensor_parallelism::COLUMN) {
+      replicate_width(this->m_prev_activations_dists[0]);
+      replicate_width(this->m_error_signals_dists[0]);
+    }
+    else {
+      replicate_width(this->m_activations_dists[0]);
+      replicate_width(this->m_prev_error_signals_dists[0]);
+    }
+  }
+
   for (auto& d : this->m_prev_activations_dists) {
     d.clear_overlap();
     constraints.mark_updated(d);
@@ -96,6 +130,50 @@ void channelwise_fully_connected_distconv_adapter<
   m_linear_operator =
     std::make_unique<dc::ChannelwiseFullyConnected<TensorDataType>>(
       dc::get_backend());
+
+  auto& layer = dynamic_cast<
+    channelwise_fully_connected_layer<TensorDataType, Layout, Device>&>(
+    this->layer());
+  const auto mode = layer.tensor_parallelism();
+  if (mode == fc_tensor_parallelism::NONE) {
+    return;
+  }
+
+  // Processes that differ only in their width index share the
+  // linearity. Each one applies the block matching that index.
+  const auto& x = this->get_prev_activations();
+  const auto& proc_index = x.get_proc_index();
+  const auto& locale_shape = x.get_locale_shape();
+  const int num_blocks = locale_shape[0];
+  int color = 0;
+  for (int i = dc::get_num_dims(layer) - 1; i > 0; --i) {
+    color = color * locale_shape[i] + proc_index[i];
+  }
+  MPI_Comm comm;
+  MPI_Comm_split(dc::get_mpi_comm(), color, proc_index[0], &comm);
+  m_tensor_parallel_comm = std::make_unique<El::mpi::Comm>(comm);
+  MPI_Comm_free(&comm); // El::mpi::Comm duplicates internally.
+
+  m_linear_operator->set_linearity_block(mode == fc_tensor_parallelism::COLUMN,
+                                         proc_index[0],
+                                         num_blocks);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void channelwise_fully_connected_distconv_adapter<TensorDataType,
+                                                  Layout,
+                                                  Device>::
+  allreduce_partial_sums(TensorDevType& tensor)
+{
+  if (m_tensor_parallel_comm == nullptr || tensor.get_local_size() == 0) {
+    return;
+  }
+  const El::Int size = tensor.get_local_size();
+  El::Matrix<TensorDataType, El::Device::GPU> mat(size,
+                                                  1,
+                                                  tensor.get_buffer(),
+                                                  size);
+  this->layer().get_comm()->allreduce(mat, *m_tensor_parallel_comm);
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -213,6 +291,9 @@ void channelwise_fully_connected_distconv_adapter<TensorDataType,
                              this->get_prev_activations(),
                              *m_linear,
                              this->get_activations());
+  if (layer.m_tensor_parallelism == fc_tensor_parallelism::ROW) {
+    allreduce_partial_sums(this->get_activations());
+  }
 
   if (layer.m_has_bias) {
     const auto& bias = layer.weights_values(1);
@@ -243,6 +324,9 @@ void channelwise_fully_connected_distconv_adapter<TensorDataType,
                                         this->get_prev_error_signals(),
                                         *m_linear,
                                         this->get_error_signals());
+  if (layer.m_tensor_parallelism == fc_tensor_parallelism::COLUMN) {
+    allreduce_partial_sums(this->get_error_signals());
+  }
   auto* linearity_optimizer = static_cast<data_type_optimizer<TensorDataType>*>(
     layer.get_weights(0).get_optimizer());
 
@@ -299,10 +383,13 @@ channelwise_fully_connected_distconv_adapter<TensorDataType, Layout, Device>::
   auto linearity_dims = layer.get_linearity_dims();
 
   std::reverse(std::begin(linearity_dims), std::end(linearity_dims));
-  const auto output_shape =
+  auto output_shape =
     ::distconv::get_fc_output_local_tensor_shape(this->get_prev_activations(),
                                                  linearity_dims,
                                                  layer.m_transpose);
+  if (layer.m_tensor_parallelism == fc_tensor_parallelism::COLUMN) {
+    output_shape[0] /= this->get_activations_dist().get_locale_shape()[0];
+  }
   return output_shape;
 }
 
@@ -363,12 +450,15 @@ channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
-  channelwise_fully_connected_layer(std::vector<size_t> output_channel_dims,
-                                    bool bias,
-                                    bool transpose)
+  channelwise_fully_connected_layer(
+    std::vector<size_t> output_channel_dims,
+    bool bias,
+    bool transpose,
+    fc_tensor_parallelism tensor_parallelism)
   : data_type_layer<TensorDataType>(nullptr),
     m_has_bias{bias},
-    m_transpose{transpose}
+    m_transpose{transpose},
+    m_tensor_parallelism{tensor_parallelism}
 {
 
   // Initialize output tensor dimensions
@@ -425,6 +515,16 @@ description channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
   auto desc = data_type_layer<TensorDataType>::get_description();
   desc.add("Bias", m_has_bias);
   desc.add("Transpose", m_transpose);
+  switch (m_tensor_parallelism) {
+  case fc_tensor_parallelism::COLUMN:
+    desc.add("Tensor parallelism", "column");
+    break;
+  case fc_tensor_parallelism::ROW:
+    desc.add("Tensor parallelism", "row");
+    break;
+  default:
+    break;
+  }
   return desc;
 }
 
@@ -533,6 +633,27 @@ void channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
         output_dims.size(),
         "-D output tensor");
     }
+    if (m_tensor_parallelism != fc_tensor_parallelism::NONE) {
+      const auto& ps = this->get_parallel_strategy();
+      const auto split_size =
+        (m_tensor_parallelism == fc_tensor_parallelism::COLUMN
+           ? output_dims.back()
+           : input_dims.back());
+      if (ps.height_groups > 1 || ps.width_groups <= 0 ||
+          split_size % ps.width_groups != 0) {
+        LBANN_ERROR(this->get_type(),
+                    " layer \"",
+                    this->get_name(),
+                    "\" splits ",
+                    split_size,
+                    " features across ",
+                    ps.width_groups,
+                    " width groups and ",
+                    ps.height_groups,
+                    " height groups, but tensor parallelism requires the ",
+                    "features to divide evenly across width groups only");
+      }
+    }
   }
 #endif // LBANN_HAS_DISTCONV
 
@@ -1124,7 +1245,24 @@ std::unique_ptr<Layer> build_channelwise_fully_connected_layer_from_pbuf(
   const bool has_bias = (params.has_bias() ? params.bias().value() : true);
   const bool transpose =
     (params.has_transpose() ? params.transpose().value() : false);
-  return BuilderType::Build(output_channel_dims, has_bias, transpose);
+  auto tensor_parallelism = fc_tensor_parallelism::NONE;
+  const auto& mode = params.tensor_parallelism();
+  if (mode == "column") {
+    tensor_parallelism = fc_tensor_parallelism::COLUMN;
+  }
+  else if (mode == "row") {
+    tensor_parallelism = fc_tensor_parallelism::ROW;
+  }
+  else if (!mode.empty() && mode != "none") {
+    LBANN_ERROR("invalid tensor parallelism \"",
+                mode,
+                "\" for channel-wise fully-connected layer ",
+                "(expected \"none\", \"column\", or \"row\")");
+  }
+  return BuilderType::Build(output_channel_dims,
+                            has_bias,
+                            transpose,
+                            tensor_parallelism);
 }
 
 // =========================================================
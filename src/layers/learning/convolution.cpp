@@ -28,6 +28,7 @@
 #define LBANN_CONVOLUTION_LAYER_INSTANTIATE
 #include "lbann/layers/learning/base_convolution.hpp"
 #include "lbann/layers/learning/convolution.hpp"
+#include "lbann/layers/learning/bias_activation.hpp"
 
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/proto_common.hpp"
@@ -96,13 +97,17 @@ void convolution_layer<TensorDataType, Layout, Device>::setup_dims()
   base_convolution_layer<TensorDataType, Device>::setup_dims();
 
   // Get tensor dimensions
-  const auto& input_dims = this->get_input_dims();
+  const auto input_dims = this->to_channels_first(this->get_input_dims());
   auto output_dims = input_dims;
 
-  // Initialize output tensor dimensions
+  // Initialize output tensor dimensions. A fused upsample parent
+  // scales the spatial dimensions first.
   output_dims[0] = this->m_output_channels;
   for (size_t i = 0; i < output_dims.size() - 1; ++i) {
-    const auto& input_dim = input_dims[i + 1];
+    const auto input_dim =
+      input_dims[i + 1] * (this->m_upsample_factors.empty()
+                             ? 1
+                             : this->m_upsample_factors[i]);
     const auto& kernel_dim = this->m_conv_dims[i];
     const auto& stride = this->m_strides[i];
     const auto& pad = this->m_pads[i];
@@ -111,16 +116,17 @@ void convolution_layer<TensorDataType, Layout, Device>::setup_dims()
       (input_dim + 2 * pad - dilation * (kernel_dim - 1));
     output_dims[i + 1] = (effective_dim + stride - 1) / stride;
   }
-  this->set_output_dims(output_dims);
+  this->set_output_dims(this->from_channels_first(output_dims));
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 std::vector<int>
 convolution_layer<TensorDataType, Layout, Device>::get_kernel_dims() const
 {
+  const auto input_dims = this->to_channels_first(this->get_input_dims());
   std::vector<int> dims;
   dims.push_back(this->m_output_channels);
-  dims.push_back(this->get_input_dims()[0] / this->m_groups);
+  dims.push_back(input_dims[0] / this->m_groups);
   dims.insert(dims.end(), this->m_conv_dims.begin(), this->m_conv_dims.end());
   return dims;
 }
@@ -137,11 +143,23 @@ void convolution_layer<TensorDataType, Layout, Device>::fp_compute()
       return;
     }
 #endif // LBANN_HAS_DISTCONV
-    BaseConvLayer::apply_convolution_dnn(true);
+    if (!this->m_upsample_factors.empty()) {
+      BaseConvLayer::expand_upsampled_kernel();
+      BaseConvLayer::apply_transposed_convolution_dnn(true);
+    }
+    else {
+      BaseConvLayer::apply_convolution_dnn(true);
+    }
     BaseConvLayer::apply_bias_dnn();
   }
   else {
-    BaseConvLayer::apply_convolution_im2col(true);
+    if (!this->m_upsample_factors.empty()) {
+      BaseConvLayer::expand_upsampled_kernel();
+      BaseConvLayer::apply_transposed_convolution_cpu(true);
+    }
+    else {
+      BaseConvLayer::apply_convolution_cpu(true);
+    }
     BaseConvLayer::apply_bias_cpu();
   }
 }
@@ -150,6 +168,11 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void convolution_layer<TensorDataType, Layout, Device>::bp_compute()
 {
   using BaseConvLayer = base_convolution_layer<TensorDataType, Device>;
+  fused_activation_backprop_guard<TensorDataType, Device> guard(
+    *this,
+    this->m_fused_activation,
+    this->m_fused_preactivations.get(),
+    this->m_fused_activation_gradient);
   if (this->using_gpus()) {
 #ifdef LBANN_HAS_DISTCONV
     if (this->distconv_enabled()) {
@@ -163,12 +186,29 @@ void convolution_layer<TensorDataType, Layout, Device>::bp_compute()
       return;
     }
 #endif // LBANN_HAS_DISTCONV
-    BaseConvLayer::compute_gradients_dnn(false);
-    BaseConvLayer::apply_transposed_convolution_dnn(false);
+    // With a fused upsample, the layer is a transposed convolution
+    const bool upsampled = !this->m_upsample_factors.empty();
+    BaseConvLayer::compute_gradients_dnn(upsampled);
+    if (this->are_error_signals_needed()) {
+      if (upsampled) {
+        BaseConvLayer::apply_convolution_dnn(false);
+      }
+      else {
+        BaseConvLayer::apply_transposed_convolution_dnn(false);
+      }
+    }
   }
   else {
-    BaseConvLayer::compute_gradients_im2col(false);
-    BaseConvLayer::apply_transposed_convolution_im2col(false);
+    const bool upsampled = !this->m_upsample_factors.empty();
+    BaseConvLayer::compute_gradients_cpu(upsampled);
+    if (this->are_error_signals_needed()) {
+      if (upsampled) {
+        BaseConvLayer::apply_convolution_cpu(false);
+      }
+      else {
+        BaseConvLayer::apply_transposed_convolution_cpu(false);
+      }
+    }
   }
 }
 
@@ -244,6 +284,7 @@ void convolution_layer<T, L, D>::write_specific_proto(
   auto const has_bias = (this->num_weights() > 1UL);
   msg->mutable_has_bias()->set_value(has_bias);
   protobuf::assign_to_repeated(*msg->mutable_dilation(), this->get_dilations());
+  msg->set_channels_last(this->m_channels_last);
 #ifdef LBANN_HAS_DNN_LIB
   msg->set_conv_tensor_op_mode(
     dnn_lib::convert_to_proto_math_type(this->m_convolution_math_type));
@@ -262,6 +303,10 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 bool convolution_layer<TensorDataType, Layout, Device>::is_distconv_supported()
   const
 {
+  if (this->m_channels_last) {
+    dc::MPIRootPrintStreamDebug() << "Channels-last layout not supported";
+    return false;
+  }
   const auto& kernel_dims = get_kernel_dims();
   for (int i = 0; i < dc::get_num_spatial_dims(*this); i++) {
     if (kernel_dims[2 + i] != kernel_dims[2]) {
@@ -457,6 +502,7 @@ struct ConvLayerBuilder
         ensure_dims(params.dilation(), /*default=*/1),
         num_groups,
         bias);
+    ret->set_channels_last(params.channels_last());
 #ifdef LBANN_HAS_DNN_LIB
     ret->set_dnn_math_mode(
       dnn_lib::convert_to_dnn_math_type(params.conv_tensor_op_mode()));
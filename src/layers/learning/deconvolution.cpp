@@ -29,6 +29,7 @@
 #define LBANN_CONVOLUTION_LAYER_INSTANTIATE
 #include "lbann/layers/learning/base_convolution.hpp"
 #include "lbann/layers/learning/deconvolution.hpp"
+#include "lbann/layers/learning/bias_activation.hpp"
 
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/proto_common.hpp"
@@ -127,7 +128,7 @@ void deconvolution_layer<TensorDataType, Layout, Device>::setup_dims()
   }
 
   // Compute output tensor dimensions
-  const auto& input_dims = this->get_input_dims();
+  const auto input_dims = this->to_channels_first(this->get_input_dims());
   auto output_dims = input_dims;
   output_dims[0] = this->m_output_channels;
   for (size_t i = 0; i < output_dims.size() - 1; ++i) {
@@ -176,15 +177,16 @@ void deconvolution_layer<TensorDataType, Layout, Device>::setup_dims()
                   ")");
     }
   }
-  this->set_output_dims(output_dims);
+  this->set_output_dims(this->from_channels_first(output_dims));
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 std::vector<int>
 deconvolution_layer<TensorDataType, Layout, Device>::get_kernel_dims() const
 {
+  const auto input_dims = this->to_channels_first(this->get_input_dims());
   std::vector<int> dims;
-  dims.push_back(this->get_input_dims()[0]);
+  dims.push_back(input_dims[0]);
   dims.push_back(this->m_output_channels);
   dims.insert(dims.end(), this->m_conv_dims.begin(), this->m_conv_dims.end());
   return dims;
@@ -206,7 +208,7 @@ void deconvolution_layer<TensorDataType, Layout, Device>::fp_compute()
     BaseConvLayer::apply_bias_dnn();
   }
   else {
-    BaseConvLayer::apply_transposed_convolution_im2col(true);
+    BaseConvLayer::apply_transposed_convolution_cpu(true);
     BaseConvLayer::apply_bias_cpu();
   }
 }
@@ -215,6 +217,11 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void deconvolution_layer<TensorDataType, Layout, Device>::bp_compute()
 {
   using BaseConvLayer = base_convolution_layer<TensorDataType, Device>;
+  fused_activation_backprop_guard<TensorDataType, Device> guard(
+    *this,
+    this->m_fused_activation,
+    this->m_fused_preactivations.get(),
+    this->m_fused_activation_gradient);
   if (this->using_gpus()) {
 #ifdef LBANN_HAS_DISTCONV
     if (this->distconv_enabled()) {
@@ -229,11 +236,15 @@ void deconvolution_layer<TensorDataType, Layout, Device>::bp_compute()
     }
 #endif // LBANN_HAS_DISTCONV
     BaseConvLayer::compute_gradients_dnn(true);
-    BaseConvLayer::apply_convolution_dnn(false);
+    if (this->are_error_signals_needed()) {
+      BaseConvLayer::apply_convolution_dnn(false);
+    }
   }
   else {
-    BaseConvLayer::compute_gradients_im2col(true);
-    BaseConvLayer::apply_convolution_im2col(false);
+    BaseConvLayer::compute_gradients_cpu(true);
+    if (this->are_error_signals_needed()) {
+      BaseConvLayer::apply_convolution_cpu(false);
+    }
   }
 }
 
@@ -243,6 +254,11 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 bool deconvolution_layer<TensorDataType, Layout, Device>::
   is_distconv_supported() const
 {
+  if (this->m_channels_last) {
+    dc::MPIPrintStreamDebug()
+      << this->get_name() << " unsupported with channels-last layout";
+    return false;
+  }
   const auto& kernel_dims = get_kernel_dims();
   for (int i = 0; i < dc::get_num_spatial_dims(*this); i++) {
     auto pad = this->m_pads[i];
@@ -429,8 +445,9 @@ struct Builder<TensorDataType, data_layout::DATA_PARALLEL, Device>
     using LayerType =
       deconvolution_layer<TensorDataType, data_layout::DATA_PARALLEL, Device>;
     auto ret = make_unique<LayerType>(std::forward<Args>(args)...);
-#ifdef LBANN_HAS_DNN_LIB
     const auto& params = proto_layer.deconvolution();
+    ret->set_channels_last(params.channels_last());
+#ifdef LBANN_HAS_DNN_LIB
     ret->set_dnn_math_mode(
       dnn_lib::convert_to_dnn_math_type(params.conv_tensor_op_mode()));
 #endif // LBANN_HAS_DNN_LIB
@@ -502,6 +519,7 @@ void deconvolution_layer<T, L, D>::write_specific_proto(
   auto const has_bias = (this->num_weights() > 1UL);
   msg->mutable_has_bias()->set_value(has_bias);
   protobuf::assign_to_repeated(*msg->mutable_dilation(), this->get_dilations());
+  msg->set_channels_last(this->m_channels_last);
 #ifdef LBANN_HAS_DNN_LIB
   msg->set_conv_tensor_op_mode(
     dnn_lib::convert_to_proto_math_type(this->m_convolution_math_type));
@@ -30,6 +30,43 @@
 
 namespace distconv {
 
+template <typename Backend, typename DataType>
+std::pair<El::Int, El::Int>
+ChannelwiseFullyConnected<Backend, DataType>::get_linearity_dims(
+  bool transpose_A,
+  El::Int local_input_size,
+  El::Int local_output_size) const
+{
+  auto input_size = local_input_size;
+  auto output_size = local_output_size;
+  if (m_split_output) {
+    output_size *= m_num_blocks;
+  }
+  else {
+    input_size *= m_num_blocks;
+  }
+  return transpose_A ? std::make_pair(input_size, output_size)
+                     : std::make_pair(output_size, input_size);
+}
+
+template <typename Backend, typename DataType>
+std::pair<El::IR, El::IR>
+ChannelwiseFullyConnected<Backend, DataType>::get_linearity_block(
+  bool transpose_A,
+  El::Int height,
+  El::Int width) const
+{
+  // Linearity rows correspond to output features unless transposed
+  const bool split_rows = (m_split_output != transpose_A);
+  const auto block_size = (split_rows ? height : width) / m_num_blocks;
+  const El::IR block(m_block_index * block_size,
+                     (m_block_index + 1) * block_size);
+  if (split_rows) {
+    return std::make_pair(block, El::IR(0, width));
+  }
+  return std::make_pair(El::IR(0, height), block);
+}
+
 template <typename Backend, typename DataType>
 template <typename Allocator>
 int ChannelwiseFullyConnected<Backend, DataType>::forward(
@@ -53,9 +90,6 @@ int ChannelwiseFullyConnected<Backend, DataType>::forward(
   const auto& input_size = input_dims[0] * input_dims[1];
   const auto& output_size = output_dims[0] * output_dims[1];
 
-  const auto linearity_input_size = transpose_A ? output_size : input_size;
-  const auto linearity_output_size = transpose_A ? input_size : output_size;
-
   const auto num_local_channels = output_dims[2];
   const auto local_mini_batch_size = output_dims[3];
 
@@ -83,10 +117,17 @@ int ChannelwiseFullyConnected<Backend, DataType>::forward(
                                                   num_local_channels,
                                                 output.get_buffer(),
                                                 output_size);
-  El::Matrix<DataType, El::Device::GPU> weights(linearity_output_size,
-                                                linearity_input_size,
-                                                linearity.get_buffer(),
-                                                linearity_output_size);
+  const auto linearity_dims =
+    get_linearity_dims(transpose_A, input_size, output_size);
+  El::Matrix<DataType, El::Device::GPU> full_weights(linearity_dims.first,
+                                                     linearity_dims.second,
+                                                     linearity.get_buffer(),
+                                                     linearity_dims.first);
+  const auto block = get_linearity_block(transpose_A,
+                                         linearity_dims.first,
+                                         linearity_dims.second);
+  El::Matrix<DataType, El::Device::GPU> weights;
+  El::LockedView(weights, full_weights, block.first, block.second);
 
   El::Gemm(transpose_A ? El::TRANSPOSE : El::NORMAL,
            El::NORMAL,
@@ -124,9 +165,11 @@ int ChannelwiseFullyConnected<Backend, DataType>::apply_bias(
                                                   num_local_channels,
                                                 output.get_buffer(),
                                                 output_size);
+  const auto bias_offset = m_split_output ? m_block_index * output_size : 0;
+  auto* bias_buffer = bias.get_buffer() + bias_offset;
   El::Matrix<DataType, El::Device::GPU> bias_vec(output_size,
                                                  1,
-                                                 bias.get_buffer(),
+                                                 bias_buffer,
                                                  output_size);
 
   El::Fill(ones, one);
@@ -153,9 +196,6 @@ int ChannelwiseFullyConnected<Backend, DataType>::backward_wrt_input(
   const auto& input_size = input_dims[0] * input_dims[1];
   const auto& output_size = output_dims[0] * output_dims[1];
 
-  const auto linearity_input_size = transpose_A ? output_size : input_size;
-  const auto linearity_output_size = transpose_A ? input_size : output_size;
-
   const auto num_local_channels = output_dims[2];
   const auto local_mini_batch_size = output_dims[3];
 
@@ -169,10 +209,17 @@ int ChannelwiseFullyConnected<Backend, DataType>::backward_wrt_input(
                                                          num_local_channels,
                                                        input_grad.get_buffer(),
                                                        input_size);
-  El::Matrix<DataType, El::Device::GPU> weights(linearity_output_size,
-                                                linearity_input_size,
-                                                linearity.get_buffer(),
-                                                linearity_output_size);
+  const auto linearity_dims =
+    get_linearity_dims(transpose_A, input_size, output_size);
+  El::Matrix<DataType, El::Device::GPU> full_weights(linearity_dims.first,
+                                                     linearity_dims.second,
+                                                     linearity.get_buffer(),
+                                                     linearity_dims.first);
+  const auto block = get_linearity_block(transpose_A,
+                                         linearity_dims.first,
+                                         linearity_dims.second);
+  El::Matrix<DataType, El::Device::GPU> weights;
+  El::LockedView(weights, full_weights, block.first, block.second);
 
   El::Gemm(transpose_A ? El::NORMAL : El::TRANSPOSE,
            El::NORMAL,
@@ -208,9 +255,6 @@ int ChannelwiseFullyConnected<Backend, DataType>::backward_wrt_weight(
   const auto& input_size = input_dims[0] * input_dims[1];
   const auto& output_size = output_dims[0] * output_dims[1];
 
-  const auto linearity_input_size = transpose_A ? output_size : input_size;
-  const auto linearity_output_size = transpose_A ? input_size : output_size;
-
   const auto num_local_channels = output_dims[2];
   const auto local_mini_batch_size = output_dims[3];
 
@@ -224,11 +268,23 @@ int ChannelwiseFullyConnected<Backend, DataType>::backward_wrt_weight(
     local_mini_batch_size * num_local_channels,
     output_grad.get_buffer(),
     output_size);
-  El::Matrix<DataType, El::Device::GPU> linearity_grad_mat(
-    linearity_output_size,
-    linearity_input_size,
+  const auto linearity_dims =
+    get_linearity_dims(transpose_A, input_size, output_size);
+  El::Matrix<DataType, El::Device::GPU> full_linearity_grad(
+    linearity_dims.first,
+    linearity_dims.second,
     linearity_grad.get_buffer(),
-    linearity_output_size);
+    linearity_dims.first);
+  if (m_num_blocks > 1) {
+    // Only this process's block is accumulated into
+    El::Scale(dst_scale, full_linearity_grad);
+    dst_scale = El::TypeTraits<DataType>::One();
+  }
+  const auto block = get_linearity_block(transpose_A,
+                                         linearity_dims.first,
+                                         linearity_dims.second);
+  El::Matrix<DataType, El::Device::GPU> linearity_grad_mat;
+  El::View(linearity_grad_mat, full_linearity_grad, block.first, block.second);
 
   if (transpose_A) {
     El::Gemm(El::NORMAL,
@@ -282,10 +338,28 @@ int ChannelwiseFullyConnected<Backend, DataType>::backward_wrt_bias(
                                                        num_local_channels,
                                                      output_grad.get_buffer(),
                                                      output_size);
-  El::Matrix<DataType, El::Device::GPU> bias_grad_vec(output_size,
-                                                      1,
-                                                      bias_grad.get_buffer(),
-                                                      output_size);
+  const auto num_output_blocks = m_split_output ? m_num_blocks : 1;
+  El::Matrix<DataType, El::Device::GPU> full_bias_grad(output_size *
+                                                         num_output_blocks,
+                                                       1,
+                                                       bias_grad.get_buffer(),
+                                                       output_size *
+                                                         num_output_blocks);
+  if (m_num_blocks > 1) {
+    El::Scale(dst_scale, full_bias_grad);
+    dst_scale = one;
+    // Row-parallel processes share the same output gradient, so only
+    // one of them contributes to the bias gradient
+    if (!m_split_output && m_block_index != 0) {
+      return 0;
+    }
+  }
+  const auto bias_offset = m_split_output ? m_block_index * output_size : 0;
+  El::Matrix<DataType, El::Device::GPU> bias_grad_vec;
+  El::View(bias_grad_vec,
+           full_bias_grad,
+           El::IR(bias_offset, bias_offset + output_size),
+           El::IR(0, 1));
 
   El::Fill(ones, one);
   El::Gemv(El::NORMAL,
@@ -52,7 +52,7 @@ void embedding_layer<TensorDataType, Layout, Device>::fp_compute()
                local_output,
                El::IR(i * m_embedding_dim, (i + 1) * m_embedding_dim),
                El::IR(j));
-      const El::Int ind = static_cast<El::Int>(std::floor(local_input(i, j)));
+      const El::Int ind = this->get_lookup_index(local_input(i, j));
       if (0 <= ind && ind < static_cast<El::Int>(this->m_num_embeddings)) {
         El::LockedView(embedding_v, local_embeddings, El::ALL, El::IR(ind));
         El::Copy(embedding_v, output_v);
@@ -78,6 +78,9 @@ void embedding_layer<TensorDataType, Layout, Device>::bp_compute()
     return;
   }
   auto& opt = *this->get_weights(0).get_optimizer();
+  if (this->bp_compute_sparse(opt)) {
+    return;
+  }
 
   // Local data
   const auto& local_input =
@@ -104,7 +107,7 @@ void embedding_layer<TensorDataType, Layout, Device>::bp_compute()
   MatType embedding_grad_v, output_grad_v;
   for (size_t j = 0; j < local_mini_batch_size; ++j) {
     for (size_t i = 0; i < input_size; ++i) {
-      const El::Int ind = static_cast<El::Int>(std::floor(local_input(i, j)));
+      const El::Int ind = this->get_lookup_index(local_input(i, j));
       if (0 <= ind && ind < static_cast<El::Int>(this->m_num_embeddings) &&
           ind != this->m_padding_idx) {
         El::LockedView(output_grad_v,
@@ -41,6 +41,7 @@ namespace {
  */
 template <typename TensorDataType>
 __global__ void fp_kernel(El::Int num_embeddings,
+                          bool hash_inputs,
                           El::Int embedding_dim,
                           El::Int input_size,
                           El::Int mini_batch_size,
@@ -61,7 +62,10 @@ __global__ void fp_kernel(El::Int num_embeddings,
     for (El::Int j = gidy; j < input_size; j += nthreadsy) {
       for (El::Int i = gidx; i < embedding_dim; i += nthreadsx) {
         auto& y = output[i + j * embedding_dim + k * output_ldim];
-        const El::Int ind = static_cast<El::Int>(indices[j + k * indices_ldim]);
+        El::Int ind = static_cast<El::Int>(indices[j + k * indices_ldim]);
+        if (hash_inputs) {
+          ind = embedding_hash::get_row(ind, num_embeddings);
+        }
         if (0 <= ind && ind < num_embeddings) {
           y = embeddings[i + ind * embeddings_ldim];
         }
@@ -81,6 +85,7 @@ __global__ void fp_kernel(El::Int num_embeddings,
  */
 template <typename TensorDataType>
 __global__ void bp_kernel(El::Int num_embeddings,
+                          bool hash_inputs,
                           El::Int embedding_dim,
                           El::Int input_size,
                           El::Int mini_batch_size,
@@ -102,7 +107,10 @@ __global__ void bp_kernel(El::Int num_embeddings,
   for (El::Int k = gidz; k < mini_batch_size; k += nthreadsz) {
     for (El::Int j = gidy; j < input_size; j += nthreadsy) {
       for (El::Int i = gidx; i < embedding_dim; i += nthreadsx) {
-        const El::Int ind = static_cast<El::Int>(indices[j + k * indices_ldim]);
+        El::Int ind = static_cast<El::Int>(indices[j + k * indices_ldim]);
+        if (hash_inputs) {
+          ind = embedding_hash::get_row(ind, num_embeddings);
+        }
         if (0 <= ind && ind < num_embeddings && ind != padding_idx) {
           const auto& dy =
             output_grad[i + j * embedding_dim + k * output_grad_ldim];
@@ -147,6 +155,7 @@ void embedding_layer<TensorDataType, T_layout, Dev>::fp_compute()
                                 0,
                                 multisync,
                                 this->m_num_embeddings,
+                                this->m_hash_inputs,
                                 this->m_embedding_dim,
                                 input_size,
                                 local_mini_batch_size,
@@ -172,6 +181,9 @@ void embedding_layer<TensorDataType, T_layout, Dev>::bp_compute()
     return;
   }
   auto& opt = *this->get_weights(0).get_optimizer();
+  if (this->bp_compute_sparse(opt)) {
+    return;
+  }
 
   // Local data
   const auto& local_input =
@@ -210,6 +222,7 @@ void embedding_layer<TensorDataType, T_layout, Dev>::bp_compute()
                                 0,
                                 multisync,
                                 this->m_num_embeddings,
+                                this->m_hash_inputs,
                                 this->m_embedding_dim,
                                 input_size,
                                 local_mini_batch_size,
@@ -26,8 +26,14 @@
 
 #define LBANN_FULLY_CONNECTED_LAYER_INSTANTIATE
 #include "lbann/layers/learning/fully_connected.hpp"
+#include "lbann/layers/learning/bias_activation.hpp"
+#include "lbann/layers/learning/entrywise_scale_bias.hpp"
+#include "lbann/layers/regularizers/batch_normalization.hpp"
+#include "lbann/layers/regularizers/entrywise_batch_normalization.hpp"
 
+#include "lbann/execution_algorithms/execution_context.hpp"
 #include "lbann/optimizers/optimizer.hpp"
+#include "lbann/utils/int8.hpp"
 #include "lbann/weights/initializer.hpp"
 #include "lbann/weights/variance_scaling_initializers.hpp"
 
@@ -37,6 +43,8 @@
 
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace lbann {
 
@@ -69,7 +77,8 @@ fully_connected_layer<TensorDataType, T_layout, Dev>::fully_connected_layer(
   const fully_connected_layer& other)
   : data_type_layer<TensorDataType>(other),
     m_bias_scaling_factor(other.m_bias_scaling_factor),
-    m_transpose(other.m_transpose)
+    m_transpose(other.m_transpose),
+    m_fused_activation(other.m_fused_activation)
 {
 
   // Deep matrix copies
@@ -86,6 +95,10 @@ auto fully_connected_layer<TensorDataType, T_layout, Dev>::operator=(
   data_type_layer<TensorDataType>::operator=(other);
   m_bias_scaling_factor = other.m_bias_scaling_factor;
   m_transpose = other.m_transpose;
+  m_fused_activation = other.m_fused_activation;
+  m_fused_preactivations.reset();
+  m_fused_activation_gradient.reset();
+  m_output_statistics = nullptr;
 
   // Deep matrix copies
   deallocate_matrices();
@@ -190,8 +203,10 @@ void fully_connected_layer<TensorDataType, T_layout, Dev>::setup_data(
     bias_weights.set_dims(output_dims);
     bias_weights.set_matrix_distribution(bias_dist);
 
-    // Setup bias gradient
-    if (Dev == El::Device::CPU) {
+    // Setup bias gradient, which inference-only models never use
+    deallocate_matrices();
+    this->m_bias_gradient = nullptr;
+    if (Dev == El::Device::CPU && !this->m_model->is_inference_only()) {
       if (T_layout == data_layout::MODEL_PARALLEL) {
         // Allocate a MCStarMat (RowSumMat)
         this->m_bias_gradient =
@@ -283,7 +298,10 @@ void fp_compute_impl(fully_connected_layer<TensorDataType,
   }
 
   // Apply bias if needed
-  if (l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
+  // Note: A fused activation or statistics pass applies the bias itself
+  if (l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero() &&
+      l.m_fused_activation == fused_activation::NONE &&
+      !l.computes_output_statistics()) {
     const auto& local_bias = l.weights_values(1).LockedMatrix();
     auto& local_output = output.Matrix();
     El::IndexDependentMap(
@@ -385,7 +403,10 @@ void bp_compute_impl(fully_connected_layer<TensorDataType,
     }
   }
 
-  // Compute gradient w.r.t. input
+  // Compute gradient w.r.t. input if needed
+  if (!l.are_error_signals_needed()) {
+    return;
+  }
   // Note: Perform GEMMs independently if possible
   if (linearity.DistSize() == 1) {
     El::Gemm(l.m_transpose ? El::NORMAL : El::TRANSPOSE,
@@ -407,6 +428,69 @@ void bp_compute_impl(fully_connected_layer<TensorDataType,
   }
 }
 
+namespace {
+
+/** Apply the linearity with int8 arithmetic.
+ *  Each output gets its own weight scale, and the input is quantized
+ *  with the scale for its calibrated range.
+ */
+template <typename TensorDataType>
+void apply_linearity_int8(
+  const El::AbstractMatrix<TensorDataType>& local_linearity,
+  bool transpose,
+  const El::AbstractMatrix<TensorDataType>& local_input,
+  double input_range,
+  El::AbstractMatrix<TensorDataType>& local_output)
+{
+  if constexpr (std::is_floating_point_v<TensorDataType>) {
+    const El::Int output_size = local_output.Height();
+    const El::Int input_size = local_input.Height();
+    const El::Int local_mini_batch_size = local_input.Width();
+
+    // Store the coefficients of each output contiguously
+    std::vector<int8_t> linearity(input_size * output_size);
+    std::vector<TensorDataType> linearity_scales(output_size);
+    quantize_int8_columns(local_linearity.LockedBuffer(),
+                          local_linearity.Height(),
+                          local_linearity.Width(),
+                          local_linearity.LDim(),
+                          !transpose,
+                          linearity_scales.data(),
+                          linearity.data());
+
+    const auto input_scale =
+      int8_scale(static_cast<TensorDataType>(input_range));
+    std::vector<int8_t> input(input_size * local_mini_batch_size);
+    quantize_int8(local_input.LockedBuffer(),
+                  input_size,
+                  local_mini_batch_size,
+                  local_input.LDim(),
+                  false,
+                  input_scale,
+                  input.data());
+
+    gemm_int8(output_size,
+              local_mini_batch_size,
+              input_size,
+              input_scale,
+              linearity.data(),
+              0,
+              linearity_scales.data(),
+              input.data(),
+              0,
+              static_cast<const TensorDataType*>(nullptr),
+              local_output.Buffer(),
+              local_output.LDim(),
+              0,
+              1);
+  }
+  else {
+    LBANN_ERROR("int8 inference requires float or double data");
+  }
+}
+
+} // namespace
+
 /** CPU implementation of forward prop computation. */
 template <typename TensorDataType>
 void fp_compute_impl(fully_connected_layer<TensorDataType,
@@ -420,16 +504,28 @@ void fp_compute_impl(fully_connected_layer<TensorDataType,
 
   // Apply linearity
   const auto& local_linearity = l.weights_values(0).LockedMatrix();
-  El::Gemm(l.m_transpose ? El::TRANSPOSE : El::NORMAL,
-           El::NORMAL,
-           El::TypeTraits<TensorDataType>::One(),
-           local_linearity,
-           local_input,
-           El::TypeTraits<TensorDataType>::Zero(),
-           local_output);
+  if (l.using_int8_inference()) {
+    apply_linearity_int8(local_linearity,
+                         l.m_transpose,
+                         local_input,
+                         l.get_int8_input_ranges().front(),
+                         local_output);
+  }
+  else {
+    El::Gemm(l.m_transpose ? El::TRANSPOSE : El::NORMAL,
+             El::NORMAL,
+             El::TypeTraits<TensorDataType>::One(),
+             local_linearity,
+             local_input,
+             El::TypeTraits<TensorDataType>::Zero(),
+             local_output);
+  }
 
   // Apply bias if needed
-  if (l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
+  // Note: A fused activation or statistics pass applies the bias itself
+  if (l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero() &&
+      l.m_fused_activation == fused_activation::NONE &&
+      !l.computes_output_statistics()) {
     const auto& local_bias = l.weights_values(1).LockedMatrix();
     El::IndexDependentMap(
       local_output,
@@ -496,7 +592,10 @@ void bp_compute_impl(fully_connected_layer<TensorDataType,
     }
   }
 
-  // Compute gradient w.r.t. input
+  // Compute gradient w.r.t. input if needed
+  if (!l.are_error_signals_needed()) {
+    return;
+  }
   El::Gemm(l.m_transpose ? El::NORMAL : El::TRANSPOSE,
            El::NORMAL,
            El::TypeTraits<TensorDataType>::One(),
@@ -534,7 +633,10 @@ void fp_compute_impl(fully_connected_layer<TensorDataType,
            local_output);
 
   // Apply bias if needed
-  if (l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
+  // Note: A fused activation or statistics pass applies the bias itself
+  if (l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero() &&
+      l.m_fused_activation == fused_activation::NONE &&
+      !l.computes_output_statistics()) {
     const auto& local_bias = l.weights_values(1).LockedMatrix();
     El::Matrix<TensorDataType, El::Device::GPU> ones;
 #ifdef HYDROGEN_HAVE_CUB
@@ -625,7 +727,10 @@ void bp_compute_impl(fully_connected_layer<TensorDataType,
     }
   }
 
-  // Compute gradient w.r.t. input
+  // Compute gradient w.r.t. input if needed
+  if (!l.are_error_signals_needed()) {
+    return;
+  }
   El::Gemm(l.m_transpose ? El::NORMAL : El::TRANSPOSE,
            El::NORMAL,
            El::TypeTraits<TensorDataType>::One(),
@@ -672,7 +777,10 @@ void fp_compute_impl(fully_connected_layer<TensorDataType,
 
   // Apply bias if needed
   // Note: local outer product is sufficient, no need for global GEMM
-  if (l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
+  // Note: A fused activation or statistics pass applies the bias itself
+  if (l.m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero() &&
+      l.m_fused_activation == fused_activation::NONE &&
+      !l.computes_output_statistics()) {
     const auto& bias = l.weights_values(1);
     El::Matrix<TensorDataType, El::Device::GPU> ones;
 #ifdef HYDROGEN_HAVE_CUB
@@ -793,7 +901,10 @@ void bp_compute_impl(fully_connected_layer<TensorDataType,
     }
   }
 
-  // Compute gradient w.r.t. input
+  // Compute gradient w.r.t. input if needed
+  if (!l.are_error_signals_needed()) {
+    return;
+  }
   // Note: Perform GEMMs independently if possible
   if (linearity.DistSize() == 1) {
     El::Gemm(l.m_transpose ? El::NORMAL : El::TRANSPOSE,
@@ -829,15 +940,180 @@ void fully_connected_layer<T, L, D>::write_specific_proto(
   msg->set_transpose(m_transpose);
 }
 
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+bool fully_connected_layer<TensorDataType, T_layout, Dev>::fuse_child(
+  Layer const& child)
+{
+  if (m_fused_activation != fused_activation::NONE ||
+      child.get_data_layout() != T_layout) {
+    return false;
+  }
+  m_fused_activation = get_fusable_activation<TensorDataType, Dev>(child);
+  return m_fused_activation != fused_activation::NONE;
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+bool fully_connected_layer<TensorDataType, T_layout, Dev>::
+  supports_int8_inference() const
+{
+  return T_layout == data_layout::DATA_PARALLEL && Dev == El::Device::CPU &&
+         std::is_floating_point_v<TensorDataType>;
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+bool fully_connected_layer<TensorDataType, T_layout, Dev>::
+  fold_child_into_weights(Layer const& child)
+{
+  using LocalMatrix = El::Matrix<TensorDataType, El::Device::CPU>;
+  // Entry-wise layers give one scale and shift per output
+  LocalMatrix scale, shift;
+  if (m_fused_activation != fused_activation::NONE ||
+      child.get_output_size() != this->get_output_size() ||
+      !(get_batch_normalization_affine<TensorDataType, Dev>(child,
+                                                            scale,
+                                                            shift) ||
+        get_entrywise_batch_normalization_affine<TensorDataType, Dev>(child,
+                                                                      scale,
+                                                                      shift) ||
+        get_entrywise_scale_bias_affine<TensorDataType, Dev>(child,
+                                                             scale,
+                                                             shift))) {
+    return false;
+  }
+  const El::Int num_channels = scale.Height();
+  const El::Int output_size = this->get_output_size();
+  if (num_channels == 0 || output_size % num_channels != 0) {
+    return false;
+  }
+  const El::Int channel_size = output_size / num_channels;
+
+  // Only replicated weights can be updated locally
+  auto is_replicated = [](weights* w) {
+    auto* dtw = dynamic_cast<WeightsType*>(w);
+    if (dtw == nullptr || dtw->is_sharded()) {
+      return false;
+    }
+    const auto& values = dtw->get_values();
+    return values.ColStride() == 1 && values.RowStride() == 1;
+  };
+  const bool has_bias =
+    (m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero());
+  if (!is_replicated(&this->get_weights(0)) ||
+      (has_bias && !is_replicated(&this->get_weights(1)))) {
+    return false;
+  }
+
+  // Scale the linearity entries that produce each output
+  auto& linearity =
+    dynamic_cast<WeightsType&>(this->get_weights(0)).get_values_sharded();
+  LocalMatrix local_linearity;
+  El::Copy(linearity.LockedMatrix(), local_linearity);
+  for (El::Int col = 0; col < local_linearity.Width(); ++col) {
+    for (El::Int row = 0; row < local_linearity.Height(); ++row) {
+      const El::Int output = (m_transpose ? col : row);
+      local_linearity(row, col) *= scale(output / channel_size, 0);
+    }
+  }
+  El::Copy(local_linearity, linearity.Matrix());
+
+  // bias' = scale * bias + shift, stored without the bias scaling
+  std::vector<TensorDataType> bias(output_size);
+  LocalMatrix local_bias;
+  if (has_bias) {
+    El::Copy(dynamic_cast<WeightsType&>(this->get_weights(1))
+               .get_values()
+               .LockedMatrix(),
+             local_bias);
+  }
+  for (El::Int i = 0; i < output_size; ++i) {
+    const auto b =
+      (has_bias ? m_bias_scaling_factor * local_bias(i, 0)
+                : El::TypeTraits<TensorDataType>::Zero());
+    bias[i] = scale(i / channel_size, 0) * b + shift(i / channel_size, 0);
+  }
+  if (has_bias) {
+    for (El::Int i = 0; i < output_size; ++i) {
+      local_bias(i, 0) = bias[i] / m_bias_scaling_factor;
+    }
+    El::Copy(local_bias,
+             dynamic_cast<WeightsType&>(this->get_weights(1))
+               .get_values_sharded()
+               .Matrix());
+  }
+  else {
+    // New bias weights take their values at the next setup
+    auto w = std::make_shared<WeightsType>(*this->get_comm());
+    w->set_name(this->get_name() + "_bias_weights");
+    w->set_initializer(
+      std::make_unique<value_initializer<TensorDataType>>(std::move(bias)));
+    m_bias_scaling_factor = El::TypeTraits<TensorDataType>::One();
+    this->set_num_weights(2);
+    this->set_weights(1, w);
+    this->m_model->add_weights(std::move(w));
+  }
+  return true;
+}
+
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void fully_connected_layer<TensorDataType, T_layout, Dev>::fp_compute()
 {
   fp_compute_impl<TensorDataType>(*this);
+
+  // Apply bias and fused activation in one pass
+  if (m_fused_activation != fused_activation::NONE &&
+      this->weights_values(0).Participating()) {
+    using LocalMatrixType = El::Matrix<TensorDataType, Dev>;
+    LocalMatrixType const* local_bias = nullptr;
+    if (m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
+      local_bias = &static_cast<LocalMatrixType const&>(
+        this->weights_values(1).LockedMatrix());
+    }
+    apply_bias_activation(local_bias,
+                          m_bias_scaling_factor,
+                          El::Int{1},
+                          m_fused_activation,
+                          this->get_activations(),
+                          m_fused_preactivations);
+  }
+  // Apply bias and compute the statistics of the child entry-wise
+  // batch normalization in one pass
+  else if (computes_output_statistics() &&
+           this->weights_values(0).Participating()) {
+    using LocalMatrixType = El::Matrix<TensorDataType, Dev>;
+    LocalMatrixType const* local_bias = nullptr;
+    if (m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
+      local_bias = &static_cast<LocalMatrixType const&>(
+        this->weights_values(1).LockedMatrix());
+    }
+    auto& output = this->get_activations();
+    m_output_statistics->AlignWith(output);
+    m_output_statistics->Resize(output.Height(), 2);
+    apply_bias_row_statistics(
+      local_bias,
+      m_bias_scaling_factor,
+      static_cast<LocalMatrixType&>(output.Matrix()),
+      static_cast<LocalMatrixType&>(m_output_statistics->Matrix()));
+  }
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+bool fully_connected_layer<TensorDataType, T_layout, Dev>::
+  computes_output_statistics() const
+{
+  return T_layout == data_layout::DATA_PARALLEL &&
+         m_output_statistics != nullptr &&
+         this->m_model->get_execution_context().get_execution_mode() ==
+           execution_mode::training;
 }
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void fully_connected_layer<TensorDataType, T_layout, Dev>::bp_compute()
 {
+  fused_activation_backprop_guard<TensorDataType, Dev> guard(
+    *this,
+    m_fused_activation,
+    m_fused_preactivations.get(),
+    m_fused_activation_gradient);
   bp_compute_impl<TensorDataType>(*this);
 }
 
@@ -27,6 +27,9 @@
 #include <hydrogen/utils/SimpleBuffer.hpp>
 #define LBANN_GRU_LAYER_INSTANTIATE
 #include "lbann/layers/learning/gru.hpp"
+#ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
+#include "lbann/layers/learning/gru_fused.hpp"
+#endif // LBANN_GRU_LAYER_CUDNN_SUPPORTED
 #include "lbann/models/model.hpp"
 #include "lbann/proto/proto_common.hpp"
 #include "lbann/utils/dim_helpers.hpp"
@@ -57,13 +60,15 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 gru_layer<TensorDataType, Layout, Device>::gru_layer(const gru_layer& other)
   : data_type_layer<TensorDataType>(other),
     m_hidden_size{other.m_hidden_size},
-    m_num_layers{other.m_num_layers}
+    m_num_layers{other.m_num_layers},
+    m_fused_kernels_enabled{other.m_fused_kernels_enabled}
 {
 #ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   m_onednn_cpu_objects.reset();
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
   m_cudnn_objects.reset();
+  m_fused_objects.reset();
 #endif // LBANN_GRU_LAYER_CUDNN_SUPPORTED
 }
 
@@ -74,11 +79,13 @@ gru_layer<TensorDataType, Layout, Device>::operator=(const gru_layer& other)
   data_type_layer<TensorDataType>::operator=(other);
   m_hidden_size = other.m_hidden_size;
   m_num_layers = other.m_num_layers;
+  m_fused_kernels_enabled = other.m_fused_kernels_enabled;
 #ifdef LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
   m_onednn_cpu_objects.reset();
 #endif // LBANN_GRU_LAYER_ONEDNN_CPU_SUPPORTED
 #ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
   m_cudnn_objects.reset();
+  m_fused_objects.reset();
 #endif // LBANN_GRU_LAYER_CUDNN_SUPPORTED
   return *this;
 }
@@ -145,6 +152,18 @@ gru_layer<TensorDataType, Layout, Device>::get_reserve_space() const
   return invalid; // silence compiler warnings
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool gru_layer<TensorDataType, Layout, Device>::uses_fused_kernels() const
+{
+#ifdef LBANN_GRU_LAYER_CUDNN_SUPPORTED
+  if constexpr (Device == El::Device::GPU) {
+    return (m_fused_kernels_enabled &&
+            gru_fused::is_supported<TensorDataType>(m_hidden_size));
+  }
+#endif // LBANN_GRU_LAYER_CUDNN_SUPPORTED
+  return false;
+}
+
 // =========================================================
 // Setup
 // =========================================================
@@ -990,6 +1009,7 @@ void gru_layer<TensorDataType, Layout, Device>::setup_cudnn()
 
   // Initialize storage for cuDNN objects
   m_cudnn_objects = std::make_unique<CudnnObjects>();
+  m_fused_objects = std::make_unique<FusedObjects>();
 
   // RNN descriptor
   static dnn_lib::DropoutDescriptor dropout_desc;
@@ -1010,6 +1030,329 @@ void gru_layer<TensorDataType, Layout, Device>::setup_cudnn()
                                 CUDNN_RNN_PADDED_IO_ENABLED);
 }
 
+// ---------------------------------
+// Fused kernel forward prop
+// ---------------------------------
+
+template <typename TensorDataType>
+void fp_compute_fused_impl(
+  gru_layer<TensorDataType, data_layout::DATA_PARALLEL, El::Device::GPU>& l)
+{
+
+  // Matrices
+  using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+  const auto& input_sequence =
+    dynamic_cast<const LocalMat&>(l.get_local_prev_activations(0));
+  const auto& init_hidden =
+    dynamic_cast<const LocalMat&>(l.get_local_prev_activations(1));
+  auto& output_sequence = dynamic_cast<LocalMat&>(l.get_local_activations());
+
+  // Dimensions
+  const size_t sequence_length = l.get_input_dims(0)[0];
+  const size_t input_size = l.get_input_size(0) / sequence_length;
+  const size_t hidden_size = l.m_hidden_size;
+  const size_t num_layers = l.m_num_layers;
+  const size_t mini_batch_size = input_sequence.Width();
+  const size_t num_steps = sequence_length * mini_batch_size;
+
+  // GPU objects
+  if (l.m_fused_objects == nullptr) {
+    LBANN_ERROR(l.get_type(),
+                " layer \"",
+                l.get_name(),
+                "\" ",
+                "attempted to run fused kernel implementation ",
+                "before initializing workspaces");
+  }
+  auto&& sync_info = input_sequence.GetSyncInfo();
+  auto& fused_objects = *l.m_fused_objects;
+  fused_objects.output_sequence_workspaces.resize(num_layers);
+  fused_objects.reserve_workspaces.resize(num_layers);
+  auto& input_gates = fused_objects.input_gates_workspace;
+  input_gates.SetSyncInfo(sync_info);
+  input_gates.Resize(3 * hidden_size, num_steps);
+
+  // Input sequence of first cell
+  LocalMat x;
+  x.SetSyncInfo(sync_info);
+  if (input_sequence.Contiguous()) {
+    x.LockedAttach(input_size,
+                   num_steps,
+                   input_sequence.LockedBuffer(),
+                   input_size);
+  }
+  else {
+    fused_objects.input_sequence_workspace.SetSyncInfo(sync_info);
+    El::Copy(input_sequence, fused_objects.input_sequence_workspace);
+    x.LockedAttach(input_size,
+                   num_steps,
+                   fused_objects.input_sequence_workspace.LockedBuffer(),
+                   input_size);
+  }
+
+  for (size_t i = 0; i < num_layers; ++i) {
+    const auto& ih_matrix =
+      dynamic_cast<const LocalMat&>(l.weights_values(4 * i).LockedMatrix());
+    const auto& hh_matrix =
+      dynamic_cast<const LocalMat&>(l.weights_values(4 * i + 1).LockedMatrix());
+    const auto& ih_bias =
+      dynamic_cast<const LocalMat&>(l.weights_values(4 * i + 2).LockedMatrix());
+    const auto& hh_bias =
+      dynamic_cast<const LocalMat&>(l.weights_values(4 * i + 3).LockedMatrix());
+    auto& y = fused_objects.output_sequence_workspaces[i];
+    auto& reserve = fused_objects.reserve_workspaces[i];
+    y.SetSyncInfo(sync_info);
+    reserve.SetSyncInfo(sync_info);
+    y.Resize(hidden_size, num_steps);
+    reserve.Resize(gru_fused::reserve_rows_per_hidden * hidden_size,
+                   num_steps);
+
+    // Input projections for every time step
+    El::Gemm(El::NORMAL,
+             El::NORMAL,
+             El::TypeTraits<TensorDataType>::One(),
+             ih_matrix,
+             x,
+             El::TypeTraits<TensorDataType>::Zero(),
+             input_gates);
+
+    // Recurrence
+    const auto h0 =
+      El::LockedView(init_hidden,
+                     El::IR(i * hidden_size, (i + 1) * hidden_size),
+                     El::ALL);
+    gru_fused::fp_recurrence(sequence_length,
+                             hh_matrix,
+                             ih_bias,
+                             hh_bias,
+                             input_gates,
+                             h0,
+                             y,
+                             reserve);
+    x.LockedAttach(hidden_size, num_steps, y.LockedBuffer(), hidden_size);
+  }
+
+  // Output tensor
+  output_sequence.LockedAttach(
+    sequence_length * hidden_size,
+    mini_batch_size,
+    fused_objects.output_sequence_workspaces.back().LockedBuffer(),
+    sequence_length * hidden_size);
+}
+
+// ---------------------------------
+// Fused kernel back prop
+// ---------------------------------
+
+template <typename TensorDataType>
+void bp_compute_fused_impl(
+  gru_layer<TensorDataType, data_layout::DATA_PARALLEL, El::Device::GPU>& l)
+{
+
+  // Matrices
+  using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+  const auto& input_sequence =
+    dynamic_cast<const LocalMat&>(l.get_local_prev_activations(0));
+  const auto& output_sequence_grad =
+    dynamic_cast<const LocalMat&>(l.get_local_prev_error_signals());
+  auto& input_sequence_grad =
+    dynamic_cast<LocalMat&>(l.get_local_error_signals(0));
+  auto& init_hidden_grad =
+    dynamic_cast<LocalMat&>(l.get_local_error_signals(1));
+
+  // Dimensions
+  const size_t sequence_length = l.get_input_dims(0)[0];
+  const size_t input_size = l.get_input_size(0) / sequence_length;
+  const size_t hidden_size = l.m_hidden_size;
+  const size_t num_layers = l.m_num_layers;
+  const size_t mini_batch_size = output_sequence_grad.Width();
+  const size_t num_steps = sequence_length * mini_batch_size;
+  const auto one = El::TypeTraits<TensorDataType>::One();
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
+
+  // GPU objects
+  // Note: Output sequences and reserve space have already been setup
+  // in forward prop
+  auto&& sync_info = output_sequence_grad.GetSyncInfo();
+  auto& fused_objects = *l.m_fused_objects;
+  auto& input_gates_grad = fused_objects.input_gates_workspace;
+  auto& hh_gates_grad = fused_objects.hh_gates_grad_workspace;
+  input_gates_grad.SetSyncInfo(sync_info);
+  hh_gates_grad.SetSyncInfo(sync_info);
+  input_gates_grad.Resize(3 * hidden_size, num_steps);
+  hh_gates_grad.Resize(3 * hidden_size, num_steps);
+  // Note: The gradient w.r.t. the input sequence of each cell is
+  // written into the same workspace, so it is allocated once for the
+  // largest cell.
+  auto& input_sequence_grad_workspace =
+    fused_objects.input_sequence_grad_workspace;
+  input_sequence_grad_workspace.SetSyncInfo(sync_info);
+  input_sequence_grad_workspace.Resize(El::Max(input_size, hidden_size) *
+                                         num_steps,
+                                       1);
+  LocalMat ones;
+  ones.SetSyncInfo(sync_info);
+  El::Ones(ones, num_steps, 1);
+
+  // Weight gradients
+  std::vector<LocalMat> weights_grad_list(4 * num_layers);
+  for (auto& dw : weights_grad_list) {
+    dw.SetSyncInfo(sync_info);
+  }
+  for (size_t i = 0; i < num_layers; ++i) {
+    weights_grad_list[4 * i].Resize(3 * hidden_size,
+                                    i == 0 ? input_size : hidden_size);
+    weights_grad_list[4 * i + 1].Resize(3 * hidden_size, hidden_size);
+    weights_grad_list[4 * i + 2].Resize(3 * hidden_size, 1);
+    weights_grad_list[4 * i + 3].Resize(3 * hidden_size, 1);
+  }
+
+  // Gradient w.r.t. output sequence of last cell
+  LocalMat dy;
+  dy.SetSyncInfo(sync_info);
+  if (output_sequence_grad.Contiguous()) {
+    dy.LockedAttach(hidden_size,
+                    num_steps,
+                    output_sequence_grad.LockedBuffer(),
+                    hidden_size);
+  }
+  else {
+    fused_objects.output_sequence_grad_workspace.SetSyncInfo(sync_info);
+    El::Copy(output_sequence_grad,
+             fused_objects.output_sequence_grad_workspace);
+    dy.LockedAttach(
+      hidden_size,
+      num_steps,
+      fused_objects.output_sequence_grad_workspace.LockedBuffer(),
+      hidden_size);
+  }
+
+  for (size_t i = num_layers; i-- > 0;) {
+    const auto& ih_matrix =
+      dynamic_cast<const LocalMat&>(l.weights_values(4 * i).LockedMatrix());
+    const auto& hh_matrix =
+      dynamic_cast<const LocalMat&>(l.weights_values(4 * i + 1).LockedMatrix());
+    const auto& reserve = fused_objects.reserve_workspaces[i];
+    const size_t cell_input_size = (i == 0 ? input_size : hidden_size);
+
+    // Recurrence
+    auto dh0 = El::View(init_hidden_grad,
+                        El::IR(i * hidden_size, (i + 1) * hidden_size),
+                        El::ALL);
+    gru_fused::bp_recurrence(sequence_length,
+                             hh_matrix,
+                             reserve,
+                             dy,
+                             input_gates_grad,
+                             hh_gates_grad,
+                             dh0);
+
+    // Input sequence of current cell
+    LocalMat x;
+    if (i > 0) {
+      x.LockedAttach(
+        hidden_size,
+        num_steps,
+        fused_objects.output_sequence_workspaces[i - 1].LockedBuffer(),
+        hidden_size);
+    }
+    else if (input_sequence.Contiguous()) {
+      x.LockedAttach(input_size,
+                     num_steps,
+                     input_sequence.LockedBuffer(),
+                     input_size);
+    }
+    else {
+      x.LockedAttach(input_size,
+                     num_steps,
+                     fused_objects.input_sequence_workspace.LockedBuffer(),
+                     input_size);
+    }
+
+    // Gradients w.r.t. weights
+    const auto h_prev =
+      El::LockedView(reserve,
+                     El::IR(4 * hidden_size, 5 * hidden_size),
+                     El::ALL);
+    El::Gemm(El::NORMAL,
+             El::TRANSPOSE,
+             one,
+             input_gates_grad,
+             x,
+             zero,
+             weights_grad_list[4 * i]);
+    El::Gemm(El::NORMAL,
+             El::TRANSPOSE,
+             one,
+             hh_gates_grad,
+             h_prev,
+             zero,
+             weights_grad_list[4 * i + 1]);
+    El::Gemm(El::NORMAL,
+             El::NORMAL,
+             one,
+             input_gates_grad,
+             ones,
+             zero,
+             weights_grad_list[4 * i + 2]);
+    El::Gemm(El::NORMAL,
+             El::NORMAL,
+             one,
+             hh_gates_grad,
+             ones,
+             zero,
+             weights_grad_list[4 * i + 3]);
+
+    // Gradient w.r.t. input sequence of current cell
+    // Note: This overwrites dy, which the recurrence has already
+    // consumed.
+    LocalMat dx;
+    if (i == 0 && input_sequence_grad.Contiguous()) {
+      dx.Attach(cell_input_size,
+                num_steps,
+                input_sequence_grad.Buffer(),
+                cell_input_size);
+    }
+    else {
+      dx.Attach(cell_input_size,
+                num_steps,
+                input_sequence_grad_workspace.Buffer(),
+                cell_input_size);
+    }
+    dx.SetSyncInfo(sync_info);
+    El::Gemm(El::TRANSPOSE,
+             El::NORMAL,
+             one,
+             ih_matrix,
+             input_gates_grad,
+             zero,
+             dx);
+    if (i == 0 && !input_sequence_grad.Contiguous()) {
+      LocalMat dx_view;
+      dx_view.LockedAttach(sequence_length * input_size,
+                           mini_batch_size,
+                           dx.LockedBuffer(),
+                           sequence_length * input_size);
+      El::Copy(dx_view, input_sequence_grad);
+    }
+    dy.LockedAttach(cell_input_size,
+                    num_steps,
+                    dx.LockedBuffer(),
+                    cell_input_size);
+  }
+
+  // Send gradients to optimizers
+  TensorDataType buf_scale, in_scale;
+  for (size_t i = 0; i < 4 * num_layers; ++i) {
+    auto&& opt = l.get_weights(i).get_optimizer();
+    if (opt != nullptr) {
+      auto& buf = opt->get_gradient_buffer(buf_scale, in_scale, true);
+      El::Scale(buf_scale, buf);
+      El::Axpy(in_scale, weights_grad_list[i], buf.Matrix());
+    }
+  }
+}
+
 // ---------------------------------
 // cuDNN forward prop
 // ---------------------------------
@@ -1148,6 +1491,10 @@ void fp_compute_impl(
   if (mini_batch_size <= 0) {
     return;
   }
+  if (l.uses_fused_kernels()) {
+    fp_compute_fused_impl(l);
+    return;
+  }
   if (active_min_workspace_mini_batch_size == 0) {
     // Set the minumum to the smaller of the initial mini-batch size
     // or a predefined minumim
@@ -1459,6 +1806,10 @@ void bp_compute_impl(
   if (mini_batch_size <= 0) {
     return;
   }
+  if (l.uses_fused_kernels()) {
+    bp_compute_fused_impl(l);
+    return;
+  }
   const size_t workspace_mini_batch_size =
     El::Max(mini_batch_size, active_min_workspace_mini_batch_size);
 
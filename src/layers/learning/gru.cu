@@ -0,0 +1,398 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/layers/learning/gru_fused.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace gru_fused {
+
+namespace {
+
+/** @brief Shared memory available to a block without opting in */
+constexpr size_t max_shared_memory_size = 48 * 1024;
+
+/** @brief Shared memory used by the recurrence kernels
+ *  @details Recurrent weights, one hidden-size vector and one
+ *           gate-size vector.
+ */
+template <typename TensorDataType>
+size_t shared_memory_size(size_t hidden_size)
+{
+  return (3 * hidden_size * hidden_size + 4 * hidden_size) *
+         sizeof(TensorDataType);
+}
+
+template <typename TensorDataType>
+__device__ __forceinline__ TensorDataType sigmoid(const TensorDataType& x)
+{
+  const TensorDataType one = 1.;
+  return one / (one + gpu_lib::exp(-x));
+}
+
+/** @brief Copy recurrent weights into shared memory
+ *  @details Stored column-major with the gate index varying fastest,
+ *           so consecutive threads read consecutive gates.
+ */
+template <typename TensorDataType>
+__device__ void load_hh_matrix(size_t hidden_size,
+                               const TensorDataType* __restrict__ hh_matrix,
+                               size_t hh_matrix_ldim,
+                               TensorDataType* __restrict__ shared_hh_matrix)
+{
+  const size_t gate_size = 3 * hidden_size;
+  for (size_t pos = threadIdx.x; pos < gate_size * hidden_size;
+       pos += blockDim.x) {
+    const auto i = pos % gate_size;
+    const auto j = pos / gate_size;
+    shared_hh_matrix[pos] = hh_matrix[i + j * hh_matrix_ldim];
+  }
+}
+
+/** @brief Forward prop recurrence of a GRU cell
+ *
+ *  Each block owns whole sequences and loops over their time
+ *  steps. Threads are assigned to gates when applying the
+ *  recurrent weights and to hidden units when applying the
+ *  nonlinearities.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: mini_batch_size x 1 x 1
+ */
+template <typename TensorDataType>
+__global__ void
+fp_recurrence_kernel(size_t hidden_size,
+                     size_t sequence_length,
+                     size_t mini_batch_size,
+                     const TensorDataType* __restrict__ hh_matrix,
+                     size_t hh_matrix_ldim,
+                     const TensorDataType* __restrict__ ih_bias,
+                     const TensorDataType* __restrict__ hh_bias,
+                     const TensorDataType* __restrict__ input_gates,
+                     size_t input_gates_ldim,
+                     const TensorDataType* __restrict__ init_hidden,
+                     size_t init_hidden_ldim,
+                     TensorDataType* __restrict__ output,
+                     size_t output_ldim,
+                     TensorDataType* __restrict__ reserve,
+                     size_t reserve_ldim)
+{
+  extern __shared__ __align__(8) unsigned char shared_memory[];
+  const size_t gate_size = 3 * hidden_size;
+  auto* shared_hh_matrix = reinterpret_cast<TensorDataType*>(shared_memory);
+  auto* shared_hidden = shared_hh_matrix + gate_size * hidden_size;
+  auto* shared_hh_gates = shared_hidden + hidden_size;
+  const TensorDataType one = 1.;
+
+  load_hh_matrix(hidden_size, hh_matrix, hh_matrix_ldim, shared_hh_matrix);
+
+  for (size_t k = blockIdx.x; k < mini_batch_size; k += gridDim.x) {
+    for (size_t i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+      shared_hidden[i] = init_hidden[i + k * init_hidden_ldim];
+    }
+    __syncthreads();
+    for (size_t t = 0; t < sequence_length; ++t) {
+      const size_t pos = t + k * sequence_length;
+
+      // Recurrent part of gates: hh_matrix * h + hh_bias
+      for (size_t j = threadIdx.x; j < gate_size; j += blockDim.x) {
+        TensorDataType sum = hh_bias[j];
+        for (size_t i = 0; i < hidden_size; ++i) {
+          sum += shared_hh_matrix[j + i * gate_size] * shared_hidden[i];
+        }
+        shared_hh_gates[j] = sum;
+      }
+      __syncthreads();
+
+      // Nonlinearities and new hidden state
+      // Note: Each hidden unit is read and written by one thread.
+      const auto* x_gates = &input_gates[pos * input_gates_ldim];
+      auto* res = &reserve[pos * reserve_ldim];
+      for (size_t i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+        const auto r =
+          sigmoid(x_gates[i] + ih_bias[i] + shared_hh_gates[i]);
+        const auto z =
+          sigmoid(x_gates[hidden_size + i] + ih_bias[hidden_size + i] +
+                  shared_hh_gates[hidden_size + i]);
+        const auto hn = shared_hh_gates[2 * hidden_size + i];
+        const auto n = gpu_lib::tanh(x_gates[2 * hidden_size + i] +
+                                     ih_bias[2 * hidden_size + i] + r * hn);
+        const auto h_prev = shared_hidden[i];
+        const auto h = (one - z) * n + z * h_prev;
+        res[i] = r;
+        res[hidden_size + i] = z;
+        res[2 * hidden_size + i] = n;
+        res[3 * hidden_size + i] = hn;
+        res[4 * hidden_size + i] = h_prev;
+        output[i + pos * output_ldim] = h;
+        shared_hidden[i] = h;
+      }
+      __syncthreads();
+    }
+  }
+}
+
+/** @brief Back prop recurrence of a GRU cell
+ *
+ *  Runs the time steps of each sequence in reverse, carrying the
+ *  gradient w.r.t. the hidden state in shared memory.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: mini_batch_size x 1 x 1
+ */
+template <typename TensorDataType>
+__global__ void
+bp_recurrence_kernel(size_t hidden_size,
+                     size_t sequence_length,
+                     size_t mini_batch_size,
+                     const TensorDataType* __restrict__ hh_matrix,
+                     size_t hh_matrix_ldim,
+                     const TensorDataType* __restrict__ reserve,
+                     size_t reserve_ldim,
+                     const TensorDataType* __restrict__ output_grad,
+                     size_t output_grad_ldim,
+                     TensorDataType* __restrict__ input_gates_grad,
+                     size_t input_gates_grad_ldim,
+                     TensorDataType* __restrict__ hh_gates_grad,
+                     size_t hh_gates_grad_ldim,
+                     TensorDataType* __restrict__ init_hidden_grad,
+                     size_t init_hidden_grad_ldim)
+{
+  extern __shared__ __align__(8) unsigned char shared_memory[];
+  const size_t gate_size = 3 * hidden_size;
+  auto* shared_hh_matrix = reinterpret_cast<TensorDataType*>(shared_memory);
+  auto* shared_hidden_grad = shared_hh_matrix + gate_size * hidden_size;
+  auto* shared_hh_gates_grad = shared_hidden_grad + hidden_size;
+  const TensorDataType zero = 0.;
+  const TensorDataType one = 1.;
+
+  load_hh_matrix(hidden_size, hh_matrix, hh_matrix_ldim, shared_hh_matrix);
+
+  for (size_t k = blockIdx.x; k < mini_batch_size; k += gridDim.x) {
+    for (size_t i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+      shared_hidden_grad[i] = zero;
+    }
+    __syncthreads();
+    for (size_t t = sequence_length; t-- > 0;) {
+      const size_t pos = t + k * sequence_length;
+
+      // Gradients w.r.t. gate pre-activations
+      // Note: Each hidden unit is read and written by one thread.
+      const auto* res = &reserve[pos * reserve_ldim];
+      auto* dx_gates = &input_gates_grad[pos * input_gates_grad_ldim];
+      auto* dh_gates = &hh_gates_grad[pos * hh_gates_grad_ldim];
+      for (size_t i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+        const auto r = res[i];
+        const auto z = res[hidden_size + i];
+        const auto n = res[2 * hidden_size + i];
+        const auto hn = res[3 * hidden_size + i];
+        const auto h_prev = res[4 * hidden_size + i];
+        const auto dh =
+          output_grad[i + pos * output_grad_ldim] + shared_hidden_grad[i];
+        const auto dn = dh * (one - z) * (one - n * n);
+        const auto dz = dh * (h_prev - n) * z * (one - z);
+        const auto dr = dn * hn * r * (one - r);
+        dx_gates[i] = dr;
+        dx_gates[hidden_size + i] = dz;
+        dx_gates[2 * hidden_size + i] = dn;
+        dh_gates[i] = dr;
+        dh_gates[hidden_size + i] = dz;
+        dh_gates[2 * hidden_size + i] = dn * r;
+        shared_hh_gates_grad[i] = dr;
+        shared_hh_gates_grad[hidden_size + i] = dz;
+        shared_hh_gates_grad[2 * hidden_size + i] = dn * r;
+        shared_hidden_grad[i] = dh * z;
+      }
+      __syncthreads();
+
+      // Gradient w.r.t. previous hidden state: hh_matrix^T * dh_gates
+      for (size_t i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+        TensorDataType sum = shared_hidden_grad[i];
+        for (size_t j = 0; j < gate_size; ++j) {
+          sum += shared_hh_matrix[j + i * gate_size] * shared_hh_gates_grad[j];
+        }
+        shared_hidden_grad[i] = sum;
+      }
+      __syncthreads();
+    }
+    for (size_t i = threadIdx.x; i < hidden_size; i += blockDim.x) {
+      init_hidden_grad[i + k * init_hidden_grad_ldim] = shared_hidden_grad[i];
+    }
+    __syncthreads();
+  }
+}
+
+/** @brief Block and grid dimensions for the recurrence kernels */
+void get_launch_dims(size_t hidden_size,
+                     size_t mini_batch_size,
+                     dim3& block_dims,
+                     dim3& grid_dims)
+{
+  constexpr size_t warp_size = 32;
+  const size_t gate_size = 3 * hidden_size;
+  block_dims.x = ((gate_size + warp_size - 1) / warp_size) * warp_size;
+  grid_dims.x = mini_batch_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+}
+
+} // namespace
+
+template <typename TensorDataType>
+bool is_supported(size_t hidden_size)
+{
+  return (hidden_size > 0 && hidden_size <= max_hidden_size &&
+          shared_memory_size<TensorDataType>(hidden_size) <=
+            max_shared_memory_size);
+}
+
+template <typename TensorDataType>
+void fp_recurrence(
+  size_t sequence_length,
+  El::Matrix<TensorDataType, El::Device::GPU> const& hh_matrix,
+  El::Matrix<TensorDataType, El::Device::GPU> const& ih_bias,
+  El::Matrix<TensorDataType, El::Device::GPU> const& hh_bias,
+  El::Matrix<TensorDataType, El::Device::GPU> const& input_gates,
+  El::Matrix<TensorDataType, El::Device::GPU> const& init_hidden,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  El::Matrix<TensorDataType, El::Device::GPU>& reserve)
+{
+  const size_t hidden_size = hh_matrix.Width();
+  const size_t mini_batch_size = init_hidden.Width();
+  if (!is_supported<TensorDataType>(hidden_size)) {
+    LBANN_ERROR("fused GRU kernels do not support a hidden size of ",
+                hidden_size);
+  }
+  if (mini_batch_size == 0 || sequence_length == 0) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                     gpu::get_sync_info(reserve),
+                                     gpu::get_sync_info(hh_matrix),
+                                     gpu::get_sync_info(ih_bias),
+                                     gpu::get_sync_info(hh_bias),
+                                     gpu::get_sync_info(input_gates),
+                                     gpu::get_sync_info(init_hidden));
+  dim3 block_dims, grid_dims;
+  get_launch_dims(hidden_size, mini_batch_size, block_dims, grid_dims);
+  hydrogen::gpu::LaunchKernel(
+    fp_recurrence_kernel<TensorDataType>,
+    grid_dims,
+    block_dims,
+    shared_memory_size<TensorDataType>(hidden_size),
+    multisync,
+    hidden_size,
+    sequence_length,
+    mini_batch_size,
+    hh_matrix.LockedBuffer(),
+    size_t(hh_matrix.LDim()),
+    ih_bias.LockedBuffer(),
+    hh_bias.LockedBuffer(),
+    input_gates.LockedBuffer(),
+    size_t(input_gates.LDim()),
+    init_hidden.LockedBuffer(),
+    size_t(init_hidden.LDim()),
+    output.Buffer(),
+    size_t(output.LDim()),
+    reserve.Buffer(),
+    size_t(reserve.LDim()));
+}
+
+template <typename TensorDataType>
+void bp_recurrence(
+  size_t sequence_length,
+  El::Matrix<TensorDataType, El::Device::GPU> const& hh_matrix,
+  El::Matrix<TensorDataType, El::Device::GPU> const& reserve,
+  El::Matrix<TensorDataType, El::Device::GPU> const& output_grad,
+  El::Matrix<TensorDataType, El::Device::GPU>& input_gates_grad,
+  El::Matrix<TensorDataType, El::Device::GPU>& hh_gates_grad,
+  El::Matrix<TensorDataType, El::Device::GPU>& init_hidden_grad)
+{
+  const size_t hidden_size = hh_matrix.Width();
+  const size_t mini_batch_size = init_hidden_grad.Width();
+  if (!is_supported<TensorDataType>(hidden_size)) {
+    LBANN_ERROR("fused GRU kernels do not support a hidden size of ",
+                hidden_size);
+  }
+  if (mini_batch_size == 0) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(input_gates_grad),
+                                     gpu::get_sync_info(hh_gates_grad),
+                                     gpu::get_sync_info(init_hidden_grad),
+                                     gpu::get_sync_info(hh_matrix),
+                                     gpu::get_sync_info(reserve),
+                                     gpu::get_sync_info(output_grad));
+  dim3 block_dims, grid_dims;
+  get_launch_dims(hidden_size, mini_batch_size, block_dims, grid_dims);
+  hydrogen::gpu::LaunchKernel(
+    bp_recurrence_kernel<TensorDataType>,
+    grid_dims,
+    block_dims,
+    shared_memory_size<TensorDataType>(hidden_size),
+    multisync,
+    hidden_size,
+    sequence_length,
+    mini_batch_size,
+    hh_matrix.LockedBuffer(),
+    size_t(hh_matrix.LDim()),
+    reserve.LockedBuffer(),
+    size_t(reserve.LDim()),
+    output_grad.LockedBuffer(),
+    size_t(output_grad.LDim()),
+    input_gates_grad.Buffer(),
+    size_t(input_gates_grad.LDim()),
+    hh_gates_grad.Buffer(),
+    size_t(hh_gates_grad.LDim()),
+    init_hidden_grad.Buffer(),
+    size_t(init_hidden_grad.LDim()));
+}
+
+#define PROTO(T)                                                               \
+  template bool is_supported<T>(size_t);                                       \
+  template void fp_recurrence<T>(size_t,                                       \
+                                 El::Matrix<T, El::Device::GPU> const&,        \
+                                 El::Matrix<T, El::Device::GPU> const&,        \
+                                 El::Matrix<T, El::Device::GPU> const&,        \
+                                 El::Matrix<T, El::Device::GPU> const&,        \
+                                 El::Matrix<T, El::Device::GPU> const&,        \
+                                 El::Matrix<T, El::Device::GPU>&,              \
+                                 El::Matrix<T, El::Device::GPU>&);             \
+  template void bp_recurrence<T>(size_t,                                       \
+                                 El::Matrix<T, El::Device::GPU> const&,        \
+                                 El::Matrix<T, El::Device::GPU> const&,        \
+                                 El::Matrix<T, El::Device::GPU> const&,        \
+                                 El::Matrix<T, El::Device::GPU>&,              \
+                                 El::Matrix<T, El::Device::GPU>&,              \
+                                 El::Matrix<T, El::Device::GPU>&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace gru_fused
+} // namespace lbann
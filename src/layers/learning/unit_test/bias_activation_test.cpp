@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/activations/relu.hpp>
+#include <lbann/layers/learning/bias_activation.hpp>
+#include <lbann/layers/learning/fully_connected.hpp>
+#include <lbann/layers/operator_layer.hpp>
+#include <lbann/operators/math/unary.hpp>
+
+#include <lbann/utils/memory.hpp>
+#include <lbann/utils/serialize.hpp>
+
+#include <memory>
+#include <sstream>
+
+// Some convenience typedefs
+
+template <typename T, lbann::data_layout L, El::Device D>
+using LayerType = lbann::fully_connected_layer<T, L, D>;
+
+template <typename T>
+using LayerTypesAllDevices =
+  h2::meta::TL<LayerType<T, lbann::data_layout::DATA_PARALLEL, El::Device::CPU>
+#ifdef LBANN_HAS_GPU
+               ,
+               LayerType<T, lbann::data_layout::DATA_PARALLEL, El::Device::GPU>
+#endif // LBANN_HAS_GPU
+               >;
+
+using AllLayerTypes = h2::meta::tlist::Append<
+#ifdef LBANN_HAS_DOUBLE
+  LayerTypesAllDevices<double>,
+#endif // LBANN_HAS_DOUBLE
+  LayerTypesAllDevices<float>>;
+
+template <typename LayerT>
+struct LayerTraits;
+
+template <typename T, lbann::data_layout L, El::Device D>
+struct LayerTraits<LayerType<T, L, D>>
+{
+  using value_type = T;
+  static constexpr El::Device device = D;
+  template <template <typename, lbann::data_layout, El::Device> class OtherT>
+  using rebind = OtherT<T, L, D>;
+  using OperatorLayerType = lbann::OperatorLayer<T, T, L, D>;
+};
+
+namespace {
+
+template <typename T>
+using CPUMatType = El::Matrix<T, El::Device::CPU>;
+
+template <typename T>
+CPUMatType<T> to_cpu(El::AbstractDistMatrix<T> const& mat)
+{
+  CPUMatType<T> local;
+  El::Copy(mat.LockedMatrix(), local);
+  return local;
+}
+
+template <typename T>
+void check_close(El::AbstractDistMatrix<T> const& mat,
+                 CPUMatType<T> const& expected)
+{
+  auto const local = to_cpu(mat);
+  REQUIRE(local.Height() == expected.Height());
+  REQUIRE(local.Width() == expected.Width());
+  for (El::Int col = 0; col < local.Width(); ++col) {
+    for (El::Int row = 0; row < local.Height(); ++row) {
+      CHECK(local(row, col) == Approx(expected(row, col)).margin(1e-5));
+    }
+  }
+}
+
+} // namespace
+
+TEMPLATE_LIST_TEST_CASE("Fused bias and activation match unfused layers",
+                        "[mpi][layer][fusion]",
+                        AllLayerTypes)
+{
+  using T = typename LayerTraits<TestType>::value_type;
+  constexpr El::Device D = LayerTraits<TestType>::device;
+  using DistMatType = El::DistMatrix<T, El::STAR, El::VC, El::ELEMENT, D>;
+  using LocalMatType = El::Matrix<T, D>;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  auto const& g = world_comm.get_trainer_grid();
+
+  El::Int const num_channels = 3;
+  El::Int const rows_per_bias = 4;
+  El::Int const height = num_channels * rows_per_bias;
+  El::Int const width = 7;
+  T const scale = El::To<T>(0.5);
+
+  // Layer output before the bias, bias and gradient w.r.t. the
+  // activation's output
+  DistMatType input(height, width, g, 0), grad_wrt_output(height, width, g, 0);
+  El::MakeUniform(input);
+  El::MakeUniform(grad_wrt_output);
+  CPUMatType<T> cpu_bias;
+  El::Uniform(cpu_bias, num_channels, 1);
+  LocalMatType bias;
+  El::Copy(cpu_bias, bias);
+
+  // Unfused bias pass
+  auto cpu_biased = to_cpu(input);
+  for (El::Int col = 0; col < cpu_biased.Width(); ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      cpu_biased(row, col) += scale * cpu_bias(row / rows_per_bias, 0);
+    }
+  }
+  DistMatType biased(height, width, g, 0);
+  El::Copy(cpu_biased, biased.Matrix());
+
+  DistMatType output(input), grad_wrt_input(height, width, g, 0);
+  std::unique_ptr<El::AbstractDistMatrix<T>> preactivations;
+
+  SECTION("ReLU")
+  {
+    // Unfused ReLU layer
+    auto cpu_output = cpu_biased;
+    auto cpu_grad_wrt_input = to_cpu(grad_wrt_output);
+    for (El::Int col = 0; col < cpu_output.Width(); ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        if (cpu_biased(row, col) <= El::To<T>(0)) {
+          cpu_output(row, col) = El::To<T>(0);
+          cpu_grad_wrt_input(row, col) = El::To<T>(0);
+        }
+      }
+    }
+
+    lbann::apply_bias_activation(&bias,
+                                 scale,
+                                 rows_per_bias,
+                                 lbann::fused_activation::RELU,
+                                 output,
+                                 preactivations);
+    CHECK(preactivations == nullptr);
+    check_close(output, cpu_output);
+
+    lbann::apply_relu_gradient(output.LockedMatrix(),
+                               grad_wrt_output.LockedMatrix(),
+                               grad_wrt_input.Matrix());
+    check_close(grad_wrt_input, cpu_grad_wrt_input);
+  }
+
+  SECTION("GELU")
+  {
+    // Unfused GELU operator
+    lbann::GeluOperator<T, D> gelu;
+    DistMatType true_output(height, width, g, 0),
+      true_grad_wrt_input(height, width, g, 0);
+    gelu.fp_compute({biased}, {true_output});
+    gelu.bp_compute({biased}, {grad_wrt_output}, {true_grad_wrt_input});
+
+    lbann::apply_bias_activation(&bias,
+                                 scale,
+                                 rows_per_bias,
+                                 lbann::fused_activation::GELU,
+                                 output,
+                                 preactivations);
+    REQUIRE(preactivations != nullptr);
+    check_close(*preactivations, cpu_biased);
+    check_close(output, to_cpu(true_output));
+
+    lbann::apply_gelu_gradient(
+      static_cast<LocalMatType const&>(preactivations->LockedMatrix()),
+      grad_wrt_output.LockedMatrix(),
+      grad_wrt_input.Matrix());
+    check_close(grad_wrt_input, to_cpu(true_grad_wrt_input));
+  }
+}
+
+TEMPLATE_LIST_TEST_CASE("Fusing activations into fully-connected layer",
+                        "[mpi][layer][fusion]",
+                        AllLayerTypes)
+{
+  using LayerType = TestType;
+  using T = typename LayerTraits<LayerType>::value_type;
+  constexpr El::Device D = LayerTraits<LayerType>::device;
+  using ReLUType =
+    typename LayerTraits<LayerType>::template rebind<lbann::relu_layer>;
+  using OperatorLayerType = typename LayerTraits<LayerType>::OperatorLayerType;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  auto const& g = world_comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  LayerType layer(16);
+  ReLUType relu(&world_comm);
+  OperatorLayerType gelu(world_comm,
+                         std::make_unique<lbann::GeluOperator<T, D>>());
+  OperatorLayerType cosine(world_comm,
+                           std::make_unique<lbann::CosOperator<T, D>>());
+
+  SECTION("Fusable activations")
+  {
+    CHECK(lbann::get_fusable_activation<T, D>(relu) ==
+          lbann::fused_activation::RELU);
+    CHECK(lbann::get_fusable_activation<T, D>(gelu) ==
+          lbann::fused_activation::GELU);
+    CHECK(lbann::get_fusable_activation<T, D>(cosine) ==
+          lbann::fused_activation::NONE);
+  }
+  SECTION("ReLU keeps the output for backprop")
+  {
+    REQUIRE(layer.fuse_child(relu));
+    CHECK_FALSE(layer.fuse_child(gelu));
+    CHECK(layer.get_fused_activation() == lbann::fused_activation::RELU);
+    CHECK(layer.get_backprop_requirements() & lbann::ACTIVATIONS);
+  }
+  SECTION("GELU keeps its own input for backprop")
+  {
+    REQUIRE(layer.fuse_child(gelu));
+    CHECK(layer.get_fused_activation() == lbann::fused_activation::GELU);
+    CHECK_FALSE(layer.get_backprop_requirements() & lbann::ACTIVATIONS);
+  }
+  SECTION("Other operators are not fused")
+  {
+    CHECK_FALSE(layer.fuse_child(cosine));
+  }
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  SECTION("Fused activation is serialized")
+  {
+    REQUIRE(layer.fuse_child(gelu));
+    LayerType tgt_layer(8);
+    std::stringstream ss;
+    {
+      cereal::BinaryOutputArchive oarchive(ss);
+      REQUIRE_NOTHROW(oarchive(layer));
+    }
+    {
+      cereal::BinaryInputArchive iarchive(ss);
+      REQUIRE_NOTHROW(iarchive(tgt_layer));
+    }
+    CHECK(tgt_layer.get_fused_activation() == lbann::fused_activation::GELU);
+  }
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+}
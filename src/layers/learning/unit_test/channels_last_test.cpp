@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::add_weights;
+using unit_test::utilities::check_close;
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::run_training_step;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+// Channels-first input dims are (channels, height, width)
+constexpr int input_channels = 2;
+constexpr int height = 4;
+constexpr int width = 6;
+constexpr int output_channels = 3;
+constexpr int kernel_size = 3;
+
+/** @brief Reorder a (outer, channels, spatial) tensor to
+ *  (outer, spatial, channels).
+ */
+std::vector<float> to_channels_last(std::vector<float> const& values,
+                                    int num_channels)
+{
+  const int spatial_size = values.size() / num_channels;
+  std::vector<float> result(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    const int inner = i % (num_channels * spatial_size);
+    const int outer = i - inner;
+    const int c = inner / spatial_size;
+    const int s = inner % spatial_size;
+    result[outer + s * num_channels + c] = values[i];
+  }
+  return result;
+}
+
+/** Channels-first input values */
+std::vector<float> input_values()
+{
+  std::vector<float> values;
+  const int size = input_channels * height * width;
+  for (int i = 0; i < size; ++i) {
+    values.push_back(static_cast<float>((i * 17) % size) / size - 0.5f);
+  }
+  return values;
+}
+
+/** Channels-first kernel values, (out channels, in channels, h, w) */
+std::vector<float> kernel_values()
+{
+  std::vector<float> values;
+  const int size =
+    output_channels * input_channels * kernel_size * kernel_size;
+  for (int i = 0; i < size; ++i) {
+    values.push_back(0.1f * static_cast<float>((i * 5) % 13 - 6));
+  }
+  return values;
+}
+
+/** Convolution, batch normalization and max pooling */
+std::string make_prototext(bool channels_last)
+{
+  const auto flag = (channels_last ? "true" : "false");
+  std::ostringstream ss;
+  ss << "model {\n"
+     << "  layer {\n"
+     << "    name: \"inp\"\n"
+     << "    children: \"conv\"\n"
+     << "    weights: \"inputs\"\n"
+     << "    weights_layer {\n";
+  if (channels_last) {
+    ss << "      dims: " << height << " dims: " << width
+       << " dims: " << input_channels << "\n";
+  }
+  else {
+    ss << "      dims: " << input_channels << " dims: " << height
+       << " dims: " << width << "\n";
+  }
+  ss << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"conv\"\n"
+     << "    parents: \"inp\"\n"
+     << "    children: \"bn\"\n"
+     << "    weights: \"kernel\"\n"
+     << "    convolution {\n"
+     << "      num_dims: 2\n"
+     << "      out_channels: " << output_channels << "\n"
+     << "      kernel_size: " << kernel_size << "\n"
+     << "      padding: 1\n"
+     << "      stride: 1\n"
+     << "      dilation: 1\n"
+     << "      groups { value: 1 }\n"
+     << "      has_bias { value: false }\n"
+     << "      channels_last: " << flag << "\n"
+     << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"bn\"\n"
+     << "    parents: \"conv\"\n"
+     << "    children: \"pool\"\n"
+     << "    batch_normalization {\n"
+     << "      decay: 0.9\n"
+     << "      epsilon: 1e-5\n"
+     << "      channels_last: " << flag << "\n"
+     << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"pool\"\n"
+     << "    parents: \"bn\"\n"
+     << "    children: \"out\"\n"
+     << "    pooling {\n"
+     << "      pool_mode: \"max\"\n"
+     << "      num_dims: 2\n"
+     << "      pool_dims_i: 2\n"
+     << "      pool_pads_i: 0\n"
+     << "      pool_strides_i: 2\n"
+     << "      channels_last: " << flag << "\n"
+     << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"out\"\n"
+     << "    parents: \"pool\"\n"
+     << "    dummy {\n"
+     << "    }\n"
+     << "  }\n";
+  // Channels-last kernels are stored as (out channels, h, w, in
+  // channels)
+  if (channels_last) {
+    add_weights(ss, "inputs", to_channels_last(input_values(),
+                                               input_channels));
+    add_weights(ss, "kernel", to_channels_last(kernel_values(),
+                                               input_channels));
+  }
+  else {
+    add_weights(ss, "inputs", input_values());
+    add_weights(ss, "kernel", kernel_values());
+  }
+  ss << "}\n"
+     << "optimizer {\n"
+     << "  sgd {\n"
+     << "    learn_rate: 1.0\n"
+     << "  }\n"
+     << "}\n";
+  return ss.str();
+}
+
+struct cnn_result
+{
+  std::vector<float> output;
+  std::vector<float> inputs;
+  std::vector<float> kernel;
+};
+
+/** @brief One training step
+ *  @details Results are in the layout of the model.
+ */
+cnn_result train_step(bool channels_last)
+{
+  using data_type_layer = lbann::data_type_layer<float>;
+
+  auto m = construct_model(make_prototext(channels_last));
+  setup_model(*m);
+  auto& out = find_layer(*m, "out");
+  auto const& pool =
+    dynamic_cast<data_type_layer const&>(out.get_parent_layer());
+
+  // Error signal is defined in channels-first order
+  const int output_size = pool.get_output_size();
+  std::vector<float> signal_values;
+  for (int i = 0; i < output_size; ++i) {
+    signal_values.push_back(0.5f - 0.125f * static_cast<float>(i % 9));
+  }
+  if (channels_last) {
+    signal_values = to_channels_last(signal_values, output_channels);
+  }
+  set_error_signal<El::Device::GPU>(out, signal_values);
+  run_training_step(*m);
+
+  cnn_result result;
+  result.output = to_vector(pool.get_activations());
+  for (auto* w : m->get_weights()) {
+    auto& dtw = dynamic_cast<lbann::data_type_weights<float>&>(*w);
+    if (w->get_name() == "inputs") {
+      result.inputs = to_vector(dtw.get_values());
+    }
+    if (w->get_name() == "kernel") {
+      result.kernel = to_vector(dtw.get_values());
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("Channels-last CNN layers match channels-first layers",
+          "[mpi][layer][channels_last]")
+{
+  auto const expected = train_step(false);
+  auto const result = train_step(true);
+
+  SECTION("Output")
+  {
+    check_close(result.output,
+                to_channels_last(expected.output, output_channels));
+  }
+  // Plain SGD with unit learning rate, so the updated values differ
+  // by the gradients
+  SECTION("Updated inputs")
+  {
+    check_close(result.inputs,
+                to_channels_last(expected.inputs, input_channels));
+  }
+  SECTION("Updated kernel")
+  {
+    check_close(result.kernel,
+                to_channels_last(expected.kernel, input_channels));
+  }
+}
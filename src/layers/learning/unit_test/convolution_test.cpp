@@ -31,11 +31,19 @@
 
 #include <lbann/base.hpp>
 #include <lbann/layers/learning/convolution.hpp>
+#include <lbann/layers/transform/dummy.hpp>
+#include <lbann/layers/transform/upsample.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/proto/factories.hpp>
 
 #include <h2/patterns/multimethods/SwitchDispatcher.hpp>
+#include <lbann/utils/lbann_library.hpp>
 #include <lbann/utils/memory.hpp>
 #include <lbann/utils/serialize.hpp>
 
+#include "lbann/proto/lbann.pb.h"
+#include <google/protobuf/text_format.h>
+
 // Some convenience typedefs
 
 template <typename T, lbann::data_layout L, El::Device D>
@@ -60,6 +68,16 @@ using AllLayerTypes = h2::meta::tlist::Append<
 #endif // LBANN_HAS_DOUBLE
   LayerTypesAllDevices<float>>;
 
+template <typename LayerT>
+struct LayerTraits;
+
+template <typename T, lbann::data_layout L, El::Device D>
+struct LayerTraits<LayerType<T, L, D>>
+{
+  template <template <typename, lbann::data_layout, El::Device> class OtherT>
+  using rebind = OtherT<T, L, D>;
+};
+
 using unit_test::utilities::IsValidPtr;
 TEMPLATE_LIST_TEST_CASE("Serializing convolution layer",
                         "[mpi][layer][serialize]",
@@ -161,3 +179,221 @@ TEMPLATE_LIST_TEST_CASE("Serializing convolution layer",
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
 }
+
+TEMPLATE_LIST_TEST_CASE("Fusing upsample into convolution layer",
+                        "[mpi][layer][fusion]",
+                        AllLayerTypes)
+{
+  using LayerType = TestType;
+  using UpsampleType =
+    typename LayerTraits<LayerType>::template rebind<lbann::upsample_layer>;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+
+  UpsampleType upsample(&world_comm, 2, 2, lbann::upsample_mode::NEAREST);
+
+  SECTION("Upsample parent is fused once")
+  {
+    LayerType layer(2, 4, {3, 3}, {1, 1}, {1, 1}, {1, 1}, 1, true);
+    REQUIRE(layer.fuse_parent(upsample));
+    CHECK_FALSE(layer.fuse_parent(upsample));
+    LayerType copy(layer);
+    CHECK_FALSE(copy.fuse_parent(upsample));
+  }
+  SECTION("Strided convolution is not fused")
+  {
+    LayerType layer(2, 4, {3, 3}, {1, 1}, {2, 2}, {1, 1}, 1, true);
+    CHECK_FALSE(layer.fuse_parent(upsample));
+  }
+  SECTION("Pads as large as the kernel are not fused")
+  {
+    LayerType layer(2, 4, {3, 3}, {3, 3}, {1, 1}, {1, 1}, 1, true);
+    CHECK_FALSE(layer.fuse_parent(upsample));
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+namespace {
+
+// Nearest-neighbor upsample followed by a 3x3 convolution
+const std::string upsample_conv_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "upsample"
+    weights: "inputs"
+    weights_layer {
+      dims: 1
+      dims: 3
+      dims: 3
+    }
+  }
+  layer {
+    name: "upsample"
+    parents: "inp"
+    children: "conv"
+    upsample {
+      upsample_mode: "nearest"
+      num_dims: 2
+      has_vectors: true
+      scale_factors: 2
+      scale_factors: 2
+    }
+  }
+  layer {
+    name: "conv"
+    parents: "upsample"
+    children: "out"
+    weights: "kernel bias"
+    convolution {
+      num_dims: 2
+      out_channels: 2
+      kernel_size: 3
+      padding: 1
+      stride: 1
+      dilation: 1
+      groups {
+        value: 1
+      }
+      has_bias {
+        value: true
+      }
+    }
+  }
+  layer {
+    name: "out"
+    parents: "conv"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 0.4
+        values: 2.1
+        values: -0.3
+        values: 0.8
+        values: -0.6
+        values: 1.5
+        values: 0.2
+        values: -0.9
+      }
+    }
+  }
+  weights {
+    name: "kernel"
+    initializer {
+      value_initializer {
+        values: 0.5
+        values: -0.25
+        values: 0.75
+        values: 0.1
+        values: -0.6
+        values: 0.3
+        values: 0.2
+        values: 0.4
+        values: -0.8
+        values: -0.1
+        values: 0.05
+        values: 0.6
+        values: 0.35
+        values: -0.45
+        values: 0.15
+        values: -0.2
+        values: 0.9
+        values: -0.7
+      }
+    }
+  }
+  weights {
+    name: "bias"
+    initializer {
+      value_initializer {
+        values: 0.1
+        values: -0.2
+      }
+    }
+  }
+}
+)""";
+
+/** Convolution output and input gradient with or without fusion */
+std::pair<std::vector<float>, std::vector<float>> run_upsample_conv(bool fuse)
+{
+  using DummyType = lbann::
+    dummy_layer<float, lbann::data_layout::DATA_PARALLEL, El::Device::GPU>;
+  using MatrixType =
+    El::DistMatrix<float, El::STAR, El::STAR, El::ELEMENT, El::Device::GPU>;
+  using DataTypeLayer = lbann::data_type_layer<float>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+  lbann_data::LbannPB my_proto;
+  REQUIRE(google::protobuf::TextFormat::ParseFromString(upsample_conv_prototext,
+                                                        &my_proto));
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  auto m = lbann::proto::construct_model(&comm,
+                                         my_proto.optimizer(),
+                                         my_proto.trainer(),
+                                         my_proto.model());
+  m->set_layer_fusion(fuse);
+  m->setup(1UL, {&g});
+  CHECK(m->get_num_layers() == (fuse ? 3 : 4));
+
+  DummyType* out = nullptr;
+  for (auto* l : m->get_layers()) {
+    l->set_keep_error_signals(true);
+    if (l->get_name() == "out") {
+      out = dynamic_cast<DummyType*>(l);
+    }
+  }
+  REQUIRE(out != nullptr);
+  auto const& conv =
+    dynamic_cast<DataTypeLayer const&>(out->get_parent_layer());
+  auto const& inp = m->get_layer(0);
+  REQUIRE(inp.get_name() == "inp");
+  auto const& consumer =
+    dynamic_cast<DataTypeLayer const&>(inp.get_child_layer());
+  auto error_signal =
+    std::make_unique<MatrixType>(conv.get_output_size(), 1, g);
+  for (El::Int i = 0; i < error_signal->Height(); ++i) {
+    error_signal->Set(i, 0, 0.5f - 0.125f * static_cast<float>(i % 9));
+  }
+  out->set_error_signal(std::move(error_signal));
+
+  REQUIRE_NOTHROW(m->forward_prop(lbann::execution_mode::training));
+  REQUIRE_NOTHROW(m->backward_prop(false));
+  std::vector<float> output, grad;
+  auto const& activations = conv.get_activations();
+  for (El::Int i = 0; i < activations.Height(); ++i) {
+    output.push_back(activations.Get(i, 0));
+  }
+  auto const& signals = consumer.get_error_signals(inp);
+  for (El::Int i = 0; i < signals.Height(); ++i) {
+    grad.push_back(signals.Get(i, 0));
+  }
+  return {output, grad};
+}
+
+} // namespace
+
+TEST_CASE("Fused upsample and convolution match the unfused layers",
+          "[mpi][layer][fusion]")
+{
+  auto const [expected_output, expected_grad] = run_upsample_conv(false);
+  auto const [output, grad] = run_upsample_conv(true);
+  REQUIRE(expected_output.size() == 2 * 6 * 6);
+  REQUIRE(output.size() == expected_output.size());
+  for (size_t i = 0; i < output.size(); ++i) {
+    CHECK(output[i] == Approx(expected_output[i]));
+  }
+  REQUIRE(expected_grad.size() == 3 * 3);
+  REQUIRE(grad.size() == expected_grad.size());
+  for (size_t i = 0; i < grad.size(); ++i) {
+    CHECK(grad[i] == Approx(expected_grad[i]));
+  }
+}
+#endif // LBANN_HAS_GPU
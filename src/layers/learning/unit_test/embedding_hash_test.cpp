@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/layers/learning/embedding_hash.hpp"
+#include "lbann/utils/hash.hpp"
+
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("Embedding hashing trick", "[layer][embedding]")
+{
+  using lbann::embedding_hash::get_row;
+
+  SECTION("Rows are in range and match the SplitMix64 finalizer")
+  {
+    constexpr int64_t num_embeddings = 10;
+    for (int64_t id = -50; id <= 50; ++id) {
+      const auto row = get_row(id, num_embeddings);
+      CHECK(row >= 0);
+      CHECK(row < num_embeddings);
+      const auto bits = lbann::splitmix64(static_cast<uint64_t>(id));
+      CHECK(row == static_cast<int64_t>(bits % num_embeddings));
+    }
+    CHECK(get_row(0, num_embeddings) == 0);
+    CHECK(get_row(1, num_embeddings) == 9);
+    CHECK(get_row(-1, num_embeddings) == 7);
+  }
+
+  SECTION("Consecutive IDs are spread over the rows")
+  {
+    constexpr int64_t num_embeddings = 16;
+    constexpr int64_t num_ids = 16000;
+    std::vector<int64_t> counts(num_embeddings, 0);
+    for (int64_t id = 0; id < num_ids; ++id) {
+      ++counts[get_row(id, num_embeddings)];
+    }
+    const int64_t expected = num_ids / num_embeddings;
+    for (const auto count : counts) {
+      CHECK(count > expected * 8 / 10);
+      CHECK(count < expected * 12 / 10);
+    }
+  }
+}
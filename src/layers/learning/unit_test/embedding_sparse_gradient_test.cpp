@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/optimizers/sparse_gradient.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::add_weights;
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::run_training_step;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+constexpr int num_embeddings = 6;
+constexpr int embedding_dim = 3;
+
+// Looked-up embedding vectors, with a repeat; 1, 3 and 4 are never used
+const std::vector<int> indices = {0, 2, 2, 5};
+
+float initial_value(int i) { return 0.1f * static_cast<float>(i % 7) - 0.3f; }
+
+/** Embedding layer fed by fixed indices */
+std::string make_prototext(bool sparse, std::string const& optimizer)
+{
+  std::ostringstream ss;
+  ss << "model {\n"
+     << "  layer {\n"
+     << "    name: \"idx\"\n"
+     << "    children: \"emb\"\n"
+     << "    weights: \"indices\"\n"
+     << "    weights_layer {\n"
+     << "      dims: " << indices.size() << "\n"
+     << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"emb\"\n"
+     << "    parents: \"idx\"\n"
+     << "    children: \"out\"\n"
+     << "    weights: \"table\"\n"
+     << "    embedding {\n"
+     << "      num_embeddings: " << num_embeddings << "\n"
+     << "      embedding_dim: " << embedding_dim << "\n"
+     << "      sparse_gradient: " << (sparse ? "true" : "false") << "\n"
+     << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"out\"\n"
+     << "    parents: \"emb\"\n"
+     << "    dummy {\n"
+     << "    }\n"
+     << "  }\n"
+     << "  weights {\n"
+     << "    name: \"indices\"\n"
+     << "    optimizer {\n"
+     << "      no_optimizer {\n"
+     << "      }\n"
+     << "    }\n"
+     << "    initializer {\n"
+     << "      value_initializer {\n";
+  for (auto i : indices) {
+    ss << "        values: " << i << "\n";
+  }
+  ss << "      }\n"
+     << "    }\n"
+     << "  }\n";
+  std::vector<float> table;
+  for (int i = 0; i < num_embeddings * embedding_dim; ++i) {
+    table.push_back(initial_value(i));
+  }
+  add_weights(ss, "table", table);
+  ss << "}\n"
+     << optimizer;
+  return ss.str();
+}
+
+/** Embedding table, column by column, after a few steps */
+std::vector<float> train_steps(bool sparse, std::string const& optimizer)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif
+  auto m = construct_model(make_prototext(sparse, optimizer));
+  setup_model(*m);
+  lbann::data_type_weights<float>* table = nullptr;
+  for (auto* w : m->get_weights()) {
+    if (w->get_name() == "table") {
+      table = dynamic_cast<lbann::data_type_weights<float>*>(w);
+    }
+  }
+  REQUIRE(table != nullptr);
+
+  auto& out = find_layer(*m, "out");
+  const int output_size = indices.size() * embedding_dim;
+  for (int step = 0; step < 3; ++step) {
+    std::vector<float> error_signal;
+    for (int i = 0; i < output_size; ++i) {
+      error_signal.push_back(0.1f * static_cast<float>((i + step) % 4) - 0.1f);
+    }
+    set_error_signal<Dev>(out, error_signal);
+    run_training_step(*m);
+  }
+  return to_vector(table->get_values());
+}
+
+void check_same_results(std::string const& optimizer)
+{
+  auto const dense = train_steps(false, optimizer);
+  auto const sparse = train_steps(true, optimizer);
+  REQUIRE(dense.size() == num_embeddings * embedding_dim);
+  REQUIRE(sparse.size() == dense.size());
+  for (size_t i = 0; i < dense.size(); ++i) {
+    CHECK(sparse[i] == Approx(dense[i]));
+  }
+
+  // Embedding vectors that were never looked up keep their values
+  for (int col : {1, 3, 4}) {
+    for (int row = 0; row < embedding_dim; ++row) {
+      const int i = row + col * embedding_dim;
+      CHECK(sparse[i] == Approx(initial_value(i)));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Sparse embedding gradients", "[mpi][layer][embedding]")
+{
+  // The same vectors are looked up at every step, so the lazy sparse
+  // state updates agree with the dense ones
+  SECTION("SGD with momentum")
+  {
+    check_same_results(R"""(
+optimizer {
+  sgd {
+    learn_rate: 0.1
+    momentum: 0.9
+  }
+}
+)""");
+  }
+  SECTION("Adam")
+  {
+    check_same_results(R"""(
+optimizer {
+  adam {
+    learn_rate: 0.1
+    beta1: 0.9
+    beta2: 0.99
+    eps: 1e-8
+  }
+}
+)""");
+  }
+}
+
+TEST_CASE("Coalescing sparse gradient columns", "[optimizer][embedding]")
+{
+  std::vector<El::Int> rows, positions;
+  lbann::sparse_gradient::coalesce({5, -1, 2, 5, 0, 2}, rows, positions);
+  CHECK(rows == std::vector<El::Int>{0, 2, 5});
+  CHECK(positions == std::vector<El::Int>{2, -1, 1, 2, 0, 1});
+}
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/learning/gru.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::add_weights;
+using unit_test::utilities::check_close;
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::run_training_step;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+constexpr int sequence_length = 5;
+constexpr int input_size = 3;
+constexpr int hidden_size = 4;
+
+std::vector<float> make_values(int size, int seed)
+{
+  std::vector<float> values;
+  for (int i = 0; i < size; ++i) {
+    const int k = (7 * i + seed) % 11;
+    values.push_back(0.1f * static_cast<float>(k - 5));
+  }
+  return values;
+}
+
+/** GRU with fixed weights, input sequence and initial hidden state */
+std::string make_prototext()
+{
+  std::ostringstream ss;
+  ss << R"""(
+model {
+  layer {
+    name: "x"
+    children: "gru"
+    weights: "x_values"
+    weights_layer {
+      dims: 5
+      dims: 3
+    }
+  }
+  layer {
+    name: "h0"
+    children: "gru"
+    weights: "h0_values"
+    weights_layer {
+      dims: 1
+      dims: 4
+    }
+  }
+  layer {
+    name: "gru"
+    parents: "x h0"
+    children: "out"
+    weights: "ih_matrix hh_matrix ih_bias hh_bias"
+    gru {
+      hidden_size: 4
+    }
+  }
+  layer {
+    name: "out"
+    parents: "gru"
+    dummy {
+    }
+  }
+)""";
+  add_weights(ss, "x_values", make_values(sequence_length * input_size, 1));
+  add_weights(ss, "h0_values", make_values(hidden_size, 2));
+  add_weights(ss, "ih_matrix", make_values(3 * hidden_size * input_size, 3));
+  add_weights(ss, "hh_matrix", make_values(3 * hidden_size * hidden_size, 4));
+  add_weights(ss, "ih_bias", make_values(3 * hidden_size, 5));
+  add_weights(ss, "hh_bias", make_values(3 * hidden_size, 6));
+  ss << "}\n"
+     << "optimizer {\n"
+     << "  sgd {\n"
+     << "    learn_rate: 1.0\n"
+     << "  }\n"
+     << "}\n";
+  return ss.str();
+}
+
+struct gru_result
+{
+  bool fused;
+  std::vector<float> output;
+  /** Weights values after one SGD step, by name */
+  std::map<std::string, std::vector<float>> weights;
+};
+
+/** One training step with or without the fused kernels */
+gru_result train_step(bool fused)
+{
+  constexpr auto Dev = El::Device::GPU;
+  using gru_type =
+    lbann::gru_layer<float, lbann::data_layout::DATA_PARALLEL, Dev>;
+
+  auto m = construct_model(make_prototext());
+  auto& gru = find_layer<gru_type>(*m, "gru");
+  gru.set_fused_kernels_enabled(fused);
+  setup_model(*m);
+
+  std::vector<float> error_signal;
+  for (int i = 0; i < sequence_length * hidden_size; ++i) {
+    error_signal.push_back(0.5f - 0.05f * static_cast<float>(i));
+  }
+  set_error_signal<Dev>(find_layer(*m, "out"), error_signal);
+  run_training_step(*m);
+
+  gru_result result;
+  result.fused = gru.uses_fused_kernels();
+  result.output = to_vector(gru.get_activations());
+  for (auto* w : m->get_weights()) {
+    auto& dtw = dynamic_cast<lbann::data_type_weights<float>&>(*w);
+    result.weights[w->get_name()] = to_vector(dtw.get_values());
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("Fused GRU kernels match cuDNN", "[mpi][layer][gru]")
+{
+  auto const expected = train_step(false);
+  auto const fused = train_step(true);
+  CHECK_FALSE(expected.fused);
+  CHECK(fused.fused);
+
+  check_close(fused.output, expected.output);
+
+  // Plain SGD with unit learning rate, so the weights (including the
+  // input sequence and initial hidden state) differ by the gradients
+  REQUIRE(fused.weights.size() == expected.weights.size());
+  for (auto const& [name, values] : expected.weights) {
+    INFO("Weights = " << name);
+    REQUIRE(fused.weights.count(name) == 1);
+    check_close(fused.weights.at(name), values);
+  }
+}
@@ -0,0 +1,258 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::add_weights;
+using unit_test::utilities::check_close;
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::run_training_step;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+/** 2D convolution geometry. Input dims are (channels, height, width). */
+struct conv_config
+{
+  int in_channels;
+  int height;
+  int width;
+  int out_channels;
+  int kernel_size;
+  int pad;
+  int stride;
+  int dilation;
+  int groups;
+
+  int output_height() const { return output_dim(height); }
+  int output_width() const { return output_dim(width); }
+  int output_dim(int dim) const
+  {
+    const int extent = dilation * (kernel_size - 1) + 1;
+    return (dim + 2 * pad - extent) / stride + 1;
+  }
+  int input_size() const { return in_channels * height * width; }
+  int output_size() const
+  {
+    return out_channels * output_height() * output_width();
+  }
+  int kernel_entries() const
+  {
+    return out_channels * (in_channels / groups) * kernel_size * kernel_size;
+  }
+};
+
+std::vector<float> make_values(int size, int seed)
+{
+  std::vector<float> values;
+  for (int i = 0; i < size; ++i) {
+    values.push_back(0.1f * static_cast<float>((i * 7 + seed) % 17 - 8));
+  }
+  return values;
+}
+
+/** CPU convolution between a weights layer and a dummy layer */
+std::string make_prototext(conv_config const& config,
+                           std::vector<float> const& input,
+                           std::vector<float> const& kernel)
+{
+  std::ostringstream ss;
+  ss << "model {\n"
+     << "  layer {\n"
+     << "    name: \"inp\"\n"
+     << "    children: \"conv\"\n"
+     << "    weights: \"inputs\"\n"
+     << "    device_allocation: \"cpu\"\n"
+     << "    weights_layer {\n"
+     << "      dims: " << config.in_channels << "\n"
+     << "      dims: " << config.height << "\n"
+     << "      dims: " << config.width << "\n"
+     << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"conv\"\n"
+     << "    parents: \"inp\"\n"
+     << "    children: \"out\"\n"
+     << "    weights: \"kernel\"\n"
+     << "    device_allocation: \"cpu\"\n"
+     << "    convolution {\n"
+     << "      num_dims: 2\n"
+     << "      out_channels: " << config.out_channels << "\n"
+     << "      kernel_size: " << config.kernel_size << "\n"
+     << "      padding: " << config.pad << "\n"
+     << "      stride: " << config.stride << "\n"
+     << "      dilation: " << config.dilation << "\n"
+     << "      groups { value: " << config.groups << " }\n"
+     << "      has_bias { value: false }\n"
+     << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"out\"\n"
+     << "    parents: \"conv\"\n"
+     << "    device_allocation: \"cpu\"\n"
+     << "    dummy {\n"
+     << "    }\n"
+     << "  }\n";
+  add_weights(ss, "inputs", input);
+  add_weights(ss, "kernel", kernel);
+  ss << "}\n"
+     << "optimizer {\n"
+     << "  sgd {\n"
+     << "    learn_rate: 1.0\n"
+     << "  }\n"
+     << "}\n";
+  return ss.str();
+}
+
+struct conv_result
+{
+  std::vector<float> output;
+  std::vector<float> input_grad;
+  std::vector<float> kernel_grad;
+};
+
+/** @brief Direct convolution
+ *  @details Kernel is (out channels, in channels / groups, h, w).
+ */
+conv_result reference_convolution(conv_config const& config,
+                                  std::vector<float> const& input,
+                                  std::vector<float> const& kernel,
+                                  std::vector<float> const& error_signal)
+{
+  const int out_h = config.output_height();
+  const int out_w = config.output_width();
+  const int k = config.kernel_size;
+  const int group_in = config.in_channels / config.groups;
+  const int group_out = config.out_channels / config.groups;
+  conv_result result;
+  result.output.assign(config.output_size(), 0.f);
+  result.input_grad.assign(input.size(), 0.f);
+  result.kernel_grad.assign(kernel.size(), 0.f);
+  for (int o = 0; o < config.out_channels; ++o) {
+    const int group = o / group_out;
+    for (int y = 0; y < out_h; ++y) {
+      for (int x = 0; x < out_w; ++x) {
+        const int out_index = (o * out_h + y) * out_w + x;
+        for (int c = 0; c < group_in; ++c) {
+          const int in_c = group * group_in + c;
+          for (int ky = 0; ky < k; ++ky) {
+            const int iy =
+              y * config.stride - config.pad + ky * config.dilation;
+            for (int kx = 0; kx < k; ++kx) {
+              const int ix =
+                x * config.stride - config.pad + kx * config.dilation;
+              if (iy < 0 || iy >= config.height || ix < 0 ||
+                  ix >= config.width) {
+                continue;
+              }
+              const int in_index =
+                (in_c * config.height + iy) * config.width + ix;
+              const int kernel_index = ((o * group_in + c) * k + ky) * k + kx;
+              result.output[out_index] +=
+                kernel[kernel_index] * input[in_index];
+              result.input_grad[in_index] +=
+                kernel[kernel_index] * error_signal[out_index];
+              result.kernel_grad[kernel_index] +=
+                input[in_index] * error_signal[out_index];
+            }
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+/** Compare one CPU training step against direct convolution */
+void check_convolution(conv_config const& config)
+{
+  using data_type_layer = lbann::data_type_layer<float>;
+
+  const auto input = make_values(config.input_size(), 1);
+  const auto kernel = make_values(config.kernel_entries(), 4);
+  const auto error_signal = make_values(config.output_size(), 9);
+  const auto expected =
+    reference_convolution(config, input, kernel, error_signal);
+
+  auto m = construct_model(make_prototext(config, input, kernel));
+  setup_model(*m);
+  auto& out = find_layer(*m, "out");
+  auto const& conv =
+    dynamic_cast<data_type_layer const&>(out.get_parent_layer());
+  REQUIRE(conv.get_output_size() == config.output_size());
+  set_error_signal<El::Device::CPU>(out, error_signal);
+  run_training_step(*m);
+  check_close(to_vector(conv.get_activations()), expected.output);
+
+  // Plain SGD with unit learning rate subtracts the gradients
+  for (auto* w : m->get_weights()) {
+    INFO("Weights = " << w->get_name());
+    auto& dtw = dynamic_cast<lbann::data_type_weights<float>&>(*w);
+    const auto values = to_vector(dtw.get_values());
+    const bool is_input = (w->get_name() == "inputs");
+    const auto& initial = (is_input ? input : kernel);
+    const auto& grad =
+      (is_input ? expected.input_grad : expected.kernel_grad);
+    REQUIRE(values.size() == initial.size());
+    std::vector<float> computed_grad;
+    for (size_t i = 0; i < values.size(); ++i) {
+      computed_grad.push_back(initial[i] - values[i]);
+    }
+    check_close(computed_grad, grad);
+  }
+}
+
+} // namespace
+
+TEST_CASE("oneDNN CPU convolution matches direct convolution",
+          "[mpi][layer][convolution]")
+{
+  SECTION("Padded convolution")
+  {
+    check_convolution({3, 7, 7, 2, 3, 1, 1, 1, 1});
+  }
+  SECTION("Strided convolution")
+  {
+    check_convolution({3, 7, 8, 4, 3, 1, 2, 1, 1});
+  }
+  // The im2col path ignores these, so they exercise oneDNN alone
+  SECTION("Dilated grouped convolution")
+  {
+    check_convolution({4, 6, 7, 4, 3, 2, 1, 2, 2});
+  }
+}
@@ -36,7 +36,8 @@ void cross_entropy_layer<TensorDataType, Layout, Device>::serialize(
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
-     CEREAL_NVP(m_use_labels));
+     CEREAL_NVP(m_use_labels),
+     CEREAL_NVP(m_from_logits));
 }
 
 } // namespace lbann
@@ -116,6 +116,90 @@ void local_bp_cpu(
   }
 }
 
+template <typename TensorDataType>
+void local_fp_logits_cpu(
+  const El::AbstractMatrix<TensorDataType>& local_logits,
+  const El::AbstractMatrix<TensorDataType>& local_ground_truth,
+  El::AbstractMatrix<TensorDataType>& local_contribution,
+  El::AbstractMatrix<TensorDataType>& local_statistics,
+  const El::Int& softmax_size)
+{
+
+  // Useful constants
+  const TensorDataType zero = El::TypeTraits<TensorDataType>::Zero();
+  const TensorDataType one = El::TypeTraits<TensorDataType>::One();
+  const El::Int local_width = local_logits.Width();
+  const El::Int num_softmaxes = local_logits.Height() / softmax_size;
+
+  // Compute local contribution to cross entropy
+  //   CE = sum_softmaxes ( log-sum-exp(x) * sum(xhat) - sum(xhat * x) )
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    TensorDataType sum = zero;
+    for (El::Int softmax = 0; softmax < num_softmaxes; ++softmax) {
+
+      // Online log-sum-exp and ground truth sums in a single pass
+      const El::Int offset = softmax * softmax_size;
+      TensorDataType max_x = local_logits(offset, col);
+      TensorDataType sum_exp = zero;
+      TensorDataType sum_xhat = zero;
+      TensorDataType sum_xhat_x = zero;
+      for (El::Int i = 0; i < softmax_size; ++i) {
+        const auto& x = local_logits(offset + i, col);
+        const auto& xhat = local_ground_truth(offset + i, col);
+        if (x > max_x) {
+          sum_exp = sum_exp * std::exp(max_x - x) + one;
+          max_x = x;
+        }
+        else {
+          sum_exp += std::exp(x - max_x);
+        }
+        sum_xhat += xhat;
+        sum_xhat_x += xhat * x;
+      }
+      const auto log_sum_exp = max_x + std::log(sum_exp);
+      local_statistics(2 * softmax, col) = log_sum_exp;
+      local_statistics(2 * softmax + 1, col) = sum_xhat;
+      sum += log_sum_exp * sum_xhat - sum_xhat_x;
+    }
+    local_contribution(0, col) = sum;
+  }
+}
+
+template <typename TensorDataType>
+void local_bp_logits_cpu(
+  const El::AbstractMatrix<TensorDataType>& local_logits,
+  const El::AbstractMatrix<TensorDataType>& local_ground_truth,
+  const El::AbstractMatrix<TensorDataType>& local_statistics,
+  const El::AbstractMatrix<TensorDataType>& local_gradient_wrt_output,
+  El::AbstractMatrix<TensorDataType>& local_gradient_wrt_logits,
+  El::AbstractMatrix<TensorDataType>& local_gradient_wrt_ground_truth,
+  const El::Int& softmax_size)
+{
+
+  // Useful constants
+  const El::Int local_height = local_logits.Height();
+  const El::Int local_width = local_logits.Width();
+
+  // Compute gradients
+  //   dL/dx = dL/dy * ( softmax(x) * sum(xhat) - xhat )
+  //   dL/dxhat = dL/dy * ( log-sum-exp(x) - x )
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < local_width; ++col) {
+    for (El::Int row = 0; row < local_height; ++row) {
+      const auto softmax = row / softmax_size;
+      const auto& log_sum_exp = local_statistics(2 * softmax, col);
+      const auto& sum_xhat = local_statistics(2 * softmax + 1, col);
+      const auto& dy = local_gradient_wrt_output(0, col);
+      const auto& x = local_logits(row, col);
+      const auto& xhat = local_ground_truth(row, col);
+      local_gradient_wrt_logits(row, col) =
+        dy * (std::exp(x - log_sum_exp) * sum_xhat - xhat);
+      local_gradient_wrt_ground_truth(row, col) = dy * (log_sum_exp - x);
+    }
+  }
+}
+
 } // namespace
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -128,6 +212,15 @@ void cross_entropy_layer<TensorDataType, T_layout, Dev>::local_fp_compute()
                                                     1,
                                                     std::multiplies<size_t>());
 
+  if (this->m_from_logits) {
+    local_fp_logits_cpu(this->get_local_prev_activations(0),
+                        this->get_local_prev_activations(1),
+                        this->m_workspace->Matrix(),
+                        this->m_logits_statistics->Matrix(),
+                        input_dims.back());
+    return;
+  }
+
   local_fp_cpu(this->get_local_prev_activations(0),
                this->get_local_prev_activations(1),
                this->m_workspace->Matrix(),
@@ -145,6 +238,17 @@ void cross_entropy_layer<TensorDataType, T_layout, Dev>::local_bp_compute()
                                                     1,
                                                     std::multiplies<size_t>());
 
+  if (this->m_from_logits) {
+    local_bp_logits_cpu(this->get_local_prev_activations(0),
+                        this->get_local_prev_activations(1),
+                        this->m_logits_statistics->LockedMatrix(),
+                        this->m_workspace->LockedMatrix(),
+                        this->get_local_error_signals(0),
+                        this->get_local_error_signals(1),
+                        input_dims.back());
+    return;
+  }
+
   local_bp_cpu(this->get_local_prev_activations(0),
                this->get_local_prev_activations(1),
                this->m_workspace->LockedMatrix(),
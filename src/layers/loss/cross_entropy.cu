@@ -222,6 +222,223 @@ void local_bp_gpu(
   }
 }
 
+/** Reduction for online log-sum-exp.
+ *
+ *  Entries are the running maximum, the sum of exponentials shifted
+ *  by the maximum, the sum of ground truth entries, and the sum of
+ *  ground truth entries times logits.
+ */
+template <typename TensorDataType>
+struct logits_reduce_op
+{
+  using ArrayType = gpu_lib::array<TensorDataType, 4>;
+  __device__ __forceinline__ ArrayType operator()(const ArrayType& x,
+                                                  const ArrayType& y)
+  {
+    ArrayType z;
+    z[0] = gpu_lib::max(x[0], y[0]);
+    z[1] = (x[1] * gpu_lib::exp(x[0] - z[0]) +
+            y[1] * gpu_lib::exp(y[0] - z[0]));
+    z[2] = x[2] + y[2];
+    z[3] = x[3] + y[3];
+    return z;
+  }
+};
+
+/** Compute cross entropy contributions from logits.
+ *
+ *  Each block handles one softmax and loops over its entries, so
+ *  memory use does not depend on the vocabulary size.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: num_softmaxes x width x 1
+ */
+template <int block_size, typename TensorDataType>
+__global__ void
+fp_logits_kernel(int num_softmaxes,
+                 int softmax_size,
+                 int width,
+                 const TensorDataType* __restrict__ logits,
+                 int logits_ldim,
+                 const TensorDataType* __restrict__ ground_truth,
+                 int ground_truth_ldim,
+                 TensorDataType* __restrict__ statistics,
+                 int statistics_ldim,
+                 TensorDataType* __restrict__ contribution)
+{
+  using ArrayType = gpu_lib::array<TensorDataType, 4>;
+  using OpType = logits_reduce_op<TensorDataType>;
+  const int tid = threadIdx.x;
+  for (int col = blockIdx.y; col < width; col += gridDim.y) {
+    for (int softmax = blockIdx.x; softmax < num_softmaxes;
+         softmax += gridDim.x) {
+
+      // Online log-sum-exp and ground truth sums for each thread
+      const int offset = softmax * softmax_size;
+      ArrayType vals;
+      vals[0] = -gpu_lib::max<TensorDataType>();
+      vals[1] = TensorDataType(0.);
+      vals[2] = TensorDataType(0.);
+      vals[3] = TensorDataType(0.);
+      for (int i = tid; i < softmax_size; i += block_size) {
+        const auto& x = logits[offset + i + col * logits_ldim];
+        const auto& xhat = ground_truth[offset + i + col * ground_truth_ldim];
+        if (x > vals[0]) {
+          vals[1] = vals[1] * gpu_lib::exp(vals[0] - x) + TensorDataType(1.);
+          vals[0] = x;
+        }
+        else {
+          vals[1] += gpu_lib::exp(x - vals[0]);
+        }
+        vals[2] += xhat;
+        vals[3] += xhat * x;
+      }
+      vals = gpu_lib::block_reduce<block_size, 1, 1, ArrayType, OpType>(vals);
+
+      // Output result to global memory
+      if (tid == 0) {
+        const auto log_sum_exp = vals[0] + gpu_lib::log(vals[1]);
+        statistics[2 * softmax + col * statistics_ldim] = log_sum_exp;
+        statistics[2 * softmax + 1 + col * statistics_ldim] = vals[2];
+        gpu_lib::atomic_add(&contribution[col],
+                            log_sum_exp * vals[2] - vals[3]);
+      }
+      __syncthreads();
+    }
+  }
+}
+
+/** Compute gradients of cross entropy w.r.t. logits.
+ *
+ *  dL/dx = dL/dy * ( softmax(x) * sum(xhat) - xhat )
+ *
+ *  dL/dxhat = dL/dy * ( log-sum-exp(x) - x )
+ */
+template <typename TensorDataType>
+__global__ void
+bp_logits_kernel(int height,
+                 int width,
+                 int softmax_size,
+                 const TensorDataType* __restrict__ logits,
+                 int logits_ldim,
+                 const TensorDataType* __restrict__ ground_truth,
+                 int ground_truth_ldim,
+                 const TensorDataType* __restrict__ statistics,
+                 int statistics_ldim,
+                 const TensorDataType* __restrict__ gradient_wrt_output,
+                 TensorDataType* __restrict__ gradient_wrt_logits,
+                 int gradient_wrt_logits_ldim,
+                 TensorDataType* __restrict__ gradient_wrt_ground_truth,
+                 int gradient_wrt_ground_truth_ldim)
+{
+  const int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const int nthreadsx = blockDim.x * gridDim.x;
+  for (int col = blockIdx.y; col < width; col += gridDim.y) {
+    const auto& dy = gradient_wrt_output[col];
+    for (int row = gidx; row < height; row += nthreadsx) {
+      const int softmax = row / softmax_size;
+      const auto* stats = &statistics[2 * softmax + col * statistics_ldim];
+      const auto& log_sum_exp = stats[0];
+      const auto& sum_xhat = stats[1];
+      const auto& x = logits[row + col * logits_ldim];
+      const auto& xhat = ground_truth[row + col * ground_truth_ldim];
+      gradient_wrt_logits[row + col * gradient_wrt_logits_ldim] =
+        dy * (gpu_lib::exp(x - log_sum_exp) * sum_xhat - xhat);
+      gradient_wrt_ground_truth[row + col * gradient_wrt_ground_truth_ldim] =
+        dy * (log_sum_exp - x);
+    }
+  }
+}
+
+template <typename TensorDataType>
+void local_fp_logits_gpu(
+  const El::AbstractMatrix<TensorDataType>& local_logits,
+  const El::AbstractMatrix<TensorDataType>& local_ground_truth,
+  El::AbstractMatrix<TensorDataType>& local_contribution,
+  El::AbstractMatrix<TensorDataType>& local_statistics,
+  const int& softmax_size)
+{
+  El::Zero(local_contribution);
+  const auto& height = local_logits.Height();
+  const auto& width = local_logits.Width();
+  if (height > 0 && width > 0) {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_contribution),
+                                       gpu::get_sync_info(local_statistics),
+                                       gpu::get_sync_info(local_logits),
+                                       gpu::get_sync_info(local_ground_truth));
+    const int block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.x = height / softmax_size;
+    grid_dims.y = width;
+    gpu_lib::clip_grid_dims(grid_dims);
+    hydrogen::gpu::LaunchKernel(fp_logits_kernel<block_size, TensorDataType>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                multisync,
+                                height / softmax_size,
+                                softmax_size,
+                                width,
+                                local_logits.LockedBuffer(),
+                                local_logits.LDim(),
+                                local_ground_truth.LockedBuffer(),
+                                local_ground_truth.LDim(),
+                                local_statistics.Buffer(),
+                                local_statistics.LDim(),
+                                local_contribution.Buffer());
+  }
+}
+
+template <typename TensorDataType>
+void local_bp_logits_gpu(
+  const El::AbstractMatrix<TensorDataType>& local_logits,
+  const El::AbstractMatrix<TensorDataType>& local_ground_truth,
+  const El::AbstractMatrix<TensorDataType>& local_statistics,
+  const El::AbstractMatrix<TensorDataType>& local_gradient_wrt_output,
+  El::AbstractMatrix<TensorDataType>& local_gradient_wrt_logits,
+  El::AbstractMatrix<TensorDataType>& local_gradient_wrt_ground_truth,
+  const int& softmax_size)
+{
+  const auto& height = local_logits.Height();
+  const auto& width = local_logits.Width();
+  if (height > 0 && width > 0) {
+    auto multisync =
+      El::MakeMultiSync(gpu::get_sync_info(local_gradient_wrt_logits),
+                        gpu::get_sync_info(local_gradient_wrt_ground_truth),
+                        gpu::get_sync_info(local_gradient_wrt_output),
+                        gpu::get_sync_info(local_statistics),
+                        gpu::get_sync_info(local_logits),
+                        gpu::get_sync_info(local_ground_truth));
+    const int block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.x = (height + block_size - 1) / block_size;
+    grid_dims.y = width;
+    gpu_lib::clip_grid_dims(grid_dims);
+    hydrogen::gpu::LaunchKernel(bp_logits_kernel<TensorDataType>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                multisync,
+                                height,
+                                width,
+                                softmax_size,
+                                local_logits.LockedBuffer(),
+                                local_logits.LDim(),
+                                local_ground_truth.LockedBuffer(),
+                                local_ground_truth.LDim(),
+                                local_statistics.LockedBuffer(),
+                                local_statistics.LDim(),
+                                local_gradient_wrt_output.LockedBuffer(),
+                                local_gradient_wrt_logits.Buffer(),
+                                local_gradient_wrt_logits.LDim(),
+                                local_gradient_wrt_ground_truth.Buffer(),
+                                local_gradient_wrt_ground_truth.LDim());
+  }
+}
+
 } // namespace
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -234,6 +451,15 @@ void cross_entropy_layer<TensorDataType, T_layout, Dev>::local_fp_compute()
                                                     1,
                                                     std::multiplies<size_t>());
 
+  if (this->m_from_logits) {
+    local_fp_logits_gpu(this->get_local_prev_activations(0),
+                        this->get_local_prev_activations(1),
+                        this->m_workspace->Matrix(),
+                        this->m_logits_statistics->Matrix(),
+                        input_dims.back());
+    return;
+  }
+
   local_fp_gpu(this->get_local_prev_activations(0),
                this->get_local_prev_activations(1),
                this->m_workspace->Matrix(),
@@ -251,6 +477,17 @@ void cross_entropy_layer<TensorDataType, T_layout, Dev>::local_bp_compute()
                                                     1,
                                                     std::multiplies<size_t>());
 
+  if (this->m_from_logits) {
+    local_bp_logits_gpu(this->get_local_prev_activations(0),
+                        this->get_local_prev_activations(1),
+                        this->m_logits_statistics->LockedMatrix(),
+                        this->m_workspace->LockedMatrix(),
+                        this->get_local_error_signals(0),
+                        this->get_local_error_signals(1),
+                        input_dims.back());
+    return;
+  }
+
   local_bp_gpu(this->get_local_prev_activations(0),
                this->get_local_prev_activations(1),
                this->m_workspace->LockedMatrix(),
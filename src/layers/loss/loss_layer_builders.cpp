@@ -51,7 +51,8 @@ lbann::build_cross_entropy_layer_from_pbuf(lbann_comm* comm,
 {
   const auto& params = proto_layer.cross_entropy();
   return std::make_unique<cross_entropy_layer<T, L, D>>(comm,
-                                                        params.use_labels());
+                                                        params.use_labels(),
+                                                        params.from_logits());
 }
 
 template <typename T, lbann::data_layout L, El::Device D>
@@ -29,6 +29,7 @@
 #include "lbann/layers/loss/top_k_categorical_accuracy_impl.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/gpu/top_k.hpp"
 
 #include <thrust/iterator/discard_iterator.h>
 #include <thrust/sort.h>
@@ -39,13 +40,7 @@ namespace {
 
 /** Sparse vector entry. */
 template <typename TensorDataType>
-struct entry
-{
-  /** Vector entry value. */
-  TensorDataType value;
-  /** Vector entry index. */
-  El::Int index;
-};
+using entry = gpu_lib::top_k_entry<TensorDataType>;
 
 /** Comparison operation to sort sparse vector entries.
  *  Entries are sorted by value in decreasing order, with ties broken
@@ -258,7 +253,20 @@ void fp_gpu(lbann_comm& comm,
 
   // Find top-k entries in each column of local prediction matrix
   gpu_lib::thrust::vector<entry<TensorDataType>> top_entries(local_width * k);
-  {
+  if (k <= gpu_lib::max_top_k) {
+    gpu_lib::top_k_columns(k,
+                           local_height,
+                           local_width,
+                           predictions.ColShift(),
+                           predictions.ColStride(),
+                           height,
+                           local_predictions.LockedBuffer(),
+                           local_predictions.LDim(),
+                           top_entries.data().get(),
+                           k,
+                           sync_info);
+  }
+  else {
     const auto& num_local_entries_per_col = std::max(local_height, k);
     const auto& num_local_entries = local_width * num_local_entries_per_col;
     const auto& block_dim = 256;
@@ -26,6 +26,7 @@
 
 #include <lbann/layers/math/math_builders.hpp>
 #include <lbann/layers/math/matmul.hpp>
+#include <lbann/layers/math/scaled_dot_product_attention.hpp>
 
 #include "lbann/proto/layers.pb.h"
 #include <lbann/proto/proto_common.hpp>
@@ -53,6 +54,32 @@ build_matmul_layer_from_pbuf(lbann_comm* comm,
   }
 }
 
-#define PROTO_DEVICE(T, D) LBANN_LAYER_BUILDER_ETI(matmul, T, D)
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+std::unique_ptr<Layer> build_scaled_dot_product_attention_layer_from_pbuf(
+  lbann_comm* comm,
+  lbann_data::Layer const& proto_layer)
+{
+  LBANN_ASSERT_MSG_HAS_FIELD(proto_layer, scaled_dot_product_attention);
+  if constexpr (Layout == data_layout::DATA_PARALLEL) {
+    using LayerType =
+      scaled_dot_product_attention_layer<TensorDataType, Layout, Device>;
+    const auto& params = proto_layer.scaled_dot_product_attention();
+    const size_t num_heads = params.num_heads() > 0 ? params.num_heads() : 1;
+    return std::make_unique<LayerType>(comm,
+                                       num_heads,
+                                       params.causal(),
+                                       params.scale());
+  }
+  else {
+    (void)comm;
+    (void)proto_layer;
+    LBANN_ERROR("scaled dot-product attention layer is only supported with "
+                "a data-parallel layout");
+  }
+}
+
+#define PROTO_DEVICE(T, D)                                                     \
+  LBANN_LAYER_BUILDER_ETI(matmul, T, D);                                       \
+  LBANN_LAYER_BUILDER_ETI(scaled_dot_product_attention, T, D)
 #include <lbann/macros/instantiate_device.hpp>
 } // namespace lbann
@@ -28,12 +28,15 @@
 #include "lbann/layers/math/matmul.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/int8.hpp"
 
 #ifdef LBANN_HAS_GPU
 #include "lbann/utils/gpu/helpers.hpp"
 #endif // LBANN_HAS_GPU
 #include "lbann/proto/layers.pb.h"
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 namespace lbann {
 
@@ -158,6 +161,124 @@ matmul_layer<TensorDataType, Layout, Device>::get_distconv_adapter()
 
 #endif //  LBANN_HAS_DISTCONV
 
+namespace {
+
+/** @brief Strided-batched GEMM on CPU
+ *
+ *  Mirrors @c hydrogen::gpu_blas::GemmStridedBatched: computes
+ *  @f$ C_b = \alpha op(A_b) op(B_b) + \beta C_b @f$ for
+ *  column-major matrices that are evenly spaced in memory. The batch
+ *  is flattened into a single parallel loop so that threads are kept
+ *  busy even when there are few matrices per sample.
+ */
+template <typename TensorDataType>
+void gemm_strided_batched(El::Orientation transa,
+                          El::Orientation transb,
+                          El::Int m,
+                          El::Int n,
+                          El::Int k,
+                          TensorDataType alpha,
+                          const TensorDataType* A,
+                          El::Int lda,
+                          El::Int stride_a,
+                          const TensorDataType* B,
+                          El::Int ldb,
+                          El::Int stride_b,
+                          TensorDataType beta,
+                          TensorDataType* C,
+                          El::Int ldc,
+                          El::Int stride_c,
+                          El::Int batch_count)
+{
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto A_height = (transa == El::NORMAL ? m : k);
+  const auto A_width = (transa == El::NORMAL ? k : m);
+  const auto B_height = (transb == El::NORMAL ? k : n);
+  const auto B_width = (transb == El::NORMAL ? n : k);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int b = 0; b < batch_count; ++b) {
+    LocalMat A_v, B_v, C_v;
+    A_v.LockedAttach(A_height, A_width, A + b * stride_a, lda);
+    B_v.LockedAttach(B_height, B_width, B + b * stride_b, ldb);
+    C_v.Attach(m, n, C + b * stride_c, ldc);
+    El::Gemm(transa, transb, alpha, A_v, B_v, beta, C_v);
+  }
+}
+
+/** @brief Int8 version of the forward prop matrix products
+ *
+ *  Both inputs are quantized with the scales for their calibrated
+ *  ranges. The output's rows, which are contiguous in C layout, are
+ *  dot products of rows of op(input0) and columns of op(input1), so
+ *  those are what gemm_int8 receives.
+ */
+template <typename TensorDataType>
+void gemm_int8_batched(const Layer& l,
+                       bool transpose_input0,
+                       bool transpose_input1,
+                       const TensorDataType* input0,
+                       El::Int input0_height,
+                       El::Int input0_width,
+                       const TensorDataType* input1,
+                       El::Int input1_height,
+                       El::Int input1_width,
+                       TensorDataType* output,
+                       El::Int output_height,
+                       El::Int output_width,
+                       El::Int num_matrices)
+{
+  if constexpr (std::is_floating_point_v<TensorDataType>) {
+    const auto& ranges = l.get_int8_input_ranges();
+    const auto scale0 = int8_scale(static_cast<TensorDataType>(ranges[0]));
+    const auto scale1 = int8_scale(static_cast<TensorDataType>(ranges[1]));
+    const El::Int input0_stride = input0_height * input0_width;
+    const El::Int input1_stride = input1_height * input1_width;
+    const El::Int inner_size = transpose_input0 ? input0_height : input0_width;
+
+    // Rows of op(input0) and columns of op(input1), contiguously
+    std::vector<int8_t> rows(input0_stride * num_matrices);
+    std::vector<int8_t> cols(input1_stride * num_matrices);
+    quantize_int8(input0,
+                  input0_width,
+                  input0_height,
+                  input0_width,
+                  transpose_input0,
+                  scale0,
+                  rows.data(),
+                  num_matrices,
+                  input0_stride);
+    quantize_int8(input1,
+                  input1_width,
+                  input1_height,
+                  input1_width,
+                  !transpose_input1,
+                  scale1,
+                  cols.data(),
+                  num_matrices,
+                  input1_stride);
+
+    gemm_int8(output_width,
+              output_height,
+              inner_size,
+              scale0 * scale1,
+              cols.data(),
+              input1_stride,
+              static_cast<const TensorDataType*>(nullptr),
+              rows.data(),
+              input0_stride,
+              static_cast<const TensorDataType*>(nullptr),
+              output,
+              output_width,
+              output_height * output_width,
+              num_matrices);
+  }
+  else {
+    LBANN_ERROR("int8 inference requires float or double data");
+  }
+}
+
+} // namespace
+
 template <typename TensorDataType>
 void fp_compute_impl(
   matmul_layer<TensorDataType, data_layout::DATA_PARALLEL, El::Device::CPU>& l,
@@ -182,6 +303,11 @@ void fp_compute_impl(
                 "\" ",
                 "has non-contiguous data buffers");
   }
+  // Return immediately if nothing needs to be done
+  if (local_mini_batch_size < 1) {
+    return;
+  }
+
   // Matrix dimensions
   const auto input0_dims = l.get_input_dims(0);
   const auto input1_dims = l.get_input_dims(1);
@@ -197,43 +323,48 @@ void fp_compute_impl(
   const El::Int output_height = *(output_dims.rbegin() + 1);
   const El::Int output_width = *(output_dims.rbegin());
 
-  // Compute matrix multiplication for each mini-batch sample
-  // Note: Elemental matrices are in Fortran layout while LBANN
-  // tensors are in C layout.
-
-  // Calculate stride for each matrix depending on the depth
+  const auto num_matrices = mat_depth * local_mini_batch_size;
   const auto input0_stride = input0_height * input0_width;
   const auto input1_stride = input1_height * input1_width;
   const auto output_stride = output_height * output_width;
 
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int j = 0; j < mat_depth; ++j) {
-    auto input0_buffer_start = j * input0_stride;
-    auto input1_buffer_start = j * input1_stride;
-    auto output_buffer_start = j * output_stride;
-    for (El::Int i = 0; i < local_mini_batch_size; ++i) {
-      LocalMat input0_v, input1_v, output_v;
-      input0_v.LockedAttach(input0_width,
-                            input0_height,
-                            local_input0.LockedBuffer(input0_buffer_start, i),
-                            input0_width);
-      input1_v.LockedAttach(input1_width,
-                            input1_height,
-                            local_input1.LockedBuffer(input1_buffer_start, i),
-                            input1_width);
-      output_v.Attach(output_width,
+  if (l.using_int8_inference()) {
+    gemm_int8_batched(l,
+                      transpose_input0,
+                      transpose_input1,
+                      local_input0.LockedBuffer(),
+                      input0_height,
+                      input0_width,
+                      local_input1.LockedBuffer(),
+                      input1_height,
+                      input1_width,
+                      local_output.Buffer(),
                       output_height,
-                      local_output.Buffer(output_buffer_start, i),
-                      output_width);
-      El::Gemm(transpose_input1 ? El::TRANSPOSE : El::NORMAL,
-               transpose_input0 ? El::TRANSPOSE : El::NORMAL,
-               El::TypeTraits<TensorDataType>::One(),
-               input1_v,
-               input0_v,
-               El::TypeTraits<TensorDataType>::Zero(),
-               output_v);
-    }
+                      output_width,
+                      num_matrices);
+    return;
   }
+
+  // Compute matrix multiplication for each mini-batch sample
+  // Note: Elemental matrices are in Fortran layout while LBANN
+  // tensors are in C layout.
+  gemm_strided_batched(transpose_input1 ? El::TRANSPOSE : El::NORMAL,
+                       transpose_input0 ? El::TRANSPOSE : El::NORMAL,
+                       output_width,
+                       output_height,
+                       transpose_input0 ? input0_height : input0_width,
+                       El::TypeTraits<TensorDataType>::One(),
+                       local_input1.LockedBuffer(),
+                       input1_width,
+                       input1_stride,
+                       local_input0.LockedBuffer(),
+                       input0_width,
+                       input0_stride,
+                       El::TypeTraits<TensorDataType>::Zero(),
+                       local_output.Buffer(),
+                       output_width,
+                       output_stride,
+                       num_matrices);
 }
 
 template <typename TensorDataType>
@@ -256,6 +387,12 @@ void bp_compute_impl(
   auto& local_input1_grad =
     dynamic_cast<LocalMat&>(l.get_local_error_signals(1));
   const auto& local_mini_batch_size = local_input0.Width();
+
+  // Return immediately if nothing needs to be done
+  if (local_mini_batch_size < 1) {
+    return;
+  }
+
   if (!local_input0.Contiguous() || !local_input1.Contiguous() ||
       !local_output_grad.Contiguous() || !local_input0_grad.Contiguous() ||
       !local_input1_grad.Contiguous()) {
@@ -280,80 +417,89 @@ void bp_compute_impl(
   const El::Int output_height = *(output_dims.rbegin() + 1);
   const El::Int output_width = *(output_dims.rbegin());
 
-  // Compute gradients for each mini-batch sample
-  // Note: Elemental matrices are in Fortran layout while LBANN
-  // tensors are in C layout.
-
-  // Calculate stride for each matrix depending on the depth
+  const auto num_matrices = mat_depth * local_mini_batch_size;
   const auto input0_stride = input0_height * input0_width;
   const auto input1_stride = input1_height * input1_width;
   const auto output_stride = output_height * output_width;
 
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int j = 0; j < mat_depth; ++j) {
-    auto input0_buffer_start = j * input0_stride;
-    auto input1_buffer_start = j * input1_stride;
-    auto output_buffer_start = j * output_stride;
-    for (El::Int i = 0; i < local_mini_batch_size; ++i) {
-      LocalMat input0_v, input1_v, output_grad_v, input0_grad_v, input1_grad_v;
-      input0_v.LockedAttach(input0_width,
-                            input0_height,
-                            local_input0.LockedBuffer(input0_buffer_start, i),
-                            input0_width);
-      input1_v.LockedAttach(input1_width,
-                            input1_height,
-                            local_input1.LockedBuffer(input1_buffer_start, i),
-                            input1_width);
-      output_grad_v.LockedAttach(
-        output_width,
-        output_height,
-        local_output_grad.LockedBuffer(output_buffer_start, i),
-        output_width);
-      input0_grad_v.Attach(input0_width,
-                           input0_height,
-                           local_input0_grad.Buffer(input0_buffer_start, i),
-                           input0_width);
-      input1_grad_v.Attach(input1_width,
-                           input1_height,
-                           local_input1_grad.Buffer(input1_buffer_start, i),
-                           input1_width);
-      if (transpose_input0) {
-        El::Gemm(El::TRANSPOSE,
-                 transpose_input1 ? El::TRANSPOSE : El::NORMAL,
-                 El::TypeTraits<TensorDataType>::One(),
-                 output_grad_v,
-                 input1_v,
-                 El::TypeTraits<TensorDataType>::Zero(),
-                 input0_grad_v);
-      }
-      else {
-        El::Gemm(transpose_input1 ? El::NORMAL : El::TRANSPOSE,
-                 El::NORMAL,
-                 El::TypeTraits<TensorDataType>::One(),
-                 input1_v,
-                 output_grad_v,
-                 El::TypeTraits<TensorDataType>::Zero(),
-                 input0_grad_v);
-      }
-      if (transpose_input1) {
-        El::Gemm(transpose_input0 ? El::TRANSPOSE : El::NORMAL,
-                 El::TRANSPOSE,
-                 El::TypeTraits<TensorDataType>::One(),
-                 input0_v,
-                 output_grad_v,
-                 El::TypeTraits<TensorDataType>::Zero(),
-                 input1_grad_v);
-      }
-      else {
-        El::Gemm(El::NORMAL,
-                 transpose_input0 ? El::NORMAL : El::TRANSPOSE,
-                 El::TypeTraits<TensorDataType>::One(),
-                 output_grad_v,
-                 input0_v,
-                 El::TypeTraits<TensorDataType>::Zero(),
-                 input1_grad_v);
-      }
-    }
+  // Compute gradients for each mini-batch sample
+  // Note: Elemental matrices are in Fortran layout while LBANN
+  // tensors are in C layout.
+  if (transpose_input0) {
+    gemm_strided_batched(El::TRANSPOSE,
+                         transpose_input1 ? El::TRANSPOSE : El::NORMAL,
+                         input0_width,
+                         input0_height,
+                         output_width,
+                         El::TypeTraits<TensorDataType>::One(),
+                         local_output_grad.LockedBuffer(),
+                         output_width,
+                         output_stride,
+                         local_input1.LockedBuffer(),
+                         input1_width,
+                         input1_stride,
+                         El::TypeTraits<TensorDataType>::Zero(),
+                         local_input0_grad.Buffer(),
+                         input0_width,
+                         input0_stride,
+                         num_matrices);
+  }
+  else {
+    gemm_strided_batched(transpose_input1 ? El::NORMAL : El::TRANSPOSE,
+                         El::NORMAL,
+                         input0_width,
+                         input0_height,
+                         output_width,
+                         El::TypeTraits<TensorDataType>::One(),
+                         local_input1.LockedBuffer(),
+                         input1_width,
+                         input1_stride,
+                         local_output_grad.LockedBuffer(),
+                         output_width,
+                         output_stride,
+                         El::TypeTraits<TensorDataType>::Zero(),
+                         local_input0_grad.Buffer(),
+                         input0_width,
+                         input0_stride,
+                         num_matrices);
+  }
+  if (transpose_input1) {
+    gemm_strided_batched(transpose_input0 ? El::TRANSPOSE : El::NORMAL,
+                         El::TRANSPOSE,
+                         input1_width,
+                         input1_height,
+                         output_height,
+                         El::TypeTraits<TensorDataType>::One(),
+                         local_input0.LockedBuffer(),
+                         input0_width,
+                         input0_stride,
+                         local_output_grad.LockedBuffer(),
+                         output_width,
+                         output_stride,
+                         El::TypeTraits<TensorDataType>::Zero(),
+                         local_input1_grad.Buffer(),
+                         input1_width,
+                         input1_stride,
+                         num_matrices);
+  }
+  else {
+    gemm_strided_batched(El::NORMAL,
+                         transpose_input0 ? El::NORMAL : El::TRANSPOSE,
+                         input1_width,
+                         input1_height,
+                         output_height,
+                         El::TypeTraits<TensorDataType>::One(),
+                         local_output_grad.LockedBuffer(),
+                         output_width,
+                         output_stride,
+                         local_input0.LockedBuffer(),
+                         input0_width,
+                         input0_stride,
+                         El::TypeTraits<TensorDataType>::Zero(),
+                         local_input1_grad.Buffer(),
+                         input1_width,
+                         input1_stride,
+                         num_matrices);
   }
 }
 
@@ -708,6 +854,13 @@ void matmul_layer<T, L, D>::write_specific_proto(lbann_data::Layer& proto) const
   msg->set_transpose_b(m_transpose_b);
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool matmul_layer<TensorDataType, Layout, Device>::supports_int8_inference()
+  const
+{
+  return Device == El::Device::CPU && std::is_floating_point_v<TensorDataType>;
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void matmul_layer<TensorDataType, Layout, Device>::fp_compute()
 {
@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_SCALED_DOT_PRODUCT_ATTENTION_LAYER_INSTANTIATE
+#include "lbann/layers/math/scaled_dot_product_attention_impl.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace lbann {
+
+// =========================================================
+// Forward prop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  fp_compute()
+{
+
+  // Local matrices
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto& queries =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& keys =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  const auto& values =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(2));
+  auto& output = dynamic_cast<LocalMat&>(this->get_local_activations());
+
+  // Dimensions
+  const size_t num_queries = this->get_input_dims(0)[0];
+  const size_t num_keys = this->get_input_dims(1)[0];
+  const size_t embed_dim = this->get_input_dims(0)[1];
+  const size_t value_dim = this->get_input_dims(2)[1];
+  const size_t num_heads = m_num_heads;
+  const size_t qk_head_size = embed_dim / num_heads;
+  const size_t v_head_size = value_dim / num_heads;
+  const size_t local_mini_batch_size = queries.Width();
+  const auto scale = get_scale();
+  const bool causal = m_causal;
+
+  auto& stats = m_softmax_stats;
+  stats.Resize(num_heads * num_queries, local_mini_batch_size);
+
+  // Online softmax over keys for each query
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (size_t k = 0; k < local_mini_batch_size; ++k) {
+    for (size_t h = 0; h < num_heads; ++h) {
+      std::vector<StatType> acc(v_head_size);
+      for (size_t i = 0; i < num_queries; ++i) {
+        const auto* q = queries.LockedBuffer(i * embed_dim + h * qk_head_size,
+                                             k);
+        const size_t key_end = causal ? std::min(i + 1, num_keys) : num_keys;
+        StatType shift = -std::numeric_limits<StatType>::infinity();
+        StatType denom = 0;
+        std::fill(acc.begin(), acc.end(), StatType(0));
+        for (size_t j = 0; j < key_end; ++j) {
+          const auto* kj =
+            keys.LockedBuffer(j * embed_dim + h * qk_head_size, k);
+          const auto* vj =
+            values.LockedBuffer(j * value_dim + h * v_head_size, k);
+          StatType s = 0;
+          for (size_t d = 0; d < qk_head_size; ++d) {
+            s += static_cast<StatType>(q[d]) * static_cast<StatType>(kj[d]);
+          }
+          s *= scale;
+          if (s > shift) {
+            const auto rescale = std::exp(shift - s);
+            denom *= rescale;
+            for (auto& a : acc) {
+              a *= rescale;
+            }
+            shift = s;
+          }
+          const auto p = std::exp(s - shift);
+          denom += p;
+          for (size_t d = 0; d < v_head_size; ++d) {
+            acc[d] += p * static_cast<StatType>(vj[d]);
+          }
+        }
+        auto* y = output.Buffer(i * value_dim + h * v_head_size, k);
+        for (size_t d = 0; d < v_head_size; ++d) {
+          y[d] = static_cast<TensorDataType>(acc[d] / denom);
+        }
+        stats(h * num_queries + i, k) = shift + std::log(denom);
+      }
+    }
+  }
+}
+
+// =========================================================
+// Backprop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  bp_compute()
+{
+
+  // Local matrices
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto& queries =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& keys =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  const auto& values =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(2));
+  const auto& output =
+    dynamic_cast<const LocalMat&>(this->get_local_activations());
+  const auto& output_grad =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_error_signals());
+  auto& queries_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(0));
+  auto& keys_grad = dynamic_cast<LocalMat&>(this->get_local_error_signals(1));
+  auto& values_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(2));
+
+  // Dimensions
+  const size_t num_queries = this->get_input_dims(0)[0];
+  const size_t num_keys = this->get_input_dims(1)[0];
+  const size_t embed_dim = this->get_input_dims(0)[1];
+  const size_t value_dim = this->get_input_dims(2)[1];
+  const size_t num_heads = m_num_heads;
+  const size_t qk_head_size = embed_dim / num_heads;
+  const size_t v_head_size = value_dim / num_heads;
+  const size_t local_mini_batch_size = queries.Width();
+  const auto scale = get_scale();
+  const bool causal = m_causal;
+  const auto& stats = m_softmax_stats;
+
+  // Recompute probabilities from softmax statistics
+  //   p_ij = exp(s_ij - logsumexp_i)
+  //   ds_ij = p_ij * (dy_i . v_j - dy_i . y_i)
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (size_t k = 0; k < local_mini_batch_size; ++k) {
+    for (size_t h = 0; h < num_heads; ++h) {
+      std::vector<StatType> dq(qk_head_size);
+      std::vector<StatType> dk(num_keys * qk_head_size, StatType(0));
+      std::vector<StatType> dv(num_keys * v_head_size, StatType(0));
+      for (size_t i = 0; i < num_queries; ++i) {
+        const auto* q = queries.LockedBuffer(i * embed_dim + h * qk_head_size,
+                                             k);
+        const auto* y = output.LockedBuffer(i * value_dim + h * v_head_size, k);
+        const auto* dy =
+          output_grad.LockedBuffer(i * value_dim + h * v_head_size, k);
+        const size_t key_end = causal ? std::min(i + 1, num_keys) : num_keys;
+        const auto logsumexp = stats(h * num_queries + i, k);
+        StatType dy_dot_y = 0;
+        for (size_t d = 0; d < v_head_size; ++d) {
+          dy_dot_y +=
+            static_cast<StatType>(dy[d]) * static_cast<StatType>(y[d]);
+        }
+        std::fill(dq.begin(), dq.end(), StatType(0));
+        for (size_t j = 0; j < key_end; ++j) {
+          const auto* kj =
+            keys.LockedBuffer(j * embed_dim + h * qk_head_size, k);
+          const auto* vj =
+            values.LockedBuffer(j * value_dim + h * v_head_size, k);
+          StatType s = 0;
+          for (size_t d = 0; d < qk_head_size; ++d) {
+            s += static_cast<StatType>(q[d]) * static_cast<StatType>(kj[d]);
+          }
+          const auto p = std::exp(s * scale - logsumexp);
+          StatType dp = 0;
+          for (size_t d = 0; d < v_head_size; ++d) {
+            const auto dy_d = static_cast<StatType>(dy[d]);
+            dp += dy_d * static_cast<StatType>(vj[d]);
+            dv[j * v_head_size + d] += p * dy_d;
+          }
+          const auto ds = p * (dp - dy_dot_y) * scale;
+          for (size_t d = 0; d < qk_head_size; ++d) {
+            dq[d] += ds * static_cast<StatType>(kj[d]);
+            dk[j * qk_head_size + d] += ds * static_cast<StatType>(q[d]);
+          }
+        }
+        auto* dqi = queries_grad.Buffer(i * embed_dim + h * qk_head_size, k);
+        for (size_t d = 0; d < qk_head_size; ++d) {
+          dqi[d] = static_cast<TensorDataType>(dq[d]);
+        }
+      }
+      for (size_t j = 0; j < num_keys; ++j) {
+        auto* dkj = keys_grad.Buffer(j * embed_dim + h * qk_head_size, k);
+        auto* dvj = values_grad.Buffer(j * value_dim + h * v_head_size, k);
+        for (size_t d = 0; d < qk_head_size; ++d) {
+          dkj[d] = static_cast<TensorDataType>(dk[j * qk_head_size + d]);
+        }
+        for (size_t d = 0; d < v_head_size; ++d) {
+          dvj[d] = static_cast<TensorDataType>(dv[j * v_head_size + d]);
+        }
+      }
+    }
+  }
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#define PROTO(T)                                                               \
+  template class scaled_dot_product_attention_layer<                           \
+    T,                                                                         \
+    data_layout::DATA_PARALLEL,                                                \
+    El::Device::CPU>
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#undef LBANN_INSTANTIATE_CPU_HALF
+
+} // namespace lbann
@@ -0,0 +1,781 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_SCALED_DOT_PRODUCT_ATTENTION_LAYER_INSTANTIATE
+#include "lbann/layers/math/scaled_dot_product_attention_impl.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** @brief Number of queries (or keys) handled by a thread block */
+constexpr size_t block_size = 64;
+/** @brief Number of keys (or queries) staged in shared memory */
+constexpr size_t tile_size = 16;
+
+/** @brief Arithmetic type for a tensor data type
+ *  @details Half-precision data is accumulated in single precision.
+ */
+template <typename T>
+struct accumulator
+{
+  using type = T;
+};
+template <>
+struct accumulator<__half>
+{
+  using type = float;
+};
+template <typename T>
+using AccType = typename accumulator<T>::type;
+
+/** @brief Copy one head of a tile of sequence vectors into shared
+ *         memory
+ *  @details Rows past @c num_rows are zero.
+ */
+template <typename TensorDataType>
+__device__ void load_tile(size_t first_row,
+                          size_t num_rows,
+                          size_t head_offset,
+                          size_t head_size,
+                          const TensorDataType* __restrict__ sequence,
+                          size_t row_size,
+                          AccType<TensorDataType>* __restrict__ tile)
+{
+  for (size_t pos = threadIdx.x; pos < tile_size * head_size;
+       pos += blockDim.x) {
+    const auto row = first_row + pos / head_size;
+    const auto d = pos % head_size;
+    tile[pos] = (row < num_rows ? static_cast<AccType<TensorDataType>>(
+                                    sequence[row * row_size + head_offset + d])
+                                : AccType<TensorDataType>(0));
+  }
+}
+
+/** @brief Forward prop kernel
+ *
+ *  Each thread owns one query and keeps its query vector and output
+ *  accumulator in registers. Keys and values are staged through
+ *  shared memory one tile at a time, and the softmax is rescaled
+ *  whenever a tile raises the running maximum.
+ *
+ *  Block dimensions: block_size x 1 x 1
+ *
+ *  Grid dimensions: (num_queries / block_size) x num_heads x
+ *  mini_batch_size
+ */
+template <typename TensorDataType, size_t MaxHeadSize>
+__global__ void fp_kernel(size_t num_queries,
+                          size_t num_keys,
+                          size_t num_heads,
+                          size_t qk_head_size,
+                          size_t v_head_size,
+                          size_t mini_batch_size,
+                          bool causal,
+                          AccType<TensorDataType> scale,
+                          const TensorDataType* __restrict__ queries,
+                          size_t queries_ldim,
+                          const TensorDataType* __restrict__ keys,
+                          size_t keys_ldim,
+                          const TensorDataType* __restrict__ values,
+                          size_t values_ldim,
+                          TensorDataType* __restrict__ output,
+                          size_t output_ldim,
+                          AccType<TensorDataType>* __restrict__ stats,
+                          size_t stats_ldim)
+{
+  using AccT = AccType<TensorDataType>;
+  extern __shared__ __align__(8) unsigned char shared_memory[];
+  auto* shared_keys = reinterpret_cast<AccT*>(shared_memory);
+  auto* shared_values = shared_keys + tile_size * qk_head_size;
+
+  const size_t h = blockIdx.y;
+  const size_t embed_dim = num_heads * qk_head_size;
+  const size_t value_dim = num_heads * v_head_size;
+  const size_t i = threadIdx.x + blockIdx.x * blockDim.x;
+  const bool active = i < num_queries;
+  const size_t block_end =
+    gpu_lib::min(num_queries, size_t((blockIdx.x + 1) * blockDim.x));
+  const size_t key_end = causal ? gpu_lib::min(num_keys, block_end) : num_keys;
+  const AccT neg_inf = -gpu_lib::infinity<AccT>();
+
+  for (size_t k = blockIdx.z; k < mini_batch_size; k += gridDim.z) {
+    const auto* q_seq = &queries[k * queries_ldim];
+    const auto* k_seq = &keys[k * keys_ldim];
+    const auto* v_seq = &values[k * values_ldim];
+
+    // Query vector and output accumulator
+    AccT q[MaxHeadSize], acc[MaxHeadSize];
+#pragma unroll
+    for (size_t d = 0; d < MaxHeadSize; ++d) {
+      q[d] = (active && d < qk_head_size)
+               ? scale * static_cast<AccT>(
+                           q_seq[i * embed_dim + h * qk_head_size + d])
+               : AccT(0);
+      acc[d] = AccT(0);
+    }
+    AccT shift = neg_inf;
+    AccT denom = AccT(0);
+
+    for (size_t j0 = 0; j0 < key_end; j0 += tile_size) {
+      __syncthreads();
+      load_tile(j0,
+                num_keys,
+                h * qk_head_size,
+                qk_head_size,
+                k_seq,
+                embed_dim,
+                shared_keys);
+      load_tile(j0,
+                num_keys,
+                h * v_head_size,
+                v_head_size,
+                v_seq,
+                value_dim,
+                shared_values);
+      __syncthreads();
+      if (!active) {
+        continue;
+      }
+
+      // Scores for tile
+      AccT scores[tile_size];
+      AccT tile_max = neg_inf;
+#pragma unroll
+      for (size_t jj = 0; jj < tile_size; ++jj) {
+        const size_t j = j0 + jj;
+        AccT s = AccT(0);
+#pragma unroll
+        for (size_t d = 0; d < MaxHeadSize; ++d) {
+          if (d < qk_head_size) {
+            s += q[d] * shared_keys[jj * qk_head_size + d];
+          }
+        }
+        const bool valid = j < num_keys && (!causal || j <= i);
+        scores[jj] = valid ? s : neg_inf;
+        tile_max = gpu_lib::max(tile_max, scores[jj]);
+      }
+      if (tile_max == neg_inf) {
+        continue;
+      }
+
+      // Online softmax update
+      const auto new_shift = gpu_lib::max(shift, tile_max);
+      const auto rescale = gpu_lib::exp(shift - new_shift);
+      denom *= rescale;
+#pragma unroll
+      for (size_t d = 0; d < MaxHeadSize; ++d) {
+        acc[d] *= rescale;
+      }
+#pragma unroll
+      for (size_t jj = 0; jj < tile_size; ++jj) {
+        const auto p = gpu_lib::exp(scores[jj] - new_shift);
+        denom += p;
+#pragma unroll
+        for (size_t d = 0; d < MaxHeadSize; ++d) {
+          if (d < v_head_size) {
+            acc[d] += p * shared_values[jj * v_head_size + d];
+          }
+        }
+      }
+      shift = new_shift;
+    }
+
+    // Write output and softmax statistics
+    if (active) {
+      auto* y = &output[k * output_ldim + i * value_dim + h * v_head_size];
+#pragma unroll
+      for (size_t d = 0; d < MaxHeadSize; ++d) {
+        if (d < v_head_size) {
+          y[d] = static_cast<TensorDataType>(acc[d] / denom);
+        }
+      }
+      stats[k * stats_ldim + h * num_queries + i] =
+        shift + gpu_lib::log(denom);
+    }
+  }
+}
+
+/** @brief Back prop kernel for query gradients
+ *
+ *  Each thread owns one query. Scores are recomputed from the
+ *  log-sum-exp saved in forward prop. Also saves
+ *  @f$ dy_i \cdot y_i @f$ for the key/value kernel.
+ *
+ *  Block dimensions: block_size x 1 x 1
+ *
+ *  Grid dimensions: (num_queries / block_size) x num_heads x
+ *  mini_batch_size
+ */
+template <typename TensorDataType, size_t MaxHeadSize>
+__global__ void
+bp_queries_kernel(size_t num_queries,
+                  size_t num_keys,
+                  size_t num_heads,
+                  size_t qk_head_size,
+                  size_t v_head_size,
+                  size_t mini_batch_size,
+                  bool causal,
+                  AccType<TensorDataType> scale,
+                  const TensorDataType* __restrict__ queries,
+                  size_t queries_ldim,
+                  const TensorDataType* __restrict__ keys,
+                  size_t keys_ldim,
+                  const TensorDataType* __restrict__ values,
+                  size_t values_ldim,
+                  const TensorDataType* __restrict__ output,
+                  size_t output_ldim,
+                  const TensorDataType* __restrict__ output_grad,
+                  size_t output_grad_ldim,
+                  const AccType<TensorDataType>* __restrict__ stats,
+                  size_t stats_ldim,
+                  AccType<TensorDataType>* __restrict__ dots,
+                  size_t dots_ldim,
+                  TensorDataType* __restrict__ queries_grad,
+                  size_t queries_grad_ldim)
+{
+  using AccT = AccType<TensorDataType>;
+  extern __shared__ __align__(8) unsigned char shared_memory[];
+  auto* shared_keys = reinterpret_cast<AccT*>(shared_memory);
+  auto* shared_values = shared_keys + tile_size * qk_head_size;
+
+  const size_t h = blockIdx.y;
+  const size_t embed_dim = num_heads * qk_head_size;
+  const size_t value_dim = num_heads * v_head_size;
+  const size_t i = threadIdx.x + blockIdx.x * blockDim.x;
+  const bool active = i < num_queries;
+  const size_t block_end =
+    gpu_lib::min(num_queries, size_t((blockIdx.x + 1) * blockDim.x));
+  const size_t key_end = causal ? gpu_lib::min(num_keys, block_end) : num_keys;
+
+  for (size_t k = blockIdx.z; k < mini_batch_size; k += gridDim.z) {
+    const auto* k_seq = &keys[k * keys_ldim];
+    const auto* v_seq = &values[k * values_ldim];
+    const size_t q_offset = i * embed_dim + h * qk_head_size;
+    const size_t y_offset = i * value_dim + h * v_head_size;
+
+    // Query vector, output gradient, and query gradient accumulator
+    AccT q[MaxHeadSize], dy[MaxHeadSize], dq[MaxHeadSize];
+    AccT dy_dot_y = AccT(0);
+#pragma unroll
+    for (size_t d = 0; d < MaxHeadSize; ++d) {
+      q[d] = (active && d < qk_head_size)
+               ? scale * static_cast<AccT>(
+                           queries[k * queries_ldim + q_offset + d])
+               : AccT(0);
+      dy[d] = (active && d < v_head_size)
+                ? static_cast<AccT>(
+                    output_grad[k * output_grad_ldim + y_offset + d])
+                : AccT(0);
+      if (active && d < v_head_size) {
+        dy_dot_y +=
+          dy[d] * static_cast<AccT>(output[k * output_ldim + y_offset + d]);
+      }
+      dq[d] = AccT(0);
+    }
+    const AccT logsumexp =
+      active ? stats[k * stats_ldim + h * num_queries + i] : AccT(0);
+    if (active) {
+      dots[k * dots_ldim + h * num_queries + i] = dy_dot_y;
+    }
+
+    for (size_t j0 = 0; j0 < key_end; j0 += tile_size) {
+      __syncthreads();
+      load_tile(j0,
+                num_keys,
+                h * qk_head_size,
+                qk_head_size,
+                k_seq,
+                embed_dim,
+                shared_keys);
+      load_tile(j0,
+                num_keys,
+                h * v_head_size,
+                v_head_size,
+                v_seq,
+                value_dim,
+                shared_values);
+      __syncthreads();
+      if (!active) {
+        continue;
+      }
+#pragma unroll
+      for (size_t jj = 0; jj < tile_size; ++jj) {
+        const size_t j = j0 + jj;
+        if (j >= num_keys || (causal && j > i)) {
+          continue;
+        }
+        AccT s = AccT(0), dp = AccT(0);
+#pragma unroll
+        for (size_t d = 0; d < MaxHeadSize; ++d) {
+          if (d < qk_head_size) {
+            s += q[d] * shared_keys[jj * qk_head_size + d];
+          }
+          if (d < v_head_size) {
+            dp += dy[d] * shared_values[jj * v_head_size + d];
+          }
+        }
+        const auto ds = gpu_lib::exp(s - logsumexp) * (dp - dy_dot_y);
+#pragma unroll
+        for (size_t d = 0; d < MaxHeadSize; ++d) {
+          if (d < qk_head_size) {
+            dq[d] += ds * shared_keys[jj * qk_head_size + d];
+          }
+        }
+      }
+    }
+
+    if (active) {
+      auto* dqi = &queries_grad[k * queries_grad_ldim + q_offset];
+#pragma unroll
+      for (size_t d = 0; d < MaxHeadSize; ++d) {
+        if (d < qk_head_size) {
+          dqi[d] = static_cast<TensorDataType>(scale * dq[d]);
+        }
+      }
+    }
+  }
+}
+
+/** @brief Back prop kernel for key and value gradients
+ *
+ *  Each thread owns one key/value pair. Queries, output gradients,
+ *  and softmax statistics are staged through shared memory.
+ *
+ *  Block dimensions: block_size x 1 x 1
+ *
+ *  Grid dimensions: (num_keys / block_size) x num_heads x
+ *  mini_batch_size
+ */
+template <typename TensorDataType, size_t MaxHeadSize>
+__global__ void
+bp_keys_values_kernel(size_t num_queries,
+                      size_t num_keys,
+                      size_t num_heads,
+                      size_t qk_head_size,
+                      size_t v_head_size,
+                      size_t mini_batch_size,
+                      bool causal,
+                      AccType<TensorDataType> scale,
+                      const TensorDataType* __restrict__ queries,
+                      size_t queries_ldim,
+                      const TensorDataType* __restrict__ keys,
+                      size_t keys_ldim,
+                      const TensorDataType* __restrict__ values,
+                      size_t values_ldim,
+                      const TensorDataType* __restrict__ output_grad,
+                      size_t output_grad_ldim,
+                      const AccType<TensorDataType>* __restrict__ stats,
+                      size_t stats_ldim,
+                      const AccType<TensorDataType>* __restrict__ dots,
+                      size_t dots_ldim,
+                      TensorDataType* __restrict__ keys_grad,
+                      size_t keys_grad_ldim,
+                      TensorDataType* __restrict__ values_grad,
+                      size_t values_grad_ldim)
+{
+  using AccT = AccType<TensorDataType>;
+  extern __shared__ __align__(8) unsigned char shared_memory[];
+  auto* shared_queries = reinterpret_cast<AccT*>(shared_memory);
+  auto* shared_output_grad = shared_queries + tile_size * qk_head_size;
+  auto* shared_stats = shared_output_grad + tile_size * v_head_size;
+  auto* shared_dots = shared_stats + tile_size;
+
+  const size_t h = blockIdx.y;
+  const size_t embed_dim = num_heads * qk_head_size;
+  const size_t value_dim = num_heads * v_head_size;
+  const size_t j = threadIdx.x + blockIdx.x * blockDim.x;
+  const bool active = j < num_keys;
+  const size_t query_begin = causal ? blockIdx.x * blockDim.x : 0;
+
+  for (size_t k = blockIdx.z; k < mini_batch_size; k += gridDim.z) {
+    const auto* q_seq = &queries[k * queries_ldim];
+    const auto* dy_seq = &output_grad[k * output_grad_ldim];
+    const size_t k_offset = j * embed_dim + h * qk_head_size;
+    const size_t v_offset = j * value_dim + h * v_head_size;
+
+    // Key and value vectors and their gradient accumulators
+    AccT kj[MaxHeadSize], vj[MaxHeadSize];
+    AccT dk[MaxHeadSize], dv[MaxHeadSize];
+#pragma unroll
+    for (size_t d = 0; d < MaxHeadSize; ++d) {
+      kj[d] = (active && d < qk_head_size)
+                ? static_cast<AccT>(keys[k * keys_ldim + k_offset + d])
+                : AccT(0);
+      vj[d] = (active && d < v_head_size)
+                ? static_cast<AccT>(values[k * values_ldim + v_offset + d])
+                : AccT(0);
+      dk[d] = AccT(0);
+      dv[d] = AccT(0);
+    }
+
+    for (size_t i0 = query_begin; i0 < num_queries; i0 += tile_size) {
+      __syncthreads();
+      load_tile(i0,
+                num_queries,
+                h * qk_head_size,
+                qk_head_size,
+                q_seq,
+                embed_dim,
+                shared_queries);
+      load_tile(i0,
+                num_queries,
+                h * v_head_size,
+                v_head_size,
+                dy_seq,
+                value_dim,
+                shared_output_grad);
+      for (size_t ii = threadIdx.x; ii < tile_size; ii += blockDim.x) {
+        const size_t i = i0 + ii;
+        const size_t pos = h * num_queries + i;
+        shared_stats[ii] =
+          i < num_queries ? stats[k * stats_ldim + pos] : AccT(0);
+        shared_dots[ii] =
+          i < num_queries ? dots[k * dots_ldim + pos] : AccT(0);
+      }
+      __syncthreads();
+      if (!active) {
+        continue;
+      }
+#pragma unroll
+      for (size_t ii = 0; ii < tile_size; ++ii) {
+        const size_t i = i0 + ii;
+        if (i >= num_queries || (causal && j > i)) {
+          continue;
+        }
+        AccT s = AccT(0), dp = AccT(0);
+#pragma unroll
+        for (size_t d = 0; d < MaxHeadSize; ++d) {
+          if (d < qk_head_size) {
+            s += shared_queries[ii * qk_head_size + d] * kj[d];
+          }
+          if (d < v_head_size) {
+            dp += shared_output_grad[ii * v_head_size + d] * vj[d];
+          }
+        }
+        const auto p = gpu_lib::exp(scale * s - shared_stats[ii]);
+        const auto ds = p * (dp - shared_dots[ii]);
+#pragma unroll
+        for (size_t d = 0; d < MaxHeadSize; ++d) {
+          if (d < qk_head_size) {
+            dk[d] += ds * shared_queries[ii * qk_head_size + d];
+          }
+          if (d < v_head_size) {
+            dv[d] += p * shared_output_grad[ii * v_head_size + d];
+          }
+        }
+      }
+    }
+
+    if (active) {
+      auto* dkj = &keys_grad[k * keys_grad_ldim + k_offset];
+      auto* dvj = &values_grad[k * values_grad_ldim + v_offset];
+#pragma unroll
+      for (size_t d = 0; d < MaxHeadSize; ++d) {
+        if (d < qk_head_size) {
+          dkj[d] = static_cast<TensorDataType>(scale * dk[d]);
+        }
+        if (d < v_head_size) {
+          dvj[d] = static_cast<TensorDataType>(dv[d]);
+        }
+      }
+    }
+  }
+}
+
+/** @brief Call @c f with the smallest supported head size bound
+ *         that fits @c head_size
+ *  @details Head vectors are kept in registers, so the bound is a
+ *           template parameter.
+ */
+template <typename Function>
+void dispatch_head_size(size_t head_size, Function f)
+{
+  if (head_size <= 32) {
+    f(std::integral_constant<size_t, 32>{});
+  }
+  else if (head_size <= 64) {
+    f(std::integral_constant<size_t, 64>{});
+  }
+  else if (head_size <= 128) {
+    f(std::integral_constant<size_t, 128>{});
+  }
+  else {
+    LBANN_ERROR("scaled dot-product attention on GPU ",
+                "does not support a head size of ",
+                head_size);
+  }
+}
+
+/** @brief Grid dimensions with one block per tile of a sequence */
+dim3 get_grid_dims(size_t sequence_length,
+                   size_t num_heads,
+                   size_t mini_batch_size)
+{
+  dim3 grid_dims;
+  grid_dims.x = (sequence_length + block_size - 1) / block_size;
+  grid_dims.y = num_heads;
+  grid_dims.z = mini_batch_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  return grid_dims;
+}
+
+} // namespace
+
+// =========================================================
+// Forward prop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  fp_compute()
+{
+  using AccT = AccType<TensorDataType>;
+  static_assert(std::is_same_v<AccT, StatType>,
+                "softmax statistics must use the accumulation type");
+
+  // Local matrices
+  using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+  const auto& queries =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& keys =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  const auto& values =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(2));
+  auto& output = dynamic_cast<LocalMat&>(this->get_local_activations());
+
+  // Dimensions
+  const size_t num_queries = this->get_input_dims(0)[0];
+  const size_t num_keys = this->get_input_dims(1)[0];
+  const size_t num_heads = m_num_heads;
+  const size_t qk_head_size = this->get_input_dims(0)[1] / num_heads;
+  const size_t v_head_size = this->get_input_dims(2)[1] / num_heads;
+  const size_t local_mini_batch_size = queries.Width();
+
+  auto& stats = m_softmax_stats;
+  stats.SetSyncInfo(gpu::get_sync_info(output));
+  stats.Resize(num_heads * num_queries, local_mini_batch_size);
+  if (local_mini_batch_size == 0) {
+    return;
+  }
+
+  // Launch CUDA kernel
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                     gpu::get_sync_info(stats),
+                                     gpu::get_sync_info(queries),
+                                     gpu::get_sync_info(keys),
+                                     gpu::get_sync_info(values));
+  const auto grid_dims =
+    get_grid_dims(num_queries, num_heads, local_mini_batch_size);
+  const size_t shared_size =
+    tile_size * (qk_head_size + v_head_size) * sizeof(AccT);
+  dispatch_head_size(El::Max(qk_head_size, v_head_size), [&](auto bound) {
+    hydrogen::gpu::LaunchKernel(
+      fp_kernel<TensorDataType, decltype(bound)::value>,
+      grid_dims,
+      dim3(block_size),
+      shared_size,
+      multisync,
+      num_queries,
+      num_keys,
+      num_heads,
+      qk_head_size,
+      v_head_size,
+      local_mini_batch_size,
+      m_causal,
+      get_scale(),
+      queries.LockedBuffer(),
+      size_t(queries.LDim()),
+      keys.LockedBuffer(),
+      size_t(keys.LDim()),
+      values.LockedBuffer(),
+      size_t(values.LDim()),
+      output.Buffer(),
+      size_t(output.LDim()),
+      stats.Buffer(),
+      size_t(stats.LDim()));
+  });
+}
+
+// =========================================================
+// Backprop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void scaled_dot_product_attention_layer<TensorDataType, Layout, Device>::
+  bp_compute()
+{
+  using AccT = AccType<TensorDataType>;
+
+  // Local matrices
+  using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+  const auto& queries =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& keys =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  const auto& values =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(2));
+  const auto& output =
+    dynamic_cast<const LocalMat&>(this->get_local_activations());
+  const auto& output_grad =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_error_signals());
+  auto& queries_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(0));
+  auto& keys_grad = dynamic_cast<LocalMat&>(this->get_local_error_signals(1));
+  auto& values_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(2));
+  const auto& stats = m_softmax_stats;
+
+  // Dimensions
+  const size_t num_queries = this->get_input_dims(0)[0];
+  const size_t num_keys = this->get_input_dims(1)[0];
+  const size_t num_heads = m_num_heads;
+  const size_t qk_head_size = this->get_input_dims(0)[1] / num_heads;
+  const size_t v_head_size = this->get_input_dims(2)[1] / num_heads;
+  const size_t local_mini_batch_size = queries.Width();
+  if (local_mini_batch_size == 0) {
+    return;
+  }
+  const auto scale = get_scale();
+
+  // Workspace for dy_i . y_i
+  El::Matrix<AccT, El::Device::GPU> dots;
+  dots.SetSyncInfo(gpu::get_sync_info(queries_grad));
+  dots.Resize(num_heads * num_queries, local_mini_batch_size);
+
+  const size_t max_head_size = El::Max(qk_head_size, v_head_size);
+
+  // Gradient w.r.t. queries
+  {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(queries_grad),
+                                       gpu::get_sync_info(dots),
+                                       gpu::get_sync_info(queries),
+                                       gpu::get_sync_info(keys),
+                                       gpu::get_sync_info(values),
+                                       gpu::get_sync_info(output),
+                                       gpu::get_sync_info(output_grad),
+                                       gpu::get_sync_info(stats));
+    const auto grid_dims =
+      get_grid_dims(num_queries, num_heads, local_mini_batch_size);
+    const size_t shared_size =
+      tile_size * (qk_head_size + v_head_size) * sizeof(AccT);
+    dispatch_head_size(max_head_size, [&](auto bound) {
+      hydrogen::gpu::LaunchKernel(
+        bp_queries_kernel<TensorDataType, decltype(bound)::value>,
+        grid_dims,
+        dim3(block_size),
+        shared_size,
+        multisync,
+        num_queries,
+        num_keys,
+        num_heads,
+        qk_head_size,
+        v_head_size,
+        local_mini_batch_size,
+        m_causal,
+        scale,
+        queries.LockedBuffer(),
+        size_t(queries.LDim()),
+        keys.LockedBuffer(),
+        size_t(keys.LDim()),
+        values.LockedBuffer(),
+        size_t(values.LDim()),
+        output.LockedBuffer(),
+        size_t(output.LDim()),
+        output_grad.LockedBuffer(),
+        size_t(output_grad.LDim()),
+        stats.LockedBuffer(),
+        size_t(stats.LDim()),
+        dots.Buffer(),
+        size_t(dots.LDim()),
+        queries_grad.Buffer(),
+        size_t(queries_grad.LDim()));
+    });
+  }
+
+  // Gradients w.r.t. keys and values
+  {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(keys_grad),
+                                       gpu::get_sync_info(values_grad),
+                                       gpu::get_sync_info(queries),
+                                       gpu::get_sync_info(keys),
+                                       gpu::get_sync_info(values),
+                                       gpu::get_sync_info(output_grad),
+                                       gpu::get_sync_info(stats),
+                                       gpu::get_sync_info(dots));
+    const auto grid_dims =
+      get_grid_dims(num_keys, num_heads, local_mini_batch_size);
+    const size_t shared_size =
+      tile_size * (qk_head_size + v_head_size + 2) * sizeof(AccT);
+    dispatch_head_size(max_head_size, [&](auto bound) {
+      hydrogen::gpu::LaunchKernel(
+        bp_keys_values_kernel<TensorDataType, decltype(bound)::value>,
+        grid_dims,
+        dim3(block_size),
+        shared_size,
+        multisync,
+        num_queries,
+        num_keys,
+        num_heads,
+        qk_head_size,
+        v_head_size,
+        local_mini_batch_size,
+        m_causal,
+        scale,
+        queries.LockedBuffer(),
+        size_t(queries.LDim()),
+        keys.LockedBuffer(),
+        size_t(keys.LDim()),
+        values.LockedBuffer(),
+        size_t(values.LDim()),
+        output_grad.LockedBuffer(),
+        size_t(output_grad.LDim()),
+        stats.LockedBuffer(),
+        size_t(stats.LDim()),
+        dots.LockedBuffer(),
+        size_t(dots.LDim()),
+        keys_grad.Buffer(),
+        size_t(keys_grad.LDim()),
+        values_grad.Buffer(),
+        size_t(values_grad.LDim()));
+    });
+  }
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#define PROTO(T)                                                               \
+  template class scaled_dot_product_attention_layer<                           \
+    T,                                                                         \
+    data_layout::DATA_PARALLEL,                                                \
+    El::Device::GPU>
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
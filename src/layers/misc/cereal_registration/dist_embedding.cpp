@@ -34,7 +34,8 @@ namespace lbann {
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 template <typename ArchiveT>
 void dist_embedding_layer<TensorDataType, Layout, Device>::serialize(
-  ArchiveT& ar)
+  ArchiveT& ar,
+  std::uint32_t const version)
 {
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
@@ -44,6 +45,10 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::serialize(
      CEREAL_NVP(m_sparse_sgd),
      CEREAL_NVP(m_learning_rate),
      CEREAL_NVP(m_barrier_in_forward_prop));
+  // Version 1 added the hot-row cache
+  if (version >= 1) {
+    ar(CEREAL_NVP(m_hot_cache_size), CEREAL_NVP(m_hot_cache_refresh_interval));
+  }
   // Members that aren't serialized
   //   m_embeddings_buffer
   //   m_workspace_buffer_size
@@ -58,8 +63,12 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::serialize(
 #include <lbann/macros/common_cereal_registration.hpp>
 #define LBANN_COMMA ,
 #define PROTO_DEVICE(TYPE, LAYOUT, DEVICE)                                     \
-  LBANN_ADD_ALL_SERIALIZE_ETI(::lbann::dist_embedding_layer<                   \
-                              TYPE LBANN_COMMA LAYOUT LBANN_COMMA DEVICE>);    \
+  CEREAL_CLASS_VERSION(                                                        \
+    ::lbann::dist_embedding_layer<TYPE LBANN_COMMA LAYOUT LBANN_COMMA DEVICE>, \
+    1)                                                                         \
+  LBANN_ADD_ALL_VERSIONED_SERIALIZE_ETI(::lbann::dist_embedding_layer<         \
+                                        TYPE LBANN_COMMA LAYOUT LBANN_COMMA    \
+                                          DEVICE>);                            \
   CEREAL_REGISTER_TYPE_WITH_NAME(                                              \
     ::lbann::dist_embedding_layer<TYPE LBANN_COMMA LAYOUT LBANN_COMMA DEVICE>, \
     "dist_embedding_layer (" #TYPE "," #LAYOUT "," #DEVICE ")");
@@ -28,6 +28,8 @@
 #include "lbann/layers/misc/channelwise_softmax_impl.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include <type_traits>
+
 namespace lbann {
 
 namespace {
@@ -38,12 +40,92 @@ using Size3 = gpu_lib::array<size_t, 3>;
 template <class T>
 struct max_op
 {
-  __device__ __forceinline__ DataType operator()(const T& x1, const T& x2) const
+  __device__ __forceinline__ T operator()(const T& x1, const T& x2) const
   {
     return gpu_lib::max(x1, x2);
   }
 };
 
+/** @brief Number of threads that share a channel in warp kernels
+ *
+ *  Each channel is processed by a group of this many threads within
+ *  a warp, with its entries held in registers.
+ */
+constexpr size_t warp_width = 32;
+
+/** @brief Number of warp groups in each CUDA block */
+constexpr size_t warps_per_block = 8;
+
+/** @brief Largest channel handled by the warp kernels
+ *
+ *  Larger channels are split over CUDA blocks.
+ */
+constexpr size_t max_warp_channel_size = 1024;
+
+/** @brief Channel entries held by each thread in warp kernels
+ *
+ *  Rounded up to a power of two so that only a few kernel variants
+ *  are instantiated.
+ */
+size_t get_items_per_thread(size_t channel_size)
+{
+  size_t items = 1;
+  while (items * warp_width < channel_size) {
+    items *= 2;
+  }
+  return items;
+}
+
+/** @brief Launch a warp kernel specialized for the channel size
+ *
+ *  @c launch is called with a constant holding the number of channel
+ *  entries per thread, which it uses to choose the kernel variant.
+ */
+template <typename Launcher>
+void dispatch_warp_kernel(size_t channel_size, Launcher&& launch)
+{
+  switch (get_items_per_thread(channel_size)) {
+  case 1:
+    launch(std::integral_constant<size_t, 1>{});
+    break;
+  case 2:
+    launch(std::integral_constant<size_t, 2>{});
+    break;
+  case 4:
+    launch(std::integral_constant<size_t, 4>{});
+    break;
+  case 8:
+    launch(std::integral_constant<size_t, 8>{});
+    break;
+  case 16:
+    launch(std::integral_constant<size_t, 16>{});
+    break;
+  case 32:
+    launch(std::integral_constant<size_t, 32>{});
+    break;
+  default:
+    LBANN_ERROR("channel size ",
+                channel_size,
+                " is too large for warp kernels (max ",
+                max_warp_channel_size,
+                ")");
+  }
+}
+
+/** @brief Grid dimensions for a warp kernel
+ *
+ *  Block dimensions: warp_width x warps_per_block x 1
+ *
+ *  Grid dimensions: (num_rows / warps_per_block) x 1 x 1
+ */
+void get_warp_launch_dims(size_t num_rows, dim3& block_dims, dim3& grid_dims)
+{
+  block_dims.x = warp_width;
+  block_dims.y = warps_per_block;
+  grid_dims.x = (num_rows + warps_per_block - 1) / warps_per_block;
+  gpu_lib::clip_grid_dims(grid_dims);
+}
+
 } // namespace
 
 // =========================================================
@@ -211,6 +293,76 @@ fp_output_kernel(Size3 input_dims,
   }
 }
 
+/** Compute softmax with one warp group per channel.
+ *
+ *  The channel is loaded into registers once, so the max, the
+ *  denominator, and the output are computed with a single read and
+ *  write of each entry.
+ *
+ *  Block dimensions: warp_width x warps_per_block x 1
+ *
+ *  Grid dimensions: (input_dims[0] * input_dims[1] / warps_per_block) x 1 x 1
+ */
+template <typename TensorDataType, size_t items_per_thread>
+__global__ void
+fp_warp_kernel(Size3 input_dims,
+               const TensorDataType* __restrict__ input_buffer,
+               Size3 input_strides,
+               TensorDataType* __restrict__ output_buffer,
+               Size3 output_strides)
+{
+
+  // Indices and dimensions
+  const size_t lane = threadIdx.x;
+  const size_t gidy = threadIdx.y + blockIdx.x * blockDim.y;
+  const size_t nwarps = blockDim.y * gridDim.x;
+  const size_t num_rows = input_dims[0] * input_dims[1];
+  const size_t channel_size = input_dims[2];
+
+  for (size_t row = gidy; row < num_rows; row += nwarps) {
+    const size_t k = row / input_dims[1];
+    const size_t j = row % input_dims[1];
+    const auto* __restrict__ x =
+      &input_buffer[k * input_strides[0] + j * input_strides[1]];
+    auto* __restrict__ y =
+      &output_buffer[k * output_strides[0] + j * output_strides[1]];
+
+    // Load channel and find largest value
+    TensorDataType vals[items_per_thread];
+    TensorDataType maxval{-gpu_lib::infinity<TensorDataType>()};
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t i = lane + item * warp_width;
+      vals[item] = (i < channel_size ? x[i * input_strides[2]]
+                                     : -gpu_lib::infinity<TensorDataType>());
+      maxval = gpu_lib::max(maxval, vals[item]);
+    }
+    maxval =
+      gpu_lib::warp_reduce<warp_width, TensorDataType, max_op<TensorDataType>>(
+        maxval);
+
+    // Compute softmax denominator
+    TensorDataType denom{0.};
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t i = lane + item * warp_width;
+      vals[item] = (i < channel_size ? gpu_lib::exp(vals[item] - maxval)
+                                     : TensorDataType{0.});
+      denom += vals[item];
+    }
+    denom = gpu_lib::warp_reduce<warp_width>(denom);
+
+    // Compute softmax
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t i = lane + item * warp_width;
+      if (i < channel_size) {
+        y[i * output_strides[2]] = vals[item] / denom;
+      }
+    }
+  }
+}
+
 /** @brief Forward prop */
 template <typename TensorDataType>
 void fp_impl(size_t num_channels,
@@ -232,6 +384,30 @@ void fp_impl(size_t num_channels,
   const size_t local_mini_batch_size = local_input.Width();
   // const Size3 input_dims{local_mini_batch_size, num_channels, channel_size};
 
+  // Short channels are handled by one warp group each
+  if (channel_size <= max_warp_channel_size) {
+    if (!local_input.IsEmpty()) {
+      dim3 block_dims, grid_dims;
+      get_warp_launch_dims(num_channels * local_mini_batch_size,
+                           block_dims,
+                           grid_dims);
+      dispatch_warp_kernel(channel_size, [&](auto items_per_thread) {
+        hydrogen::gpu::LaunchKernel(
+          fp_warp_kernel<TensorDataType, decltype(items_per_thread)::value>,
+          grid_dims,
+          block_dims,
+          0,
+          multisync,
+          Size3{local_mini_batch_size, num_channels, channel_size},
+          local_input.LockedBuffer(),
+          Size3{static_cast<size_t>(local_input.LDim()), channel_stride, 1},
+          local_output.Buffer(),
+          Size3{static_cast<size_t>(local_output.LDim()), channel_stride, 1});
+      });
+    }
+    return;
+  }
+
   // Compute softmax shifts
   LocalMat local_shifts;
   if (!local_input.IsEmpty()) {
@@ -455,6 +631,79 @@ bp_input_grad_kernel(Size3 output_dims,
   }
 }
 
+/** Compute gradient w.r.t. input with one warp group per channel.
+ *
+ *  dL/dx_i = y_i * ( dL/dy_i - dot(y,dL/dy) )
+ *
+ *  The dot product and the input gradient are computed in one pass
+ *  over the channel.
+ *
+ *  Block dimensions: warp_width x warps_per_block x 1
+ *
+ *  Grid dimensions: (output_dims[0] * output_dims[1] / warps_per_block) x 1 x
+ *  1
+ */
+template <typename TensorDataType, size_t items_per_thread>
+__global__ void
+bp_warp_kernel(Size3 output_dims,
+               const TensorDataType* __restrict__ output_buffer,
+               Size3 output_strides,
+               const TensorDataType* __restrict__ output_grad_buffer,
+               Size3 output_grad_strides,
+               TensorDataType* __restrict__ input_grad_buffer,
+               Size3 input_grad_strides)
+{
+
+  // Indices and dimensions
+  const size_t lane = threadIdx.x;
+  const size_t gidy = threadIdx.y + blockIdx.x * blockDim.y;
+  const size_t nwarps = blockDim.y * gridDim.x;
+  const size_t num_rows = output_dims[0] * output_dims[1];
+  const size_t channel_size = output_dims[2];
+
+  for (size_t row = gidy; row < num_rows; row += nwarps) {
+    const size_t k = row / output_dims[1];
+    const size_t j = row % output_dims[1];
+    const auto* __restrict__ y =
+      &output_buffer[k * output_strides[0] + j * output_strides[1]];
+    const auto* __restrict__ dy =
+      &output_grad_buffer[k * output_grad_strides[0] +
+                          j * output_grad_strides[1]];
+    auto* __restrict__ dx =
+      &input_grad_buffer[k * input_grad_strides[0] +
+                         j * input_grad_strides[1]];
+
+    // Load channel and compute dot(y,dL/dy)
+    TensorDataType y_vals[items_per_thread];
+    TensorDataType dy_vals[items_per_thread];
+    TensorDataType y_dot_dy{0.};
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t i = lane + item * warp_width;
+      if (i < channel_size) {
+        y_vals[item] = y[i * output_strides[2]];
+        dy_vals[item] = dy[i * output_grad_strides[2]];
+      }
+      else {
+        y_vals[item] = TensorDataType{0.};
+        dy_vals[item] = TensorDataType{0.};
+      }
+      y_dot_dy += y_vals[item] * dy_vals[item];
+    }
+    y_dot_dy = gpu_lib::warp_reduce<warp_width>(y_dot_dy);
+
+    // Compute gradient w.r.t. input
+#pragma unroll
+    for (size_t item = 0; item < items_per_thread; ++item) {
+      const size_t i = lane + item * warp_width;
+      if (i < channel_size) {
+        dx[i * input_grad_strides[2]] =
+          y_vals[item] * (dy_vals[item] - y_dot_dy);
+      }
+    }
+  }
+}
+
 /** @brief Backprop */
 template <typename TensorDataType>
 void bp_impl(size_t num_channels,
@@ -476,6 +725,39 @@ void bp_impl(size_t num_channels,
   // Dimensions
   const size_t local_mini_batch_size = local_output.Width();
 
+  // Short channels are handled by one warp group each
+  if (channel_size <= max_warp_channel_size) {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_input_grad),
+                                       gpu::get_sync_info(local_output_grad),
+                                       gpu::get_sync_info(local_output));
+    if (!local_output.IsEmpty()) {
+      dim3 block_dims, grid_dims;
+      get_warp_launch_dims(num_channels * local_mini_batch_size,
+                           block_dims,
+                           grid_dims);
+      dispatch_warp_kernel(channel_size, [&](auto items_per_thread) {
+        hydrogen::gpu::LaunchKernel(
+          bp_warp_kernel<TensorDataType, decltype(items_per_thread)::value>,
+          grid_dims,
+          block_dims,
+          0,
+          multisync,
+          Size3{local_mini_batch_size, num_channels, channel_size},
+          local_output.LockedBuffer(),
+          Size3{static_cast<size_t>(local_output.LDim()), channel_stride, 1},
+          local_output_grad.LockedBuffer(),
+          Size3{static_cast<size_t>(local_output_grad.LDim()),
+                channel_stride,
+                1},
+          local_input_grad.Buffer(),
+          Size3{static_cast<size_t>(local_input_grad.LDim()),
+                channel_stride,
+                1});
+      });
+    }
+    return;
+  }
+
   // dot(y,dL/dy)
   LocalMat local_y_dot_dy(num_channels, local_mini_batch_size);
   El::Zero(local_y_dot_dy);
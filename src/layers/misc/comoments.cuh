@@ -0,0 +1,280 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef LBANN_SRC_LAYERS_MISC_COMOMENTS_CUH_INCLUDED
+#define LBANN_SRC_LAYERS_MISC_COMOMENTS_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "comoments.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace comoments {
+namespace {
+
+/** @brief Device version of comoments::merge. */
+template <typename TensorDataType>
+__device__ void merge_device(El::Int& n_a,
+                             TensorDataType& mean0_a,
+                             TensorDataType& mean1_a,
+                             TensorDataType& c_a,
+                             El::Int n_b,
+                             TensorDataType mean0_b,
+                             TensorDataType mean1_b,
+                             TensorDataType c_b)
+{
+  if (n_b == 0) {
+    return;
+  }
+  const El::Int n = n_a + n_b;
+  const auto frac_b = TensorDataType(n_b) / TensorDataType(n);
+  const auto delta0 = mean0_b - mean0_a;
+  const auto delta1 = mean1_b - mean1_a;
+  mean0_a += delta0 * frac_b;
+  mean1_a += delta1 * frac_b;
+  c_a += c_b + delta0 * delta1 * TensorDataType(n_a) * frac_b;
+  n_a = n;
+}
+
+/** Each block accumulates the statistics of one column. Threads
+ *  apply Welford's update to a strided subset of the rows, then the
+ *  block merges their statistics.
+ */
+template <El::Int block_size, typename TensorDataType>
+__global__ void local_stats_kernel(El::Int height,
+                                   El::Int width,
+                                   const TensorDataType* input0,
+                                   El::Int input0_ldim,
+                                   const TensorDataType* input1,
+                                   El::Int input1_ldim,
+                                   TensorDataType* __restrict__ stats)
+{
+  const El::Int tid = threadIdx.x;
+  __shared__ El::Int shared_n[block_size];
+  __shared__ TensorDataType shared_mean0[block_size];
+  __shared__ TensorDataType shared_mean1[block_size];
+  __shared__ TensorDataType shared_c[block_size];
+
+  for (El::Int col = blockIdx.y; col < width; col += gridDim.y) {
+
+    // Statistics of each thread's rows
+    El::Int n = 0;
+    TensorDataType mean0 = 0, mean1 = 0, c = 0;
+    for (El::Int row = tid; row < height; row += block_size) {
+      ++n;
+      const auto& x0 = input0[row + col * input0_ldim];
+      const auto& x1 = input1[row + col * input1_ldim];
+      const auto scale = TensorDataType(1) / TensorDataType(n);
+      const auto delta0 = x0 - mean0;
+      mean0 += delta0 * scale;
+      mean1 += (x1 - mean1) * scale;
+      c += delta0 * (x1 - mean1);
+    }
+
+    // Shared memory reduction to get statistics of the column
+    __syncthreads();
+    shared_n[tid] = n;
+    shared_mean0[tid] = mean0;
+    shared_mean1[tid] = mean1;
+    shared_c[tid] = c;
+    for (El::Int stride = block_size / 2; stride > 0; stride /= 2) {
+      __syncthreads();
+      if (tid < stride) {
+        merge_device(shared_n[tid],
+                     shared_mean0[tid],
+                     shared_mean1[tid],
+                     shared_c[tid],
+                     shared_n[tid + stride],
+                     shared_mean0[tid + stride],
+                     shared_mean1[tid + stride],
+                     shared_c[tid + stride]);
+      }
+    }
+    if (tid == 0) {
+      stats[col * num_stats] = shared_mean0[0];
+      stats[col * num_stats + 1] = shared_mean1[0];
+      stats[col * num_stats + 2] = shared_c[0];
+    }
+  }
+}
+
+/** Each thread merges the statistics of one column over the blocks
+ *  of rows held by different processes.
+ */
+template <typename TensorDataType>
+__global__ void merge_stats_kernel(El::Int height,
+                                   El::Int width,
+                                   int col_align,
+                                   int num_blocks,
+                                   TensorDataType denom,
+                                   const TensorDataType* __restrict__ stats,
+                                   TensorDataType* __restrict__ means,
+                                   El::Int means_ldim,
+                                   TensorDataType* __restrict__ output,
+                                   El::Int output_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreads = blockDim.x * gridDim.x;
+  for (El::Int col = gid; col < width; col += nthreads) {
+    El::Int n = 0;
+    TensorDataType mean0 = 0, mean1 = 0, c = 0;
+    for (int block = 0; block < num_blocks; ++block) {
+      // Rows held by the process with this rank (see El::Length)
+      const int shift = (block + num_blocks - col_align) % num_blocks;
+      const El::Int n_b =
+        height > shift ? (height - shift - 1) / num_blocks + 1 : 0;
+      const auto* block_stats = &stats[(col + block * width) * num_stats];
+      merge_device(n,
+                   mean0,
+                   mean1,
+                   c,
+                   n_b,
+                   block_stats[0],
+                   block_stats[1],
+                   block_stats[2]);
+    }
+    means[col * means_ldim] = mean0;
+    means[col * means_ldim + 1] = mean1;
+    output[col * output_ldim] = c / denom;
+  }
+}
+
+} // namespace
+
+/** @brief GPU version of comoments::compute_cpu. */
+template <typename TensorDataType>
+void compute_gpu(El::AbstractDistMatrix<TensorDataType> const& input0,
+                 El::AbstractDistMatrix<TensorDataType> const& input1,
+                 El::AbstractDistMatrix<TensorDataType>& means,
+                 El::AbstractDistMatrix<TensorDataType>& workspace,
+                 bool biased)
+{
+  using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+
+  // Local matrices
+  const auto& local_input0 =
+    static_cast<const GPUMatType&>(input0.LockedMatrix());
+  const auto& local_input1 =
+    static_cast<const GPUMatType&>(input1.LockedMatrix());
+
+  // Dimensions
+  const auto& height = input0.Height();
+  const auto& width = input0.Width();
+  const auto& local_height = local_input0.Height();
+  const auto& local_width = local_input0.Width();
+  const int num_blocks = input0.ColStride();
+
+  means.Empty(false);
+  means.AlignWith(input0);
+  means.Resize(2, width);
+  workspace.Empty(false);
+  workspace.AlignWith(input0);
+  workspace.Resize(1, width);
+  auto& local_means = static_cast<GPUMatType&>(means.Matrix());
+  auto& local_workspace = static_cast<GPUMatType&>(workspace.Matrix());
+  if (local_width == 0) {
+    return;
+  }
+  auto sync_info = gpu::get_sync_info(local_workspace);
+
+  // Statistics of local rows
+  GPUMatType local_stats, gathered_stats;
+#ifdef HYDROGEN_HAVE_CUB
+  local_stats.SetMemoryMode(1);    // Use CUB GPU memory pool
+  gathered_stats.SetMemoryMode(1); // Use CUB GPU memory pool
+#endif                             // HYDROGEN_HAVE_CUB
+  El::SetSyncInfo(local_stats, sync_info);
+  El::SetSyncInfo(gathered_stats, sync_info);
+  local_stats.Resize(num_stats, local_width);
+  if (local_height == 0) {
+    El::Zero(local_stats);
+  }
+  else {
+    auto multisync = El::MakeMultiSync(sync_info,
+                                       gpu::get_sync_info(local_input0),
+                                       gpu::get_sync_info(local_input1));
+    constexpr El::Int block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.y = local_width;
+    gpu_lib::clip_grid_dims(grid_dims);
+    hydrogen::gpu::LaunchKernel(
+      local_stats_kernel<block_size, TensorDataType>,
+      grid_dims,
+      block_dims,
+      0,
+      multisync,
+      local_height,
+      local_width,
+      local_input0.LockedBuffer(),
+      local_input0.LDim(),
+      local_input1.LockedBuffer(),
+      local_input1.LDim(),
+      local_stats.Buffer());
+  }
+
+  // Exchange statistics with processes holding other rows
+  const GPUMatType* all_stats = &local_stats;
+  if (num_blocks > 1) {
+    const int count = num_stats * local_width;
+    gathered_stats.Resize(num_stats, local_width * num_blocks);
+    El::mpi::AllGather(local_stats.LockedBuffer(),
+                       count,
+                       gathered_stats.Buffer(),
+                       count,
+                       input0.ColComm(),
+                       sync_info);
+    all_stats = &gathered_stats;
+  }
+
+  // Merge statistics
+  const TensorDataType denom(biased ? height : height - 1);
+  auto multisync =
+    El::MakeMultiSync(sync_info, gpu::get_sync_info(local_means));
+  constexpr El::Int block_size = 256;
+  const El::Int grid_size = (local_width + block_size - 1) / block_size;
+  hydrogen::gpu::LaunchKernel(merge_stats_kernel<TensorDataType>,
+                              grid_size,
+                              block_size,
+                              0,
+                              multisync,
+                              height,
+                              local_width,
+                              input0.ColAlign(),
+                              num_blocks,
+                              denom,
+                              all_stats->LockedBuffer(),
+                              local_means.Buffer(),
+                              local_means.LDim(),
+                              local_workspace.Buffer(),
+                              local_workspace.LDim());
+}
+
+} // namespace comoments
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_LAYERS_MISC_COMOMENTS_CUH_INCLUDED
@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef LBANN_SRC_LAYERS_MISC_COMOMENTS_HPP_INCLUDED
+#define LBANN_SRC_LAYERS_MISC_COMOMENTS_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <vector>
+
+namespace lbann {
+namespace comoments {
+
+/** @brief Statistics kept for each matrix column.
+ *
+ *  Each column of a statistics matrix holds the means of two inputs
+ *  and their co-moment @f$ \sum (x_0 - \bar{x}_0)(x_1 - \bar{x}_1)
+ *  @f$ over a block of rows. The variance of @f$ x @f$ is the
+ *  co-moment of @f$ x @f$ with itself.
+ */
+constexpr El::Int num_stats = 3;
+
+/** @brief Number of rows of @c input held by process @c rank of its
+ *  column communicator.
+ */
+template <typename TensorDataType>
+El::Int block_height(El::AbstractDistMatrix<TensorDataType> const& input,
+                     int rank)
+{
+  auto const stride = input.ColStride();
+  return El::Length(input.Height(),
+                    El::Shift(rank, input.ColAlign(), stride),
+                    stride);
+}
+
+/** @brief Merge the statistics of block B into block A.
+ *
+ *  Uses the pairwise update of Chan, Golub and LeVeque, which stays
+ *  accurate when the two blocks have very different means.
+ */
+template <typename TensorDataType>
+void merge(El::Int& n_a,
+           TensorDataType& mean0_a,
+           TensorDataType& mean1_a,
+           TensorDataType& c_a,
+           El::Int n_b,
+           TensorDataType const& mean0_b,
+           TensorDataType const& mean1_b,
+           TensorDataType const& c_b)
+{
+  if (n_b == 0) {
+    return;
+  }
+  const El::Int n = n_a + n_b;
+  const auto frac_b = El::To<TensorDataType>(n_b) / El::To<TensorDataType>(n);
+  const auto delta0 = mean0_b - mean0_a;
+  const auto delta1 = mean1_b - mean1_a;
+  mean0_a += delta0 * frac_b;
+  mean1_a += delta1 * frac_b;
+  c_a += c_b + delta0 * delta1 * El::To<TensorDataType>(n_a) * frac_b;
+  n_a = n;
+}
+
+/** @brief Column-wise means and (co)variance in one pass over the
+ *  data.
+ *
+ *  Each process accumulates the statistics of its rows with Welford's
+ *  update. If the rows are split over several processes, their
+ *  statistics are exchanged in a single allgather and merged.
+ *
+ *  @param input0    First input matrix.
+ *  @param input1    Second input matrix. Pass @c input0 to compute
+ *                   the variance.
+ *  @param means     Column-wise means of the inputs (2 x width).
+ *  @param workspace Column-wise (co)variance (1 x width).
+ *  @param biased    Scale by @f$ 1/n @f$ instead of @f$ 1/(n-1) @f$.
+ */
+template <typename TensorDataType>
+void compute_cpu(El::AbstractDistMatrix<TensorDataType> const& input0,
+                 El::AbstractDistMatrix<TensorDataType> const& input1,
+                 El::AbstractDistMatrix<TensorDataType>& means,
+                 El::AbstractDistMatrix<TensorDataType>& workspace,
+                 bool biased)
+{
+  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  const auto one = El::TypeTraits<TensorDataType>::One();
+
+  // Local matrices
+  const auto& local_input0 =
+    static_cast<const CPUMatType&>(input0.LockedMatrix());
+  const auto& local_input1 =
+    static_cast<const CPUMatType&>(input1.LockedMatrix());
+
+  // Dimensions
+  const auto& height = input0.Height();
+  const auto& width = input0.Width();
+  const auto& local_height = local_input0.Height();
+  const auto& local_width = local_input0.Width();
+  const int num_blocks = input0.ColStride();
+
+  // Statistics of local rows
+  CPUMatType local_stats(num_stats, local_width);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    TensorDataType mean0 = zero, mean1 = zero, c = zero;
+    for (El::Int row = 0; row < local_height; ++row) {
+      const auto scale = one / El::To<TensorDataType>(row + 1);
+      const auto& x0 = local_input0(row, col);
+      const auto& x1 = local_input1(row, col);
+      const auto delta0 = x0 - mean0;
+      mean0 += delta0 * scale;
+      mean1 += (x1 - mean1) * scale;
+      c += delta0 * (x1 - mean1);
+    }
+    local_stats(0, col) = mean0;
+    local_stats(1, col) = mean1;
+    local_stats(2, col) = c;
+  }
+
+  // Exchange statistics with processes holding other rows
+  CPUMatType gathered_stats;
+  const CPUMatType* all_stats = &local_stats;
+  if (num_blocks > 1) {
+    gathered_stats.Resize(num_stats, local_width * num_blocks);
+    const int count = num_stats * local_width;
+    El::mpi::AllGather(local_stats.LockedBuffer(),
+                       count,
+                       gathered_stats.Buffer(),
+                       count,
+                       input0.ColComm(),
+                       El::SyncInfo<El::Device::CPU>{});
+    all_stats = &gathered_stats;
+  }
+
+  // Merge statistics
+  means.Empty(false);
+  means.AlignWith(input0);
+  means.Resize(2, width);
+  workspace.Empty(false);
+  workspace.AlignWith(input0);
+  workspace.Resize(1, width);
+  auto& local_means = static_cast<CPUMatType&>(means.Matrix());
+  auto& local_workspace = static_cast<CPUMatType&>(workspace.Matrix());
+  std::vector<El::Int> block_heights(num_blocks);
+  for (int block = 0; block < num_blocks; ++block) {
+    block_heights[block] = block_height(input0, block);
+  }
+  const auto denom = El::To<TensorDataType>(biased ? height : height - 1);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_width; ++col) {
+    El::Int n = 0;
+    TensorDataType mean0 = zero, mean1 = zero, c = zero;
+    for (int block = 0; block < num_blocks; ++block) {
+      const auto pos = col + block * local_width;
+      merge(n,
+            mean0,
+            mean1,
+            c,
+            block_heights[block],
+            (*all_stats)(0, pos),
+            (*all_stats)(1, pos),
+            (*all_stats)(2, pos));
+    }
+    local_means(0, col) = mean0;
+    local_means(1, col) = mean1;
+    local_workspace(0, col) = c / denom;
+  }
+}
+
+} // namespace comoments
+} // namespace lbann
+
+#endif // LBANN_SRC_LAYERS_MISC_COMOMENTS_HPP_INCLUDED
@@ -27,13 +27,15 @@
 #define LBANN_COVARIANCE_LAYER_INSTANTIATE
 #include "lbann/layers/misc/covariance_impl.hpp"
 
+#include "comoments.hpp"
+
 namespace lbann {
 
 namespace {
 
 /** CPU forward prop implementation.
- *  We use a two-pass algorithm since it is more numerically stable
- *  than the naive single-pass algorithm.
+ *  Means and the covariance are computed in one pass, which is as
+ *  accurate as a two-pass algorithm (see comoments::compute_cpu).
  */
 template <typename TensorDataType>
 void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input0,
@@ -43,56 +45,7 @@ void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input0,
             El::AbstractDistMatrix<TensorDataType>& workspace,
             bool biased)
 {
-  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
-
-  // Local matrices
-  const auto& local_input0 =
-    static_cast<const CPUMatType&>(input0.LockedMatrix());
-  const auto& local_input1 =
-    static_cast<const CPUMatType&>(input1.LockedMatrix());
-  auto& local_means = static_cast<CPUMatType&>(means.Matrix());
-  auto& local_workspace = static_cast<CPUMatType&>(workspace.Matrix());
-
-  // Dimensions
-  const auto& height = input0.Height();
-  const auto& width = input0.Width();
-  const auto& local_height = local_input0.Height();
-  const auto& local_width = local_input0.Width();
-
-  // Compute column-wise mean
-  means.Empty(false);
-  means.AlignWith(input0);
-  means.Resize(2, width);
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    TensorDataType sum0 = El::TypeTraits<TensorDataType>::Zero(),
-                   sum1 = El::TypeTraits<TensorDataType>::Zero();
-    for (El::Int row = 0; row < local_height; ++row) {
-      sum0 += local_input0(row, col);
-      sum1 += local_input1(row, col);
-    }
-    local_means(0, col) = sum0 / height;
-    local_means(1, col) = sum1 / height;
-  }
-  El::AllReduce(means, means.RedundantComm());
-
-  // Compute column-wise covariance
-  workspace.Empty(false);
-  workspace.AlignWith(input0);
-  workspace.Resize(1, width);
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    const auto& mean0 = local_means(0, col);
-    const auto& mean1 = local_means(1, col);
-    TensorDataType sum = El::TypeTraits<TensorDataType>::Zero();
-    for (El::Int row = 0; row < local_height; ++row) {
-      const auto& x0 = local_input0(row, col);
-      const auto& x1 = local_input1(row, col);
-      sum += (x0 - mean0) * (x1 - mean1);
-    }
-    local_workspace(0, col) = sum / (biased ? height : height - 1);
-  }
-  El::AllReduce(workspace, workspace.RedundantComm());
+  comoments::compute_cpu(input0, input1, means, workspace, biased);
   El::Copy(workspace, output);
 }
 
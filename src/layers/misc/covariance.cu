@@ -28,118 +28,12 @@
 #include "lbann/layers/misc/covariance_impl.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "comoments.cuh"
+
 namespace lbann {
 
 namespace {
 
-/** Compute local contributions to means.
- *  Computes column-wise sums of two input matrices and multiplies
- *  them by a scaling factor (which should be
- *  1/height). 'contribution' is interpreted as a 2 x width matrix
- *  where the first row corresponds to 'input0' and the second row to
- *  'input1'.
- */
-template <typename TensorDataType, El::Int block_size>
-__global__ void
-mean_contribution_kernel(El::Int height,
-                         El::Int width,
-                         TensorDataType scale,
-                         const TensorDataType* __restrict__ input0,
-                         El::Int input0_ldim,
-                         const TensorDataType* __restrict__ input1,
-                         El::Int input1_ldim,
-                         TensorDataType* __restrict__ contribution)
-{
-
-  // Indices
-  const El::Int tid = threadIdx.x;
-  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
-  const El::Int bidy = blockIdx.y;
-  const El::Int nthreadsx = blockDim.x * gridDim.x;
-
-  // Compute local contribution for each matrix column
-  for (El::Int col = bidy; col < width; col += gridDim.y) {
-
-    // Compute contributions for each thread
-    TensorDataType private_contribution0 = 0;
-    TensorDataType private_contribution1 = 0;
-    for (El::Int row = gidx; row < height; row += nthreadsx) {
-      private_contribution0 += input0[row + col * input0_ldim];
-      private_contribution1 += input1[row + col * input1_ldim];
-    }
-
-    // Shared memory reduction to get contribution for each block
-    /// @todo unroll loops
-    __shared__ TensorDataType shared_contribution0[block_size];
-    __shared__ TensorDataType shared_contribution1[block_size];
-    shared_contribution0[tid] = private_contribution0;
-    shared_contribution1[tid] = private_contribution1;
-    for (El::Int stride = block_size / 2; stride > 0; stride /= 2) {
-      __syncthreads();
-      if (tid < stride) {
-        shared_contribution0[tid] += shared_contribution0[tid + stride];
-        shared_contribution1[tid] += shared_contribution1[tid + stride];
-      }
-    }
-    if (tid == 0) {
-      gpu_lib::atomic_add(&contribution[2 * col],
-                          scale * shared_contribution0[0]);
-      gpu_lib::atomic_add(&contribution[2 * col + 1],
-                          scale * shared_contribution1[0]);
-    }
-  }
-}
-
-/** Compute local contributions to covariances. */
-template <typename TensorDataType, El::Int block_size>
-__global__ void
-covariance_contribution_kernel(El::Int height,
-                               El::Int width,
-                               TensorDataType scale,
-                               const TensorDataType* __restrict__ input0,
-                               El::Int input0_ldim,
-                               const TensorDataType* __restrict__ input1,
-                               El::Int input1_ldim,
-                               const TensorDataType* __restrict__ means,
-                               TensorDataType* __restrict__ contribution)
-{
-
-  // Indices
-  const El::Int tid = threadIdx.x;
-  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
-  const El::Int bidy = blockIdx.y;
-  const El::Int nthreadsx = blockDim.x * gridDim.x;
-
-  // Compute local contribution for each matrix column
-  for (El::Int col = bidy; col < width; col += gridDim.y) {
-    const auto& mean0 = means[2 * col];
-    const auto& mean1 = means[2 * col + 1];
-
-    // Compute contributions for each thread
-    TensorDataType private_contribution = 0;
-    for (El::Int row = gidx; row < height; row += nthreadsx) {
-      const auto& x0 = input0[row + col * input0_ldim];
-      const auto& x1 = input1[row + col * input1_ldim];
-      private_contribution += (x0 - mean0) * (x1 - mean1);
-    }
-
-    // Shared memory reduction to get contribution for each block
-    /// @todo unroll loops
-    __shared__ TensorDataType shared_contribution[block_size];
-    shared_contribution[tid] = private_contribution;
-    for (El::Int stride = block_size / 2; stride > 0; stride /= 2) {
-      __syncthreads();
-      if (tid < stride) {
-        shared_contribution[tid] += shared_contribution[tid + stride];
-      }
-    }
-    if (tid == 0) {
-      gpu_lib::atomic_add(&contribution[col], scale * shared_contribution[0]);
-    }
-  }
-}
-
-/** Compute gradients w.r.t. inputs. */
 template <typename TensorDataType>
 __global__ void covariance_backprop_kernel(
   El::Int height,
@@ -175,8 +69,8 @@ __global__ void covariance_backprop_kernel(
 }
 
 /** GPU forward prop implementation.
- *  We use a two-pass algorithm since it is more numerically stable
- *  than the naive single-pass algorithm.
+ *  Means and the covariance are computed in one pass, which is as
+ *  accurate as a two-pass algorithm (see comoments::compute_gpu).
  */
 template <typename TensorDataType>
 void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input0,
@@ -186,92 +80,7 @@ void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input0,
             El::AbstractDistMatrix<TensorDataType>& workspace,
             bool biased)
 {
-
-  // Local matrices
-  const auto& local_input0 =
-    static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(
-      input0.LockedMatrix());
-  const auto& local_input1 =
-    static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(
-      input1.LockedMatrix());
-  auto& local_means =
-    static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(means.Matrix());
-  auto& local_workspace =
-    static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
-      workspace.Matrix());
-
-  // Dimensions
-  const auto& height = input0.Height();
-  const auto& width = input0.Width();
-  const auto& local_height = local_input0.Height();
-  const auto& local_width = local_input0.Width();
-
-  // Compute column-wise mean
-  means.Empty(false);
-  means.AlignWith(input0);
-  El::Zeros(means, 2, width);
-  if (!local_input0.IsEmpty()) {
-    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_means),
-                                       gpu::get_sync_info(local_input0),
-                                       gpu::get_sync_info(local_input1));
-    constexpr El::Int block_size = 256;
-    dim3 block_dims, grid_dims;
-    block_dims.x = block_size;
-    grid_dims.x = (local_height + block_size - 1) / block_size;
-    grid_dims.y = local_width;
-    const auto& scale =
-      El::TypeTraits<TensorDataType>::One() / TensorDataType(height);
-    hydrogen::gpu::LaunchKernel(
-      mean_contribution_kernel<TensorDataType, block_size>,
-      grid_dims,
-      block_dims,
-      0,
-      multisync,
-      local_height,
-      local_width,
-      scale,
-      local_input0.LockedBuffer(),
-      local_input0.LDim(),
-      local_input1.LockedBuffer(),
-      local_input1.LDim(),
-      local_means.Buffer());
-  }
-  El::AllReduce(means, means.RedundantComm());
-
-  // Compute column-wise covariance
-  workspace.Empty(false);
-  workspace.AlignWith(input0);
-  El::Zeros(workspace, 1, width);
-  if (!local_input0.IsEmpty()) {
-    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_workspace),
-                                       gpu::get_sync_info(local_means),
-                                       gpu::get_sync_info(local_input0),
-                                       gpu::get_sync_info(local_input1));
-    constexpr El::Int block_size = 256;
-    dim3 block_dims, grid_dims;
-    block_dims.x = block_size;
-    grid_dims.x = (local_height + block_size - 1) / block_size;
-    grid_dims.y = local_width;
-    const auto& scale =
-      El::TypeTraits<TensorDataType>::One() /
-      (biased ? TensorDataType(height) : TensorDataType(height - 1));
-    hydrogen::gpu::LaunchKernel(
-      covariance_contribution_kernel<TensorDataType, block_size>,
-      grid_dims,
-      block_dims,
-      0,
-      multisync,
-      local_height,
-      local_width,
-      scale,
-      local_input0.LockedBuffer(),
-      local_input0.LDim(),
-      local_input1.LockedBuffer(),
-      local_input1.LDim(),
-      local_means.LockedBuffer(),
-      local_workspace.Buffer());
-  }
-  El::AllReduce(workspace, workspace.RedundantComm());
+  comoments::compute_gpu(input0, input1, means, workspace, biased);
   El::Copy(workspace, output);
 }
 
@@ -170,7 +170,13 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::fp_compute()
             m_metadata_buffer + m_metadata_buffer_size,
             vector_metadata());
 
+  // Refresh cached embedding vectors
+  update_hot_cache(embeddings);
+  const bool count_lookups = m_hot_cache_size > 0;
+  ++m_forward_props_since_refresh;
+
   // Get embedding vectors from owner processes
+  // Note: Cached embedding vectors are copied locally.
   const size_t rank = comm.get_rank_in_trainer();
   for (size_t j = 0; j < local_mini_batch_size; ++j) {
     for (size_t i = 0; i < input_size; ++i) {
@@ -189,8 +195,19 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::fp_compute()
         m.is_active = true;
       }
 
-      // Get embedding vector from owner process
-      if (m.is_active) {
+      // Get embedding vector from cache or owner process
+      const auto hot_row =
+        std::lower_bound(m_hot_rows.begin(), m_hot_rows.end(), global_index);
+      if (m.is_active && count_lookups) {
+        m_access_counts(global_index, 0) += 1.f;
+      }
+      if (m.is_active && hot_row != m_hot_rows.end() &&
+          *hot_row == global_index) {
+        const auto* x =
+          m_hot_cache.LockedBuffer(0, hot_row - m_hot_rows.begin());
+        std::copy(x, x + m_embedding_dim, workspace.Buffer(0, m.target_index));
+      }
+      else if (m.is_active) {
         shmem_getmem_nbi(workspace.Buffer(0, m.target_index),
                          embeddings.LockedBuffer(0, m.source_index),
                          m_embedding_dim * sizeof(TensorDataType),
@@ -268,6 +285,15 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::bp_compute()
   // Note: Gradients have been sent.
   nb_barrier(comm, comm.get_trainer_comm(), m_nb_barrier_request);
 
+  // Pass sparse gradients to the optimizer if it supports them
+  auto* sparse_opt = dynamic_cast<data_type_optimizer<TensorDataType>*>(
+    this->get_weights(0).get_optimizer());
+  if (!m_sparse_sgd && sparse_opt != nullptr &&
+      sparse_gradient::is_supported(*this->m_model, *sparse_opt)) {
+    add_sparse_gradient(input_size * mini_batch_size, *sparse_opt);
+    return;
+  }
+
   // Use dense optimizer if needed
   if (!m_sparse_sgd) {
 
@@ -335,6 +361,40 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::
   }
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void dist_embedding_layer<TensorDataType, Layout, Device>::add_sparse_gradient(
+  size_t num_gradients,
+  data_type_optimizer<TensorDataType>& opt)
+{
+
+  // Synchronize non-blocking barrier
+  // Note: Make sure gradients have been received.
+  auto& comm = *this->get_comm();
+  comm.wait(m_nb_barrier_request);
+
+  // Initialize SHMEM buffer for gradient w.r.t. embeddings
+  LocalMat local_embeddings_grad(m_embedding_dim,
+                                 num_gradients,
+                                 m_workspace_buffer,
+                                 m_embedding_dim);
+
+  // Gradients for local embeddings
+  const size_t rank = comm.get_rank_in_trainer();
+  std::vector<El::Int> cols, workspace_cols;
+  for (size_t i = 0; i < num_gradients; ++i) {
+    const auto& m = m_metadata_buffer[i];
+    if (m.is_active && m.source_rank == rank) {
+      cols.push_back(m.source_index);
+      workspace_cols.push_back(m.target_index);
+    }
+  }
+  LocalMat values;
+  sparse_gradient::gather_columns(local_embeddings_grad,
+                                  workspace_cols,
+                                  values);
+  opt.add_to_sparse_gradient(cols, values);
+}
+
 } // namespace lbann
 #endif // LBANN_HAS_SHMEM
 
@@ -407,7 +467,9 @@ build_dist_embedding_layer_from_pbuf(lbann_comm* comm,
                             params.embedding_dim(),
                             params.sparse_sgd(),
                             params.learning_rate(),
-                            params.barrier_in_forward_prop());
+                            params.barrier_in_forward_prop(),
+                            params.hot_cache_size(),
+                            params.hot_cache_refresh_interval());
 }
 
 // ---------------------------------------------
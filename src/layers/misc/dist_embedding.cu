@@ -237,6 +237,11 @@ request_embeddings_kernel(size_t num_embeddings,
                           Size2 metadata_strides,
                           T* __restrict__ workspace,
                           Size2 workspace_strides,
+                          float* __restrict__ access_counts,
+                          const El::Int* __restrict__ hot_rows,
+                          size_t num_hot_rows,
+                          const T* __restrict__ hot_cache,
+                          Size2 hot_cache_strides,
                           size_t rank,
                           size_t input_rowshift,
                           size_t input_rowstride,
@@ -266,8 +271,10 @@ request_embeddings_kernel(size_t num_embeddings,
 
       // Figure out which process owns embedding vector
       __shared__ unsigned char metadata_shared[sizeof(VectorMetadata<T>)];
+      __shared__ El::Int hot_slot;
       auto& m = *reinterpret_cast<VectorMetadata<T>*>(metadata_shared);
       if (threadIdx.x == 0) {
+        hot_slot = -1;
         m = VectorMetadata<T>();
         m.target_rank = rank;
         m.target_index = i + global_j * input_dims[1];
@@ -281,13 +288,36 @@ request_embeddings_kernel(size_t num_embeddings,
                                                embeddings_rowalign,
                                                embeddings_rowstride);
           m.is_active = true;
+
+          // Count lookup and search cached embedding vectors
+          if (access_counts != nullptr) {
+            gpu_lib::atomic_add(&access_counts[global_index], 1.f);
+          }
+          size_t lo = 0, hi = num_hot_rows;
+          while (lo < hi) {
+            const size_t mid = (lo + hi) / 2;
+            if (hot_rows[mid] < global_index) {
+              lo = mid + 1;
+            }
+            else {
+              hi = mid;
+            }
+          }
+          if (lo < num_hot_rows && hot_rows[lo] == global_index) {
+            hot_slot = lo;
+          }
         }
         metadata[i * metadata_strides[1] + global_j * metadata_strides[0]] = m;
       }
       __syncwarp();
 
-      // Get embedding vector from owner process
-      if (m.is_active) {
+      // Get embedding vector from cache or owner process
+      if (hot_slot >= 0) {
+        memcpy_warp(&workspace[m.target_index * workspace_strides[0]],
+                    &hot_cache[hot_slot * hot_cache_strides[0]],
+                    embedding_dim);
+      }
+      else if (m.is_active) {
         nvshmemx_getmem_nbi_warp(
           &workspace[m.target_index * workspace_strides[0]],
           &embeddings[m.source_index * embeddings_strides[0]],
@@ -374,17 +404,13 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::fp_compute()
   auto&& stream = sync_info.Stream();
   nvshmem::initialize();
 
-  // Barrier to handle gradient checking
-  /// @todo Think of a way to avoid this synchronization
-  if (m_barrier_in_forward_prop) {
-    nvshmemx_barrier_all_on_stream(stream);
-  }
-
-  // Synchronize non-blocking barrier
-  // Note: Make sure embeddings are up-to-date and NVSHMEM workspaces
-  // are safe to reset.
+  // Stream-ordered barrier
+  // Note: Make sure embeddings are up-to-date and that peers have
+  // consumed the gradients from the previous step. This also covers
+  // gradient checking, which changes the embeddings without
+  // synchronizing.
+  nvshmemx_barrier_all_on_stream(stream);
   auto& comm = *this->get_comm();
-  comm.wait(m_nb_barrier_request);
 
   // Initialize NVSHMEM buffer for communicating embedding vectors
   if (m_workspace_buffer_size < output_size * mini_batch_size) {
@@ -398,16 +424,27 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::fp_compute()
                      m_embedding_dim);
 
   // Initialize NVSHMEM buffer for embedding vector metadata
+  // Note: The metadata is normally reset as soon as the gradients
+  // are consumed, so peers can send gradients without waiting for
+  // this forward prop. Fresh or stale buffers are reset here, with
+  // a barrier so no peer sends gradients before the reset.
+  bool reset_metadata = m_gradients_pending;
   if (m_metadata_buffer_size < input_size * mini_batch_size) {
     m_metadata_buffer_size = input_size * mini_batch_size;
     m_metadata_buffer =
       nvshmem::realloc(m_metadata_buffer, m_metadata_buffer_size);
+    reset_metadata = true;
   }
-  /// @todo Use generic GPU API
-  CHECK_CUDA(cudaMemsetAsync(m_metadata_buffer,
-                             0,
-                             m_metadata_buffer_size * sizeof(vector_metadata),
-                             stream));
+  if (reset_metadata) {
+    reset_metadata_buffer(stream);
+    nvshmemx_barrier_all_on_stream(stream);
+  }
+
+  // Refresh cached embedding vectors
+  m_hot_cache.SetSyncInfo(sync_info);
+  m_access_counts.SetSyncInfo(sync_info);
+  update_hot_cache(embeddings);
+  ++m_forward_props_since_refresh;
 
   // Request embedding vectors from owning processes
   const size_t rank = comm.get_rank_in_trainer();
@@ -433,6 +470,12 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::fp_compute()
                                 Size2{input_size, 1},
                                 workspace.Buffer(),
                                 Size2{size_t(workspace.LDim()), 1},
+                                (m_hot_cache_size > 0 ? m_access_counts.Buffer()
+                                                      : nullptr),
+                                m_hot_rows_device.LockedBuffer(),
+                                m_hot_rows.size(),
+                                m_hot_cache.LockedBuffer(),
+                                Size2{size_t(m_hot_cache.LDim()), 1},
                                 rank,
                                 input.RowShift(),
                                 input.RowStride(),
@@ -464,10 +507,18 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::fp_compute()
                                 input.RowShift(),
                                 input.RowStride());
   }
+}
 
-  // Non-blocking barrier
-  // Note: NVSHMEM workspaces are ready to recieve gradients.
-  nb_barrier(comm, comm.get_trainer_comm(), m_nb_barrier_request);
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void dist_embedding_layer<TensorDataType, Layout, Device>::
+  reset_metadata_buffer(cudaStream_t stream)
+{
+  /// @todo Use generic GPU API
+  CHECK_CUDA(cudaMemsetAsync(m_metadata_buffer,
+                             0,
+                             m_metadata_buffer_size * sizeof(vector_metadata),
+                             stream));
+  m_gradients_pending = false;
 }
 
 // ---------------------------------------------
@@ -556,10 +607,8 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::bp_compute()
   const El::SyncInfo<El::Device::GPU>& sync_info = multisync;
   auto&& stream = sync_info.Stream();
 
-  // Synchronize non-blocking barrier
-  // Note: Make sure NVSHMEM workspaces are ready to recieve gradients.
-  auto& comm = *this->get_comm();
-  comm.wait(m_nb_barrier_request);
+  // Note: Peers reset their metadata before the barrier in forward
+  // prop, so NVSHMEM workspaces are ready to recieve gradients.
 
   // Initialize NVSHMEM buffer for gradient w.r.t. embeddings
   LocalMat workspace(m_embedding_dim,
@@ -591,10 +640,16 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::bp_compute()
                                 input.RowStride());
   }
   nvshmemx_quiet_on_stream(stream);
-
-  // Non-blocking barrier
-  // Note: Gradients have been sent.
-  nb_barrier(comm, comm.get_trainer_comm(), m_nb_barrier_request);
+  m_gradients_pending = true;
+
+  // Pass sparse gradients to the optimizer if it supports them
+  auto* sparse_opt = dynamic_cast<data_type_optimizer<TensorDataType>*>(
+    this->get_weights(0).get_optimizer());
+  if (!m_sparse_sgd && sparse_opt != nullptr &&
+      sparse_gradient::is_supported(*this->m_model, *sparse_opt)) {
+    add_sparse_gradient(input_size * mini_batch_size, *sparse_opt);
+    return;
+  }
 
   // Use dense optimizer if needed
   if (!m_sparse_sgd) {
@@ -680,11 +735,12 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::
 
   // GPU objects
   auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_embeddings));
+  const El::SyncInfo<El::Device::GPU>& sync_info = multisync;
 
-  // Synchronize non-blocking barrier
+  // Stream-ordered barrier
   // Note: Make sure gradients have been received.
+  nvshmemx_barrier_all_on_stream(sync_info.Stream());
   auto& comm = *this->get_comm();
-  comm.wait(m_nb_barrier_request);
 
   // Initialize SHMEM buffer for gradient w.r.t. embeddings
   LocalMat local_embeddings_grad(m_embedding_dim,
@@ -710,6 +766,57 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::
                               local_embeddings.Buffer(),
                               Size2{size_t(local_embeddings.LDim()), 1},
                               rank);
+
+  // Gradients have been consumed
+  reset_metadata_buffer(sync_info.Stream());
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void dist_embedding_layer<TensorDataType, Layout, Device>::add_sparse_gradient(
+  size_t num_gradients,
+  data_type_optimizer<TensorDataType>& opt)
+{
+
+  // Initialize SHMEM buffer for gradient w.r.t. embeddings
+  LocalMat local_embeddings_grad(m_embedding_dim,
+                                 num_gradients,
+                                 m_workspace_buffer,
+                                 m_embedding_dim);
+
+  // Stream-ordered barrier
+  // Note: Make sure gradients have been received.
+  auto sync_info = gpu::get_sync_info(local_embeddings_grad);
+  nvshmemx_barrier_all_on_stream(sync_info.Stream());
+  auto& comm = *this->get_comm();
+
+  // Metadata for received gradients
+  // Note: Needed on host to build column indices, so this path waits
+  // for the device.
+  std::vector<vector_metadata> metadata(num_gradients);
+  hydrogen::gpu::Copy1DToHost(m_metadata_buffer,
+                              metadata.data(),
+                              num_gradients,
+                              sync_info);
+  El::Synchronize(sync_info);
+
+  // Gradients for local embeddings
+  const size_t rank = comm.get_rank_in_trainer();
+  std::vector<El::Int> cols, workspace_cols;
+  for (const auto& m : metadata) {
+    if (m.is_active && m.source_rank == rank) {
+      cols.push_back(m.source_index);
+      workspace_cols.push_back(m.target_index);
+    }
+  }
+  LocalMat values;
+  values.SetSyncInfo(sync_info);
+  sparse_gradient::gather_columns(local_embeddings_grad,
+                                  workspace_cols,
+                                  values);
+  opt.add_to_sparse_gradient(cols, values);
+
+  // Gradients have been consumed
+  reset_metadata_buffer(sync_info.Stream());
 }
 
 // ---------------------------------------------
@@ -24,13 +24,23 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 
+#define LBANN_EXTERNAL_LAYER_INSTANTIATE
 #include "lbann/layers/misc/external.hpp"
+#include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
+#include "lbann/proto/layers.pb.h"
+#include "lbann/utils/description.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/sync_info_helpers.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu_workspace.hpp"
+#endif // LBANN_HAS_GPU
 
 #include <algorithm>
 #include <cstdio>
 #include <dlfcn.h>
+#include <type_traits>
 
 namespace lbann {
 
@@ -74,4 +84,402 @@ external_layer_setup_t load_external_library(const std::string& filename,
   return setup_funcptr;
 }
 
+namespace {
+
+using external_kernel_getter_t = const lbann_external_kernel* (*)();
+
+/** @brief Find the function that returns a kernel's function table
+ *
+ *  Returns null if the library does not export it.
+ */
+external_kernel_getter_t find_external_kernel(const external_library& library,
+                                              const std::string& kernel_name)
+{
+  const std::string funcname = "lbann_external_kernel_" + kernel_name;
+  return (external_kernel_getter_t)dlsym(library.get(), funcname.c_str());
+}
+
+/** @brief Throw if an external kernel returns an error code */
+void check_external_kernel(int status,
+                           const char* function,
+                           const std::string& kernel_name)
+{
+  if (status != 0) {
+    LBANN_ERROR("External kernel \"",
+                kernel_name,
+                "\" failed in ",
+                function,
+                " (status ",
+                status,
+                ")");
+  }
+}
+
+/** @brief Shape of a sample for an external kernel */
+lbann_external_shape make_external_shape(const std::vector<int>& dims)
+{
+  if (dims.size() > LBANN_EXTERNAL_MAX_DIMS) {
+    LBANN_ERROR("External kernels support tensors with at most ",
+                LBANN_EXTERNAL_MAX_DIMS,
+                " dimensions, but got ",
+                dims.size());
+  }
+  lbann_external_shape shape{};
+  shape.num_dims = dims.size();
+  std::copy(dims.cbegin(), dims.cend(), shape.dims);
+  return shape;
+}
+
+/** @brief View of a local matrix for an external kernel
+ *
+ *  The kernel must not write to views of input tensors.
+ */
+template <typename TensorDataType>
+lbann_external_tensor
+make_external_tensor(const El::AbstractMatrix<TensorDataType>& mat,
+                     const std::vector<int>& dims)
+{
+  lbann_external_tensor tensor{};
+  tensor.data = const_cast<TensorDataType*>(mat.LockedBuffer());
+  tensor.height = mat.Height();
+  tensor.width = mat.Width();
+  tensor.ldim = mat.LDim();
+  tensor.shape = make_external_shape(dims);
+  return tensor;
+}
+
+} // namespace
+
+external_library open_external_library(const std::string& filename)
+{
+  void* handle = dlopen(filename.c_str(), RTLD_LAZY);
+  if (!handle) {
+    LBANN_ERROR("Cannot load library for external kernel (filename: \"",
+                filename,
+                "\"). Reason: ",
+                dlerror());
+  }
+  return external_library(handle, [](void* h) { dlclose(h); });
+}
+
+bool has_external_kernel(const std::string& filename,
+                         const std::string& kernel_name)
+{
+  auto library = open_external_library(filename);
+  return find_external_kernel(library, kernel_name) != nullptr;
+}
+
+const lbann_external_kernel*
+load_external_kernel(const external_library& library,
+                     const std::string& filename,
+                     const std::string& kernel_name)
+{
+  auto getter = find_external_kernel(library, kernel_name);
+  if (!getter) {
+    LBANN_ERROR("Malformed external library (filename: \"",
+                filename,
+                "\"). Reason: Missing function \"lbann_external_kernel_",
+                kernel_name,
+                "\"");
+  }
+  const lbann_external_kernel* kernel = getter();
+  if (!kernel) {
+    LBANN_ERROR("External kernel \"",
+                kernel_name,
+                "\" (filename: \"",
+                filename,
+                "\") returned no function table");
+  }
+  if (kernel->abi_version != LBANN_EXTERNAL_ABI_VERSION) {
+    LBANN_ERROR("External kernel \"",
+                kernel_name,
+                "\" (filename: \"",
+                filename,
+                "\") was built for ABI version ",
+                kernel->abi_version,
+                ", but LBANN expects version ",
+                LBANN_EXTERNAL_ABI_VERSION);
+  }
+  if (kernel->num_outputs < 1 || !kernel->forward) {
+    LBANN_ERROR("External kernel \"",
+                kernel_name,
+                "\" (filename: \"",
+                filename,
+                "\") must have at least one output and a forward function");
+  }
+  return kernel;
+}
+
+// =========================================================
+// External kernel layer
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+external_kernel_layer<TensorDataType, Layout, Device>::external_kernel_layer(
+  lbann_comm* comm,
+  std::string filename,
+  std::string kernel_name)
+  : data_type_layer<TensorDataType>(comm),
+    m_filename{std::move(filename)},
+    m_kernel_name{std::move(kernel_name)}
+{
+  this->m_expected_num_parent_layers = -1; // No limit
+  if (!m_filename.empty()) {
+    m_library = open_external_library(m_filename);
+    m_kernel = load_external_kernel(m_library, m_filename, m_kernel_name);
+    this->m_expected_num_child_layers = m_kernel->num_outputs;
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+external_kernel_layer<TensorDataType, Layout, Device>::external_kernel_layer(
+  const external_kernel_layer& other)
+  : data_type_layer<TensorDataType>(other),
+    m_filename{other.m_filename},
+    m_kernel_name{other.m_kernel_name},
+    m_library{other.m_library},
+    m_kernel{other.m_kernel}
+{
+  // Kernel state is owned by each layer
+  if (other.m_state) {
+    create_state();
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+auto external_kernel_layer<TensorDataType, Layout, Device>::operator=(
+  const external_kernel_layer& other) -> external_kernel_layer&
+{
+  data_type_layer<TensorDataType>::operator=(other);
+  destroy_state();
+  m_filename = other.m_filename;
+  m_kernel_name = other.m_kernel_name;
+  m_library = other.m_library;
+  m_kernel = other.m_kernel;
+  if (other.m_state) {
+    create_state();
+  }
+  return *this;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+external_kernel_layer<TensorDataType, Layout, Device>::~external_kernel_layer()
+{
+  destroy_state();
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+auto external_kernel_layer<TensorDataType, Layout, Device>::copy() const
+  -> external_kernel_layer*
+{
+  return new external_kernel_layer(*this);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+description
+external_kernel_layer<TensorDataType, Layout, Device>::get_description() const
+{
+  auto desc = data_type_layer<TensorDataType>::get_description();
+  desc.add("Library", m_filename);
+  desc.add("Kernel", m_kernel_name);
+  return desc;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void external_kernel_layer<TensorDataType, Layout, Device>::
+  write_specific_proto(lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<TensorDataType>);
+  auto* msg = proto.mutable_external();
+  msg->set_filename(m_filename);
+  msg->set_layer_name(m_kernel_name);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void external_kernel_layer<TensorDataType, Layout, Device>::create_state()
+{
+  destroy_state();
+  if (!m_kernel->create) {
+    return;
+  }
+  std::vector<lbann_external_shape> inputs;
+  for (int i = 0; i < this->get_num_parents(); ++i) {
+    inputs.push_back(make_external_shape(this->get_input_dims(i)));
+  }
+  check_external_kernel(
+    m_kernel->create(inputs.size(), inputs.data(), &m_state),
+    "create",
+    m_kernel_name);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void external_kernel_layer<TensorDataType, Layout, Device>::destroy_state()
+{
+  if (m_state && m_kernel->destroy) {
+    m_kernel->destroy(m_state);
+  }
+  m_state = nullptr;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void external_kernel_layer<TensorDataType, Layout, Device>::setup_dims()
+{
+  data_type_layer<TensorDataType>::setup_dims();
+
+  // Kernels are not serialized, so reload after a checkpoint restart
+  if (!m_kernel) {
+    m_library = open_external_library(m_filename);
+    m_kernel = load_external_kernel(m_library, m_filename, m_kernel_name);
+    this->m_expected_num_child_layers = m_kernel->num_outputs;
+  }
+  create_state();
+
+  std::vector<lbann_external_shape> inputs;
+  for (int i = 0; i < this->get_num_parents(); ++i) {
+    inputs.push_back(make_external_shape(this->get_input_dims(i)));
+  }
+  for (int i = 0; i < this->get_num_children(); ++i) {
+    if (!m_kernel->output_shape) {
+      this->set_output_dims(this->get_input_dims(), i);
+      continue;
+    }
+    lbann_external_shape output{};
+    check_external_kernel(
+      m_kernel->output_shape(m_state, i, inputs.size(), inputs.data(), &output),
+      "output_shape",
+      m_kernel_name);
+    if (output.num_dims < 1 || output.num_dims > LBANN_EXTERNAL_MAX_DIMS) {
+      LBANN_ERROR("External kernel \"",
+                  m_kernel_name,
+                  "\" returned an output with ",
+                  output.num_dims,
+                  " dimensions");
+    }
+    this->set_output_dims(
+      std::vector<int>(output.dims, output.dims + output.num_dims),
+      i);
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+lbann_external_context
+external_kernel_layer<TensorDataType, Layout, Device>::make_context(
+  size_t mini_batch_size)
+{
+  lbann_external_context context{};
+  context.abi_version = LBANN_EXTERNAL_ABI_VERSION;
+  context.datatype = (std::is_same_v<TensorDataType, float>
+                        ? LBANN_EXTERNAL_FLOAT
+                        : LBANN_EXTERNAL_DOUBLE);
+  context.is_training =
+    (this->m_model->get_execution_context().get_execution_mode() ==
+     execution_mode::training);
+  context.state = m_state;
+  const size_t workspace_size =
+    (m_kernel->workspace_size
+       ? m_kernel->workspace_size(m_state, mini_batch_size)
+       : 0);
+  context.workspace_size = workspace_size;
+
+  // All tensors of a layer share its sync info
+  if constexpr (Device == El::Device::CPU) {
+    context.device = LBANN_EXTERNAL_CPU;
+    if (m_cpu_workspace.size() < workspace_size) {
+      m_cpu_workspace.resize(workspace_size);
+    }
+    context.workspace = (workspace_size > 0 ? m_cpu_workspace.data() : nullptr);
+  }
+#ifdef LBANN_HAS_GPU
+  else {
+    context.device = LBANN_EXTERNAL_GPU;
+    using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+    const auto& sync_info = El::SyncInfoFromMatrix(
+      dynamic_cast<const LocalMat&>(this->get_local_activations()));
+    context.stream = sync_info.Stream();
+    context.workspace =
+      (workspace_size > 0 ? gpu::get_workspace(workspace_size, sync_info)
+                          : nullptr);
+  }
+#endif // LBANN_HAS_GPU
+  return context;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void external_kernel_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+  const int num_inputs = this->get_num_parents();
+  const int num_outputs = this->get_num_children();
+  std::vector<lbann_external_tensor> inputs, outputs;
+  for (int i = 0; i < num_inputs; ++i) {
+    inputs.push_back(make_external_tensor(this->get_local_prev_activations(i),
+                                          this->get_input_dims(i)));
+  }
+  for (int i = 0; i < num_outputs; ++i) {
+    outputs.push_back(make_external_tensor(this->get_local_activations(i),
+                                           this->get_output_dims(i)));
+  }
+  const auto context =
+    make_context(this->get_local_prev_activations().Width());
+  check_external_kernel(m_kernel->forward(&context,
+                                          num_inputs,
+                                          inputs.data(),
+                                          num_outputs,
+                                          outputs.data()),
+                        "forward",
+                        m_kernel_name);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void external_kernel_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+  const int num_inputs = this->get_num_parents();
+  const int num_outputs = this->get_num_children();
+  if (!m_kernel->backward) {
+    for (int i = 0; i < num_inputs; ++i) {
+      El::Zero(this->get_error_signals(i));
+    }
+    return;
+  }
+  std::vector<lbann_external_tensor> inputs, input_grads;
+  std::vector<lbann_external_tensor> outputs, output_grads;
+  for (int i = 0; i < num_inputs; ++i) {
+    inputs.push_back(make_external_tensor(this->get_local_prev_activations(i),
+                                          this->get_input_dims(i)));
+    input_grads.push_back(make_external_tensor(this->get_local_error_signals(i),
+                                               this->get_input_dims(i)));
+  }
+  for (int i = 0; i < num_outputs; ++i) {
+    outputs.push_back(make_external_tensor(this->get_local_activations(i),
+                                           this->get_output_dims(i)));
+    output_grads.push_back(
+      make_external_tensor(this->get_local_prev_error_signals(i),
+                           this->get_output_dims(i)));
+  }
+  const auto context =
+    make_context(this->get_local_prev_activations().Width());
+  check_external_kernel(m_kernel->backward(&context,
+                                           num_inputs,
+                                           inputs.data(),
+                                           num_outputs,
+                                           outputs.data(),
+                                           output_grads.data(),
+                                           input_grads.data()),
+                        "backward",
+                        m_kernel_name);
+}
+
+#define PROTO_DEVICE(T, Device)                                                \
+  template class external_kernel_layer<T, data_layout::DATA_PARALLEL, Device>
+PROTO_DEVICE(float, El::Device::CPU);
+#ifdef LBANN_HAS_DOUBLE
+PROTO_DEVICE(double, El::Device::CPU);
+#endif // LBANN_HAS_DOUBLE
+#ifdef LBANN_HAS_GPU
+PROTO_DEVICE(float, El::Device::GPU);
+#ifdef LBANN_HAS_DOUBLE
+PROTO_DEVICE(double, El::Device::GPU);
+#endif // LBANN_HAS_DOUBLE
+#endif // LBANN_HAS_GPU
+#undef PROTO_DEVICE
+
 } // namespace lbann
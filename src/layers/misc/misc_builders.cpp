@@ -278,6 +278,28 @@ std::unique_ptr<lbann::Layer>
 lbann::build_external_layer_from_pbuf(lbann_comm* comm,
                                       lbann_data::Layer const& proto_layer)
 {
+  // Libraries that export an external kernel get a layer owned by LBANN
+  const auto& params = proto_layer.external();
+  if (has_external_kernel(params.filename(), params.layer_name())) {
+    constexpr bool supported =
+      (L == data_layout::DATA_PARALLEL &&
+       (std::is_same_v<T, float> || std::is_same_v<T, double>));
+    if constexpr (supported) {
+      return std::make_unique<external_kernel_layer<T, L, D>>(
+        comm,
+        params.filename(),
+        params.layer_name());
+    }
+    else {
+      LBANN_ERROR("External kernel \"",
+                  params.layer_name(),
+                  "\" (filename: \"",
+                  params.filename(),
+                  "\") requires a data-parallel float or double layer");
+      return nullptr;
+    }
+  }
+
   lbann::external_layer_setup_t setupfunc =
     load_external_library(proto_layer.external().filename(),
                           proto_layer.external().layer_name());
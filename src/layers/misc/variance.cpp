@@ -27,13 +27,15 @@
 #define LBANN_VARIANCE_LAYER_INSTANTIATE
 #include "lbann/layers/misc/variance_impl.hpp"
 
+#include "comoments.hpp"
+
 namespace lbann {
 
 namespace {
 
 /** CPU forward prop implementation.
- *  We use a two-pass algorithm since it is more numerically stable
- *  than the naive single-pass algorithm.
+ *  Means and the variance are computed in one pass, which is as
+ *  accurate as a two-pass algorithm (see comoments::compute_cpu).
  */
 template <typename TensorDataType>
 void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input,
@@ -42,49 +44,7 @@ void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input,
             El::AbstractDistMatrix<TensorDataType>& workspace,
             bool biased)
 {
-  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
-
-  // Local matrices
-  const auto& local_input =
-    static_cast<const CPUMatType&>(input.LockedMatrix());
-  auto& local_means = static_cast<CPUMatType&>(means.Matrix());
-  auto& local_workspace = static_cast<CPUMatType&>(workspace.Matrix());
-
-  // Dimensions
-  const auto& height = input.Height();
-  const auto& width = input.Width();
-  const auto& local_height = local_input.Height();
-  const auto& local_width = local_input.Width();
-
-  // Compute column-wise mean
-  means.Empty(false);
-  means.AlignWith(input);
-  means.Resize(1, width);
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    TensorDataType sum = El::To<TensorDataType>(0);
-    for (El::Int row = 0; row < local_height; ++row) {
-      sum += local_input(row, col);
-    }
-    local_means(0, col) = sum / height;
-  }
-  El::AllReduce(means, means.RedundantComm());
-
-  // Compute column-wise variance
-  workspace.Empty(false);
-  workspace.AlignWith(input);
-  workspace.Resize(1, width);
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    const auto& mean = local_means(0, col);
-    TensorDataType sum = El::To<TensorDataType>(0);
-    for (El::Int row = 0; row < local_height; ++row) {
-      const auto& diff = local_input(row, col) - mean;
-      sum += diff * diff;
-    }
-    local_workspace(0, col) = sum / (biased ? height : height - 1);
-  }
-  El::AllReduce(workspace, workspace.RedundantComm());
+  comoments::compute_cpu(input, input, means, workspace, biased);
   El::Copy(workspace, output);
 }
 
@@ -28,54 +28,12 @@
 #include "lbann/layers/misc/variance_impl.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "comoments.cuh"
+
 namespace lbann {
 
 namespace {
 
-template <typename TensorDataType, El::Int block_size>
-__global__ void
-variance_contribution_kernel(El::Int height,
-                             El::Int width,
-                             TensorDataType scale,
-                             const TensorDataType* __restrict__ input,
-                             El::Int input_ldim,
-                             const TensorDataType* __restrict__ means,
-                             TensorDataType* __restrict__ contribution)
-{
-
-  // Indices
-  const El::Int tid = threadIdx.x;
-  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
-  const El::Int bidy = blockIdx.y;
-  const El::Int nthreadsx = blockDim.x * gridDim.x;
-
-  // Compute local contribution for each matrix column
-  for (El::Int col = bidy; col < width; col += gridDim.y) {
-    const auto& mean = means[col];
-
-    // Compute contributions for each thread
-    TensorDataType private_contribution = 0;
-    for (El::Int row = gidx; row < height; row += nthreadsx) {
-      const auto& diff = input[row + col * input_ldim] - mean;
-      private_contribution += diff * diff;
-    }
-
-    // Shared memory reduction to get contribution for each block
-    /// @todo unroll loops
-    __shared__ TensorDataType shared_contribution[block_size];
-    shared_contribution[tid] = private_contribution;
-    for (El::Int stride = block_size / 2; stride > 0; stride /= 2) {
-      __syncthreads();
-      if (tid < stride) {
-        shared_contribution[tid] += shared_contribution[tid + stride];
-      }
-    }
-    if (tid == 0) {
-      gpu_lib::atomic_add(&contribution[col], scale * shared_contribution[0]);
-    }
-  }
-}
-
 template <typename TensorDataType>
 __global__ void
 variance_backprop_kernel(El::Int height,
@@ -103,8 +61,8 @@ variance_backprop_kernel(El::Int height,
 }
 
 /** GPU forward prop implementation.
- *  We use a two-pass algorithm since it is more numerically stable
- *  than the naive single-pass algorithm.
+ *  Means and the variance are computed in one pass, which is as
+ *  accurate as a two-pass algorithm (see comoments::compute_gpu).
  */
 template <typename TensorDataType>
 void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
@@ -113,72 +71,7 @@ void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
             El::AbstractDistMatrix<TensorDataType>& workspace,
             bool biased)
 {
-
-  // Local matrices
-  const auto& local_input =
-    static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(
-      input.LockedMatrix());
-  auto& local_means =
-    static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(means.Matrix());
-  auto& local_workspace =
-    static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
-      workspace.Matrix());
-
-  // Dimensions
-  const auto& height = input.Height();
-  const auto& width = input.Width();
-  const auto& local_height = local_input.Height();
-  const auto& local_width = local_input.Width();
-
-  // Compute column-wise mean
-  means.Empty(false);
-  means.AlignWith(input);
-  means.Resize(1, width);
-  El::Matrix<TensorDataType, El::Device::GPU> ones;
-#ifdef HYDROGEN_HAVE_CUB
-  ones.SetMemoryMode(1); // Use CUB GPU memory pool
-#endif                   // HYDROGEN_HAVE_CUB
-  ones.Resize(local_height, 1);
-  El::Fill(ones, El::TypeTraits<TensorDataType>::One());
-  El::Gemv(El::TRANSPOSE,
-           El::TypeTraits<TensorDataType>::One() / TensorDataType(height),
-           local_input,
-           ones,
-           El::TypeTraits<TensorDataType>::Zero(),
-           local_means);
-  El::AllReduce(means, means.RedundantComm());
-
-  // Compute column-wise variance
-  workspace.Empty(false);
-  workspace.AlignWith(input);
-  El::Zeros(workspace, 1, width);
-  if (!local_input.IsEmpty()) {
-    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_workspace),
-                                       gpu::get_sync_info(local_means),
-                                       gpu::get_sync_info(local_input));
-    constexpr El::Int block_size = 256;
-    dim3 block_dims, grid_dims;
-    block_dims.x = block_size;
-    grid_dims.x = (local_height + block_size - 1) / block_size;
-    grid_dims.y = local_width;
-    const auto& scale =
-      El::TypeTraits<TensorDataType>::One() /
-      (biased ? TensorDataType(height) : TensorDataType(height - 1));
-    hydrogen::gpu::LaunchKernel(
-      variance_contribution_kernel<TensorDataType, block_size>,
-      grid_dims,
-      block_dims,
-      0,
-      multisync,
-      local_height,
-      local_width,
-      scale,
-      local_input.LockedBuffer(),
-      local_input.LDim(),
-      local_means.LockedBuffer(),
-      local_workspace.Buffer());
-  }
-  El::AllReduce(workspace, workspace.RedundantComm());
+  comoments::compute_gpu(input, input, means, workspace, biased);
   El::Copy(workspace, output);
 }
 
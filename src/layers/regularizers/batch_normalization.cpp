@@ -31,6 +31,8 @@
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/weights/weights_helpers.hpp"
 
+#include <algorithm>
+
 namespace lbann {
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -50,9 +52,10 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
   // Matrix parameters
   const auto& width = input.Width();
   const auto& local_width = local_input.Width();
-  const auto& output_dims = this->get_output_dims();
-  const auto& num_channels = output_dims[0];
+  const auto& num_channels = this->get_num_channels();
   const auto& channel_size = this->get_output_size() / num_channels;
+  const El::Int channel_stride = this->m_channels_last ? 1 : channel_size;
+  const El::Int spatial_stride = this->m_channels_last ? num_channels : 1;
 
   const int correction = this->m_bessel_correction ? 1 : 0;
 
@@ -66,16 +69,19 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
       ValuesGetter::mutable_values(this->get_weights(2)).Matrix();
     auto& local_running_var =
       ValuesGetter::mutable_values(this->get_weights(3)).Matrix();
-    // Compute sums and sums of squares
+    // Compute sums and sums of squares in a single pass. Entries are
+    // shifted by the running mean, which is identical on every
+    // process, so the sums stay small and the variance does not
+    // suffer from cancellation.
     LBANN_OMP_PARALLEL_FOR
     for (El::Int channel = 0; channel < num_channels; ++channel) {
+      const auto shift = local_running_mean(channel, 0);
       TensorDataType sum = zero;
       TensorDataType sqsum = zero;
-      const auto& row_start = channel * channel_size;
-      const auto& row_end = (channel + 1) * channel_size;
       for (El::Int col = 0; col < local_width; ++col) {
-        for (El::Int row = row_start; row < row_end; ++row) {
-          const auto& x = local_input(row, col);
+        for (El::Int i = 0; i < channel_size; ++i) {
+          const auto row = channel * channel_stride + i * spatial_stride;
+          const auto x = local_input(row, col) - shift;
           sum += x;
           sqsum += x * x;
         }
@@ -116,20 +122,22 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
 
     // Compute minibatch statistics
     if (num_per_sum <= 1) {
+      El::Axpy(one, local_running_mean, local_mean);
       El::Fill(local_var, one);
     }
     else {
       LBANN_OMP_PARALLEL_FOR
       for (El::Int channel = 0; channel < num_channels; ++channel) {
         auto num_per_sum_dt = El::To<TensorDataType>(num_per_sum);
-        const auto& mean = local_mean(channel, 0) / num_per_sum_dt;
+        auto& running_mean = local_running_mean(channel, 0);
+        const auto shifted_mean = local_mean(channel, 0) / num_per_sum_dt;
         const auto& sqmean = local_var(channel, 0) / num_per_sum_dt;
-        auto var = num_per_sum_dt * (sqmean - mean * mean) /
+        auto var = num_per_sum_dt * (sqmean - shifted_mean * shifted_mean) /
                    (num_per_sum_dt - correction);
         var = std::max(var, this->m_epsilon);
+        const auto mean = running_mean + shifted_mean;
         local_mean(channel, 0) = mean;
         local_var(channel, 0) = var;
-        auto& running_mean = local_running_mean(channel, 0);
         auto& running_var = local_running_var(channel, 0);
         running_mean =
           this->m_decay * running_mean + (one - this->m_decay) * mean;
@@ -148,6 +156,10 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
     (is_training ? this->m_var_v->LockedMatrix()
                  : this->weights_values(3).LockedMatrix());
 
+  // Fused residual input
+  const auto* local_residual =
+    (this->m_fused_residual ? &this->get_local_prev_activations(1) : nullptr);
+
   // Iterate through channels
   LBANN_OMP_PARALLEL_FOR
   for (El::Int channel = 0; channel < num_channels; ++channel) {
@@ -161,14 +173,19 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
     const auto& bias = local_bias(channel, 0);
 
     // Apply batch normalization to inputs in channel
-    const auto& row_start = channel * channel_size;
-    const auto& row_end = (channel + 1) * channel_size;
     for (El::Int col = 0; col < local_width; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
+      for (El::Int i = 0; i < channel_size; ++i) {
+        const auto row = channel * channel_stride + i * spatial_stride;
         const auto& x = local_input(row, col);
         const auto& xhat = (x - mean) * inv_stdev;
         auto& y = local_output(row, col);
         y = scale * xhat + bias;
+        if (local_residual != nullptr) {
+          y += (*local_residual)(row, col);
+        }
+        if (this->m_fused_relu) {
+          y = std::max(y, zero);
+        }
       }
     }
   }
@@ -198,12 +215,26 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
   auto& local_scale_gradient = this->m_scale_gradient->Matrix();
   auto& local_bias_gradient = this->m_bias_gradient->Matrix();
 
+  // Fused ReLU and residual
+  const auto* local_output =
+    (this->m_fused_relu ? &this->get_local_activations() : nullptr);
+  auto* local_gradient_wrt_residual =
+    (this->m_fused_residual ? &this->get_local_error_signals(1) : nullptr);
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  auto const get_dy = [&](El::Int row, El::Int col) {
+    const auto& dy = local_gradient_wrt_output(row, col);
+    return (local_output == nullptr || (*local_output)(row, col) > zero
+              ? dy
+              : zero);
+  };
+
   // Matrix parameters
   const auto& width = input.Width();
   const auto& local_width = local_input.Width();
-  const auto& output_dims = this->get_output_dims();
-  const auto& num_channels = output_dims[0];
+  const auto& num_channels = this->get_num_channels();
   const auto& channel_size = this->get_output_size() / num_channels;
+  const El::Int channel_stride = this->m_channels_last ? 1 : channel_size;
+  const El::Int spatial_stride = this->m_channels_last ? num_channels : 1;
 
   const int correction = this->m_bessel_correction ? 1 : 0;
 
@@ -224,13 +255,15 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
     TensorDataType dbias = El::TypeTraits<TensorDataType>::Zero();
 
     // Compute gradient contributions from local entries
-    const auto& row_start = channel * channel_size;
-    const auto& row_end = (channel + 1) * channel_size;
     for (El::Int col = 0; col < local_width; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
+      for (El::Int i = 0; i < channel_size; ++i) {
+        const auto row = channel * channel_stride + i * spatial_stride;
         const auto& x = local_input(row, col);
         const auto& xhat = (x - mean) * inv_stdev;
-        const auto& dy = local_gradient_wrt_output(row, col);
+        const auto dy = get_dy(row, col);
+        if (local_gradient_wrt_residual != nullptr) {
+          (*local_gradient_wrt_residual)(row, col) = dy;
+        }
         dscale += dy * xhat;
         dbias += dy;
         const auto& dxhat = dy * scale;
@@ -244,20 +277,24 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
     local_bias_gradient(channel, 0) = dbias;
   }
 
-  // Accumulate gradients
+  // Accumulate gradients. The allreduce is overlapped with passing
+  // the scale and bias gradients to their optimizers.
+  Al::request stats_req;
   if (is_training) {
     if (this->m_statistics_group_size == 0) {
       // Global aggregation; allreduce on fused buffer.
-      this->get_comm()->allreduce(
+      this->get_comm()->nb_allreduce(
         *this->m_mean_and_var_gradient,
         this->m_mean_and_var_gradient->RedundantComm(),
+        stats_req,
         El::mpi::SUM);
     }
     else if (this->m_statistics_group_size > 1) {
       // Grouped batchnorm; allreduce on fused buffer.
-      this->get_comm()->allreduce(
+      this->get_comm()->nb_allreduce(
         *this->m_mean_and_var_gradient,
         this->get_comm()->get_packed_group_comm(this->m_statistics_group_size),
+        stats_req,
         El::mpi::SUM);
     }
   }
@@ -277,6 +314,7 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
                                     El::TypeTraits<TensorDataType>::One(),
                                     true);
   }
+  this->get_comm()->wait(stats_req);
 
   // Compute error signal
   El::Int num_per_sum;
@@ -313,12 +351,11 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
       const auto& dvar_term = dvar * 2 / (num_per_sum - correction);
 
       // Compute error signal for current channel
-      const auto& row_start = channel * channel_size;
-      const auto& row_end = (channel + 1) * channel_size;
       for (El::Int col = 0; col < local_width; ++col) {
-        for (El::Int row = row_start; row < row_end; ++row) {
+        for (El::Int i = 0; i < channel_size; ++i) {
+          const auto row = channel * channel_stride + i * spatial_stride;
           const auto& x = local_input(row, col);
-          const auto& dy = local_gradient_wrt_output(row, col);
+          const auto dy = get_dy(row, col);
           const auto& dxhat = dy * scale;
           auto& dx = local_gradient_wrt_input(row, col);
           dx = dxhat * inv_stdev + dmean_term + dvar_term * (x - mean);
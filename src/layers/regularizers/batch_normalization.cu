@@ -55,7 +55,9 @@ struct array_sum
 
 /** Accumulate sums and sums of squares for each channel.
  *
- *  On input, sums and sqsums are assumed to be filled with zeros.
+ *  Entries are shifted by a per-channel value (the running mean) so
+ *  that the variance does not suffer from cancellation. On input,
+ *  sums and sqsums are assumed to be filled with zeros.
  *
  *  Block dimensions: bsize x 1 x 1
  *
@@ -65,8 +67,11 @@ template <typename TensorDataType, int bdimx>
 __global__ void fp_sums_kernel(int mini_batch_size,
                                int num_channels,
                                int channel_size,
+                               int channel_stride,
+                               int spatial_stride,
                                const TensorDataType* __restrict__ data,
                                int data_ldim,
+                               const BNAcc<TensorDataType>* __restrict__ shifts,
                                BNAcc<TensorDataType>* __restrict__ sums,
                                BNAcc<TensorDataType>* __restrict__ sqsums)
 {
@@ -89,9 +94,11 @@ __global__ void fp_sums_kernel(int mini_batch_size,
     array_t sum_sqsum;
     sum_sqsum[0] = AccT(0);
     sum_sqsum[1] = AccT(0);
+    const auto shift = shifts[channel];
     for (int i = gidx; i < channel_size; i += nthreadsx) {
+      const auto& row = i * spatial_stride + channel * channel_stride;
       for (int j = 0; j < mini_batch_size; ++j) {
-        const auto& x = static_cast<AccT>(data[i + channel * channel_size + j * data_ldim]);
+        const auto x = static_cast<AccT>(data[row + j * data_ldim]) - shift;
         sum_sqsum[0] += x;
         sum_sqsum[1] += x * x;
       }
@@ -111,7 +118,8 @@ __global__ void fp_sums_kernel(int mini_batch_size,
 /** Compute statistics for each channel.
  *
  *  On input, global_mean and global_var are assumed to contain sums
- *  and squares of sums, respectively.
+ *  and squares of sums, respectively, of entries shifted by the
+ *  running mean.
  *
  *  Block dimensions: bsize x 1 x 1
  *
@@ -137,27 +145,43 @@ fp_statistics_kernel(int num_sums,
   for (auto i = gid; i < num_sums; i += num_threads) {
 
     AccT num_per_sum_dt = AccT(num_per_sum);
+    auto& running_mean = global_running_mean[i];
+    auto& running_var = global_running_var[i];
+
     // Compute mean and variance
-    const auto& mean = global_mean[i] / num_per_sum_dt;
+    const auto shifted_mean = global_mean[i] / num_per_sum_dt;
     const auto& sqmean = global_var[i] / num_per_sum_dt;
-    auto var = num_per_sum_dt * (sqmean - mean * mean) /
+    auto var = num_per_sum_dt * (sqmean - shifted_mean * shifted_mean) /
                AccT(num_per_sum - correction);
     var = var > epsilon ? var : epsilon;
+    const auto mean = running_mean + shifted_mean;
     global_mean[i] = mean;
     global_var[i] = var;
 
     // Compute running statistics
-    auto& running_mean = global_running_mean[i];
-    auto& running_var = global_running_var[i];
     running_mean = decay * running_mean + (AccT(1.0) - decay) * mean;
     running_var = decay * running_var + (AccT(1.0) - decay) * var;
   }
 }
 
+/** Whether a fused ReLU passes gradients at an entry of its output.
+ *  Always true if there is no fused ReLU (null output).
+ */
+template <typename TensorDataType>
+__device__ __forceinline__ bool
+is_relu_active(const TensorDataType* __restrict__ output, int index)
+{
+  using AccT = BNAcc<TensorDataType>;
+  return output == nullptr || static_cast<AccT>(output[index]) > AccT(0);
+}
+
 /** Compute outputs.
  *
  *  y_i = (x_i - mean) / sqrt(var + epsilon)
  *
+ *  With a fused residual r and ReLU, the affine output becomes
+ *  max(scale * y_i + bias + r_i, 0).
+ *
  *  Block dimensions: bdimx x bdimy x bdimz
  *
  *  Grid dimensions: (channel_size / bdimx) x (mini_batch_size / bdimy) x
@@ -169,6 +193,8 @@ __global__ void
 fp_output_kernel(int mini_batch_size,
                  int num_channels,
                  int channel_size,
+                 int channel_stride,
+                 int spatial_stride,
                  const TensorDataType* __restrict__ global_input,
                  int input_ldim,
                  const BNAcc<TensorDataType>* __restrict__ global_mean,
@@ -176,6 +202,9 @@ fp_output_kernel(int mini_batch_size,
                  BNAcc<TensorDataType> epsilon,
                  const BNAcc<TensorDataType>* __restrict__ global_scale,
                  const BNAcc<TensorDataType>* __restrict__ global_bias,
+                 const TensorDataType* __restrict__ global_residual,
+                 int residual_ldim,
+                 bool apply_relu,
                  TensorDataType* __restrict__ global_output,
                  int output_ldim)
 {
@@ -198,10 +227,17 @@ fp_output_kernel(int mini_batch_size,
     const auto& bias = global_bias[k];
     for (auto j = gidy; j < mini_batch_size; j += nthreadsy) {
       for (auto i = gidx; i < channel_size; i += nthreadsx) {
-        const auto& x = static_cast<AccT>(global_input[i + k * channel_size + j * input_ldim]);
+        const auto& row = i * spatial_stride + k * channel_stride;
+        const auto& x = static_cast<AccT>(global_input[row + j * input_ldim]);
         const auto& xhat = (x - mean) * inv_stdev;
-        const auto& y = scale * xhat + bias;
-        global_output[i + k * channel_size + j * output_ldim] = static_cast<TensorDataType>(y);
+        auto y = scale * xhat + bias;
+        if (global_residual != nullptr) {
+          y += static_cast<AccT>(global_residual[row + j * residual_ldim]);
+        }
+        if (apply_relu) {
+          y = gpu_lib::max(y, AccT(0));
+        }
+        global_output[row + j * output_ldim] = static_cast<TensorDataType>(y);
       }
     }
   }
@@ -219,6 +255,10 @@ fp_output_kernel(int mini_batch_size,
  *
  *  On input, means_grad and vars_grad are filled with zeros.
  *
+ *  If the layer output is given, dL/dy_i is first masked by the
+ *  fused ReLU. If the residual gradient is given, the (masked)
+ *  dL/dy_i is written to it.
+ *
  *  Block dimensions: bsize x 1 x 1
  *
  *  Grid dimensions: (channel_size / bsize) x num_channels x 1
@@ -228,10 +268,14 @@ __global__ void bp_statistics_grad_kernel(
   int mini_batch_size,
   int num_channels,
   int channel_size,
+  int channel_stride,
+  int spatial_stride,
   const TensorDataType* __restrict__ global_input,
   int input_ldim,
   const TensorDataType* __restrict__ global_gradient_wrt_output,
   int gradient_wrt_output_ldim,
+  const TensorDataType* __restrict__ global_output,
+  int output_ldim,
   const BNAcc<TensorDataType>* __restrict__ global_mean,
   const BNAcc<TensorDataType>* __restrict__ global_var,
   BNAcc<TensorDataType> epsilon,
@@ -239,7 +283,9 @@ __global__ void bp_statistics_grad_kernel(
   BNAcc<TensorDataType>* __restrict__ global_dscale,
   BNAcc<TensorDataType>* __restrict__ global_dbias,
   BNAcc<TensorDataType>* __restrict__ global_dmean,
-  BNAcc<TensorDataType>* __restrict__ global_dvar)
+  BNAcc<TensorDataType>* __restrict__ global_dvar,
+  TensorDataType* __restrict__ global_gradient_wrt_residual,
+  int gradient_wrt_residual_ldim)
 {
 
   using AccT = BNAcc<TensorDataType>;
@@ -274,13 +320,19 @@ __global__ void bp_statistics_grad_kernel(
     sums[2] = AccT(0);
     sums[3] = AccT(0);
     for (int i = gidx; i < channel_size; i += nthreadsx) {
+      const auto& row = i * spatial_stride + channel * channel_stride;
       for (int j = 0; j < mini_batch_size; ++j) {
-        const auto& x = static_cast<AccT>(
-          global_input[i + channel * channel_size + j * input_ldim]);
+        const auto& x = static_cast<AccT>(global_input[row + j * input_ldim]);
         const auto& xhat = (x - mean) * inv_stdev;
-        const auto& dy = static_cast<AccT>(
-          global_gradient_wrt_output[i + channel * channel_size +
-                                     j * gradient_wrt_output_ldim]);
+        auto dy = static_cast<AccT>(
+          global_gradient_wrt_output[row + j * gradient_wrt_output_ldim]);
+        if (!is_relu_active(global_output, row + j * output_ldim)) {
+          dy = AccT(0);
+        }
+        if (global_gradient_wrt_residual != nullptr) {
+          global_gradient_wrt_residual[row + j * gradient_wrt_residual_ldim] =
+            static_cast<TensorDataType>(dy);
+        }
         sums[0] += dy * xhat;
         sums[1] += dy;
         const auto& dxhat = dy * scale;
@@ -307,6 +359,8 @@ __global__ void bp_statistics_grad_kernel(
  *              + dL/dmean / n
  *              + dL/dvar * (x_i - mean) * 2/(n-1) )
  *
+ *  If the layer output is given, dL/dy_i is masked by the fused ReLU.
+ *
  *  Block dimensions: bdimx x bdimy x bdimz
  *
  *  Grid dimensions: (channel_size / bdimx) x (mini_batch_size / bdimy) x
@@ -317,12 +371,16 @@ __global__ void bp_input_grad_kernel(
   int mini_batch_size,
   int num_channels,
   int channel_size,
+  int channel_stride,
+  int spatial_stride,
   int num_per_sum,
   int correction,
   const TensorDataType* __restrict__ global_input,
   int input_ldim,
   const TensorDataType* __restrict__ global_gradient_wrt_output,
   int gradient_wrt_output_ldim,
+  const TensorDataType* __restrict__ global_output,
+  int output_ldim,
   const BNAcc<TensorDataType>* __restrict__ global_mean,
   const BNAcc<TensorDataType>* __restrict__ global_var,
   BNAcc<TensorDataType> epsilon,
@@ -355,14 +413,16 @@ __global__ void bp_input_grad_kernel(
       dvar * AccT(2) / AccT(num_per_sum - correction);
     for (auto j = gidy; j < mini_batch_size; j += nthreadsy) {
       for (auto i = gidx; i < channel_size; i += nthreadsx) {
-        const auto& x = static_cast<AccT>(
-          global_input[i + k * channel_size + j * input_ldim]);
-        const auto& dy = static_cast<AccT>(
-          global_gradient_wrt_output[i + k * channel_size +
-                                     j * gradient_wrt_output_ldim]);
+        const auto& row = i * spatial_stride + k * channel_stride;
+        const auto& x = static_cast<AccT>(global_input[row + j * input_ldim]);
+        auto dy = static_cast<AccT>(
+          global_gradient_wrt_output[row + j * gradient_wrt_output_ldim]);
+        if (!is_relu_active(global_output, row + j * output_ldim)) {
+          dy = AccT(0);
+        }
         const auto& dxhat = dy * scale;
-        auto& dx = global_gradient_wrt_input[i + k * channel_size +
-                                             j * gradient_wrt_input_ldim];
+        auto& dx =
+          global_gradient_wrt_input[row + j * gradient_wrt_input_ldim];
         dx = static_cast<TensorDataType>(
           dxhat * inv_stdev + dmean_term + dvar_term * (x - mean));
       }
@@ -522,9 +582,10 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
   // Matrix parameters
   const auto& width = input.Width();
   const auto& local_width = local_input.Width();
-  const auto& output_dims = this->get_output_dims();
-  const auto& num_channels = output_dims[0];
+  const auto& num_channels = this->get_num_channels();
   const auto& channel_size = this->get_output_size() / num_channels;
+  const int channel_stride = this->m_channels_last ? 1 : channel_size;
+  const int spatial_stride = this->m_channels_last ? num_channels : 1;
 
   const int correction = this->m_bessel_correction ? 1 : 0;
 
@@ -538,13 +599,15 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
     auto& local_running_var =
       dynamic_cast<WeightsType&>(this->get_weights(3)).get_values_sharded().Matrix();
 
-    // Compute sums and sums of squares
+    // Compute sums and sums of squares, shifted by the running mean
     El::Zero(local_mean);
     El::Zero(local_var);
     if (!local_input.IsEmpty()) {
-      auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_mean),
-                                         gpu::get_sync_info(local_var),
-                                         gpu::get_sync_info(local_input));
+      auto multisync =
+        El::MakeMultiSync(gpu::get_sync_info(local_mean),
+                          gpu::get_sync_info(local_var),
+                          gpu::get_sync_info(local_running_mean),
+                          gpu::get_sync_info(local_input));
       const El::Int block_size = 256;
       dim3 block_dims, grid_dims;
       block_dims.x = block_size;
@@ -559,8 +622,11 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
                                   local_width,
                                   num_channels,
                                   channel_size,
+                                  channel_stride,
+                                  spatial_stride,
                                   local_input.LockedBuffer(),
                                   local_input.LDim(),
+                                  local_running_mean.LockedBuffer(),
                                   local_mean.Buffer(),
                                   local_var.Buffer());
     }
@@ -597,6 +663,7 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
 
     // Compute minibatch statistics
     if (num_per_sum <= 1) {
+      El::Axpy(AccT(1.0), local_running_mean, local_mean);
       El::Fill(local_var, AccT(1.0));
     }
     else if (num_channels > 0) {
@@ -635,6 +702,13 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
   const auto& local_var =
     (is_training ? this->m_var_v->LockedMatrix()
                  : dynamic_cast<WeightsType&>(this->get_weights(3)).get_values().LockedMatrix());
+  const TensorDataType* residual = nullptr;
+  int residual_ldim = 0;
+  if (this->m_fused_residual) {
+    const auto& local_residual = this->get_local_prev_activations(1);
+    residual = local_residual.LockedBuffer();
+    residual_ldim = local_residual.LDim();
+  }
   if (!local_input.IsEmpty()) {
     auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_output),
                                        gpu::get_sync_info(local_scale),
@@ -657,6 +731,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
                                 local_width,
                                 num_channels,
                                 channel_size,
+                                channel_stride,
+                                spatial_stride,
                                 local_input.LockedBuffer(),
                                 local_input.LDim(),
                                 local_mean.LockedBuffer(),
@@ -664,6 +740,9 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
                                 this->m_epsilon,
                                 local_scale.LockedBuffer(),
                                 local_bias.LockedBuffer(),
+                                residual,
+                                residual_ldim,
+                                this->m_fused_relu,
                                 local_output.Buffer(),
                                 local_output.LDim());
   }
@@ -703,12 +782,29 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
   auto& local_scale_gradient = this->m_scale_gradient->Matrix();
   auto& local_bias_gradient = this->m_bias_gradient->Matrix();
 
+  // Fused ReLU and residual
+  const TensorDataType* output = nullptr;
+  int output_ldim = 0;
+  if (this->m_fused_relu) {
+    const auto& local_output = this->get_local_activations();
+    output = local_output.LockedBuffer();
+    output_ldim = local_output.LDim();
+  }
+  TensorDataType* gradient_wrt_residual = nullptr;
+  int gradient_wrt_residual_ldim = 0;
+  if (this->m_fused_residual) {
+    auto& local_gradient_wrt_residual = this->get_local_error_signals(1);
+    gradient_wrt_residual = local_gradient_wrt_residual.Buffer();
+    gradient_wrt_residual_ldim = local_gradient_wrt_residual.LDim();
+  }
+
   // Matrix parameters
   const auto& width = input.Width();
   const auto& local_width = local_input.Width();
-  const auto& output_dims = this->get_output_dims();
-  const auto& num_channels = output_dims[0];
+  const auto& num_channels = this->get_num_channels();
   const auto& channel_size = this->get_output_size() / num_channels;
+  const int channel_stride = this->m_channels_last ? 1 : channel_size;
+  const int spatial_stride = this->m_channels_last ? num_channels : 1;
 
   const int correction = this->m_bessel_correction ? 1 : 0;
 
@@ -743,10 +839,14 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
       local_width,
       num_channels,
       channel_size,
+      channel_stride,
+      spatial_stride,
       local_input.LockedBuffer(),
       local_input.LDim(),
       local_gradient_wrt_output.LockedBuffer(),
       local_gradient_wrt_output.LDim(),
+      output,
+      output_ldim,
       local_mean.LockedBuffer(),
       local_var.LockedBuffer(),
       this->m_epsilon,
@@ -754,23 +854,29 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
       local_scale_gradient.Buffer(),
       local_bias_gradient.Buffer(),
       local_mean_gradient.Buffer(),
-      local_var_gradient.Buffer());
+      local_var_gradient.Buffer(),
+      gradient_wrt_residual,
+      gradient_wrt_residual_ldim);
   }
 
-  // Accumulate gradients
+  // Accumulate gradients. The allreduce is overlapped with passing
+  // the scale and bias gradients to their optimizers.
+  Al::request stats_req;
   if (is_training) {
     if (this->m_statistics_group_size == 0) {
       // Global aggregation; allreduce on fused buffer.
-      this->get_comm()->allreduce(
+      this->get_comm()->nb_allreduce(
         *this->m_mean_and_var_gradient,
         this->m_mean_and_var_gradient->RedundantComm(),
+        stats_req,
         El::mpi::SUM);
     }
     else if (this->m_statistics_group_size > 1) {
       // Grouped batchnorm; allreduce on fused buffer.
-      this->get_comm()->allreduce(
+      this->get_comm()->nb_allreduce(
         *this->m_mean_and_var_gradient,
         this->get_comm()->get_packed_group_comm(this->m_statistics_group_size),
+        stats_req,
         El::mpi::SUM);
     }
   }
@@ -790,6 +896,7 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
                                     AccT(1.0),
                                     true);
   }
+  this->get_comm()->wait(stats_req);
 
   // Compute error signal
   int num_per_sum;
@@ -824,12 +931,16 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
                                 local_width,
                                 num_channels,
                                 channel_size,
+                                channel_stride,
+                                spatial_stride,
                                 num_per_sum,
                                 correction,
                                 local_input.LockedBuffer(),
                                 local_input.LDim(),
                                 local_gradient_wrt_output.LockedBuffer(),
                                 local_gradient_wrt_output.LDim(),
+                                output,
+                                output_ldim,
                                 local_mean.LockedBuffer(),
                                 local_var.LockedBuffer(),
                                 this->m_epsilon,
@@ -74,13 +74,15 @@ std::unique_ptr<lbann::Layer> lbann::build_batch_normalization_layer_from_pbuf(
     auto const decay = params.decay() == 0.0 ? 0.9 : params.decay();
     auto const epsilon = params.epsilon() == 0.0 ? 1e-5 : params.epsilon();
     auto const bessel = params.no_bessel_correction() ? false : true;
+    auto const channels_last = params.channels_last();
     if constexpr (std::is_same_v<T, float>) {
       return std::make_unique<
         batch_normalization_layer<float, data_layout::DATA_PARALLEL, D>>(
         decay,
         epsilon,
         statistics_group_size,
-        bessel);
+        bessel,
+        channels_last);
     }
     else if constexpr (std::is_same_v<T, double>) {
       return std::make_unique<
@@ -88,7 +90,8 @@ std::unique_ptr<lbann::Layer> lbann::build_batch_normalization_layer_from_pbuf(
         decay,
         epsilon,
         statistics_group_size,
-        bessel);
+        bessel,
+        channels_last);
     }
 #ifdef LBANN_HAS_GPU_FP16
     else if constexpr (std::is_same_v<T, fp16> && D == El::Device::GPU) {
@@ -97,7 +100,8 @@ std::unique_ptr<lbann::Layer> lbann::build_batch_normalization_layer_from_pbuf(
         decay,
         epsilon,
         statistics_group_size,
-        bessel);
+        bessel,
+        channels_last);
     }
 #endif
   }
@@ -31,7 +31,8 @@ namespace lbann {
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 template <typename ArchiveT>
 void batch_normalization_layer<TensorDataType, Layout, Device>::serialize(
-  ArchiveT& ar)
+  ArchiveT& ar,
+  std::uint32_t const version)
 {
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
@@ -40,6 +41,12 @@ void batch_normalization_layer<TensorDataType, Layout, Device>::serialize(
      CEREAL_NVP(m_epsilon),
      CEREAL_NVP(m_statistics_group_size),
      CEREAL_NVP(m_bessel_correction));
+  // Version 1 added the channels-last layout and layer fusion
+  if (version >= 1) {
+    ar(CEREAL_NVP(m_channels_last),
+       CEREAL_NVP(m_fused_relu),
+       CEREAL_NVP(m_fused_residual));
+  }
 }
 
 } // namespace lbann
@@ -49,7 +56,11 @@ void batch_normalization_layer<TensorDataType, Layout, Device>::serialize(
 #include "lbann/macros/common_cereal_registration.hpp"
 #define LBANN_COMMA ,
 #define PROTO_DEVICE(T, D)                                                     \
-  LBANN_ADD_ALL_SERIALIZE_ETI(                                                 \
+  CEREAL_CLASS_VERSION(                                                        \
+    ::lbann::batch_normalization_layer<                                        \
+      T LBANN_COMMA ::lbann::data_layout::DATA_PARALLEL LBANN_COMMA D>,        \
+    1)                                                                         \
+  LBANN_ADD_ALL_VERSIONED_SERIALIZE_ETI(                                       \
     ::lbann::                                                                  \
       batch_normalization_layer<T, ::lbann::data_layout::DATA_PARALLEL, D>);   \
   CEREAL_REGISTER_TYPE_WITH_NAME(                                              \
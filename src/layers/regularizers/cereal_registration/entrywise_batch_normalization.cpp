@@ -37,7 +37,8 @@ void entrywise_batch_normalization_layer<TensorDataType, Layout, Device>::
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
      CEREAL_NVP(m_decay),
-     CEREAL_NVP(m_epsilon));
+     CEREAL_NVP(m_epsilon),
+     CEREAL_NVP(m_fuse_statistics));
 }
 
 } // namespace lbann
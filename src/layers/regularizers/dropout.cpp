@@ -27,8 +27,12 @@
 #define LBANN_DROPOUT_LAYER_INSTANTIATE
 #include "lbann/layers/regularizers/dropout.hpp"
 #include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/layers/regularizers/dropout_mask.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
+#include "lbann/utils/hash.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
 #include "lbann/proto/layers.pb.h"
 
 #ifdef LBANN_HAS_DISTCONV
@@ -38,10 +42,8 @@
 namespace lbann {
 
 template <typename TensorDataType, data_layout layout, El::Device device>
-void dropout<TensorDataType, layout, device>::fp_compute_cpu()
+void dropout<TensorDataType, layout, device>::fp_compute()
 {
-
-  // Matrices
   const auto& input = this->get_prev_activations();
   auto& output = this->get_activations();
 
@@ -53,33 +55,13 @@ void dropout<TensorDataType, layout, device>::fp_compute_cpu()
     return;
   }
 
-  // Construct mask matrix
-  const TensorDataType scale = static_cast<TensorDataType>(1 / m_keep_prob);
-  const auto& height = input.Height();
-  const auto& width = input.Width();
-  m_mask->Resize(height, width);
-#ifdef LBANN_DETERMINISTIC
-  bernoulli_fill_procdet(*m_mask, height, width, TensorDataType(m_keep_prob));
-  El::Scale(scale, *m_mask);
-#else
-  El::EntrywiseMap(
-    *m_mask,
-    (std::function<TensorDataType(
-       const TensorDataType&)>)([this, scale](
-                                  const TensorDataType& z) -> TensorDataType {
-      auto& gen = get_fast_generator();
-      std::bernoulli_distribution dist(m_keep_prob);
-      return dist(gen) ? scale : El::TypeTraits<TensorDataType>::Zero();
-    }));
-#endif // LBANN_DETERMINISTIC
-
-  // Apply mask matrix to get activations
-  El::Hadamard(input, *m_mask, output);
+  m_mask_seed = hash_combine(m_seed_base, m_num_masks++);
+  apply_mask(input, output);
 }
 
 /** Adjust gradients for dropout in backprop. */
 template <typename TensorDataType, data_layout layout, El::Device device>
-void dropout<TensorDataType, layout, device>::bp_compute_cpu()
+void dropout<TensorDataType, layout, device>::bp_compute()
 {
   const auto& gradient_wrt_output = this->get_prev_error_signals();
   auto& gradient_wrt_input = this->get_error_signals();
@@ -89,84 +71,49 @@ void dropout<TensorDataType, layout, device>::bp_compute_cpu()
     El::Copy(gradient_wrt_output, gradient_wrt_input);
   }
   else {
-    El::Hadamard(gradient_wrt_output, *m_mask, gradient_wrt_input);
+    // Same seed as the forward pass, hence the same mask
+    apply_mask(gradient_wrt_output, gradient_wrt_input);
   }
 }
 
 template <typename TensorDataType, data_layout layout, El::Device device>
-void dropout<TensorDataType, layout, device>::fp_compute_gpu()
+void dropout<TensorDataType, layout, device>::apply_mask(
+  const AbsDistMatrixType& input,
+  AbsDistMatrixType& output) const
 {
-#ifndef LBANN_HAS_DNN_LIB
-  LBANN_ERROR("DNN library not detected");
-#else
-
-  // Matrices
-  const auto& input = this->get_prev_activations();
-  const auto& local_input = input.LockedMatrix();
-  auto& output = this->get_activations();
-  auto& local_output = output.Matrix();
-
-  // Do nothing if dropout is disabled or there is no local data
-  const auto& mode =
-    this->m_model->get_execution_context().get_execution_mode();
-  if (mode != execution_mode::training || m_keep_prob < EvalType(0)) {
-    El::Copy(input, output);
+  const auto threshold = dropout_mask::keep_threshold(m_keep_prob);
+  const auto scale = static_cast<TensorDataType>(1 / m_keep_prob);
+#ifdef LBANN_HAS_GPU
+  if constexpr (device == El::Device::GPU) {
+    apply_dropout_mask_gpu(input, output, m_mask_seed, threshold, scale);
     return;
   }
-  if (local_input.Height() < 1 || local_input.Width() < 1) {
-    return;
-  }
-
-  // Initialize DNN library objects
-  auto&& input_desc = m_tensors_dnn_desc.get_prev_activations();
-  auto&& output_desc = m_tensors_dnn_desc.get_activations();
-  size_t size = dnn_lib::get_dropout_reserve_space_size(input_desc);
-  m_reserve_space.Resize((size + sizeof(TensorDataType) - 1) /
-                           sizeof(TensorDataType),
-                         1);
-
-  // Apply dropout on the GPU
-  dnn_lib::dropout_forward(m_dropout_dnn_desc,
-                           input_desc,
-                           local_input,
-                           output_desc,
-                           local_output,
-                           m_reserve_space);
-
-#endif // LBANN_HAS_DNN_LIB
-}
-
-template <typename TensorDataType, data_layout layout, El::Device device>
-void dropout<TensorDataType, layout, device>::bp_compute_gpu()
-{
-#ifndef LBANN_HAS_DNN_LIB
-  LBANN_ERROR("DNN library not detected");
-#else
-
-  // Matrices
-  const auto& gradient_wrt_output = this->get_prev_error_signals();
-  const auto& local_gradient_wrt_output = gradient_wrt_output.LockedMatrix();
-  auto& gradient_wrt_input = this->get_error_signals();
-  auto& local_gradient_wrt_input = gradient_wrt_input.Matrix();
-
-  // Copy error signal if dropout is disabled
-  const auto& mode =
-    this->m_model->get_execution_context().get_execution_mode();
-  if (mode != execution_mode::training || m_keep_prob < EvalType(0)) {
-    El::Copy(gradient_wrt_output, gradient_wrt_input);
-  }
-  else {
-    if (local_gradient_wrt_input.Height() > 0 &&
-        local_gradient_wrt_input.Width() > 0) {
-      dnn_lib::dropout_backward(m_dropout_dnn_desc,
-                                m_tensors_dnn_desc.get_prev_error_signals(),
-                                local_gradient_wrt_output,
-                                m_tensors_dnn_desc.get_error_signals(),
-                                local_gradient_wrt_input,
-                                m_reserve_space);
+#endif // LBANN_HAS_GPU
+
+  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto& local_input = static_cast<const CPUMatType&>(input.LockedMatrix());
+  auto& local_output = static_cast<CPUMatType&>(output.Matrix());
+  const El::Int local_height = local_input.Height();
+  const El::Int local_width = local_input.Width();
+  const uint64_t height = input.Height();
+  const El::Int col_shift = input.ColShift();
+  const El::Int col_stride = input.ColStride();
+  const El::Int row_shift = input.RowShift();
+  const El::Int row_stride = input.RowStride();
+  const uint64_t seed = m_mask_seed;
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int col = 0; col < local_width; ++col) {
+    for (El::Int row = 0; row < local_height; ++row) {
+      const uint64_t global_row = col_shift + row * col_stride;
+      const uint64_t global_col = row_shift + col * row_stride;
+      const bool keep = dropout_mask::keep(seed,
+                                           global_row + global_col * height,
+                                           threshold);
+      local_output(row, col) =
+        keep ? local_input(row, col) * scale
+             : El::TypeTraits<TensorDataType>::Zero();
     }
   }
-#endif // LBANN_HAS_DNN_LIB
 }
 
 template <typename TensorDataType, data_layout layout, El::Device device>
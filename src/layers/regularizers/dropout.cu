@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/layers/regularizers/dropout.hpp"
+#include "lbann/layers/regularizers/dropout_mask.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/**
+ *  Block dimensions: bsizex x bsizey x 1
+ *
+ *  Grid dimensions: (local_height / bsizex) x (local_width / bsizey) x 1
+ */
+template <typename TensorDataType>
+__global__ void apply_mask_kernel(El::Int local_height,
+                                  El::Int local_width,
+                                  uint64_t height,
+                                  El::Int col_shift,
+                                  El::Int col_stride,
+                                  El::Int row_shift,
+                                  El::Int row_stride,
+                                  uint64_t seed,
+                                  uint32_t threshold,
+                                  TensorDataType scale,
+                                  const TensorDataType* input,
+                                  El::Int input_ldim,
+                                  TensorDataType* output,
+                                  El::Int output_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  for (El::Int col = gidy; col < local_width; col += nthreadsy) {
+    const uint64_t global_col = row_shift + col * row_stride;
+    for (El::Int row = gidx; row < local_height; row += nthreadsx) {
+      const uint64_t global_row = col_shift + row * col_stride;
+      const bool keep =
+        dropout_mask::keep(seed, global_row + global_col * height, threshold);
+      output[row + col * output_ldim] =
+        keep ? input[row + col * input_ldim] * scale : TensorDataType(0.f);
+    }
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void apply_dropout_mask_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
+                            El::AbstractDistMatrix<TensorDataType>& output,
+                            uint64_t seed,
+                            uint32_t threshold,
+                            TensorDataType scale)
+{
+  const El::Int local_height = input.LocalHeight();
+  const El::Int local_width = input.LocalWidth();
+  if (local_height <= 0 || local_width <= 0) {
+    return;
+  }
+  // n.b. input and output may alias when the layer runs in-place
+  constexpr size_t block_size_x = 256;
+  constexpr size_t block_size_y = 1;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size_x;
+  block_dims.y = block_size_y;
+  grid_dims.x = (local_height + block_size_x - 1) / block_size_x;
+  grid_dims.y = (local_width + block_size_y - 1) / block_size_y;
+  gpu_lib::clip_grid_dims(grid_dims);
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                     gpu::get_sync_info(input));
+  hydrogen::gpu::LaunchKernel(apply_mask_kernel<TensorDataType>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              local_height,
+                              local_width,
+                              static_cast<uint64_t>(input.Height()),
+                              input.ColShift(),
+                              input.ColStride(),
+                              input.RowShift(),
+                              input.RowStride(),
+                              seed,
+                              threshold,
+                              scale,
+                              input.LockedBuffer(),
+                              input.LDim(),
+                              output.Buffer(),
+                              output.LDim());
+}
+
+#define PROTO(T)                                                               \
+  template void apply_dropout_mask_gpu<T>(                                     \
+    const El::AbstractDistMatrix<T>& input,                                    \
+    El::AbstractDistMatrix<T>& output,                                         \
+    uint64_t seed,                                                             \
+    uint32_t threshold,                                                        \
+    T scale)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
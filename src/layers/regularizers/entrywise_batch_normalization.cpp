@@ -48,11 +48,15 @@ constexpr El::Int bsize = _bsize > 1 ? _bsize : 1;
  *  mean = sum(x_i) / n
  *
  *  var = ( sum(x_i^2)/n - mean^2 ) * n/(n-1)
+ *
+ *  If @c local_sums_ready, batch_statistics already holds the local
+ *  sums and sums of squares.
  */
 template <typename TensorDataType>
 void compute_batch_statistics(
   lbann_comm& comm,
   TensorDataType decay,
+  bool local_sums_ready,
   const El::AbstractDistMatrix<TensorDataType>& input,
   El::AbstractDistMatrix<TensorDataType>& batch_statistics,
   El::AbstractDistMatrix<TensorDataType>& running_mean,
@@ -75,17 +79,19 @@ void compute_batch_statistics(
   const El::Int local_width = local_input.Width();
 
   // Compute local sums
-  El::Zero(batch_statistics);
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int row_start = 0; row_start < local_height; row_start += bsize) {
-    const El::Int row_end = std::min(row_start + bsize, local_height);
-    const El::Int col_start = 0;
-    const El::Int col_end = local_width;
-    for (El::Int col = col_start; col < col_end; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
-        const auto& x = local_input(row, col);
-        local_batch_mean(row, 0) += x;
-        local_batch_var(row, 0) += x * x;
+  if (!local_sums_ready) {
+    El::Zero(batch_statistics);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int row_start = 0; row_start < local_height; row_start += bsize) {
+      const El::Int row_end = std::min(row_start + bsize, local_height);
+      const El::Int col_start = 0;
+      const El::Int col_end = local_width;
+      for (El::Int col = col_start; col < col_end; ++col) {
+        for (El::Int row = row_start; row < row_end; ++row) {
+          const auto& x = local_input(row, col);
+          local_batch_mean(row, 0) += x;
+          local_batch_var(row, 0) += x * x;
+        }
       }
     }
   }
@@ -161,6 +167,7 @@ void fp_impl(lbann_comm& comm,
              TensorDataType decay,
              TensorDataType epsilon,
              bool is_training,
+             bool local_sums_ready,
              const El::AbstractDistMatrix<TensorDataType>& input,
              El::AbstractDistMatrix<TensorDataType>& output,
              El::AbstractDistMatrix<TensorDataType>& batch_statistics,
@@ -170,9 +177,11 @@ void fp_impl(lbann_comm& comm,
   using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
 
   // Make sure workspace is aligned with input tensor
-  batch_statistics.Empty(false);
-  batch_statistics.AlignWith(input);
-  batch_statistics.Resize(input.Height(), 2);
+  if (!local_sums_ready) {
+    batch_statistics.Empty(false);
+    batch_statistics.AlignWith(input);
+    batch_statistics.Resize(input.Height(), 2);
+  }
 
   // Local matrices
   const auto& local_input =
@@ -185,6 +194,7 @@ void fp_impl(lbann_comm& comm,
     // For training, normalize with batch statistics
     compute_batch_statistics<TensorDataType>(comm,
                                              decay,
+                                             local_sums_ready,
                                              input,
                                              batch_statistics,
                                              running_mean,
@@ -436,6 +446,7 @@ void entrywise_batch_normalization_layer<TensorDataType, T_layout, Dev>::
           this->m_decay,
           this->m_epsilon,
           mode == execution_mode::training,
+          mode == execution_mode::training && m_statistics_from_parent,
           this->get_prev_activations(),
           this->get_activations(),
           *this->m_batch_statistics,
@@ -109,11 +109,15 @@ compute_statistics_kernel(size_t size,
  *  mean = sum(x_i) / n
  *
  *  var = ( sum(x_i^2)/n - mean^2 ) * n/(n-1)
+ *
+ *  If @c local_sums_ready, batch_statistics already holds the local
+ *  sums and sums of squares.
  */
 template <typename TensorDataType>
 void compute_batch_statistics(
   lbann_comm& comm,
   TensorDataType decay,
+  bool local_sums_ready,
   const El::AbstractDistMatrix<TensorDataType>& input,
   El::AbstractDistMatrix<TensorDataType>& batch_statistics,
   El::AbstractDistMatrix<TensorDataType>& running_mean,
@@ -141,8 +145,10 @@ void compute_batch_statistics(
   const size_t local_width = local_input.Width();
 
   // Compute local sums
-  El::Zero(batch_statistics);
-  if (local_height > 0) {
+  if (!local_sums_ready) {
+    El::Zero(batch_statistics);
+  }
+  if (local_height > 0 && !local_sums_ready) {
     auto multisync =
       El::MakeMultiSync(gpu::get_sync_info(local_batch_statistics),
                         gpu::get_sync_info(local_input));
@@ -282,6 +288,7 @@ void fp_impl(lbann_comm& comm,
              TensorDataType decay,
              TensorDataType epsilon,
              bool is_training,
+             bool local_sums_ready,
              const El::AbstractDistMatrix<TensorDataType>& input,
              El::AbstractDistMatrix<TensorDataType>& output,
              El::AbstractDistMatrix<TensorDataType>& batch_statistics,
@@ -290,9 +297,11 @@ void fp_impl(lbann_comm& comm,
 {
 
   // Make sure workspace is aligned with input tensor
-  batch_statistics.Empty(false);
-  batch_statistics.AlignWith(input);
-  batch_statistics.Resize(input.Height(), 2);
+  if (!local_sums_ready) {
+    batch_statistics.Empty(false);
+    batch_statistics.AlignWith(input);
+    batch_statistics.Resize(input.Height(), 2);
+  }
 
   // Local matrices
   const auto& local_input =
@@ -307,6 +316,7 @@ void fp_impl(lbann_comm& comm,
     // For training, normalize with batch statistics
     compute_batch_statistics<TensorDataType>(comm,
                                              decay,
+                                             local_sums_ready,
                                              input,
                                              batch_statistics,
                                              running_mean,
@@ -705,6 +715,7 @@ void entrywise_batch_normalization_layer<TensorDataType, T_layout, Dev>::
           this->m_decay,
           this->m_epsilon,
           mode == execution_mode::training,
+          mode == execution_mode::training && m_statistics_from_parent,
           this->get_prev_activations(),
           this->get_activations(),
           *this->m_batch_statistics,
@@ -42,12 +42,14 @@ lbann::build_entrywise_batch_normalization_layer_from_pbuf(
   if constexpr (std::is_same_v<T, float>)
     return std::make_unique<entrywise_batch_normalization_layer<float, L, D>>(
       params.decay(),
-      params.epsilon());
+      params.epsilon(),
+      params.fuse_statistics());
 #ifdef LBANN_HAS_DOUBLE
   else if constexpr (std::is_same_v<T, double>)
     return std::make_unique<entrywise_batch_normalization_layer<double, L, D>>(
       params.decay(),
-      params.epsilon());
+      params.epsilon(),
+      params.fuse_statistics());
 #endif // LBANN_HAS_DOUBLE
   else
     LBANN_ERROR("entrywise_batch_normalization_layer is only supported for "
@@ -33,10 +33,166 @@
 #include "lbann/layers/data_type_distconv_adapter.hpp"
 #endif // LBANN_HAS_DISTCONV
 
+#include <algorithm>
+
 namespace lbann {
 
 namespace {
 
+/** @brief Forward prop when every normalized row is stored locally
+ *
+ *  Each row is handled by one OpenMP task with contiguous loops that
+ *  the compiler can vectorize. The variance is computed with a second
+ *  pass over the row rather than from sums of squares.
+ */
+template <typename TensorDataType>
+void fp_local_rows(TensorDataType epsilon,
+                   El::Int normalization_size,
+                   El::Int num_normalized,
+                   El::Int normalization_stride,
+                   const El::Matrix<TensorDataType, El::Device::CPU>& input,
+                   El::Matrix<TensorDataType, El::Device::CPU>& output,
+                   El::Matrix<TensorDataType, El::Device::CPU>& statistics,
+                   const TensorDataType* local_scale,
+                   const TensorDataType* local_bias)
+{
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  const auto one = El::TypeTraits<TensorDataType>::One();
+  const auto n = El::To<TensorDataType>(normalization_size);
+  const El::Int local_num_samples = input.Width();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int i = 0; i < local_num_samples; ++i) {
+    for (El::Int j = 0; j < num_normalized; ++j) {
+      const auto* __restrict__ x =
+        input.LockedBuffer(j * normalization_stride, i);
+      auto* __restrict__ y = output.Buffer(j * normalization_stride, i);
+
+      // Two-pass statistics
+      auto sum = zero;
+      for (El::Int k = 0; k < normalization_size; ++k) {
+        sum += x[k];
+      }
+      const auto mean = sum / n;
+      auto sqsum = zero;
+      for (El::Int k = 0; k < normalization_size; ++k) {
+        const auto diff = x[k] - mean;
+        sqsum += diff * diff;
+      }
+      const auto var = sqsum / n;
+      statistics(j, i) = mean;
+      statistics(j + num_normalized, i) = var;
+
+      // Normalize, scale, and shift
+      const TensorDataType inv_stdev = one / El::Sqrt(var + epsilon);
+      for (El::Int k = 0; k < normalization_size; ++k) {
+        y[k] = (x[k] - mean) * inv_stdev;
+      }
+      if (local_scale) {
+        for (El::Int k = 0; k < normalization_size; ++k) {
+          y[k] *= local_scale[k];
+        }
+      }
+      if (local_bias) {
+        for (El::Int k = 0; k < normalization_size; ++k) {
+          y[k] += local_bias[k];
+        }
+      }
+    }
+  }
+}
+
+/** @brief Backprop when every normalized row is stored locally
+ *
+ *  The error signal is computed one row per OpenMP task. Scale and
+ *  bias gradients are then accumulated over blocks of entries, so
+ *  no atomics are needed.
+ */
+template <typename TensorDataType>
+void bp_local_rows(
+  TensorDataType epsilon,
+  El::Int normalization_size,
+  El::Int num_normalized,
+  El::Int normalization_stride,
+  const El::Matrix<TensorDataType, El::Device::CPU>& input,
+  const El::Matrix<TensorDataType, El::Device::CPU>& output_grad,
+  El::Matrix<TensorDataType, El::Device::CPU>& input_grad,
+  const El::Matrix<TensorDataType, El::Device::CPU>& statistics,
+  const TensorDataType* local_scale,
+  TensorDataType* scale_grad,
+  TensorDataType* bias_grad)
+{
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
+  const auto one = El::TypeTraits<TensorDataType>::One();
+  const auto two = El::To<TensorDataType>(2);
+  const auto n = El::To<TensorDataType>(normalization_size);
+  const El::Int local_num_samples = input.Width();
+
+  // Compute gradient w.r.t. input
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int i = 0; i < local_num_samples; ++i) {
+    for (El::Int j = 0; j < num_normalized; ++j) {
+      const auto offset = j * normalization_stride;
+      const auto* __restrict__ x = input.LockedBuffer(offset, i);
+      const auto* __restrict__ dy = output_grad.LockedBuffer(offset, i);
+      auto* __restrict__ dx = input_grad.Buffer(offset, i);
+      const auto mean = statistics(j, i);
+      const auto var = statistics(j + num_normalized, i);
+      const TensorDataType inv_stdev = one / El::Sqrt(var + epsilon);
+
+      // Gradient w.r.t. statistics
+      auto sum_dy = zero;
+      auto sum_dy_diff = zero;
+      for (El::Int k = 0; k < normalization_size; ++k) {
+        const auto dxhat = (local_scale ? dy[k] * local_scale[k] : dy[k]);
+        sum_dy += dxhat;
+        sum_dy_diff += dxhat * (x[k] - mean);
+      }
+      const auto dmean = -sum_dy * inv_stdev;
+      const auto dvar = -sum_dy_diff * inv_stdev * inv_stdev * inv_stdev / two;
+
+      // Gradient w.r.t. input
+      for (El::Int k = 0; k < normalization_size; ++k) {
+        const auto dxhat = (local_scale ? dy[k] * local_scale[k] : dy[k]);
+        dx[k] =
+          (dxhat * inv_stdev + dmean / n + dvar * (x[k] - mean) * two / n);
+      }
+    }
+  }
+
+  // Compute gradients w.r.t. scale and bias
+  if (scale_grad == nullptr && bias_grad == nullptr) {
+    return;
+  }
+  constexpr El::Int block_size = 64;
+  const El::Int num_blocks =
+    (normalization_size + block_size - 1) / block_size;
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int block = 0; block < num_blocks; ++block) {
+    const El::Int k_begin = block * block_size;
+    const El::Int k_end = std::min(k_begin + block_size, normalization_size);
+    for (El::Int i = 0; i < local_num_samples; ++i) {
+      for (El::Int j = 0; j < num_normalized; ++j) {
+        const auto offset = j * normalization_stride;
+        const auto* __restrict__ x = input.LockedBuffer(offset, i);
+        const auto* __restrict__ dy = output_grad.LockedBuffer(offset, i);
+        const auto mean = statistics(j, i);
+        const auto var = statistics(j + num_normalized, i);
+        const TensorDataType inv_stdev = one / El::Sqrt(var + epsilon);
+        if (bias_grad) {
+          for (El::Int k = k_begin; k < k_end; ++k) {
+            bias_grad[k] += dy[k];
+          }
+        }
+        if (scale_grad) {
+          for (El::Int k = k_begin; k < k_end; ++k) {
+            scale_grad[k] += dy[k] * (x[k] - mean) * inv_stdev;
+          }
+        }
+      }
+    }
+  }
+}
+
 /** @brief Forward prop */
 template <typename TensorDataType>
 void fp_impl(lbann_comm& comm,
@@ -72,6 +228,21 @@ void fp_impl(lbann_comm& comm,
   // Dimensions
   const El::Int local_num_samples = local_input.Width();
 
+  // Fused implementation if no communication is needed
+  if (normalization_size == global_normalization_size &&
+      global_normalization_size > 1 && statistics.RedundantSize() == 1) {
+    fp_local_rows(epsilon,
+                  normalization_size,
+                  num_normalized,
+                  normalization_stride,
+                  local_input,
+                  local_output,
+                  local_statistics,
+                  local_scale,
+                  local_bias);
+    return;
+  }
+
   // Compute sums
   El::Zero(statistics);
   LBANN_OMP_PARALLEL_FOR_COLLAPSE2
@@ -191,6 +362,23 @@ void bp_impl(lbann_comm& comm,
     return;
   }
 
+  // Fused implementation if no communication is needed
+  if (normalization_size == global_normalization_size &&
+      statistics_grad.RedundantSize() == 1) {
+    bp_local_rows(epsilon,
+                  normalization_size,
+                  num_normalized,
+                  normalization_stride,
+                  local_input,
+                  local_output_grad,
+                  local_input_grad,
+                  local_statistics,
+                  local_scale,
+                  scale_grad,
+                  bias_grad);
+    return;
+  }
+
   // Compute gradient w.r.t. statistics
   //   dL/dmean = - sum(dL/dy_i) / sqrt(var+epsilon)
   //   dL/dvar = - sum(dL/dy_i * (x_i-mean)) * (var+epsilon)^(-3/2) / 2
@@ -36,6 +36,8 @@
 
 #include <thrust/pair.h>
 
+#include <cstdint>
+
 namespace lbann {
 
 namespace {
@@ -201,6 +203,231 @@ __global__ void fp_output_kernel(size_t local_num_samples,
   }
 }
 
+/** Vector of entries for wide memory accesses. */
+template <typename TensorDataType, size_t vec_size>
+struct alignas(sizeof(TensorDataType) * vec_size) vector_t
+{
+  TensorDataType data[vec_size];
+};
+
+/** Fused forward prop when every normalized row is stored locally.
+ *
+ *  Each block normalizes one row at a time with vectorized loads. The
+ *  mean and variance are computed with two passes over the row, which
+ *  stays in cache for the hidden sizes of typical transformers.
+ *
+ *  Block dimensions: bdimx x 1 x 1
+ *
+ *  Grid dimensions: (local_num_samples * num_normalized) x 1 x 1
+ */
+template <size_t bdimx, size_t vec_size, typename TensorDataType>
+__global__ void fp_fused_kernel(size_t local_num_samples,
+                                size_t normalization_size,
+                                size_t num_normalized,
+                                size_t normalization_stride,
+                                TensorDataType epsilon,
+                                const TensorDataType* __restrict__ input,
+                                size_t input_ldim,
+                                TensorDataType* __restrict__ output,
+                                size_t output_ldim,
+                                TensorDataType* __restrict__ means,
+                                size_t means_stride,
+                                TensorDataType* __restrict__ vars,
+                                size_t vars_stride,
+                                const TensorDataType* __restrict__ scale,
+                                const TensorDataType* __restrict__ bias)
+{
+  using vec_t = vector_t<TensorDataType, vec_size>;
+  __shared__ TensorDataType shared_stat;
+
+  const size_t tid = threadIdx.x;
+  const size_t num_rows = local_num_samples * num_normalized;
+  const size_t num_vecs = normalization_size / vec_size;
+  const TensorDataType n = TensorDataType(normalization_size);
+  for (size_t row = blockIdx.x; row < num_rows; row += gridDim.x) {
+    const size_t i = row / num_normalized;
+    const size_t j = row % num_normalized;
+    const auto* x = reinterpret_cast<const vec_t*>(
+      &input[i * input_ldim + j * normalization_stride]);
+    auto* y = reinterpret_cast<vec_t*>(
+      &output[i * output_ldim + j * normalization_stride]);
+
+    // Mean
+    TensorDataType sum(0);
+    for (size_t k = tid; k < num_vecs; k += bdimx) {
+      const vec_t xk = x[k];
+#pragma unroll
+      for (size_t v = 0; v < vec_size; ++v) {
+        sum += xk.data[v];
+      }
+    }
+    sum = gpu_lib::block_reduce<bdimx, 1, 1>(sum);
+    if (tid == 0) {
+      shared_stat = sum / n;
+    }
+    __syncthreads();
+    const TensorDataType mean = shared_stat;
+    __syncthreads();
+
+    // Variance
+    TensorDataType sqsum(0);
+    for (size_t k = tid; k < num_vecs; k += bdimx) {
+      const vec_t xk = x[k];
+#pragma unroll
+      for (size_t v = 0; v < vec_size; ++v) {
+        const auto diff = xk.data[v] - mean;
+        sqsum += diff * diff;
+      }
+    }
+    sqsum = gpu_lib::block_reduce<bdimx, 1, 1>(sqsum);
+    if (tid == 0) {
+      const auto var = sqsum / n;
+      shared_stat = var;
+      means[i * means_stride + j] = mean;
+      vars[i * vars_stride + j] = var;
+    }
+    __syncthreads();
+    const auto inv_stdev = gpu_lib::rsqrt(shared_stat + epsilon);
+    __syncthreads();
+
+    // Output
+    for (size_t k = tid; k < num_vecs; k += bdimx) {
+      const vec_t xk = x[k];
+      vec_t yk;
+#pragma unroll
+      for (size_t v = 0; v < vec_size; ++v) {
+        const size_t idx = k * vec_size + v;
+        auto result = (xk.data[v] - mean) * inv_stdev;
+        if (scale != nullptr) {
+          result *= scale[idx];
+        }
+        if (bias != nullptr) {
+          result += bias[idx];
+        }
+        yk.data[v] = result;
+      }
+      y[k] = yk;
+    }
+  }
+}
+
+/** Fused backprop when every normalized row is stored locally.
+ *
+ *  Each block computes the error signal for one row at a time with
+ *  vectorized loads. Gradients w.r.t. the per-row statistics never
+ *  leave the block.
+ *
+ *  Block dimensions: bdimx x 1 x 1
+ *
+ *  Grid dimensions: (local_num_samples * num_normalized) x 1 x 1
+ */
+template <size_t bdimx, size_t vec_size, typename TensorDataType>
+__global__ void bp_fused_kernel(size_t local_num_samples,
+                                size_t normalization_size,
+                                size_t num_normalized,
+                                size_t normalization_stride,
+                                TensorDataType epsilon,
+                                const TensorDataType* __restrict__ input,
+                                size_t input_ldim,
+                                const TensorDataType* __restrict__ output_grad,
+                                size_t output_grad_ldim,
+                                TensorDataType* __restrict__ input_grad,
+                                size_t input_grad_ldim,
+                                const TensorDataType* __restrict__ means,
+                                size_t means_stride,
+                                const TensorDataType* __restrict__ vars,
+                                size_t vars_stride,
+                                const TensorDataType* __restrict__ scale,
+                                TensorDataType* __restrict__ scale_grad,
+                                TensorDataType* __restrict__ bias_grad)
+{
+  using vec_t = vector_t<TensorDataType, vec_size>;
+  using pair_t = thrust::pair<TensorDataType, TensorDataType>;
+  using pair_sum_t = pair_sum<pair_t>;
+  __shared__ TensorDataType shared_sums[2];
+
+  const size_t tid = threadIdx.x;
+  const size_t num_rows = local_num_samples * num_normalized;
+  const size_t num_vecs = normalization_size / vec_size;
+  const TensorDataType n = TensorDataType(normalization_size);
+  for (size_t row = blockIdx.x; row < num_rows; row += gridDim.x) {
+    const size_t i = row / num_normalized;
+    const size_t j = row % num_normalized;
+    const size_t offset = j * normalization_stride;
+    const auto* x =
+      reinterpret_cast<const vec_t*>(&input[i * input_ldim + offset]);
+    const auto* dy = reinterpret_cast<const vec_t*>(
+      &output_grad[i * output_grad_ldim + offset]);
+    auto* dx =
+      reinterpret_cast<vec_t*>(&input_grad[i * input_grad_ldim + offset]);
+    const auto mean = means[i * means_stride + j];
+    const auto inv_stdev = gpu_lib::rsqrt(vars[i * vars_stride + j] + epsilon);
+
+    // Gradient w.r.t. statistics, scale, and bias
+    pair_t sums(0, 0);
+    for (size_t k = tid; k < num_vecs; k += bdimx) {
+      const vec_t xk = x[k];
+      const vec_t dyk = dy[k];
+#pragma unroll
+      for (size_t v = 0; v < vec_size; ++v) {
+        const size_t idx = k * vec_size + v;
+        const auto diff = xk.data[v] - mean;
+        auto dxhat = dyk.data[v];
+        if (bias_grad != nullptr) {
+          gpu_lib::atomic_add(&bias_grad[idx], dxhat);
+        }
+        if (scale_grad != nullptr) {
+          gpu_lib::atomic_add(&scale_grad[idx], dxhat * diff * inv_stdev);
+        }
+        if (scale != nullptr) {
+          dxhat *= scale[idx];
+        }
+        sums.first += dxhat;
+        sums.second += dxhat * diff;
+      }
+    }
+    sums = gpu_lib::block_reduce<bdimx, 1, 1, pair_t, pair_sum_t>(sums);
+    if (tid == 0) {
+      shared_sums[0] = sums.first;
+      shared_sums[1] = sums.second;
+    }
+    __syncthreads();
+    const TensorDataType dmean = -shared_sums[0] * inv_stdev;
+    const TensorDataType dvar = -shared_sums[1] * inv_stdev * inv_stdev *
+                                inv_stdev / TensorDataType(2);
+    __syncthreads();
+
+    // Gradient w.r.t. input
+    for (size_t k = tid; k < num_vecs; k += bdimx) {
+      const vec_t xk = x[k];
+      const vec_t dyk = dy[k];
+      vec_t dxk;
+#pragma unroll
+      for (size_t v = 0; v < vec_size; ++v) {
+        const size_t idx = k * vec_size + v;
+        auto dxhat = dyk.data[v];
+        if (scale != nullptr) {
+          dxhat *= scale[idx];
+        }
+        dxk.data[v] = (dxhat * inv_stdev + dmean / n +
+                       dvar * (xk.data[v] - mean) * TensorDataType(2) / n);
+      }
+      dx[k] = dxk;
+    }
+  }
+}
+
+/** Whether a matrix can be accessed with vectors of @c vec_size
+ *  entries.
+ */
+template <size_t vec_size, typename TensorDataType>
+bool is_vectorizable(const TensorDataType* buffer, size_t ldim)
+{
+  const auto address = reinterpret_cast<uintptr_t>(buffer);
+  return (address % (vec_size * sizeof(TensorDataType)) == 0 &&
+          ldim % vec_size == 0);
+}
+
 /** @brief Forward prop */
 template <typename TensorDataType>
 void fp_impl(lbann_comm& comm,
@@ -242,6 +469,55 @@ void fp_impl(lbann_comm& comm,
     return;
   }
 
+  // Fused implementation if no communication is needed
+  // Note: Hidden sizes of 768-8192 give 192-2048 vectors per row,
+  // which keep a 256-thread block busy.
+  if (normalization_size == global_normalization_size &&
+      global_normalization_size > 1 && statistics.RedundantSize() == 1) {
+    const bool vectorize =
+      (normalization_size % 4 == 0 && normalization_stride % 4 == 0 &&
+       is_vectorizable<4>(local_input.LockedBuffer(), local_input.LDim()) &&
+       is_vectorizable<4>(local_output.LockedBuffer(), local_output.LDim()));
+    const El::Int num_vecs = normalization_size / (vectorize ? 4 : 1);
+    const El::Int block_size = (num_vecs >= 256 ? 256 : 64);
+    auto kernel = fp_fused_kernel<64, 1, TensorDataType>;
+    if (vectorize && block_size == 256) {
+      kernel = fp_fused_kernel<256, 4, TensorDataType>;
+    }
+    else if (vectorize) {
+      kernel = fp_fused_kernel<64, 4, TensorDataType>;
+    }
+    else if (block_size == 256) {
+      kernel = fp_fused_kernel<256, 1, TensorDataType>;
+    }
+    dim3 grid_dims(local_num_samples * num_normalized, 1, 1);
+    gpu_lib::clip_grid_dims(grid_dims);
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_output),
+                                       gpu::get_sync_info(local_statistics),
+                                       gpu::get_sync_info(local_input));
+    hydrogen::gpu::LaunchKernel(kernel,
+                                grid_dims,
+                                block_size,
+                                0,
+                                multisync,
+                                local_num_samples,
+                                normalization_size,
+                                num_normalized,
+                                normalization_stride,
+                                epsilon,
+                                local_input.LockedBuffer(),
+                                local_input.LDim(),
+                                local_output.Buffer(),
+                                local_output.LDim(),
+                                local_means.Buffer(),
+                                local_means.LDim(),
+                                local_vars.Buffer(),
+                                local_vars.LDim(),
+                                local_scale,
+                                local_bias);
+    return;
+  }
+
   // Compute sums
   El::Zero(statistics);
   if (!local_input.IsEmpty()) {
@@ -565,6 +841,64 @@ void bp_impl(lbann_comm& comm,
     return;
   }
 
+  // Fused implementation if no communication is needed
+  if (normalization_size == global_normalization_size &&
+      statistics_grad.RedundantSize() == 1) {
+    if (local_num_samples < 1) {
+      return;
+    }
+    const bool vectorize =
+      (normalization_size % 4 == 0 && normalization_stride % 4 == 0 &&
+       is_vectorizable<4>(local_input.LockedBuffer(), local_input.LDim()) &&
+       is_vectorizable<4>(local_output_grad.LockedBuffer(),
+                          local_output_grad.LDim()) &&
+       is_vectorizable<4>(local_input_grad.LockedBuffer(),
+                          local_input_grad.LDim()));
+    const El::Int num_vecs = normalization_size / (vectorize ? 4 : 1);
+    const El::Int block_size = (num_vecs >= 256 ? 256 : 64);
+    auto kernel = bp_fused_kernel<64, 1, TensorDataType>;
+    if (vectorize && block_size == 256) {
+      kernel = bp_fused_kernel<256, 4, TensorDataType>;
+    }
+    else if (vectorize) {
+      kernel = bp_fused_kernel<64, 4, TensorDataType>;
+    }
+    else if (block_size == 256) {
+      kernel = bp_fused_kernel<256, 1, TensorDataType>;
+    }
+    dim3 grid_dims(local_num_samples * num_normalized, 1, 1);
+    gpu_lib::clip_grid_dims(grid_dims);
+    auto multisync =
+      El::MakeMultiSync(gpu::get_sync_info(local_input_grad),
+                        gpu::get_sync_info(local_output_grad),
+                        gpu::get_sync_info(local_statistics),
+                        gpu::get_sync_info(local_input));
+    hydrogen::gpu::LaunchKernel(kernel,
+                                grid_dims,
+                                block_size,
+                                0,
+                                multisync,
+                                local_num_samples,
+                                normalization_size,
+                                num_normalized,
+                                normalization_stride,
+                                epsilon,
+                                local_input.LockedBuffer(),
+                                local_input.LDim(),
+                                local_output_grad.LockedBuffer(),
+                                local_output_grad.LDim(),
+                                local_input_grad.Buffer(),
+                                local_input_grad.LDim(),
+                                local_means.LockedBuffer(),
+                                local_means.LDim(),
+                                local_vars.LockedBuffer(),
+                                local_vars.LDim(),
+                                local_scale,
+                                scale_grad,
+                                bias_grad);
+    return;
+  }
+
   // Compute gradient w.r.t. statistics
   El::Zero(statistics_grad);
   if (!local_output_grad.IsEmpty()) {
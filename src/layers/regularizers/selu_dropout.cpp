@@ -27,8 +27,11 @@
 #define LBANN_SELU_DROPOUT_LAYER_INSTANTIATE
 #include "lbann/layers/regularizers/selu_dropout.hpp"
 #include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/layers/regularizers/dropout_mask.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
+#include "lbann/utils/hash.hpp"
+#include "lbann/utils/random_number_generators.hpp"
 
 #ifdef LBANN_HAS_DISTCONV
 #include "lbann/layers/data_type_distconv_adapter.hpp"
@@ -57,11 +60,8 @@ namespace lbann {
 
 template <typename T, data_layout L, El::Device D>
 selu_dropout<T, L, D>::selu_dropout(T keep_prob, T alpha, T scale)
-  : data_type_layer<T>(nullptr), m_keep_prob(keep_prob), m_mask(nullptr)
+  : data_type_layer<T>(nullptr), m_keep_prob(keep_prob)
 {
-#ifdef LBANN_DETERMINISTIC
-  LBANN_WARNING("selu_dropout: deterministic dropout not supported");
-#endif
   // Compute alpha' and the affine transform.
   m_alpha_prime = -scale * alpha;
   m_a = keep_prob + m_alpha_prime * m_alpha_prime * keep_prob *
@@ -70,47 +70,6 @@ selu_dropout<T, L, D>::selu_dropout(T keep_prob, T alpha, T scale)
   m_b = -m_a * m_alpha_prime * (El::TypeTraits<T>::One() - keep_prob);
 }
 
-template <typename T, data_layout L, El::Device D>
-selu_dropout<T, L, D>::selu_dropout(const selu_dropout& other)
-  : data_type_layer<T>(other),
-    m_alpha_prime(other.m_alpha_prime),
-    m_a(other.m_a),
-    m_b(other.m_b),
-    m_keep_prob(other.m_keep_prob),
-    m_mask(other.m_mask)
-{
-  if (m_mask != nullptr) {
-    m_mask = m_mask->Copy();
-  }
-}
-
-template <typename T, data_layout L, El::Device D>
-auto selu_dropout<T, L, D>::operator=(const selu_dropout& other)
-  -> selu_dropout&
-{
-  data_type_layer<T>::operator=(other);
-  m_alpha_prime = other.m_alpha_prime;
-  m_a = other.m_a;
-  m_b = other.m_b;
-  m_keep_prob = other.m_keep_prob;
-  if (m_mask != nullptr) {
-    delete m_mask;
-  }
-  m_mask = other.m_mask;
-  if (m_mask != nullptr) {
-    m_mask = m_mask->Copy();
-  }
-  return *this;
-}
-
-template <typename T, data_layout L, El::Device D>
-selu_dropout<T, L, D>::~selu_dropout()
-{
-  if (m_mask != nullptr) {
-    delete m_mask;
-  }
-}
-
 template <typename T, data_layout L, El::Device D>
 auto selu_dropout<T, L, D>::copy() const -> selu_dropout*
 {
@@ -156,10 +115,23 @@ template <typename T, data_layout L, El::Device D>
 void selu_dropout<T, L, D>::setup_data(size_t max_mini_batch_size)
 {
   data_type_layer<T>::setup_data(max_mini_batch_size);
-  if (m_mask != nullptr) {
-    delete m_mask;
-  }
-  m_mask = this->get_activations().Copy();
+
+  // Every rank derives the same mask seeds, so masks only depend on
+  // the global position of each entry
+  m_seed_base = get_generator()();
+  this->get_comm()->trainer_broadcast(0, m_seed_base);
+}
+
+template <typename T, data_layout L, El::Device D>
+bool selu_dropout<T, L, D>::keep(El::Int row, El::Int col) const
+{
+  const auto& acts = this->get_activations();
+  const uint64_t global_row = acts.GlobalRow(row);
+  const uint64_t global_col = acts.GlobalCol(col);
+  return dropout_mask::keep(
+    m_mask_seed,
+    global_row + global_col * static_cast<uint64_t>(acts.Height()),
+    dropout_mask::keep_threshold(m_keep_prob));
 }
 
 template <typename T, data_layout L, El::Device D>
@@ -174,24 +146,19 @@ void selu_dropout<T, L, D>::fp_compute()
   else {
 
     const auto* input_acts = &this->get_prev_activations();
-    const El::Int height = input_acts->Height();
-    const El::Int width = input_acts->Width();
     const El::Int local_height = input_acts->LocalHeight();
     const El::Int local_width = input_acts->LocalWidth();
 
     const auto& local_input_acts = input_acts->LockedMatrix();
     CPUMatrixType& local_output_acts = this->get_local_activations();
-    CPUMatrixType& local_mask = m_mask->Matrix();
 
-    // Construct and apply mask and the affine transform.
-    // TODO: Optimize.
-    El::Bernoulli(*m_mask, height, width, m_keep_prob);
+    // Apply the mask and the affine transform. The mask is
+    // regenerated from its seed in backprop.
+    m_mask_seed = hash_combine(m_seed_base, m_num_masks++);
     for (El::Int col = 0; col < local_width; ++col) {
       for (El::Int row = 0; row < local_height; ++row) {
         local_output_acts(row, col) =
-          m_a * (local_input_acts(row, col) * local_mask(row, col) +
-                 m_alpha_prime *
-                   (El::TypeTraits<T>::One() - local_mask(row, col))) +
+          m_a * (keep(row, col) ? local_input_acts(row, col) : m_alpha_prime) +
           m_b;
       }
     }
@@ -210,14 +177,14 @@ void selu_dropout<T, L, D>::bp_compute()
 
     const auto& local_prev_error_signal = this->get_local_prev_error_signals();
     CPUMatrixType& local_error_signal = this->get_local_error_signals();
-    CPUMatrixType& local_mask = m_mask->Matrix();
     const El::Int local_height = local_prev_error_signal.Height();
     const El::Int local_width = local_prev_error_signal.Width();
     // Reweight with the affine scale factor and the dropout mask.
     for (El::Int col = 0; col < local_width; ++col) {
       for (El::Int row = 0; row < local_height; ++row) {
         local_error_signal(row, col) =
-          m_a * local_prev_error_signal(row, col) * local_mask(row, col);
+          keep(row, col) ? m_a * local_prev_error_signal(row, col)
+                         : El::TypeTraits<T>::Zero();
       }
     }
   }
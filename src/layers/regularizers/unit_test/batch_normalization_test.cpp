@@ -30,7 +30,9 @@
 #include "TestHelpers.hpp"
 
 #include <lbann/base.hpp>
+#include <lbann/layers/activations/relu.hpp>
 #include <lbann/layers/regularizers/batch_normalization.hpp>
+#include <lbann/layers/transform/sum.hpp>
 
 #include <h2/patterns/multimethods/SwitchDispatcher.hpp>
 #include <lbann/utils/memory.hpp>
@@ -60,6 +62,16 @@ using AllLayerTypes = h2::meta::tlist::Append<
 #endif // LBANN_HAS_DOUBLE
   LayerTypesAllDevices<float>>;
 
+template <typename LayerT>
+struct LayerTraits;
+
+template <typename T, lbann::data_layout L, El::Device D>
+struct LayerTraits<LayerType<T, L, D>>
+{
+  template <template <typename, lbann::data_layout, El::Device> class OtherT>
+  using rebind = OtherT<T, L, D>;
+};
+
 using unit_test::utilities::IsValidPtr;
 TEMPLATE_LIST_TEST_CASE("Serializing batchnorm layer",
                         "[mpi][layer][serialize]",
@@ -149,3 +161,55 @@ TEMPLATE_LIST_TEST_CASE("Serializing batchnorm layer",
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
 }
+
+TEMPLATE_LIST_TEST_CASE("Fusing batchnorm layer",
+                        "[mpi][layer][fusion]",
+                        AllLayerTypes)
+{
+  using LayerType = TestType;
+  using ReLUType =
+    typename LayerTraits<LayerType>::template rebind<lbann::relu_layer>;
+  using SumType =
+    typename LayerTraits<LayerType>::template rebind<lbann::sum_layer>;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+
+  LayerType layer(0.9, 1e-5, 1);
+  ReLUType relu(&world_comm);
+  SumType sum(&world_comm);
+
+  SECTION("ReLU child is fused once")
+  {
+    REQUIRE(layer.fuse_child(relu));
+    CHECK_FALSE(layer.fuse_child(relu));
+    CHECK(layer.get_backprop_requirements() & lbann::ACTIVATIONS);
+  }
+  SECTION("Sum without a residual input is not fused")
+  {
+    CHECK_FALSE(layer.fuse_child(sum));
+  }
+  SECTION("Fused ReLU survives copies")
+  {
+    REQUIRE(layer.fuse_child(relu));
+    LayerType copy(layer);
+    CHECK_FALSE(copy.fuse_child(relu));
+  }
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  SECTION("Fused ReLU is serialized")
+  {
+    REQUIRE(layer.fuse_child(relu));
+    LayerType tgt_layer(0.5, 1e-3, 1);
+    std::stringstream ss;
+    {
+      cereal::BinaryOutputArchive oarchive(ss);
+      REQUIRE_NOTHROW(oarchive(layer));
+    }
+    {
+      cereal::BinaryInputArchive iarchive(ss);
+      REQUIRE_NOTHROW(iarchive(tgt_layer));
+    }
+    CHECK_FALSE(tgt_layer.fuse_child(relu));
+    CHECK(tgt_layer.get_backprop_requirements() & lbann::ACTIVATIONS);
+  }
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+}
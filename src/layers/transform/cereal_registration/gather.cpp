@@ -35,7 +35,8 @@ void gather_layer<TensorDataType, Layout, Device>::serialize(ArchiveT& ar)
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
-     CEREAL_NVP(m_gather_axis));
+     CEREAL_NVP(m_gather_axis),
+     CEREAL_NVP(m_deterministic));
 }
 
 } // namespace lbann
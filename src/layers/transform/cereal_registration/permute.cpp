@@ -74,7 +74,8 @@ void PermuteLayer<T>::serialize(ArchiveT& ar)
   using DataTypeLayer = data_type_layer<T>;
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
-     CEREAL_NVP(m_impl));
+     CEREAL_NVP(m_impl),
+     CEREAL_NVP(m_fused_scale));
 }
 
 } // namespace lbann
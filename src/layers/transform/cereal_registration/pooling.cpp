@@ -39,7 +39,9 @@ void pooling_layer<TensorDataType, Layout, Device>::serialize(ArchiveT& ar)
      CEREAL_NVP(m_pool_dims),
      CEREAL_NVP(m_pool_size),
      CEREAL_NVP(m_pads),
-     CEREAL_NVP(m_strides));
+     CEREAL_NVP(m_strides),
+     CEREAL_NVP(m_channels_last),
+     CEREAL_NVP(m_compact_indices));
   // Members that aren't serialized
   //     m_max_pool_indices;
 }
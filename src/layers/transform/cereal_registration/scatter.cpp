@@ -35,7 +35,8 @@ void scatter_layer<TensorDataType, Layout, Device>::serialize(ArchiveT& ar)
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
-     CEREAL_NVP(m_scatter_axis));
+     CEREAL_NVP(m_scatter_axis),
+     CEREAL_NVP(m_deterministic));
 }
 
 } // namespace lbann
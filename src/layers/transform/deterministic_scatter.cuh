@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SRC_LAYERS_TRANSFORM_DETERMINISTIC_SCATTER_CUH_INCLUDED
+#define LBANN_SRC_LAYERS_TRANSFORM_DETERMINISTIC_SCATTER_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+#include <thrust/sort.h>
+
+namespace lbann {
+namespace deterministic_scatter {
+
+using Dim2 = gpu_lib::array<size_t, 2>;
+using Dim3 = gpu_lib::array<size_t, 3>;
+
+/** @brief Compute sort keys for scatter indices
+ *
+ *  Index j of mini-batch sample k gets the key
+ *  k*bounds + indices(k,j), or mini_batch_size*bounds if the index
+ *  is out of range. The position of the index, k*num_indices + j, is
+ *  stored alongside.
+ */
+template <typename T>
+__global__ void make_keys_kernel(const T* __restrict__ indices,
+                                 Dim2 indices_strides,
+                                 size_t mini_batch_size,
+                                 size_t num_indices,
+                                 size_t bounds,
+                                 El::Int* __restrict__ keys,
+                                 El::Int* __restrict__ positions)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = gridDim.x * blockDim.x;
+  const size_t size = mini_batch_size * num_indices;
+  const El::Int invalid_key = mini_batch_size * bounds;
+  for (size_t pos = gid; pos < size; pos += nthreads) {
+    const size_t batch = pos / num_indices;
+    const size_t j = pos % num_indices;
+    const auto ind = static_cast<El::Int>(gpu_lib::floor(
+      indices[batch * indices_strides[0] + j * indices_strides[1]]));
+    const bool valid = 0 <= ind && ind < static_cast<El::Int>(bounds);
+    keys[pos] = valid ? batch * bounds + ind : invalid_key;
+    positions[pos] = pos;
+  }
+}
+
+/** @brief Sum values that share a sort key
+ *
+ *  Each run of equal keys is reduced by the thread that owns its
+ *  first entry, in order of increasing index position, and the sum
+ *  is written to the output without atomics.
+ *
+ *  Block dimensions: bdimx x bdimy x 1
+ *
+ *  Grid dimensions: (num_features / bdimx) x (num_keys / bdimy) x 1
+ */
+template <typename T, bool has_row_vectors>
+__global__ void segmented_sum_kernel(size_t num_keys,
+                                     const El::Int* __restrict__ keys,
+                                     const El::Int* __restrict__ positions,
+                                     size_t num_indices,
+                                     size_t num_features,
+                                     size_t bounds,
+                                     El::Int invalid_key,
+                                     const T* __restrict__ values,
+                                     Dim3 values_strides,
+                                     T* __restrict__ output,
+                                     Dim3 output_strides)
+{
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = gridDim.x * blockDim.x;
+  const size_t nthreadsy = gridDim.y * blockDim.y;
+
+  for (size_t start = gidy; start < num_keys; start += nthreadsy) {
+    const auto key = keys[start];
+    if (key >= invalid_key || (start > 0 && keys[start - 1] == key)) {
+      continue;
+    }
+    const size_t batch = key / bounds;
+    const size_t ind = key % bounds;
+    for (size_t f = gidx; f < num_features; f += nthreadsx) {
+      T sum = T{0.f};
+      for (size_t i = start; i < num_keys && keys[i] == key; ++i) {
+        const size_t j = positions[i] % num_indices;
+        const auto values_offset =
+          has_row_vectors ? j * values_strides[1] + f * values_strides[2]
+                          : f * values_strides[1] + j * values_strides[2];
+        sum += values[batch * values_strides[0] + values_offset];
+      }
+      const auto output_offset =
+        has_row_vectors ? ind * output_strides[1] + f * output_strides[2]
+                        : f * output_strides[1] + ind * output_strides[2];
+      output[batch * output_strides[0] + output_offset] = sum;
+    }
+  }
+}
+
+/** @brief Deterministic replacement for an atomic 3D scatter-add
+ *
+ *  Computes the same result as scatter3d_kernel in scatter.cu and
+ *  gather.cu:
+ *
+ *  output(k,indices(k,j),i) += values(k,j,i) if has_row_vectors
+ *  output(k,j,indices(k,i)) += values(k,j,i) otherwise
+ *
+ *  Index positions are sorted by (sample, index) and each run of
+ *  duplicate indices is summed by a single thread in a fixed order,
+ *  so results are bitwise reproducible. This is also faster than
+ *  atomics when indices collide heavily.
+ *
+ *  The output must be zeroed beforehand. Entries that receive no
+ *  values are not written.
+ */
+template <typename T, bool has_row_vectors>
+void scatter3d(const T* indices,
+               Dim2 indices_strides,
+               const T* values,
+               Dim3 values_dims,
+               Dim3 values_strides,
+               T* output,
+               Dim3 output_dims,
+               Dim3 output_strides,
+               const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  const size_t mini_batch_size = output_dims[0];
+  const size_t num_indices = has_row_vectors ? values_dims[1] : values_dims[2];
+  const size_t num_features =
+    has_row_vectors ? values_dims[2] : values_dims[1];
+  const size_t bounds = has_row_vectors ? output_dims[1] : output_dims[2];
+  const size_t num_keys = mini_batch_size * num_indices;
+  if (num_keys == 0 || num_features == 0) {
+    return;
+  }
+
+  // Sort index positions by (sample, index)
+  gpu_lib::thrust::allocator<> alloc(sync_info.Stream());
+  gpu_lib::thrust::vector<El::Int> keys(num_keys);
+  gpu_lib::thrust::vector<El::Int> positions(num_keys);
+  {
+    constexpr size_t block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.x = (num_keys + block_size - 1) / block_size;
+    gpu_lib::clip_grid_dims(grid_dims);
+    hydrogen::gpu::LaunchKernel(make_keys_kernel<T>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                indices,
+                                indices_strides,
+                                mini_batch_size,
+                                num_indices,
+                                bounds,
+                                keys.data().get(),
+                                positions.data().get());
+  }
+  ::thrust::stable_sort_by_key(alloc.system(),
+                               keys.begin(),
+                               keys.end(),
+                               positions.begin());
+
+  // Reduce runs of duplicate indices
+  {
+    dim3 block_dims, grid_dims;
+    block_dims.x = num_features >= 32 ? 32 : 1;
+    block_dims.y = 256 / block_dims.x;
+    grid_dims.x = (num_features + block_dims.x - 1) / block_dims.x;
+    grid_dims.y = (num_keys + block_dims.y - 1) / block_dims.y;
+    gpu_lib::clip_grid_dims(grid_dims);
+    hydrogen::gpu::LaunchKernel(segmented_sum_kernel<T, has_row_vectors>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                num_keys,
+                                keys.data().get(),
+                                positions.data().get(),
+                                num_indices,
+                                num_features,
+                                bounds,
+                                static_cast<El::Int>(mini_batch_size * bounds),
+                                values,
+                                values_strides,
+                                output,
+                                output_strides);
+  }
+}
+
+} // namespace deterministic_scatter
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_LAYERS_TRANSFORM_DETERMINISTIC_SCATTER_CUH_INCLUDED
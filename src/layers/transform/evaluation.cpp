@@ -41,25 +41,50 @@ namespace lbann {
 
 namespace {
 
-/** CPU implementation of evaluation layer forward prop. */
-template <typename TensorDataType, typename EvalDataType>
-void fp_cpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<TensorDataType>& input,
-            EvalDataType& value,
-            Al::request& req)
+/** Sum of the entries in the local input matrix. */
+template <typename EvalDataType, typename TensorDataType>
+EvalDataType local_sum_cpu(const El::AbstractDistMatrix<TensorDataType>& input)
 {
   const auto& local_input = input.LockedMatrix();
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
-  const auto& mini_batch_size = input.Width();
-  value = El::TypeTraits<EvalDataType>::Zero();
-  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+ : value) collapse(2))
+  EvalDataType sum = El::TypeTraits<EvalDataType>::Zero();
+  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+ : sum) collapse(2))
   for (El::Int col = 0; col < local_width; ++col) {
     for (El::Int row = 0; row < local_height; ++row) {
-      value += local_input(row, col);
+      sum += local_input(row, col);
     }
   }
-  value = value / mini_batch_size;
+  return sum;
+}
+
+#ifdef LBANN_HAS_HALF
+template <typename EvalDataType>
+EvalDataType local_sum_cpu(const El::AbstractDistMatrix<cpu_fp16>& input)
+{
+  LBANN_ERROR("This function is not supported in FP16 on CPUs");
+  return El::TypeTraits<EvalDataType>::Zero();
+}
+#endif // LBANN_HAS_HALF
+
+#ifdef LBANN_HAS_GPU_FP16
+template <typename EvalDataType>
+EvalDataType local_sum_cpu(const El::AbstractDistMatrix<fp16>& input)
+{
+  LBANN_ERROR("This function is not supported in FP16 on CPUs");
+  return El::TypeTraits<EvalDataType>::Zero();
+}
+#endif // LBANN_HAS_GPU_HALF
+
+/** CPU implementation of evaluation layer forward prop. */
+template <typename TensorDataType, typename EvalDataType>
+void fp_cpu(lbann_comm& comm,
+            const El::AbstractDistMatrix<TensorDataType>& input,
+            EvalDataType& value,
+            Al::request& req)
+{
+  const auto& mini_batch_size = input.Width();
+  value = local_sum_cpu<EvalDataType>(input) / mini_batch_size;
   comm.nb_allreduce(&value, 1, input.DistComm(), req);
 }
 
@@ -86,12 +111,13 @@ void fp_cpu(lbann_comm& comm,
 #endif // LBANN_HAS_GPU_HALF
 
 #ifdef LBANN_HAS_GPU
-/** GPU implementation of evaluation layer forward prop. */
+/** Sum the entries in the local input matrix into a 1x1 GPU matrix.
+ *
+ *  The sum is computed on the stream of @c sum_d.
+ */
 template <typename TensorDataType, typename EvalDataType>
-void fp_gpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<TensorDataType>& input,
-            EvalDataType& value,
-            gpu_lib::event_wrapper& copy_event)
+void local_sum_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
+                   El::Matrix<EvalDataType, El::Device::GPU>& sum_d)
 {
   const EvalDataType zero = El::TypeTraits<EvalDataType>::Zero();
   const EvalDataType one = El::TypeTraits<EvalDataType>::One();
@@ -102,12 +128,10 @@ void fp_gpu(lbann_comm& comm,
     ViewIfPossibleOrCopy<TensorDataType, EvalDataType>::get(local_tdf_input);
   const auto& local_height = local_input->Height();
   const auto& local_width = local_input->Width();
-  const auto& mini_batch_size = input.Width();
 
   // GPU objects
-  El::Matrix<EvalDataType, El::Device::GPU> sum_d, ones_d;
+  El::Matrix<EvalDataType, El::Device::GPU> ones_d;
 #ifdef HYDROGEN_HAVE_CUB
-  sum_d.SetMemoryMode(1);  // Use CUB GPU memory pool
   ones_d.SetMemoryMode(1); // Use CUB GPU memory pool
 #endif                     // HYDROGEN_HAVE_CUB
   sum_d.Resize(1, 1);
@@ -172,6 +196,35 @@ void fp_gpu(lbann_comm& comm,
   }
   // Restore the host pointer mode
   hydrogen::gpu_blas::SetPointerMode(hydrogen::PointerMode::HOST);
+}
+
+#ifdef LBANN_HAS_GPU_FP16
+template <typename EvalDataType>
+void local_sum_gpu(const El::AbstractDistMatrix<cpu_fp16>& input,
+                   El::Matrix<EvalDataType, El::Device::GPU>& sum_d)
+{
+  LBANN_ERROR("This function is not supported with "
+              "the CPU FP16 type on GPUs.");
+}
+#endif // LBANN_HAS_GPU_HALF
+
+/** GPU implementation of evaluation layer forward prop. */
+template <typename TensorDataType, typename EvalDataType>
+void fp_gpu(lbann_comm& comm,
+            const El::AbstractDistMatrix<TensorDataType>& input,
+            EvalDataType& value,
+            gpu_lib::event_wrapper& copy_event)
+{
+  const EvalDataType one = El::TypeTraits<EvalDataType>::One();
+  const auto& mini_batch_size = input.Width();
+
+  // Compute sum of local input matrix entries
+  El::Matrix<EvalDataType, El::Device::GPU> sum_d;
+#ifdef HYDROGEN_HAVE_CUB
+  sum_d.SetMemoryMode(1); // Use CUB GPU memory pool
+#endif                    // HYDROGEN_HAVE_CUB
+  local_sum_gpu(input, sum_d);
+  auto const& sync_info = gpu::get_sync_info(sum_d);
 
   // Compute average value across mini-batch
   El::Scale(one / El::To<EvalDataType>(mini_batch_size), sum_d);
@@ -210,6 +263,10 @@ void evaluation_layer<T, L, D>::write_specific_proto(
 template <typename TensorDataType>
 EvalType abstract_evaluation_layer<TensorDataType>::get_value(bool scaled)
 {
+  if (m_window > 1) {
+    finish_readback(false);
+    return scaled ? m_scale * m_last_window_mean : m_last_window_mean;
+  }
   switch (this->get_device_allocation()) {
   case El::Device::CPU:
     this->get_comm()->wait(m_allreduce_req);
@@ -230,6 +287,154 @@ EvalType abstract_evaluation_layer<TensorDataType>::get_value(bool scaled)
   }
 }
 
+template <typename TensorDataType>
+void abstract_evaluation_layer<TensorDataType>::set_accumulation_window(
+  size_t steps)
+{
+  steps = std::max(steps, size_t{1});
+  if (steps == m_window) {
+    return;
+  }
+  // The per-step path reuses the read-back buffer, so drain it first.
+  close_window();
+  finish_readback(true);
+  m_window = steps;
+}
+
+template <typename TensorDataType>
+std::pair<EvalType, El::Int>
+abstract_evaluation_layer<TensorDataType>::take_accumulated_value(
+  execution_mode mode,
+  bool wait)
+{
+  if (wait) {
+    close_window();
+  }
+  finish_readback(wait);
+  auto it = m_accumulated.find(mode);
+  if (it == m_accumulated.end()) {
+    return {EvalType(0), 0};
+  }
+  const auto total = it->second;
+  m_accumulated.erase(it);
+  return total;
+}
+
+template <typename TensorDataType>
+void abstract_evaluation_layer<TensorDataType>::fp_compute_windowed()
+{
+  // Windows never span execution modes.
+  const auto mode =
+    this->m_model->get_execution_context().get_execution_mode();
+  if (m_window_steps > 0 && mode != m_window_mode) {
+    close_window();
+  }
+  m_window_mode = mode;
+
+  const auto& input = this->get_prev_activations();
+  switch (this->get_device_allocation()) {
+  case El::Device::CPU:
+    m_window_sum += local_sum_cpu<EvalType>(input);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    El::Matrix<EvalType, El::Device::GPU> sum_d;
+    El::SetSyncInfo(sum_d, gpu::get_sync_info(m_window_sum_d));
+#ifdef HYDROGEN_HAVE_CUB
+    sum_d.SetMemoryMode(1); // Use CUB GPU memory pool
+#endif                      // HYDROGEN_HAVE_CUB
+    local_sum_gpu(input, sum_d);
+    El::Axpy(EvalType(1), sum_d, m_window_sum_d);
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+  m_window_samples += input.Width();
+  if (++m_window_steps >= m_window) {
+    close_window();
+  }
+}
+
+template <typename TensorDataType>
+void abstract_evaluation_layer<TensorDataType>::close_window()
+{
+  if (m_window_steps == 0) {
+    return;
+  }
+  // The previous window was issued a window ago, so this rarely blocks.
+  finish_readback(true);
+
+  auto& comm = *this->get_comm();
+  const auto& input = this->get_prev_activations();
+  switch (this->get_device_allocation()) {
+  case El::Device::CPU:
+    m_readback(0, 0) = m_window_sum;
+    m_window_sum = EvalType(0);
+    comm.nb_allreduce(m_readback.Buffer(),
+                      1,
+                      input.DistComm(),
+                      m_allreduce_req);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    auto const& sync_info = gpu::get_sync_info(m_window_sum_d);
+    comm.allreduce(static_cast<El::AbstractMatrix<EvalType>&>(m_window_sum_d),
+                   input.DistComm());
+    hydrogen::gpu::Copy1DToHost(m_window_sum_d.LockedBuffer(),
+                                m_readback.Buffer(),
+                                1,
+                                sync_info);
+    m_copy_event.record(sync_info.Stream());
+    El::Zero(m_window_sum_d);
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+  m_readback_pending = true;
+  m_readback_mode = m_window_mode;
+  m_readback_samples = m_window_samples;
+  m_window_steps = 0;
+  m_window_samples = 0;
+}
+
+template <typename TensorDataType>
+void abstract_evaluation_layer<TensorDataType>::finish_readback(bool wait)
+{
+  if (!m_readback_pending) {
+    return;
+  }
+  switch (this->get_device_allocation()) {
+  case El::Device::CPU:
+    if (!wait && !this->get_comm()->test(m_allreduce_req)) {
+      return;
+    }
+    this->get_comm()->wait(m_allreduce_req);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    if (!wait && !m_copy_event.query()) {
+      return;
+    }
+    m_copy_event.synchronize();
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+  const EvalType sum = m_readback(0, 0);
+  auto& total = m_accumulated[m_readback_mode];
+  total.first += sum;
+  total.second += m_readback_samples;
+  if (m_readback_samples > 0) {
+    m_last_window_mean = sum / m_readback_samples;
+  }
+  m_readback_pending = false;
+}
+
 template <typename TensorDataType>
 abstract_evaluation_layer<TensorDataType>::abstract_evaluation_layer(
   lbann_comm* comm)
@@ -263,14 +468,23 @@ void abstract_evaluation_layer<TensorDataType>::setup_data(
 {
   data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
 #ifdef LBANN_HAS_GPU
-  m_value.SetMemoryMode(1); // Use pinned memory on host
-#endif                      // LBANN_HAS_GPU
+  m_value.SetMemoryMode(1);    // Use pinned memory on host
+  m_readback.SetMemoryMode(1); // Use pinned memory on host
+  if (this->get_device_allocation() == El::Device::GPU) {
+    El::Zeros(m_window_sum_d, 1, 1);
+  }
+#endif // LBANN_HAS_GPU
   El::Zeros(m_value, 1, 1);
+  El::Zeros(m_readback, 1, 1);
 }
 
 template <typename TensorDataType>
 void abstract_evaluation_layer<TensorDataType>::fp_compute()
 {
+  if (m_window > 1) {
+    fp_compute_windowed();
+    return;
+  }
   switch (this->get_device_allocation()) {
   case El::Device::CPU:
     this->get_comm()->wait(m_allreduce_req);
@@ -28,6 +28,8 @@
 #include "lbann/layers/transform/gather.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "deterministic_scatter.cuh"
+
 #if defined(LBANN_HAS_DISTCONV) && defined(LBANN_HAS_NVSHMEM)
 #include "lbann/utils/nvshmem.hpp"
 #endif
@@ -318,6 +320,42 @@ void gather_layer<TensorDataType, Layout, Device>::bp_compute()
     auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_values_grad),
                                        gpu::get_sync_info(local_output_grad),
                                        gpu::get_sync_info(local_indices));
+    if (m_deterministic) {
+      if (has_row_vectors) {
+        deterministic_scatter::scatter3d<TensorDataType, true>(
+          local_indices.LockedBuffer(),
+          Dim2{static_cast<size_t>(local_indices.LDim()), 1},
+          local_output_grad.LockedBuffer(),
+          Dim3{local_mini_batch_size, num_output_rows, output_size},
+          Dim3{static_cast<size_t>(local_output_grad.LDim()),
+               output_stride_2,
+               1},
+          local_values_grad.Buffer(),
+          Dim3{local_mini_batch_size, num_rows, values_size},
+          Dim3{static_cast<size_t>(local_values_grad.LDim()),
+               value_stride_2,
+               1},
+          multisync);
+      }
+      else {
+        deterministic_scatter::scatter3d<TensorDataType, false>(
+          local_indices.LockedBuffer(),
+          Dim2{static_cast<size_t>(local_indices.LDim()), 1},
+          local_output_grad.LockedBuffer(),
+          Dim3{local_mini_batch_size, num_output_rows, output_size},
+          Dim3{static_cast<size_t>(local_output_grad.LDim()),
+               output_stride_2,
+               1},
+          local_values_grad.Buffer(),
+          Dim3{local_mini_batch_size, num_rows, values_size},
+          Dim3{static_cast<size_t>(local_values_grad.LDim()),
+               value_stride_2,
+               1},
+          multisync);
+      }
+      return;
+    }
+
     constexpr size_t block_size_x = 32;
     constexpr size_t block_size_y = 8;
 
@@ -34,6 +34,7 @@
 
 #ifdef LBANN_HAS_CUTENSOR
 #include "lbann/utils/cutensor_support.hpp"
+#include "lbann/utils/gpu_workspace.hpp"
 #endif
 
 namespace lbann {
@@ -187,9 +188,6 @@ void multidim_reduction_layer<TensorDataType, Layout, Device>::fp_compute()
     auto input_desc = get_descriptor(input, input_dims);
     auto output_desc = get_descriptor(output, output_dims);
 
-    // Create workspace buffers
-    LocalMat workspace;
-    workspace.SetMemoryMode(1);
     auto handle = get_handle_ptr();
     uint64_t wspsize = 0;
     CHECK_CUTENSOR(
@@ -206,10 +204,11 @@ void multidim_reduction_layer<TensorDataType, Layout, Device>::fp_compute()
                                         cutensor_reduce_op,
                                         CUDATypeT<TensorDataType>::compute_type,
                                         &wspsize));
-    workspace.Resize(wspsize, 1);
-
     auto multisync = El::MakeMultiSync(El::SyncInfoFromMatrix(output),
                                        El::SyncInfoFromMatrix(input));
+    const auto sync_info =
+      static_cast<El::SyncInfo<El::Device::GPU>>(multisync);
+    void* workspace = gpu::get_workspace(wspsize, sync_info);
 
     // Compute reduction locally
     CHECK_CUTENSOR(cutensorReduction(
@@ -227,9 +226,9 @@ void multidim_reduction_layer<TensorDataType, Layout, Device>::fp_compute()
       output_modes.data(),
       cutensor_reduce_op,
       CUDATypeT<TensorDataType>::compute_type,
-      workspace.Buffer(),
+      workspace,
       wspsize,
-      static_cast<El::SyncInfo<El::Device::GPU>>(multisync).Stream()));
+      sync_info.Stream()));
   }
 #endif
 }
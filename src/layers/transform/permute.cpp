@@ -30,6 +30,8 @@
 
 #include "permute/permuteimpl.hpp"
 
+#include "lbann/layers/operator_layer.hpp"
+#include "lbann/operators/math/binary_with_constant.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/utils/description.hpp"
 #include "lbann/utils/protobuf.hpp"
@@ -63,21 +65,35 @@ PermuteLayer<T>::PermuteImpl::setup_dims(std::vector<int> const& input_dims)
 
 template <typename T>
 void PermuteLayer<T>::PermuteImpl::forward_prop(MatType const& input,
-                                                MatType& output) const
+                                                MatType& output,
+                                                double scale) const
 {
   if (input.Width() == El::Int{0} || output.Width() == El::Int{0})
     return;
+#ifdef LBANN_HAS_CUTENSOR
+  m_device_impl.permute(input, output, El::To<CUDAScalar<T>>(scale));
+#else
+  LBANN_ASSERT_DEBUG(scale == 1.0);
   m_device_impl.permute(input, output);
+#endif
 }
 
 // Activations don't actually matter here...
 template <typename T>
 void PermuteLayer<T>::PermuteImpl::backward_prop(MatType const& grad_wrt_out,
-                                                 MatType& grad_wrt_in)
+                                                 MatType& grad_wrt_in,
+                                                 double scale)
 {
   if (grad_wrt_out.Width() == El::Int{0} || grad_wrt_in.Width() == El::Int{0})
     return;
+#ifdef LBANN_HAS_CUTENSOR
+  m_device_impl.inverse_permute(grad_wrt_out,
+                                grad_wrt_in,
+                                El::To<CUDAScalar<T>>(scale));
+#else
+  LBANN_ASSERT_DEBUG(scale == 1.0);
   m_device_impl.inverse_permute(grad_wrt_out, grad_wrt_in);
+#endif
 }
 
 template <typename T>
@@ -117,7 +133,8 @@ PermuteLayer<T>::PermuteLayer(std::vector<int> const& axes_rm)
 template <typename T>
 PermuteLayer<T>::PermuteLayer(PermuteLayer const& other)
   : data_type_layer<T>{other},
-    m_impl{std::make_unique<PermuteImpl>(*other.m_impl)}
+    m_impl{std::make_unique<PermuteImpl>(*other.m_impl)},
+    m_fused_scale{other.m_fused_scale}
 {
   this->m_expected_num_parent_layers = 1;
 }
@@ -163,6 +180,7 @@ template <typename T>
 void PermuteLayer<T>::swap(PermuteLayer& other)
 {
   std::swap(m_impl, other.m_impl);
+  std::swap(m_fused_scale, other.m_fused_scale);
 }
 
 template <typename T>
@@ -170,9 +188,37 @@ description PermuteLayer<T>::get_description() const
 {
   auto desc = data_type_layer<T>::get_description();
   desc.add("perm", m_impl->describe_perm());
+  if (m_fused_scale != 1.0) {
+    desc.add("Fused scale", m_fused_scale);
+  }
   return desc;
 }
 
+template <typename T>
+bool PermuteLayer<T>::fuse_child(Layer const& child)
+{
+  // A scale operator (e.g. the 1/sqrt(d) of attention scores) becomes
+  // the alpha of the permutation
+  using ChildType =
+    OperatorLayer<T, T, data_layout::DATA_PARALLEL, El::Device::GPU>;
+  using ScaleType = ScaleOperator<T, El::Device::GPU>;
+  if (!PermuteImpl::supports_scale()) {
+    return false;
+  }
+  auto const* other = dynamic_cast<ChildType const*>(&child);
+  if (other == nullptr || child.get_num_parents() != 1 ||
+      other->get_operators().size() != 1UL) {
+    return false;
+  }
+  auto const* scale =
+    dynamic_cast<ScaleType const*>(other->get_operators().front().get());
+  if (scale == nullptr) {
+    return false;
+  }
+  m_fused_scale *= static_cast<double>(scale->get_constant());
+  return true;
+}
+
 template <typename T>
 void PermuteLayer<T>::setup_dims()
 {
@@ -193,7 +239,8 @@ void PermuteLayer<T>::fp_compute()
 
   if (input.Width()) {
     m_impl->forward_prop(static_cast<MatType const&>(input),
-                         static_cast<MatType&>(output));
+                         static_cast<MatType&>(output),
+                         m_fused_scale);
   }
 }
 
@@ -210,7 +257,8 @@ void PermuteLayer<T>::bp_compute()
 
   if (grad_wrt_output.Width()) {
     m_impl->backward_prop(static_cast<MatType const&>(grad_wrt_output),
-                          static_cast<MatType&>(grad_wrt_input));
+                          static_cast<MatType&>(grad_wrt_input),
+                          m_fused_scale);
   }
 }
 
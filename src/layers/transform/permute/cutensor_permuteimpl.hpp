@@ -92,7 +92,8 @@ public:
    *  Applies the permutation to the tensor represented by "in". In
    *  line with the rest of LBANN, the permutation is applied to each
    *  column, which is treated as a packed tensor with the dimensions
-   *  stored in this object.
+   *  stored in this object. The result is scaled by @c alpha, which
+   *  lets a following scale operation run as part of the permutation.
    *
    *  @note (trb) I think this can be extended to support data type
    *  conversions during permutation, but I haven't tested this and
@@ -100,18 +101,22 @@ public:
    */
   template <typename DataT>
   void permute(El::Matrix<DataT, El::Device::GPU> const& in,
-               El::Matrix<DataT, El::Device::GPU>& out) const;
+               El::Matrix<DataT, El::Device::GPU>& out,
+               CUDAScalar<DataT> alpha = El::To<CUDAScalar<DataT>>(1.f)) const;
 
   /** @brief Apply the inverse permutation to the tensor.
    *
    *  Applies the inverse permutation to the tensor represented by
    *  "in". In line with the rest of LBANN, the permutation is applied
    *  to each column, which is treated as a packed tensor with the
-   *  dimensions stored in this object.
+   *  dimensions stored in this object. The result is scaled by @c
+   *  alpha.
    */
   template <typename DataT>
-  void inverse_permute(El::Matrix<DataT, El::Device::GPU> const& in,
-                       El::Matrix<DataT, El::Device::GPU>& out) const;
+  void inverse_permute(
+    El::Matrix<DataT, El::Device::GPU> const& in,
+    El::Matrix<DataT, El::Device::GPU>& out,
+    CUDAScalar<DataT> alpha = El::To<CUDAScalar<DataT>>(1.f)) const;
 
   ///@}
   /** @name Modifiers */
@@ -182,19 +187,19 @@ inline void cuTENSOR_PermuteImpl::set_dims(DimsType input_dims)
 template <typename DataT>
 void cuTENSOR_PermuteImpl::permute(
   El::Matrix<DataT, El::Device::GPU> const& in,
-  El::Matrix<DataT, El::Device::GPU>& out) const
+  El::Matrix<DataT, El::Device::GPU>& out,
+  CUDAScalar<DataT> alpha) const
 {
   auto const in_desc = get_descriptor(in, m_input_dims);
   auto const out_desc = get_descriptor(out, m_output_dims);
 
-  auto const one = El::To<CUDAScalar<DataT>>(1.f);
   auto multisync =
     El::MakeMultiSync(El::SyncInfoFromMatrix(out), El::SyncInfoFromMatrix(in));
 
   // This permutation is input_modes -> output_modes.
   CHECK_CUTENSOR(cutensorPermutation(
     get_handle_ptr(),
-    &one,
+    &alpha,
     in.LockedBuffer(),
     &in_desc,
     m_input_modes.data(),
@@ -208,7 +213,8 @@ void cuTENSOR_PermuteImpl::permute(
 template <typename DataT>
 void cuTENSOR_PermuteImpl::inverse_permute(
   El::Matrix<DataT, El::Device::GPU> const& in,
-  El::Matrix<DataT, El::Device::GPU>& out) const
+  El::Matrix<DataT, El::Device::GPU>& out,
+  CUDAScalar<DataT> alpha) const
 {
   // This permutation is output_modes -> input_modes. Use some aliases
   // to help.
@@ -222,13 +228,12 @@ void cuTENSOR_PermuteImpl::inverse_permute(
   auto const in_desc = get_descriptor(in, in_dims);
   auto const out_desc = get_descriptor(out, out_dims);
 
-  auto const one = El::To<CUDAScalar<DataT>>(1.f);
   auto multisync =
     El::MakeMultiSync(El::SyncInfoFromMatrix(out), El::SyncInfoFromMatrix(in));
 
   CHECK_CUTENSOR(cutensorPermutation(
     get_handle_ptr(),
-    &one,
+    &alpha,
     in.LockedBuffer(),
     &in_desc,
     in_modes.data(),
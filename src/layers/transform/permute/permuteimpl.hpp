@@ -63,10 +63,24 @@ public:
   // Returns the row-major output dims.
   std::vector<int> setup_dims(std::vector<int> const& input_dims);
 
-  void forward_prop(MatType const& prev_acts, MatType& acts) const;
+  // Both directions scale their result by "scale", which only the
+  // cuTENSOR backend supports (see supports_scale).
+  void
+  forward_prop(MatType const& prev_acts, MatType& acts, double scale) const;
 
   // Activations don't actually matter here...
-  void backward_prop(MatType const& grad_wrt_out, MatType& grad_wrt_in);
+  void backward_prop(MatType const& grad_wrt_out,
+                     MatType& grad_wrt_in,
+                     double scale);
+
+  static constexpr bool supports_scale() noexcept
+  {
+#ifdef LBANN_HAS_CUTENSOR
+    return true;
+#else
+    return false;
+#endif
+  }
 
   std::vector<int> get_perm() const;
   std::string describe_perm() const;
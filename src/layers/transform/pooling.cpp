@@ -61,11 +61,15 @@ template <typename TensorDataType, El::Device Device>
 struct Builder<TensorDataType, data_layout::DATA_PARALLEL, Device>
 {
   template <typename... Args>
-  static std::unique_ptr<Layer> Build(Args&&... args)
+  static std::unique_ptr<Layer>
+  Build(bool channels_last, bool compact_indices, Args&&... args)
   {
     using LayerType =
       pooling_layer<TensorDataType, data_layout::DATA_PARALLEL, Device>;
-    return std::make_unique<LayerType>(std::forward<Args>(args)...);
+    auto layer = std::make_unique<LayerType>(std::forward<Args>(args)...);
+    layer->set_channels_last(channels_last);
+    layer->set_compact_indices(compact_indices);
+    return layer;
   }
 };
 } // namespace
@@ -82,7 +86,12 @@ void pooling_layer<TensorDataType, Layout, Device>::fp_compute()
       return;
     }
 #endif // LBANN_HAS_DISTCONV
-    fp_compute_dnn();
+    if (m_compact_indices) {
+      fp_compute_compact();
+    }
+    else {
+      fp_compute_dnn();
+    }
   }
   else {
     fp_compute_im2col();
@@ -99,7 +108,12 @@ void pooling_layer<TensorDataType, Layout, Device>::bp_compute()
       return;
     }
 #endif // LBANN_HAS_DISTCONV
-    bp_compute_dnn();
+    if (m_compact_indices) {
+      bp_compute_compact();
+    }
+    else {
+      bp_compute_dnn();
+    }
   }
   else {
     bp_compute_im2col();
@@ -196,7 +210,13 @@ void pooling_layer<TensorDataType, Layout, Dev>::fp_compute_im2col()
   // Initialize max pool indices if needed
   if (m_pool_mode == pooling_mode::MAX ||
       m_pool_mode == pooling_mode::MAX_DETERMINISTIC) {
-    m_max_pool_indices.assign(this->get_output_size() * local_width, 0);
+    dispatch_max_pool_index_type(m_pool_size, [&](auto index) {
+      const size_t index_bytes =
+        sizeof(index) * this->get_output_size() * local_width;
+      m_max_pool_indices.Resize(
+        (index_bytes + sizeof(TensorDataType) - 1) / sizeof(TensorDataType),
+        1);
+    });
   }
 
   // Initialize matrices
@@ -222,27 +242,31 @@ void pooling_layer<TensorDataType, Layout, Dev>::fp_compute_im2col()
         m_pool_mode == pooling_mode::MAX_DETERMINISTIC) {
       // Apply max pooling
       TensorDataType* output_buffer = local_output.Buffer(0, sample);
-      int* indices_buffer =
-        &m_max_pool_indices[sample * this->get_output_size()];
-      LBANN_OMP_PARALLEL_FOR
-      for (int channel = 0; channel < num_channels; ++channel) {
-        for (int j = 0; j < num_per_output_channel; ++j) {
-          TensorDataType* im2col_buffer =
-            im2col_mat.Buffer(channel * m_pool_size, j);
-          TensorDataType max_entry = im2col_buffer[0];
-          int max_index = 0;
-          for (int i = 1; i < m_pool_size; ++i) {
-            const TensorDataType current_entry = im2col_buffer[i];
-            if (current_entry > max_entry) {
-              max_entry = current_entry;
-              max_index = i;
+      dispatch_max_pool_index_type(m_pool_size, [&](auto index) {
+        using IndexType = decltype(index);
+        IndexType* indices_buffer =
+          reinterpret_cast<IndexType*>(m_max_pool_indices.Buffer()) +
+          sample * this->get_output_size();
+        LBANN_OMP_PARALLEL_FOR
+        for (int channel = 0; channel < num_channels; ++channel) {
+          for (int j = 0; j < num_per_output_channel; ++j) {
+            TensorDataType* im2col_buffer =
+              im2col_mat.Buffer(channel * m_pool_size, j);
+            TensorDataType max_entry = im2col_buffer[0];
+            int max_index = 0;
+            for (int i = 1; i < m_pool_size; ++i) {
+              const TensorDataType current_entry = im2col_buffer[i];
+              if (current_entry > max_entry) {
+                max_entry = current_entry;
+                max_index = i;
+              }
             }
+            const int output_index = j + channel * num_per_output_channel;
+            output_buffer[output_index] = max_entry;
+            indices_buffer[output_index] = static_cast<IndexType>(max_index);
           }
-          const int output_index = j + channel * num_per_output_channel;
-          output_buffer[output_index] = max_entry;
-          indices_buffer[output_index] = max_index;
         }
-      }
+      });
     }
 
     if (m_pool_mode == pooling_mode::AVERAGE_COUNT_INCLUDE_PADDING) {
@@ -305,18 +329,23 @@ void pooling_layer<TensorDataType, Layout, Dev>::bp_compute_im2col()
       // corresponding to max
       const TensorDataType* gradient_wrt_output_buffer =
         local_gradient_wrt_output.LockedBuffer(0, sample);
-      const int* indices_buffer =
-        &m_max_pool_indices[sample * this->get_output_size()];
-      LBANN_OMP_PARALLEL_FOR
-      for (int channel = 0; channel < num_channels; ++channel) {
-        for (int j = 0; j < num_per_input_channel; ++j) {
-          const int input_index = j + channel * num_per_input_channel;
-          const int max_index = indices_buffer[input_index];
-          TensorDataType* im2col_buffer =
-            im2col_mat.Buffer(channel * m_pool_size, j);
-          im2col_buffer[max_index] = gradient_wrt_output_buffer[input_index];
+      dispatch_max_pool_index_type(m_pool_size, [&](auto index) {
+        using IndexType = decltype(index);
+        const IndexType* indices_buffer =
+          reinterpret_cast<const IndexType*>(
+            m_max_pool_indices.LockedBuffer()) +
+          sample * this->get_output_size();
+        LBANN_OMP_PARALLEL_FOR
+        for (int channel = 0; channel < num_channels; ++channel) {
+          for (int j = 0; j < num_per_input_channel; ++j) {
+            const int input_index = j + channel * num_per_input_channel;
+            const int max_index = indices_buffer[input_index];
+            TensorDataType* im2col_buffer =
+              im2col_mat.Buffer(channel * m_pool_size, j);
+            im2col_buffer[max_index] = gradient_wrt_output_buffer[input_index];
+          }
         }
-      }
+      });
     }
 
     // Compute gradient w.r.t. im2col matrix for average pooling
@@ -355,6 +384,49 @@ void pooling_layer<TensorDataType, Layout, Dev>::bp_compute_im2col()
   }
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Dev>
+void pooling_layer<TensorDataType, Layout, Dev>::fp_compute_compact()
+{
+#ifdef LBANN_HAS_GPU
+  if constexpr (Dev == El::Device::GPU) {
+    using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+    max_pool_with_indices_gpu(
+      static_cast<const GPUMatType&>(this->get_local_prev_activations()),
+      static_cast<GPUMatType&>(this->get_local_activations()),
+      m_max_pool_indices,
+      this->get_input_dims(),
+      this->get_output_dims(),
+      m_pool_dims,
+      m_pads,
+      m_strides);
+    return;
+  }
+#endif // LBANN_HAS_GPU
+  // The im2col implementation always records window offsets
+  fp_compute_im2col();
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Dev>
+void pooling_layer<TensorDataType, Layout, Dev>::bp_compute_compact()
+{
+#ifdef LBANN_HAS_GPU
+  if constexpr (Dev == El::Device::GPU) {
+    using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+    max_unpool_from_indices_gpu(
+      static_cast<const GPUMatType&>(this->get_local_prev_error_signals()),
+      m_max_pool_indices,
+      static_cast<GPUMatType&>(this->get_local_error_signals()),
+      this->get_input_dims(),
+      this->get_output_dims(),
+      m_pool_dims,
+      m_pads,
+      m_strides);
+    return;
+  }
+#endif // LBANN_HAS_GPU
+  bp_compute_im2col();
+}
+
 template <typename T, data_layout L, El::Device D>
 void pooling_layer<T, L, D>::write_specific_proto(
   lbann_data::Layer& proto) const
@@ -382,6 +454,8 @@ void pooling_layer<T, L, D>::write_specific_proto(
   protobuf::assign_to_repeated(*msg->mutable_pool_dims(), m_pool_dims);
   protobuf::assign_to_repeated(*msg->mutable_pool_pads(), m_pads);
   protobuf::assign_to_repeated(*msg->mutable_pool_strides(), m_strides);
+  msg->set_channels_last(m_channels_last);
+  msg->set_compact_indices(m_compact_indices);
 }
 
 #ifdef LBANN_HAS_DISTCONV
@@ -406,7 +480,8 @@ pooling_layer<TensorDataType, T_layout, Dev>::get_distconv_adapter() const
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 bool pooling_layer<TensorDataType, T_layout, Dev>::is_distconv_supported() const
 {
-  if (Dev != El::Device::GPU || T_layout != data_layout::DATA_PARALLEL) {
+  if (Dev != El::Device::GPU || T_layout != data_layout::DATA_PARALLEL ||
+      m_channels_last || m_compact_indices) {
     return false;
   }
 
@@ -603,7 +678,9 @@ build_pooling_layer_from_pbuf(lbann_comm* comm,
   const auto& params = proto_layer.pooling();
   pooling_mode const mode = to_pool_mode(params.pool_mode());
   if (params.has_vectors()) {
-    return BuilderType::Build(comm,
+    return BuilderType::Build(params.channels_last(),
+                              params.compact_indices(),
+                              comm,
                               params.pool_dims_size(),
                               protobuf::to_vector<int>(params.pool_dims()),
                               protobuf::to_vector<int>(params.pool_pads()),
@@ -611,7 +688,9 @@ build_pooling_layer_from_pbuf(lbann_comm* comm,
                               mode);
   }
   else {
-    return BuilderType::Build(comm,
+    return BuilderType::Build(params.channels_last(),
+                              params.compact_indices(),
+                              comm,
                               params.num_dims(),
                               params.pool_dims_i(),
                               params.pool_pads_i(),
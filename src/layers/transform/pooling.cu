@@ -0,0 +1,341 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/layers/transform/pooling.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+using Dim3 = gpu_lib::array<int, 3>;
+
+/** @brief Pooling geometry with spatial dims padded to 3
+ *
+ *  Missing leading spatial dims have size 1 and a trivial window.
+ */
+struct pool_geometry
+{
+  int num_channels;
+  Dim3 input_dims;
+  Dim3 output_dims;
+  Dim3 pool_dims;
+  Dim3 pads;
+  Dim3 strides;
+};
+
+pool_geometry get_pool_geometry(const std::vector<int>& input_dims,
+                                const std::vector<int>& output_dims,
+                                const std::vector<int>& pool_dims,
+                                const std::vector<int>& pads,
+                                const std::vector<int>& strides)
+{
+  const int num_spatial_dims = pool_dims.size();
+  if (num_spatial_dims > 3) {
+    LBANN_ERROR("max pooling with indices supports at most 3 spatial ",
+                "dimensions, but got ",
+                num_spatial_dims);
+  }
+  pool_geometry geom;
+  geom.num_channels = input_dims.front();
+  for (int d = 0; d < 3; ++d) {
+    const int i = d - (3 - num_spatial_dims);
+    geom.input_dims[d] = (i < 0 ? 1 : input_dims[i + 1]);
+    geom.output_dims[d] = (i < 0 ? 1 : output_dims[i + 1]);
+    geom.pool_dims[d] = (i < 0 ? 1 : pool_dims[i]);
+    geom.pads[d] = (i < 0 ? 0 : pads[i]);
+    geom.strides[d] = (i < 0 ? 1 : strides[i]);
+  }
+  return geom;
+}
+
+/** @brief Max pooling that records window offsets
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (output_size / bsize) x local_mini_batch_size x 1
+ */
+template <typename TensorDataType, typename IndexType>
+__global__ void max_pool_kernel(pool_geometry geom,
+                                El::Int local_mini_batch_size,
+                                El::Int input_size,
+                                El::Int output_size,
+                                const TensorDataType* __restrict__ input,
+                                El::Int input_ldim,
+                                TensorDataType* __restrict__ output,
+                                El::Int output_ldim,
+                                IndexType* __restrict__ indices)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  const El::Int channel_size = input_size / geom.num_channels;
+  for (El::Int col = gidy; col < local_mini_batch_size; col += nthreadsy) {
+    for (El::Int row = gidx; row < output_size; row += nthreadsx) {
+
+      // Position in output tensor
+      El::Int pos = row;
+      Dim3 start;
+      for (int d = 2; d >= 0; --d) {
+        start[d] = (pos % geom.output_dims[d]) * geom.strides[d] - geom.pads[d];
+        pos /= geom.output_dims[d];
+      }
+      const TensorDataType* x = &input[col * input_ldim + pos * channel_size];
+
+      // Find max entry in window, ignoring padding
+      TensorDataType max_x = TensorDataType(0.f);
+      int max_offset = 0;
+      bool found = false;
+      for (int w0 = 0; w0 < geom.pool_dims[0]; ++w0) {
+        const int i0 = start[0] + w0;
+        if (i0 < 0 || i0 >= geom.input_dims[0]) {
+          continue;
+        }
+        for (int w1 = 0; w1 < geom.pool_dims[1]; ++w1) {
+          const int i1 = start[1] + w1;
+          if (i1 < 0 || i1 >= geom.input_dims[1]) {
+            continue;
+          }
+          for (int w2 = 0; w2 < geom.pool_dims[2]; ++w2) {
+            const int i2 = start[2] + w2;
+            if (i2 < 0 || i2 >= geom.input_dims[2]) {
+              continue;
+            }
+            const auto& val =
+              x[(i0 * geom.input_dims[1] + i1) * geom.input_dims[2] + i2];
+            if (!found || val > max_x) {
+              max_x = val;
+              max_offset =
+                (w0 * geom.pool_dims[1] + w1) * geom.pool_dims[2] + w2;
+              found = true;
+            }
+          }
+        }
+      }
+      output[row + col * output_ldim] = max_x;
+      indices[row + col * output_size] = static_cast<IndexType>(max_offset);
+    }
+  }
+}
+
+/** @brief Max pooling backprop from recorded window offsets
+ *
+ *  Each input entry loops over the windows that contain it and sums
+ *  the gradients of those whose max it is.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (input_size / bsize) x local_mini_batch_size x 1
+ */
+template <typename TensorDataType, typename IndexType>
+__global__ void
+max_unpool_kernel(pool_geometry geom,
+                  El::Int local_mini_batch_size,
+                  El::Int input_size,
+                  El::Int output_size,
+                  const TensorDataType* __restrict__ gradient_wrt_output,
+                  El::Int gradient_wrt_output_ldim,
+                  const IndexType* __restrict__ indices,
+                  TensorDataType* __restrict__ gradient_wrt_input,
+                  El::Int gradient_wrt_input_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  const El::Int output_channel_size = output_size / geom.num_channels;
+  for (El::Int col = gidy; col < local_mini_batch_size; col += nthreadsy) {
+    for (El::Int row = gidx; row < input_size; row += nthreadsx) {
+
+      // Position in input tensor and range of windows containing it
+      El::Int pos = row;
+      Dim3 shifted, first, last;
+      for (int d = 2; d >= 0; --d) {
+        shifted[d] = (pos % geom.input_dims[d]) + geom.pads[d];
+        pos /= geom.input_dims[d];
+        const int lo = shifted[d] - geom.pool_dims[d] + 1;
+        first[d] = (lo <= 0 ? 0 : (lo + geom.strides[d] - 1) / geom.strides[d]);
+        last[d] = min(shifted[d] / geom.strides[d], geom.output_dims[d] - 1);
+      }
+      const El::Int offset = col * output_size + pos * output_channel_size;
+      const IndexType* ind = &indices[offset];
+      const TensorDataType* dy =
+        &gradient_wrt_output[col * gradient_wrt_output_ldim +
+                             pos * output_channel_size];
+
+      // Accumulate gradients from windows whose max is this entry
+      TensorDataType dx = TensorDataType(0.f);
+      for (int o0 = first[0]; o0 <= last[0]; ++o0) {
+        const int w0 = shifted[0] - o0 * geom.strides[0];
+        for (int o1 = first[1]; o1 <= last[1]; ++o1) {
+          const int w1 = shifted[1] - o1 * geom.strides[1];
+          for (int o2 = first[2]; o2 <= last[2]; ++o2) {
+            const int w2 = shifted[2] - o2 * geom.strides[2];
+            const int window_offset =
+              (w0 * geom.pool_dims[1] + w1) * geom.pool_dims[2] + w2;
+            const El::Int j =
+              (o0 * geom.output_dims[1] + o1) * geom.output_dims[2] + o2;
+            if (static_cast<int>(ind[j]) == window_offset) {
+              dx += dy[j];
+            }
+          }
+        }
+      }
+      gradient_wrt_input[row + col * gradient_wrt_input_ldim] = dx;
+    }
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void max_pool_with_indices_gpu(
+  const El::Matrix<TensorDataType, El::Device::GPU>& input,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  El::Matrix<TensorDataType, El::Device::GPU>& indices,
+  const std::vector<int>& input_dims,
+  const std::vector<int>& output_dims,
+  const std::vector<int>& pool_dims,
+  const std::vector<int>& pads,
+  const std::vector<int>& strides)
+{
+  const auto geom =
+    get_pool_geometry(input_dims, output_dims, pool_dims, pads, strides);
+  const El::Int input_size = input.Height();
+  const El::Int output_size = output.Height();
+  const El::Int local_mini_batch_size = input.Width();
+  const int pool_size = get_linear_size(pool_dims);
+  indices.SetSyncInfo(gpu::get_sync_info(output));
+  dispatch_max_pool_index_type(pool_size, [&](auto index) {
+    using IndexType = decltype(index);
+    const size_t index_bytes =
+      sizeof(IndexType) * output_size * local_mini_batch_size;
+    indices.Resize(
+      (index_bytes + sizeof(TensorDataType) - 1) / sizeof(TensorDataType),
+      1);
+    if (output_size <= 0 || local_mini_batch_size <= 0) {
+      return;
+    }
+    constexpr size_t block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.x = (output_size + block_size - 1) / block_size;
+    grid_dims.y = local_mini_batch_size;
+    gpu_lib::clip_grid_dims(grid_dims);
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                       gpu::get_sync_info(input));
+    hydrogen::gpu::LaunchKernel(
+      max_pool_kernel<TensorDataType, IndexType>,
+      grid_dims,
+      block_dims,
+      0,
+      multisync,
+      geom,
+      local_mini_batch_size,
+      input_size,
+      output_size,
+      input.LockedBuffer(),
+      input.LDim(),
+      output.Buffer(),
+      output.LDim(),
+      reinterpret_cast<IndexType*>(indices.Buffer()));
+  });
+}
+
+template <typename TensorDataType>
+void max_unpool_from_indices_gpu(
+  const El::Matrix<TensorDataType, El::Device::GPU>& gradient_wrt_output,
+  const El::Matrix<TensorDataType, El::Device::GPU>& indices,
+  El::Matrix<TensorDataType, El::Device::GPU>& gradient_wrt_input,
+  const std::vector<int>& input_dims,
+  const std::vector<int>& output_dims,
+  const std::vector<int>& pool_dims,
+  const std::vector<int>& pads,
+  const std::vector<int>& strides)
+{
+  const El::Int input_size = gradient_wrt_input.Height();
+  const El::Int output_size = gradient_wrt_output.Height();
+  const El::Int local_mini_batch_size = gradient_wrt_input.Width();
+  if (input_size <= 0 || local_mini_batch_size <= 0) {
+    return;
+  }
+  const auto geom =
+    get_pool_geometry(input_dims, output_dims, pool_dims, pads, strides);
+  const int pool_size = get_linear_size(pool_dims);
+  dispatch_max_pool_index_type(pool_size, [&](auto index) {
+    using IndexType = decltype(index);
+    constexpr size_t block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.x = (input_size + block_size - 1) / block_size;
+    grid_dims.y = local_mini_batch_size;
+    gpu_lib::clip_grid_dims(grid_dims);
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(gradient_wrt_input),
+                                       gpu::get_sync_info(gradient_wrt_output),
+                                       gpu::get_sync_info(indices));
+    hydrogen::gpu::LaunchKernel(
+      max_unpool_kernel<TensorDataType, IndexType>,
+      grid_dims,
+      block_dims,
+      0,
+      multisync,
+      geom,
+      local_mini_batch_size,
+      input_size,
+      output_size,
+      gradient_wrt_output.LockedBuffer(),
+      gradient_wrt_output.LDim(),
+      reinterpret_cast<const IndexType*>(indices.LockedBuffer()),
+      gradient_wrt_input.Buffer(),
+      gradient_wrt_input.LDim());
+  });
+}
+
+#define PROTO(T)                                                               \
+  template void max_pool_with_indices_gpu<T>(                                  \
+    const El::Matrix<T, El::Device::GPU>&,                                     \
+    El::Matrix<T, El::Device::GPU>&,                                           \
+    El::Matrix<T, El::Device::GPU>&,                                           \
+    const std::vector<int>&,                                                   \
+    const std::vector<int>&,                                                   \
+    const std::vector<int>&,                                                   \
+    const std::vector<int>&,                                                   \
+    const std::vector<int>&);                                                  \
+  template void max_unpool_from_indices_gpu<T>(                                \
+    const El::Matrix<T, El::Device::GPU>&,                                     \
+    const El::Matrix<T, El::Device::GPU>&,                                     \
+    El::Matrix<T, El::Device::GPU>&,                                           \
+    const std::vector<int>&,                                                   \
+    const std::vector<int>&,                                                   \
+    const std::vector<int>&,                                                   \
+    const std::vector<int>&,                                                   \
+    const std::vector<int>&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
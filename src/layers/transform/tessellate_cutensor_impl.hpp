@@ -28,6 +28,7 @@
 
 #ifdef LBANN_HAS_CUTENSOR
 #include "lbann/utils/cutensor_support.hpp"
+#include "lbann/utils/gpu_workspace.hpp"
 
 namespace lbann {
 
@@ -76,9 +77,6 @@ void tessellate_layer<TensorDataType, T_layout, Dev>::bp_compute_cutensor(
   auto input_desc = get_descriptor(input, ct_input_dims);
   auto output_desc = get_descriptor(output, ct_output_dims);
 
-  // Create workspace buffers
-  LocalMat workspace;
-  workspace.SetMemoryMode(1);
   auto handle = get_handle_ptr();
   uint64_t wspsize = 0;
   CHECK_CUTENSOR(
@@ -95,10 +93,10 @@ void tessellate_layer<TensorDataType, T_layout, Dev>::bp_compute_cutensor(
                                       CUTENSOR_OP_ADD,
                                       CUDATypeT<TensorDataType>::compute_type,
                                       &wspsize));
-  workspace.Resize(wspsize, 1);
-
   auto multisync = El::MakeMultiSync(gpu::get_sync_info(input_grad),
                                      gpu::get_sync_info(output_grad));
+  const auto sync_info = static_cast<El::SyncInfo<El::Device::GPU>>(multisync);
+  void* workspace = gpu::get_workspace(wspsize, sync_info);
 
   // Compute reduction locally
   CHECK_CUTENSOR(cutensorReduction(
@@ -116,9 +114,9 @@ void tessellate_layer<TensorDataType, T_layout, Dev>::bp_compute_cutensor(
     output_modes.data(),
     CUTENSOR_OP_ADD,
     CUDATypeT<TensorDataType>::compute_type,
-    workspace.Buffer(),
+    workspace,
     wspsize,
-    static_cast<El::SyncInfo<El::Device::GPU>>(multisync).Stream()));
+    sync_info.Stream()));
 }
 
 } // namespace lbann
@@ -129,7 +129,8 @@ lbann::build_gather_layer_from_pbuf(lbann_comm* /*comm*/,
   if constexpr (L == data_layout::DATA_PARALLEL) {
     const auto& params = proto_layer.gather();
     return std::make_unique<gather_layer<T, data_layout::DATA_PARALLEL, D>>(
-      params.has_axis() ? params.axis().value() : -1);
+      params.has_axis() ? params.axis().value() : -1,
+      params.deterministic());
   }
   else {
     LBANN_ERROR("Attempted to instantiate \"gather\" layer with Layout=",
@@ -178,7 +179,8 @@ lbann::build_scatter_layer_from_pbuf(lbann_comm* /*comm*/,
     const auto& params = proto_layer.scatter();
     return std::make_unique<scatter_layer<T, data_layout::DATA_PARALLEL, D>>(
       protobuf::to_vector<int>(params.dims()),
-      params.has_axis() ? params.axis().value() : -1);
+      params.has_axis() ? params.axis().value() : -1,
+      params.deterministic());
   }
   else {
     LBANN_ERROR("Attempted to instantiate layer \"scatter\""
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include "lbann/objective_functions/objective_function.hpp"
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
+#include <lbann/metrics/metric.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::setup_model;
+
+/** Evaluation layer feeding an objective function term and a metric */
+const std::string evaluation_prototext = R"""(
+model {
+  layer {
+    name: "x"
+    children: "eval"
+    weights: "x_values"
+    weights_layer {
+      dims: 1
+    }
+  }
+  layer {
+    name: "eval"
+    parents: "x"
+    evaluation {
+    }
+  }
+  weights {
+    name: "x_values"
+    optimizer {
+      no_optimizer {
+      }
+    }
+    initializer {
+      constant_initializer {
+        value: 0.0
+      }
+    }
+  }
+  objective_function {
+    layer_term {
+      scale_factor: 2.0
+      layer: "eval"
+    }
+  }
+  metric {
+    layer_metric {
+      layer: "eval"
+      name: "value"
+    }
+  }
+}
+)""";
+
+using lbann::EvalType;
+using lbann::execution_mode;
+
+/** Execution mode and input value of each mini-batch step */
+const std::vector<std::pair<execution_mode, float>> steps = {
+  {execution_mode::training, 0.25f},
+  {execution_mode::training, 0.5f},
+  {execution_mode::training, -1.f},
+  {execution_mode::training, 2.f},
+  {execution_mode::training, 0.75f},
+  {execution_mode::validation, 1.5f},
+  {execution_mode::validation, -0.5f},
+  {execution_mode::training, 1.25f},
+  {execution_mode::training, 0.125f},
+};
+
+struct evaluation_result
+{
+  EvalType objective_mean;
+  int objective_samples;
+  EvalType metric_mean;
+  int metric_samples;
+};
+
+/** Run every step and flush the accumulated values */
+std::map<execution_mode, evaluation_result> run_steps(size_t window)
+{
+  auto m = construct_model(evaluation_prototext);
+  m->set_metric_accumulation_window(window);
+  setup_model(*m);
+  REQUIRE(m->get_metric_accumulation_window() == window);
+
+  auto& x =
+    dynamic_cast<lbann::data_type_weights<float>&>(*m->get_weights()[0]);
+  auto* obj = m->get_objective_function();
+  REQUIRE(m->get_metrics().size() == 1);
+  auto* met = m->get_metrics()[0];
+
+  lbann::SGDExecutionContext c(execution_mode::training);
+  m->reset_mode(c, execution_mode::training);
+  for (auto const& [mode, value] : steps) {
+    c.set_execution_mode(mode);
+    x.set_value(value, 0);
+    REQUIRE_NOTHROW(m->forward_prop(mode));
+    obj->start_evaluation(mode, 1);
+    obj->finish_evaluation(mode, 1);
+    m->evaluate_metrics(mode, 1);
+  }
+
+  std::map<execution_mode, evaluation_result> results;
+  for (auto mode : {execution_mode::training, execution_mode::validation}) {
+    m->flush_accumulated_metrics(mode);
+    results[mode] = {obj->get_mean_value(mode),
+                     obj->get_statistics_num_samples(mode),
+                     met->get_mean_value(mode),
+                     met->get_statistics_num_samples(mode)};
+  }
+  return results;
+}
+
+} // namespace
+
+TEST_CASE("Windowed metric accumulation matches per-step values",
+          "[mpi][layer][evaluation]")
+{
+  // Windows that divide the steps evenly and ones that do not
+  const size_t window = GENERATE(1, 2, 3, 16);
+  INFO("Window = " << window);
+
+  std::map<execution_mode, std::pair<EvalType, int>> expected;
+  for (auto const& [mode, value] : steps) {
+    expected[mode].first += value;
+    expected[mode].second += 1;
+  }
+
+  auto const results = run_steps(window);
+  for (auto const& [mode, sum_and_count] : expected) {
+    INFO("Mode = " << lbann::to_string(mode));
+    auto const& [sum, count] = sum_and_count;
+    auto const& result = results.at(mode);
+    CHECK(result.objective_samples == count);
+    CHECK(result.objective_mean == Approx(2 * sum / count));
+    CHECK(result.metric_samples == count);
+    CHECK(result.metric_mean == Approx(sum / count));
+  }
+}
@@ -31,7 +31,10 @@
 #include "TestHelpers.hpp"
 
 #include "lbann/base.hpp"
+#include "lbann/layers/operator_layer.hpp"
 #include "lbann/layers/transform/permute.hpp"
+#include "lbann/operators/math/binary_with_constant.hpp"
+#include "lbann/operators/math/clamp.hpp"
 #include "lbann/utils/description.hpp"
 #include <lbann/utils/serialize.hpp>
 #include <lbann/utils/typename.hpp>
@@ -61,6 +64,45 @@ static std::string desc(lbann::Layer const& l)
   return to_str(l.get_description());
 }
 
+#ifdef LBANN_HAS_CUTENSOR
+TEMPLATE_LIST_TEST_CASE("Fusing scale layers into PermuteLayers",
+                        "[mpi][layer][fusion]",
+                        TheTestTypes)
+{
+  using DataT = TestType;
+  using LayerType = ::lbann::PermuteLayer<DataT>;
+  using OpLayerType = ::lbann::OperatorLayer<DataT,
+                                             DataT,
+                                             lbann::data_layout::DATA_PARALLEL,
+                                             El::Device::GPU>;
+  using ScaleOpType = ::lbann::ScaleOperator<DataT, El::Device::GPU>;
+  using ClampOpType = ::lbann::ClampOperator<DataT, El::Device::GPU>;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+
+  LayerType layer(std::vector<int>{0, 2, 1});
+  OpLayerType scale(world_comm, std::make_unique<ScaleOpType>(0.5));
+  OpLayerType clamp(world_comm, std::make_unique<ClampOpType>(-1.0, 1.0));
+
+  SECTION("Scale child is fused")
+  {
+    REQUIRE(layer.fuse_child(scale));
+    CHECK(desc(layer).find("Fused scale") != std::string::npos);
+  }
+  SECTION("Other operators are not fused")
+  {
+    CHECK_FALSE(layer.fuse_child(clamp));
+    CHECK(desc(layer).find("Fused scale") == std::string::npos);
+  }
+  SECTION("Fused scale survives a copy")
+  {
+    REQUIRE(layer.fuse_child(scale));
+    LayerType copy(layer);
+    CHECK(desc(copy) == desc(layer));
+  }
+}
+#endif // LBANN_HAS_CUTENSOR
+
 using unit_test::utilities::IsValidPtr;
 TEMPLATE_LIST_TEST_CASE("Serializing PermuteLayers",
                         "[mpi][layer][serialize]",
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/transform/pooling.hpp>
+
+#include <functional>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+struct pooling_config
+{
+  std::vector<int> input_dims;
+  std::vector<int> pool_dims;
+  std::vector<int> pads;
+  std::vector<int> strides;
+};
+
+/** Weights layer feeding a max pooling layer and a dummy layer
+ *
+ *  Input entries are a permutation of evenly spaced values, so every
+ *  window has a unique max.
+ */
+std::string make_prototext(pooling_config const& config, bool compact)
+{
+  const int size = std::accumulate(config.input_dims.begin(),
+                                   config.input_dims.end(),
+                                   1,
+                                   std::multiplies<int>());
+  std::ostringstream ss;
+  ss << "model {\n"
+     << "  layer {\n"
+     << "    name: \"inp\"\n"
+     << "    children: \"pool\"\n"
+     << "    weights: \"inputs\"\n"
+     << "    weights_layer {\n";
+  for (auto d : config.input_dims) {
+    ss << "      dims: " << d << "\n";
+  }
+  ss << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"pool\"\n"
+     << "    parents: \"inp\"\n"
+     << "    children: \"out\"\n"
+     << "    pooling {\n"
+     << "      pool_mode: \"max\"\n"
+     << "      num_dims: " << config.pool_dims.size() << "\n"
+     << "      has_vectors: true\n";
+  for (size_t i = 0; i < config.pool_dims.size(); ++i) {
+    ss << "      pool_dims: " << config.pool_dims[i] << "\n"
+       << "      pool_pads: " << config.pads[i] << "\n"
+       << "      pool_strides: " << config.strides[i] << "\n";
+  }
+  ss << "      compact_indices: " << (compact ? "true" : "false") << "\n"
+     << "    }\n"
+     << "  }\n"
+     << "  layer {\n"
+     << "    name: \"out\"\n"
+     << "    parents: \"pool\"\n"
+     << "    dummy {\n"
+     << "    }\n"
+     << "  }\n"
+     << "  weights {\n"
+     << "    name: \"inputs\"\n"
+     << "    initializer {\n"
+     << "      value_initializer {\n";
+  // 37 is coprime with every size below, so i*37 mod size permutes
+  for (int i = 0; i < size; ++i) {
+    const auto value = static_cast<double>((i * 37) % size) / size - 0.5;
+    ss << "        values: " << value << "\n";
+  }
+  ss << "      }\n"
+     << "    }\n"
+     << "  }\n"
+     << "}\n";
+  return ss.str();
+}
+
+struct pooling_result
+{
+  std::vector<float> output;
+  std::vector<float> input_grad;
+};
+
+/** One forward and backward pass through the pooling layer */
+pooling_result run_pooling(pooling_config const& config, bool compact)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif
+  using pooling_type =
+    lbann::pooling_layer<float, lbann::data_layout::DATA_PARALLEL, Dev>;
+
+  auto m = construct_model(make_prototext(config, compact));
+  setup_model(*m);
+  auto& inp = m->get_layer(0);
+  auto& pool = dynamic_cast<pooling_type&>(m->get_layer(1));
+  CHECK(pool.uses_compact_indices() == compact);
+  pool.set_keep_error_signals(true);
+
+  std::vector<float> error_signal;
+  for (int i = 0; i < pool.get_output_size(); ++i) {
+    error_signal.push_back(1.f + 0.5f * static_cast<float>(i % 7));
+  }
+  set_error_signal<Dev>(m->get_layer(2), error_signal);
+
+  REQUIRE_NOTHROW(m->forward_prop(lbann::execution_mode::training));
+  REQUIRE_NOTHROW(m->backward_prop(false));
+  return {to_vector(pool.get_activations()),
+          to_vector(pool.get_error_signals(inp))};
+}
+
+void check_same_results(pooling_config const& config)
+{
+  auto const expected = run_pooling(config, false);
+  auto const compact = run_pooling(config, true);
+  REQUIRE(compact.output.size() == expected.output.size());
+  for (size_t i = 0; i < expected.output.size(); ++i) {
+    CHECK(compact.output[i] == expected.output[i]);
+  }
+  REQUIRE(compact.input_grad.size() == expected.input_grad.size());
+  for (size_t i = 0; i < expected.input_grad.size(); ++i) {
+    CHECK(compact.input_grad[i] == Approx(expected.input_grad[i]));
+  }
+}
+
+} // namespace
+
+TEST_CASE("Compact max pooling matches the default implementation",
+          "[mpi][layer][pooling]")
+{
+  SECTION("Non-overlapping 2D windows")
+  {
+    check_same_results({{2, 6, 6}, {2, 2}, {0, 0}, {2, 2}});
+  }
+  SECTION("Overlapping padded 2D windows")
+  {
+    check_same_results({{3, 5, 7}, {3, 3}, {1, 1}, {1, 2}});
+  }
+  SECTION("3D windows")
+  {
+    check_same_results({{2, 4, 5, 3}, {2, 3, 2}, {0, 1, 0}, {1, 1, 1}});
+  }
+  SECTION("Windows with more than 255 entries")
+  {
+    // Offsets no longer fit in one byte
+    check_same_results({{1, 18, 19}, {16, 17}, {0, 0}, {1, 1}});
+  }
+}
@@ -25,17 +25,22 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <lbann/lbann.hpp>
+#include <lbann/layers/misc/external_abi.hpp>
+
+#include <cstring>
 
 #ifdef LBANN_HAS_GPU
 #ifdef __HIPCC__
 #include <hip/hip_runtime.h>
 typedef hipStream_t gpuStream_t;
 #define gpuMemcpyAsync hipMemcpyAsync
+#define gpuMemcpy2DAsync hipMemcpy2DAsync
 #define gpuMemcpyDeviceToDevice hipMemcpyDeviceToDevice
 #else
 #include <cuda_runtime.h>
 typedef cudaStream_t gpuStream_t;
 #define gpuMemcpyAsync cudaMemcpyAsync
+#define gpuMemcpy2DAsync cudaMemcpy2DAsync
 #define gpuMemcpyDeviceToDevice cudaMemcpyDeviceToDevice
 #endif
 
@@ -177,3 +182,79 @@ extern "C" lbann::Layer* setup_layer(int datatype,
   // Unsupported configurations return nullptr
   return nullptr;
 }
+
+/**
+ * Sample external kernel that performs the identity function. Unlike the
+ * layer above, it only uses the C interface in external_abi.hpp. Copies are
+ * enqueued on the stream that LBANN passes in.
+ **/
+namespace {
+
+int copy_tensor(const lbann_external_context* context,
+                const lbann_external_tensor* src,
+                lbann_external_tensor* dst)
+{
+  const size_t entry_size =
+    (context->datatype == LBANN_EXTERNAL_FLOAT ? sizeof(float)
+                                               : sizeof(double));
+  const size_t column_size = entry_size * src->height;
+  if (context->device == LBANN_EXTERNAL_CPU) {
+    for (int64_t j = 0; j < src->width; ++j) {
+      std::memcpy(static_cast<char*>(dst->data) + j * dst->ldim * entry_size,
+                  static_cast<const char*>(src->data) +
+                    j * src->ldim * entry_size,
+                  column_size);
+    }
+    return 0;
+  }
+#ifdef LBANN_HAS_GPU
+  return static_cast<int>(
+    gpuMemcpy2DAsync(dst->data,
+                     dst->ldim * entry_size,
+                     src->data,
+                     src->ldim * entry_size,
+                     column_size,
+                     src->width,
+                     gpuMemcpyDeviceToDevice,
+                     static_cast<gpuStream_t>(context->stream)));
+#else
+  return 1;
+#endif // LBANN_HAS_GPU
+}
+
+int identity_forward(const lbann_external_context* context,
+                     int32_t num_inputs,
+                     const lbann_external_tensor* inputs,
+                     int32_t num_outputs,
+                     lbann_external_tensor* outputs)
+{
+  return copy_tensor(context, &inputs[0], &outputs[0]);
+}
+
+int identity_backward(const lbann_external_context* context,
+                      int32_t num_inputs,
+                      const lbann_external_tensor* inputs,
+                      int32_t num_outputs,
+                      const lbann_external_tensor* outputs,
+                      const lbann_external_tensor* output_grads,
+                      lbann_external_tensor* input_grads)
+{
+  return copy_tensor(context, &output_grads[0], &input_grads[0]);
+}
+
+} // namespace
+
+extern "C" const lbann_external_kernel* lbann_external_kernel_identity()
+{
+  static const lbann_external_kernel kernel = {
+    LBANN_EXTERNAL_ABI_VERSION, // abi_version
+    1,                          // num_outputs
+    nullptr,                    // create
+    nullptr,                    // destroy
+    nullptr,                    // output_shape
+    nullptr,                    // workspace_size
+    identity_forward,           // forward
+    identity_backward,          // backward
+  };
+  return &kernel;
+}
@@ -71,6 +71,45 @@ TEST_CASE("External Layer test", "[layer][externallayer]")
                      "DOES_NOT_EXIST"));
     CHECK(setupfunc == nullptr);
   }
+  SECTION("Load an external kernel")
+  {
+    CHECK(lbann::has_external_kernel("src/layers/unit_test/libexample_layer.so",
+                                     "identity"));
+    CHECK_FALSE(
+      lbann::has_external_kernel("src/layers/unit_test/libexample_layer.so",
+                                 "layer"));
+
+    auto library =
+      lbann::open_external_library("src/layers/unit_test/libexample_layer.so");
+    const lbann_external_kernel* kernel = nullptr;
+    REQUIRE_NOTHROW(kernel = lbann::load_external_kernel(
+                      library,
+                      "src/layers/unit_test/libexample_layer.so",
+                      "identity"));
+    REQUIRE(kernel != nullptr);
+    CHECK(kernel->abi_version == LBANN_EXTERNAL_ABI_VERSION);
+    CHECK(kernel->num_outputs == 1);
+
+    std::unique_ptr<lbann::Layer> layer;
+    REQUIRE_NOTHROW(
+      layer = std::make_unique<
+        lbann::external_kernel_layer<float,
+                                     lbann::data_layout::DATA_PARALLEL,
+                                     El::Device::CPU>>(
+        &world_comm,
+        "src/layers/unit_test/libexample_layer.so",
+        "identity"));
+    CHECK(layer->get_type() == "external kernel");
+  }
+  SECTION("Load a nonexistent external kernel")
+  {
+    auto library =
+      lbann::open_external_library("src/layers/unit_test/libexample_layer.so");
+    REQUIRE_THROWS(lbann::load_external_kernel(
+      library,
+      "src/layers/unit_test/libexample_layer.so",
+      "DOES_NOT_EXIST"));
+  }
   SECTION("Load a nonexistent external library")
   {
     lbann::external_layer_setup_t setupfunc = nullptr;
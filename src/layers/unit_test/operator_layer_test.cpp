@@ -31,6 +31,8 @@
 #include "lbann/operators/math/clamp.hpp"
 #include "lbann/utils/serialize.hpp"
 
+#include "lbann/proto/layers.pb.h"
+
 #include "MPITestHelpers.hpp"
 #include "TestHelpers.hpp"
 
@@ -142,13 +144,21 @@ TEMPLATE_LIST_TEST_CASE("OperatorLayer lifecycle",
       layer = std::make_unique<OperatorLayer>(world_comm, std::move(ops)));
     CHECK(IsValidPtr(layer));
   }
-  SECTION("Constructing with multiple operators fails")
+  SECTION("Construct with a chain of element-wise operators")
   {
     LayerPtr layer = nullptr;
     std::vector<std::unique_ptr<OpType>> ops;
     ops.reserve(2);
     ops.push_back(std::make_unique<ClampOpType>(-1.0, 1.0));
     ops.push_back(std::make_unique<ClampOpType>(-0.5, 0.5));
+    REQUIRE_NOTHROW(
+      layer = std::make_unique<OperatorLayer>(world_comm, std::move(ops)));
+    CHECK(IsValidPtr(layer));
+  }
+  SECTION("Constructing with no operators fails")
+  {
+    LayerPtr layer = nullptr;
+    std::vector<std::unique_ptr<OpType>> ops;
     REQUIRE_THROWS(
       layer = std::make_unique<OperatorLayer>(world_comm, std::move(ops)));
     CHECK_FALSE(IsValidPtr(layer));
@@ -184,6 +194,38 @@ TEMPLATE_LIST_TEST_CASE("OperatorLayer lifecycle",
   }
 }
 
+TEMPLATE_LIST_TEST_CASE("Fusing operator layers",
+                        "[layer][operatorlayer][mpi][fusion]",
+                        AllLayerTypes)
+{
+  using OperatorLayer = TestType;
+  using ValueType = ValueType<TestType>;
+  constexpr auto DeviceAlloc = Device<TestType>;
+
+  using ClampOpType = lbann::ClampOperator<ValueType, DeviceAlloc>;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+
+  OperatorLayer parent(world_comm, std::make_unique<ClampOpType>(-1.0, 1.0));
+  OperatorLayer child(world_comm, std::make_unique<ClampOpType>(-0.5, 0.5));
+
+  SECTION("Element-wise child is fused")
+  {
+    REQUIRE(parent.fuse_child(child));
+    lbann_data::Layer msg;
+    parent.write_proto(msg);
+    CHECK(msg.operator_layer().ops_size() == 2);
+  }
+  SECTION("Fused layers keep their operators when copied")
+  {
+    REQUIRE(parent.fuse_child(child));
+    OperatorLayer copy(parent);
+    lbann_data::Layer msg;
+    copy.write_proto(msg);
+    CHECK(msg.operator_layer().ops_size() == 2);
+  }
+}
+
 TEMPLATE_LIST_TEST_CASE("Serializing operator layer with clamp operator",
                         "[layer][operatorlayer][mpi][serialize]",
                         AllLayerTypes)
@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+
+#ifdef LBANN_HAS_GPU
+constexpr auto Dev = El::Device::GPU;
+#else
+constexpr auto Dev = El::Device::CPU;
+#endif
+
+/** @brief Sums its input over the trainer without waiting.
+ *
+ *  Forward and back prop each leave a non-blocking allreduce for the
+ *  first consumer of the tensors to complete, like the cross-grid sum
+ *  layers.
+ */
+class pending_sum_layer final : public lbann::data_type_layer<float>
+{
+public:
+  pending_sum_layer(lbann::lbann_comm* comm)
+    : lbann::data_type_layer<float>(comm)
+  {}
+  pending_sum_layer* copy() const final
+  {
+    return new pending_sum_layer(*this);
+  }
+  std::string get_type() const final { return "pending sum"; }
+  lbann::data_layout get_data_layout() const final
+  {
+    return lbann::data_layout::DATA_PARALLEL;
+  }
+  El::Device get_device_allocation() const final { return Dev; }
+  void write_specific_proto(lbann_data::Layer& proto) const final {}
+
+private:
+  void setup_dims() final
+  {
+    lbann::data_type_layer<float>::setup_dims();
+    this->set_output_dims(this->get_input_dims());
+  }
+
+  void fp_compute() final
+  {
+    El::Copy(this->get_prev_activations(), this->get_activations());
+    Al::request req;
+    this->get_comm()->nb_allreduce(this->get_activations(),
+                                   this->get_comm()->get_trainer_comm(),
+                                   req);
+    this->add_pending_communication(req);
+  }
+
+  void bp_compute() final
+  {
+    El::Copy(this->get_prev_error_signals(), this->get_error_signals());
+    Al::request req;
+    this->get_comm()->nb_allreduce(this->get_error_signals(),
+                                   this->get_comm()->get_trainer_comm(),
+                                   req);
+    this->add_pending_communication(req);
+  }
+};
+
+/** "mid" is replaced with a pending_sum_layer */
+const std::string pending_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "mid"
+    weights: "inputs"
+    weights_layer {
+      dims: 4
+    }
+  }
+  layer {
+    name: "mid"
+    parents: "inp"
+    children: "out"
+    identity {
+    }
+  }
+  layer {
+    name: "out"
+    parents: "mid"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    initializer {
+      value_initializer {
+        values: 0.5
+        values: -1.0
+        values: 0.25
+        values: 2.0
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 1.0
+  }
+}
+)""";
+
+} // namespace
+
+TEST_CASE("Pending layer communication completes before its consumers",
+          "[mpi][layer][communication]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto m = construct_model(pending_prototext);
+  auto sum = std::make_unique<pending_sum_layer>(&comm);
+  sum->set_name("sum");
+  REQUIRE_NOTHROW(m->replace_layer(std::move(sum), "mid"));
+  setup_model(*m);
+
+  auto& sum_layer = find_layer<lbann::data_type_layer<float>>(*m, "sum");
+  sum_layer.set_keep_error_signals(true);
+
+  const std::vector<float> inputs = {0.5f, -1.f, 0.25f, 2.f};
+  const std::vector<float> signal = {1.f, -0.5f, 0.25f, 3.f};
+  set_error_signal<Dev>(find_layer(*m, "out"), signal);
+
+  // Every rank holds the same values, so the sums scale them
+  const float num_procs = comm.get_procs_per_trainer();
+
+  m->clear_gradients();
+  REQUIRE_NOTHROW(m->forward_prop(lbann::execution_mode::training));
+  CHECK_FALSE(sum_layer.has_pending_communication());
+  auto const& output = sum_layer.get_activations();
+  for (El::Int i = 0; i < 4; ++i) {
+    CHECK(output.Get(i, 0) == Approx(num_procs * inputs[i]));
+  }
+
+  // The input layer is the parent, so it waits on the error signals
+  REQUIRE_NOTHROW(m->backward_prop(false));
+  CHECK_FALSE(sum_layer.has_pending_communication());
+  auto const& grad = sum_layer.get_error_signals(sum_layer.get_parent_layer());
+  for (El::Int i = 0; i < 4; ++i) {
+    CHECK(grad.Get(i, 0) == Approx(num_procs * signal[i]));
+  }
+}
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/metrics/async_metric_value.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/metrics/metric.hpp"
+
+#include <chrono>
+#include <limits>
+
+namespace lbann {
+
+async_metric_value::async_metric_value(const async_metric_value& other)
+{
+  for (const auto& [mode, s] : other.m_states) {
+    m_states[mode].last_value = s.last_value;
+    m_states[mode].has_last_value = s.has_last_value;
+  }
+}
+
+async_metric_value&
+async_metric_value::operator=(const async_metric_value& other)
+{
+  if (this != &other) {
+    async_metric_value copy(other);
+    m_states = std::move(copy.m_states);
+  }
+  return *this;
+}
+
+async_metric_value::~async_metric_value()
+{
+  // Let computations finish rather than abandon a running process
+  for (auto& [mode, s] : m_states) {
+    if (s.in_flight.valid()) {
+      s.in_flight.wait();
+    }
+  }
+}
+
+EvalType async_metric_value::evaluate(execution_mode mode,
+                                      int mini_batch_size,
+                                      const function_type& compute)
+{
+  auto& s = m_states[mode];
+  s.num_samples += mini_batch_size;
+  if (!s.launched && !s.in_flight.valid()) {
+    s.in_flight = std::async(std::launch::async, compute);
+    s.launched = true;
+  }
+  return (s.has_last_value ? s.last_value
+                           : std::numeric_limits<EvalType>::quiet_NaN());
+}
+
+void async_metric_value::flush(execution_mode mode,
+                               lbann_comm& comm,
+                               metric_statistics& statistics)
+{
+  auto& s = m_states[mode];
+  if (s.num_samples == 0) {
+    return;
+  }
+
+  // Only take the new value once every rank has it
+  const bool local_ready =
+    (s.in_flight.valid() &&
+     s.in_flight.wait_for(std::chrono::seconds(0)) ==
+       std::future_status::ready);
+  const bool ready = comm.trainer_allreduce<int>(local_ready, El::mpi::MIN);
+  if (ready || (!s.has_last_value && s.in_flight.valid())) {
+    s.last_value = s.in_flight.get();
+    s.has_last_value = true;
+  }
+
+  statistics.add_value(s.last_value * s.num_samples, s.num_samples);
+  s.num_samples = 0;
+  s.launched = false;
+}
+
+} // namespace lbann
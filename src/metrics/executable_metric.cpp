@@ -43,7 +43,8 @@ void executable_metric::serialize(Archive& ar)
   ar(::cereal::make_nvp("Metric", ::cereal::base_class<metric>(this)),
      CEREAL_NVP(m_name),
      CEREAL_NVP(m_filename),
-     CEREAL_NVP(m_other_args));
+     CEREAL_NVP(m_other_args),
+     CEREAL_NVP(m_asynchronous));
 }
 
 std::string executable_metric::name() const { return m_name; }
@@ -118,12 +119,27 @@ static inline EvalType spawn_process_and_read_output(const char* cmd)
 EvalType executable_metric::evaluate(execution_mode mode, int mini_batch_size)
 {
   const auto& start = get_time();
+  if (m_asynchronous) {
+    const EvalType value =
+      m_async_value.evaluate(mode, mini_batch_size, [cmd = m_cmd]() {
+        return spawn_process_and_read_output(cmd.c_str());
+      });
+    get_evaluate_time() += get_time() - start;
+    return value;
+  }
   EvalType value = spawn_process_and_read_output(m_cmd.c_str());
   get_evaluate_time() += get_time() - start;
   get_statistics()[mode].add_value(value * mini_batch_size, mini_batch_size);
   return value;
 }
 
+void executable_metric::flush_accumulated_values(execution_mode mode)
+{
+  if (m_asynchronous) {
+    m_async_value.flush(mode, get_comm(), get_statistics()[mode]);
+  }
+}
+
 bool executable_metric::save_to_checkpoint_shared(persist& p)
 {
   // write out fields we need to save for model
@@ -101,17 +101,37 @@ void layer_metric::setup(model& m)
 EvalType layer_metric::evaluate(execution_mode mode, int mini_batch_size)
 {
   const auto& start = get_time();
-  auto value =
-    dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer())
-      .get_value(false);
-  get_evaluate_time() += get_time() - start;
-  if (m_unit == "%") {
-    value *= 100;
+  auto& eval =
+    dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer());
+  auto value = eval.get_value(false);
+  const EvalType unit_scale = (m_unit == "%" ? 100 : 1);
+  value *= unit_scale;
+  if (eval.get_accumulation_window() > 1) {
+    // Sums arrive a window late; samples are counted every step.
+    const auto accumulated = eval.take_accumulated_value(mode, false).first;
+    get_statistics()[mode].add_value(unit_scale * accumulated,
+                                     mini_batch_size);
+  }
+  else {
+    get_statistics()[mode].add_value(value * mini_batch_size,
+                                     mini_batch_size);
   }
-  get_statistics()[mode].add_value(value * mini_batch_size, mini_batch_size);
+  get_evaluate_time() += get_time() - start;
   return value;
 }
 
+void layer_metric::flush_accumulated_values(execution_mode mode)
+{
+  auto& eval =
+    dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer());
+  if (eval.get_accumulation_window() <= 1) {
+    return;
+  }
+  const EvalType unit_scale = (m_unit == "%" ? 100 : 1);
+  const auto accumulated = eval.take_accumulated_value(mode, true).first;
+  get_statistics()[mode].add_value(unit_scale * accumulated, 0);
+}
+
 /*abstract_evaluation_*/ Layer& layer_metric::get_evaluation_layer()
 {
   auto& l = get_layer();
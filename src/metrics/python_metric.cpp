@@ -46,7 +46,8 @@ void python_metric::serialize(Archive& ar)
      CEREAL_NVP(m_name),
      CEREAL_NVP(m_module),
      CEREAL_NVP(m_module_dir),
-     CEREAL_NVP(m_function));
+     CEREAL_NVP(m_function),
+     CEREAL_NVP(m_asynchronous));
 }
 
 std::string python_metric::name() const { return m_name; }
@@ -88,27 +89,47 @@ void python_metric::setup(model& m)
 #endif
 }
 
-EvalType python_metric::evaluate(execution_mode mode, int mini_batch_size)
+EvalType python_metric::call_function(int rank)
 {
   EvalType value = -999.0;
-  const auto& start = get_time();
 #ifdef LBANN_HAS_EMBEDDED_PYTHON
-  {
-    python::global_interpreter_lock gil;
-    // Call function, convert output reference to EvalType
-    python::object result =
-      PyObject_CallFunction(m_evaluate_function,
-                            "s, i",
-                            m_model_dir.c_str(),
-                            this->get_comm().get_rank_in_trainer());
-    value = static_cast<EvalType>(PyFloat_AsDouble(result));
-  }
+  python::global_interpreter_lock gil;
+  // Call function, convert output reference to EvalType
+  python::object result =
+    PyObject_CallFunction(m_evaluate_function,
+                          "s, i",
+                          m_model_dir.c_str(),
+                          rank);
+  value = static_cast<EvalType>(PyFloat_AsDouble(result));
 #endif
+  return value;
+}
+
+EvalType python_metric::evaluate(execution_mode mode, int mini_batch_size)
+{
+  const auto& start = get_time();
+  const int rank = this->get_comm().get_rank_in_trainer();
+  if (m_asynchronous) {
+    const EvalType value =
+      m_async_value.evaluate(mode, mini_batch_size, [this, rank]() {
+        return call_function(rank);
+      });
+    get_evaluate_time() += get_time() - start;
+    return value;
+  }
+  const EvalType value = call_function(rank);
   get_evaluate_time() += get_time() - start;
   get_statistics()[mode].add_value(value * mini_batch_size, mini_batch_size);
   return value;
 }
 
+void python_metric::flush_accumulated_values(execution_mode mode)
+{
+  if (m_asynchronous) {
+    m_async_value.flush(mode, get_comm(), get_statistics()[mode]);
+  }
+}
+
 bool python_metric::save_to_checkpoint_shared(persist& p)
 {
   // write out fields we need to save for model
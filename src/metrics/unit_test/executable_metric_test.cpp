@@ -130,6 +130,32 @@ TEST_CASE("Executable metric", "[metrics][executable]")
     // Application should print a non-numeric number
     REQUIRE_THROWS(metric->evaluate(lbann::execution_mode::testing, 1));
   }
+  SECTION("asynchronous")
+  {
+    auto m = setup_metric_model(R"""(
+      metric {
+        executable_metric {
+          name: "metric"
+          filename: "src/metrics/unit_test/metric-tester"
+          asynchronous: true
+        }
+      }
+    )""");
+    auto* metric = m->get_metrics()[0];
+    const auto mode = lbann::execution_mode::testing;
+
+    // The first pass launches one run and waits for it when flushed
+    REQUIRE_NOTHROW(metric->evaluate(mode, 1));
+    REQUIRE_NOTHROW(metric->evaluate(mode, 2));
+    REQUIRE_NOTHROW(metric->flush_accumulated_values(mode));
+    CHECK(metric->get_statistics_num_samples(mode) == 3);
+    CHECK(metric->get_mean_value(mode) == 1.4);
+
+    // Later evaluations report the last computed value
+    CHECK(metric->evaluate(mode, 1) == 1.4);
+    REQUIRE_NOTHROW(metric->flush_accumulated_values(mode));
+    CHECK(metric->get_statistics_num_samples(mode) == 4);
+  }
   SECTION("returncode")
   {
     auto m = setup_metric_model(R"""(
@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/models/activation_memory_planner.hpp"
+
+#include "lbann/layers/layer.hpp"
+#include "lbann/models/model.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <unordered_map>
+
+namespace lbann {
+
+namespace {
+
+size_t align_up(size_t bytes)
+{
+  constexpr auto a = activation_memory_planner::alignment;
+  return (bytes + a - 1) / a * a;
+}
+
+bool lifetimes_overlap(activation_memory_planner::tensor_interval const& a,
+                       activation_memory_planner::tensor_interval const& b)
+{
+  return a.birth <= b.death && b.birth <= a.death;
+}
+
+} // namespace
+
+void activation_memory_planner::plan(model const& m,
+                                     El::Int max_mini_batch_size)
+{
+  m_intervals.clear();
+  m_positions.clear();
+
+  const auto layers = m.get_layers();
+  const int num_layers = layers.size();
+  std::unordered_map<Layer const*, int> position;
+  for (int i = 0; i < num_layers; ++i) {
+    position[layers[i]] = i;
+  }
+  // Inference-only models have no backward steps
+  const bool forward_only = m.is_inference_only();
+  auto fp_step = [&](Layer const& l) { return position.at(&l); };
+  auto bp_step = [&](Layer const& l) {
+    return 2 * num_layers - 1 - position.at(&l);
+  };
+
+  // A checkpointed segment reruns forward prop before the backward
+  // prop of its last layer, which reads the segment's inputs and
+  // rewrites its outputs. Both are kept live until that step so no
+  // other tensor takes their place in the meantime.
+  std::unordered_map<int, int> recompute_step;
+  if (!forward_only) {
+    for (auto const* l : layers) {
+      const int segment = m.get_recompute_segment(*l);
+      if (segment >= 0) {
+        recompute_step[segment] = bp_step(*l);
+      }
+    }
+  }
+
+  // Last step at which each activation or a view of it is read.
+  // Children come later in execution order, so sweep backward.
+  std::map<std::pair<Layer const*, int>, int> activation_death;
+  for (int pos = num_layers - 1; pos >= 0; --pos) {
+    auto const& l = *layers[pos];
+    const bool keeps_activations =
+      !forward_only && (l.get_backprop_requirements() & ACTIVATIONS);
+    for (int i = 0; i < l.get_num_children(); ++i) {
+      auto const& child = l.get_child_layer(i);
+      int death = fp_step(child);
+      if (keeps_activations) {
+        death = std::max(death, bp_step(l));
+      }
+      if (!forward_only &&
+          (child.get_backprop_requirements() & PREV_ACTIVATIONS)) {
+        death = std::max(death, bp_step(child));
+      }
+      for (int segment :
+           {m.get_recompute_segment(l), m.get_recompute_segment(child)}) {
+        if (segment >= 0 && !forward_only) {
+          death = std::max(death, recompute_step.at(segment));
+        }
+      }
+      if (child.has_tensor_views()) {
+        for (int k = 0; k < child.get_num_children(); ++k) {
+          death = std::max(death, activation_death.at({&child, k}));
+        }
+      }
+      activation_death[{&l, i}] = death;
+    }
+  }
+
+  // Last step at which each error signal or a view of it is read.
+  // Parents come earlier in execution order, so sweep forward.
+  std::map<std::pair<Layer const*, int>, int> error_signal_death;
+  for (int pos = 0; pos < num_layers; ++pos) {
+    auto const& l = *layers[pos];
+    for (int j = 0; j < l.get_num_parents(); ++j) {
+      auto const& parent = l.get_parent_layer(j);
+      int death = bp_step(parent);
+      if (parent.has_tensor_views()) {
+        for (int k = 0; k < parent.get_num_parents(); ++k) {
+          death = std::max(death, error_signal_death.at({&parent, k}));
+        }
+      }
+      error_signal_death[{&l, j}] = death;
+    }
+  }
+
+  // Collect the tensors the layers let us place
+  for (auto const* l : layers) {
+    for (int i = 0; i < l->get_num_children(); ++i) {
+      tensor_interval t;
+      t.layer = l;
+      t.index = i;
+      t.error_signal = false;
+      t.device = l->get_device_allocation();
+      t.bytes = l->get_plannable_tensor_bytes(i, false, max_mini_batch_size);
+      t.birth = fp_step(*l);
+      t.death = activation_death.at({l, i});
+      if (t.bytes > 0) {
+        m_intervals.push_back(t);
+      }
+    }
+    for (int j = 0; j < l->get_num_parents() && !forward_only; ++j) {
+      tensor_interval t;
+      t.layer = l;
+      t.index = j;
+      t.error_signal = true;
+      t.device = l->get_device_allocation();
+      t.bytes = l->get_plannable_tensor_bytes(j, true, max_mini_batch_size);
+      t.birth = bp_step(*l);
+      t.death = error_signal_death.at({l, j});
+      if (t.bytes > 0) {
+        m_intervals.push_back(t);
+      }
+    }
+  }
+  for (size_t i = 0; i < m_intervals.size(); ++i) {
+    auto const& t = m_intervals[i];
+    m_positions[{t.layer, t.index, t.error_signal}] = i;
+  }
+
+  // Pack each device's tensors and allocate its arena
+  std::vector<tensor_interval*> cpu_intervals, gpu_intervals;
+  for (auto& t : m_intervals) {
+    (t.device == El::Device::CPU ? cpu_intervals : gpu_intervals)
+      .push_back(&t);
+  }
+  const size_t cpu_bytes = assign_offsets(cpu_intervals);
+  m_cpu_arena.allocate(cpu_bytes);
+#ifdef LBANN_HAS_GPU
+  const size_t gpu_bytes = assign_offsets(gpu_intervals);
+  m_gpu_arena.allocate(gpu_bytes);
+#else
+  if (!gpu_intervals.empty()) {
+    LBANN_ERROR("planned GPU tensors in a build without GPU support");
+  }
+#endif // LBANN_HAS_GPU
+}
+
+size_t activation_memory_planner::assign_offsets(
+  std::vector<tensor_interval*> const& intervals)
+{
+  auto order = intervals;
+  std::stable_sort(order.begin(),
+                   order.end(),
+                   [](tensor_interval const* a, tensor_interval const* b) {
+                     return a->bytes > b->bytes;
+                   });
+
+  size_t arena_bytes = 0;
+  std::vector<tensor_interval const*> placed, live;
+  for (auto* t : order) {
+    // Tensors already placed that are live at the same time
+    live.clear();
+    for (auto const* p : placed) {
+      if (lifetimes_overlap(*t, *p)) {
+        live.push_back(p);
+      }
+    }
+    std::sort(live.begin(),
+              live.end(),
+              [](tensor_interval const* a, tensor_interval const* b) {
+                return a->offset < b->offset;
+              });
+
+    // Smallest gap that fits, else the end
+    constexpr auto none = std::numeric_limits<size_t>::max();
+    size_t best_offset = none, best_gap = none, end = 0;
+    for (auto const* p : live) {
+      if (p->offset >= end) {
+        const size_t gap = p->offset - end;
+        if (gap >= t->bytes && gap < best_gap) {
+          best_gap = gap;
+          best_offset = end;
+        }
+      }
+      end = std::max(end, align_up(p->offset + p->bytes));
+    }
+    t->offset = (best_offset == none ? end : best_offset);
+    arena_bytes = std::max(arena_bytes, t->offset + t->bytes);
+    placed.push_back(t);
+  }
+  return arena_bytes;
+}
+
+El::byte* activation_memory_planner::get_buffer(Layer const& l,
+                                                int index,
+                                                bool error_signal,
+                                                size_t bytes) const
+{
+  auto it = m_positions.find({&l, index, error_signal});
+  if (it == m_positions.end()) {
+    return nullptr;
+  }
+  auto const& t = m_intervals[it->second];
+  if (bytes > t.bytes) {
+    return nullptr;
+  }
+#ifdef LBANN_HAS_GPU
+  if (t.device == El::Device::GPU) {
+    return const_cast<El::byte*>(m_gpu_arena.data()) + t.offset;
+  }
+#endif // LBANN_HAS_GPU
+  return const_cast<El::byte*>(m_cpu_arena.data()) + t.offset;
+}
+
+bool activation_memory_planner::contains(void const* ptr) const noexcept
+{
+  auto in = [ptr](El::byte const* begin, size_t size) {
+    return size > 0 && ptr >= begin && ptr < begin + size;
+  };
+#ifdef LBANN_HAS_GPU
+  if (in(m_gpu_arena.data(), m_gpu_arena.size())) {
+    return true;
+  }
+#endif // LBANN_HAS_GPU
+  return in(m_cpu_arena.data(), m_cpu_arena.size());
+}
+
+size_t activation_memory_planner::get_arena_bytes(
+  El::Device device) const noexcept
+{
+#ifdef LBANN_HAS_GPU
+  if (device == El::Device::GPU) {
+    return m_gpu_arena.size();
+  }
+#endif // LBANN_HAS_GPU
+  return device == El::Device::CPU ? m_cpu_arena.size() : 0;
+}
+
+size_t activation_memory_planner::get_unshared_bytes(
+  El::Device device) const noexcept
+{
+  size_t bytes = 0;
+  for (auto const& t : m_intervals) {
+    if (t.device == device) {
+      bytes += t.bytes;
+    }
+  }
+  return bytes;
+}
+
+size_t activation_memory_planner::get_peak_live_bytes(
+  El::Device device) const noexcept
+{
+  int last_step = -1;
+  for (auto const& t : m_intervals) {
+    last_step = std::max(last_step, t.death);
+  }
+  size_t peak = 0;
+  for (int step = 0; step <= last_step; ++step) {
+    size_t bytes = 0;
+    for (auto const& t : m_intervals) {
+      if (t.device == device && t.birth <= step && step <= t.death) {
+        bytes += t.bytes;
+      }
+    }
+    peak = std::max(peak, bytes);
+  }
+  return peak;
+}
+
+void activation_memory_planner::print_report(std::ostream& os) const
+{
+  auto mib = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+  os << "Activation memory plan: " << m_intervals.size()
+     << " tensors placed\n";
+  std::vector<std::pair<El::Device, char const*>> devices = {
+    {El::Device::CPU, "CPU"}};
+#ifdef LBANN_HAS_GPU
+  devices.emplace_back(El::Device::GPU, "GPU");
+#endif // LBANN_HAS_GPU
+  for (auto const& [device, name] : devices) {
+    const auto unshared = get_unshared_bytes(device);
+    if (unshared == 0) {
+      continue;
+    }
+    os << "  " << name << " arena: " << mib(get_arena_bytes(device))
+       << " MiB (unshared " << mib(unshared) << " MiB, peak live "
+       << mib(get_peak_live_bytes(device)) << " MiB)\n";
+  }
+}
+
+} // namespace lbann
@@ -35,6 +35,7 @@
 #include "lbann/data_ingestion/data_store_conduit.hpp"
 #include "lbann/execution_algorithms/execution_context.hpp"
 #include "lbann/io/persist.hpp"
+#include "lbann/io/weights_container.hpp"
 #include "lbann/layers/io/input_layer.hpp"
 #include "lbann/layers/transform/dummy.hpp"
 #include "lbann/layers/transform/evaluation.hpp"
@@ -42,15 +43,18 @@
 #include "lbann/metrics/layer_metric.hpp"
 #include "lbann/objective_functions/layer_term.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/optimizers/gradient_fusion.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/amp.hpp"
 #include "lbann/utils/description.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/graph.hpp"
+#include "lbann/utils/hash.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
 #include "lbann/utils/onnx_utils.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/summary_impl.hpp"
+#include "lbann/weights/weights.hpp"
 
 #include "lbann/proto/model.pb.h"
 #include "lbann/proto/optimizers.pb.h"
@@ -59,13 +63,36 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <map>
 #include <set>
 #include <sstream>
 #include <string>
+#include <typeindex>
 #include <unordered_map>
 
 namespace lbann {
 
+namespace {
+
+/** @brief Whether a layer data type has a half-precision exponent. */
+bool is_fp16_datatype(std::type_index type)
+{
+#ifdef LBANN_HAS_HALF
+  if (type == std::type_index(typeid(cpu_fp16))) {
+    return true;
+  }
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU_FP16
+  if (type == std::type_index(typeid(fp16))) {
+    return true;
+  }
+#endif // LBANN_HAS_GPU_FP16
+  (void)type;
+  return false;
+}
+
+} // namespace
+
 // =============================================
 // Life cycle functions
 // =============================================
@@ -83,16 +110,35 @@ model::model(lbann_comm* comm,
   static El::Int num_models = 0;
   m_name = "model" + std::to_string(num_models);
   num_models++;
+  update_hook_callbacks();
 }
 
 model::model() : model(&utils::get_current_comm(), nullptr, nullptr) {}
 
+model::~model() { clear_layer_streams_(); }
+
 model::model(const model& other)
   : m_execution_context(other.m_execution_context),
     m_comm(other.m_comm),
     m_name(other.m_name),
-    m_model_is_setup(false)
+    m_model_is_setup(false),
+    m_weights_prefetch_lookahead(other.m_weights_prefetch_lookahead),
+    m_weights_prefetch_max_bytes(other.m_weights_prefetch_max_bytes),
+    m_plan_activation_memory(other.m_plan_activation_memory),
+    m_pipeline_parallelism(other.m_pipeline_parallelism),
+    m_flat_weights(other.m_flat_weights),
+    m_capture_gpu_graphs(other.m_capture_gpu_graphs),
+    m_num_layer_streams(other.m_num_layer_streams),
+    m_fuse_layers(other.m_fuse_layers),
+    m_inference_only(other.m_inference_only),
+    m_weights_container_file(other.m_weights_container_file),
+    m_multi_tensor_step(other.m_multi_tensor_step),
+    m_clip_gradient_norm(other.m_clip_gradient_norm),
+    m_metric_accumulation_window(other.m_metric_accumulation_window)
 {
+#ifdef LBANN_HAS_GPU
+  m_forward_stream = other.m_forward_stream;
+#endif // LBANN_HAS_GPU
 
   // Deep copies
   m_default_optimizer_msg =
@@ -109,6 +155,7 @@ model::model(const model& other)
   for (const auto& cb : other.m_callbacks) {
     m_callbacks.emplace_back(cb ? cb->copy() : nullptr);
   }
+  update_hook_callbacks();
 
   // Copy layers
   std::unordered_map<Layer*, ViewingLayerPtr> layer_map;
@@ -155,6 +202,30 @@ model& model::operator=(const model& other)
   m_comm = other.m_comm;
   m_name = other.m_name;
   m_model_is_setup = false;
+  m_plan_activation_memory = other.m_plan_activation_memory;
+  m_activation_memory_planner.reset();
+  m_pipeline_parallelism = other.m_pipeline_parallelism;
+  m_pipeline.reset();
+  m_flat_weights = other.m_flat_weights;
+  m_flat_weights_buffers.clear();
+  m_recompute_segments.clear();
+  m_recompute_segment_ids.clear();
+  m_capture_gpu_graphs = other.m_capture_gpu_graphs;
+#ifdef LBANN_HAS_CUDA
+  m_fp_graph_segments.clear();
+#endif // LBANN_HAS_CUDA
+  m_fp_graph_tensor_layers.clear();
+  m_num_layer_streams = other.m_num_layer_streams;
+  clear_layer_streams_();
+#ifdef LBANN_HAS_GPU
+  m_forward_stream = other.m_forward_stream;
+#endif // LBANN_HAS_GPU
+  m_fuse_layers = other.m_fuse_layers;
+  m_inference_only = other.m_inference_only;
+  m_weights_container_file = other.m_weights_container_file;
+  m_multi_tensor_step = other.m_multi_tensor_step;
+  m_clip_gradient_norm = other.m_clip_gradient_norm;
+  m_metric_accumulation_window = other.m_metric_accumulation_window;
 
   // Deep copies
   m_execution_context = other.m_execution_context;
@@ -170,6 +241,7 @@ model& model::operator=(const model& other)
   for (const auto& cb : other.m_callbacks) {
     m_callbacks.emplace_back(cb ? cb->copy() : nullptr);
   }
+  update_hook_callbacks();
 
   // Copy layers
   std::unordered_map<Layer*, ViewingLayerPtr> layer_map;
@@ -226,6 +298,7 @@ void model::serialize(Archive& ar)
     CEREAL_NVP(m_max_mini_batch_size),
     // CEREAL_NVP(m_current_mini_batch_size),
     CEREAL_NVP(m_amp_enabled),
+    CEREAL_NVP(m_amp_loss_scaling),
     CEREAL_NVP(m_amp_scale_factor),
     CEREAL_NVP(m_amp_growth_factor),
     CEREAL_NVP(m_amp_backoff_factor),
@@ -260,6 +333,9 @@ description model::get_description() const
   // AMP details.
   if (is_amp_enabled()) {
     description amp_desc("Automatic mixed precision: Enabled");
+    if (!m_amp_loss_scaling) {
+      amp_desc.add("Loss scaling", "Disabled");
+    }
     desc.add(amp_desc);
   }
 
@@ -593,6 +669,21 @@ void model::add_callback(std::shared_ptr<callback_base> cb)
                 "\"");
   }
   m_callbacks.emplace_back(std::move(cb));
+  update_hook_callbacks();
+}
+
+void model::set_callbacks(std::vector<std::shared_ptr<callback_base>> callbacks)
+{
+  for (const auto& cb : callbacks) {
+    if (cb == nullptr) {
+      LBANN_ERROR("attempted to add a null pointer as callback to ",
+                  "model \"",
+                  get_name(),
+                  "\"");
+    }
+  }
+  m_callbacks = std::move(callbacks);
+  update_hook_callbacks();
 }
 
 void model::add_metric(std::unique_ptr<metric> m)
@@ -762,6 +853,23 @@ void model::setup(uint64_t max_mini_batch_size,
   // Setup layers
 
   setup_layer_topology();
+  if (m_fuse_layers) {
+    fuse_layers_();
+  }
+
+  // FP16 gradients underflow unless the loss is scaled
+  if (m_amp_enabled && !m_amp_loss_scaling) {
+    for (const auto* l : get_layers()) {
+      if (is_fp16_datatype(l->get_output_datatype())) {
+        LBANN_ERROR("AMP loss scaling is disabled in model \"",
+                    get_name(),
+                    "\", but layer \"",
+                    l->get_name(),
+                    "\" computes in FP16");
+      }
+    }
+  }
+
   setup_layer_execution_order();
   setup_layer_grid_tags(grids_);
 
@@ -779,6 +887,12 @@ void model::setup(uint64_t max_mini_batch_size,
   m_current_mini_batch_size = max_mini_batch_size;
   setup_layers(max_mini_batch_size, grids_);
 
+  // Assign layers to pipeline stages
+  m_pipeline.reset();
+  if (m_pipeline_parallelism) {
+    m_pipeline = std::make_unique<pipeline_parallelism>(*this, grids_);
+  }
+
   // Setup weights
   setup_weights();
 
@@ -789,6 +903,7 @@ void model::setup(uint64_t max_mini_batch_size,
   for (const auto& m : m_metrics) {
     m->setup(*this);
   }
+  set_metric_accumulation_window(m_metric_accumulation_window);
 
   // Set up callbacks
   for (const auto& cb : m_callbacks) {
@@ -800,6 +915,25 @@ void model::setup(uint64_t max_mini_batch_size,
 #ifdef LBANN_HAS_DISTCONV
   setup_distconv();
 #endif
+  setup_redistributions_();
+  print_distributions();
+
+  // The plan keeps the tensors recomputation reads alive
+  setup_recompute_segments_();
+
+  // Plan activation memory once all tensors have their distributions
+  m_activation_memory_planner.reset();
+  if (m_plan_activation_memory && !this->is_subgraph_parallelism_enabled() &&
+      m_pipeline == nullptr) {
+    m_activation_memory_planner = std::make_unique<activation_memory_planner>();
+    m_activation_memory_planner->plan(*this, max_mini_batch_size);
+    if (m_comm->am_trainer_master()) {
+      m_activation_memory_planner->print_report(std::cout);
+    }
+  }
+
+  setup_fp_graph_segments_();
+  setup_layer_streams_();
 
   // Callback hooks at end of setup
   do_setup_end_cbs();
@@ -1146,10 +1280,39 @@ void model::setup_weights()
               return x->get_name().compare(y->get_name()) < 0;
             });
 
+  // Attach weights to a container before they are initialized
+  if (!m_weights_container_file.empty()) {
+    const auto missing =
+      weights_container::attach(m_weights_container_file, get_weights());
+    if (m_comm->am_trainer_master()) {
+      for (const auto& name : missing) {
+        std::cout << "Weights \"" << name << "\" are not in "
+                  << m_weights_container_file << ", using their initializer"
+                  << std::endl;
+      }
+    }
+    m_weights_container_file.clear();
+  }
+
   // Setup weights
   for (auto&& w : m_weights) {
     w->setup();
   }
+
+  // Pack weights into contiguous buffers. Weights that are already
+  // packed are copied out of their old buffers, so those are only
+  // released once the new ones are filled.
+  if (m_flat_weights) {
+    auto buffers = make_flat_weights_buffers(get_weights());
+    m_flat_weights_buffers = std::move(buffers);
+    if (global_argument_parser().get<bool>(LBANN_OPTION_VERBOSE) &&
+        m_comm->am_trainer_master()) {
+      for (const auto& buffer : m_flat_weights_buffers) {
+        std::cout << "Packed " << buffer->num_weights() << " weights into "
+                  << buffer->size_in_bytes() << " bytes" << std::endl;
+      }
+    }
+  }
 }
 
 void model::add_evaluation_layers(std::unordered_set<Layer*>& layer_set,
@@ -1573,6 +1736,11 @@ void model::reset_mode(ExecutionContext& context, execution_mode mode)
     m_execution_context = nullptr;
     return;
   }
+  if (m_inference_only && mode == execution_mode::training) {
+    LBANN_ERROR("model \"",
+                get_name(),
+                "\" was compiled for inference and cannot be trained");
+  }
   m_execution_context = static_cast<observer_ptr<ExecutionContext>>(&context);
   //  set_execution_mode(mode);
   for (El::Int i = 0; i < get_num_layers(); ++i) {
@@ -1583,6 +1751,8 @@ void model::reset_mode(ExecutionContext& context, execution_mode mode)
 // At the end of the epoch, clean up the objective function and metrics
 void model::reset_epoch_statistics(execution_mode mode)
 {
+  // Drain values still being accumulated before clearing them
+  flush_accumulated_metrics(mode);
   get_objective_function()->reset_statistics(mode);
   for (const auto& m : m_metrics) {
     m->reset_statistics(mode);
@@ -1597,6 +1767,28 @@ void model::evaluate_metrics(execution_mode mode,
   }
 }
 
+void model::set_metric_accumulation_window(size_t steps)
+{
+  m_metric_accumulation_window = std::max(steps, size_t{1});
+  for (auto* l : get_layers()) {
+    auto* eval = dynamic_cast<abstract_evaluation_layer<DataType>*>(l);
+    if (eval != nullptr) {
+      eval->set_accumulation_window(m_metric_accumulation_window);
+    }
+  }
+}
+
+void model::flush_accumulated_metrics(execution_mode mode)
+{
+  if (m_metric_accumulation_window > 1) {
+    get_objective_function()->flush_accumulated_values(mode);
+  }
+  // Metrics may also be computed asynchronously
+  for (const auto& m : m_metrics) {
+    m->flush_accumulated_values(mode);
+  }
+}
+
 void model::clear_gradients()
 {
   for (auto&& w : m_weights) {
@@ -1607,6 +1799,26 @@ void model::clear_gradients()
   }
 }
 
+void model::set_gradient_sync_deferred(bool deferred)
+{
+  for (auto&& w : m_weights) {
+    auto&& opt = w->get_optimizer();
+    if (opt != nullptr) {
+      opt->set_gradient_sync_deferred(deferred);
+    }
+  }
+}
+
+void model::scale_gradients(EvalType factor)
+{
+  for (auto&& w : m_weights) {
+    auto&& opt = w->get_optimizer();
+    if (opt != nullptr) {
+      opt->scale_gradient(factor);
+    }
+  }
+}
+
 void model::forward_prop(execution_mode mode, bool skip_callbacks)
 {
   LBANN_CALIPER_MARK_FUNCTION;
@@ -1619,9 +1831,47 @@ void model::forward_prop(execution_mode mode, bool skip_callbacks)
   // Clear layers that will be required in backpropagation
   m_needed_for_backprop.clear();
 
+  // Outside of training, a pipeline runs each mini-batch whole
+  const bool whole_pipeline_pass =
+    m_pipeline != nullptr && mode != execution_mode::training;
+  if (whole_pipeline_pass)
+    m_pipeline->begin_forward(0, false);
+
+  // Start the layer streams after the work already on the default one
+  const bool layer_streams = uses_layer_streams();
+  if (layer_streams)
+    fork_layer_streams_();
+
+#ifdef LBANN_HAS_CUDA
+  // Replay graphs only for full training mini-batches
+  const bool use_fp_graphs =
+    (mode == execution_mode::training && uses_fp_graphs() &&
+     get_current_mini_batch_size() == get_max_mini_batch_size());
+  auto next_graph_segment = m_fp_graph_segments.begin();
+#endif // LBANN_HAS_CUDA
+
   for (El::Int i = 0; i < get_num_layers(); ++i) {
+#ifdef LBANN_HAS_CUDA
+    if (use_fp_graphs && next_graph_segment != m_fp_graph_segments.end() &&
+        next_graph_segment->first == i) {
+      forward_prop_graph_segment_(*next_graph_segment, mode, skip_callbacks);
+      i = next_graph_segment->last;
+      ++next_graph_segment;
+      continue;
+    }
+#endif // LBANN_HAS_CUDA
+
     auto& l = get_layer(i);
 
+    // Layers of other pipeline stages run on other processes
+    if (m_pipeline != nullptr && !m_pipeline->is_in_stage(l)) {
+      if (is_layer_needed_for_backprop(&l))
+        m_needed_for_backprop.insert(&l);
+      continue;
+    }
+
+    prefetch_full_weights_(i, true);
+
     if (this->is_subgraph_parallelism_enabled()) {
       if (l.get_run_layer_in_subgraph()) {
         if (!skip_callbacks)
@@ -1636,9 +1886,14 @@ void model::forward_prop(execution_mode mode, bool skip_callbacks)
       }
     }
     else {
+      if (layer_streams)
+        wait_on_layer_streams_(l, l.get_parent_layers());
       if (!skip_callbacks)
         do_layer_forward_prop_begin_cbs(mode, &l);
-      l.forward_prop();
+      if (m_pipeline == nullptr || !m_pipeline->restore_outputs(l))
+        l.forward_prop();
+      if (m_pipeline != nullptr)
+        m_pipeline->send_outputs(l);
       if (!skip_callbacks)
         do_layer_forward_prop_end_cbs(mode, &l);
     }
@@ -1646,6 +1901,15 @@ void model::forward_prop(execution_mode mode, bool skip_callbacks)
     if (is_layer_needed_for_backprop(&l))
       m_needed_for_backprop.insert(&l);
   }
+  // Outputs of the last layers are read by the objective function
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    get_layer(i).finish_pending_communication();
+  }
+  // With a forward stream the caller joins, so that models overlap
+  if (layer_streams && !m_borrows_layer_stream)
+    join_layer_streams_();
+  if (whole_pipeline_pass)
+    m_pipeline->end_mini_batch();
   if (!skip_callbacks)
     do_model_forward_prop_end_cbs(mode);
 }
@@ -1656,6 +1920,8 @@ void model::backward_prop(bool compute_weight_grads_only, bool skip_callbacks)
 
   // Layers disabled due to not propagating error signals through
   std::unordered_set<const Layer*> disabled_layers;
+  // Layers skipped for any reason, when run as a pipeline
+  std::unordered_set<const Layer*> pipeline_skipped_layers;
   auto const& arg_parser = global_argument_parser();
   bool const envvar_disable_layers =
     !arg_parser.get<bool>(LBANN_OPTION_NO_BACKPROP_DISABLE);
@@ -1663,6 +1929,14 @@ void model::backward_prop(bool compute_weight_grads_only, bool skip_callbacks)
   if (!skip_callbacks)
     do_model_backward_prop_begin_cbs();
 
+  // Segment whose activations have been recomputed
+  int recomputed_segment = -1;
+
+  // Start the layer streams after the objective function's gradients
+  const bool layer_streams = uses_layer_streams();
+  if (layer_streams)
+    fork_layer_streams_();
+
   for (El::Int i = get_num_layers() - 1; i >= 0; --i) {
 
     // Perform backward prop step on current layer
@@ -1701,6 +1975,37 @@ void model::backward_prop(bool compute_weight_grads_only, bool skip_callbacks)
       }
     }
 
+    // Layers of other pipeline stages run on other processes
+    if (m_pipeline != nullptr) {
+      if (!enable_layer)
+        pipeline_skipped_layers.insert(&l);
+      if (!m_pipeline->is_in_stage(l))
+        continue;
+    }
+
+    // Recompute the activations of a checkpointed segment before the
+    // first of its layers runs backprop. Disabled layers above it in
+    // the segment are not recomputed.
+    const int segment = get_recompute_segment(l);
+    if (enable_layer && segment >= 0 && segment != recomputed_segment) {
+      recompute_segment_(segment, i);
+      recomputed_segment = segment;
+    }
+
+    if (enable_layer) {
+      prefetch_full_weights_(i, false);
+    }
+
+    // Error signals are only needed by parents that run backprop
+    bool error_signals_needed = !envvar_disable_layers ||
+                                !compute_weight_grads_only ||
+                                m_needed_for_backprop.empty();
+    for (int j = 0; j < l.get_num_parents() && !error_signals_needed; ++j) {
+      error_signals_needed =
+        m_needed_for_backprop.count(&l.get_parent_layer(j)) > 0;
+    }
+    l.set_error_signals_needed(error_signals_needed);
+
     if (this->is_subgraph_parallelism_enabled()) {
       if (l.get_run_layer_in_subgraph()) {
         if (!skip_callbacks)
@@ -1716,14 +2021,21 @@ void model::backward_prop(bool compute_weight_grads_only, bool skip_callbacks)
       }
     }
     else {
+      if (layer_streams)
+        wait_on_layer_streams_(l, l.get_child_layers());
       if (!skip_callbacks)
         do_layer_backward_prop_begin_cbs(&l);
+      if (enable_layer && m_pipeline != nullptr)
+        m_pipeline->receive_error_signals(l, pipeline_skipped_layers);
       if (enable_layer)
         l.back_prop();
       if (!skip_callbacks)
         do_layer_backward_prop_end_cbs(&l);
     }
 
+    // Keep the gradient allreduces launched so far moving
+    progress_gradient_fusion_buckets(*m_comm);
+
     // Terminate early if all gradients have been computed
     bool all_gradients_computed = true;
     for (auto&& w : m_weights) {
@@ -1741,181 +2053,928 @@ void model::backward_prop(bool compute_weight_grads_only, bool skip_callbacks)
 
     // Tim or Tom: What is your suggestation?
     if (compute_weight_grads_only && all_gradients_computed &&
-        this->is_subgraph_parallelism_enabled() == false) {
+        this->is_subgraph_parallelism_enabled() == false &&
+        m_pipeline == nullptr) {
       break;
     }
   }
 
+  // Error signals of layers whose parents did not run are delivered
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    get_layer(i).finish_pending_communication();
+  }
+
+  // Later work on the default stream sees every layer's gradients
+  if (layer_streams)
+    join_layer_streams_();
+
+  // Send the gradients left in partially filled fusion buckets
+  flush_gradient_fusion_buckets(*m_comm);
+
+  // Drop weights prefetched for layers that ended up not running
+  if (m_weights_prefetch_lookahead > 0) {
+    for (auto const& w : m_weights) {
+      w->release_full_weights();
+    }
+  }
+
   if (!skip_callbacks)
     do_model_backward_prop_end_cbs();
 }
 
-void model::update_weights()
+void model::fuse_layers_()
 {
-  LBANN_CALIPER_MARK_FUNCTION;
-  do_model_optimize_begin_cbs();
-
-  // AMP: Check gradients for NaNs and infinities.
-  // If any are found, this iteration will be skipped.
-  // If not, the gradients will be unscaled.
-  bool skip_step = false;
-  if (is_amp_enabled()) {
-    std::vector<optimizer*> optimizers;
-    for (auto rit = m_weights.rbegin(); rit != m_weights.rend(); ++rit) {
-      auto& w = **rit;
-      auto&& opt = w.get_optimizer();
-      if (opt != nullptr) {
-        optimizers.push_back(opt);
-      }
+  // Layers that others take their dimensions from are kept
+  std::unordered_set<Layer const*> hint_layers;
+  for (auto const* l : get_layers()) {
+    if (l->get_hint_layer() != nullptr) {
+      hint_layers.insert(l->get_hint_layer());
     }
-    skip_step = !amp::is_finite_and_unscale_all(optimizers, m_amp_scale_factor);
   }
 
-  if (!skip_step) {
-    // Apply optimization step to weights
-    // Note: Heuristically, forward prop consumes weights in the same
-    // order as m_weights and backprop computes weights gradients in
-    // reverse order. Also, we often launch a non-blocking allreduce
-    // after a weights gradient has been computed. Thus, iterating in
-    // reverse order will use gradients that have already finished their
-    // allreduce, giving more time for more recent allreduces to finish.
-    for (auto rit = m_weights.rbegin(); rit != m_weights.rend(); ++rit) {
-      auto& w = **rit;
-      auto&& opt = w.get_optimizer();
+  // A rejected pair stays rejected after other fusions, so one pass
+  // over the layer list is enough
+  std::map<std::string, std::vector<std::string>> fused_names;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto& child = get_layer(i);
+    if (child.get_num_parents() < 1 || child.get_num_children() != 1 ||
+        child.is_checkpointed() || child.get_hint_layer() != nullptr ||
+        hint_layers.count(&child) > 0 || child.distconv_enabled()) {
+      continue;
+    }
+
+    // Any input of the child may take it over. The child's other
+    // inputs must not already feed that parent.
+    Layer* parent = nullptr;
+    for (int p = 0; p < child.get_num_parents() && parent == nullptr; ++p) {
+      auto& candidate = const_cast<Layer&>(child.get_parent_layer(p));
+      if (candidate.get_num_children() != 1 || candidate.is_checkpointed() ||
+          candidate.get_grid_tag() != child.get_grid_tag() ||
+          candidate.distconv_enabled()) {
+        continue;
+      }
+      auto const candidate_parents = candidate.get_parent_layers();
+      bool const shares_input =
+        std::any_of(candidate_parents.cbegin(),
+                    candidate_parents.cend(),
+                    [&child](Layer const* l) {
+                      auto const siblings = child.get_parent_layers();
+                      return std::find(siblings.cbegin(),
+                                       siblings.cend(),
+                                       l) != siblings.cend();
+                    });
+      if (!shares_input && candidate.fuse_child(child)) {
+        parent = &candidate;
+      }
+    }
+    if (parent == nullptr) {
+      // Otherwise the child may take over an input that only feeds it
+      if (child.get_num_parents() != 1) {
+        continue;
+      }
+      auto& input = const_cast<Layer&>(child.get_parent_layer(0));
+      if (input.get_num_parents() != 1 || input.get_num_children() != 1 ||
+          input.is_checkpointed() || input.get_hint_layer() != nullptr ||
+          hint_layers.count(&input) > 0 ||
+          input.get_grid_tag() != child.get_grid_tag() ||
+          input.distconv_enabled() || !child.fuse_parent(input)) {
+        continue;
+      }
+      auto const input_name = input.get_name();
+      auto& names = fused_names[child.get_name()];
+      names.push_back(input_name);
+      auto const iter = fused_names.find(input_name);
+      if (iter != fused_names.end()) {
+        names.insert(names.end(), iter->second.cbegin(), iter->second.cend());
+        fused_names.erase(iter);
+      }
+      remove_layer(input_name);
+      --i;
+      continue;
+    }
 
-      if (opt != nullptr) {
-        do_weight_optimize_begin_cbs(&w);
-        opt->step();
-        do_weight_optimize_end_cbs(&w);
+    // The child's other inputs now feed the parent, in order
+    if (child.get_num_parents() > 1) {
+      auto const parent_ptr =
+        child.get_parent_layer_pointer(child.find_parent_layer_index(*parent));
+      for (int p = 0; p < child.get_num_parents(); ++p) {
+        auto& other = const_cast<Layer&>(child.get_parent_layer(p));
+        if (&other == parent) {
+          continue;
+        }
+        other.replace_child_layer(parent_ptr,
+                                  other.find_child_layer_index(child));
+        parent->add_parent_layer(child.get_parent_layer_pointer(p));
       }
+      child.clear_parent_layers();
+      child.add_parent_layer(parent_ptr);
     }
+
+    auto const child_name = child.get_name();
+    auto& names = fused_names[parent->get_name()];
+    names.push_back(child_name);
+    auto const iter = fused_names.find(child_name);
+    if (iter != fused_names.end()) {
+      names.insert(names.end(), iter->second.cbegin(), iter->second.cend());
+      fused_names.erase(iter);
+    }
+    remove_layer(child_name);
+    --i;
   }
 
-  // AMP: Update loss scale.
-  if (is_amp_enabled()) {
-    if (skip_step) {
-      m_amp_cur_steps = 0;
-      ++m_amp_cur_skipped_steps;
-      // Keep scale factor to the smallest positive normalized value for
-      // floats. Even when EvalType is double, we may cast to float.
-      m_amp_scale_factor =
-        std::max(static_cast<EvalType>(std::numeric_limits<float>::min()),
-                 m_amp_scale_factor * m_amp_backoff_factor);
-      // Warn if we've been skipping too many steps.
-      // Check exact number to avoid printing repeatedly.
-      if (m_amp_cur_skipped_steps == 10) {
-        LBANN_WARNING("AMP skipped ten steps in a row, your model may have "
-                      "issues with AMP");
+  if (m_comm->am_trainer_master() && !fused_names.empty()) {
+    std::ostringstream ss;
+    ss << "model \"" << get_name() << "\" fused layers:\n";
+    for (auto const& [name, children] : fused_names) {
+      ss << "  " << name << " <-";
+      for (auto const& child_name : children) {
+        ss << " " << child_name;
       }
+      ss << "\n";
     }
-    else {
-      if (m_amp_cur_steps + 1 == m_amp_growth_interval) {
-        m_amp_cur_steps = 0;
-        m_amp_cur_skipped_steps = 0;
-        // Prevent scale factor from overflowing to inf when cast to
-        // float.
-        m_amp_scale_factor =
-          std::min(static_cast<EvalType>(std::numeric_limits<float>::max()),
-                   m_amp_scale_factor * m_amp_growth_factor);
+    std::cout << ss.str();
+  }
+}
+
+void model::compile_for_inference(const std::vector<El::Grid*>& grids)
+{
+  if (!m_model_is_setup) {
+    LBANN_ERROR("model \"",
+                get_name(),
+                "\" must be set up before it is compiled for inference");
+  }
+  if (m_inference_only) {
+    return;
+  }
+
+  const auto removed_names = remove_inference_identities_();
+  const auto folded_names = fold_layers_into_weights_();
+
+  // Nothing will be trained, so optimizers and their state can go
+  for (auto* l : get_layers()) {
+    l->freeze();
+  }
+  for (auto* w : get_weights()) {
+    w->freeze();
+    w->set_optimizer(nullptr);
+  }
+  m_inference_only = true;
+
+  // Set up again for the new graph, without error signals
+  setup(m_max_mini_batch_size, grids, true);
+
+  if (m_comm->am_trainer_master()) {
+    std::ostringstream ss;
+    ss << "model \"" << get_name() << "\" compiled for inference\n";
+    for (auto const& [name, children] : folded_names) {
+      ss << "  folded into " << name << ":";
+      for (auto const& child_name : children) {
+        ss << " " << child_name;
       }
-      else {
-        ++m_amp_cur_steps;
+      ss << "\n";
+    }
+    if (!removed_names.empty()) {
+      ss << "  removed:";
+      for (auto const& name : removed_names) {
+        ss << " " << name;
       }
+      ss << "\n";
     }
-    get_objective_function()->set_amp_scale(m_amp_scale_factor);
+    std::cout << ss.str();
   }
-
-  do_model_optimize_end_cbs();
 }
 
-bool model::update_layers()
+std::vector<std::string> model::remove_inference_identities_()
 {
-  bool finished = true;
-  for (El::Int i = get_num_layers() - 1; i >= 0; --i) {
-    finished = get_layer(i).update() && finished;
+  // Layers that others take their dimensions from are kept
+  std::unordered_set<Layer const*> hint_layers;
+  for (auto const* l : get_layers()) {
+    if (l->get_hint_layer() != nullptr) {
+      hint_layers.insert(l->get_hint_layer());
+    }
   }
-  return finished;
+
+  std::vector<std::string> removed_names;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto& l = get_layer(i);
+    auto const type = l.get_type();
+    if ((type != "dropout" && type != "identity") ||
+        l.get_num_parents() != 1 || l.get_num_children() != 1 ||
+        l.get_hint_layer() != nullptr || hint_layers.count(&l) > 0 ||
+        l.distconv_enabled()) {
+      continue;
+    }
+    auto const& parent = l.get_parent_layer(0);
+    auto const& child = l.get_child_layer(0);
+    auto const siblings = child.get_parent_layers();
+    if (parent.get_grid_tag() != l.get_grid_tag() ||
+        child.get_grid_tag() != l.get_grid_tag() ||
+        std::find(siblings.cbegin(), siblings.cend(), &parent) !=
+          siblings.cend()) {
+      continue;
+    }
+    auto const name = l.get_name();
+    remove_layer(name);
+    removed_names.push_back(name);
+    --i;
+  }
+  return removed_names;
 }
 
-void model::reconcile_weight_values()
+std::map<std::string, std::vector<std::string>>
+model::fold_layers_into_weights_()
 {
-  LBANN_ERROR("This should not be called. Method is a candidate for removal");
-  // Launch non-blocking communication to reconcile weights
-  // Note: Heuristically, forward prop consumes weights in the same
-  // order as m_weights. Also, weights tend to get larger as you get
-  // deeper into a neural network. Thus, iterating in reverse order
-  // means that we perform the expensive communication first, covering
-  // up the launch overheads for the subsequent cheap communication.
-  std::vector<Al::request> reqs;
-  reqs.reserve(m_weights.size());
-  for (auto rit = m_weights.rbegin(); rit != m_weights.rend(); ++rit) {
-    auto& w = **rit;
-    reqs.emplace_back();
-    w.reconcile_values(reqs.back());
+  // Weights used by more than one layer cannot be changed for one
+  std::unordered_map<weights const*, int> num_users;
+  for (auto const* l : get_layers()) {
+    for (auto const& w : l->get_weights_pointers()) {
+      if (auto const ptr = w.lock()) {
+        ++num_users[ptr.get()];
+      }
+    }
+  }
+  auto const shares_weights = [&num_users](Layer const& l) {
+    for (auto const& w : l.get_weights_pointers()) {
+      auto const ptr = w.lock();
+      if (ptr != nullptr && num_users[ptr.get()] > 1) {
+        return true;
+      }
+    }
+    return false;
+  };
+  std::unordered_set<Layer const*> hint_layers;
+  for (auto const* l : get_layers()) {
+    if (l->get_hint_layer() != nullptr) {
+      hint_layers.insert(l->get_hint_layer());
+    }
   }
 
-  // Wait for communication to finish
-  for (auto& req : reqs) {
-    m_comm->wait(req);
+  std::map<std::string, std::vector<std::string>> folded_names;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto& child = get_layer(i);
+    if (child.get_num_parents() != 1 || child.get_num_children() != 1 ||
+        child.get_hint_layer() != nullptr || hint_layers.count(&child) > 0 ||
+        child.distconv_enabled() || shares_weights(child)) {
+      continue;
+    }
+    auto& parent = const_cast<Layer&>(child.get_parent_layer(0));
+    if (parent.get_num_children() != 1 ||
+        parent.get_grid_tag() != child.get_grid_tag() ||
+        parent.distconv_enabled() || shares_weights(parent) ||
+        !parent.fold_child_into_weights(child)) {
+      continue;
+    }
+    auto const child_name = child.get_name();
+    remove_layer(child_name);
+    folded_names[parent.get_name()].push_back(child_name);
+    --i;
   }
+  return folded_names;
 }
 
-void model::enable_amp(EvalType init_scale_factor,
-                       EvalType growth_factor,
-                       EvalType backoff_factor,
-                       size_t growth_interval)
+void model::setup_recompute_segments_()
 {
-  m_amp_enabled = true;
-  m_amp_scale_factor = init_scale_factor;
-  m_amp_growth_factor = growth_factor;
-  m_amp_backoff_factor = backoff_factor;
-  m_amp_growth_interval = growth_interval;
-}
+  m_recompute_segments.clear();
+  m_recompute_segment_ids.clear();
 
-// =============================================
-// Callbacks
-// =============================================
+  // Input layers would fetch new data, and layers that are random or
+  // keep running statistics would not reproduce their outputs
+  bool segment_open = false;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto& l = get_layer(i);
+    bool recompute = l.is_checkpointed();
+    if (recompute &&
+        (!l.supports_recomputation() || l.get_num_parents() == 0 ||
+         l.distconv_enabled() || this->is_subgraph_parallelism_enabled() ||
+         m_pipeline != nullptr)) {
+      if (m_comm->am_trainer_master()) {
+        LBANN_WARNING("layer \"",
+                      l.get_name(),
+                      "\" (",
+                      l.get_type(),
+                      ") cannot be recomputed, ignoring its checkpoint flag");
+      }
+      recompute = false;
+    }
+    if (!recompute) {
+      segment_open = false;
+      continue;
+    }
+    if (!segment_open) {
+      m_recompute_segments.emplace_back(i, i);
+      segment_open = true;
+    }
+    m_recompute_segments.back().second = i;
+    m_recompute_segment_ids[&l] = m_recompute_segments.size() - 1;
+  }
+}
 
-void model::do_setup_end_cbs()
+int model::get_recompute_segment(Layer const& l) const
 {
-  for (const auto& cb : m_callbacks) {
-    cb->on_setup_end(this);
-  }
+  auto const iter = m_recompute_segment_ids.find(&l);
+  return (iter != m_recompute_segment_ids.end() ? iter->second : -1);
 }
 
-void model::do_model_forward_prop_begin_cbs(execution_mode mode)
+void model::recompute_segment_(int segment, El::Int last)
 {
-  for (const auto& cb : m_callbacks) {
-    switch (mode) {
-    case execution_mode::training:
-      if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
-        cb->on_forward_prop_begin(this);
-      }
-      break;
-    case execution_mode::validation:
-    case execution_mode::tournament:
-    case execution_mode::testing:
-      cb->on_evaluate_forward_prop_begin(this);
-      break;
-    default:
-      LBANN_ERROR("invalid execution mode");
-    }
+  LBANN_CALIPER_MARK_FUNCTION;
+  m_recomputing_activations = true;
+  for (El::Int i = m_recompute_segments[segment].first; i <= last; ++i) {
+    prefetch_full_weights_(i, true);
+    get_layer(i).forward_prop();
   }
+  m_recomputing_activations = false;
 }
 
-void model::do_model_forward_prop_end_cbs(execution_mode mode)
+void model::setup_fp_graph_segments_()
 {
-  for (const auto& cb : m_callbacks) {
+  m_fp_graph_tensor_layers.clear();
+#ifdef LBANN_HAS_CUDA
+  m_fp_graph_segments.clear();
+  if (!m_capture_gpu_graphs || this->is_subgraph_parallelism_enabled() ||
+      m_pipeline != nullptr) {
+    return;
+  }
+
+  // Layers with weights are left out since their forward prop also
+  // updates weights proxies and gradient sources
+  bool segment_open = false;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto const& l = get_layer(i);
+    const bool capture =
+      (l.supports_graph_capture() &&
+       l.get_device_allocation() == El::Device::GPU &&
+       l.get_num_parents() > 0 && l.num_weights() == 0 &&
+       l.is_participating() && !l.distconv_enabled() &&
+       get_recompute_segment(l) < 0);
+    if (!capture) {
+      segment_open = false;
+      continue;
+    }
+    if (!segment_open) {
+      m_fp_graph_segments.emplace_back();
+      m_fp_graph_segments.back().first = i;
+      segment_open = true;
+    }
+    m_fp_graph_segments.back().last = i;
+  }
+
+  // Replayed graphs keep using the buffers they were captured with,
+  // so the tensors they touch must outlive their last eager use
+  for (auto const& segment : m_fp_graph_segments) {
+    for (El::Int i = segment.first; i <= segment.last; ++i) {
+      auto const& l = get_layer(i);
+      m_fp_graph_tensor_layers.insert(&l);
+      for (auto const* parent : l.get_parent_layers()) {
+        m_fp_graph_tensor_layers.insert(parent);
+      }
+    }
+  }
+#else
+  if (m_capture_gpu_graphs && m_comm->am_trainer_master()) {
+    LBANN_WARNING("GPU graph capture requires CUDA, running eagerly");
+  }
+#endif // LBANN_HAS_CUDA
+}
+
+bool model::uses_fp_graphs() const noexcept
+{
+#ifdef LBANN_HAS_CUDA
+  return !m_fp_graph_segments.empty();
+#else
+  return false;
+#endif // LBANN_HAS_CUDA
+}
+
+#ifdef LBANN_HAS_CUDA
+void model::forward_prop_graph_segment_(fp_graph_segment& segment,
+                                        execution_mode mode,
+                                        bool skip_callbacks)
+{
+  LBANN_CALIPER_MARK_FUNCTION;
+
+  // Set up tensors and host state without running the compute
+  m_fp_compute_deferred = true;
+  for (El::Int i = segment.first; i <= segment.last; ++i) {
+    auto& l = get_layer(i);
+    if (!skip_callbacks)
+      do_layer_forward_prop_begin_cbs(mode, &l);
+    l.forward_prop();
+  }
+  m_fp_compute_deferred = false;
+
+  // Recapture if the mini-batch size or any buffer has changed
+  size_t signature = hash_combine(size_t{0}, get_current_mini_batch_size());
+  for (El::Int i = segment.first; i <= segment.last; ++i) {
+    signature =
+      hash_combine(signature, get_layer(i).get_fp_tensor_signature());
+  }
+  auto const stream = El::SyncInfo<El::Device::GPU>{}.Stream();
+  if (segment.graph.get() == nullptr || segment.signature != signature) {
+    cuda::Graph::begin_capture(stream);
+    for (El::Int i = segment.first; i <= segment.last; ++i) {
+      get_layer(i).fp_compute();
+    }
+    auto graph = cuda::Graph::end_capture(stream);
+    segment.graph.update(graph);
+    segment.signature = signature;
+  }
+  segment.graph.launch(stream);
+
+  // End callbacks are ordered after the segment's compute
+  for (El::Int i = segment.first; i <= segment.last; ++i) {
+    auto& l = get_layer(i);
+    if (!skip_callbacks)
+      do_layer_forward_prop_end_cbs(mode, &l);
+    if (is_layer_needed_for_backprop(&l))
+      m_needed_for_backprop.insert(&l);
+  }
+}
+#endif // LBANN_HAS_CUDA
+
+void model::setup_layer_streams_()
+{
+  clear_layer_streams_();
+#ifdef LBANN_HAS_GPU
+  const bool forward_stream = m_forward_stream.has_value();
+#else
+  const bool forward_stream = false;
+#endif // LBANN_HAS_GPU
+  if (m_num_layer_streams <= 1 && !forward_stream) {
+    return;
+  }
+#if defined(LBANN_HAS_GPU) && !defined(LBANN_DETERMINISTIC)
+  if (this->is_subgraph_parallelism_enabled() || uses_fp_graphs() ||
+      !m_recompute_segments.empty() || m_pipeline != nullptr) {
+    if (m_comm->am_trainer_master()) {
+      LBANN_WARNING("layer streams are not used with sub-graph parallelism, ",
+                    "GPU graph capture, activation checkpointing or ",
+                    "pipeline parallelism");
+    }
+    return;
+  }
+
+  if (forward_stream) {
+    // Every GPU layer runs on the caller's stream
+    m_layer_sync_infos.push_back(*m_forward_stream);
+    m_borrows_layer_stream = true;
+    for (auto* l : get_layers()) {
+      if (l->get_device_allocation() == El::Device::GPU &&
+          !l->distconv_enabled()) {
+        m_layer_stream_ids[l] = 1;
+      }
+    }
+  }
+  else {
+    // Layer graph in execution order
+    const El::Int num_layers = get_num_layers();
+    std::set<El::Int> nodes;
+    std::map<El::Int, std::set<El::Int>> edges;
+    std::unordered_map<Layer const*, El::Int> layer_indices;
+    for (El::Int node = 0; node < num_layers; ++node) {
+      nodes.insert(node);
+      layer_indices[&get_layer(node)] = node;
+    }
+    for (El::Int node = 0; node < num_layers; ++node) {
+      for (auto const* child : get_layer(node).get_child_layers()) {
+        edges[node].insert(layer_indices[child]);
+      }
+    }
+    const auto streams =
+      graph::assign_streams(nodes,
+                            edges,
+                            static_cast<int>(m_num_layer_streams));
+
+    // Distconv and host layers stay on the default stream
+    for (El::Int node = 0; node < num_layers; ++node) {
+      auto& l = get_layer(node);
+      const size_t stream = streams.at(node);
+      if (stream == 0 || l.get_device_allocation() != El::Device::GPU ||
+          l.distconv_enabled()) {
+        continue;
+      }
+      while (m_layer_sync_infos.size() <= stream) {
+        m_layer_sync_infos.push_back(
+          El::CreateNewSyncInfo<El::Device::GPU>());
+      }
+      m_layer_stream_ids[&l] = stream;
+    }
+  }
+
+  // Error signals may be read on another stream after the layer that
+  // produced them has finished
+  if (uses_layer_streams()) {
+    for (auto* l : get_layers()) {
+      l->set_keep_error_signals(true);
+    }
+  }
+#else
+  if (m_comm->am_trainer_master()) {
+    LBANN_WARNING("layer streams require a GPU build without "
+                  "LBANN_DETERMINISTIC, running on one stream");
+  }
+#endif // defined(LBANN_HAS_GPU) && !defined(LBANN_DETERMINISTIC)
+}
+
+void model::clear_layer_streams_()
+{
+#ifdef LBANN_HAS_GPU
+  // A forward stream belongs to the caller
+  for (size_t i = (m_borrows_layer_stream ? 2 : 1);
+       i < m_layer_sync_infos.size();
+       ++i) {
+    El::DestroySyncInfo(m_layer_sync_infos[i]);
+  }
+  m_layer_sync_infos.resize(1);
+  m_layer_stream_ids.clear();
+#endif // LBANN_HAS_GPU
+  m_borrows_layer_stream = false;
+}
+
+bool model::uses_layer_streams() const noexcept
+{
+#ifdef LBANN_HAS_GPU
+  return !m_layer_stream_ids.empty();
+#else
+  return false;
+#endif // LBANN_HAS_GPU
+}
+
+#ifdef LBANN_HAS_GPU
+El::SyncInfo<El::Device::GPU> const*
+model::get_layer_sync_info(Layer const& l) const
+{
+  auto const iter = m_layer_stream_ids.find(&l);
+  return (iter != m_layer_stream_ids.end() ? &m_layer_sync_infos[iter->second]
+                                           : nullptr);
+}
+#endif // LBANN_HAS_GPU
+
+void model::fork_layer_streams_() const
+{
+#ifdef LBANN_HAS_GPU
+  for (size_t i = 1; i < m_layer_sync_infos.size(); ++i) {
+    El::AddSynchronizationPoint(m_layer_sync_infos.front(),
+                                m_layer_sync_infos[i]);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void model::join_layer_streams_() const
+{
+#ifdef LBANN_HAS_GPU
+  for (size_t i = 1; i < m_layer_sync_infos.size(); ++i) {
+    El::AddSynchronizationPoint(m_layer_sync_infos[i],
+                                m_layer_sync_infos.front());
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void model::wait_on_layer_streams_(Layer const& l,
+                                   std::vector<Layer const*> const& deps) const
+{
+#ifdef LBANN_HAS_GPU
+  auto stream_of = [this](Layer const& layer) {
+    auto const* sync_info = get_layer_sync_info(layer);
+    return (sync_info != nullptr ? sync_info : &get_default_sync_info());
+  };
+  auto const* stream = stream_of(l);
+  std::set<El::SyncInfo<El::Device::GPU> const*> waited;
+  for (auto const* dep : deps) {
+    auto const* dep_stream = stream_of(*dep);
+    if (dep_stream != stream && waited.insert(dep_stream).second) {
+      El::AddSynchronizationPoint(*dep_stream, *stream);
+    }
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void model::set_weights_prefetch(size_t lookahead, size_t max_bytes) noexcept
+{
+  m_weights_prefetch_lookahead = lookahead;
+  m_weights_prefetch_max_bytes = max_bytes;
+}
+
+void model::prefetch_full_weights_(El::Int i, bool forward) const
+{
+  if (m_weights_prefetch_lookahead == 0) {
+    return;
+  }
+
+  // Walk the upcoming layers in execution order, counting weights
+  // already gathered against the cap so it bounds the whole window
+  const El::Int step = forward ? 1 : -1;
+  size_t bytes = 0;
+  for (size_t k = 1; k <= m_weights_prefetch_lookahead; ++k) {
+    const El::Int j = i + step * static_cast<El::Int>(k);
+    if (j < 0 || j >= get_num_layers()) {
+      break;
+    }
+    auto const& l = get_layer(j);
+    if (!l.is_participating() || (this->is_subgraph_parallelism_enabled() &&
+                                  !l.get_run_layer_in_subgraph())) {
+      continue;
+    }
+    for (size_t w = 0; w < l.num_weights(); ++w) {
+      auto const& weights = l.get_weights(w);
+      if (!weights.is_sharded()) {
+        continue;
+      }
+      const size_t size = weights.get_full_weights_bytes();
+      if (!weights.has_full_weights()) {
+        if (m_weights_prefetch_max_bytes > 0 &&
+            bytes + size > m_weights_prefetch_max_bytes) {
+          return;
+        }
+        weights.request_full_weights_async();
+      }
+      bytes += size;
+    }
+  }
+}
+
+void model::update_weights()
+{
+  LBANN_CALIPER_MARK_FUNCTION;
+  do_model_optimize_begin_cbs();
+
+  // AMP: Check gradients for NaNs and infinities.
+  // If any are found, this iteration will be skipped.
+  // If not, the gradients will be unscaled.
+  // Without loss scaling there is nothing to unscale, and skipping
+  // the check avoids waiting on the device.
+  const bool amp_loss_scaling = is_amp_enabled() && m_amp_loss_scaling;
+  std::vector<optimizer*> optimizers;
+  // Device-side results can only be handed to optimizers whose GPU
+  // kernels read them (see optimizer::set_step_scale)
+  bool all_support_step_scale = true;
+  for (auto rit = m_weights.rbegin(); rit != m_weights.rend(); ++rit) {
+    auto& w = **rit;
+    auto&& opt = w.get_optimizer();
+    if (opt != nullptr) {
+      optimizers.push_back(opt);
+      all_support_step_scale &= opt->supports_step_scale();
+    }
+  }
+#ifdef LBANN_HAS_GPU
+  // AMP: Read the previous step's device-side result, whose copy
+  // finished long ago. If that step was skipped, rewind the host-side
+  // optimizer state it advanced before anything uses it.
+  bool prev_amp_result = false;
+  bool prev_skip_step = false;
+  if (m_amp_is_finite_pending) {
+    m_amp_is_finite_event.synchronize();
+    m_amp_is_finite_pending = false;
+    prev_amp_result = true;
+    prev_skip_step = m_amp_is_finite_host(0, 0) != 1.0f;
+    if (prev_skip_step) {
+      for (auto* opt : optimizers) {
+        opt->undo_skipped_step();
+      }
+    }
+  }
+#endif // LBANN_HAS_GPU
+  bool skip_step = false;
+  // When every gradient is on the GPU, the result stays on the device
+  // and gates the optimizer kernels instead of being read here.
+  bool amp_on_device = false;
+  if (amp_loss_scaling) {
+#ifdef LBANN_HAS_GPU
+    amp_on_device =
+      all_support_step_scale &&
+      amp::is_finite_and_unscale_all_gpu(optimizers,
+                                         m_amp_scale_factor,
+                                         m_amp_is_finite_gpu);
+#endif // LBANN_HAS_GPU
+    if (!amp_on_device) {
+      skip_step =
+        !amp::is_finite_and_unscale_all(optimizers, m_amp_scale_factor);
+    }
+  }
+
+  // Device scalar the optimizer kernels multiply gradients by, or
+  // nullptr to step with the gradients as they are
+  const float* step_scale = nullptr;
+#ifdef LBANN_HAS_GPU
+  if (amp_on_device) {
+    step_scale = m_amp_is_finite_gpu.LockedBuffer();
+  }
+#endif // LBANN_HAS_GPU
+
+  // Clip the global gradient norm. Gradients are unscaled by now, so
+  // AMP does not affect the norm. When the norm can be reduced on the
+  // device, the clipping factor is folded into step_scale and applied
+  // by the update kernels.
+  if (m_clip_gradient_norm > DataType(0) && !skip_step) {
+    std::vector<weights*> weights_list(m_weights.rbegin(), m_weights.rend());
+    bool clip_on_device = false;
+#ifdef LBANN_HAS_GPU
+    clip_on_device =
+      all_support_step_scale &&
+      gradient_clipping::global_norm_scale_gpu(weights_list,
+                                               m_clip_gradient_norm,
+                                               *m_comm,
+                                               step_scale,
+                                               m_gradient_clip_gpu);
+    if (clip_on_device) {
+      step_scale = m_gradient_clip_gpu.scale.LockedBuffer();
+    }
+#endif // LBANN_HAS_GPU
+    if (!clip_on_device) {
+      gradient_clipping::clip_global_norm(weights_list,
+                                          m_clip_gradient_norm,
+                                          *m_comm);
+    }
+  }
+
+  if (!skip_step) {
+    // Apply optimization step to weights
+    // Note: Heuristically, forward prop consumes weights in the same
+    // order as m_weights and backprop computes weights gradients in
+    // reverse order. Also, we often launch a non-blocking allreduce
+    // after a weights gradient has been computed. Thus, iterating in
+    // reverse order will use gradients that have already finished their
+    // allreduce, giving more time for more recent allreduces to finish.
+    // Optimizers that can be stepped together are grouped, in the
+    // order of their first member.
+    std::vector<std::vector<weights*>> groups;
+    std::unordered_map<std::string, size_t> group_index;
+    for (auto rit = m_weights.rbegin(); rit != m_weights.rend(); ++rit) {
+      auto* w = *rit;
+      auto* opt = w->get_optimizer();
+      if (opt == nullptr) {
+        continue;
+      }
+      const auto key =
+        m_multi_tensor_step ? opt->get_multi_tensor_key() : std::string();
+      if (key.empty()) {
+        groups.push_back({w});
+        continue;
+      }
+      auto [it, inserted] = group_index.emplace(key, groups.size());
+      if (inserted) {
+        groups.emplace_back();
+      }
+      groups[it->second].push_back(w);
+    }
+
+    for (auto const& group : groups) {
+      std::vector<optimizer*> opts;
+      opts.reserve(group.size());
+      for (auto* w : group) {
+        do_weight_optimize_begin_cbs(w);
+        opts.push_back(w->get_optimizer());
+        opts.back()->set_step_scale(step_scale);
+      }
+      if (opts.size() == 1) {
+        opts.front()->step();
+      }
+      else {
+        opts.front()->multi_tensor_step(opts);
+      }
+      for (auto* w : group) {
+        w->get_optimizer()->set_step_scale(nullptr);
+        do_weight_optimize_end_cbs(w);
+      }
+    }
+  }
+
+  // AMP: Update loss scale.
+  if (amp_loss_scaling) {
+#ifdef LBANN_HAS_GPU
+    // The scale lags device-side results by one step
+    if (prev_amp_result) {
+      update_amp_scale_(prev_skip_step);
+    }
+#endif // LBANN_HAS_GPU
+    if (!amp_on_device) {
+      update_amp_scale_(skip_step);
+    }
+#ifdef LBANN_HAS_GPU
+    else {
+      // Start copying this step's result for the next step
+      if (m_amp_is_finite_host.Height() != 1) {
+        m_amp_is_finite_host.SetMemoryMode(1); // Pinned memory
+        m_amp_is_finite_host.Resize(1, 1);
+      }
+      auto sync_info = El::SyncInfoFromMatrix(m_amp_is_finite_gpu);
+      ::hydrogen::gpu::Copy1DToHost(m_amp_is_finite_gpu.LockedBuffer(),
+                                    m_amp_is_finite_host.Buffer(),
+                                    1,
+                                    sync_info);
+      m_amp_is_finite_event.record(sync_info.Stream());
+      m_amp_is_finite_pending = true;
+    }
+#endif // LBANN_HAS_GPU
+    get_objective_function()->set_amp_scale(m_amp_scale_factor);
+  }
+
+  do_model_optimize_end_cbs();
+}
+
+bool model::update_layers()
+{
+  bool finished = true;
+  for (El::Int i = get_num_layers() - 1; i >= 0; --i) {
+    finished = get_layer(i).update() && finished;
+  }
+  return finished;
+}
+
+void model::reconcile_weight_values()
+{
+  LBANN_ERROR("This should not be called. Method is a candidate for removal");
+  // Launch non-blocking communication to reconcile weights
+  // Note: Heuristically, forward prop consumes weights in the same
+  // order as m_weights. Also, weights tend to get larger as you get
+  // deeper into a neural network. Thus, iterating in reverse order
+  // means that we perform the expensive communication first, covering
+  // up the launch overheads for the subsequent cheap communication.
+  std::vector<Al::request> reqs;
+  reqs.reserve(m_weights.size());
+  for (auto rit = m_weights.rbegin(); rit != m_weights.rend(); ++rit) {
+    auto& w = **rit;
+    reqs.emplace_back();
+    w.reconcile_values(reqs.back());
+  }
+
+  // Wait for communication to finish
+  for (auto& req : reqs) {
+    m_comm->wait(req);
+  }
+}
+
+void model::update_amp_scale_(bool skipped_step)
+{
+  if (skipped_step) {
+    m_amp_cur_steps = 0;
+    ++m_amp_cur_skipped_steps;
+    // Keep scale factor to the smallest positive normalized value for
+    // floats. Even when EvalType is double, we may cast to float.
+    m_amp_scale_factor =
+      std::max(static_cast<EvalType>(std::numeric_limits<float>::min()),
+               m_amp_scale_factor * m_amp_backoff_factor);
+    // Warn if we've been skipping too many steps.
+    // Check exact number to avoid printing repeatedly.
+    if (m_amp_cur_skipped_steps == 10) {
+      LBANN_WARNING("AMP skipped ten steps in a row, your model may have "
+                    "issues with AMP");
+    }
+  }
+  else {
+    if (m_amp_cur_steps + 1 == m_amp_growth_interval) {
+      m_amp_cur_steps = 0;
+      m_amp_cur_skipped_steps = 0;
+      // Prevent scale factor from overflowing to inf when cast to
+      // float.
+      m_amp_scale_factor =
+        std::min(static_cast<EvalType>(std::numeric_limits<float>::max()),
+                 m_amp_scale_factor * m_amp_growth_factor);
+    }
+    else {
+      ++m_amp_cur_steps;
+    }
+  }
+}
+
+void model::enable_amp(EvalType init_scale_factor,
+                       EvalType growth_factor,
+                       EvalType backoff_factor,
+                       size_t growth_interval,
+                       bool loss_scaling)
+{
+  m_amp_enabled = true;
+  m_amp_loss_scaling = loss_scaling;
+  m_amp_scale_factor = loss_scaling ? init_scale_factor : EvalType(1);
+  m_amp_growth_factor = growth_factor;
+  m_amp_backoff_factor = backoff_factor;
+  m_amp_growth_interval = growth_interval;
+}
+
+// =============================================
+// Callbacks
+// =============================================
+
+void model::do_setup_end_cbs()
+{
+  for (const auto& cb : m_callbacks) {
+    cb->on_setup_end(this);
+  }
+}
+
+void model::do_model_forward_prop_begin_cbs(execution_mode mode)
+{
+  for (const auto& cb : m_callbacks) {
     switch (mode) {
     case execution_mode::training:
       if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
-        cb->on_forward_prop_end(this);
+        cb->on_forward_prop_begin(this);
       }
       break;
     case execution_mode::validation:
     case execution_mode::tournament:
     case execution_mode::testing:
-      cb->on_evaluate_forward_prop_end(this);
+      cb->on_evaluate_forward_prop_begin(this);
       break;
     default:
       LBANN_ERROR("invalid execution mode");
@@ -1923,22 +2982,19 @@ void model::do_model_forward_prop_end_cbs(execution_mode mode)
   }
 }
 
-/** @todo Consistent behavior between train, validation, and test
- *  modes
- */
-void model::do_layer_forward_prop_begin_cbs(execution_mode mode, Layer* l)
+void model::do_model_forward_prop_end_cbs(execution_mode mode)
 {
   for (const auto& cb : m_callbacks) {
     switch (mode) {
     case execution_mode::training:
       if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
-        cb->on_forward_prop_begin(this, l);
+        cb->on_forward_prop_end(this);
       }
       break;
     case execution_mode::validation:
     case execution_mode::tournament:
     case execution_mode::testing:
-      cb->on_evaluate_forward_prop_begin(this, l);
+      cb->on_evaluate_forward_prop_end(this);
       break;
     default:
       LBANN_ERROR("invalid execution mode");
@@ -1946,26 +3002,71 @@ void model::do_layer_forward_prop_begin_cbs(execution_mode mode, Layer* l)
   }
 }
 
+void model::update_hook_callbacks()
+{
+  m_hook_callbacks.assign(callback_base::num_hooks, {});
+  for (const auto& cb : m_callbacks) {
+    if (cb == nullptr) {
+      continue;
+    }
+    const auto hooks = cb->get_hooks();
+    for (unsigned h = 0; h < callback_base::num_hooks; ++h) {
+      if (hooks & callback_base::hook_bit(callback_base::hook(h))) {
+        m_hook_callbacks[h].push_back(cb.get());
+      }
+    }
+  }
+}
+
+/** @todo Consistent behavior between train, validation, and test
+ *  modes
+ */
+void model::do_layer_forward_prop_begin_cbs(execution_mode mode, Layer* l)
+{
+  switch (mode) {
+  case execution_mode::training:
+    for (auto* cb : m_hook_callbacks[callback_base::layer_forward_prop_begin]) {
+      if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
+        cb->on_forward_prop_begin(this, l);
+      }
+    }
+    break;
+  case execution_mode::validation:
+  case execution_mode::tournament:
+  case execution_mode::testing:
+    for (auto* cb :
+         m_hook_callbacks[callback_base::layer_evaluate_forward_prop_begin]) {
+      cb->on_evaluate_forward_prop_begin(this, l);
+    }
+    break;
+  default:
+    LBANN_ERROR("invalid execution mode");
+  }
+}
+
 /** @todo Consistent behavior between train, validation, and test
  *  modes
  */
 void model::do_layer_forward_prop_end_cbs(execution_mode mode, Layer* l)
 {
-  for (const auto& cb : m_callbacks) {
-    switch (mode) {
-    case execution_mode::training:
+  switch (mode) {
+  case execution_mode::training:
+    for (auto* cb : m_hook_callbacks[callback_base::layer_forward_prop_end]) {
       if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
         cb->on_forward_prop_end(this, l);
       }
-      break;
-    case execution_mode::validation:
-    case execution_mode::tournament:
-    case execution_mode::testing:
+    }
+    break;
+  case execution_mode::validation:
+  case execution_mode::tournament:
+  case execution_mode::testing:
+    for (auto* cb :
+         m_hook_callbacks[callback_base::layer_evaluate_forward_prop_end]) {
       cb->on_evaluate_forward_prop_end(this, l);
-      break;
-    default:
-      LBANN_ERROR("invalid execution mode");
     }
+    break;
+  default:
+    LBANN_ERROR("invalid execution mode");
   }
 }
 
@@ -1989,7 +3090,7 @@ void model::do_model_backward_prop_end_cbs()
 
 void model::do_layer_backward_prop_begin_cbs(Layer* l)
 {
-  for (const auto& cb : m_callbacks) {
+  for (auto* cb : m_hook_callbacks[callback_base::layer_backward_prop_begin]) {
     if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
       cb->on_backward_prop_begin(this, l);
     }
@@ -1998,7 +3099,7 @@ void model::do_layer_backward_prop_begin_cbs(Layer* l)
 
 void model::do_layer_backward_prop_end_cbs(Layer* l)
 {
-  for (const auto& cb : m_callbacks) {
+  for (auto* cb : m_hook_callbacks[callback_base::layer_backward_prop_end]) {
     if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
       cb->on_backward_prop_end(this, l);
     }
@@ -2025,7 +3126,7 @@ void model::do_model_optimize_end_cbs()
 
 void model::do_weight_optimize_begin_cbs(weights* w)
 {
-  for (const auto& cb : m_callbacks) {
+  for (auto* cb : m_hook_callbacks[callback_base::weights_optimize_begin]) {
     if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
       cb->on_optimize_begin(this, w);
     }
@@ -2034,7 +3135,7 @@ void model::do_weight_optimize_begin_cbs(weights* w)
 
 void model::do_weight_optimize_end_cbs(weights* w)
 {
-  for (const auto& cb : m_callbacks) {
+  for (auto* cb : m_hook_callbacks[callback_base::weights_optimize_end]) {
     if (get_execution_context().get_step() % cb->get_batch_interval() == 0) {
       cb->on_optimize_end(this, w);
     }
@@ -2128,17 +3229,8 @@ bool model::load_from_checkpoint_shared(persist& p)
   p.open_restart(file::join_path(trainer_dir, get_name()));
   // Assume checkpoint reload from epoch end not step end
 
-  std::ifstream ifs;
-  if (m_comm->am_trainer_master()) {
-    ifs.open(file::join_path(p.get_checkpoint_dir(), "model.bin"));
-    LBANN_ASSERT(ifs.good());
-  }
-
   // Restore the checkpoint
-  {
-    lbann::RootedBinaryInputArchive ar(ifs, m_comm->get_trainer_grid());
-    ar(*this);
-  }
+  load_checkpoint_archive(p.get_checkpoint_dir(), true);
 
   m_model_is_setup = false;
   p.set_restart_dir(trainer_dir);
@@ -2176,24 +3268,138 @@ bool model::save_to_checkpoint_distributed(persist& p)
   return true;
 }
 
-bool model::load_from_checkpoint_distributed(persist& p)
+std::vector<std::pair<std::string, std::string>>
+model::snapshot_checkpoint_shared(persist& p)
 {
   const std::string trainer_dir = p.get_checkpoint_dir();
-  p.open_restart(file::join_path(trainer_dir, get_name()));
+  p.open_checkpoint_dir(file::join_path(trainer_dir, this->get_name()),
+                        m_comm->am_trainer_master());
+  m_comm->trainer_barrier();
 
-#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  std::ostringstream oss;
   {
-    std::ifstream ifs(file::join_path(p.get_checkpoint_dir(), "model.bin"));
-    cereal::BinaryInputArchive ar(ifs);
+    lbann::RootedBinaryOutputArchive ar(oss, m_comm->get_trainer_grid());
     ar(*this);
   }
+  std::vector<std::pair<std::string, std::string>> files;
+  if (m_comm->am_trainer_master()) {
+    files.emplace_back(file::join_path(p.get_checkpoint_dir(), "model.bin"),
+                       oss.str());
+  }
+
+  p.open_checkpoint_dir(trainer_dir, false);
+  return files;
+}
+
+std::vector<std::pair<std::string, std::string>>
+model::snapshot_checkpoint_distributed(persist& p)
+{
+  const std::string trainer_dir = p.get_checkpoint_dir();
+  p.open_checkpoint_dir(file::join_path(trainer_dir, get_name()), true);
+  m_comm->trainer_barrier();
+
+  std::vector<std::pair<std::string, std::string>> files;
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  {
+    std::ostringstream oss;
+    {
+      cereal::BinaryOutputArchive ar(oss);
+      ar(*this);
+    }
+    files.emplace_back(file::join_path(p.get_checkpoint_dir(), "model.bin"),
+                       oss.str());
+  }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 
+#ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
+  {
+    std::ostringstream oss;
+    {
+      cereal::XMLOutputArchive ar(oss);
+      ar(*this);
+    }
+    files.emplace_back(file::join_path(p.get_checkpoint_dir(), "model.xml"),
+                       oss.str());
+  }
+#endif // LBANN_HAS_CEREAL_XML_ARCHIVES
+
+  p.open_checkpoint_dir(trainer_dir, false);
+  return files;
+}
+
+bool model::load_from_checkpoint_distributed(persist& p)
+{
+  const std::string trainer_dir = p.get_checkpoint_dir();
+  p.open_restart(file::join_path(trainer_dir, get_name()));
+
+  load_checkpoint_archive(p.get_checkpoint_dir(), false);
+
   m_model_is_setup = false;
   p.set_restart_dir(trainer_dir);
   return true;
 }
 
+void model::load_checkpoint_archive(std::string const& model_dir, bool shared)
+{
+  // Incremental checkpoints name the checkpoint they build on,
+  // relative to their own model directory
+  int incremental = 0;
+  std::string chain;
+  if (!shared || m_comm->am_trainer_master()) {
+    std::ifstream chain_ifs(file::join_path(model_dir, "model.chain"));
+    if (chain_ifs.good()) {
+      incremental = 1;
+      std::getline(chain_ifs, chain);
+    }
+  }
+  if (shared) {
+    m_comm->trainer_broadcast(0, incremental);
+    m_comm->trainer_broadcast(0, chain);
+  }
+
+  // Load the earlier checkpoints and keep their weights around
+  std::map<std::string, OwningWeightsPtr> previous;
+  if (incremental && !chain.empty()) {
+    load_checkpoint_archive(file::join_path(model_dir, chain), shared);
+    for (auto& w : m_weights) {
+      auto const name = w->get_name();
+      previous[name] = std::move(w);
+    }
+  }
+  std::unique_ptr<incremental_checkpoint_scope> scope;
+  if (incremental) {
+    scope = std::make_unique<incremental_checkpoint_scope>(
+      std::set<std::string>{},
+      std::move(previous));
+  }
+
+  if (shared) {
+    std::ifstream ifs;
+    if (m_comm->am_trainer_master()) {
+      ifs.open(file::join_path(model_dir, "model.bin"), std::ios::binary);
+      LBANN_ASSERT(ifs.good());
+    }
+    // Each rank reads its own share of the weights when every rank
+    // can see the file; otherwise the root reads and scatters them
+    std::ifstream local_ifs(file::join_path(model_dir, "model.bin"),
+                            std::ios::binary);
+    int const all_open =
+      m_comm->trainer_allreduce(local_ifs.good() ? 1 : 0, El::mpi::MIN);
+    lbann::RootedBinaryInputArchive ar(ifs,
+                                       m_comm->get_trainer_grid(),
+                                       0,
+                                       all_open ? &local_ifs : nullptr);
+    ar(*this);
+  }
+  else {
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+    std::ifstream ifs(file::join_path(model_dir, "model.bin"));
+    cereal::BinaryInputArchive ar(ifs);
+    ar(*this);
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  }
+}
+
 void model::write_proto(lbann_data::Model& proto)
 {
   if (!get_comm()->am_trainer_master())
@@ -2248,6 +3454,95 @@ void model::save_model()
   }
 }
 
+void model::setup_redistributions_()
+{
+  m_redistributions.clear();
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto& child = get_layer(i);
+    for (int j = 0; j < child.get_num_parents(); ++j) {
+      const size_t bytes = child.get_input_redistribution_bytes(j);
+      if (bytes == 0) {
+        continue;
+      }
+      // Siblings that make the same copy of the parent's output view
+      // the first sibling's copy
+      const auto& parent = child.get_parent_layer(j);
+      Layer const* source = nullptr;
+      if (!this->is_subgraph_parallelism_enabled()) {
+        for (const auto& r : m_redistributions) {
+          if (r.parent == &parent && r.source == nullptr &&
+              child.share_input_redistribution(j, *r.child)) {
+            source = r.child;
+            break;
+          }
+        }
+      }
+      m_redistributions.push_back({&parent, &child, j, bytes, source});
+    }
+  }
+}
+
+void model::print_distributions() const
+{
+  std::ostringstream ss;
+#ifdef LBANN_HAS_DISTCONV
+  bool has_distconv = false;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    has_distconv = has_distconv || get_layer(i).distconv_enabled();
+  }
+  for (El::Int i = 0; has_distconv && i < get_num_layers(); ++i) {
+    const auto& layer = get_layer(i);
+    if (layer.distconv_enabled()) {
+      ss << layer.get_name() << " disributions: "
+         << "prev_activations: "
+         << layer.get_distconv_adapter().get_prev_activations_dist()
+         << ", activations: "
+         << layer.get_distconv_adapter().get_activations_dist()
+         << ", error_signals: "
+         << layer.get_distconv_adapter().get_error_signals_dist()
+         << ", prev_error_signals: "
+         << layer.get_distconv_adapter().get_prev_activations_dist() << "\n";
+    }
+    else {
+      ss << layer.get_name() << ": distconv disabled"
+         << "\n";
+    }
+  }
+  if (has_distconv) {
+    dc::MPIRootPrintStreamDebug() << ss.str();
+    ss.str("");
+  }
+#endif // LBANN_HAS_DISTCONV
+
+  // Redistributions between layers, per mini-batch sample
+  if (m_redistributions.empty() || !m_comm->am_trainer_master()) {
+    return;
+  }
+  size_t total_bytes = 0;
+  size_t elided_bytes = 0;
+  ss << "Redistributions in model \"" << get_name() << "\":\n";
+  for (const auto& r : m_redistributions) {
+    ss << "  " << r.parent->get_name() << " ("
+       << to_string(r.parent->get_data_layout()) << ", "
+       << to_string(r.parent->get_device_allocation()) << ") -> "
+       << r.child->get_name() << " input " << r.input_index << " ("
+       << to_string(r.child->get_data_layout()) << ", "
+       << to_string(r.child->get_device_allocation()) << "): "
+       << r.bytes_per_sample << " B/sample";
+    if (r.source != nullptr) {
+      ss << ", views copy of " << r.source->get_name();
+      elided_bytes += r.bytes_per_sample;
+    }
+    else {
+      total_bytes += r.bytes_per_sample;
+    }
+    ss << "\n";
+  }
+  ss << "  total: " << total_bytes << " B/sample copied, " << elided_bytes
+     << " B/sample elided\n";
+  std::cout << ss.str();
+}
+
 #ifdef LBANN_HAS_DISTCONV
 void model::setup_distconv()
 {
@@ -2278,7 +3573,6 @@ void model::setup_distconv()
     endl(std::cout);
   }
   setup_distributions();
-  print_distributions();
   // Setup fp tensors
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     auto& layer = get_layer(i);
@@ -2323,29 +3617,6 @@ void model::setup_distributions()
   constraints.find_valid_overlap();
 }
 
-void model::print_distributions() const
-{
-  std::ostringstream ss;
-  for (El::Int i = 0; i < get_num_layers(); ++i) {
-    const auto& layer = get_layer(i);
-    if (layer.distconv_enabled()) {
-      ss << layer.get_name() << " disributions: "
-         << "prev_activations: "
-         << layer.get_distconv_adapter().get_prev_activations_dist()
-         << ", activations: "
-         << layer.get_distconv_adapter().get_activations_dist()
-         << ", error_signals: "
-         << layer.get_distconv_adapter().get_error_signals_dist()
-         << ", prev_error_signals: "
-         << layer.get_distconv_adapter().get_prev_activations_dist() << "\n";
-    }
-    else {
-      ss << layer.get_name() << ": distconv disabled"
-         << "\n";
-    }
-  }
-  dc::MPIRootPrintStreamDebug() << ss.str();
-}
 #endif // LBANN_HAS_DISTCONV
 
 } // namespace lbann
@@ -0,0 +1,376 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/models/pipeline_parallelism.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+// Defined with the layers
+void attempt_move_error_signal(Layer& parent,
+                               Layer const& child,
+                               std::unique_ptr<BaseDistMat> signal);
+
+namespace {
+
+El::AbstractDistMatrix<DataType> const& as_data_type(BaseDistMat const& mat,
+                                                     Layer const& l)
+{
+  auto const* ptr = dynamic_cast<El::AbstractDistMatrix<DataType> const*>(&mat);
+  if (ptr == nullptr) {
+    LBANN_ERROR("layer \"",
+                l.get_name(),
+                "\" is on a pipeline stage boundary, which requires ",
+                "tensors of the default data type");
+  }
+  return *ptr;
+}
+
+} // namespace
+
+std::vector<pipeline_step> make_1f1b_schedule(size_t num_stages,
+                                              size_t stage,
+                                              size_t num_micro_batches)
+{
+  if (stage >= num_stages) {
+    LBANN_ERROR("pipeline stage ", stage, " of ", num_stages, " stages");
+  }
+  const size_t warmup = std::min(num_stages - stage - 1, num_micro_batches);
+  std::vector<pipeline_step> steps;
+  steps.reserve(2 * num_micro_batches);
+  size_t next_forward = 0, next_backward = 0;
+  for (; next_forward < warmup; ++next_forward) {
+    steps.push_back({false, next_forward});
+  }
+  for (; next_forward < num_micro_batches; ++next_forward, ++next_backward) {
+    steps.push_back({false, next_forward});
+    steps.push_back({true, next_backward});
+  }
+  for (; next_backward < num_micro_batches; ++next_backward) {
+    steps.push_back({true, next_backward});
+  }
+  return steps;
+}
+
+pipeline_parallelism::pipeline_parallelism(model& m,
+                                           std::vector<El::Grid*> const& grids)
+  : m_model{m}
+{
+  if (m.is_subgraph_parallelism_enabled()) {
+    LBANN_ERROR("pipeline parallelism is not supported with sub-graph "
+                "parallelism");
+  }
+
+  // Stages are runs of consecutive layers on the same grid
+  std::vector<int> stage_tags;
+  for (auto const* l : m.get_layers()) {
+    const int tag = l->grid_tag();
+    if (tag <= 0) {
+      LBANN_ERROR("pipeline parallelism requires every layer to be on a ",
+                  "sub-grid, but layer \"",
+                  l->get_name(),
+                  "\" is on the trainer grid");
+    }
+    if (stage_tags.empty() || stage_tags.back() != tag) {
+      if (std::find(stage_tags.begin(), stage_tags.end(), tag) !=
+          stage_tags.end()) {
+        LBANN_ERROR("layers on grid ",
+                    tag,
+                    " are not consecutive in execution order (layer \"",
+                    l->get_name(),
+                    "\")");
+      }
+      stage_tags.push_back(tag);
+    }
+    m_layer_stages[l] = stage_tags.size() - 1;
+  }
+
+  // Find this process's stage and its counterparts in the others
+  El::Grid const* my_grid = nullptr;
+  for (size_t stage = 0; stage < stage_tags.size(); ++stage) {
+    auto const& grid = *grids.at(stage_tags[stage]);
+    if (grid.InGrid()) {
+      if (my_grid != nullptr) {
+        LBANN_ERROR("pipeline stage grids must not overlap");
+      }
+      my_grid = &grid;
+      m_stage = stage;
+    }
+  }
+  if (my_grid == nullptr) {
+    LBANN_ERROR("process is not in the grid of any pipeline stage");
+  }
+  for (const int tag : stage_tags) {
+    auto const& grid = *grids[tag];
+    if (grid.Height() != my_grid->Height() ||
+        grid.Width() != my_grid->Width()) {
+      LBANN_ERROR("pipeline stage grids must have the same shape");
+    }
+    m_stage_ranks.push_back(grid.VCToViewing(my_grid->VCRank()));
+  }
+
+  // Tag the edges between stages: even for activations, odd for
+  // error signals
+  int num_edges = 0;
+  for (auto const* l : m.get_layers()) {
+    for (auto const* child : l->get_child_layers()) {
+      if (m_layer_stages.at(child) == m_layer_stages.at(l)) {
+        continue;
+      }
+      if (l->get_data_layout() != child->get_data_layout()) {
+        LBANN_ERROR("layers \"",
+                    l->get_name(),
+                    "\" and \"",
+                    child->get_name(),
+                    "\" are on a pipeline stage boundary and must have ",
+                    "the same data layout");
+      }
+      m_edge_tags[{l, child}] = 2 * num_edges++;
+    }
+  }
+}
+
+pipeline_parallelism::~pipeline_parallelism()
+{
+  try {
+    end_mini_batch();
+  }
+  catch (...) {
+  }
+}
+
+bool pipeline_parallelism::is_in_stage(Layer const& l) const
+{
+  return m_layer_stages.at(&l) == m_stage;
+}
+
+void pipeline_parallelism::begin_forward(size_t micro_batch, bool replay)
+{
+  if (!replay) {
+    if (micro_batch != m_num_forward) {
+      LBANN_ERROR("pipeline micro-batches must run forward in order");
+    }
+    ++m_num_forward;
+    m_mini_batch_sizes.push_back(m_model.get_current_mini_batch_size());
+  }
+  else if (micro_batch >= m_num_forward) {
+    LBANN_ERROR("attempted to replay micro-batch ",
+                micro_batch,
+                " before running it forward");
+  }
+  m_micro_batch = micro_batch;
+  m_replaying = replay;
+  m_last_forward = micro_batch;
+}
+
+void pipeline_parallelism::begin_backward(size_t micro_batch)
+{
+  if (needs_replay(micro_batch)) {
+    LBANN_ERROR("layers do not hold the activations of micro-batch ",
+                micro_batch);
+  }
+  if (micro_batch > 0) {
+    release_(micro_batch - 1);
+  }
+  m_micro_batch = micro_batch;
+  m_replaying = false;
+}
+
+bool pipeline_parallelism::needs_replay(size_t micro_batch) const noexcept
+{
+  return m_last_forward != micro_batch;
+}
+
+El::Int pipeline_parallelism::get_mini_batch_size(size_t micro_batch) const
+{
+  return m_mini_batch_sizes.at(micro_batch);
+}
+
+void pipeline_parallelism::end_mini_batch()
+{
+  auto const& comm = *m_model.get_comm();
+  for (auto& send : m_sends) {
+    comm.wait(send.second);
+  }
+  m_sends.clear();
+  m_inputs.clear();
+  m_source_outputs.clear();
+  m_mini_batch_sizes.clear();
+  m_num_forward = 0;
+}
+
+El::BaseDistMatrix const&
+pipeline_parallelism::receive_input(Layer const& parent,
+                                    Layer const& child,
+                                    El::BaseDistMatrix const& like)
+{
+  auto& kept = m_inputs[{&parent, &child}];
+  if (kept.size() <= m_micro_batch) {
+    kept.resize(m_micro_batch + 1);
+  }
+  auto& input = kept[m_micro_batch];
+  if (!m_replaying) {
+    auto const& like_mat = as_data_type(like, child);
+    input.reset(like_mat.Construct(like_mat.Grid(), like_mat.Root()));
+    input->Resize(child.get_input_size(child.find_parent_layer_index(parent)),
+                  m_mini_batch_sizes.at(m_micro_batch));
+    receive_(*input,
+             m_layer_stages.at(&parent),
+             m_edge_tags.at({&parent, &child}));
+  }
+  else if (input == nullptr) {
+    LBANN_ERROR("no input of layer \"",
+                child.get_name(),
+                "\" is kept for micro-batch ",
+                m_micro_batch);
+  }
+  return *input;
+}
+
+void pipeline_parallelism::send_outputs(Layer& l)
+{
+  if (m_replaying) {
+    return;
+  }
+  for (auto const* child : l.get_child_layers()) {
+    auto const& output = as_data_type(l.get_activations(*child), l);
+    auto tag = m_edge_tags.find({&l, child});
+    if (tag != m_edge_tags.end()) {
+      send_(output, m_layer_stages.at(child), tag->second);
+    }
+    else if (l.get_num_parents() == 0) {
+      auto& kept = m_source_outputs[{&l, child}];
+      if (kept.size() <= m_micro_batch) {
+        kept.resize(m_micro_batch + 1);
+      }
+      kept[m_micro_batch].reset(output.Copy());
+    }
+  }
+}
+
+bool pipeline_parallelism::restore_outputs(Layer& l)
+{
+  if (!m_replaying || l.get_num_parents() > 0) {
+    return false;
+  }
+  auto* dtl = dynamic_cast<data_type_layer<DataType>*>(&l);
+  if (dtl == nullptr) {
+    LBANN_ERROR("input layer \"",
+                l.get_name(),
+                "\" of a pipeline stage must use the default data type");
+  }
+  for (int i = 0; i < l.get_num_children(); ++i) {
+    auto const* child = &l.get_child_layer(i);
+    auto kept = m_source_outputs.find({&l, child});
+    if (kept == m_source_outputs.end()) {
+      continue;
+    }
+    El::Copy(*kept->second.at(m_micro_batch), dtl->get_activations(i));
+  }
+  return true;
+}
+
+void pipeline_parallelism::receive_error_signals(
+  Layer& l,
+  std::unordered_set<Layer const*> const& skipped)
+{
+  // Children skip parents that need no error signals
+  if (l.get_backprop_requirements() == PROPAGATE_NOTHING) {
+    return;
+  }
+  for (int i = 0; i < l.get_num_children(); ++i) {
+    auto const* child = &l.get_child_layer(i);
+    auto tag = m_edge_tags.find({&l, child});
+    if (tag == m_edge_tags.end() || skipped.count(child) > 0) {
+      continue;
+    }
+    auto const& output = as_data_type(l.get_activations(*child), l);
+    std::unique_ptr<DistMatrix> signal(
+      output.Construct(output.Grid(), output.Root()));
+    signal->Resize(l.get_output_size(i),
+                   m_mini_batch_sizes.at(m_micro_batch));
+    receive_(*signal, m_layer_stages.at(child), tag->second + 1);
+    attempt_move_error_signal(l, *child, std::move(signal));
+  }
+}
+
+void pipeline_parallelism::send_error_signal(Layer const& parent,
+                                             Layer const& child,
+                                             El::BaseDistMatrix const& signal)
+{
+  send_(as_data_type(signal, child),
+        m_layer_stages.at(&parent),
+        m_edge_tags.at({&parent, &child}) + 1);
+}
+
+void pipeline_parallelism::send_(DistMatrix const& mat, size_t stage, int tag)
+{
+  auto const& comm = *m_model.get_comm();
+  m_sends.emplace_back();
+  auto& send = m_sends.back();
+  El::Copy(mat.LockedMatrix(), send.first);
+  const int count = send.first.Height() * send.first.Width();
+  comm.nb_tagged_send(send.first.LockedBuffer(),
+                      count,
+                      m_stage_ranks[stage],
+                      tag,
+                      send.second,
+                      comm.get_trainer_comm());
+}
+
+void pipeline_parallelism::receive_(DistMatrix& mat, size_t stage, int tag)
+{
+  auto const& comm = *m_model.get_comm();
+  LocalMatrix buffer(mat.LocalHeight(), mat.LocalWidth());
+  const int count = buffer.Height() * buffer.Width();
+  El::mpi::Request<DataType> req;
+  comm.nb_tagged_recv(buffer.Buffer(),
+                      count,
+                      m_stage_ranks[stage],
+                      tag,
+                      req,
+                      comm.get_trainer_comm());
+  comm.wait(req);
+  El::Copy(buffer, mat.Matrix());
+}
+
+void pipeline_parallelism::release_(size_t micro_batch)
+{
+  for (auto* kept_tensors : {&m_inputs, &m_source_outputs}) {
+    for (auto& kept : *kept_tensors) {
+      if (micro_batch < kept.second.size()) {
+        kept.second[micro_batch].reset();
+      }
+    }
+  }
+}
+
+} // namespace lbann
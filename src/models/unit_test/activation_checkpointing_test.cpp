@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/layer.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+
+#include "lbann/proto/lbann.pb.h"
+#include <google/protobuf/text_format.h>
+
+#include <string>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+// model_prototext string is defined here as a "const std::string".
+#include "lenet.prototext.inc"
+
+using unit_test::utilities::find_layer;
+
+} // namespace
+
+TEST_CASE("Activation checkpointing segments", "[mpi][memory][model]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  lbann_data::LbannPB my_proto;
+  REQUIRE(pb::TextFormat::ParseFromString(model_prototext, &my_proto));
+  auto& trainer =
+    lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  unit_test::utilities::mock_data_reader(trainer, {1, 28, 28}, 10);
+  auto m = lbann::proto::construct_model(&comm,
+                                         my_proto.optimizer(),
+                                         my_proto.trainer(),
+                                         my_proto.model());
+  for (auto const& name : {"image", "layer5", "layer6", "layer7", "layer10"}) {
+    find_layer(*m, name).set_checkpoint(true);
+  }
+  m->setup(8UL, {&comm.get_trainer_grid()});
+
+  // Input layers are never recomputed
+  CHECK(m->get_recompute_segment(find_layer(*m, "image")) == -1);
+  CHECK(m->get_recompute_segment(find_layer(*m, "layer4")) == -1);
+
+  // Consecutive checkpointed layers share a segment
+  const int segment = m->get_recompute_segment(find_layer(*m, "layer5"));
+  CHECK(segment >= 0);
+  CHECK(m->get_recompute_segment(find_layer(*m, "layer6")) == segment);
+  CHECK(m->get_recompute_segment(find_layer(*m, "layer7")) == segment);
+
+  // A gap starts a new segment
+  CHECK(m->get_recompute_segment(find_layer(*m, "layer8")) == -1);
+  const int other = m->get_recompute_segment(find_layer(*m, "layer10"));
+  CHECK(other >= 0);
+  CHECK(other != segment);
+  CHECK_FALSE(m->is_recomputing_activations());
+}
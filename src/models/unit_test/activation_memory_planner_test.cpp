@@ -0,0 +1,236 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+#include <lbann/models/activation_memory_planner.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/utils/serialize.hpp>
+
+#include "lbann/proto/lbann.pb.h"
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+// model_prototext string is defined here as a "const std::string".
+#include "lenet.prototext.inc"
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+using interval = lbann::activation_memory_planner::tensor_interval;
+
+interval make_interval(size_t bytes, int birth, int death)
+{
+  interval t;
+  t.bytes = bytes;
+  t.birth = birth;
+  t.death = death;
+  return t;
+}
+
+bool collide(interval const& a, interval const& b)
+{
+  return a.birth <= b.death && b.birth <= a.death &&
+         a.offset < b.offset + b.bytes && b.offset < a.offset + a.bytes;
+}
+
+// Two checkpointed layers between a weights layer and a dummy layer
+const std::string recompute_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "layer1"
+    weights: "inputs"
+    weights_layer {
+      dims: 4
+    }
+  }
+  layer {
+    name: "layer1"
+    parents: "inp"
+    children: "layer2"
+    checkpoint: true
+    elu {
+    }
+  }
+  layer {
+    name: "layer2"
+    parents: "layer1"
+    children: "layer3"
+    checkpoint: true
+    softmax {
+    }
+  }
+  layer {
+    name: "layer3"
+    parents: "layer2"
+    children: "out"
+    relu {
+    }
+  }
+  layer {
+    name: "out"
+    parents: "layer3"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 3.4
+        values: -5.67
+        values: 0.5
+      }
+    }
+  }
+}
+)""";
+
+/** Error signal reaching the weights layer with and without a plan */
+std::vector<float> recompute_gradient(bool plan)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif
+  auto m = construct_model(recompute_prototext);
+  m->set_activation_memory_planning(plan);
+  setup_model(*m);
+  REQUIRE((m->get_activation_memory_planner() != nullptr) == plan);
+
+  auto& layer1 = dynamic_cast<lbann::data_type_layer<float>&>(m->get_layer(1));
+  set_error_signal<Dev>(m->get_layer(4), {0.25f, -2.f, 0.25f, 0.25f});
+  layer1.set_keep_error_signals(true);
+
+  REQUIRE_NOTHROW(m->forward_prop(lbann::execution_mode::training));
+  REQUIRE_NOTHROW(m->backward_prop(false));
+  return to_vector(layer1.get_error_signals());
+}
+
+} // namespace
+
+TEST_CASE("Activation memory offset assignment", "[memory][model]")
+{
+  using planner = lbann::activation_memory_planner;
+
+  SECTION("Disjoint lifetimes share memory")
+  {
+    std::vector<interval> ts = {make_interval(1000, 0, 1),
+                                make_interval(1000, 2, 3),
+                                make_interval(1000, 4, 5)};
+    std::vector<interval*> ptrs = {&ts[0], &ts[1], &ts[2]};
+    CHECK(planner::assign_offsets(ptrs) == 1000);
+    for (auto const& t : ts) {
+      CHECK(t.offset == 0);
+    }
+  }
+
+  SECTION("Overlapping lifetimes are disjoint and aligned")
+  {
+    std::vector<interval> ts = {make_interval(1000, 0, 3),
+                                make_interval(300, 1, 2),
+                                make_interval(500, 2, 5),
+                                make_interval(200, 4, 6)};
+    std::vector<interval*> ptrs;
+    for (auto& t : ts) {
+      ptrs.push_back(&t);
+    }
+    const auto arena = planner::assign_offsets(ptrs);
+    size_t required = 0;
+    for (size_t i = 0; i < ts.size(); ++i) {
+      CHECK(ts[i].offset % planner::alignment == 0);
+      CHECK(ts[i].offset + ts[i].bytes <= arena);
+      required = std::max(required, ts[i].offset + ts[i].bytes);
+      for (size_t j = 0; j < i; ++j) {
+        CHECK_FALSE(collide(ts[i], ts[j]));
+      }
+    }
+    CHECK(arena == required);
+    // The 200 byte tensor fits in the gap left by the first one
+    CHECK(ts[3].offset == 0);
+  }
+}
+
+TEST_CASE("Activation memory plan for a model", "[mpi][memory][model]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  lbann_data::LbannPB my_proto;
+  REQUIRE(pb::TextFormat::ParseFromString(model_prototext, &my_proto));
+  auto& trainer =
+    lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  unit_test::utilities::mock_data_reader(trainer, {1, 28, 28}, 10);
+  auto m = lbann::proto::construct_model(&comm,
+                                         my_proto.optimizer(),
+                                         my_proto.trainer(),
+                                         my_proto.model());
+  m->set_activation_memory_planning(true);
+  m->setup(8UL, {&comm.get_trainer_grid()});
+
+  auto const* plan = m->get_activation_memory_planner();
+  REQUIRE(plan != nullptr);
+  auto const& ts = plan->get_intervals();
+  REQUIRE_FALSE(ts.empty());
+
+  // No two tensors live at the same time share memory
+  for (size_t i = 0; i < ts.size(); ++i) {
+    CHECK(ts[i].birth <= ts[i].death);
+    for (size_t j = 0; j < i; ++j) {
+      if (ts[i].device == ts[j].device) {
+        CHECK_FALSE(collide(ts[i], ts[j]));
+      }
+    }
+  }
+
+  // Reuse brings the arena below one allocation per tensor
+  const auto device = ts.front().device;
+  CHECK(plan->get_arena_bytes(device) >= plan->get_peak_live_bytes(device));
+  CHECK(plan->get_arena_bytes(device) < plan->get_unshared_bytes(device));
+}
+
+TEST_CASE("Activation memory plan with recomputation", "[mpi][memory][model]")
+{
+  const auto expected = recompute_gradient(false);
+  const auto planned = recompute_gradient(true);
+  REQUIRE(planned.size() == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    CHECK(planned[i] == Approx(expected[i]));
+  }
+}
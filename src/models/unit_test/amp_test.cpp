@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/optimizers/adam.hpp>
+#include <lbann/utils/serialize.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <limits>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::run_training_step;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+// Adam-trained weights fed straight to a dummy layer
+const std::string amp_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "out"
+    weights: "inputs"
+    weights_layer {
+      dims: 4
+    }
+  }
+  layer {
+    name: "out"
+    parents: "inp"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 3.4
+        values: -5.67
+        values: 0.5
+      }
+    }
+  }
+}
+optimizer {
+  adam {
+    learn_rate: 0.1
+    beta1: 0.9
+    beta2: 0.99
+    eps: 1e-8
+  }
+}
+)""";
+
+#ifdef LBANN_HAS_HALF
+// Half-precision CPU layers with no weights
+const std::string fp16_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "out"
+    datatype: FP16
+    device_allocation: "cpu"
+    constant {
+      value: 1.0
+      num_neurons: 4
+    }
+  }
+  layer {
+    name: "out"
+    parents: "inp"
+    datatype: FP16
+    device_allocation: "cpu"
+    dummy {
+    }
+  }
+}
+)""";
+
+/** Set up the FP16 model with AMP enabled */
+void setup_fp16_model(bool loss_scaling)
+{
+  auto m = construct_model(fp16_prototext);
+  m->enable_amp(65536.0, 2.0, 0.5, 2000, loss_scaling);
+  setup_model(*m);
+}
+#endif // LBANN_HAS_HALF
+
+#ifdef LBANN_HAS_GPU
+constexpr auto Dev = El::Device::GPU;
+#else
+constexpr auto Dev = El::Device::CPU;
+#endif
+
+struct amp_state
+{
+  std::vector<float> values;
+  std::vector<float> moment1;
+  std::vector<float> moment2;
+  float current_beta1;
+  float current_beta2;
+};
+
+/** Train the weights on the given error signals with AMP enabled */
+amp_state train_steps(std::vector<float> const& signals)
+{
+  auto m = construct_model(amp_prototext);
+  // A backoff factor of one keeps the scale, and with it the
+  // unscaled gradients, the same whichever steps were skipped
+  m->enable_amp(/*init_scale_factor=*/1.0,
+                /*growth_factor=*/2.0,
+                /*backoff_factor=*/1.0);
+  setup_model(*m);
+
+  auto& w = dynamic_cast<lbann::data_type_weights<float>&>(
+    *m->get_weights().front());
+  auto& opt = dynamic_cast<lbann::adam<float>&>(*w.get_optimizer());
+  for (auto const& s : signals) {
+    set_error_signal<Dev>(m->get_layer(1), {0.25f, s, 0.25f, 0.25f});
+    run_training_step(*m);
+  }
+  return {to_vector(w.get_values()),
+          to_vector(opt.get_moment1()),
+          to_vector(opt.get_moment2()),
+          opt.get_current_beta1(),
+          opt.get_current_beta2()};
+}
+
+void check_same(amp_state const& a, amp_state const& b)
+{
+  CHECK(a.values == b.values);
+  CHECK(a.moment1 == b.moment1);
+  CHECK(a.moment2 == b.moment2);
+  CHECK(a.current_beta1 == b.current_beta1);
+  CHECK(a.current_beta2 == b.current_beta2);
+}
+
+} // namespace
+
+TEST_CASE("AMP overflow skips the optimization step", "[mpi][amp][model]")
+{
+  constexpr float inf = std::numeric_limits<float>::infinity();
+
+  SECTION("Weights and optimizer state are unchanged")
+  {
+    const auto initial = train_steps({});
+    const auto skipped = train_steps({inf});
+    CHECK(skipped.values == initial.values);
+    CHECK(skipped.moment1 == initial.moment1);
+    CHECK(skipped.moment2 == initial.moment2);
+  }
+
+  SECTION("Later steps do not see the skipped step")
+  {
+    // The host learns of a skip on the device one step late, so the
+    // optimizer state is compared after further steps
+    check_same(train_steps({inf, -2.f, 3.f}), train_steps({-2.f, 3.f}));
+    check_same(train_steps({-2.f, inf, 3.f}), train_steps({-2.f, 3.f}));
+  }
+}
+
+#ifdef LBANN_HAS_HALF
+TEST_CASE("AMP rejects FP16 layers without loss scaling",
+          "[mpi][amp][model]")
+{
+  CHECK_NOTHROW(setup_fp16_model(true));
+  CHECK_THROWS(setup_fp16_model(false));
+}
+#endif // LBANN_HAS_HALF
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::run_training_step;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+/** Two fully-connected layers on top of a fixed input
+ *
+ *  "@FREEZE@" is replaced with whether the lower layer is frozen.
+ */
+const std::string frozen_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "fc1"
+    weights: "inputs"
+    weights_layer {
+      dims: 4
+    }
+  }
+  layer {
+    name: "fc1"
+    parents: "inp"
+    children: "fc2"
+    weights: "w1"
+    freeze: @FREEZE@
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "fc2"
+    parents: "fc1"
+    children: "out"
+    weights: "w2"
+    fully_connected {
+      num_neurons: 2
+      has_bias: false
+    }
+  }
+  layer {
+    name: "out"
+    parents: "fc2"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    optimizer {
+      no_optimizer {
+      }
+    }
+    initializer {
+      value_initializer {
+        values: 0.5
+        values: -1.0
+        values: 0.25
+        values: 2.0
+      }
+    }
+  }
+  weights {
+    name: "w1"
+    initializer {
+      value_initializer {
+        values: 0.1
+        values: -0.2
+        values: 0.3
+        values: 0.4
+        values: -0.5
+        values: 0.6
+        values: -0.7
+        values: 0.8
+        values: 0.9
+        values: -0.1
+        values: 0.2
+        values: -0.3
+      }
+    }
+  }
+  weights {
+    name: "w2"
+    initializer {
+      value_initializer {
+        values: 0.5
+        values: -0.4
+        values: 0.3
+        values: -0.2
+        values: 0.1
+        values: 0.6
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 1.0
+  }
+}
+)""";
+
+struct backprop_result
+{
+  /** Whether each layer's back prop needed input error signals */
+  std::map<std::string, bool> error_signals_needed;
+  /** Weights values after one SGD step, by name */
+  std::map<std::string, std::vector<float>> weights;
+};
+
+/** One training step, with or without pruning input error signals */
+backprop_result train_step(bool freeze, bool compute_weight_grads_only)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif
+  auto prototext = frozen_prototext;
+  const std::string placeholder = "@FREEZE@";
+  prototext.replace(prototext.find(placeholder),
+                    placeholder.size(),
+                    freeze ? "true" : "false");
+
+  auto m = construct_model(prototext);
+  setup_model(*m);
+  set_error_signal<Dev>(find_layer(*m, "out"), {1.5f, -0.5f});
+  run_training_step(*m, compute_weight_grads_only);
+
+  backprop_result result;
+  for (auto const* l : m->get_layers()) {
+    result.error_signals_needed[l->get_name()] =
+      l->are_error_signals_needed();
+  }
+  for (auto* w : m->get_weights()) {
+    auto& dtw = dynamic_cast<lbann::data_type_weights<float>&>(*w);
+    result.weights[w->get_name()] = to_vector(dtw.get_values());
+  }
+  return result;
+}
+
+void check_same_weights(backprop_result const& result,
+                        backprop_result const& expected)
+{
+  REQUIRE(result.weights.size() == expected.weights.size());
+  for (auto const& [name, values] : expected.weights) {
+    INFO("Weights = " << name);
+    REQUIRE(result.weights.count(name) == 1);
+    auto const& result_values = result.weights.at(name);
+    REQUIRE(result_values.size() == values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      CHECK(result_values[i] == Approx(values[i]));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Back prop skips error signals below trainable layers",
+          "[mpi][model][backprop]")
+{
+  SECTION("Frozen lower layer")
+  {
+    auto const expected = train_step(true, false);
+    auto const pruned = train_step(true, true);
+    CHECK(expected.error_signals_needed.at("fc2"));
+    CHECK_FALSE(pruned.error_signals_needed.at("fc2"));
+    CHECK(pruned.error_signals_needed.at("out"));
+    check_same_weights(pruned, expected);
+  }
+  SECTION("Trainable lower layer")
+  {
+    auto const expected = train_step(false, false);
+    auto const pruned = train_step(false, true);
+    CHECK(pruned.error_signals_needed.at("fc2"));
+    CHECK_FALSE(pruned.error_signals_needed.at("fc1"));
+    check_same_weights(pruned, expected);
+  }
+}
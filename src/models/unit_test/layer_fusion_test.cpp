@@ -0,0 +1,368 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+// Fully-connected layer followed by a GELU operator
+const std::string fc_gelu_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "fc"
+    weights: "inputs"
+    weights_layer {
+      dims: 4
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "inp"
+    children: "gelu"
+    weights: "fc_linearity fc_bias"
+    fully_connected {
+      num_neurons: 3
+      has_bias: true
+    }
+  }
+  layer {
+    name: "gelu"
+    parents: "fc"
+    children: "out"
+    operator_layer {
+      ops {
+        parameters {
+          type_url: "type.googleapis.com/lbann_data.GeluOperator"
+        }
+      }
+    }
+  }
+  layer {
+    name: "out"
+    parents: "gelu"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 0.4
+        values: 0.9
+        values: -0.3
+      }
+    }
+  }
+  weights {
+    name: "fc_linearity"
+    initializer {
+      value_initializer {
+        values: 0.5
+        values: -0.25
+        values: 0.75
+        values: 0.1
+        values: -0.6
+        values: 0.3
+        values: 0.2
+        values: 0.4
+        values: -0.8
+        values: -0.1
+        values: 0.05
+        values: 0.6
+      }
+    }
+  }
+  weights {
+    name: "fc_bias"
+    initializer {
+      value_initializer {
+        values: 0.1
+        values: -0.2
+        values: 0.3
+      }
+    }
+  }
+}
+)""";
+
+// Batch normalization with a residual sum and ReLU
+const std::string bn_residual_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "bn"
+    weights: "inputs"
+    weights_layer {
+      dims: 2
+      dims: 2
+      dims: 2
+    }
+  }
+  layer {
+    name: "res"
+    children: "sum"
+    weights: "residual"
+    weights_layer {
+      dims: 2
+      dims: 2
+      dims: 2
+    }
+  }
+  layer {
+    name: "bn"
+    parents: "inp"
+    children: "sum"
+    batch_normalization {
+      decay: 0.9
+      epsilon: 1e-5
+    }
+  }
+  layer {
+    name: "sum"
+    parents: "bn res"
+    children: "relu"
+    sum {
+    }
+  }
+  layer {
+    name: "relu"
+    parents: "sum"
+    children: "out"
+    relu {
+    }
+  }
+  layer {
+    name: "out"
+    parents: "relu"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 0.4
+        values: 2.1
+        values: -0.3
+        values: 0.8
+        values: -0.6
+        values: 1.5
+        values: 0.2
+      }
+    }
+  }
+  weights {
+    name: "residual"
+    initializer {
+      value_initializer {
+        values: 0.3
+        values: -0.5
+        values: 0.1
+        values: 0.9
+        values: -0.2
+        values: 0.6
+        values: -1.1
+        values: 0.4
+      }
+    }
+  }
+}
+)""";
+
+// Chain of element-wise operator layers
+const std::string operator_chain_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "tanh"
+    weights: "inputs"
+    weights_layer {
+      dims: 5
+    }
+  }
+  layer {
+    name: "tanh"
+    parents: "inp"
+    children: "exp"
+    operator_layer {
+      ops {
+        parameters {
+          type_url: "type.googleapis.com/lbann_data.TanhOperator"
+        }
+      }
+    }
+  }
+  layer {
+    name: "exp"
+    parents: "tanh"
+    children: "sin"
+    operator_layer {
+      ops {
+        parameters {
+          type_url: "type.googleapis.com/lbann_data.ExpOperator"
+        }
+      }
+    }
+  }
+  layer {
+    name: "sin"
+    parents: "exp"
+    children: "out"
+    operator_layer {
+      ops {
+        parameters {
+          type_url: "type.googleapis.com/lbann_data.SinOperator"
+        }
+      }
+    }
+  }
+  layer {
+    name: "out"
+    parents: "sin"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 0.4
+        values: 0.9
+        values: -0.3
+        values: 2.0
+      }
+    }
+  }
+}
+)""";
+
+struct fusion_result
+{
+  /** Number of layers after setup */
+  El::Int num_layers;
+  /** Output of the layer feeding the dummy layer */
+  std::vector<float> output;
+  /** Error signal reaching each weights layer, by name */
+  std::map<std::string, std::vector<float>> grads;
+};
+
+/** One forward and backward pass with or without layer fusion */
+fusion_result run_model(std::string const& prototext, bool fuse)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif
+  using layer_type = lbann::data_type_layer<float>;
+
+  auto m = construct_model(prototext);
+  m->set_layer_fusion(fuse);
+  setup_model(*m);
+
+  fusion_result result;
+  result.num_layers = m->get_num_layers();
+  for (auto* l : m->get_layers()) {
+    l->set_keep_error_signals(true);
+  }
+  auto& out = find_layer(*m, "out");
+  auto const& last = dynamic_cast<layer_type const&>(out.get_parent_layer(0));
+  std::vector<float> error_signal;
+  for (int i = 0; i < last.get_output_size(); ++i) {
+    error_signal.push_back(0.5f - 0.25f * static_cast<float>(i));
+  }
+  set_error_signal<Dev>(out, error_signal);
+
+  REQUIRE_NOTHROW(m->forward_prop(lbann::execution_mode::training));
+  REQUIRE_NOTHROW(m->backward_prop(false));
+  result.output = to_vector(last.get_activations());
+  for (auto const* l : m->get_layers()) {
+    if (l->get_type() != "weights") {
+      continue;
+    }
+    auto const& consumer =
+      dynamic_cast<layer_type const&>(l->get_child_layer(0));
+    result.grads[l->get_name()] = to_vector(consumer.get_error_signals(*l));
+  }
+  return result;
+}
+
+void check_same_results(std::string const& prototext, El::Int num_fused)
+{
+  auto const expected = run_model(prototext, false);
+  auto const fused = run_model(prototext, true);
+  CHECK(fused.num_layers == expected.num_layers - num_fused);
+  REQUIRE(fused.output.size() == expected.output.size());
+  for (size_t i = 0; i < expected.output.size(); ++i) {
+    CHECK(fused.output[i] == Approx(expected.output[i]));
+  }
+  REQUIRE(fused.grads.size() == expected.grads.size());
+  for (auto const& [name, grad] : expected.grads) {
+    REQUIRE(fused.grads.count(name) == 1);
+    auto const& fused_grad = fused.grads.at(name);
+    REQUIRE(fused_grad.size() == grad.size());
+    for (size_t i = 0; i < grad.size(); ++i) {
+      CHECK(fused_grad[i] == Approx(grad[i]));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Layer fusion preserves model results", "[mpi][model][fusion]")
+{
+  SECTION("Fully-connected with GELU")
+  {
+    check_same_results(fc_gelu_prototext, 1);
+  }
+  SECTION("Batch normalization with residual and ReLU")
+  {
+    check_same_results(bn_residual_prototext, 2);
+  }
+  SECTION("Chain of operator layers")
+  {
+    check_same_results(operator_chain_prototext, 2);
+  }
+}
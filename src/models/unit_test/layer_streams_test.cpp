@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/data_type_layer.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+// Two independent branches, a fully-connected layer and a tanh, that
+// join in a sum
+const std::string branched_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "fc tanh"
+    weights: "inputs"
+    weights_layer {
+      dims: 3
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "inp"
+    children: "sum"
+    weights: "fc_linearity"
+    fully_connected {
+      num_neurons: 3
+      has_bias: false
+    }
+  }
+  layer {
+    name: "tanh"
+    parents: "inp"
+    children: "sum"
+    operator_layer {
+      ops {
+        parameters {
+          type_url: "type.googleapis.com/lbann_data.TanhOperator"
+        }
+      }
+    }
+  }
+  layer {
+    name: "sum"
+    parents: "fc tanh"
+    children: "out"
+    sum {
+    }
+  }
+  layer {
+    name: "out"
+    parents: "sum"
+    dummy {
+    }
+  }
+  weights {
+    name: "inputs"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 0.4
+        values: 0.9
+      }
+    }
+  }
+  weights {
+    name: "fc_linearity"
+    initializer {
+      value_initializer {
+        values: 0.5
+        values: -0.25
+        values: 0.75
+        values: 0.1
+        values: -0.6
+        values: 0.3
+        values: 0.2
+        values: 0.4
+        values: -0.8
+      }
+    }
+  }
+}
+)""";
+
+struct streams_result
+{
+  bool uses_layer_streams;
+  std::vector<float> output;
+  std::vector<float> input_grad;
+};
+
+/** One forward and backward pass on the given number of streams */
+streams_result run_model(size_t num_streams)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif
+  using layer_type = lbann::data_type_layer<float>;
+
+  auto m = construct_model(branched_prototext);
+  m->set_layer_streams(num_streams);
+  setup_model(*m);
+  for (auto* l : m->get_layers()) {
+    l->set_keep_error_signals(true);
+  }
+  auto const& inp = find_layer<layer_type const>(*m, "inp");
+  auto& out = find_layer(*m, "out");
+  auto const& sum = dynamic_cast<layer_type const&>(out.get_parent_layer(0));
+  set_error_signal<Dev>(out, {0.5f, 0.25f, 0.f});
+
+  REQUIRE_NOTHROW(m->forward_prop(lbann::execution_mode::training));
+  REQUIRE_NOTHROW(m->backward_prop(false));
+  m->join_layer_streams();
+  auto const& consumer =
+    dynamic_cast<layer_type const&>(inp.get_child_layer(0));
+  return {m->uses_layer_streams(),
+          to_vector(sum.get_activations()),
+          to_vector(consumer.get_error_signals(inp))};
+}
+
+} // namespace
+
+TEST_CASE("Layer streams preserve model results", "[mpi][model][streams]")
+{
+  auto const expected = run_model(1);
+  auto const result = run_model(3);
+  CHECK_FALSE(expected.uses_layer_streams);
+#if defined(LBANN_HAS_GPU) && !defined(LBANN_DETERMINISTIC)
+  CHECK(result.uses_layer_streams);
+#endif
+  REQUIRE(result.output.size() == expected.output.size());
+  for (size_t i = 0; i < expected.output.size(); ++i) {
+    CHECK(result.output[i] == Approx(expected.output[i]));
+  }
+  REQUIRE(result.input_grad.size() == expected.input_grad.size());
+  for (size_t i = 0; i < expected.input_grad.size(); ++i) {
+    CHECK(result.input_grad[i] == Approx(expected.input_grad[i]));
+  }
+}
@@ -29,8 +29,10 @@
 #include "MPITestHelpers.hpp"
 #include "TestHelpers.hpp"
 
+#include "lbann/callbacks/callback.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
 #include <lbann/base.hpp>
+#include <lbann/execution_algorithms/sgd_execution_context.hpp>
 #include <lbann/layers/io/input_layer.hpp>
 #include <lbann/layers/layer.hpp>
 #include <lbann/models/model.hpp>
@@ -38,6 +40,7 @@
 #include <lbann/utils/lbann_library.hpp>
 #include <lbann/utils/memory.hpp>
 #include <lbann/utils/serialize.hpp>
+#include <lbann/weights/data_type_weights.hpp>
 
 #include "lbann/proto/lbann.pb.h"
 #include <google/protobuf/text_format.h>
@@ -283,3 +286,414 @@ TEST_CASE("Gradient backpropagation stop", "[mpi][model][backprop]")
   REQUIRE(!before_stopgrad->bprop_computed());
   REQUIRE(after_stopgrad->bprop_computed());
 }
+
+namespace {
+// Counts evaluation forward prop calls for each layer
+class count_layer_hooks_callback : public lbann::callback_base
+{
+public:
+  count_layer_hooks_callback(unsigned hooks) : m_hooks(hooks) {}
+  count_layer_hooks_callback* copy() const override
+  {
+    return new count_layer_hooks_callback(*this);
+  }
+  std::string name() const override { return "count layer hooks"; }
+  unsigned get_hooks() const override { return m_hooks; }
+  void on_evaluate_forward_prop_begin(lbann::model*, lbann::Layer*) override
+  {
+    ++num_calls;
+  }
+  void on_evaluate_forward_prop_end(lbann::model*, lbann::Layer*) override
+  {
+    ++num_calls;
+  }
+  int num_calls = 0;
+
+private:
+  void write_specific_proto(lbann_data::Callback&) const override {}
+  unsigned m_hooks;
+};
+} // namespace
+
+TEST_CASE("Per-layer callback hooks go only to subscribers",
+          "[mpi][model][callbacks]")
+{
+  using DataType = float;
+  using lbann::callback_base;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+  std::unique_ptr<lbann::model> model = make_model<DataType>(comm);
+
+  auto subscribed = std::make_shared<count_layer_hooks_callback>(
+    callback_base::hook_bit(callback_base::layer_evaluate_forward_prop_end));
+  auto unsubscribed = std::make_shared<count_layer_hooks_callback>(0u);
+  model->add_callback(subscribed);
+  model->add_callback(unsubscribed);
+
+  auto& l = model->get_layer(0);
+  model->do_layer_forward_prop_begin_cbs(lbann::execution_mode::testing, &l);
+  model->do_layer_forward_prop_end_cbs(lbann::execution_mode::testing, &l);
+  CHECK(subscribed->num_calls == 1);
+  CHECK(unsubscribed->num_calls == 0);
+
+  // Copies rebuild the subscriber lists for their own callbacks
+  lbann::model model_copy(*model);
+  count_layer_hooks_callback* copied = nullptr;
+  for (auto* cb : model_copy.get_callbacks()) {
+    auto* counter = dynamic_cast<count_layer_hooks_callback*>(cb);
+    if (counter != nullptr && counter->get_hooks() != 0u) {
+      copied = counter;
+    }
+  }
+  REQUIRE(copied != nullptr);
+  model_copy.do_layer_forward_prop_end_cbs(lbann::execution_mode::testing,
+                                           &model_copy.get_layer(0));
+  CHECK(copied->num_calls == 2);
+  CHECK(subscribed->num_calls == 1);
+}
+
+namespace {
+const std::string inference_test_model = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "fc"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "inp"
+    children: "bn"
+    fully_connected {
+      num_neurons: 6
+      has_bias: false
+    }
+  }
+  layer {
+    name: "bn"
+    parents: "fc"
+    children: "drop"
+    batch_normalization {
+      epsilon: 1e-5
+    }
+  }
+  layer {
+    name: "drop"
+    parents: "bn"
+    children: "id"
+    dropout {
+      keep_prob: 0.5
+    }
+  }
+  layer {
+    name: "id"
+    parents: "drop"
+    children: "prob"
+    identity {
+    }
+  }
+  layer {
+    name: "prob"
+    parents: "id"
+    softmax {
+    }
+  }
+}
+)""";
+
+template <typename T>
+El::Matrix<T, El::Device::CPU> run_inference(lbann::model& m,
+                                             El::AbstractDistMatrix<T> const& x)
+{
+  for (auto* l : m.get_layers()) {
+    if (l->get_type() == "input") {
+      dynamic_cast<lbann::input_layer<T>&>(*l).set_samples(x);
+    }
+  }
+  m.set_current_mini_batch_size(x.Width());
+  m.forward_prop(lbann::execution_mode::inference);
+  auto const& prob =
+    dynamic_cast<lbann::data_type_layer<T> const&>(*m.get_layers().back());
+  El::DistMatrix<T, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU> out(
+    prob.get_activations().Grid());
+  El::Copy(prob.get_activations(), out);
+  return out.Matrix();
+}
+} // namespace
+
+TEST_CASE("Compiling models for inference", "[mpi][model][inference]")
+{
+  using DataType = float;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+  std::unique_ptr<lbann::model> model =
+    make_model<DataType>(comm, inference_test_model);
+  auto c = lbann::SGDExecutionContext(lbann::execution_mode::inference);
+  model->reset_mode(c, lbann::execution_mode::inference);
+
+  // Give the batch normalization non-trivial statistics and parameters
+  lbann::Layer* bn = nullptr;
+  for (auto* l : model->get_layers()) {
+    if (l->get_name() == "bn") {
+      bn = l;
+    }
+  }
+  REQUIRE(bn != nullptr);
+  for (size_t i = 0; i < bn->num_weights(); ++i) {
+    auto& values = dynamic_cast<lbann::data_type_weights<DataType>&>(
+                     bn->get_weights(i))
+                     .get_values_sharded();
+    for (El::Int channel = 0; channel < values.Height(); ++channel) {
+      values.Set(channel, 0, DataType(0.25) * (i + 1) + DataType(0.1) * channel);
+    }
+  }
+
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU> x(
+    28 * 28,
+    1,
+    g);
+  for (El::Int i = 0; i < x.Height(); ++i) {
+    x.Set(i, 0, DataType((i % 7) - 3) / DataType(7));
+  }
+  auto const expected = run_inference(*model, x);
+
+  model->compile_for_inference({&g});
+  CHECK(model->is_inference_only());
+
+  SECTION("Batch normalization is folded and identities are removed")
+  {
+    std::vector<std::string> names;
+    for (auto const* l : model->get_layers()) {
+      names.push_back(l->get_name());
+    }
+    CHECK(names == std::vector<std::string>{"inp", "fc", "prob"});
+    CHECK(model->get_layers()[1]->num_weights() == 2);
+  }
+
+  SECTION("Training state is released")
+  {
+    for (auto const* w : model->get_weights()) {
+      CHECK(w->is_frozen());
+      CHECK(w->get_optimizer() == nullptr);
+    }
+    auto train = lbann::SGDExecutionContext(lbann::execution_mode::training);
+    CHECK_THROWS(model->reset_mode(train, lbann::execution_mode::training));
+  }
+
+  SECTION("Outputs are unchanged")
+  {
+    model->reset_mode(c, lbann::execution_mode::inference);
+    auto const actual = run_inference(*model, x);
+    REQUIRE(actual.Height() == expected.Height());
+    for (El::Int i = 0; i < actual.Height(); ++i) {
+      CHECK(actual(i, 0) == Approx(expected(i, 0)).epsilon(1e-4));
+    }
+  }
+}
+
+namespace {
+const std::string entrywise_inference_test_model = R"""(
+model {
+  layer {
+    name: "inp"
+    children: "fc"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "inp"
+    children: "ebn"
+    fully_connected {
+      num_neurons: 6
+      has_bias: true
+    }
+  }
+  layer {
+    name: "ebn"
+    parents: "fc"
+    children: "sb"
+    entrywise_batch_normalization {
+      decay: 0.9
+      epsilon: 1e-5
+    }
+  }
+  layer {
+    name: "sb"
+    parents: "ebn"
+    children: "prob"
+    entrywise_scale_bias {
+    }
+  }
+  layer {
+    name: "prob"
+    parents: "sb"
+    softmax {
+    }
+  }
+}
+)""";
+} // namespace
+
+TEST_CASE("Folding entry-wise layers for inference",
+          "[mpi][model][inference]")
+{
+  using DataType = float;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+  std::unique_ptr<lbann::model> model =
+    make_model<DataType>(comm, entrywise_inference_test_model);
+  auto c = lbann::SGDExecutionContext(lbann::execution_mode::inference);
+  model->reset_mode(c, lbann::execution_mode::inference);
+
+  // Give the statistics, scales and biases non-trivial values
+  for (auto* l : model->get_layers()) {
+    if (l->get_name() != "ebn" && l->get_name() != "sb") {
+      continue;
+    }
+    for (size_t i = 0; i < l->num_weights(); ++i) {
+      auto& values = dynamic_cast<lbann::data_type_weights<DataType>&>(
+                       l->get_weights(i))
+                       .get_values_sharded();
+      for (El::Int col = 0; col < values.Width(); ++col) {
+        for (El::Int row = 0; row < values.Height(); ++row) {
+          values.Set(row,
+                     col,
+                     DataType(0.25) * (i + col + 1) + DataType(0.1) * row);
+        }
+      }
+    }
+  }
+
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU> x(
+    28 * 28,
+    1,
+    g);
+  for (El::Int i = 0; i < x.Height(); ++i) {
+    x.Set(i, 0, DataType((i % 7) - 3) / DataType(7));
+  }
+  auto const expected = run_inference(*model, x);
+
+  model->compile_for_inference({&g});
+
+  std::vector<std::string> names;
+  for (auto const* l : model->get_layers()) {
+    names.push_back(l->get_name());
+  }
+  CHECK(names == std::vector<std::string>{"inp", "fc", "prob"});
+
+  model->reset_mode(c, lbann::execution_mode::inference);
+  auto const actual = run_inference(*model, x);
+  REQUIRE(actual.Height() == expected.Height());
+  for (El::Int i = 0; i < actual.Height(); ++i) {
+    CHECK(actual(i, 0) == Approx(expected(i, 0)).epsilon(1e-4));
+  }
+}
+
+TEST_CASE("Int8 inference", "[mpi][model][inference]")
+{
+  using DataType = float;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+  std::unique_ptr<lbann::model> model =
+    make_model<DataType>(comm, inference_test_model);
+  auto c = lbann::SGDExecutionContext(lbann::execution_mode::inference);
+  model->reset_mode(c, lbann::execution_mode::inference);
+
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU> x(
+    28 * 28,
+    2,
+    g);
+  for (El::Int j = 0; j < x.Width(); ++j) {
+    for (El::Int i = 0; i < x.Height(); ++i) {
+      x.Set(i, j, DataType(((i + j) % 7) - 3) / DataType(7));
+    }
+  }
+  auto const expected = run_inference(*model, x);
+
+  lbann::Layer* fc = nullptr;
+  lbann::Layer* prob = nullptr;
+  for (auto* l : model->get_layers()) {
+    if (l->get_name() == "fc") {
+      fc = l;
+    }
+    if (l->get_name() == "prob") {
+      prob = l;
+    }
+  }
+  REQUIRE(fc != nullptr);
+  REQUIRE(prob != nullptr);
+  CHECK_FALSE(prob->set_int8_input_ranges({1.}));
+  CHECK_FALSE(prob->using_int8_inference());
+  REQUIRE(fc->set_int8_input_ranges({3. / 7.}));
+  CHECK(fc->using_int8_inference());
+
+  auto const actual = run_inference(*model, x);
+  REQUIRE(actual.Height() == expected.Height());
+  for (El::Int j = 0; j < actual.Width(); ++j) {
+    for (El::Int i = 0; i < actual.Height(); ++i) {
+      CHECK(actual(i, j) == Approx(expected(i, j)).margin(1e-2));
+    }
+  }
+
+  REQUIRE(fc->set_int8_input_ranges({}));
+  CHECK_FALSE(fc->using_int8_inference());
+}
+
+TEST_CASE("GPU graph capture keeps only the tensors it touches",
+          "[mpi][model][gpu_graph]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  lbann_data::LbannPB my_proto;
+  REQUIRE(pb::TextFormat::ParseFromString(model_prototext, &my_proto));
+  auto& trainer =
+    lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  unit_test::utilities::mock_data_reader(trainer, {1, 28, 28}, 10);
+  auto m = lbann::proto::construct_model(&comm,
+                                         my_proto.optimizer(),
+                                         my_proto.trainer(),
+                                         my_proto.model());
+  m->set_gpu_graph_capture(true);
+  m->setup(8UL, {&comm.get_trainer_grid()});
+
+  auto keeps = [&m](std::string const& name) {
+    for (auto const* l : m->get_layers()) {
+      if (l->get_name() == name) {
+        return m->keeps_step_activations(*l);
+      }
+    }
+    FAIL("no layer named " << name);
+    return false;
+  };
+
+#ifdef LBANN_HAS_CUDA
+  REQUIRE(m->uses_fp_graphs());
+  // Each relu is captured and reads its parent's activations
+  for (auto const* name : {"layer4",
+                           "layer5",
+                           "layer7",
+                           "layer8",
+                           "layer10",
+                           "layer11",
+                           "layer12",
+                           "layer13"}) {
+    CHECK(keeps(name));
+  }
+#endif // LBANN_HAS_CUDA
+  // Layers outside the graphs still release their activations early
+  for (auto const* name : {"image", "layer6", "layer9", "layer14", "layer15"}) {
+    CHECK_FALSE(keeps(name));
+  }
+}
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/models/pipeline_parallelism.hpp>
+
+#include <vector>
+
+using lbann::pipeline_step;
+
+namespace {
+std::vector<size_t> micro_batches(std::vector<pipeline_step> const& steps,
+                                  bool backward)
+{
+  std::vector<size_t> out;
+  for (auto const& step : steps) {
+    if (step.backward == backward) {
+      out.push_back(step.micro_batch);
+    }
+  }
+  return out;
+}
+} // namespace
+
+TEST_CASE("One-forward-one-backward pipeline schedule", "[model][pipeline]")
+{
+  SECTION("The last stage alternates from the start")
+  {
+    auto steps = lbann::make_1f1b_schedule(4, 3, 3);
+    REQUIRE(steps.size() == 6);
+    for (size_t i = 0; i < steps.size(); ++i) {
+      CHECK(steps[i].backward == (i % 2 == 1));
+      CHECK(steps[i].micro_batch == i / 2);
+    }
+  }
+
+  SECTION("Earlier stages warm up with forward passes")
+  {
+    auto steps = lbann::make_1f1b_schedule(4, 0, 6);
+    REQUIRE(steps.size() == 12);
+    for (size_t i = 0; i < 3; ++i) {
+      CHECK_FALSE(steps[i].backward);
+    }
+    CHECK(steps[3].micro_batch == 3);
+    CHECK_FALSE(steps[3].backward);
+    CHECK(steps[4].micro_batch == 0);
+    CHECK(steps[4].backward);
+  }
+
+  SECTION("Every micro-batch runs once each way, in order")
+  {
+    for (size_t stage = 0; stage < 4; ++stage) {
+      auto steps = lbann::make_1f1b_schedule(4, stage, 5);
+      const std::vector<size_t> expected{0, 1, 2, 3, 4};
+      CHECK(micro_batches(steps, false) == expected);
+      CHECK(micro_batches(steps, true) == expected);
+    }
+  }
+
+  SECTION("A micro-batch runs backward only after it runs forward")
+  {
+    for (size_t stage = 0; stage < 3; ++stage) {
+      auto steps = lbann::make_1f1b_schedule(3, stage, 2);
+      size_t num_forward = 0;
+      for (auto const& step : steps) {
+        if (step.backward) {
+          CHECK(step.micro_batch < num_forward);
+        }
+        else {
+          ++num_forward;
+        }
+      }
+    }
+  }
+
+  SECTION("Invalid stages are rejected")
+  {
+    CHECK_THROWS(lbann::make_1f1b_schedule(2, 2, 4));
+  }
+}
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/layer.hpp>
+
+#include <string>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::setup_model;
+
+// Two model-parallel layers consume the same data-parallel tensor
+const std::string model_prototext = R"""(
+model {
+  layer {
+    name: "inp"
+    weights: "dummy_inputs"
+    weights_layer {
+      dims: 3
+    }
+  }
+  layer {
+    name: "a"
+    parents: "inp"
+    data_layout: "model_parallel"
+    dummy {
+    }
+  }
+  layer {
+    name: "b"
+    parents: "inp"
+    data_layout: "model_parallel"
+    dummy {
+    }
+  }
+  weights {
+    name: "dummy_inputs"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 3.4
+        values: -5.67
+      }
+    }
+  }
+}
+)""";
+
+} // namespace
+
+TEST_CASE("Redistributions between layers", "[mpi][model]")
+{
+  auto m = construct_model(model_prototext);
+  setup_model(*m);
+
+  auto& a = find_layer(*m, "a");
+  auto& b = find_layer(*m, "b");
+
+  // Both layers copy the data-parallel output
+  CHECK(a.get_input_redistribution_bytes(0) == 3 * sizeof(lbann::DataType));
+  CHECK(b.get_input_redistribution_bytes(0) == 3 * sizeof(lbann::DataType));
+
+  // Siblings can share a copy, but a layer cannot share with itself
+  CHECK(b.share_input_redistribution(0, a));
+  CHECK_FALSE(a.share_input_redistribution(0, a));
+
+  REQUIRE_NOTHROW(m->forward_prop(lbann::execution_mode::training));
+}
@@ -104,6 +104,23 @@ EvalType layer_term::finish_evaluation()
   return eval.get_value();
 }
 
+bool layer_term::is_accumulated() const
+{
+  const auto* eval =
+    dynamic_cast<const abstract_evaluation_layer<DataType>*>(&get_layer());
+  return eval != nullptr && eval->get_accumulation_window() > 1;
+}
+
+EvalType layer_term::take_accumulated_value(execution_mode mode, bool wait)
+{
+  if (m_scale_factor == EvalType(0)) {
+    return EvalType(0);
+  }
+  auto& eval =
+    dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer());
+  return m_scale_factor * eval.take_accumulated_value(mode, wait).first;
+}
+
 void layer_term::differentiate()
 {
   auto& eval =
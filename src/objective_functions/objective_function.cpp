@@ -106,20 +106,43 @@ EvalType objective_function::finish_evaluation(execution_mode mode,
 {
   const auto start_time = get_time();
   EvalType value = EvalType(0);
+  EvalType step_value = EvalType(0);
+  EvalType accumulated = EvalType(0);
   prof_region_begin("obj-finish-eval", prof_colors[0], false);
   for (auto&& term : m_terms) {
     prof_region_begin(("obj-finish-eval-" + term->name()).c_str(),
                       prof_colors[1],
                       false);
-    value += term->finish_evaluation();
+    const auto term_value = term->finish_evaluation();
+    value += term_value;
+    if (term->is_accumulated()) {
+      accumulated += term->take_accumulated_value(mode, false);
+    }
+    else {
+      step_value += term_value;
+    }
     prof_region_end(("obj-finish-eval-" + term->name()).c_str(), false);
   }
   prof_region_end("obj-finish-eval", false);
-  m_statistics[mode].add_value(mini_batch_size * value, mini_batch_size);
+  // Accumulated terms arrive a window late, but the sample count is
+  // kept current so the mean is exact once they are flushed.
+  m_statistics[mode].add_value(mini_batch_size * step_value + accumulated,
+                               mini_batch_size);
   m_evaluation_time += get_time() - start_time;
   return value;
 }
 
+void objective_function::flush_accumulated_values(execution_mode mode)
+{
+  EvalType accumulated = EvalType(0);
+  for (auto&& term : m_terms) {
+    if (term->is_accumulated()) {
+      accumulated += term->take_accumulated_value(mode, true);
+    }
+  }
+  m_statistics[mode].add_value(accumulated, 0);
+}
+
 void objective_function::differentiate()
 {
   const auto start_time = get_time();
@@ -25,22 +25,45 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/optimizers/adagrad_impl.hpp"
+#include "lbann/optimizers/fused_update.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/profiling.hpp"
 
 namespace lbann {
 
+namespace {
+
+template <typename TensorDataType>
+struct adagrad_update
+{
+  TensorDataType learning_rate;
+  TensorDataType eps;
+  bool operator()(TensorDataType& x,
+                  TensorDataType g,
+                  TensorDataType& c,
+                  TensorDataType&) const
+  {
+    c += g * g;
+    x -= learning_rate * g / (El::Sqrt(c) + eps);
+    return true;
+  }
+};
+
+} // namespace
+
 template <typename TensorDataType>
 adagrad<TensorDataType>::adagrad(TensorDataType learning_rate,
-                                 TensorDataType eps)
-  : BaseType(learning_rate), m_eps(eps)
+                                 TensorDataType eps,
+                                 TensorDataType weight_decay)
+  : BaseType(learning_rate), m_eps(eps), m_weight_decay(weight_decay)
 {}
 
 template <typename TensorDataType>
 adagrad<TensorDataType>::adagrad(const adagrad<TensorDataType>& other)
   : BaseType(other),
     m_eps(other.m_eps),
+    m_weight_decay(other.m_weight_decay),
     m_cache(other.m_cache ? other.m_cache->Copy() : nullptr)
 {}
 
@@ -50,6 +73,7 @@ adagrad<TensorDataType>::operator=(const adagrad<TensorDataType>& other)
 {
   OptimizerType::operator=(other);
   m_eps = other.m_eps;
+  m_weight_decay = other.m_weight_decay;
   m_cache.reset(other.m_cache ? other.m_cache->Copy() : nullptr);
   return *this;
 }
@@ -59,6 +83,9 @@ description adagrad<TensorDataType>::get_description() const
 {
   auto desc = OptimizerType::get_description();
   desc.add("eps", m_eps);
+  if (m_weight_decay != El::To<TensorDataType>(0)) {
+    desc.add("Weight decay", m_weight_decay);
+  }
   return desc;
 }
 
@@ -84,6 +111,7 @@ void adagrad<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
   auto* opt = proto.mutable_adagrad();
   opt->set_learn_rate(this->get_learning_rate());
   opt->set_eps(m_eps);
+  opt->set_weight_decay(m_weight_decay);
 }
 
 template <typename TensorDataType>
@@ -113,29 +141,14 @@ void adagrad<TensorDataType>::step_compute_cpu(
   const AbsDistMatrixType& gradient)
 {
   LBANN_CALIPER_MARK_SCOPE("adagrad::step_compute");
-
-  // Get local matrix data
-  const size_t local_height = values.LocalHeight();
-  const size_t local_width = values.LocalWidth();
-  auto* __restrict__ values_buffer = values.Buffer();
-  const size_t values_ldim = values.LDim();
-  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
-  const size_t gradient_ldim = gradient.LDim();
-  auto* __restrict__ cache_buffer = m_cache->Buffer();
-  const size_t cache_ldim = m_cache->LDim();
-
-  // Apply AdaGrad step
   const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
-  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
-  for (size_t col = 0; col < local_width; ++col) {
-    for (size_t row = 0; row < local_height; ++row) {
-      auto& x = values_buffer[row + col * values_ldim];
-      const auto& g = gradient_buffer[row + col * gradient_ldim];
-      auto& c = cache_buffer[row + col * cache_ldim];
-      c += g * g;
-      x -= learning_rate * g / (El::Sqrt(c) + m_eps);
-    }
-  }
+  fused_update::apply_cpu(
+    values,
+    gradient,
+    m_cache.get(),
+    nullptr,
+    learning_rate * m_weight_decay,
+    adagrad_update<TensorDataType>{learning_rate, m_eps});
 }
 
 template <typename TensorDataType>
@@ -145,7 +158,8 @@ build_adagrad_optimizer_from_pbuf(google::protobuf::Message const& msg)
   const auto& params = dynamic_cast<lbann_data::Optimizer::AdaGrad const&>(msg);
   return std::make_unique<adagrad<TensorDataType>>(
     TensorDataType(params.learn_rate()),
-    TensorDataType(params.eps()));
+    TensorDataType(params.eps()),
+    TensorDataType(params.weight_decay()));
 }
 
 #define PROTO(T)                                                               \
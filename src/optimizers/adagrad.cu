@@ -28,34 +28,27 @@
 #include "lbann/utils/gpu/helpers.hpp"
 #include "lbann/utils/profiling.hpp"
 
+#include "fused_update.cuh"
+
 namespace lbann {
 
 namespace {
 
 template <typename TensorDataType>
-__global__ void adagrad_kernel(size_t height,
-                               size_t width,
-                               TensorDataType learning_rate,
-                               TensorDataType eps,
-                               TensorDataType* __restrict__ values,
-                               size_t values_ldim,
-                               const TensorDataType* __restrict__ gradient,
-                               size_t gradient_ldim,
-                               TensorDataType* __restrict__ cache,
-                               size_t cache_ldim)
+struct adagrad_update
 {
-  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
-  const size_t nthreads = blockDim.x * gridDim.x;
-  for (size_t pos = gid; pos < height * width; pos += nthreads) {
-    const auto& row = pos % height;
-    const auto& col = pos / height;
-    auto& x = values[row + col * values_ldim];
-    const auto& g = gradient[row + col * gradient_ldim];
-    auto& c = cache[row + col * cache_ldim];
+  TensorDataType learning_rate;
+  TensorDataType eps;
+  __device__ bool operator()(TensorDataType& x,
+                             TensorDataType g,
+                             TensorDataType& c,
+                             TensorDataType&) const
+  {
     c += g * g;
     x -= learning_rate * g / (gpu_lib::sqrt(c) + eps);
+    return true;
   }
-}
+};
 
 } // namespace
 
@@ -65,30 +58,18 @@ void adagrad<TensorDataType>::step_compute_gpu(
   const AbsDistMatrixType& gradient)
 {
   LBANN_CALIPER_MARK_SCOPE("adagrad::step_compute");
-  const size_t local_height = values.LocalHeight();
-  const size_t local_width = values.LocalWidth();
-  const size_t local_size = local_height * local_width;
-  if (local_size > 0) {
-    auto multisync = El::MakeMultiSync(gpu::get_sync_info(values),
-                                       gpu::get_sync_info(gradient));
-    constexpr size_t block_size = 256;
-    const size_t grid_size = (local_size + block_size - 1) / block_size;
-    hydrogen::gpu::LaunchKernel(adagrad_kernel<TensorDataType>,
-                                grid_size,
-                                block_size,
-                                0,
-                                multisync,
-                                local_height,
-                                local_width,
-                                this->get_learning_rate(),
-                                m_eps,
-                                values.Buffer(),
-                                values.LDim(),
-                                gradient.LockedBuffer(),
-                                gradient.LDim(),
-                                m_cache->Buffer(),
-                                m_cache->LDim());
-  }
+  const auto weight_decay = El::To<TensorDataType>(
+    this->get_learning_rate() * El::To<float>(m_weight_decay));
+  fused_update::apply_gpu(
+    values,
+    gradient,
+    m_cache.get(),
+    nullptr,
+    weight_decay,
+    adagrad_update<TensorDataType>{
+      El::To<TensorDataType>(this->get_learning_rate()),
+      m_eps},
+    this->get_step_scale());
 }
 
 #ifdef LBANN_HAS_HALF
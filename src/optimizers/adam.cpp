@@ -26,12 +26,15 @@
 
 #include "lbann/optimizers/adam.hpp"
 #include "lbann/optimizers/adam_impl.hpp"
+#include "lbann/optimizers/fused_update.hpp"
 #include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/profiling.hpp"
 
+#include <sstream>
+
 namespace lbann {
 
 #if defined(LBANN_HAS_GPU_FP16)
@@ -41,6 +44,33 @@ bool isfinite(fp16 const& x) { return std::isfinite(float(x)); }
 #endif
 using std::isfinite;
 
+namespace {
+
+template <typename TensorDataType>
+struct adam_update
+{
+  TensorDataType correction;
+  TensorDataType eps;
+  TensorDataType beta1;
+  TensorDataType beta2;
+  bool operator()(TensorDataType& x,
+                  TensorDataType g,
+                  TensorDataType& m1,
+                  TensorDataType& m2) const
+  {
+    static const auto one = TensorDataType(1.);
+    if (!isfinite(g)) {
+      return false;
+    }
+    m1 = beta1 * m1 + (one - beta1) * g;
+    m2 = beta2 * m2 + (one - beta2) * g * g;
+    x -= correction * (m1 / (El::Sqrt(m2) + eps));
+    return true;
+  }
+};
+
+} // namespace
+
 template <typename TensorDataType>
 adam<TensorDataType>::adam(TensorDataType learning_rate,
                            TensorDataType beta1,
@@ -63,6 +93,8 @@ adam<TensorDataType>::adam(const adam& other)
     m_adamw_weight_decay(other.m_adamw_weight_decay),
     m_current_beta1(other.m_current_beta1),
     m_current_beta2(other.m_current_beta2),
+    m_previous_beta1(other.m_previous_beta1),
+    m_previous_beta2(other.m_previous_beta2),
     m_moment1(other.m_moment1 ? other.m_moment1->Copy() : nullptr),
     m_moment2(other.m_moment2 ? other.m_moment2->Copy() : nullptr)
 {}
@@ -78,6 +110,8 @@ adam<TensorDataType>::operator=(const adam<TensorDataType>& other)
   m_adamw_weight_decay = other.m_adamw_weight_decay;
   m_current_beta1 = other.m_current_beta1;
   m_current_beta2 = other.m_current_beta2;
+  m_previous_beta1 = other.m_previous_beta1;
+  m_previous_beta2 = other.m_previous_beta2;
   m_moment1.reset(other.m_moment1 ? other.m_moment1->Copy() : nullptr);
   m_moment2.reset(other.m_moment2 ? other.m_moment2->Copy() : nullptr);
   return *this;
@@ -96,6 +130,13 @@ description adam<TensorDataType>::get_description() const
   return desc;
 }
 
+template <typename TensorDataType>
+void adam<TensorDataType>::undo_skipped_step()
+{
+  m_current_beta1 = m_previous_beta1;
+  m_current_beta2 = m_previous_beta2;
+}
+
 template <typename TensorDataType>
 size_t adam<TensorDataType>::get_state_size() const
 {
@@ -174,6 +215,8 @@ void adam<TensorDataType>::step_compute(AbsDistMatrixType& values,
   static const auto one = TensorDataType(1.);
 
   // Precompute the bias correction and learning rate.
+  m_previous_beta1 = m_current_beta1;
+  m_previous_beta2 = m_current_beta2;
   m_current_beta1 *= m_beta1;
   m_current_beta2 *= m_beta2;
   const TensorDataType correction =
@@ -197,68 +240,54 @@ void adam<TensorDataType>::step_compute(AbsDistMatrixType& values,
   }
 }
 
+template <typename TensorDataType>
+std::string adam<TensorDataType>::get_multi_tensor_hyperparameters() const
+{
+  std::ostringstream ss;
+  ss << std::hexfloat << El::To<double>(m_beta1) << ' '
+     << El::To<double>(m_beta2) << ' ' << El::To<double>(m_eps) << ' '
+     << El::To<double>(m_adamw_weight_decay) << ' '
+     << El::To<double>(m_current_beta1) << ' '
+     << El::To<double>(m_current_beta2);
+  return ss.str();
+}
+
+template <typename TensorDataType>
+bool adam<TensorDataType>::get_multi_tensor_entry(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  multi_tensor_entry<TensorDataType>& entry)
+{
+  if (!values.Contiguous() || !gradient.Contiguous() ||
+      !m_moment1->Contiguous() || !m_moment2->Contiguous()) {
+    return false;
+  }
+  m_previous_beta1 = m_current_beta1;
+  m_previous_beta2 = m_current_beta2;
+  m_current_beta1 *= m_beta1;
+  m_current_beta2 *= m_beta2;
+  entry = {values.Buffer(),
+           gradient.LockedBuffer(),
+           m_moment1->Buffer(),
+           m_moment2->Buffer(),
+           static_cast<size_t>(values.LocalHeight() * values.LocalWidth())};
+  return true;
+}
+
 template <typename TensorDataType>
 void adam<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
                                             const AbsDistMatrixType& gradient,
                                             const TensorDataType& correction)
 {
   LBANN_CALIPER_MARK_SCOPE("adam::step_compute");
-  static const auto one = TensorDataType(1.);
-
   const TensorDataType lr = El::To<TensorDataType>(this->get_learning_rate());
-
-  // Get local matrix data
-  const size_t local_height = values.LocalHeight();
-  const size_t local_width = values.LocalWidth();
-  auto* __restrict__ values_buffer = values.Buffer();
-  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
-  auto* __restrict__ moment1_buffer = m_moment1->Buffer();
-  auto* __restrict__ moment2_buffer = m_moment2->Buffer();
-
-  if (values.Contiguous() && gradient.Contiguous() && m_moment1->Contiguous() &&
-      m_moment2->Contiguous()) {
-
-    // Update with contiguous data
-    const size_t local_size = local_height * local_width;
-    LBANN_OMP_PARALLEL_FOR
-    for (size_t i = 0; i < local_size; ++i) {
-      auto& x = values_buffer[i];
-      const auto& g = gradient_buffer[i];
-      if (!isfinite(g)) {
-        continue;
-      }
-      auto& m1 = moment1_buffer[i];
-      auto& m2 = moment2_buffer[i];
-      m1 = m_beta1 * m1 + (one - m_beta1) * g;
-      m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
-      x -= correction * (m1 / (El::Sqrt(m2) + m_eps)) +
-           lr * m_adamw_weight_decay * x;
-    }
-  }
-  else {
-
-    // Update with non-contiguous data
-    const size_t values_ldim = values.LDim();
-    const size_t gradient_ldim = gradient.LDim();
-    const size_t moment1_ldim = m_moment1->LDim();
-    const size_t moment2_ldim = m_moment2->LDim();
-    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
-    for (size_t col = 0; col < local_width; ++col) {
-      for (size_t row = 0; row < local_height; ++row) {
-        auto& x = values_buffer[row + col * values_ldim];
-        const auto& g = gradient_buffer[row + col * gradient_ldim];
-        if (!isfinite(g)) {
-          continue;
-        }
-        auto& m1 = moment1_buffer[row + col * moment1_ldim];
-        auto& m2 = moment2_buffer[row + col * moment2_ldim];
-        m1 = m_beta1 * m1 + (one - m_beta1) * g;
-        m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
-        x -= correction * (m1 / (El::Sqrt(m2) + m_eps)) +
-             lr * m_adamw_weight_decay * x;
-      }
-    }
-  }
+  fused_update::apply_cpu(
+    values,
+    gradient,
+    m_moment1.get(),
+    m_moment2.get(),
+    lr * m_adamw_weight_decay,
+    adam_update<TensorDataType>{correction, m_eps, m_beta1, m_beta2});
 }
 
 template <typename TensorDataType>
@@ -28,74 +28,58 @@
 #include "lbann/utils/gpu/helpers.hpp"
 #include "lbann/utils/profiling.hpp"
 
+#include "fused_update.cuh"
+
 namespace lbann {
 
 namespace {
 
 template <typename TensorDataType>
-__global__ void
-adam_noncontiguous_kernel(size_t height,
-                          size_t width,
-                          TensorDataType correction,
-                          TensorDataType eps,
-                          TensorDataType beta1,
-                          TensorDataType beta2,
-                          TensorDataType weight_decay,
-                          TensorDataType* __restrict__ values,
-                          size_t values_ldim,
-                          const TensorDataType* __restrict__ gradient,
-                          size_t gradient_ldim,
-                          TensorDataType* __restrict__ moment1,
-                          size_t moment1_ldim,
-                          TensorDataType* __restrict__ moment2,
-                          size_t moment2_ldim)
+struct adam_update
 {
-  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
-  if (gid < height * width) {
-    const auto& row = gid % height;
-    const auto& col = gid / height;
-    const auto& g = gradient[row + col * gradient_ldim];
+  TensorDataType correction;
+  TensorDataType eps;
+  TensorDataType beta1;
+  TensorDataType beta2;
+  __device__ bool operator()(TensorDataType& x,
+                             TensorDataType g,
+                             TensorDataType& m1,
+                             TensorDataType& m2) const
+  {
     if (gpu_lib::isinf(g) || gpu_lib::isnan(g)) {
-      return;
+      return false;
     }
-    auto& m1 = moment1[row + col * moment1_ldim];
-    auto& m2 = moment2[row + col * moment2_ldim];
-    auto& x = values[row + col * values_ldim];
     m1 = beta1 * m1 + (TensorDataType(1) - beta1) * g;
     m2 = beta2 * m2 + (TensorDataType(1) - beta2) * g * g;
-    x -= correction * (m1 / (gpu_lib::sqrt(m2) + eps)) + weight_decay * x;
+    x -= correction * (m1 / (gpu_lib::sqrt(m2) + eps));
+    return true;
   }
-}
+};
+
+} // namespace
 
 template <typename TensorDataType>
-__global__ void
-adam_contiguous_kernel(size_t size,
-                       TensorDataType correction,
-                       TensorDataType eps,
-                       TensorDataType beta1,
-                       TensorDataType beta2,
-                       TensorDataType weight_decay,
-                       TensorDataType* __restrict__ values,
-                       const TensorDataType* __restrict__ gradient,
-                       TensorDataType* __restrict__ moment1,
-                       TensorDataType* __restrict__ moment2)
+void adam<TensorDataType>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
 {
-  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
-  if (gid < size) {
-    const auto& g = gradient[gid];
-    if (gpu_lib::isinf(g) || gpu_lib::isnan(g)) {
-      return;
-    }
-    auto& m1 = moment1[gid];
-    auto& m2 = moment2[gid];
-    auto& x = values[gid];
-    m1 = beta1 * m1 + (TensorDataType(1) - beta1) * g;
-    m2 = beta2 * m2 + (TensorDataType(1) - beta2) * g * g;
-    x -= correction * (m1 / (gpu_lib::sqrt(m2) + eps)) + weight_decay * x;
-  }
-}
+  LBANN_CALIPER_MARK_SCOPE("adam::multi_tensor_step");
+  static const auto one = TensorDataType(1.);
 
-} // namespace
+  // Every entry has advanced the bias correction to the same step
+  const TensorDataType correction =
+    El::To<TensorDataType>(this->get_learning_rate()) *
+    (El::Sqrt(one - m_current_beta2) / (one - m_current_beta1));
+  const TensorDataType adjusted_weight_decay = El::To<TensorDataType>(
+    this->get_learning_rate() * El::To<float>(m_adamw_weight_decay));
+  fused_update::apply_multi_tensor(
+    entries,
+    adjusted_weight_decay,
+    adam_update<TensorDataType>{correction, m_eps, m_beta1, m_beta2},
+    this->get_step_scale(),
+    this->m_multi_tensor_workspace,
+    sync_info);
+}
 
 template <typename TensorDataType>
 void adam<TensorDataType>::step_compute_gpu(AbsDistMatrixType& values,
@@ -103,63 +87,16 @@ void adam<TensorDataType>::step_compute_gpu(AbsDistMatrixType& values,
                                             const TensorDataType& correction)
 {
   LBANN_CALIPER_MARK_SCOPE("adam::step_compute");
-
   const TensorDataType adjusted_weight_decay = El::To<TensorDataType>(
     this->get_learning_rate() * El::To<float>(m_adamw_weight_decay));
-
-  // Get matrix dimensions
-  const size_t local_height = values.LocalHeight();
-  const size_t local_width = values.LocalWidth();
-  const size_t local_size = local_height * local_width;
-  if (local_size <= 0) {
-    return;
-  }
-
-  // Launch GPU kernel
-  constexpr size_t block_size = 256;
-  const size_t grid_size = (local_size + block_size - 1) / block_size;
-  auto multisync =
-    El::MakeMultiSync(gpu::get_sync_info(values), gpu::get_sync_info(gradient));
-  if (values.Contiguous() && gradient.Contiguous() && m_moment1->Contiguous() &&
-      m_moment2->Contiguous()) {
-    hydrogen::gpu::LaunchKernel(adam_contiguous_kernel<TensorDataType>,
-                                grid_size,
-                                block_size,
-                                0,
-                                multisync,
-                                local_size,
-                                correction,
-                                m_eps,
-                                m_beta1,
-                                m_beta2,
-                                adjusted_weight_decay,
-                                values.Buffer(),
-                                gradient.LockedBuffer(),
-                                m_moment1->Buffer(),
-                                m_moment2->Buffer());
-  }
-  else {
-    hydrogen::gpu::LaunchKernel(adam_noncontiguous_kernel<TensorDataType>,
-                                grid_size,
-                                block_size,
-                                0,
-                                multisync,
-                                local_height,
-                                local_width,
-                                correction,
-                                m_eps,
-                                m_beta1,
-                                m_beta2,
-                                adjusted_weight_decay,
-                                values.Buffer(),
-                                values.LDim(),
-                                gradient.LockedBuffer(),
-                                gradient.LDim(),
-                                m_moment1->Buffer(),
-                                m_moment1->LDim(),
-                                m_moment2->Buffer(),
-                                m_moment2->LDim());
-  }
+  fused_update::apply_gpu(
+    values,
+    gradient,
+    m_moment1.get(),
+    m_moment2.get(),
+    adjusted_weight_decay,
+    adam_update<TensorDataType>{correction, m_eps, m_beta1, m_beta2},
+    this->get_step_scale());
 }
 
 #ifdef LBANN_HAS_HALF
@@ -170,12 +107,23 @@ void adam<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
 {
   LBANN_ERROR("Can't call this function with cpu_fp16!");
 }
+
+template <>
+void adam<cpu_fp16>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
 #endif // LBANN_HAS_HALF
 
 #define PROTO(T)                                                               \
   template void adam<T>::step_compute_gpu(El::AbstractDistMatrix<T>&,          \
                                           const El::AbstractDistMatrix<T>&,    \
-                                          const T&)
+                                          const T&);                           \
+  template void adam<T>::multi_tensor_step_compute(                            \
+    std::vector<multi_tensor_entry<T>> const&,                                 \
+    El::SyncInfo<El::Device::GPU> const&)
 
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
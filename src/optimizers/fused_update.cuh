@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SRC_OPTIMIZERS_FUSED_UPDATE_CUH_INCLUDED
+#define LBANN_SRC_OPTIMIZERS_FUSED_UPDATE_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/optimizers/fused_update.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+#include "multi_tensor.cuh"
+
+namespace lbann {
+namespace fused_update {
+
+/** @brief Update one entry; see lbann/optimizers/fused_update.hpp */
+template <typename TensorDataType, typename OpT>
+__device__ __forceinline__ void update(OpT const& op,
+                                       TensorDataType weight_decay,
+                                       TensorDataType& x,
+                                       TensorDataType g,
+                                       TensorDataType* s0,
+                                       TensorDataType* s1)
+{
+  TensorDataType scratch0(0), scratch1(0);
+  const auto x0 = x;
+  if (op(x,
+         g,
+         s0 != nullptr ? *s0 : scratch0,
+         s1 != nullptr ? *s1 : scratch1) &&
+      weight_decay != TensorDataType(0)) {
+    x -= weight_decay * x0;
+  }
+}
+
+template <typename TensorDataType, typename OpT>
+__global__ void apply_kernel(size_t height,
+                             size_t width,
+                             TensorDataType* __restrict__ values,
+                             size_t values_ldim,
+                             const TensorDataType* __restrict__ gradient,
+                             size_t gradient_ldim,
+                             TensorDataType* __restrict__ state0,
+                             size_t state0_ldim,
+                             TensorDataType* __restrict__ state1,
+                             size_t state1_ldim,
+                             TensorDataType weight_decay,
+                             OpT op,
+                             const float* __restrict__ step_scale)
+{
+  if (step_scale != nullptr && *step_scale == 0.f) {
+    return;
+  }
+  const TensorDataType scale =
+    step_scale != nullptr ? TensorDataType(*step_scale) : TensorDataType(1);
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t pos = gid; pos < height * width; pos += nthreads) {
+    const auto row = pos % height;
+    const auto col = pos / height;
+    update(op,
+           weight_decay,
+           values[row + col * values_ldim],
+           scale * gradient[row + col * gradient_ldim],
+           state0 != nullptr ? state0 + row + col * state0_ldim : nullptr,
+           state1 != nullptr ? state1 + row + col * state1_ldim : nullptr);
+  }
+}
+
+/** @brief Apply @c op to the local entries on the GPU.
+ *
+ *  The gradient is multiplied by @c step_scale (one if it is null)
+ *  and nothing is updated if it is zero.
+ */
+template <typename TensorDataType, typename OpT>
+void apply_gpu(El::AbstractDistMatrix<TensorDataType>& values,
+               El::AbstractDistMatrix<TensorDataType> const& gradient,
+               El::AbstractDistMatrix<TensorDataType>* state0,
+               El::AbstractDistMatrix<TensorDataType>* state1,
+               TensorDataType weight_decay,
+               OpT const& op,
+               float const* step_scale)
+{
+  const size_t local_height = values.LocalHeight();
+  const size_t local_width = values.LocalWidth();
+  const size_t local_size = local_height * local_width;
+  if (local_size == 0) {
+    return;
+  }
+  constexpr size_t block_size = 256;
+  dim3 grid_dims((local_size + block_size - 1) / block_size);
+  gpu_lib::clip_grid_dims(grid_dims);
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(values), gpu::get_sync_info(gradient));
+  hydrogen::gpu::LaunchKernel(
+    apply_kernel<TensorDataType, OpT>,
+    grid_dims,
+    block_size,
+    0,
+    multisync,
+    local_height,
+    local_width,
+    values.Buffer(),
+    static_cast<size_t>(values.LDim()),
+    gradient.LockedBuffer(),
+    static_cast<size_t>(gradient.LDim()),
+    state0 != nullptr ? state0->Buffer() : nullptr,
+    static_cast<size_t>(state0 != nullptr ? state0->LDim() : 0),
+    state1 != nullptr ? state1->Buffer() : nullptr,
+    static_cast<size_t>(state1 != nullptr ? state1->LDim() : 0),
+    weight_decay,
+    op,
+    step_scale);
+}
+
+/** @brief Adapts an update rule to multi_tensor::apply */
+template <typename TensorDataType, typename OpT>
+struct multi_tensor_op
+{
+  OpT op;
+  TensorDataType weight_decay;
+  __device__ void operator()(multi_tensor_entry<TensorDataType> const& e,
+                             size_t i,
+                             TensorDataType scale) const
+  {
+    update(op,
+           weight_decay,
+           e.values[i],
+           scale * e.gradient[i],
+           e.state0 != nullptr ? e.state0 + i : nullptr,
+           e.state1 != nullptr ? e.state1 + i : nullptr);
+  }
+};
+
+/** @brief Apply @c op to many contiguous tensors in one launch. */
+template <typename TensorDataType, typename OpT>
+void apply_multi_tensor(
+  std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+  TensorDataType weight_decay,
+  OpT const& op,
+  float const* step_scale,
+  multi_tensor_workspace& workspace,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  const multi_tensor_op<TensorDataType, OpT> mt_op{op, weight_decay};
+  multi_tensor::apply(entries, mt_op, step_scale, workspace, sync_info);
+}
+
+} // namespace fused_update
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_OPTIMIZERS_FUSED_UPDATE_CUH_INCLUDED
@@ -0,0 +1,330 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/gradient_clipping.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/optimizers/multi_tensor.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/profiling.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <h2/patterns/multimethods/SwitchDispatcher.hpp>
+
+#include <cmath>
+#include <type_traits>
+
+namespace lbann {
+namespace gradient_clipping {
+namespace {
+
+bool on_subgrid(El::BaseDistMatrix const& mat, lbann_comm const& comm)
+{
+  return mat.DistData().grid->Size() != comm.get_trainer_grid().Size();
+}
+
+/** Base for functors dispatched on the data type of weights. */
+struct WeightsFunctor
+{
+  template <typename... Ts>
+  void DispatchError(Ts&&...)
+  {
+    LBANN_ERROR("Unable to dispatch functor.");
+  }
+
+  template <typename... Ts>
+  void DeductionError(Ts&&...)
+  {
+    LBANN_ERROR("Unable to deduce an argument type.");
+  }
+};
+
+template <typename FunctorT>
+void dispatch(FunctorT functor, weights& w)
+{
+  using WeightsTypes =
+    h2::meta::tlist::ExpandTL<data_type_weights, supported_layer_data_type>;
+  using Dispatcher =
+    h2::multimethods::SwitchDispatcher<FunctorT, void, weights, WeightsTypes>;
+  Dispatcher::Exec(std::move(functor), w);
+}
+
+/** Adds the squared norm of a gradient to the replicated or the
+ *  sharded sum. Sharded sums are allreduced over the trainer later;
+ *  gradients on a subgrid are weighted so that allreduce counts them
+ *  once.
+ */
+struct NormComputer : WeightsFunctor
+{
+  lbann_comm const& comm;
+  DataType* norm;
+  DataType* sharded_norm;
+  bool* any_sharded;
+#ifdef LBANN_HAS_GPU
+  multi_tensor_sum_of_squares* gpu_sums;
+#endif // LBANN_HAS_GPU
+
+  template <typename TensorDataType>
+  void operator()(data_type_weights<TensorDataType>& dtw)
+  {
+    auto& grad = dtw.get_optimizer()->get_gradient_sharded();
+    bool sharded = false;
+    DataType weight = DataType(1);
+    if (dtw.is_sharded()) {
+      sharded = true;
+    }
+    else if (on_subgrid(grad, comm)) {
+      sharded = true;
+      weight = DataType(1) / DataType(grad.RedundantSize());
+    }
+    if (sharded) {
+      *any_sharded = true;
+    }
+
+    const auto& gradmat = grad.LockedMatrix();
+    TensorDataType local_norm = El::To<TensorDataType>(0);
+    if (gradmat.GetDevice() == El::Device::CPU) {
+      const auto& gradmatrix =
+        static_cast<const El::Matrix<TensorDataType, El::Device::CPU>&>(
+          gradmat);
+      // Nrm2 is not supported on CPU matrices with __half.
+#ifdef LBANN_HAS_GPU_FP16
+      if constexpr (!std::is_same_v<TensorDataType, __half>) {
+        local_norm = El::Nrm2(gradmatrix);
+      }
+      else {
+        LBANN_ERROR("Cannot clip a CPU matrix using the GPU half type");
+      }
+#else
+      local_norm = El::Nrm2(gradmatrix);
+#endif // LBANN_HAS_GPU_FP16
+    }
+#ifdef LBANN_HAS_GPU
+    else if (gradmat.GetDevice() == El::Device::GPU) {
+      const auto& gradmatrix =
+        static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(
+          gradmat);
+      if (!gradmatrix.Contiguous()) {
+        LBANN_ERROR("Cannot compute l2 norm of noncontiguous gradient");
+      }
+
+      // Defer to one launch per data type, read back once
+      if constexpr (multi_tensor_sum_of_squares_supports<
+                      TensorDataType>::value) {
+        gpu_sums->add(gradmatrix.LockedBuffer(),
+                      gradmatrix.Height() * gradmatrix.Width(),
+                      sharded ? 1 : 0,
+                      weight);
+        return;
+      }
+
+      hydrogen::gpu_blas::Nrm2(
+        size_t(gradmatrix.Width() * gradmatrix.Height()),
+        gradmatrix.LockedBuffer(),
+        size_t(1),
+        &local_norm,
+        gpu::get_sync_info(gradmatrix));
+    }
+#endif // LBANN_HAS_GPU
+    const auto sq_norm = El::To<DataType>(local_norm * local_norm);
+    *(sharded ? sharded_norm : norm) += weight * sq_norm;
+  }
+};
+
+/** Scales a gradient by a constant. */
+struct GradientScaler : WeightsFunctor
+{
+  DataType scale;
+
+  template <typename TensorDataType>
+  void operator()(data_type_weights<TensorDataType>& dtw)
+  {
+    auto& grad = dtw.get_optimizer()->get_gradient_sharded();
+    El::Scale(El::To<TensorDataType>(scale), grad.Matrix());
+  }
+};
+
+/** Clips the norm of a gradient on its own. */
+struct NormClipper : WeightsFunctor
+{
+  DataType max_norm;
+
+  template <typename TensorDataType>
+  void operator()(data_type_weights<TensorDataType>& dtw)
+  {
+    auto& grad = dtw.get_optimizer()->get_gradient_sharded();
+    // The following call may incur communication (e.g., with sharded weights)
+    const TensorDataType norm = El::Nrm2(grad);
+    if (norm > El::To<TensorDataType>(max_norm)) {
+      El::Scale(El::To<TensorDataType>(max_norm) / norm, grad);
+    }
+  }
+};
+
+#ifdef LBANN_HAS_GPU
+/** Adds a gradient to a device-side reduction if it qualifies. */
+struct GpuNormCollector : WeightsFunctor
+{
+  lbann_comm const& comm;
+  multi_tensor_sum_of_squares* gpu_sums;
+  bool* any_sharded;
+  bool* supported;
+
+  template <typename TensorDataType>
+  void operator()(data_type_weights<TensorDataType>& dtw)
+  {
+    if constexpr (!multi_tensor_sum_of_squares_supports<
+                    TensorDataType>::value) {
+      *supported = false;
+    }
+    else {
+      auto& grad = dtw.get_optimizer()->get_gradient_sharded();
+      if (grad.GetLocalDevice() != El::Device::GPU || !grad.Contiguous()) {
+        *supported = false;
+        return;
+      }
+      bool sharded = false;
+      DataType weight = DataType(1);
+      if (dtw.is_sharded()) {
+        sharded = true;
+      }
+      else if (on_subgrid(grad, comm)) {
+        sharded = true;
+        weight = DataType(1) / DataType(grad.RedundantSize());
+      }
+      if (sharded) {
+        *any_sharded = true;
+      }
+      gpu_sums->add(grad.LockedBuffer(),
+                    grad.LocalHeight() * grad.LocalWidth(),
+                    sharded ? 1 : 0,
+                    weight);
+    }
+  }
+};
+#endif // LBANN_HAS_GPU
+
+} // namespace
+
+DataType global_norm(std::vector<weights*> const& weights_list,
+                     lbann_comm& comm)
+{
+  LBANN_CALIPER_MARK_FUNCTION;
+  DataType norm = 0, sharded_norm = 0;
+  bool any_sharded = false;
+#ifdef LBANN_HAS_GPU
+  multi_tensor_sum_of_squares gpu_sums;
+#endif // LBANN_HAS_GPU
+  for (weights* w : weights_list) {
+    if (w->get_optimizer() != nullptr) {
+      dispatch(NormComputer{{},
+                            comm,
+                            &norm,
+                            &sharded_norm,
+                            &any_sharded
+#ifdef LBANN_HAS_GPU
+                            ,
+                            &gpu_sums
+#endif // LBANN_HAS_GPU
+               },
+               *w);
+    }
+  }
+#ifdef LBANN_HAS_GPU
+  if (!gpu_sums.empty()) {
+    const auto sums = gpu_sums.finish(2, El::gpu::DefaultSyncInfo());
+    norm += sums[0];
+    sharded_norm += sums[1];
+  }
+#endif // LBANN_HAS_GPU
+
+  // Allreduce the norm of sharded weights
+  if (any_sharded) {
+    norm += comm.trainer_allreduce(sharded_norm);
+  }
+  return std::sqrt(norm);
+}
+
+DataType clip_global_norm(std::vector<weights*> const& weights_list,
+                          DataType max_norm,
+                          lbann_comm& comm)
+{
+  const DataType norm = global_norm(weights_list, comm);
+  if (norm > max_norm) {
+    const DataType scale = max_norm / norm;
+    for (weights* w : weights_list) {
+      if (w->get_optimizer() != nullptr) {
+        dispatch(GradientScaler{{}, scale}, *w);
+      }
+    }
+  }
+  return norm;
+}
+
+void clip_norm(std::vector<weights*> const& weights_list, DataType max_norm)
+{
+  for (weights* w : weights_list) {
+    if (w->get_optimizer() != nullptr) {
+      dispatch(NormClipper{{}, max_norm}, *w);
+    }
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+bool global_norm_scale_gpu(std::vector<weights*> const& weights_list,
+                           DataType max_norm,
+                           lbann_comm& comm,
+                           float const* is_finite,
+                           gpu_workspace& workspace)
+{
+  LBANN_CALIPER_MARK_FUNCTION;
+  multi_tensor_sum_of_squares gpu_sums;
+  bool any_sharded = false;
+  bool supported = true;
+  for (weights* w : weights_list) {
+    if (w->get_optimizer() != nullptr) {
+      dispatch(
+        GpuNormCollector{{}, comm, &gpu_sums, &any_sharded, &supported},
+        *w);
+      if (!supported) {
+        return false;
+      }
+    }
+  }
+
+  gpu_sums.launch(2, workspace.sums);
+  if (any_sharded) {
+    El::Matrix<DataType, El::Device::GPU> sharded_sum;
+    El::View(sharded_sum, workspace.sums, El::IR(1, 2), El::ALL);
+    comm.allreduce(sharded_sum, comm.get_trainer_comm());
+  }
+  compute_clip_scale_gpu(workspace.sums, max_norm, is_finite, workspace.scale);
+  return true;
+}
+#endif // LBANN_HAS_GPU
+
+} // namespace gradient_clipping
+} // namespace lbann
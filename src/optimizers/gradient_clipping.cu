@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/gradient_clipping.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace gradient_clipping {
+
+namespace {
+
+__global__ void clip_scale_kernel(DataType const* __restrict__ sums,
+                                  DataType max_norm,
+                                  float const* __restrict__ is_finite,
+                                  float* __restrict__ scale)
+{
+  const DataType norm = gpu_lib::sqrt(sums[0] + sums[1]);
+  float s = (norm > max_norm) ? static_cast<float>(max_norm / norm) : 1.f;
+  if (is_finite != nullptr) {
+    s *= *is_finite;
+  }
+  *scale = s;
+}
+
+} // namespace
+
+void compute_clip_scale_gpu(El::Matrix<DataType, El::Device::GPU> const& sums,
+                            DataType max_norm,
+                            float const* is_finite,
+                            El::Matrix<float, El::Device::GPU>& scale)
+{
+  scale.Resize(1, 1);
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(scale), gpu::get_sync_info(sums));
+  hydrogen::gpu::LaunchKernel(clip_scale_kernel,
+                              1,
+                              1,
+                              0,
+                              multisync,
+                              sums.LockedBuffer(),
+                              max_norm,
+                              is_finite,
+                              scale.Buffer());
+}
+
+} // namespace gradient_clipping
+} // namespace lbann
@@ -0,0 +1,446 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/gradient_compression.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace lbann {
+
+std::string to_string(gradient_compression_method method)
+{
+  switch (method) {
+  case gradient_compression_method::none:
+    return "none";
+  case gradient_compression_method::fp16:
+    return "fp16";
+  case gradient_compression_method::topk:
+    return "top-k";
+  case gradient_compression_method::powersgd:
+    return "PowerSGD";
+  default:
+    return "unknown";
+  }
+}
+
+namespace {
+
+template <El::Device Device>
+struct half_type
+{};
+#ifdef LBANN_HAS_HALF
+template <>
+struct half_type<El::Device::CPU>
+{
+  using type = cpu_fp16;
+};
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU_FP16
+template <>
+struct half_type<El::Device::GPU>
+{
+  using type = fp16;
+};
+#endif // LBANN_HAS_GPU_FP16
+
+template <El::Device Device, typename = void>
+struct has_half_type : std::false_type
+{};
+template <El::Device Device>
+struct has_half_type<Device, std::void_t<typename half_type<Device>::type>>
+  : std::true_type
+{};
+
+/** @brief Allreduce a half-precision copy of the gradient. */
+template <typename TensorDataType, El::Device Device>
+class fp16_compressor final : public gradient_compressor<TensorDataType>
+{
+public:
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+  using MatType = El::Matrix<TensorDataType, Device>;
+  using HalfType = typename half_type<Device>::type;
+
+  void start(lbann_comm& comm,
+             AbsMatType& grad,
+             El::mpi::Comm const& redundant_comm) override
+  {
+    auto& g = static_cast<MatType&>(grad);
+    if (m_error.Height() != g.Height() || m_error.Width() != g.Width()) {
+      El::SetSyncInfo(m_error, El::SyncInfoFromMatrix(g));
+      El::SetSyncInfo(m_packed, El::SyncInfoFromMatrix(g));
+      El::Zeros(m_error, g.Height(), g.Width());
+    }
+    // v = g + e, sent as half(v); the rounding error stays behind
+    El::Axpy(TensorDataType(1), m_error, g);
+    El::Copy(g, m_packed);
+    El::Copy(m_packed, m_error);
+    El::Scale(TensorDataType(-1), m_error);
+    El::Axpy(TensorDataType(1), g, m_error);
+    comm.nb_allreduce(m_packed, redundant_comm, m_req);
+
+    const size_t size = g.Height() * g.Width();
+    this->m_uncompressed_bytes += size * sizeof(TensorDataType);
+    this->m_sent_bytes += size * sizeof(HalfType);
+  }
+
+  void finish(lbann_comm& comm, AbsMatType& grad) override
+  {
+    comm.wait(m_req);
+    El::Copy(m_packed, grad);
+  }
+
+private:
+  MatType m_error;
+  El::Matrix<HalfType, Device> m_packed;
+  Al::request m_req;
+};
+
+/** @brief Allgather the k largest-magnitude entries of the gradient.
+ *
+ *  Selection and accumulation run on the host. The collective is
+ *  blocking, since the sparse contributions of every process are
+ *  needed before the sum can be formed.
+ */
+template <typename TensorDataType>
+class topk_compressor final : public gradient_compressor<TensorDataType>
+{
+public:
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+  using HostMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+
+  explicit topk_compressor(double fraction) : m_fraction{fraction}
+  {
+    if (!(fraction > 0. && fraction <= 1.)) {
+      LBANN_ERROR("top-k gradient compression expects a fraction in (0, 1], "
+                  "got ",
+                  fraction);
+    }
+  }
+
+  void start(lbann_comm& comm,
+             AbsMatType& grad,
+             El::mpi::Comm const& redundant_comm) override
+  {
+    const El::Int height = grad.Height();
+    const El::Int width = grad.Width();
+    const El::Int size = height * width;
+    if (size > std::numeric_limits<int>::max()) {
+      LBANN_ERROR("gradient too large for top-k compression");
+    }
+    if (m_error.Height() != height || m_error.Width() != width) {
+      El::Zeros(m_error, height, width);
+    }
+
+    // v = g + e, kept on the host in m_error
+    El::Copy(grad, m_values);
+    El::Axpy(TensorDataType(1), m_values, m_error);
+    auto* v = m_error.Buffer();
+
+    // Pick the k largest |v|; sort the indices so the scatter-add
+    // below visits memory in order
+    const El::Int k =
+      std::max(El::Int{1},
+               static_cast<El::Int>(std::ceil(m_fraction * size)));
+    std::vector<int> idx(size);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::nth_element(idx.begin(),
+                     idx.begin() + (k - 1),
+                     idx.end(),
+                     [v](int a, int b) {
+                       return std::abs(v[a]) > std::abs(v[b]);
+                     });
+    idx.resize(k);
+    std::sort(idx.begin(), idx.end());
+
+    std::vector<float> vals(k);
+    for (El::Int i = 0; i < k; ++i) {
+      vals[i] = static_cast<float>(v[idx[i]]);
+      v[idx[i]] -= static_cast<TensorDataType>(vals[i]);
+    }
+
+    const int num_procs = El::mpi::Size(redundant_comm);
+    std::vector<int> all_idx(k * num_procs);
+    std::vector<float> all_vals(k * num_procs);
+    const int count = static_cast<int>(k);
+    comm.all_gather(idx.data(), count, all_idx.data(), count, redundant_comm);
+    comm.all_gather(vals.data(), count, all_vals.data(), count, redundant_comm);
+
+    El::Zeros(m_values, height, width);
+    auto* sum = m_values.Buffer();
+    for (size_t i = 0; i < all_idx.size(); ++i) {
+      sum[all_idx[i]] += static_cast<TensorDataType>(all_vals[i]);
+    }
+    El::Copy(m_values, grad);
+
+    this->m_uncompressed_bytes += size * sizeof(TensorDataType);
+    this->m_sent_bytes += k * (sizeof(int) + sizeof(float));
+  }
+
+  void finish(lbann_comm&, AbsMatType&) override {}
+
+private:
+  double m_fraction;
+  /** @brief Untransmitted remainder, stored contiguously. */
+  HostMatType m_error;
+  /** @brief Host staging for the gradient. */
+  HostMatType m_values;
+};
+
+/** @brief Orthonormalize the columns of a tall matrix in place
+ *         (modified Gram-Schmidt).
+ */
+template <typename TensorDataType>
+void orthonormalize_columns(El::Matrix<TensorDataType, El::Device::CPU>& p)
+{
+  const El::Int height = p.Height();
+  for (El::Int j = 0; j < p.Width(); ++j) {
+    auto* pj = p.Buffer(0, j);
+    for (El::Int i = 0; i < j; ++i) {
+      const auto* pi = p.LockedBuffer(0, i);
+      TensorDataType dot = 0;
+      for (El::Int r = 0; r < height; ++r) {
+        dot += pi[r] * pj[r];
+      }
+      for (El::Int r = 0; r < height; ++r) {
+        pj[r] -= dot * pi[r];
+      }
+    }
+    TensorDataType norm = 0;
+    for (El::Int r = 0; r < height; ++r) {
+      norm += pj[r] * pj[r];
+    }
+    norm = std::sqrt(norm);
+    const TensorDataType scale =
+      (norm > TensorDataType(0) ? TensorDataType(1) / norm : TensorDataType(0));
+    for (El::Int r = 0; r < height; ++r) {
+      pj[r] *= scale;
+    }
+  }
+}
+
+/** @brief Allreduce a rank-r approximation P Q^T of the gradient.
+ *
+ *  One power iteration per step, warm-started from the previous Q.
+ *  Gradients that are vectors, or whose factors would not be smaller
+ *  than the matrix itself, are allreduced uncompressed. Both factor
+ *  allreduces are blocking because Q depends on the reduced P.
+ */
+template <typename TensorDataType, El::Device Device>
+class powersgd_compressor final : public gradient_compressor<TensorDataType>
+{
+public:
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+  using MatType = El::Matrix<TensorDataType, Device>;
+
+  explicit powersgd_compressor(El::Int rank) : m_rank{rank}
+  {
+    if (rank < 1) {
+      LBANN_ERROR("PowerSGD gradient compression expects a positive rank, "
+                  "got ",
+                  rank);
+    }
+  }
+
+  void start(lbann_comm& comm,
+             AbsMatType& grad,
+             El::mpi::Comm const& redundant_comm) override
+  {
+    auto& m = static_cast<MatType&>(grad);
+    const El::Int height = m.Height();
+    const El::Int width = m.Width();
+    const El::Int rank = std::min({m_rank, height, width});
+    const size_t size = height * width;
+    this->m_uncompressed_bytes += size * sizeof(TensorDataType);
+    if (rank * (height + width) >= height * width) {
+      m_uncompressed = true;
+      comm.nb_allreduce(m, redundant_comm, m_req);
+      this->m_sent_bytes += size * sizeof(TensorDataType);
+      return;
+    }
+    m_uncompressed = false;
+
+    if (m_q.Height() != width || m_q.Width() != rank) {
+      init_factors(m, rank);
+    }
+
+    // M = g + e
+    El::Axpy(TensorDataType(1), m_error, m);
+
+    // P = M Q, summed and orthonormalized
+    El::Gemm(El::NORMAL,
+             El::NORMAL,
+             TensorDataType(1),
+             m,
+             m_q,
+             TensorDataType(0),
+             m_p);
+    comm.allreduce(m_p, redundant_comm);
+    El::Copy(m_p, m_host_p);
+    orthonormalize_columns(m_host_p);
+    El::Copy(m_host_p, m_p);
+
+    // Q = M^T P
+    El::Gemm(El::TRANSPOSE,
+             El::NORMAL,
+             TensorDataType(1),
+             m,
+             m_p,
+             TensorDataType(0),
+             m_q);
+
+    // e = M - P Q^T with the local Q, so each process only keeps the
+    // part of its own contribution that the approximation missed
+    El::Copy(m, m_error);
+    El::Gemm(El::NORMAL,
+             El::TRANSPOSE,
+             TensorDataType(-1),
+             m_p,
+             m_q,
+             TensorDataType(1),
+             m_error);
+
+    // g = P Q^T with Q summed
+    comm.allreduce(m_q, redundant_comm);
+    El::Gemm(El::NORMAL,
+             El::TRANSPOSE,
+             TensorDataType(1),
+             m_p,
+             m_q,
+             TensorDataType(0),
+             m);
+
+    this->m_sent_bytes += rank * (height + width) * sizeof(TensorDataType);
+  }
+
+  void finish(lbann_comm& comm, AbsMatType&) override
+  {
+    if (m_uncompressed) {
+      comm.wait(m_req);
+    }
+  }
+
+private:
+  /** @brief Seed Q identically on every process so the factors agree. */
+  void init_factors(MatType const& m, El::Int rank)
+  {
+    const auto sync_info = El::SyncInfoFromMatrix(m);
+    El::SetSyncInfo(m_q, sync_info);
+    El::SetSyncInfo(m_p, sync_info);
+    El::SetSyncInfo(m_error, sync_info);
+    El::Matrix<TensorDataType, El::Device::CPU> q(m.Width(), rank);
+    std::mt19937 gen(static_cast<unsigned>(m.Height() * 7919 + m.Width()));
+    std::normal_distribution<double> dist(0., 1.);
+    for (El::Int j = 0; j < rank; ++j) {
+      for (El::Int i = 0; i < m.Width(); ++i) {
+        q(i, j) = static_cast<TensorDataType>(dist(gen));
+      }
+    }
+    El::Copy(q, m_q);
+    m_p.Resize(m.Height(), rank);
+    El::Zeros(m_error, m.Height(), m.Width());
+  }
+
+  El::Int m_rank;
+  MatType m_p;
+  MatType m_q;
+  MatType m_error;
+  El::Matrix<TensorDataType, El::Device::CPU> m_host_p;
+  Al::request m_req;
+  bool m_uncompressed = false;
+};
+
+template <typename TensorDataType, El::Device Device>
+std::unique_ptr<gradient_compressor<TensorDataType>>
+make_compressor_on_device(gradient_compression_config const& config)
+{
+  switch (config.method) {
+  case gradient_compression_method::fp16:
+    if constexpr (has_half_type<Device>::value) {
+      return std::make_unique<fp16_compressor<TensorDataType, Device>>();
+    }
+    LBANN_ERROR("fp16 gradient compression needs half-precision support "
+                "on this device");
+  case gradient_compression_method::topk:
+    return std::make_unique<topk_compressor<TensorDataType>>(
+      config.topk_fraction);
+  case gradient_compression_method::powersgd:
+    return std::make_unique<powersgd_compressor<TensorDataType, Device>>(
+      config.powersgd_rank);
+  default:
+    LBANN_ERROR("unknown gradient compression method");
+  }
+  return nullptr;
+}
+
+} // namespace
+
+template <typename TensorDataType>
+std::unique_ptr<gradient_compressor<TensorDataType>>
+make_gradient_compressor(gradient_compression_config const& config,
+                         El::Device device)
+{
+  if (config.method == gradient_compression_method::none) {
+    return nullptr;
+  }
+  if constexpr (!std::is_floating_point_v<TensorDataType>) {
+    LBANN_ERROR("gradient compression is only supported for single- and "
+                "double-precision weights");
+    return nullptr;
+  }
+  else {
+    switch (device) {
+    case El::Device::CPU:
+      return make_compressor_on_device<TensorDataType, El::Device::CPU>(config);
+#ifdef LBANN_HAS_GPU
+    case El::Device::GPU:
+      return make_compressor_on_device<TensorDataType, El::Device::GPU>(config);
+#endif // LBANN_HAS_GPU
+    default:
+      LBANN_ERROR("invalid device for gradient compression");
+    }
+  }
+  return nullptr;
+}
+
+#define PROTO(T)                                                               \
+  template std::unique_ptr<gradient_compressor<T>> make_gradient_compressor(   \
+    gradient_compression_config const& config,                                 \
+    El::Device device)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#define LBANN_INSTANTIATE_DOUBLE
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,353 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/gradient_fusion.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace lbann {
+namespace {
+
+size_t bucket_size_bytes = 0;
+
+allreduce_algorithm gradient_allreduce_algo = allreduce_algorithm::flat;
+
+/** Buckets still accepting gradients, in the order they were opened. */
+std::vector<std::shared_ptr<gradient_fusion_bucket_base>> open_buckets;
+
+/** Launched buckets that have not been finished yet. */
+std::vector<std::weak_ptr<gradient_fusion_bucket_base>> in_flight_buckets;
+
+bool sync_tracing = false;
+std::vector<lbann::gradient_sync_record> sync_records;
+
+/** Seconds spent blocked on gradient allreduces. */
+EvalType sync_wait_time = 0.;
+
+template <typename TensorDataType, El::Device Device>
+void pack_gradients(
+  std::vector<El::AbstractMatrix<TensorDataType>*> const& grads,
+  El::AbstractMatrix<TensorDataType>& packed,
+  bool unpack)
+{
+  using MatType = El::Matrix<TensorDataType, Device>;
+  auto& packed_d = static_cast<MatType&>(packed);
+  El::SyncInfo<Device> sync_info = El::SyncInfoFromMatrix(packed_d);
+  El::Int offset = 0;
+  for (auto* g : grads) {
+    auto& grad = static_cast<MatType&>(*g);
+    El::SyncInfo<Device> grad_sync = El::SyncInfoFromMatrix(grad);
+    auto multisync = El::MakeMultiSync(sync_info, grad_sync);
+    auto* packed_buf = packed_d.Buffer() + offset;
+    if (unpack) {
+      El::copy::util::InterleaveMatrix(grad.Height(),
+                                       grad.Width(),
+                                       packed_buf,
+                                       1,
+                                       grad.Height(),
+                                       grad.Buffer(),
+                                       1,
+                                       grad.LDim(),
+                                       multisync);
+    }
+    else {
+      El::copy::util::InterleaveMatrix(grad.Height(),
+                                       grad.Width(),
+                                       grad.LockedBuffer(),
+                                       1,
+                                       grad.LDim(),
+                                       packed_buf,
+                                       1,
+                                       grad.Height(),
+                                       multisync);
+    }
+    offset += grad.Height() * grad.Width();
+  }
+}
+
+template <typename TensorDataType>
+void pack_gradients(
+  std::vector<El::AbstractMatrix<TensorDataType>*> const& grads,
+  El::AbstractMatrix<TensorDataType>& packed,
+  bool unpack)
+{
+  switch (packed.GetDevice()) {
+  case El::Device::CPU:
+    pack_gradients<TensorDataType, El::Device::CPU>(grads, packed, unpack);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    pack_gradients<TensorDataType, El::Device::GPU>(grads, packed, unpack);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device for gradient fusion");
+  }
+}
+
+template <typename TensorDataType>
+std::unique_ptr<El::AbstractMatrix<TensorDataType>>
+make_packed_buffer(El::AbstractMatrix<TensorDataType> const& like,
+                   El::Int size)
+{
+  switch (like.GetDevice()) {
+  case El::Device::CPU:
+    return std::make_unique<El::Matrix<TensorDataType, El::Device::CPU>>(size,
+                                                                         1);
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    using MatType = El::Matrix<TensorDataType, El::Device::GPU>;
+    auto packed = std::make_unique<MatType>();
+    // Keep the packed buffer on the gradients' stream and in the pool
+    packed->SetMemoryMode(1);
+    El::SetSyncInfo(*packed,
+                    El::SyncInfoFromMatrix(static_cast<MatType const&>(like)));
+    packed->Resize(size, 1);
+    return packed;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device for gradient fusion");
+  }
+  return nullptr;
+}
+
+} // namespace
+
+template <typename TensorDataType>
+gradient_fusion_bucket<TensorDataType>::gradient_fusion_bucket(
+  El::Device device,
+  El::mpi::Comm const& comm)
+  : m_device{device}, m_comm{&comm}
+{}
+
+template <typename TensorDataType>
+bool gradient_fusion_bucket<TensorDataType>::accepts(
+  AbsMatType const& grad,
+  El::mpi::Comm const& comm) const
+{
+  return !m_launched && grad.GetDevice() == m_device &&
+         comm.GetMPIComm() == m_comm->GetMPIComm();
+}
+
+template <typename TensorDataType>
+void gradient_fusion_bucket<TensorDataType>::add(AbsMatType& grad)
+{
+  if (m_launched) {
+    LBANN_ERROR("attempted to add a gradient to a launched fusion bucket");
+  }
+  m_grads.push_back(&grad);
+  m_size += grad.Height() * grad.Width();
+}
+
+template <typename TensorDataType>
+void gradient_fusion_bucket<TensorDataType>::launch(lbann_comm& comm)
+{
+  if (m_launched) {
+    return;
+  }
+  m_launched = true;
+  if (m_grads.empty()) {
+    return;
+  }
+  m_packed = make_packed_buffer(*m_grads.front(), m_size);
+  pack_gradients(m_grads, *m_packed, false);
+  m_record = begin_gradient_sync_record(get_size_bytes(), m_grads.size());
+  lbann_comm::collective_tag_scope tag(comm, "gradient_bucket");
+  comm.nb_allreduce(*m_packed,
+                    *m_comm,
+                    m_req,
+                    El::mpi::SUM,
+                    gradient_allreduce_algo);
+  in_flight_buckets.push_back(weak_from_this());
+}
+
+template <typename TensorDataType>
+void gradient_fusion_bucket<TensorDataType>::finish(lbann_comm& comm)
+{
+  if (m_finished) {
+    return;
+  }
+  if (!m_launched) {
+    // Finishing early: the bucket can take no more gradients.
+    open_buckets.erase(
+      std::remove_if(open_buckets.begin(),
+                     open_buckets.end(),
+                     [this](auto const& b) { return b.get() == this; }),
+      open_buckets.end());
+    launch(comm);
+  }
+  m_finished = true;
+  if (m_packed == nullptr) {
+    return;
+  }
+  const EvalType wait_time = get_time();
+  comm.wait(m_req);
+  end_gradient_sync_record(m_record, wait_time);
+  pack_gradients(m_grads, *m_packed, true);
+  m_packed.reset();
+}
+
+template <typename TensorDataType>
+bool gradient_fusion_bucket<TensorDataType>::progress(lbann_comm& comm)
+{
+  if (m_finished || m_packed == nullptr) {
+    return false;
+  }
+  comm.test(m_req);
+  return true;
+}
+
+void set_gradient_fusion_bucket_size(size_t bytes)
+{
+  bucket_size_bytes = bytes;
+}
+
+size_t get_gradient_fusion_bucket_size() noexcept { return bucket_size_bytes; }
+
+void set_gradient_allreduce_algorithm(allreduce_algorithm algo)
+{
+  gradient_allreduce_algo = algo;
+}
+
+allreduce_algorithm get_gradient_allreduce_algorithm() noexcept
+{
+  return gradient_allreduce_algo;
+}
+
+template <typename TensorDataType>
+std::shared_ptr<gradient_fusion_bucket_base>
+fuse_gradient(lbann_comm& comm,
+              El::AbstractMatrix<TensorDataType>& grad,
+              El::mpi::Comm const& redundant_comm)
+{
+  using BucketType = gradient_fusion_bucket<TensorDataType>;
+  const size_t grad_bytes =
+    grad.Height() * grad.Width() * sizeof(TensorDataType);
+  if (bucket_size_bytes == 0 || grad_bytes >= bucket_size_bytes ||
+      El::mpi::Size(redundant_comm) == 1) {
+    return nullptr;
+  }
+
+  auto it = std::find_if(open_buckets.begin(),
+                         open_buckets.end(),
+                         [&](auto const& b) {
+                           auto* bucket = dynamic_cast<BucketType*>(b.get());
+                           return bucket != nullptr &&
+                                  bucket->accepts(grad, redundant_comm);
+                         });
+  if (it != open_buckets.end() &&
+      (*it)->get_size_bytes() + grad_bytes > bucket_size_bytes) {
+    // No room left: send what the bucket holds and start a new one.
+    (*it)->launch(comm);
+    open_buckets.erase(it);
+    it = open_buckets.end();
+  }
+  if (it == open_buckets.end()) {
+    open_buckets.push_back(
+      std::make_shared<BucketType>(grad.GetDevice(), redundant_comm));
+    it = std::prev(open_buckets.end());
+  }
+
+  auto bucket = *it;
+  static_cast<BucketType&>(*bucket).add(grad);
+  if (bucket->get_size_bytes() >= bucket_size_bytes) {
+    bucket->launch(comm);
+    open_buckets.erase(it);
+  }
+  return bucket;
+}
+
+void flush_gradient_fusion_buckets(lbann_comm& comm)
+{
+  for (auto& bucket : open_buckets) {
+    bucket->launch(comm);
+  }
+  open_buckets.clear();
+}
+
+void progress_gradient_fusion_buckets(lbann_comm& comm)
+{
+  in_flight_buckets.erase(
+    std::remove_if(in_flight_buckets.begin(),
+                   in_flight_buckets.end(),
+                   [&comm](auto const& b) {
+                     auto bucket = b.lock();
+                     return bucket == nullptr || !bucket->progress(comm);
+                   }),
+    in_flight_buckets.end());
+}
+
+void set_gradient_sync_tracing(bool enable) { sync_tracing = enable; }
+
+std::vector<gradient_sync_record> take_gradient_sync_records()
+{
+  return std::exchange(sync_records, {});
+}
+
+size_t begin_gradient_sync_record(size_t bytes, size_t num_gradients)
+{
+  if (!sync_tracing) {
+    return no_gradient_sync_record;
+  }
+  const EvalType now = get_time();
+  sync_records.push_back({bytes, num_gradients, now, now, now});
+  return sync_records.size() - 1;
+}
+
+void end_gradient_sync_record(size_t record, EvalType wait_time)
+{
+  if (record < sync_records.size()) {
+    sync_records[record].wait_time = wait_time;
+    sync_records[record].finish_time = get_time();
+  }
+}
+
+void add_gradient_sync_wait_time(EvalType seconds)
+{
+  sync_wait_time += seconds;
+}
+
+EvalType get_gradient_sync_wait_time() { return sync_wait_time; }
+
+#define PROTO(T)                                                               \
+  template class gradient_fusion_bucket<T>;                                    \
+  template std::shared_ptr<gradient_fusion_bucket_base> fuse_gradient(         \
+    lbann_comm& comm,                                                          \
+    El::AbstractMatrix<T>& grad,                                               \
+    El::mpi::Comm const& redundant_comm)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#define LBANN_INSTANTIATE_DOUBLE
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,285 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/lamb.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/optimizers/lamb_impl.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+#include "lbann/utils/profiling.hpp"
+
+#include <cmath>
+#include <sstream>
+
+namespace lbann {
+
+template <typename TensorDataType>
+lamb<TensorDataType>::lamb(TensorDataType learning_rate,
+                           TensorDataType beta1,
+                           TensorDataType beta2,
+                           TensorDataType eps,
+                           TensorDataType weight_decay)
+  : BaseType(learning_rate),
+    m_beta1(beta1),
+    m_beta2(beta2),
+    m_eps(eps),
+    m_weight_decay(weight_decay)
+{}
+
+template <typename TensorDataType>
+lamb<TensorDataType>::lamb(const lamb& other)
+  : BaseType(other),
+    m_beta1(other.m_beta1),
+    m_beta2(other.m_beta2),
+    m_eps(other.m_eps),
+    m_weight_decay(other.m_weight_decay),
+    m_current_beta1(other.m_current_beta1),
+    m_current_beta2(other.m_current_beta2),
+    m_previous_beta1(other.m_previous_beta1),
+    m_previous_beta2(other.m_previous_beta2),
+    m_moment1(other.m_moment1 ? other.m_moment1->Copy() : nullptr),
+    m_moment2(other.m_moment2 ? other.m_moment2->Copy() : nullptr)
+{}
+
+template <typename TensorDataType>
+lamb<TensorDataType>&
+lamb<TensorDataType>::operator=(const lamb<TensorDataType>& other)
+{
+  OptimizerType::operator=(other);
+  m_beta1 = other.m_beta1;
+  m_beta2 = other.m_beta2;
+  m_eps = other.m_eps;
+  m_weight_decay = other.m_weight_decay;
+  m_current_beta1 = other.m_current_beta1;
+  m_current_beta2 = other.m_current_beta2;
+  m_previous_beta1 = other.m_previous_beta1;
+  m_previous_beta2 = other.m_previous_beta2;
+  m_moment1.reset(other.m_moment1 ? other.m_moment1->Copy() : nullptr);
+  m_moment2.reset(other.m_moment2 ? other.m_moment2->Copy() : nullptr);
+  return *this;
+}
+
+template <typename TensorDataType>
+description lamb<TensorDataType>::get_description() const
+{
+  auto desc = OptimizerType::get_description();
+  desc.add("beta1", m_beta1);
+  desc.add("beta2", m_beta2);
+  desc.add("eps", m_eps);
+  desc.add("Weight decay", m_weight_decay);
+  return desc;
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::undo_skipped_step()
+{
+  m_current_beta1 = m_previous_beta1;
+  m_current_beta2 = m_previous_beta2;
+}
+
+template <typename TensorDataType>
+size_t lamb<TensorDataType>::get_state_size() const
+{
+  size_t allocated = m_moment1->AllocatedMemory() * sizeof(TensorDataType);
+  allocated += m_moment2->AllocatedMemory() * sizeof(TensorDataType);
+  return data_type_optimizer<TensorDataType>::get_state_size() + allocated;
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::setup(WeightsType* w)
+{
+  OptimizerType::setup(w);
+  const auto& gradient = this->get_gradient_sharded();
+  m_moment1.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
+  m_moment2.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
+  El::Zeros(*m_moment1, gradient.Height(), gradient.Width());
+  El::Zeros(*m_moment2, gradient.Height(), gradient.Width());
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
+{
+  auto* opt = proto.mutable_lamb();
+  opt->set_learn_rate(this->get_learning_rate());
+  opt->set_beta1(m_beta1);
+  opt->set_beta2(m_beta2);
+  opt->set_eps(m_eps);
+  opt->set_weight_decay(m_weight_decay);
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::step_compute(AbsDistMatrixType& values,
+                                        const AbsDistMatrixType& gradient)
+{
+  m_previous_beta1 = m_current_beta1;
+  m_previous_beta2 = m_current_beta2;
+  m_current_beta1 *= m_beta1;
+  m_current_beta2 *= m_beta2;
+
+  switch (values.GetLocalDevice()) {
+  case El::Device::CPU:
+    step_compute_cpu(values, gradient);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    step_compute_gpu(values, gradient);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    std::ostringstream err;
+    err << "unsupported device type "
+        << "(" << static_cast<int>(values.GetLocalDevice()) << ")";
+    LBANN_ERROR(err.str());
+  }
+}
+
+template <typename TensorDataType>
+std::string lamb<TensorDataType>::get_multi_tensor_hyperparameters() const
+{
+  std::ostringstream ss;
+  ss << std::hexfloat << El::To<double>(m_beta1) << ' '
+     << El::To<double>(m_beta2) << ' ' << El::To<double>(m_eps) << ' '
+     << El::To<double>(m_weight_decay) << ' '
+     << El::To<double>(m_current_beta1) << ' '
+     << El::To<double>(m_current_beta2);
+  return ss.str();
+}
+
+template <typename TensorDataType>
+bool lamb<TensorDataType>::get_multi_tensor_entry(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  multi_tensor_entry<TensorDataType>& entry)
+{
+  if (values.DistSize() != 1 || !values.Contiguous() ||
+      !gradient.Contiguous() || !m_moment1->Contiguous() ||
+      !m_moment2->Contiguous()) {
+    return false;
+  }
+  m_previous_beta1 = m_current_beta1;
+  m_previous_beta2 = m_current_beta2;
+  m_current_beta1 *= m_beta1;
+  m_current_beta2 *= m_beta2;
+  entry = {values.Buffer(),
+           gradient.LockedBuffer(),
+           m_moment1->Buffer(),
+           m_moment2->Buffer(),
+           static_cast<size_t>(values.LocalHeight() * values.LocalWidth())};
+  return true;
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
+                                            const AbsDistMatrixType& gradient)
+{
+  LBANN_CALIPER_MARK_SCOPE("lamb::step_compute");
+  static const auto one = TensorDataType(1.);
+  const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
+  const auto correction1 = one / (one - m_current_beta1);
+  const auto correction2 = one / (one - m_current_beta2);
+
+  // Get local matrix data
+  const size_t local_height = values.LocalHeight();
+  const size_t local_width = values.LocalWidth();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const size_t values_ldim = values.LDim();
+  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
+  const size_t gradient_ldim = gradient.LDim();
+  auto* __restrict__ moment1_buffer = m_moment1->Buffer();
+  const size_t moment1_ldim = m_moment1->LDim();
+  auto* __restrict__ moment2_buffer = m_moment2->Buffer();
+  const size_t moment2_ldim = m_moment2->LDim();
+
+  // Bias-corrected Adam direction plus weight decay
+  const auto direction = [&](size_t row, size_t col) {
+    const auto& x = values_buffer[row + col * values_ldim];
+    const auto m1 = moment1_buffer[row + col * moment1_ldim] * correction1;
+    const auto m2 = moment2_buffer[row + col * moment2_ldim] * correction2;
+    return m1 / (El::Sqrt(m2) + m_eps) + m_weight_decay * x;
+  };
+
+  // Update the moments and accumulate ||x||^2 and ||r||^2
+  DataType x_sqsum = 0, r_sqsum = 0;
+  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+ : x_sqsum, r_sqsum) collapse(2))
+  for (size_t col = 0; col < local_width; ++col) {
+    for (size_t row = 0; row < local_height; ++row) {
+      const auto& g = gradient_buffer[row + col * gradient_ldim];
+      auto& m1 = moment1_buffer[row + col * moment1_ldim];
+      auto& m2 = moment2_buffer[row + col * moment2_ldim];
+      m1 = m_beta1 * m1 + (one - m_beta1) * g;
+      m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
+      const auto x = El::To<DataType>(values_buffer[row + col * values_ldim]);
+      const auto r = El::To<DataType>(direction(row, col));
+      x_sqsum += x * x;
+      r_sqsum += r * r;
+    }
+  }
+  DataType norms[2] = {x_sqsum, r_sqsum};
+  if (values.DistSize() > 1) {
+    this->get_comm().allreduce(norms, 2, values.DistComm());
+  }
+
+  // Step along the direction, scaled by the trust ratio
+  const DataType trust = (norms[0] > DataType(0) && norms[1] > DataType(0))
+                           ? std::sqrt(norms[0] / norms[1])
+                           : DataType(1);
+  const auto step_size = learning_rate * El::To<TensorDataType>(trust);
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (size_t col = 0; col < local_width; ++col) {
+    for (size_t row = 0; row < local_height; ++row) {
+      const auto r = direction(row, col);
+      values_buffer[row + col * values_ldim] -= step_size * r;
+    }
+  }
+}
+
+template <typename TensorDataType>
+std::unique_ptr<optimizer>
+build_lamb_optimizer_from_pbuf(google::protobuf::Message const& msg)
+{
+  const auto& params = dynamic_cast<lbann_data::Optimizer::LAMB const&>(msg);
+  return std::make_unique<lamb<TensorDataType>>(
+    TensorDataType(params.learn_rate()),
+    TensorDataType(params.beta1()),
+    TensorDataType(params.beta2()),
+    TensorDataType(params.eps()),
+    TensorDataType(params.weight_decay()));
+}
+
+#define PROTO(T)                                                               \
+  template class lamb<T>;                                                      \
+  template std::unique_ptr<optimizer> build_lamb_optimizer_from_pbuf<T>(       \
+    google::protobuf::Message const&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
+
+#define LBANN_CLASS_NAME lamb
+#include <lbann/macros/register_template_class_with_cereal.hpp>
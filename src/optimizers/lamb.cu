@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/lamb.hpp"
+#include "lbann/utils/profiling.hpp"
+
+#include "layerwise_adaptive.cuh"
+
+namespace lbann {
+
+namespace {
+
+template <typename TensorDataType>
+struct lamb_op
+{
+  DataType learning_rate;
+  TensorDataType beta1;
+  TensorDataType beta2;
+  TensorDataType eps;
+  TensorDataType weight_decay;
+  TensorDataType correction1;
+  TensorDataType correction2;
+
+  /** Bias-corrected Adam direction plus weight decay */
+  __device__ TensorDataType
+  direction(multi_tensor_entry<TensorDataType> const& e, size_t i) const
+  {
+    const auto m1 = e.state0[i] * correction1;
+    const auto m2 = e.state1[i] * correction2;
+    return m1 / (gpu_lib::sqrt(m2) + eps) + weight_decay * e.values[i];
+  }
+
+  __device__ void accumulate(multi_tensor_entry<TensorDataType> const& e,
+                             size_t i,
+                             TensorDataType scale,
+                             DataType& x_sqsum,
+                             DataType& r_sqsum) const
+  {
+    const auto g = scale * e.gradient[i];
+    auto& m1 = e.state0[i];
+    auto& m2 = e.state1[i];
+    m1 = beta1 * m1 + (TensorDataType(1) - beta1) * g;
+    m2 = beta2 * m2 + (TensorDataType(1) - beta2) * g * g;
+    const auto x = static_cast<DataType>(e.values[i]);
+    const auto r = static_cast<DataType>(direction(e, i));
+    x_sqsum += x * x;
+    r_sqsum += r * r;
+  }
+
+  __device__ void update(multi_tensor_entry<TensorDataType> const& e,
+                         size_t i,
+                         TensorDataType,
+                         DataType x_sqsum,
+                         DataType r_sqsum) const
+  {
+    const DataType trust = (x_sqsum > DataType(0) && r_sqsum > DataType(0))
+                             ? gpu_lib::sqrt(x_sqsum / r_sqsum)
+                             : DataType(1);
+    e.values[i] -= TensorDataType(learning_rate * trust) * direction(e, i);
+  }
+};
+
+template <typename TensorDataType>
+lamb_op<TensorDataType> make_lamb_op(double learning_rate,
+                                     TensorDataType beta1,
+                                     TensorDataType beta2,
+                                     TensorDataType eps,
+                                     TensorDataType weight_decay,
+                                     TensorDataType current_beta1,
+                                     TensorDataType current_beta2)
+{
+  static const auto one = TensorDataType(1.);
+  return {El::To<DataType>(learning_rate),
+          beta1,
+          beta2,
+          eps,
+          weight_decay,
+          one / (one - current_beta1),
+          one / (one - current_beta2)};
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  LBANN_CALIPER_MARK_SCOPE("lamb::multi_tensor_step");
+  // Every entry has advanced the bias correction to the same step
+  layerwise_adaptive::step(entries,
+                           make_lamb_op(this->get_learning_rate(),
+                                        m_beta1,
+                                        m_beta2,
+                                        m_eps,
+                                        m_weight_decay,
+                                        m_current_beta1,
+                                        m_current_beta2),
+                           this->get_step_scale(),
+                           this->m_multi_tensor_workspace,
+                           sync_info);
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::step_compute_gpu(AbsDistMatrixType& values,
+                                            const AbsDistMatrixType& gradient)
+{
+  LBANN_CALIPER_MARK_SCOPE("lamb::step_compute");
+  if (!values.Contiguous() || !gradient.Contiguous() ||
+      !m_moment1->Contiguous() || !m_moment2->Contiguous()) {
+    LBANN_ERROR("LAMB requires contiguous GPU buffers");
+  }
+  const std::vector<multi_tensor_entry<TensorDataType>> entries{
+    {values.Buffer(),
+     gradient.LockedBuffer(),
+     m_moment1->Buffer(),
+     m_moment2->Buffer(),
+     static_cast<size_t>(values.LocalHeight() * values.LocalWidth())}};
+
+  // The norms are over the whole tensor
+  const bool distributed = values.DistSize() > 1;
+  layerwise_adaptive::step(entries,
+                           make_lamb_op(this->get_learning_rate(),
+                                        m_beta1,
+                                        m_beta2,
+                                        m_eps,
+                                        m_weight_decay,
+                                        m_current_beta1,
+                                        m_current_beta2),
+                           this->get_step_scale(),
+                           this->m_multi_tensor_workspace,
+                           gpu::get_sync_info(values),
+                           distributed ? &this->get_comm() : nullptr,
+                           &values.DistComm());
+}
+
+#ifdef LBANN_HAS_HALF
+template <>
+void lamb<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
+                                      const AbsDistMatrixType&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
+
+template <>
+void lamb<cpu_fp16>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
+#endif // LBANN_HAS_HALF
+
+#define PROTO(T)                                                               \
+  template void lamb<T>::step_compute_gpu(El::AbstractDistMatrix<T>&,          \
+                                          const El::AbstractDistMatrix<T>&);   \
+  template void lamb<T>::multi_tensor_step_compute(                            \
+    std::vector<multi_tensor_entry<T>> const&,                                 \
+    El::SyncInfo<El::Device::GPU> const&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,244 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/lars.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/optimizers/lars_impl.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+#include "lbann/utils/profiling.hpp"
+
+#include <cmath>
+#include <sstream>
+
+namespace lbann {
+
+template <typename TensorDataType>
+lars<TensorDataType>::lars(TensorDataType learning_rate,
+                           TensorDataType momentum,
+                           TensorDataType trust_coefficient,
+                           TensorDataType weight_decay,
+                           TensorDataType eps)
+  : BaseType(learning_rate),
+    m_momentum(momentum),
+    m_trust_coefficient(trust_coefficient),
+    m_weight_decay(weight_decay),
+    m_eps(eps)
+{}
+
+template <typename TensorDataType>
+lars<TensorDataType>::lars(const lars& other)
+  : BaseType(other),
+    m_momentum(other.m_momentum),
+    m_trust_coefficient(other.m_trust_coefficient),
+    m_weight_decay(other.m_weight_decay),
+    m_eps(other.m_eps),
+    m_velocity(other.m_velocity ? other.m_velocity->Copy() : nullptr)
+{}
+
+template <typename TensorDataType>
+lars<TensorDataType>&
+lars<TensorDataType>::operator=(const lars<TensorDataType>& other)
+{
+  OptimizerType::operator=(other);
+  m_momentum = other.m_momentum;
+  m_trust_coefficient = other.m_trust_coefficient;
+  m_weight_decay = other.m_weight_decay;
+  m_eps = other.m_eps;
+  m_velocity.reset(other.m_velocity ? other.m_velocity->Copy() : nullptr);
+  return *this;
+}
+
+template <typename TensorDataType>
+description lars<TensorDataType>::get_description() const
+{
+  auto desc = OptimizerType::get_description();
+  desc.add("Momentum", m_momentum);
+  desc.add("Trust coefficient", m_trust_coefficient);
+  desc.add("Weight decay", m_weight_decay);
+  desc.add("eps", m_eps);
+  return desc;
+}
+
+template <typename TensorDataType>
+size_t lars<TensorDataType>::get_state_size() const
+{
+  size_t allocated = m_velocity->AllocatedMemory() * sizeof(TensorDataType);
+  return data_type_optimizer<TensorDataType>::get_state_size() + allocated;
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::setup(WeightsType* w)
+{
+  OptimizerType::setup(w);
+  const auto& gradient = this->get_gradient_sharded();
+  m_velocity.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
+  El::Zeros(*m_velocity, gradient.Height(), gradient.Width());
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
+{
+  auto* opt = proto.mutable_lars();
+  opt->set_learn_rate(this->get_learning_rate());
+  opt->set_momentum(m_momentum);
+  opt->set_trust_coefficient(m_trust_coefficient);
+  opt->set_weight_decay(m_weight_decay);
+  opt->set_eps(m_eps);
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::step_compute(AbsDistMatrixType& values,
+                                        const AbsDistMatrixType& gradient)
+{
+  switch (values.GetLocalDevice()) {
+  case El::Device::CPU:
+    step_compute_cpu(values, gradient);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    step_compute_gpu(values, gradient);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    std::ostringstream err;
+    err << "unsupported device type "
+        << "(" << static_cast<int>(values.GetLocalDevice()) << ")";
+    LBANN_ERROR(err.str());
+  }
+}
+
+template <typename TensorDataType>
+std::string lars<TensorDataType>::get_multi_tensor_hyperparameters() const
+{
+  std::ostringstream ss;
+  ss << std::hexfloat << El::To<double>(m_momentum) << ' '
+     << El::To<double>(m_trust_coefficient) << ' '
+     << El::To<double>(m_weight_decay) << ' ' << El::To<double>(m_eps);
+  return ss.str();
+}
+
+template <typename TensorDataType>
+bool lars<TensorDataType>::get_multi_tensor_entry(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  multi_tensor_entry<TensorDataType>& entry)
+{
+  if (values.DistSize() != 1 || !values.Contiguous() ||
+      !gradient.Contiguous() || !m_velocity->Contiguous()) {
+    return false;
+  }
+  entry = {values.Buffer(),
+           gradient.LockedBuffer(),
+           m_velocity->Buffer(),
+           nullptr,
+           static_cast<size_t>(values.LocalHeight() * values.LocalWidth())};
+  return true;
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
+                                            const AbsDistMatrixType& gradient)
+{
+  LBANN_CALIPER_MARK_SCOPE("lars::step_compute");
+
+  // Get local matrix data
+  const size_t local_height = values.LocalHeight();
+  const size_t local_width = values.LocalWidth();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const size_t values_ldim = values.LDim();
+  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
+  const size_t gradient_ldim = gradient.LDim();
+  auto* __restrict__ velocity_buffer = m_velocity->Buffer();
+  const size_t velocity_ldim = m_velocity->LDim();
+
+  // Norms of the weights and the gradient
+  DataType x_sqsum = 0, g_sqsum = 0;
+  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+ : x_sqsum, g_sqsum) collapse(2))
+  for (size_t col = 0; col < local_width; ++col) {
+    for (size_t row = 0; row < local_height; ++row) {
+      const auto x = El::To<DataType>(values_buffer[row + col * values_ldim]);
+      const auto g =
+        El::To<DataType>(gradient_buffer[row + col * gradient_ldim]);
+      x_sqsum += x * x;
+      g_sqsum += g * g;
+    }
+  }
+  DataType norms[2] = {x_sqsum, g_sqsum};
+  if (values.DistSize() > 1) {
+    this->get_comm().allreduce(norms, 2, values.DistComm());
+  }
+
+  // Momentum step with the local learning rate
+  const DataType x_norm = std::sqrt(norms[0]);
+  const DataType g_norm = std::sqrt(norms[1]);
+  DataType local_lr = 1;
+  if (x_norm > DataType(0) && g_norm > DataType(0)) {
+    local_lr = El::To<DataType>(m_trust_coefficient) * x_norm /
+               (g_norm + El::To<DataType>(m_weight_decay) * x_norm +
+                El::To<DataType>(m_eps));
+  }
+  const auto step_size =
+    El::To<TensorDataType>(this->get_learning_rate() * local_lr);
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (size_t col = 0; col < local_width; ++col) {
+    for (size_t row = 0; row < local_height; ++row) {
+      auto& x = values_buffer[row + col * values_ldim];
+      const auto& g = gradient_buffer[row + col * gradient_ldim];
+      auto& v = velocity_buffer[row + col * velocity_ldim];
+      v = m_momentum * v + step_size * (g + m_weight_decay * x);
+      x -= v;
+    }
+  }
+}
+
+template <typename TensorDataType>
+std::unique_ptr<optimizer>
+build_lars_optimizer_from_pbuf(google::protobuf::Message const& msg)
+{
+  const auto& params = dynamic_cast<lbann_data::Optimizer::LARS const&>(msg);
+  return std::make_unique<lars<TensorDataType>>(
+    TensorDataType(params.learn_rate()),
+    TensorDataType(params.momentum()),
+    TensorDataType(params.trust_coefficient()),
+    TensorDataType(params.weight_decay()),
+    TensorDataType(params.eps()));
+}
+
+#define PROTO(T)                                                               \
+  template class lars<T>;                                                      \
+  template std::unique_ptr<optimizer> build_lars_optimizer_from_pbuf<T>(       \
+    google::protobuf::Message const&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
+
+#define LBANN_CLASS_NAME lars
+#include <lbann/macros/register_template_class_with_cereal.hpp>
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/lars.hpp"
+#include "lbann/utils/profiling.hpp"
+
+#include "layerwise_adaptive.cuh"
+
+namespace lbann {
+
+namespace {
+
+template <typename TensorDataType>
+struct lars_op
+{
+  DataType learning_rate;
+  TensorDataType momentum;
+  DataType trust_coefficient;
+  TensorDataType weight_decay;
+  DataType eps;
+
+  __device__ void accumulate(multi_tensor_entry<TensorDataType> const& e,
+                             size_t i,
+                             TensorDataType scale,
+                             DataType& x_sqsum,
+                             DataType& g_sqsum) const
+  {
+    const auto x = static_cast<DataType>(e.values[i]);
+    const auto g = static_cast<DataType>(scale * e.gradient[i]);
+    x_sqsum += x * x;
+    g_sqsum += g * g;
+  }
+
+  __device__ void update(multi_tensor_entry<TensorDataType> const& e,
+                         size_t i,
+                         TensorDataType scale,
+                         DataType x_sqsum,
+                         DataType g_sqsum) const
+  {
+    const DataType x_norm = gpu_lib::sqrt(x_sqsum);
+    const DataType g_norm = gpu_lib::sqrt(g_sqsum);
+    DataType local_lr = 1;
+    if (x_norm > DataType(0) && g_norm > DataType(0)) {
+      local_lr =
+        trust_coefficient * x_norm /
+        (g_norm + static_cast<DataType>(weight_decay) * x_norm + eps);
+    }
+    const TensorDataType step_size(learning_rate * local_lr);
+    auto& x = e.values[i];
+    auto& v = e.state0[i];
+    v = momentum * v + step_size * (scale * e.gradient[i] + weight_decay * x);
+    x -= v;
+  }
+};
+
+template <typename TensorDataType>
+lars_op<TensorDataType> make_lars_op(double learning_rate,
+                                     TensorDataType momentum,
+                                     TensorDataType trust_coefficient,
+                                     TensorDataType weight_decay,
+                                     TensorDataType eps)
+{
+  return {El::To<DataType>(learning_rate),
+          momentum,
+          El::To<DataType>(trust_coefficient),
+          weight_decay,
+          El::To<DataType>(eps)};
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void lars<TensorDataType>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  LBANN_CALIPER_MARK_SCOPE("lars::multi_tensor_step");
+  layerwise_adaptive::step(entries,
+                           make_lars_op(this->get_learning_rate(),
+                                        m_momentum,
+                                        m_trust_coefficient,
+                                        m_weight_decay,
+                                        m_eps),
+                           this->get_step_scale(),
+                           this->m_multi_tensor_workspace,
+                           sync_info);
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::step_compute_gpu(AbsDistMatrixType& values,
+                                            const AbsDistMatrixType& gradient)
+{
+  LBANN_CALIPER_MARK_SCOPE("lars::step_compute");
+  if (!values.Contiguous() || !gradient.Contiguous() ||
+      !m_velocity->Contiguous()) {
+    LBANN_ERROR("LARS requires contiguous GPU buffers");
+  }
+  const std::vector<multi_tensor_entry<TensorDataType>> entries{
+    {values.Buffer(),
+     gradient.LockedBuffer(),
+     m_velocity->Buffer(),
+     nullptr,
+     static_cast<size_t>(values.LocalHeight() * values.LocalWidth())}};
+
+  // The norms are over the whole tensor
+  const bool distributed = values.DistSize() > 1;
+  layerwise_adaptive::step(entries,
+                           make_lars_op(this->get_learning_rate(),
+                                        m_momentum,
+                                        m_trust_coefficient,
+                                        m_weight_decay,
+                                        m_eps),
+                           this->get_step_scale(),
+                           this->m_multi_tensor_workspace,
+                           gpu::get_sync_info(values),
+                           distributed ? &this->get_comm() : nullptr,
+                           &values.DistComm());
+}
+
+#ifdef LBANN_HAS_HALF
+template <>
+void lars<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
+                                      const AbsDistMatrixType&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
+
+template <>
+void lars<cpu_fp16>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
+#endif // LBANN_HAS_HALF
+
+#define PROTO(T)                                                               \
+  template void lars<T>::step_compute_gpu(El::AbstractDistMatrix<T>&,          \
+                                          const El::AbstractDistMatrix<T>&);   \
+  template void lars<T>::multi_tensor_step_compute(                            \
+    std::vector<multi_tensor_entry<T>> const&,                                 \
+    El::SyncInfo<El::Device::GPU> const&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SRC_OPTIMIZERS_LAYERWISE_ADAPTIVE_CUH_INCLUDED
+#define LBANN_SRC_OPTIMIZERS_LAYERWISE_ADAPTIVE_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+#include "multi_tensor.cuh"
+
+namespace lbann {
+
+/** @brief Steps whose size is rescaled per tensor by a trust ratio
+ *         (LAMB, LARS).
+ *
+ *  A step is two launches over the multi-tensor table. The first
+ *  calls @c op.accumulate(entry,i,scale,sum0,sum1) for every entry,
+ *  which may update optimizer state and adds to two per-tensor sums
+ *  (typically squared norms). The second calls
+ *  @c op.update(entry,i,scale,sum0,sum1) with the tensor's totals.
+ *  The sums stay on the device, so there is no host synchronization.
+ */
+namespace layerwise_adaptive {
+
+template <typename TensorDataType, typename OpT>
+__global__ void
+accumulate_kernel(multi_tensor_entry<TensorDataType> const* __restrict__ entries,
+                  size_t const* __restrict__ chunk_offsets,
+                  size_t num_tensors,
+                  size_t num_chunks,
+                  OpT op,
+                  float const* __restrict__ step_scale,
+                  DataType* __restrict__ sums)
+{
+  using multi_tensor::block_size;
+  using multi_tensor::chunk_size;
+  if (step_scale != nullptr && *step_scale == 0.f) {
+    return;
+  }
+  const TensorDataType scale =
+    step_scale != nullptr ? TensorDataType(*step_scale) : TensorDataType(1);
+  for (size_t chunk = blockIdx.x; chunk < num_chunks; chunk += gridDim.x) {
+    const size_t t =
+      multi_tensor::find_tensor(chunk_offsets, num_tensors, chunk);
+    const auto& entry = entries[t];
+    const size_t begin = (chunk - chunk_offsets[t]) * chunk_size;
+    const size_t end =
+      (begin + chunk_size < entry.size) ? begin + chunk_size : entry.size;
+    DataType sum0 = 0, sum1 = 0;
+    for (size_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+      op.accumulate(entry, i, scale, sum0, sum1);
+    }
+    // The reductions share their shared memory workspace
+    sum0 = gpu_lib::block_reduce<block_size, 1, 1>(sum0);
+    __syncthreads();
+    sum1 = gpu_lib::block_reduce<block_size, 1, 1>(sum1);
+    __syncthreads();
+    if (threadIdx.x == 0) {
+      gpu_lib::atomic_add(&sums[2 * t], sum0);
+      gpu_lib::atomic_add(&sums[2 * t + 1], sum1);
+    }
+  }
+}
+
+template <typename TensorDataType, typename OpT>
+__global__ void
+update_kernel(multi_tensor_entry<TensorDataType> const* __restrict__ entries,
+              size_t const* __restrict__ chunk_offsets,
+              size_t num_tensors,
+              size_t num_chunks,
+              OpT op,
+              float const* __restrict__ step_scale,
+              DataType const* __restrict__ sums)
+{
+  using multi_tensor::chunk_size;
+  if (step_scale != nullptr && *step_scale == 0.f) {
+    return;
+  }
+  const TensorDataType scale =
+    step_scale != nullptr ? TensorDataType(*step_scale) : TensorDataType(1);
+  for (size_t chunk = blockIdx.x; chunk < num_chunks; chunk += gridDim.x) {
+    const size_t t =
+      multi_tensor::find_tensor(chunk_offsets, num_tensors, chunk);
+    const auto& entry = entries[t];
+    const DataType sum0 = sums[2 * t];
+    const DataType sum1 = sums[2 * t + 1];
+    const size_t begin = (chunk - chunk_offsets[t]) * chunk_size;
+    const size_t end =
+      (begin + chunk_size < entry.size) ? begin + chunk_size : entry.size;
+    for (size_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+      op.update(entry, i, scale, sum0, sum1);
+    }
+  }
+}
+
+/** @brief Step many tensors with per-tensor trust ratios.
+ *
+ *  @c step_scale multiplies the gradient as in multi_tensor::apply.
+ *  If @c comm is given, the sums are added over @c sum_comm between
+ *  the launches; this is for a single tensor whose entries are spread
+ *  over that communicator, and every rank in it must call this.
+ */
+template <typename TensorDataType, typename OpT>
+void step(std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+          OpT const& op,
+          float const* step_scale,
+          multi_tensor_workspace& workspace,
+          El::SyncInfo<El::Device::GPU> const& sync_info,
+          lbann_comm* comm = nullptr,
+          El::mpi::Comm const* sum_comm = nullptr)
+{
+  auto table = multi_tensor::make_device_table(entries, workspace, sync_info);
+  if (table.num_chunks == 0 && comm == nullptr) {
+    return;
+  }
+
+  El::Matrix<DataType, El::Device::GPU> sums;
+  sums.SetSyncInfo(sync_info);
+#ifdef HYDROGEN_HAVE_CUB
+  sums.SetMemoryMode(1); // Use CUB memory pool.
+#endif
+  El::Zeros(sums, 2, entries.size());
+  const auto grid_dims = multi_tensor::get_grid_dims(table.num_chunks);
+  const dim3 block_dims(multi_tensor::block_size);
+  if (table.num_chunks > 0) {
+    hydrogen::gpu::LaunchKernel(accumulate_kernel<TensorDataType, OpT>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                table.entries,
+                                table.chunk_offsets,
+                                table.num_tensors,
+                                table.num_chunks,
+                                op,
+                                step_scale,
+                                sums.Buffer());
+  }
+  if (comm != nullptr) {
+    comm->allreduce(static_cast<El::AbstractMatrix<DataType>&>(sums),
+                    *sum_comm);
+  }
+  if (table.num_chunks > 0) {
+    hydrogen::gpu::LaunchKernel(update_kernel<TensorDataType, OpT>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                table.entries,
+                                table.chunk_offsets,
+                                table.num_tensors,
+                                table.num_chunks,
+                                op,
+                                step_scale,
+                                sums.LockedBuffer());
+  }
+}
+
+} // namespace layerwise_adaptive
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_OPTIMIZERS_LAYERWISE_ADAPTIVE_CUH_INCLUDED
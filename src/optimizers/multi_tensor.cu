@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/multi_tensor.hpp"
+#include "lbann/utils/profiling.hpp"
+
+#include "multi_tensor.cuh"
+
+namespace lbann {
+
+namespace {
+
+using multi_tensor::block_size;
+using multi_tensor::chunk_size;
+
+template <typename TensorDataType>
+using SumOfSquaresEntry = multi_tensor_sum_of_squares::entry<TensorDataType>;
+
+template <typename TensorDataType>
+__global__ void sum_of_squares_kernel(
+  SumOfSquaresEntry<TensorDataType> const* __restrict__ entries,
+  size_t const* __restrict__ chunk_offsets,
+  size_t num_tensors,
+  size_t num_chunks,
+  DataType* __restrict__ sums)
+{
+  for (size_t chunk = blockIdx.x; chunk < num_chunks; chunk += gridDim.x) {
+    const size_t t =
+      multi_tensor::find_tensor(chunk_offsets, num_tensors, chunk);
+    const auto& entry = entries[t];
+    const size_t begin = (chunk - chunk_offsets[t]) * chunk_size;
+    const size_t end =
+      (begin + chunk_size < entry.size) ? begin + chunk_size : entry.size;
+    DataType thread_sum = 0;
+    for (size_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+      const auto x = static_cast<DataType>(entry.buffer[i]);
+      thread_sum += x * x;
+    }
+    const DataType block_sum =
+      gpu_lib::block_reduce<block_size, 1, 1>(thread_sum);
+    if (threadIdx.x == 0) {
+      gpu_lib::atomic_add(&sums[entry.slot], entry.scale * block_sum);
+    }
+  }
+}
+
+template <typename TensorDataType>
+void launch_sum_of_squares(
+  std::vector<SumOfSquaresEntry<TensorDataType>>& entries,
+  multi_tensor_workspace& workspace,
+  El::Matrix<DataType, El::Device::GPU>& sums)
+{
+  if (entries.empty()) {
+    return;
+  }
+  auto sync_info = gpu::get_sync_info(sums);
+  auto table = multi_tensor::make_device_table(entries, workspace, sync_info);
+  entries.clear();
+  if (table.num_chunks == 0) {
+    return;
+  }
+  hydrogen::gpu::LaunchKernel(sum_of_squares_kernel<TensorDataType>,
+                              multi_tensor::get_grid_dims(table.num_chunks),
+                              dim3(block_size),
+                              0,
+                              sync_info,
+                              table.entries,
+                              table.chunk_offsets,
+                              table.num_tensors,
+                              table.num_chunks,
+                              sums.Buffer());
+}
+
+} // namespace
+
+void multi_tensor_sum_of_squares::add(float const* buffer,
+                                      size_t size,
+                                      size_t slot,
+                                      DataType scale)
+{
+  m_float_entries.push_back({buffer, size, slot, scale});
+}
+
+void multi_tensor_sum_of_squares::add(double const* buffer,
+                                      size_t size,
+                                      size_t slot,
+                                      DataType scale)
+{
+  m_double_entries.push_back({buffer, size, slot, scale});
+}
+
+#ifdef LBANN_HAS_GPU_FP16
+void multi_tensor_sum_of_squares::add(fp16 const* buffer,
+                                      size_t size,
+                                      size_t slot,
+                                      DataType scale)
+{
+  m_fp16_entries.push_back({buffer, size, slot, scale});
+}
+#endif // LBANN_HAS_GPU_FP16
+
+bool multi_tensor_sum_of_squares::empty() const noexcept
+{
+  bool is_empty = m_float_entries.empty() && m_double_entries.empty();
+#ifdef LBANN_HAS_GPU_FP16
+  is_empty = is_empty && m_fp16_entries.empty();
+#endif // LBANN_HAS_GPU_FP16
+  return is_empty;
+}
+
+void multi_tensor_sum_of_squares::launch(
+  size_t num_slots,
+  El::Matrix<DataType, El::Device::GPU>& sums)
+{
+  LBANN_CALIPER_MARK_SCOPE("multi_tensor::sum_of_squares");
+  El::Zeros(sums, num_slots, 1);
+  launch_sum_of_squares(m_float_entries, m_workspace, sums);
+  launch_sum_of_squares(m_double_entries, m_workspace, sums);
+#ifdef LBANN_HAS_GPU_FP16
+  launch_sum_of_squares(m_fp16_entries, m_workspace, sums);
+#endif // LBANN_HAS_GPU_FP16
+}
+
+std::vector<DataType> multi_tensor_sum_of_squares::finish(
+  size_t num_slots,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  std::vector<DataType> result(num_slots, DataType(0));
+  if (empty()) {
+    return result;
+  }
+
+  El::Matrix<DataType, El::Device::GPU> sums;
+  sums.SetSyncInfo(sync_info);
+#ifdef HYDROGEN_HAVE_CUB
+  sums.SetMemoryMode(1); // Use CUB memory pool.
+#endif
+  launch(num_slots, sums);
+
+  hydrogen::gpu::Copy1DToHost(sums.LockedBuffer(),
+                              result.data(),
+                              num_slots,
+                              sync_info);
+  El::Synchronize(sync_info);
+  return result;
+}
+
+} // namespace lbann
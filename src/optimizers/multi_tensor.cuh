@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SRC_OPTIMIZERS_MULTI_TENSOR_CUH_INCLUDED
+#define LBANN_SRC_OPTIMIZERS_MULTI_TENSOR_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/optimizers/multi_tensor.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace lbann {
+namespace multi_tensor {
+
+/** @brief Number of tensor entries handled by one thread block. */
+constexpr size_t chunk_size = 4096;
+/** @brief Threads per block in multi-tensor kernels. */
+constexpr size_t block_size = 256;
+
+/** @brief Index of the tensor that owns a chunk.
+ *  @param chunk_offsets Prefix sums of the tensors' chunk counts.
+ */
+__device__ __forceinline__ size_t find_tensor(size_t const* chunk_offsets,
+                                              size_t num_tensors,
+                                              size_t chunk)
+{
+  size_t lo = 0;
+  size_t hi = num_tensors;
+  while (hi - lo > 1) {
+    const size_t mid = (lo + hi) / 2;
+    if (chunk_offsets[mid] <= chunk) {
+      lo = mid;
+    }
+    else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/** @brief Device copy of a table of tensors and their chunk offsets. */
+template <typename EntryT>
+struct device_table
+{
+  hydrogen::simple_buffer<unsigned char, El::Device::GPU> buffer;
+  EntryT const* entries;
+  size_t const* chunk_offsets;
+  size_t num_tensors;
+  size_t num_chunks;
+};
+
+/** @brief Copy the non-empty tensors of @c entries to the device.
+ *
+ *  @c EntryT must have a @c size member. The host staging buffer is
+ *  reused once the previous copy from it has finished.
+ */
+template <typename EntryT>
+device_table<EntryT> make_device_table(std::vector<EntryT> const& entries,
+                                       multi_tensor_workspace& workspace,
+                                       El::SyncInfo<El::Device::GPU> const& si)
+{
+  std::vector<EntryT> tensors;
+  std::vector<size_t> chunk_offsets(1, 0);
+  tensors.reserve(entries.size());
+  chunk_offsets.reserve(entries.size() + 1);
+  for (auto const& e : entries) {
+    if (e.size > 0) {
+      tensors.push_back(e);
+      chunk_offsets.push_back(chunk_offsets.back() +
+                              (e.size + chunk_size - 1) / chunk_size);
+    }
+  }
+
+  // Entries hold 8-byte members, so the offsets that follow them
+  // stay aligned
+  const size_t entries_bytes = sizeof(EntryT) * tensors.size();
+  const size_t offsets_bytes = sizeof(size_t) * chunk_offsets.size();
+  workspace.event.synchronize();
+  workspace.host.resize(entries_bytes + offsets_bytes);
+  std::memcpy(workspace.host.data(), tensors.data(), entries_bytes);
+  std::memcpy(workspace.host.data() + entries_bytes,
+              chunk_offsets.data(),
+              offsets_bytes);
+
+  device_table<EntryT> table{
+    hydrogen::simple_buffer<unsigned char, El::Device::GPU>(
+      workspace.host.size(),
+      si),
+    nullptr,
+    nullptr,
+    tensors.size(),
+    chunk_offsets.back()};
+  if (table.num_tensors == 0) {
+    return table;
+  }
+  hydrogen::gpu::Copy1DToDevice(workspace.host.data(),
+                                table.buffer.data(),
+                                workspace.host.size(),
+                                si);
+  workspace.event.record(si.Stream());
+  table.entries = reinterpret_cast<EntryT const*>(table.buffer.data());
+  table.chunk_offsets =
+    reinterpret_cast<size_t const*>(table.buffer.data() + entries_bytes);
+  return table;
+}
+
+/** @brief Grid for a launch over @c num_chunks chunks. */
+inline dim3 get_grid_dims(size_t num_chunks)
+{
+  dim3 grid_dims(num_chunks);
+  gpu_lib::clip_grid_dims(grid_dims);
+  return grid_dims;
+}
+
+template <typename TensorDataType, typename OpT>
+__global__ void
+apply_kernel(multi_tensor_entry<TensorDataType> const* __restrict__ entries,
+             size_t const* __restrict__ chunk_offsets,
+             size_t num_tensors,
+             size_t num_chunks,
+             OpT op,
+             float const* __restrict__ step_scale)
+{
+  if (step_scale != nullptr && *step_scale == 0.f) {
+    return;
+  }
+  const TensorDataType scale =
+    step_scale != nullptr ? TensorDataType(*step_scale) : TensorDataType(1);
+  for (size_t chunk = blockIdx.x; chunk < num_chunks; chunk += gridDim.x) {
+    const size_t t = find_tensor(chunk_offsets, num_tensors, chunk);
+    const auto& entry = entries[t];
+    const size_t begin = (chunk - chunk_offsets[t]) * chunk_size;
+    const size_t end =
+      (begin + chunk_size < entry.size) ? begin + chunk_size : entry.size;
+    for (size_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+      op(entry, i, scale);
+    }
+  }
+}
+
+/** @brief Apply an optimizer update to many tensors in one launch.
+ *
+ *  @c op is called on the device as @c op(entry,i,scale) for every
+ *  index @c i of every entry, where @c scale is the value of
+ *  @c step_scale (one if it is null) to multiply the gradient by. If
+ *  it is zero, nothing is updated.
+ */
+template <typename TensorDataType, typename OpT>
+void apply(std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+           OpT const& op,
+           float const* step_scale,
+           multi_tensor_workspace& workspace,
+           El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  auto table = make_device_table(entries, workspace, sync_info);
+  if (table.num_chunks == 0) {
+    return;
+  }
+  hydrogen::gpu::LaunchKernel(apply_kernel<TensorDataType, OpT>,
+                              get_grid_dims(table.num_chunks),
+                              dim3(block_size),
+                              0,
+                              sync_info,
+                              table.entries,
+                              table.chunk_offsets,
+                              table.num_tensors,
+                              table.num_chunks,
+                              op,
+                              step_scale);
+}
+
+} // namespace multi_tensor
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_OPTIMIZERS_MULTI_TENSOR_CUH_INCLUDED
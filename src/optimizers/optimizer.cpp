@@ -39,9 +39,38 @@ void optimizer::clear_gradient()
     }
     g.second->clear();
   }
+  this->clear_sparse_gradient();
   this->get_gradient_sources().clear();
 }
 
+bool optimizer::has_gradient_contributions() const
+{
+  for (auto const& g : m_local_gradient_contributions) {
+    if (g.second->get_status() != optimizer_gradient_status::cleared) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void optimizer::scale_gradient(EvalType factor)
+{
+  for (auto& g : m_local_gradient_contributions) {
+    switch (g.second->get_status()) {
+    case optimizer_gradient_status::cleared:
+      break;
+    case optimizer_gradient_status::ready:
+    case optimizer_gradient_status::sync_needed:
+      g.second->scale(factor);
+      break;
+    default:
+      LBANN_ERROR("attempted to scale a gradient whose synchronization "
+                  "has started");
+    }
+  }
+  this->scale_sparse_gradient(factor);
+}
+
 void optimizer::start_gradient_sync()
 {
   for (auto& grad_mgr : m_local_gradient_contributions) {
@@ -51,9 +80,11 @@ void optimizer::start_gradient_sync()
 
 void optimizer::finish_gradient_sync()
 {
+  const EvalType start = get_time();
   for (auto& grad_mgr : m_local_gradient_contributions) {
     grad_mgr.second->complete_sync(*m_comm);
   }
+  add_gradient_sync_wait_time(get_time() - start);
 }
 
 std::vector<std::reference_wrapper<El::BaseDistMatrix>>
@@ -117,6 +148,13 @@ optimizer& optimizer::operator=(const optimizer& other)
   return *this;
 }
 
+void optimizer::multi_tensor_step(std::vector<optimizer*> const& group)
+{
+  for (auto* opt : group) {
+    opt->step();
+  }
+}
+
 template <class Archive>
 void optimizer::serialize(Archive& ar)
 {
@@ -129,6 +167,17 @@ description optimizer::get_description() const
   return desc;
 }
 
+double optimizer::get_gradient_compression_ratio() const
+{
+  for (auto const& grad_mgr : m_local_gradient_contributions) {
+    const double ratio = grad_mgr.second->get_compression_ratio();
+    if (ratio > 0.) {
+      return ratio;
+    }
+  }
+  return 0.;
+}
+
 El::Int optimizer::get_num_gradient_sources() const
 {
   return m_gradient_sources.size();
@@ -145,7 +194,7 @@ void optimizer::remove_gradient_source(const void* source)
 {
   m_gradient_sources.erase(nullptr);
   m_gradient_sources.erase(source);
-  if (get_gradient_sources().empty()) {
+  if (get_gradient_sources().empty() && !m_gradient_sync_deferred) {
     start_gradient_sync();
   }
 }
@@ -159,6 +208,7 @@ void optimizer::remove_gradient_source(const void* source)
     T& buf_scale,                                                              \
     T& in_scale,                                                               \
     bool sync_needed);                                                         \
+  template void lbann::optimizer::set_gradient_storage(T * buffer);            \
   template void lbann::optimizer::add_to_gradient(                             \
     El::AbstractDistMatrix<T> const& contrib,                                  \
     T scale,                                                                   \
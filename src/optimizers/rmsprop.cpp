@@ -25,17 +25,45 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/optimizers/rmsprop_impl.hpp"
+#include "lbann/optimizers/fused_update.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/profiling.hpp"
 
+#include <sstream>
+
 namespace lbann {
 
+namespace {
+
+template <typename TensorDataType>
+struct rmsprop_update
+{
+  TensorDataType learning_rate;
+  TensorDataType decay_rate;
+  TensorDataType eps;
+  bool operator()(TensorDataType& x,
+                  TensorDataType g,
+                  TensorDataType& c,
+                  TensorDataType&) const
+  {
+    c = decay_rate * c + (TensorDataType(1.) - decay_rate) * g * g;
+    x -= learning_rate * g / (El::Sqrt(c) + eps);
+    return true;
+  }
+};
+
+} // namespace
+
 template <typename TensorDataType>
 rmsprop<TensorDataType>::rmsprop(TensorDataType learning_rate,
                                  TensorDataType decay_rate,
-                                 TensorDataType eps)
-  : BaseType(learning_rate), m_decay_rate(decay_rate), m_eps(eps)
+                                 TensorDataType eps,
+                                 TensorDataType weight_decay)
+  : BaseType(learning_rate),
+    m_decay_rate(decay_rate),
+    m_eps(eps),
+    m_weight_decay(weight_decay)
 {}
 
 template <typename TensorDataType>
@@ -43,6 +71,7 @@ rmsprop<TensorDataType>::rmsprop(const rmsprop& other)
   : BaseType(other),
     m_decay_rate(other.m_decay_rate),
     m_eps(other.m_eps),
+    m_weight_decay(other.m_weight_decay),
     m_cache(other.m_cache ? other.m_cache->Copy() : nullptr)
 {}
 
@@ -53,6 +82,7 @@ rmsprop<TensorDataType>::operator=(const rmsprop& other)
   OptimizerType::operator=(other);
   m_decay_rate = other.m_decay_rate;
   m_eps = other.m_eps;
+  m_weight_decay = other.m_weight_decay;
   m_cache.reset(other.m_cache ? other.m_cache->Copy() : nullptr);
   return *this;
 }
@@ -63,6 +93,9 @@ description rmsprop<TensorDataType>::get_description() const
   auto desc = OptimizerType::get_description();
   desc.add("Decay rate", m_decay_rate);
   desc.add("eps", m_eps);
+  if (m_weight_decay != El::To<TensorDataType>(0)) {
+    desc.add("Weight decay", m_weight_decay);
+  }
   return desc;
 }
 
@@ -89,6 +122,7 @@ void rmsprop<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
   opt->set_learn_rate(this->get_learning_rate());
   opt->set_decay_rate(m_decay_rate);
   opt->set_eps(m_eps);
+  opt->set_weight_decay(m_weight_decay);
 }
 
 template <typename TensorDataType>
@@ -112,35 +146,47 @@ void rmsprop<TensorDataType>::step_compute(AbsDistMatrixType& values,
   }
 }
 
+template <typename TensorDataType>
+std::string rmsprop<TensorDataType>::get_multi_tensor_hyperparameters() const
+{
+  std::ostringstream ss;
+  ss << std::hexfloat << El::To<double>(m_decay_rate) << ' '
+     << El::To<double>(m_eps) << ' ' << El::To<double>(m_weight_decay);
+  return ss.str();
+}
+
+template <typename TensorDataType>
+bool rmsprop<TensorDataType>::get_multi_tensor_entry(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  multi_tensor_entry<TensorDataType>& entry)
+{
+  if (!values.Contiguous() || !gradient.Contiguous() ||
+      !m_cache->Contiguous()) {
+    return false;
+  }
+  entry = {values.Buffer(),
+           gradient.LockedBuffer(),
+           m_cache->Buffer(),
+           nullptr,
+           static_cast<size_t>(values.LocalHeight() * values.LocalWidth())};
+  return true;
+}
+
 template <typename TensorDataType>
 void rmsprop<TensorDataType>::step_compute_cpu(
   AbsDistMatrixType& values,
   const AbsDistMatrixType& gradient)
 {
   LBANN_CALIPER_MARK_SCOPE("rmsprop::step_compute");
-
-  // Get local matrix data
-  const size_t local_height = values.LocalHeight();
-  const size_t local_width = values.LocalWidth();
-  auto* __restrict__ values_buffer = values.Buffer();
-  const size_t values_ldim = values.LDim();
-  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
-  const size_t gradient_ldim = gradient.LDim();
-  auto* __restrict__ cache_buffer = m_cache->Buffer();
-  const size_t cache_ldim = m_cache->LDim();
-
-  // Apply RMSprop step
   const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
-  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
-  for (size_t col = 0; col < local_width; ++col) {
-    for (size_t row = 0; row < local_height; ++row) {
-      auto& x = values_buffer[row + col * values_ldim];
-      const auto& g = gradient_buffer[row + col * gradient_ldim];
-      auto& c = cache_buffer[row + col * cache_ldim];
-      c = m_decay_rate * c + (TensorDataType(1.) - m_decay_rate) * g * g;
-      x -= learning_rate * g / (El::Sqrt(c) + m_eps);
-    }
-  }
+  fused_update::apply_cpu(
+    values,
+    gradient,
+    m_cache.get(),
+    nullptr,
+    learning_rate * m_weight_decay,
+    rmsprop_update<TensorDataType>{learning_rate, m_decay_rate, m_eps});
 }
 
 template <typename TensorDataType>
@@ -151,7 +197,8 @@ build_rmsprop_optimizer_from_pbuf(google::protobuf::Message const& msg)
   return std::make_unique<rmsprop<TensorDataType>>(
     TensorDataType(params.learn_rate()),
     TensorDataType(params.decay_rate()),
-    TensorDataType(params.eps()));
+    TensorDataType(params.eps()),
+    TensorDataType(params.weight_decay()));
 }
 
 #define PROTO(T)                                                               \
@@ -28,69 +28,70 @@
 #include "lbann/utils/gpu/helpers.hpp"
 #include "lbann/utils/profiling.hpp"
 
+#include "fused_update.cuh"
+
 namespace lbann {
 
 namespace {
 
 template <typename TensorDataType>
-__global__ void rmsprop_kernel(size_t height,
-                               size_t width,
-                               TensorDataType learning_rate,
-                               TensorDataType decay_rate,
-                               TensorDataType eps,
-                               TensorDataType* __restrict__ values,
-                               size_t values_ldim,
-                               const TensorDataType* __restrict__ gradient,
-                               size_t gradient_ldim,
-                               TensorDataType* __restrict__ cache,
-                               size_t cache_ldim)
+struct rmsprop_update
 {
-  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
-  const size_t nthreads = gridDim.x * blockDim.x;
-  for (size_t pos = gid; pos < height * width; pos += nthreads) {
-    const auto& row = pos % height;
-    const auto& col = pos / height;
-    const auto& g = gradient[row + col * gradient_ldim];
-    auto& c = cache[row + col * cache_ldim];
-    auto& x = values[row + col * values_ldim];
+  TensorDataType learning_rate;
+  TensorDataType decay_rate;
+  TensorDataType eps;
+  __device__ bool operator()(TensorDataType& x,
+                             TensorDataType g,
+                             TensorDataType& c,
+                             TensorDataType&) const
+  {
     c = decay_rate * c + (TensorDataType(1) - decay_rate) * g * g;
     x -= learning_rate * g / (gpu_lib::sqrt(c) + eps);
+    return true;
   }
-}
+};
 
 } // namespace
 
+template <typename TensorDataType>
+void rmsprop<TensorDataType>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  LBANN_CALIPER_MARK_SCOPE("rmsprop::multi_tensor_step");
+  const auto weight_decay = El::To<TensorDataType>(
+    this->get_learning_rate() * El::To<float>(m_weight_decay));
+  fused_update::apply_multi_tensor(
+    entries,
+    weight_decay,
+    rmsprop_update<TensorDataType>{
+      El::To<TensorDataType>(this->get_learning_rate()),
+      m_decay_rate,
+      m_eps},
+    this->get_step_scale(),
+    this->m_multi_tensor_workspace,
+    sync_info);
+}
+
 template <typename TensorDataType>
 void rmsprop<TensorDataType>::step_compute_gpu(
   AbsDistMatrixType& values,
   const AbsDistMatrixType& gradient)
 {
   LBANN_CALIPER_MARK_SCOPE("rmsprop::step_compute");
-  const size_t local_height = values.LocalHeight();
-  const size_t local_width = values.LocalWidth();
-  const size_t local_size = local_height * local_width;
-  if (local_size > 0) {
-    constexpr size_t block_size = 256;
-    const size_t grid_size = (local_size + block_size - 1) / block_size;
-    auto multisync = El::MakeMultiSync(gpu::get_sync_info(values),
-                                       gpu::get_sync_info(gradient));
-    hydrogen::gpu::LaunchKernel(rmsprop_kernel<TensorDataType>,
-                                grid_size,
-                                block_size,
-                                0,
-                                multisync,
-                                local_height,
-                                local_width,
-                                this->get_learning_rate(),
-                                m_decay_rate,
-                                m_eps,
-                                values.Buffer(),
-                                values.LDim(),
-                                gradient.LockedBuffer(),
-                                gradient.LDim(),
-                                m_cache->Buffer(),
-                                m_cache->LDim());
-  }
+  const auto weight_decay = El::To<TensorDataType>(
+    this->get_learning_rate() * El::To<float>(m_weight_decay));
+  fused_update::apply_gpu(
+    values,
+    gradient,
+    m_cache.get(),
+    nullptr,
+    weight_decay,
+    rmsprop_update<TensorDataType>{
+      El::To<TensorDataType>(this->get_learning_rate()),
+      m_decay_rate,
+      m_eps},
+    this->get_step_scale());
 }
 
 #ifdef LBANN_HAS_HALF
@@ -100,11 +101,23 @@ void rmsprop<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
 {
   LBANN_ERROR("Can't call this function with cpu_fp16!");
 }
+
+template <>
+void rmsprop<cpu_fp16>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
 #endif // LBANN_HAS_HALF
 
 #define PROTO(T)                                                               \
-  template void rmsprop<T>::step_compute_gpu(El::AbstractDistMatrix<T>&,       \
-                                             const El::AbstractDistMatrix<T>&)
+  template void rmsprop<T>::step_compute_gpu(                                  \
+    El::AbstractDistMatrix<T>&,                                                \
+    const El::AbstractDistMatrix<T>&);                                         \
+  template void rmsprop<T>::multi_tensor_step_compute(                         \
+    std::vector<multi_tensor_entry<T>> const&,                                 \
+    El::SyncInfo<El::Device::GPU> const&)
 
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
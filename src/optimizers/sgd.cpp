@@ -25,19 +25,48 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/optimizers/sgd_impl.hpp"
+#include "lbann/optimizers/fused_update.hpp"
 #include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/profiling.hpp"
 
+#include <sstream>
+
 namespace lbann {
 
+namespace {
+
+/** @brief Momentum or Nesterov SGD; vanilla SGD without velocity */
+template <typename TensorDataType>
+struct sgd_update
+{
+  TensorDataType learning_rate;
+  TensorDataType momentum;
+  bool nesterov;
+  bool operator()(TensorDataType& x,
+                  TensorDataType g,
+                  TensorDataType& v,
+                  TensorDataType&) const
+  {
+    v = momentum * v + g;
+    x -= nesterov ? learning_rate * (momentum * v + g) : learning_rate * v;
+    return true;
+  }
+};
+
+} // namespace
+
 template <typename TensorDataType>
 sgd<TensorDataType>::sgd(TensorDataType learning_rate,
                          TensorDataType momentum,
-                         bool nesterov)
-  : BaseType(learning_rate), m_momentum(momentum), m_nesterov(nesterov)
+                         bool nesterov,
+                         TensorDataType weight_decay)
+  : BaseType(learning_rate),
+    m_momentum(momentum),
+    m_nesterov(nesterov),
+    m_weight_decay(weight_decay)
 {}
 
 template <typename TensorDataType>
@@ -45,6 +74,7 @@ sgd<TensorDataType>::sgd(const sgd& other)
   : BaseType(other),
     m_momentum(other.m_momentum),
     m_nesterov(other.m_nesterov),
+    m_weight_decay(other.m_weight_decay),
     m_velocity(other.m_velocity ? other.m_velocity->Copy() : nullptr)
 {}
 
@@ -55,6 +85,7 @@ sgd<TensorDataType>::operator=(const sgd<TensorDataType>& other)
   OptimizerType::operator=(other);
   m_momentum = other.m_momentum;
   m_nesterov = other.m_nesterov;
+  m_weight_decay = other.m_weight_decay;
   m_velocity.reset(other.m_velocity ? other.m_velocity->Copy() : nullptr);
   return *this;
 }
@@ -65,6 +96,9 @@ description sgd<TensorDataType>::get_description() const
   auto desc = OptimizerType::get_description();
   desc.add("Momentum", m_momentum);
   desc.add("Nesterov acceleration", m_nesterov);
+  if (m_weight_decay != El::To<TensorDataType>(0)) {
+    desc.add("Weight decay", m_weight_decay);
+  }
   return desc;
 }
 
@@ -117,13 +151,20 @@ void sgd<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
   opt->set_learn_rate(this->get_learning_rate());
   opt->set_momentum(m_momentum);
   opt->set_nesterov(m_nesterov);
+  opt->set_weight_decay(m_weight_decay);
 }
 
 template <typename TensorDataType>
 void sgd<TensorDataType>::step_compute(AbsDistMatrixType& values,
                                        const AbsDistMatrixType& gradient)
 {
-  if (m_momentum == TensorDataType(0.)) {
+  // A scaled GPU step needs a kernel that reads the step scale, and
+  // weight decay is applied in the update kernel. With zero momentum,
+  // the momentum kernel is plain SGD.
+  const bool gated_gpu_step = this->get_step_scale() != nullptr &&
+                              values.GetLocalDevice() == El::Device::GPU;
+  if (m_momentum == TensorDataType(0.) && !gated_gpu_step &&
+      m_weight_decay == TensorDataType(0.)) {
     // Vanilla SGD
     El::Axpy(-this->get_learning_rate(), gradient, values);
   }
@@ -147,65 +188,49 @@ void sgd<TensorDataType>::step_compute(AbsDistMatrixType& values,
   }
 }
 
+template <typename TensorDataType>
+std::string sgd<TensorDataType>::get_multi_tensor_hyperparameters() const
+{
+  std::ostringstream ss;
+  ss << std::hexfloat << El::To<double>(m_momentum) << ' ' << m_nesterov
+     << ' ' << El::To<double>(m_weight_decay);
+  return ss.str();
+}
+
+template <typename TensorDataType>
+bool sgd<TensorDataType>::get_multi_tensor_entry(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  multi_tensor_entry<TensorDataType>& entry)
+{
+  // Vanilla SGD also goes through the velocity, which it overwrites
+  // with the gradient
+  if (!values.Contiguous() || !gradient.Contiguous() ||
+      !m_velocity->Contiguous()) {
+    return false;
+  }
+  entry = {values.Buffer(),
+           gradient.LockedBuffer(),
+           m_velocity->Buffer(),
+           nullptr,
+           static_cast<size_t>(values.LocalHeight() * values.LocalWidth())};
+  return true;
+}
+
 template <typename TensorDataType>
 void sgd<TensorDataType>::momentum_step_cpu(AbsDistMatrixType& values,
                                             const AbsDistMatrixType& gradient)
 {
   LBANN_CALIPER_MARK_SCOPE("sgd::momentum_step");
-  // Get local matrix data
   const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
-  const size_t local_height = values.LocalHeight();
-  const size_t local_width = values.LocalWidth();
-  auto* __restrict__ values_buffer = values.Buffer();
-  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
-  auto* __restrict__ velocity_buffer = m_velocity->Buffer();
-
-  if (values.Contiguous() && gradient.Contiguous() &&
-      m_velocity->Contiguous()) {
-    const size_t local_size = local_height * local_width;
-    if (m_nesterov) {
-
-      // Nesterov SGD for contiguous data
-      LBANN_OMP_PARALLEL_FOR
-      for (size_t i = 0; i < local_size; ++i) {
-        auto& x = values_buffer[i];
-        const auto& g = gradient_buffer[i];
-        auto& v = velocity_buffer[i];
-        v = m_momentum * v + g;
-        x -= learning_rate * (m_momentum * v + g);
-      }
-    }
-    else {
-
-      // Momentum SGD with contiguous data
-      LBANN_OMP_PARALLEL_FOR
-      for (size_t i = 0; i < local_size; ++i) {
-        auto& x = values_buffer[i];
-        const auto& g = gradient_buffer[i];
-        auto& v = velocity_buffer[i];
-        v = m_momentum * v + g;
-        x -= learning_rate * v;
-      }
-    }
-  }
-  else {
-
-    // Momentum or Nesterov SGD with non-contiguous data
-    const size_t values_ldim = values.LDim();
-    const size_t gradient_ldim = gradient.LDim();
-    const size_t velocity_ldim = m_velocity->LDim();
-    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
-    for (size_t col = 0; col < local_width; ++col) {
-      for (size_t row = 0; row < local_height; ++row) {
-        const auto& g = gradient_buffer[row + col * gradient_ldim];
-        auto& v = velocity_buffer[row + col * velocity_ldim];
-        auto& x = values_buffer[row + col * values_ldim];
-        v = m_momentum * v + g;
-        x -= (m_nesterov ? learning_rate * (m_momentum * v + g)
-                         : learning_rate * v);
-      }
-    }
-  }
+  const bool has_momentum = m_momentum != TensorDataType(0.);
+  fused_update::apply_cpu(
+    values,
+    gradient,
+    has_momentum ? m_velocity.get() : nullptr,
+    nullptr,
+    learning_rate * m_weight_decay,
+    sgd_update<TensorDataType>{learning_rate, m_momentum, m_nesterov});
 }
 
 template <typename TensorDataType>
@@ -216,7 +241,8 @@ build_sgd_optimizer_from_pbuf(google::protobuf::Message const& msg)
   return std::make_unique<sgd<TensorDataType>>(
     TensorDataType(params.learn_rate()),
     TensorDataType(params.momentum()),
-    params.nesterov());
+    params.nesterov(),
+    TensorDataType(params.weight_decay()));
 }
 
 #define PROTO(T)                                                               \
@@ -27,150 +27,67 @@
 #include "lbann/optimizers/sgd.hpp"
 #include "lbann/utils/profiling.hpp"
 
+#include "fused_update.cuh"
+
 namespace lbann {
 
 namespace {
 
+/** @brief Momentum or Nesterov SGD; vanilla SGD without velocity */
 template <typename TensorDataType>
-__global__ void
-momentum_noncontiguous_kernel(size_t height,
-                              size_t width,
-                              TensorDataType learning_rate,
-                              TensorDataType momentum,
-                              TensorDataType* __restrict__ values,
-                              size_t values_ldim,
-                              const TensorDataType* __restrict__ gradient,
-                              size_t gradient_ldim,
-                              TensorDataType* __restrict__ velocity,
-                              size_t velocity_ldim)
+struct sgd_update
 {
-  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
-  if (gid < height * width) {
-    const auto& row = gid % height;
-    const auto& col = gid / height;
-    const auto& g = gradient[row + col * gradient_ldim];
-    auto& v = velocity[row + col * velocity_ldim];
-    auto& x = values[row + col * values_ldim];
+  TensorDataType learning_rate;
+  TensorDataType momentum;
+  bool nesterov;
+  __device__ bool operator()(TensorDataType& x,
+                             TensorDataType g,
+                             TensorDataType& v,
+                             TensorDataType&) const
+  {
     v = momentum * v + g;
-    x -= learning_rate * v;
+    x -= nesterov ? learning_rate * (momentum * v + g) : learning_rate * v;
+    return true;
   }
-}
+};
 
-template <typename TensorDataType>
-__global__ void
-momentum_contiguous_kernel(size_t size,
-                           TensorDataType learning_rate,
-                           TensorDataType momentum,
-                           TensorDataType* __restrict__ values,
-                           const TensorDataType* __restrict__ gradient,
-                           TensorDataType* __restrict__ velocity)
-{
-  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
-  if (gid < size) {
-    const auto& g = gradient[gid];
-    auto& v = velocity[gid];
-    auto& x = values[gid];
-    v = momentum * v + g;
-    x -= learning_rate * v;
-  }
-}
+} // namespace
 
 template <typename TensorDataType>
-__global__ void nesterov_kernel(size_t height,
-                                size_t width,
-                                TensorDataType learning_rate,
-                                TensorDataType momentum,
-                                TensorDataType* __restrict__ values,
-                                size_t values_ldim,
-                                const TensorDataType* __restrict__ gradient,
-                                size_t gradient_ldim,
-                                TensorDataType* __restrict__ velocity,
-                                size_t velocity_ldim)
+void sgd<TensorDataType>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
 {
-  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
-  const size_t nthreads = gridDim.x * blockDim.x;
-  for (size_t pos = gid; pos < height * width; pos += nthreads) {
-    const auto& row = pos % height;
-    const auto& col = pos / height;
-    const auto& g = gradient[row + col * gradient_ldim];
-    auto& v = velocity[row + col * velocity_ldim];
-    auto& x = values[row + col * values_ldim];
-    v = momentum * v + g;
-    x -= learning_rate * (momentum * v + g);
-  }
+  LBANN_CALIPER_MARK_SCOPE("sgd::multi_tensor_step");
+  const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
+  const auto weight_decay = El::To<TensorDataType>(
+    this->get_learning_rate() * El::To<float>(m_weight_decay));
+  fused_update::apply_multi_tensor(
+    entries,
+    weight_decay,
+    sgd_update<TensorDataType>{learning_rate, m_momentum, m_nesterov},
+    this->get_step_scale(),
+    this->m_multi_tensor_workspace,
+    sync_info);
 }
 
-} // namespace
-
 template <typename TensorDataType>
 void sgd<TensorDataType>::momentum_step_gpu(AbsDistMatrixType& values,
                                             const AbsDistMatrixType& gradient)
 {
-
   LBANN_CALIPER_MARK_SCOPE("sgd::momentum_step");
-  // Get matrix dimensions
-  const size_t local_height = values.LocalHeight();
-  const size_t local_width = values.LocalWidth();
-  const size_t local_size = local_height * local_width;
-  if (local_size <= 0) {
-    return;
-  }
-
-  // Launch GPU kernels for momentum SGD or NAG
-  constexpr size_t block_size = 256;
-  const size_t grid_size = (local_size + block_size - 1) / block_size;
-  auto multisync =
-    El::MakeMultiSync(gpu::get_sync_info(values), gpu::get_sync_info(gradient));
-  if (m_nesterov) {
-    hydrogen::gpu::LaunchKernel(nesterov_kernel<TensorDataType>,
-                                grid_size,
-                                block_size,
-                                0,
-                                multisync,
-                                local_height,
-                                local_width,
-                                this->get_learning_rate(),
-                                m_momentum,
-                                values.Buffer(),
-                                values.LDim(),
-                                gradient.LockedBuffer(),
-                                gradient.LDim(),
-                                m_velocity->Buffer(),
-                                m_velocity->LDim());
-  }
-  else {
-    if (values.Contiguous() && gradient.Contiguous() &&
-        m_velocity->Contiguous()) {
-      hydrogen::gpu::LaunchKernel(momentum_contiguous_kernel<TensorDataType>,
-                                  grid_size,
-                                  block_size,
-                                  0,
-                                  multisync,
-                                  local_size,
-                                  this->get_learning_rate(),
-                                  m_momentum,
-                                  values.Buffer(),
-                                  gradient.LockedBuffer(),
-                                  m_velocity->Buffer());
-    }
-    else {
-      hydrogen::gpu::LaunchKernel(momentum_noncontiguous_kernel<TensorDataType>,
-                                  grid_size,
-                                  block_size,
-                                  0,
-                                  multisync,
-                                  local_height,
-                                  local_width,
-                                  this->get_learning_rate(),
-                                  m_momentum,
-                                  values.Buffer(),
-                                  values.LDim(),
-                                  gradient.LockedBuffer(),
-                                  gradient.LDim(),
-                                  m_velocity->Buffer(),
-                                  m_velocity->LDim());
-    }
-  }
+  const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
+  const auto weight_decay = El::To<TensorDataType>(
+    this->get_learning_rate() * El::To<float>(m_weight_decay));
+  const bool has_momentum = El::To<float>(m_momentum) != 0.f;
+  fused_update::apply_gpu(
+    values,
+    gradient,
+    has_momentum ? m_velocity.get() : nullptr,
+    nullptr,
+    weight_decay,
+    sgd_update<TensorDataType>{learning_rate, m_momentum, m_nesterov},
+    this->get_step_scale());
 }
 
 #ifdef LBANN_HAS_HALF
@@ -180,11 +97,22 @@ void sgd<cpu_fp16>::momentum_step_gpu(AbsDistMatrixType&,
 {
   LBANN_ERROR("Can't call this function with cpu_fp16!");
 }
+
+template <>
+void sgd<cpu_fp16>::multi_tensor_step_compute(
+  std::vector<multi_tensor_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
 #endif // LBANN_HAS_HALF
 
 #define PROTO(T)                                                               \
   template void sgd<T>::momentum_step_gpu(El::AbstractDistMatrix<T>&,          \
-                                          const El::AbstractDistMatrix<T>&)
+                                          const El::AbstractDistMatrix<T>&);   \
+  template void sgd<T>::multi_tensor_step_compute(                             \
+    std::vector<multi_tensor_entry<T>> const&,                                 \
+    El::SyncInfo<El::Device::GPU> const&)
 
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
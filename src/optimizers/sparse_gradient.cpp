@@ -0,0 +1,319 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/sparse_gradient.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/optimizers/optimizer.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+namespace sparse_gradient {
+
+bool is_supported(model const& m, optimizer const& opt)
+{
+  if (!opt.supports_sparse_gradient() || opt.is_sharded()) {
+    return false;
+  }
+  if (m.is_amp_enabled() && m.is_amp_loss_scaling_enabled()) {
+    return false;
+  }
+  return m.get_gradient_clipping() <= DataType(0);
+}
+
+void coalesce(std::vector<El::Int> const& cols,
+              std::vector<El::Int>& unique_cols,
+              std::vector<El::Int>& positions)
+{
+  unique_cols.clear();
+  unique_cols.reserve(cols.size());
+  for (auto const& col : cols) {
+    if (col >= 0) {
+      unique_cols.push_back(col);
+    }
+  }
+  std::sort(unique_cols.begin(), unique_cols.end());
+  unique_cols.erase(std::unique(unique_cols.begin(), unique_cols.end()),
+                    unique_cols.end());
+  positions.resize(cols.size());
+  for (size_t j = 0; j < cols.size(); ++j) {
+    if (cols[j] < 0) {
+      positions[j] = -1;
+      continue;
+    }
+    auto const it =
+      std::lower_bound(unique_cols.begin(), unique_cols.end(), cols[j]);
+    positions[j] = std::distance(unique_cols.begin(), it);
+  }
+}
+
+namespace {
+
+template <typename TensorDataType>
+void gather_columns_cpu(El::Matrix<TensorDataType, El::Device::CPU> const& src,
+                        std::vector<El::Int> const& cols,
+                        El::Matrix<TensorDataType, El::Device::CPU>& dst)
+{
+  const El::Int height = src.Height();
+  const El::Int num_cols = cols.size();
+  dst.Resize(height, num_cols);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int j = 0; j < num_cols; ++j) {
+    std::copy_n(src.LockedBuffer(0, cols[j]), height, dst.Buffer(0, j));
+  }
+}
+
+template <typename TensorDataType>
+void scatter_columns_cpu(
+  El::Matrix<TensorDataType, El::Device::CPU> const& src,
+  std::vector<El::Int> const& cols,
+  El::Matrix<TensorDataType, El::Device::CPU>& dst)
+{
+  const El::Int height = src.Height();
+  const El::Int num_cols = cols.size();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int j = 0; j < num_cols; ++j) {
+    std::copy_n(src.LockedBuffer(0, j), height, dst.Buffer(0, cols[j]));
+  }
+}
+
+template <typename TensorDataType>
+void scatter_add_columns_cpu(
+  El::Matrix<TensorDataType, El::Device::CPU> const& src,
+  std::vector<El::Int> const& positions,
+  El::Matrix<TensorDataType, El::Device::CPU>& dst)
+{
+  // Serial over columns since positions may repeat
+  const El::Int height = src.Height();
+  const El::Int num_cols = positions.size();
+  for (El::Int j = 0; j < num_cols; ++j) {
+    const auto& pos = positions[j];
+    if (pos < 0) {
+      continue;
+    }
+    const auto* __restrict__ x = src.LockedBuffer(0, j);
+    auto* __restrict__ y = dst.Buffer(0, pos);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int i = 0; i < height; ++i) {
+      y[i] += x[i];
+    }
+  }
+}
+
+template <typename TensorDataType, El::Device D>
+void allgather_columns_impl(lbann_comm const& comm,
+                            El::mpi::Comm const& c,
+                            std::vector<El::Int> const& local_cols,
+                            El::Matrix<TensorDataType, D> const& local_values,
+                            std::vector<El::Int>& cols,
+                            El::Matrix<TensorDataType, D>& values)
+{
+  const int num_procs = El::mpi::Size(c);
+  const El::Int height = local_values.Height();
+
+  // Column counts from every rank
+  std::vector<El::Int> counts(num_procs);
+  comm.all_gather(static_cast<El::Int>(local_cols.size()), counts, c);
+  const El::Int max_count = *std::max_element(counts.begin(), counts.end());
+  if (max_count == 0) {
+    cols.clear();
+    values.Resize(height, 0);
+    return;
+  }
+
+  // Pad local contribution to the largest count
+  std::vector<El::Int> padded_cols(local_cols);
+  padded_cols.resize(max_count, -1);
+  El::Matrix<TensorDataType, D> padded_values;
+  padded_values.SetSyncInfo(El::SyncInfoFromMatrix(local_values));
+  El::Zeros(padded_values, height, max_count);
+  if (!local_cols.empty()) {
+    auto padded_view = padded_values(El::ALL, El::IR(0, local_cols.size()));
+    El::Copy(local_values, padded_view);
+  }
+
+  // Exchange indices on host and values on the values' device
+  cols.resize(max_count * num_procs);
+  comm.all_gather(padded_cols.data(),
+                  max_count,
+                  cols.data(),
+                  max_count,
+                  c);
+  values.Resize(height, max_count * num_procs);
+  comm.all_gather(padded_values.LockedBuffer(),
+                  height * max_count,
+                  values.Buffer(),
+                  height * max_count,
+                  c,
+                  El::SyncInfoFromMatrix(values));
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void gather_columns(El::AbstractMatrix<TensorDataType> const& src,
+                    std::vector<El::Int> const& cols,
+                    El::AbstractMatrix<TensorDataType>& dst)
+{
+  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  switch (src.GetDevice()) {
+  case El::Device::CPU:
+    gather_columns_cpu(static_cast<CPUMatType const&>(src),
+                       cols,
+                       static_cast<CPUMatType&>(dst));
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+    gather_columns_gpu(static_cast<GPUMatType const&>(src),
+                       cols,
+                       static_cast<GPUMatType&>(dst));
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+}
+
+template <typename TensorDataType>
+void scatter_columns(El::AbstractMatrix<TensorDataType> const& src,
+                     std::vector<El::Int> const& cols,
+                     El::AbstractMatrix<TensorDataType>& dst)
+{
+  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  switch (src.GetDevice()) {
+  case El::Device::CPU:
+    scatter_columns_cpu(static_cast<CPUMatType const&>(src),
+                        cols,
+                        static_cast<CPUMatType&>(dst));
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+    scatter_columns_gpu(static_cast<GPUMatType const&>(src),
+                        cols,
+                        static_cast<GPUMatType&>(dst));
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+}
+
+template <typename TensorDataType>
+void scatter_add_columns(El::AbstractMatrix<TensorDataType> const& src,
+                         std::vector<El::Int> const& positions,
+                         El::AbstractMatrix<TensorDataType>& dst)
+{
+  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  switch (src.GetDevice()) {
+  case El::Device::CPU:
+    scatter_add_columns_cpu(static_cast<CPUMatType const&>(src),
+                            positions,
+                            static_cast<CPUMatType&>(dst));
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+    scatter_add_columns_gpu(static_cast<GPUMatType const&>(src),
+                            positions,
+                            static_cast<GPUMatType&>(dst));
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+}
+
+template <typename TensorDataType>
+void allgather_columns(lbann_comm const& comm,
+                       El::mpi::Comm const& c,
+                       std::vector<El::Int> const& local_cols,
+                       El::AbstractMatrix<TensorDataType> const& local_values,
+                       std::vector<El::Int>& cols,
+                       El::AbstractMatrix<TensorDataType>& values)
+{
+  if (El::mpi::Size(c) == 1) {
+    cols = local_cols;
+    El::Copy(local_values, values);
+    return;
+  }
+  using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  switch (local_values.GetDevice()) {
+  case El::Device::CPU:
+    allgather_columns_impl(comm,
+                           c,
+                           local_cols,
+                           static_cast<CPUMatType const&>(local_values),
+                           cols,
+                           static_cast<CPUMatType&>(values));
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+    allgather_columns_impl(comm,
+                           c,
+                           local_cols,
+                           static_cast<GPUMatType const&>(local_values),
+                           cols,
+                           static_cast<GPUMatType&>(values));
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+}
+
+#define PROTO(T)                                                               \
+  template void gather_columns<T>(El::AbstractMatrix<T> const&,                \
+                                  std::vector<El::Int> const&,                 \
+                                  El::AbstractMatrix<T>&);                     \
+  template void scatter_columns<T>(El::AbstractMatrix<T> const&,               \
+                                   std::vector<El::Int> const&,                \
+                                   El::AbstractMatrix<T>&);                    \
+  template void scatter_add_columns<T>(El::AbstractMatrix<T> const&,           \
+                                       std::vector<El::Int> const&,            \
+                                       El::AbstractMatrix<T>&);                \
+  template void allgather_columns<T>(lbann_comm const&,                        \
+                                     El::mpi::Comm const&,                     \
+                                     std::vector<El::Int> const&,              \
+                                     El::AbstractMatrix<T> const&,             \
+                                     std::vector<El::Int>&,                    \
+                                     El::AbstractMatrix<T>&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace sparse_gradient
+} // namespace lbann
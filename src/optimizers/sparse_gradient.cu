@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/sparse_gradient.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace sparse_gradient {
+
+namespace {
+
+/** Copy column cols[j] of src into column j of dst. */
+template <typename TensorDataType>
+__global__ void
+gather_columns_kernel(size_t height,
+                      size_t num_cols,
+                      TensorDataType const* __restrict__ src,
+                      size_t src_ldim,
+                      El::Int const* __restrict__ cols,
+                      TensorDataType* __restrict__ dst,
+                      size_t dst_ldim)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t pos = gid; pos < height * num_cols; pos += nthreads) {
+    const auto i = pos % height;
+    const auto j = pos / height;
+    dst[i + j * dst_ldim] = src[i + cols[j] * src_ldim];
+  }
+}
+
+/** Copy column j of src into column cols[j] of dst. */
+template <typename TensorDataType>
+__global__ void
+scatter_columns_kernel(size_t height,
+                       size_t num_cols,
+                       TensorDataType const* __restrict__ src,
+                       size_t src_ldim,
+                       El::Int const* __restrict__ cols,
+                       TensorDataType* __restrict__ dst,
+                       size_t dst_ldim)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t pos = gid; pos < height * num_cols; pos += nthreads) {
+    const auto i = pos % height;
+    const auto j = pos / height;
+    dst[i + cols[j] * dst_ldim] = src[i + j * src_ldim];
+  }
+}
+
+/** Add column j of src to column positions[j] of dst. */
+template <typename TensorDataType>
+__global__ void
+scatter_add_columns_kernel(size_t height,
+                           size_t num_cols,
+                           TensorDataType const* __restrict__ src,
+                           size_t src_ldim,
+                           El::Int const* __restrict__ positions,
+                           TensorDataType* __restrict__ dst,
+                           size_t dst_ldim)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t pos = gid; pos < height * num_cols; pos += nthreads) {
+    const auto i = pos % height;
+    const auto j = pos / height;
+    const auto& col = positions[j];
+    if (col >= 0) {
+      gpu_lib::atomic_add(&dst[i + col * dst_ldim], src[i + j * src_ldim]);
+    }
+  }
+}
+
+/** Launch a column kernel with indices copied to the device. */
+template <typename TensorDataType, typename Kernel>
+void launch_column_kernel(
+  Kernel kernel,
+  El::Matrix<TensorDataType, El::Device::GPU> const& src,
+  std::vector<El::Int> const& cols,
+  El::Matrix<TensorDataType, El::Device::GPU>& dst)
+{
+  const size_t height = src.Height();
+  const size_t num_cols = cols.size();
+  if (height == 0 || num_cols == 0) {
+    return;
+  }
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(dst), gpu::get_sync_info(src));
+  El::SyncInfo<El::Device::GPU> const& sync_info = multisync;
+  hydrogen::simple_buffer<El::Int, El::Device::GPU> device_cols(num_cols,
+                                                                sync_info);
+  hydrogen::gpu::Copy1DToDevice(cols.data(),
+                                device_cols.data(),
+                                num_cols,
+                                sync_info);
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (height * num_cols + block_size - 1) / block_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(kernel,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              height,
+                              num_cols,
+                              src.LockedBuffer(),
+                              size_t(src.LDim()),
+                              device_cols.data(),
+                              dst.Buffer(),
+                              size_t(dst.LDim()));
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void gather_columns_gpu(
+  El::Matrix<TensorDataType, El::Device::GPU> const& src,
+  std::vector<El::Int> const& cols,
+  El::Matrix<TensorDataType, El::Device::GPU>& dst)
+{
+  dst.Resize(src.Height(), cols.size());
+  launch_column_kernel(gather_columns_kernel<TensorDataType>, src, cols, dst);
+}
+
+template <typename TensorDataType>
+void scatter_columns_gpu(
+  El::Matrix<TensorDataType, El::Device::GPU> const& src,
+  std::vector<El::Int> const& cols,
+  El::Matrix<TensorDataType, El::Device::GPU>& dst)
+{
+  launch_column_kernel(scatter_columns_kernel<TensorDataType>, src, cols, dst);
+}
+
+template <typename TensorDataType>
+void scatter_add_columns_gpu(
+  El::Matrix<TensorDataType, El::Device::GPU> const& src,
+  std::vector<El::Int> const& positions,
+  El::Matrix<TensorDataType, El::Device::GPU>& dst)
+{
+  launch_column_kernel(scatter_add_columns_kernel<TensorDataType>,
+                       src,
+                       positions,
+                       dst);
+}
+
+#define PROTO(T)                                                               \
+  template void gather_columns_gpu<T>(                                         \
+    El::Matrix<T, El::Device::GPU> const&,                                     \
+    std::vector<El::Int> const&,                                               \
+    El::Matrix<T, El::Device::GPU>&);                                          \
+  template void scatter_columns_gpu<T>(                                        \
+    El::Matrix<T, El::Device::GPU> const&,                                     \
+    std::vector<El::Int> const&,                                               \
+    El::Matrix<T, El::Device::GPU>&);                                          \
+  template void scatter_add_columns_gpu<T>(                                    \
+    El::Matrix<T, El::Device::GPU> const&,                                     \
+    std::vector<El::Int> const&,                                               \
+    El::Matrix<T, El::Device::GPU>&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+#ifdef LBANN_HAS_HALF
+#define CPU_FP16_ERROR(fn)                                                     \
+  template <>                                                                  \
+  void fn<cpu_fp16>(El::Matrix<cpu_fp16, El::Device::GPU> const&,              \
+                    std::vector<El::Int> const&,                               \
+                    El::Matrix<cpu_fp16, El::Device::GPU>&)                    \
+  {                                                                            \
+    LBANN_ERROR("Can't call this function with cpu_fp16!");                  \
+  }
+CPU_FP16_ERROR(gather_columns_gpu)
+CPU_FP16_ERROR(scatter_columns_gpu)
+CPU_FP16_ERROR(scatter_add_columns_gpu)
+#undef CPU_FP16_ERROR
+#endif // LBANN_HAS_HALF
+
+} // namespace sparse_gradient
+} // namespace lbann
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+namespace {
+
+using DataType = float;
+using AbsDistMatType = El::AbstractDistMatrix<DataType>;
+
+constexpr El::Int height = 5, width = 3;
+
+/** Gradient of one sample's objective. */
+DataType sample_gradient(El::Int sample, El::Int i, El::Int j)
+{
+  return DataType((sample + 1) * ((i + 2 * j) % 5) - 3) / 8.f;
+}
+
+auto make_weights(lbann::lbann_comm& comm)
+{
+  auto w = std::make_unique<lbann::data_type_weights<DataType>>(comm);
+  w->set_dims({height}, {width});
+  w->set_optimizer(std::make_unique<lbann::sgd<DataType>>(1.f, 0.f, false));
+  w->setup();
+  return w;
+}
+
+/** Mean gradient over samples [first, first + count), like the
+ *  gradient of an objective averaged over a (micro-)batch. */
+std::unique_ptr<AbsDistMatType> make_batch_gradient(
+  lbann::data_type_weights<DataType>& w,
+  El::Int first,
+  El::Int count)
+{
+  std::unique_ptr<AbsDistMatType> grad(w.get_values_sharded().Copy());
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      DataType sum = 0.f;
+      for (El::Int s = first; s < first + count; ++s) {
+        sum += sample_gradient(s, i, j);
+      }
+      grad->Set(i, j, sum / DataType(count));
+    }
+  }
+  return grad;
+}
+
+/** Accumulate micro-batches as SGD training does: each is scaled by
+ *  the number scheduled and only the last one may sync. */
+void accumulate(lbann::data_type_optimizer<DataType>& opt,
+                lbann::data_type_weights<DataType>& w,
+                El::Int micro_batch_size,
+                size_t num_scheduled,
+                size_t num_run)
+{
+  opt.clear_gradient();
+  for (size_t b = 0; b < num_run; ++b) {
+    opt.set_gradient_sync_deferred(b + 1 < num_scheduled);
+    auto grad =
+      make_batch_gradient(w, El::Int(b) * micro_batch_size, micro_batch_size);
+    opt.add_to_gradient(*grad, DataType(1) / DataType(num_scheduled), true);
+  }
+  opt.set_gradient_sync_deferred(false);
+  if (num_run < num_scheduled) {
+    opt.scale_gradient(lbann::EvalType(num_scheduled) /
+                       lbann::EvalType(num_run));
+  }
+}
+
+void check_equal(AbsDistMatType const& a, AbsDistMatType const& b)
+{
+  auto const& a_local = a.LockedMatrix();
+  auto const& b_local = b.LockedMatrix();
+  REQUIRE(a_local.Height() == b_local.Height());
+  REQUIRE(a_local.Width() == b_local.Width());
+  for (El::Int j = 0; j < a_local.Width(); ++j) {
+    for (El::Int i = 0; i < a_local.Height(); ++i) {
+      CHECK(a_local(i, j) == Approx(b_local(i, j)));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Gradient accumulation over micro-batches",
+          "[mpi][optimizer][accumulation]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  constexpr El::Int micro_batch_size = 4;
+  constexpr El::Int num_micro_batches = 3;
+
+  auto full = make_weights(comm);
+  auto accumulated = make_weights(comm);
+  auto& full_opt = *full->get_optimizer();
+  auto& accumulated_opt = *accumulated->get_optimizer();
+
+  SECTION("Every micro-batch run matches one full mini-batch")
+  {
+    full_opt.clear_gradient();
+    const El::Int num_samples = micro_batch_size * num_micro_batches;
+    auto grad = make_batch_gradient(*full, 0, num_samples);
+    full_opt.add_to_gradient(*grad, DataType(1), true);
+
+    accumulate(accumulated_opt,
+               *accumulated,
+               micro_batch_size,
+               num_micro_batches,
+               num_micro_batches);
+    check_equal(accumulated_opt.get_gradient_sharded(),
+                full_opt.get_gradient_sharded());
+  }
+
+  SECTION("A step cut short averages over the micro-batches run")
+  {
+    constexpr El::Int num_run = 2;
+    full_opt.clear_gradient();
+    const El::Int num_samples = micro_batch_size * num_run;
+    auto grad = make_batch_gradient(*full, 0, num_samples);
+    full_opt.add_to_gradient(*grad, DataType(1), true);
+
+    accumulate(accumulated_opt,
+               *accumulated,
+               micro_batch_size,
+               num_micro_batches,
+               num_run);
+    check_equal(accumulated_opt.get_gradient_sharded(),
+                full_opt.get_gradient_sharded());
+  }
+}
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::run_training_step;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+// Two weights tensors trained with plain SGD through a dummy layer,
+// so each gradient is the error signal
+const std::string model_prototext = R"""(
+model {
+  layer {
+    name: "a"
+    children: "cat"
+    weights: "wa"
+    weights_layer {
+      dims: 2
+    }
+  }
+  layer {
+    name: "b"
+    children: "cat"
+    weights: "wb"
+    weights_layer {
+      dims: 2
+    }
+  }
+  layer {
+    name: "cat"
+    parents: "a b"
+    children: "out"
+    concatenation {
+      axis: 0
+    }
+  }
+  layer {
+    name: "out"
+    parents: "cat"
+    dummy {
+    }
+  }
+  weights {
+    name: "wa"
+    initializer {
+      value_initializer {
+        values: 1.0
+        values: 2.0
+      }
+    }
+  }
+  weights {
+    name: "wb"
+    initializer {
+      value_initializer {
+        values: -1.0
+        values: 0.5
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 1.0
+  }
+}
+)""";
+
+const std::vector<float> initial_values = {1.f, 2.f, -1.f, 0.5f};
+
+// Global norm of 5, split over both weights tensors
+const std::vector<float> gradient = {3.f, 0.f, 0.f, 4.f};
+
+/** Values of both weights tensors after one step */
+std::vector<float> train_step(float max_norm, bool multi_tensor)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif
+  auto m = construct_model(model_prototext);
+  m->set_gradient_clipping(max_norm);
+  m->set_multi_tensor_optimizer_step(multi_tensor);
+  setup_model(*m);
+  CHECK(m->get_gradient_clipping() == max_norm);
+  set_error_signal<Dev>(find_layer(*m, "out"), gradient);
+  run_training_step(*m);
+
+  std::vector<float> values;
+  for (auto const* name : {"wa", "wb"}) {
+    for (auto* w : m->get_weights()) {
+      if (w->get_name() != name) {
+        continue;
+      }
+      auto& dtw = dynamic_cast<lbann::data_type_weights<float>&>(*w);
+      auto const w_values = to_vector(dtw.get_values());
+      values.insert(values.end(), w_values.begin(), w_values.end());
+    }
+  }
+  return values;
+}
+
+/** Check one SGD step with the gradient scaled by @c scale */
+void check_step(std::vector<float> const& values, float scale)
+{
+  REQUIRE(values.size() == initial_values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    CHECK(values[i] == Approx(initial_values[i] - scale * gradient[i]));
+  }
+}
+
+} // namespace
+
+TEST_CASE("Global gradient norm clipping in the optimizer step",
+          "[mpi][optimizer][clipping]")
+{
+  const bool multi_tensor = GENERATE(false, true);
+  INFO("Multi-tensor step = " << multi_tensor);
+  SECTION("Gradients above the limit are scaled by one global factor")
+  {
+    check_step(train_step(1.f, multi_tensor), 0.2f);
+  }
+  SECTION("Gradients within the limit are unchanged")
+  {
+    check_step(train_step(10.f, multi_tensor), 1.f);
+  }
+  SECTION("A zero limit disables clipping")
+  {
+    check_step(train_step(0.f, multi_tensor), 1.f);
+  }
+}
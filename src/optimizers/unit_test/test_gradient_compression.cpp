@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+#include <lbann/optimizers/gradient_compression.hpp>
+
+namespace {
+
+using MatType = El::Matrix<float, El::Device::CPU>;
+
+/** Rank p holds (p+1) u v^T, so the sum over ranks has rank one. */
+MatType make_gradient(El::Int height, El::Int width, int rank)
+{
+  MatType grad(height, width);
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      grad(i, j) = float(rank + 1) * float(i + 1) * float(1 + j % 3) / 64.f;
+    }
+  }
+  return grad;
+}
+
+void sync(lbann::gradient_compressor<float>& compressor,
+          lbann::lbann_comm& comm,
+          MatType& grad)
+{
+  compressor.start(comm, grad, comm.get_world_comm());
+  compressor.finish(comm, grad);
+}
+
+} // namespace
+
+TEST_CASE("Gradient compression", "[mpi][optimizer][compression]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const int rank = comm.get_rank_in_world();
+  const El::Int height = 32, width = 24;
+
+  // Full-precision reference sum
+  auto expected = make_gradient(height, width, rank);
+  comm.allreduce(expected, comm.get_world_comm());
+
+  lbann::gradient_compression_config config;
+
+  SECTION("No compression")
+  {
+    CHECK(lbann::make_gradient_compressor<float>(config, El::Device::CPU) ==
+          nullptr);
+  }
+
+  SECTION("Top-k keeping every entry is exact")
+  {
+    config.method = lbann::gradient_compression_method::topk;
+    config.topk_fraction = 1.;
+    auto compressor =
+      lbann::make_gradient_compressor<float>(config, El::Device::CPU);
+    auto grad = make_gradient(height, width, rank);
+    sync(*compressor, comm, grad);
+    for (El::Int j = 0; j < width; ++j) {
+      for (El::Int i = 0; i < height; ++i) {
+        CHECK(grad(i, j) == Approx(expected(i, j)));
+      }
+    }
+  }
+
+  SECTION("Top-k carries the dropped entries forward")
+  {
+    config.method = lbann::gradient_compression_method::topk;
+    config.topk_fraction = 0.1;
+    auto compressor =
+      lbann::make_gradient_compressor<float>(config, El::Device::CPU);
+    auto grad = make_gradient(height, width, rank);
+    sync(*compressor, comm, grad);
+    CHECK(compressor->get_compression_ratio() > 1.);
+
+    // Sending zeros flushes the remainder, so the steps together
+    // deliver the whole gradient.
+    MatType total(grad);
+    for (int step = 0; step < 20; ++step) {
+      El::Zeros(grad, height, width);
+      sync(*compressor, comm, grad);
+      El::Axpy(1.f, grad, total);
+    }
+    for (El::Int j = 0; j < width; ++j) {
+      for (El::Int i = 0; i < height; ++i) {
+        CHECK(total(i, j) == Approx(expected(i, j)).margin(1e-4));
+      }
+    }
+  }
+
+  SECTION("PowerSGD recovers a low-rank sum")
+  {
+    config.method = lbann::gradient_compression_method::powersgd;
+    config.powersgd_rank = 2;
+    auto compressor =
+      lbann::make_gradient_compressor<float>(config, El::Device::CPU);
+
+    // Each local gradient lies in the recovered subspace, so the
+    // carried residual stays zero and every step matches the sum.
+    for (int step = 0; step < 4; ++step) {
+      auto grad = make_gradient(height, width, rank);
+      sync(*compressor, comm, grad);
+      CHECK(compressor->get_compression_ratio() > 1.);
+      for (El::Int j = 0; j < width; ++j) {
+        for (El::Int i = 0; i < height; ++i) {
+          CHECK(grad(i, j) == Approx(expected(i, j)).epsilon(1e-3));
+        }
+      }
+    }
+  }
+
+#ifdef LBANN_HAS_HALF
+  SECTION("fp16 cast")
+  {
+    config.method = lbann::gradient_compression_method::fp16;
+    auto compressor =
+      lbann::make_gradient_compressor<float>(config, El::Device::CPU);
+    auto grad = make_gradient(height, width, rank);
+    sync(*compressor, comm, grad);
+    CHECK(compressor->get_compression_ratio() == Approx(2.));
+    for (El::Int j = 0; j < width; ++j) {
+      for (El::Int i = 0; i < height; ++i) {
+        CHECK(grad(i, j) == Approx(expected(i, j)).epsilon(1e-2));
+      }
+    }
+  }
+#endif // LBANN_HAS_HALF
+}
@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "ModelTestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using unit_test::utilities::construct_model;
+using unit_test::utilities::find_layer;
+using unit_test::utilities::run_training_step;
+using unit_test::utilities::set_error_signal;
+using unit_test::utilities::setup_model;
+using unit_test::utilities::to_vector;
+
+// Three weights tensors of different sizes, concatenated into a
+// dummy layer
+const std::string model_prototext = R"""(
+model {
+  layer {
+    name: "a"
+    children: "cat"
+    weights: "wa"
+    weights_layer {
+      dims: 3
+    }
+  }
+  layer {
+    name: "b"
+    children: "cat"
+    weights: "wb"
+    weights_layer {
+      dims: 4
+    }
+  }
+  layer {
+    name: "c"
+    children: "cat"
+    weights: "wc"
+    weights_layer {
+      dims: 5
+    }
+  }
+  layer {
+    name: "cat"
+    parents: "a b c"
+    children: "out"
+    concatenation {
+      axis: 0
+    }
+  }
+  layer {
+    name: "out"
+    parents: "cat"
+    dummy {
+    }
+  }
+  weights {
+    name: "wa"
+    initializer {
+      value_initializer {
+        values: -1.2
+        values: 3.4
+        values: 0.5
+      }
+    }
+  }
+  weights {
+    name: "wb"
+    initializer {
+      value_initializer {
+        values: 0.1
+        values: -0.7
+        values: 2.2
+        values: -3.3
+      }
+    }
+  }
+  weights {
+    name: "wc"
+    initializer {
+      value_initializer {
+        values: 1.5
+        values: -0.25
+        values: 0.75
+        values: -2.0
+        values: 0.3
+      }
+    }
+  }
+}
+)""";
+
+constexpr El::Int num_outputs = 12;
+
+/** Weights values after a few steps of the given optimizer */
+std::vector<std::vector<float>> train_steps(std::string const& optimizer,
+                                            bool multi_tensor)
+{
+#ifdef LBANN_HAS_GPU
+  constexpr auto Dev = El::Device::GPU;
+#else
+  constexpr auto Dev = El::Device::CPU;
+#endif
+  auto m = construct_model(model_prototext + optimizer);
+  m->set_multi_tensor_optimizer_step(multi_tensor);
+  setup_model(*m);
+  auto& out = find_layer(*m, "out");
+  for (int step = 0; step < 3; ++step) {
+    std::vector<float> error_signal;
+    for (El::Int i = 0; i < num_outputs; ++i) {
+      error_signal.push_back(0.1f * static_cast<float>((i + step) % 5) - 0.2f);
+    }
+    set_error_signal<Dev>(out, error_signal);
+    run_training_step(*m);
+  }
+
+  std::vector<std::vector<float>> values;
+  for (auto* w : m->get_weights()) {
+    auto& dtw = dynamic_cast<lbann::data_type_weights<float>&>(*w);
+    values.push_back(to_vector(dtw.get_values()));
+  }
+  return values;
+}
+
+void check_same_values(std::string const& optimizer)
+{
+  auto const expected = train_steps(optimizer, false);
+  auto const fused = train_steps(optimizer, true);
+  REQUIRE(fused.size() == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    REQUIRE(fused[i].size() == expected[i].size());
+    for (size_t j = 0; j < expected[i].size(); ++j) {
+      CHECK(fused[i][j] == Approx(expected[i][j]));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Multi-tensor optimizer steps match per-weights steps",
+          "[mpi][optimizer][multi_tensor]")
+{
+  SECTION("SGD with momentum")
+  {
+    check_same_values(R"""(
+optimizer {
+  sgd {
+    learn_rate: 0.1
+    momentum: 0.9
+    nesterov: true
+  }
+}
+)""");
+  }
+  SECTION("Adam")
+  {
+    check_same_values(R"""(
+optimizer {
+  adam {
+    learn_rate: 0.1
+    beta1: 0.9
+    beta2: 0.99
+    eps: 1e-8
+  }
+}
+)""");
+  }
+  SECTION("RMSprop")
+  {
+    check_same_values(R"""(
+optimizer {
+  rmsprop {
+    learn_rate: 0.1
+    decay_rate: 0.9
+    eps: 1e-8
+  }
+}
+)""");
+  }
+}
@@ -69,7 +69,8 @@ struct SGDBuilder
     return lbann::sgd<TensorDataType>(
       /*learning_rate=*/TensorDataType(2.f),
       /*momentum=*/TensorDataType(3.f),
-      /*nesterov=*/true);
+      /*nesterov=*/true,
+      /*weight_decay=*/TensorDataType(4.f));
   }
 
   static lbann::sgd<TensorDataType> Default()
@@ -77,7 +78,8 @@ struct SGDBuilder
     return lbann::sgd<TensorDataType>(
       /*learning_rate=*/TensorDataType(0.0f),
       /*momentum=*/TensorDataType(0.0f),
-      /*nesterov=*/false);
+      /*nesterov=*/false,
+      /*weight_decay=*/TensorDataType(0.0f));
   }
 }; // struct SGDBuilder
 
@@ -105,6 +107,7 @@ TEMPLATE_LIST_TEST_CASE("SGD Optimizer serialization",
   CHECK_FALSE(opt.get_learning_rate() == opt_restore.get_learning_rate());
   CHECK_FALSE(opt.get_momentum() == opt_restore.get_momentum());
   CHECK_FALSE(opt.using_nesterov() == opt_restore.using_nesterov());
+  CHECK_FALSE(opt.get_weight_decay() == opt_restore.get_weight_decay());
 
   {
     OutputArchiveType oarchive(ss);
@@ -120,4 +123,5 @@ TEMPLATE_LIST_TEST_CASE("SGD Optimizer serialization",
   CHECK(opt.get_learning_rate() == opt_restore.get_learning_rate());
   CHECK(opt.get_momentum() == opt_restore.get_momentum());
   CHECK(opt.using_nesterov() == opt_restore.using_nesterov());
+  CHECK(opt.get_weight_decay() == opt_restore.get_weight_decay());
 }
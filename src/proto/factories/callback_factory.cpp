@@ -26,6 +26,7 @@
 
 // Get the declarations of all the builders for registration
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/callbacks/calibrate_int8.hpp"
 #include "lbann/callbacks/check_dataset.hpp"
 #include "lbann/callbacks/check_gradients.hpp"
 #include "lbann/callbacks/check_init.hpp"
@@ -56,6 +57,7 @@
 #include "lbann/callbacks/load_model.hpp"
 #include "lbann/callbacks/ltfb.hpp"
 #include "lbann/callbacks/memory_profiler.hpp"
+#include "lbann/callbacks/memory_replica.hpp"
 #include "lbann/callbacks/mixup.hpp"
 #include "lbann/callbacks/monitor_io.hpp"
 #include "lbann/callbacks/perturb_adam.hpp"
@@ -71,12 +73,14 @@
 #include "lbann/callbacks/save_model.hpp"
 #include "lbann/callbacks/save_topk_models.hpp"
 #include "lbann/callbacks/set_weights_value.hpp"
+#include "lbann/callbacks/straggler_detection.hpp"
 #include "lbann/callbacks/summarize_images.hpp"
 #include "lbann/callbacks/summary.hpp"
 #include "lbann/callbacks/sync_layers.hpp"
 #include "lbann/callbacks/timeline.hpp"
 #include "lbann/callbacks/timer.hpp"
 #include "lbann/callbacks/variable_minibatch.hpp"
+#include "lbann/callbacks/watchdog.hpp"
 
 #include "lbann/proto/factories.hpp"
 #include "lbann/utils/factory.hpp"
@@ -113,6 +117,8 @@ void register_default_builders(factory_type& factory)
                            build_adaptive_learning_rate_callback_from_pbuf);
   factory.register_builder("CallbackAlternateUpdates",
                            build_alternate_updates_callback_from_pbuf);
+  factory.register_builder("CallbackCalibrateInt8",
+                           build_calibrate_int8_callback_from_pbuf);
   factory.register_builder("CallbackCheckDataset",
                            build_check_dataset_callback_from_pbuf);
   factory.register_builder("CallbackCheckGradients",
@@ -169,6 +175,8 @@ void register_default_builders(factory_type& factory)
   factory.register_builder("CallbackLTFB", build_ltfb_callback_from_pbuf);
   factory.register_builder("CallbackMemoryProfiler",
                            build_memory_profiler_callback_from_pbuf);
+  factory.register_builder("CallbackMemoryReplica",
+                           build_memory_replica_callback_from_pbuf);
   factory.register_builder("CallbackMinibatchSchedule",
                            build_minibatch_schedule_callback_from_pbuf);
   factory.register_builder("CallbackMixup", build_mixup_callback_from_pbuf);
@@ -209,6 +217,8 @@ void register_default_builders(factory_type& factory)
                            build_set_learning_rate_callback_from_pbuf);
   factory.register_builder("CallbackStepMinibatch",
                            build_step_minibatch_callback_from_pbuf);
+  factory.register_builder("CallbackStragglerDetection",
+                           build_straggler_detection_callback_from_pbuf);
   factory.register_builder("CallbackSummarizeImages",
                            build_summarize_images_callback_from_pbuf);
   factory.register_builder("CallbackSummary", build_summary_callback_from_pbuf);
@@ -219,6 +229,8 @@ void register_default_builders(factory_type& factory)
   factory.register_builder("CallbackTimer", build_timer_callback_from_pbuf);
   factory.register_builder("CallbackSetWeightsValue",
                            build_set_weights_value_callback_from_pbuf);
+  factory.register_builder("CallbackWatchdog",
+                           build_watchdog_callback_from_pbuf);
 }
 
 // Manage a global factory
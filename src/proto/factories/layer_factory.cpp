@@ -128,6 +128,8 @@ private:
 
     // Math layers
     LBANN_REGISTER_BUILDER(MatMul, matmul);
+    LBANN_REGISTER_BUILDER(ScaledDotProductAttention,
+                           scaled_dot_product_attention);
 
     // Transform layers
     LBANN_REGISTER_BUILDER(BatchwiseReduceSum, batchwise_reduce_sum);
@@ -198,6 +200,7 @@ private:
                            composite_image_transformation);
     LBANN_REGISTER_BUILDER(Rotation, rotation);
     LBANN_REGISTER_BUILDER(Cutout, cutout);
+    LBANN_REGISTER_BUILDER(ImageAugmentation, image_augmentation);
 
     // Miscellaneous layers
     LBANN_REGISTER_BUILDER(Argmax, argmax);
@@ -210,6 +210,7 @@ construct_layer_graph(lbann_comm* comm,
 #endif
       l->freeze();
     }
+    l->set_checkpoint(proto_layer.checkpoint());
     // Add layer to list
     layers.emplace_back(std::move(l));
   }
@@ -51,7 +51,8 @@ std::unique_ptr<metric> construct_metric(lbann_comm* comm,
     return std::make_unique<executable_metric>(comm,
                                                xm.name(),
                                                xm.filename(),
-                                               xm.other_args());
+                                               xm.other_args(),
+                                               xm.asynchronous());
   }
   else if (metric_type == "python_metric") {
     auto const& pym = proto_metric.python_metric();
@@ -59,7 +60,8 @@ std::unique_ptr<metric> construct_metric(lbann_comm* comm,
                                            pym.name(),
                                            pym.module(),
                                            pym.module_dir(),
-                                           pym.function());
+                                           pym.function(),
+                                           pym.asynchronous());
   }
   else {
     LBANN_ERROR("Unsupported metric type \"", metric_type, "\"");
@@ -36,6 +36,7 @@
 #include "lbann/proto/model.pb.h"
 #include "lbann/proto/objective_functions.pb.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -316,7 +317,33 @@ std::unique_ptr<model> construct_model(lbann_comm* comm,
     if (growth_interval == 0) {
       growth_interval = 2000;
     }
-    m->enable_amp(init_scale, growth_factor, backoff_factor, growth_interval);
+    m->enable_amp(init_scale,
+                  growth_factor,
+                  backoff_factor,
+                  growth_interval,
+                  !proto_amp.disable_loss_scaling());
+  }
+
+  const auto& proto_prefetch = proto_model.weights_prefetch();
+  if (proto_prefetch.lookahead() > 0) {
+    m->set_weights_prefetch(proto_prefetch.lookahead(),
+                            std::max(proto_prefetch.max_bytes(), int64_t{0}));
+  }
+
+  m->set_activation_memory_planning(proto_model.plan_activation_memory());
+  m->set_flat_weights(proto_model.flat_weights());
+  m->set_pipeline_parallelism(proto_model.pipeline_parallelism());
+  m->set_gpu_graph_capture(proto_model.capture_gpu_graphs());
+  if (proto_model.layer_streams() > 1) {
+    m->set_layer_streams(proto_model.layer_streams());
+  }
+  m->set_layer_fusion(proto_model.fuse_layers());
+  m->set_multi_tensor_optimizer_step(
+    proto_model.multi_tensor_optimizer_step());
+  m->set_gradient_clipping(proto_model.clip_gradient_norm());
+  if (proto_model.metric_accumulation_window() > 1) {
+    m->set_metric_accumulation_window(
+      proto_model.metric_accumulation_window());
   }
 
   return m;
@@ -47,7 +47,14 @@ construct_trainer(lbann_comm* comm, const lbann_data::Trainer& proto_trainer)
 #define TEMPLATE_INSTANTIATION(TensorDataType)                                 \
   do {                                                                         \
     if (proto_datatype == TypeToProtoDataType<TensorDataType>::value) {        \
-      dc = std::make_unique<buffered_data_coordinator<TensorDataType>>(comm);  \
+      auto bdc =                                                               \
+        std::make_unique<buffered_data_coordinator<TensorDataType>>(comm);     \
+      bdc->set_device_resident_data(                                           \
+        proto_trainer.data_coordinator().device_resident_data());              \
+      bdc->set_input_transfer_type(                                            \
+        proto_trainer.data_coordinator().input_transfer_type(),                \
+        proto_trainer.data_coordinator().input_transfer_scale());              \
+      dc = std::move(bdc);                                                     \
     }                                                                          \
   } while (0)
 
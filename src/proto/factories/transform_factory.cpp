@@ -140,5 +140,6 @@ lbann::transform::transform_pipeline lbann::proto::construct_transform_pipeline(
   for (int i = 0; i < data_reader_proto.transforms_size(); ++i) {
     tp.add_transform(construct_transform(data_reader_proto.transforms(i)));
   }
+  tp.set_device_execution(data_reader_proto.transforms_on_device());
   return tp;
 }
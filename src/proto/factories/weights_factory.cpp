@@ -195,6 +195,37 @@ lbann::proto::construct_weights(lbann_comm* comm,
     w->set_sharding_distribution(dist);
   }
 
+  // Set gradient compression
+  gradient_compression_config compression;
+  switch (proto_weights.gradient_compression()) {
+  case lbann_data::GradientCompression::FP16_CAST:
+    compression.method = gradient_compression_method::fp16;
+    break;
+  case lbann_data::GradientCompression::TOP_K:
+    compression.method = gradient_compression_method::topk;
+    break;
+  case lbann_data::GradientCompression::POWER_SGD:
+    compression.method = gradient_compression_method::powersgd;
+    break;
+  default:
+    compression.method = gradient_compression_method::none;
+    break;
+  }
+  if (proto_weights.topk_fraction() > 0.) {
+    compression.topk_fraction = proto_weights.topk_fraction();
+  }
+  if (proto_weights.powersgd_rank() > 0) {
+    compression.powersgd_rank = proto_weights.powersgd_rank();
+  }
+  if (compression.method != gradient_compression_method::none &&
+      proto_weights.sharded()) {
+    LBANN_ERROR("weights \"",
+                w->get_name(),
+                "\" requests gradient compression, which is not supported "
+                "for sharded weights");
+  }
+  w->set_gradient_compression(compression);
+
   // Set weights initializer and optimizer
   w->set_initializer(std::move(init));
   w->set_optimizer(std::move(opt));
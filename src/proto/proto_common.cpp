@@ -159,6 +159,13 @@ void init_data_readers(
       reader = dr;
       reader->set_data_sample_list(readme.sample_list());
     }
+    else if (name == "columnar") {
+      auto* dr = new columnar_reader(shuffle);
+      dr->set_experiment_schema_filename(readme.experiment_schema_filename());
+      dr->set_has_labels(readme.enable_labels());
+      dr->set_has_responses(readme.enable_responses());
+      reader = dr;
+    }
     else if (name == "ras_lipid") {
 #ifdef LBANN_HAS_CNPY
       auto* ras_lipid = new ras_lipid_conduit_data_reader(shuffle);
@@ -428,6 +435,8 @@ void init_data_readers(
           parse_list<El::Int>(readme.synth_response_dimensions()),
           shuffle);
       }
+      static_cast<data_reader_synthetic*>(reader)->set_generate_on_device(
+        readme.synth_on_device());
     }
     else if (name == "mesh") {
       reader = new mesh_reader(shuffle);
@@ -452,6 +461,7 @@ void init_data_readers(
       reader = new python_dataset_reader(params.dataset_path(),
                                          params.module_dir(),
                                          params.prefetch_factor(),
+                                         params.batches_in_flight(),
                                          shuffle);
 #else
       LBANN_ERROR("attempted to construct Python data reader, "
@@ -466,7 +476,8 @@ void init_data_readers(
                                    params.walk_length(),
                                    params.return_param(),
                                    params.inout_param(),
-                                   params.num_negative_samples());
+                                   params.num_negative_samples(),
+                                   params.prefetch_batches());
 #else
       LBANN_ERROR("attempted to construct node2vec data reader, "
                   "but LBANN is not built with "
@@ -611,6 +622,10 @@ void init_data_readers(
             split_reader = new hdf5_data_reader(shuffle);
             (*(hdf5_data_reader*)split_reader) = (*(hdf5_data_reader*)reader);
           }
+          else if (name == "columnar") {
+            split_reader =
+              new columnar_reader(*dynamic_cast<const columnar_reader*>(reader));
+          }
           else if (name == "csv") {
             split_reader = new csv_reader(shuffle);
             (*(csv_reader*)split_reader) = (*(csv_reader*)reader);
@@ -667,6 +682,7 @@ void init_data_readers(
             split_reader = new python_dataset_reader(params.dataset_path(),
                                                      params.module_dir(),
                                                      params.prefetch_factor(),
+                                                     params.batches_in_flight(),
                                                      shuffle);
             (*(python_dataset_reader*)split_reader) = (*(python_dataset_reader*)reader);
 #else
@@ -748,6 +764,28 @@ void init_data_readers(
       ++it;
     }
   }
+
+  // Only the training reader computes normalization statistics while
+  // loading; the readers of the other roles reuse them, or compute
+  // their own if there is no HDF5 training reader
+  auto& arg_parser = global_argument_parser();
+  if (!arg_parser.get<std::string>(LBANN_OPTION_HDF5_COMPUTE_NORMALIZATION)
+         .empty()) {
+    const auto* train = dynamic_cast<const hdf5_data_reader*>(
+      peek_map(data_readers, execution_mode::training));
+    for (auto& [mode, reader] : data_readers) {
+      auto* hdf5_reader = dynamic_cast<hdf5_data_reader*>(reader);
+      if (hdf5_reader == nullptr || hdf5_reader == train) {
+        continue;
+      }
+      if (train != nullptr) {
+        hdf5_reader->copy_normalization_statistics(*train);
+      }
+      else {
+        hdf5_reader->compute_normalization_statistics();
+      }
+    }
+  }
 }
 
 void read_prototext_file(const std::string& fn,
@@ -1002,6 +1040,10 @@ void print_parameters(const lbann_comm& comm,
             << "  num_epochs:                 " << m.num_epochs() << '\n'
             << "  hydrogen_block_size:        " << t.hydrogen_block_size()
             << '\n'
+            << "  gradient_fusion_bucket_size: "
+            << t.gradient_fusion_bucket_size() << '\n'
+            << "  hierarchical_gradient_allreduce: "
+            << t.hierarchical_gradient_allreduce() << '\n'
             << "  procs_per_trainer:          " << comm.get_procs_per_trainer()
             << '\n'
             << "  serialize_io:               " << t.serialize_io() << '\n'
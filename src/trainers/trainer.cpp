@@ -32,6 +32,7 @@
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/data_ingestion/data_coordinator.hpp"
 #include "lbann/data_ingestion/readers/metadata.hpp"
+#include "lbann/execution_algorithms/co_scheduled_training.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
@@ -277,6 +278,18 @@ void trainer::train(observer_ptr<model> model,
   }
 }
 
+void trainer::train(co_scheduled_training& models,
+                    El::Int num_epochs,
+                    El::Int num_batches)
+{
+  std::unique_ptr<SGDTerminationCriteria> stopping;
+  if (num_epochs)
+    stopping = std::make_unique<EpochTerminationCriteria>(num_epochs);
+  else
+    stopping = std::make_unique<BatchTerminationCriteria>(num_batches);
+  models.train(get_data_coordinator(), *stopping);
+}
+
 // NOTE (trb 04/19/2021): Currently, "evaluate" is just defined as
 // "run forward prop and look at objective
 // functions/metrics/etc". This is currently implemented in
@@ -298,11 +311,20 @@ void trainer::evaluate(observer_ptr<model> model,
 
   if (m_comm->get_grid_type() == GridType::NO_GRID or
       m_comm->get_grid_type() == GridType::PRIMARY_GRID) {
-    sgd->evaluate(*ctxt,
-                  *model,
-                  get_data_coordinator(),
-                  mode,
-                  EpochTerminationCriteria(/*num_epochs=*/1UL));
+    if (num_batches > 0) {
+      sgd->evaluate(*ctxt,
+                    *model,
+                    get_data_coordinator(),
+                    mode,
+                    BatchTerminationCriteria(num_batches));
+    }
+    else {
+      sgd->evaluate(*ctxt,
+                    *model,
+                    get_data_coordinator(),
+                    mode,
+                    EpochTerminationCriteria(/*num_epochs=*/1UL));
+    }
   }
 }
 
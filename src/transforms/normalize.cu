@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/transforms/normalize.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace transform {
+
+namespace {
+
+/** Normalize a block of rows, one channel of each sample in the batch. */
+__global__ void normalize_kernel(size_t height,
+                                 size_t width,
+                                 DataType mean,
+                                 DataType std,
+                                 DataType* __restrict__ buf,
+                                 size_t ldim)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t i = gid; i < height * width; i += nthreads) {
+    const auto row = i % height;
+    const auto col = i / height;
+    DataType& val = buf[row + col * ldim];
+    val = (val - mean) / std;
+  }
+}
+
+} // anonymous namespace
+
+void normalize::apply_batch(GPUMat& data, const std::vector<size_t>& dims)
+{
+  // Ensure we have the right number of channels.
+  if (dims.size() == 3 && m_means.size() != dims[0]) {
+    LBANN_ERROR("Normalize channels does not match data");
+  }
+  else if (dims.size() != 3 && m_means.size() != 1) {
+    LBANN_ERROR("Transform data has no channels, cannot normalize with "
+                "multiple channels");
+  }
+  const size_t width = data.Width();
+  const size_t channel_size = data.Height() / m_means.size();
+  if (channel_size * width == 0) {
+    return;
+  }
+  constexpr size_t block_size = 256;
+  const size_t grid_size =
+    (channel_size * width + block_size - 1) / block_size;
+  // One launch per channel, each over that channel's rows of every sample.
+  for (size_t channel = 0; channel < m_means.size(); ++channel) {
+    hydrogen::gpu::LaunchKernel(normalize_kernel,
+                                grid_size,
+                                block_size,
+                                0,
+                                gpu::get_sync_info(data),
+                                channel_size,
+                                width,
+                                DataType(m_means[channel]),
+                                DataType(m_stds[channel]),
+                                data.Buffer(channel * channel_size, 0),
+                                size_t(data.LDim()));
+  }
+}
+
+} // namespace transform
+} // namespace lbann
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/transforms/scale_and_translate.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace transform {
+
+namespace {
+
+__global__ void scale_and_translate_kernel(size_t height,
+                                           size_t width,
+                                           DataType scale,
+                                           DataType translate,
+                                           DataType* __restrict__ buf,
+                                           size_t ldim)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t i = gid; i < height * width; i += nthreads) {
+    const auto row = i % height;
+    const auto col = i / height;
+    DataType& val = buf[row + col * ldim];
+    val = scale * val + translate;
+  }
+}
+
+} // anonymous namespace
+
+void scale_and_translate::apply_batch(GPUMat& data, const std::vector<size_t>&)
+{
+  const size_t height = data.Height();
+  const size_t width = data.Width();
+  if (height * width == 0) {
+    return;
+  }
+  constexpr size_t block_size = 256;
+  const size_t grid_size = (height * width + block_size - 1) / block_size;
+  hydrogen::gpu::LaunchKernel(scale_and_translate_kernel,
+                              grid_size,
+                              block_size,
+                              0,
+                              gpu::get_sync_info(data),
+                              height,
+                              width,
+                              DataType(m_scale),
+                              DataType(m_translate),
+                              data.Buffer(),
+                              size_t(data.LDim()));
+}
+
+} // namespace transform
+} // namespace lbann
@@ -25,13 +25,34 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/transform_pipeline.hpp"
+#include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/random_number_generators.hpp"
+
+#include <algorithm>
 
 namespace lbann {
 namespace transform {
 
+namespace {
+
+/** Give transform @c i its own substream of the sample's I/O stream, so
+ *  its draws do not shift when earlier transforms change.
+ */
+void select_transform_stream(size_t i)
+{
+  if (is_io_sample_stream_active()) {
+    set_io_sample_transform(i);
+  }
+}
+
+} // namespace
+
 transform_pipeline::transform_pipeline(const transform_pipeline& other)
-  : m_expected_out_dims(other.m_expected_out_dims)
+  : m_expected_out_dims(other.m_expected_out_dims),
+    m_fused_view_begin(other.m_fused_view_begin),
+    m_device_execution(other.m_device_execution),
+    m_device_begin(other.m_device_begin)
 {
   for (const auto& trans : other.m_transforms) {
     m_transforms.emplace_back(trans->copy());
@@ -42,6 +63,9 @@ transform_pipeline&
 transform_pipeline::operator=(const transform_pipeline& other)
 {
   m_expected_out_dims = other.m_expected_out_dims;
+  m_fused_view_begin = other.m_fused_view_begin;
+  m_device_execution = other.m_device_execution;
+  m_device_begin = other.m_device_begin;
   m_transforms.clear();
   for (const auto& trans : other.m_transforms) {
     m_transforms.emplace_back(trans->copy());
@@ -52,8 +76,9 @@ transform_pipeline::operator=(const transform_pipeline& other)
 void transform_pipeline::apply(utils::type_erased_matrix& data,
                                std::vector<size_t>& dims)
 {
-  for (auto& trans : m_transforms) {
-    trans->apply(data, dims);
+  for (size_t i = 0; i < m_device_begin; ++i) {
+    select_transform_stream(i);
+    m_transforms[i]->apply(data, dims);
   }
   assert_expected_out_dims(dims);
 }
@@ -67,29 +92,49 @@ void transform_pipeline::apply(CPUMat& data, std::vector<size_t>& dims)
 
 void transform_pipeline::apply(El::Matrix<uint8_t>& data,
                                CPUMat& out_data,
-                               std::vector<size_t>& dims)
+                               std::vector<size_t>& dims,
+                               size_t first)
 {
   utils::type_erased_matrix m = utils::type_erased_matrix(std::move(data));
-  if (!m_transforms.empty()) {
+  if (first < m_transforms.size()) {
+    // A skipped prefix may have cut into the chain folded into the view.
+    const size_t fused_view_begin = std::max(m_fused_view_begin, first);
     bool applied_non_inplace = false;
-    size_t i = 0;
+    size_t i = first;
     for (; !applied_non_inplace && i < m_transforms.size(); ++i) {
-      if (m_transforms[i]->supports_non_inplace()) {
+      if (i == fused_view_begin && dims.size() == 3) {
+        // Fold the crops and flips into how the conversion reads the image.
+        image_view view;
+        view.h = dims[1];
+        view.w = dims[2];
+        std::vector<size_t> view_dims = dims;
+        for (; !m_transforms[i]->supports_non_inplace(); ++i) {
+          select_transform_stream(i);
+          m_transforms[i]->fold_into_view(view, view_dims);
+        }
         applied_non_inplace = true;
+        select_transform_stream(i);
+        m_transforms[i]->apply(m, out_data, dims, view);
+      }
+      else if (m_transforms[i]->supports_non_inplace()) {
+        applied_non_inplace = true;
+        select_transform_stream(i);
         m_transforms[i]->apply(m, out_data, dims);
       }
       else {
+        select_transform_stream(i);
         m_transforms[i]->apply(m, dims);
       }
     }
     if (!applied_non_inplace) {
       LBANN_ERROR("No transform to go from uint8 -> DataType");
     }
-    if (i < m_transforms.size()) {
-      // Apply the remaining transforms.
+    if (i < m_device_begin) {
+      // Apply the remaining transforms not deferred to the GPU.
       // TODO(pp): Prevent out_data from being resized/reallocated.
       m = utils::type_erased_matrix(std::move(out_data));
-      for (; i < m_transforms.size(); ++i) {
+      for (; i < m_device_begin; ++i) {
+        select_transform_stream(i);
         m_transforms[i]->apply(m, dims);
       }
       out_data = std::move(m.template get<DataType>());
@@ -101,6 +146,102 @@ void transform_pipeline::apply(El::Matrix<uint8_t>& data,
   assert_expected_out_dims(dims);
 }
 
+size_t transform_pipeline::get_deterministic_prefix_length() const
+{
+  size_t n = 0;
+  while (n < m_transforms.size() && m_transforms[n]->is_deterministic() &&
+         !m_transforms[n]->supports_non_inplace()) {
+    ++n;
+  }
+  return n;
+}
+
+size_t transform_pipeline::apply_deterministic_prefix(El::Matrix<uint8_t>& data,
+                                                      std::vector<size_t>& dims)
+{
+  const size_t n = get_deterministic_prefix_length();
+  if (n == 0) {
+    return 0;
+  }
+  utils::type_erased_matrix m = utils::type_erased_matrix(std::move(data));
+  for (size_t i = 0; i < n; ++i) {
+    m_transforms[i]->apply(m, dims);
+  }
+  data = std::move(m.template get<uint8_t>());
+  return n;
+}
+
+void transform_pipeline::set_device_execution(bool device_execution)
+{
+#ifndef LBANN_HAS_GPU
+  if (device_execution) {
+    LBANN_ERROR("Device execution of transforms requires a GPU-enabled build");
+  }
+#endif // LBANN_HAS_GPU
+  m_device_execution = device_execution;
+  find_device_transforms();
+}
+
+#ifdef LBANN_HAS_GPU
+void transform_pipeline::apply_on_device(GPUMat& data,
+                                         const std::vector<size_t>& dims)
+{
+  if (!has_device_transforms()) {
+    return;
+  }
+  if (static_cast<size_t>(data.Height()) != get_linear_size(dims)) {
+    LBANN_ERROR("Device transform batch height (",
+                data.Height(),
+                ") does not match the sample size (",
+                get_linear_size(dims),
+                ")");
+  }
+  for (size_t i = m_device_begin; i < m_transforms.size(); ++i) {
+    m_transforms[i]->apply_batch(data, dims);
+  }
+}
+#endif // LBANN_HAS_GPU
+
+void transform_pipeline::find_fused_view()
+{
+  m_fused_view_begin = m_transforms.size();
+  for (size_t i = 0; i < m_transforms.size(); ++i) {
+    if (m_transforms[i]->supports_non_inplace()) {
+      if (m_transforms[i]->supports_fused_view()) {
+        // Walk back over the crops and flips feeding the conversion.
+        size_t begin = i;
+        while (begin > 0 && m_transforms[begin - 1]->supports_view_folding()) {
+          --begin;
+        }
+        if (begin < i) {
+          m_fused_view_begin = begin;
+        }
+      }
+      return;
+    }
+  }
+}
+
+void transform_pipeline::find_device_transforms()
+{
+  m_device_begin = m_transforms.size();
+  if (!m_device_execution) {
+    return;
+  }
+  // Keep everything up to the conversion to DataType on the CPU.
+  size_t first_deferrable = 0;
+  for (size_t i = 0; i < m_transforms.size(); ++i) {
+    if (m_transforms[i]->supports_non_inplace()) {
+      first_deferrable = i + 1;
+      break;
+    }
+  }
+  while (m_device_begin > first_deferrable &&
+         m_transforms[m_device_begin - 1]->supports_device_batch()) {
+    --m_device_begin;
+  }
+}
+
 void transform_pipeline::assert_expected_out_dims(
   const std::vector<size_t>& dims)
 {
@@ -28,6 +28,7 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 
 #include "lbann/proto/transforms.pb.h"
 
@@ -64,7 +65,7 @@ void adjust_contrast::apply(utils::type_erased_matrix& data,
   else {
     std::vector<size_t> gray_dims = {1, dims[1], dims[2]};
     const size_t size = get_linear_size(gray_dims);
-    auto gray_real = El::Matrix<uint8_t>(size, 1);
+    auto gray_real = utils::get_scratch_matrix<uint8_t>(size, 1);
     cv::Mat gray = utils::get_opencv_mat(gray_real, gray_dims);
     cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
     const uint8_t* __restrict__ gray_buf = gray.ptr();
@@ -28,6 +28,7 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 
 #include "lbann/proto/transforms.pb.h"
 
@@ -47,7 +48,8 @@ void center_crop::apply(utils::type_erased_matrix& data,
     LBANN_ERROR(ss.str());
   }
   std::vector<size_t> new_dims = {dims[0], m_h, m_w};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real =
+    utils::get_scratch_matrix<uint8_t>(get_linear_size(new_dims), 1);
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   // Compute upper-left corner of crop.
   const size_t x = std::round(float(src.cols - m_w) / 2.0);
@@ -68,6 +70,22 @@ void center_crop::apply(utils::type_erased_matrix& data,
   dims = new_dims;
 }
 
+void center_crop::fold_into_view(image_view& view,
+                                 std::vector<size_t>& dims)
+{
+  if (dims[1] <= m_h || dims[2] <= m_w) {
+    std::stringstream ss;
+    ss << "Center crop to " << m_h << "x" << m_w << " applied to input "
+       << dims[1] << "x" << dims[2];
+    LBANN_ERROR(ss.str());
+  }
+  // Compute upper-left corner of crop.
+  const size_t x = std::round(float(dims[2] - m_w) / 2.0);
+  const size_t y = std::round(float(dims[1] - m_h) / 2.0);
+  view.crop(x, y, m_h, m_w);
+  dims = {dims[0], m_h, m_w};
+}
+
 std::unique_ptr<transform>
 build_center_crop_transform_from_pbuf(google::protobuf::Message const& msg)
 {
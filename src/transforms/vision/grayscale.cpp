@@ -28,6 +28,7 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 
 #include <opencv2/imgproc.hpp>
 
@@ -42,7 +43,8 @@ void grayscale::apply(utils::type_erased_matrix& data,
     return; // Only one channel: Already grayscale.
   }
   std::vector<size_t> new_dims = {1, dims[1], dims[2]};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real =
+    utils::get_scratch_matrix<uint8_t>(get_linear_size(new_dims), 1);
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   cv::cvtColor(src, dst, cv::COLOR_BGR2GRAY);
   data.emplace<uint8_t>(std::move(dst_real));
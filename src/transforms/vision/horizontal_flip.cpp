@@ -28,6 +28,7 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 
 #include "lbann/proto/transforms.pb.h"
 
@@ -39,13 +40,22 @@ void horizontal_flip::apply(utils::type_erased_matrix& data,
 {
   if (transform::get_bool_random(m_p)) {
     cv::Mat src = utils::get_opencv_mat(data, dims);
-    auto dst_real = El::Matrix<uint8_t>(get_linear_size(dims), 1);
+    auto dst_real =
+      utils::get_scratch_matrix<uint8_t>(get_linear_size(dims), 1);
     cv::Mat dst = utils::get_opencv_mat(dst_real, dims);
     cv::flip(src, dst, 1);
     data.emplace<uint8_t>(std::move(dst_real));
   }
 }
 
+void horizontal_flip::fold_into_view(image_view& view,
+                                     std::vector<size_t>& dims)
+{
+  if (transform::get_bool_random(m_p)) {
+    view.flip_h = !view.flip_h;
+  }
+}
+
 std::unique_ptr<transform>
 build_horizontal_flip_transform_from_pbuf(google::protobuf::Message const& msg)
 {
@@ -28,6 +28,7 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 
 #include "lbann/proto/transforms.pb.h"
 
@@ -42,7 +43,8 @@ void pad::apply(utils::type_erased_matrix& data, std::vector<size_t>& dims)
   std::vector<size_t> new_dims = {dims[0],
                                   dims[1] + m_p * 2,
                                   dims[2] + m_p * 2};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real =
+    utils::get_scratch_matrix<uint8_t>(get_linear_size(new_dims), 1);
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   cv::copyMakeBorder(src,
                      dst,
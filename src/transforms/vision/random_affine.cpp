@@ -28,6 +28,7 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 
 #include "lbann/proto/transforms.pb.h"
 
@@ -40,7 +41,7 @@ void random_affine::apply(utils::type_erased_matrix& data,
                           std::vector<size_t>& dims)
 {
   cv::Mat src = utils::get_opencv_mat(data, dims);
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(dims), 1);
+  auto dst_real = utils::get_scratch_matrix<uint8_t>(get_linear_size(dims), 1);
   cv::Mat dst = utils::get_opencv_mat(dst_real, dims);
   // Compute the random quantities for the transform.
   // For converting to radians:
@@ -28,6 +28,7 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 
 #include "lbann/proto/transforms.pb.h"
 
@@ -45,7 +46,8 @@ void random_crop::apply(utils::type_erased_matrix& data,
     LBANN_ERROR(ss.str());
   }
   std::vector<size_t> new_dims = {dims[0], m_h, m_w};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real =
+    utils::get_scratch_matrix<uint8_t>(get_linear_size(new_dims), 1);
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   // Select the upper-left corner of the crop.
   const size_t x = transform::get_uniform_random_int(0, dims[2] - m_w + 1);
@@ -66,6 +68,22 @@ void random_crop::apply(utils::type_erased_matrix& data,
   dims = new_dims;
 }
 
+void random_crop::fold_into_view(image_view& view,
+                                 std::vector<size_t>& dims)
+{
+  if (dims[1] <= m_h || dims[2] <= m_w) {
+    std::stringstream ss;
+    ss << "Random crop to " << m_h << "x" << m_w << " applied to input "
+       << dims[1] << "x" << dims[2];
+    LBANN_ERROR(ss.str());
+  }
+  // Select the upper-left corner of the crop.
+  const size_t x = transform::get_uniform_random_int(0, dims[2] - m_w + 1);
+  const size_t y = transform::get_uniform_random_int(0, dims[1] - m_h + 1);
+  view.crop(x, y, m_h, m_w);
+  dims = {dims[0], m_h, m_w};
+}
+
 std::unique_ptr<transform>
 build_random_crop_transform_from_pbuf(google::protobuf::Message const& msg)
 {
@@ -83,6 +83,50 @@ void to_lbann_layout::apply(utils::type_erased_matrix& data,
   }
 }
 
+void to_lbann_layout::apply(utils::type_erased_matrix& data,
+                            CPUMat& out,
+                            std::vector<size_t>& dims,
+                            const image_view& view)
+{
+  cv::Mat src = utils::get_opencv_mat(data, dims);
+  if (!src.isContinuous()) {
+    // This should not occur, but just in case.
+    LBANN_ERROR("Do not support non-contiguous OpenCV matrices.");
+  }
+  if (!out.Contiguous()) {
+    LBANN_ERROR("ToLBANNLayout does not support non-contiguous destination.");
+  }
+  if (view.x + view.w > dims[2] || view.y + view.h > dims[1]) {
+    LBANN_ERROR("Image view does not fit in the source image.");
+  }
+  std::vector<size_t> new_dims = {dims[0], view.h, view.w};
+  const size_t out_size = get_linear_size(new_dims);
+  if (static_cast<size_t>(out.Height() * out.Width()) != out_size) {
+    LBANN_ERROR("Transform output does not have sufficient space.");
+  }
+  // Read the crop through the view and mirror it while converting, so no
+  // intermediate image is produced.
+  const size_t channels = dims[0];
+  const size_t src_ldim = dims[2] * channels;
+  const size_t size = view.h * view.w;
+  const uint8_t* __restrict__ src_buf = src.ptr();
+  DataType* __restrict__ dst_buf = out.Buffer();
+  const float scale = 1.0f / 255.0f;
+  for (size_t row = 0; row < view.h; ++row) {
+    const size_t src_row = view.y + (view.flip_v ? view.h - 1 - row : row);
+    const uint8_t* __restrict__ src_line = src_buf + src_row * src_ldim;
+    for (size_t col = 0; col < view.w; ++col) {
+      const size_t src_col = view.x + (view.flip_h ? view.w - 1 - col : col);
+      const uint8_t* __restrict__ pixel = src_line + src_col * channels;
+      const size_t dst_base = row + col * view.h;
+      for (size_t c = 0; c < channels; ++c) {
+        dst_buf[dst_base + c * size] = pixel[c] * scale;
+      }
+    }
+  }
+  dims = new_dims;
+}
+
 std::unique_ptr<transform>
 build_to_lbann_layout_transform_from_pbuf(google::protobuf::Message const&)
 {
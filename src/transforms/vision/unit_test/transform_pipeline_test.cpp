@@ -31,9 +31,13 @@
 #include <lbann/transforms/normalize.hpp>
 #include <lbann/transforms/scale.hpp>
 #include <lbann/transforms/transform_pipeline.hpp>
+#include <lbann/transforms/vision/center_crop.hpp>
+#include <lbann/transforms/vision/horizontal_flip.hpp>
 #include <lbann/transforms/vision/resized_center_crop.hpp>
 #include <lbann/transforms/vision/to_lbann_layout.hpp>
+#include <lbann/transforms/vision/vertical_flip.hpp>
 #include <lbann/utils/memory.hpp>
+#include <lbann/utils/random_number_generators.hpp>
 
 TEST_CASE("Testing vision transform pipeline", "[preproc]")
 {
@@ -74,3 +78,91 @@ TEST_CASE("Testing vision transform pipeline", "[preproc]")
     }
   }
 }
+
+TEST_CASE("Testing fused crop and flip in vision transform pipeline",
+          "[preproc]")
+{
+  // Grab the necessary I/O RNG and lock it
+  lbann::locked_io_rng_ref io_rng = lbann::set_io_generators_local_index(0);
+  lbann::transform::transform_pipeline p;
+  p.add_transform(std::make_unique<lbann::transform::center_crop>(3, 3));
+  p.add_transform(std::make_unique<lbann::transform::horizontal_flip>(1.0));
+  p.add_transform(std::make_unique<lbann::transform::vertical_flip>(1.0));
+  p.add_transform(std::make_unique<lbann::transform::to_lbann_layout>());
+  El::Matrix<uint8_t> mat;
+  zeros(mat, 5, 5, 3);
+  apply_elementwise(mat,
+                    5,
+                    5,
+                    3,
+                    [](uint8_t& x, El::Int row, El::Int col, El::Int channel) {
+                      x = 25 * row + 5 * col + channel;
+                    });
+  std::vector<size_t> dims = {3, 5, 5};
+  lbann::CPUMat out(3 * 3 * 3, 1);
+
+  SECTION("applying the pipeline")
+  {
+    REQUIRE_NOTHROW(p.apply(mat, out, dims));
+
+    SECTION("pipeline produces correct dims")
+    {
+      REQUIRE(dims[0] == 3);
+      REQUIRE(dims[1] == 3);
+      REQUIRE(dims[2] == 3);
+    }
+    SECTION("pipeline produces cropped and mirrored values")
+    {
+      const lbann::DataType* buf = out.LockedBuffer();
+      for (size_t channel = 0; channel < 3; ++channel) {
+        for (size_t col = 0; col < 3; ++col) {
+          for (size_t row = 0; row < 3; ++row) {
+            // The crop starts at (1, 1); both flips mirror it.
+            const size_t src_row = 1 + (2 - row);
+            const size_t src_col = 1 + (2 - col);
+            const float expected =
+              (25 * src_row + 5 * src_col + channel) / 255.0f;
+            REQUIRE(buf[row + col * 3 + channel * 9] == Approx(expected));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Testing cached deterministic prefix of vision transform pipeline",
+          "[preproc]")
+{
+  lbann::locked_io_rng_ref io_rng = lbann::set_io_generators_local_index(0);
+  lbann::transform::transform_pipeline p;
+  p.add_transform(std::make_unique<lbann::transform::center_crop>(3, 3));
+  p.add_transform(std::make_unique<lbann::transform::horizontal_flip>(1.0));
+  p.add_transform(std::make_unique<lbann::transform::to_lbann_layout>());
+  El::Matrix<uint8_t> mat, cached;
+  zeros(mat, 5, 5, 3);
+  apply_elementwise(mat,
+                    5,
+                    5,
+                    3,
+                    [](uint8_t& x, El::Int row, El::Int col, El::Int channel) {
+                      x = 25 * row + 5 * col + channel;
+                    });
+  El::Copy(mat, cached);
+  std::vector<size_t> dims = {3, 5, 5};
+  std::vector<size_t> cached_dims = dims;
+  lbann::CPUMat out(3 * 3 * 3, 1), cached_out(3 * 3 * 3, 1);
+
+  REQUIRE(p.get_deterministic_prefix_length() == 1);
+  REQUIRE(p.apply_deterministic_prefix(cached, cached_dims) == 1);
+  REQUIRE(cached_dims == std::vector<size_t>{3, 3, 3});
+
+  SECTION("resuming after the prefix matches the full pipeline")
+  {
+    REQUIRE_NOTHROW(p.apply(mat, out, dims));
+    REQUIRE_NOTHROW(p.apply(cached, cached_out, cached_dims, 1));
+    REQUIRE(dims == cached_dims);
+    for (El::Int i = 0; i < out.Height(); ++i) {
+      REQUIRE(cached_out(i, 0) == out(i, 0));
+    }
+  }
+}
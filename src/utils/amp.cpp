@@ -61,6 +61,38 @@ void is_finite_and_unscale(El::AbstractDistMatrix<TensorDataType>& grads,
   }
 }
 
+namespace {
+
+/** Call @c f with the gradient cast to its AbstractDistMatrix type. */
+template <typename F>
+void visit_gradient(El::BaseDistMatrix& grad, F&& f)
+{
+  // Attempt to convert from a BaseDistMatrix to an AbstractDistMatrix.
+  if (auto* ptr_f = dynamic_cast<El::AbstractDistMatrix<float>*>(&grad)) {
+    f(*ptr_f);
+  }
+  else if (auto* ptr_d = dynamic_cast<El::AbstractDistMatrix<double>*>(&grad)) {
+    f(*ptr_d);
+  }
+#ifdef LBANN_HAS_HALF
+  else if (auto* ptr_cpufp16 =
+             dynamic_cast<El::AbstractDistMatrix<cpu_fp16>*>(&grad)) {
+    f(*ptr_cpufp16);
+  }
+#endif
+#ifdef LBANN_HAS_GPU_FP16
+  else if (auto* ptr_fp16 =
+             dynamic_cast<El::AbstractDistMatrix<fp16>*>(&grad)) {
+    f(*ptr_fp16);
+  }
+#endif
+  else {
+    LBANN_ERROR("Could not determine gradient type");
+  }
+}
+
+} // namespace
+
 bool is_finite_and_unscale_all(std::vector<optimizer*> optimizers,
                                EvalType scale)
 {
@@ -85,36 +117,9 @@ bool is_finite_and_unscale_all(std::vector<optimizer*> optimizers,
   for (auto&& opt : optimizers) {
     auto grads = opt->get_raw_gradients();
     for (auto&& grad_r : grads) {
-      auto& grad = grad_r.get();
-      // Attempt to convert from a BaseDistMatrix to an AbstractDistMatrix.
-      if (auto* ptr_f = dynamic_cast<El::AbstractDistMatrix<float>*>(&grad)) {
-        is_finite_and_unscale(*ptr_f, scale, is_finite_cpu_p, is_finite_gpu_p);
-      }
-      else if (auto* ptr_d =
-                 dynamic_cast<El::AbstractDistMatrix<double>*>(&grad)) {
-        is_finite_and_unscale(*ptr_d, scale, is_finite_cpu_p, is_finite_gpu_p);
-      }
-#ifdef LBANN_HAS_HALF
-      else if (auto* ptr_cpufp16 =
-                 dynamic_cast<El::AbstractDistMatrix<cpu_fp16>*>(&grad)) {
-        is_finite_and_unscale(*ptr_cpufp16,
-                              scale,
-                              is_finite_cpu_p,
-                              is_finite_gpu_p);
-      }
-#endif
-#ifdef LBANN_HAS_GPU_FP16
-      else if (auto* ptr_fp16 =
-                 dynamic_cast<El::AbstractDistMatrix<fp16>*>(&grad)) {
-        is_finite_and_unscale(*ptr_fp16,
-                              scale,
-                              is_finite_cpu_p,
-                              is_finite_gpu_p);
-      }
-#endif
-      else {
-        LBANN_ERROR("Could not determine gradient type");
-      }
+      visit_gradient(grad_r.get(), [&](auto& grad) {
+        is_finite_and_unscale(grad, scale, is_finite_cpu_p, is_finite_gpu_p);
+      });
     }
   }
 
@@ -128,6 +133,39 @@ bool is_finite_and_unscale_all(std::vector<optimizer*> optimizers,
   return is_finite;
 }
 
+#ifdef LBANN_HAS_GPU
+bool is_finite_and_unscale_all_gpu(
+  std::vector<optimizer*> const& optimizers,
+  EvalType scale,
+  El::Matrix<float, El::Device::GPU>& is_finite)
+{
+  std::vector<std::reference_wrapper<El::BaseDistMatrix>> grads;
+  for (auto&& opt : optimizers) {
+    auto opt_grads = opt->get_raw_gradients();
+    grads.insert(grads.end(), opt_grads.begin(), opt_grads.end());
+  }
+  bool all_on_gpu = true;
+  for (auto&& grad_r : grads) {
+    visit_gradient(grad_r.get(), [&](auto& grad) {
+      all_on_gpu &= (grad.GetLocalDevice() == El::Device::GPU);
+    });
+  }
+  if (!all_on_gpu) {
+    return false;
+  }
+
+  // See the note on stream ordering in is_finite_and_unscale_all.
+  is_finite.Resize(1, 1);
+  El::Fill(is_finite, El::TypeTraits<float>::One());
+  for (auto&& grad_r : grads) {
+    visit_gradient(grad_r.get(), [&](auto& grad) {
+      is_finite_and_unscale_gpu(grad, scale, is_finite.Buffer());
+    });
+  }
+  return true;
+}
+#endif // LBANN_HAS_GPU
+
 template <typename TensorDataType>
 void is_finite_and_unscale_cpu(El::AbstractDistMatrix<TensorDataType>& grads,
                                EvalType scale,
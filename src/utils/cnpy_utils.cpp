@@ -25,6 +25,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/utils/cnpy_utils.hpp"
+#include "lbann/comm.hpp"
+
+#include <fcntl.h>
+#include <cstring>
+#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace lbann {
 namespace cnpy_utils {
@@ -85,5 +92,138 @@ std::string show_shape(const cnpy::NpyArray& na)
   return ret;
 }
 
+void load_node_shared(
+  lbann_comm& comm,
+  const std::string& name,
+  const std::function<std::map<std::string, cnpy::NpyArray>()>& load,
+  std::map<std::string, cnpy::NpyArray>& arrays,
+  std::map<std::string, std::shared_ptr<const char>>& data)
+{
+  // Arrays start on cache-line boundaries within the segment
+  constexpr size_t alignment = 64;
+
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(comm.get_trainer_comm().GetMPIComm(),
+                      MPI_COMM_TYPE_SHARED,
+                      comm.get_rank_in_trainer(),
+                      MPI_INFO_NULL,
+                      &node_comm);
+  int node_rank = 0;
+  MPI_Comm_rank(node_comm, &node_rank);
+  const bool is_root = (node_rank == 0);
+
+  // The root loads the arrays and broadcasts their metadata
+  arrays.clear();
+  data.clear();
+  std::string metadata;
+  if (is_root) {
+    arrays = load();
+    std::ostringstream ss;
+    for (const auto& [key, na] : arrays) {
+      ss << key.size() << ' ' << key << ' ' << na.word_size << ' '
+         << na.fortran_order << ' ' << na.shape.size();
+      for (const auto& d : na.shape) {
+        ss << ' ' << d;
+      }
+      ss << '\n';
+    }
+    metadata = ss.str();
+  }
+  unsigned long long metadata_size = metadata.size();
+  MPI_Bcast(&metadata_size, 1, MPI_UNSIGNED_LONG_LONG, 0, node_comm);
+  metadata.resize(metadata_size);
+  MPI_Bcast(metadata.data(), metadata_size, MPI_CHAR, 0, node_comm);
+
+  std::map<std::string, size_t> offsets;
+  size_t total_bytes = 0;
+  {
+    std::istringstream ss(metadata);
+    size_t key_size;
+    while (ss >> key_size) {
+      std::string key(key_size, '\0');
+      ss.get(); // the separating space
+      ss.read(key.data(), key_size);
+      cnpy::NpyArray na;
+      size_t ndims;
+      ss >> na.word_size >> na.fortran_order >> ndims;
+      na.shape.resize(ndims);
+      na.num_vals = 1;
+      for (auto& d : na.shape) {
+        ss >> d;
+        na.num_vals *= d;
+      }
+      offsets[key] = total_bytes;
+      total_bytes += (na.num_vals * na.word_size + alignment - 1) /
+                     alignment * alignment;
+      if (!is_root) {
+        na.data_holder = std::make_shared<std::vector<char>>();
+        arrays[key] = std::move(na);
+      }
+    }
+  }
+
+  if (total_bytes == 0) {
+    for (auto& [key, na] : arrays) {
+      data[key] = nullptr;
+    }
+    MPI_Comm_free(&node_comm);
+    return;
+  }
+
+  // One segment per (trainer, arrays) on each node
+  const std::string seg_name =
+    "/lbann_npy_" + std::to_string(std::hash<std::string>{}(name)) + "_" +
+    std::to_string(comm.get_trainer_rank());
+  void* seg = MAP_FAILED;
+  if (is_root) {
+    shm_unlink(seg_name.c_str()); // in case a previous run left it behind
+    const int fd = shm_open(seg_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+      LBANN_ERROR("shm_open failed for ", seg_name, " (", name, ")");
+    }
+    if (ftruncate(fd, total_bytes) != 0) {
+      LBANN_ERROR("ftruncate of ", seg_name, " to ", total_bytes, " failed");
+    }
+    seg = mmap(nullptr, total_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+      LBANN_ERROR("mmap of ", seg_name, " failed");
+    }
+    for (auto& [key, na] : arrays) {
+      std::memcpy(static_cast<char*>(seg) + offsets.at(key),
+                  na.data_holder->data(),
+                  na.num_vals * na.word_size);
+      // Release the private copy
+      na.data_holder = std::make_shared<std::vector<char>>();
+    }
+  }
+  MPI_Barrier(node_comm);
+  if (!is_root) {
+    const int fd = shm_open(seg_name.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+      LBANN_ERROR("shm_open failed for ", seg_name, " (", name, ")");
+    }
+    seg = mmap(nullptr, total_bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+      LBANN_ERROR("mmap of ", seg_name, " failed");
+    }
+  }
+  // Once everyone has it mapped the name is no longer needed
+  MPI_Barrier(node_comm);
+  if (is_root) {
+    shm_unlink(seg_name.c_str());
+  }
+  MPI_Comm_free(&node_comm);
+
+  std::shared_ptr<const char> base(static_cast<const char*>(seg),
+                                   [total_bytes](const char* p) {
+                                     munmap(const_cast<char*>(p), total_bytes);
+                                   });
+  for (const auto& [key, offset] : offsets) {
+    data[key] = std::shared_ptr<const char>(base, base.get() + offset);
+  }
+}
+
 } // end of namespace cnpy_utils
 } // end of namespace lbann
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann_config.hpp"
+
+#ifdef LBANN_HAS_DNN_LIB
+
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/dnn_lib/dnn_lib.hpp"
+#include "lbann/utils/options.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace lbann {
+namespace dnn_lib {
+
+namespace {
+
+/** @brief Autotuned convolution algorithms shared by all layers
+ *
+ *  Each line of the backing file is a tab-separated record of key,
+ *  algorithm, and math type. Records are appended as they are found,
+ *  so an interrupted run still saves its progress. Malformed lines
+ *  (e.g. from a concurrent partial write) are skipped.
+ */
+class conv_algorithm_cache
+{
+public:
+  static conv_algorithm_cache& instance()
+  {
+    static conv_algorithm_cache cache;
+    return cache;
+  }
+
+  bool find(const std::string& key, int& algo, int& math_type)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+      return false;
+    }
+    algo = it->second.first;
+    math_type = it->second.second;
+    return true;
+  }
+
+  void insert(const std::string& key, int algo, int math_type, bool persist)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[key] = {algo, math_type};
+    if (persist && !m_path.empty()) {
+      std::ofstream ofs(m_path, std::ios::app);
+      if (!ofs) {
+        LBANN_WARNING("could not write convolution algorithm cache ",
+                      "(",
+                      m_path,
+                      ")");
+        return;
+      }
+      ofs << key << '\t' << algo << '\t' << math_type << '\n';
+    }
+  }
+
+private:
+  conv_algorithm_cache()
+  {
+    auto& arg_parser = global_argument_parser();
+    m_path = arg_parser.get<std::string>(LBANN_OPTION_CONV_ALGO_CACHE);
+    if (m_path.empty()) {
+      return;
+    }
+    std::ifstream ifs(m_path);
+    std::string line;
+    while (std::getline(ifs, line)) {
+      const auto tab1 = line.find('\t');
+      const auto tab2 = line.find('\t', tab1 + 1);
+      if (tab1 == std::string::npos || tab2 == std::string::npos) {
+        continue;
+      }
+      std::istringstream values(line.substr(tab1 + 1));
+      int algo, math_type;
+      if (values >> algo >> math_type) {
+        m_entries[line.substr(0, tab1)] = {algo, math_type};
+      }
+    }
+  }
+
+  /** Backing file (empty if entries are not persisted). */
+  std::string m_path;
+  /** Problem description -> (algorithm, math type). */
+  std::unordered_map<std::string, std::pair<int, int>> m_entries;
+  std::mutex m_mutex;
+};
+
+} // namespace
+
+bool find_cached_conv_algorithm(const std::string& key,
+                                int& algo,
+                                int& math_type)
+{
+  return conv_algorithm_cache::instance().find(key, algo, math_type);
+}
+
+void cache_conv_algorithm(const std::string& key,
+                          int algo,
+                          int math_type,
+                          bool persist)
+{
+  conv_algorithm_cache::instance().insert(key, algo, math_type, persist);
+}
+
+} // namespace dnn_lib
+} // namespace lbann
+
+#endif // LBANN_HAS_DNN_LIB
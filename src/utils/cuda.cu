@@ -111,8 +111,37 @@ bool event_wrapper::query() const
 
 void event_wrapper::synchronize() { CHECK_CUDA(cudaEventSynchronize(m_event)); }
 
+void event_wrapper::wait(cudaStream_t stream)
+{
+  CHECK_CUDA(cudaStreamWaitEvent(stream, m_event, 0));
+}
+
 cudaEvent_t& event_wrapper::get_event() { return m_event; }
 
+// -------------------------------------------------------------
+// timing_event
+// -------------------------------------------------------------
+
+timing_event::timing_event() : m_event(nullptr)
+{
+  CHECK_CUDA(cudaEventCreate(&m_event));
+}
+
+timing_event::~timing_event() { cudaEventDestroy(m_event); }
+
+void timing_event::record(cudaStream_t stream)
+{
+  CHECK_CUDA(cudaEventRecord(m_event, stream));
+}
+
+float timing_event::elapsed_ms(const timing_event& start)
+{
+  CHECK_CUDA(cudaEventSynchronize(m_event));
+  float ms = 0.f;
+  CHECK_CUDA(cudaEventElapsedTime(&ms, start.m_event, m_event));
+  return ms;
+}
+
 // -----------------------------
 // Graph
 // -----------------------------
@@ -32,6 +32,7 @@
 #include "lbann/utils/number_theory.hpp"
 
 #include "El.hpp"
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <tuple>
@@ -1094,7 +1095,8 @@ template <typename TensorDataType>
 void set_data_parallel_tensor_desc(
   TensorDescriptor& desc,
   std::vector<int> dims,
-  const El::AbstractMatrix<TensorDataType>& local_data)
+  const El::AbstractMatrix<TensorDataType>& local_data,
+  bool channels_last)
 {
 #ifdef LBANN_DEBUG
   if (local_data.GetDevice() != El::Device::GPU) {
@@ -1106,6 +1108,12 @@ void set_data_parallel_tensor_desc(
     for (int i = strides.size() - 1; i > 0; --i) {
       strides[i - 1] = strides[i] * dims[i];
     }
+    if (channels_last && dims.size() > 1) {
+      // Move the trailing channel dim to the front, keeping its
+      // unit stride, so the descriptor is NCHW with NHWC strides
+      std::rotate(dims.rbegin(), dims.rbegin() + 1, dims.rend());
+      std::rotate(strides.rbegin(), strides.rbegin() + 1, strides.rend());
+    }
     dims.insert(dims.begin(), local_data.Width());
     strides.insert(strides.begin(), local_data.LDim());
     desc.set(get_data_type<TensorDataType>(), dims, strides);
@@ -1127,7 +1135,10 @@ data_parallel_layer_tensor_manager<TensorDataType>::get_prev_activations(
   const auto& dims = this->m_layer->get_input_dims(parent_index);
   this->set_num_parents(this->m_layer->get_num_parents());
   auto& desc = this->m_prev_activations[parent_index];
-  set_data_parallel_tensor_desc<TensorDataType>(desc, dims, local_data);
+  set_data_parallel_tensor_desc<TensorDataType>(desc,
+                                                dims,
+                                                local_data,
+                                                m_channels_last);
   return desc;
 }
 
@@ -1143,7 +1154,10 @@ data_parallel_layer_tensor_manager<TensorDataType>::get_activations(
   const auto& dims = this->m_layer->get_output_dims(child_index);
   this->set_num_children(this->m_layer->get_num_children());
   auto& desc = this->m_activations[child_index];
-  set_data_parallel_tensor_desc<TensorDataType>(desc, dims, local_data);
+  set_data_parallel_tensor_desc<TensorDataType>(desc,
+                                                dims,
+                                                local_data,
+                                                m_channels_last);
   return desc;
 }
 
@@ -1160,7 +1174,10 @@ data_parallel_layer_tensor_manager<TensorDataType>::get_prev_error_signals(
   const auto& dims = this->m_layer->get_output_dims(child_index);
   this->set_num_children(this->m_layer->get_num_children());
   auto& desc = this->m_prev_error_signals[child_index];
-  set_data_parallel_tensor_desc<TensorDataType>(desc, dims, local_data);
+  set_data_parallel_tensor_desc<TensorDataType>(desc,
+                                                dims,
+                                                local_data,
+                                                m_channels_last);
   return desc;
 }
 
@@ -1176,7 +1193,10 @@ data_parallel_layer_tensor_manager<TensorDataType>::get_error_signals(
   const auto& dims = this->m_layer->get_input_dims(parent_index);
   this->set_num_parents(this->m_layer->get_num_parents());
   auto& desc = this->m_error_signals[parent_index];
-  set_data_parallel_tensor_desc<TensorDataType>(desc, dims, local_data);
+  set_data_parallel_tensor_desc<TensorDataType>(desc,
+                                                dims,
+                                                local_data,
+                                                m_channels_last);
   return desc;
 }
 
@@ -1785,6 +1805,15 @@ ProtoTensorOpEnumType convert_to_proto_math_type(cudnnMathType_t mt)
   }
 }
 
+std::string get_autotune_context()
+{
+  int device = 0;
+  cudaDeviceProp prop;
+  CHECK_CUDA(cudaGetDevice(&device));
+  CHECK_CUDA(cudaGetDeviceProperties(&prop, device));
+  return build_string(prop.name, " cudnn-", cudnnGetVersion());
+}
+
 std::string get_math_type_description(dnnMathType_t mt) {
   switch (mt) {
   case CUDNN_DEFAULT_MATH:
@@ -26,8 +26,13 @@
 
 #include <lbann/utils/cufft_wrapper.hpp>
 #include <lbann/utils/exception.hpp>
+#include <lbann/utils/gpu/helpers.hpp>
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 
 namespace lbann {
 namespace cufft {
@@ -104,5 +109,35 @@ std::string result_string(cufftResult_t r)
   }
   return "";
 }
+
+int get_device_id()
+{
+  int device = 0;
+  CHECK_CUDA(cudaGetDevice(&device));
+  return device;
+}
+
+void* get_work_area(size_t size, El::SyncInfo<El::Device::GPU> const& sync)
+{
+  using BufferType = El::simple_buffer<unsigned char, El::Device::GPU>;
+  using WorkAreaType = std::pair<size_t, std::unique_ptr<BufferType>>;
+  static std::mutex mutex;
+  // Deliberately leaked so that nothing is freed after the GPU
+  // runtime shuts down
+  static auto& work_areas =
+    *(new std::map<std::pair<int, cudaStream_t>, WorkAreaType>);
+  if (size == 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& work_area = work_areas[{get_device_id(), sync.Stream()}];
+  if (work_area.first < size) {
+    // Stream-ordered, so pending transforms finish with the old buffer
+    work_area.second = std::make_unique<BufferType>(size, sync);
+    work_area.first = size;
+  }
+  return work_area.second->data();
+}
+
 } // namespace cufft
 } // namespace lbann
@@ -31,6 +31,9 @@
 #endif // LBANN_HAS_DNN_LIB
 #include "lbann/layers/layer.hpp"
 #include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <sstream>
 
 #ifdef LBANN_HAS_DISTCONV
 
@@ -65,7 +68,9 @@ std::string opt_synthetic_data_reader_randgen("MINSTD");
 int opt_num_pre_generated_synthetic_data = 0;
 bool opt_deterministic = false;
 int opt_num_io_partitions = 1;
+std::vector<int> opt_io_partition_shape;
 bool opt_cosmoflow_parallel_io = false;
+bool opt_overlap_halo_exchange = false;
 
 void set_options()
 {
@@ -115,10 +120,45 @@ void set_options()
   if (env) {
     opt_num_io_partitions = std::atoi(env);
   }
+  env = getenv("LBANN_DISTCONV_IO_PARTITION_SHAPE");
+  if (env) {
+    // Partitions along depth, height and width, e.g. "2x2x2"
+    std::istringstream ss(env);
+    std::string token;
+    while (std::getline(ss, token, 'x')) {
+      opt_io_partition_shape.push_back(std::atoi(token.c_str()));
+    }
+    const int num_parts = std::accumulate(opt_io_partition_shape.begin(),
+                                          opt_io_partition_shape.end(),
+                                          1,
+                                          std::multiplies<int>());
+    if (opt_io_partition_shape.size() != 3 || num_parts <= 0) {
+      LBANN_ERROR("LBANN_DISTCONV_IO_PARTITION_SHAPE must have the form ",
+                  "DxHxW (got \"",
+                  env,
+                  "\")");
+    }
+    if (getenv("LBANN_DISTCONV_NUM_IO_PARTITIONS") &&
+        opt_num_io_partitions != num_parts) {
+      LBANN_ERROR("LBANN_DISTCONV_IO_PARTITION_SHAPE (",
+                  env,
+                  ") does not match LBANN_DISTCONV_NUM_IO_PARTITIONS (",
+                  opt_num_io_partitions,
+                  ")");
+    }
+    opt_num_io_partitions = num_parts;
+  }
+  else {
+    opt_io_partition_shape = {opt_num_io_partitions, 1, 1};
+  }
   env = getenv("LBANN_DISTCONV_COSMOFLOW_PARALLEL_IO");
   if (env) {
     opt_cosmoflow_parallel_io = true;
   }
+  env = getenv("LBANN_DISTCONV_OVERLAP_HALO_EXCHANGE");
+  if (env) {
+    opt_overlap_halo_exchange = true;
+  }
   options_set = true;
 }
 
@@ -143,7 +183,12 @@ void print_options(std::ostream& os)
        << opt_num_pre_generated_synthetic_data << std::endl;
     ss << "  deterministic: " << opt_deterministic << std::endl;
     ss << "  num_io_partitions: " << opt_num_io_partitions << std::endl;
+    ss << "  io_partition_shape: " << opt_io_partition_shape[0] << "x"
+       << opt_io_partition_shape[1] << "x" << opt_io_partition_shape[2]
+       << std::endl;
     ss << "  cosmoflow_parallel_io: " << opt_cosmoflow_parallel_io << std::endl;
+    ss << "  overlap_halo_exchange: " << opt_overlap_halo_exchange
+       << std::endl;
     os << ss.str();
   }
 }
@@ -304,6 +349,9 @@ void initialize(MPI_Comm comm)
     new AlCommType(mpi_comm, default_hydrogen_stream());
   ::distconv::backend::Options backend_opts;
   backend_opts.m_deterministic = opt_deterministic;
+  // Convolutions split into interior and boundary regions so the
+  // interior is computed while halos are in flight
+  backend_opts.m_overlap_halo_exchange = opt_overlap_halo_exchange;
   backend_instance = new Backend(mpi_comm,
                                  lbann::dnn_lib::get_handle(),
                                  default_hydrogen_stream(),
@@ -379,8 +427,26 @@ bool is_deterministic() { return opt_deterministic; }
 
 int get_number_of_io_partitions() { return opt_num_io_partitions; }
 
+const std::vector<int>& get_io_partition_shape()
+{
+  return opt_io_partition_shape;
+}
+
+std::vector<int> get_io_partition_index(int rank)
+{
+  // Ranks that read one sample are consecutive, with the width index
+  // varying fastest as in the Distconv process grid
+  const auto& shape = opt_io_partition_shape;
+  const int part = rank % opt_num_io_partitions;
+  return {part / (shape[1] * shape[2]),
+          (part / shape[2]) % shape[1],
+          part % shape[2]};
+}
+
 bool is_cosmoflow_parallel_io_enabled() { return opt_cosmoflow_parallel_io; }
 
+bool is_overlap_halo_exchange_enabled() { return opt_overlap_halo_exchange; }
+
 AlCommType& get_hosttransfer() { return *hosttransfer_comm_instance; }
 
 Backend& get_backend() { return *backend_instance; }
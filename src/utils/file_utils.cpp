@@ -31,11 +31,15 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <dirent.h>
 #include <errno.h>
 #include <fstream>
 #include <libgen.h>
+#include <fcntl.h>
 #include <sstream>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 namespace lbann {
 
@@ -289,6 +293,69 @@ void remove_multiple_slashes(std::string& str)
   str = s.str();
 }
 
+namespace {
+void list_files_impl(const std::string& root,
+                     const std::string& prefix,
+                     std::vector<std::string>& files)
+{
+  const std::string dir = prefix.empty() ? root : join_path(root, prefix);
+  DIR* const d = ::opendir(dir.c_str());
+  if (d == nullptr) {
+    LBANN_ERROR("failed to open directory ", dir, " (", strerror(errno), ")");
+  }
+  while (struct dirent* const entry = ::readdir(d)) {
+    const std::string name = entry->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    const std::string rel = prefix.empty() ? name : join_path(prefix, name);
+    if (directory_exists(join_path(root, rel))) {
+      list_files_impl(root, rel, files);
+    }
+    else {
+      files.push_back(rel);
+    }
+  }
+  ::closedir(d);
+}
+} // namespace
+
+std::vector<std::string> list_files(const std::string& dir)
+{
+  std::vector<std::string> files;
+  list_files_impl(dir, "", files);
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+mapped_file::mapped_file(const std::string& filename)
+{
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LBANN_ERROR("failed to open ", filename, " for reading");
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    LBANN_ERROR("failed to stat ", filename);
+  }
+  m_size = st.st_size;
+  void* const m =
+    m_size ? mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+  close(fd);
+  if (m == MAP_FAILED) {
+    LBANN_ERROR("failed to map ", filename);
+  }
+  m_data = m;
+}
+
+mapped_file::~mapped_file()
+{
+  if (m_data != nullptr) {
+    munmap(m_data, m_size);
+  }
+}
+
 } // namespace file
 
 } // namespace lbann
@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann_config.hpp"
+
+#ifdef LBANN_HAS_GPU
+
+#include "lbann/utils/gpu_memory_pool.hpp"
+
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/options.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#if defined(LBANN_HAS_CUDA)
+#define LBANN_CHECK_POOL(call) CHECK_CUDA(call)
+#elif defined(LBANN_HAS_ROCM)
+#define LBANN_CHECK_POOL(call) CHECK_ROCM(call)
+#endif
+
+namespace lbann {
+namespace gpu {
+
+double memory_pool_statistics::fragmentation() const noexcept
+{
+  if (free_bytes == 0) {
+    return 0.;
+  }
+  return 1. - static_cast<double>(largest_free_block) / free_bytes;
+}
+
+memory_pool_statistics get_memory_pool_statistics()
+{
+  memory_pool_statistics stats;
+#ifdef HYDROGEN_HAVE_CUB
+  auto& pool = El::cub::MemoryPool();
+  const int device = hydrogen::gpu::DefaultDevice();
+  std::lock_guard<decltype(pool.mutex)> lock(pool.mutex);
+  for (auto const& block : pool.live_blocks) {
+    if (block.device == device) {
+      stats.live_bytes += block.bytes;
+      ++stats.live_blocks;
+    }
+  }
+  for (auto const& block : pool.cached_blocks) {
+    if (block.device == device) {
+      stats.free_bytes += block.bytes;
+      ++stats.free_blocks;
+      stats.largest_free_block =
+        std::max(stats.largest_free_block, block.bytes);
+      ++stats.free_bins[block.bytes];
+    }
+  }
+#endif // HYDROGEN_HAVE_CUB
+  return stats;
+}
+
+size_t grow_memory_pool(double slack)
+{
+  size_t added_bytes = 0;
+#ifdef HYDROGEN_HAVE_CUB
+  auto& pool = El::cub::MemoryPool();
+  const int device = hydrogen::gpu::DefaultDevice();
+
+  // Every binned block the pool holds, live or cached, and the cached
+  // ones among them. Larger requests are not binned and never cached.
+  std::map<size_t, size_t> bins;
+  std::map<size_t, size_t> cached_bins;
+  size_t pool_bytes = 0;
+  {
+    auto add_blocks = [&](auto const& blocks, bool cached) {
+      for (auto const& block : blocks) {
+        if (block.device == device && block.bin != pool.INVALID_BIN) {
+          ++bins[block.bytes];
+          cached_bins[block.bytes] += cached ? 1 : 0;
+          pool_bytes += block.bytes;
+        }
+      }
+    };
+    std::lock_guard<decltype(pool.mutex)> lock(pool.mutex);
+    add_blocks(pool.live_blocks, false);
+    add_blocks(pool.cached_blocks, true);
+  }
+
+  // The first allocations of a bin take its cached blocks, so those
+  // are allocated too. Every block stays live until the end, so each
+  // extra one is new device memory.
+  std::vector<void*> blocks;
+  for (auto const& [bytes, count] : bins) {
+    const auto num_extra = static_cast<size_t>(std::ceil(count * slack));
+    const size_t num_blocks = cached_bins[bytes] + num_extra;
+    for (size_t i = 0; i < num_blocks; ++i) {
+      void* ptr = nullptr;
+      LBANN_CHECK_POOL(pool.DeviceAllocate(&ptr, bytes));
+      blocks.push_back(ptr);
+    }
+    added_bytes += num_extra * bytes;
+  }
+
+  // Keep the whole working set cached, then hand the blocks back to
+  // the cache
+  pool.SetMaxCachedBytes(
+    std::max(pool.max_cached_bytes, pool_bytes + added_bytes));
+  for (auto* ptr : blocks) {
+    LBANN_CHECK_POOL(pool.DeviceFree(ptr));
+  }
+#endif // HYDROGEN_HAVE_CUB
+  return added_bytes;
+}
+
+size_t preallocate_memory_pool()
+{
+  static std::once_flag once;
+  size_t added_bytes = 0;
+  std::call_once(once, [&added_bytes] {
+    auto const& arg_parser = global_argument_parser();
+    const double slack =
+      arg_parser.get<float>(LBANN_OPTION_PREALLOCATE_MEMORY_POOL);
+    if (slack >= 0) {
+      added_bytes = grow_memory_pool(slack);
+    }
+  });
+  return added_bytes;
+}
+
+} // namespace gpu
+} // namespace lbann
+
+#endif // LBANN_HAS_GPU
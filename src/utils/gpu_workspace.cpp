@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann_config.hpp"
+
+#ifdef LBANN_HAS_GPU
+
+#include "lbann/utils/gpu_workspace.hpp"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace lbann {
+namespace gpu {
+
+namespace {
+
+using StreamType =
+  decltype(std::declval<El::SyncInfo<El::Device::GPU>>().Stream());
+using ByteBuffer = hydrogen::simple_buffer<El::byte, El::Device::GPU>;
+
+/** Workspace for each stream. */
+std::unordered_map<StreamType, std::unique_ptr<ByteBuffer>> workspaces;
+std::mutex workspaces_mutex;
+
+} // namespace
+
+void* get_workspace(size_t size, El::SyncInfo<El::Device::GPU> const& si)
+{
+  std::lock_guard<std::mutex> lock(workspaces_mutex);
+  auto& workspace = workspaces[si.Stream()];
+  if (workspace == nullptr) {
+    workspace = std::make_unique<ByteBuffer>(si);
+  }
+  if (workspace->size() < size) {
+    // Note: Previous work on this stream finishes with the old
+    // buffer before the new one is used.
+    workspace->allocate(size);
+  }
+  return workspace->data();
+}
+
+size_t get_workspace_capacity()
+{
+  std::lock_guard<std::mutex> lock(workspaces_mutex);
+  size_t capacity = 0;
+  for (const auto& w : workspaces) {
+    capacity += w.second->size();
+  }
+  return capacity;
+}
+
+void free_workspaces()
+{
+  std::lock_guard<std::mutex> lock(workspaces_mutex);
+  workspaces.clear();
+}
+
+} // namespace gpu
+} // namespace lbann
+
+#endif // LBANN_HAS_GPU
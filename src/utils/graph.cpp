@@ -355,5 +355,42 @@ void condensation(const std::set<El::Int>& nodes,
   }
 }
 
+std::map<El::Int, int>
+assign_streams(const std::set<El::Int>& nodes,
+               const std::map<El::Int, std::set<El::Int>>& edges,
+               int num_streams)
+{
+  if (num_streams < 1) {
+    LBANN_ERROR("attempted to assign graph nodes to ",
+                num_streams,
+                " streams");
+  }
+  if (!is_topologically_sorted(nodes, edges)) {
+    LBANN_ERROR("attempted to assign streams in a graph "
+                "that is not topologically sorted");
+  }
+
+  const auto& parents = transpose(nodes, edges);
+  std::map<El::Int, int> streams;
+  std::set<El::Int> continued;
+  int next_stream = 0;
+  for (const auto& node : nodes) {
+    bool assigned = false;
+    for (const auto& parent : get_neighbors(node, parents)) {
+      if (continued.count(parent) == 0) {
+        continued.insert(parent);
+        streams[node] = streams[parent];
+        assigned = true;
+        break;
+      }
+    }
+    if (!assigned) {
+      streams[node] = next_stream;
+      next_stream = (next_stream + 1) % num_streams;
+    }
+  }
+  return streams;
+}
+
 } // namespace graph
 } // namespace lbann
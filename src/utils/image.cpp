@@ -28,9 +28,13 @@
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/opencv.hpp"
+#include "lbann/utils/scratch_arena.hpp"
 #include <arpa/inet.h>
 #include <opencv2/imgcodecs.hpp>
 #include <stdio.h>
+#ifdef LBANN_HAS_TURBOJPEG
+#include <turbojpeg.h>
+#endif // LBANN_HAS_TURBOJPEG
 
 namespace lbann {
 
@@ -56,7 +60,7 @@ void read_file_to_buf(const std::string& filename,
   size = static_cast<size_t>(size_);
   rewind(f);
   // Allocate sufficient space and read.
-  buf.Resize(size, 1);
+  utils::attach_scratch_matrix(buf, size, 1);
   if (fread(buf.Buffer(), 1, size, f) != size) {
     LBANN_ERROR("Could not real file " + filename);
   }
@@ -178,7 +182,7 @@ void opencv_decode(El::Matrix<uint8_t>& buf,
   guess_image_size(buf, encoded_size, height, width, channels);
   if (height != 0) {
     // We have a guess.
-    dst.Resize(height * width * channels, 1);
+    utils::attach_scratch_matrix(dst, height * width * channels, 1);
     std::vector<size_t> guessed_dims = {channels, height, width};
     // Decode the image.
     cv::Mat cv_dst = utils::get_opencv_mat(dst, guessed_dims);
@@ -196,7 +200,7 @@ void opencv_decode(El::Matrix<uint8_t>& buf,
             static_cast<size_t>(real_decoded.cols)};
     // If we did not guess the size right, need to copy.
     if (real_decoded.ptr() != dst.Buffer()) {
-      dst.Resize(get_linear_size(dims), 1);
+      utils::attach_scratch_matrix(dst, get_linear_size(dims), 1);
       cv_dst = utils::get_opencv_mat(dst, dims);
       real_decoded.copyTo(cv_dst);
     }
@@ -212,12 +216,148 @@ void opencv_decode(El::Matrix<uint8_t>& buf,
             static_cast<size_t>(decoded.rows),
             static_cast<size_t>(decoded.cols)};
     // Copy to dst.
-    dst.Resize(get_linear_size(dims), 1);
+    utils::attach_scratch_matrix(dst, get_linear_size(dims), 1);
     cv::Mat cv_dst = utils::get_opencv_mat(dst, dims);
     decoded.copyTo(cv_dst);
   }
 }
 
+#ifdef LBANN_HAS_TURBOJPEG
+// Per-thread libjpeg-turbo decompressor; handles are not thread-safe.
+struct turbojpeg_decompressor
+{
+  tjhandle handle = tjInitDecompress();
+  ~turbojpeg_decompressor()
+  {
+    if (handle != nullptr) {
+      tjDestroy(handle);
+    }
+  }
+};
+
+// Read the orientation tag from the TIFF header and first IFD of an EXIF
+// block. Returns 1 (no transform) if there is none.
+int exif_orientation(const uint8_t* tiff, size_t size)
+{
+  if (size < 8 || (tiff[0] != 'M' && tiff[0] != 'I') || tiff[0] != tiff[1]) {
+    return 1;
+  }
+  const bool big_endian = tiff[0] == 'M';
+  auto read16 = [big_endian](const uint8_t* p) -> size_t {
+    return big_endian ? (p[0] << 8) | p[1] : (p[1] << 8) | p[0];
+  };
+  auto read32 = [big_endian, &read16](const uint8_t* p) -> size_t {
+    return big_endian ? (read16(p) << 16) | read16(p + 2)
+                      : (read16(p + 2) << 16) | read16(p);
+  };
+  const size_t ifd = read32(tiff + 4);
+  if (ifd + 2 > size) {
+    return 1;
+  }
+  const size_t num_entries = read16(tiff + ifd);
+  for (size_t i = 0; i < num_entries; ++i) {
+    const size_t entry = ifd + 2 + 12 * i;
+    if (entry + 12 > size) {
+      return 1;
+    }
+    if (read16(tiff + entry) == 0x0112) {
+      const size_t orientation = read16(tiff + entry + 8);
+      return (orientation >= 1 && orientation <= 8)
+               ? static_cast<int>(orientation)
+               : 1;
+    }
+  }
+  return 1;
+}
+
+// Return the EXIF orientation (1-8) of a JPEG, or 1 if there is none.
+// Only the segments before the first scan are searched.
+int jpeg_exif_orientation(const uint8_t* buf, size_t size)
+{
+  for (size_t pos = 2; pos + 4 <= size;) {
+    const uint8_t marker = buf[pos + 1];
+    if (buf[pos] != 0xFF || marker == 0xDA || marker == 0xD9) {
+      // Not a marker, start of scan, or end of image
+      return 1;
+    }
+    const size_t length = (buf[pos + 2] << 8) | buf[pos + 3];
+    if (length < 2 || pos + 2 + length > size) {
+      return 1;
+    }
+    if (marker == 0xE1 && length >= 8 &&
+        memcmp(&buf[pos + 4], "Exif\0\0", 6) == 0) {
+      return exif_orientation(&buf[pos + 10], length - 8);
+    }
+    pos += 2 + length;
+  }
+  return 1;
+}
+
+// Decode a JPEG image from a buffer using libjpeg-turbo's SIMD decoder.
+// The output layout matches opencv_decode (interleaved BGR or gray).
+// Returns false for anything it cannot handle (non-JPEG, CMYK, EXIF
+// orientation, corrupt) so that the caller can fall back to OpenCV, which
+// rotates and flips images as their EXIF orientation asks.
+bool turbojpeg_decode(El::Matrix<uint8_t>& buf,
+                      El::Matrix<uint8_t>& dst,
+                      std::vector<size_t>& dims)
+{
+  const size_t encoded_size = buf.Height() * buf.Width();
+  const uint8_t* encoded = buf.LockedBuffer();
+  if (encoded_size < 2 || encoded[0] != 0xFF || encoded[1] != 0xD8) {
+    return false;
+  }
+  if (jpeg_exif_orientation(encoded, encoded_size) != 1) {
+    return false;
+  }
+  thread_local turbojpeg_decompressor tj;
+  if (tj.handle == nullptr) {
+    return false;
+  }
+  int width, height, subsamp, colorspace;
+  if (tjDecompressHeader3(tj.handle,
+                          encoded,
+                          encoded_size,
+                          &width,
+                          &height,
+                          &subsamp,
+                          &colorspace) != 0) {
+    return false;
+  }
+  if (colorspace == TJCS_CMYK || colorspace == TJCS_YCCK) {
+    return false;
+  }
+  const bool gray = (colorspace == TJCS_GRAY);
+  dims = {gray ? 1ull : 3ull,
+          static_cast<size_t>(height),
+          static_cast<size_t>(width)};
+  utils::attach_scratch_matrix(dst, get_linear_size(dims), 1);
+  return tjDecompress2(tj.handle,
+                       encoded,
+                       encoded_size,
+                       dst.Buffer(),
+                       width,
+                       0,
+                       height,
+                       gray ? TJPF_GRAY : TJPF_BGR,
+                       0) == 0;
+}
+#endif // LBANN_HAS_TURBOJPEG
+
+// Decode an image, preferring libjpeg-turbo for JPEGs when available.
+void decode(El::Matrix<uint8_t>& buf,
+            El::Matrix<uint8_t>& dst,
+            std::vector<size_t>& dims,
+            const std::string filename)
+{
+#ifdef LBANN_HAS_TURBOJPEG
+  if (turbojpeg_decode(buf, dst, dims)) {
+    return;
+  }
+#endif // LBANN_HAS_TURBOJPEG
+  opencv_decode(buf, dst, dims, filename);
+}
+
 } // anonymous namespace
 
 void load_image(const std::string& filename,
@@ -228,14 +368,14 @@ void load_image(const std::string& filename,
   El::Matrix<uint8_t> buf;
   size_t encoded_size;
   read_file_to_buf(filename, buf, encoded_size);
-  opencv_decode(buf, dst, dims, filename);
+  decode(buf, dst, dims, filename);
 }
 
 void decode_image(El::Matrix<uint8_t>& src,
                   El::Matrix<uint8_t>& dst,
                   std::vector<size_t>& dims)
 {
-  opencv_decode(src, dst, dims, "encoded image");
+  decode(src, dst, dims, "encoded image");
 }
 
 void save_image(const std::string& filename,
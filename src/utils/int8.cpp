@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/int8.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lbann {
+
+namespace {
+
+template <typename TensorDataType>
+inline int8_t to_int8(TensorDataType x, TensorDataType inv_scale)
+{
+  const auto q = std::nearbyint(x * inv_scale);
+  return static_cast<int8_t>(
+    std::min(std::max(q, TensorDataType(-127)), TensorDataType(127)));
+}
+
+/** Entry (i,j) of op(X) */
+template <typename TensorDataType>
+inline TensorDataType op_entry(const TensorDataType* x,
+                               El::Int ldx,
+                               bool transpose,
+                               El::Int i,
+                               El::Int j)
+{
+  return transpose ? x[j + i * ldx] : x[i + j * ldx];
+}
+
+} // namespace
+
+template <typename TensorDataType>
+TensorDataType int8_scale(TensorDataType range)
+{
+  return range > TensorDataType(0) ? range / TensorDataType(127)
+                                   : TensorDataType(1);
+}
+
+template <typename TensorDataType>
+void quantize_int8(const TensorDataType* x,
+                   El::Int height,
+                   El::Int width,
+                   El::Int ldx,
+                   bool transpose,
+                   TensorDataType scale,
+                   int8_t* out,
+                   El::Int batch_count,
+                   El::Int stride_x)
+{
+  const El::Int op_height = transpose ? width : height;
+  const El::Int op_width = transpose ? height : width;
+  const TensorDataType inv_scale = TensorDataType(1) / scale;
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int b = 0; b < batch_count; ++b) {
+    for (El::Int j = 0; j < op_width; ++j) {
+      const TensorDataType* x_b = x + b * stride_x;
+      int8_t* out_col = out + b * op_height * op_width + j * op_height;
+      for (El::Int i = 0; i < op_height; ++i) {
+        out_col[i] = to_int8(op_entry(x_b, ldx, transpose, i, j), inv_scale);
+      }
+    }
+  }
+}
+
+template <typename TensorDataType>
+void quantize_int8_columns(const TensorDataType* x,
+                           El::Int height,
+                           El::Int width,
+                           El::Int ldx,
+                           bool transpose,
+                           TensorDataType* scales,
+                           int8_t* out)
+{
+  const El::Int op_height = transpose ? width : height;
+  const El::Int op_width = transpose ? height : width;
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int j = 0; j < op_width; ++j) {
+    TensorDataType range = 0;
+    for (El::Int i = 0; i < op_height; ++i) {
+      range = std::max(range, std::abs(op_entry(x, ldx, transpose, i, j)));
+    }
+    scales[j] = int8_scale(range);
+    const TensorDataType inv_scale = TensorDataType(1) / scales[j];
+    for (El::Int i = 0; i < op_height; ++i) {
+      out[i + j * op_height] =
+        to_int8(op_entry(x, ldx, transpose, i, j), inv_scale);
+    }
+  }
+}
+
+template <typename TensorDataType>
+void gemm_int8(El::Int m,
+               El::Int n,
+               El::Int k,
+               TensorDataType alpha,
+               const int8_t* A,
+               El::Int stride_a,
+               const TensorDataType* a_scales,
+               const int8_t* B,
+               El::Int stride_b,
+               const TensorDataType* b_scales,
+               TensorDataType* C,
+               El::Int ldc,
+               El::Int stride_c,
+               El::Int batch_count)
+{
+  // Work items are blocks of rows in one output column, so that a
+  // column of B stays in cache while it meets a block of A
+  constexpr El::Int block_size = 64;
+  const El::Int num_blocks = (m + block_size - 1) / block_size;
+  const El::Int num_items = batch_count * n * num_blocks;
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int item = 0; item < num_items; ++item) {
+    const El::Int block = item % num_blocks;
+    const El::Int j = (item / num_blocks) % n;
+    const El::Int b = item / (num_blocks * n);
+    const int8_t* B_col = B + b * stride_b + j * k;
+    const TensorDataType col_scale =
+      alpha * (b_scales != nullptr ? b_scales[j] : TensorDataType(1));
+    TensorDataType* C_col = C + b * stride_c + j * ldc;
+    const El::Int row_end = std::min(m, (block + 1) * block_size);
+    for (El::Int i = block * block_size; i < row_end; ++i) {
+      const int8_t* A_col = A + b * stride_a + i * k;
+      int32_t sum = 0;
+      for (El::Int l = 0; l < k; ++l) {
+        sum += static_cast<int32_t>(A_col[l]) * static_cast<int32_t>(B_col[l]);
+      }
+      const TensorDataType row_scale =
+        (a_scales != nullptr ? a_scales[i] : TensorDataType(1));
+      C_col[i] = col_scale * row_scale * static_cast<TensorDataType>(sum);
+    }
+  }
+}
+
+#define PROTO(T)                                                               \
+  template T int8_scale<T>(T);                                                 \
+  template void quantize_int8<T>(const T*,                                     \
+                                 El::Int,                                      \
+                                 El::Int,                                      \
+                                 El::Int,                                      \
+                                 bool,                                         \
+                                 T,                                            \
+                                 int8_t*,                                      \
+                                 El::Int,                                      \
+                                 El::Int);                                     \
+  template void quantize_int8_columns<T>(const T*,                             \
+                                         El::Int,                              \
+                                         El::Int,                              \
+                                         El::Int,                              \
+                                         bool,                                 \
+                                         T*,                                   \
+                                         int8_t*);                             \
+  template void gemm_int8<T>(El::Int,                                          \
+                             El::Int,                                          \
+                             El::Int,                                          \
+                             T,                                                \
+                             const int8_t*,                                    \
+                             El::Int,                                          \
+                             const T*,                                         \
+                             const int8_t*,                                    \
+                             El::Int,                                          \
+                             const T*,                                         \
+                             T*,                                               \
+                             El::Int,                                          \
+                             El::Int,                                          \
+                             El::Int)
+
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
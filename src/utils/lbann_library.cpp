@@ -27,6 +27,7 @@
 #include "lbann/utils/lbann_library.hpp"
 #include "lbann/comm.hpp"
 #include "lbann/comm_impl.hpp"
+#include "lbann/data_ingestion/data_coordinator.hpp"
 #include "lbann/data_ingestion/data_reader.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/utils/exception.hpp"
@@ -38,14 +39,17 @@
 #include "lbann/callbacks/save_model.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/optimizers/gradient_fusion.hpp"
 #include "lbann/proto/factories.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
+#include "lbann/utils/threads/thread_budget.hpp"
 #include "lbann/utils/threads/thread_utils.hpp"
 
 #include "lbann/proto/lbann.pb.h"
 #include "lbann/proto/model.pb.h"
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 
@@ -65,10 +69,45 @@ std::unique_ptr<model> load_inference_model(lbann_comm* lc,
   p.close_restart();
 
   m->setup(mbs, get_trainer().get_grids());
+  m->compile_for_inference(get_trainer().get_grids());
 
   return m;
 }
 
+// Builds a model and reads its weights from a container on first use
+std::unique_ptr<model> load_inference_model(lbann_comm* lc,
+                                            lbann_data::LbannPB const& pb,
+                                            std::string const& weights_file,
+                                            int mbs)
+{
+  auto m =
+    proto::construct_model(lc, pb.optimizer(), pb.trainer(), pb.model());
+  m->load_weights_at_setup(weights_file);
+  m->setup(mbs, get_trainer().get_grids());
+  m->compile_for_inference(get_trainer().get_grids());
+  return m;
+}
+
+// Loads models from checkpoints and runs them together on shared streams
+std::unique_ptr<ensemble_inference>
+load_inference_ensemble(lbann_comm* lc,
+                        std::vector<std::string> const& cp_dirs,
+                        int mbs,
+                        std::vector<int> input_dims,
+                        std::vector<int> output_dims,
+                        size_t num_streams)
+{
+  const std::vector<El::Int> in_dims(input_dims.begin(), input_dims.end());
+  const std::vector<El::Int> out_dims(output_dims.begin(), output_dims.end());
+  std::vector<std::unique_ptr<model>> models;
+  for (const auto& cp_dir : cp_dirs) {
+    models.push_back(load_inference_model(lc, cp_dir, mbs, in_dims, out_dims));
+  }
+  return std::make_unique<ensemble_inference>(std::move(models),
+                                              get_trainer().get_grids(),
+                                              num_streams);
+}
+
 /// Split the MPI communicator into trainers
 /// Return the
 int allocate_trainer_resources(lbann_comm* comm)
@@ -85,6 +124,8 @@ int allocate_trainer_resources(lbann_comm* comm)
     arg_parser.get<bool>(LBANN_OPTION_TRAINER_ENABLE_SUBGRID_ASYNC_COMM);
   bool trainer_topo_aware_subgrid =
     arg_parser.get<bool>(LBANN_OPTION_TRAINER_ENABLE_TOPO_AWARE_SUBGRID);
+  bool trainer_topology_aware =
+    arg_parser.get<bool>(LBANN_OPTION_TRAINER_TOPOLOGY_AWARE);
 
   if (procs_per_trainer == 0) {
     procs_per_trainer = comm->get_procs_in_world();
@@ -94,8 +135,11 @@ int allocate_trainer_resources(lbann_comm* comm)
   // We do not currently support splitting different trainers in different ways,
   // as this implies different grids.
   if (procs_per_trainer != comm->get_procs_per_trainer() ||
-      trainer_grid_height != comm->get_trainer_grid().Height()) {
-    comm->split_trainers(procs_per_trainer, trainer_grid_height);
+      trainer_grid_height != comm->get_trainer_grid().Height() ||
+      trainer_topology_aware) {
+    comm->split_trainers(procs_per_trainer,
+                         trainer_grid_height,
+                         trainer_topology_aware);
   }
 
   // Split trainer when sub-grid parallelism is enabled
@@ -153,6 +197,10 @@ trainer& construct_trainer(lbann_comm* comm,
   auto num_omp_threads = arg_parser.get<int>(LBANN_OPTION_OMP_NUM_THREADS);
   omp_set_num_threads(num_omp_threads);
 
+  // Divide the rank's CPUs between OpenMP, I/O threads and Python
+  // workers, if a thread budget policy is selected
+  setup_thread_budget(*comm);
+
   // Check to see if the model wants to reduce the I/O parallelism
   bool const serialized_io = pb_trainer->serialize_io();
   if (comm->am_trainer_master()) {
@@ -175,6 +223,13 @@ trainer& construct_trainer(lbann_comm* comm,
     El::SetBlocksize(pb_trainer->hydrogen_block_size());
   }
 
+  // Set the size of the fused gradient allreduces
+  set_gradient_fusion_bucket_size(
+    std::max(pb_trainer->gradient_fusion_bucket_size(), int64_t{0}));
+  set_gradient_allreduce_algorithm(pb_trainer->hierarchical_gradient_allreduce()
+                                     ? allreduce_algorithm::hierarchical
+                                     : allreduce_algorithm::flat);
+
   // Display how the OpenMP threads are provisioned
   // if (opts->has_string("print_affinity")) {
   //   display_omp_setup();
@@ -301,6 +356,11 @@ trainer& construct_trainer(lbann_comm* comm,
   std::map<execution_mode, generic_data_reader*> data_readers;
   init_data_readers(comm, pb, data_readers);
 
+  if (pb.data_reader().num_io_buffers() > 0) {
+    global_trainer_->get_data_coordinator().set_num_io_buffers(
+      pb.data_reader().num_io_buffers());
+  }
+
   global_trainer_->setup(std::move(io_thread_pool), data_readers);
 
   if (arg_parser.get<bool>(LBANN_OPTION_DISABLE_BACKGROUND_IO_ACTIVITY)) {
@@ -365,7 +425,9 @@ trainer& construct_trainer(lbann_comm* comm,
 std::unique_ptr<thread_pool> construct_io_thread_pool(lbann_comm* comm,
                                                       bool serialized_io)
 {
-  int max_io_threads = num_free_cores_per_process(comm);
+  thread_budget const* budget = get_thread_budget();
+  int max_io_threads = (budget != nullptr ? budget->num_io_threads
+                                          : num_free_cores_per_process(comm));
   // Allow the trainer to override the command-line option or environment
   // variable
   if (serialized_io) {
@@ -385,15 +447,25 @@ std::unique_ptr<thread_pool> construct_io_thread_pool(lbann_comm* comm,
 
   auto io_threads_offset = free_core_offset(comm);
 
-  if (comm->am_world_master()) {
-    std::cout << "\tNum. I/O Threads: " << num_io_threads
-              << " (Limited to # Unused Compute Cores [" << max_io_threads
-              << "] # of RNG banks [" << max_io_rng_banks
-              << "] or 1) at offset " << io_threads_offset << std::endl;
-  }
-
   auto io_thread_pool = std::make_unique<thread_pool>();
-  io_thread_pool->launch_pinned_threads(num_io_threads, io_threads_offset);
+  if (budget != nullptr) {
+    if (comm->am_world_master()) {
+      std::cout << "\tNum. I/O Threads: " << num_io_threads
+                << " (Limited to thread budget [" << max_io_threads
+                << "] # of RNG banks [" << max_io_rng_banks << "] or 1)"
+                << std::endl;
+    }
+    io_thread_pool->launch_bound_threads(num_io_threads, budget->io_cpus);
+  }
+  else {
+    if (comm->am_world_master()) {
+      std::cout << "\tNum. I/O Threads: " << num_io_threads
+                << " (Limited to # Unused Compute Cores [" << max_io_threads
+                << "] # of RNG banks [" << max_io_rng_banks
+                << "] or 1) at offset " << io_threads_offset << std::endl;
+    }
+    io_thread_pool->launch_pinned_threads(num_io_threads, io_threads_offset);
+  }
 
   return io_thread_pool;
 }
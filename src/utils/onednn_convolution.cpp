@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/dnn_lib/onednn/convolution.hpp"
+#include "lbann/utils/dim_helpers.hpp"
+#include "lbann/utils/exception.hpp"
+
+#ifdef LBANN_HAS_ONEDNN
+namespace lbann {
+namespace onednn {
+namespace {
+
+/** (N, dims...) */
+dnnl::memory::dims make_tensor_dims(int mini_batch_size,
+                                    std::vector<int> const& dims)
+{
+  dnnl::memory::dims out{mini_batch_size};
+  out.insert(out.end(), dims.cbegin(), dims.cend());
+  return out;
+}
+
+/** Packed samples, one per column, @c ldim entries apart. */
+dnnl::memory::desc make_matrix_desc(dnnl::memory::dims const& dims,
+                                    El::Int ldim,
+                                    dnnl::memory::data_type dt)
+{
+  auto strides = get_packed_strides(dims);
+  strides.front() = ldim;
+  return dnnl::memory::desc(dims, dt, strides);
+}
+
+/** Let the primitive choose the layout, e.g. a blocked format. */
+dnnl::memory::desc make_any_desc(dnnl::memory::desc const& md)
+{
+  return dnnl::memory::desc(md.dims(),
+                            md.data_type(),
+                            dnnl::memory::format_tag::any);
+}
+
+} // namespace
+
+void staged_memory::setup(dnnl::memory::desc const& user_md,
+                          dnnl::memory::desc const& primitive_md,
+                          dnnl::engine const& engine,
+                          bool is_input)
+{
+  m_engine = engine;
+  m_user_md = user_md;
+  m_needs_reorder = (user_md != primitive_md);
+  if (m_needs_reorder) {
+    m_primitive_memory = dnnl::memory(primitive_md, engine);
+    auto const& src_md = (is_input ? user_md : primitive_md);
+    auto const& dst_md = (is_input ? primitive_md : user_md);
+    m_reorder = dnnl::reorder(
+      dnnl::reorder::primitive_desc(engine, src_md, engine, dst_md));
+  }
+}
+
+dnnl::memory staged_memory::import(dnnl::stream& stream,
+                                   void const* buffer) const
+{
+  dnnl::memory user(m_user_md, m_engine, const_cast<void*>(buffer));
+  if (!m_needs_reorder) {
+    return user;
+  }
+  auto primitive_memory = m_primitive_memory;
+  m_reorder.execute(stream, user, primitive_memory);
+  return primitive_memory;
+}
+
+dnnl::memory staged_memory::output(void* buffer) const
+{
+  if (m_needs_reorder) {
+    return m_primitive_memory;
+  }
+  return dnnl::memory(m_user_md, m_engine, buffer);
+}
+
+void staged_memory::finish_output(dnnl::stream& stream,
+                                  dnnl::memory& primitive_memory,
+                                  void* buffer) const
+{
+  if (m_needs_reorder) {
+    dnnl::memory user(m_user_md, m_engine, buffer);
+    m_reorder.execute(stream, primitive_memory, user);
+  }
+}
+
+template <typename T>
+convolution_primitives<T>::convolution_primitives(convolution_geometry geom)
+  : m_geom(std::move(geom)), m_engine(get_device_engine<El::Device::CPU>())
+{
+  auto const dt = get_data_type<T>();
+  auto const& g = m_geom;
+  auto const num_spatial_dims = g.src_dims.size() - 1;
+
+  // Convolution parameters. oneDNN counts dilation from zero.
+  m_strides.assign(g.strides.cbegin(), g.strides.cend());
+  m_pads.assign(g.pads.cbegin(), g.pads.cend());
+  m_dilations.resize(num_spatial_dims);
+  for (size_t i = 0; i < num_spatial_dims; ++i) {
+    m_dilations[i] = g.dilations[i] - 1;
+  }
+
+  // Tensors in LBANN's layout. Grouped kernels are already stored
+  // group-major, so splitting the leading dimension is free.
+  auto const src_dims = make_tensor_dims(g.mini_batch_size, g.src_dims);
+  auto const dst_dims = make_tensor_dims(g.mini_batch_size, g.dst_dims);
+  dnnl::memory::dims weights_dims(g.kernel_dims.cbegin(),
+                                  g.kernel_dims.cend());
+  if (g.groups > 1) {
+    weights_dims.front() /= g.groups;
+    weights_dims.insert(weights_dims.begin(), g.groups);
+  }
+  m_src_md = make_matrix_desc(src_dims, g.src_ldim, dt);
+  m_dst_md = make_matrix_desc(dst_dims, g.dst_ldim, dt);
+  m_weights_md =
+    dnnl::memory::desc(weights_dims, dt, get_packed_strides(weights_dims));
+
+  // Forward primitive
+  dnnl::convolution_forward::desc fwd_desc(
+    dnnl::prop_kind::forward_training,
+    dnnl::algorithm::convolution_direct,
+    make_any_desc(m_src_md),
+    make_any_desc(m_weights_md),
+    make_any_desc(m_dst_md),
+    m_strides,
+    m_dilations,
+    m_pads,
+    m_pads);
+  m_fwd_pd = dnnl::convolution_forward::primitive_desc(fwd_desc, m_engine);
+  m_fwd = dnnl::convolution_forward(m_fwd_pd);
+  m_fwd_src.setup(m_src_md, m_fwd_pd.src_desc(), m_engine, true);
+  m_fwd_weights.setup(m_weights_md, m_fwd_pd.weights_desc(), m_engine, true);
+  m_fwd_dst.setup(m_dst_md, m_fwd_pd.dst_desc(), m_engine, false);
+}
+
+template <typename T>
+void convolution_primitives<T>::setup_backward_data()
+{
+  dnnl::convolution_backward_data::desc desc(
+    dnnl::algorithm::convolution_direct,
+    make_any_desc(m_src_md),
+    make_any_desc(m_weights_md),
+    make_any_desc(m_dst_md),
+    m_strides,
+    m_dilations,
+    m_pads,
+    m_pads);
+  dnnl::convolution_backward_data::primitive_desc pd(desc,
+                                                      m_engine,
+                                                      m_fwd_pd);
+  m_bwd_data = dnnl::convolution_backward_data(pd);
+  m_bwd_data_diff_dst.setup(m_dst_md, pd.diff_dst_desc(), m_engine, true);
+  m_bwd_data_weights.setup(m_weights_md, pd.weights_desc(), m_engine, true);
+  m_bwd_data_diff_src.setup(m_src_md, pd.diff_src_desc(), m_engine, false);
+  m_has_bwd_data = true;
+}
+
+template <typename T>
+void convolution_primitives<T>::setup_backward_weights()
+{
+  dnnl::convolution_backward_weights::desc desc(
+    dnnl::algorithm::convolution_direct,
+    make_any_desc(m_src_md),
+    make_any_desc(m_weights_md),
+    make_any_desc(m_dst_md),
+    m_strides,
+    m_dilations,
+    m_pads,
+    m_pads);
+  dnnl::convolution_backward_weights::primitive_desc pd(desc,
+                                                         m_engine,
+                                                         m_fwd_pd);
+  m_bwd_weights = dnnl::convolution_backward_weights(pd);
+  m_bwd_weights_src.setup(m_src_md, pd.src_desc(), m_engine, true);
+  m_bwd_weights_diff_dst.setup(m_dst_md, pd.diff_dst_desc(), m_engine, true);
+  m_bwd_weights_diff_weights.setup(m_weights_md,
+                                   pd.diff_weights_desc(),
+                                   m_engine,
+                                   false);
+  m_has_bwd_weights = true;
+}
+
+template <typename T>
+void convolution_primitives<T>::forward(T const* src,
+                                        T const* weights,
+                                        T* dst)
+{
+  dnnl::stream stream(m_engine);
+  auto src_mem = m_fwd_src.import(stream, src);
+  auto weights_mem = m_fwd_weights.import(stream, weights);
+  auto dst_mem = m_fwd_dst.output(dst);
+  m_fwd.execute(stream,
+                {{DNNL_ARG_SRC, src_mem},
+                 {DNNL_ARG_WEIGHTS, weights_mem},
+                 {DNNL_ARG_DST, dst_mem}});
+  m_fwd_dst.finish_output(stream, dst_mem, dst);
+  stream.wait();
+}
+
+template <typename T>
+void convolution_primitives<T>::backward_data(T const* diff_dst,
+                                              T const* weights,
+                                              T* diff_src)
+{
+  if (!m_has_bwd_data) {
+    setup_backward_data();
+  }
+  dnnl::stream stream(m_engine);
+  auto diff_dst_mem = m_bwd_data_diff_dst.import(stream, diff_dst);
+  auto weights_mem = m_bwd_data_weights.import(stream, weights);
+  auto diff_src_mem = m_bwd_data_diff_src.output(diff_src);
+  m_bwd_data.execute(stream,
+                     {{DNNL_ARG_DIFF_DST, diff_dst_mem},
+                      {DNNL_ARG_WEIGHTS, weights_mem},
+                      {DNNL_ARG_DIFF_SRC, diff_src_mem}});
+  m_bwd_data_diff_src.finish_output(stream, diff_src_mem, diff_src);
+  stream.wait();
+}
+
+template <typename T>
+void convolution_primitives<T>::backward_weights(T const* src,
+                                                 T const* diff_dst,
+                                                 T* diff_weights)
+{
+  if (!m_has_bwd_weights) {
+    setup_backward_weights();
+  }
+  dnnl::stream stream(m_engine);
+  auto src_mem = m_bwd_weights_src.import(stream, src);
+  auto diff_dst_mem = m_bwd_weights_diff_dst.import(stream, diff_dst);
+  auto diff_weights_mem = m_bwd_weights_diff_weights.output(diff_weights);
+  m_bwd_weights.execute(stream,
+                        {{DNNL_ARG_SRC, src_mem},
+                         {DNNL_ARG_DIFF_DST, diff_dst_mem},
+                         {DNNL_ARG_DIFF_WEIGHTS, diff_weights_mem}});
+  m_bwd_weights_diff_weights.finish_output(stream,
+                                           diff_weights_mem,
+                                           diff_weights);
+  stream.wait();
+}
+
+template class convolution_primitives<float>;
+
+} // namespace onednn
+} // namespace lbann
+#endif // LBANN_HAS_ONEDNN
@@ -146,6 +146,14 @@ void construct_std_options()
     "Additionally, sets the output directory for dumping weights.\n"
     "Modifies callbacks: checkpoint, save_model, dump_weights\n",
     "");
+  arg_parser.add_option(
+    LBANN_OPTION_CONV_ALGO_CACHE,
+    {"--conv_algo_cache"},
+    utils::ENV("LBANN_CONV_ALGO_CACHE"),
+    "[STD] File that stores autotuned convolution algorithms.\n"
+    "Entries are reused by later runs on the same GPU model and\n"
+    "DNN library version. The world master appends new entries.\n",
+    "");
   arg_parser.add_option(LBANN_OPTION_HYDROGEN_BLOCK_SIZE,
                         {"--hydrogen_block_size"},
                         "[STD] Block size for Hydrogen",
@@ -194,6 +202,23 @@ void construct_std_options()
     "[STD] Maximum number of random number generator banks available to "
     "both I/O and initial data transformations for each rank. (Default: 128)",
     128);
+  arg_parser.add_option(
+    LBANN_OPTION_NUM_PYTHON_WORKERS,
+    {"--num_python_workers"},
+    utils::ENV("LBANN_NUM_PYTHON_WORKERS"),
+    "[STD] Number of worker processes for the Python dataset reader. "
+    "0 uses one worker per I/O thread. (Default: 0)",
+    0);
+  arg_parser.add_option(
+    LBANN_OPTION_THREAD_BUDGET_POLICY,
+    {"--thread_budget"},
+    utils::ENV("LBANN_THREAD_BUDGET"),
+    "[STD] Divide each rank's CPUs between OpenMP, I/O threads and "
+    "Python workers and bind them accordingly. When the requests do not "
+    "fit, \"compute\" favors OpenMP, \"io\" favors I/O and Python, and "
+    "\"balanced\" shrinks all requests proportionally. \"none\" lets "
+    "each size itself. (Default: none)",
+    "none");
   arg_parser.add_option(
     LBANN_OPTION_OMP_NUM_THREADS,
     {"--omp_num_threads"},
@@ -206,6 +231,14 @@ void construct_std_options()
                         {"--optimizer"},
                         "[STD] Optimizer input file",
                         "");
+  arg_parser.add_option(
+    LBANN_OPTION_PREALLOCATE_MEMORY_POOL,
+    {"--preallocate_memory_pool"},
+    utils::ENV("LBANN_PREALLOCATE_MEMORY_POOL"),
+    "[STD] After the first training step measures the high-water mark "
+    "of the GPU memory pool, preallocate this fraction of extra blocks "
+    "in each of its bins. Negative disables. (Default: -1)",
+    (float)-1);
   arg_parser.add_option(LBANN_OPTION_PROCS_PER_TRAINER,
                         {"--procs_per_trainer"},
                         utils::ENV("LBANN_PROCS_PER_TRAINER"),
@@ -270,6 +303,14 @@ void construct_std_options()
     "Enable topology aware process placement in sub-grid parallelism. "
     "Default is False.",
     false);
+  arg_parser.add_option(
+    LBANN_OPTION_TRAINER_TOPOLOGY_AWARE,
+    {"--trainer_topology_aware"},
+    utils::ENV("LBANN_TRAINER_TOPOLOGY_AWARE"),
+    "Assign ranks to trainers by network location (LBANN_TOPOLOGY_ADDR, "
+    "SLURM_TOPOLOGY_ADDR or host name) so each trainer spans as few "
+    "switches as possible. Default is False.",
+    false);
   arg_parser.add_option(LBANN_OPTION_NUM_SUBGRIDS_BLOCK_ORDER,
                         {"--num-subgrids", "--num-subgrids-block-order"},
                         utils::ENV("LBANN_NUM_SUBGRIDS"),
@@ -299,15 +340,32 @@ void construct_datastore_options()
                       {"--data_store_debug"},
                       "[DATASTORE] Enables data store debug output for each "
                       "<rank, reader_role> pair");
+  arg_parser.add_flag(
+    LBANN_OPTION_DATA_STORE_DECODED_IMAGES,
+    {"--data_store_decoded_images"},
+    "[DATASTORE] Store images decoded, after the leading deterministic "
+    "transforms (e.g. resize), so later epochs skip decoding; not "
+    "supported with --data_store_cache");
   arg_parser.add_flag(
     LBANN_OPTION_DATA_STORE_FAIL,
     {"--data_store_fail"},
     "[DATASTORE] Forces data store to fail, used for testing purposes");
+  arg_parser.add_flag(
+    LBANN_OPTION_DATA_STORE_FIXED_RECORDS,
+    {"--data_store_fixed_records"},
+    "[DATASTORE] Store fixed-size samples as raw records in a slab instead "
+    "of one conduit node per sample, and exchange them with one message "
+    "per peer");
   arg_parser.add_flag(
     LBANN_OPTION_DATA_STORE_MIN_MAX_TIMING,
     {"--data_store_min_max_timing"},
     "[DATASTORE] Enables data store min and max times output to profile for "
     "various data store operations, data store profiling must be enabled");
+  arg_parser.add_flag(
+    LBANN_OPTION_DATA_STORE_NODE_AGGREGATION,
+    {"--data_store_node_aggregation"},
+    "[DATASTORE] Coalesce the mini-batch data exchange into one message "
+    "per remote node, forwarded within that node to its final destination");
   arg_parser.add_flag(LBANN_OPTION_DATA_STORE_NO_THREAD,
                       {"--data_store_no_thread"},
                       "[DATASTORE] Disables data store I/O multi-threading");
@@ -325,6 +383,25 @@ void construct_datastore_options()
     "[DATASTORE] Allows Conduit data store nodes to have non-uniform sizes");
 
   // Input options
+  arg_parser.add_option(
+    LBANN_OPTION_DATA_STORE_COMPRESSION_FIELDS,
+    {"--data_store_compression_fields"},
+    "[DATASTORE] Comma-separated list of conduit field names whose data "
+    "is compressed in the data store; if empty, every field is compressed",
+    "");
+  arg_parser.add_option(
+    LBANN_OPTION_DATA_STORE_COMPRESSION_LEVEL,
+    {"--data_store_compression_level"},
+    "[DATASTORE] zlib compression level (1-9) for samples held in the "
+    "data store; 0 disables compression",
+    0);
+  arg_parser.add_option(
+    LBANN_OPTION_DATA_STORE_SHUFFLE_LOCALITY,
+    {"--data_store_shuffle_locality"},
+    "[DATASTORE] Fraction (0-1) of each mini-batch to draw from samples "
+    "owned by the rank that consumes them when shuffling with a data "
+    "store; 0 uses a global shuffle",
+    (float)0);
   arg_parser.add_option(
     LBANN_OPTION_DATA_STORE_SPILL,
     {"--data_store_spill"},
@@ -356,15 +433,36 @@ void construct_datareader_options()
     LBANN_OPTION_KEEP_PACKED_FIELDS,
     {"--keep_packed_fields"},
     "[DATAREADER] Prevents packed fields deletion in HDF5 data reader");
+  arg_parser.add_flag(
+    LBANN_OPTION_HDF5_CORE_DRIVER,
+    {"--hdf5_core_driver"},
+    "[DATAREADER] While preloading, the HDF5 data reader reads each file "
+    "into memory with one large read instead of many small per-field reads");
   arg_parser.add_flag(
     LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE,
     {"--load_full_sample_list_once"},
     "[DATAREADER] Trainer master will load entire sample list into memory and "
     "then broadcast it to other workers within the trainer");
+  arg_parser.add_flag(
+    LBANN_OPTION_NODE_SHARED_NUMPY,
+    {"--node_shared_numpy"},
+    "[DATAREADER] The numpy and numpy_npz readers load their arrays once per "
+    "node into shared memory and read samples directly from it");
+  arg_parser.add_flag(
+    LBANN_OPTION_NODE_SHARED_SAMPLE_LIST,
+    {"--node_shared_sample_list"},
+    "[DATAREADER] Build the index of an inclusive or single-sample list once "
+    "per node in shared memory; every trainer on the node that uses the same "
+    "list parses only its own partition from it");
   arg_parser.add_flag(
     LBANN_OPTION_QUIET,
     {"--quiet"},
     "[DATAREADER] Silences metadata output from HDF5 datareader");
+  arg_parser.add_flag(
+    LBANN_OPTION_SORT_MINI_BATCH_BY_FILE,
+    {"--sort_mini_batch_by_file"},
+    "[DATAREADER] Sample list readers order each rank's share of a "
+    "mini-batch by file, so that consecutive fetches reuse open files");
   arg_parser.add_flag(LBANN_OPTION_WRITE_SAMPLE_LABEL_LIST,
                       {"--write_sample_label_list"},
                       "[DATAREADER] When enabled, the sample labels from image "
@@ -384,6 +482,13 @@ void construct_datareader_options()
                         {"--absolute_sample_count"},
                         "[DATAREADER] Number of data samples to use",
                         -1);
+  arg_parser.add_option(LBANN_OPTION_CSV_BINARY_CACHE,
+                        {"--csv_binary_cache"},
+                        "[DATAREADER] Directory for binary caches of parsed "
+                        "CSV data. A missing cache is written on first use; "
+                        "rows are then fetched from the memory-mapped cache "
+                        "instead of being re-parsed.",
+                        "");
   arg_parser.add_option(
     LBANN_OPTION_DATA_FILEDIR,
     {"--data_filedir"},
@@ -419,6 +524,13 @@ void construct_datareader_options()
     {"--data_reader_fraction"},
     "[DATAREADER] Sets the fraction of total samples to use",
     (float)-1);
+  arg_parser.add_option(
+    LBANN_OPTION_HDF5_COMPUTE_NORMALIZATION,
+    {"--hdf5_compute_normalization"},
+    "[DATAREADER] The HDF5 training data reader computes the scale and bias "
+    "of every field marked 'normalize: true' in one distributed pass over "
+    "the data set and writes the updated experiment schema to this file",
+    "");
   arg_parser.add_option(
     LBANN_OPTION_LABEL_FILENAME_TEST,
     {"--label_filename_test"},
@@ -434,6 +546,19 @@ void construct_datareader_options()
     {"--label_filename_validate"},
     "[DATAREADER] Sets the filename for validation data labels",
     "");
+  arg_parser.add_option(
+    LBANN_OPTION_LENGTH_BUCKET_SIZE,
+    {"--length_bucket_size"},
+    "[DATAREADER] Readers of variable-length samples sort each run of this "
+    "many shuffled samples by length, so that mini-batches group similar "
+    "lengths; 0 disables bucketing",
+    0);
+  arg_parser.add_option(
+    LBANN_OPTION_MAX_OPEN_FILES,
+    {"--max_open_files"},
+    "[DATAREADER] Number of data files each sample list keeps open for "
+    "reuse; 0 lets it use the process's file descriptor limit",
+    0);
   arg_parser.add_option(LBANN_OPTION_NORMALIZATION,
                         {"--normalization"},
                         "[DATAREADER] Sets the filename for normalization data "
@@ -475,6 +600,19 @@ void construct_datareader_options()
                         "[DATAREADER] Size of the read buffer for the SMILES "
                         "data reader.",
                         16 * 1024 * 1024UL);
+  arg_parser.add_option(LBANN_OPTION_SMILES_TOKEN_CACHE,
+                        {"--smiles_token_cache"},
+                        "[DATAREADER] Directory for pretokenized SMILES "
+                        "caches. Caches that are missing are built on first "
+                        "use; samples are then fetched from the memory-mapped "
+                        "caches instead of being re-tokenized.",
+                        "");
+  arg_parser.add_option(
+    LBANN_OPTION_STREAM_SHUFFLE_BUFFER_SIZE,
+    {"--stream_shuffle_buffer_size"},
+    "[DATAREADER] Number of samples that streaming data readers hold in "
+    "their shuffle buffer; larger buffers shuffle more thoroughly",
+    65536);
   arg_parser.add_option(LBANN_OPTION_VOCAB,
                         {"--vocab"},
                         "[DATAREADER] Sets the filename containing the "
@@ -73,6 +73,16 @@ bool save_rng_to_checkpoint(persist& p, lbann_comm* comm, bool is_distributed)
     }
     rng_EL << El::Generator();
     rng_EL.close();
+
+    // Lets a restart on more ranks tell which streams were never saved
+    rng_name = dirname + "/procs_per_trainer";
+    std::ofstream rng_ranks(rng_name);
+    if (!rng_ranks) {
+      LBANN_ERROR("Failed to open ", rng_name);
+    }
+    rng_ranks << (comm == nullptr ? El::mpi::Size(El::mpi::COMM_WORLD)
+                                  : comm->get_procs_per_trainer());
+    rng_ranks.close();
   }
 
   for (int i = 0; i < get_num_io_generators(); i++) {
@@ -187,12 +197,17 @@ bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm)
   }
   rng_EL >> El::Generator();
 
-  std::string rank_in_trainer;
-  if (comm == nullptr) {
-    rank_in_trainer = std::to_string(El::mpi::Rank(El::mpi::COMM_WORLD));
-  }
-  else {
-    rank_in_trainer = std::to_string(comm->get_rank_in_trainer());
+  int const rank = (comm == nullptr ? El::mpi::Rank(El::mpi::COMM_WORLD)
+                                     : comm->get_rank_in_trainer());
+  std::string const rank_in_trainer = std::to_string(rank);
+
+  // A checkpoint written by fewer ranks has no per-rank streams for
+  // the added ranks, which keep the generators seeded at startup.
+  // Older checkpoints do not record the count and always have them.
+  int writer_ranks = 0;
+  std::ifstream rng_ranks(dirname + "/procs_per_trainer");
+  if ((rng_ranks >> writer_ranks) && rank >= writer_ranks) {
+    return true;
   }
 
   for (int i = 0; i < get_num_io_generators(); i++) {
@@ -266,6 +281,25 @@ bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm)
   return true;
 }
 
+#ifdef LBANN_HAS_GPU
+namespace {
+
+/** @brief Seed for a counter-based fill of a matrix on @c grid.
+ *
+ *  Drawn from the generator of the grid's first rank so that every
+ *  rank generates its local entries from the same sequence.
+ */
+uint64_t get_device_fill_seed(El::Grid const& grid)
+{
+  auto& gen = get_generator();
+  uint64_t seed = (uint64_t(gen()) << 32) | (uint64_t(gen()) & 0xFFFFFFFFull);
+  El::mpi::Broadcast(seed, 0, grid.Comm(), El::SyncInfo<El::Device::CPU>{});
+  return seed;
+}
+
+} // namespace
+#endif // LBANN_HAS_GPU
+
 template <typename TensorDataType>
 void gaussian_fill(El::AbstractDistMatrix<TensorDataType>& mat,
                    El::Int m,
@@ -301,6 +335,14 @@ void uniform_fill(El::AbstractDistMatrix<TensorDataType>& mat,
                   TensorDataType radius)
 {
 #ifndef LBANN_DETERMINISTIC
+#ifdef LBANN_HAS_GPU
+  // Generate GPU matrices in place instead of on the host
+  if (mat.GetLocalDevice() == El::Device::GPU) {
+    mat.Resize(m, n);
+    uniform_fill_gpu(mat, center, radius, get_device_fill_seed(mat.Grid()));
+    return;
+  }
+#endif // LBANN_HAS_GPU
   El::Uniform(mat, m, n, center, radius);
 #else
   uniform_fill_procdet(mat, m, n, center, radius);
@@ -446,6 +488,16 @@ void gaussian_fill_parallel(El::AbstractDistMatrix<TensorDataType>& mat,
   // Resize matrix
   mat.Resize(m, n);
 
+#ifdef LBANN_HAS_GPU
+  // Generate GPU matrices in place instead of on the host. Entries
+  // depend only on their global position, so redundant copies agree
+  // without a broadcast.
+  if (mat.GetLocalDevice() == El::Device::GPU) {
+    gaussian_fill_gpu(mat, mean, stddev, get_device_fill_seed(mat.Grid()));
+    return;
+  }
+#endif // LBANN_HAS_GPU
+
   // Nothing to be done if there is no local data
   if (mat.LockedMatrix().IsEmpty()) {
     return;
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/hash.hpp"
+#include "lbann/utils/profiling.hpp"
+#include "lbann/utils/random.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** Uniform value in (0,1] from the upper bits of a hash */
+template <typename RandDataType>
+__device__ __forceinline__ RandDataType to_unit(uint64_t bits)
+{
+  if constexpr (std::is_same_v<RandDataType, double>) {
+    return (static_cast<double>(bits >> 11) + 1.) * (1. / 9007199254740992.);
+  }
+  else {
+    return (static_cast<float>(bits >> 40) + 1.f) * (1.f / 16777216.f);
+  }
+}
+
+/** Generates the local entries of a distributed matrix.
+ *
+ *  Each entry is a function of the seed and its global position, so
+ *  the matrix is the same for any grid and distribution.
+ *
+ *  Block dimensions: bsizex x bsizey x 1
+ *
+ *  Grid dimensions: (local_height / bsizex) x (local_width / bsizey) x 1
+ */
+template <bool Gaussian, typename RandDataType, typename TensorDataType>
+__global__ void fill_kernel(El::Int local_height,
+                            El::Int local_width,
+                            El::Int global_height,
+                            El::Int col_shift,
+                            El::Int col_stride,
+                            El::Int row_shift,
+                            El::Int row_stride,
+                            uint64_t seed,
+                            RandDataType shift,
+                            RandDataType scale,
+                            TensorDataType* __restrict__ buffer,
+                            El::Int ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  for (El::Int col = gidy; col < local_width; col += nthreadsy) {
+    const El::Int global_col = row_shift + col * row_stride;
+    for (El::Int row = gidx; row < local_height; row += nthreadsx) {
+      const El::Int global_row = col_shift + row * col_stride;
+      const uint64_t bits =
+        splitmix64(seed + global_row + global_col * global_height);
+      const auto u1 = to_unit<RandDataType>(bits);
+      RandDataType x;
+      if constexpr (Gaussian) {
+        // Box-Muller transform of two hashed uniforms
+        const auto u2 = to_unit<RandDataType>(splitmix64(bits));
+        x = sqrt(RandDataType(-2) * log(u1)) * cospi(RandDataType(2) * u2);
+      }
+      else {
+        // Map (0,1] to [-1,1)
+        x = RandDataType(1) - RandDataType(2) * u1;
+      }
+      buffer[row + col * ldim] = TensorDataType(shift + scale * x);
+    }
+  }
+}
+
+template <bool Gaussian, typename TensorDataType>
+void fill_gpu(El::AbstractDistMatrix<TensorDataType>& mat,
+              TensorDataType shift,
+              TensorDataType scale,
+              uint64_t seed)
+{
+  using RandDataType =
+    std::conditional_t<std::is_same_v<TensorDataType, double>, double, float>;
+  const El::Int local_height = mat.LocalHeight();
+  const El::Int local_width = mat.LocalWidth();
+  if (local_height <= 0 || local_width <= 0) {
+    return;
+  }
+  constexpr size_t block_size_x = 256;
+  constexpr size_t block_size_y = 1;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size_x;
+  block_dims.y = block_size_y;
+  grid_dims.x = (local_height + block_size_x - 1) / block_size_x;
+  grid_dims.y = (local_width + block_size_y - 1) / block_size_y;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(
+    fill_kernel<Gaussian, RandDataType, TensorDataType>,
+    grid_dims,
+    block_dims,
+    0,
+    gpu::get_sync_info(mat),
+    local_height,
+    local_width,
+    mat.Height(),
+    mat.ColShift(),
+    mat.ColStride(),
+    mat.RowShift(),
+    mat.RowStride(),
+    seed,
+    static_cast<RandDataType>(shift),
+    static_cast<RandDataType>(scale),
+    mat.Buffer(),
+    mat.LDim());
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void gaussian_fill_gpu(El::AbstractDistMatrix<TensorDataType>& mat,
+                       TensorDataType mean,
+                       TensorDataType stddev,
+                       uint64_t seed)
+{
+  LBANN_CALIPER_MARK_FUNCTION;
+  fill_gpu<true>(mat, mean, stddev, seed);
+}
+
+template <typename TensorDataType>
+void uniform_fill_gpu(El::AbstractDistMatrix<TensorDataType>& mat,
+                      TensorDataType center,
+                      TensorDataType radius,
+                      uint64_t seed)
+{
+  LBANN_CALIPER_MARK_FUNCTION;
+  fill_gpu<false>(mat, center, radius, seed);
+}
+
+#ifdef LBANN_HAS_HALF
+template <>
+void gaussian_fill_gpu<cpu_fp16>(El::AbstractDistMatrix<cpu_fp16>&,
+                                 cpu_fp16,
+                                 cpu_fp16,
+                                 uint64_t)
+{
+  LBANN_ERROR("Do not call the GPU kernels with cpu_fp16!");
+}
+template <>
+void uniform_fill_gpu<cpu_fp16>(El::AbstractDistMatrix<cpu_fp16>&,
+                                cpu_fp16,
+                                cpu_fp16,
+                                uint64_t)
+{
+  LBANN_ERROR("Do not call the GPU kernels with cpu_fp16!");
+}
+#endif
+
+#define PROTO(T)                                                               \
+  template void gaussian_fill_gpu<T>(El::AbstractDistMatrix<T> & mat,          \
+                                     T mean,                                   \
+                                     T stddev,                                 \
+                                     uint64_t seed);                           \
+  template void uniform_fill_gpu<T>(El::AbstractDistMatrix<T> & mat,           \
+                                    T center,                                  \
+                                    T radius,                                  \
+                                    uint64_t seed)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
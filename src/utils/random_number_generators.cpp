@@ -71,6 +71,14 @@ bool data_seq_generator_seed_inited = false;
 thread_local size_t local_io_generators_index = 0;
 std::vector<lbann::io_rng_t> io_generators;
 bool io_generators_inited = false;
+
+// Counter-based per-sample I/O stream
+uint64_t io_sample_seed = 0;
+thread_local bool io_sample_stream_active = false;
+thread_local uint64_t io_sample_key = 0;
+thread_local uint64_t io_sample_id = 0;
+thread_local uint32_t io_sample_mode = 0;
+thread_local lbann::philox_rng io_sample_generator;
 } // namespace
 
 namespace lbann {
@@ -161,8 +169,49 @@ fast_rng_gen& get_fast_io_generator()
   return io_rng.fast_generator;
 }
 
+io_sample_stream_scope::io_sample_stream_scope(uint64_t epoch,
+                                               uint64_t sample_id,
+                                               execution_mode mode)
+{
+  if (::io_sample_stream_active) {
+    LBANN_ERROR("I/O sample streams cannot be nested");
+  }
+  // Philox key: seed in the low word, epoch in the high word.
+  ::io_sample_key = (epoch << 32) | (::io_sample_seed & 0xFFFFFFFFu);
+  ::io_sample_id = sample_id;
+  ::io_sample_mode = static_cast<uint32_t>(mode) << 24;
+  ::io_sample_stream_active = true;
+  set_io_sample_transform(0);
+}
+
+io_sample_stream_scope::~io_sample_stream_scope()
+{
+  ::io_sample_stream_active = false;
+}
+
+void set_io_sample_transform(uint32_t transform_id)
+{
+  ::io_sample_generator.reset(::io_sample_key,
+                              ::io_sample_id,
+                              ::io_sample_mode | (transform_id & 0xFFFFFFu));
+}
+
+bool is_io_sample_stream_active() { return ::io_sample_stream_active; }
+
+philox_rng& get_io_sample_generator()
+{
+  if (!::io_sample_stream_active) {
+    LBANN_ERROR("I/O sample stream accessed outside of a sample scope");
+  }
+  return ::io_sample_generator;
+}
+
 void init_random(int seed, int num_io_RNGs, lbann_comm* comm)
 {
+  // The per-sample I/O streams are keyed on sample indices, so they
+  // use the seed before it is specialized to this rank.
+  const int sample_seed = seed;
+
   generator_inited = true;
   fast_generator_inited = true;
 
@@ -199,6 +248,9 @@ void init_random(int seed, int num_io_RNGs, lbann_comm* comm)
 
   // Initialize IO RNGs
   init_io_random(seed, num_io_RNGs);
+  if (sample_seed != -1) {
+    ::io_sample_seed = static_cast<uint32_t>(sample_seed);
+  }
 }
 
 void init_data_seq_random(int seed)
@@ -241,6 +293,7 @@ void init_io_random(int seed, int num_io_RNGs)
     io_rng.fast_generator.seed(hash_combine(seed_base, i));
     io_rng.active_thread_id.store(std::thread::id());
   }
+  ::io_sample_seed = static_cast<uint32_t>(seed_base);
   ::io_generators_inited = true;
 }
 
@@ -123,8 +123,37 @@ bool event_wrapper::query() const
 
 void event_wrapper::synchronize() { CHECK_ROCM(hipEventSynchronize(m_event)); }
 
+void event_wrapper::wait(hipStream_t stream)
+{
+  CHECK_ROCM(hipStreamWaitEvent(stream, m_event, 0));
+}
+
 hipEvent_t& event_wrapper::get_event() { return m_event; }
 
+// -------------------------------------------------------------
+// timing_event
+// -------------------------------------------------------------
+
+timing_event::timing_event() : m_event(nullptr)
+{
+  CHECK_ROCM(hipEventCreate(&m_event));
+}
+
+timing_event::~timing_event() { static_cast<void>(hipEventDestroy(m_event)); }
+
+void timing_event::record(hipStream_t stream)
+{
+  CHECK_ROCM(hipEventRecord(m_event, stream));
+}
+
+float timing_event::elapsed_ms(const timing_event& start)
+{
+  CHECK_ROCM(hipEventSynchronize(m_event));
+  float ms = 0.f;
+  CHECK_ROCM(hipEventElapsedTime(&ms, start.m_event, m_event));
+  return ms;
+}
+
 // -------------------------------------------------------------
 // Helper functions for tensor operations
 // -------------------------------------------------------------
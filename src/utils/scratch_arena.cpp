@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/scratch_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace lbann {
+namespace utils {
+
+namespace {
+
+/** Smallest block the arena allocates. */
+constexpr size_t min_block_size = 1 << 20;
+
+size_t align_up(size_t x)
+{
+  return (x + scratch_arena::alignment - 1) & ~(scratch_arena::alignment - 1);
+}
+
+} // anonymous namespace
+
+void* scratch_arena::allocate(size_t bytes)
+{
+  bytes = align_up(std::max(bytes, size_t{1}));
+  // Move on to the next block that still has room, adding one if needed.
+  while (m_current < m_blocks.size() &&
+         m_offset + bytes > m_blocks[m_current].size) {
+    ++m_current;
+    m_offset = 0;
+  }
+  if (m_current == m_blocks.size()) {
+    size_t size = std::max(bytes, min_block_size);
+    if (!m_blocks.empty()) {
+      size = std::max(size, 2 * m_blocks.back().size);
+    }
+    // Over-allocate so that the usable region can be aligned.
+    m_blocks.push_back({std::make_unique<std::byte[]>(size + alignment), size});
+  }
+  auto* base = m_blocks[m_current].data.get();
+  auto* aligned = reinterpret_cast<std::byte*>(
+    align_up(reinterpret_cast<uintptr_t>(base)));
+  void* ptr = aligned + m_offset;
+  m_offset += bytes;
+  m_used += bytes;
+  return ptr;
+}
+
+void scratch_arena::reset()
+{
+  if (m_blocks.size() > 1) {
+    // Replace the blocks with one that fits everything at once.
+    const size_t size = std::max(m_used, get_capacity());
+    m_blocks.clear();
+    m_blocks.push_back({std::make_unique<std::byte[]>(size + alignment), size});
+  }
+  m_current = 0;
+  m_offset = 0;
+  m_used = 0;
+}
+
+void scratch_arena::reserve(size_t bytes)
+{
+  bytes = align_up(bytes);
+  if (is_active() || (m_blocks.size() == 1 && m_blocks[0].size >= bytes)) {
+    return;
+  }
+  // The block is value-initialized, so its pages are touched here.
+  const size_t size = std::max({bytes, min_block_size, get_capacity()});
+  m_blocks.clear();
+  m_blocks.push_back({std::make_unique<std::byte[]>(size + alignment), size});
+  m_current = 0;
+  m_offset = 0;
+  m_used = 0;
+}
+
+size_t scratch_arena::get_capacity() const noexcept
+{
+  size_t capacity = 0;
+  for (const auto& b : m_blocks) {
+    capacity += b.size;
+  }
+  return capacity;
+}
+
+scratch_arena& get_scratch_arena()
+{
+  thread_local scratch_arena arena;
+  return arena;
+}
+
+} // namespace utils
+} // namespace lbann
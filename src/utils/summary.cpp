@@ -29,6 +29,7 @@
 
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/threads/thread_pool.hpp"
 #ifdef LBANN_HAS_OPENCV
 #include "lbann/utils/image.hpp"
 #endif // LBANN_HAS_OPENCV
@@ -42,6 +43,8 @@ lbann_summary::lbann_summary(std::string logdir, lbann_comm* comm)
 {
   if (m_comm->am_world_master()) {
     m_sw = new TBinf::SummaryWriter(logdir);
+    m_writer = std::make_unique<thread_pool>();
+    m_writer->launch_threads(1);
   }
   else {
     m_sw = nullptr;
@@ -52,6 +55,8 @@ lbann_summary::lbann_summary(std::string logdir, lbann_comm* comm)
 lbann_summary::~lbann_summary()
 {
   flush();
+  wait_for_writes();
+  m_writer.reset();
   if (m_sw != nullptr) {
     delete m_sw;
   }
@@ -74,197 +79,205 @@ void lbann_summary::report_image(std::string const& tag,
                 "\".");
   }
 
+  if (m_sw == nullptr) {
+    LBANN_ERROR("Images can only be reported by the world master.");
+  }
   auto uint8_img = get_uint8_t_image(image, dims);
   auto img_str = encode_image(uint8_img, dims, img_format);
-  m_sw->add_image(tag, img_str, dims, step);
+  enqueue_write([this, tag, img_str = std::move(img_str), dims, step]() {
+    m_sw->add_image(tag, img_str, dims, step);
+  });
 }
 #endif // LBANN_HAS_OPENCV
 
+bool lbann_summary::pending_summaries::empty() const noexcept
+{
+  return (means.empty() && mins.empty() && maxes.empty() && stdevs.empty() &&
+          scalars.empty() && sum_scalars.empty() && histograms.empty());
+}
+
 void lbann_summary::flush()
 {
-  flush_means();
-  flush_mins();
-  flush_maxes();
-  flush_stdevs();
-  flush_scalars();
-  flush_sum_scalars();
+  LBANN_CALIPER_MARK_SCOPE("lbann_summary::flush");
+  flush_reductions();
   flush_scalar_alls();
-  flush_histograms();
   if (m_sw != nullptr) {
-    m_sw->flush();
+    enqueue_write([this]() { m_sw->flush(); });
   }
 }
 
-void lbann_summary::flush_means()
+void lbann_summary::enqueue_write(std::function<void()> write)
 {
-  if (m_pending_means.empty()) {
-    return;
-  }
-  std::vector<float> local_sums;
-  for (const auto& op : m_pending_means) {
-    local_sums.push_back(op.local);
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> global_sums(local_sums.size());
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           global_sums.data(),
-                           El::mpi::SUM);
-    // Compute the means in-place.
-    for (unsigned i = 0; i < global_sums.size(); ++i) {
-      global_sums[i] /= m_pending_means[i].num;
-    }
-    gather_scalar_summary(m_pending_means, global_sums);
-  }
-  else {
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
+  m_last_write = m_writer->submit_job(std::move(write));
+}
+
+void lbann_summary::wait_for_writes()
+{
+  // The writer has one thread, so jobs finish in submission order.
+  if (m_last_write.valid()) {
+    m_last_write.get();
   }
-  m_pending_means.clear();
 }
 
-void lbann_summary::flush_mins()
+void lbann_summary::flush_reductions()
 {
-  if (m_pending_mins.empty()) {
+  if (m_pending.empty()) {
     return;
   }
-  std::vector<float> local_mins;
-  for (const auto& op : m_pending_mins) {
-    local_mins.push_back(op.local);
+
+  // Pack every reduction within the trainer into one buffer that is
+  // summed and one that is maxed; minima are reduced as negated maxima.
+  std::vector<double> local_sums;
+  std::vector<double> local_maxes;
+  for (const auto& op : m_pending.means) {
+    local_sums.push_back(op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> global_mins(local_mins.size());
-    m_comm->trainer_reduce(local_mins.data(),
-                           local_mins.size(),
-                           global_mins.data(),
-                           El::mpi::MIN);
-    gather_scalar_summary(m_pending_mins, global_mins);
+  for (const auto& op : m_pending.stdevs) {
+    local_sums.push_back(op.local);
+    local_sums.push_back(op.local2);
   }
-  else {
-    m_comm->trainer_reduce(local_mins.data(),
-                           local_mins.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::MIN);
+  for (const auto& op : m_pending.sum_scalars) {
+    local_sums.push_back(op.local);
+  }
+  for (const auto& op : m_pending.maxes) {
+    local_maxes.push_back(op.local);
+  }
+  for (const auto& op : m_pending.mins) {
+    local_maxes.push_back(-op.local);
+  }
+  for (const auto& op : m_pending.histograms) {
+    local_sums.push_back(op.sum);
+    local_sums.push_back(op.sqsum);
+    local_sums.insert(local_sums.end(), op.buckets.begin(), op.buckets.end());
+    local_maxes.push_back(op.max);
+    local_maxes.push_back(-op.min);
   }
-  m_pending_mins.clear();
-}
 
-void lbann_summary::flush_maxes()
-{
-  if (m_pending_maxes.empty()) {
+  if (!m_comm->am_trainer_master()) {
+    if (!local_sums.empty()) {
+      m_comm->trainer_reduce(local_sums.data(),
+                             local_sums.size(),
+                             m_comm->get_trainer_master(),
+                             El::mpi::SUM);
+    }
+    if (!local_maxes.empty()) {
+      m_comm->trainer_reduce(local_maxes.data(),
+                             local_maxes.size(),
+                             m_comm->get_trainer_master(),
+                             El::mpi::MAX);
+    }
+    m_pending = pending_summaries{};
     return;
   }
-  std::vector<float> local_maxes;
-  for (const auto& op : m_pending_maxes) {
-    local_maxes.push_back(op.local);
+
+  std::vector<double> global_sums(local_sums.size());
+  std::vector<double> global_maxes(local_maxes.size());
+  if (!local_sums.empty()) {
+    m_comm->trainer_reduce(local_sums.data(),
+                           local_sums.size(),
+                           global_sums.data(),
+                           El::mpi::SUM);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> global_maxes(local_maxes.size());
+  if (!local_maxes.empty()) {
     m_comm->trainer_reduce(local_maxes.data(),
                            local_maxes.size(),
                            global_maxes.data(),
                            El::mpi::MAX);
-    gather_scalar_summary(m_pending_maxes, global_maxes);
   }
-  else {
-    m_comm->trainer_reduce(local_maxes.data(),
-                           local_maxes.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::MAX);
-  }
-  m_pending_maxes.clear();
-}
 
-void lbann_summary::flush_stdevs()
-{
-  if (m_pending_stdevs.empty()) {
-    return;
-  }
-  std::vector<float> local_sums;
-  std::vector<float> local_sqsums;
-  for (const auto& op : m_pending_stdevs) {
-    local_sums.push_back(op.local);
-    local_sqsums.push_back(op.local2);
-  }
-  if (m_comm->am_trainer_master()) {
+  // Finish each summary in the order write_reductions expects.
+  std::vector<double> values;
+  auto sum = global_sums.cbegin();
+  auto max = global_maxes.cbegin();
+  for (const auto& op : m_pending.means) {
+    values.push_back(*sum++ / op.num);
+  }
+  for (const auto& op : m_pending.stdevs) {
     // Compute the model sample standard deviation as:
     // sqrt[1/(n-1) (sqsum - (1/n)*sum^2)]
     // The n-1 is to use an unbiased variance estimate.
-    // This unrolls the usual formulation of standard deviation some, to avoid
-    // global operations when pushing the operation.
-    std::vector<float> global_sums(local_sums.size());
-    std::vector<float> global_sqsums(local_sqsums.size());
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           global_sums.data(),
-                           El::mpi::SUM);
-    m_comm->trainer_reduce(local_sqsums.data(),
-                           local_sqsums.size(),
-                           global_sqsums.data(),
-                           El::mpi::SUM);
-    // Re-use the global_sums vector for the standard deviation.
-    for (unsigned i = 0; i < global_sums.size(); ++i) {
-      global_sums[i] =
-        El::Sqrt((global_sqsums[i] -
-                  global_sums[i] * global_sums[i] / m_pending_stdevs[i].num) /
-                 (m_pending_stdevs[i].num - 1));
-    }
-    gather_scalar_summary(m_pending_stdevs, global_sums);
+    const double s = *sum++;
+    const double sqsum = *sum++;
+    values.push_back(El::Sqrt((sqsum - s * s / op.num) / (op.num - 1)));
   }
-  else {
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
-    m_comm->trainer_reduce(local_sqsums.data(),
-                           local_sqsums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
+  for (size_t i = 0; i < m_pending.sum_scalars.size(); ++i) {
+    values.push_back(*sum++);
   }
-  m_pending_stdevs.clear();
-}
-
-void lbann_summary::flush_scalars()
-{
-  if (m_pending_scalars.empty()) {
-    return;
+  for (size_t i = 0; i < m_pending.maxes.size(); ++i) {
+    values.push_back(*max++);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> local_scalars;
-    for (const auto& op : m_pending_scalars) {
-      local_scalars.push_back(op.local);
-    }
-    gather_scalar_summary(m_pending_scalars, local_scalars);
+  for (size_t i = 0; i < m_pending.mins.size(); ++i) {
+    values.push_back(-*max++);
   }
-  m_pending_scalars.clear();
-}
-
-void lbann_summary::flush_sum_scalars()
-{
-  if (m_pending_sum_scalars.empty()) {
-    return;
+  for (const auto& op : m_pending.scalars) {
+    values.push_back(op.local);
   }
-  std::vector<float> local_sums;
-  for (const auto& op : m_pending_sum_scalars) {
-    local_sums.push_back(op.local);
+  for (const auto& op : m_pending.histograms) {
+    values.push_back(-max[1]);
+    values.push_back(max[0]);
+    values.push_back(sum[0]);
+    values.push_back(sum[1]);
+    values.insert(values.end(), sum + 2, sum + 2 + op.buckets.size());
+    max += 2;
+    sum += 2 + op.buckets.size();
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> global_sums(local_sums.size());
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           global_sums.data(),
-                           El::mpi::SUM);
-    gather_scalar_summary(m_pending_sum_scalars, global_sums);
+
+  // Gather to the world master for writing out.
+  if (m_comm->am_world_master()) {
+    const int num_trainers = m_comm->get_num_trainers();
+    std::vector<double> data(num_trainers * values.size());
+    m_comm->intertrainer_gather(values.data(), values.size(), data.data());
+    enqueue_write([this,
+                   ops = std::move(m_pending),
+                   data = std::move(data),
+                   num_trainers]() {
+      write_reductions(ops, data, num_trainers);
+    });
   }
   else {
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
+    m_comm->intertrainer_gather(values.data(),
+                                values.size(),
+                                m_comm->get_intertrainer_master());
+  }
+  m_pending = pending_summaries{};
+}
+
+void lbann_summary::write_reductions(const pending_summaries& ops,
+                                     const std::vector<double>& data,
+                                     int num_trainers) const
+{
+  auto value = data.cbegin();
+  for (int model = 0; model < num_trainers; ++model) {
+    for (const auto* pending : {&ops.means,
+                                &ops.stdevs,
+                                &ops.sum_scalars,
+                                &ops.maxes,
+                                &ops.mins,
+                                &ops.scalars}) {
+      for (const auto& op : *pending) {
+        m_sw->add_scalar(prepend_model(op.tag, model), *value++, op.step);
+      }
+    }
+    for (const auto& op : ops.histograms) {
+      const double min = value[0];
+      const double max = value[1];
+      const double sum = value[2];
+      const double sqsum = value[3];
+      value += 4;
+      // TBinf expects one count per bucket limit; the last bucket only
+      // holds values beyond the largest limit.
+      std::vector<float> buckets(value, value + m_histogram_buckets.size());
+      value += op.buckets.size();
+      m_sw->add_histogram(prepend_model(op.tag, model),
+                          buckets,
+                          min,
+                          max,
+                          op.num,
+                          sum,
+                          sqsum,
+                          op.step);
+    }
   }
-  m_pending_sum_scalars.clear();
 }
 
 void lbann_summary::flush_scalar_alls()
@@ -284,16 +297,22 @@ void lbann_summary::flush_scalar_alls()
                    local_scalars.size(),
                    scalars.data(),
                    m_comm->get_world_comm());
-    for (size_t i = 0; i < scalars.size(); ++i) {
-      int rank = i / local_scalars.size();
-      int model = rank / m_comm->get_procs_per_trainer();
-      int pos = i % local_scalars.size();
-      m_sw->add_scalar(prepend_model("rank" + std::to_string(rank) + "/" +
-                                       m_pending_scalar_alls[pos].tag,
-                                     model),
-                       scalars[i],
-                       m_pending_scalar_alls[pos].step);
-    }
+    const int procs_per_trainer = m_comm->get_procs_per_trainer();
+    enqueue_write([this,
+                   ops = std::move(m_pending_scalar_alls),
+                   scalars = std::move(scalars),
+                   procs_per_trainer]() {
+      for (size_t i = 0; i < scalars.size(); ++i) {
+        int rank = i / ops.size();
+        int model = rank / procs_per_trainer;
+        int pos = i % ops.size();
+        m_sw->add_scalar(
+          prepend_model("rank" + std::to_string(rank) + "/" + ops[pos].tag,
+                        model),
+          scalars[i],
+          ops[pos].step);
+      }
+    });
   }
   else {
     m_comm->gather(local_scalars.data(),
@@ -304,175 +323,11 @@ void lbann_summary::flush_scalar_alls()
   m_pending_scalar_alls.clear();
 }
 
-void lbann_summary::flush_histograms()
-{
-  if (m_pending_histograms.empty()) {
-    return;
-  }
-  std::vector<float> local_mins;
-  std::vector<float> local_maxes;
-  std::vector<float> local_sums;
-  std::vector<float> local_sqsums;
-  std::vector<float> buckets;
-  for (const auto& op : m_pending_histograms) {
-    local_mins.push_back(op.min);
-    local_maxes.push_back(op.max);
-    local_sums.push_back(op.sum);
-    local_sqsums.push_back(op.sqsum);
-    buckets.insert(buckets.end(), op.buckets.begin(), op.buckets.end());
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> model_mins(local_mins.size());
-    std::vector<float> model_maxes(local_maxes.size());
-    std::vector<float> model_sums(local_sums.size());
-    std::vector<float> model_sqsums(local_sqsums.size());
-    std::vector<float> model_buckets(buckets.size());
-    m_comm->trainer_reduce(local_mins.data(),
-                           local_mins.size(),
-                           model_mins.data(),
-                           El::mpi::MIN);
-    m_comm->trainer_reduce(local_maxes.data(),
-                           local_maxes.size(),
-                           model_maxes.data(),
-                           El::mpi::MAX);
-    m_comm->trainer_reduce(local_sums.data(),
-                           model_sums.size(),
-                           model_sums.data());
-    m_comm->trainer_reduce(local_sqsums.data(),
-                           local_sqsums.size(),
-                           model_sqsums.data());
-    m_comm->trainer_reduce(buckets.data(),
-                           buckets.size(),
-                           model_buckets.data());
-    // Gather to the world master for writing out.
-    if (m_comm->am_world_master()) {
-      std::vector<float> global_mins(m_comm->get_num_trainers() *
-                                     model_mins.size());
-      std::vector<float> global_maxes(m_comm->get_num_trainers() *
-                                      model_maxes.size());
-      std::vector<float> global_sums(m_comm->get_num_trainers() *
-                                     model_sums.size());
-      std::vector<float> global_sqsums(m_comm->get_num_trainers() *
-                                       model_sqsums.size());
-      std::vector<float> global_buckets(m_comm->get_num_trainers() *
-                                        model_buckets.size());
-      m_comm->intertrainer_gather(model_mins.data(),
-                                  model_mins.size(),
-                                  global_mins.data());
-      m_comm->intertrainer_gather(model_maxes.data(),
-                                  model_maxes.size(),
-                                  global_maxes.data());
-      m_comm->intertrainer_gather(model_sums.data(),
-                                  model_sums.size(),
-                                  global_sums.data());
-      m_comm->intertrainer_gather(model_sqsums.data(),
-                                  model_sqsums.size(),
-                                  global_sqsums.data());
-      m_comm->intertrainer_gather(model_buckets.data(),
-                                  model_buckets.size(),
-                                  global_buckets.data());
-      for (unsigned i = 0; i < global_mins.size(); ++i) {
-        int model = i / m_pending_histograms.size();
-        unsigned ops_pos = i % m_pending_histograms.size();
-        std::vector<float> tmp_buckets(
-          global_buckets.begin() + i * m_histogram_buckets.size(),
-          global_buckets.begin() + (i + 1) * m_histogram_buckets.size());
-        m_sw->add_histogram(
-          prepend_model(m_pending_histograms[ops_pos].tag, model),
-          tmp_buckets,
-          global_mins[i],
-          global_maxes[i],
-          m_pending_histograms[ops_pos].num,
-          global_sums[i],
-          global_sqsums[i],
-          m_pending_histograms[ops_pos].step);
-      }
-    }
-    else {
-      m_comm->intertrainer_gather(model_mins.data(),
-                                  model_mins.size(),
-                                  m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_maxes.data(),
-                                  model_maxes.size(),
-                                  m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_sums.data(),
-                                  model_sums.size(),
-                                  m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_sqsums.data(),
-                                  model_sqsums.size(),
-                                  m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_buckets.data(),
-                                  model_buckets.size(),
-                                  m_comm->get_intertrainer_master());
-    }
-  }
-  else {
-    m_comm->trainer_reduce(local_mins.data(),
-                           local_mins.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::MIN);
-    m_comm->trainer_reduce(local_maxes.data(),
-                           local_maxes.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::MAX);
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
-    m_comm->trainer_reduce(local_sqsums.data(),
-                           local_sqsums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
-    m_comm->trainer_reduce(buckets.data(),
-                           buckets.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
-  }
-  m_pending_histograms.clear();
-}
-
 std::string lbann_summary::prepend_model(const std::string tag, int model) const
 {
   return "model" + std::to_string(model) + "/" + tag;
 }
 
-void lbann_summary::gather_scalar_summary(const std::vector<pending_op>& ops,
-                                          std::vector<float>& scalars)
-{
-  if (m_comm->am_world_master()) {
-    std::vector<float> data(m_comm->get_num_trainers() * scalars.size());
-    m_comm->intertrainer_gather(scalars.data(), scalars.size(), data.data());
-    for (unsigned i = 0; i < data.size(); ++i) {
-      int model = i / ops.size();
-      unsigned ops_pos = i % ops.size();
-      m_sw->add_scalar(prepend_model(ops[ops_pos].tag, model),
-                       data[i],
-                       ops[ops_pos].step);
-    }
-  }
-  else {
-    m_comm->intertrainer_gather(scalars.data(),
-                                scalars.size(),
-                                m_comm->get_intertrainer_master());
-  }
-}
-
-void lbann_summary::gather_scalar_summary(const std::string tag,
-                                          float s,
-                                          int step)
-{
-  if (m_comm->am_world_master()) {
-    std::vector<float> data(m_comm->get_num_trainers());
-    m_comm->intertrainer_gather(s, data);
-    for (size_t model = 0; model < data.size(); ++model) {
-      m_sw->add_scalar(prepend_model(tag, model), data[model], step);
-    }
-  }
-  else {
-    m_comm->intertrainer_gather(s, m_comm->get_intertrainer_master());
-  }
-}
-
 #endif // LBANN_HAS_TBINF
 
 } // namespace lbann
@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/summary_histogram.hpp"
+
+#include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/profiling.hpp"
+
+namespace lbann {
+namespace summary_details {
+
+namespace {
+
+/** @brief Min functor */
+template <class T>
+struct min_op
+{
+  __device__ __forceinline__ T operator()(const T& x1, const T& x2) const
+  {
+    return gpu_lib::min(x1, x2);
+  }
+};
+
+/** @brief Max functor */
+template <class T>
+struct max_op
+{
+  __device__ __forceinline__ T operator()(const T& x1, const T& x2) const
+  {
+    return gpu_lib::max(x1, x2);
+  }
+};
+
+/** @brief Histogram and moments of a matrix.
+ *
+ *  Each block bins its entries into a shared-memory histogram before
+ *  adding it to the global bucket counts, and writes its min, max,
+ *  sum and sum of squares to @c partials.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Dynamic shared memory: (num_limits + 1) unsigned ints
+ *
+ *  @param limits    Upper bucket limits (num_limits)
+ *  @param buckets   Bucket counts (num_limits + 1)
+ *  @param partials  Per-block min, max, sum, sqsum (4 x nblocks)
+ */
+template <size_t bsize, typename TensorDataType>
+__global__ void
+local_histogram_kernel(size_t height,
+                       size_t width,
+                       const TensorDataType* __restrict__ values,
+                       size_t ldim,
+                       const double* __restrict__ limits,
+                       size_t num_limits,
+                       double* __restrict__ buckets,
+                       double* __restrict__ partials)
+{
+  extern __shared__ unsigned int block_buckets[];
+
+  const size_t tid = threadIdx.x;
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t i = tid; i <= num_limits; i += bsize) {
+    block_buckets[i] = 0;
+  }
+  __syncthreads();
+
+  double thread_min = gpu_lib::infinity<double>();
+  double thread_max = -gpu_lib::infinity<double>();
+  double thread_sum = 0.;
+  double thread_sqsum = 0.;
+  for (size_t i = gid; i < height * width; i += nthreads) {
+    const auto row = i % height;
+    const auto col = i / height;
+    const double val = values[row + col * ldim];
+    thread_min = gpu_lib::min(thread_min, val);
+    thread_max = gpu_lib::max(thread_max, val);
+    thread_sum += val;
+    thread_sqsum += val * val;
+    // Same bucket as std::upper_bound on the host
+    size_t lo = 0;
+    size_t hi = num_limits;
+    while (lo < hi) {
+      const size_t mid = (lo + hi) / 2;
+      if (limits[mid] <= val) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
+      }
+    }
+    atomicAdd(&block_buckets[lo], 1u);
+  }
+
+  // Reductions sharing an instantiation share scratch space, so
+  // synchronize between them.
+  const double block_min =
+    gpu_lib::block_reduce<bsize, 1, 1, double, min_op<double>>(thread_min);
+  __syncthreads();
+  const double block_max =
+    gpu_lib::block_reduce<bsize, 1, 1, double, max_op<double>>(thread_max);
+  __syncthreads();
+  const double block_sum = gpu_lib::block_reduce<bsize, 1, 1>(thread_sum);
+  __syncthreads();
+  const double block_sqsum = gpu_lib::block_reduce<bsize, 1, 1>(thread_sqsum);
+  if (tid == 0) {
+    partials[4 * blockIdx.x] = block_min;
+    partials[4 * blockIdx.x + 1] = block_max;
+    partials[4 * blockIdx.x + 2] = block_sum;
+    partials[4 * blockIdx.x + 3] = block_sqsum;
+  }
+  for (size_t i = tid; i <= num_limits; i += bsize) {
+    if (block_buckets[i] != 0) {
+      gpu_lib::atomic_add(&buckets[i], static_cast<double>(block_buckets[i]));
+    }
+  }
+}
+
+} // anonymous namespace
+
+template <typename TensorDataType>
+void gpu_local_histogram(
+  const El::Matrix<TensorDataType, El::Device::GPU>& mat,
+  const std::vector<double>& limits,
+  histogram_stats& stats)
+{
+  LBANN_CALIPER_MARK_SCOPE("lbann_summary::gpu_local_histogram");
+
+  const size_t height = mat.Height();
+  const size_t width = mat.Width();
+  const size_t num_limits = limits.size();
+  stats = histogram_stats(num_limits + 1);
+  if (height * width == 0) {
+    return;
+  }
+
+  // Only the bucket counts and a few partial moments per block leave
+  // the device.
+  constexpr size_t block_size = 256;
+  constexpr size_t max_grid_size = 128;
+  const size_t grid_size = std::min((height * width + block_size - 1) /
+                                      block_size,
+                                    max_grid_size);
+  const auto& sync_info = gpu::get_sync_info(mat);
+  hydrogen::simple_buffer<double, El::Device::GPU> device_limits(num_limits,
+                                                                 sync_info);
+  hydrogen::gpu::Copy1DToDevice(limits.data(),
+                                device_limits.data(),
+                                num_limits,
+                                sync_info);
+  El::Matrix<double, El::Device::GPU> results;
+  results.SetSyncInfo(sync_info);
+#ifdef HYDROGEN_HAVE_CUB
+  results.SetMemoryMode(1); // Use CUB memory pool.
+#endif
+  El::Zeros(results, num_limits + 1 + 4 * grid_size, 1);
+  hydrogen::gpu::LaunchKernel(
+    local_histogram_kernel<block_size, TensorDataType>,
+    grid_size,
+    block_size,
+    (num_limits + 1) * sizeof(unsigned int),
+    sync_info,
+    height,
+    width,
+    mat.LockedBuffer(),
+    mat.LDim(),
+    device_limits.data(),
+    num_limits,
+    results.Buffer(),
+    results.Buffer() + num_limits + 1);
+
+  std::vector<double> host_results(results.Height());
+  hydrogen::gpu::Copy1DToHost(results.LockedBuffer(),
+                              host_results.data(),
+                              host_results.size(),
+                              sync_info);
+  El::Synchronize(sync_info);
+  std::copy_n(host_results.begin(), num_limits + 1, stats.buckets.begin());
+  for (size_t block = 0; block < grid_size; ++block) {
+    const auto* partial = &host_results[num_limits + 1 + 4 * block];
+    stats.min = std::min(stats.min, partial[0]);
+    stats.max = std::max(stats.max, partial[1]);
+    stats.sum += partial[2];
+    stats.sqsum += partial[3];
+  }
+}
+
+template void
+gpu_local_histogram<float>(const El::Matrix<float, El::Device::GPU>&,
+                           const std::vector<double>&,
+                           histogram_stats&);
+template void
+gpu_local_histogram<double>(const El::Matrix<double, El::Device::GPU>&,
+                            const std::vector<double>&,
+                            histogram_stats&);
+
+} // namespace summary_details
+} // namespace lbann
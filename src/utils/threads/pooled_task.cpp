@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/threads/pooled_task.hpp"
+
+namespace lbann {
+
+pooled_task* pooled_task_allocator::acquire(std::size_t count)
+{
+  if (count == 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  pooled_task* head = nullptr;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (m_free == nullptr) {
+      m_chunks.emplace_back(std::make_unique<pooled_task[]>(chunk_size));
+      auto* chunk = m_chunks.back().get();
+      for (std::size_t j = 0; j < chunk_size; ++j) {
+        chunk[j].next = (j + 1 < chunk_size ? &chunk[j + 1] : nullptr);
+      }
+      m_free = chunk;
+    }
+    pooled_task* node = m_free;
+    m_free = node->next;
+    node->next = head;
+    head = node;
+  }
+  return head;
+}
+
+void pooled_task_allocator::release(pooled_task* head, pooled_task* tail)
+{
+  if (head == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  tail->next = m_free;
+  m_free = head;
+}
+
+std::size_t pooled_task_allocator::capacity() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_chunks.size() * chunk_size;
+}
+
+} // namespace lbann
@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/threads/thread_budget.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/options.hpp"
+
+#include <omp.h>
+#if defined(LBANN_HAS_PTHREAD_AFFINITY_SUPPORT)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+namespace lbann {
+
+namespace {
+
+std::unique_ptr<thread_budget> g_thread_budget;
+
+/** @brief Format CPUs as ranges, e.g. "0-3,8,10-11" */
+std::string cpu_list_string(std::vector<int> const& cpus)
+{
+  std::ostringstream ss;
+  for (size_t i = 0; i < cpus.size();) {
+    size_t j = i;
+    while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+      ++j;
+    }
+    ss << (i > 0 ? "," : "") << cpus[i];
+    if (j > i) {
+      ss << "-" << cpus[j];
+    }
+    i = j + 1;
+  }
+  return ss.str();
+}
+
+} // namespace
+
+thread_budget_policy thread_budget_policy_from_string(std::string const& str)
+{
+  if (str == "none") {
+    return thread_budget_policy::none;
+  }
+  if (str == "compute") {
+    return thread_budget_policy::compute;
+  }
+  if (str == "io") {
+    return thread_budget_policy::io;
+  }
+  if (str == "balanced") {
+    return thread_budget_policy::balanced;
+  }
+  LBANN_ERROR("unknown thread budget policy \"",
+              str,
+              "\" (expected none, compute, io or balanced)");
+  return thread_budget_policy::none;
+}
+
+std::string to_string(thread_budget_policy policy)
+{
+  switch (policy) {
+  case thread_budget_policy::none:
+    return "none";
+  case thread_budget_policy::compute:
+    return "compute";
+  case thread_budget_policy::io:
+    return "io";
+  case thread_budget_policy::balanced:
+    return "balanced";
+  }
+  return "unknown";
+}
+
+thread_budget divide_thread_budget(std::vector<int> const& cpus,
+                                   thread_budget_policy policy,
+                                   int num_omp_threads,
+                                   int num_io_threads,
+                                   int num_python_workers,
+                                   int num_reserved)
+{
+  // Consumers in CPU order: OpenMP, I/O threads, Python workers
+  const bool own_python_cpus = (num_python_workers > 0);
+  const std::array<int, 3> requests = {std::max(num_omp_threads, 1),
+                                       std::max(num_io_threads, 1),
+                                       own_python_cpus ? num_python_workers
+                                                       : 0};
+  const int num_consumers = (own_python_cpus ? 3 : 2);
+  const int num_cpus = static_cast<int>(cpus.size());
+
+  thread_budget budget;
+  budget.policy = policy;
+  if (num_cpus - std::max(num_reserved, 0) < num_consumers) {
+    num_reserved = 0;
+  }
+  const int num_avail = num_cpus - std::max(num_reserved, 0);
+
+  if (num_avail < num_consumers) {
+    // Too few CPUs to keep the consumers apart, so they all share
+    budget.oversubscribed = true;
+    budget.num_omp_threads = requests[0];
+    budget.num_io_threads = requests[1];
+    budget.num_python_workers = own_python_cpus ? requests[2] : requests[1];
+    budget.omp_cpus = cpus;
+    budget.io_cpus = cpus;
+    budget.python_cpus = cpus;
+    return budget;
+  }
+
+  std::array<int, 3> grants = {0, 0, 0};
+  if (std::accumulate(requests.begin(), requests.end(), 0) <= num_avail) {
+    grants = requests;
+  }
+  else {
+    // Everyone gets one CPU, then the policy hands out the rest
+    int remaining = num_avail;
+    for (int c = 0; c < num_consumers; ++c) {
+      grants[c] = 1;
+      --remaining;
+    }
+    if (policy == thread_budget_policy::balanced) {
+      // Largest-remainder split of the extra CPUs
+      std::array<double, 3> shares = {0., 0., 0.};
+      double total_extra = 0.;
+      for (int c = 0; c < num_consumers; ++c) {
+        total_extra += requests[c] - 1;
+      }
+      const int to_split = remaining;
+      for (int c = 0; c < num_consumers; ++c) {
+        shares[c] = to_split * (requests[c] - 1) / total_extra;
+        const int whole = static_cast<int>(shares[c]);
+        grants[c] += whole;
+        shares[c] -= whole;
+        remaining -= whole;
+      }
+      while (remaining > 0) {
+        int best = 0;
+        for (int c = 1; c < num_consumers; ++c) {
+          if (shares[c] > shares[best]) {
+            best = c;
+          }
+        }
+        ++grants[best];
+        shares[best] = -1.;
+        --remaining;
+      }
+    }
+    else {
+      const std::array<int, 3> order =
+        (policy == thread_budget_policy::io ? std::array<int, 3>{1, 2, 0}
+                                            : std::array<int, 3>{0, 1, 2});
+      for (int c : order) {
+        const int extra = std::min(requests[c] - grants[c], remaining);
+        grants[c] += extra;
+        remaining -= extra;
+      }
+    }
+  }
+
+  auto next = cpus.begin();
+  auto take = [&next](int count) {
+    std::vector<int> slice(next, next + count);
+    next += count;
+    return slice;
+  };
+  budget.omp_cpus = take(grants[0]);
+  budget.reserved_cpus = take(num_reserved);
+  budget.io_cpus = take(grants[1]);
+  budget.num_omp_threads = grants[0];
+  budget.num_io_threads = grants[1];
+  if (own_python_cpus) {
+    budget.python_cpus = take(grants[2]);
+    budget.num_python_workers = grants[2];
+  }
+  else {
+    budget.python_cpus = budget.io_cpus;
+    budget.num_python_workers = grants[1];
+  }
+  return budget;
+}
+
+std::vector<int> get_rank_cpus(lbann_comm const& comm)
+{
+  const int num_node_cpus =
+    std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  std::vector<int> cpus;
+#if defined(LBANN_HAS_PTHREAD_AFFINITY_SUPPORT)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) ==
+      0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpuset)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif // LBANN_HAS_PTHREAD_AFFINITY_SUPPORT
+  if (cpus.empty()) {
+    cpus.resize(num_node_cpus);
+    std::iota(cpus.begin(), cpus.end(), 0);
+  }
+
+  // Unbound ranks each take an even share of the node
+  const int procs_per_node = comm.get_procs_per_node();
+  if (procs_per_node > 1 && static_cast<int>(cpus.size()) >= num_node_cpus) {
+    const int share = std::max(static_cast<int>(cpus.size()) / procs_per_node, 1);
+    const int begin =
+      std::min(comm.get_rank_in_node() * share,
+               static_cast<int>(cpus.size()) - share);
+    cpus = std::vector<int>(cpus.begin() + begin,
+                            cpus.begin() + begin + share);
+  }
+  return cpus;
+}
+
+thread_budget const* setup_thread_budget(lbann_comm const& comm)
+{
+  auto const& arg_parser = global_argument_parser();
+  const auto policy = thread_budget_policy_from_string(
+    arg_parser.get<std::string>(LBANN_OPTION_THREAD_BUDGET_POLICY));
+  if (policy == thread_budget_policy::none || g_thread_budget != nullptr) {
+    return g_thread_budget.get();
+  }
+
+  int num_reserved = 0;
+#ifdef LBANN_HAS_ALUMINUM
+  // The Aluminum progress engine runs its own thread
+  num_reserved = 1;
+#endif // LBANN_HAS_ALUMINUM
+  g_thread_budget = std::make_unique<thread_budget>(divide_thread_budget(
+    get_rank_cpus(comm),
+    policy,
+    arg_parser.get<int>(LBANN_OPTION_OMP_NUM_THREADS),
+    arg_parser.get<int>(LBANN_OPTION_NUM_IO_THREADS),
+    arg_parser.get<int>(LBANN_OPTION_NUM_PYTHON_WORKERS),
+    num_reserved));
+  auto const& budget = *g_thread_budget;
+
+  omp_set_num_threads(budget.num_omp_threads);
+#if defined(LBANN_HAS_PTHREAD_AFFINITY_SUPPORT)
+  // Threads inherit the affinity of the thread that creates them, so
+  // this covers the OpenMP team and the runtime helpers
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int cpu : budget.omp_cpus) {
+    CPU_SET(cpu, &cpuset);
+  }
+  for (int cpu : budget.reserved_cpus) {
+    CPU_SET(cpu, &cpuset);
+  }
+  const int error =
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+  if (error != 0) {
+    LBANN_WARNING("could not bind the main thread to its thread budget: ",
+                  std::strerror(error));
+  }
+#endif // LBANN_HAS_PTHREAD_AFFINITY_SUPPORT
+
+  if (comm.am_world_master()) {
+    print_thread_budget(std::cout, budget);
+  }
+  if (budget.oversubscribed) {
+    LBANN_WARNING("rank ",
+                  comm.get_rank_in_world(),
+                  " has too few CPUs to separate OpenMP, I/O and Python "
+                  "threads; they will share CPUs ",
+                  cpu_list_string(budget.omp_cpus));
+  }
+  return g_thread_budget.get();
+}
+
+thread_budget const* get_thread_budget() { return g_thread_budget.get(); }
+
+void print_thread_budget(std::ostream& os, thread_budget const& budget)
+{
+  const size_t num_cpus = budget.omp_cpus.size() +
+                          budget.reserved_cpus.size() +
+                          budget.io_cpus.size() +
+                          (budget.python_cpus == budget.io_cpus
+                             ? 0
+                             : budget.python_cpus.size());
+  std::ostringstream ss;
+  ss << "\tThread budget (policy " << to_string(budget.policy) << ", "
+     << (budget.oversubscribed ? budget.omp_cpus.size() : num_cpus)
+     << " CPUs per rank" << (budget.oversubscribed ? ", shared" : "")
+     << "):\n"
+     << "\t  OpenMP threads: " << budget.num_omp_threads << " on CPUs "
+     << cpu_list_string(budget.omp_cpus) << "\n";
+  if (!budget.reserved_cpus.empty()) {
+    ss << "\t  Reserved: CPUs " << cpu_list_string(budget.reserved_cpus)
+       << "\n";
+  }
+  ss << "\t  I/O threads: " << budget.num_io_threads << " on CPUs "
+     << cpu_list_string(budget.io_cpus) << "\n"
+     << "\t  Python workers: " << budget.num_python_workers << " on CPUs "
+     << cpu_list_string(budget.python_cpus) << "\n";
+  os << ss.str();
+}
+
+} // namespace lbann
@@ -64,13 +64,28 @@ void check_hwloc_api_version()
 }
 #endif
 
+#if defined(LBANN_HAS_PTHREAD_AFFINITY_SUPPORT)
+#include <pthread.h>
+#endif
+
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 
 namespace lbann {
 
+thread_local thread_pool::worker_state* thread_pool::t_current_worker_ =
+  nullptr;
+
 thread_pool::thread_pool()
-  : thread_joiner_{threads_}, all_work_done_{false}, m_threads_offset{0}
+  : m_num_injected{0},
+    m_num_queued{0},
+    m_num_sleeping{0},
+    thread_joiner_{threads_},
+    all_work_done_{false},
+    m_work_group_pending{0},
+    m_work_group_failed{false},
+    m_threads_offset{0}
 {}
 
 thread_pool::thread_pool(size_type max_threads) : thread_pool()
@@ -79,14 +94,34 @@ thread_pool::thread_pool(size_type max_threads) : thread_pool()
   this->launch_threads(num_threads);
 }
 
-void thread_pool::launch_threads(size_type num_threads)
+void thread_pool::setup_workers_(size_type num_threads)
 {
+  if (!threads_.empty()) {
+    LBANN_ERROR("thread pool already has ",
+                threads_.size(),
+                " threads; reap them before launching more");
+  }
+  // Thieves index every worker, so all states must exist before the
+  // first thread starts
+  m_workers.reserve(num_threads);
+  for (size_type cnt = 0; cnt < num_threads; ++cnt) {
+    m_workers.emplace_back(
+      std::make_unique<worker_state>(*this, static_cast<int>(cnt)));
+  }
   threads_.reserve(num_threads);
+  m_thread_cpus.clear();
+}
+
+void thread_pool::launch_threads(size_type num_threads)
+{
+  setup_workers_(num_threads);
 
   // Try to launch each worker thread
   try {
     for (size_type cnt = 0; cnt < num_threads; ++cnt) {
-      threads_.emplace_back(&thread_pool::do_thread_work_, this);
+      threads_.emplace_back(&thread_pool::do_thread_work_,
+                            this,
+                            m_workers[cnt].get());
     }
   }
   catch (...) {
@@ -110,9 +145,7 @@ void thread_pool::launch_pinned_threads(size_type num_threads, int PU_offset)
 {
 
 #if defined(LBANN_TOPO_AWARE)
-  threads_.reserve(num_threads);
-  m_work_group.reserve(num_threads);
-  m_thread_id_to_local_id_map.reserve(num_threads);
+  setup_workers_(num_threads);
 
   hwloc_topology_t topo;
   int err;
@@ -169,7 +202,7 @@ void thread_pool::launch_pinned_threads(size_type num_threads, int PU_offset)
       }
       threads_.emplace_back(&thread_pool::do_thread_work_pinned_thread_,
                             this,
-                            cnt,
+                            m_workers[cnt].get(),
                             ht_topo,
                             ht_cpuset);
     }
@@ -186,48 +219,160 @@ void thread_pool::launch_pinned_threads(size_type num_threads, int PU_offset)
 #endif // LBANN_HAS_PTHREAD_AFFINITY_SUPPORT
 }
 
+void thread_pool::launch_bound_threads(size_type num_threads,
+                                       std::vector<int> const& cpus)
+{
+  setup_workers_(num_threads);
+  m_thread_cpus = cpus;
+
+  try {
+    for (size_type cnt = 0; cnt < num_threads; ++cnt) {
+      threads_.emplace_back(&thread_pool::do_thread_work_bound_thread_,
+                            this,
+                            m_workers[cnt].get());
+    }
+  }
+  catch (...) {
+    all_work_done_ = true;
+    throw;
+  }
+}
+
 void thread_pool::reap_threads()
 {
   if (this->get_num_threads() == 0) {
     return;
   }
-  all_work_done_ = true;
-  do {
-    global_work_queue_.wake_all(true);
-  } while (!global_work_queue_.empty());
+  {
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    all_work_done_ = true;
+  }
+  m_wake_cv.notify_all();
 
   for (auto& t : threads_)
     if (t.joinable())
       t.join();
 
-  m_work_group.clear();
-  m_thread_id_to_local_id_map.clear();
+  // Discard jobs that were queued after the workers drained; dropping
+  // a job breaks the promise of any future waiting on it
+  auto discard = [this](pooled_task* task) {
+    task->reset();
+    m_task_allocator.release(task, task);
+  };
+  while (m_injection_head != nullptr) {
+    pooled_task* task = m_injection_head;
+    m_injection_head = task->next;
+    discard(task);
+  }
+  m_injection_tail = nullptr;
+  m_num_injected = 0;
+  for (auto& w : m_workers) {
+    pooled_task* task;
+    while (w->deque.pop(task)) {
+      discard(task);
+    }
+    if (w->free_tasks != nullptr) {
+      pooled_task* tail = w->free_tasks;
+      while (tail->next != nullptr) {
+        tail = tail->next;
+      }
+      m_task_allocator.release(w->free_tasks, tail);
+    }
+  }
+  m_workers.clear();
+  m_num_queued = 0;
+  m_work_group_pending = 0;
+  m_work_group_failed = false;
+  m_work_group_exception = nullptr;
   threads_.clear();
   /// Reset the flag so that new threads can be started
   all_work_done_ = false;
-  global_work_queue_.set_stop_threads(false);
   return;
 }
 
 void thread_pool::relaunch_pinned_threads(size_type num_threads)
 {
   reap_threads();
-  launch_pinned_threads(num_threads, m_threads_offset);
+  if (!m_thread_cpus.empty()) {
+    auto cpus = std::move(m_thread_cpus);
+    launch_bound_threads(num_threads, cpus);
+  }
+  else {
+    launch_pinned_threads(num_threads, m_threads_offset);
+  }
   return;
 }
 
-void thread_pool::do_thread_work_()
+bool thread_pool::finish_work_group()
 {
-  while (not all_work_done_) {
-    auto task = global_work_queue_.wait_and_pop();
-    if (task) {
-      (*task)();
+  wait_for_jobs_(m_work_group_pending);
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(m_work_group_mutex);
+    std::swap(error, m_work_group_exception);
+  }
+  const bool failed = m_work_group_failed.exchange(false);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  if (failed) {
+    LBANN_ERROR("invalid result from a job in the work group");
+  }
+  return true;
+}
+
+void thread_pool::do_thread_work_(worker_state* self)
+{
+  t_current_worker_ = self;
+  // Spin briefly before sleeping so that bursts of fine-grained jobs
+  // do not pay for a wakeup each
+  constexpr int max_idle_spins = 64;
+  int idle_spins = 0;
+  while (true) {
+    if (pooled_task* task = take_task_(*self)) {
+      run_task_(task);
+      idle_spins = 0;
+      continue;
     }
+    if (all_work_done_) {
+      break;
+    }
+    if (idle_spins < max_idle_spins) {
+      ++idle_spins;
+      std::this_thread::yield();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+    ++m_num_sleeping;
+    m_wake_cv.wait(lock, [this] {
+      return m_num_queued.load() > 0 || all_work_done_.load();
+    });
+    --m_num_sleeping;
+    idle_spins = 0;
   }
+  t_current_worker_ = nullptr;
+}
+
+void thread_pool::do_thread_work_bound_thread_(worker_state* self)
+{
+#if defined(LBANN_HAS_PTHREAD_AFFINITY_SUPPORT)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int cpu : m_thread_cpus) {
+    CPU_SET(cpu, &cpuset);
+  }
+  auto error =
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+  if (error != 0) {
+    std::cerr << "error in pthread_setaffinity_np, error=" << strerror(error)
+              << std::endl;
+  }
+#endif // LBANN_HAS_PTHREAD_AFFINITY_SUPPORT
+  do_thread_work_(self);
 }
 
 #if defined(LBANN_TOPO_AWARE)
-void thread_pool::do_thread_work_pinned_thread_(int tid,
+void thread_pool::do_thread_work_pinned_thread_(worker_state* self,
                                                 hwloc_topology_t topo,
                                                 hwloc_cpuset_t cpuset)
 {
@@ -244,25 +389,174 @@ void thread_pool::do_thread_work_pinned_thread_(int tid,
   /* terminate this topology context */
   hwloc_topology_destroy(topo);
 
+  do_thread_work_(self);
+}
+#endif // LBANN_TOPO_AWARE
+
+pooled_task* thread_pool::acquire_task_()
+{
+  // Workers refill their private cache in batches so the allocator
+  // lock is rarely taken
+  constexpr size_type refill_size = pooled_task_allocator::chunk_size / 2;
+  worker_state* self = current_worker_();
+  if (self == nullptr) {
+    return m_task_allocator.acquire(1);
+  }
+  if (self->free_tasks == nullptr) {
+    self->free_tasks = m_task_allocator.acquire(refill_size);
+    self->num_free_tasks = refill_size;
+  }
+  pooled_task* task = self->free_tasks;
+  self->free_tasks = task->next;
+  --self->num_free_tasks;
+  task->next = nullptr;
+  return task;
+}
+
+void thread_pool::release_task_(pooled_task* task)
+{
+  constexpr size_type max_cached = pooled_task_allocator::chunk_size;
+  worker_state* self = current_worker_();
+  if (self == nullptr) {
+    task->next = nullptr;
+    m_task_allocator.release(task, task);
+    return;
+  }
+  task->next = self->free_tasks;
+  self->free_tasks = task;
+  ++self->num_free_tasks;
+  if (self->num_free_tasks > max_cached) {
+    // Hand back everything past the first half of the cache, e.g.
+    // when this worker runs jobs that another thread submitted
+    pooled_task* keep_tail = self->free_tasks;
+    for (size_type i = 1; i < max_cached / 2; ++i) {
+      keep_tail = keep_tail->next;
+    }
+    pooled_task* head = keep_tail->next;
+    pooled_task* tail = head;
+    while (tail->next != nullptr) {
+      tail = tail->next;
+    }
+    keep_tail->next = nullptr;
+    m_task_allocator.release(head, tail);
+    self->num_free_tasks = max_cached / 2;
+  }
+}
+
+void thread_pool::push_task_(pooled_task* task)
+{
+  worker_state* self = current_worker_();
+  if (self != nullptr) {
+    self->deque.push(task);
+  }
+  else {
+    std::lock_guard<std::mutex> lock(m_injection_mutex);
+    task->next = nullptr;
+    if (m_injection_tail == nullptr) {
+      m_injection_head = task;
+    }
+    else {
+      m_injection_tail->next = task;
+    }
+    m_injection_tail = task;
+    m_num_injected.fetch_add(1, std::memory_order_relaxed);
+  }
+  // Pairs with a sleeping worker incrementing m_num_sleeping before
+  // it checks m_num_queued
+  m_num_queued.fetch_add(1);
+  if (m_num_sleeping.load() > 0) {
+    { std::lock_guard<std::mutex> lock(m_sleep_mutex); }
+    m_wake_cv.notify_one();
+  }
+}
+
+pooled_task* thread_pool::take_task_(worker_state& self)
+{
+  pooled_task* task = nullptr;
+  if (self.deque.pop(task)) {
+    m_num_queued.fetch_sub(1);
+    return task;
+  }
+  if (m_num_injected.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> lock(m_injection_mutex);
+    task = m_injection_head;
+    if (task != nullptr) {
+      m_injection_head = task->next;
+      if (m_injection_head == nullptr) {
+        m_injection_tail = nullptr;
+      }
+      task->next = nullptr;
+      m_num_injected.fetch_sub(1, std::memory_order_relaxed);
+      m_num_queued.fetch_sub(1);
+      return task;
+    }
+  }
+  const size_type num_workers = m_workers.size();
+  for (size_type i = 1; i < num_workers; ++i) {
+    auto& victim = *m_workers[(self.id + i) % num_workers];
+    if (victim.deque.steal(task)) {
+      m_num_queued.fetch_sub(1);
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+void thread_pool::run_task_(pooled_task* task)
+{
+  struct recycle_guard
   {
-    std::lock_guard<std::mutex> guard(m_thread_map_mutex);
-    // Establish a local thread id
-    std::thread::id this_id = std::this_thread::get_id();
-    m_thread_id_to_local_id_map[this_id] = tid;
-  }
-  while (not all_work_done_) {
-    auto task = global_work_queue_.wait_and_pop();
-    if (task) {
-      (*task)();
+    thread_pool& pool;
+    pooled_task* task;
+    ~recycle_guard() { pool.release_task_(task); }
+  } guard{*this, task};
+  task->run();
+}
+
+void thread_pool::notify_job_done_(std::atomic<size_type>& pending)
+{
+  if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    { std::lock_guard<std::mutex> lock(m_done_mutex); }
+    m_done_cv.notify_all();
+  }
+}
+
+void thread_pool::wait_for_jobs_(std::atomic<size_type>& pending)
+{
+  worker_state* self = current_worker_();
+  if (self == nullptr) {
+    std::unique_lock<std::mutex> lock(m_done_mutex);
+    m_done_cv.wait(lock, [&pending] {
+      return pending.load(std::memory_order_acquire) == 0;
+    });
+    return;
+  }
+  // Only this worker's own jobs are run while waiting, so an
+  // unrelated long-running job is never nested inside the wait
+  while (pending.load(std::memory_order_acquire) != 0) {
+    pooled_task* task = nullptr;
+    if (self->deque.pop(task)) {
+      m_num_queued.fetch_sub(1);
+      run_task_(task);
+    }
+    else {
+      std::this_thread::yield();
     }
   }
 }
-#endif // LBANN_TOPO_AWARE
+
+void thread_pool::record_work_group_exception_(std::exception_ptr e)
+{
+  std::lock_guard<std::mutex> lock(m_work_group_mutex);
+  if (!m_work_group_exception) {
+    m_work_group_exception = e;
+  }
+}
 
 int thread_pool::get_local_thread_id()
 {
-  std::thread::id this_id = std::this_thread::get_id();
-  return m_thread_id_to_local_id_map[this_id];
+  worker_state* self = current_worker_();
+  return (self != nullptr ? self->id : 0);
 }
 
 } // namespace lbann
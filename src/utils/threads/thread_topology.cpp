@@ -101,6 +101,13 @@ void hwloc_print_topo()
 // Used by thread_pool.hpp also -- NOT static.
 hwloc_cpuset_t get_local_cpuset_for_current_thread(hwloc_topology_t topo)
 {
+  // CPUs this rank is allowed to run on
+  hwloc_cpuset_t bound_cpuset = hwloc_bitmap_alloc();
+  if (hwloc_get_cpubind(topo, bound_cpuset, HWLOC_CPUBIND_PROCESS) != 0 ||
+      hwloc_bitmap_iszero(bound_cpuset)) {
+    hwloc_bitmap_copy(bound_cpuset, hwloc_topology_get_allowed_cpuset(topo));
+  }
+
   hwloc_cpuset_t local_cpuset = hwloc_bitmap_alloc();
 #ifdef LBANN_HAS_CUDA
   // Find CPUs close to the GPU being used
@@ -108,11 +115,33 @@ hwloc_cpuset_t get_local_cpuset_for_current_thread(hwloc_topology_t topo)
                                  hydrogen::gpu::DefaultDevice(),
                                  local_cpuset);
 #else
-  hwloc_const_cpuset_t allowed_cpuset = hwloc_topology_get_allowed_cpuset(topo);
-  hwloc_bitmap_free(local_cpuset);
-  local_cpuset = hwloc_bitmap_dup(allowed_cpuset);
-  //  hwloc_bitmap_free(allowed_cpuset);
+  // Use the NUMA domain the calling thread is running on, since that
+  // is where the consumer of the I/O buffers lives
+  hwloc_cpuset_t last_cpu = hwloc_bitmap_alloc();
+  hwloc_obj_t numa = nullptr;
+  if (hwloc_get_last_cpu_location(topo, last_cpu, HWLOC_CPUBIND_THREAD) ==
+      0) {
+    numa = hwloc_get_next_obj_covering_cpuset_by_type(topo,
+                                                      last_cpu,
+                                                      HWLOC_OBJ_NUMANODE,
+                                                      nullptr);
+  }
+  hwloc_bitmap_free(last_cpu);
+  if (numa != nullptr && numa->cpuset != nullptr) {
+    hwloc_bitmap_copy(local_cpuset, numa->cpuset);
+  }
+  else {
+    hwloc_bitmap_copy(local_cpuset, bound_cpuset);
+  }
 #endif // LBANN_HAS_CUDA
+
+  // Stay inside the rank's binding; if the local domain lies entirely
+  // outside of it, fall back to the whole binding
+  hwloc_bitmap_and(local_cpuset, local_cpuset, bound_cpuset);
+  if (hwloc_bitmap_iszero(local_cpuset)) {
+    hwloc_bitmap_copy(local_cpuset, bound_cpuset);
+  }
+  hwloc_bitmap_free(bound_cpuset);
   return local_cpuset;
 }
 
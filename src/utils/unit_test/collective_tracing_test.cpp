@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+
+#include <sstream>
+
+TEST_CASE("Collective tracing", "[mpi][comm]")
+{
+  using MatType = El::Matrix<float, El::Device::CPU>;
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+  comm.take_collective_records();
+  comm.reset_collective_summary();
+
+  MatType m(7, 3);
+  El::Fill(m, 1.f);
+
+  SECTION("Nothing is recorded unless tracing is enabled")
+  {
+    comm.allreduce(m, world);
+    CHECK(comm.take_collective_records().empty());
+  }
+
+  SECTION("Collectives carry the innermost tag")
+  {
+    comm.set_collective_tracing(true);
+    {
+      lbann::lbann_comm::collective_tag_scope outer(comm, "outer");
+      comm.allreduce(m, world);
+      {
+        lbann::lbann_comm::collective_tag_scope inner(comm, "inner");
+        lbann::Al::request req;
+        comm.nb_allreduce(m, world, req);
+        comm.wait(req);
+      }
+      comm.allreduce(m, world);
+    }
+    comm.allreduce(m, world);
+    comm.set_collective_tracing(false);
+
+    if (comm.get_procs_in_world() == 1) {
+      // Single-process allreduces return before communicating
+      CHECK(comm.take_collective_records().empty());
+      return;
+    }
+    auto const records = comm.take_collective_records();
+    REQUIRE(records.size() == 4);
+    CHECK(records[0].tag == "outer");
+    CHECK(records[0].op == "allreduce");
+    CHECK(records[0].algorithm == "flat/CPU");
+    CHECK(records[1].tag == "inner");
+    CHECK(records[1].op == "nb_allreduce");
+    CHECK(records[2].tag == "outer");
+    CHECK(records[3].tag == "untagged");
+    for (auto const& r : records) {
+      CHECK(r.bytes == 7 * 3 * sizeof(float));
+      CHECK(r.end_time >= r.start_time);
+    }
+
+    // The summary outlives the records
+    CHECK(comm.take_collective_records().empty());
+    std::ostringstream summary;
+    comm.print_collective_summary(summary);
+    CHECK(summary.str().find("outer allreduce (flat/CPU): 2 calls") !=
+          std::string::npos);
+    CHECK(summary.str().find("inner nb_allreduce (flat/CPU): 1 calls") !=
+          std::string::npos);
+  }
+
+  SECTION("Pending collectives are kept until they complete")
+  {
+    comm.set_pending_collective_tracking(true);
+    if (comm.get_procs_in_world() == 1) {
+      comm.allreduce(m, world);
+      CHECK(comm.get_pending_collectives().empty());
+      comm.set_pending_collective_tracking(false);
+      return;
+    }
+    lbann::lbann_comm::collective_tag_scope tag(comm, "pending");
+    lbann::Al::request req;
+    comm.nb_allreduce(m, world, req);
+    auto const pending = comm.get_pending_collectives();
+    comm.wait(req);
+    comm.set_pending_collective_tracking(false);
+    REQUIRE(pending.size() == 1);
+    CHECK(pending[0].tag == "pending");
+    CHECK(pending[0].op == "nb_allreduce");
+    CHECK(comm.get_pending_collectives().empty());
+    // Tracking alone records nothing
+    CHECK(comm.take_collective_records().empty());
+  }
+  comm.reset_collective_summary();
+}
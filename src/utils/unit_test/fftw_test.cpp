@@ -385,3 +385,54 @@ TEMPLATE_TEST_CASE("Testing FFTW wrapper (C2C-InPlace)",
     }
   }
 }
+
+TEMPLATE_TEST_CASE("Testing FFTW plan cache",
+                   "[fft][fftw][utilities]",
+                   float,
+                   double)
+{
+  using RealT = TestType;
+  using DataT = El::Complex<RealT>;
+
+  auto dims = get_input_dims(2);
+  int const num_samples = get_num_samples();
+  auto const matrix_height = lbann::get_linear_size(dims);
+
+  // Plan with a wrapper that goes out of scope
+  {
+    lbann::fftw::FFTWWrapper<DataT> fftw;
+    El::Matrix<DataT, El::Device::CPU> mat(matrix_height, num_samples);
+    REQUIRE_NOTHROW(fftw.setup_forward(mat, dims));
+    REQUIRE_NOTHROW(fftw.setup_backward(mat, dims));
+  }
+
+  // A new wrapper with the same layout reuses the cached plans, which
+  // must still be valid for its own buffers
+  lbann::fftw::FFTWWrapper<DataT> fftw;
+  El::Matrix<DataT, El::Device::CPU> mat(matrix_height, num_samples),
+    mat_orig(matrix_height, num_samples);
+  REQUIRE_NOTHROW(fftw.setup_forward(mat, dims));
+  REQUIRE_NOTHROW(fftw.setup_backward(mat, dims));
+  El::MakeUniform(mat, DataT(0.f), RealT(2.f));
+  El::Copy(mat, mat_orig);
+  REQUIRE_NOTHROW(fftw.compute_forward(mat));
+  REQUIRE_NOTHROW(fftw.compute_backward(mat));
+
+  auto const scale_factor =
+    RealT(lbann::get_linear_size(dims.size() - 1, dims.data() + 1));
+  for (El::Int col = 0; col < num_samples; ++col) {
+    for (El::Int row = 0; row < matrix_height; ++row) {
+      CAPTURE(row, col);
+      CHECK(Approx(RealPart(mat.CRef(row, col))).epsilon(0.05) ==
+            scale_factor * RealPart(mat_orig.CRef(row, col)));
+      CHECK(Approx(ImagPart(mat.CRef(row, col))).epsilon(0.05) ==
+            scale_factor * ImagPart(mat_orig.CRef(row, col)));
+    }
+  }
+
+  // A different mini-batch size gets its own plan
+  El::Matrix<DataT, El::Device::CPU> small_mat(matrix_height, 2);
+  REQUIRE_NOTHROW(fftw.setup_forward(small_mat, dims));
+  REQUIRE_NOTHROW(fftw.compute_forward(small_mat));
+  REQUIRE_THROWS(fftw.compute_backward(small_mat));
+}
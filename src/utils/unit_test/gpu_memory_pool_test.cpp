@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/utils/gpu/helpers.hpp>
+#include <lbann/utils/gpu_memory_pool.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef HYDROGEN_HAVE_CUB
+
+#if defined(LBANN_HAS_CUDA)
+#define CHECK_POOL(call) CHECK_CUDA(call)
+#elif defined(LBANN_HAS_ROCM)
+#define CHECK_POOL(call) CHECK_ROCM(call)
+#endif
+
+TEST_CASE("Growing the GPU memory pool", "[gpu][memory]")
+{
+  auto& pool = El::cub::MemoryPool();
+  constexpr size_t bytes = size_t{1} << 20;
+
+  // Two live blocks and one cached block of the same bin
+  std::vector<void*> live(3, nullptr);
+  for (auto*& ptr : live) {
+    CHECK_POOL(pool.DeviceAllocate(&ptr, bytes));
+  }
+  pool.SetMaxCachedBytes(std::max(pool.max_cached_bytes, 4 * bytes));
+  CHECK_POOL(pool.DeviceFree(live.back()));
+  live.pop_back();
+
+  const auto before = lbann::gpu::get_memory_pool_statistics();
+  const size_t added = lbann::gpu::grow_memory_pool(1.);
+  const auto after = lbann::gpu::get_memory_pool_statistics();
+
+  // Every binned block gets a new cached twin, so the cached blocks
+  // grow by exactly the added bytes
+  CHECK(added >= 3 * bytes);
+  CHECK(after.live_bytes == before.live_bytes);
+  CHECK(after.free_bytes == before.free_bytes + added);
+  CHECK(pool.max_cached_bytes >= after.free_bytes);
+
+  for (auto* ptr : live) {
+    CHECK_POOL(pool.DeviceFree(ptr));
+  }
+}
+#endif // HYDROGEN_HAVE_CUB
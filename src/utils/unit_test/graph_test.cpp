@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/graph.hpp>
+
+TEST_CASE("Assigning graph nodes to streams", "[graph][utilities]")
+{
+  using lbann::graph::assign_streams;
+  const std::set<El::Int> nodes = {0, 1, 2, 3};
+
+  SECTION("A chain stays on one stream")
+  {
+    const std::map<El::Int, std::set<El::Int>> edges = {{0, {1}},
+                                                        {1, {2}},
+                                                        {2, {3}}};
+    for (auto const& [node, stream] : assign_streams(nodes, edges, 4)) {
+      CHECK(stream == 0);
+    }
+  }
+
+  SECTION("Independent branches get different streams")
+  {
+    const std::map<El::Int, std::set<El::Int>> edges = {{0, {1, 2}},
+                                                        {1, {3}},
+                                                        {2, {3}}};
+    auto streams = assign_streams(nodes, edges, 2);
+    CHECK(streams[0] == 0);
+    CHECK(streams[1] == 0);
+    CHECK(streams[2] == 1);
+    CHECK(streams[3] == 0);
+
+    // A single stream serializes everything
+    for (auto const& [node, stream] : assign_streams(nodes, edges, 1)) {
+      CHECK(stream == 0);
+    }
+  }
+
+  SECTION("Invalid inputs")
+  {
+    const std::map<El::Int, std::set<El::Int>> edges = {{1, {0}}};
+    CHECK_THROWS(assign_streams(nodes, edges, 2));
+    CHECK_THROWS(assign_streams(nodes, {}, 0));
+  }
+}
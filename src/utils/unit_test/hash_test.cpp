@@ -90,4 +90,13 @@ TEST_CASE("Testing convenience functions for hashing", "[hash][utilities]")
       }
     }
   }
+
+  SECTION("splitmix64")
+  {
+    // Outputs of the reference SplitMix64 generator seeded with zero
+    constexpr std::uint64_t gamma = 0x9e3779b97f4a7c15ull;
+    CHECK(lbann::splitmix64(gamma) == 0xe220a8397b1dcdafull);
+    CHECK(lbann::splitmix64(2 * gamma) == 0x6e789e6aa1b965f4ull);
+    CHECK(lbann::splitmix64(0) == 0);
+  }
 }
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+
+namespace {
+
+using MatType = El::Matrix<float, El::Device::CPU>;
+
+/** Small integers keep the sums exact in any reduction order. */
+MatType make_contribution(El::Int height, El::Int width, int rank)
+{
+  MatType m(height, width);
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      m(i, j) = float((rank + 1) * ((i + 3 * j) % 7));
+    }
+  }
+  return m;
+}
+
+void check_sum(MatType const& m, int comm_size)
+{
+  const float rank_sum = float(comm_size * (comm_size + 1) / 2);
+  for (El::Int j = 0; j < m.Width(); ++j) {
+    for (El::Int i = 0; i < m.Height(); ++i) {
+      CHECK(m(i, j) == rank_sum * float((i + 3 * j) % 7));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Hierarchical allreduce", "[mpi][comm]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+  const int rank = comm.get_rank_in_world();
+  const int size = comm.get_procs_in_world();
+  const auto algo = lbann::allreduce_algorithm::hierarchical;
+
+  SECTION("Uneven shards")
+  {
+    auto m = make_contribution(37, 5, rank);
+    comm.allreduce(m, world, El::mpi::SUM, algo);
+    check_sum(m, size);
+  }
+
+  SECTION("Fewer entries than processes per node")
+  {
+    auto m = make_contribution(1, 1, rank);
+    comm.allreduce(m, world, El::mpi::SUM, algo);
+    check_sum(m, size);
+  }
+
+  SECTION("Non-contiguous view")
+  {
+    auto full = make_contribution(16, 8, rank);
+    MatType view;
+    El::View(view, full, El::IR(2, 12), El::ALL);
+    comm.allreduce(view, world, El::mpi::SUM, algo);
+    for (El::Int j = 0; j < view.Width(); ++j) {
+      for (El::Int i = 0; i < view.Height(); ++i) {
+        CHECK(view(i, j) == float(size * (size + 1) / 2) *
+                              float((i + 2 + 3 * j) % 7));
+      }
+    }
+  }
+
+  SECTION("Non-blocking interface")
+  {
+    auto m = make_contribution(64, 3, rank);
+    lbann::Al::request req;
+    comm.nb_allreduce(m, world, req, El::mpi::SUM, algo);
+    comm.wait(req);
+    check_sum(m, size);
+  }
+
+  SECTION("Trainer communicator")
+  {
+    auto m = make_contribution(29, 2, comm.get_rank_in_trainer());
+    comm.allreduce(m, comm.get_trainer_comm(), El::mpi::SUM, algo);
+    check_sum(m, comm.get_procs_per_trainer());
+  }
+}
+
+TEST_CASE("Hierarchical allreduce over emulated nodes", "[mpi][comm]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+  const int rank = comm.get_rank_in_world();
+  const int size = comm.get_procs_in_world();
+  const auto algo = lbann::allreduce_algorithm::hierarchical;
+
+  // Pairs of processes form the nodes, so the hierarchical path runs
+  // even when every process shares one compute node
+  if (size < 4 || size % 2 != 0) {
+    return;
+  }
+  comm.set_hierarchical_node_size(2);
+  const bool tracing = comm.is_collective_tracing();
+  comm.set_collective_tracing(true);
+  comm.take_collective_records();
+
+  SECTION("CPU")
+  {
+    auto m = make_contribution(37, 5, rank);
+    comm.allreduce(m, world, El::mpi::SUM, algo);
+    check_sum(m, size);
+    auto records = comm.take_collective_records();
+    CHECK(records.size() == 1);
+    for (auto const& r : records) {
+      CHECK(r.algorithm == "hierarchical/CPU");
+    }
+  }
+
+#ifdef LBANN_HAS_GPU
+  SECTION("GPU")
+  {
+    auto m = make_contribution(37, 5, rank);
+    El::Matrix<float, El::Device::GPU> m_gpu;
+    El::Copy(m, m_gpu);
+    comm.allreduce(m_gpu, world, El::mpi::SUM, algo);
+    El::Copy(m_gpu, m);
+    check_sum(m, size);
+    auto records = comm.take_collective_records();
+    CHECK(records.size() == 1);
+    for (auto const& r : records) {
+      CHECK(r.algorithm == "hierarchical/GPU");
+    }
+  }
+#endif // LBANN_HAS_GPU
+
+  comm.set_collective_tracing(tracing);
+  comm.set_hierarchical_node_size(0);
+}
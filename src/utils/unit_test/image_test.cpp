@@ -29,6 +29,10 @@
 // File being tested
 #include <lbann/utils/image.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
 // Hide by default because this will create a file.
 TEST_CASE("Testing image utils", "[.image-utils][utilities]")
 {
@@ -86,3 +90,59 @@ TEST_CASE("Testing image utils", "[.image-utils][utilities]")
     }
   }
 }
+
+TEST_CASE("Decoding a JPEG applies its EXIF orientation", "[utilities]")
+{
+  // 3-channel 8x16 image with a different color in each 8x8 block
+  constexpr size_t height = 8;
+  constexpr size_t width = 16;
+  El::Matrix<uint8_t> image(3 * height * width, 1);
+  for (size_t row = 0; row < height; ++row) {
+    for (size_t col = 0; col < width; ++col) {
+      for (size_t channel = 0; channel < 3; ++channel) {
+        image(3 * (col + row * width) + channel, 0) =
+          col < 8 ? 40 + 60 * channel : 220 - 80 * channel;
+      }
+    }
+  }
+  const std::string jpeg =
+    lbann::encode_image(image, {3, height, width}, ".jpg");
+  REQUIRE(jpeg.size() > 2);
+
+  // APP1 segment with a big-endian EXIF block whose only tag is
+  // orientation 6 (rotate 90 degrees clockwise)
+  const std::string exif("\xFF\xE1\x00\x22"
+                         "Exif\0\0"
+                         "MM\x00\x2A\x00\x00\x00\x08"
+                         "\x00\x01"
+                         "\x01\x12\x00\x03\x00\x00\x00\x01\x00\x06\x00\x00"
+                         "\x00\x00\x00\x00",
+                         36);
+  const std::string rotated_jpeg = jpeg.substr(0, 2) + exif + jpeg.substr(2);
+
+  auto decode = [](std::string const& encoded,
+                   El::Matrix<uint8_t>& dst,
+                   std::vector<size_t>& dims) {
+    El::Matrix<uint8_t> src(encoded.size(), 1);
+    std::copy(encoded.begin(), encoded.end(), src.Buffer());
+    lbann::decode_image(src, dst, dims);
+  };
+  El::Matrix<uint8_t> decoded, rotated;
+  std::vector<size_t> dims, rotated_dims;
+  REQUIRE_NOTHROW(decode(jpeg, decoded, dims));
+  REQUIRE_NOTHROW(decode(rotated_jpeg, rotated, rotated_dims));
+  REQUIRE(dims == std::vector<size_t>{3, height, width});
+  REQUIRE(rotated_dims == std::vector<size_t>{3, width, height});
+
+  // Rotated pixel (row, col) is original pixel (height-1-col, row)
+  for (size_t row = 0; row < width; ++row) {
+    for (size_t col = 0; col < height; ++col) {
+      for (size_t channel = 0; channel < 3; ++channel) {
+        const int expected =
+          decoded(3 * (row + (height - 1 - col) * width) + channel, 0);
+        const int actual = rotated(3 * (col + row * height) + channel, 0);
+        CHECK(std::abs(actual - expected) <= 2);
+      }
+    }
+  }
+}
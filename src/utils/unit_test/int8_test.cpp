@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/int8.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("Int8 quantization", "[utilities][int8]")
+{
+  SECTION("Values are rounded to the nearest step and clamped")
+  {
+    const std::vector<float> x = {0.f, 0.5f, -1.f, 1.26f, 3.f, -3.f};
+    const float scale = lbann::int8_scale(1.27f);
+    CHECK(scale == Approx(0.01f));
+    std::vector<int8_t> q(x.size());
+    lbann::quantize_int8(x.data(), 2, 3, 2, false, scale, q.data());
+    CHECK(q == std::vector<int8_t>{0, 50, -100, 126, 127, -127});
+  }
+
+  SECTION("Transposed matrices are written densely")
+  {
+    // X is 2 x 3 with leading dimension 4
+    const std::vector<float> x = {1, 2, -9, -9, 3, 4, -9, -9, 5, 6, -9, -9};
+    std::vector<int8_t> q(6);
+    lbann::quantize_int8(x.data(), 2, 3, 4, true, 1.f, q.data());
+    CHECK(q == std::vector<int8_t>{1, 3, 5, 2, 4, 6});
+  }
+
+  SECTION("Batches of matrices are quantized together")
+  {
+    // Two 2 x 2 matrices, 5 entries apart
+    const std::vector<float> x = {1, 2, 3, 4, -9, 5, 6, 7, 8};
+    std::vector<int8_t> q(8);
+    lbann::quantize_int8(x.data(), 2, 2, 2, true, 1.f, q.data(), 2, 5);
+    CHECK(q == std::vector<int8_t>{1, 3, 2, 4, 5, 7, 6, 8});
+  }
+
+  SECTION("Each column gets its own scale")
+  {
+    const std::vector<float> x = {1.f, -0.5f, 0.f, 0.f, 10.f, 20.f};
+    std::vector<float> scales(3);
+    std::vector<int8_t> q(6);
+    lbann::quantize_int8_columns(x.data(),
+                                 2,
+                                 3,
+                                 2,
+                                 false,
+                                 scales.data(),
+                                 q.data());
+    CHECK(scales[0] == Approx(1.f / 127));
+    CHECK(scales[1] == 1.f);
+    CHECK(scales[2] == Approx(20.f / 127));
+    CHECK(q == std::vector<int8_t>{127, -64, 0, 0, 64, 127});
+  }
+}
+
+TEST_CASE("Int8 GEMM", "[utilities][int8]")
+{
+  // Two batches of A (k x m) and B (k x n)
+  constexpr int m = 70, n = 3, k = 5, batch = 2;
+  std::vector<int8_t> A(k * m * batch), B(k * n * batch);
+  for (size_t i = 0; i < A.size(); ++i) {
+    A[i] = static_cast<int8_t>(static_cast<int>(i * 37 % 255) - 127);
+  }
+  for (size_t i = 0; i < B.size(); ++i) {
+    B[i] = static_cast<int8_t>(static_cast<int>(i * 91 % 255) - 127);
+  }
+  std::vector<double> a_scales(m), b_scales(n);
+  for (int i = 0; i < m; ++i) {
+    a_scales[i] = 0.5 + i;
+  }
+  for (int j = 0; j < n; ++j) {
+    b_scales[j] = 1. / (j + 1);
+  }
+
+  // C has a padded leading dimension that must not be written
+  constexpr int ldc = m + 2;
+  std::vector<double> C(ldc * n * batch, -1.);
+  lbann::gemm_int8(m,
+                   n,
+                   k,
+                   2.,
+                   A.data(),
+                   k * m,
+                   a_scales.data(),
+                   B.data(),
+                   k * n,
+                   b_scales.data(),
+                   C.data(),
+                   ldc,
+                   ldc * n,
+                   batch);
+
+  for (int b = 0; b < batch; ++b) {
+    for (int j = 0; j < n; ++j) {
+      for (int i = 0; i < m; ++i) {
+        long sum = 0;
+        for (int l = 0; l < k; ++l) {
+          sum += A[b * k * m + i * k + l] * B[b * k * n + j * k + l];
+        }
+        const double expected = 2. * a_scales[i] * b_scales[j] * sum;
+        CHECK(C[b * ldc * n + j * ldc + i] == Approx(expected));
+      }
+      CHECK(C[b * ldc * n + j * ldc + m] == -1.);
+      CHECK(C[b * ldc * n + j * ldc + m + 1] == -1.);
+    }
+  }
+}
@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+
+TEST_CASE("Non-blocking barrier", "[mpi][comm]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+
+  // Arriving does not block, so work can go on until the wait
+  lbann::Al::request req;
+  comm.nb_barrier(world, req);
+  const int rank = comm.get_rank_in_world();
+  comm.wait(req);
+  CHECK(req.raw_mpi_req == MPI_REQUEST_NULL);
+  CHECK(comm.allreduce(rank, world) ==
+        comm.get_procs_in_world() * (comm.get_procs_in_world() - 1) / 2);
+
+  // A completed barrier tests true
+  comm.nb_barrier(world, req);
+  while (!comm.test(req)) {
+  }
+  CHECK(comm.test(req));
+}
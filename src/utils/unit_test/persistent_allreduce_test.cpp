@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+
+TEST_CASE("Persistent allreduce", "[mpi][comm]")
+{
+  using MatType = El::Matrix<float, El::Device::CPU>;
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+  const int rank = comm.get_rank_in_world();
+  const float size = float(comm.get_procs_in_world());
+
+  MatType m(13, 4);
+  lbann::Al::persistent_request req;
+  comm.persistent_allreduce_init(m, world, req);
+  CHECK(req.is_registered_on(m.LockedBuffer(), 13 * 4));
+
+  // Restarting reduces whatever the buffer holds at each start
+  for (int step = 0; step < 3; ++step) {
+    El::Fill(m, float(rank + step));
+    comm.start(req);
+    comm.wait(req);
+    const float expected = size * (size - 1) / 2 + size * float(step);
+    for (El::Int j = 0; j < m.Width(); ++j) {
+      for (El::Int i = 0; i < m.Height(); ++i) {
+        CHECK(m(i, j) == expected);
+      }
+    }
+  }
+  CHECK(comm.test(req));
+
+  comm.free(req);
+  CHECK_FALSE(req.is_registered_on(m.LockedBuffer(), 13 * 4));
+}
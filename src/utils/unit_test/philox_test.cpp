@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/philox.hpp>
+#include <lbann/utils/random_number_generators.hpp>
+
+#include <thread>
+#include <vector>
+
+using lbann::philox_rng;
+
+TEST_CASE("Philox4x32-10 known answers", "[random][utilities]")
+{
+  // Known-answer vectors from the Random123 distribution.
+  SECTION("Zero counter and key")
+  {
+    auto out = philox_rng::generate({0, 0, 0, 0}, {0, 0});
+    CHECK(out == philox_rng::counter_type{0x6627e8d5u,
+                                          0xe169c58du,
+                                          0xbc57ac4cu,
+                                          0x9b00dbd8u});
+  }
+  SECTION("Saturated counter and key")
+  {
+    auto out =
+      philox_rng::generate({0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu},
+                           {0xffffffffu, 0xffffffffu});
+    CHECK(out == philox_rng::counter_type{0x408f276du,
+                                          0x41c83b0eu,
+                                          0xa20bc7c6u,
+                                          0x6d5451fdu});
+  }
+  SECTION("Digits of pi")
+  {
+    auto out =
+      philox_rng::generate({0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u},
+                           {0xa4093822u, 0x299f31d0u});
+    CHECK(out == philox_rng::counter_type{0xd16cfe09u,
+                                          0x94fdccebu,
+                                          0x5001e420u,
+                                          0x24126ea1u});
+  }
+}
+
+TEST_CASE("Philox stream", "[random][utilities]")
+{
+  SECTION("discard matches drawing")
+  {
+    philox_rng a(17, 42, 3), b(17, 42, 3);
+    for (size_t n : {1, 3, 4, 9}) {
+      for (size_t i = 0; i < n; ++i) {
+        a();
+      }
+      b.discard(n);
+      CHECK(a() == b());
+    }
+  }
+  SECTION("distinct streams differ")
+  {
+    philox_rng a(17, 42, 3), b(17, 42, 4), c(17, 43, 3), d(18, 42, 3);
+    const auto x = a();
+    CHECK(x != b());
+    CHECK(x != c());
+    CHECK(x != d());
+  }
+}
+
+namespace {
+std::vector<uint32_t> draw_sample(uint64_t epoch,
+                                  uint64_t sample_id,
+                                  uint32_t transform_id)
+{
+  lbann::io_sample_stream_scope scope(epoch,
+                                      sample_id,
+                                      lbann::execution_mode::training);
+  lbann::set_io_sample_transform(transform_id);
+  std::vector<uint32_t> draws(8);
+  for (auto& d : draws) {
+    d = lbann::get_io_sample_generator()();
+  }
+  return draws;
+}
+} // namespace
+
+TEST_CASE("Per-sample I/O streams", "[random][utilities]")
+{
+  lbann::init_io_random(1234, 2);
+  REQUIRE_FALSE(lbann::is_io_sample_stream_active());
+
+  const auto reference = draw_sample(3, 1001, 2);
+  REQUIRE_FALSE(lbann::is_io_sample_stream_active());
+
+  SECTION("independent of call order")
+  {
+    draw_sample(3, 7, 2);
+    draw_sample(4, 1001, 2);
+    CHECK(draw_sample(3, 1001, 2) == reference);
+  }
+  SECTION("independent of thread")
+  {
+    std::vector<uint32_t> other;
+    std::thread t([&other]() { other = draw_sample(3, 1001, 2); });
+    t.join();
+    CHECK(other == reference);
+  }
+  SECTION("keyed on epoch, sample, and transform")
+  {
+    CHECK(draw_sample(4, 1001, 2) != reference);
+    CHECK(draw_sample(3, 1002, 2) != reference);
+    CHECK(draw_sample(3, 1001, 1) != reference);
+  }
+}
@@ -379,3 +379,59 @@ TEMPLATE_LIST_TEST_CASE("Testing gaussian_fill",
   }
 }
 #endif // Disabled test
+
+#ifdef LBANN_HAS_GPU
+TEST_CASE("Testing gaussian_fill_gpu", "[random][utilities][mpi]")
+{
+
+  // Typedefs
+  using StarMatType =
+    El::DistMatrix<double, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+
+  // Parameters
+  const float mean = 12.3f;
+  const float stddev = 4.56f;
+  const El::Int height = 41;
+  const El::Int width = 31;
+  const uint64_t seed = 20200319;
+
+  // Initialization
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const auto& grid = comm.get_trainer_grid();
+
+  // Fill matrices with different distributions from the same seed
+  El::DistMatrix<float, El::MC, El::MR, El::ELEMENT, El::Device::GPU> mat_mcmr(
+    height,
+    width,
+    grid);
+  El::DistMatrix<float, El::STAR, El::VC, El::ELEMENT, El::Device::GPU>
+    mat_starvc(height, width, grid);
+  lbann::gaussian_fill_gpu(mat_mcmr, mean, stddev, seed);
+  lbann::gaussian_fill_gpu(mat_starvc, mean, stddev, seed);
+  StarMatType mcmr_copy(grid), starvc_copy(grid);
+  El::Copy(mat_mcmr, mcmr_copy);
+  El::Copy(mat_starvc, starvc_copy);
+
+  SECTION("Values do not depend on the distribution")
+  {
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        REQUIRE(mcmr_copy.GetLocal(row, col) ==
+                starvc_copy.GetLocal(row, col));
+      }
+    }
+  }
+
+  SECTION("Values are normally distributed")
+  {
+    std::vector<double> values;
+    for (El::Int col = 0; col < width; ++col) {
+      for (El::Int row = 0; row < height; ++row) {
+        values.push_back(mcmr_copy.GetLocal(row, col));
+      }
+    }
+    REQUIRE(anderson_darling_test(values, mean, stddev) <
+            anderson_darling_critical_value);
+  }
+}
+#endif // LBANN_HAS_GPU
@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+
+TEST_CASE("Column reduce-scatter", "[mpi][comm]")
+{
+  using StarStar = El::DistMatrix<float, El::STAR, El::STAR>;
+  using StarVC = El::DistMatrix<float, El::STAR, El::VC>;
+
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  auto const& grid = comm.get_trainer_grid();
+  const int rank = comm.get_rank_in_trainer();
+  const int size = comm.get_procs_per_trainer();
+  const El::Int height = 5;
+  const El::Int width = 3 * size + 1;
+
+  // Rank r contributes (r+1) * (i + j * height)
+  StarStar src(height, width, grid);
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      src.Set(i, j, float((rank + 1) * (i + j * height)));
+    }
+  }
+  StarVC dst(height, width, grid);
+  REQUIRE(lbann::lbann_comm::is_column_reduce_scatter_supported<float>(src,
+                                                                       dst));
+  comm.reduce_scatter_columns<float>(src, dst);
+
+  const float rank_sum = float(size * (size + 1) / 2);
+  for (El::Int jl = 0; jl < dst.LocalWidth(); ++jl) {
+    const El::Int j = dst.GlobalCol(jl);
+    for (El::Int i = 0; i < height; ++i) {
+      CHECK(dst.GetLocal(i, jl) == rank_sum * float(i + j * height));
+    }
+  }
+
+  SECTION("Unsupported distributions are rejected")
+  {
+    El::DistMatrix<float, El::MC, El::MR> other(height, width, grid);
+    CHECK_FALSE(
+      lbann::lbann_comm::is_column_reduce_scatter_supported<float>(other,
+                                                                   dst));
+  }
+}
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/scratch_arena.hpp>
+
+#include <cstdint>
+
+using namespace lbann::utils;
+
+TEST_CASE("Scratch arena", "[utilities][scratch_arena]")
+{
+  auto& arena = get_scratch_arena();
+
+  SECTION("Matrices outside a scope own their memory")
+  {
+    REQUIRE_FALSE(arena.is_active());
+    auto mat = get_scratch_matrix<uint8_t>(16, 1);
+    CHECK_FALSE(mat.Viewing());
+    CHECK(mat.Height() == 16);
+  }
+
+  SECTION("Matrices inside a scope view aligned arena memory")
+  {
+    scratch_arena_scope scope;
+    REQUIRE(arena.is_active());
+    auto a = get_scratch_matrix<uint8_t>(3, 1);
+    auto b = get_scratch_matrix<float>(10, 2);
+    CHECK(a.Viewing());
+    CHECK(b.Viewing());
+    CHECK(b.LDim() == 10);
+    CHECK(reinterpret_cast<uintptr_t>(a.Buffer()) %
+            scratch_arena::alignment ==
+          0);
+    CHECK(reinterpret_cast<uintptr_t>(b.Buffer()) %
+            scratch_arena::alignment ==
+          0);
+    CHECK(static_cast<void*>(a.Buffer()) != static_cast<void*>(b.Buffer()));
+  }
+
+  SECTION("Memory is reused after the outermost scope ends")
+  {
+    void* first = nullptr;
+    {
+      scratch_arena_scope scope;
+      first = arena.allocate(100);
+      {
+        scratch_arena_scope inner;
+      }
+      // The inner scope does not reset the arena.
+      CHECK(arena.allocate(100) != first);
+    }
+    CHECK_FALSE(arena.is_active());
+    scratch_arena_scope scope;
+    CHECK(arena.allocate(100) == first);
+  }
+
+  SECTION("Blocks are merged when a sample outgrows the arena")
+  {
+    {
+      scratch_arena_scope scope;
+      arena.allocate(1);
+      arena.allocate(arena.get_capacity() + 1);
+      CHECK(arena.get_num_blocks() > 1);
+    }
+    CHECK(arena.get_num_blocks() == 1);
+    const size_t capacity = arena.get_capacity();
+    scratch_arena_scope scope;
+    arena.allocate(capacity);
+    CHECK(arena.get_num_blocks() == 1);
+  }
+
+  SECTION("Reserving sizes a single block up front")
+  {
+    const size_t bytes = 2 * arena.get_capacity() + 1;
+    arena.reserve(bytes);
+    CHECK(arena.get_num_blocks() == 1);
+    CHECK(arena.get_capacity() >= bytes);
+    scratch_arena_scope scope;
+    arena.allocate(bytes);
+    CHECK(arena.get_num_blocks() == 1);
+  }
+}
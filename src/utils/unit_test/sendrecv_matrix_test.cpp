@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+
+using MatrixTypes = h2::meta::TL<El::Matrix<float, El::Device::CPU>
+#ifdef LBANN_HAS_GPU
+                                 ,
+                                 El::Matrix<float, El::Device::GPU>
+#endif
+                                 >;
+
+TEMPLATE_LIST_TEST_CASE("Matrix send/recv", "[mpi][comm]", MatrixTypes)
+{
+  using MatType = TestType;
+
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const int rank = comm.get_rank_in_world();
+  const int size = comm.get_procs_in_world();
+  // Pair neighbors; an odd rank out exchanges with itself
+  const int partner = (rank ^ 1) < size ? (rank ^ 1) : rank;
+
+  MatType snd(6, 4), rcv(6, 4);
+  El::Fill(snd, float(rank));
+  El::Zero(rcv);
+  comm.sendrecv_matrix<float>(snd, rcv, partner);
+
+  El::Matrix<float, El::Device::CPU> result;
+  El::Copy(rcv, result);
+  for (El::Int j = 0; j < result.Width(); ++j) {
+    for (El::Int i = 0; i < result.Height(); ++i) {
+      CHECK(result(i, j) == float(partner));
+    }
+  }
+}
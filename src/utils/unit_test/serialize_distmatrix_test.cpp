@@ -31,6 +31,9 @@
 
 #include "MPITestHelpers.hpp"
 
+#include <memory>
+#include <type_traits>
+
 // Enumerate all DistMatrix types. Start by getting all the
 // distributions.
 template <typename T, El::Device D>
@@ -105,6 +108,45 @@ TEMPLATE_LIST_TEST_CASE("DistMatrix serialization",
       }
     }
   }
+
+  SECTION("Binary archive, restored into another distribution")
+  {
+    using T = std::remove_pointer_t<decltype(mat.Buffer())>;
+    El::MakeUniform(mat);
+
+    auto dist = mat.DistData();
+    dist.colDist = (mat.ColDist() == El::STAR ? El::VC : El::STAR);
+    dist.rowDist = (mat.ColDist() == El::STAR ? El::STAR : El::VC);
+    dist.colAlign = 0;
+    dist.rowAlign = 0;
+    std::unique_ptr<El::AbstractDistMatrix<T>> other_restore(
+      El::AbstractDistMatrix<T>::Instantiate(dist));
+    {
+      cereal::BinaryOutputArchive oarchive(ss);
+      REQUIRE_NOTHROW(oarchive(mat));
+    }
+    {
+      cereal::BinaryInputArchive iarchive(ss);
+      REQUIRE_NOTHROW(iarchive(*other_restore));
+    }
+
+    // Compare full copies of both
+    dist.colDist = El::STAR;
+    dist.rowDist = El::STAR;
+    std::unique_ptr<El::AbstractDistMatrix<T>> expected(
+      El::AbstractDistMatrix<T>::Instantiate(dist)),
+      restored(El::AbstractDistMatrix<T>::Instantiate(dist));
+    El::Copy(mat, *expected);
+    El::Copy(*other_restore, *restored);
+    REQUIRE(restored->Height() == mat.Height());
+    REQUIRE(restored->Width() == mat.Width());
+    for (El::Int col = 0; col < mat.Width(); ++col) {
+      for (El::Int row = 0; row < mat.Height(); ++row) {
+        INFO("(Row,Col) = (" << row << "," << col << ")");
+        CHECK(expected->GetLocal(row, col) == restored->GetLocal(row, col));
+      }
+    }
+  }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 
 #ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
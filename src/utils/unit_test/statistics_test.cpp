@@ -94,3 +94,52 @@ TEST_CASE("Running statistics accumulation", "[utils][stats]")
   CHECK(stats.variance() == Approx(0.5));
   CHECK(stats.stddev() == Approx(std::sqrt(0.5)));
 }
+
+TEST_CASE("Running statistics merge", "[utils][stats]")
+{
+  using StatsType = lbann::RunningStats;
+  StatsType all, first, second;
+  for (double x : {5., 4., 5., 6.}) {
+    all.insert(x);
+    first.insert(x);
+  }
+  for (double x : {4.5, 5.5, 1.}) {
+    all.insert(x);
+    second.insert(x);
+  }
+
+  SECTION("Merging disjoint partial statistics matches a single pass")
+  {
+    first.merge(second);
+    CHECK(first.samples() == all.samples());
+    CHECK(first.min() == all.min());
+    CHECK(first.max() == all.max());
+    CHECK(first.mean() == Approx(all.mean()));
+    CHECK(first.variance() == Approx(all.variance()));
+  }
+
+  SECTION("Merging with empty statistics is a no-op")
+  {
+    StatsType empty;
+    empty.merge(all);
+    CHECK(empty.samples() == all.samples());
+    CHECK(empty.mean() == all.mean());
+    all.merge(StatsType{});
+    CHECK(all.samples() == 7UL);
+    CHECK(all.variance() == Approx(empty.variance()));
+  }
+
+  SECTION("Statistics can be restored from their moments")
+  {
+    StatsType restored(all.samples(),
+                       all.mean(),
+                       all.sum_squared_deviations(),
+                       all.min(),
+                       all.max());
+    CHECK(restored.samples() == all.samples());
+    CHECK(restored.mean() == all.mean());
+    CHECK(restored.variance() == all.variance());
+    CHECK(restored.min() == all.min());
+    CHECK(restored.max() == all.max());
+  }
+}
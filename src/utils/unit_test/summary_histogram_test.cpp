@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/utils/summary_histogram.hpp"
+
+#include <vector>
+
+using namespace lbann::summary_details;
+
+TEST_CASE("Histogram of a local matrix", "[utils][summary]")
+{
+  const std::vector<double> limits = {-1.0, 0.0, 1.0};
+
+  SECTION("Empty matrix")
+  {
+    El::Matrix<float, El::Device::CPU> mat(0, 0);
+    histogram_stats stats;
+    cpu_local_histogram(mat, limits, stats);
+    CHECK(stats.buckets == std::vector<double>(4, 0.0));
+    CHECK(stats.sum == 0.0);
+    CHECK(stats.sqsum == 0.0);
+  }
+
+  SECTION("Bucket boundaries match std::upper_bound")
+  {
+    El::Matrix<double, El::Device::CPU> mat(3, 2);
+    mat(0, 0) = -2.0;
+    mat(1, 0) = -1.0;
+    mat(2, 0) = -0.5;
+    mat(0, 1) = 0.0;
+    mat(1, 1) = 0.5;
+    mat(2, 1) = 3.0;
+    histogram_stats stats;
+    cpu_local_histogram(mat, limits, stats);
+    CHECK(stats.buckets == std::vector<double>{1.0, 2.0, 2.0, 1.0});
+    CHECK(stats.min == -2.0);
+    CHECK(stats.max == 3.0);
+    CHECK(stats.sum == Approx(0.0));
+    CHECK(stats.sqsum == Approx(14.5));
+  }
+
+  SECTION("Padding in a view is ignored")
+  {
+    El::Matrix<float, El::Device::CPU> mat(4, 2);
+    El::Fill(mat, 5.f);
+    auto view = mat(El::IR(0, 2), El::ALL);
+    El::Fill(view, 0.5f);
+    histogram_stats stats;
+    cpu_local_histogram(view, limits, stats);
+    CHECK(stats.buckets == std::vector<double>{0.0, 0.0, 4.0, 0.0});
+    CHECK(stats.max == 0.5);
+  }
+}
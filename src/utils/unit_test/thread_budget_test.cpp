@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/threads/thread_budget.hpp>
+
+#include <numeric>
+#include <vector>
+
+using lbann::thread_budget_policy;
+
+namespace {
+std::vector<int> make_cpus(int count, int first = 0)
+{
+  std::vector<int> cpus(count);
+  std::iota(cpus.begin(), cpus.end(), first);
+  return cpus;
+}
+} // namespace
+
+TEST_CASE("Thread budget division", "[utilities][thread_budget]")
+{
+  SECTION("Requests that fit are granted in CPU order")
+  {
+    auto budget = lbann::divide_thread_budget(make_cpus(12, 4),
+                                              thread_budget_policy::compute,
+                                              4,
+                                              2,
+                                              3,
+                                              1);
+    CHECK_FALSE(budget.oversubscribed);
+    CHECK(budget.num_omp_threads == 4);
+    CHECK(budget.num_io_threads == 2);
+    CHECK(budget.num_python_workers == 3);
+    CHECK(budget.omp_cpus == std::vector<int>{4, 5, 6, 7});
+    CHECK(budget.reserved_cpus == std::vector<int>{8});
+    CHECK(budget.io_cpus == std::vector<int>{9, 10});
+    CHECK(budget.python_cpus == std::vector<int>{11, 12, 13});
+  }
+
+  SECTION("The compute policy favors OpenMP")
+  {
+    auto budget = lbann::divide_thread_budget(make_cpus(8),
+                                              thread_budget_policy::compute,
+                                              8,
+                                              4,
+                                              4,
+                                              0);
+    CHECK(budget.num_omp_threads == 6);
+    CHECK(budget.num_io_threads == 1);
+    CHECK(budget.num_python_workers == 1);
+  }
+
+  SECTION("The io policy favors I/O threads and Python workers")
+  {
+    auto budget = lbann::divide_thread_budget(make_cpus(8),
+                                              thread_budget_policy::io,
+                                              8,
+                                              4,
+                                              4,
+                                              0);
+    CHECK(budget.num_omp_threads == 1);
+    CHECK(budget.num_io_threads == 4);
+    CHECK(budget.num_python_workers == 3);
+  }
+
+  SECTION("The balanced policy splits in proportion to the requests")
+  {
+    auto budget = lbann::divide_thread_budget(make_cpus(8),
+                                              thread_budget_policy::balanced,
+                                              9,
+                                              5,
+                                              0,
+                                              0);
+    CHECK(budget.num_omp_threads + budget.num_io_threads == 8);
+    CHECK(budget.num_omp_threads == 5);
+    CHECK(budget.num_io_threads == 3);
+  }
+
+  SECTION("Python workers share the I/O CPUs when none are requested")
+  {
+    auto budget = lbann::divide_thread_budget(make_cpus(6),
+                                              thread_budget_policy::compute,
+                                              4,
+                                              2,
+                                              0,
+                                              0);
+    CHECK(budget.python_cpus == budget.io_cpus);
+    CHECK(budget.num_python_workers == budget.num_io_threads);
+  }
+
+  SECTION("Too few CPUs makes everyone share")
+  {
+    auto budget = lbann::divide_thread_budget(make_cpus(2),
+                                              thread_budget_policy::balanced,
+                                              4,
+                                              2,
+                                              2,
+                                              1);
+    CHECK(budget.oversubscribed);
+    CHECK(budget.reserved_cpus.empty());
+    CHECK(budget.omp_cpus == make_cpus(2));
+    CHECK(budget.io_cpus == make_cpus(2));
+    CHECK(budget.python_cpus == make_cpus(2));
+  }
+
+  SECTION("Policies round-trip through strings")
+  {
+    for (auto policy : {thread_budget_policy::none,
+                        thread_budget_policy::compute,
+                        thread_budget_policy::io,
+                        thread_budget_policy::balanced}) {
+      CHECK(lbann::thread_budget_policy_from_string(lbann::to_string(
+              policy)) == policy);
+    }
+  }
+}
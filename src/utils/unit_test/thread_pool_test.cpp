@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/threads/thread_pool.hpp>
+
+#include <array>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Work-stealing deque", "[utilities][thread_pool]")
+{
+  lbann::work_stealing_deque<int> deque(2);
+
+  SECTION("The owner pops in LIFO order and grows past capacity")
+  {
+    for (int i = 0; i < 10; ++i) {
+      deque.push(i);
+    }
+    CHECK(deque.size() == 10);
+    int x = -1;
+    for (int i = 9; i >= 0; --i) {
+      REQUIRE(deque.pop(x));
+      CHECK(x == i);
+    }
+    CHECK_FALSE(deque.pop(x));
+  }
+
+  SECTION("Thieves take the oldest value")
+  {
+    deque.push(1);
+    deque.push(2);
+    int x = -1;
+    REQUIRE(deque.steal(x));
+    CHECK(x == 1);
+    REQUIRE(deque.pop(x));
+    CHECK(x == 2);
+    CHECK_FALSE(deque.steal(x));
+  }
+
+  SECTION("Every value is taken exactly once under contention")
+  {
+    constexpr int num_values = 20000;
+    std::vector<std::atomic<int>> taken(num_values);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t) {
+      thieves.emplace_back([&]() {
+        int x;
+        while (!done) {
+          if (deque.steal(x)) {
+            ++taken[x];
+          }
+        }
+      });
+    }
+    for (int i = 0; i < num_values; ++i) {
+      deque.push(i);
+      int x;
+      if (i % 3 == 0 && deque.pop(x)) {
+        ++taken[x];
+      }
+    }
+    int x;
+    while (deque.pop(x)) {
+      ++taken[x];
+    }
+    done = true;
+    for (auto& t : thieves) {
+      t.join();
+    }
+    for (auto& count : taken) {
+      CHECK(count == 1);
+    }
+  }
+}
+
+TEST_CASE("Pooled task nodes", "[utilities][thread_pool]")
+{
+  lbann::pooled_task_allocator allocator;
+
+  SECTION("Nodes are recycled instead of reallocated")
+  {
+    auto* task = allocator.acquire(1);
+    REQUIRE(task != nullptr);
+    allocator.release(task, task);
+    auto* again = allocator.acquire(1);
+    CHECK(again == task);
+    CHECK(allocator.capacity() == lbann::pooled_task_allocator::chunk_size);
+    allocator.release(again, again);
+  }
+
+  SECTION("Large callables fall back to the heap")
+  {
+    std::vector<int> big(lbann::pooled_task::inline_capacity, 1);
+    std::array<char, 2 * lbann::pooled_task::inline_capacity> padding{};
+    int sum = 0;
+    lbann::pooled_task task;
+    task.emplace([&sum, big, padding]() {
+      sum = std::accumulate(big.begin(), big.end(), 0) + padding[0];
+    });
+    task.run();
+    CHECK(sum == static_cast<int>(lbann::pooled_task::inline_capacity));
+  }
+}
+
+TEST_CASE("Thread pool", "[utilities][thread_pool]")
+{
+  lbann::thread_pool pool;
+  pool.launch_threads(4);
+
+  SECTION("Futures carry results")
+  {
+    auto f = pool.submit_job([]() { return 42; });
+    CHECK(f.get() == 42);
+  }
+
+  SECTION("Worker ids are distinct and outside threads report 0")
+  {
+    std::vector<std::atomic<int>> seen(pool.get_num_threads());
+    pool.parallel_for(0, 1000, [&](int) {
+      ++seen[pool.get_local_thread_id()];
+    });
+    CHECK(pool.get_local_thread_id() == 0);
+    CHECK(std::accumulate(seen.begin(), seen.end(), 0) == 1000);
+  }
+
+  SECTION("parallel_for visits every index once")
+  {
+    std::vector<std::atomic<int>> visits(10007);
+    pool.parallel_for(size_t{0}, visits.size(), [&](size_t i) {
+      ++visits[i];
+    }, size_t{16});
+    for (auto& v : visits) {
+      CHECK(v == 1);
+    }
+  }
+
+  SECTION("parallel_for nests inside a job")
+  {
+    std::atomic<int> total{0};
+    auto f = pool.submit_job([&]() {
+      pool.parallel_for(0, 100, [&](int i) { total += i; });
+      return true;
+    });
+    CHECK(f.get());
+    CHECK(total == 4950);
+  }
+
+  SECTION("parallel_for rethrows the first exception")
+  {
+    CHECK_THROWS_AS(pool.parallel_for(0,
+                                      100,
+                                      [](int i) {
+                                        if (i == 50) {
+                                          throw std::runtime_error("bad");
+                                        }
+                                      }),
+                    std::runtime_error);
+  }
+
+  SECTION("for_each_thread runs once on every worker")
+  {
+    std::vector<std::atomic<int>> calls(pool.get_num_threads());
+    pool.for_each_thread([&](int tid) { ++calls[tid]; });
+    for (auto& c : calls) {
+      CHECK(c == 1);
+    }
+  }
+
+  SECTION("Work groups report failures")
+  {
+    std::atomic<int> count{0};
+    for (int i = 0; i < 20; ++i) {
+      pool.submit_job_to_work_group([&]() { return ++count > 0; });
+    }
+    CHECK(pool.finish_work_group());
+    CHECK(count == 20);
+
+    pool.submit_job_to_work_group([]() { return false; });
+    CHECK_THROWS(pool.finish_work_group());
+  }
+
+  SECTION("Threads can be reaped and relaunched")
+  {
+    pool.reap_threads();
+    CHECK(pool.get_num_threads() == 0);
+    pool.launch_threads(2);
+    auto f = pool.submit_job([]() { return 7; });
+    CHECK(f.get() == 7);
+  }
+}
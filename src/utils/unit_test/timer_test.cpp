@@ -28,6 +28,7 @@
 
 #include "lbann/utils/accumulating_timer.hpp"
 #include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/duration_histogram.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/utils/timer_map.hpp"
 
@@ -142,3 +143,56 @@ TEST_CASE("Accumulating timer", "[utils][timer]")
     CHECK(timer.samples() == 0UL);
   }
 }
+
+TEST_CASE("Duration histogram", "[utils][timer]")
+{
+  lbann::DurationHistogram hist;
+  CHECK(hist.samples() == 0UL);
+  CHECK(hist.percentile(0.5) == 0.);
+
+  // 1 ms, 2 ms, ..., 100 ms
+  for (int i = 1; i <= 100; ++i) {
+    hist.insert(i * 1e-3);
+  }
+  CHECK(hist.samples() == 100UL);
+  CHECK(hist.percentile(0.5) == Approx(50e-3).epsilon(0.1));
+  CHECK(hist.percentile(0.95) == Approx(95e-3).epsilon(0.1));
+  CHECK(hist.percentile(0.) >= 1e-3);
+  CHECK(hist.percentile(1.) <= 100e-3);
+
+  hist.reset();
+  CHECK(hist.samples() == 0UL);
+  CHECK(hist.percentile(0.99) == 0.);
+}
+
+TEST_CASE("Timer percentiles", "[utils][timer]")
+{
+  lbann::AccumulatingTimer timer;
+  for (int i = 0; i < 99; ++i) {
+    timer.insert(0.01);
+  }
+  timer.insert(1.);
+  CHECK(timer.samples() == 100UL);
+  CHECK(timer.max() == 1.);
+  CHECK(timer.percentile(0.5) == Approx(0.01).epsilon(0.1));
+  CHECK(timer.percentile(0.99) == Approx(0.01).epsilon(0.1));
+  CHECK(timer.percentile(1.) == 1.);
+
+  timer.reset_statistics();
+  CHECK(timer.percentile(0.5) == 0.);
+}
+
+TEST_CASE("Recording into a scope", "[utils][timer]")
+{
+  lbann::TimerMap timers("step");
+  {
+    lbann::ScopeTimer step(timers, "optimizer");
+    step.record("gradient sync wait", 0.25);
+    step.record("gradient sync wait", 0.75);
+  }
+  auto const& wait =
+    timers.scope("optimizer").scope("gradient sync wait").timer();
+  CHECK(wait.samples() == 2UL);
+  CHECK(wait.total_time() == 1.);
+  CHECK(timers.scope("optimizer").timer().samples() == 1UL);
+}
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/comm_impl.hpp>
+
+#include <cstdlib>
+#include <string>
+
+TEST_CASE("Topology-aware trainer placement", "[mpi][comm]")
+{
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  const int rank = comm.get_rank_in_world();
+  const int size = comm.get_procs_in_world();
+  const int orig_ppt = comm.get_procs_per_trainer();
+
+  // Addresses that sort in reverse world-rank order
+  const std::string addr = "switch0.node" + std::to_string(size - 1 - rank);
+  setenv("LBANN_TOPOLOGY_ADDR", addr.c_str(), 1);
+  comm.split_trainers(1, -1, true);
+
+  CHECK(comm.get_trainer_rank() == size - 1 - rank);
+  CHECK(comm.get_rank_in_trainer() == 0);
+  for (int r = 0; r < size; ++r) {
+    const int t = comm.map_world_rank_to_trainer_rank(r);
+    CHECK(t == size - 1 - r);
+    CHECK(comm.get_world_rank(t, 0) == r);
+  }
+
+  unsetenv("LBANN_TOPOLOGY_ADDR");
+  comm.split_trainers(orig_ppt);
+  CHECK(comm.get_trainer_rank() == rank / orig_ppt);
+}
@@ -85,6 +85,7 @@ data_type_weights<TensorDataType>::data_type_weights(const WeightsType& other)
 
   // Deep copies
   m_values.reset(other.m_values ? other.m_values->Copy() : nullptr);
+  m_deferred_values = other.m_deferred_values;
   m_initializer =
     (other.m_initializer ? other.m_initializer->clone() : nullptr);
   m_optimizer = (other.m_optimizer ? other.m_optimizer->clone() : nullptr);
@@ -101,6 +102,7 @@ auto data_type_weights<TensorDataType>::operator=(const WeightsType& other)
 
   // Deep copies
   m_values.reset(other.m_values ? other.m_values->Copy() : nullptr);
+  m_deferred_values = other.m_deferred_values;
   m_initializer =
     (other.m_initializer ? other.m_initializer->clone() : nullptr);
   m_optimizer = (other.m_optimizer ? other.m_optimizer->clone() : nullptr);
@@ -223,6 +225,7 @@ void data_type_weights<TensorDataType>::set_optimizer(
     LBANN_ERROR("Optimizer has incompatible dynamic type");
   else
     m_optimizer.reset();
+  this->mark_modified();
 }
 
 // -----------------------------------------------
@@ -282,13 +285,16 @@ void data_type_weights<TensorDataType>::do_setup_()
   m_values->AlignWith(matrix_dist);
   m_values->Resize(this->get_matrix_height(), this->get_matrix_width());
 
-  // Initialize values
-  if (m_initializer != nullptr) {
-    m_initializer->fill(*m_values);
-  }
-  else {
-    El::Zero(*m_values);
+  // Initialize values, unless they are loaded on first access
+  if (!m_deferred_values) {
+    if (m_initializer != nullptr) {
+      m_initializer->fill(*m_values);
+    }
+    else {
+      El::Zero(*m_values);
+    }
   }
+  this->mark_modified();
 
   // Setup optimizer
   if (m_optimizer != nullptr) {
@@ -304,6 +310,8 @@ template <typename TensorDataType>
 auto data_type_weights<TensorDataType>::get_values() const
   -> const AbsDistMatrixType&
 {
+  materialize_values_();
+
   // If the weights are not sharded, return m_values directly
   if (!this->is_sharded()) {
     return *m_values;
@@ -320,6 +328,9 @@ template <typename TensorDataType>
 auto data_type_weights<TensorDataType>::get_values_sharded()
   -> AbsDistMatrixType&
 {
+  // The caller may modify the shard
+  m_full_weights_valid = false;
+  this->mark_modified();
   return const_cast<AbsDistMatrixType&>(
     static_cast<const data_type_weights&>(*this).get_values_sharded());
 }
@@ -334,6 +345,7 @@ auto data_type_weights<TensorDataType>::get_values_sharded() const
                 "\" "
                 "before they are set up");
   }
+  materialize_values_();
   return *m_values;
 }
 
@@ -353,6 +365,31 @@ void data_type_weights<TensorDataType>::set_values(
                 values.Width());
   }
   El::Copy(values, *m_values);
+  m_deferred_values = nullptr;
+  m_full_weights_valid = false;
+  this->mark_modified();
+}
+
+template <typename TensorDataType>
+void data_type_weights<TensorDataType>::set_deferred_values(
+  std::function<void(AbsDistMatrixType&)> source)
+{
+  m_deferred_values = std::move(source);
+  m_full_weights_valid = false;
+  this->mark_modified();
+}
+
+template <typename TensorDataType>
+void data_type_weights<TensorDataType>::materialize_values_() const
+{
+  if (!m_deferred_values || m_values == nullptr) {
+    return;
+  }
+  // Drop the source first so that it can use the accessors
+  auto source = std::move(m_deferred_values);
+  m_deferred_values = nullptr;
+  source(*m_values);
+  m_full_weights_valid = false;
 }
 
 template <typename TensorDataType>
@@ -446,18 +483,26 @@ void data_type_weights<TensorDataType>::set_value(TensorDataType value,
 #endif // LBANN_DEBUG
 
   // Set value if it is local
+  materialize_values_();
   auto& values = *m_values;
   if (values.IsLocal(row, col)) {
     values.SetLocal(values.LocalRow(row), values.LocalCol(col), value);
   }
+  m_full_weights_valid = false;
+  this->mark_modified();
 }
 
 template <typename TensorDataType>
 void data_type_weights<TensorDataType>::request_full_weights_async() const
 {
+  if (!this->is_sharded() || m_full_weights_valid) {
+    return;
+  }
   m_values_view->AlignWith(this->get_matrix_distribution());
   m_values_view->Resize(this->get_matrix_height(), this->get_matrix_width());
+  materialize_values_();
   El::Copy(*m_values, *m_values_view);
+  m_full_weights_valid = true;
 }
 
 template <typename TensorDataType>
@@ -471,9 +516,23 @@ void data_type_weights<TensorDataType>::release_full_weights() const
 {
   if (this->is_sharded()) {
     m_values_view->Empty();
+    m_full_weights_valid = false;
   }
 }
 
+template <typename TensorDataType>
+bool data_type_weights<TensorDataType>::has_full_weights() const noexcept
+{
+  return this->is_sharded() && m_full_weights_valid;
+}
+
+template <typename TensorDataType>
+size_t data_type_weights<TensorDataType>::get_full_weights_bytes() const
+{
+  return sizeof(TensorDataType) * this->get_matrix_height() *
+         this->get_matrix_width();
+}
+
 template <typename TensorDataType>
 void data_type_weights<TensorDataType>::reconcile_values()
 {
@@ -567,6 +626,8 @@ bool data_type_weights<TensorDataType>::load_from_save(
       return false;
     }
     El::Read(*m_values, full_path, el_mode, true);
+    m_deferred_values = nullptr;
+    this->mark_modified();
   }
   return true;
 }
@@ -585,7 +646,11 @@ template <typename TensorDataType>
 void data_type_weights<TensorDataType>::do_move_values_(
   data_type_weights& other)
 {
+  other.materialize_values_();
   m_values = std::move(other.m_values);
+  m_deferred_values = nullptr;
+  m_full_weights_valid = false;
+  this->mark_modified();
 }
 
 template <typename TensorDataType>
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/weights/flat_weights_buffer.hpp"
+#include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+namespace {
+
+/** Slots start on 256-byte boundaries, as fresh allocations would. */
+constexpr size_t slot_alignment = 256;
+
+template <typename T>
+size_t aligned_slot_size(El::AbstractDistMatrix<T> const& mat)
+{
+  constexpr size_t align = slot_alignment / sizeof(T);
+  const size_t size = mat.LocalHeight() * mat.LocalWidth();
+  return (size + align - 1) / align * align;
+}
+
+/** Copy the local data of @c mat into @c slot and make it a view. */
+template <typename T, El::Device Device>
+void move_to_slot(El::AbstractDistMatrix<T>& mat, T* slot)
+{
+  const El::Int local_height = mat.LocalHeight();
+  const El::Int ldim = std::max(local_height, El::Int{1});
+  El::Matrix<T, Device> slot_view;
+  slot_view.Attach(local_height, mat.LocalWidth(), slot, ldim);
+  El::Copy(mat.LockedMatrix(), slot_view);
+  mat.Attach(mat.Height(),
+             mat.Width(),
+             mat.Grid(),
+             mat.ColAlign(),
+             mat.RowAlign(),
+             slot,
+             ldim,
+             mat.Root());
+}
+
+template <typename T, El::Device Device>
+class flat_weights_buffer final : public flat_weights_buffer_base
+{
+public:
+  explicit flat_weights_buffer(
+    std::vector<data_type_weights<T>*> const& weights_list)
+    : m_num_weights{weights_list.size()}
+  {
+
+    // Size the buffer
+    size_t size = 0;
+    for (auto* w : weights_list) {
+      const auto& values = w->get_values_sharded();
+      size += aligned_slot_size(values);
+      auto* opt = w->get_optimizer();
+      if (opt != nullptr) {
+        if (!w->is_sharded()) {
+          size += aligned_slot_size(values);
+        }
+        for (auto* state : opt->get_state_matrices()) {
+          if (has_slot(*state)) {
+            size += aligned_slot_size(**state);
+          }
+        }
+      }
+    }
+#ifdef LBANN_HAS_GPU
+    if (Device == El::Device::GPU) {
+      m_buffer.SetMemoryMode(0); // Direct allocation
+    }
+#endif // LBANN_HAS_GPU
+    m_buffer.Resize(std::max(size, size_t{1}), 1);
+    El::Zero(m_buffer);
+
+    // Move values, gradients and optimizer state into their slots
+    T* slot = m_buffer.Buffer();
+    for (auto* w : weights_list) {
+      auto& values = w->get_values_sharded();
+      const size_t values_size = aligned_slot_size(values);
+      move_to_slot<T, Device>(values, slot);
+      slot += values_size;
+      auto* opt = w->get_optimizer();
+      if (opt != nullptr) {
+        if (!w->is_sharded()) {
+          opt->set_gradient_storage(slot);
+          slot += values_size;
+        }
+        for (auto* state : opt->get_state_matrices()) {
+          if (has_slot(*state)) {
+            const size_t state_size = aligned_slot_size(**state);
+            move_to_slot<T, Device>(**state, slot);
+            slot += state_size;
+          }
+        }
+      }
+    }
+  }
+
+  size_t num_weights() const noexcept final { return m_num_weights; }
+  size_t size_in_bytes() const noexcept final
+  {
+    return m_buffer.Height() * sizeof(T);
+  }
+
+private:
+  static bool
+  has_slot(std::unique_ptr<El::AbstractDistMatrix<T>> const& mat) noexcept
+  {
+    return mat != nullptr && mat->GetLocalDevice() == Device;
+  }
+
+  El::Matrix<T, Device> m_buffer;
+  size_t m_num_weights;
+};
+
+template <typename T, El::Device Device>
+void add_flat_weights_buffer(
+  std::vector<weights*> const& weights_list,
+  std::vector<std::unique_ptr<flat_weights_buffer_base>>& buffers)
+{
+  std::vector<data_type_weights<T>*> group;
+  for (auto* w : weights_list) {
+    auto* dtw = dynamic_cast<data_type_weights<T>*>(w);
+    if (dtw != nullptr && dtw->get_values_sharded().GetLocalDevice() == Device) {
+      group.push_back(dtw);
+    }
+  }
+  if (!group.empty()) {
+    buffers.emplace_back(
+      std::make_unique<flat_weights_buffer<T, Device>>(group));
+  }
+}
+
+} // namespace
+
+std::vector<std::unique_ptr<flat_weights_buffer_base>>
+make_flat_weights_buffers(std::vector<weights*> const& weights_list)
+{
+  std::vector<std::unique_ptr<flat_weights_buffer_base>> buffers;
+  add_flat_weights_buffer<float, El::Device::CPU>(weights_list, buffers);
+#ifdef LBANN_HAS_DOUBLE
+  add_flat_weights_buffer<double, El::Device::CPU>(weights_list, buffers);
+#endif // LBANN_HAS_DOUBLE
+#ifdef LBANN_HAS_HALF
+  add_flat_weights_buffer<cpu_fp16, El::Device::CPU>(weights_list, buffers);
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU
+  add_flat_weights_buffer<float, El::Device::GPU>(weights_list, buffers);
+#ifdef LBANN_HAS_DOUBLE
+  add_flat_weights_buffer<double, El::Device::GPU>(weights_list, buffers);
+#endif // LBANN_HAS_DOUBLE
+#ifdef LBANN_HAS_GPU_FP16
+  add_flat_weights_buffer<fp16, El::Device::GPU>(weights_list, buffers);
+#endif // LBANN_HAS_GPU_FP16
+#endif // LBANN_HAS_GPU
+  return buffers;
+}
+
+} // namespace lbann
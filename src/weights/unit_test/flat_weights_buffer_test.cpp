@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+#include <lbann/weights/flat_weights_buffer.hpp>
+
+namespace {
+
+using DataType = float;
+using WeightsType = lbann::data_type_weights<DataType>;
+
+auto make_weights(lbann::lbann_comm& comm, size_t height, size_t width)
+{
+  auto w = std::make_unique<WeightsType>(comm);
+  w->set_dims({height}, {width});
+  w->set_optimizer(std::make_unique<lbann::sgd<DataType>>(1.f, 0.9f, false));
+  w->setup();
+  return w;
+}
+
+DataType value_at(size_t k, El::Int i, El::Int j)
+{
+  return DataType(k + 1) + DataType(i) / 8.f + DataType(j) / 64.f;
+}
+
+void fill(WeightsType& w, size_t k)
+{
+  auto& values = w.get_values_sharded();
+  for (El::Int j = 0; j < values.Width(); ++j) {
+    for (El::Int i = 0; i < values.Height(); ++i) {
+      values.Set(i, j, value_at(k, i, j));
+    }
+  }
+}
+
+void check_values(WeightsType const& w, size_t k)
+{
+  auto const& values = w.get_values_sharded();
+  for (El::Int j = 0; j < values.Width(); ++j) {
+    for (El::Int i = 0; i < values.Height(); ++i) {
+      CHECK(values.Get(i, j) == value_at(k, i, j));
+    }
+  }
+}
+
+} // namespace
+
+TEST_CASE("Flat weights buffers", "[mpi][weights]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  std::vector<std::unique_ptr<WeightsType>> owned;
+  owned.push_back(make_weights(comm, 7, 3));
+  owned.push_back(make_weights(comm, 5, 1));
+  owned.push_back(make_weights(comm, 2, 9));
+  std::vector<lbann::weights*> weights_list;
+  for (size_t k = 0; k < owned.size(); ++k) {
+    fill(*owned[k], k);
+    weights_list.push_back(owned[k].get());
+  }
+
+  auto buffers = lbann::make_flat_weights_buffers(weights_list);
+  REQUIRE(buffers.size() == 1);
+  CHECK(buffers.front()->num_weights() == owned.size());
+
+  SECTION("Values survive packing")
+  {
+    for (size_t k = 0; k < owned.size(); ++k) {
+      check_values(*owned[k], k);
+    }
+  }
+
+  SECTION("Values and optimizer state share one allocation")
+  {
+    auto const* begin = reinterpret_cast<char const*>(
+      owned.front()->get_values_sharded().LockedBuffer());
+    auto const* end = begin + buffers.front()->size_in_bytes();
+    for (auto const& w : owned) {
+      auto const& local = w->get_values_sharded().LockedMatrix();
+      if (local.Height() == 0 || local.Width() == 0) {
+        continue;
+      }
+      auto const* values =
+        reinterpret_cast<char const*>(w->get_values_sharded().LockedBuffer());
+      CHECK(values >= begin);
+      CHECK(values < end);
+      for (auto* state : w->get_optimizer()->get_state_matrices()) {
+        auto const* data =
+          reinterpret_cast<char const*>((*state)->LockedBuffer());
+        CHECK(data >= begin);
+        CHECK(data < end);
+      }
+    }
+  }
+
+  SECTION("Packed weights can be packed again")
+  {
+    auto repacked = lbann::make_flat_weights_buffers(weights_list);
+    buffers = std::move(repacked);
+    for (size_t k = 0; k < owned.size(); ++k) {
+      check_values(*owned[k], k);
+    }
+  }
+
+  SECTION("Packed matrices cannot grow")
+  {
+    CHECK_THROWS(owned.front()->get_values_sharded().Resize(70, 30));
+  }
+}
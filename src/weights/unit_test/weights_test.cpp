@@ -35,8 +35,11 @@
 #include <lbann/utils/serialize.hpp>
 #include <lbann/weights/data_type_weights.hpp>
 #include <lbann/weights/weights.hpp>
+#include <lbann/weights/weights_helpers.hpp>
 #include <lbann/weights/weights_proxy.hpp>
 
+#include <type_traits>
+
 // Some convenience typedefs
 
 template <typename T>
@@ -171,3 +174,142 @@ TEST_CASE("Serializing weights", "[mpi][weights][serialize]")
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
 }
+
+TEST_CASE("Caching full views of sharded weights", "[mpi][weights]")
+{
+  using DataType = float;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  size_t const size_of_world = world_comm.get_procs_in_world();
+
+  auto const& g = world_comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  size_t const weights_height = 3 * size_of_world;
+  size_t const weights_width = 2 * size_of_world;
+  auto dtw = make_weights<DataType>(world_comm, weights_height, weights_width);
+  dtw.set_sharded(true);
+  dtw.set_sharding_distribution(El::VC);
+  dtw.setup();
+
+  CHECK(dtw.get_full_weights_bytes() ==
+        sizeof(DataType) * weights_height * weights_width);
+  CHECK_FALSE(dtw.has_full_weights());
+
+  dtw.request_full_weights_async();
+  dtw.wait_for_full_weights();
+  CHECK(dtw.has_full_weights());
+  CHECK(dtw.get_values().Height() == El::Int(weights_height));
+  CHECK(dtw.get_values().Width() == El::Int(weights_width));
+
+  SECTION("Writable access to the shard invalidates the view")
+  {
+    dtw.get_values_sharded();
+    CHECK_FALSE(dtw.has_full_weights());
+  }
+
+  SECTION("Releasing drops the view")
+  {
+    dtw.release_full_weights();
+    CHECK_FALSE(dtw.has_full_weights());
+  }
+}
+
+TEMPLATE_TEST_CASE("Copying values between weights of any data type",
+                   "[mpi][weights]",
+                   float,
+                   double)
+{
+  using DataType = TestType;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  auto const& g = world_comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  auto src = make_weights<DataType>(world_comm, 3, 2);
+  auto dst = make_weights<DataType>(world_comm, 3, 2);
+  src.setup();
+  dst.setup();
+  El::Fill(src.get_values_sharded(), El::To<DataType>(4.f));
+
+  SECTION("Weights of the same data type are copied")
+  {
+    lbann::weights const& src_base = src;
+    lbann::weights& dst_base = dst;
+    REQUIRE_NOTHROW(lbann::weights_details::copy_values(src_base, dst_base));
+    auto const& values = dst.get_values_sharded().LockedMatrix();
+    for (El::Int j = 0; j < values.Width(); ++j) {
+      for (El::Int i = 0; i < values.Height(); ++i) {
+        CHECK(values.Get(i, j) == El::To<DataType>(4.f));
+      }
+    }
+  }
+
+  SECTION("Weights of different data types are rejected")
+  {
+    using OtherType = std::conditional_t<std::is_same_v<DataType, float>,
+                                         double,
+                                         float>;
+    auto other = make_weights<OtherType>(world_comm, 3, 2);
+    other.setup();
+    CHECK_THROWS(lbann::weights_details::copy_values(src, other));
+  }
+}
+
+TEST_CASE("Incremental serialization of weights", "[mpi][weights][serialize]")
+{
+  using DataType = float;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  size_t const size_of_world = world_comm.get_procs_in_world();
+
+  auto const& g = world_comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  size_t const weights_height = 3 * size_of_world;
+  size_t const weights_width = 2 * size_of_world;
+  auto dtw = make_weights<DataType>(world_comm, weights_height, weights_width);
+  dtw.set_name("w");
+  dtw.setup();
+
+  SECTION("Const access keeps the version")
+  {
+    auto const version = dtw.get_version();
+    static_cast<DataTypeWeights<DataType> const&>(dtw).get_values_sharded();
+    CHECK(dtw.get_version() == version);
+  }
+
+  SECTION("Writable access bumps the version")
+  {
+    auto const version = dtw.get_version();
+    dtw.get_values_sharded();
+    CHECK(dtw.get_version() > version);
+  }
+
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  SECTION("Skipped weights are taken from the previous checkpoint")
+  {
+    El::Fill(dtw.get_values_sharded(), El::To<DataType>(4.f));
+    std::shared_ptr<lbann::weights> previous =
+      make_weights_ptr<DataType>(world_comm, weights_height, weights_width);
+    previous->set_name("w");
+    previous->setup();
+
+    std::stringstream ss;
+    {
+      lbann::incremental_checkpoint_scope scope({"w"});
+      cereal::BinaryOutputArchive oarchive(ss);
+      REQUIRE_NOTHROW(oarchive(dtw));
+    }
+    auto tgt = make_weights<DataType>(world_comm);
+    {
+      lbann::incremental_checkpoint_scope scope({}, {{"w", previous}});
+      cereal::BinaryInputArchive iarchive(ss);
+      REQUIRE_NOTHROW(iarchive(tgt));
+    }
+    auto const& values = tgt.get_values_sharded().LockedMatrix();
+    REQUIRE(values.Height() > 0);
+    CHECK(values.Get(0, 0) == El::To<DataType>(1.3));
+  }
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+}
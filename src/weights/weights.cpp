@@ -33,6 +33,7 @@
 #include "lbann/proto/layers.pb.h"
 
 #include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -62,13 +63,18 @@ std::string get_dims_string(const std::vector<size_t>& matrix_height_dims,
   return ss.str();
 }
 
+std::atomic<uint64_t> next_weights_version{0};
+
+thread_local incremental_checkpoint_scope* current_incremental_scope = nullptr;
+
 } // namespace
 
 weights::weights()
   : m_comm(nullptr),
     m_frozen(false),
     m_sharded(false),
-    m_sharding_strategy(El::STAR)
+    m_sharding_strategy(El::STAR),
+    m_version(++next_weights_version)
 {
 
   // Initialize weights name
@@ -85,6 +91,8 @@ weights::weights(lbann_comm& comm) : weights()
   setup_default_matrix_distribution();
 }
 
+void weights::mark_modified() noexcept { m_version = ++next_weights_version; }
+
 template <typename ArchiveT>
 void weights::serialize(ArchiveT& ar)
 {
@@ -257,6 +265,39 @@ void weights::steal_values(weights& other)
     // Copy things over.
     this->set_values(other.get_values_sharded());
 }
+
+incremental_checkpoint_scope::incremental_checkpoint_scope(
+  std::set<std::string> skip,
+  std::map<std::string, OwningWeightsPtr> previous)
+  : m_skip(std::move(skip)),
+    m_previous(std::move(previous)),
+    m_outer(current_incremental_scope)
+{
+  current_incremental_scope = this;
+}
+
+incremental_checkpoint_scope::~incremental_checkpoint_scope()
+{
+  current_incremental_scope = m_outer;
+}
+
+incremental_checkpoint_scope*
+incremental_checkpoint_scope::get_current() noexcept
+{
+  return current_incremental_scope;
+}
+
+weights&
+incremental_checkpoint_scope::get_previous(std::string const& name) const
+{
+  auto const it = m_previous.find(name);
+  if (it == m_previous.end() || !it->second) {
+    LBANN_ERROR("incremental checkpoint does not store weights \"",
+                name,
+                "\" and the checkpoint it builds on has no copy of them");
+  }
+  return *it->second;
+}
 } // namespace lbann
 
 #define LBANN_CLASS_NAME weights
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef LBANN_UNIT_TEST_UTILITIES_MODEL_TEST_HELPERS_HPP_INCLUDED
+#define LBANN_UNIT_TEST_UTILITIES_MODEL_TEST_HELPERS_HPP_INCLUDED
+
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/layers/transform/dummy.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+
+#include "lbann/proto/lbann.pb.h"
+#include <google/protobuf/text_format.h>
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace unit_test {
+namespace utilities {
+
+/** @brief Entries of a distributed matrix in column-major order */
+inline std::vector<float> to_vector(El::AbstractDistMatrix<float> const& mat)
+{
+  std::vector<float> values;
+  for (El::Int j = 0; j < mat.Width(); ++j) {
+    for (El::Int i = 0; i < mat.Height(); ++i) {
+      values.push_back(mat.Get(i, j));
+    }
+  }
+  return values;
+}
+
+/** @brief Write a weights block with fixed initial values
+ *
+ *  The block belongs inside the @c model message of a prototext.
+ */
+inline void add_weights(std::ostream& os,
+                        std::string const& name,
+                        std::vector<float> const& values)
+{
+  os << "  weights {\n"
+     << "    name: \"" << name << "\"\n"
+     << "    initializer {\n"
+     << "      value_initializer {\n";
+  for (auto const& v : values) {
+    os << "        values: " << v << "\n";
+  }
+  os << "      }\n"
+     << "    }\n"
+     << "  }\n";
+}
+
+/** @brief Check two vectors entry by entry */
+inline void check_close(std::vector<float> const& values,
+                        std::vector<float> const& expected,
+                        double margin = 1e-5)
+{
+  REQUIRE(values.size() == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    CHECK(values[i] == Approx(expected[i]).margin(margin));
+  }
+}
+
+/** @brief Construct a trainer and a model from a prototext
+ *
+ *  The model is not set up, so its options can still be changed (see
+ *  setup_model).
+ */
+inline std::unique_ptr<lbann::model>
+construct_model(std::string const& prototext)
+{
+  auto& comm = current_world_comm();
+  lbann::utils::grid_manager mgr(comm.get_trainer_grid());
+  lbann_data::LbannPB my_proto;
+  REQUIRE(google::protobuf::TextFormat::ParseFromString(prototext, &my_proto));
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  return lbann::proto::construct_model(&comm,
+                                       my_proto.optimizer(),
+                                       my_proto.trainer(),
+                                       my_proto.model());
+}
+
+/** @brief Set up a model for mini-batches of one sample */
+inline void setup_model(lbann::model& m)
+{
+  auto& g = current_world_comm().get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+  m.setup(1UL, {&g});
+}
+
+/** @brief Find a layer by name */
+template <typename LayerT = lbann::Layer>
+LayerT& find_layer(lbann::model& m, std::string const& name)
+{
+  LayerT* layer = nullptr;
+  for (auto* l : m.get_layers()) {
+    if (l->get_name() == name) {
+      layer = dynamic_cast<LayerT*>(l);
+    }
+  }
+  REQUIRE(layer != nullptr);
+  return *layer;
+}
+
+/** @brief Set the error signal of a dummy layer to one sample */
+template <El::Device Dev>
+void set_error_signal(lbann::Layer& out, std::vector<float> const& values)
+{
+  using dummy_type =
+    lbann::dummy_layer<float, lbann::data_layout::DATA_PARALLEL, Dev>;
+  using matrix_type =
+    El::DistMatrix<float, El::STAR, El::STAR, El::ELEMENT, Dev>;
+  auto& g = current_world_comm().get_trainer_grid();
+  auto signal = std::make_unique<matrix_type>(values.size(), 1, g);
+  for (size_t i = 0; i < values.size(); ++i) {
+    signal->Set(i, 0, values[i]);
+  }
+  dynamic_cast<dummy_type&>(out).set_error_signal(std::move(signal));
+}
+
+/** @brief One training step with the current error signals */
+inline void run_training_step(lbann::model& m,
+                              bool compute_weight_grads_only = false)
+{
+  m.clear_gradients();
+  REQUIRE_NOTHROW(m.forward_prop(lbann::execution_mode::training));
+  REQUIRE_NOTHROW(m.backward_prop(compute_weight_grads_only));
+  REQUIRE_NOTHROW(m.update_weights());
+}
+
+} // namespace utilities
+} // namespace unit_test
+#endif // LBANN_UNIT_TEST_UTILITIES_MODEL_TEST_HELPERS_HPP_INCLUDED